@@ -169,6 +169,58 @@ BOOST_AUTO_TEST_CASE (test_convertUTF16ToUTF8) {
   BOOST_CHECK(result.empty());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test_Base64
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (test_Base64) {
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64(""), "");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64("f"), "Zg==");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64("fo"), "Zm8=");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64("foo"), "Zm9v");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64("foobar"), "Zm9vYmFy");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64("\xfb\xff"), "+/8=");
+  BOOST_CHECK_EQUAL(StringUtils::encodeBase64U("\xfb\xff"), "-_8=");
+
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64("Zg=="), "f");
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64("Zm8="), "fo");
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64("Zm9vYmFy"), "foobar");
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64("+/8="), "\xfb\xff");
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64U("-_8="), "\xfb\xff");
+
+  // decoding stops at the first invalid character
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64("Zm9v YmFy"), "foo");
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64U("Zm9v+mFy"), "foo");
+
+  string all;
+  for (int i = 0; i < 256; ++i) {
+    all.push_back((char) i);
+  }
+  BOOST_CHECK_EQUAL(StringUtils::decodeBase64(StringUtils::encodeBase64(all)), all);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test_UrlDecode
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (test_UrlDecode) {
+  BOOST_CHECK_EQUAL(StringUtils::urlDecode("hello+world"), "hello world");
+  BOOST_CHECK_EQUAL(StringUtils::urlDecode("a%2Fb%2fc"), "a/b/c");
+  BOOST_CHECK_EQUAL(StringUtils::urlDecode("%41+%4"), "A \x04");
+  BOOST_CHECK_EQUAL(StringUtils::urlDecode("plain"), "plain");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test_EscapeUnicode
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (test_EscapeUnicode) {
+  BOOST_CHECK_EQUAL(StringUtils::escapeUnicode("the quick brown fox", true), "the quick brown fox");
+  BOOST_CHECK_EQUAL(StringUtils::escapeUnicode("a/b\"c\"\n", true), "a\\/b\\\"c\\\"\\n");
+  BOOST_CHECK_EQUAL(StringUtils::escapeUnicode("a/b", false), "a/b");
+  BOOST_CHECK_EQUAL(StringUtils::escapeUnicode("long plain prefix before \xc3\xa4", false), "long plain prefix before \\u00E4");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for AssocAppendOnly
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/AssocAppendOnly.h"
+#include "Basics/hashes.h"
+
+#include <thread>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+typedef struct data_container_s {
+  uint64_t key;
+  int value;
+}
+data_container_t;
+
+static uint64_t HashKey (void const* k) {
+  return TRI_FnvHashPointer(k, sizeof(uint64_t));
+}
+
+static uint64_t HashElement (void const* e) {
+  return TRI_FnvHashPointer(&static_cast<data_container_t const*>(e)->key, sizeof(uint64_t));
+}
+
+static bool IsEqualKeyElement (void const* k, void const* e) {
+  return *static_cast<uint64_t const*>(k) == static_cast<data_container_t const*>(e)->key;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CAssocAppendOnlySetup {
+  CAssocAppendOnlySetup () {
+    BOOST_TEST_MESSAGE("setup AssocAppendOnly");
+  }
+
+  ~CAssocAppendOnlySetup () {
+    BOOST_TEST_MESSAGE("tear-down AssocAppendOnly");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CAssocAppendOnlyTest, CAssocAppendOnlySetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test insertion, overwriting and growing
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_insert_lookup) {
+  AssocAppendOnly a(HashKey, HashElement, IsEqualKeyElement, 4);
+  std::vector<data_container_t> elements(1000);
+
+  for (size_t i = 0; i < elements.size(); ++i) {
+    elements[i].key = i * 7;
+    elements[i].value = (int) i;
+
+    void* found = &elements[0];
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&elements[i].key, &elements[i], false, &found));
+    BOOST_CHECK(found == nullptr);
+  }
+
+  BOOST_CHECK_EQUAL((uint64_t) 1000, a.size());
+
+  for (size_t i = 0; i < elements.size(); ++i) {
+    uint64_t key = i * 7;
+    BOOST_CHECK(a.lookup(&key) == &elements[i]);
+
+    key = i * 7 + 1;
+    BOOST_CHECK(a.lookup(&key) == nullptr);
+  }
+
+  // an existing key is kept unless overwrite is set
+  data_container_t other = { 14, 99 };
+  void* found = nullptr;
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&other.key, &other, false, &found));
+  BOOST_CHECK(found == &elements[2]);
+  BOOST_CHECK(a.lookup(&other.key) == &elements[2]);
+
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&other.key, &other, true, &found));
+  BOOST_CHECK(found == &elements[2]);
+  BOOST_CHECK(a.lookup(&other.key) == &other);
+  BOOST_CHECK_EQUAL((uint64_t) 1000, a.size());
+
+  size_t n = 0;
+  a.invokeOnAllElements([&n] (void*) { ++n; });
+  BOOST_CHECK_EQUAL((size_t) 1000, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test lookups running concurrently with insertions
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_concurrent_lookup) {
+  AssocAppendOnly a(HashKey, HashElement, IsEqualKeyElement);
+  size_t const n = 100000;
+  std::vector<data_container_t> elements(n);
+  std::atomic<uint64_t> published(0);
+  std::atomic<bool> failed(false);
+
+  for (size_t i = 0; i < n; ++i) {
+    elements[i].key = i;
+    elements[i].value = (int) i;
+  }
+
+  std::vector<std::thread> readers;
+
+  for (size_t t = 0; t < 4; ++t) {
+    readers.emplace_back([&] () {
+      while (true) {
+        uint64_t const limit = published.load();
+
+        // everything published must be visible
+        for (uint64_t key = (limit > 64 ? limit - 64 : 0); key < limit; ++key) {
+          auto element = static_cast<data_container_t const*>(a.lookup(&key));
+
+          if (element == nullptr || element->key != key) {
+            failed = true;
+          }
+        }
+
+        if (limit == n) {
+          break;
+        }
+      }
+    });
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    a.insert(&elements[i].key, &elements[i], false, nullptr);
+    published = i + 1;
+  }
+
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  BOOST_CHECK(! failed.load());
+  BOOST_CHECK_EQUAL((uint64_t) n, a.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
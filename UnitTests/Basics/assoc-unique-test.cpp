@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for AssocUnique
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/AssocUnique.h"
+#include "Basics/voc-errors.h"
+
+#include <vector>
+
+using namespace std;
+
+typedef triagens::basics::AssocUnique<uint64_t, uint64_t> AssocUniqueType;
+
+static uint64_t HashKey (uint64_t const* key) {
+  // spread the keys, so that they do not end up in adjacent slots
+  return *key * 0x9E3779B97F4A7C15ULL;
+}
+
+static uint64_t HashElement (uint64_t const* element) {
+  return HashKey(element);
+}
+
+static bool IsEqualKeyElement (uint64_t const* key,
+                               uint64_t hash,
+                               uint64_t const* element) {
+  return *key == *element;
+}
+
+static bool IsEqualElementElement (uint64_t const* left,
+                                   uint64_t const* right) {
+  return *left == *right;
+}
+
+static size_t Comparisons = 0;
+
+static uint64_t HashKeyPairs (uint64_t const* key) {
+  // two keys share each hash value
+  return (*key / 2) * 0x9E3779B97F4A7C15ULL;
+}
+
+static uint64_t HashElementPairs (uint64_t const* element) {
+  return HashKeyPairs(element);
+}
+
+static bool IsEqualKeyElementCounting (uint64_t const* key,
+                                       uint64_t hash,
+                                       uint64_t const* element) {
+  ++Comparisons;
+  return *key == *element;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CAssocUniqueSetup {
+  CAssocUniqueSetup () {
+    BOOST_TEST_MESSAGE("setup AssocUnique");
+  }
+
+  ~CAssocUniqueSetup () {
+    BOOST_TEST_MESSAGE("tear-down AssocUnique");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CAssocUniqueTest, CAssocUniqueSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test inserting, finding and removing
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_insert_remove) {
+  AssocUniqueType a(HashKey, HashElement, IsEqualKeyElement, IsEqualElementElement, IsEqualElementElement);
+
+  vector<uint64_t> values;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    values.push_back(i);
+  }
+
+  for (auto& it : values) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&it));
+  }
+  BOOST_CHECK_EQUAL(1000, (int) a.size());
+
+  // duplicates are rejected
+  uint64_t duplicate = 17;
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, a.insert(&duplicate));
+
+  for (uint64_t i = 0; i < 1000; i += 2) {
+    BOOST_CHECK_EQUAL(&values[i], a.removeByKey(&i));
+  }
+  BOOST_CHECK_EQUAL(500, (int) a.size());
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    BOOST_CHECK_EQUAL((i % 2 == 0) ? nullptr : &values[i], a.findByKey(&i));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that only elements with the hash of a key are compared to it
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_compare_equal_hashes_only) {
+  AssocUniqueType a(HashKeyPairs, HashElementPairs, IsEqualKeyElementCounting, IsEqualElementElement, IsEqualElementElement);
+
+  vector<uint64_t> values;
+  for (uint64_t i = 0; i < 10000; ++i) {
+    values.push_back(i);
+  }
+
+  for (auto& it : values) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&it));
+  }
+
+  // keys that are not contained have hashes no element has
+  Comparisons = 0;
+  for (uint64_t i = 20000; i < 30000; ++i) {
+    BOOST_CHECK_EQUAL((uint64_t*) nullptr, a.findByKey(&i));
+  }
+  BOOST_CHECK_EQUAL(0, (int) Comparisons);
+
+  // keys sharing a hash are told apart by the comparison
+  Comparisons = 0;
+  for (uint64_t i = 0; i < 10000; ++i) {
+    BOOST_CHECK_EQUAL(&values[i], a.findByKey(&i));
+  }
+  BOOST_CHECK(Comparisons <= 15000);
+
+  for (uint64_t i = 0; i < 10000; i += 2) {
+    BOOST_CHECK_EQUAL(&values[i], a.removeByKey(&i));
+  }
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    BOOST_CHECK_EQUAL((i % 2 == 0) ? nullptr : &values[i], a.findByKey(&i));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test growing a large table incrementally
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_incremental_resize) {
+  AssocUniqueType a(HashKey, HashElement, IsEqualKeyElement, IsEqualElementElement, IsEqualElementElement);
+
+  uint64_t const n = 500000;
+  vector<uint64_t> values;
+  values.reserve(n);
+  for (uint64_t i = 0; i < n; ++i) {
+    values.push_back(i);
+  }
+
+  for (uint64_t i = 0; i < n; ++i) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&values[i]));
+
+    if (i % 3 == 2) {
+      // remove an element while elements are moved between tables
+      uint64_t key = i - 1;
+      BOOST_CHECK_EQUAL(&values[i - 1], a.removeByKey(&key));
+    }
+    if (i % 1024 == 0) {
+      // re-inserting an element that may still be in the old table
+      uint64_t key = i / 2;
+      if (key % 3 != 1) {
+        BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, a.insert(&values[key]));
+      }
+    }
+  }
+
+  uint64_t expected = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    bool const removed = (i % 3 == 1 && i + 1 < n);
+    BOOST_CHECK_EQUAL(removed ? nullptr : &values[i], a.findByKey(&i));
+    if (! removed) {
+      ++expected;
+    }
+  }
+  BOOST_CHECK_EQUAL(expected, a.size());
+
+  // all elements are visited exactly once
+  uint64_t visited = 0;
+  uint64_t sum = 0;
+  a.invokeOnAllElements([&] (uint64_t* element) -> void {
+    ++visited;
+    sum += *element;
+  });
+  BOOST_CHECK_EQUAL(expected, visited);
+
+  uint64_t expectedSum = 0;
+  for (uint64_t i = 0; i < n; ++i) {
+    if (! (i % 3 == 1 && i + 1 < n)) {
+      expectedSum += i;
+    }
+  }
+  BOOST_CHECK_EQUAL(expectedSum, sum);
+
+  // sequential iteration sees the same elements
+  triagens::basics::BucketPosition position;
+  uint64_t total = 0;
+  uint64_t iterated = 0;
+  while (a.findSequential(position, total) != nullptr) {
+    ++iterated;
+  }
+  BOOST_CHECK_EQUAL(expected, iterated);
+
+  // remove everything
+  for (uint64_t i = 0; i < n; ++i) {
+    a.removeByKey(&i);
+  }
+  BOOST_CHECK_EQUAL(0, (int) a.size());
+  BOOST_CHECK(a.isEmpty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test scanning in chunks while the table is modified
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_scan_chunks) {
+  AssocUniqueType a(HashKey, HashElement, IsEqualKeyElement, IsEqualElementElement, IsEqualElementElement, 4);
+
+  uint64_t const n = 20000;
+  vector<uint64_t> values;
+  values.reserve(4 * n);
+  for (uint64_t i = 0; i < 4 * n; ++i) {
+    values.push_back(i);
+  }
+
+  for (uint64_t i = 0; i < n; ++i) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&values[i]));
+  }
+
+  vector<int> seen(4 * n, 0);
+  triagens::basics::ScanCursor cursor;
+  uint64_t removed = 1;
+  uint64_t inserted = n;
+
+  while (! a.isScanDone(cursor)) {
+    a.scanChunk(cursor, 100, [&] (uint64_t* element) -> void {
+      ++seen[*element];
+    });
+
+    // between two chunks, remove odd elements and insert new ones. this
+    // moves elements within their buckets and grows the tables
+    for (int i = 0; i < 50 && removed < n; ++i, removed += 2) {
+      BOOST_CHECK_EQUAL(&values[removed], a.removeByKey(&removed));
+    }
+    for (int i = 0; i < 200 && inserted < 4 * n; ++i, ++inserted) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, a.insert(&values[inserted]));
+    }
+  }
+
+  for (uint64_t i = 0; i < 4 * n; ++i) {
+    // no element is visited twice
+    BOOST_CHECK(seen[i] <= 1);
+
+    if (i < n && i % 2 == 0) {
+      // elements present during the whole scan are visited
+      BOOST_CHECK_EQUAL(1, seen[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,343 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for BTree
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/BTree.h"
+#include "Basics/voc-errors.h"
+
+#include <vector>
+
+using namespace std;
+
+typedef triagens::basics::BTree<int, int> Tree;
+
+static int CmpElmElm (int const* left,
+                      int const* right,
+                      triagens::basics::SkipListCmpType cmptype) {
+  if (*left != *right) {
+    return *left < *right ? -1 : 1;
+  }
+  return 0;
+}
+
+static int CmpKeyElm (int const* left,
+                      int const* right) {
+  if (*left != *right) {
+    return *left < *right ? -1 : 1;
+  }
+  return 0;
+}
+
+// order preserving, but many values share a prefix
+static uint64_t Prefix (int const* value) {
+  return static_cast<uint64_t>(*value + 1000000) >> 4;
+}
+
+static int NumFreed = 0;
+
+static void FreeElm (int*) {
+  ++NumFreed;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CBTreeSetup {
+  CBTreeSetup () {
+    BOOST_TEST_MESSAGE("setup BTree");
+  }
+
+  ~CBTreeSetup () {
+    BOOST_TEST_MESSAGE("tear-down BTree");
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that a scan returns exactly the expected values
+////////////////////////////////////////////////////////////////////////////////
+
+static void CheckScan (Tree const& tree,
+                       std::vector<int> const& expected) {
+  std::vector<int> found;
+  auto pos = tree.begin();
+  while (! pos.isEnd()) {
+    found.emplace_back(*tree.at(pos));
+    tree.next(pos);
+  }
+  BOOST_CHECK(expected == found);
+
+  // and backwards
+  found.clear();
+  pos = tree.end();
+  while (tree.prev(pos)) {
+    found.emplace_back(*tree.at(pos));
+  }
+  std::reverse(found.begin(), found.end());
+  BOOST_CHECK(expected == found);
+
+  BOOST_CHECK_EQUAL(expected.size(), (size_t) tree.getNrUsed());
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE (CBTreeTest, CBTreeSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test empty tree
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_empty) {
+  Tree tree(CmpElmElm, CmpKeyElm, FreeElm, false, false);
+
+  BOOST_CHECK_EQUAL(0, (int) tree.getNrUsed());
+  BOOST_CHECK(tree.begin().isEnd());
+  BOOST_CHECK(tree.last().isEnd());
+
+  int key = 5;
+  BOOST_CHECK(tree.lowerBound(&key).isEnd());
+  BOOST_CHECK(tree.upperBound(&key).isEnd());
+  BOOST_CHECK_EQUAL((void*) 0, tree.lookup(&key));
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, tree.remove(&key));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test insertion in mixed order, with and without prefixes
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_insert_scan) {
+  for (int withPrefix = 0; withPrefix < 2; ++withPrefix) {
+    Tree tree(CmpElmElm, CmpKeyElm, nullptr, true, false,
+              withPrefix ? Tree::ElementPrefixFuncType(Prefix) : nullptr,
+              withPrefix ? Tree::KeyPrefixFuncType(Prefix) : nullptr);
+
+    std::vector<int> values(10000);
+    for (int i = 0; i < 10000; ++i) {
+      values[i] = i;
+    }
+
+    // insert in a scrambled order
+    for (int i = 0; i < 10000; ++i) {
+      int j = (i * 7919) % 10000;
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&values[j]));
+    }
+
+    CheckScan(tree, values);
+
+    // duplicates are rejected
+    int dup = 4711;
+    BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, tree.insert(&dup));
+    BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, tree.insert(&values[4711]));
+
+    for (int i = 0; i < 10000; ++i) {
+      BOOST_CHECK_EQUAL(&values[i], tree.lookup(&values[i]));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test range bounds
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_bounds) {
+  Tree tree(CmpElmElm, CmpKeyElm, nullptr, false, false, Prefix, Prefix);
+
+  // even values only
+  std::vector<int> values;
+  for (int i = 0; i < 5000; ++i) {
+    values.emplace_back(i * 2);
+  }
+  for (auto& it : values) {
+    tree.insert(&it);
+  }
+
+  for (int key = -1; key < 10001; ++key) {
+    auto lower = tree.lowerBound(&key);
+    auto upper = tree.upperBound(&key);
+
+    int firstNotLess = (key < 0 ? 0 : (key + 1) / 2 * 2);
+    int firstGreater = (key < 0 ? 0 : key / 2 * 2 + 2);
+
+    if (firstNotLess >= 10000) {
+      BOOST_CHECK(lower.isEnd());
+    }
+    else {
+      BOOST_CHECK_EQUAL(firstNotLess, *tree.at(lower));
+    }
+    if (firstGreater >= 10000) {
+      BOOST_CHECK(upper.isEnd());
+    }
+    else {
+      BOOST_CHECK_EQUAL(firstGreater, *tree.at(upper));
+      BOOST_CHECK(tree.upperBoundElement(&key) == upper);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test removal, including removal of all elements
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_remove) {
+  NumFreed = 0;
+
+  std::vector<int> values(20000);
+  for (int i = 0; i < 20000; ++i) {
+    values[i] = i;
+  }
+
+  {
+    Tree tree(CmpElmElm, CmpKeyElm, FreeElm, false, false, Prefix, Prefix);
+
+    for (auto& it : values) {
+      tree.insert(&it);
+    }
+
+    // remove every other element, which removes separators, too
+    std::vector<int> expected;
+    for (int i = 0; i < 20000; ++i) {
+      if (i % 2 == 0) {
+        BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&values[i]));
+      }
+      else {
+        expected.emplace_back(i);
+      }
+    }
+    BOOST_CHECK_EQUAL(10000, NumFreed);
+    CheckScan(tree, expected);
+
+    for (int i = 0; i < 20000; ++i) {
+      if (i % 2 == 0) {
+        BOOST_CHECK_EQUAL((void*) 0, tree.lookup(&values[i]));
+        BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, tree.remove(&values[i]));
+      }
+      else {
+        BOOST_CHECK_EQUAL(&values[i], tree.lookup(&values[i]));
+      }
+    }
+
+    // remove a large block from the middle, emptying whole leaves
+    expected.clear();
+    for (int i = 1; i < 20000; i += 2) {
+      if (i > 2000 && i < 18000) {
+        BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&values[i]));
+      }
+      else {
+        expected.emplace_back(i);
+      }
+    }
+    CheckScan(tree, expected);
+
+    // insert again into the gap
+    for (int i = 5000; i < 6000; ++i) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&values[i]));
+    }
+    for (int i = 5000; i < 6000; ++i) {
+      expected.emplace_back(i);
+    }
+    std::sort(expected.begin(), expected.end());
+    CheckScan(tree, expected);
+
+    // remove everything
+    for (auto& it : expected) {
+      BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.remove(&values[it]));
+    }
+    CheckScan(tree, std::vector<int>());
+    BOOST_CHECK(tree.begin().isEnd());
+
+    // and the tree is still usable
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, tree.insert(&values[42]));
+    CheckScan(tree, std::vector<int>({ 42 }));
+  }
+
+  // the remaining element is freed by the destructor
+  BOOST_CHECK_EQUAL(10000 + 8000 + 3000 + 1, NumFreed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the unique constraint
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unique) {
+  // the preorder only looks at value / 10, the total order at the value
+  auto cmpElmElm = [] (int const* left, int const* right, triagens::basics::SkipListCmpType cmptype) -> int {
+    int l = *left;
+    int r = *right;
+    if (cmptype == triagens::basics::SKIPLIST_CMP_PREORDER) {
+      l /= 10;
+      r /= 10;
+    }
+    return (l == r ? 0 : (l < r ? -1 : 1));
+  };
+  auto cmpKeyElm = [] (int const* left, int const* right) -> int {
+    int r = *right / 10;
+    return (*left == r ? 0 : (*left < r ? -1 : 1));
+  };
+
+  std::vector<int> values({ 10, 11, 25, 30, 39 });
+
+  Tree unique(cmpElmElm, cmpKeyElm, nullptr, true, false);
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, unique.insert(&values[0]));
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, unique.insert(&values[1]));
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, unique.insert(&values[2]));
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, unique.insert(&values[4]));
+  BOOST_CHECK_EQUAL(TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED, unique.insert(&values[3]));
+  BOOST_CHECK_EQUAL(3, (int) unique.getNrUsed());
+
+  Tree nonUnique(cmpElmElm, cmpKeyElm, nullptr, false, false);
+  for (auto& it : values) {
+    BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, nonUnique.insert(&it));
+  }
+
+  // all elements with key 3
+  int key = 3;
+  auto pos = nonUnique.lowerBound(&key);
+  auto end = nonUnique.upperBound(&key);
+  BOOST_CHECK_EQUAL(30, *nonUnique.at(pos));
+  nonUnique.next(pos);
+  BOOST_CHECK_EQUAL(39, *nonUnique.at(pos));
+  nonUnique.next(pos);
+  BOOST_CHECK(pos == end);
+  BOOST_CHECK(end.isEnd());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
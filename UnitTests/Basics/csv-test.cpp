@@ -382,6 +382,31 @@ BOOST_AUTO_TEST_CASE (tst_csv_semicolon_noquote) {
   TRI_DestroyCsvParser(&parser);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test csv long fields, which are scanned in blocks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_csv_long_fields) {
+  INIT_PARSER
+  TRI_SetSeparatorCsvParser(&parser, ',');
+  TRI_SetQuoteCsvParser(&parser, '"', true);
+
+  const char* csv = 
+    "abcdefghijklmnopqrstuvwxyz0123456789,\"abcdefghijklmnopqrstuvwxyz\"\"0123456789\"" LF
+    "\"abcdefghijklmnop\"\"qrstuvwxyz\"\"0123456789,abcdefghijklmnop\",x" CR LF;
+
+  // feed the input in small pieces, so that fields span several calls
+  size_t const length = strlen(csv);
+
+  for (size_t i = 0; i < length; i += 7) {
+    TRI_ParseCsvString(&parser, csv + i, (std::min)((size_t) 7, length - i));
+  }
+
+  BOOST_CHECK_EQUAL("0:abcdefghijklmnopqrstuvwxyz0123456789,ESCabcdefghijklmnopqrstuvwxyz\"0123456789ESC\n1:ESCabcdefghijklmnop\"qrstuvwxyz\"0123456789,abcdefghijklmnopESC,x\n", out.str());
+
+  TRI_DestroyCsvParser(&parser);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for DataProtector
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/DataProtector.h"
+
+#include <thread>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+static std::atomic<int> Freed(0);
+
+static void CountFree (void*) {
+  ++Freed;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CDataProtectorSetup {
+  CDataProtectorSetup () {
+    BOOST_TEST_MESSAGE("setup DataProtector");
+    Freed = 0;
+  }
+
+  ~CDataProtectorSetup () {
+    BOOST_TEST_MESSAGE("tear-down DataProtector");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CDataProtectorTest, CDataProtectorSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that readers are seen until they are released, also nested
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_use) {
+  DataProtector prot;
+
+  BOOST_CHECK(prot.isUnused());
+
+  {
+    auto outer(prot.use());
+    BOOST_CHECK(! prot.isUnused());
+
+    {
+      auto inner(prot.use());
+      BOOST_CHECK(! prot.isUnused());
+    }
+
+    BOOST_CHECK(! prot.isUnused());
+  }
+
+  BOOST_CHECK(prot.isUnused());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that protectors do not see each other's readers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_independent) {
+  DataProtector one;
+  DataProtector two;
+
+  auto unuser(one.use());
+
+  BOOST_CHECK(! one.isUnused());
+  BOOST_CHECK(two.isUnused());
+
+  // does not wait for the reader of the other protector
+  two.scan();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that retired data is freed only after older readers are done
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_retire) {
+  DataProtector prot;
+
+  {
+    auto unuser(prot.use());
+
+    prot.retire(nullptr, CountFree);
+
+    BOOST_CHECK_EQUAL(0, (int) prot.reclaim());
+    BOOST_CHECK_EQUAL(0, Freed.load());
+  }
+
+  // a reader that starts after the data was retired does not block it
+  auto unuser(prot.use());
+
+  BOOST_CHECK_EQUAL(1, (int) prot.reclaim());
+  BOOST_CHECK_EQUAL(1, Freed.load());
+  BOOST_CHECK_EQUAL(0, (int) prot.reclaim());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the destructor frees the retired data
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_destroy) {
+  {
+    DataProtector prot;
+
+    {
+      auto unuser(prot.use());
+      prot.retire(nullptr, CountFree);
+      prot.retire(nullptr, CountFree);
+    }
+  }
+
+  BOOST_CHECK_EQUAL(2, Freed.load());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that scan waits for readers of other threads, and that an
+/// unuser can be released by another thread
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_threads) {
+  DataProtector prot;
+  std::atomic<bool> reading(false);
+  std::atomic<bool> released(false);
+
+  std::thread reader([&] () -> void {
+    auto unuser(prot.use());
+    reading = true;
+    usleep(50 * 1000);
+    released = true;
+  });
+
+  while (! reading) {
+    usleep(100);
+  }
+
+  prot.scan();
+  BOOST_CHECK(released.load());
+
+  reader.join();
+
+  // move a reader to another thread
+  std::unique_ptr<DataProtector::UnUser> moved(new DataProtector::UnUser(prot.use()));
+  BOOST_CHECK(! prot.isUnused());
+
+  std::thread other([&] () -> void {
+    moved.reset();
+  });
+  other.join();
+
+  BOOST_CHECK(prot.isUnused());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
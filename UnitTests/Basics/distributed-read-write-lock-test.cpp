@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the distributed read-write lock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/DistributedReadWriteLock.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/ReadWriteLock.h"
+#include "Basics/WriteLocker.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs readers and an occasional writer on a lock, returns the time
+/// in seconds
+///
+/// The writer changes both values, readers check that they are equal.
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static double Contend (T& lock,
+                       int numThreads,
+                       int numIterations,
+                       std::atomic<int>& errors) {
+  uint64_t a = 0;
+  uint64_t b = 0;
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < numThreads; ++i) {
+    threads.emplace_back([&, i] () {
+      for (int j = 0; j < numIterations; ++j) {
+        if (i == 0 && j % 100 == 0) {
+          WRITE_LOCKER(lock);
+          ++a;
+          ++b;
+        }
+        else {
+          READ_LOCKER(lock);
+
+          if (a != b) {
+            ++errors;
+          }
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (a != b || a != static_cast<uint64_t>((numIterations + 99) / 100)) {
+    ++errors;
+  }
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CDistributedReadWriteLockSetup {
+  CDistributedReadWriteLockSetup () {
+    BOOST_TEST_MESSAGE("setup distributed read-write lock");
+  }
+
+  ~CDistributedReadWriteLockSetup () {
+    BOOST_TEST_MESSAGE("tear-down distributed read-write lock");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CDistributedReadWriteLockTest, CDistributedReadWriteLockSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test try locks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_try_lock) {
+  DistributedReadWriteLock lock;
+
+  // readers share the lock
+  BOOST_CHECK(lock.tryReadLock());
+  BOOST_CHECK(lock.tryReadLock());
+  BOOST_CHECK(! lock.tryWriteLock());
+  lock.unlock();
+  BOOST_CHECK(! lock.tryWriteLock());
+  lock.unlock();
+
+  // writers do not
+  BOOST_CHECK(lock.tryWriteLock());
+  BOOST_CHECK(! lock.tryWriteLock());
+  BOOST_CHECK(! lock.tryReadLock());
+  lock.unlock();
+
+  BOOST_CHECK(lock.tryReadLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a waiting writer keeps new readers out
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_waiting_writer) {
+  DistributedReadWriteLock lock;
+  std::atomic<bool> written(false);
+
+  lock.readLock();
+
+  std::thread writer([&] () {
+    WRITE_LOCKER(lock);
+    written = true;
+  });
+
+  // wait until the writer has announced itself
+  while (lock.tryReadLock()) {
+    lock.unlock();
+    std::this_thread::yield();
+  }
+
+  BOOST_CHECK(! written);
+
+  // the writer gets the lock once the reader is gone, even after blocking
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  lock.unlock();
+  writer.join();
+
+  BOOST_CHECK(written);
+  BOOST_CHECK(lock.tryReadLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the lock can be released by another thread
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_unlock_other_thread) {
+  DistributedReadWriteLock lock;
+
+  for (int i = 0; i < 20; ++i) {
+    lock.readLock();
+    std::thread([&] () { lock.unlock(); }).join();
+  }
+
+  BOOST_CHECK(lock.tryWriteLock());
+  lock.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test mutual exclusion under contention, and compare with the
+/// pthread-based lock
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_contention) {
+  int const numThreads = 8;
+  int const numIterations = 100000;
+
+  std::atomic<int> errors(0);
+
+  DistributedReadWriteLock distributed;
+  double t1 = Contend(distributed, numThreads, numIterations, errors);
+  BOOST_CHECK_EQUAL(0, errors.load());
+
+  ReadWriteLock pthread;
+  double t2 = Contend(pthread, numThreads, numIterations, errors);
+  BOOST_CHECK_EQUAL(0, errors.load());
+
+  BOOST_TEST_MESSAGE("distributed read-write lock: " << t1 << " s, ReadWriteLock: " << t2 << " s");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for FlatDictionary
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/FlatDictionary.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CFlatDictionarySetup {
+  CFlatDictionarySetup () {
+    BOOST_TEST_MESSAGE("setup FlatDictionary");
+  }
+
+  ~CFlatDictionarySetup () {
+    BOOST_TEST_MESSAGE("tear-down FlatDictionary");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CFlatDictionaryTest, CFlatDictionarySetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test lookups in an empty dictionary
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_empty) {
+  FlatDictionary<char const*, 4> dict;
+
+  BOOST_CHECK_EQUAL((size_t) 0, dict.size());
+  BOOST_CHECK(dict.lookup("host") == nullptr);
+  BOOST_CHECK(dict.lookup("", 0) == nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test slices into a shared buffer
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_slices) {
+  char const* buffer = "content-typeaccept";
+  FlatDictionary<char const*, 4> dict;
+
+  BOOST_CHECK(dict.insert(buffer, 12, "json"));
+  BOOST_CHECK(dict.insert(buffer + 12, 6, "*/*"));
+
+  BOOST_CHECK_EQUAL((size_t) 2, dict.size());
+  BOOST_CHECK_EQUAL("json", dict.lookup("content-type")->_value);
+  BOOST_CHECK_EQUAL("*/*", dict.lookup("accept")->_value);
+  BOOST_CHECK(dict.lookup("content") == nullptr);
+  BOOST_CHECK(dict.lookup("content-type", 7) == nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test replacing a value
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_replace) {
+  FlatDictionary<int, 4> dict;
+
+  BOOST_CHECK(dict.insert("a", 1));
+  BOOST_CHECK(! dict.insert("a", 2));
+
+  BOOST_CHECK_EQUAL((size_t) 1, dict.size());
+  BOOST_CHECK_EQUAL(2, dict.lookup("a")->_value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test growing beyond the inline slots
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_grow) {
+  std::vector<std::string> keys;
+
+  for (int i = 0;  i < 100;  ++i) {
+    keys.emplace_back("x-header-" + std::to_string(i));
+  }
+
+  FlatDictionary<int, 4> dict;
+
+  for (int i = 0;  i < 100;  ++i) {
+    BOOST_CHECK(dict.insert(keys[i].c_str(), keys[i].size(), i));
+  }
+
+  BOOST_CHECK_EQUAL((size_t) 100, dict.size());
+
+  for (int i = 0;  i < 100;  ++i) {
+    auto kv = dict.lookup(keys[i].c_str());
+
+    BOOST_REQUIRE(kv != nullptr);
+    BOOST_CHECK_EQUAL(i, kv->_value);
+  }
+
+  // the range covers every entry exactly once
+  FlatDictionary<int, 4>::KeyValue const* begin;
+  FlatDictionary<int, 4>::KeyValue const* end;
+  int sum = 0;
+  size_t count = 0;
+
+  for (dict.range(begin, end);  begin < end;  ++begin) {
+    if (begin->_key != nullptr) {
+      sum += begin->_value;
+      ++count;
+    }
+  }
+
+  BOOST_CHECK_EQUAL((size_t) 100, count);
+  BOOST_CHECK_EQUAL(99 * 100 / 2, sum);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
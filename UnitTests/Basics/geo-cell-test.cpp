@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for GeoCell
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/GeoCell.h"
+
+using namespace triagens::basics;
+
+static bool IsCovered (std::vector<GeoCell::Range> const& ranges,
+                       uint64_t id) {
+  for (auto const& it : ranges) {
+    if (id >= it._min && id <= it._max) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void CheckSortedAndDisjoint (std::vector<GeoCell::Range> const& ranges) {
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    BOOST_CHECK(ranges[i]._min <= ranges[i]._max);
+    if (i > 0) {
+      // adjacent ranges are merged
+      BOOST_CHECK(ranges[i - 1]._max + 1 < ranges[i]._min);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CGeoCellSetup {
+  CGeoCellSetup () {
+    BOOST_TEST_MESSAGE("setup GeoCell");
+  }
+
+  ~CGeoCellSetup () {
+    BOOST_TEST_MESSAGE("tear-down GeoCell");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CGeoCellTest, CGeoCellSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test ids and cells
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_cells) {
+  BOOST_CHECK(GeoCell::isValid(90.0, 180.0));
+  BOOST_CHECK(GeoCell::isValid(-90.0, -180.0));
+  BOOST_CHECK(! GeoCell::isValid(90.5, 0.0));
+  BOOST_CHECK(! GeoCell::isValid(0.0, -181.0));
+
+  BOOST_CHECK_EQUAL(0ULL, (unsigned long long) GeoCell::id(-90.0, -180.0));
+
+  // the level 0 cell is the whole world
+  GeoCell::Range world = GeoCell::cell(50.9, 6.9, 0);
+  BOOST_CHECK_EQUAL(0ULL, (unsigned long long) world._min);
+  BOOST_CHECK_EQUAL((unsigned long long) ((1ULL << 60) - 1), (unsigned long long) world._max);
+
+  // cells are nested and contain their points
+  uint64_t const id = GeoCell::id(50.9, 6.9);
+  for (int level = 0; level <= GeoCell::MaxLevel; ++level) {
+    GeoCell::Range cell = GeoCell::cell(50.9, 6.9, level);
+    BOOST_CHECK(cell._min <= id && id <= cell._max);
+
+    if (level > 0) {
+      GeoCell::Range parent = GeoCell::cell(50.9, 6.9, level - 1);
+      BOOST_CHECK(parent._min <= cell._min && cell._max <= parent._max);
+    }
+  }
+
+  // nearby points share coarse cells
+  GeoCell::Range a = GeoCell::cell(50.9, 6.9, 10);
+  GeoCell::Range b = GeoCell::cell(50.9001, 6.9001, 10);
+  BOOST_CHECK_EQUAL(a._min, b._min);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test rectangle coverings
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_cover_rectangle) {
+  double const minLat = 47.3, maxLat = 55.0, minLon = 5.9, maxLon = 15.0;
+
+  for (size_t maxCells : { 1, 4, 8, 16, 64 }) {
+    auto ranges = GeoCell::coverRectangle(minLat, minLon, maxLat, maxLon, maxCells);
+
+    BOOST_CHECK(! ranges.empty());
+    BOOST_CHECK(ranges.size() <= maxCells);
+    CheckSortedAndDisjoint(ranges);
+
+    // all points inside are covered
+    for (double lat = minLat; lat <= maxLat; lat += 0.37) {
+      for (double lon = minLon; lon <= maxLon; lon += 0.41) {
+        BOOST_CHECK(IsCovered(ranges, GeoCell::id(lat, lon)));
+      }
+    }
+    BOOST_CHECK(IsCovered(ranges, GeoCell::id(maxLat, maxLon)));
+  }
+
+  // more cells cover less of the outside
+  auto coarse = GeoCell::coverRectangle(minLat, minLon, maxLat, maxLon, 4);
+  auto fine = GeoCell::coverRectangle(minLat, minLon, maxLat, maxLon, 64);
+  size_t coarseHits = 0, fineHits = 0;
+
+  for (double lat = 40.0; lat <= 62.0; lat += 0.25) {
+    for (double lon = 0.0; lon <= 21.0; lon += 0.25) {
+      bool const inside = (lat >= minLat && lat <= maxLat && lon >= minLon && lon <= maxLon);
+      if (! inside) {
+        coarseHits += IsCovered(coarse, GeoCell::id(lat, lon)) ? 1 : 0;
+        fineHits += IsCovered(fine, GeoCell::id(lat, lon)) ? 1 : 0;
+      }
+    }
+  }
+  BOOST_CHECK(fineHits < coarseHits);
+
+  // points far away are not covered
+  BOOST_CHECK(! IsCovered(fine, GeoCell::id(-33.9, 151.2)));
+
+  // degenerate rectangle
+  auto point = GeoCell::coverRectangle(10.0, 20.0, 10.0, 20.0);
+  BOOST_CHECK(IsCovered(point, GeoCell::id(10.0, 20.0)));
+
+  // whole world
+  auto world = GeoCell::coverRectangle(-90.0, -180.0, 90.0, 180.0);
+  BOOST_CHECK_EQUAL(1U, (unsigned) world.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test polygons
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_polygon) {
+  // a triangle
+  std::vector<std::pair<double, double>> polygon = {
+    { 0.0, 0.0 }, { 0.0, 10.0 }, { 10.0, 0.0 }
+  };
+
+  BOOST_CHECK(GeoCell::isInPolygon(polygon, 1.0, 1.0));
+  BOOST_CHECK(GeoCell::isInPolygon(polygon, 4.9, 4.9));
+  BOOST_CHECK(! GeoCell::isInPolygon(polygon, 5.1, 5.1));
+  BOOST_CHECK(! GeoCell::isInPolygon(polygon, -1.0, 1.0));
+
+  auto ranges = GeoCell::coverPolygon(polygon, 32);
+  BOOST_CHECK(! ranges.empty());
+  BOOST_CHECK(ranges.size() <= 32);
+  CheckSortedAndDisjoint(ranges);
+
+  size_t outsideHits = 0;
+  for (double lat = -1.0; lat <= 11.0; lat += 0.1) {
+    for (double lon = -1.0; lon <= 11.0; lon += 0.1) {
+      if (GeoCell::isInPolygon(polygon, lat, lon)) {
+        BOOST_CHECK(IsCovered(ranges, GeoCell::id(lat, lon)));
+      }
+      else if (IsCovered(ranges, GeoCell::id(lat, lon))) {
+        ++outsideHits;
+      }
+    }
+  }
+
+  // the covering follows the diagonal edge, unlike the bounding box
+  auto box = GeoCell::coverRectangle(0.0, 0.0, 10.0, 10.0, 32);
+  size_t boxHits = 0;
+  for (double lat = -1.0; lat <= 11.0; lat += 0.1) {
+    for (double lon = -1.0; lon <= 11.0; lon += 0.1) {
+      if (! GeoCell::isInPolygon(polygon, lat, lon) && IsCovered(box, GeoCell::id(lat, lon))) {
+        ++boxHits;
+      }
+    }
+  }
+  BOOST_CHECK(outsideHits < boxHits);
+
+  // empty polygon
+  BOOST_CHECK(GeoCell::coverPolygon(std::vector<std::pair<double, double>>()).empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
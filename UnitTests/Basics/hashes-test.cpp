@@ -28,6 +28,9 @@
 #include <boost/test/unit_test.hpp>
 
 #include "Basics/hashes.h"
+#include "Basics/fasthash.h"
+
+#include <set>
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    private macros
@@ -423,6 +426,89 @@ BOOST_AUTO_TEST_CASE (tst_crc32_utf8) {
   BOOST_CHECK_EQUAL((uint64_t) 2590070434ULL,   TRI_FinalCrc32(TRI_BlockCrc32(TRI_InitialCrc32(), buffer.c_str(), strlen(buffer.c_str()))));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test memory hash
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_memory_hash) {
+  char buffer[1025];
+  for (size_t i = 0; i < sizeof(buffer); ++i) {
+    buffer[i] = static_cast<char>(i * 31);
+  }
+
+  // short blocks are hashed with fasthash64
+  for (size_t i = 0; i < 32; ++i) {
+    BOOST_CHECK_EQUAL(fasthash64(buffer, i, 0x0123456789abcdef), TRI_MemoryHash64(buffer, i, 0x0123456789abcdef));
+  }
+
+  std::set<uint64_t> hashes;
+  for (size_t i = 0; i < 1024; ++i) {
+    // unaligned start addresses
+    uint64_t hash = TRI_MemoryHash64(buffer + 1, i, 0x0123456789abcdef);
+    BOOST_CHECK_EQUAL(hash, TRI_MemoryHash64(buffer + 1, i, 0x0123456789abcdef));
+    BOOST_CHECK(hash != TRI_MemoryHash64(buffer + 1, i, 0x0123456789abcdee));
+    hashes.insert(hash);
+  }
+  BOOST_CHECK_EQUAL(1024, (int) hashes.size());
+
+  // every byte influences the result
+  size_t const lengths[] = { 32, 40, 48, 49, 64, 100, 256, 1000 };
+  for (auto const& length : lengths) {
+    uint64_t const hash = TRI_MemoryHash64(buffer, length, 0);
+    for (size_t i = 0; i < length; ++i) {
+      buffer[i] ^= 0x10;
+      BOOST_CHECK(hash != TRI_MemoryHash64(buffer, length, 0));
+      buffer[i] ^= 0x10;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test crc32c
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_crc32c) {
+  auto crc32c = [] (char const* data, size_t length) -> uint64_t {
+    return TRI_FinalCrc32(TRI_BlockCrc32C(TRI_InitialCrc32(), data, length));
+  };
+
+  BOOST_CHECK_EQUAL((uint64_t) 0ULL, crc32c("", 0));
+  BOOST_CHECK_EQUAL((uint64_t) 0xE3069283ULL, crc32c("123456789", 9));
+
+  // test vectors from RFC 3720
+  char buffer[1024 + 8];
+
+  memset(buffer, 0, 32);
+  BOOST_CHECK_EQUAL((uint64_t) 0x8A9136AAULL, crc32c(buffer, 32));
+
+  memset(buffer, 0xFF, 32);
+  BOOST_CHECK_EQUAL((uint64_t) 0x62A8AB43ULL, crc32c(buffer, 32));
+
+  for (int i = 0; i < 32; ++i) {
+    buffer[i] = (char) i;
+  }
+  BOOST_CHECK_EQUAL((uint64_t) 0x46DD794EULL, crc32c(buffer, 32));
+
+  // the result does not depend on the alignment or on how the data is split
+  for (size_t i = 0; i < sizeof(buffer); ++i) {
+    buffer[i] = (char) (i * 31 + 7);
+  }
+
+  for (size_t offset = 0; offset < 8; ++offset) {
+    memmove(buffer + offset, buffer, 1024);
+    uint64_t const expected = crc32c(buffer + offset, 1024);
+
+    for (size_t split = 0; split <= 1024; split += 73) {
+      uint32_t crc = TRI_InitialCrc32();
+      crc = TRI_BlockCrc32C(crc, buffer + offset, split);
+      crc = TRI_BlockCrc32C(crc, buffer + offset + split, 1024 - split);
+      BOOST_CHECK_EQUAL(expected, (uint64_t) TRI_FinalCrc32(crc));
+    }
+
+    memmove(buffer, buffer + offset, 1024);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
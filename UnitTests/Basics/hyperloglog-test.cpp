@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for HyperLogLog
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/HyperLogLog.h"
+#include "Basics/fasthash.h"
+
+using namespace triagens::basics;
+
+static uint64_t Hash (uint64_t value) {
+  return fasthash64(&value, sizeof(value), 0xdeadbeef);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CHyperLogLogSetup {
+  CHyperLogLogSetup () {
+    BOOST_TEST_MESSAGE("setup HyperLogLog");
+  }
+
+  ~CHyperLogLogSetup () {
+    BOOST_TEST_MESSAGE("tear-down HyperLogLog");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CHyperLogLogTest, CHyperLogLogSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test empty sketch
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_empty) {
+  HyperLogLog hll;
+
+  BOOST_CHECK_EQUAL(0.0, hll.estimate());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test small cardinalities
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_small) {
+  HyperLogLog hll;
+
+  for (uint64_t i = 0; i < 100; ++i) {
+    hll.add(Hash(i));
+  }
+
+  BOOST_CHECK_CLOSE(100.0, hll.estimate(), 10.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test large cardinalities
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_large) {
+  HyperLogLog hll;
+
+  for (uint64_t i = 0; i < 100000; ++i) {
+    hll.add(Hash(i));
+  }
+
+  BOOST_CHECK_CLOSE(100000.0, hll.estimate(), 15.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that duplicates are not counted
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_duplicates) {
+  HyperLogLog hll;
+
+  for (size_t j = 0; j < 10; ++j) {
+    for (uint64_t i = 0; i < 1000; ++i) {
+      hll.add(Hash(i));
+    }
+  }
+
+  BOOST_CHECK_CLOSE(1000.0, hll.estimate(), 15.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test merging and clearing
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_merge_clear) {
+  HyperLogLog left;
+  HyperLogLog right;
+
+  for (uint64_t i = 0; i < 5000; ++i) {
+    left.add(Hash(i));
+    right.add(Hash(i + 2500));
+  }
+
+  left.merge(right);
+  BOOST_CHECK_CLOSE(7500.0, left.estimate(), 15.0);
+
+  left.clear();
+  BOOST_CHECK_EQUAL(0.0, left.estimate());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
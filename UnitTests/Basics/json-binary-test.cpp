@@ -0,0 +1,222 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for binary json
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/json-binary.h"
+#include "Basics/json.h"
+#include "Basics/string-buffer.h"
+#include "Basics/tri-strings.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief encodes a json text in binary
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string Encode (char const* text) {
+  TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, text);
+  BOOST_REQUIRE(json != nullptr);
+
+  TRI_string_buffer_t buffer;
+  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+  BOOST_CHECK_EQUAL(TRI_ERROR_NO_ERROR, TRI_StringifyBinaryJson(&buffer, json));
+
+  std::string result(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+
+  TRI_DestroyStringBuffer(&buffer);
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes binary json and stringifies the result
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string Decode (std::string const& data) {
+  char* error = nullptr;
+  TRI_json_t* json = TRI_BinaryJson(TRI_UNKNOWN_MEM_ZONE, data.c_str(), data.size(), &error);
+
+  if (json == nullptr) {
+    BOOST_CHECK(error != nullptr);
+    TRI_FreeString(TRI_CORE_MEM_ZONE, error);
+    return "<error>";
+  }
+
+  BOOST_CHECK(error == nullptr);
+
+  TRI_string_buffer_t buffer;
+  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+  TRI_StringifyJson(&buffer, json);
+
+  std::string result(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+
+  TRI_DestroyStringBuffer(&buffer);
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CJsonBinarySetup {
+  CJsonBinarySetup () {
+    BOOST_TEST_MESSAGE("setup json binary");
+  }
+
+  ~CJsonBinarySetup () {
+    BOOST_TEST_MESSAGE("tear-down json binary");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CJsonBinaryTest, CJsonBinarySetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the encoding of scalars
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_encode_scalars) {
+  BOOST_CHECK_EQUAL(std::string("\x00", 1), Encode("null"));
+  BOOST_CHECK_EQUAL(std::string("\x01", 1), Encode("false"));
+  BOOST_CHECK_EQUAL(std::string("\x02", 1), Encode("true"));
+  BOOST_CHECK_EQUAL(std::string("\x04\x00", 2), Encode("0"));
+  BOOST_CHECK_EQUAL(std::string("\x04\x7f", 2), Encode("127"));
+  BOOST_CHECK_EQUAL(std::string("\x04\x80\x01", 3), Encode("128"));
+  BOOST_CHECK_EQUAL(std::string("\x05\x01", 2), Encode("-1"));
+  BOOST_CHECK_EQUAL(std::string("\x03\x00\x00\x00\x00\x00\x00\xf8\x3f", 9), Encode("1.5"));
+  BOOST_CHECK_EQUAL(std::string("\x03\x00\x00\x00\x00\x00\x00\x00\x80", 9), Encode("-0.0"));
+  BOOST_CHECK_EQUAL(std::string("\x06\x00", 2), Encode("\"\""));
+  BOOST_CHECK_EQUAL(std::string("\x06\x03" "abc", 5), Encode("\"abc\""));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the encoding of arrays and objects
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_encode_compound) {
+  BOOST_CHECK_EQUAL(std::string("\x07\x00", 2), Encode("[]"));
+  BOOST_CHECK_EQUAL(std::string("\x08\x00", 2), Encode("{}"));
+  BOOST_CHECK_EQUAL(std::string("\x07\x02\x02\x00", 4), Encode("[true,null]"));
+  BOOST_CHECK_EQUAL(std::string("\x08\x01\x01" "a" "\x07\x01\x04\x01", 8), Encode("{\"a\":[1]}"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test round trips
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_round_trip) {
+  char const* texts[] = {
+    "null",
+    "[1,-2,3.25,-0,9007199254740992,-9007199254740992,9007199254740994,1e+300]",
+    "\"\\u0000 \\u00e4 \\ud83d\\ude00\"",
+    "{\"_key\":\"abc\",\"value\":{\"nested\":[[],{},\"\",false]},\"\":1}"
+  };
+
+  for (auto text : texts) {
+    TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, text);
+    BOOST_REQUIRE(json != nullptr);
+
+    TRI_string_buffer_t buffer;
+    TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+    TRI_StringifyJson(&buffer, json);
+    std::string expected(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+    TRI_DestroyStringBuffer(&buffer);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    BOOST_CHECK_EQUAL(expected, Decode(Encode(text)));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test invalid input
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_invalid) {
+  std::string const valid = Encode("{\"a\":[1,\"bc\",2.5]}");
+
+  // every proper prefix is truncated
+  for (size_t i = 0; i < valid.size(); ++i) {
+    BOOST_CHECK_EQUAL("<error>", Decode(valid.substr(0, i)));
+  }
+
+  // trailing data
+  BOOST_CHECK_EQUAL("<error>", Decode(valid + std::string("\x00", 1)));
+
+  // unknown tag
+  BOOST_CHECK_EQUAL("<error>", Decode("\x09"));
+
+  // counts larger than the remaining input
+  BOOST_CHECK_EQUAL("<error>", Decode("\x07\xff\xff\xff\xff\x0f"));
+  BOOST_CHECK_EQUAL("<error>", Decode("\x08\x02\x01" "a" "\x00"));
+
+  // overlong varint
+  BOOST_CHECK_EQUAL("<error>", Decode("\x04\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\x01"));
+
+  // not a number
+  BOOST_CHECK_EQUAL("<error>", Decode(std::string("\x03\x00\x00\x00\x00\x00\x00\xf8\x7f", 9)));
+
+  // nesting too deep
+  BOOST_CHECK_EQUAL("<error>", Decode(std::string(100000, '\x07')));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test content type detection
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_content_type) {
+  BOOST_CHECK(TRI_IsBinaryJsonContentType("application/x-arango-binary"));
+  BOOST_CHECK(TRI_IsBinaryJsonContentType("Application/X-Arango-Binary; charset=binary"));
+  BOOST_CHECK(TRI_IsBinaryJsonContentType("application/json, application/x-arango-binary"));
+  BOOST_CHECK(! TRI_IsBinaryJsonContentType(nullptr));
+  BOOST_CHECK(! TRI_IsBinaryJsonContentType(""));
+  BOOST_CHECK(! TRI_IsBinaryJsonContentType("application/json; charset=utf-8"));
+  BOOST_CHECK(! TRI_IsBinaryJsonContentType("application/x-arango-binaryx"));
+  BOOST_CHECK(! TRI_IsBinaryJsonContentType("*/*"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -29,6 +29,7 @@
 
 #include "Basics/json.h"
 #include "Basics/string-buffer.h"
+#include "JsonParser/json-scanner.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    private macros
@@ -684,6 +685,174 @@ BOOST_AUTO_TEST_CASE (tst_json_array_keys_utf8) {
   FREE_BUFFER
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test parsing a json string
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_parse) {
+  INIT_BUFFER
+
+  TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, " { \"a\" : [ 1, -2.5, 1e3, TRUE, False, null ],\n\t\"\" : \"\", \"b\\u00e4\" : \"quoted \\\"text\\\" which is longer than sixteen bytes\" } ");
+  BOOST_REQUIRE(json != nullptr);
+
+  STRINGIFY
+  BOOST_CHECK_EQUAL("{\"a\":[1,-2.5,1000,true,false,null],\"\":\"\",\"b\\u00E4\":\"quoted \\\"text\\\" which is longer than sixteen bytes\"}", STRING_VALUE);
+  FREE_JSON
+  FREE_BUFFER
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test parsing numbers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_parse_numbers) {
+  TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, "[0, -0, +17, 123456789012345, 12345678901234567890, 0.125, -4E-2]");
+  BOOST_REQUIRE(json != nullptr);
+  BOOST_REQUIRE_EQUAL((size_t) 7, TRI_LengthArrayJson(json));
+
+  double expected[] = { 0.0, 0.0, 17.0, 123456789012345.0, 12345678901234567890.0, 0.125, -0.04 };
+
+  for (size_t i = 0;  i < 7;  ++i) {
+    TRI_json_t const* value = TRI_LookupArrayJson(json, i);
+
+    BOOST_CHECK(TRI_IsNumberJson(value));
+    BOOST_CHECK_EQUAL(expected[i], value->_value._number);
+  }
+
+  FREE_JSON
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test parse errors
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_parse_errors) {
+  char const* invalid[] = {
+    "", "[1,]", "[1 2]", "{\"a\" 1}", "{a:1}", "01", "1.", "-", "\"abc",
+    "\"a\\\nb\"", "truex", "[] []", "1e400"
+  };
+
+  for (auto text : invalid) {
+    char* error = nullptr;
+    TRI_json_t* json = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, text, &error);
+
+    BOOST_CHECK_MESSAGE(json == nullptr, text);
+    BOOST_CHECK(error != nullptr);
+
+    if (json != nullptr) {
+      FREE_JSON
+    }
+
+    if (error != nullptr) {
+      TRI_Free(TRI_CORE_MEM_ZONE, error);
+    }
+  }
+
+  char* error = nullptr;
+  TRI_json_t* json = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, "{\"a\":1 \"b\":2}", &error);
+
+  BOOST_CHECK(json == nullptr);
+  BOOST_CHECK_EQUAL("expecting comma", error);
+  TRI_Free(TRI_CORE_MEM_ZONE, error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the array reader
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_array_reader) {
+  std::string const text = " [ {\"a\":[1,{\"b\":\"]\"}]} ,2,\n\"x,y\" , [] ]\n ";
+
+  TRI_json_array_reader_t reader;
+  BOOST_REQUIRE(TRI_InitJsonArrayReader(&reader, text.c_str(), text.size()));
+
+  std::vector<std::string> elements;
+  char const* value;
+  size_t length;
+
+  while (true) {
+    BOOST_REQUIRE(TRI_NextJsonArrayReader(&reader, &value, &length));
+
+    if (value == nullptr) {
+      break;
+    }
+
+    elements.emplace_back(value, length);
+  }
+
+  BOOST_REQUIRE_EQUAL((size_t) 4, elements.size());
+  BOOST_CHECK_EQUAL("{\"a\":[1,{\"b\":\"]\"}]}", elements[0]);
+  BOOST_CHECK_EQUAL("2", elements[1]);
+  BOOST_CHECK_EQUAL("\"x,y\"", elements[2]);
+  BOOST_CHECK_EQUAL("[]", elements[3]);
+
+  // the end is sticky
+  BOOST_CHECK(TRI_NextJsonArrayReader(&reader, &value, &length));
+  BOOST_CHECK(value == nullptr);
+
+  // elements can be parsed without a terminating null byte
+  TRI_json_t* json = TRI_Json2StringLength(TRI_UNKNOWN_MEM_ZONE, elements[0].c_str(), elements[0].size(), nullptr);
+  BOOST_CHECK(TRI_IsObjectJson(json));
+  FREE_JSON
+
+  BOOST_CHECK(TRI_InitJsonArrayReader(&reader, "[]", 2));
+  BOOST_CHECK(TRI_NextJsonArrayReader(&reader, &value, &length));
+  BOOST_CHECK(value == nullptr);
+
+  BOOST_CHECK(! TRI_InitJsonArrayReader(&reader, "{}", 2));
+  BOOST_CHECK(! TRI_InitJsonArrayReader(&reader, "", 0));
+
+  // malformed arrays fail after their valid elements
+  char const* invalid[] = {
+    "[1,]", "[1 2]", "[1,{\"a\" 1}]", "[1,[2]", "[1] 2", "[1,}"
+  };
+
+  for (auto text : invalid) {
+    BOOST_REQUIRE(TRI_InitJsonArrayReader(&reader, text, strlen(text)));
+    BOOST_CHECK(TRI_NextJsonArrayReader(&reader, &value, &length));
+    BOOST_CHECK_EQUAL("1", std::string(value, length));
+
+    bool ok;
+    do {
+      ok = TRI_NextJsonArrayReader(&reader, &value, &length);
+    }
+    while (ok && value != nullptr);
+
+    BOOST_CHECK_MESSAGE(! ok, text);
+    BOOST_CHECK(reader._scanner._message != nullptr);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test finding attribute values in json text
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_find_attribute) {
+  std::string const text = " {\"a\" : {\"count\":1}, \"documents\":[ 1, \"],\" ] ,\"count\": 42 } ";
+
+  char const* value;
+  size_t length;
+
+  BOOST_REQUIRE(TRI_FindAttributeJsonScanner(text.c_str(), text.size(), "documents", &value, &length));
+  BOOST_CHECK_EQUAL("[ 1, \"],\" ]", std::string(value, length));
+
+  // nested attributes are skipped
+  BOOST_REQUIRE(TRI_FindAttributeJsonScanner(text.c_str(), text.size(), "count", &value, &length));
+  BOOST_CHECK_EQUAL("42", std::string(value, length));
+
+  BOOST_REQUIRE(TRI_FindAttributeJsonScanner(text.c_str(), text.size(), "a", &value, &length));
+  BOOST_CHECK_EQUAL("{\"count\":1}", std::string(value, length));
+
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner(text.c_str(), text.size(), "b", &value, &length));
+  BOOST_CHECK(value == nullptr);
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner(text.c_str(), text.size(), "coun", &value, &length));
+
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner("{}", 2, "a", &value, &length));
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner("[1]", 3, "a", &value, &length));
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner("{\"a\" 1}", 7, "a", &value, &length));
+  BOOST_CHECK(! TRI_FindAttributeJsonScanner("{\"b\":[1}", 8, "a", &value, &length));
+}
+
 // TODO: add tests for lookup json array value etc.
 
 ////////////////////////////////////////////////////////////////////////////////
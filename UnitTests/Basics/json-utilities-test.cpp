@@ -30,6 +30,9 @@
 #include "Basics/string-buffer.h"
 #include "Basics/json-utilities.h"
 
+#include <string>
+#include <vector>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    private macros
 // -----------------------------------------------------------------------------
@@ -184,6 +187,55 @@ BOOST_AUTO_TEST_CASE (tst_compare_values_unequal) {
   // TODO: add more tests
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that sort keys are ordered like the values
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_sort_keys) {
+  char const* values[] = {
+    "null", "false", "true", "-1e300", "-10", "-1.5", "-1", "-0.0", "0", "0.5",
+    "1", "1.5", "10", "1e300", "\"\"", "\" \"", "\"0\"", "\"-1\"", "\"a\"",
+    "\"A\"", "\"ab\"", "\"b\"", "[]", "[null]", "[null, null]", "[false]",
+    "[0]", "[0, null]", "[0, null, 1]", "[0, 1]", "[1]", "[\"a\"]", "[[]]",
+    "[[0]]", "[[0], 1]", "[[0, 1]]"
+  };
+
+  size_t const n = sizeof(values) / sizeof(values[0]);
+
+  std::vector<TRI_json_t*> jsons;
+  std::vector<std::string> keys;
+
+  for (size_t i = 0; i < n; ++i) {
+    TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, values[i]);
+    BOOST_REQUIRE(json != nullptr);
+    jsons.push_back(json);
+
+    std::string key;
+    BOOST_CHECK(TRI_AppendSortKeyJson(json, false, key));
+    keys.push_back(key);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      int expected = TRI_CompareValuesJson(jsons[i], jsons[j], false);
+      int actual = keys[i].compare(keys[j]);
+      actual = (actual < 0) ? -1 : ((actual > 0) ? 1 : 0);
+
+      BOOST_CHECK_MESSAGE(expected == actual, values[i] << " vs. " << values[j]);
+    }
+  }
+
+  for (auto& json : jsons) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+  }
+
+  // objects have no sort keys
+  TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, "[1, {}]");
+  std::string key;
+  BOOST_CHECK(! TRI_AppendSortKeyJson(json, false, key));
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+}
+
 // TODO: add tests for
   // TRI_CheckSameValueJson
   // TRI_UniquifyArrayJson
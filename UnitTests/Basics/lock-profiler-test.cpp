@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the lock profiler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/JsonHelper.h"
+#include "Basics/LockProfiler.h"
+#include "Basics/MutexLocker.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CLockProfilerSetup {
+  CLockProfilerSetup () {
+    BOOST_TEST_MESSAGE("setup LockProfiler");
+  }
+
+  ~CLockProfilerSetup () {
+    BOOST_TEST_MESSAGE("tear-down LockProfiler");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CLockProfilerTest, CLockProfilerSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the wait buckets and the hold times of a site
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_site) {
+  LockSite site{};
+
+  site.addWait(500);            // 0.5 us
+  site.addWait(1000);           // 1 us
+  site.addWait(3000);           // 3 us
+  site.addWait(10000000000ULL); // 10 s
+
+  BOOST_CHECK_EQUAL(4U, site._acquisitions.load());
+  BOOST_CHECK_EQUAL(10000004500ULL, site._waitTime.load());
+  BOOST_CHECK_EQUAL(1U, site._waitBuckets[0].load());
+  BOOST_CHECK_EQUAL(1U, site._waitBuckets[1].load());
+  BOOST_CHECK_EQUAL(1U, site._waitBuckets[2].load());
+  BOOST_CHECK_EQUAL(1U, site._waitBuckets[LockSite::NumWaitBuckets - 1].load());
+
+  site.addHold(20);
+  site.addHold(50);
+  site.addHold(30);
+
+  BOOST_CHECK_EQUAL(100U, site._holdTime.load());
+  BOOST_CHECK_EQUAL(50U, site._maxHoldTime.load());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the lockers are recorded if the profiler is compiled in
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_lockers) {
+  LockProfiler::reset();
+
+  Mutex mutex;
+
+  for (size_t i = 0; i < 3; ++i) {
+    MUTEX_LOCKER(mutex);
+  }
+
+  Json result = LockProfiler::toJson();
+
+  BOOST_CHECK_EQUAL(LockProfiler::enabled(), JsonHelper::getBooleanValue(result.json(), "enabled", ! LockProfiler::enabled()));
+
+  Json sites = result.get("sites");
+  BOOST_CHECK(sites.isArray());
+
+  if (! LockProfiler::enabled()) {
+    BOOST_CHECK_EQUAL(0U, sites.size());
+    return;
+  }
+
+  bool found = false;
+
+  for (size_t i = 0; i < sites.size(); ++i) {
+    Json site = sites.at(static_cast<int>(i));
+
+    if (JsonHelper::getStringValue(site.json(), "file", "") == __FILE__ &&
+        JsonHelper::getStringValue(site.json(), "type", "") == "mutex") {
+      BOOST_CHECK_EQUAL(3.0, JsonHelper::getNumericValue<double>(site.json(), "acquisitions", 0.0));
+      found = true;
+    }
+  }
+
+  BOOST_CHECK(found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
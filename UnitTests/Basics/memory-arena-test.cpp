@@ -0,0 +1,232 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for arena memory zones
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/json.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CMemoryArenaSetup {
+  CMemoryArenaSetup () {
+    BOOST_TEST_MESSAGE("setup memory arena");
+  }
+
+  ~CMemoryArenaSetup () {
+    BOOST_TEST_MESSAGE("tear-down memory arena");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CMemoryArenaTest, CMemoryArenaSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test zone ids
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_zone_ids) {
+  TRI_memory_zone_t* a = TRI_CreateArenaMemoryZone(1024);
+  TRI_memory_zone_t* b = TRI_CreateArenaMemoryZone(1024);
+
+  BOOST_REQUIRE(a != nullptr);
+  BOOST_REQUIRE(b != nullptr);
+  BOOST_CHECK(TRI_IsArenaMemoryZone(a));
+  BOOST_CHECK(! TRI_IsArenaMemoryZone(TRI_UNKNOWN_MEM_ZONE));
+  BOOST_CHECK(TRI_MemoryZoneId(a) != TRI_MemoryZoneId(b));
+  BOOST_CHECK(TRI_MemoryZone(TRI_MemoryZoneId(a)) == a);
+  BOOST_CHECK(TRI_MemoryZone(TRI_MemoryZoneId(b)) == b);
+
+  TRI_memory_zone_id_t const zid = TRI_MemoryZoneId(a);
+  TRI_FreeArenaMemoryZone(a);
+
+  // ids are reused
+  TRI_memory_zone_t* c = TRI_CreateArenaMemoryZone(1024);
+  BOOST_REQUIRE(c != nullptr);
+  BOOST_CHECK_EQUAL(zid, TRI_MemoryZoneId(c));
+  BOOST_CHECK(TRI_MemoryZone(zid) == c);
+
+  TRI_FreeArenaMemoryZone(b);
+  TRI_FreeArenaMemoryZone(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test allocation, reallocation and freeing
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_allocate) {
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(1024);
+  BOOST_REQUIRE(zone != nullptr);
+
+  // zeroed memory
+  char* p = static_cast<char*>(TRI_Allocate(zone, 100, true));
+  BOOST_REQUIRE(p != nullptr);
+  BOOST_CHECK_EQUAL(0, (int) (reinterpret_cast<uintptr_t>(p) % 8));
+
+  for (size_t i = 0; i < 100; ++i) {
+    BOOST_CHECK_EQUAL(0, p[i]);
+  }
+
+  memset(p, 'a', 100);
+
+  // the most recent allocation grows in place
+  char* q = static_cast<char*>(TRI_Reallocate(zone, p, 200));
+  BOOST_CHECK(q == p);
+
+  // everything else is copied
+  char* r = static_cast<char*>(TRI_Allocate(zone, 10, false));
+  BOOST_REQUIRE(r != nullptr);
+  q = static_cast<char*>(TRI_Reallocate(zone, p, 300));
+  BOOST_REQUIRE(q != nullptr);
+  BOOST_CHECK(q != p);
+
+  for (size_t i = 0; i < 100; ++i) {
+    BOOST_CHECK_EQUAL('a', q[i]);
+  }
+
+  // freeing the most recent allocation gives it back
+  char* s = static_cast<char*>(TRI_Allocate(zone, 16, false));
+  TRI_Free(zone, s);
+  BOOST_CHECK(TRI_Allocate(zone, 16, false) == s);
+
+  // allocations larger than a block
+  char* big = static_cast<char*>(TRI_Allocate(zone, 100000, false));
+  BOOST_REQUIRE(big != nullptr);
+  memset(big, 'b', 100000);
+
+  for (size_t i = 0; i < 1000; ++i) {
+    BOOST_CHECK(TRI_Allocate(zone, 24, false) != nullptr);
+  }
+
+  TRI_ResetArenaMemoryZone(zone);
+
+  p = static_cast<char*>(TRI_Allocate(zone, 100, false));
+  BOOST_REQUIRE(p != nullptr);
+  memset(p, 'c', 100);
+
+  TRI_FreeArenaMemoryZone(zone);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test json in an arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json) {
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(256);
+  BOOST_REQUIRE(zone != nullptr);
+
+  for (int i = 0; i < 10; ++i) {
+    TRI_ResetArenaMemoryZone(zone);
+
+    TRI_json_t* json = TRI_JsonString(zone, "{\"a\":[1,2,3,4,5,6,7,8,9,10],\"b\":\"a long enough string value\",\"c\":{\"d\":null}}");
+    BOOST_REQUIRE(json != nullptr);
+
+    // grow a vector that lives in the arena
+    TRI_json_t* a = TRI_LookupObjectJson(json, "a");
+    BOOST_REQUIRE(a != nullptr);
+
+    for (int j = 0; j < 100; ++j) {
+      TRI_PushBack3ArrayJson(zone, a, TRI_CreateNumberJson(zone, (double) j));
+    }
+
+    BOOST_CHECK_EQUAL((size_t) 110, TRI_LengthArrayJson(a));
+
+    TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+    BOOST_REQUIRE(copy != nullptr);
+    BOOST_CHECK_EQUAL((size_t) 110, TRI_LengthArrayJson(TRI_LookupObjectJson(copy, "a")));
+    BOOST_CHECK_EQUAL(std::string("a long enough string value"), std::string(TRI_LookupObjectJson(copy, "b")->_value._string.data));
+
+    TRI_FreeJson(zone, json);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, copy);
+  }
+
+  TRI_FreeArenaMemoryZone(zone);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the accounting of the named zones
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_zone_usage) {
+  TRI_InitializeMemory();
+
+  BOOST_CHECK_EQUAL(std::string("cursors"), std::string(TRI_MemoryZoneName(TRI_CURSORS_MEM_ZONE_ID)));
+  BOOST_CHECK(TRI_NamedMemoryZone(TRI_QUERY_CACHE_MEM_ZONE_ID) == TRI_QUERY_CACHE_MEM_ZONE);
+
+  int64_t bytes, allocations;
+  int64_t bytesBefore, allocationsBefore;
+
+  TRI_FlushMemoryZoneUsage();
+  TRI_MemoryZoneUsage(TRI_CURSORS_MEM_ZONE_ID, &bytesBefore, &allocationsBefore);
+
+  TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, 100, 1);
+  TRI_FlushMemoryZoneUsage();
+  TRI_MemoryZoneUsage(TRI_CURSORS_MEM_ZONE_ID, &bytes, &allocations);
+
+  BOOST_CHECK_EQUAL(bytesBefore + 100, bytes);
+  BOOST_CHECK_EQUAL(allocationsBefore + 1, allocations);
+
+  TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, -100, -1);
+
+  // allocations are accounted with the size the allocator reserved
+  TRI_MemoryZoneUsage(TRI_QUERY_CACHE_MEM_ZONE_ID, &bytesBefore, &allocationsBefore);
+
+  void* p = TRI_Allocate(TRI_QUERY_CACHE_MEM_ZONE, 1000, false);
+  BOOST_REQUIRE(p != nullptr);
+
+  TRI_FlushMemoryZoneUsage();
+  TRI_MemoryZoneUsage(TRI_QUERY_CACHE_MEM_ZONE_ID, &bytes, &allocations);
+
+  BOOST_CHECK(bytes >= bytesBefore + 1000);
+  BOOST_CHECK_EQUAL(allocationsBefore + 1, allocations);
+
+  TRI_Free(TRI_QUERY_CACHE_MEM_ZONE, p);
+
+  TRI_FlushMemoryZoneUsage();
+  TRI_MemoryZoneUsage(TRI_QUERY_CACHE_MEM_ZONE_ID, &bytes, &allocations);
+
+  BOOST_CHECK_EQUAL(bytesBefore, bytes);
+  BOOST_CHECK_EQUAL(allocationsBefore, allocations);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
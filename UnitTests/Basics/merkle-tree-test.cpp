@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for MerkleTree
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/MerkleTree.h"
+#include "Basics/hashes.h"
+
+using namespace triagens::basics;
+
+static uint64_t KeyHash (uint64_t value) {
+  std::string const key = "test" + std::to_string(value);
+  return TRI_FnvHashString(key.c_str());
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CMerkleTreeSetup {
+  CMerkleTreeSetup () {
+    BOOST_TEST_MESSAGE("setup MerkleTree");
+  }
+
+  ~CMerkleTreeSetup () {
+    BOOST_TEST_MESSAGE("tear-down MerkleTree");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CMerkleTreeTest, CMerkleTreeSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that nodes sum up their children
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_nodes) {
+  MerkleTree tree(8);
+
+  BOOST_CHECK_EQUAL(8U, tree.depth());
+  BOOST_CHECK_EQUAL(0U, tree.count());
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    tree.insert(KeyHash(i), i + 1);
+  }
+
+  BOOST_CHECK_EQUAL(10000U, tree.count());
+
+  for (uint32_t level = 0; level < tree.depth(); ++level) {
+    for (uint64_t i = 0; i < (static_cast<uint64_t>(1) << level); ++i) {
+      auto const& parent = tree.node(level, i);
+      auto const& left = tree.node(level + 1, 2 * i);
+      auto const& right = tree.node(level + 1, 2 * i + 1);
+
+      BOOST_CHECK_EQUAL(parent._count, left._count + right._count);
+      BOOST_CHECK_EQUAL(parent._hash, left._hash ^ right._hash);
+    }
+  }
+
+  // the keys are spread over the leaves
+  size_t empty = 0;
+  for (uint64_t i = 0; i < 256; ++i) {
+    if (tree.node(8, i)._count == 0) {
+      ++empty;
+    }
+  }
+  BOOST_CHECK_EQUAL(0U, empty);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the tree does not depend on the order of operations
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_order) {
+  MerkleTree left(8);
+  MerkleTree right(8);
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    left.insert(KeyHash(i), 1);
+  }
+  for (uint64_t i = 0; i < 1000; ++i) {
+    left.remove(KeyHash(i), 1);
+    left.insert(KeyHash(i), 2);
+  }
+
+  for (uint64_t i = 1000; i > 0; --i) {
+    right.insert(KeyHash(i - 1), 2);
+  }
+
+  BOOST_CHECK(left.node(0, 0) == right.node(0, 0));
+
+  for (uint64_t i = 0; i < 256; ++i) {
+    BOOST_CHECK(left.node(8, i) == right.node(8, i));
+  }
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    left.remove(KeyHash(i), 2);
+  }
+
+  BOOST_CHECK_EQUAL(0U, left.count());
+  BOOST_CHECK_EQUAL(0U, left.node(0, 0)._hash);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that a differing revision is found in a single leaf
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_difference) {
+  MerkleTree left(10);
+  MerkleTree right(10);
+
+  for (uint64_t i = 0; i < 5000; ++i) {
+    left.insert(KeyHash(i), 1);
+    right.insert(KeyHash(i), (i == 1234 ? 2 : 1));
+  }
+
+  BOOST_CHECK(left.node(0, 0) != right.node(0, 0));
+  // the counts are equal, only the hashes differ
+  BOOST_CHECK_EQUAL(left.count(), right.count());
+
+  uint64_t const leaf = MerkleTree::bucket(10, KeyHash(1234));
+
+  for (uint64_t i = 0; i < 1024; ++i) {
+    BOOST_CHECK_EQUAL(i != leaf, left.node(10, i) == right.node(10, i));
+  }
+
+  // the path to the leaf differs on every level
+  for (uint32_t level = 0; level <= 10; ++level) {
+    uint64_t const node = MerkleTree::bucket(level, KeyHash(1234));
+
+    BOOST_CHECK_EQUAL(leaf >> (10 - level), node);
+    BOOST_CHECK(left.node(level, node) != right.node(level, node));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that trees of different depths agree on their common levels
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_depths) {
+  MerkleTree small(6);
+  MerkleTree large(12);
+
+  for (uint64_t i = 0; i < 3000; ++i) {
+    small.insert(KeyHash(i), i);
+    large.insert(KeyHash(i), i);
+  }
+
+  for (uint32_t level = 0; level <= 6; ++level) {
+    for (uint64_t i = 0; i < (static_cast<uint64_t>(1) << level); ++i) {
+      BOOST_CHECK(small.node(level, i) == large.node(level, i));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the depth for a number of entries
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_depth_for_count) {
+  BOOST_CHECK_EQUAL(MerkleTree::MinDepth, MerkleTree::depthForCount(0));
+  BOOST_CHECK_EQUAL(MerkleTree::MinDepth, MerkleTree::depthForCount(1000));
+  BOOST_CHECK_EQUAL(12U, MerkleTree::depthForCount(1000000));
+  BOOST_CHECK_EQUAL(MerkleTree::MaxDepth, MerkleTree::depthForCount(UINT64_MAX));
+
+  MerkleTree tree(MerkleTree::MinDepth);
+
+  for (uint64_t i = 0; i < 65536; ++i) {
+    tree.insert(KeyHash(i), 1);
+  }
+  BOOST_CHECK(! tree.isOverfull());
+
+  tree.insert(KeyHash(65536), 1);
+  BOOST_CHECK(tree.isOverfull());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
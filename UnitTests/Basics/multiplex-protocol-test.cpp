@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for the multiplexed binary protocol
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/StringBuffer.h"
+#include "Rest/MultiplexProtocol.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+typedef MultiplexProtocol::Header Header;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CMultiplexProtocolSetup {
+  CMultiplexProtocolSetup () {
+    BOOST_TEST_MESSAGE("setup MultiplexProtocol");
+  }
+
+  ~CMultiplexProtocolSetup () {
+    BOOST_TEST_MESSAGE("tear-down MultiplexProtocol");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CMultiplexProtocolTest, CMultiplexProtocolSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test frame headers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_frame_header) {
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+
+  MultiplexProtocol::appendFrameHeader(&buffer,
+                                       0x012345,
+                                       MultiplexProtocol::FRAME_HEADERS,
+                                       MultiplexProtocol::FLAG_END_HEADERS | MultiplexProtocol::FLAG_END_STREAM,
+                                       0x7654321);
+
+  BOOST_CHECK_EQUAL(MultiplexProtocol::FrameHeaderSize, buffer.length());
+  BOOST_CHECK_EQUAL(std::string("\x01\x23\x45\x01\x05\x07\x65\x43\x21", 9), std::string(buffer.c_str(), buffer.length()));
+
+  MultiplexProtocol::FrameHeader header;
+  MultiplexProtocol::parseFrameHeader(buffer.c_str(), header);
+
+  BOOST_CHECK_EQUAL(0x012345U, header._length);
+  BOOST_CHECK_EQUAL((int) MultiplexProtocol::FRAME_HEADERS, (int) header._type);
+  BOOST_CHECK_EQUAL(0x05, (int) header._flags);
+  BOOST_CHECK_EQUAL(0x7654321U, header._streamId);
+
+  // the reserved bit of the stream id is ignored
+  char const raw[] = "\x00\x00\x00\x00\x00\xff\xff\xff\xff";
+  MultiplexProtocol::parseFrameHeader(raw, header);
+  BOOST_CHECK_EQUAL(0x7fffffffU, header._streamId);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test decoding a header block of the HPACK specification
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_decode_request) {
+  MultiplexHeaderDecoder decoder;
+  std::vector<Header> headers;
+
+  // RFC 7541, C.3.1
+  std::string const first("\x82\x86\x84\x41\x0f" "www.example.com");
+
+  BOOST_CHECK(decoder.decode(first.c_str(), first.size(), 65536, headers));
+  BOOST_CHECK_EQUAL(4U, headers.size());
+  BOOST_CHECK_EQUAL(":method", headers[0].first);
+  BOOST_CHECK_EQUAL("GET", headers[0].second);
+  BOOST_CHECK_EQUAL(":scheme", headers[1].first);
+  BOOST_CHECK_EQUAL("http", headers[1].second);
+  BOOST_CHECK_EQUAL(":path", headers[2].first);
+  BOOST_CHECK_EQUAL("/", headers[2].second);
+  BOOST_CHECK_EQUAL(":authority", headers[3].first);
+  BOOST_CHECK_EQUAL("www.example.com", headers[3].second);
+
+  // RFC 7541, C.3.2, uses the dynamic table entry of the first block
+  std::string const second("\x82\x86\x84\xbe\x58\x08" "no-cache");
+
+  headers.clear();
+  BOOST_CHECK(decoder.decode(second.c_str(), second.size(), 65536, headers));
+  BOOST_CHECK_EQUAL(5U, headers.size());
+  BOOST_CHECK_EQUAL(":authority", headers[3].first);
+  BOOST_CHECK_EQUAL("www.example.com", headers[3].second);
+  BOOST_CHECK_EQUAL("cache-control", headers[4].first);
+  BOOST_CHECK_EQUAL("no-cache", headers[4].second);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test malformed header blocks
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_decode_invalid) {
+  std::vector<Header> headers;
+
+  // index 0
+  {
+    MultiplexHeaderDecoder decoder;
+    BOOST_CHECK(! decoder.decode("\x80", 1, 65536, headers));
+  }
+
+  // index beyond the tables
+  {
+    MultiplexHeaderDecoder decoder;
+    BOOST_CHECK(! decoder.decode("\xbe", 1, 65536, headers));
+  }
+
+  // truncated string
+  {
+    MultiplexHeaderDecoder decoder;
+    BOOST_CHECK(! decoder.decode("\x40\x05" "abc", 5, 65536, headers));
+  }
+
+  // huffman coded strings are not supported
+  {
+    MultiplexHeaderDecoder decoder;
+    BOOST_CHECK(! decoder.decode("\x40\x81" "a" "\x01" "b", 5, 65536, headers));
+  }
+
+  // table size update beyond the announced size
+  {
+    MultiplexHeaderDecoder decoder;
+    BOOST_CHECK(! decoder.decode("\x3f\xe2\x1f", 3, 65536, headers));
+  }
+
+  // headers too large
+  {
+    MultiplexHeaderDecoder decoder;
+    std::string const block("\x82\x86\x84\x41\x0f" "www.example.com");
+    BOOST_CHECK(! decoder.decode(block.c_str(), block.size(), 16, headers));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test encoding and decoding
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_roundtrip) {
+  MultiplexHeaderEncoder encoder;
+  MultiplexHeaderDecoder decoder;
+
+  std::vector<Header> headers;
+  headers.emplace_back(":status", "200");
+  headers.emplace_back("content-type", "application/json; charset=utf-8");
+  headers.emplace_back("server", "ArangoDB");
+  headers.emplace_back("content-length", "1234");
+  headers.emplace_back("x-arango-long", std::string(1000, 'x'));
+
+  size_t firstSize = 0;
+
+  for (size_t i = 0; i < 3; ++i) {
+    StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+    encoder.encode(headers, &buffer);
+
+    if (i == 0) {
+      firstSize = buffer.length();
+    }
+    else {
+      // repeated headers are sent as indexes
+      BOOST_CHECK(buffer.length() < firstSize);
+    }
+
+    std::vector<Header> decoded;
+    BOOST_CHECK(decoder.decode(buffer.c_str(), buffer.length(), 65536, decoded));
+    BOOST_CHECK(headers == decoded);
+  }
+
+  // a smaller table is signaled to the decoder
+  encoder.setMaxTableSize(64);
+
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+  encoder.encode(headers, &buffer);
+
+  std::vector<Header> decoded;
+  BOOST_CHECK(decoder.decode(buffer.c_str(), buffer.length(), 65536, decoded));
+  BOOST_CHECK(headers == decoded);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_table_eviction) {
+  MultiplexHeaderTable table;
+  bool exact;
+
+  BOOST_CHECK_EQUAL(":authority", table.lookup(1)->first);
+  BOOST_CHECK_EQUAL("www-authenticate", table.lookup(61)->first);
+  BOOST_CHECK(table.lookup(0) == nullptr);
+  BOOST_CHECK(table.lookup(62) == nullptr);
+
+  BOOST_CHECK_EQUAL(2U, table.find(":method", "GET", exact));
+  BOOST_CHECK(exact);
+
+  table.setMaxSize(100);
+
+  // an entry costs 32 bytes more than its name and value
+  table.add("a", "12345678901234567");
+  BOOST_CHECK_EQUAL(50U, table.size());
+  table.add("b", "12345678901234567");
+  BOOST_CHECK_EQUAL(100U, table.size());
+
+  // newest first
+  BOOST_CHECK_EQUAL("b", table.lookup(62)->first);
+  BOOST_CHECK_EQUAL("a", table.lookup(63)->first);
+
+  table.add("c", "12345678901234567");
+  BOOST_CHECK_EQUAL(100U, table.size());
+  BOOST_CHECK_EQUAL("c", table.lookup(62)->first);
+  BOOST_CHECK_EQUAL("b", table.lookup(63)->first);
+  BOOST_CHECK(table.lookup(64) == nullptr);
+
+  BOOST_CHECK_EQUAL(0U, table.find("a", "12345678901234567", exact));
+  BOOST_CHECK_EQUAL(63U, table.find("b", "other", exact));
+  BOOST_CHECK(! exact);
+
+  // an entry larger than the table empties it
+  table.add("d", std::string(200, 'd'));
+  BOOST_CHECK_EQUAL(0U, table.size());
+  BOOST_CHECK(table.lookup(62) == nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for PathFinder
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/Traverser.h"
+#include "Basics/voc-errors.h"
+
+#include <cstdlib>
+#include <vector>
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test graph
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a vertex of the test graph. cid is the number of the vertex plus 1
+////////////////////////////////////////////////////////////////////////////////
+
+struct GridVertex {
+  uint64_t    cid;
+  char const* key;
+
+  GridVertex ()
+    : cid(0),
+      key("") {
+  }
+
+  GridVertex (uint64_t cid, char const* key)
+    : cid(cid), key(key) {
+  }
+};
+
+namespace std {
+  template<>
+  struct hash<GridVertex> {
+    size_t operator() (GridVertex const& v) const {
+      return std::hash<uint64_t>()(v.cid);
+    }
+  };
+
+  template<>
+  struct equal_to<GridVertex> {
+    bool operator() (GridVertex const& a, GridVertex const& b) const {
+      return a.cid == b.cid && strcmp(a.key, b.key) == 0;
+    }
+  };
+}
+
+typedef triagens::basics::PathFinder<GridVertex, std::string, double> GridPathFinder;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an undirected grid of Size x Size vertices. the weight of an edge
+/// is 1, 2 or 3, and the last vertex has no edges at all
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const Size = 30;
+
+static std::vector<std::string> Keys;
+
+static GridVertex Vertex (size_t row, size_t column) {
+  size_t const n = row * Size + column;
+
+  if (Keys.empty()) {
+    for (size_t i = 0; i < Size * Size; ++i) {
+      Keys.emplace_back("v" + std::to_string(i));
+    }
+  }
+
+  return GridVertex(n + 1, Keys[n].c_str());
+}
+
+static void Expand (GridVertex& vertex,
+                    std::vector<GridPathFinder::Step>& result) {
+  size_t const n = vertex.cid - 1;
+  size_t const row = n / Size;
+  size_t const column = n % Size;
+
+  auto add = [&] (size_t r, size_t c) {
+    GridVertex neighbor = Vertex(r, c);
+
+    if (neighbor.cid == Size * Size || vertex.cid == Size * Size) {
+      // the isolated vertex
+      return;
+    }
+
+    std::string edge = std::to_string(std::min(n, neighbor.cid - 1)) + "-" +
+                       std::to_string(std::max(n, neighbor.cid - 1));
+    double weight = static_cast<double>(1 + (n + neighbor.cid - 1) % 3);
+    result.emplace_back(neighbor, vertex, weight, edge);
+  };
+
+  if (row > 0) {
+    add(row - 1, column);
+  }
+  if (row + 1 < Size) {
+    add(row + 1, column);
+  }
+  if (column > 0) {
+    add(row, column - 1);
+  }
+  if (column + 1 < Size) {
+    add(row, column + 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks that a path is connected and sums up its weight
+////////////////////////////////////////////////////////////////////////////////
+
+static double CheckPath (GridPathFinder::Path const* path,
+                         GridVertex const& start,
+                         GridVertex const& target) {
+  BOOST_REQUIRE(path != nullptr);
+  BOOST_REQUIRE_EQUAL(path->vertices.size(), path->edges.size() + 1);
+  BOOST_CHECK_EQUAL(start.cid, path->vertices.front().cid);
+  BOOST_CHECK_EQUAL(target.cid, path->vertices.back().cid);
+
+  double weight = 0.0;
+
+  for (size_t i = 0; i < path->edges.size(); ++i) {
+    size_t const a = path->vertices[i].cid - 1;
+    size_t const b = path->vertices[i + 1].cid - 1;
+    size_t const diff = (a > b ? a - b : b - a);
+
+    BOOST_CHECK(diff == 1 || diff == Size);
+    weight += static_cast<double>(1 + (a + b) % 3);
+  }
+
+  BOOST_CHECK_EQUAL(weight, path->weight);
+  return weight;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CShortestPathSetup {
+  CShortestPathSetup () {
+    BOOST_TEST_MESSAGE("setup PathFinder");
+  }
+
+  ~CShortestPathSetup () {
+    BOOST_TEST_MESSAGE("tear-down PathFinder");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CShortestPathTest, CShortestPathSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that all searches find a path of the same weight
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_same_weight) {
+  GridPathFinder finder(Expand, Expand);
+
+  for (size_t i = 0; i < 5; ++i) {
+    GridVertex start = Vertex(i * 3, i);
+    GridVertex target = Vertex(Size - 1 - i, Size - 2 - i * 4);
+
+    std::unique_ptr<GridPathFinder::Path> dijkstra(finder.shortestPath(start, target));
+    double const weight = CheckPath(dijkstra.get(), start, target);
+
+    std::unique_ptr<GridPathFinder::Path> threads(finder.shortestPathTwoThreads(start, target));
+    BOOST_CHECK_EQUAL(weight, CheckPath(threads.get(), start, target));
+
+    // the manhattan distance, every edge weighs at least 1
+    auto heuristic = [&target] (GridVertex const& v) -> double {
+      long const a = static_cast<long>(v.cid - 1);
+      long const b = static_cast<long>(target.cid - 1);
+      long const size = static_cast<long>(Size);
+      return static_cast<double>(std::labs(a / size - b / size) + std::labs(a % size - b % size));
+    };
+
+    std::unique_ptr<GridPathFinder::Path> astar(finder.shortestPathAStar(start, target, heuristic));
+    BOOST_CHECK_EQUAL(weight, CheckPath(astar.get(), start, target));
+
+    auto zero = [] (GridVertex const&) -> double {
+      return 0.0;
+    };
+
+    std::unique_ptr<GridPathFinder::Path> plain(finder.shortestPathAStar(start, target, zero));
+    BOOST_CHECK_EQUAL(weight, CheckPath(plain.get(), start, target));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the path from a vertex to itself
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_same_vertex) {
+  GridPathFinder finder(Expand, Expand);
+  GridVertex start = Vertex(3, 4);
+
+  auto zero = [] (GridVertex const&) -> double {
+    return 0.0;
+  };
+
+  std::unique_ptr<GridPathFinder::Path> astar(finder.shortestPathAStar(start, start, zero));
+  BOOST_REQUIRE(astar != nullptr);
+  BOOST_CHECK_EQUAL(1U, astar->vertices.size());
+  BOOST_CHECK_EQUAL(0U, astar->edges.size());
+  BOOST_CHECK_EQUAL(0.0, astar->weight);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that no path is found to an unconnected vertex
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_no_path) {
+  GridPathFinder finder(Expand, Expand);
+  GridVertex start = Vertex(0, 0);
+  GridVertex target = Vertex(Size - 1, Size - 1);
+
+  auto zero = [] (GridVertex const&) -> double {
+    return 0.0;
+  };
+
+  std::unique_ptr<GridPathFinder::Path> dijkstra(finder.shortestPath(start, target));
+  BOOST_CHECK(dijkstra == nullptr);
+
+  std::unique_ptr<GridPathFinder::Path> threads(finder.shortestPathTwoThreads(start, target));
+  BOOST_CHECK(threads == nullptr);
+
+  std::unique_ptr<GridPathFinder::Path> astar(finder.shortestPathAStar(start, target, zero));
+  BOOST_CHECK(astar == nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
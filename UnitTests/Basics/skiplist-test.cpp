@@ -60,6 +60,12 @@ static int CmpKeyElm (void const* left,
 static void FreeElm (void* e) {
 }
 
+static int NumFreed = 0;
+
+static void CountingFreeElm (void* e) {
+  ++NumFreed;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 setup / tear-down
 // -----------------------------------------------------------------------------
@@ -437,6 +443,65 @@ BOOST_AUTO_TEST_CASE (tst_unique_remove_all) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that removed nodes are only freed when no reader is active
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_deferred_free) {
+  NumFreed = 0;
+
+  {
+    triagens::basics::SkipList<void, void> skiplist(CmpElmElm, CmpKeyElm, CountingFreeElm, true, false);
+  
+    std::vector<int*> values; 
+    for (int i = 0; i < 10; ++i) {
+      values.push_back(new int(i));
+    }
+  
+    for (int i = 0; i < 10; ++i) {
+      skiplist.insert(values[i]);
+    }
+
+    // nothing removed yet
+    BOOST_CHECK_EQUAL(0, (int) skiplist.reclaim());
+
+    {
+      auto guard(skiplist.readProtect());
+
+      auto node = skiplist.lookup(values[4]);
+      BOOST_CHECK(node != nullptr);
+
+      for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK_EQUAL(0, skiplist.remove(values[i]));
+      }
+      BOOST_CHECK_EQUAL(5, (int) skiplist.getNrUsed());
+      BOOST_CHECK_EQUAL(0, NumFreed);
+
+      // a reader is still active
+      BOOST_CHECK_EQUAL(0, (int) skiplist.reclaim());
+      BOOST_CHECK_EQUAL(0, NumFreed);
+
+      // the removed node is still valid and leads back into the list
+      BOOST_CHECK_EQUAL(values[4], node->document());
+      BOOST_CHECK_EQUAL(values[5], node->nextNode()->document());
+    }
+
+    BOOST_CHECK_EQUAL(5, (int) skiplist.reclaim());
+    BOOST_CHECK_EQUAL(5, NumFreed);
+    BOOST_CHECK_EQUAL(0, (int) skiplist.reclaim());
+
+    BOOST_CHECK_EQUAL(values[5], skiplist.startNode()->nextNode()->document());
+  
+    // clean up
+    for (auto i : values) {
+      delete i;
+    }
+  }
+
+  // the remaining documents are freed by the destructor
+  BOOST_CHECK_EQUAL(10, NumFreed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for StatisticsHistogram
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <boost/test/unit_test.hpp>
+
+#include "Statistics/figures.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CStatisticsHistogramSetup {
+  CStatisticsHistogramSetup () {
+    BOOST_TEST_MESSAGE("setup StatisticsHistogram");
+  }
+
+  ~CStatisticsHistogramSetup () {
+    BOOST_TEST_MESSAGE("tear-down StatisticsHistogram");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CStatisticsHistogramTest, CStatisticsHistogramSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that the buckets cover all values without gaps
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_buckets) {
+  BOOST_CHECK_EQUAL(0U, StatisticsHistogram::bucket(0));
+  BOOST_CHECK_EQUAL(63U, StatisticsHistogram::bucket(63));
+  BOOST_CHECK_EQUAL(64U, StatisticsHistogram::bucket(64));
+  BOOST_CHECK_EQUAL(64U, StatisticsHistogram::bucket(65));
+  BOOST_CHECK_EQUAL(StatisticsHistogram::NumBuckets - 1, StatisticsHistogram::bucket(UINT64_MAX));
+
+  BOOST_CHECK_EQUAL(0U, StatisticsHistogram::lowerBound(0));
+
+  for (size_t i = 0; i + 1 < StatisticsHistogram::NumBuckets; ++i) {
+    uint64_t const lower = StatisticsHistogram::lowerBound(i);
+    uint64_t const upper = StatisticsHistogram::upperBound(i);
+
+    BOOST_CHECK(lower <= upper);
+    BOOST_CHECK_EQUAL(upper + 1, StatisticsHistogram::lowerBound(i + 1));
+    BOOST_CHECK_EQUAL(i, StatisticsHistogram::bucket(lower));
+    BOOST_CHECK_EQUAL(i, StatisticsHistogram::bucket(upper));
+
+    // a bucket is at most 1/32 of its values wide
+    BOOST_CHECK((upper - lower) * 32 <= lower);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the percentiles of a uniform distribution
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_percentiles) {
+  StatisticsHistogram histogram;
+
+  BOOST_CHECK_EQUAL(0U, histogram.percentile(0.5));
+
+  for (uint64_t i = 1; i <= 100000; ++i) {
+    histogram.addFigure(i);
+  }
+
+  BOOST_CHECK_EQUAL(100000U, histogram._count);
+  BOOST_CHECK_EQUAL(1U, histogram._min);
+  BOOST_CHECK_EQUAL(100000U, histogram._max);
+
+  double const fractions[] = { 0.5, 0.9, 0.99, 0.999 };
+
+  for (auto fraction : fractions) {
+    double const expected = fraction * 100000.0;
+    double const actual = static_cast<double>(histogram.percentile(fraction));
+
+    BOOST_CHECK(std::abs(actual - expected) <= expected * 0.03);
+  }
+
+  // the results never leave the range of the values added
+  BOOST_CHECK(histogram.percentile(1.0) <= 100000U);
+  BOOST_CHECK(histogram.percentile(1.0) >= 97000U);
+  BOOST_CHECK_EQUAL(1U, histogram.percentile(0.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that merged histograms equal a single one
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_merge) {
+  StatisticsHistogram single;
+  StatisticsHistogram left;
+  StatisticsHistogram right;
+
+  for (uint64_t i = 0; i < 10000; ++i) {
+    uint64_t const value = (i * 7919) % 1000000;
+
+    single.addFigure(value);
+    (i % 2 == 0 ? left : right).addFigure(value);
+  }
+
+  StatisticsHistogram merged;
+  merged.merge(left);
+  merged.merge(right);
+
+  BOOST_CHECK_EQUAL(single._count, merged._count);
+  BOOST_CHECK_EQUAL(single._total, merged._total);
+  BOOST_CHECK_EQUAL(single._min, merged._min);
+  BOOST_CHECK_EQUAL(single._max, merged._max);
+  BOOST_CHECK(single._counts == merged._counts);
+  BOOST_CHECK_EQUAL(single.percentile(0.99), merged.percentile(0.99));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -691,6 +691,103 @@ BOOST_AUTO_TEST_CASE (tst_doubles) {
   TRI_AppendDoubleStringBuffer(&sb, value);
   BOOST_CHECK_EQUAL("-3575783498001355400000", sb._buffer);
 
+  // integral values
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, 0.0);
+  BOOST_CHECK_EQUAL("0", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, -0.0);
+  BOOST_CHECK_EQUAL("-0", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, -12345678.0);
+  BOOST_CHECK_EQUAL("-12345678", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, 99999999.0);
+  BOOST_CHECK_EQUAL("99999999", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, 100000000.0);
+  BOOST_CHECK_EQUAL("1e+8", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendDoubleStringBuffer(&sb, 42.5);
+  BOOST_CHECK_EQUAL("42.5", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_DestroyStringBuffer(&sb);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tst_json_encoded
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_json_encoded) {
+  TRI_string_buffer_t sb;
+
+  TRI_InitStringBuffer(&sb, TRI_CORE_MEM_ZONE);
+
+  // long runs of plain characters around escaped ones
+  std::string const plain("the quick brown fox jumped over the lazy dog");
+  std::string const value = plain + "\"/\\\n\t" + plain + "\x01" + plain;
+
+  TRI_AppendJsonEncodedStringStringBuffer(&sb, value.c_str(), value.size(), false);
+  BOOST_CHECK_EQUAL(plain + "\\\"/\\\\\\n\\t" + plain + "\\u0001" + plain, std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendJsonEncodedStringStringBuffer(&sb, value.c_str(), true);
+  BOOST_CHECK_EQUAL(plain + "\\\"\\/\\\\\\n\\t" + plain + "\\u0001" + plain, std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  // multi-byte characters are escaped
+  TRI_ClearStringBuffer(&sb);
+  TRI_AppendJsonEncodedStringStringBuffer(&sb, "0123456789abcdef\xc3\xa4", false);
+  BOOST_CHECK_EQUAL("0123456789abcdef\\u00E4", std::string(sb._buffer, TRI_LengthStringBuffer(&sb)));
+
+  TRI_DestroyStringBuffer(&sb);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tst_reserve_growth
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_reserve_growth) {
+  TRI_string_buffer_t sb;
+
+  // a size hint is allocated exactly
+  TRI_InitSizedStringBuffer(&sb, TRI_CORE_MEM_ZONE, 1000);
+  BOOST_CHECK_EQUAL(1000, (int) sb._len);
+
+  TRI_AppendStringStringBuffer(&sb, "foo");
+  TRI_ReserveStringBuffer(&sb, 997);
+  BOOST_CHECK_EQUAL(1000, (int) sb._len);
+
+  // growing takes at least half of the capacity more
+  TRI_ReserveStringBuffer(&sb, 998);
+  BOOST_CHECK_EQUAL(1500, (int) sb._len);
+
+  TRI_ReserveStringBuffer(&sb, 5000);
+  BOOST_CHECK_EQUAL(5003, (int) sb._len);
+
+  // the contents survive, and the rest is zeroed
+  BOOST_CHECK_EQUAL("foo", sb._buffer);
+  BOOST_CHECK_EQUAL(0, (int) sb._buffer[4999]);
+
+  size_t reallocations = 0;
+  char const* buffer = sb._buffer;
+
+  for (int i = 0; i < 100000; ++i) {
+    TRI_AppendCharStringBuffer(&sb, 'x');
+
+    if (sb._buffer != buffer) {
+      buffer = sb._buffer;
+      ++reallocations;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(100003, (int) TRI_LengthStringBuffer(&sb));
+  BOOST_CHECK(reallocations <= 8);
+
   TRI_DestroyStringBuffer(&sb);
 }
 
@@ -225,6 +225,69 @@ BOOST_AUTO_TEST_CASE (tst_5) {
   BOOST_CHECK(words == NULL);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test the ASCII fast paths
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_6) {
+  triagens::basics::Utf8Helper helper("en");
+
+  BOOST_CHECK_EQUAL("hello world 42 ab-cd", helper.toLowerCase("Hello WORLD 42 aB-Cd"));
+  BOOST_CHECK_EQUAL("HELLO WORLD 42 AB-CD", helper.toUpperCase("Hello world 42 aB-Cd"));
+  BOOST_CHECK_EQUAL("abcdefghijklmnopqrstuvwxyz0123456789", helper.toLowerCase("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"));
+  BOOST_CHECK_EQUAL("ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789", helper.toUpperCase("abcdefghijklmnopqrstuvwxyz0123456789"));
+
+  // the ASCII comparison must agree with the collator
+  std::vector<std::string> const values = {
+    "a", "A", "b", "B", "ab", "aB", "Ab", "a b", "a-b", "a_b", "a1", "a10", "a9",
+    "abc", "ABC", "abC", " a", "\t", "zebra", "Zebra", "customer-1", "customer-10",
+    "some/path/file.txt", "some/path/File.txt", "x\x01y", "xy"
+  };
+
+  for (auto const& left : values) {
+    UChar* l16;
+    size_t l16Length;
+    l16 = TRI_Utf8ToUChar(TRI_UNKNOWN_MEM_ZONE, left.c_str(), left.size(), &l16Length);
+
+    for (auto const& right : values) {
+      UChar* r16;
+      size_t r16Length;
+      r16 = TRI_Utf8ToUChar(TRI_UNKNOWN_MEM_ZONE, right.c_str(), right.size(), &r16Length);
+
+      int expected = helper.compareUtf16((uint16_t const*) l16, l16Length, (uint16_t const*) r16, r16Length);
+      BOOST_CHECK_EQUAL(expected, helper.compareUtf8(left.c_str(), left.size(), right.c_str(), right.size()));
+      BOOST_CHECK_EQUAL(expected, helper.compareUtf8(left.c_str(), right.c_str()));
+
+      if (r16 != nullptr) {
+        TRI_Free(TRI_UNKNOWN_MEM_ZONE, r16);
+      }
+    }
+
+    if (l16 != nullptr) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, l16);
+    }
+  }
+
+  BOOST_CHECK(helper.compareUtf8("", 0, "\t", 1) < 0);
+  BOOST_CHECK(helper.compareUtf8("a", 1, "B", 1) < 0);
+  BOOST_CHECK(helper.compareUtf8("A", 1, "a", 1) < 0);
+  BOOST_CHECK(helper.compareUtf8("a", 1, "ab", 2) < 0);
+  BOOST_CHECK_EQUAL(0, helper.compareUtf8("abc", 3, "abc", 3));
+
+  // ASCII text is in NFC already
+  size_t length;
+  char* result = TRI_normalize_utf8_to_NFC(TRI_UNKNOWN_MEM_ZONE, "plain text", 10, &length);
+  BOOST_CHECK_EQUAL((size_t) 10, length);
+  BOOST_CHECK_EQUAL("plain text", result);
+  TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, result);
+
+  uint16_t const utf16[] = { 'p', 'l', 'a', 'i', 'n' };
+  result = TRI_normalize_utf16_to_NFC(TRI_UNKNOWN_MEM_ZONE, utf16, 5, &length);
+  BOOST_CHECK_EQUAL((size_t) 5, length);
+  BOOST_CHECK_EQUAL("plain", result);
+  TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, result);
+}
+
 BOOST_AUTO_TEST_SUITE_END ()
 
 // Local Variables:
@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test suite for TimerWheel
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include "Basics/TimerWheel.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 setup / tear-down
+// -----------------------------------------------------------------------------
+
+struct CTimerWheelSetup {
+  CTimerWheelSetup () {
+    BOOST_TEST_MESSAGE("setup TimerWheel");
+  }
+
+  ~CTimerWheelSetup () {
+    BOOST_TEST_MESSAGE("tear-down TimerWheel");
+  }
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        test suite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief setup
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE(CTimerWheelTest, CTimerWheelSetup)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that timers expire at their tick, on all levels
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_expiry) {
+  TimerWheel wheel(1000);
+
+  std::vector<uint64_t> const delays = { 1, 2, 255, 256, 257, 1000, 65535, 65536, 65537,
+                                         1000000, 16777216, 20000000 };
+  std::vector<TimerWheel::Timer> timers(delays.size());
+
+  for (size_t i = 0; i < delays.size(); ++i) {
+    timers[i].setData(&timers[i]);
+    wheel.insert(&timers[i], 1000 + delays[i]);
+  }
+
+  BOOST_CHECK_EQUAL(delays.size(), wheel.size());
+
+  std::vector<std::pair<uint64_t, uint64_t>> expired;
+
+  // advance in uneven steps
+  uint64_t now = 1000;
+
+  while (! wheel.empty()) {
+    uint64_t next = wheel.nextExpiry();
+    BOOST_CHECK(next > now);
+
+    now += 7777;
+
+    if (next < now) {
+      now = next;
+    }
+
+    wheel.advance(now, [&] (TimerWheel::Timer* timer) {
+      BOOST_CHECK(! timer->isActive());
+      BOOST_CHECK(timer->data() == timer);
+      expired.emplace_back(timer->expires(), now);
+    });
+  }
+
+  BOOST_CHECK_EQUAL(delays.size(), expired.size());
+
+  for (size_t i = 0; i < expired.size(); ++i) {
+    BOOST_CHECK_EQUAL(1000 + delays[i], expired[i].first);
+    // nextExpiry() never lets a timer expire late
+    BOOST_CHECK_EQUAL(expired[i].first, expired[i].second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test removing and moving timers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_remove) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Timer> timers(1000);
+
+  for (size_t i = 0; i < timers.size(); ++i) {
+    wheel.insert(&timers[i], 1 + i * 97);
+  }
+
+  BOOST_CHECK_EQUAL(1000U, wheel.size());
+
+  // remove the even ones, and move every third one far out
+  for (size_t i = 0; i < timers.size(); i += 2) {
+    wheel.remove(&timers[i]);
+    BOOST_CHECK(! timers[i].isActive());
+  }
+
+  for (size_t i = 1; i < timers.size(); i += 6) {
+    wheel.insert(&timers[i], 10000000);
+  }
+
+  BOOST_CHECK_EQUAL(500U, wheel.size());
+
+  size_t count = 0;
+  wheel.advance(9999999, [&] (TimerWheel::Timer* timer) {
+    size_t const i = timer - timers.data();
+    BOOST_CHECK(i % 2 == 1);
+    BOOST_CHECK(i % 6 != 1);
+    ++count;
+  });
+
+  BOOST_CHECK_EQUAL(500U - 167U, count);
+  BOOST_CHECK_EQUAL(167U, wheel.size());
+
+  count = 0;
+  wheel.advance(10000000, [&] (TimerWheel::Timer*) {
+    ++count;
+  });
+
+  BOOST_CHECK_EQUAL(167U, count);
+  BOOST_CHECK(wheel.empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test that callbacks can reinsert and remove timers
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_callbacks) {
+  TimerWheel wheel;
+  TimerWheel::Timer a;
+  TimerWheel::Timer b;
+
+  wheel.insert(&a, 10);
+  wheel.insert(&b, 10);
+
+  size_t fired = 0;
+
+  // a repeats every 10 ticks, and removes b when it fires first
+  auto callback = [&] (TimerWheel::Timer* timer) {
+    ++fired;
+    BOOST_CHECK(timer == &a);
+    wheel.remove(&b);
+    wheel.insert(&a, wheel.now() + 10);
+  };
+
+  BOOST_CHECK_EQUAL(1U, wheel.advance(10, callback));
+  BOOST_CHECK_EQUAL(1U, wheel.size());
+  BOOST_CHECK_EQUAL(20U, a.expires());
+
+  // a timer inserted in the past expires with the next tick
+  wheel.insert(&b, 5);
+  BOOST_CHECK_EQUAL(11U, b.expires());
+  wheel.remove(&b);
+
+  BOOST_CHECK_EQUAL(100U, wheel.advance(1010, callback));
+  BOOST_CHECK_EQUAL(101U, fired);
+
+  wheel.remove(&a);
+  BOOST_CHECK(wheel.empty());
+  BOOST_CHECK_EQUAL(UINT64_MAX, wheel.nextExpiry());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief test timers beyond the reach of the wheel
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE (tst_far) {
+  TimerWheel wheel;
+  TimerWheel::Timer timer;
+
+  uint64_t const expires = TimerWheel::Reach * 2 + 12345;
+  wheel.insert(&timer, expires);
+
+  size_t count = 0;
+  wheel.advance(expires - 1, [&] (TimerWheel::Timer*) {
+    ++count;
+  });
+
+  BOOST_CHECK_EQUAL(0U, count);
+  BOOST_CHECK(timer.isActive());
+
+  wheel.advance(expires, [&] (TimerWheel::Timer* t) {
+    BOOST_CHECK(t == &timer);
+    ++count;
+  });
+
+  BOOST_CHECK_EQUAL(1U, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generate tests
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END ()
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
@@ -0,0 +1,639 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief micro benchmarks for the core data structures
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "Basics/AssocMulti.h"
+#include "Basics/AssocUnique.h"
+#include "Basics/SkipList.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/init.h"
+#include "Basics/json.h"
+#include "Basics/random.h"
+#include "Basics/string-buffer.h"
+#include "Basics/voc-errors.h"
+
+using namespace std;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of runs of a benchmark, the fastest one is reported
+////////////////////////////////////////////////////////////////////////////////
+
+static int const NumRuns = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplies the number of items of all benchmarks
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t Scale = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief only benchmarks whose name contains this are run
+////////////////////////////////////////////////////////////////////////////////
+
+static string Filter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief nanoseconds per item of an earlier run, by benchmark name
+////////////////////////////////////////////////////////////////////////////////
+
+static unordered_map<string, double> Baseline;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief how much slower than the baseline a benchmark may be, 0.2 = 20%
+////////////////////////////////////////////////////////////////////////////////
+
+static double Tolerance = 0.2;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of benchmarks slower than the baseline
+////////////////////////////////////////////////////////////////////////////////
+
+static int NumRegressions = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keeps the compiler from optimizing results away
+////////////////////////////////////////////////////////////////////////////////
+
+static volatile uint64_t Sink = 0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs a benchmark and prints its result as one line of JSON
+///
+/// setup prepares a run and is not measured, the body performs the given
+/// number of items. the fastest of NumRuns runs is reported
+////////////////////////////////////////////////////////////////////////////////
+
+static void Run (char const* name,
+                 uint64_t items,
+                 std::function<void()> const& setup,
+                 std::function<void()> const& body,
+                 std::function<void()> const& teardown) {
+  if (! Filter.empty() && strstr(name, Filter.c_str()) == nullptr) {
+    return;
+  }
+
+  double best = 0.0;
+
+  for (int run = 0; run < NumRuns; ++run) {
+    setup();
+
+    double const start = TRI_microtime();
+    body();
+    double const time = TRI_microtime() - start;
+
+    teardown();
+
+    if (run == 0 || time < best) {
+      best = time;
+    }
+  }
+
+  double const nsPerItem = (items > 0 ? best * 1000000000.0 / (double) items : 0.0);
+
+  char buffer[512];
+  int length = snprintf(buffer, sizeof(buffer),
+                        "{\"benchmark\":\"%s\",\"items\":%llu,\"runs\":%d,\"seconds\":%.6f,\"itemsPerSecond\":%.1f,\"nsPerItem\":%.2f",
+                        name,
+                        (unsigned long long) items,
+                        NumRuns,
+                        best,
+                        best > 0.0 ? (double) items / best : 0.0,
+                        nsPerItem);
+
+  string line(buffer, static_cast<size_t>(length));
+  auto it = Baseline.find(name);
+
+  if (it != Baseline.end() && (*it).second > 0.0) {
+    bool const regression = (nsPerItem > (*it).second * (1.0 + Tolerance));
+
+    snprintf(buffer, sizeof(buffer), ",\"baselineNsPerItem\":%.2f,\"regression\":%s",
+             (*it).second,
+             regression ? "true" : "false");
+    line.append(buffer);
+
+    if (regression) {
+      ++NumRegressions;
+    }
+  }
+
+  line.push_back('}');
+  cout << line << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the output of an earlier run as baseline
+////////////////////////////////////////////////////////////////////////////////
+
+static bool LoadBaseline (char const* filename) {
+  ifstream file(filename);
+
+  if (! file) {
+    return false;
+  }
+
+  string line;
+
+  while (getline(file, line)) {
+    std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, line.c_str()));
+
+    if (TRI_IsObjectJson(json.get())) {
+      string const name = JsonHelper::getStringValue(json.get(), "benchmark", "");
+      double const nsPerItem = JsonHelper::getNumericValue<double>(json.get(), "nsPerItem", 0.0);
+
+      if (! name.empty()) {
+        Baseline[name] = nsPerItem;
+      }
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a random permutation of the numbers 0 to n - 1
+////////////////////////////////////////////////////////////////////////////////
+
+static vector<uint64_t> Permutation (uint64_t n) {
+  vector<uint64_t> values;
+  values.reserve(n);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    values.push_back(i);
+  }
+
+  for (uint64_t i = n; i > 1; --i) {
+    std::swap(values[i - 1], values[TRI_UInt32Random() % i]);
+  }
+
+  return values;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       AssocUnique
+// -----------------------------------------------------------------------------
+
+typedef AssocUnique<uint64_t, uint64_t> AssocUniqueType;
+
+static uint64_t UniqueHashKey (uint64_t const* key) {
+  return *key * 0x9E3779B97F4A7C15ULL;
+}
+
+static uint64_t UniqueHashElement (uint64_t const* element) {
+  return UniqueHashKey(element);
+}
+
+static bool UniqueIsEqualKeyElement (uint64_t const* key,
+                                     uint64_t hash,
+                                     uint64_t const* element) {
+  return *key == *element;
+}
+
+static bool UniqueIsEqualElementElement (uint64_t const* left,
+                                         uint64_t const* right) {
+  return *left == *right;
+}
+
+static AssocUniqueType* CreateAssocUnique () {
+  return new AssocUniqueType(UniqueHashKey,
+                             UniqueHashElement,
+                             UniqueIsEqualKeyElement,
+                             UniqueIsEqualElementElement,
+                             UniqueIsEqualElementElement);
+}
+
+static void BenchmarkAssocUnique () {
+  uint64_t const n = 1000000 * Scale;
+  vector<uint64_t> const values = Permutation(n);
+  std::unique_ptr<AssocUniqueType> a;
+
+  // inserts grow the table from its initial size
+  Run("assoc-unique-insert", n,
+      [&] () { a.reset(CreateAssocUnique()); },
+      [&] () {
+        for (auto const& it : values) {
+          a->insert(const_cast<uint64_t*>(&it));
+        }
+      },
+      [&] () { a.reset(); });
+
+  a.reset(CreateAssocUnique());
+  for (auto const& it : values) {
+    a->insert(const_cast<uint64_t*>(&it));
+  }
+
+  Run("assoc-unique-lookup", n,
+      [] () { },
+      [&] () {
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+          found += (a->findByKey(&i) != nullptr ? 1 : 0);
+        }
+        Sink = Sink + found;
+      },
+      [] () { });
+
+  Run("assoc-unique-lookup-missing", n,
+      [] () { },
+      [&] () {
+        uint64_t found = 0;
+        for (uint64_t i = n; i < 2 * n; ++i) {
+          found += (a->findByKey(&i) != nullptr ? 1 : 0);
+        }
+        Sink = Sink + found;
+      },
+      [] () { });
+
+  // resizing a filled table rehashes all elements
+  size_t size = a->size();
+
+  Run("assoc-unique-resize", n,
+      [] () { },
+      [&] () {
+        size *= 2;
+        a->resize(size);
+      },
+      [] () { });
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                        AssocMulti
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an element of a multi hash, many elements share a key like the
+/// documents with the same value in a non-unique hash index
+////////////////////////////////////////////////////////////////////////////////
+
+struct MultiElement {
+  uint64_t _key;
+  uint64_t _value;
+};
+
+typedef AssocMulti<uint64_t, MultiElement, uint32_t, true> AssocMultiType;
+
+static uint64_t MultiHashKey (uint64_t const* key) {
+  return *key * 0x9E3779B97F4A7C15ULL;
+}
+
+static uint64_t MultiHashElement (MultiElement const* element,
+                                  bool byKey) {
+  return (byKey ? MultiHashKey(&element->_key) : element->_value * 0xC2B2AE3D27D4EB4FULL);
+}
+
+static bool MultiIsEqualKeyElement (uint64_t const* key,
+                                    MultiElement const* element) {
+  return *key == element->_key;
+}
+
+static bool MultiIsEqualElementElement (MultiElement const* left,
+                                        MultiElement const* right) {
+  return left->_value == right->_value;
+}
+
+static bool MultiIsEqualElementElementByKey (MultiElement const* left,
+                                             MultiElement const* right) {
+  return left->_key == right->_key;
+}
+
+static AssocMultiType* CreateAssocMulti () {
+  return new AssocMultiType(MultiHashKey,
+                            MultiHashElement,
+                            MultiIsEqualKeyElement,
+                            MultiIsEqualElementElement,
+                            MultiIsEqualElementElementByKey);
+}
+
+static void BenchmarkAssocMulti () {
+  uint64_t const n = 1000000 * Scale;
+  uint64_t const perKey = 10;
+  vector<uint64_t> const order = Permutation(n);
+  vector<MultiElement> elements(n);
+
+  for (uint64_t i = 0; i < n; ++i) {
+    elements[i]._key = order[i] / perKey;
+    elements[i]._value = order[i];
+  }
+
+  std::unique_ptr<AssocMultiType> a;
+
+  Run("assoc-multi-insert", n,
+      [&] () { a.reset(CreateAssocMulti()); },
+      [&] () {
+        for (auto& it : elements) {
+          a->insert(&it, false, true);
+        }
+      },
+      [&] () { a.reset(); });
+
+  a.reset(CreateAssocMulti());
+  for (auto& it : elements) {
+    a->insert(&it, false, true);
+  }
+
+  Run("assoc-multi-lookup-by-key", n,
+      [] () { },
+      [&] () {
+        uint64_t found = 0;
+        for (uint64_t key = 0; key < n / perKey; ++key) {
+          std::unique_ptr<vector<MultiElement*>> result(a->lookupByKey(&key));
+          found += result->size();
+        }
+        Sink = Sink + found;
+      },
+      [] () { });
+
+  Run("assoc-multi-remove", n,
+      [] () { },
+      [&] () {
+        for (auto const& it : elements) {
+          a->remove(&it);
+        }
+      },
+      [&] () {
+        for (auto& it : elements) {
+          a->insert(&it, false, true);
+        }
+      });
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                          SkipList
+// -----------------------------------------------------------------------------
+
+typedef SkipList<uint64_t, uint64_t> SkipListType;
+
+static int SkipListCmpElmElm (uint64_t const* left,
+                              uint64_t const* right,
+                              SkipListCmpType cmptype) {
+  if (*left != *right) {
+    return (*left < *right ? -1 : 1);
+  }
+  return 0;
+}
+
+static int SkipListCmpKeyElm (uint64_t const* left,
+                              uint64_t const* right) {
+  if (*left != *right) {
+    return (*left < *right ? -1 : 1);
+  }
+  return 0;
+}
+
+static void SkipListFree (uint64_t*) {
+}
+
+static void BenchmarkSkipList () {
+  uint64_t const n = 1000000 * Scale;
+  vector<uint64_t> const values = Permutation(n);
+  std::unique_ptr<SkipListType> s;
+
+  Run("skiplist-insert", n,
+      [&] () { s.reset(new SkipListType(SkipListCmpElmElm, SkipListCmpKeyElm, SkipListFree, true, false)); },
+      [&] () {
+        for (auto const& it : values) {
+          s->insert(const_cast<uint64_t*>(&it));
+        }
+      },
+      [&] () { s.reset(); });
+
+  s.reset(new SkipListType(SkipListCmpElmElm, SkipListCmpKeyElm, SkipListFree, true, false));
+  for (auto const& it : values) {
+    s->insert(const_cast<uint64_t*>(&it));
+  }
+
+  Run("skiplist-lookup", n,
+      [] () { },
+      [&] () {
+        uint64_t found = 0;
+        for (uint64_t i = 0; i < n; ++i) {
+          found += (s->lookup(&i) != nullptr ? 1 : 0);
+        }
+        Sink = Sink + found;
+      },
+      [] () { });
+
+  // range scans of 100 elements each, items are the elements visited
+  uint64_t const rangeLength = 100;
+  uint64_t const numRanges = n / rangeLength;
+
+  Run("skiplist-range-scan", numRanges * rangeLength,
+      [] () { },
+      [&] () {
+        uint64_t sum = 0;
+        for (uint64_t r = 0; r < numRanges; ++r) {
+          uint64_t const from = (TRI_UInt32Random() % (n - rangeLength));
+          auto node = s->nextNode(s->leftKeyLookup(&from));
+
+          for (uint64_t i = 0; i < rangeLength && node != nullptr; ++i) {
+            sum += *node->document();
+            node = s->nextNode(node);
+          }
+        }
+        Sink = Sink + sum;
+      },
+      [] () { });
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                              JSON
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a document with the usual mix of attributes, about 600 bytes
+////////////////////////////////////////////////////////////////////////////////
+
+static string JsonDocument (uint64_t i) {
+  string s("{\"_key\":\"");
+  s += to_string(i);
+  s += "\",\"name\":\"user ";
+  s += to_string(i);
+  s += "\",\"active\":";
+  s += (i % 2 == 0 ? "true" : "false");
+  s += ",\"age\":";
+  s += to_string(18 + i % 60);
+  s += ",\"score\":";
+  s += to_string((double) i / 7.0);
+  s += ",\"address\":{\"street\":\"Some Street 12\",\"city\":\"Cologne\",\"zip\":\"50667\",\"country\":\"Germany\"}";
+  s += ",\"tags\":[\"alpha\",\"beta\",\"gamma\",\"delta\"]";
+  s += ",\"history\":[";
+  for (int j = 0; j < 10; ++j) {
+    if (j > 0) {
+      s += ",";
+    }
+    s += "{\"at\":";
+    s += to_string(1400000000 + i + j);
+    s += ",\"value\":";
+    s += to_string(j * 1.5);
+    s += "}";
+  }
+  s += "],\"comment\":\"a somewhat longer text value with \\\"escapes\\\" and unicode \\u00e4\\u00f6\\u00fc\"}";
+
+  return s;
+}
+
+static void BenchmarkJson () {
+  uint64_t const n = 100000 * Scale;
+  vector<string> documents;
+  documents.reserve(n);
+
+  uint64_t bytes = 0;
+
+  for (uint64_t i = 0; i < n; ++i) {
+    documents.emplace_back(JsonDocument(i));
+    bytes += documents.back().size();
+  }
+
+  Run("json-parse", n,
+      [] () { },
+      [&] () {
+        for (auto const& it : documents) {
+          TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, it.c_str());
+          Sink = Sink + (json != nullptr ? 1 : 0);
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        }
+      },
+      [] () { });
+
+  // the same work, reported in bytes to tell the parser throughput
+  Run("json-parse-bytes", bytes,
+      [] () { },
+      [&] () {
+        for (auto const& it : documents) {
+          TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, it.c_str());
+          Sink = Sink + (json != nullptr ? 1 : 0);
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        }
+      },
+      [] () { });
+
+  vector<TRI_json_t*> parsed;
+  parsed.reserve(n);
+
+  for (auto const& it : documents) {
+    parsed.emplace_back(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, it.c_str()));
+  }
+
+  Run("json-stringify", n,
+      [] () { },
+      [&] () {
+        TRI_string_buffer_t buffer;
+        TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+
+        for (auto const& it : parsed) {
+          TRI_ResetStringBuffer(&buffer);
+          TRI_StringifyJson(&buffer, it);
+          Sink = Sink + TRI_LengthStringBuffer(&buffer);
+        }
+
+        TRI_DestroyStringBuffer(&buffer);
+      },
+      [] () { });
+
+  Run("json-copy", n,
+      [] () { },
+      [&] () {
+        for (auto const& it : parsed) {
+          TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, it);
+          Sink = Sink + (copy != nullptr ? 1 : 0);
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, copy);
+        }
+      },
+      [] () { });
+
+  for (auto& it : parsed) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, it);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief main
+///
+/// usage: benchmarks_suite [--scale <n>] [--baseline <file>]
+///                         [--tolerance <fraction>] [<filter>]
+///
+/// every benchmark prints one line of JSON with its name, the number of
+/// items processed, the time of the fastest run and the resulting rates.
+/// with a baseline, which is the saved output of an earlier run, the lines
+/// also tell whether a benchmark became slower by more than the tolerance,
+/// and the exit code is 1 if any did
+////////////////////////////////////////////////////////////////////////////////
+
+int main (int argc, char* argv[]) {
+  TRIAGENS_C_INITIALIZE(argc, argv);
+
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+      Scale = (std::max)(static_cast<uint64_t>(1), static_cast<uint64_t>(strtoull(argv[++i], nullptr, 10)));
+    }
+    else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      if (! LoadBaseline(argv[++i])) {
+        cerr << "cannot read baseline '" << argv[i] << "'" << endl;
+        return EXIT_FAILURE;
+      }
+    }
+    else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      Tolerance = strtod(argv[++i], nullptr);
+    }
+    else {
+      Filter = argv[i];
+    }
+  }
+
+  BenchmarkAssocUnique();
+  BenchmarkAssocMulti();
+  BenchmarkSkipList();
+  BenchmarkJson();
+
+  TRIAGENS_C_SHUTDOWN;
+
+  return (NumRegressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
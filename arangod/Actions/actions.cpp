@@ -33,7 +33,6 @@
 #include "Basics/ReadWriteLock.h"
 #include "Basics/StringUtils.h"
 #include "Basics/WriteLocker.h"
-#include "Basics/delete_object.h"
 #include "Basics/logging.h"
 #include "Rest/HttpRequest.h"
 
@@ -41,20 +40,41 @@ using namespace std;
 using namespace triagens::basics;
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                 private variables
+// --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief actions
+/// @brief a node of the action tree. there is one node per path segment, so
+/// a lookup walks the segments of the request once
 ////////////////////////////////////////////////////////////////////////////////
 
-static map<string, TRI_action_t*> Actions;
+namespace {
+  struct ActionNode {
+    ActionNode ()
+      : _action(nullptr),
+        _prefixAction(nullptr) {
+    }
+
+    ~ActionNode () {
+      delete _action;
+      delete _prefixAction;
+    }
+
+    TRI_action_t* _action;
+    TRI_action_t* _prefixAction;
+    std::unordered_map<std::string, std::unique_ptr<ActionNode>> _children;
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief prefix actions
+/// @brief the root of the action tree, for the empty url
 ////////////////////////////////////////////////////////////////////////////////
 
-static map<string, TRI_action_t*> PrefixActions;
+static ActionNode Actions;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief actions lock
@@ -62,6 +82,73 @@ static map<string, TRI_action_t*> PrefixActions;
 
 static ReadWriteLock ActionsLock;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the node for an url, creating it if necessary. the url is
+/// split at every slash, so joining the segments yields the url again
+////////////////////////////////////////////////////////////////////////////////
+
+static ActionNode* CreateNode (string const& url) {
+  ActionNode* node = &Actions;
+
+  if (url.empty()) {
+    return node;
+  }
+
+  size_t start = 0;
+
+  while (true) {
+    size_t end = url.find('/', start);
+    string segment = url.substr(start, end == string::npos ? string::npos : end - start);
+
+    auto& child = node->_children[segment];
+
+    if (child == nullptr) {
+      child.reset(new ActionNode());
+    }
+
+    node = child.get();
+
+    if (end == string::npos) {
+      return node;
+    }
+
+    start = end + 1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stores an action in a slot of a node, returns the action to use
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_action_t* StoreAction (TRI_action_t*& slot,
+                                  TRI_action_t* action) {
+  TRI_action_t* oldAction = slot;
+
+  if (oldAction == nullptr) {
+    slot = action;
+    return action;
+  }
+
+  if (oldAction->_type != action->_type) {
+    LOG_ERROR("trying to define two incompatible actions of type '%s' and '%s' for %surl '%s'",
+              oldAction->_type.c_str(),
+              action->_type.c_str(),
+              (action->_isPrefix ? "prefix " : ""),
+              action->_url.c_str());
+
+    delete oldAction;
+    slot = action;
+    return action;
+  }
+
+  delete action;
+  return oldAction;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -84,47 +171,13 @@ TRI_action_t* TRI_DefineActionVocBase (string const& name,
   action->_urlParts = StringUtils::split(url, "/").size();
 
   // create a new action and store the callback function
+  ActionNode* node = CreateNode(url);
+
   if (action->_isPrefix) {
-    if (PrefixActions.find(url) == PrefixActions.end()) {
-      PrefixActions[url] = action;
-    }
-    else {
-      TRI_action_t* oldAction = PrefixActions[url];
-
-      if (oldAction->_type != action->_type) {
-        LOG_ERROR("trying to define two incompatible actions of type '%s' and '%s' for prefix url '%s'",
-                  oldAction->_type.c_str(),
-                  action->_type.c_str(),
-                  action->_url.c_str());
-
-        delete oldAction;
-      }
-      else {
-        delete action;
-        action = oldAction;
-      }
-    }
+    action = StoreAction(node->_prefixAction, action);
   }
   else {
-    if (Actions.find(url) == Actions.end()) {
-      Actions[url] = action;
-    }
-    else {
-      TRI_action_t* oldAction = Actions[url];
-
-      if (oldAction->_type != action->_type) {
-        LOG_ERROR("trying to define two incompatible actions of type '%s' and type '%s' for url '%s'",
-                  oldAction->_type.c_str(),
-                  action->_type.c_str(),
-                  action->_url.c_str());
-
-        delete oldAction;
-      }
-      else {
-        delete action;
-        action = oldAction;
-      }
-    }
+    action = StoreAction(node->_action, action);
   }
 
   // some debug output
@@ -139,40 +192,45 @@ TRI_action_t* TRI_DefineActionVocBase (string const& name,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief looks up an action
+///
+/// an action for the full suffix wins, otherwise the prefix action with the
+/// longest url matching the suffix is returned
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_action_t* TRI_LookupActionVocBase (triagens::rest::HttpRequest* request) {
-  // check if we know a callback
-  vector<string> suffix = request->suffix();
-
-  // find a direct match
-  string name = StringUtils::join(suffix, '/');
-  
+  vector<string> const& suffix = request->suffix();
 
   READ_LOCKER(ActionsLock);
-  map<string, TRI_action_t*>::iterator i = Actions.find(name);
 
-  if (i != Actions.end()) {
-    return i->second;
+  ActionNode const* node = &Actions;
+  TRI_action_t* prefixAction = node->_prefixAction;
+  size_t n = suffix.size();
+
+  if (n == 1 && suffix[0].empty()) {
+    // joins to the empty url
+    n = 0;
   }
 
-  // find longest prefix match
-  while (true) {
-    name = StringUtils::join(suffix, '/');
-    i = PrefixActions.find(name);
+  for (size_t i = 0; i < n; ++i) {
+    auto it = node->_children.find(suffix[i]);
 
-    if (i != PrefixActions.end()) {
-      return i->second;
+    if (it == node->_children.end()) {
+      return prefixAction;
     }
 
-    if (suffix.empty()) {
-      break;
+    node = (*it).second.get();
+
+    if (node->_prefixAction != nullptr) {
+      prefixAction = node->_prefixAction;
     }
+  }
 
-    suffix.pop_back();
+  // find a direct match
+  if (node->_action != nullptr) {
+    return node->_action;
   }
 
-  return nullptr;
+  return prefixAction;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,11 +238,13 @@ TRI_action_t* TRI_LookupActionVocBase (triagens::rest::HttpRequest* request) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_CleanupActions () {
-  for_each(Actions.begin(), Actions.end(), DeleteObjectValue());
-  Actions.clear();
+  WRITE_LOCKER(ActionsLock);
 
-  for_each(PrefixActions.begin(), PrefixActions.end(), DeleteObjectValue());
-  PrefixActions.clear();
+  delete Actions._action;
+  Actions._action = nullptr;
+  delete Actions._prefixAction;
+  Actions._prefixAction = nullptr;
+  Actions._children.clear();
 }
 
 // -----------------------------------------------------------------------------
@@ -29,6 +29,8 @@
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionEngine.h"
 #include "Basics/Exceptions.h"
+#include "Basics/files.h"
+#include "Basics/JsonHelper.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -480,11 +482,21 @@ void SortedAggregateBlock::emitGroup (AqlItemBlock const* cur,
 // --SECTION--                                        class HashedAggregateBlock
 // -----------------------------------------------------------------------------
         
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of spill partitions
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const HashedAggregateBlock::NumSpillPartitions = 32;
+
 HashedAggregateBlock::HashedAggregateBlock (ExecutionEngine* engine,
                                             AggregateNode const* en)
   : ExecutionBlock(engine, en),
     _aggregateRegisters(),
-    _groupRegister(ExecutionNode::MaxRegisterId) {
+    _groupRegister(ExecutionNode::MaxRegisterId),
+    _spillThreshold(engine->getQuery()->collectSpillThreshold()),
+    _partitions(),
+    _nextPartition(0),
+    _lastBlock(nullptr) {
  
   for (auto const& p : en->_aggregateVariables) {
     // We know that planRegisters() has been run, so
@@ -516,6 +528,7 @@ HashedAggregateBlock::HashedAggregateBlock (ExecutionEngine* engine,
 }
 
 HashedAggregateBlock::~HashedAggregateBlock () {
+  clearPartitions();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -532,6 +545,23 @@ int HashedAggregateBlock::initialize () {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+int HashedAggregateBlock::initializeCursor (AqlItemBlock* items, 
+                                            size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  clearPartitions();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
                                          size_t atMost,
                                          bool skipping,
@@ -544,6 +574,11 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
     return TRI_ERROR_NO_ERROR;
   }
 
+  if (! _partitions.empty()) {
+    // all input was consumed in a previous call, and the groups were spilled
+    return emitPartitions(atLeast, skipping, result, skipped);
+  }
+
   if (_buffer.empty()) {
     if (! ExecutionBlock::getBlock(atLeast, atMost)) {
       // done
@@ -562,55 +597,12 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
     colls.emplace_back(cur->getDocumentCollection(it.second));
   }
 
-  std::unordered_map<std::vector<AqlValue>, size_t, GroupKeyHash, GroupKeyEqual> allGroups(
+  GroupMap allGroups(
     1024, 
     GroupKeyHash(_trx, colls), 
     GroupKeyEqual(_trx, colls)
   );
 
-  auto buildResult = [&] (AqlItemBlock const* src) {
-    auto planNode = static_cast<AggregateNode const*>(getPlanNode());
-    auto nrRegs = planNode->getRegisterPlan()->nrRegs[planNode->getDepth()];
-
-    std::unique_ptr<AqlItemBlock> result(new AqlItemBlock(allGroups.size(), nrRegs));
-    
-    if (src != nullptr) {
-      inheritRegisters(src, result.get(), 0);
-    }
-
-    size_t const n = _aggregateRegisters.size();
-    TRI_ASSERT(colls.size() == n);
-
-    for (size_t i = 0; i < n; ++i) {
-      result->setDocumentCollection(_aggregateRegisters[i].first, colls[i]);
-    }
-    
-    TRI_ASSERT(! planNode->_count || _groupRegister != ExecutionNode::MaxRegisterId);
-
-    size_t row = 0;
-    for (auto const& it : allGroups) {
-      auto& keys = it.first;
-
-      TRI_ASSERT_EXPENSIVE(keys.size() == n);
-      size_t i = 0;
-      for (auto& key : keys) {
-        result->setValue(row, _aggregateRegisters[i++].first, key);
-        const_cast<AqlValue*>(&key)->erase(); // to prevent double-freeing later
-      }
-    
-      if (planNode->_count) {
-        // set group count in result register
-        result->setValue(row, _groupRegister, AqlValue(new Json(static_cast<double>(it.second))));
-      }
-
-      ++row;
-    }
-
-    return result.release();
-  };
-
-
-
   std::vector<AqlValue> groupValues;
   size_t const n = _aggregateRegisters.size();
   groupValues.reserve(n);
@@ -640,6 +632,11 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
         }
 
         allGroups.emplace(group, 1);
+
+        if (_spillThreshold > 0 && allGroups.size() >= _spillThreshold) {
+          // too many groups. write them to disk with their partial counts
+          spillGroups(allGroups, colls);
+        }
       }
       else {
         // existing group. simply increase the counter
@@ -658,6 +655,23 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
 
         if (! hasMore) {
           // no more input. we're done
+          if (! _partitions.empty()) {
+            // groups were spilled. spill the remaining ones, too, and
+            // produce the result from the partitions
+            try {
+              spillGroups(allGroups, colls);
+            }
+            catch (...) {
+              returnBlock(cur);
+              throw;
+            }
+
+            // keep the last block for the inherited registers
+            _lastBlock = cur;
+
+            return emitPartitions(atLeast, skipping, result, skipped);
+          }
+
           try {
             // emit last buffered group
             if (! skipping) {
@@ -667,7 +681,7 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
             }
 
             ++skipped;
-            result = buildResult(cur);
+            result = buildResult(cur, allGroups, colls);
    
             returnBlock(cur);         
             _done = true;
@@ -692,12 +706,7 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
   }
   catch (...) {
     // clean up
-    for (auto& it : allGroups) {
-      for (auto& it2 : it.first) {
-        const_cast<AqlValue*>(&it2)->destroy();
-      }
-    }
-    allGroups.clear();
+    destroyGroups(allGroups);
     throw;
   }
   
@@ -708,11 +717,233 @@ int HashedAggregateBlock::getOrSkipSome (size_t atLeast,
     TRI_ASSERT(skipped > 0);
   }
 
-  result = buildResult(nullptr);
+  result = buildResult(nullptr, allGroups, colls);
   
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build a result block from the groups
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* HashedAggregateBlock::buildResult (AqlItemBlock const* src,
+                                                 GroupMap& groups,
+                                                 std::vector<TRI_document_collection_t const*> const& colls) {
+  auto planNode = static_cast<AggregateNode const*>(getPlanNode());
+  auto nrRegs = planNode->getRegisterPlan()->nrRegs[planNode->getDepth()];
+
+  std::unique_ptr<AqlItemBlock> result(new AqlItemBlock(groups.size(), nrRegs));
+  
+  if (src != nullptr) {
+    inheritRegisters(src, result.get(), 0);
+  }
+
+  size_t const n = _aggregateRegisters.size();
+  TRI_ASSERT(colls.size() == n);
+
+  for (size_t i = 0; i < n; ++i) {
+    result->setDocumentCollection(_aggregateRegisters[i].first, colls[i]);
+  }
+  
+  TRI_ASSERT(! planNode->_count || _groupRegister != ExecutionNode::MaxRegisterId);
+
+  size_t row = 0;
+  for (auto const& it : groups) {
+    auto& keys = it.first;
+
+    TRI_ASSERT_EXPENSIVE(keys.size() == n);
+    size_t i = 0;
+    for (auto& key : keys) {
+      result->setValue(row, _aggregateRegisters[i++].first, key);
+      const_cast<AqlValue*>(&key)->erase(); // to prevent double-freeing later
+    }
+  
+    if (planNode->_count) {
+      // set group count in result register
+      result->setValue(row, _groupRegister, AqlValue(new Json(static_cast<double>(it.second))));
+    }
+
+    ++row;
+  }
+
+  return result.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the group values of all groups
+////////////////////////////////////////////////////////////////////////////////
+
+void HashedAggregateBlock::destroyGroups (GroupMap& groups) {
+  for (auto& it : groups) {
+    for (auto& it2 : it.first) {
+      const_cast<AqlValue*>(&it2)->destroy();
+    }
+  }
+  groups.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write all groups to the spill partitions. a group goes to the
+/// partition determined by its hash value, so all partial counts of a group
+/// end up in the same partition
+////////////////////////////////////////////////////////////////////////////////
+
+void HashedAggregateBlock::spillGroups (GroupMap& groups,
+                                        std::vector<TRI_document_collection_t const*> const& colls) {
+  if (_partitions.empty()) {
+    _partitions.reserve(NumSpillPartitions);
+    for (size_t i = 0; i < NumSpillPartitions; ++i) {
+      _partitions.emplace_back(new SpilledPartition());
+    }
+    _nextPartition = 0;
+  }
+
+  size_t const n = _aggregateRegisters.size();
+  auto const& hasher = groups.hash_function();
+
+  std::vector<Json> chunks;
+  chunks.reserve(NumSpillPartitions);
+  for (size_t i = 0; i < NumSpillPartitions; ++i) {
+    chunks.emplace_back(Json(Json::Array, groups.size() / NumSpillPartitions + 1));
+  }
+
+  for (auto const& it : groups) {
+    Json record(Json::Array, n + 1);
+
+    for (size_t i = 0; i < n; ++i) {
+      record.add(it.first[i].toJson(_trx, colls[i], true));
+    }
+    record.add(Json(static_cast<double>(it.second)));
+
+    chunks[hasher(it.first) % NumSpillPartitions].add(record);
+  }
+
+  destroyGroups(groups);
+
+  for (size_t i = 0; i < NumSpillPartitions; ++i) {
+    if (chunks[i].size() > 0) {
+      _partitions[i]->append(chunks[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge the partial counts of the spilled groups, one partition at a
+/// time, so only the groups of a single partition are in memory
+////////////////////////////////////////////////////////////////////////////////
+
+int HashedAggregateBlock::emitPartitions (size_t atLeast,
+                                          bool skipping,
+                                          AqlItemBlock*& result,
+                                          size_t& skipped) {
+  size_t const n = _aggregateRegisters.size();
+  // spilled values are always JSON
+  std::vector<TRI_document_collection_t const*> const colls(n, nullptr);
+
+  while (_nextPartition < _partitions.size()) {
+    throwIfKilled(); // check if we were aborted
+
+    std::unique_ptr<SpilledPartition> partition(_partitions[_nextPartition]);
+    _partitions[_nextPartition++] = nullptr;
+
+    GroupMap groups(
+      1024, 
+      GroupKeyHash(_trx, const_cast<std::vector<TRI_document_collection_t const*>&>(colls)), 
+      GroupKeyEqual(_trx, const_cast<std::vector<TRI_document_collection_t const*>&>(colls))
+    );
+
+    try {
+      partition->rewind();
+
+      std::vector<AqlValue> group;
+      group.reserve(n);
+
+      while (true) {
+        TRI_json_t* data = partition->next();
+
+        if (data == nullptr) {
+          break;
+        }
+
+        Json chunk(TRI_UNKNOWN_MEM_ZONE, data);
+        size_t const length = chunk.size();
+
+        for (size_t i = 0; i < length; ++i) {
+          TRI_json_t const* record = TRI_LookupArrayJson(chunk.json(), i);
+          TRI_ASSERT(TRI_LengthArrayJson(record) == n + 1);
+
+          group.clear();
+          for (size_t j = 0; j < n; ++j) {
+            // lookup values only point into the chunk
+            group.emplace_back(AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, TRI_LookupArrayJson(record, j), Json::NOFREE)));
+          }
+
+          size_t const count = static_cast<size_t>(TRI_LookupArrayJson(record, n)->_value._number);
+          auto it = groups.find(group);
+
+          if (it == groups.end()) {
+            std::vector<AqlValue> copy;
+            copy.reserve(n);
+            for (auto const& value : group) {
+              copy.emplace_back(value.clone());
+            }
+            groups.emplace(copy, count);
+          }
+          else {
+            (*it).second += count;
+          }
+
+          for (auto& value : group) {
+            value.destroy();
+          }
+        }
+      }
+    }
+    catch (...) {
+      destroyGroups(groups);
+      throw;
+    }
+
+    if (groups.empty()) {
+      continue;
+    }
+
+    std::unique_ptr<AqlItemBlock> block(buildResult(_lastBlock, groups, colls));
+    skipped += block->size();
+
+    if (! skipping) {
+      result = block.release();
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (skipped >= atLeast) {
+      return TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  _done = true;
+  clearPartitions();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all spill partitions
+////////////////////////////////////////////////////////////////////////////////
+
+void HashedAggregateBlock::clearPartitions () {
+  for (auto& it : _partitions) {
+    delete it;
+  }
+  _partitions.clear();
+  _nextPartition = 0;
+
+  if (_lastBlock != nullptr) {
+    returnBlock(_lastBlock);
+    _lastBlock = nullptr;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hasher for groups
 ////////////////////////////////////////////////////////////////////////////////
@@ -746,6 +977,304 @@ bool HashedAggregateBlock::GroupKeyEqual::operator() (std::vector<AqlValue> cons
   return true;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                           class HashedAggregateBlock::SpilledPartition
+// -----------------------------------------------------------------------------
+
+HashedAggregateBlock::SpilledPartition::SpilledPartition () 
+  : _filename(nullptr),
+    _fd(-1),
+    _numChunks(0),
+    _numRead(0) {
+
+  long systemError;
+  std::string errorMessage;
+
+  if (TRI_GetTempName("aql-collect", &_filename, false, systemError, errorMessage) != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_CREATE_TEMP_FILE, errorMessage);
+  }
+
+  _fd = TRI_CREATE(_filename, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+  if (_fd < 0) {
+    TRI_Free(TRI_CORE_MEM_ZONE, _filename);
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CANNOT_CREATE_TEMP_FILE);
+  }
+}
+
+HashedAggregateBlock::SpilledPartition::~SpilledPartition () {
+  TRI_CLOSE(_fd);
+  TRI_UnlinkFile(_filename);
+  TRI_Free(TRI_CORE_MEM_ZONE, _filename);
+}
+
+void HashedAggregateBlock::SpilledPartition::append (Json const& chunk) {
+  std::string const data = chunk.toString();
+  uint64_t const length = static_cast<uint64_t>(data.size());
+
+  if (! TRI_WritePointer(_fd, &length, sizeof(length)) ||
+      ! TRI_WritePointer(_fd, data.c_str(), data.size())) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CANNOT_WRITE_FILE);
+  }
+
+  ++_numChunks;
+}
+
+void HashedAggregateBlock::SpilledPartition::rewind () {
+  if (TRI_LSEEK(_fd, 0, SEEK_SET) != 0) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+
+  _numRead = 0;
+}
+
+TRI_json_t* HashedAggregateBlock::SpilledPartition::next () {
+  if (_numRead == _numChunks) {
+    return nullptr;
+  }
+
+  uint64_t length;
+
+  if (! TRI_ReadPointer(_fd, &length, sizeof(length))) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+  
+  std::string data;
+  data.resize(static_cast<size_t>(length));
+
+  if (! TRI_ReadPointer(_fd, &data[0], data.size())) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+
+  ++_numRead;
+
+  TRI_json_t* json = JsonHelper::fromString(data);
+
+  if (! TRI_IsArrayJson(json)) {
+    if (json != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid data in collect partition");
+  }
+
+  return json;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class DistinctAggregateBlock
+// -----------------------------------------------------------------------------
+
+DistinctAggregateBlock::DistinctAggregateBlock (ExecutionEngine* engine,
+                                                AggregateNode const* en)
+  : ExecutionBlock(engine, en),
+    _aggregateRegisters(),
+    _seen(1024, SeenValuesHash(), SeenValuesEqual(_trx)) {
+ 
+  for (auto const& p : en->_aggregateVariables) {
+    // We know that planRegisters() has been run, so
+    // getPlanNode()->_registerPlan is set up
+    auto itOut = en->getRegisterPlan()->varInfo.find(p.first->id);
+    TRI_ASSERT(itOut != en->getRegisterPlan()->varInfo.end());
+
+    auto itIn = en->getRegisterPlan()->varInfo.find(p.second->id);
+    TRI_ASSERT(itIn != en->getRegisterPlan()->varInfo.end());
+    TRI_ASSERT((*itIn).second.registerId < ExecutionNode::MaxRegisterId);
+    TRI_ASSERT((*itOut).second.registerId < ExecutionNode::MaxRegisterId);
+    _aggregateRegisters.emplace_back(make_pair((*itOut).second.registerId, (*itIn).second.registerId));
+  }
+
+  TRI_ASSERT(en->_outVariable == nullptr);
+  TRI_ASSERT(! en->_count);
+  TRI_ASSERT(! _aggregateRegisters.empty());
+}
+
+DistinctAggregateBlock::~DistinctAggregateBlock () {
+  clearSeen();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize
+////////////////////////////////////////////////////////////////////////////////
+
+int DistinctAggregateBlock::initialize () {
+  return ExecutionBlock::initialize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+int DistinctAggregateBlock::initializeCursor (AqlItemBlock* items, 
+                                              size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  clearSeen();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+int DistinctAggregateBlock::getOrSkipSome (size_t atLeast,
+                                           size_t atMost,
+                                           bool skipping,
+                                           AqlItemBlock*& result,
+                                           size_t& skipped) {
+
+  TRI_ASSERT(result == nullptr && skipped == 0);
+
+  if (_done) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  auto planNode = static_cast<AggregateNode const*>(getPlanNode());
+  auto nrRegs = planNode->getRegisterPlan()->nrRegs[planNode->getDepth()];
+  size_t const n = _aggregateRegisters.size();
+
+  std::unique_ptr<AqlItemBlock> res;
+
+  // the values of the current row. they are neither cloned nor freed
+  SeenValues current;
+  current.values.reserve(n);
+  current.collections.reserve(n);
+
+  while (skipped < atMost) {
+    if (_buffer.empty()) {
+      if (skipped >= atLeast) {
+        // do not read more input than needed
+        break;
+      }
+
+      if (! ExecutionBlock::getBlock(atLeast, atMost)) {
+        _done = true;
+        break;
+      }
+      _pos = 0;
+    }
+
+    AqlItemBlock* cur = _buffer.front();
+
+    current.collections.clear();
+    for (auto const& it : _aggregateRegisters) {
+      current.collections.emplace_back(cur->getDocumentCollection(it.second));
+    }
+
+    while (_pos < cur->size() && skipped < atMost) {
+      current.values.clear();
+      current.hash = 0x12345678;
+
+      for (size_t i = 0; i < n; ++i) {
+        AqlValue const& value = cur->getValueReference(_pos, _aggregateRegisters[i].second);
+        current.values.emplace_back(value);
+        // combine such that the order of the values matters
+        current.hash ^= value.hash(_trx, current.collections[i]) + 0x9e3779b97f4a7c15ULL + (current.hash << 6) + (current.hash >> 2);
+      }
+
+      if (_seen.find(current) == _seen.end()) {
+        // first occurrence of the values. remember a copy of them
+        SeenValues seen;
+        seen.hash = current.hash;
+        seen.collections = current.collections;
+        seen.values.reserve(n);
+
+        try {
+          for (auto const& value : current.values) {
+            seen.values.emplace_back(value.clone());
+          }
+          _seen.emplace(std::move(seen));
+        }
+        catch (...) {
+          for (auto& value : seen.values) {
+            value.destroy();
+          }
+          throw;
+        }
+
+        if (! skipping) {
+          if (res == nullptr) {
+            res.reset(new AqlItemBlock(atMost, nrRegs));
+          }
+
+          inheritRegisters(cur, res.get(), _pos, skipped);
+
+          for (size_t i = 0; i < n; ++i) {
+            AqlValue value = current.values[i].clone();
+
+            try {
+              res->setValue(skipped, _aggregateRegisters[i].first, value);
+            }
+            catch (...) {
+              value.destroy();
+              throw;
+            }
+            res->setDocumentCollection(_aggregateRegisters[i].first, current.collections[i]);
+          }
+        }
+
+        ++skipped;
+      }
+
+      ++_pos;
+    }
+
+    if (_pos >= cur->size()) {
+      _buffer.pop_front();
+      _pos = 0;
+      returnBlock(cur);
+    }
+  }
+
+  if (res != nullptr) {
+    TRI_ASSERT(skipped > 0);
+
+    if (skipped < atMost) {
+      res->shrink(skipped);
+    }
+    result = res.release();
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free all seen values
+////////////////////////////////////////////////////////////////////////////////
+
+void DistinctAggregateBlock::clearSeen () {
+  for (auto& it : _seen) {
+    for (auto& value : it.values) {
+      const_cast<AqlValue*>(&value)->destroy();
+    }
+  }
+
+  _seen.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief comparator for seen values
+////////////////////////////////////////////////////////////////////////////////
+    
+bool DistinctAggregateBlock::SeenValuesEqual::operator() (SeenValues const& lhs,
+                                                          SeenValues const& rhs) const {
+  if (lhs.hash != rhs.hash) {
+    return false;
+  }
+
+  size_t const n = lhs.values.size();
+
+  for (size_t i = 0; i < n; ++i) {
+    int res = AqlValue::Compare(_trx, lhs.values[i], lhs.collections[i], rhs.values[i], rhs.collections[i], false);
+
+    if (res != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
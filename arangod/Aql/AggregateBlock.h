@@ -167,6 +167,8 @@ namespace triagens {
 
         int initialize () override;
 
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
       private:
 
         int getOrSkipSome (size_t atLeast,
@@ -175,6 +177,86 @@ namespace triagens {
                            AqlItemBlock*& result,
                            size_t& skipped) override;
 
+        struct GroupKeyHash;
+        struct GroupKeyEqual;
+
+        typedef std::unordered_map<std::vector<AqlValue>, size_t, GroupKeyHash, GroupKeyEqual> GroupMap;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build a result block from the groups. the group values are moved
+/// into the result
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* buildResult (AqlItemBlock const*,
+                                   GroupMap&,
+                                   std::vector<TRI_document_collection_t const*> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the group values of all groups
+////////////////////////////////////////////////////////////////////////////////
+
+        static void destroyGroups (GroupMap&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write all groups with their counts to the spill partitions, and
+/// remove them from memory
+////////////////////////////////////////////////////////////////////////////////
+
+        void spillGroups (GroupMap&,
+                          std::vector<TRI_document_collection_t const*> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge the spilled groups of the next partition and return them
+////////////////////////////////////////////////////////////////////////////////
+
+        int emitPartitions (size_t atLeast,
+                            bool skipping,
+                            AqlItemBlock*& result,
+                            size_t& skipped);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all spill partitions
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearPartitions ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a partition of spilled groups in a temporary file. the file
+/// contains chunks of [ value1, ..., valueN, count ] records, and the same
+/// group may occur in several chunks, with partial counts
+////////////////////////////////////////////////////////////////////////////////
+
+        class SpilledPartition {
+
+          public:
+
+            SpilledPartition ();
+
+            ~SpilledPartition ();
+
+            void append (triagens::basics::Json const&);
+
+            void rewind ();
+
+            TRI_json_t* next ();
+
+          private:
+
+            char* _filename;
+
+            int _fd;
+
+            size_t _numChunks;
+
+            size_t _numRead;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of spill partitions
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NumSpillPartitions;
+
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -190,6 +272,32 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         RegisterId _groupRegister;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of groups to keep in memory before they are spilled, 0 means
+/// groups are never spilled
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _spillThreshold;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spill partitions, empty if nothing was spilled
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<SpilledPartition*> _partitions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief next partition to emit
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nextPartition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the last input block, used for the inherited registers of results
+/// that are produced from spill partitions
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* _lastBlock;
         
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hasher for a vector of AQL values
@@ -230,6 +338,88 @@ namespace triagens {
         
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                            DistinctAggregateBlock
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief COLLECT without INTO and WITH COUNT, and RETURN DISTINCT. the block
+/// remembers the distinct values it has seen together with their hashes, and
+/// emits each input row whose values it has not seen yet right away. it
+/// neither needs sorted input nor reads all input before producing results
+////////////////////////////////////////////////////////////////////////////////
+
+    class DistinctAggregateBlock : public ExecutionBlock  {
+
+      public:
+
+        DistinctAggregateBlock (ExecutionEngine*,
+                                AggregateNode const*);
+
+        ~DistinctAggregateBlock ();
+
+        int initialize () override;
+
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
+      private:
+
+        int getOrSkipSome (size_t atLeast,
+                           size_t atMost,
+                           bool skipping,
+                           AqlItemBlock*& result,
+                           size_t& skipped) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free all seen values
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearSeen ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distinct values seen so far. the hash is computed only once per
+/// input row, because hashing a document is expensive
+////////////////////////////////////////////////////////////////////////////////
+
+        struct SeenValues {
+          uint64_t hash;
+          std::vector<AqlValue> values;
+          std::vector<TRI_document_collection_t const*> collections;
+        };
+
+        struct SeenValuesHash {
+          size_t operator() (SeenValues const& value) const {
+            return static_cast<size_t>(value.hash);
+          }
+        };
+
+        struct SeenValuesEqual {
+          explicit SeenValuesEqual (triagens::arango::AqlTransaction* trx)
+            : _trx(trx) {
+          }
+
+          bool operator() (SeenValues const&,
+                           SeenValues const&) const;
+          
+          triagens::arango::AqlTransaction* _trx;
+        };
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pairs, consisting of out register and in register
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<RegisterId, RegisterId>> _aggregateRegisters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the distinct values seen since the cursor was initialized
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_set<SeenValues, SeenValuesHash, SeenValuesEqual> _seen;
+        
+    };
+
   }  // namespace triagens::aql
 }  // namespace triagens
 
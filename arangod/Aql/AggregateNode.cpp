@@ -193,6 +193,8 @@ struct UserVarFinder final : public WalkerWorker<ExecutionNode> {
     }
     else if (en->getType() == ExecutionNode::ENUMERATE_COLLECTION ||
              en->getType() == ExecutionNode::INDEX ||
+             en->getType() == ExecutionNode::HASH_JOIN ||
+             en->getType() == ExecutionNode::TRAVERSAL ||
              en->getType() == ExecutionNode::ENUMERATE_LIST ||
              en->getType() == ExecutionNode::AGGREGATE) {
       depth += 1;
@@ -57,6 +57,7 @@ namespace triagens {
       friend class ExecutionBlock;
       friend class SortedAggregateBlock;
       friend class HashedAggregateBlock;
+      friend class DistinctAggregateBlock;
       friend class RedundantCalculationsReplacer;
 
       public:
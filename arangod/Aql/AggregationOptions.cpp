@@ -79,6 +79,9 @@ AggregationOptions::AggregationMethod AggregationOptions::methodFromString (std:
   if (method == "sorted") {
     return AggregationMethod::AGGREGATION_METHOD_SORTED;
   }
+  if (method == "distinct") {
+    return AggregationMethod::AGGREGATION_METHOD_DISTINCT;
+  }
 
   return AggregationMethod::AGGREGATION_METHOD_UNDEFINED;
 }
@@ -94,6 +97,9 @@ std::string AggregationOptions::methodToString (AggregationOptions::AggregationM
   if (method == AggregationMethod::AGGREGATION_METHOD_SORTED) {
     return std::string("sorted");
   }
+  if (method == AggregationMethod::AGGREGATION_METHOD_DISTINCT) {
+    return std::string("distinct");
+  }
 
   THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "cannot stringify unknown aggregation method");
 }
@@ -51,7 +51,8 @@ namespace triagens {
       enum AggregationMethod {
         AGGREGATION_METHOD_UNDEFINED,
         AGGREGATION_METHOD_HASH,
-        AGGREGATION_METHOD_SORTED
+        AGGREGATION_METHOD_SORTED,
+        AGGREGATION_METHOD_DISTINCT
       };
 
 // -----------------------------------------------------------------------------
@@ -27,11 +27,309 @@
 
 #include "Aql/AqlItemBlock.h"
 #include "Aql/ExecutionNode.h"
+#include "Basics/StringBuffer.h"
 
 using namespace triagens::aql;
 
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
+using StringBuffer = triagens::basics::StringBuffer;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 binary encoding
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the binary encoding of an AqlItemBlock. all numbers are stored in
+/// host byte order, all servers of a cluster are expected to share it:
+///  uint32 magic, uint64 total length in bytes (including the header),
+///  uint64 nrItems, uint32 nrRegs,
+///  uint32 number of dictionary strings, followed by each string as
+///  uint32 length and the bytes,
+///  the entries columnwise as in toJson, each starting with a tag:
+///   BLOCK_EMPTY                  a single empty entry
+///   BLOCK_EMPTY_RUN  uint64 N    a run of N empty entries
+///   BLOCK_RANGE      int64 int64 a range with LOW and HIGH (inclusive)
+///   BLOCK_VALUE      value       a new value, which gets the next number
+///                                in the value table (starting at 0)
+///   BLOCK_REPEAT     uint32 N    a repetition of value N of the value table
+/// a value starts with a tag as well:
+///   VALUE_NULL, VALUE_FALSE, VALUE_TRUE
+///   VALUE_NUMBER     double
+///   VALUE_STRING     uint32 N    string N of the dictionary
+///   VALUE_ARRAY      uint32 N    followed by N values
+///   VALUE_OBJECT     uint32 N    followed by N pairs of a dictionary index
+///                                for the attribute name and a value
+/// attribute names and string values share the dictionary, so every string
+/// is only transferred once per block
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t const BinaryMagic = 0x31425141; // "AQB1"
+
+static size_t const BinaryHeaderLength = sizeof(uint32_t) + sizeof(uint64_t) + 
+                                         sizeof(uint64_t) + sizeof(uint32_t);
+
+enum BinaryBlockTag : uint8_t {
+  BLOCK_EMPTY,
+  BLOCK_EMPTY_RUN,
+  BLOCK_RANGE,
+  BLOCK_VALUE,
+  BLOCK_REPEAT
+};
+
+enum BinaryValueTag : uint8_t {
+  VALUE_NULL,
+  VALUE_FALSE,
+  VALUE_TRUE,
+  VALUE_NUMBER,
+  VALUE_STRING,
+  VALUE_ARRAY,
+  VALUE_OBJECT
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a fixed-size number to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static inline void AppendBinary (StringBuffer& buffer, T value) {
+  buffer.appendText(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collects the strings of a block while it is encoded
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+  struct BinaryDictionary {
+    uint32_t lookup (char const* data, size_t length) {
+      std::string key(data, length);
+      auto it = _positions.find(key);
+
+      if (it != _positions.end()) {
+        return (*it).second;
+      }
+
+      uint32_t const position = static_cast<uint32_t>(_strings.size());
+      _strings.emplace_back(key);
+      _positions.emplace(std::move(key), position);
+      return position;
+    }
+
+    std::vector<std::string> _strings;
+    std::unordered_map<std::string, uint32_t> _positions;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a binary encoded block, bounds-checking every access
+////////////////////////////////////////////////////////////////////////////////
+
+  struct BinaryReader {
+    BinaryReader (char const* data, size_t length) 
+      : _position(data),
+        _end(data + length) {
+    }
+
+    template<typename T> 
+    T read () {
+      if (static_cast<size_t>(_end - _position) < sizeof(T)) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                       "binary AqlItemBlock is truncated");
+      }
+
+      T value;
+      memcpy(&value, _position, sizeof(T));
+      _position += sizeof(T);
+      return value;
+    }
+
+    char const* readBytes (size_t length) {
+      if (static_cast<size_t>(_end - _position) < length) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                       "binary AqlItemBlock is truncated");
+      }
+
+      char const* result = _position;
+      _position += length;
+      return result;
+    }
+      
+    char const* _position;
+    char const* const _end;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the binary encoding of a JSON value
+////////////////////////////////////////////////////////////////////////////////
+
+static void EncodeBinaryJson (StringBuffer& buffer,
+                              BinaryDictionary& dictionary,
+                              TRI_json_t const* json) {
+  switch (json->_type) {
+    case TRI_JSON_BOOLEAN: {
+      AppendBinary<uint8_t>(buffer, json->_value._boolean ? VALUE_TRUE : VALUE_FALSE);
+      break;
+    }
+
+    case TRI_JSON_NUMBER: {
+      AppendBinary<uint8_t>(buffer, VALUE_NUMBER);
+      AppendBinary<double>(buffer, json->_value._number);
+      break;
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      AppendBinary<uint8_t>(buffer, VALUE_STRING);
+      AppendBinary<uint32_t>(buffer, dictionary.lookup(json->_value._string.data, 
+                                                       json->_value._string.length - 1));
+      break;
+    }
+
+    case TRI_JSON_ARRAY: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+      AppendBinary<uint8_t>(buffer, VALUE_ARRAY);
+      AppendBinary<uint32_t>(buffer, static_cast<uint32_t>(n));
+
+      for (size_t i = 0; i < n; ++i) {
+        EncodeBinaryJson(buffer, dictionary, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i)));
+      }
+      break;
+    }
+
+    case TRI_JSON_OBJECT: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+      AppendBinary<uint8_t>(buffer, VALUE_OBJECT);
+      AppendBinary<uint32_t>(buffer, static_cast<uint32_t>(n / 2));
+
+      for (size_t i = 0; i < n; i += 2) {
+        auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+        TRI_ASSERT(TRI_IsStringJson(key));
+        AppendBinary<uint32_t>(buffer, dictionary.lookup(key->_value._string.data,
+                                                         key->_value._string.length - 1));
+        EncodeBinaryJson(buffer, dictionary, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i + 1)));
+      }
+      break;
+    }
+
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL: {
+      AppendBinary<uint8_t>(buffer, VALUE_NULL);
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes an array or object value, the tag has been read already
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_json_t* DecodeBinaryJson (BinaryReader& reader,
+                                     std::vector<std::string> const& dictionary,
+                                     uint8_t tag) {
+  auto lookup = [&] () -> std::string const& {
+    uint32_t const position = reader.read<uint32_t>();
+    if (position >= dictionary.size()) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                     "invalid string in binary AqlItemBlock");
+    }
+    return dictionary[position];
+  };
+
+  TRI_json_t* json = nullptr;
+
+  switch (tag) {
+    case VALUE_NULL: 
+      json = TRI_CreateNullJson(TRI_UNKNOWN_MEM_ZONE);
+      break;
+    case VALUE_FALSE: 
+      json = TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false);
+      break;
+    case VALUE_TRUE: 
+      json = TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, true);
+      break;
+    case VALUE_NUMBER: 
+      json = TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, reader.read<double>());
+      break;
+    case VALUE_STRING: {
+      std::string const& value = lookup();
+      json = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, value.c_str(), value.size());
+      break;
+    }
+
+    case VALUE_ARRAY: 
+    case VALUE_OBJECT: {
+      uint32_t const n = reader.read<uint32_t>();
+      json = (tag == VALUE_ARRAY) ? TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, n) 
+                                  : TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE, n);
+      if (json == nullptr) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+      }
+
+      try {
+        for (uint32_t i = 0; i < n; ++i) {
+          if (tag == VALUE_ARRAY) {
+            TRI_json_t* member = DecodeBinaryJson(reader, dictionary, reader.read<uint8_t>());
+            TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, json, member);
+          }
+          else {
+            std::string const& key = lookup();
+            TRI_json_t* member = DecodeBinaryJson(reader, dictionary, reader.read<uint8_t>());
+            TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, key.c_str(), member);
+          }
+        }
+      }
+      catch (...) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        throw;
+      }
+      return json;
+    }
+
+    default: {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                     "invalid value in binary AqlItemBlock");
+    }
+  }
+
+  if (json == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a value for an AqlItemBlock. scalars are stored inline
+/// where possible
+////////////////////////////////////////////////////////////////////////////////
+
+static AqlValue DecodeBinaryValue (BinaryReader& reader,
+                                   std::vector<std::string> const& dictionary) {
+  uint8_t const tag = reader.read<uint8_t>();
+
+  switch (tag) {
+    case VALUE_NULL: 
+      return AqlValue::CreateNull();
+    case VALUE_FALSE: 
+      return AqlValue::CreateBool(false);
+    case VALUE_TRUE: 
+      return AqlValue::CreateBool(true);
+    case VALUE_NUMBER: 
+      return AqlValue::CreateNumber(reader.read<double>());
+    case VALUE_STRING: {
+      uint32_t const position = reader.read<uint32_t>();
+      if (position >= dictionary.size()) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                       "invalid string in binary AqlItemBlock");
+      }
+      return AqlValue::CreateString(dictionary[position].c_str(), dictionary[position].size());
+    }
+    default: {
+      TRI_json_t* json = DecodeBinaryJson(reader, dictionary, tag);
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, json));
+    }
+  }
+}
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      AqlItemBlock
@@ -175,12 +473,117 @@ AqlItemBlock::AqlItemBlock (Json const& json) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the block from its binary encoding, note that this can throw
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock::AqlItemBlock (char const* data,
+                            size_t length) {
+  BinaryReader reader(data, binaryLength(data, length));
+  reader.read<uint32_t>(); // magic
+  reader.read<uint64_t>(); // length
+
+  _nrItems = static_cast<size_t>(reader.read<uint64_t>());
+  if (_nrItems == 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "nrItems must be > 0");
+  }
+
+  _nrRegs = static_cast<RegisterId>(reader.read<uint32_t>());
+
+  if (_nrRegs > 0) {
+    _data.resize(_nrItems * _nrRegs);
+    _docColls.reserve(_nrRegs);
+    for (size_t i = 0; i < _nrRegs; ++i) {
+      _docColls.emplace_back(nullptr);
+    }
+  }
+
+  std::vector<std::string> dictionary;
+  uint32_t const nrStrings = reader.read<uint32_t>();
+  dictionary.reserve(nrStrings);
+  for (uint32_t i = 0; i < nrStrings; ++i) {
+    uint32_t const stringLength = reader.read<uint32_t>();
+    dictionary.emplace_back(reader.readBytes(stringLength), stringLength);
+  }
+
+  std::vector<AqlValue> madeHere;
+  
+  try {
+    uint64_t emptyRun = 0;
+
+    for (RegisterId column = 0; column < _nrRegs; column++) {
+      for (size_t i = 0; i < _nrItems; i++) {
+        if (emptyRun > 0) {
+          emptyRun--;
+          continue;
+        }
+
+        uint8_t const tag = reader.read<uint8_t>();
+
+        if (tag == BLOCK_EMPTY) {
+          // empty, do nothing here
+        }
+        else if (tag == BLOCK_EMPTY_RUN) {
+          emptyRun = reader.read<uint64_t>();
+          if (emptyRun == 0) {
+            THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                           "invalid empty run in binary AqlItemBlock");
+          }
+          emptyRun--;
+        }
+        else if (tag == BLOCK_RANGE) {
+          int64_t low = reader.read<int64_t>();
+          int64_t high = reader.read<int64_t>();
+          AqlValue a(low, high);
+          try {
+            setValue(i, column, a);
+          }
+          catch (...) {
+            a.destroy();
+            throw;
+          }
+        }
+        else if (tag == BLOCK_VALUE) {
+          AqlValue a(DecodeBinaryValue(reader, dictionary));
+          try {
+            setValue(i, column, a);  
+          }
+          catch (...) {
+            a.destroy();
+            throw;
+          }
+          madeHere.emplace_back(a);
+        }
+        else if (tag == BLOCK_REPEAT) {
+          uint32_t const position = reader.read<uint32_t>();
+          if (position >= madeHere.size()) {
+            THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                           "invalid repetition in binary AqlItemBlock");
+          }
+          setValue(i, column, madeHere[position]);
+          // If this throws, all is OK, because it was already put into
+          // the block elsewhere.
+        }
+        else {
+          THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                                         "found undefined data value");
+        }
+      }
+    }
+  }
+  catch (...) {
+    destroy();
+    throw;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy the block, used in the destructor and elsewhere
 ////////////////////////////////////////////////////////////////////////////////
 
 void AqlItemBlock::destroy () {
   if (_valueCount.empty()) {
+    _referencedValues.clear();
     return;
   }
 
@@ -211,6 +614,8 @@ void AqlItemBlock::destroy () {
   }
 
   _valueCount.clear();
+  // only now the values pointing into the referenced values are gone
+  _referencedValues.clear();
 }
 
 // -----------------------------------------------------------------------------
@@ -444,6 +849,7 @@ AqlItemBlock* AqlItemBlock::steal (std::vector<size_t>& chosen,
   TRI_ASSERT(from < to && to <= chosen.size());
 
   std::unique_ptr<AqlItemBlock> res(new AqlItemBlock(to - from, _nrRegs));
+  res->inheritReferencedValues(this);
 
   for (RegisterId col = 0; col < _nrRegs; col++) {
     res->_docColls[col] = _docColls[col];
@@ -513,6 +919,7 @@ AqlItemBlock* AqlItemBlock::concatenate (std::vector<AqlItemBlock*> const& block
     }
 
     TRI_ASSERT((*it) != res.get());
+    res->inheritReferencedValues(*it);
     size_t const n = (*it)->size();
     for (size_t row = 0; row < n; ++row) {
       for (RegisterId col = 0; col < nrRegs; ++col) {
@@ -619,6 +1026,127 @@ Json AqlItemBlock::toJson (triagens::arango::AqlTransaction* trx) const {
   return json;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toBinary, append the binary encoding of the whole AqlItemBlock to
+/// the buffer, see the description of the format at the top of this file
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemBlock::toBinary (triagens::arango::AqlTransaction* trx,
+                             StringBuffer& buffer) const {
+  // the entries are encoded first, because the dictionary must precede them
+  StringBuffer entries(TRI_UNKNOWN_MEM_ZONE);
+  BinaryDictionary dictionary;
+
+  std::unordered_map<AqlValue, uint32_t> table;   // remember duplicates
+
+  uint64_t emptyCount = 0;  // here we count runs of empty AqlValues
+
+  auto commitEmpties = [&] () {  // this commits an empty run to the entries
+    if (emptyCount > 0) {
+      if (emptyCount == 1) {
+        AppendBinary<uint8_t>(entries, BLOCK_EMPTY);
+      }
+      else {
+        AppendBinary<uint8_t>(entries, BLOCK_EMPTY_RUN);
+        AppendBinary<uint64_t>(entries, emptyCount);
+      }
+      emptyCount = 0;
+    }
+  };
+
+  for (RegisterId column = 0; column < _nrRegs; column++) {
+    for (size_t i = 0; i < _nrItems; i++) {
+      AqlValue const& a(_data[i * _nrRegs + column]);
+      if (a.isEmpty()) {
+        emptyCount++;
+        continue;
+      }
+
+      commitEmpties();
+
+      if (a._type == AqlValue::RANGE) {
+        AppendBinary<uint8_t>(entries, BLOCK_RANGE);
+        AppendBinary<int64_t>(entries, a._range->_low);
+        AppendBinary<int64_t>(entries, a._range->_high);
+        continue;
+      }
+
+      auto it = table.find(a);
+      if (it != table.end()) {
+        AppendBinary<uint8_t>(entries, BLOCK_REPEAT);
+        AppendBinary<uint32_t>(entries, (*it).second);
+        continue;
+      }
+
+      AppendBinary<uint8_t>(entries, BLOCK_VALUE);
+
+      if (a._type == AqlValue::INLINE) {
+        TRI_json_t inlined;
+        a.fillInlineJson(&inlined);
+        EncodeBinaryJson(entries, dictionary, &inlined);
+      }
+      else {
+        // JSON values are referenced, not copied
+        Json json(a.toJson(trx, _docColls[column], false));
+        EncodeBinaryJson(entries, dictionary, json.json());
+      }
+
+      table.emplace(a, static_cast<uint32_t>(table.size()));
+    }
+  }
+  commitEmpties();
+
+  size_t total = BinaryHeaderLength + sizeof(uint32_t) + entries.length();
+  for (auto const& it : dictionary._strings) {
+    total += sizeof(uint32_t) + it.size();
+  }
+
+  buffer.reserve(total);
+  AppendBinary<uint32_t>(buffer, BinaryMagic);
+  AppendBinary<uint64_t>(buffer, static_cast<uint64_t>(total));
+  AppendBinary<uint64_t>(buffer, static_cast<uint64_t>(_nrItems));
+  AppendBinary<uint32_t>(buffer, static_cast<uint32_t>(_nrRegs));
+
+  AppendBinary<uint32_t>(buffer, static_cast<uint32_t>(dictionary._strings.size()));
+  for (auto const& it : dictionary._strings) {
+    AppendBinary<uint32_t>(buffer, static_cast<uint32_t>(it.size()));
+    buffer.appendText(it.c_str(), it.size());
+  }
+
+  buffer.appendText(entries.begin(), entries.length());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the length of the binary encoding of an AqlItemBlock at the
+/// start of the data, throws if the data does not start with a complete one
+////////////////////////////////////////////////////////////////////////////////
+
+size_t AqlItemBlock::binaryLength (char const* data,
+                                   size_t length) {
+  BinaryReader reader(data, length);
+
+  if (reader.read<uint32_t>() != BinaryMagic) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                   "invalid binary AqlItemBlock");
+  }
+
+  uint64_t const total = reader.read<uint64_t>();
+
+  if (total < BinaryHeaderLength || total > length) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, 
+                                   "binary AqlItemBlock is truncated");
+  }
+
+  return static_cast<size_t>(total);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type of HTTP bodies that start with a binary encoded
+/// AqlItemBlock
+////////////////////////////////////////////////////////////////////////////////
+
+char const* const AqlItemBlock::BinaryContentType = "application/x-arango-aqlblock";
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
@@ -37,6 +37,10 @@
 struct TRI_document_collection_t;
 
 namespace triagens {
+  namespace basics {
+    class StringBuffer;
+  }
+
   namespace aql {
 
 // -----------------------------------------------------------------------------
@@ -80,6 +84,13 @@ namespace triagens {
 
         AqlItemBlock (triagens::basics::Json const& json);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the block from its binary encoding, note that this can throw
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock (char const* data,
+                      size_t length);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy the block
 ////////////////////////////////////////////////////////////////////////////////
@@ -259,6 +270,36 @@ namespace triagens {
           }
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keep a value alive as long as the block, because values in the
+/// block point into it without owning their memory
+////////////////////////////////////////////////////////////////////////////////
+
+        void addReferencedValue (std::shared_ptr<AqlValue> const& value) {
+          if (_referencedValues.empty() || _referencedValues.back() != value) {
+            _referencedValues.emplace_back(value);
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keep the values alive that the values of another block point into.
+/// this must be called when values are stolen from the other block
+////////////////////////////////////////////////////////////////////////////////
+
+        void inheritReferencedValues (AqlItemBlock const* other) {
+          for (auto const& it : other->_referencedValues) {
+            addReferencedValue(it);
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not values in the block may point into other values
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasReferencedValues () const {
+          return ! _referencedValues.empty();
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief getDocumentCollection
 ////////////////////////////////////////////////////////////////////////////////
@@ -361,6 +402,34 @@ namespace triagens {
 
         triagens::basics::Json toJson (triagens::arango::AqlTransaction* trx) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toBinary, append the binary encoding of the whole AqlItemBlock to
+/// the buffer, the result can be used to recreate the AqlItemBlock via the
+/// binary constructor
+////////////////////////////////////////////////////////////////////////////////
+
+        void toBinary (triagens::arango::AqlTransaction* trx,
+                       triagens::basics::StringBuffer& buffer) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the length of the binary encoding of an AqlItemBlock at the
+/// start of the data, throws if the data does not start with a complete one
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t binaryLength (char const* data,
+                                    size_t length);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type of HTTP bodies that start with a binary encoded
+/// AqlItemBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        static char const* const BinaryContentType;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -385,6 +454,13 @@ namespace triagens {
 
         std::unordered_map<AqlValue, uint32_t> _valueCount;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief _referencedValues, values owned jointly with other blocks, which
+/// values in this block point into
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::shared_ptr<AqlValue>> _referencedValues;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _docColls, for every column a possible collection, which contains
 /// all AqlValues of type SHAPED in this column.
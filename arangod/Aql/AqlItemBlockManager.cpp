@@ -29,9 +29,41 @@
 
 #include "AqlItemBlockManager.h"
 #include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionStats.h"
 
 using namespace triagens::aql;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief smallest size class which has room for the number of values.
+/// size class 0 is used for blocks without any values, size class i > 0 for
+/// blocks with room for at least 2^(i - 1) values
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t BucketForRequest (size_t n) {
+  size_t bucket = 0;
+  while (n > 0 && (static_cast<size_t>(1) << bucket) < n) {
+    ++bucket;
+  }
+  return (n == 0 ? 0 : bucket + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest size class whose requests all fit into the capacity
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t BucketForCapacity (size_t n) {
+  size_t bucket = 0;
+  while (n > 0) {
+    n >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -40,9 +72,11 @@ using namespace triagens::aql;
 /// @brief create the manager
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlItemBlockManager::AqlItemBlockManager ()
-  : _last(nullptr) {
+AqlItemBlockManager::AqlItemBlockManager (ExecutionStats* stats)
+  : _memoryUsage(0),
+    _stats(stats) {
 
+  TRI_ASSERT(_stats != nullptr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,7 +84,13 @@ AqlItemBlockManager::AqlItemBlockManager ()
 ////////////////////////////////////////////////////////////////////////////////
 
 AqlItemBlockManager::~AqlItemBlockManager () {
-  delete _last;
+  for (auto& bucket : _buckets) {
+    for (auto& block : bucket) {
+      delete block;
+    }
+  }
+
+  TRI_AddMemoryZoneUsage(TRI_AQL_MEM_ZONE, - (int64_t) _memoryUsage, 0);
 }
 
 // -----------------------------------------------------------------------------
@@ -63,17 +103,37 @@ AqlItemBlockManager::~AqlItemBlockManager () {
 
 AqlItemBlock* AqlItemBlockManager::requestBlock (size_t nrItems, 
                                                  RegisterId nrRegs) {
-  if (_last != nullptr &&
-      _last->size() == nrItems &&
-      _last->getNrRegs() == nrRegs) {
-    auto block = _last;
-    // don't hand out the same block next time
-    _last = nullptr;
+  size_t const nrValues = nrItems * nrRegs;
+  size_t const first = BucketForRequest(nrValues);
+
+  // try the matching size class first, then the next larger one
+  for (size_t i = first; i < first + 2 && i < NumBuckets; ++i) {
+    auto& bucket = _buckets[i];
+
+    if (bucket.empty()) {
+      continue;
+    }
+
+    AqlItemBlock* block = bucket.back();
+    bucket.pop_back();
+    size_t const memory = BlockMemory(block);
+    _memoryUsage -= memory;
+    TRI_AddMemoryZoneUsage(TRI_AQL_MEM_ZONE, - (int64_t) memory, 0);
+    ++_stats->blockPoolHits;
+
+    TRI_ASSERT(block->_data.capacity() >= nrValues);
+
     block->eraseAll();
+    // resizing will not reallocate, and all values are empty now
+    block->_data.resize(nrValues);
+    block->_docColls.assign(nrRegs, nullptr);
+    block->_nrItems = nrItems;
+    block->_nrRegs  = nrRegs;
 
     return block;
   }
 
+  ++_stats->blockPoolMisses;
   return new AqlItemBlock(nrItems, nrRegs);
 }
 
@@ -85,11 +145,42 @@ void AqlItemBlockManager::returnBlock (AqlItemBlock*& block) {
   TRI_ASSERT(block != nullptr);
   block->destroy();
 
-  delete _last;
-  _last = block;
+  size_t const memory = BlockMemory(block);
+  size_t const i = BucketForCapacity(block->_data.capacity());
+
+  if (i < NumBuckets &&
+      _buckets[i].size() < MaxBlocksPerBucket &&
+      _memoryUsage + memory <= MaxMemoryUsage) {
+    try {
+      _buckets[i].emplace_back(block);
+      _memoryUsage += memory;
+      TRI_AddMemoryZoneUsage(TRI_AQL_MEM_ZONE, (int64_t) memory, 0);
+      block = nullptr;
+      return;
+    }
+    catch (...) {
+      // if we cannot keep the block, we'll simply delete it
+    }
+  }
+
+  delete block;
   block = nullptr;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief approximate memory used by a block's value storage
+////////////////////////////////////////////////////////////////////////////////
+
+size_t AqlItemBlockManager::BlockMemory (AqlItemBlock const* block) {
+  return sizeof(AqlItemBlock) + 
+         block->_data.capacity() * sizeof(AqlValue) +
+         block->_docColls.capacity() * sizeof(TRI_document_collection_t const*);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -37,11 +37,18 @@ namespace triagens {
   namespace aql {
 
     class AqlItemBlock;
+    struct ExecutionStats;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                         class AqlItemBlockManager
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief per-query pool of AqlItemBlocks. returned blocks are kept in
+/// buckets by the number of values (rows x registers) they can hold without
+/// reallocating, so blocks of different shapes can be recycled
+////////////////////////////////////////////////////////////////////////////////
+
     class AqlItemBlockManager {
 
 // -----------------------------------------------------------------------------
@@ -50,11 +57,14 @@ namespace triagens {
 
       public:
 
+        AqlItemBlockManager (AqlItemBlockManager const&) = delete;
+        AqlItemBlockManager& operator= (AqlItemBlockManager const&) = delete;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create the manager
 ////////////////////////////////////////////////////////////////////////////////
 
-        AqlItemBlockManager ();
+        explicit AqlItemBlockManager (ExecutionStats*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy the manager
@@ -81,19 +91,68 @@ namespace triagens {
 
         void returnBlock (AqlItemBlock*&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory currently held by the pooled blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t memoryUsage () const {
+          return _memoryUsage;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief approximate memory used by a block's value storage
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t BlockMemory (AqlItemBlock const*);
+
 // -----------------------------------------------------------------------------
-// --SECTION--                                                 private variables
+// --SECTION--                                               private variables
 // -----------------------------------------------------------------------------
 
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief last block handed back to the manager
-/// this is the block that may be recycled
+/// @brief number of size classes. bucket i > 0 contains blocks with room for
+/// at least 2^(i - 1) values
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NumBuckets = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of blocks kept per size class
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxBlocksPerBucket = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory kept in the pool
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxMemoryUsage = 8 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the pooled blocks, by size class
 ////////////////////////////////////////////////////////////////////////////////
 
-        AqlItemBlock* _last;
+        std::vector<AqlItemBlock*> _buckets[NumBuckets];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory currently held by the pooled blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _memoryUsage;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the statistics to update with pool hits and misses
+////////////////////////////////////////////////////////////////////////////////
 
+        ExecutionStats* _stats;
     };
 
   }
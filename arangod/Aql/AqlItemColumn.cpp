@@ -0,0 +1,299 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL, column-major view of a single register of an AqlItemBlock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "AqlItemColumn.h"
+#include "Aql/AqlItemBlock.h"
+#include "Basics/json.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/shaped-json.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the attribute name is one of the system attributes
+/// that are stored in the marker and not in the shaped json
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsMarkerAttribute (char const* name) {
+  return (strcmp(name, TRI_VOC_ATTRIBUTE_KEY) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_ID) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_REV) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_FROM) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_TO) == 0);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty column
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemColumn::AqlItemColumn ()
+  : _types(),
+    _numbers(),
+    _strings(),
+    _markers() {
+
+  reset(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the column
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemColumn::~AqlItemColumn () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief load the column from a register of the block
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::load (AqlItemBlock const* block,
+                          RegisterId reg,
+                          char const* attribute) {
+  size_t const n = block->size();
+  reset(n);
+
+  TRI_document_collection_t const* document = block->getDocumentCollection(reg);
+
+  // shaped attribute lookups are resolved once per column
+  VocShaper* shaper = nullptr;
+  TRI_shape_pid_t pid = 0;
+
+  if (attribute != nullptr &&
+      document != nullptr &&
+      ! IsMarkerAttribute(attribute)) {
+    shaper = document->getShaper();
+    pid = shaper->lookupAttributePathByName(attribute);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    AqlValue const& value = block->getValueReference(i, reg);
+
+    switch (value._type) {
+      case AqlValue::JSON: {
+        TRI_json_t const* json = value._json->json();
+
+        if (attribute != nullptr) {
+          if (! TRI_IsObjectJson(json)) {
+            break;
+          }
+          json = TRI_LookupObjectJson(json, attribute);
+          if (json == nullptr) {
+            break;
+          }
+        }
+
+        switch (json->_type) {
+          case TRI_JSON_NUMBER:
+            setNumber(i, json->_value._number);
+            break;
+          case TRI_JSON_BOOLEAN:
+            setBool(i, json->_value._boolean);
+            break;
+          case TRI_JSON_STRING:
+          case TRI_JSON_STRING_REFERENCE:
+            // length includes the terminating null byte
+            setString(i, json->_value._string.data, json->_value._string.length - 1);
+            break;
+          default: {
+            break;
+          }
+        }
+        break;
+      }
+
+      case AqlValue::SHAPED: {
+        if (attribute == nullptr) {
+          setMarker(i, value._marker);
+          break;
+        }
+
+        if (pid == 0) {
+          // attribute unknown to the shaper or a system attribute
+          break;
+        }
+
+        TRI_shaped_json_t shaped;
+        TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, value._marker);
+
+        TRI_shaped_json_t json;
+        TRI_shape_t const* shape;
+
+        if (! shaper->extractShapedJson(&shaped, 0, pid, &json, &shape) ||
+            shape == nullptr) {
+          break;
+        }
+
+        switch (shape->_type) {
+          case TRI_SHAPE_NUMBER:
+            setNumber(i, *reinterpret_cast<TRI_shape_number_t const*>(json._data.data));
+            break;
+          case TRI_SHAPE_BOOLEAN:
+            setBool(i, *reinterpret_cast<TRI_shape_boolean_t const*>(json._data.data) != 0);
+            break;
+          case TRI_SHAPE_SHORT_STRING:
+          case TRI_SHAPE_LONG_STRING:
+          case TRI_SHAPE_DICTIONARY_STRING: {
+            char* data;
+            size_t length;
+
+            if (TRI_StringValueShapedJson(shape, json._data.data, &data, &length)) {
+              // length excludes the terminating null byte
+              setString(i, data, length);
+            }
+            break;
+          }
+          default: {
+            break;
+          }
+        }
+        break;
+      }
+
+      case AqlValue::INLINE: {
+        if (attribute != nullptr) {
+          // scalars do not have attributes
+          break;
+        }
+
+        switch (value._inlineType) {
+          case AqlValue::INLINE_NUMBER:
+            setNumber(i, value._number);
+            break;
+          case AqlValue::INLINE_INT64:
+            setNumber(i, static_cast<double>(value._int64));
+            break;
+          case AqlValue::INLINE_BOOL:
+            setBool(i, value._boolean);
+            break;
+          case AqlValue::INLINE_STRING:
+            setString(i, value._string, value._inlineLength);
+            break;
+          case AqlValue::INLINE_NULL:
+            break;
+        }
+        break;
+      }
+
+      default: {
+        // DOCVEC, RANGE and EMPTY values are not represented in columns
+        break;
+      }
+    }
+  }
+
+  _counts[VALUE_NONE] = n - _counts[VALUE_NUMBER] - _counts[VALUE_BOOL]
+                          - _counts[VALUE_STRING] - _counts[VALUE_SHAPED];
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the column to the specified number of rows
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::reset (size_t n) {
+  _types.assign(n, VALUE_NONE);
+  _numbers.assign(n, 0.0);
+  _strings.clear();
+  _markers.clear();
+
+  for (size_t i = 0; i <= VALUE_SHAPED; ++i) {
+    _counts[i] = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a number in the column
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::setNumber (size_t row,
+                               double value) {
+  _types[row] = VALUE_NUMBER;
+  _numbers[row] = value;
+  ++_counts[VALUE_NUMBER];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a boolean in the column
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::setBool (size_t row,
+                             bool value) {
+  _types[row] = VALUE_BOOL;
+  _numbers[row] = value ? 1.0 : 0.0;
+  ++_counts[VALUE_BOOL];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a string reference in the column
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::setString (size_t row,
+                               char const* value,
+                               size_t length) {
+  if (_strings.empty()) {
+    _strings.resize(_types.size(), std::make_pair(nullptr, 0));
+  }
+  _types[row] = VALUE_STRING;
+  _strings[row] = std::make_pair(value, length);
+  ++_counts[VALUE_STRING];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a shaped marker in the column
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlItemColumn::setMarker (size_t row,
+                               TRI_df_marker_t const* marker) {
+  if (_markers.empty()) {
+    _markers.resize(_types.size(), nullptr);
+  }
+  _types[row] = VALUE_SHAPED;
+  _markers[row] = marker;
+  ++_counts[VALUE_SHAPED];
+}
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AQL, column-major view of a single register of an AqlItemBlock
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_AQL_ITEM_COLUMN_H
+#define ARANGODB_AQL_AQL_ITEM_COLUMN_H 1
+
+#include "Basics/Common.h"
+#include "Aql/types.h"
+#include "VocBase/datafile.h"
+
+namespace triagens {
+  namespace aql {
+
+    class AqlItemBlock;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     AqlItemColumn
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a typed, column-major copy of one register (or of one top-level
+/// attribute of the values in one register) for all rows of an AqlItemBlock.
+/// The column does not own any of the values it refers to: string values and
+/// shaped markers point into the AqlItemBlock they were loaded from, so the
+/// column must not outlive the block.
+/// Rows whose value cannot be represented in the column have the type
+/// VALUE_NONE and must be handled by the caller using the regular AqlValue
+/// code path.
+////////////////////////////////////////////////////////////////////////////////
+
+    class AqlItemColumn {
+
+      public:
+
+        enum ValueType : uint8_t {
+          VALUE_NONE   = 0,
+          VALUE_NUMBER = 1,
+          VALUE_BOOL   = 2,
+          VALUE_STRING = 3,
+          VALUE_SHAPED = 4
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        AqlItemColumn (AqlItemColumn const&) = delete;
+        AqlItemColumn& operator= (AqlItemColumn const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an empty column
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemColumn ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the column
+////////////////////////////////////////////////////////////////////////////////
+
+        ~AqlItemColumn ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief load the column from a register of the block. if an attribute name
+/// is specified, the column will contain the values of this top-level
+/// attribute instead of the register values themselves
+////////////////////////////////////////////////////////////////////////////////
+
+        void load (AqlItemBlock const*,
+                   RegisterId,
+                   char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows in the column
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t size () const {
+          return _types.size();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief type of the value in the specified row
+////////////////////////////////////////////////////////////////////////////////
+
+        inline ValueType type (size_t row) const {
+          return static_cast<ValueType>(_types[row]);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows that have the specified type
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t count (ValueType type) const {
+          return _counts[type];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the type tag of all rows, as a contiguous array
+////////////////////////////////////////////////////////////////////////////////
+
+        inline uint8_t const* types () const {
+          return _types.data();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the numeric values of all rows, as a contiguous array. rows of type
+/// VALUE_BOOL contain 0 or 1, all other non-numeric rows contain 0
+////////////////////////////////////////////////////////////////////////////////
+
+        inline double const* numbers () const {
+          return _numbers.data();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the string value of a row of type VALUE_STRING. the string
+/// is not necessarily null-terminated
+////////////////////////////////////////////////////////////////////////////////
+
+        inline std::pair<char const*, size_t> const& string (size_t row) const {
+          TRI_ASSERT(type(row) == VALUE_STRING);
+          return _strings[row];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the marker of a row of type VALUE_SHAPED
+////////////////////////////////////////////////////////////////////////////////
+
+        inline TRI_df_marker_t const* marker (size_t row) const {
+          TRI_ASSERT(type(row) == VALUE_SHAPED);
+          return _markers[row];
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the column to the specified number of rows
+////////////////////////////////////////////////////////////////////////////////
+
+        void reset (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a value in the column
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumber (size_t, double);
+        void setBool (size_t, bool);
+        void setString (size_t, char const*, size_t);
+        void setMarker (size_t, TRI_df_marker_t const*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the value type for each row
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint8_t> _types;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief numeric (and boolean) values for each row
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<double> _numbers;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief string references for each row, only populated if the column
+/// contains at least one string
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<char const*, size_t>> _strings;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marker references for each row, only populated if the column
+/// contains at least one shaped value
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_df_marker_t const*> _markers;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows per value type
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _counts[VALUE_SHAPED + 1];
+
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
+// End:
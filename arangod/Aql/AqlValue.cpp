@@ -37,6 +37,25 @@ using namespace triagens::aql;
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a string value
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue AqlValue::CreateString (char const* data,
+                                 size_t length) {
+  if (length > MaxInlineStringLength) {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, data, length));
+  }
+
+  AqlValue value;
+  value._type = INLINE;
+  value._inlineType = INLINE_STRING;
+  value._inlineLength = static_cast<uint8_t>(length);
+  memcpy(value._string, data, length);
+  value._string[length] = '\0';
+  return value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief a quick method to decide whether a value is true
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +77,20 @@ bool AqlValue::isTrue () const {
       return true;
     }
   }
+  else if (_type == INLINE) {
+    switch (_inlineType) {
+      case INLINE_NULL:
+        return false;
+      case INLINE_BOOL:
+        return _boolean;
+      case INLINE_NUMBER:
+        return _number != 0.0;
+      case INLINE_INT64:
+        return _int64 != 0;
+      case INLINE_STRING:
+        return _inlineLength != 0;
+    }
+  }
   else if (_type == RANGE || _type == DOCVEC) {
     // a range or a docvec is equivalent to an array
     return true;
@@ -99,6 +132,7 @@ void AqlValue::destroy () {
       // do nothing here, since data pointers need not be freed
       break;
     }
+    case INLINE: 
     case EMPTY: {
       // do nothing
       break;
@@ -123,6 +157,11 @@ std::string AqlValue::getTypeString () const {
       return "docvec";
     case RANGE: 
       return "range";
+    case INLINE: {
+      TRI_json_t json;
+      fillInlineJson(&json);
+      return std::string("inline (") + std::string(TRI_GetTypeStringJson(&json)) + std::string(")");
+    }
     case EMPTY: 
       return "empty";
   }
@@ -166,6 +205,11 @@ AqlValue AqlValue::clone () const {
       return AqlValue(_range->_low, _range->_high);
     }
 
+    case INLINE: {
+      // inline values do not own any memory
+      return *this;
+    }
+
     case EMPTY: {
       return AqlValue();
     }
@@ -198,6 +242,10 @@ bool AqlValue::isString () const {
       return TRI_IsStringJson(json);
     }
 
+    case INLINE: {
+      return _inlineType == INLINE_STRING;
+    }
+
     case SHAPED: 
     case DOCVEC: 
     case RANGE: 
@@ -221,6 +269,10 @@ bool AqlValue::isNumber () const {
       return TRI_IsNumberJson(json);
     }
 
+    case INLINE: {
+      return (_inlineType == INLINE_NUMBER || _inlineType == INLINE_INT64);
+    }
+
     case SHAPED: 
     case DOCVEC: 
     case RANGE: 
@@ -244,6 +296,10 @@ bool AqlValue::isBoolean () const {
       return TRI_IsBooleanJson(json);
     }
 
+    case INLINE: {
+      return _inlineType == INLINE_BOOL;
+    }
+
     case SHAPED: 
     case DOCVEC: 
     case RANGE: 
@@ -266,7 +322,8 @@ bool AqlValue::isArray () const {
       return TRI_IsArrayJson(json);
     }
 
-    case SHAPED: {
+    case SHAPED: 
+    case INLINE: {
       return false;
     }
 
@@ -300,6 +357,7 @@ bool AqlValue::isObject () const {
 
     case DOCVEC: 
     case RANGE: 
+    case INLINE: 
     case EMPTY: {
       return false;
     }
@@ -328,6 +386,10 @@ bool AqlValue::isNull (bool emptyIsNull) const {
       return false;
     }
 
+    case INLINE: {
+      return _inlineType == INLINE_NULL;
+    }
+
     case EMPTY: {
       return emptyIsNull;
     }
@@ -378,6 +440,7 @@ triagens::basics::Json AqlValue::at (triagens::arango::AqlTransaction* trx,
     }
        
     case SHAPED: 
+    case INLINE: 
     case EMPTY: {
     }
   }
@@ -416,6 +479,7 @@ size_t AqlValue::arraySize () const {
     }
        
     case SHAPED: 
+    case INLINE: 
     case EMPTY: {
     }
   }
@@ -431,6 +495,14 @@ int64_t AqlValue::toInt64 () const {
   switch (_type) {
     case JSON: 
       return TRI_ToInt64Json(_json->json());
+    case INLINE: {
+      if (_inlineType == INLINE_INT64) {
+        return _int64;
+      }
+      TRI_json_t json;
+      fillInlineJson(&json);
+      return TRI_ToInt64Json(&json);
+    }
     case RANGE: {
       size_t rangeSize = _range->size();
       if (rangeSize == 1) {  
@@ -456,6 +528,11 @@ double AqlValue::toNumber (bool& failed) const {
   switch (_type) {
     case JSON: 
       return TRI_ToDoubleJson(_json->json(), failed);
+    case INLINE: {
+      TRI_json_t json;
+      fillInlineJson(&json);
+      return TRI_ToDoubleJson(&json, failed);
+    }
     case RANGE: {
       size_t rangeSize = _range->size();
       if (rangeSize == 1) {  
@@ -485,6 +562,11 @@ std::string AqlValue::toString () const {
       return std::string(json->_value._string.data, json->_value._string.length - 1);
     }
 
+    case INLINE: {
+      TRI_ASSERT(_inlineType == INLINE_STRING);
+      return std::string(_string, _inlineLength);
+    }
+
     case SHAPED: 
     case DOCVEC: 
     case RANGE: 
@@ -569,6 +651,12 @@ v8::Handle<v8::Value> AqlValue::toV8 (v8::Isolate* isolate,
       return TRI_ObjectJson(isolate, _json->json());
     }
 
+    case INLINE: {
+      TRI_json_t json;
+      fillInlineJson(&json);
+      return TRI_ObjectJson(isolate, &json);
+    }
+
     case SHAPED: {
       TRI_ASSERT(document != nullptr);
       TRI_ASSERT(_marker != nullptr);
@@ -638,6 +726,23 @@ Json AqlValue::toJson (triagens::arango::AqlTransaction* trx,
       return Json(_json->zone(), _json->json(), Json::NOFREE);
     }
 
+    case INLINE: {
+      // the inline storage may go away at any time, so always return a copy
+      switch (_inlineType) {
+        case INLINE_NULL:
+          return Json(Json::Null);
+        case INLINE_BOOL:
+          return Json(_boolean);
+        case INLINE_NUMBER:
+          return Json(_number);
+        case INLINE_INT64:
+          return Json(static_cast<double>(_int64));
+        case INLINE_STRING:
+          return Json(TRI_UNKNOWN_MEM_ZONE, _string, _inlineLength);
+      }
+      break;
+    }
+
     case SHAPED: {
       TRI_ASSERT(document != nullptr);
       TRI_ASSERT(_marker != nullptr);
@@ -733,6 +838,12 @@ uint64_t AqlValue::hash (triagens::arango::AqlTransaction* trx,
       return TRI_FastHashJson(_json->json());
     }
 
+    case INLINE: {
+      TRI_json_t json;
+      fillInlineJson(&json);
+      return TRI_FastHashJson(&json);
+    }
+
     case SHAPED: {
       TRI_ASSERT(document != nullptr);
       TRI_ASSERT(_marker != nullptr);
@@ -922,6 +1033,7 @@ Json AqlValue::extractObjectMember (triagens::arango::AqlTransaction* trx,
 
     case DOCVEC:
     case RANGE:
+    case INLINE:
     case EMPTY: {
       break;
     }
@@ -1008,6 +1120,7 @@ Json AqlValue::extractArrayMember (triagens::arango::AqlTransaction* trx,
     }
 
     case SHAPED: 
+    case INLINE: 
     case EMPTY: {
       break; // fall-through to returning null
     }
@@ -1095,6 +1208,51 @@ int AqlValue::Compare (triagens::arango::AqlTransaction* trx,
                        AqlValue const& right, 
                        TRI_document_collection_t const* rightcoll,
                        bool compareUtf8) {
+  if (left._type == AqlValue::INLINE || right._type == AqlValue::INLINE) {
+    if (left._type == AqlValue::EMPTY) {
+      return -1;
+    }
+
+    if (right._type == AqlValue::EMPTY) {
+      return 1;
+    }
+
+    // compare INLINE values using stack-allocated JSON, so there are no
+    // allocations for INLINE against INLINE or JSON
+    TRI_json_t ltmp;
+    TRI_json_t rtmp;
+    triagens::basics::Json ljson;
+    triagens::basics::Json rjson;
+    TRI_json_t const* l;
+    TRI_json_t const* r;
+
+    if (left._type == AqlValue::INLINE) {
+      left.fillInlineJson(&ltmp);
+      l = &ltmp;
+    }
+    else if (left._type == AqlValue::JSON) {
+      l = left._json->json();
+    }
+    else {
+      ljson = left.toJson(trx, leftcoll, false);
+      l = ljson.json();
+    }
+
+    if (right._type == AqlValue::INLINE) {
+      right.fillInlineJson(&rtmp);
+      r = &rtmp;
+    }
+    else if (right._type == AqlValue::JSON) {
+      r = right._json->json();
+    }
+    else {
+      rjson = right.toJson(trx, rightcoll, false);
+      r = rjson.json();
+    }
+
+    return TRI_CompareValuesJson(l, r, compareUtf8);
+  }
+
   if (left._type != right._type) {
     if (left._type == AqlValue::EMPTY) {
       return -1;
@@ -1246,6 +1404,38 @@ int AqlValue::Compare (triagens::arango::AqlTransaction* trx,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fill a (stack-allocated) TRI_json_t with the INLINE value
+////////////////////////////////////////////////////////////////////////////////
+
+void AqlValue::fillInlineJson (TRI_json_t* json) const {
+  TRI_ASSERT(_type == INLINE);
+
+  switch (_inlineType) {
+    case INLINE_NULL:
+      json->_type = TRI_JSON_NULL;
+      break;
+    case INLINE_BOOL:
+      json->_type = TRI_JSON_BOOLEAN;
+      json->_value._boolean = _boolean;
+      break;
+    case INLINE_NUMBER:
+      json->_type = TRI_JSON_NUMBER;
+      json->_value._number = _number;
+      break;
+    case INLINE_INT64:
+      json->_type = TRI_JSON_NUMBER;
+      json->_value._number = static_cast<double>(_int64);
+      break;
+    case INLINE_STRING:
+      json->_type = TRI_JSON_STRING_REFERENCE;
+      json->_value._string.data = const_cast<char*>(_string);
+      // length includes the terminating null byte
+      json->_value._string.length = static_cast<uint32_t>(_inlineLength) + 1;
+      break;
+  }
+}
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
@@ -31,6 +31,7 @@
 #include "Basics/Common.h"
 #include "Aql/Range.h"
 #include "Aql/types.h"
+#include "Basics/hashes.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/StringBuffer.h"
 #include "Utils/V8TransactionContext.h"
@@ -66,9 +67,29 @@ namespace triagens {
         JSON,      // Json*
         SHAPED,    // TRI_df_marker_t*
         DOCVEC,    // a vector of blocks of results coming from a subquery
-        RANGE      // a pointer to a range remembering lower and upper bound
+        RANGE,     // a pointer to a range remembering lower and upper bound
+        INLINE     // a small scalar value stored in the AqlValue itself
       };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief InlineType, indicates what sort of inline value we have
+////////////////////////////////////////////////////////////////////////////////
+
+      enum InlineType : uint8_t {
+        INLINE_NULL,
+        INLINE_BOOL,
+        INLINE_NUMBER,
+        INLINE_INT64,
+        INLINE_STRING
+      };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum length of a string that is stored inline, not counting the
+/// terminating null byte
+////////////////////////////////////////////////////////////////////////////////
+
+      static size_t const MaxInlineStringLength = 15;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -104,6 +125,62 @@ namespace triagens {
         _range = new Range(low, high);
       }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an inline null value
+////////////////////////////////////////////////////////////////////////////////
+
+      static AqlValue CreateNull () {
+        AqlValue value;
+        value._type = INLINE;
+        value._inlineType = INLINE_NULL;
+        return value;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an inline boolean value
+////////////////////////////////////////////////////////////////////////////////
+
+      static AqlValue CreateBool (bool b) {
+        AqlValue value;
+        value._type = INLINE;
+        value._inlineType = INLINE_BOOL;
+        value._boolean = b;
+        return value;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an inline number value
+////////////////////////////////////////////////////////////////////////////////
+
+      static AqlValue CreateNumber (double d) {
+        AqlValue value;
+        value._type = INLINE;
+        value._inlineType = INLINE_NUMBER;
+        value._number = d;
+        return value;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an inline integer value
+/// note that integers are still treated as numbers by all AQL operations
+////////////////////////////////////////////////////////////////////////////////
+
+      static AqlValue CreateInt64 (int64_t i) {
+        AqlValue value;
+        value._type = INLINE;
+        value._inlineType = INLINE_INT64;
+        value._int64 = i;
+        return value;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a string value. the string is stored inline if it is short
+/// enough, otherwise a JSON string value is created
+////////////////////////////////////////////////////////////////////////////////
+
+      static AqlValue CreateString (char const*,
+                                    size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destructor, doing nothing automatically!
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,7 +206,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
       inline bool requiresDestruction () const noexcept {
-        return (_type != EMPTY && _type != SHAPED);
+        return (_type != EMPTY && _type != SHAPED && _type != INLINE);
       }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -163,6 +240,14 @@ namespace triagens {
       inline bool isRange () const noexcept {
         return _type == RANGE;
       }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the AqlValue is an INLINE value
+////////////////////////////////////////////////////////////////////////////////
+
+      inline bool isInline () const noexcept {
+        return _type == INLINE;
+      }
       
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the shape marker
@@ -375,6 +460,14 @@ namespace triagens {
                           TRI_document_collection_t const*,
                           bool compareUtf8);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fill a (stack-allocated) TRI_json_t with the INLINE value. the 
+/// result refers to the AqlValue's memory and must not be freed or outlive
+/// the AqlValue
+////////////////////////////////////////////////////////////////////////////////
+
+      void fillInlineJson (TRI_json_t*) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -388,6 +481,10 @@ namespace triagens {
         TRI_df_marker_t const*      _marker;
         std::vector<AqlItemBlock*>* _vector;
         Range const*                _range;
+        bool                        _boolean;
+        double                      _number;
+        int64_t                     _int64;
+        char                        _string[MaxInlineStringLength + 1];
       };
       
 ////////////////////////////////////////////////////////////////////////////////
@@ -396,6 +493,18 @@ namespace triagens {
 
       AqlValueType _type;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief _inlineType, the type of an INLINE value
+////////////////////////////////////////////////////////////////////////////////
+
+      InlineType _inlineType;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief _inlineLength, the length of an INLINE string value
+////////////////////////////////////////////////////////////////////////////////
+
+      uint8_t _inlineLength;
+
     };
 
   } //closes namespace triagens::aql
@@ -429,6 +538,22 @@ namespace std {
         case triagens::aql::AqlValue::RANGE: {
           return res ^ ptrHash(x._range);
         }
+        case triagens::aql::AqlValue::INLINE: {
+          res ^= intHash(static_cast<uint32_t>(x._inlineType));
+          switch (x._inlineType) {
+            case triagens::aql::AqlValue::INLINE_NULL:
+              return res;
+            case triagens::aql::AqlValue::INLINE_BOOL:
+              return res ^ (x._boolean ? 1 : 0);
+            case triagens::aql::AqlValue::INLINE_NUMBER:
+              return res ^ std::hash<double>()(x._number);
+            case triagens::aql::AqlValue::INLINE_INT64:
+              return res ^ std::hash<int64_t>()(x._int64);
+            case triagens::aql::AqlValue::INLINE_STRING:
+              return res ^ static_cast<size_t>(TRI_FnvHashPointer(x._string, x._inlineLength));
+          }
+          return res;
+        }
         case triagens::aql::AqlValue::EMPTY: {
           return res;
         }
@@ -458,6 +583,25 @@ namespace std {
         case triagens::aql::AqlValue::RANGE: {
           return a._range == b._range;
         }
+        case triagens::aql::AqlValue::INLINE: {
+          if (a._inlineType != b._inlineType) {
+            return false;
+          }
+          switch (a._inlineType) {
+            case triagens::aql::AqlValue::INLINE_NULL:
+              return true;
+            case triagens::aql::AqlValue::INLINE_BOOL:
+              return a._boolean == b._boolean;
+            case triagens::aql::AqlValue::INLINE_NUMBER:
+              return a._number == b._number;
+            case triagens::aql::AqlValue::INLINE_INT64:
+              return a._int64 == b._int64;
+            case triagens::aql::AqlValue::INLINE_STRING:
+              return (a._inlineLength == b._inlineLength &&
+                      memcmp(a._string, b._string, a._inlineLength) == 0);
+          }
+          return false;
+        }
         // case triagens::aql::AqlValue::EMPTY intentionally not handled here!
         // (should fall through and fail!)
 
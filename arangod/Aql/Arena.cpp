@@ -1,5 +1,5 @@
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Aql, short string storage
+/// @brief Aql, query-scoped memory arena
 ///
 /// @file
 ///
@@ -27,7 +27,7 @@
 /// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "ShortStringStorage.h"
+#include "Arena.h"
 #include "Basics/Exceptions.h"
 
 using namespace triagens::aql;
@@ -37,36 +37,46 @@ using namespace triagens::aql;
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief maximum length of a "short" string
+/// @brief maximum length of a string that should be stored in the arena
 ////////////////////////////////////////////////////////////////////////////////
         
-size_t const ShortStringStorage::MaxStringLength = 127;
+size_t const Arena::MaxStringLength = 127;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief alignment of all allocations
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const Arena::Alignment = 2 * sizeof(void*);
       
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief create a short string storage instance
+/// @brief create an arena with the specified block size
 ////////////////////////////////////////////////////////////////////////////////
 
-ShortStringStorage::ShortStringStorage (size_t blockSize) 
+Arena::Arena (size_t blockSize) 
   : _blocks(),
     _blockSize(blockSize),
     _current(nullptr),
-    _end(nullptr) {
+    _end(nullptr),
+    _memoryUsage(0) {
 
-  TRI_ASSERT(blockSize >= 64);
+  TRI_ASSERT(blockSize >= 256);
+  TRI_ASSERT(blockSize % Alignment == 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief destroy a short string storage instance
+/// @brief destroy the arena, freeing all memory
 ////////////////////////////////////////////////////////////////////////////////
 
-ShortStringStorage::~ShortStringStorage () {
+Arena::~Arena () {
   for (auto& it : _blocks) {
     delete[] it;
   }      
+
+  TRI_AddMemoryZoneUsage(TRI_AQL_MEM_ZONE, - (int64_t) _memoryUsage, - (int64_t) _blocks.size());
 }
 
 // -----------------------------------------------------------------------------
@@ -74,27 +84,61 @@ ShortStringStorage::~ShortStringStorage () {
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief register a short string
+/// @brief allocate memory from the arena
 ////////////////////////////////////////////////////////////////////////////////
 
-char* ShortStringStorage::registerString (char const* p,
-                                          size_t length) {
-  TRI_ASSERT_EXPENSIVE(length <= MaxStringLength);
+void* Arena::allocate (size_t length) {
+  // round up to the alignment so the next allocation is aligned, too
+  length = (length + Alignment - 1) & ~(Alignment - 1);
+
+  if (length > _blockSize / 4) {
+    // big allocations get a block of their own, so the remainder of the
+    // current block is not wasted
+    return allocateBlock(length);
+  }
 
-  if (_current == nullptr || (_current + length + 1 > _end)) {
-    allocateBlock();
+  if (_current == nullptr || _current + length > _end) {
+    _current = allocateBlock(_blockSize);
+    _end     = _current + _blockSize;
   }
 
-  TRI_ASSERT_EXPENSIVE(! _blocks.empty());
-  TRI_ASSERT_EXPENSIVE(_current != nullptr);
-  TRI_ASSERT_EXPENSIVE(_end != nullptr);
-  TRI_ASSERT_EXPENSIVE(_current + length + 1 <= _end);
+  TRI_ASSERT_EXPENSIVE(_current + length <= _end);
 
+  void* position = _current;
+  _current += length;
+
+  return position;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy a string into the arena and null-terminate it
+////////////////////////////////////////////////////////////////////////////////
+
+char* Arena::registerString (char const* p,
+                             size_t length) {
+  TRI_ASSERT_EXPENSIVE(length <= MaxStringLength);
+
+  if (_current == nullptr || _current + length + 1 > _end) {
+    _current = allocateBlock(_blockSize);
+    _end     = _current + _blockSize;
+  }
+
+  // strings need no alignment, so they are packed into the current block
   char* position = _current;
   memcpy(static_cast<void*>(position), p, length);
-  _current[length] = '\0';
+  position[length] = '\0';
   _current += length + 1;
 
+  // re-establish the alignment for the next allocate() call
+  size_t const misalignment = reinterpret_cast<uintptr_t>(_current) & (Alignment - 1);
+
+  if (misalignment != 0) {
+    _current += Alignment - misalignment;
+    if (_current > _end) {
+      _current = _end;
+    }
+  }
+
   return position;
 }
 
@@ -103,21 +147,25 @@ char* ShortStringStorage::registerString (char const* p,
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief allocate a new block of memory
+/// @brief allocate a new block of memory of the specified size
 ////////////////////////////////////////////////////////////////////////////////
 
-void ShortStringStorage::allocateBlock () {
-  char* buffer = new char[_blockSize];
+char* Arena::allocateBlock (size_t size) {
+  // memory returned by new[] is suitably aligned for any type
+  char* buffer = new char[size];
 
   try {
     _blocks.emplace_back(buffer);
-    _current = buffer;
-    _end     = _current + _blockSize;
   }
   catch (...) {
     delete[] buffer;
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
+
+  _memoryUsage += size;
+  TRI_AddMemoryZoneUsage(TRI_AQL_MEM_ZONE, (int64_t) size, 1);
+
+  return buffer;
 }
 
 // -----------------------------------------------------------------------------
@@ -1,5 +1,5 @@
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Aql, short string storage
+/// @brief Aql, query-scoped memory arena
 ///
 /// @file
 ///
@@ -27,8 +27,8 @@
 /// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifndef ARANGODB_AQL_SHORT_STRING_STORAGE_H
-#define ARANGODB_AQL_SHORT_STRING_STORAGE_H 1
+#ifndef ARANGODB_AQL_ARENA_H
+#define ARANGODB_AQL_ARENA_H 1
 
 #include "Basics/Common.h"
 
@@ -36,10 +36,16 @@ namespace triagens {
   namespace aql {
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                          class ShortStringStorage
+// --SECTION--                                                       class Arena
 // -----------------------------------------------------------------------------
 
-    class ShortStringStorage {
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bump-pointer memory arena. memory handed out by the arena cannot be
+/// freed individually, but is released all at once when the arena is
+/// destroyed. the arena does not call destructors of objects placed in it
+////////////////////////////////////////////////////////////////////////////////
+
+    class Arena {
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
@@ -47,33 +53,60 @@ namespace triagens {
  
       public:
 
-        ShortStringStorage (ShortStringStorage const&) = delete;
-        ShortStringStorage& operator= (ShortStringStorage const&) = delete;
+        Arena (Arena const&) = delete;
+        Arena& operator= (Arena const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an arena with the specified block size
+////////////////////////////////////////////////////////////////////////////////
      
-        explicit ShortStringStorage (size_t);
+        explicit Arena (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the arena, freeing all memory
+////////////////////////////////////////////////////////////////////////////////
         
-        ~ShortStringStorage ();
+        ~Arena ();
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocate memory from the arena. the memory is suitably aligned for
+/// any object type
+////////////////////////////////////////////////////////////////////////////////
+
+        void* allocate (size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief register a short string
+/// @brief copy a string into the arena and null-terminate it
 ////////////////////////////////////////////////////////////////////////////////
  
         char* registerString (char const*, 
                               size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total amount of memory allocated by the arena
+////////////////////////////////////////////////////////////////////////////////
+
+        inline size_t memoryUsage () const {
+          return _memoryUsage;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
 
+      private:
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief allocate a new block of memory
+/// @brief allocate a new block of memory of the specified size
 ////////////////////////////////////////////////////////////////////////////////
 
-        void allocateBlock ();
+        char* allocateBlock (size_t);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
@@ -82,11 +115,17 @@ namespace triagens {
       public:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief maximum length of strings in short string storage
+/// @brief maximum length of strings that should be stored in the arena
 ////////////////////////////////////////////////////////////////////////////////
 
         static size_t const MaxStringLength;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief alignment of all allocations
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const Alignment;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -94,13 +133,13 @@ namespace triagens {
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief already allocated string blocks
+/// @brief already allocated blocks
 ////////////////////////////////////////////////////////////////////////////////
 
         std::vector<char*> _blocks;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief size of each block
+/// @brief size of each regular block
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t const _blockSize;
@@ -116,6 +155,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         char* _end;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total amount of memory allocated by the arena
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _memoryUsage;
     };
 
   }
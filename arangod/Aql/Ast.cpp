@@ -617,6 +617,53 @@ AstNode* Ast::createNodeLimit (AstNode const* offset,
   return node;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an AST window node. each aggregate is given as an assign
+/// node with a function call, e.g. total = SUM(doc.value). it is stored as
+/// an array of the variable, the function name and the argument, so that
+/// the call is never evaluated as an expression. the name is null if the
+/// expression is not a call with a single argument, which is reported when
+/// the execution plan is created
+////////////////////////////////////////////////////////////////////////////////
+
+AstNode* Ast::createNodeWindow (AstNode const* frame,
+                                AstNode const* list) {
+  AstNode* node = createNode(NODE_TYPE_WINDOW);
+  node->addMember(frame);
+
+  AstNode* aggregates = createNodeArray();
+  size_t const n = list->numMembers();
+
+  for (size_t i = 0; i < n; ++i) {
+    auto assigner = list->getMember(i);
+    TRI_ASSERT(assigner->type == NODE_TYPE_ASSIGN);
+
+    auto expression = assigner->getMember(1);
+    AstNode* name;
+
+    if (expression->type == NODE_TYPE_FCALL &&
+        expression->getMember(0)->numMembers() == 1) {
+      auto func = static_cast<Function const*>(expression->getData());
+      char* p = _query->registerString(func->externalName);
+      name = createNodeValueString(p, func->externalName.size());
+      expression = expression->getMember(0)->getMember(0);
+    }
+    else {
+      name = createNodeValueNull();
+    }
+
+    AstNode* aggregate = createNodeArray();
+    aggregate->addMember(assigner->getMember(0));
+    aggregate->addMember(name);
+    aggregate->addMember(expression);
+    aggregates->addMember(aggregate);
+  }
+
+  node->addMember(aggregates);
+
+  return node;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an AST assign node, used in COLLECT statements
 ////////////////////////////////////////////////////////////////////////////////
@@ -1255,11 +1302,70 @@ AstNode* Ast::createNodeNaryOperator (AstNodeType type,
   return node;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the values of the bind parameters can be left out of
+/// the AST while the execution plan is created
+////////////////////////////////////////////////////////////////////////////////
+
+bool Ast::canKeepBindParameters () const {
+  auto containsParameter = [] (AstNode const* node) -> bool {
+    bool found = false;
+
+    traverseReadOnly(node, [&](AstNode const* member, void*) -> void {
+      if (member->type == NODE_TYPE_PARAMETER) {
+        found = true;
+      }
+    }, nullptr);
+
+    return found;
+  };
+
+  bool result = true;
+
+  traverseReadOnly(_root, [&](AstNode const* node, void*) -> void {
+    switch (node->type) {
+      case NODE_TYPE_BOUND_ATTRIBUTE_ACCESS:
+        // the attribute name must be known
+        result = false;
+        break;
+
+      case NODE_TYPE_LIMIT:
+        // the plan contains the offset and count values
+        if (containsParameter(node)) {
+          result = false;
+        }
+        break;
+
+      case NODE_TYPE_WINDOW:
+      case NODE_TYPE_REMOVE:
+      case NODE_TYPE_INSERT:
+      case NODE_TYPE_UPDATE:
+      case NODE_TYPE_REPLACE:
+      case NODE_TYPE_UPSERT:
+      case NODE_TYPE_COLLECT:
+      case NODE_TYPE_COLLECT_COUNT:
+      case NODE_TYPE_COLLECT_EXPRESSION:
+        // the window frame and the options are evaluated when the plan is
+        // created
+        if (containsParameter(node->getMember(0))) {
+          result = false;
+        }
+        break;
+
+      default: {
+      }
+    }
+  }, nullptr);
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief injects bind parameters into the AST
 ////////////////////////////////////////////////////////////////////////////////
 
-void Ast::injectBindParameters (BindParameters& parameters) {
+void Ast::injectBindParameters (BindParameters& parameters,
+                                bool keepValues) {
   auto p = parameters();
 
   auto func = [&](AstNode* node, void*) -> AstNode* {
@@ -1317,6 +1423,10 @@ void Ast::injectBindParameters (BindParameters& parameters) {
           }
         }
       }
+      else if (keepValues) {
+        // the value is put into the execution plan later
+        TRI_ASSERT(value != nullptr);
+      }
       else {
         node = nodeFromJson(value, false);
 
@@ -2864,14 +2974,15 @@ std::pair<std::string, bool> Ast::normalizeFunctionName (char const* name) {
 AstNode* Ast::createNode (AstNodeType type) {
   TRI_ASSERT(_query != nullptr);
 
-  auto node = new AstNode(type);
+  auto node = new (_query->arena()) AstNode(type);
 
   try {
-    // register the node so it gets freed automatically later
+    // register the node so it gets destructed automatically later
     _query->addNode(node);
   }
   catch (...) {
-    delete node;
+    // node memory is owned by the arena
+    node->~AstNode();
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
 
@@ -202,6 +202,15 @@ namespace triagens {
           return _functionsMayAccessDocuments;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief note that function calls may access collection documents. this is
+/// used when the plan is not created from the query string
+////////////////////////////////////////////////////////////////////////////////
+
+        void setFunctionsMayAccessDocuments () {
+          _functionsMayAccessDocuments = true;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief convert the AST into JSON
 /// the caller is responsible for freeing the JSON later
@@ -389,6 +398,13 @@ namespace triagens {
         AstNode* createNodeLimit (AstNode const*,
                                   AstNode const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an AST window node
+////////////////////////////////////////////////////////////////////////////////
+
+        AstNode* createNodeWindow (AstNode const*,
+                                   AstNode const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an AST assign node
 ////////////////////////////////////////////////////////////////////////////////
@@ -622,10 +638,21 @@ namespace triagens {
                                          AstNode const*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief injects bind parameters into the AST
+/// @brief whether or not the values of the bind parameters can be left out of
+/// the AST while the execution plan is created. this is not possible if the
+/// plan needs a value, e.g. for LIMIT, OPTIONS or a bound attribute name
+////////////////////////////////////////////////////////////////////////////////
+
+        bool canKeepBindParameters () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief injects bind parameters into the AST. if the last parameter is
+/// true, only collection parameters are injected, and the other parameters
+/// are left in the AST as parameter nodes
 ////////////////////////////////////////////////////////////////////////////////
 
-        void injectBindParameters (BindParameters&);
+        void injectBindParameters (BindParameters&,
+                                   bool = false);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief replace variables
@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Aql/AstNode.h"
+#include "Aql/Arena.h"
 #include "Aql/Ast.h"
 #include "Aql/Executor.h"
 #include "Aql/Function.h"
@@ -156,7 +157,8 @@ std::unordered_map<int, std::string const> const AstNode::TypeNames{
   { static_cast<int>(NODE_TYPE_ARRAY_LIMIT),              "array limit" },
   { static_cast<int>(NODE_TYPE_DISTINCT),                 "distinct" },
   { static_cast<int>(NODE_TYPE_OPERATOR_NARY_AND),        "n-ary and" },
-  { static_cast<int>(NODE_TYPE_OPERATOR_NARY_OR),         "n-ary or" }
+  { static_cast<int>(NODE_TYPE_OPERATOR_NARY_OR),         "n-ary or" },
+  { static_cast<int>(NODE_TYPE_WINDOW),                   "window" }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -576,6 +578,7 @@ AstNode::AstNode (Ast* ast,
     case NODE_TYPE_SORT:
     case NODE_TYPE_SORT_ELEMENT:
     case NODE_TYPE_LIMIT:
+    case NODE_TYPE_WINDOW:
     case NODE_TYPE_ASSIGN:
     case NODE_TYPE_OPERATOR_UNARY_PLUS:
     case NODE_TYPE_OPERATOR_UNARY_MINUS:
@@ -625,7 +628,7 @@ AstNode::AstNode (Ast* ast,
         addMember(Ast::getNodeNop());
       }
       else {
-        addMember(new AstNode(ast, subNode));
+        addMember(new (query->arena()) AstNode(ast, subNode));
       }
     }
   }
@@ -644,6 +647,25 @@ AstNode::~AstNode () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocate memory for a node from the arena
+////////////////////////////////////////////////////////////////////////////////
+
+void* AstNode::operator new (size_t size,
+                             Arena* arena) {
+  TRI_ASSERT(arena != nullptr);
+  return arena->allocate(size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called if a node constructor throws. the memory will be released
+/// together with the arena
+////////////////////////////////////////////////////////////////////////////////
+
+void AstNode::operator delete (void*,
+                               Arena*) {
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -1350,6 +1372,13 @@ bool AstNode::isSimple () const {
     return true;
   }
 
+  if (type == NODE_TYPE_PARAMETER) {
+    // only found in plans for the plan cache. the parameter is replaced with
+    // its value before the plan is executed
+    setFlag(DETERMINED_SIMPLE, VALUE_SIMPLE);
+    return true;
+  }
+
   if (type == NODE_TYPE_ARRAY ||
       type == NODE_TYPE_OBJECT ||
       type == NODE_TYPE_EXPANSION ||
@@ -45,6 +45,7 @@ namespace triagens {
   }
 
   namespace aql {
+    class Arena;
     class Ast;
     struct Variable;
 
@@ -181,7 +182,8 @@ namespace triagens {
       NODE_TYPE_ARRAY_LIMIT                   = 57,
       NODE_TYPE_DISTINCT                      = 58,
       NODE_TYPE_OPERATOR_NARY_AND             = 59,
-      NODE_TYPE_OPERATOR_NARY_OR              = 60
+      NODE_TYPE_OPERATOR_NARY_OR              = 60,
+      NODE_TYPE_WINDOW                        = 61
     };
 
     static_assert(NODE_TYPE_VALUE < NODE_TYPE_ARRAY,  "incorrect node types order");
@@ -249,6 +251,16 @@ namespace triagens {
 
       ~AstNode ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief nodes can only be created in a query's arena. the memory is
+/// released together with the arena, so nodes must not be deleted but only
+/// destructed
+////////////////////////////////////////////////////////////////////////////////
+
+      static void* operator new (size_t, Arena*);
+      static void operator delete (void*, Arena*);
+      static void operator delete (void*) = delete;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -102,6 +102,8 @@ int SingletonBlock::getOrSkipSome (size_t,   // atLeast,
     try {
       if (_inputRegisterValues != nullptr) {
         skipped++;
+        result->inheritReferencedValues(_inputRegisterValues);
+
         for (RegisterId reg = 0; reg < _inputRegisterValues->getNrRegs(); ++reg) {
 
           TRI_IF_FAILURE("SingletonBlock::getOrSkipSome") {
@@ -484,6 +486,7 @@ AqlItemBlock* ReturnBlock::getSome (size_t atLeast,
   RegisterId const registerId = it->second.registerId;
 
   std::unique_ptr<AqlItemBlock> stripped(new AqlItemBlock(n, 1));
+  stripped->inheritReferencedValues(res.get());
 
   for (size_t i = 0; i < n; i++) {
     auto a = res->getValueReference(i, registerId);
@@ -27,7 +27,9 @@
 
 #include "CalculationBlock.h"
 #include "Aql/ExecutionEngine.h"
+#include "Aql/ExecutionPlan.h"
 #include "Aql/Functions.h"
+#include "Aql/Query.h"
 #include "Basics/ScopeGuard.h"
 #include "Basics/Exceptions.h"
 #include "V8/v8-globals.h"
@@ -39,6 +41,141 @@ using namespace triagens::aql;
 
 using Json = triagens::basics::Json;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply a unary kernel to a whole column
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename F>
+static inline void ApplyColumnKernel (double const* values,
+                                      double* results,
+                                      size_t n,
+                                      F const& kernel) {
+  for (size_t i = 0; i < n; ++i) {
+    results[i] = kernel(values[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute a binary operator with one constant operand on a whole
+/// column of numbers. comparison results are returned as 1.0 (true) or
+/// 0.0 (false)
+////////////////////////////////////////////////////////////////////////////////
+
+static void ExecuteColumnOperator (AstNodeType type,
+                                   double const* values,
+                                   double c,
+                                   bool constantLeft,
+                                   double* results,
+                                   size_t n) {
+  if (constantLeft) {
+    // normalize comparisons so that the column is always the left operand
+    switch (type) {
+      case NODE_TYPE_OPERATOR_BINARY_LT:
+        type = NODE_TYPE_OPERATOR_BINARY_GT;
+        break;
+      case NODE_TYPE_OPERATOR_BINARY_LE:
+        type = NODE_TYPE_OPERATOR_BINARY_GE;
+        break;
+      case NODE_TYPE_OPERATOR_BINARY_GT:
+        type = NODE_TYPE_OPERATOR_BINARY_LT;
+        break;
+      case NODE_TYPE_OPERATOR_BINARY_GE:
+        type = NODE_TYPE_OPERATOR_BINARY_LE;
+        break;
+      default: {
+        break;
+      }
+    }
+  }
+
+  switch (type) {
+    case NODE_TYPE_OPERATOR_BINARY_PLUS:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return v + c; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_MINUS:
+      if (constantLeft) {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return c - v; });
+      }
+      else {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return v - c; });
+      }
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_TIMES:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return v * c; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_DIV:
+      // division by zero is handled by the caller
+      if (constantLeft) {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return c / v; });
+      }
+      else {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return v / c; });
+      }
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_MOD:
+      if (constantLeft) {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return fmod(c, v); });
+      }
+      else {
+        ApplyColumnKernel(values, results, n, [c] (double v) { return fmod(v, c); });
+      }
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v == c) ? 1.0 : 0.0; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v != c) ? 1.0 : 0.0; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v < c) ? 1.0 : 0.0; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v <= c) ? 1.0 : 0.0; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v > c) ? 1.0 : 0.0; });
+      break;
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+      ApplyColumnKernel(values, results, n, [c] (double v) { return (v >= c) ? 1.0 : 0.0; });
+      break;
+    default: {
+      TRI_ASSERT(false);
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the operator is a comparison operator that is
+/// supported by the columnar execution
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool IsColumnarComparison (AstNodeType type) {
+  return (type == NODE_TYPE_OPERATOR_BINARY_EQ ||
+          type == NODE_TYPE_OPERATOR_BINARY_NE ||
+          type == NODE_TYPE_OPERATOR_BINARY_LT ||
+          type == NODE_TYPE_OPERATOR_BINARY_LE ||
+          type == NODE_TYPE_OPERATOR_BINARY_GT ||
+          type == NODE_TYPE_OPERATOR_BINARY_GE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the operator is an arithmetic operator that is
+/// supported by the columnar execution
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool IsColumnarArithmetic (AstNodeType type) {
+  return (type == NODE_TYPE_OPERATOR_BINARY_PLUS ||
+          type == NODE_TYPE_OPERATOR_BINARY_MINUS ||
+          type == NODE_TYPE_OPERATOR_BINARY_TIMES ||
+          type == NODE_TYPE_OPERATOR_BINARY_DIV ||
+          type == NODE_TYPE_OPERATOR_BINARY_MOD);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            class CalculationBlock
 // -----------------------------------------------------------------------------
@@ -49,7 +186,15 @@ CalculationBlock::CalculationBlock (ExecutionEngine* engine,
     _expression(en->expression()),
     _inVars(),
     _inRegs(),
-    _outReg(ExecutionNode::MaxRegisterId) {
+    _outReg(ExecutionNode::MaxRegisterId),
+    _isColumnar(false),
+    _columnarConstantLeft(false),
+    _columnarConstant(0.0),
+    _columnarAttribute(nullptr),
+    _column(),
+    _columnResults(),
+    _compiled(nullptr),
+    _compiledContext() {
 
   std::unordered_set<Variable const*> inVars;
   _expression->variables(inVars);
@@ -85,6 +230,22 @@ CalculationBlock::CalculationBlock (ExecutionEngine* engine,
     _conditionReg = it->second.registerId;
     TRI_ASSERT(_conditionReg < ExecutionNode::MaxRegisterId);
   }
+
+  // check if the expression can be executed on whole columns
+  if (! _isReference &&
+      en->_conditionVariable == nullptr &&
+      engine->getQuery()->columnar()) {
+    _isColumnar = setupColumnarExecution();
+  }
+
+  if (! _isReference) {
+    // the program is compiled only once per plan and shared by all blocks
+    _compiled = en->_plan->getCompiledExpression(_expression);
+
+    if (_compiled != nullptr) {
+      _compiled->bind(_compiledContext, _inVars, _inRegs);
+    }
+  }
 }
 
 CalculationBlock::~CalculationBlock () {
@@ -141,14 +302,13 @@ void CalculationBlock::executeExpression (AqlItemBlock* result) {
         TRI_IF_FAILURE("CalculationBlock::executeExpressionWithCondition") {
           THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
         }
-        result->setValue(i, _outReg, AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, &Expression::NullJson, Json::NOFREE)));
+        result->setValue(i, _outReg, AqlValue::CreateNull());
         continue;
       }
     }
     
     // execute the expression
-    TRI_document_collection_t const* myCollection = nullptr;
-    AqlValue a = _expression->execute(_trx, result, i, _inVars, _inRegs, &myCollection);
+    AqlValue a = executeRow(result, i);
     
     try {
       TRI_IF_FAILURE("CalculationBlock::executeExpression") {
@@ -164,6 +324,138 @@ void CalculationBlock::executeExpression (AqlItemBlock* result) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the expression for a single row
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue CalculationBlock::executeRow (AqlItemBlock* result,
+                                       size_t row) {
+  TRI_document_collection_t const* myCollection = nullptr;
+
+  if (_compiled != nullptr) {
+    return _compiled->execute(_expression, _compiledContext, _trx, result, row, _inVars, _inRegs, &myCollection);
+  }
+
+  return _expression->execute(_trx, result, row, _inVars, _inRegs, &myCollection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether the expression can be executed on a whole column
+/// at once. this is the case for arithmetic and comparison operators with
+/// one numeric constant operand, and a variable or a top-level attribute
+/// of a variable as the other operand
+////////////////////////////////////////////////////////////////////////////////
+
+bool CalculationBlock::setupColumnarExecution () {
+  if (_inRegs.size() != 1 || _expression->isV8()) {
+    return false;
+  }
+
+  AstNode const* node = _expression->node();
+
+  if ((! IsColumnarComparison(node->type) && ! IsColumnarArithmetic(node->type)) ||
+      node->numMembers() != 2) {
+    return false;
+  }
+
+  AstNode const* lhs = node->getMember(0);
+  AstNode const* rhs = node->getMember(1);
+  AstNode const* constant;
+  AstNode const* operand;
+
+  if (lhs->isNumericValue()) {
+    constant = lhs;
+    operand = rhs;
+    _columnarConstantLeft = true;
+  }
+  else if (rhs->isNumericValue()) {
+    constant = rhs;
+    operand = lhs;
+    _columnarConstantLeft = false;
+  }
+  else {
+    return false;
+  }
+
+  _columnarConstant = constant->getDoubleValue();
+
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_DIV &&
+      ! _columnarConstantLeft &&
+      _columnarConstant == 0.0) {
+    // division by zero will produce a warning for each row
+    return false;
+  }
+
+  if (operand->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+    _columnarAttribute = operand->getStringValue();
+    operand = operand->getMember(0);
+  }
+
+  if (operand->type != NODE_TYPE_REFERENCE) {
+    return false;
+  }
+
+  TRI_ASSERT(static_cast<Variable const*>(operand->getData()) == _inVars[0]);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the expression for all rows of the block at once
+////////////////////////////////////////////////////////////////////////////////
+
+void CalculationBlock::executeExpressionColumnar (AqlItemBlock* result) {
+  _column.load(result, _inRegs[0], _columnarAttribute);
+
+  if (_column.count(AqlItemColumn::VALUE_NUMBER) == 0) {
+    // nothing to gain here
+    executeExpression(result);
+    return;
+  }
+
+  result->setDocumentCollection(_outReg, nullptr);
+
+  size_t const n = result->size();
+  AstNodeType const type = _expression->node()->type;
+  bool const isComparison = IsColumnarComparison(type);
+  bool const checkDivisor = (_columnarConstantLeft && 
+                             (type == NODE_TYPE_OPERATOR_BINARY_DIV));
+
+  _columnResults.resize(n);
+  double const* values = _column.numbers();
+  double* results = _columnResults.data();
+
+  ExecuteColumnOperator(type, values, _columnarConstant, _columnarConstantLeft, results, n);
+
+  for (size_t i = 0; i < n; i++) {
+    AqlValue a;
+
+    if (_column.type(i) != AqlItemColumn::VALUE_NUMBER ||
+        (checkDivisor && values[i] == 0.0)) {
+      // the value is not a number, or the calculation will produce a warning
+      a = executeRow(result, i);
+    }
+    else if (isComparison) {
+      a = AqlValue::CreateBool(results[i] != 0.0);
+    }
+    else {
+      a = AqlValue::CreateNumber(results[i]);
+    }
+    
+    try {
+      TRI_IF_FAILURE("CalculationBlock::executeExpression") {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+      }
+      result->setValue(i, _outReg, a);
+    }
+    catch (...) {
+      a.destroy();
+      throw;
+    }
+  }
+
+  throwIfKilled(); // check if we were aborted
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief doEvaluation, private helper to do the work
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,7 +480,12 @@ void CalculationBlock::doEvaluation (AqlItemBlock* result) {
 
     Functions::InitializeThreadContext();
     try {
-      executeExpression(result);
+      if (_isColumnar) {
+        executeExpressionColumnar(result);
+      }
+      else {
+        executeExpression(result);
+      }
       Functions::DestroyThreadContext();
     }
     catch (...) {
@@ -197,7 +494,10 @@ void CalculationBlock::doEvaluation (AqlItemBlock* result) {
     }
   }
   else {
-    bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster();
+    // in the cluster and for streaming cursors, the next batch may be
+    // requested from a different thread
+    bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster() ||
+                                    _engine->getQuery()->isStreaming();
 
     // must have a V8 context here to protect Expression::execute()
     triagens::basics::ScopeGuard guard{
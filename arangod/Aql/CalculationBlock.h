@@ -28,6 +28,8 @@
 #ifndef ARANGODB_AQL_CALCULATION_BLOCK_H
 #define ARANGODB_AQL_CALCULATION_BLOCK_H 1
 
+#include "Aql/AqlItemColumn.h"
+#include "Aql/CompiledExpression.h"
 #include "Aql/ExecutionBlock.h"
 #include "Aql/ExecutionNode.h"
 #include "Utils/AqlTransaction.h"
@@ -69,6 +71,29 @@ namespace triagens {
 
         void executeExpression (AqlItemBlock*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the expression for a single row, using the compiled
+/// program if there is one
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue executeRow (AqlItemBlock*,
+                             size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether the expression can be executed on a whole column
+/// at once, and set up the columnar execution if so
+////////////////////////////////////////////////////////////////////////////////
+
+        bool setupColumnarExecution ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the expression for all rows of the block at once, using
+/// a typed column of the input register. rows that cannot be handled in the
+/// column are executed using the regular expression code path
+////////////////////////////////////////////////////////////////////////////////
+
+        void executeExpressionColumnar (AqlItemBlock*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief doEvaluation, private helper to do the work
 ////////////////////////////////////////////////////////////////////////////////
@@ -122,6 +147,57 @@ namespace triagens {
 
         bool _isReference;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the expression is executed column-wise
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _isColumnar;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the constant is the left operand of the columnar
+/// expression
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _columnarConstantLeft;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the constant operand of the columnar expression
+////////////////////////////////////////////////////////////////////////////////
+
+        double _columnarConstant;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the accessed attribute of the columnar expression, or a nullptr
+/// if the register value is used directly
+////////////////////////////////////////////////////////////////////////////////
+
+        char const* _columnarAttribute;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input column, reused for all blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemColumn _column;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief results of the columnar expression, reused for all blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<double> _columnResults;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the compiled program of the expression, owned by the plan. this
+/// is a nullptr if the expression is not compiled
+////////////////////////////////////////////////////////////////////////////////
+
+        CompiledExpression const* _compiled;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execution state of the compiled program, reused for all rows
+////////////////////////////////////////////////////////////////////////////////
+
+        CompiledExpression::Context _compiledContext;
+
     };
 
   }  // namespace triagens::aql
@@ -54,6 +54,26 @@ using StringBuffer = triagens::basics::StringBuffer;
 #define LEAVE_BLOCK
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum read-ahead factor of a RemoteBlock
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxPrefetchFactor = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a RemoteBlock requests at most this many bytes at once, estimated
+/// from the size of the rows received so far
+////////////////////////////////////////////////////////////////////////////////
+
+static double const MaxTransferSize = 16.0 * 1024.0 * 1024.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a RemoteBlock waiting longer than this for a read-ahead request
+/// (in seconds) increases its read-ahead factor
+////////////////////////////////////////////////////////////////////////////////
+
+static double const PrefetchWaitThreshold = 0.001;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 class GatherBlock
 // -----------------------------------------------------------------------------
@@ -232,6 +252,14 @@ bool GatherBlock::hasMore () {
     }
   }
   else {
+    // send the requests to all shards first, so that their round trips
+    // overlap
+    for (size_t i = 0; i < _gatherBlockBuffer.size(); i++) { 
+      if (_gatherBlockBuffer.at(i).empty()) {
+        prefetch(i, DefaultBatchSize, DefaultBatchSize);
+      }
+    }
+
     for (size_t i = 0; i < _gatherBlockBuffer.size(); i++) { 
       if (! _gatherBlockBuffer.at(i).empty()) {
         return true;
@@ -259,14 +287,24 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
+    auto res = _dependencies.at(_atDep)->profiledGetSome(atLeast, atMost);
     while (res == nullptr && _atDep < _dependencies.size() - 1) {
       _atDep++;
-      res = _dependencies.at(_atDep)->getSome(atLeast, atMost);
+      res = _dependencies.at(_atDep)->profiledGetSome(atLeast, atMost);
     }
     if (res == nullptr) {
       _done = true;
     }
+    else if (_atDep < _dependencies.size() - 1) {
+      // the next shard's first batch is ready when this one is used up
+      try {
+        prefetch(_atDep + 1, atLeast, atMost);
+      }
+      catch (...) {
+        delete res;
+        throw;
+      }
+    }
     return res;
   }
  
@@ -274,6 +312,14 @@ AqlItemBlock* GatherBlock::getSome (size_t atLeast, size_t atMost) {
   size_t available = 0; // nr of available rows
   size_t index = 0;     // an index of a non-empty buffer
   
+  // send the requests to all shards with an empty buffer first, so that
+  // their round trips overlap
+  for (size_t i = 0; i < _dependencies.size(); i++) {
+    if (_gatherBlockBuffer.at(i).empty()) {
+      prefetch(i, atLeast, atMost);
+    }
+  }
+
   // pull more blocks from dependencies . . .
   for (size_t i = 0; i < _dependencies.size(); i++) {
     
@@ -381,10 +427,10 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
 
   // the simple case . . .  
   if (_isSimple) {
-    auto skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+    auto skipped = _dependencies.at(_atDep)->profiledSkipSome(atLeast, atMost);
     while (skipped == 0 && _atDep < _dependencies.size() - 1) {
       _atDep++;
-      skipped = _dependencies.at(_atDep)->skipSome(atLeast, atMost);
+      skipped = _dependencies.at(_atDep)->profiledSkipSome(atLeast, atMost);
     }
     if (skipped == 0) {
       _done = true;
@@ -397,6 +443,14 @@ size_t GatherBlock::skipSome (size_t atLeast, size_t atMost) {
   size_t index = 0;     // an index of a non-empty buffer
   TRI_ASSERT(_dependencies.size() != 0); 
 
+  // send the requests to all shards with an empty buffer first, so that
+  // their round trips overlap
+  for (size_t i = 0; i < _dependencies.size(); i++) {
+    if (_gatherBlockBuffer.at(i).empty()) {
+      prefetch(i, atLeast, atMost);
+    }
+  }
+
   // pull more blocks from dependencies . . .
   for (size_t i = 0; i < _dependencies.size(); i++) {
     if (_gatherBlockBuffer.at(i).empty()) {
@@ -464,7 +518,7 @@ bool GatherBlock::getBlock (size_t i, size_t atLeast, size_t atMost) {
   ENTER_BLOCK
   TRI_ASSERT(i < _dependencies.size());
   TRI_ASSERT(! _isSimple);
-  AqlItemBlock* docs = _dependencies.at(i)->getSome(atLeast, atMost);
+  AqlItemBlock* docs = _dependencies.at(i)->profiledGetSome(atLeast, atMost);
   if (docs != nullptr) {
     try {
       _gatherBlockBuffer.at(i).emplace_back(docs);
@@ -480,6 +534,22 @@ bool GatherBlock::getBlock (size_t i, size_t atLeast, size_t atMost) {
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefetch: let dependency i request its next batch from its DB
+/// server in the background, if it is a RemoteBlock
+////////////////////////////////////////////////////////////////////////////////
+
+void GatherBlock::prefetch (size_t i, size_t atLeast, size_t atMost) {
+  ENTER_BLOCK
+  TRI_ASSERT(i < _dependencies.size());
+  auto dep = _dependencies.at(i);
+
+  if (dep->getPlanNode()->getType() == ExecutionNode::REMOTE) {
+    static_cast<RemoteBlock*>(dep)->prefetch(atLeast, atMost);
+  }
+  LEAVE_BLOCK
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief OurLessThan: comparison method for elements of _gatherBlockPos
 ////////////////////////////////////////////////////////////////////////////////
@@ -1114,6 +1184,26 @@ bool DistributeBlock::getBlockForClient (size_t atLeast,
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace an INLINE value in the register of the current row with
+/// an equivalent JSON value
+////////////////////////////////////////////////////////////////////////////////
+  
+void DistributeBlock::materializeInlineValue (AqlItemBlock* cur,
+                                              RegisterId reg) const {
+  auto const& val = cur->getValueReference(_pos, reg);
+
+  if (val._type != AqlValue::INLINE) {
+    return;
+  }
+
+  // toJson() always returns an owned copy for INLINE values
+  std::unique_ptr<triagens::basics::Json> json(new triagens::basics::Json(val.toJson(nullptr, nullptr, false)));
+  cur->destroyValue(_pos, reg);
+  cur->setValue(_pos, reg, AqlValue(json.get()));
+  json.release();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the JSON that is used to determine the initial shard
 ////////////////////////////////////////////////////////////////////////////////
@@ -1158,6 +1248,12 @@ TRI_json_t const* DistributeBlock::getInputJson (AqlItemBlock const* cur) const
 size_t DistributeBlock::sendToClient (AqlItemBlock* cur) {
   ENTER_BLOCK
       
+  // inline values cannot be inspected as JSON, so convert them first
+  materializeInlineValue(cur, _regId);
+  if (_alternativeRegId != ExecutionNode::MaxRegisterId) {
+    materializeInlineValue(cur, _alternativeRegId);
+  }
+
   // inspect cur in row _pos and check to which shard it should be sent . .
   auto json = getInputJson(cur);
 
@@ -1378,6 +1474,94 @@ static bool throwExceptionAfterBadSyncRequest (ClusterCommResult* res,
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check the answer to an asynchronous request, throws if the request
+/// failed or the remote side reported an error
+////////////////////////////////////////////////////////////////////////////////
+
+static void checkAsyncAnswer (ClusterCommResult const* res) {
+  ENTER_BLOCK
+  if (res->status == CL_COMM_TIMEOUT) {
+    std::string errorMessage = std::string("Timeout in communication with shard '") + 
+      std::string(res->shardID) + 
+      std::string("' on cluster node '") +
+      std::string(res->serverID) +
+      std::string("' failed.");
+    
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CLUSTER_TIMEOUT,
+                                   errorMessage);
+  }
+
+  if (res->status != CL_COMM_RECEIVED || res->answer == nullptr) {
+    std::string errorMessage = std::string("Empty result in communication with shard '") + 
+      std::string(res->shardID) + 
+      std::string("' on cluster node '") +
+      std::string(res->serverID) +
+      std::string("': ") + 
+      res->errorMessage;
+
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CLUSTER_CONNECTION_LOST,
+                                   errorMessage);
+  }
+
+  if (res->answer_code != triagens::rest::HttpResponse::OK &&
+      res->answer_code != triagens::rest::HttpResponse::CREATED &&
+      res->answer_code != triagens::rest::HttpResponse::ACCEPTED) {
+    Json json(TRI_UNKNOWN_MEM_ZONE, TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, res->answer->body()));
+    int errorNum = JsonHelper::getNumericValue<int>(json.json(), "errorNum", TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
+    std::string errorMessage = std::string("Error message received from shard '") + 
+      std::string(res->shardID) + 
+      std::string("' on cluster node '") +
+      std::string(res->serverID) +
+      std::string("': ") +
+      JsonHelper::getStringValue(json.json(), "errorMessage", "(no valid error in response)");
+
+    THROW_ARANGO_EXCEPTION_MESSAGE(errorNum, errorMessage);
+  }
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parse the answer to a getSome request, which is either JSON or a
+/// binary encoded AqlItemBlock followed by JSON. returns the JSON part and
+/// stores the block in result, or a nullptr if the remote side is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+static Json parseGetSomeAnswer (char const* body,
+                                size_t length,
+                                char const* contentType,
+                                AqlItemBlock*& result) {
+  ENTER_BLOCK
+  result = nullptr;
+
+  // the body is always null-terminated, so the JSON part can be parsed
+  // in place
+  std::unique_ptr<AqlItemBlock> block;
+  char const* json = body;
+
+  if (contentType != nullptr &&
+      strncmp(contentType, AqlItemBlock::BinaryContentType, strlen(AqlItemBlock::BinaryContentType)) == 0) {
+    size_t const binaryLength = AqlItemBlock::binaryLength(body, length);
+    block.reset(new AqlItemBlock(body, binaryLength));
+    json += binaryLength;
+  }
+
+  Json responseBodyJson(TRI_UNKNOWN_MEM_ZONE, TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, json));
+
+  if (! responseBodyJson.isObject()) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
+  }
+
+  if (block == nullptr && 
+      ! JsonHelper::getBooleanValue(responseBodyJson.json(), "exhausted", true)) {
+    block.reset(new AqlItemBlock(responseBodyJson));
+  }
+
+  result = block.release();
+  return responseBodyJson;
+  LEAVE_BLOCK
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief timeout
 ////////////////////////////////////////////////////////////////////////////////
@@ -1396,7 +1580,17 @@ RemoteBlock::RemoteBlock (ExecutionEngine* engine,
   : ExecutionBlock(engine, en),
     _server(server),
     _ownName(ownName),
-    _queryId(queryId) {
+    _queryId(queryId),
+    // only the coordinator reads ahead. DB servers fetch from the
+    // coordinator's scatter blocks, which buffer for all their clients anyway 
+    _prefetchDepth(ownName.empty() ? engine->getQuery()->remotePrefetchDepth() : 0),
+    _prefetchFactor(_prefetchDepth),
+    _bytesPerRow(0.0),
+    _prefetchOperation(0),
+    _prefetchTransaction(0),
+    _prefetched(nullptr),
+    _prefetchedPos(0),
+    _prefetchedExhausted(false) {
 
   TRI_ASSERT(! queryId.empty());
   TRI_ASSERT_EXPENSIVE((triagens::arango::ServerState::instance()->isCoordinator() && ownName.empty()) ||
@@ -1404,6 +1598,12 @@ RemoteBlock::RemoteBlock (ExecutionEngine* engine,
 }
 
 RemoteBlock::~RemoteBlock () {
+  if (_prefetchOperation != 0) {
+    // nobody is interested in the answer anymore
+    ClusterComm::instance()->drop("AQL", _prefetchTransaction, _prefetchOperation, "");
+  }
+
+  delete _prefetched;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1424,6 +1624,8 @@ ClusterCommResult* RemoteBlock::sendRequest (
   if (! _ownName.empty()) {
     headers.emplace(make_pair("Shard-Id", _ownName));
   }
+  // only answers to getSome make use of this
+  headers.emplace(make_pair("Accept", AqlItemBlock::BinaryContentType));
 
   auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
 
@@ -1450,6 +1652,188 @@ ClusterCommResult* RemoteBlock::sendRequest (
   LEAVE_BLOCK
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request the next batch asynchronously
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::prefetch (size_t atLeast,
+                            size_t atMost) {
+  ENTER_BLOCK
+  if (_prefetchDepth == 0 ||
+      _prefetchOperation != 0 ||
+      _prefetched != nullptr ||
+      _prefetchedExhausted) {
+    return;
+  }
+
+  size_t const rows = limitRows(atMost * _prefetchFactor);
+
+  Json body(Json::Object, 2);
+  body("atLeast", Json(static_cast<double>((std::min)(atLeast, rows))))
+      ("atMost", Json(static_cast<double>(rows)));
+
+  std::unique_ptr<std::string> bodyString(new std::string(body.toString()));
+  std::unique_ptr<std::map<std::string, std::string>> headers(new std::map<std::string, std::string>);
+  if (! _ownName.empty()) {
+    headers->emplace(make_pair("Shard-Id", _ownName));
+  }
+  headers->emplace(make_pair("Accept", AqlItemBlock::BinaryContentType));
+
+  ClusterComm* cc = ClusterComm::instance();
+  CoordTransactionID const coordTransactionId = TRI_NewTickServer();
+
+  // ownership of the body and the headers is transferred to ClusterComm
+  std::unique_ptr<ClusterCommResult> res(cc->asyncRequest("AQL",
+                                                          coordTransactionId,
+                                                          _server,
+                                                          rest::HttpRequest::HTTP_REQUEST_PUT,
+                                                          std::string("/_db/") 
+                                                          + triagens::basics::StringUtils::urlEncode(_engine->getQuery()->trx()->vocbase()->_name)
+                                                          + "/_api/aql/getSome/" + _queryId,
+                                                          bodyString.release(),
+                                                          true,
+                                                          headers.release(),
+                                                          nullptr,
+                                                          defaultTimeOut));
+
+  if (res == nullptr || res->status == CL_COMM_ERROR) {
+    // could not submit the request. getSome will fetch synchronously
+    return;
+  }
+
+  _prefetchTransaction = coordTransactionId;
+  _prefetchOperation = res->operationID;
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for a pending read-ahead request and buffer its result
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::waitForPrefetch () {
+  ENTER_BLOCK
+  if (_prefetchOperation == 0) {
+    return;
+  }
+
+  OperationID const operationId = _prefetchOperation;
+  _prefetchOperation = 0;
+
+  double const start = TRI_microtime();
+  std::unique_ptr<ClusterCommResult> res(ClusterComm::instance()->wait("AQL", 
+                                                                       _prefetchTransaction,
+                                                                       operationId,
+                                                                       "",
+                                                                       defaultTimeOut));
+  if (res == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
+  }
+
+  bool const waited = (TRI_microtime() - start > PrefetchWaitThreshold);
+
+  checkAsyncAnswer(res.get());
+
+  bool found;
+  char const* contentType = res->answer->header("content-type", found);
+
+  AqlItemBlock* items;
+  Json responseBodyJson(parseGetSomeAnswer(res->answer->body(),
+                                           res->answer->bodySize(),
+                                           found ? contentType : nullptr,
+                                           items));
+  std::unique_ptr<AqlItemBlock> guard(items);
+
+  updateStats(responseBodyJson);
+
+  if (items == nullptr) {
+    _prefetchedExhausted = true;
+    return;
+  }
+
+  updateRowSize(res->answer->bodySize(), items->size());
+
+  if (waited && _prefetchFactor < MaxPrefetchFactor) {
+    // the remote side could not keep up. larger requests save round trips
+    _prefetchFactor = (std::min)(2 * _prefetchFactor, MaxPrefetchFactor);
+  }
+
+  TRI_ASSERT(_prefetched == nullptr);
+  _prefetched = guard.release();
+  _prefetchedPos = 0;
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for a pending read-ahead request and throw away the rows
+/// received ahead of time
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::discardPrefetch () {
+  ENTER_BLOCK
+  try {
+    waitForPrefetch();
+  }
+  catch (...) {
+    delete _prefetched;
+    _prefetched = nullptr;
+    _prefetchedPos = 0;
+    _prefetchedExhausted = false;
+    throw;
+  }
+
+  delete _prefetched;
+  _prefetched = nullptr;
+  _prefetchedPos = 0;
+  _prefetchedExhausted = false;
+  LEAVE_BLOCK
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the statistics from the response to a getSome request
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::updateStats (Json const& responseBodyJson) {
+  ExecutionStats newStats(responseBodyJson.get("stats"));
+  
+  _engine->_stats.addDelta(_deltaStats, newStats);
+  _deltaStats = newStats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the average row size from a response with rows
+/// the average adapts to changing row sizes, e.g. after a FILTER on the
+/// remote side starts to let larger documents pass
+////////////////////////////////////////////////////////////////////////////////
+
+void RemoteBlock::updateRowSize (size_t bytes,
+                                 size_t rows) {
+  if (rows == 0) {
+    return;
+  }
+
+  double const current = static_cast<double>(bytes) / static_cast<double>(rows);
+
+  if (_bytesPerRow <= 0.0) {
+    _bytesPerRow = current;
+  }
+  else {
+    _bytesPerRow = 0.75 * _bytesPerRow + 0.25 * current;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief limit a number of rows to request to the transfer size limit
+////////////////////////////////////////////////////////////////////////////////
+
+size_t RemoteBlock::limitRows (size_t rows) const {
+  if (_bytesPerRow <= 0.0) {
+    return rows;
+  }
+
+  size_t const limit = static_cast<size_t>(MaxTransferSize / _bytesPerRow);
+  return (std::max)((std::min)(rows, limit), static_cast<size_t>(1));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief initialize
 ////////////////////////////////////////////////////////////////////////////////
@@ -1472,6 +1856,9 @@ int RemoteBlock::initialize () {
 
 int RemoteBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   ENTER_BLOCK
+  // rows read ahead belong to the previous cursor
+  discardPrefetch();
+
   // For every call we simply forward via HTTP
 
   Json body(Json::Object, 4);
@@ -1512,6 +1899,13 @@ int RemoteBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
 
 int RemoteBlock::shutdown (int errorCode) {
   ENTER_BLOCK
+  try {
+    discardPrefetch();
+  }
+  catch (...) {
+    // the query is shut down anyway
+  }
+
   // For every call we simply forward via HTTP
 
   std::unique_ptr<ClusterCommResult> res;
@@ -1559,36 +1953,79 @@ int RemoteBlock::shutdown (int errorCode) {
 AqlItemBlock* RemoteBlock::getSome (size_t atLeast,
                                     size_t atMost) {
   ENTER_BLOCK
-  // For every call we simply forward via HTTP
+  waitForPrefetch();
 
-  Json body(Json::Object, 2);
-  body("atLeast", Json(static_cast<double>(atLeast)))
-      ("atMost", Json(static_cast<double>(atMost)));
-  std::string bodyString(body.toString());
-
-  std::unique_ptr<ClusterCommResult> res;
-  res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_PUT,
-                        "/_api/aql/getSome/",
-                        bodyString));
-  throwExceptionAfterBadSyncRequest(res.get(), false);
+  AqlItemBlock* result = nullptr;
 
-  // If we get here, then res->result is the response which will be
-  // a serialized AqlItemBlock:
-  StringBuffer const& responseBodyBuf(res->result->getBody());
-  Json responseBodyJson(TRI_UNKNOWN_MEM_ZONE,
-                        TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, 
-                                       responseBodyBuf.begin()));
+  if (_prefetched != nullptr) {
+    // serve the rows received ahead of time
+    size_t const available = _prefetched->size() - _prefetchedPos;
 
-  ExecutionStats newStats(responseBodyJson.get("stats"));
-  
-  _engine->_stats.addDelta(_deltaStats, newStats);
-  _deltaStats = newStats;
-  
-  if (JsonHelper::getBooleanValue(responseBodyJson.json(), "exhausted", true)) {
+    if (_prefetchedPos == 0 && available <= atMost) {
+      result = _prefetched;
+      _prefetched = nullptr;
+    }
+    else {
+      size_t const n = (std::min)(available, atMost);
+      result = _prefetched->slice(_prefetchedPos, _prefetchedPos + n);
+      _prefetchedPos += n;
+
+      if (_prefetchedPos >= _prefetched->size()) {
+        delete _prefetched;
+        _prefetched = nullptr;
+        _prefetchedPos = 0;
+      }
+    }
+  }
+  else if (_prefetchedExhausted) {
     return nullptr;
   }
+  else {
+    // nothing read ahead: forward via HTTP
+    size_t const rows = limitRows(atMost);
+
+    Json body(Json::Object, 2);
+    body("atLeast", Json(static_cast<double>((std::min)(atLeast, rows))))
+        ("atMost", Json(static_cast<double>(rows)));
+    std::string bodyString(body.toString());
+
+    std::unique_ptr<ClusterCommResult> res;
+    res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_PUT,
+                          "/_api/aql/getSome/",
+                          bodyString));
+    throwExceptionAfterBadSyncRequest(res.get(), false);
+
+    // If we get here, then res->result is the response which will be
+    // a serialized AqlItemBlock:
+    StringBuffer const& responseBodyBuf(res->result->getBody());
+    bool found;
+    std::string const contentType = res->result->getHeaderField("content-type", found);
+
+    Json responseBodyJson(parseGetSomeAnswer(responseBodyBuf.begin(),
+                                             responseBodyBuf.length(),
+                                             found ? contentType.c_str() : nullptr,
+                                             result));
+    std::unique_ptr<AqlItemBlock> guard(result);
+
+    updateStats(responseBodyJson);
     
-  return new triagens::aql::AqlItemBlock(responseBodyJson);
+    if (result == nullptr) {
+      return nullptr;
+    }
+    updateRowSize(responseBodyBuf.length(), result->size());
+    guard.release();
+  }
+
+  // request the next batch while the caller processes this one
+  try {
+    prefetch(atLeast, atMost);
+  }
+  catch (...) {
+    delete result;
+    throw;
+  }
+
+  return result;
   LEAVE_BLOCK
 }
 
@@ -1598,6 +2035,25 @@ AqlItemBlock* RemoteBlock::getSome (size_t atLeast,
 
 size_t RemoteBlock::skipSome (size_t atLeast, size_t atMost) {
   ENTER_BLOCK
+  waitForPrefetch();
+
+  if (_prefetched != nullptr) {
+    // skip the rows received ahead of time first
+    size_t const n = (std::min)(_prefetched->size() - _prefetchedPos, atMost);
+    _prefetchedPos += n;
+
+    if (_prefetchedPos >= _prefetched->size()) {
+      delete _prefetched;
+      _prefetched = nullptr;
+      _prefetchedPos = 0;
+    }
+    return n;
+  }
+
+  if (_prefetchedExhausted) {
+    return 0;
+  }
+
   // For every call we simply forward via HTTP
 
   Json body(Json::Object, 2);
@@ -1632,6 +2088,16 @@ size_t RemoteBlock::skipSome (size_t atLeast, size_t atMost) {
 
 bool RemoteBlock::hasMore () {
   ENTER_BLOCK
+  waitForPrefetch();
+
+  if (_prefetched != nullptr) {
+    return true;
+  }
+
+  if (_prefetchedExhausted) {
+    return false;
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -1658,6 +2124,10 @@ bool RemoteBlock::hasMore () {
 
 int64_t RemoteBlock::count () const {
   ENTER_BLOCK
+  // the remote query must not receive a request while the read-ahead 
+  // request is pending. the total count is not affected by read-ahead
+  const_cast<RemoteBlock*>(this)->waitForPrefetch();
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -1685,6 +2155,16 @@ int64_t RemoteBlock::count () const {
 
 int64_t RemoteBlock::remaining () {
   ENTER_BLOCK
+  waitForPrefetch();
+
+  int64_t prefetched = 0;
+  if (_prefetched != nullptr) {
+    prefetched = static_cast<int64_t>(_prefetched->size() - _prefetchedPos);
+  }
+  else if (_prefetchedExhausted) {
+    return 0;
+  }
+
   // For every call we simply forward via HTTP
   std::unique_ptr<ClusterCommResult> res;
   res.reset(sendRequest(rest::HttpRequest::HTTP_REQUEST_GET,
@@ -1701,7 +2181,7 @@ int64_t RemoteBlock::remaining () {
   if (JsonHelper::getBooleanValue(responseBodyJson.json(), "error", true)) {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_CLUSTER_AQL_COMMUNICATION);
   }
-  return JsonHelper::getNumericValue<int64_t>
+  return prefetched + JsonHelper::getNumericValue<int64_t>
                (responseBodyJson.json(), "remaining", 0);
   LEAVE_BLOCK
 }
@@ -128,6 +128,13 @@ namespace triagens {
         
         bool getBlock (size_t i, size_t atLeast, size_t atMost);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefetch: let dependency i request its next batch from its DB
+/// server in the background, if it is a RemoteBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetch (size_t i, size_t atLeast, size_t atMost);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _gatherBlockBuffer: buffer the incoming block from each dependency
 /// separately 
@@ -497,6 +504,13 @@ namespace triagens {
                                 size_t atMost,
                                 size_t clientId);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace an INLINE value in the register of the current row with
+/// an equivalent JSON value
+////////////////////////////////////////////////////////////////////////////////
+
+        void materializeInlineValue (AqlItemBlock*, RegisterId) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the JSON that is used to determine the initial shard
 ////////////////////////////////////////////////////////////////////////////////
@@ -632,6 +646,15 @@ namespace triagens {
 
         int64_t remaining () override final;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request the next batch asynchronously, so that it is already on
+/// its way when getSome is called. does nothing if read-ahead is turned off,
+/// a request is already pending or the remote side is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetch (size_t atLeast,
+                       size_t atMost);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief internal method to send a request
 ////////////////////////////////////////////////////////////////////////////////
@@ -643,6 +666,40 @@ namespace triagens {
                   std::string const& urlPart,
                   std::string const& body) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for a pending read-ahead request and buffer its result. must
+/// be called before any other request is sent, because the remote query
+/// can only serve one request at a time
+////////////////////////////////////////////////////////////////////////////////
+
+        void waitForPrefetch ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for a pending read-ahead request and throw away all rows
+/// received ahead of time
+////////////////////////////////////////////////////////////////////////////////
+
+        void discardPrefetch ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the statistics from the response to a getSome request
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateStats (triagens::basics::Json const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief update the average row size from a response with rows
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateRowSize (size_t,
+                            size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief limit a number of rows to request to the transfer size limit
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t limitRows (size_t) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief our server, can be like "shard:S1000" or like "server:Claus"
 ////////////////////////////////////////////////////////////////////////////////
@@ -667,6 +724,51 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         ExecutionStats _deltaStats;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read-ahead factor: a read-ahead request asks for this many times
+/// the number of rows of the last getSome. 0 means no read-ahead
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t const _prefetchDepth;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current read-ahead factor. it starts at _prefetchDepth and grows
+/// whenever the consumer had to wait for a read-ahead request, i.e. when the
+/// query is bound by the throughput of the remote side
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _prefetchFactor;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief average size of a transferred row in bytes, 0 if unknown. limits
+/// the number of rows requested at once
+////////////////////////////////////////////////////////////////////////////////
+
+        double _bytesPerRow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief operation and transaction ids of the pending read-ahead request,
+/// the operation id is 0 if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_tick_t _prefetchOperation;
+
+        TRI_voc_tick_t _prefetchTransaction;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rows received ahead of time, and the first row not yet returned
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* _prefetched;
+
+        size_t _prefetchedPos;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a read-ahead request found the remote side exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _prefetchedExhausted;
         
     };
 
@@ -132,6 +132,14 @@ namespace triagens {
           return _collection;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCollection (Collection const* collection) {
+          _collection = collection;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the server name
 ////////////////////////////////////////////////////////////////////////////////
@@ -576,6 +584,14 @@ namespace triagens {
           return _collection;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCollection (Collection const* collection) {
+          _collection = collection;
+        }
+
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +58,7 @@ Collection::Collection (std::string const& name,
                         TRI_transaction_type_e accessType) 
   : collection(nullptr),
     currentShard(),
+    restrictedShard(),
     name(name),
     vocbase(vocbase),
     accessType(accessType),
@@ -129,6 +130,10 @@ TRI_voc_cid_t Collection::getPlanId () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 std::vector<std::string> Collection::shardIds () const {
+  if (! restrictedShard.empty()) {
+    return std::vector<std::string>{ restrictedShard };
+  }
+
   auto clusterInfo = triagens::arango::ClusterInfo::instance();
   auto collectionInfo = clusterInfo->getCollection(std::string(vocbase->_name), name);
   if (collectionInfo.get() == nullptr) {
@@ -144,6 +149,82 @@ std::vector<std::string> Collection::shardIds () const {
   return ids;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection is co-located with another collection
+////////////////////////////////////////////////////////////////////////////////
+
+bool Collection::isColocatedWith (Collection const* other) const {
+  auto clusterInfo = triagens::arango::ClusterInfo::instance();
+  auto mine = clusterInfo->getCollection(std::string(vocbase->_name), name);
+  auto theirs = clusterInfo->getCollection(std::string(other->vocbase->_name), other->name);
+
+  if (mine->empty() || theirs->empty()) {
+    return false;
+  }
+
+  // the collections must belong to the same group
+  std::string myGroup = mine->distributeShardsLike();
+  if (myGroup.empty()) {
+    myGroup = triagens::basics::StringUtils::itoa(mine->id());
+  }
+  std::string theirGroup = theirs->distributeShardsLike();
+  if (theirGroup.empty()) {
+    theirGroup = triagens::basics::StringUtils::itoa(theirs->id());
+  }
+
+  if (myGroup != theirGroup ||
+      mine->shardKeys().size() != theirs->shardKeys().size()) {
+    return false;
+  }
+
+  // and their shards must still be placed next to each other
+  auto const myShards = mine->shardIds();
+  auto const theirShards = theirs->shardIds();
+
+  if (myShards.size() != theirShards.size()) {
+    return false;
+  }
+
+  auto it = theirShards.begin();
+  for (auto const& shard : myShards) {
+    if (shard.second != (*it).second) {
+      return false;
+    }
+    ++it;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the shard next to a shard of a co-located collection
+////////////////////////////////////////////////////////////////////////////////
+
+std::string Collection::colocatedShard (Collection const* other,
+                                        std::string const& otherShard) const {
+  auto clusterInfo = triagens::arango::ClusterInfo::instance();
+  auto mine = clusterInfo->getCollection(std::string(vocbase->_name), name);
+  auto theirs = clusterInfo->getCollection(std::string(other->vocbase->_name), other->name);
+
+  auto const myShards = mine->shardIds();
+  auto const theirShards = theirs->shardIds();
+
+  if (myShards.size() == theirShards.size()) {
+    // shards are co-located by their position
+    auto it = myShards.begin();
+    for (auto const& shard : theirShards) {
+      if (shard.first == otherShard) {
+        return (*it).first;
+      }
+      ++it;
+    }
+  }
+
+  THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_INTERNAL, 
+                                "no shard of collection '%s' next to shard '%s'",
+                                name.c_str(), otherShard.c_str());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the shard keys of a collection
 ////////////////////////////////////////////////////////////////////////////////
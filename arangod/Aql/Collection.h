@@ -150,6 +150,39 @@ namespace triagens {
 
       std::vector<std::string> shardIds () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restricts the query to a single shard of the collection. this is
+/// set by the optimizer if the filter conditions determine the shard
+////////////////////////////////////////////////////////////////////////////////
+
+      inline void restrictToShard (std::string const& shard) {
+        restrictedShard = shard;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the shard the query is restricted to, or an empty string
+////////////////////////////////////////////////////////////////////////////////
+
+      inline std::string const& getRestrictedShard () const {
+        return restrictedShard;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection follows the shard distribution of another
+/// collection (or vice versa), so that documents with equal shard key values
+/// are stored on the same server
+////////////////////////////////////////////////////////////////////////////////
+
+      bool isColocatedWith (Collection const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the shard of the collection next to a shard of a
+/// co-located collection
+////////////////////////////////////////////////////////////////////////////////
+
+      std::string colocatedShard (Collection const*,
+                                  std::string const&) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the shard keys of a collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -233,6 +266,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
       std::string                  currentShard;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the only shard the query needs to access. if set, shardIds() will
+/// return just this shard
+////////////////////////////////////////////////////////////////////////////////
+
+      std::string                  restrictedShard;
       
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
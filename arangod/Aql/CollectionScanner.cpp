@@ -147,6 +147,96 @@ void LinearCollectionScanner::reset () {
   position.reset();
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct ParallelCollectionScanner
+// -----------------------------------------------------------------------------
+
+size_t const ParallelCollectionScanner::PrefetchPerThread = 8192;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+ParallelCollectionScanner::ParallelCollectionScanner (triagens::arango::AqlTransaction* trx,
+                                                      TRI_transaction_collection_t* trxCollection,
+                                                      size_t numThreads) 
+  : CollectionScanner(trx, trxCollection),
+    numThreads(numThreads),
+    posInBuffer(0) {
+
+  TRI_ASSERT(numThreads > 0);
+}
+
+int ParallelCollectionScanner::scan (std::vector<TRI_doc_mptr_copy_t>& docs,
+                                     size_t batchSize) {
+  while (docs.size() < batchSize) {
+    if (posInBuffer >= buffer.size()) {
+      int res = refill();
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+      if (buffer.empty()) {
+        // all documents read
+        break;
+      }
+    }
+
+    size_t n = (std::min)(batchSize - docs.size(), buffer.size() - posInBuffer);
+    docs.insert(docs.end(), buffer.begin() + posInBuffer, buffer.begin() + posInBuffer + n);
+    posInBuffer += n;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+int ParallelCollectionScanner::forward (size_t batchSize, size_t& skipped) {
+  size_t toSkip = batchSize;
+
+  while (toSkip > 0) {
+    if (posInBuffer >= buffer.size()) {
+      int res = refill();
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+      if (buffer.empty()) {
+        // all documents read
+        break;
+      }
+    }
+
+    size_t n = (std::min)(toSkip, buffer.size() - posInBuffer);
+    posInBuffer += n;
+    toSkip -= n;
+    skipped += n;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+int ParallelCollectionScanner::refill () {
+  buffer.clear();
+  posInBuffer = 0;
+
+  return trx->readParallel(trxCollection,
+                           buffer,
+                           positions,
+                           static_cast<uint64_t>(PrefetchPerThread * numThreads),
+                           numThreads,
+                           totalCount);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+void ParallelCollectionScanner::reset () {
+  positions.clear();
+  buffer.clear();
+  posInBuffer = 0;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -122,6 +122,52 @@ namespace triagens {
       int forward (size_t, size_t&) override;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                  struct ParallelCollectionScanner
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a scanner that reads the buckets of the primary index with several
+/// threads. documents are prefetched into a buffer, so the cost of starting
+/// the threads is spread over many batches. the number of threads that can
+/// be used is limited by the number of index buckets of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ParallelCollectionScanner final : public CollectionScanner {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+  
+      ParallelCollectionScanner (triagens::arango::AqlTransaction*,
+                                 TRI_transaction_collection_t*,
+                                 size_t); 
+
+      int scan (std::vector<TRI_doc_mptr_copy_t>&,
+                size_t) override;
+      
+      void reset () override;
+
+      int forward (size_t, size_t&) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief refill the prefetch buffer
+////////////////////////////////////////////////////////////////////////////////
+
+      int refill ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents to prefetch per thread
+////////////////////////////////////////////////////////////////////////////////
+
+      static size_t const PrefetchPerThread;
+
+      size_t numThreads;
+      std::vector<uint64_t> positions;
+      std::vector<TRI_doc_mptr_copy_t> buffer;
+      size_t posInBuffer;
+    };
+
   }
 }
 
@@ -0,0 +1,719 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, compiled expression
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/CompiledExpression.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/Ast.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/Expression.h"
+#include "Aql/Function.h"
+#include "Aql/Query.h"
+#include "Aql/Variable.h"
+#include "Basics/Exceptions.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/json.h"
+
+using namespace triagens::aql;
+using Json = triagens::basics::Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            static helper function
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the compiler has an instruction for a node. the
+/// result is only a hint for deciding if compiling an expression is worth it
+////////////////////////////////////////////////////////////////////////////////
+
+static bool HasInstruction (AstNode const* node) {
+  switch (node->type) {
+    case NODE_TYPE_ATTRIBUTE_ACCESS:
+    case NODE_TYPE_REFERENCE:
+    case NODE_TYPE_FCALL:
+    case NODE_TYPE_OPERATOR_UNARY_NOT:
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_BINARY_OR:
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+    case NODE_TYPE_OPERATOR_BINARY_IN:
+    case NODE_TYPE_OPERATOR_BINARY_NIN:
+    case NODE_TYPE_OPERATOR_TERNARY:
+    case NODE_TYPE_OPERATOR_BINARY_PLUS:
+    case NODE_TYPE_OPERATOR_BINARY_MINUS:
+    case NODE_TYPE_OPERATOR_BINARY_TIMES:
+    case NODE_TYPE_OPERATOR_BINARY_DIV:
+    case NODE_TYPE_OPERATOR_BINARY_MOD:
+      return true;
+    default:
+      return false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy a register value and mark the register as empty
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void ClearValue (AqlValue& value) {
+  value.destroy();
+  value.erase();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                           Context
+// -----------------------------------------------------------------------------
+
+CompiledExpression::Context::Context ()
+  : values(),
+    collections(),
+    inputRegisters(),
+    parameters(),
+    buffer(TRI_UNKNOWN_MEM_ZONE) {
+
+}
+
+CompiledExpression::Context::~Context () {
+  for (auto& it : values) {
+    ClearValue(it);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+CompiledExpression::CompiledExpression ()
+  : _instructions(),
+    _ownedJson(),
+    _variables(),
+    _numRegisters(0),
+    _resultRegister(0) {
+
+}
+
+CompiledExpression::~CompiledExpression () {
+  for (auto& it : _ownedJson) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, it);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile an expression
+////////////////////////////////////////////////////////////////////////////////
+
+CompiledExpression* CompiledExpression::compile (Expression* expression) {
+  if (! expression->isSimple()) {
+    // constant expressions and attribute accessors are already cheap,
+    // and V8 expressions cannot be compiled
+    return nullptr;
+  }
+
+  AstNode const* node = expression->node();
+
+  if (! HasInstruction(node)) {
+    // the program would consist of a single call to the interpreter
+    return nullptr;
+  }
+
+  std::unique_ptr<CompiledExpression> program(new CompiledExpression());
+  program->_resultRegister = program->nextRegister();
+  program->compileNode(node, program->_resultRegister, true);
+
+  return program.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepare a context for executing the program
+////////////////////////////////////////////////////////////////////////////////
+
+void CompiledExpression::bind (Context& context,
+                               std::vector<Variable const*> const& vars,
+                               std::vector<RegisterId> const& regs) const {
+  clearRegisters(context);
+
+  context.values.resize(_numRegisters);
+  context.collections.resize(_numRegisters, nullptr);
+  context.inputRegisters.clear();
+  context.inputRegisters.reserve(_variables.size());
+
+  for (auto const& variable : _variables) {
+    RegisterId reg = ExecutionNode::MaxRegisterId;
+
+    for (size_t i = 0; i < vars.size(); ++i) {
+      if (vars[i]->name == variable->name) {
+        reg = regs[i];
+        break;
+      }
+    }
+    // a variable that is not found may still be unused at runtime, so
+    // this is only reported when the variable is actually accessed
+    context.inputRegisters.emplace_back(reg);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the program for a row
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue CompiledExpression::execute (Expression* expression,
+                                      Context& context,
+                                      triagens::arango::AqlTransaction* trx,
+                                      AqlItemBlock const* argv,
+                                      size_t startPos,
+                                      std::vector<Variable const*> const& vars,
+                                      std::vector<RegisterId> const& regs,
+                                      TRI_document_collection_t const** collection) const {
+  TRI_ASSERT(context.values.size() == _numRegisters);
+  TRI_ASSERT(context.inputRegisters.size() == _variables.size());
+
+  auto& values = context.values;
+  auto& collections = context.collections;
+
+  size_t const n = _instructions.size();
+  size_t pc = 0;
+
+  try {
+    while (pc < n) {
+      auto const& instruction = _instructions[pc++];
+      uint32_t const dest = instruction.dest;
+
+      switch (instruction.opcode) {
+        case OP_CONSTANT: {
+          if (instruction.json == nullptr) {
+            values[dest] = instruction.constant;
+          }
+          else {
+            // we do not own the JSON but the AST does!
+            values[dest] = AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, const_cast<TRI_json_t*>(instruction.json), Json::NOFREE));
+          }
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_VARIABLE: {
+          RegisterId const reg = context.inputRegisters[instruction.a];
+
+          if (reg == ExecutionNode::MaxRegisterId) {
+            THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "unhandled type 'reference' in executeSimpleExpression()");
+          }
+
+          // save the collection info
+          collections[dest] = argv->getDocumentCollection(reg);
+
+          if (instruction.doCopy) {
+            values[dest] = argv->getValueReference(startPos, reg).clone();
+          }
+          else {
+            // the value will be destroyed soon, so we must not use the
+            // original AqlValue from the AqlItemBlock here
+            values[dest] = argv->getValueReference(startPos, reg).shallowClone();
+          }
+          break;
+        }
+
+        case OP_ATTRIBUTE: {
+          auto name = static_cast<char const*>(instruction.node->getData());
+          auto j = values[instruction.a].extractObjectMember(trx, collections[instruction.a], name, true, context.buffer);
+          ClearValue(values[instruction.a]);
+
+          values[dest] = AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, j.steal()));
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_NOT: {
+          bool const operandIsTrue = values[instruction.a].isTrue();
+          ClearValue(values[instruction.a]);
+
+          values[dest] = AqlValue::CreateBool(! operandIsTrue);
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_COMPARE: {
+          AstNodeType const type = instruction.node->type;
+          // for equality and non-equality we can use a binary comparison
+          bool const compareUtf8 = (type != NODE_TYPE_OPERATOR_BINARY_EQ && type != NODE_TYPE_OPERATOR_BINARY_NE);
+
+          int const compareResult = AqlValue::Compare(trx,
+                                                      values[instruction.a], collections[instruction.a],
+                                                      values[instruction.b], collections[instruction.b],
+                                                      compareUtf8);
+          ClearValue(values[instruction.a]);
+          ClearValue(values[instruction.b]);
+
+          bool result;
+          switch (type) {
+            case NODE_TYPE_OPERATOR_BINARY_EQ:
+              result = (compareResult == 0);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_NE:
+              result = (compareResult != 0);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_LT:
+              result = (compareResult < 0);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_LE:
+              result = (compareResult <= 0);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_GT:
+              result = (compareResult > 0);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_GE:
+              result = (compareResult >= 0);
+              break;
+            default:
+              THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid comparison in compiled expression");
+          }
+
+          values[dest] = AqlValue::CreateBool(result);
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_IN: {
+          bool result = false;
+
+          // right operand must be a list, otherwise we return false
+          if (values[instruction.b].isArray()) {
+            result = expression->findInArray(values[instruction.a], values[instruction.b],
+                                             collections[instruction.a], collections[instruction.b],
+                                             trx, instruction.node);
+
+            if (instruction.node->type == NODE_TYPE_OPERATOR_BINARY_NIN) {
+              // revert the result in case of a NOT IN
+              result = ! result;
+            }
+          }
+          ClearValue(values[instruction.a]);
+          ClearValue(values[instruction.b]);
+
+          values[dest] = AqlValue::CreateBool(result);
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_ARITHMETIC: {
+          AqlValue& lhs = values[instruction.a];
+          AqlValue& rhs = values[instruction.b];
+          bool failed = (lhs.isObject() || rhs.isObject());
+          double l = 0.0;
+          double r = 0.0;
+
+          if (! failed) {
+            l = lhs.toNumber(failed);
+          }
+          if (! failed) {
+            r = rhs.toNumber(failed);
+          }
+          ClearValue(lhs);
+          ClearValue(rhs);
+          collections[dest] = nullptr;
+
+          if (failed) {
+            values[dest] = AqlValue::CreateNull();
+            break;
+          }
+
+          switch (instruction.node->type) {
+            case NODE_TYPE_OPERATOR_BINARY_PLUS:
+              values[dest] = AqlValue::CreateNumber(l + r);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_MINUS:
+              values[dest] = AqlValue::CreateNumber(l - r);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_TIMES:
+              values[dest] = AqlValue::CreateNumber(l * r);
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_DIV:
+              if (r == 0) {
+                std::string msg("in function '/()': ");
+                msg.append(TRI_errno_string(TRI_ERROR_QUERY_DIVISION_BY_ZERO));
+                expression->_ast->query()->registerWarning(TRI_ERROR_QUERY_DIVISION_BY_ZERO, msg.c_str());
+                values[dest] = AqlValue::CreateNull();
+              }
+              else {
+                values[dest] = AqlValue::CreateNumber(l / r);
+              }
+              break;
+            case NODE_TYPE_OPERATOR_BINARY_MOD:
+              values[dest] = AqlValue::CreateNumber(fmod(l, r));
+              break;
+            default:
+              values[dest] = AqlValue::CreateNull();
+              break;
+          }
+          break;
+        }
+
+        case OP_FCALL: {
+          auto func = static_cast<Function*>(instruction.node->getData());
+          TRI_ASSERT(func->implementation != nullptr);
+
+          auto& parameters = context.parameters;
+          parameters.clear();
+
+          for (auto const& it : instruction.arguments) {
+            parameters.emplace_back(values[it], collections[it]);
+            // the value is now owned by the parameters
+            values[it].erase();
+          }
+
+          // if this throws, the parameters are freed by clearRegisters()
+          AqlValue result = func->implementation(expression->_ast->query(), trx, parameters);
+
+          for (auto& it : parameters) {
+            it.first.destroy();
+          }
+          parameters.clear();
+
+          values[dest] = result;
+          collections[dest] = nullptr;
+          break;
+        }
+
+        case OP_CLEAR: {
+          ClearValue(values[dest]);
+          break;
+        }
+
+        case OP_JUMP: {
+          pc = instruction.target;
+          break;
+        }
+
+        case OP_JUMP_IF_TRUE: {
+          if (values[instruction.a].isTrue()) {
+            pc = instruction.target;
+          }
+          break;
+        }
+
+        case OP_JUMP_IF_FALSE: {
+          if (! values[instruction.a].isTrue()) {
+            pc = instruction.target;
+          }
+          break;
+        }
+
+        case OP_INTERPRET: {
+          TRI_document_collection_t const* myCollection = nullptr;
+          values[dest] = expression->executeSimpleExpression(instruction.node, &myCollection, trx, argv, startPos, vars, regs, instruction.doCopy);
+          collections[dest] = myCollection;
+          break;
+        }
+      }
+    }
+  }
+  catch (...) {
+    clearRegisters(context);
+    throw;
+  }
+
+  AqlValue result = values[_resultRegister];
+  values[_resultRegister].erase();
+  *collection = collections[_resultRegister];
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append an instruction to the program
+////////////////////////////////////////////////////////////////////////////////
+
+size_t CompiledExpression::emit (Opcode opcode,
+                                 uint32_t dest,
+                                 AstNode const* node) {
+  Instruction instruction;
+  instruction.opcode   = opcode;
+  instruction.doCopy   = false;
+  instruction.dest     = dest;
+  instruction.a        = 0;
+  instruction.b        = 0;
+  instruction.target   = 0;
+  instruction.node     = node;
+  instruction.constant = AqlValue();
+  instruction.json     = nullptr;
+
+  _instructions.emplace_back(std::move(instruction));
+  return _instructions.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile a node, so that its result is stored in register dest.
+/// the value ownership rules are the same as in the interpreter
+////////////////////////////////////////////////////////////////////////////////
+
+void CompiledExpression::compileNode (AstNode const* node,
+                                      uint32_t dest,
+                                      bool doCopy) {
+  switch (node->type) {
+    case NODE_TYPE_VALUE: {
+      compileConstant(node, dest);
+      return;
+    }
+
+    case NODE_TYPE_ARRAY:
+    case NODE_TYPE_OBJECT: {
+      if (node->isConstant()) {
+        compileConstant(node, dest);
+        return;
+      }
+      break;
+    }
+
+    case NODE_TYPE_REFERENCE: {
+      auto v = static_cast<Variable const*>(node->getData());
+      size_t slot = 0;
+
+      while (slot < _variables.size() && _variables[slot] != v) {
+        ++slot;
+      }
+      if (slot == _variables.size()) {
+        _variables.emplace_back(v);
+      }
+
+      size_t pos = emit(OP_VARIABLE, dest, node);
+      _instructions[pos].a = static_cast<uint32_t>(slot);
+      _instructions[pos].doCopy = doCopy;
+      return;
+    }
+
+    case NODE_TYPE_ATTRIBUTE_ACCESS: {
+      uint32_t const operand = nextRegister();
+      compileNode(node->getMember(0), operand, false);
+
+      size_t pos = emit(OP_ATTRIBUTE, dest, node);
+      _instructions[pos].a = operand;
+      return;
+    }
+
+    case NODE_TYPE_OPERATOR_UNARY_NOT: {
+      uint32_t const operand = nextRegister();
+      compileNode(node->getMember(0), operand, false);
+
+      size_t pos = emit(OP_NOT, dest, node);
+      _instructions[pos].a = operand;
+      return;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_AND:
+    case NODE_TYPE_OPERATOR_BINARY_OR: {
+      // the result is the left operand if it decides the result, and
+      // the right operand otherwise
+      compileNode(node->getMember(0), dest, true);
+
+      Opcode const opcode = (node->type == NODE_TYPE_OPERATOR_BINARY_AND) ? OP_JUMP_IF_FALSE : OP_JUMP_IF_TRUE;
+      size_t jump = emit(opcode, dest, node);
+      _instructions[jump].a = dest;
+
+      emit(OP_CLEAR, dest, node);
+      compileNode(node->getMember(1), dest, true);
+
+      _instructions[jump].target = _instructions.size();
+      return;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_EQ:
+    case NODE_TYPE_OPERATOR_BINARY_NE:
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+    case NODE_TYPE_OPERATOR_BINARY_IN:
+    case NODE_TYPE_OPERATOR_BINARY_NIN: {
+      uint32_t const left = nextRegister();
+      uint32_t const right = nextRegister();
+      compileNode(node->getMember(0), left, false);
+      compileNode(node->getMember(1), right, false);
+
+      bool const isIn = (node->type == NODE_TYPE_OPERATOR_BINARY_IN ||
+                         node->type == NODE_TYPE_OPERATOR_BINARY_NIN);
+      size_t pos = emit(isIn ? OP_IN : OP_COMPARE, dest, node);
+      _instructions[pos].a = left;
+      _instructions[pos].b = right;
+      return;
+    }
+
+    case NODE_TYPE_OPERATOR_TERNARY: {
+      uint32_t const condition = nextRegister();
+      compileNode(node->getMember(0), condition, false);
+
+      size_t jumpToFalse = emit(OP_JUMP_IF_FALSE, dest, node);
+      _instructions[jumpToFalse].a = condition;
+
+      // true part
+      emit(OP_CLEAR, condition, node);
+      compileNode(node->getMember(1), dest, true);
+      size_t jumpToEnd = emit(OP_JUMP, dest, node);
+
+      // false part
+      _instructions[jumpToFalse].target = _instructions.size();
+      emit(OP_CLEAR, condition, node);
+      compileNode(node->getMember(2), dest, true);
+
+      _instructions[jumpToEnd].target = _instructions.size();
+      return;
+    }
+
+    case NODE_TYPE_OPERATOR_BINARY_PLUS:
+    case NODE_TYPE_OPERATOR_BINARY_MINUS:
+    case NODE_TYPE_OPERATOR_BINARY_TIMES:
+    case NODE_TYPE_OPERATOR_BINARY_DIV:
+    case NODE_TYPE_OPERATOR_BINARY_MOD: {
+      uint32_t const left = nextRegister();
+      uint32_t const right = nextRegister();
+      compileNode(node->getMember(0), left, true);
+      compileNode(node->getMember(1), right, true);
+
+      size_t pos = emit(OP_ARITHMETIC, dest, node);
+      _instructions[pos].a = left;
+      _instructions[pos].b = right;
+      return;
+    }
+
+    case NODE_TYPE_FCALL: {
+      auto member = node->getMember(0);
+      TRI_ASSERT(member->type == NODE_TYPE_ARRAY);
+
+      size_t const n = member->numMembers();
+      std::vector<uint32_t> arguments;
+      arguments.reserve(n);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto arg = member->getMemberUnchecked(i);
+        uint32_t const reg = nextRegister();
+
+        if (arg->type == NODE_TYPE_COLLECTION) {
+          // collection names are passed as strings
+          TRI_json_t* json = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, arg->getStringValue(), arg->getStringLength());
+
+          if (json == nullptr) {
+            THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+          }
+
+          try {
+            _ownedJson.emplace_back(json);
+          }
+          catch (...) {
+            TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+            throw;
+          }
+
+          size_t pos = emit(OP_CONSTANT, reg, arg);
+          _instructions[pos].json = json;
+        }
+        else {
+          compileNode(arg, reg, false);
+        }
+
+        arguments.emplace_back(reg);
+      }
+
+      size_t pos = emit(OP_FCALL, dest, node);
+      _instructions[pos].arguments = std::move(arguments);
+      return;
+    }
+
+    default: {
+      break;
+    }
+  }
+
+  // no instruction for this node, so let the interpreter handle it
+  size_t pos = emit(OP_INTERPRET, dest, node);
+  _instructions[pos].doCopy = doCopy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile a constant node. scalars are stored inline in the
+/// instruction, all other values refer to the JSON computed by the node
+////////////////////////////////////////////////////////////////////////////////
+
+void CompiledExpression::compileConstant (AstNode const* node,
+                                          uint32_t dest) {
+  size_t pos = emit(OP_CONSTANT, dest, node);
+  auto& instruction = _instructions[pos];
+
+  if (node->type == NODE_TYPE_VALUE) {
+    if (node->isNullValue()) {
+      instruction.constant = AqlValue::CreateNull();
+      return;
+    }
+    if (node->isBoolValue()) {
+      instruction.constant = AqlValue::CreateBool(node->getBoolValue());
+      return;
+    }
+    if (node->isNumericValue()) {
+      instruction.constant = AqlValue::CreateNumber(node->getDoubleValue());
+      return;
+    }
+  }
+
+  auto json = node->computeJson();
+
+  if (json == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  instruction.json = json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy all register values of a context
+////////////////////////////////////////////////////////////////////////////////
+
+void CompiledExpression::clearRegisters (Context& context) const {
+  for (auto& it : context.values) {
+    ClearValue(it);
+  }
+  for (auto& it : context.parameters) {
+    it.first.destroy();
+  }
+  context.parameters.clear();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
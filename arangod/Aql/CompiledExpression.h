@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, compiled expression
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_COMPILED_EXPRESSION_H
+#define ARANGODB_AQL_COMPILED_EXPRESSION_H 1
+
+#include "Basics/Common.h"
+#include "Aql/AqlValue.h"
+#include "Aql/AstNode.h"
+#include "Aql/Functions.h"
+#include "Aql/types.h"
+#include "Basics/StringBuffer.h"
+
+struct TRI_document_collection_t;
+struct TRI_json_t;
+
+namespace triagens {
+  namespace arango {
+    class AqlTransaction;
+  }
+
+  namespace aql {
+
+    class AqlItemBlock;
+    class Expression;
+    struct Function;
+    struct Variable;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          class CompiledExpression
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a simple expression, flattened into a linear program
+///
+/// the program operates on a file of registers holding AqlValues. each
+/// instruction reads its operands from registers and writes its result into
+/// a register, so executing the program needs neither recursion nor a
+/// dispatch on the AST node type. AND, OR and the ternary operator are
+/// compiled into conditional jumps, so their operands are only evaluated
+/// when needed. sub-expressions that have no instruction (e.g. expansions
+/// or indexed accesses) are handed back to the expression's interpreter
+///
+/// the program itself is immutable after compilation and can be shared by
+/// all blocks that execute the same expression. all state needed during
+/// execution lives in a Context, which each block owns
+////////////////////////////////////////////////////////////////////////////////
+
+    class CompiledExpression {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the execution state of a program
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Context {
+          Context ();
+
+          ~Context ();
+
+          std::vector<AqlValue>                         values;
+          std::vector<TRI_document_collection_t const*> collections;
+          std::vector<RegisterId>                       inputRegisters;
+          FunctionParameters                            parameters;
+          triagens::basics::StringBuffer                buffer;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+        enum Opcode : uint8_t {
+          OP_CONSTANT,       // dest = constant
+          OP_VARIABLE,       // dest = input variable #a
+          OP_ATTRIBUTE,      // dest = a.name
+          OP_NOT,            // dest = ! a
+          OP_COMPARE,        // dest = a <op> b
+          OP_IN,             // dest = a IN b, or a NOT IN b
+          OP_ARITHMETIC,     // dest = a <op> b
+          OP_FCALL,          // dest = function(arguments)
+          OP_CLEAR,          // destroy dest
+          OP_JUMP,           // continue at target
+          OP_JUMP_IF_TRUE,   // continue at target if a is true
+          OP_JUMP_IF_FALSE,  // continue at target if a is false
+          OP_INTERPRET       // dest = interpreted node
+        };
+
+        struct Instruction {
+          Opcode                  opcode;
+          bool                    doCopy;
+          uint32_t                dest;
+          uint32_t                a;
+          uint32_t                b;
+          size_t                  target;
+          AstNode const*          node;
+          AqlValue                constant;
+          TRI_json_t const*       json;
+          std::vector<uint32_t>   arguments;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        CompiledExpression (CompiledExpression const&) = delete;
+        CompiledExpression& operator= (CompiledExpression const&) = delete;
+
+        ~CompiledExpression ();
+
+      private:
+
+        CompiledExpression ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile an expression. returns a nullptr if the expression is not
+/// a simple expression, or if compiling it would not save anything over
+/// interpreting it
+////////////////////////////////////////////////////////////////////////////////
+
+        static CompiledExpression* compile (Expression*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepare a context for executing the program with the given input
+/// variables and registers
+////////////////////////////////////////////////////////////////////////////////
+
+        void bind (Context&,
+                   std::vector<Variable const*> const&,
+                   std::vector<RegisterId> const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute the program for a row. the context must have been bound
+/// to the same input variables and registers before. the result must be
+/// destroyed by the caller
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue execute (Expression*,
+                          Context&,
+                          triagens::arango::AqlTransaction*,
+                          AqlItemBlock const*,
+                          size_t,
+                          std::vector<Variable const*> const&,
+                          std::vector<RegisterId> const&,
+                          TRI_document_collection_t const**) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocate a new register
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t nextRegister () {
+          return _numRegisters++;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append an instruction to the program, returns its position
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t emit (Opcode,
+                     uint32_t,
+                     AstNode const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile a node, so that its result is stored in register dest
+////////////////////////////////////////////////////////////////////////////////
+
+        void compileNode (AstNode const*,
+                          uint32_t,
+                          bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compile a constant node
+////////////////////////////////////////////////////////////////////////////////
+
+        void compileConstant (AstNode const*,
+                              uint32_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy all register values of a context
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearRegisters (Context&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the instructions
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Instruction> _instructions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief JSON values created during compilation, owned by the program
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_json_t*> _ownedJson;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the input variables used by the program
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> _variables;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of registers used by the program
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _numRegisters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the register that contains the result
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _resultRegister;
+
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
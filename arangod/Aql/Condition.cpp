@@ -281,7 +281,8 @@ Condition::Condition (Ast* ast)
   : _ast(ast),
     _root(nullptr),
     _isNormalized(false),
-    _isSorted(false) {
+    _isSorted(false),
+    _intersections() {
 
 }
 
@@ -307,9 +308,9 @@ Condition* Condition::fromJson (ExecutionPlan* plan,
   std::unique_ptr<Condition> condition(new Condition(plan->getAst()));
 
   if (json.isObject() && json.members() != 0) {
-    std::unique_ptr<AstNode> node(new AstNode(plan->getAst(), json)); 
-    condition->andCombine(node.get());
-    node.release();
+    // the node is registered with the query and freed by it
+    auto ast = plan->getAst();
+    condition->andCombine(new (ast->query()->arena()) AstNode(ast, json));
   }
 
   condition->_isNormalized = true;
@@ -368,6 +369,7 @@ std::pair<bool, bool> Condition::findIndexes (EnumerateCollectionNode const* nod
                                               SortCondition const* sortCondition) {
   TRI_ASSERT(usedIndexes.empty());
   Variable const* reference = node->outVariable();
+  _intersections.clear();
 
   if (_root == nullptr) {
     // We do not have a condition. But we have a sort!
@@ -420,6 +422,7 @@ std::pair<bool, bool> Condition::findIndexes (EnumerateCollectionNode const* nod
       // index can be used for sorting only
       // we need to abort further searching and only return one index
       TRI_ASSERT(! usedIndexes.empty());
+      _intersections.clear();
       if (usedIndexes.size() > 1) {
         auto sortIndex = usedIndexes.back();
 
@@ -443,6 +446,32 @@ std::pair<bool, bool> Condition::findIndexes (EnumerateCollectionNode const* nod
   return std::make_pair(canUseForFilter, canUseForSort);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the index intersections found by findIndexes for each OR
+/// branch
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<IndexIntersection> Condition::intersections () const {
+  std::vector<IndexIntersection> result;
+
+  if (_root == nullptr || _intersections.empty()) {
+    return result;
+  }
+
+  size_t const n = _root->numMembers();
+  result.resize(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    auto it = _intersections.find(_root->getMemberUnchecked(i));
+
+    if (it != _intersections.end()) {
+      result[i] = (*it).second;
+    }
+  }
+
+  return result;
+}
+
 bool Condition::indexSupportsSort (Index const* idx,
                                    Variable const* reference,
                                    SortCondition const* sortCondition,
@@ -481,6 +510,7 @@ std::pair<bool, bool> Condition::findIndexForAndNode (size_t position,
 
   Index const* bestIndex  = nullptr;
   double bestCost         = 0.0;
+  size_t bestItems        = itemsInIndex;
   bool bestSupportsFilter = false;
   bool bestSupportsSort   = false;
 
@@ -504,6 +534,7 @@ std::pair<bool, bool> Condition::findIndexForAndNode (size_t position,
     else {
       // index does not support the filter condition
       filterCost = itemsInIndex * 1.5;
+      estimatedItems = itemsInIndex;
     }
 
     if (! sortCondition->isEmpty() &&
@@ -528,6 +559,7 @@ std::pair<bool, bool> Condition::findIndexForAndNode (size_t position,
     if (bestIndex == nullptr || totalCost < bestCost) {
       bestIndex          = idx;
       bestCost           = totalCost;
+      bestItems          = estimatedItems;
       bestSupportsFilter = supportsFilter;
       bestSupportsSort   = supportsSort;
     }
@@ -537,13 +569,144 @@ std::pair<bool, bool> Condition::findIndexForAndNode (size_t position,
     return std::make_pair(false, false);
   }
 
-  _root->changeMember(position, bestIndex->specializeCondition(node, reference)); 
+  // remember the members of the AND node before the index removes the
+  // parts it cannot use
+  std::vector<AstNode*> members;
+  if (bestSupportsFilter) {
+    size_t const n = node->numMembers();
+    members.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      members.emplace_back(node->getMemberUnchecked(i));
+    }
+  }
+
+  auto specialized = bestIndex->specializeCondition(node, reference);
+  _root->changeMember(position, specialized); 
 
   usedIndexes.emplace_back(bestIndex);
 
+  if (members.size() > specialized->numMembers()) {
+    findIntersection(specialized, members, reference, colNode, bestIndex, bestItems);
+  }
+
   return std::make_pair(bestSupportsFilter, bestSupportsSort);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a condition part compares an attribute of the
+/// variable with a constant, so it can be looked up in an index once
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsConstantIndexComparison (AstNode const* node,
+                                       Variable const* reference) {
+  if (! node->isComparisonOperator() ||
+      node->type == NODE_TYPE_OPERATOR_BINARY_NE ||
+      node->type == NODE_TYPE_OPERATOR_BINARY_NIN ||
+      node->numMembers() != 2) {
+    return false;
+  }
+
+  auto lhs = node->getMember(0);
+  auto rhs = node->getMember(1);
+
+  return ((lhs->isAttributeAccessForVariable(reference) && rhs->isConstant()) ||
+          (rhs->isAttributeAccessForVariable(reference) && lhs->isConstant()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds further indexes for the parts of an AND node that are not
+/// covered by the index chosen for it
+/// an index is added if it is a hash or skiplist index that is expected to
+/// return fewer documents than the indexes chosen so far. the results of all
+/// indexes are intersected, and the FILTER still checks the complete
+/// condition. only constant comparisons are used, so the additional lookups
+/// do not need to be re-evaluated for each input row
+////////////////////////////////////////////////////////////////////////////////
+
+void Condition::findIntersection (AstNode const* node,
+                                  std::vector<AstNode*> const& members,
+                                  Variable const* reference,
+                                  EnumerateCollectionNode const* colNode,
+                                  Index const* usedIndex,
+                                  size_t estimatedItems) {
+  // the parts of the AND node not covered by the index used for it
+  std::vector<AstNode*> rest;
+  size_t const n = node->numMembers();
+
+  for (auto const& member : members) {
+    bool isCovered = false;
+
+    for (size_t i = 0; i < n; ++i) {
+      if (node->getMemberUnchecked(i) == member) {
+        isCovered = true;
+        break;
+      }
+    }
+
+    if (! isCovered && IsConstantIndexComparison(member, reference)) {
+      rest.emplace_back(member);
+    }
+  }
+
+  size_t const itemsInIndex = colNode->collection()->count(); 
+  std::vector<Index const*> indexes = colNode->collection()->getIndexes();
+  IndexIntersection intersection;
+
+  while (! rest.empty()) {
+    auto andNode = _ast->createNodeNaryOperator(NODE_TYPE_OPERATOR_NARY_AND);
+    for (auto const& it : rest) {
+      andNode->addMember(it);
+    }
+
+    Index const* bestIndex = nullptr;
+    size_t bestItems = estimatedItems;
+
+    for (auto const& idx : indexes) {
+      if (idx == usedIndex ||
+          (idx->type != triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX &&
+           idx->type != triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX)) {
+        continue;
+      }
+
+      bool isUsed = false;
+      for (auto const& it : intersection) {
+        if (it.first == idx) {
+          isUsed = true;
+          break;
+        }
+      }
+
+      double estimatedCost;
+      size_t items;
+      if (! isUsed &&
+          idx->supportsFilterCondition(andNode, reference, itemsInIndex, items, estimatedCost) &&
+          items < bestItems) {
+        bestIndex = idx;
+        bestItems = items;
+      }
+    }
+
+    if (bestIndex == nullptr) {
+      break;
+    }
+
+    auto specialized = bestIndex->specializeCondition(andNode, reference);
+    intersection.emplace_back(bestIndex, specialized);
+    estimatedItems = bestItems;
+
+    // continue with the parts the index does not cover
+    size_t const m = specialized->numMembers();
+    for (size_t i = 0; i < m; ++i) {
+      auto member = specialized->getMemberUnchecked(i);
+      rest.erase(std::remove(rest.begin(), rest.end(), member), rest.end());
+    }
+  }
+
+  if (! intersection.empty()) {
+    _intersections[node] = intersection;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief normalize the condition
 /// this will convert the condition into its disjunctive normal form
@@ -199,6 +199,18 @@ namespace triagens {
       bool                        isExpanded;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 IndexIntersection
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief additional indexes whose results are intersected with the results
+/// of the index used for an OR branch, each with the part of the branch's
+/// condition it is looked up with
+////////////////////////////////////////////////////////////////////////////////
+
+    typedef std::vector<std::pair<Index const*, AstNode const*>> IndexIntersection;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   class Condition
 // -----------------------------------------------------------------------------
@@ -333,6 +345,13 @@ namespace triagens {
                                            std::vector<Index const*>&, 
                                            SortCondition const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the index intersections found by findIndexes for each OR
+/// branch. returns an empty vector if no intersections were found
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<IndexIntersection> intersections () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -431,6 +450,18 @@ namespace triagens {
                                                    std::vector<Index const*>&,
                                                    SortCondition const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds further indexes for the parts of an AND node that are not
+/// covered by the index chosen for it
+////////////////////////////////////////////////////////////////////////////////
+
+        void findIntersection (AstNode const*,
+                               std::vector<AstNode*> const&,
+                               Variable const*,
+                               EnumerateCollectionNode const*,
+                               Index const*,
+                               size_t);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -461,6 +492,12 @@ namespace triagens {
 
         bool _isSorted;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief index intersections found for the AND nodes of the condition
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<AstNode const*, IndexIntersection> _intersections;
+
     };
   }
 }
@@ -44,6 +44,8 @@ bool ConditionFinder::before (ExecutionNode* en) {
     case EN::REMOTE:
     case EN::SUBQUERY:        
     case EN::INDEX:
+    case EN::HASH_JOIN:
+    case EN::TRAVERSAL:
     case EN::INSERT:
     case EN::REMOVE:
     case EN::REPLACE:
@@ -60,6 +62,13 @@ bool ConditionFinder::before (ExecutionNode* en) {
       _sorts.clear();
       break;
 
+    case EN::WINDOW:
+      // the rows before a WINDOW must not be restricted or reordered by the
+      // filters and sorts after it, as this would change the aggregates
+      _filters.clear();
+      _sorts.clear();
+      break;
+
     case EN::SINGLETON:
     case EN::NORESULTS:
     case EN::ILLEGAL:
@@ -194,6 +203,9 @@ bool ConditionFinder::before (ExecutionNode* en) {
           condition.get(),
           reverse
         ));
+        if (canUseIndex.first) {
+          static_cast<IndexNode*>(newNode.get())->setIntersections(condition->intersections());
+        }
         condition.release();
         TRI_IF_FAILURE("ConditionFinder::insertIndexNode") {
           THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
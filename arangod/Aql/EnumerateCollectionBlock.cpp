@@ -31,6 +31,7 @@
 #include "Aql/CollectionScanner.h"
 #include "Aql/ExecutionEngine.h"
 #include "Basics/Exceptions.h"
+#include "Basics/StringBuffer.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -50,6 +51,8 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
     _scanner(nullptr),
     _posInDocuments(0),
     _random(ep->_random),
+    _scanSize(0),
+    _projections(ep->projections()),
     _mustStoreResult(true) {
 
   auto trxCollection = _trx->trxCollection(_collection->cid());
@@ -61,6 +64,10 @@ EnumerateCollectionBlock::EnumerateCollectionBlock (ExecutionEngine* engine,
     // random scan
     _scanner = new RandomCollectionScanner(_trx, trxCollection);
   }
+  else if (engine->getQuery()->scanThreads() > 1) {
+    // linear scan, reading the index buckets in parallel
+    _scanner = new ParallelCollectionScanner(_trx, trxCollection, engine->getQuery()->scanThreads());
+  }
   else {
     // default: linear scan
     _scanner = new LinearCollectionScanner(_trx, trxCollection);
@@ -79,6 +86,7 @@ void EnumerateCollectionBlock::initializeDocuments () {
   _scanner->reset();
   _documents.clear();
   _posInDocuments = 0;
+  _scanSize = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,12 +120,21 @@ bool EnumerateCollectionBlock::skipDocuments (size_t toSkip, size_t& skipped) {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief continue fetching of documents
+/// the first scan for an input row only reads as many documents as were
+/// requested, so that a LIMIT downstream does not make the block read a
+/// full batch. if more are needed, e.g. because a FILTER discards some of
+/// them, each scan reads twice as many as the previous one, up to the
+/// default batch size
 ////////////////////////////////////////////////////////////////////////////////
 
 bool EnumerateCollectionBlock::moreDocuments (size_t hint) {
-  if (hint < DefaultBatchSize) {
-    hint = DefaultBatchSize;
+  if (_scanSize > 0) {
+    hint = (std::max)(hint, (std::min)(2 * _scanSize, DefaultBatchSize));
+  }
+  if (hint == 0) {
+    hint = 1;
   }
+  _scanSize = hint;
 
   throwIfKilled(); // check if we were aborted
 
@@ -216,8 +233,14 @@ AqlItemBlock* EnumerateCollectionBlock::getSome (size_t, // atLeast,
   // only copy 1st row of registers inherited from previous frame(s)1
   inheritRegisters(cur, res.get(), _pos);
 
-  // set our collection for our output register
-  res->setDocumentCollection(static_cast<triagens::aql::RegisterId>(curRegs), _trx->documentCollection(_collection->cid()));
+  auto document = _trx->documentCollection(_collection->cid());
+
+  // set our collection for our output register. projections are plain
+  // objects that do not refer to the collection
+  res->setDocumentCollection(static_cast<triagens::aql::RegisterId>(curRegs), 
+                             _projections.empty() ? document : nullptr);
+
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
 
   for (size_t j = 0; j < toSend; j++) {
     if (j > 0) {
@@ -229,7 +252,18 @@ AqlItemBlock* EnumerateCollectionBlock::getSome (size_t, // atLeast,
       }
     }
 
-    if (_mustStoreResult) {
+    if (_mustStoreResult && ! _projections.empty()) {
+      AqlValue value = buildProjection(_documents[_posInDocuments], document, buffer);
+
+      try {
+        res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs), value);
+      }
+      catch (...) {
+        value.destroy();
+        throw;
+      }
+    }
+    else if (_mustStoreResult) {
       // The result is in the first variable of this depth,
       // we do not need to do a lookup in getPlanNode()->_registerPlan->varInfo,
       // but can just take cur->getNrRegs() as registerId:
@@ -320,6 +354,25 @@ size_t EnumerateCollectionBlock::skipSome (size_t atLeast, size_t atMost) {
   return skipped;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build an object with the projected attributes of a document
+/// missing attributes are produced as null, so that accessing them yields
+/// the same result as accessing them in the complete document
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue EnumerateCollectionBlock::buildProjection (TRI_doc_mptr_copy_t const& mptr,
+                                                    TRI_document_collection_t const* document,
+                                                    triagens::basics::StringBuffer& buffer) const {
+  AqlValue shaped(reinterpret_cast<TRI_df_marker_t const*>(mptr.getDataPtr()));
+  std::unique_ptr<Json> result(new Json(Json::Object, _projections.size()));
+
+  for (auto const& projection : _projections) {
+    result->set(projection.c_str(), shaped.extractObjectMember(_trx, document, projection.c_str(), true, buffer));
+  }
+
+  return AqlValue(result.release());
+}
+
 // Local Variables:
 // mode: outline-minor
 // outline-regexp: "^\\(/// @brief\\|/// {@inheritDoc}\\|/// @addtogroup\\|// --SECTION--\\|/// @\\}\\)"
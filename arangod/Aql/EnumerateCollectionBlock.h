@@ -97,6 +97,20 @@ namespace triagens {
 
         size_t skipSome (size_t atLeast, size_t atMost) override final;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build an object with the projected attributes of a document
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue buildProjection (TRI_doc_mptr_copy_t const&,
+                                  TRI_document_collection_t const*,
+                                  triagens::basics::StringBuffer&) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -133,6 +147,19 @@ namespace triagens {
 
         bool const _random;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents read by the last scan for the current input
+/// row, 0 if there was none yet
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _scanSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes to produce instead of complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const _projections;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the enumerated documents need to be stored
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +36,71 @@ using namespace triagens::aql;
 
 using Json = triagens::basics::Json;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy a value taken over from an input block
+////////////////////////////////////////////////////////////////////////////////
+
+static void DestroyOwnedValue (AqlValue* value) {
+  value->destroy();
+  delete value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an AqlValue for an array member. scalars are stored inline,
+/// other members are copied unless the array is owned by the block
+////////////////////////////////////////////////////////////////////////////////
+
+static AqlValue MemberValue (TRI_json_t* json,
+                             bool reference) {
+  switch (json->_type) {
+    case TRI_JSON_NULL: {
+      return AqlValue::CreateNull();
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      return AqlValue::CreateBool(json->_value._boolean);
+    }
+
+    case TRI_JSON_NUMBER: {
+      return AqlValue::CreateNumber(json->_value._number);
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      if (json->_value._string.length - 1 <= AqlValue::MaxInlineStringLength) {
+        return AqlValue::CreateString(json->_value._string.data, json->_value._string.length - 1);
+      }
+      break;
+    }
+
+    default: {
+      break;
+    }
+  }
+
+  if (reference) {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, json, Json::NOFREE));
+  }
+
+  TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+  if (copy == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  try {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, copy));
+  }
+  catch (...) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, copy);
+    throw;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                          class EnumerateListBlock
 // -----------------------------------------------------------------------------
@@ -46,6 +111,7 @@ EnumerateListBlock::EnumerateListBlock (ExecutionEngine* engine,
     _index(0),
     _thisBlock(0),
     _seen(0),
+    _owned(),
     _collection(nullptr),
     _inVarRegId(ExecutionNode::MaxRegisterId) {
 
@@ -82,6 +148,7 @@ int EnumerateListBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   _thisBlock = 0; // the current block in the _inVariable DOCVEC
   _seen = 0;      // the sum of the sizes of the blocks in the _inVariable
   // DOCVEC that preceed _thisBlock
+  _owned.reset();
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -151,6 +218,7 @@ AqlItemBlock* EnumerateListBlock::getSome (size_t, size_t atMost) {
         throwArrayExpectedException();
       }
 
+      case AqlValue::INLINE: 
       case AqlValue::EMPTY: {
         throwArrayExpectedException();
       }
@@ -160,11 +228,27 @@ AqlItemBlock* EnumerateListBlock::getSome (size_t, size_t atMost) {
       res = nullptr;
     }
     else {
+      if (_index == 0 &&
+          (inVarReg._type == AqlValue::JSON || inVarReg._type == AqlValue::DOCVEC) &&
+          cur->valueCount(inVarReg) == 1) {
+        // take over the value from the input block, so the values produced
+        // can point into it. the result blocks keep it alive
+        TRI_ASSERT(_owned == nullptr);
+        std::shared_ptr<AqlValue> owned(new AqlValue(), DestroyOwnedValue);
+        *owned = inVarReg;
+        cur->steal(inVarReg);
+        _owned = std::move(owned);
+      }
+
       size_t toSend = (std::min)(atMost, sizeInVar - _index);
 
       // create the result
       res.reset(new AqlItemBlock(toSend, getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()]));
 
+      if (_owned != nullptr) {
+        res->addReferencedValue(_owned);
+      }
+
       inheritRegisters(cur, res.get(), _pos);
 
       // we might have a collection:
@@ -181,8 +265,6 @@ AqlItemBlock* EnumerateListBlock::getSome (size_t, size_t atMost) {
         }
         // add the new register value . . .
         AqlValue a = getAqlValue(inVarReg);
-        // deep copy of the inVariable.at(_pos) with correct memory
-        // requirements
         // Note that _index has been increased by 1 by getAqlValue!
         try {
           TRI_IF_FAILURE("EnumerateListBlock::getSome") {
@@ -201,6 +283,7 @@ AqlItemBlock* EnumerateListBlock::getSome (size_t, size_t atMost) {
       _index = 0;
       _thisBlock = 0;
       _seen = 0;
+      _owned.reset();
       // advance read position in the current block . . .
       if (++_pos == cur->size()) {
         delete cur;
@@ -271,6 +354,7 @@ size_t EnumerateListBlock::skipSome (size_t atLeast, size_t atMost) {
       }
 
       case AqlValue::SHAPED: 
+      case AqlValue::INLINE: 
       case AqlValue::EMPTY: {
         throwArrayExpectedException();
       }
@@ -287,6 +371,7 @@ size_t EnumerateListBlock::skipSome (size_t atLeast, size_t atMost) {
       _index = 0;
       _thisBlock = 0;
       _seen = 0;
+      _owned.reset();
       delete cur;
       _buffer.pop_front();
       _pos = 0;
@@ -306,17 +391,17 @@ AqlValue EnumerateListBlock::getAqlValue (AqlValue const& inVarReg) {
 
   switch (inVarReg._type) {
     case AqlValue::JSON: {
-      // FIXME: is this correct? What if the copy works, but the
-      // new throws? Is this then a leak? What if the new works
-      // but the AqlValue temporary cannot be made?
-      return AqlValue(new Json(inVarReg._json->at(static_cast<int>(_index++)).copy()));
+      auto member = static_cast<TRI_json_t*>(TRI_AtVector(&inVarReg._json->json()->_value._objects, _index++));
+      return MemberValue(member, _owned != nullptr);
     }
     case AqlValue::RANGE: {
-      return AqlValue(new Json(static_cast<double>(inVarReg._range->at(_index++))));
+      return AqlValue::CreateInt64(inVarReg._range->at(_index++));
     }
     case AqlValue::DOCVEC: { // incoming doc vec has a single column
       auto& block = inVarReg._vector->at(_thisBlock);
-      AqlValue out = block->getValue(_index - _seen, 0).clone();
+      AqlValue const& value = block->getValueReference(_index - _seen, 0);
+      // the block keeps the value alive if it is owned
+      AqlValue out = (_owned != nullptr ? value.shallowClone() : value.clone());
       if (++_index == block->size() + _seen) {
         _seen += block->size();
         _thisBlock++;
@@ -325,6 +410,7 @@ AqlValue EnumerateListBlock::getAqlValue (AqlValue const& inVarReg) {
     }
 
     case AqlValue::SHAPED:
+    case AqlValue::INLINE:
     case AqlValue::EMPTY: {
       // error
       break;
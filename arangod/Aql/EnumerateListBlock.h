@@ -122,6 +122,14 @@ namespace triagens {
 
         size_t _docVecSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the value currently looped over, if this block has taken it over
+/// from the input block. the values produced then point into it instead of
+/// copying its members
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<AqlValue> _owned;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief document collection from DOCVEC
 ////////////////////////////////////////////////////////////////////////////////
@@ -323,7 +323,7 @@ void ExecutionBlock::inheritRegisters (AqlItemBlock const* src,
 bool ExecutionBlock::getBlock (size_t atLeast, size_t atMost) {
   throwIfKilled(); // check if we were aborted
 
-  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->getSome(atLeast, atMost));
+  std::unique_ptr<AqlItemBlock> docs(_dependencies[0]->profiledGetSome(atLeast, atMost));
 
   if (docs == nullptr) {
     return false;
@@ -388,10 +388,10 @@ size_t ExecutionBlock::skipSome (size_t atLeast, size_t atMost) {
 // skip exactly <number> outputs, returns <true> if _done after
 // skipping, and <false> otherwise . . .
 bool ExecutionBlock::skip (size_t number) {
-  size_t skipped = skipSome(number, number);
+  size_t skipped = profiledSkipSome(number, number);
   size_t nr = skipped;
   while (nr != 0 && skipped < number) {
-    nr = skipSome(number - skipped, number - skipped);
+    nr = profiledSkipSome(number - skipped, number - skipped);
     skipped += nr;
   }
   if (nr == 0) {
@@ -400,6 +400,49 @@ bool ExecutionBlock::skip (size_t number) {
   return ! hasMore();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, recording the runtime figures
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* ExecutionBlock::getSomeWithProfile (size_t atLeast, size_t atMost) {
+  TRI_ASSERT(_profile != nullptr);
+
+  double const start = TRI_microtime();
+  AqlItemBlock* result = getSome(atLeast, atMost);
+
+  _profile->runtime += TRI_microtime() - start;
+  ++_profile->calls;
+
+  if (result != nullptr) {
+    _profile->items += result->size();
+
+    size_t const memory = result->size() * result->getNrRegs() * sizeof(AqlValue);
+
+    if (memory > _profile->peakMemory) {
+      _profile->peakMemory = memory;
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, recording the runtime figures
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ExecutionBlock::skipSomeWithProfile (size_t atLeast, size_t atMost) {
+  TRI_ASSERT(_profile != nullptr);
+
+  double const start = TRI_microtime();
+  size_t const skipped = skipSome(atLeast, atMost);
+
+  _profile->runtime += TRI_microtime() - start;
+  ++_profile->calls;
+  _profile->skipped += skipped;
+
+  return skipped;
+}
+
 bool ExecutionBlock::hasMore () {
   if (_done) {
     return false;
@@ -40,6 +40,69 @@ namespace triagens {
 
     class ExecutionEngine;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                             ExecutionBlockProfile
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runtime figures of a block, collected only for profiled queries.
+/// the runtime includes the time spent in the dependencies
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ExecutionBlockProfile {
+      ExecutionBlockProfile ()
+        : calls(0),
+          items(0),
+          skipped(0),
+          runtime(0.0),
+          peakMemory(0) {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sums up the figures of another block of the same node
+////////////////////////////////////////////////////////////////////////////////
+
+      void add (ExecutionBlockProfile const& other) {
+        calls   += other.calls;
+        items   += other.items;
+        skipped += other.skipped;
+        runtime += other.runtime;
+        if (other.peakMemory > peakMemory) {
+          peakMemory = other.peakMemory;
+        }
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of getSome and skipSome calls
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t calls;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows returned
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t items;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows skipped
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t skipped;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time spent in getSome and skipSome, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+      double runtime;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory of the largest AqlItemBlock returned, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t peakMemory;
+    };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    ExecutionBlock
 // -----------------------------------------------------------------------------
@@ -269,6 +332,62 @@ namespace triagens {
           return _exeNode;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome for the consumers of a block, which records the runtime
+/// figures if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* profiledGetSome (size_t atLeast, size_t atMost) {
+          if (_profile == nullptr) {
+            return getSome(atLeast, atMost);
+          }
+          return getSomeWithProfile(atLeast, atMost);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome for the consumers of a block, which records the runtime
+/// figures if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t profiledSkipSome (size_t atLeast, size_t atMost) {
+          if (_profile == nullptr) {
+            return skipSome(atLeast, atMost);
+          }
+          return skipSomeWithProfile(atLeast, atMost);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts collecting runtime figures
+////////////////////////////////////////////////////////////////////////////////
+
+        void enableProfiling () {
+          if (_profile == nullptr) {
+            _profile.reset(new ExecutionBlockProfile());
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the runtime figures, or nullptr if the query is not profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionBlockProfile const* profile () const {
+          return _profile.get();
+        }
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome, recording the runtime figures
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSomeWithProfile (size_t atLeast, size_t atMost);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome, recording the runtime figures
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSomeWithProfile (size_t atLeast, size_t atMost);
+
       protected:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -329,6 +448,14 @@ namespace triagens {
 
         bool _done;
 
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runtime figures, only set if the query is profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unique_ptr<ExecutionBlockProfile> _profile;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
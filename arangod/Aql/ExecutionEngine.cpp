@@ -39,12 +39,16 @@
 #include "Aql/ExecutionBlock.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/HashJoinBlock.h"
 #include "Aql/IndexBlock.h"
 #include "Aql/ModificationBlocks.h"
 #include "Aql/QueryRegistry.h"
+#include "Aql/QuerySnippetCache.h"
 #include "Aql/SortBlock.h"
 #include "Aql/SubqueryBlock.h"
+#include "Aql/TraversalBlock.h"
 #include "Aql/WalkerWorker.h"
+#include "Aql/WindowBlock.h"
 #include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "Cluster/ClusterComm.h"
@@ -68,6 +72,15 @@ static ExecutionBlock* CreateBlock (ExecutionEngine* engine,
     case ExecutionNode::INDEX: {
       return new IndexBlock(engine, static_cast<IndexNode const*>(en));
     }
+    case ExecutionNode::HASH_JOIN: {
+      return new HashJoinBlock(engine, static_cast<HashJoinNode const*>(en));
+    }
+    case ExecutionNode::TRAVERSAL: {
+      return new TraversalBlock(engine, static_cast<TraversalNode const*>(en));
+    }
+    case ExecutionNode::WINDOW: {
+      return new WindowBlock(engine, static_cast<WindowNode const*>(en));
+    }
     case ExecutionNode::ENUMERATE_COLLECTION: {
       return new EnumerateCollectionBlock(engine,
                                           static_cast<EnumerateCollectionNode const*>(en));
@@ -98,6 +111,9 @@ static ExecutionBlock* CreateBlock (ExecutionEngine* engine,
       else if (aggregationMethod == AggregationOptions::AggregationMethod::AGGREGATION_METHOD_SORTED) {
         return new SortedAggregateBlock(engine, static_cast<AggregateNode const*>(en));
       }
+      else if (aggregationMethod == AggregationOptions::AggregationMethod::AGGREGATION_METHOD_DISTINCT) {
+        return new DistinctAggregateBlock(engine, static_cast<AggregateNode const*>(en));
+      }
 
       THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "cannot instantiate AggregateBlock with undetermined aggregation method");
     }
@@ -187,13 +203,19 @@ static ExecutionBlock* CreateBlock (ExecutionEngine* engine,
 
 ExecutionEngine::ExecutionEngine (Query* query)
   : _stats(),
+    _itemBlockManager(&_stats),
     _blocks(),
     _root(nullptr),
     _query(query),
     _resultRegister(0),
     _wasShutdown(false),
     _previouslyLockedShards(nullptr),
-    _lockedShards(nullptr) {
+    _lockedShards(nullptr),
+    _prefetched(nullptr),
+    _prefetchError(TRI_ERROR_NO_ERROR),
+    _prefetchErrorMessage(),
+    _hasPrefetched(false),
+    _prefetchAllowed(false) {
 
   _blocks.reserve(8);
 }
@@ -210,6 +232,8 @@ ExecutionEngine::~ExecutionEngine () {
     // shutdown can throw - ignore it in the destructor
   }
 
+  discardPrefetch();
+
   for (auto& it : _blocks) {
     delete it;
   }
@@ -392,6 +416,9 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
         else if ((*en)->getType() == ExecutionNode::INDEX) {
           collection = const_cast<Collection*>(static_cast<IndexNode*>((*en))->collection());
         }
+        else if ((*en)->getType() == ExecutionNode::HASH_JOIN) {
+          collection = const_cast<Collection*>(static_cast<HashJoinNode*>((*en))->collection());
+        }
         else if ((*en)->getType() == ExecutionNode::INSERT ||
                  (*en)->getType() == ExecutionNode::UPDATE ||
                  (*en)->getType() == ExecutionNode::REPLACE ||
@@ -405,6 +432,31 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
       return collection;
     }
 
+    // returns the other collections read by the engine. these are
+    // co-located with the main collection of the engine
+    std::vector<Collection*> getColocatedCollections (Collection const* main) const {
+      std::vector<Collection*> result;
+
+      for (auto const& en : nodes) {
+        Collection const* collection = nullptr;
+
+        if (en->getType() == ExecutionNode::ENUMERATE_COLLECTION) {
+          collection = static_cast<EnumerateCollectionNode const*>(en)->collection();
+        }
+        else if (en->getType() == ExecutionNode::INDEX) {
+          collection = static_cast<IndexNode const*>(en)->collection();
+        }
+
+        if (collection != nullptr && 
+            collection != main &&
+            std::find(result.begin(), result.end(), collection) == result.end()) {
+          result.emplace_back(const_cast<Collection*>(collection));
+        }
+      }
+
+      return result;
+    }
+
     EngineLocation const         location;
     size_t const                 id;
     std::vector<ExecutionNode*>  nodes;
@@ -413,6 +465,14 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
                 // in the original plan that needs this engine
   };
 
+  struct SnippetRequest {
+    std::string  url;
+    std::string  body;
+    uint64_t     hash;
+    QueryId      remoteQueryId;
+    bool         sentHash;   // only the hash was sent, not the body
+  };
+
   Query*                   query;
   QueryRegistry*           queryRegistry;
   ExecutionBlock*          root;
@@ -442,6 +502,10 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
      // DBservers and used when we instantiate the ones on the
      // coordinator. Note that the main query and engine is not put into
      // this map at all.
+  std::unordered_map<std::string, SnippetRequest> snippetRequests;
+     // the requests of the current Scatter/Gather block, by shard id. these
+     // are needed to send the full request to a DB server that does not
+     // know the snippet anymore
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructor
@@ -474,7 +538,6 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 ////////////////////////////////////////////////////////////////////////////////
 
   triagens::basics::Json generatePlanForOneShard (EngineInfo const& info,
-                                                  QueryId& connectedId,
                                                   std::string const& shardId,
                                                   bool verbose) {
     // copy the relevant fragment of the plan for each shard
@@ -491,7 +554,9 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
         // update the remote node with the information about the query
         static_cast<RemoteNode*>(clone)->server("server:" + triagens::arango::ServerState::instance()->getId());
         static_cast<RemoteNode*>(clone)->ownName(shardId);
-        static_cast<RemoteNode*>(clone)->queryId(connectedId);
+        // the query id is sent in a header, so that the plan is the same
+        // for every instantiation of the query
+        static_cast<RemoteNode*>(clone)->queryId(std::string());
       }
     
       if (previous != nullptr) {
@@ -512,6 +577,7 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
   void distributePlanToShard (triagens::arango::CoordTransactionID& coordTransactionID,
                               EngineInfo const& info,
                               Collection* collection,
+                              std::vector<Collection*> const& colocated,
                               QueryId& connectedId,
                               std::string const& shardId, 
                               TRI_json_t* jsonPlan) {
@@ -522,6 +588,20 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     collection->setCurrentShard(shardId);
 
     Json jsonNodesList(TRI_UNKNOWN_MEM_ZONE, jsonPlan, Json::NOFREE);
+
+    // the DB servers do not use the estimates, and leaving them out keeps
+    // the plan the same while the number of documents changes
+    TRI_json_t* nodes = TRI_LookupObjectJson(jsonPlan, "nodes");
+    if (TRI_IsArrayJson(nodes)) {
+      size_t const n = TRI_LengthArrayJson(nodes);
+      for (size_t i = 0; i < n; ++i) {
+        TRI_json_t* node = TRI_LookupArrayJson(nodes, i);
+        if (TRI_IsObjectJson(node)) {
+          TRI_DeleteObjectJson(TRI_UNKNOWN_MEM_ZONE, node, "estimatedCost");
+          TRI_DeleteObjectJson(TRI_UNKNOWN_MEM_ZONE, node, "estimatedNrItems");
+        }
+      }
+    }
     
     // add the collection
     Json jsonCollectionsList(Json::Array);
@@ -529,6 +609,13 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     jsonCollectionsList(json("name", Json(collection->getName()))
                             ("type", Json(TRI_TransactionTypeGetStr(collection->accessType))));
 
+    // the shards of co-located collections on the same server
+    for (auto const& other : colocated) {
+      Json otherJson(Json::Object);
+      jsonCollectionsList(otherJson("name", Json(other->getName()))
+                                   ("type", Json(TRI_TransactionTypeGetStr(other->accessType))));
+    }
+
     jsonNodesList.set("collections", jsonCollectionsList);
     jsonNodesList.set("variables", query->ast()->variables()->toJson(TRI_UNKNOWN_MEM_ZONE));
 
@@ -548,22 +635,42 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     optimizerOptions.set("rules", optimizerOptionsRules);
     options.set("optimizer", optimizerOptions);
     result.set("options", options);
-    std::unique_ptr<std::string> body(new std::string(triagens::basics::JsonHelper::toString(result.json())));
-    
-    // std::cout << "GENERATED A PLAN FOR THE REMOTE SERVERS: " << *(body.get()) << "\n";
+
+    SnippetRequest request;
+    request.url = "/_db/" + triagens::basics::StringUtils::urlEncode(collection->vocbase->_name) + 
+                  "/_api/aql/instantiate";
+    request.body = triagens::basics::JsonHelper::toString(result.json());
+    request.hash = QuerySnippetCache::Hash(request.url, request.body);
+    request.remoteQueryId = connectedId;
+    // if the DB server has kept the snippet, the hash is enough
+    request.sentHash = QuerySnippetCache::instance()->isKept(request.hash);
     
+    // std::cout << "GENERATED A PLAN FOR THE REMOTE SERVERS: " << request.body << "\n";
+
+    sendSnippetRequest(coordTransactionID, shardId, request);
+    snippetRequests[shardId] = std::move(request);
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sendSnippetRequest, send the request for a snippet to one shard
+////////////////////////////////////////////////////////////////////////////////
+
+  void sendSnippetRequest (triagens::arango::CoordTransactionID& coordTransactionID,
+                           std::string const& shardId,
+                           SnippetRequest const& request) {
     auto cc = triagens::arango::ClusterComm::instance();
 
-    std::string const url("/_db/" + triagens::basics::StringUtils::urlEncode(collection->vocbase->_name) + 
-                          "/_api/aql/instantiate");
+    std::unique_ptr<std::string> body(new std::string(request.sentHash ? "{}" : request.body));
 
     auto headers = new std::map<std::string, std::string>;
     (*headers)["X-Arango-Nolock"] = shardId;   // Prevent locking
+    (*headers)["X-Arango-Aql-Snippet"] = triagens::basics::StringUtils::itoa(request.hash);
+    (*headers)["X-Arango-Aql-Remote-Query-Id"] = triagens::basics::StringUtils::itoa(request.remoteQueryId);
     auto res = cc->asyncRequest("", 
                                 coordTransactionID,
                                 "shard:" + shardId,  
                                 triagens::rest::HttpRequest::HTTP_REQUEST_POST, 
-                                url,
+                                request.url,
                                 body.release(),
                                 true,
                                 headers,
@@ -604,6 +711,16 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
           triagens::basics::Json response(TRI_UNKNOWN_MEM_ZONE, triagens::basics::JsonHelper::fromString(res->answer->body()));
           std::string queryId = triagens::basics::JsonHelper::getStringValue(response.json(), "queryId", "");
 
+          auto it = snippetRequests.find(res->shardID);
+          if (it != snippetRequests.end()) {
+            if (triagens::basics::JsonHelper::getBooleanValue(response.json(), "snippet", false)) {
+              QuerySnippetCache::instance()->setKept((*it).second.hash);
+            }
+            else {
+              QuerySnippetCache::instance()->unsetKept((*it).second.hash);
+            }
+          }
+
           // std::cout << "DB SERVER ANSWERED WITHOUT ERROR: " << res->answer->body() << ", REMOTENODEID: " << info.idOfRemoteNode << " SHARDID:"  << res->shardID << ", QUERYID: " << queryId << "\n";
           std::string theID
             = triagens::basics::StringUtils::itoa(info.idOfRemoteNode)
@@ -615,6 +732,12 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
             queryIds.emplace(theID, queryId);
           }
         }
+        else if (res->answer_code == triagens::rest::HttpResponse::NOT_FOUND &&
+                 resendSnippetRequest(coordTransactionID, res)) {
+          // the DB server does not know the snippet anymore, and has been
+          // sent the full request. wait for its answer, too
+          count++;
+        }
         else {
           error += "DB SERVER ANSWERED WITH ERROR: ";
           error += res->answer->body();
@@ -639,6 +762,34 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
     }
   }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resendSnippetRequest, send the full request to a shard that did not
+/// know the snippet. returns false if the answer is another error
+////////////////////////////////////////////////////////////////////////////////
+
+  bool resendSnippetRequest (triagens::arango::CoordTransactionID& coordTransactionID,
+                             triagens::arango::ClusterCommResult const* res) {
+    auto it = snippetRequests.find(res->shardID);
+
+    if (it == snippetRequests.end() || ! (*it).second.sentHash) {
+      return false;
+    }
+
+    triagens::basics::Json response(TRI_UNKNOWN_MEM_ZONE, triagens::basics::JsonHelper::fromString(res->answer->body()));
+    int errorNum = triagens::basics::JsonHelper::getNumericValue<int>(response.json(), "errorNum", TRI_ERROR_NO_ERROR);
+
+    if (errorNum != TRI_ERROR_QUERY_SNIPPET_NOT_FOUND) {
+      return false;
+    }
+
+    SnippetRequest& request = (*it).second;
+    QuerySnippetCache::instance()->unsetKept(request.hash);
+    request.sentHash = false;
+    sendSnippetRequest(coordTransactionID, res->shardID, request);
+
+    return true;
+  }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief distributePlansToShards, for a single Scatter/Gather block
 ////////////////////////////////////////////////////////////////////////////////
@@ -648,23 +799,35 @@ struct CoordinatorInstanciator : public WalkerWorker<ExecutionNode> {
 
     // std::cout << "distributePlansToShards: " << info.id << std::endl;
     Collection* collection = info.getCollection();
+    std::vector<Collection*> const colocated = info.getColocatedCollections(collection);
     // now send the plan to the remote servers
     triagens::arango::CoordTransactionID coordTransactionID = TRI_NewTickServer();
     auto cc = triagens::arango::ClusterComm::instance();
     TRI_ASSERT(cc != nullptr);
+    snippetRequests.clear();
 
     // iterate over all shards of the collection
     for (auto& shardId : collection->shardIds()) {
       // inject the current shard id into the collection
       collection->setCurrentShard(shardId);
-      auto jsonPlan = generatePlanForOneShard(info, connectedId, shardId, true);
 
-      distributePlanToShard(coordTransactionID, info, collection, connectedId, shardId, jsonPlan.steal());
+      for (auto& other : colocated) {
+        other->setCurrentShard(other->colocatedShard(collection, shardId));
+      }
+
+      auto jsonPlan = generatePlanForOneShard(info, shardId, true);
+
+      distributePlanToShard(coordTransactionID, info, collection, colocated, connectedId, shardId, jsonPlan.steal());
     }
 
     // fix collection  
     collection->resetCurrentShard();
+
+    for (auto& other : colocated) {
+      other->resetCurrentShard();
+    }
     aggregateQueryIds(info, cc, coordTransactionID, collection);
+    snippetRequests.clear();
   }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1115,6 +1278,201 @@ void ExecutionEngine::addBlock (ExecutionBlock* block) {
   TRI_ASSERT(block != nullptr);
 
   _blocks.emplace_back(block);
+
+  if (_query->profiling()) {
+    block->enableProfiling();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the runtime figures of the blocks by plan node id
+////////////////////////////////////////////////////////////////////////////////
+
+std::unordered_map<size_t, ExecutionBlockProfile> ExecutionEngine::blockProfiles () const {
+  std::unordered_map<size_t, ExecutionBlockProfile> result;
+
+  for (auto const& it : _blocks) {
+    auto profile = it->profile();
+
+    if (profile != nullptr) {
+      // a node may have been instantiated more than once, e.g. for several
+      // shards
+      result[it->getPlanNode()->id()].add(*profile);
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* ExecutionEngine::getSome (size_t atLeast, size_t atMost) {
+  _prefetchAllowed = true;
+
+  if (! _hasPrefetched) {
+    return _root->profiledGetSome(atLeast, atMost);
+  }
+
+  _hasPrefetched = false;
+
+  if (_prefetchError != TRI_ERROR_NO_ERROR) {
+    int res = _prefetchError;
+    std::string message;
+    message.swap(_prefetchErrorMessage);
+    _prefetchError = TRI_ERROR_NO_ERROR;
+
+    THROW_ARANGO_EXCEPTION_MESSAGE(res, message);
+  }
+
+  std::unique_ptr<AqlItemBlock> result(_prefetched);
+  _prefetched = nullptr;
+
+  if (result.get() == nullptr) {
+    // the prefetch found the engine exhausted
+    return nullptr;
+  }
+
+  size_t const n = result->size();
+
+  if (n > atMost) {
+    // the caller wants less than was prefetched, keep the rest for later
+    std::unique_ptr<AqlItemBlock> first(result->slice(0, atMost));
+    _prefetched = result->slice(atMost, n);
+    _hasPrefetched = true;
+    return first.release();
+  }
+
+  if (n < atLeast) {
+    // the caller wants more than was prefetched
+    std::unique_ptr<AqlItemBlock> more(_root->profiledGetSome(atLeast - n, atMost - n));
+
+    if (more.get() != nullptr) {
+      std::vector<AqlItemBlock*> blocks{ result.get(), more.get() };
+      return AqlItemBlock::concatenate(blocks);
+    }
+  }
+
+  return result.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skipSome
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ExecutionEngine::skipSome (size_t atLeast, size_t atMost) {
+  if (! _hasPrefetched) {
+    return _root->profiledSkipSome(atLeast, atMost);
+  }
+
+  std::unique_ptr<AqlItemBlock> items(getSome(atLeast, atMost));
+
+  if (items.get() == nullptr) {
+    return 0;
+  }
+
+  return items->size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skip
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExecutionEngine::skip (size_t number) {
+  if (_hasPrefetched && number > 0) {
+    std::unique_ptr<AqlItemBlock> items(getSome(number, number));
+
+    if (items.get() == nullptr) {
+      return true;
+    }
+
+    number -= items->size();
+
+    if (number == 0) {
+      return ! hasMore();
+    }
+  }
+
+  return _root->skip(number);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the engine may compute results in advance
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExecutionEngine::canPrefetch () const {
+  if (! _prefetchAllowed || _hasPrefetched || _wasShutdown) {
+    return false;
+  }
+
+  for (auto const& it : _blocks) {
+    switch (it->getPlanNode()->getType()) {
+      case ExecutionNode::SCATTER:
+      case ExecutionNode::DISTRIBUTE:
+      case ExecutionNode::INSERT:
+      case ExecutionNode::REMOVE:
+      case ExecutionNode::REPLACE:
+      case ExecutionNode::UPDATE:
+      case ExecutionNode::UPSERT: {
+        return false;
+      }
+      default: {
+        break;
+      }
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the result of the next getSome() call in advance
+////////////////////////////////////////////////////////////////////////////////
+
+void ExecutionEngine::prefetch (size_t atLeast, size_t atMost) {
+  if (! canPrefetch()) {
+    // the cursor was re-initialized or used up in the meantime
+    return;
+  }
+
+  try {
+    _prefetched = _root->profiledGetSome(atLeast, atMost);
+  }
+  catch (triagens::basics::Exception const& ex) {
+    _prefetchError = ex.code();
+    _prefetchErrorMessage = ex.message();
+  }
+  catch (std::bad_alloc const&) {
+    _prefetchError = TRI_ERROR_OUT_OF_MEMORY;
+    _prefetchErrorMessage = TRI_errno_string(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  catch (std::exception const& ex) {
+    _prefetchError = TRI_ERROR_INTERNAL;
+    _prefetchErrorMessage = ex.what();
+  }
+  catch (...) {
+    _prefetchError = TRI_ERROR_INTERNAL;
+    _prefetchErrorMessage = TRI_errno_string(TRI_ERROR_INTERNAL);
+  }
+
+  _hasPrefetched = true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the results of a prefetch that were not picked up
+////////////////////////////////////////////////////////////////////////////////
+
+void ExecutionEngine::discardPrefetch () {
+  delete _prefetched;
+  _prefetched = nullptr;
+  _prefetchError = TRI_ERROR_NO_ERROR;
+  _prefetchErrorMessage.clear();
+  _hasPrefetched = false;
 }
 
 // -----------------------------------------------------------------------------
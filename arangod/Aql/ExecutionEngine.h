@@ -112,6 +112,8 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         int initializeCursor (AqlItemBlock* items, size_t pos) {
+          discardPrefetch();
+          _prefetchAllowed = false;
           return _root->initializeCursor(items, pos);
         }
 
@@ -134,6 +136,9 @@ namespace triagens {
               _previouslyLockedShards = nullptr;
             }
 
+            discardPrefetch();
+            _prefetchAllowed = false;
+
             // prevent a duplicate shutdown
             int res = _root->shutdown(errorCode);
             _wasShutdown = true;
@@ -148,39 +153,37 @@ namespace triagens {
 /// @brief getSome
 ////////////////////////////////////////////////////////////////////////////////
 
-        AqlItemBlock* getSome (size_t atLeast, size_t atMost) {
-          return _root->getSome(atLeast, atMost);
-        }
+        AqlItemBlock* getSome (size_t atLeast, size_t atMost);
         
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief skipSome
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t skipSome (size_t atLeast, size_t atMost) {
-          return _root->skipSome(atLeast, atMost);
-        }
+        size_t skipSome (size_t atLeast, size_t atMost);
         
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief getOne
 ////////////////////////////////////////////////////////////////////////////////
 
         AqlItemBlock* getOne () {
-          return _root->getSome(1, 1);
+          return getSome(1, 1);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief skip
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool skip (size_t number) {
-          return _root->skip(number);
-        }
+        bool skip (size_t number);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hasMore
 ////////////////////////////////////////////////////////////////////////////////
 
         inline bool hasMore () const {
+          if (_hasPrefetched) {
+            // a failed prefetch still has to report its error
+            return (_prefetched != nullptr || _prefetchError != TRI_ERROR_NO_ERROR);
+          }
           return _root->hasMore();
         }
 
@@ -197,9 +200,30 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         inline int64_t remaining () const {
-          return _root->remaining();
+          int64_t number = _root->remaining();
+          if (number != -1 && _prefetched != nullptr) {
+            number += static_cast<int64_t>(_prefetched->size());
+          }
+          return number;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the engine may compute results in advance via prefetch().
+/// this is the case for DB server snippets that have handed out results
+/// since their cursor was last initialized, and that do not serve other
+/// snippets or modify data
+////////////////////////////////////////////////////////////////////////////////
+
+        bool canPrefetch () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the result of the next getSome() call in advance. this is
+/// called on a dispatcher thread while the query is not in use otherwise.
+/// an error is stored and reported by the next getSome() call
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetch (size_t atLeast, size_t atMost);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief add a block to the engine
 ////////////////////////////////////////////////////////////////////////////////
@@ -238,6 +262,25 @@ namespace triagens {
           return _lockedShards;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the runtime figures of the blocks by plan node id. empty if the
+/// query is not profiled
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<size_t, ExecutionBlockProfile> blockProfiles () const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the results of a prefetch that were not picked up
+////////////////////////////////////////////////////////////////////////////////
+
+        void discardPrefetch ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -306,6 +349,34 @@ namespace triagens {
 
         std::unordered_set<std::string>* _lockedShards;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the result of prefetch(), nullptr if the engine was exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock*                _prefetched;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief error code and message of a failed prefetch()
+////////////////////////////////////////////////////////////////////////////////
+
+        int                          _prefetchError;
+
+        std::string                  _prefetchErrorMessage;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether prefetch() has run and its result was not picked up yet
+////////////////////////////////////////////////////////////////////////////////
+
+        bool                         _hasPrefetched;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether getSome() was called since the cursor was initialized.
+/// a prefetch before that could consume input of the coordinator that the
+/// initialization of the other snippets of the query resets
+////////////////////////////////////////////////////////////////////////////////
+
+        bool                         _prefetchAllowed;
+
     };
 
   }
@@ -31,10 +31,13 @@
 #include "Aql/ClusterNodes.h"
 #include "Aql/Collection.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/HashJoinNode.h"
 #include "Aql/IndexNode.h"
 #include "Aql/ModificationNodes.h"
 #include "Aql/SortNode.h"
+#include "Aql/TraversalNode.h"
 #include "Aql/WalkerWorker.h"
+#include "Aql/WindowNode.h"
 #include "Basics/StringBuffer.h"
 
 using namespace std;
@@ -64,6 +67,9 @@ std::unordered_map<int, std::string const> const ExecutionNode::TypeNames{
   { static_cast<int>(ENUMERATE_COLLECTION),         "EnumerateCollectionNode" },
   { static_cast<int>(ENUMERATE_LIST),               "EnumerateListNode" },
   { static_cast<int>(INDEX),                        "IndexNode" },
+  { static_cast<int>(HASH_JOIN),                    "HashJoinNode" },
+  { static_cast<int>(TRAVERSAL),                    "TraversalNode" },
+  { static_cast<int>(WINDOW),                       "WindowNode" },
   { static_cast<int>(LIMIT),                        "LimitNode" },
   { static_cast<int>(CALCULATION),                  "CalculationNode" },
   { static_cast<int>(SUBQUERY),                     "SubqueryNode" },
@@ -234,6 +240,12 @@ ExecutionNode* ExecutionNode::fromJsonFactory (ExecutionPlan* plan,
       return new NoResultsNode(plan, oneNode);
     case INDEX:
       return new IndexNode(plan, oneNode);
+    case HASH_JOIN:
+      return new HashJoinNode(plan, oneNode);
+    case TRAVERSAL:
+      return new TraversalNode(plan, oneNode);
+    case WINDOW:
+      return new WindowNode(plan, oneNode);
     case REMOTE:
       return new RemoteNode(plan, oneNode);
     case GATHER: {
@@ -430,6 +442,11 @@ void ExecutionNode::cloneHelper (ExecutionNode* other,
   }
 
   if (withDependencies) {
+    // the clone of a whole sub-plan has the same costs
+    other->_estimatedCost = _estimatedCost;
+    other->_estimatedNrItems = _estimatedNrItems;
+    other->_estimatedCostSet = _estimatedCostSet;
+
     cloneDependencies(plan, other, withProperties);
   }
 }
@@ -545,7 +562,8 @@ bool ExecutionNode::isInInnerLoop () const {
 
     if (type == ENUMERATE_COLLECTION ||
         type == INDEX ||
-        type == ENUMERATE_LIST) {
+        type == ENUMERATE_LIST ||
+        type == TRAVERSAL) {
       // we are contained in an outer loop
       return true;
 
@@ -845,6 +863,36 @@ void ExecutionNode::RegisterPlan::after (ExecutionNode* en) {
       totalNrRegs++;
       break;
     }
+    
+    case ExecutionNode::HASH_JOIN: {
+      depth++;
+      nrRegsHere.emplace_back(1);
+      // create a copy of the last value here
+      // this is requried because back returns a reference and emplace/push_back may invalidate all references
+      RegisterId registerId = 1 + nrRegs.back();
+      nrRegs.emplace_back(registerId);
+
+      auto ep = static_cast<HashJoinNode const*>(en);
+      TRI_ASSERT(ep != nullptr);
+      varInfo.emplace(ep->outVariable()->id, VarInfo(depth, totalNrRegs));
+      totalNrRegs++;
+      break;
+    }
+
+    case ExecutionNode::TRAVERSAL: {
+      depth++;
+      nrRegsHere.emplace_back(1);
+      // create a copy of the last value here
+      // this is requried because back returns a reference and emplace/push_back may invalidate all references
+      RegisterId registerId = 1 + nrRegs.back();
+      nrRegs.emplace_back(registerId);
+
+      auto ep = static_cast<TraversalNode const*>(en);
+      TRI_ASSERT(ep != nullptr);
+      varInfo.emplace(ep->outVariable()->id, VarInfo(depth, totalNrRegs));
+      totalNrRegs++;
+      break;
+    }
 
     case ExecutionNode::ENUMERATE_LIST: {
       depth++;
@@ -871,6 +919,20 @@ void ExecutionNode::RegisterPlan::after (ExecutionNode* en) {
       break;
     }
 
+    case ExecutionNode::WINDOW: {
+      // the aggregates are added to the incoming rows, like calculations
+      auto ep = static_cast<WindowNode const*>(en);
+      TRI_ASSERT(ep != nullptr);
+
+      for (auto const& it : ep->aggregates()) {
+        nrRegsHere[depth]++;
+        nrRegs[depth]++;
+        varInfo.emplace(it.outVariable->id, VarInfo(depth, totalNrRegs));
+        totalNrRegs++;
+      }
+      break;
+    }
+
     case ExecutionNode::SUBQUERY: {
       nrRegsHere[depth]++;
       nrRegs[depth]++;
@@ -1112,7 +1174,25 @@ EnumerateCollectionNode::EnumerateCollectionNode (ExecutionPlan* plan,
     _vocbase(plan->getAst()->query()->vocbase()),
     _collection(plan->getAst()->query()->collections()->get(JsonHelper::checkAndGetStringValue(base.json(), "collection"))),
     _outVariable(varFromJson(plan->getAst(), base, "outVariable")),
-    _random(JsonHelper::checkAndGetBooleanValue(base.json(), "random")) {
+    _random(JsonHelper::checkAndGetBooleanValue(base.json(), "random")),
+    _projections() {
+
+  auto projections = TRI_LookupObjectJson(base.json(), "projections");
+
+  if (TRI_IsArrayJson(projections)) {
+    size_t const n = TRI_LengthArrayJson(projections);
+    _projections.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      auto projection = TRI_LookupArrayJson(projections, i);
+
+      if (! TRI_IsStringJson(projection)) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid projection");
+      }
+
+      _projections.emplace_back(projection->_value._string.data, projection->_value._string.length - 1);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1134,6 +1214,14 @@ void EnumerateCollectionNode::toJsonHelper (triagens::basics::Json& nodes,
       ("outVariable", _outVariable->toJson())
       ("random", triagens::basics::Json(_random));
 
+  if (! _projections.empty()) {
+    triagens::basics::Json projections(triagens::basics::Json::Array, _projections.size());
+    for (auto const& it : _projections) {
+      projections.add(triagens::basics::Json(it));
+    }
+    json("projections", projections);
+  }
+
   // And add it:
   nodes(json);
 }
@@ -1152,6 +1240,7 @@ ExecutionNode* EnumerateCollectionNode::clone (ExecutionPlan* plan,
   }
     
   auto c = new EnumerateCollectionNode(plan, _id, _vocbase, _collection, outVariable, _random);
+  c->_projections = _projections;
 
   cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1400,7 +1489,8 @@ SubqueryNode::SubqueryNode (ExecutionPlan* plan,
                             triagens::basics::Json const& base)
   : ExecutionNode(plan, base),
     _subquery(nullptr),
-    _outVariable(varFromJson(plan->getAst(), base, "outVariable")) {
+    _outVariable(varFromJson(plan->getAst(), base, "outVariable")),
+    _cacheResults(JsonHelper::getBooleanValue(base.json(), "cacheResults", false)) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1415,7 +1505,8 @@ void SubqueryNode::toJsonHelper (triagens::basics::Json& nodes,
     return;
   }
   json("subquery",  _subquery->toJson(TRI_UNKNOWN_MEM_ZONE, verbose))
-      ("outVariable", _outVariable->toJson());
+      ("outVariable", _outVariable->toJson())
+      ("cacheResults", triagens::basics::Json(_cacheResults));
 
   // And add it:
   nodes(json);
@@ -1431,6 +1522,7 @@ ExecutionNode* SubqueryNode::clone (ExecutionPlan* plan,
   }
   auto c = new SubqueryNode(plan, _id, _subquery->clone(plan, true, withProperties),
                             outVariable);
+  c->_cacheResults = _cacheResults;
 
   cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -1450,6 +1542,11 @@ double SubqueryNode::estimateCost (size_t& nrItems) const {
   double depCost = _dependencies.at(0)->getCost(nrItems);
   size_t nrItemsSubquery;
   double subCost = _subquery->getCost(nrItemsSubquery);
+
+  if (_cacheResults && getVariablesUsedHere().empty()) {
+    // an uncorrelated subquery is executed only once
+    return depCost + subCost + nrItems;
+  }
   return depCost + nrItems * subCost;
 }
 
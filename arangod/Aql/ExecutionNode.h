@@ -90,7 +90,10 @@ namespace triagens {
           NORESULTS               = 19,
           DISTRIBUTE              = 20,
           UPSERT                  = 21,
-          INDEX                   = 22
+          INDEX                   = 22,
+          HASH_JOIN               = 23,
+          TRAVERSAL               = 24,
+          WINDOW                  = 25
         };
 
 // -----------------------------------------------------------------------------
@@ -409,13 +412,31 @@ namespace triagens {
 /// @brief invalidate the cost estimation for the node and its dependencies
 ////////////////////////////////////////////////////////////////////////////////
         
-        void invalidateCost () {
+        virtual void invalidateCost () {
           _estimatedCostSet = false;
           
           for (auto& dep : _dependencies) {
             dep->invalidateCost();
           }
         }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the cost estimation for the node and its parents, and
+/// return the topmost node reached. the estimates of the dependencies, which
+/// do not depend on the node, remain valid
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNode* invalidateCostUpwards () {
+          _estimatedCostSet = false;
+
+          ExecutionNode* top = this;
+
+          for (auto& parent : _parents) {
+            top = parent->invalidateCostUpwards();
+          }
+
+          return top;
+        }
        
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief estimate the cost of the node . . .
@@ -917,7 +938,8 @@ namespace triagens {
             _vocbase(vocbase), 
             _collection(collection),
             _outVariable(outVariable),  
-            _random(random) {
+            _random(random),
+            _projections() {
 
           TRI_ASSERT(_vocbase != nullptr);
           TRI_ASSERT(_collection != nullptr);
@@ -974,6 +996,14 @@ namespace triagens {
           _random = true;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the documents are iterated in random order
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isRandom () const {
+          return _random;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the database
 ////////////////////////////////////////////////////////////////////////////////
@@ -998,6 +1028,23 @@ namespace triagens {
           return _outVariable;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the top-level attributes the node produces instead of complete
+/// documents. if empty, the node produces complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const& projections () const {
+          return _projections;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief make the node produce only the given attributes of the documents
+////////////////////////////////////////////////////////////////////////////////
+
+        void setProjections (std::vector<std::string> const& projections) {
+          _projections = projections;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -1027,6 +1074,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         bool _random;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes produced instead of complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _projections;
     };
 
 // -----------------------------------------------------------------------------
@@ -1150,6 +1203,7 @@ namespace triagens {
       
       friend class ExecutionBlock;
       friend class LimitBlock;
+      friend class SortBlock;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructors for various arguments, always with offset and limit
@@ -1228,6 +1282,30 @@ namespace triagens {
           _fullCount = true;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the node fully counts what it limits
+////////////////////////////////////////////////////////////////////////////////
+
+        bool fullCount () const {
+          return _fullCount;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the offset
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t offset () const {
+          return _offset;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the limit
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t limit () const {
+          return _limit;
+        }
+
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1457,7 +1535,8 @@ namespace triagens {
                       Variable const* outVariable)
           : ExecutionNode(plan, id), 
             _subquery(subquery), 
-            _outVariable(outVariable) {
+            _outVariable(outVariable),
+            _cacheResults(false) {
 
           TRI_ASSERT(_subquery != nullptr);
           TRI_ASSERT(_outVariable != nullptr);
@@ -1513,6 +1592,18 @@ namespace triagens {
           _subquery = subquery;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the cost estimation, including the one of the subquery
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidateCost () override final {
+          ExecutionNode::invalidateCost();
+
+          if (_subquery != nullptr) {
+            _subquery->invalidateCost();
+          }
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief estimateCost
 ////////////////////////////////////////////////////////////////////////////////
@@ -1545,6 +1636,24 @@ namespace triagens {
 
         void replaceOutVariable(Variable const* var);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the results of the subquery are cached by the values of
+/// the outer variables it uses
+////////////////////////////////////////////////////////////////////////////////
+
+        bool cacheResults () const {
+          return _cacheResults;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enable caching of the subquery results. this must only be used if
+/// the subquery is deterministic and does not modify data
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCacheResults () {
+          _cacheResults = true;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief can the node throw? Note that this means that an exception can
 /// *originate* from this node. That is, this method does not need to
@@ -1571,6 +1680,12 @@ namespace triagens {
 
         Variable const* _outVariable;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the results of the subquery are cached
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _cacheResults;
+
     };
 
 // -----------------------------------------------------------------------------
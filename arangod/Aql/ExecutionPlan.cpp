@@ -32,6 +32,7 @@
 #include "Aql/AggregationOptions.h"
 #include "Aql/Ast.h"
 #include "Aql/AstNode.h"
+#include "Aql/CompiledExpression.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/Expression.h"
 #include "Aql/ModificationNodes.h"
@@ -41,6 +42,7 @@
 #include "Aql/SortNode.h"
 #include "Aql/Variable.h"
 #include "Aql/WalkerWorker.h"
+#include "Aql/WindowNode.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/Exceptions.h"
 
@@ -63,7 +65,8 @@ ExecutionPlan::ExecutionPlan (Ast* ast)
     _nextId(0),
     _ast(ast),
     _lastLimitNode(nullptr),
-    _subqueries() {
+    _subqueries(),
+    _compiledExpressions() {
 
 }
 
@@ -75,6 +78,9 @@ ExecutionPlan::~ExecutionPlan () {
   for (auto& x : _ids) {
     delete x.second;
   }
+  for (auto& x : _compiledExpressions) {
+    delete x.second;
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -126,10 +132,17 @@ void ExecutionPlan::getCollectionsFromJson (Ast* ast,
     triagens::basics::Json oneJsonCollection = jsonCollections.at(static_cast<int>(i));
     auto typeStr = triagens::basics::JsonHelper::checkAndGetStringValue(oneJsonCollection.json(), "type");
       
-    ast->query()->collections()->add(
+    auto collection = ast->query()->collections()->add(
       triagens::basics::JsonHelper::checkAndGetStringValue(oneJsonCollection.json(), "name"),
       TRI_GetTransactionTypeFromStr(triagens::basics::JsonHelper::checkAndGetStringValue(oneJsonCollection.json(), "type").c_str())
     );
+
+    // a cached plan must keep the shard restriction of the optimizer
+    std::string const restrictedShard = triagens::basics::JsonHelper::getStringValue(oneJsonCollection.json(), "restrictedShard", "");
+
+    if (collection != nullptr && ! restrictedShard.empty()) {
+      collection->restrictToShard(restrictedShard);
+    }
   }
 }
 
@@ -243,8 +256,14 @@ triagens::basics::Json ExecutionPlan::toJson (Ast* ast,
   for (auto const& c : usedCollections) {
     triagens::basics::Json json(triagens::basics::Json::Object);
 
-    jsonCollectionList(json("name", triagens::basics::Json(c.first))
-                           ("type", triagens::basics::Json(TRI_TransactionTypeGetStr(c.second->accessType))));
+    json("name", triagens::basics::Json(c.first))
+        ("type", triagens::basics::Json(TRI_TransactionTypeGetStr(c.second->accessType)));
+
+    if (! c.second->getRestrictedShard().empty()) {
+      json("restrictedShard", triagens::basics::Json(c.second->getRestrictedShard()));
+    }
+
+    jsonCollectionList(json);
   }
 
   result.set("collections", jsonCollectionList);
@@ -554,6 +573,27 @@ ExecutionNode* ExecutionPlan::createTemporaryCalculation (AstNode const* express
   return createCalculation(out, nullptr, expression, previous);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the compiled program for an expression
+////////////////////////////////////////////////////////////////////////////////
+
+CompiledExpression const* ExecutionPlan::getCompiledExpression (Expression* expression) {
+  TRI_ASSERT(expression != nullptr);
+
+  AstNode const* node = expression->node();
+  auto it = _compiledExpressions.find(node);
+
+  if (it != _compiledExpressions.end()) {
+    return (*it).second;
+  }
+
+  // the result may be a nullptr, which is cached as well
+  std::unique_ptr<CompiledExpression> compiled(CompiledExpression::compile(expression));
+  _compiledExpressions.emplace(node, compiled.get());
+
+  return compiled.release();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief adds "previous" as dependency to "plan", returns "plan"
 ////////////////////////////////////////////////////////////////////////////////
@@ -1096,6 +1136,119 @@ ExecutionNode* ExecutionPlan::fromNodeLimit (ExecutionNode* previous,
   return addDependency(previous, en);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an execution plan element from an AST WINDOW node
+/// the frame is given as an object with the optional attributes "preceding"
+/// and "following", each a non-negative number or "unbounded". by default,
+/// the frame reaches from the first row to the current row
+////////////////////////////////////////////////////////////////////////////////
+
+ExecutionNode* ExecutionPlan::fromNodeWindow (ExecutionNode* previous,
+                                              AstNode const* node) {
+  TRI_ASSERT(node != nullptr && node->type == NODE_TYPE_WINDOW);
+  TRI_ASSERT(node->numMembers() == 2);
+
+  auto frame = node->getMember(0);
+  
+  if (frame->type != NODE_TYPE_OBJECT) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_QUERY_PARSE, "expecting object literal for WINDOW frame");
+  }
+
+  int64_t preceding = WindowNode::Unbounded;
+  int64_t following = 0;
+
+  size_t const n = frame->numMembers();
+
+  for (size_t i = 0; i < n; ++i) {
+    auto member = frame->getMember(i);
+
+    if (member->type != NODE_TYPE_OBJECT_ELEMENT) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_QUERY_PARSE, "expecting literal attribute names in WINDOW frame");
+    }
+
+    std::string const name(member->getStringValue(), member->getStringLength());
+    int64_t* bound;
+
+    if (name == "preceding") {
+      bound = &preceding;
+    }
+    else if (name == "following") {
+      bound = &following;
+    }
+    else {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_QUERY_PARSE, "unknown attribute '" + name + "' in WINDOW frame, expecting 'preceding' or 'following'");
+    }
+
+    auto value = member->getMember(0);
+
+    if (value->isStringValue() &&
+        std::string(value->getStringValue(), value->getStringLength()) == "unbounded") {
+      *bound = WindowNode::Unbounded;
+    }
+    else if (value->isNumericValue() && 
+             value->getIntValue() >= 0) {
+      *bound = value->getIntValue();
+    }
+    else {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_QUERY_NUMBER_OUT_OF_RANGE, "WINDOW frame bound is not a number, not 'unbounded' or out of range");
+    }
+  }
+
+  auto list = node->getMember(1);
+  size_t const numAggregates = list->numMembers();
+
+  std::vector<WindowNode::Aggregate> aggregates;
+  aggregates.reserve(numAggregates);
+
+  for (size_t i = 0; i < numAggregates; ++i) {
+    auto member = list->getMember(i);
+    TRI_ASSERT(member->numMembers() == 3);
+
+    WindowNode::Aggregate aggregate;
+
+    auto out = member->getMember(0);
+    TRI_ASSERT(out != nullptr && out->type == NODE_TYPE_VARIABLE);
+    aggregate.outVariable = static_cast<Variable const*>(out->getData());
+
+    auto function = member->getMember(1);
+
+    if (! function->isStringValue() ||
+        ! WindowNode::aggregateType(std::string(function->getStringValue(), function->getStringLength()), aggregate.type)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_QUERY_PARSE, "WINDOW aggregates must be calls of LENGTH, SUM, AVERAGE, MIN or MAX with one argument");
+    }
+
+    auto expression = member->getMember(2);
+
+    // the arguments are computed before the node, so they cannot use the
+    // results of other aggregates of the same WINDOW
+    std::unordered_set<Variable const*> referenced;
+    Ast::getReferencedVariables(expression, referenced);
+
+    for (auto const& it : aggregates) {
+      if (referenced.find(it.outVariable) != referenced.end()) {
+        THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_VARIABLE_NAME_UNKNOWN, it.outVariable->name.c_str());
+      }
+    }
+
+    if (expression->type == NODE_TYPE_REFERENCE) {
+      // operand is a variable
+      aggregate.inVariable = static_cast<Variable const*>(expression->getData());
+    }
+    else {
+      // operand is some misc expression
+      auto calc = createTemporaryCalculation(expression, previous);
+      previous = calc;
+      aggregate.inVariable = getOutVariable(calc);
+    }
+
+    aggregates.emplace_back(aggregate);
+  }
+
+  auto en = registerNode(new WindowNode(this, nextId(), preceding, following, aggregates));
+
+  return addDependency(previous, en);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an execution plan element from an AST RETURN node
 ////////////////////////////////////////////////////////////////////////////////
@@ -1440,6 +1593,11 @@ ExecutionNode* ExecutionPlan::fromNode (AstNode const* node) {
         en = fromNodeLimit(en, member);
         break;
       }
+
+      case NODE_TYPE_WINDOW: {
+        en = fromNodeWindow(en, member);
+        break;
+      }
     
       case NODE_TYPE_RETURN: {
         en = fromNodeReturn(en, member);
@@ -1849,7 +2007,9 @@ bool ExecutionPlan::isDeadSimple () const {
     if (nodeType == ExecutionNode::SUBQUERY ||
         nodeType == ExecutionNode::ENUMERATE_COLLECTION ||
         nodeType == ExecutionNode::ENUMERATE_LIST ||
-        nodeType == ExecutionNode::INDEX) { 
+        nodeType == ExecutionNode::INDEX ||
+        nodeType == ExecutionNode::HASH_JOIN ||
+        nodeType == ExecutionNode::TRAVERSAL) { 
       // these node types are not simple
       return false;
     }
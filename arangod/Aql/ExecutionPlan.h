@@ -45,7 +45,9 @@ namespace triagens {
     class Ast;
     struct AstNode;
     class CalculationNode;
+    class CompiledExpression;
     class ExecutionNode;
+    class Expression;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                               class ExecutionPlan
@@ -344,6 +346,15 @@ namespace triagens {
         ExecutionNode* createTemporaryCalculation (AstNode const*,
                                                    ExecutionNode*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the compiled program for an expression, compiling it on
+/// first use. returns a nullptr if the expression cannot be compiled. the
+/// program is owned by the plan and shared by all blocks executing the
+/// expression
+////////////////////////////////////////////////////////////////////////////////
+
+        CompiledExpression const* getCompiledExpression (Expression*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -453,6 +464,13 @@ namespace triagens {
         ExecutionNode* fromNodeLimit (ExecutionNode*,
                                       AstNode const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an execution plan element from an AST WINDOW node
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNode* fromNodeWindow (ExecutionNode*,
+                                       AstNode const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an execution plan element from an AST RETURN node
 ////////////////////////////////////////////////////////////////////////////////
@@ -568,6 +586,12 @@ namespace triagens {
 
         std::unordered_map<VariableId, ExecutionNode*> _subqueries;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compiled expressions, keyed by the expression's AST node
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<AstNode const*, CompiledExpression*> _compiledExpressions;
+
     };
 
   }
@@ -43,12 +43,14 @@ using JsonHelper = triagens::basics::JsonHelper;
 ////////////////////////////////////////////////////////////////////////////////
 
 Json ExecutionStats::toJson () const {
-  Json json(Json::Object, 5);
+  Json json(Json::Object, 8);
   json.set("writesExecuted", Json(static_cast<double>(writesExecuted)));
   json.set("writesIgnored",  Json(static_cast<double>(writesIgnored)));
   json.set("scannedFull",    Json(static_cast<double>(scannedFull)));
   json.set("scannedIndex",   Json(static_cast<double>(scannedIndex)));
   json.set("filtered",       Json(static_cast<double>(filtered)));
+  json.set("blockPoolHits",  Json(static_cast<double>(blockPoolHits)));
+  json.set("blockPoolMisses", Json(static_cast<double>(blockPoolMisses)));
 
   if (fullCount > -1) {
     // fullCount is exceptional. it has a default value of -1 and is
@@ -60,12 +62,14 @@ Json ExecutionStats::toJson () const {
 }
 
 Json ExecutionStats::toJsonStatic () {
-  Json json(Json::Object, 7);
+  Json json(Json::Object, 9);
   json.set("writesExecuted", Json(0.0));
   json.set("writesIgnored",  Json(0.0));
   json.set("scannedFull",    Json(0.0));
   json.set("scannedIndex",   Json(0.0));
   json.set("filtered",       Json(0.0));
+  json.set("blockPoolHits",  Json(0.0));
+  json.set("blockPoolMisses", Json(0.0));
   json.set("fullCount",      Json(-1.0));
   json.set("static",         Json(0.0));
 
@@ -78,7 +82,9 @@ ExecutionStats::ExecutionStats()
    scannedFull(0),
    scannedIndex(0),
    filtered(0),
-   fullCount(-1) {
+   fullCount(-1),
+   blockPoolHits(0),
+   blockPoolMisses(0) {
 }
 
 ExecutionStats::ExecutionStats (triagens::basics::Json const& jsonStats) {
@@ -94,6 +100,11 @@ ExecutionStats::ExecutionStats (triagens::basics::Json const& jsonStats) {
 
   // note: fullCount is an optional attribute!
   fullCount      = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "fullCount", -1);
+
+  // note: the block pool attributes are optional, too, as older servers
+  // do not send them
+  blockPoolHits   = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "blockPoolHits", 0);
+  blockPoolMisses = JsonHelper::getNumericValue<int64_t>(jsonStats.json(), "blockPoolMisses", 0);
 }
 
 // -----------------------------------------------------------------------------
@@ -69,6 +69,8 @@ namespace triagens {
         scannedIndex   += summand.scannedIndex;
         fullCount      += summand.fullCount;
         filtered       += summand.filtered;
+        blockPoolHits  += summand.blockPoolHits;
+        blockPoolMisses += summand.blockPoolMisses;
       }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +84,8 @@ namespace triagens {
         scannedIndex   += newStats.scannedIndex   - lastStats.scannedIndex;
         fullCount      += newStats.fullCount      - lastStats.fullCount;
         filtered       += newStats.filtered       - lastStats.filtered;
+        blockPoolHits  += newStats.blockPoolHits  - lastStats.blockPoolHits;
+        blockPoolMisses += newStats.blockPoolMisses - lastStats.blockPoolMisses;
       }
 
 
@@ -121,6 +125,18 @@ namespace triagens {
 
       int64_t fullCount; 
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of AqlItemBlocks that were recycled from the block pool
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t blockPoolHits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of AqlItemBlocks that had to be allocated
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t blockPoolMisses;
+
     };
 
   }
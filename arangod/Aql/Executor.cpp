@@ -121,15 +121,15 @@ std::unordered_map<std::string, Function const> const Executor::FunctionNames{
   
   // string functions
   { "CONCAT",                      Function("CONCAT",                      "AQL_CONCAT", "szl|+", true, true, false, true, true, &Functions::Concat) },
-  { "CONCAT_SEPARATOR",            Function("CONCAT_SEPARATOR",            "AQL_CONCAT_SEPARATOR", "s,szl|+", true, true, false, true, true) },
-  { "CHAR_LENGTH",                 Function("CHAR_LENGTH",                 "AQL_CHAR_LENGTH", "s", true, true, false, true, true) },
-  { "LOWER",                       Function("LOWER",                       "AQL_LOWER", "s", true, true, false, true, true) },
-  { "UPPER",                       Function("UPPER",                       "AQL_UPPER", "s", true, true, false, true, true) },
-  { "SUBSTRING",                   Function("SUBSTRING",                   "AQL_SUBSTRING", "s,n|n", true, true, false, true, true) },
-  { "CONTAINS",                    Function("CONTAINS",                    "AQL_CONTAINS", "s,s|b", true, true, false, true, true) },
+  { "CONCAT_SEPARATOR",            Function("CONCAT_SEPARATOR",            "AQL_CONCAT_SEPARATOR", "s,szl|+", true, true, false, true, true, &Functions::ConcatSeparator) },
+  { "CHAR_LENGTH",                 Function("CHAR_LENGTH",                 "AQL_CHAR_LENGTH", "s", true, true, false, true, true, &Functions::CharLength) },
+  { "LOWER",                       Function("LOWER",                       "AQL_LOWER", "s", true, true, false, true, true, &Functions::Lower) },
+  { "UPPER",                       Function("UPPER",                       "AQL_UPPER", "s", true, true, false, true, true, &Functions::Upper) },
+  { "SUBSTRING",                   Function("SUBSTRING",                   "AQL_SUBSTRING", "s,n|n", true, true, false, true, true, &Functions::Substring) },
+  { "CONTAINS",                    Function("CONTAINS",                    "AQL_CONTAINS", "s,s|b", true, true, false, true, true, &Functions::Contains) },
   { "LIKE",                        Function("LIKE",                        "AQL_LIKE", "s,r|b", true, true, false, true, true, &Functions::Like) },
-  { "LEFT",                        Function("LEFT",                        "AQL_LEFT", "s,n", true, true, false, true, true) },
-  { "RIGHT",                       Function("RIGHT",                       "AQL_RIGHT", "s,n", true, true, false, true, true) },
+  { "LEFT",                        Function("LEFT",                        "AQL_LEFT", "s,n", true, true, false, true, true, &Functions::Left) },
+  { "RIGHT",                       Function("RIGHT",                       "AQL_RIGHT", "s,n", true, true, false, true, true, &Functions::Right) },
   { "TRIM",                        Function("TRIM",                        "AQL_TRIM", "s|ns", true, true, false, true, true) },
   { "LTRIM",                       Function("LTRIM",                       "AQL_LTRIM", "s|s", true, true, false, true, true) },
   { "RTRIM",                       Function("RTRIM",                       "AQL_RTRIM", "s|s", true, true, false, true, true) },
@@ -169,8 +169,8 @@ std::unordered_map<std::string, Function const> const Executor::FunctionNames{
   { "STDDEV_POPULATION",           Function("STDDEV_POPULATION",           "AQL_STDDEV_POPULATION", "l", true, true, false, true, true, &Functions::StdDevPopulation) },
   { "UNIQUE",                      Function("UNIQUE",                      "AQL_UNIQUE", "l", true, true, false, true, true, &Functions::Unique) },
   { "SORTED_UNIQUE",               Function("SORTED_UNIQUE",               "AQL_SORTED_UNIQUE", "l", true, true, false, true, true, &Functions::SortedUnique) },
-  { "SLICE",                       Function("SLICE",                       "AQL_SLICE", "l,n|n", true, true, false, true, true) },
-  { "REVERSE",                     Function("REVERSE",                     "AQL_REVERSE", "ls", true, true, false, true, true) },    // note: REVERSE() can be applied on strings, too
+  { "SLICE",                       Function("SLICE",                       "AQL_SLICE", "l,n|n", true, true, false, true, true, &Functions::Slice) },
+  { "REVERSE",                     Function("REVERSE",                     "AQL_REVERSE", "ls", true, true, false, true, true, &Functions::Reverse) },    // note: REVERSE() can be applied on strings, too
   { "FIRST",                       Function("FIRST",                       "AQL_FIRST", "l", true, true, false, true, true, &Functions::First) },
   { "LAST",                        Function("LAST",                        "AQL_LAST", "l", true, true, false, true, true, &Functions::Last) },
   { "NTH",                         Function("NTH",                         "AQL_NTH", "l,n", true, true, false, true, true, &Functions::Nth) },
@@ -197,17 +197,23 @@ std::unordered_map<std::string, Function const> const Executor::FunctionNames{
   { "UNSET",                       Function("UNSET",                       "AQL_UNSET", "a,sl|+", true, true, false, true, true, &Functions::Unset) },
   { "UNSET_RECURSIVE",             Function("UNSET_RECURSIVE",             "AQL_UNSET_RECURSIVE", "a,sl|+", true, true, false, true, true, &Functions::UnsetRecursive) },
   { "KEEP",                        Function("KEEP",                        "AQL_KEEP", "a,sl|+", true, true, false, true, true, &Functions::Keep) },
-  { "TRANSLATE",                   Function("TRANSLATE",                   "AQL_TRANSLATE", ".,a|.", true, true, false, true, true) },
+  { "TRANSLATE",                   Function("TRANSLATE",                   "AQL_TRANSLATE", ".,a|.", true, true, false, true, true, &Functions::Translate) },
   { "ZIP",                         Function("ZIP",                         "AQL_ZIP", "l,l", true, true, false, true, true, &Functions::Zip) },
 
   // geo functions
   { "NEAR",                        Function("NEAR",                        "AQL_NEAR", "h,n,n|nz,s", true, false, true, false, true, &Functions::Near, NotInCluster) },
   { "WITHIN",                      Function("WITHIN",                      "AQL_WITHIN", "h,n,n,n|s", true, false, true, false, true, &Functions::Within, NotInCluster) },
-  { "WITHIN_RECTANGLE",            Function("WITHIN_RECTANGLE",            "AQL_WITHIN_RECTANGLE", "h,d,d,d,d", true, false, true, false, true) },
+  { "WITHIN_RECTANGLE",            Function("WITHIN_RECTANGLE",            "AQL_WITHIN_RECTANGLE", "h,d,d,d,d", true, false, true, false, true, &Functions::WithinRectangle, NotInCluster) },
+  { "WITHIN_POLYGON",              Function("WITHIN_POLYGON",              "AQL_WITHIN_POLYGON", "h,l", true, false, true, false, true, &Functions::WithinPolygon, NotInCluster) },
+  { "DISTANCE",                    Function("DISTANCE",                    "AQL_DISTANCE", "n,n,n,n", true, true, false, true, true, &Functions::Distance) },
   { "IS_IN_POLYGON",               Function("IS_IN_POLYGON",               "AQL_IS_IN_POLYGON", "l,ln|nb", true, true, false, true, true) },
 
+  // materialized views
+  { "MATERIALIZED_VIEW",           Function("MATERIALIZED_VIEW",           "AQL_MATERIALIZED_VIEW", "h,s", true, false, true, false, true, &Functions::MaterializedView, NotInCluster) },
+
   // fulltext functions
   { "FULLTEXT",                    Function("FULLTEXT",                    "AQL_FULLTEXT", "h,s,s|n", true, false, true, false, true) },
+  { "FULLTEXT_MATCH",              Function("FULLTEXT_MATCH",              "AQL_FULLTEXT_MATCH", ".,s", true, true, true, true, true, &Functions::FulltextMatch) },
 
   // graph functions
   { "PATHS",                       Function("PATHS",                       "AQL_PATHS", "c,h|s,ba", true, false, true, false, false) },
@@ -223,6 +229,7 @@ std::unordered_map<std::string, Function const> const Executor::FunctionNames{
   { "GRAPH_EDGES",                 Function("GRAPH_EDGES",                 "AQL_GRAPH_EDGES", "s,als|a", false, false, true, false, false) },
   { "GRAPH_VERTICES",              Function("GRAPH_VERTICES",              "AQL_GRAPH_VERTICES", "s,als|a", false, false, true, false, false) },
   { "NEIGHBORS",                   Function("NEIGHBORS",                   "AQL_NEIGHBORS", "h,h,s,s|l,a", true, false, true, false, false, &Functions::Neighbors, NotInCluster) },
+  { "TRAVERSE",                    Function("TRAVERSE",                    "AQL_TRAVERSE", "h,h,s,s|a", false, false, true, false, false, &Functions::Traverse, NotInCluster) },
   { "GRAPH_NEIGHBORS",             Function("GRAPH_NEIGHBORS",             "AQL_GRAPH_NEIGHBORS", "s,als|a", false, false, true, false, false) },
   { "GRAPH_COMMON_NEIGHBORS",      Function("GRAPH_COMMON_NEIGHBORS",      "AQL_GRAPH_COMMON_NEIGHBORS", "s,als,als|a,a", false, false, true, false, false) },
   { "GRAPH_COMMON_PROPERTIES",     Function("GRAPH_COMMON_PROPERTIES",     "AQL_GRAPH_COMMON_PROPERTIES", "s,als,als|a", false, false, true, false, false) },
@@ -236,7 +243,7 @@ std::unordered_map<std::string, Function const> const Executor::FunctionNames{
   { "GRAPH_RADIUS",                Function("GRAPH_RADIUS",                "AQL_GRAPH_RADIUS", "s|a", false, false, true, false, false) },
 
   // date functions
-  { "DATE_NOW",                    Function("DATE_NOW",                    "AQL_DATE_NOW", "", false, false, false, true, true) },
+  { "DATE_NOW",                    Function("DATE_NOW",                    "AQL_DATE_NOW", "", false, false, false, true, true, &Functions::DateNow) },
   { "DATE_TIMESTAMP",              Function("DATE_TIMESTAMP",              "AQL_DATE_TIMESTAMP", "ns|ns,ns,ns,ns,ns,ns", true, true, false, true, true) },
   { "DATE_ISO8601",                Function("DATE_ISO8601",                "AQL_DATE_ISO8601", "ns|ns,ns,ns,ns,ns,ns", true, true, false, true, true) },
   { "DATE_DAYOFWEEK",              Function("DATE_DAYOFWEEK",              "AQL_DATE_DAYOFWEEK", "ns", true, true, false, true, true) },
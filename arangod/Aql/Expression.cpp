@@ -132,7 +132,7 @@ Expression::Expression (Ast* ast,
 
 Expression::Expression (Ast* ast,
                         triagens::basics::Json const& json)
-  : Expression(ast, new AstNode(ast, json.get("expression"))) {
+  : Expression(ast, new (ast->query()->arena()) AstNode(ast, json.get("expression"))) {
 
 }
 
@@ -743,7 +743,7 @@ AqlValue Expression::executeSimpleExpressionIndexedAccess (AstNode const* node,
   }
   result.destroy();
     
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, &NullJson, Json::NOFREE));
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -971,7 +971,7 @@ AqlValue Expression::executeSimpleExpressionNot (AstNode const* node,
   
   bool const operandIsTrue = operand.isTrue();
   operand.destroy();
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, operandIsTrue ? &FalseJson : &TrueJson, Json::NOFREE));
+  return AqlValue::CreateBool(! operandIsTrue);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1038,7 +1038,7 @@ AqlValue Expression::executeSimpleExpressionComparison (AstNode const* node,
       left.destroy();
       right.destroy();
       // do not throw, but return "false" instead
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(false);
     }
  
     bool result = findInArray(left, right, leftCollection, rightCollection, trx, node); 
@@ -1064,17 +1064,17 @@ AqlValue Expression::executeSimpleExpressionComparison (AstNode const* node,
   right.destroy();
   switch (node->type) {
     case NODE_TYPE_OPERATOR_BINARY_EQ:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult == 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult == 0);
     case NODE_TYPE_OPERATOR_BINARY_NE:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult != 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult != 0);
     case NODE_TYPE_OPERATOR_BINARY_LT:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult < 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult < 0);
     case NODE_TYPE_OPERATOR_BINARY_LE:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult <= 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult <= 0);
     case NODE_TYPE_OPERATOR_BINARY_GT:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult > 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult > 0);
     case NODE_TYPE_OPERATOR_BINARY_GE:
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, (compareResult >= 0) ? &TrueJson : &FalseJson, Json::NOFREE));
+      return AqlValue::CreateBool(compareResult >= 0);
     default:
       std::string msg("unhandled type '");
       msg.append(node->getTypeString()); 
@@ -1318,7 +1318,7 @@ AqlValue Expression::executeSimpleExpressionArithmetic (AstNode const* node,
 
   if (lhs.isObject()) {
     lhs.destroy();
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   TRI_document_collection_t const* rightCollection = nullptr;
@@ -1327,7 +1327,7 @@ AqlValue Expression::executeSimpleExpressionArithmetic (AstNode const* node,
   if (rhs.isObject()) {
     lhs.destroy();
     rhs.destroy();
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   // TODO Optimize. Right now we always use double precission
@@ -1337,33 +1337,33 @@ AqlValue Expression::executeSimpleExpressionArithmetic (AstNode const* node,
 
   if (failed) {
     rhs.destroy();
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   double r = rhs.toNumber(failed);
   rhs.destroy();
 
   if (failed) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   switch (node->type) {
     case NODE_TYPE_OPERATOR_BINARY_PLUS:
-      return AqlValue(new Json(l + r));
+      return AqlValue::CreateNumber(l + r);
     case NODE_TYPE_OPERATOR_BINARY_MINUS:
-      return AqlValue(new Json(l - r));
+      return AqlValue::CreateNumber(l - r);
     case NODE_TYPE_OPERATOR_BINARY_TIMES:
-      return AqlValue(new Json(l * r));
+      return AqlValue::CreateNumber(l * r);
     case NODE_TYPE_OPERATOR_BINARY_DIV:
       if (r == 0) {
         RegisterWarning(_ast, "/", TRI_ERROR_QUERY_DIVISION_BY_ZERO);
-        return AqlValue(new Json(Json::Null));
+        return AqlValue::CreateNull();
       }
-      return AqlValue(new Json(l / r));
+      return AqlValue::CreateNumber(l / r);
     case NODE_TYPE_OPERATOR_BINARY_MOD:
-      return AqlValue(new Json(fmod(l, r)));
+      return AqlValue::CreateNumber(fmod(l, r));
     default:
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
   }
 }
 
@@ -51,6 +51,7 @@ namespace triagens {
     struct AqlValue;
     class Ast;
     class AttributeAccessor;
+    class CompiledExpression;
     class Executor;
     struct V8Expression;
 
@@ -60,6 +61,8 @@ namespace triagens {
 
     class Expression {
 
+      friend class CompiledExpression;
+
       enum ExpressionType : uint32_t {
         UNPROCESSED,
         JSON,
@@ -201,6 +204,17 @@ namespace triagens {
           return _type == V8;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether this is a simple expression
+////////////////////////////////////////////////////////////////////////////////
+
+        inline bool isSimple () {
+          if (_type == UNPROCESSED) {
+            analyzeExpression();
+          }
+          return _type == SIMPLE;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get expression type as string
 ////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include "Aql/Functions.h"
 #include "Aql/Function.h"
 #include "Aql/Query.h"
+#include "Aql/Traversal.h"
 #include "Basics/Exceptions.h"
 #include "Basics/fpconv.h"
 #include "Basics/JsonHelper.h"
@@ -37,9 +38,15 @@
 #include "Basics/ScopeGuard.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/Utf8Helper.h"
+#include "FulltextIndex/fulltext-index.h"
+#include "FulltextIndex/fulltext-query.h"
 #include "Indexes/Index.h"
+#include "Indexes/AggregateIndex.h"
+#include "Indexes/FulltextIndex.h"
+#include "Indexes/GeoCellIndex.h"
 #include "Indexes/GeoIndex2.h"
 #include "Rest/SslInterface.h"
+#include "Utils/DocumentCache.h"
 #include "V8Server/V8Traverser.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/VocShaper.h"
@@ -510,7 +517,7 @@ AqlValue Functions::IsNull (triagens::aql::Query*,
                             triagens::arango::AqlTransaction* trx,
                             FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isNull()));
+  return AqlValue::CreateBool(value.isNull());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -521,7 +528,7 @@ AqlValue Functions::IsBool (triagens::aql::Query*,
                             triagens::arango::AqlTransaction* trx,
                             FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isBoolean()));
+  return AqlValue::CreateBool(value.isBoolean());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -532,7 +539,7 @@ AqlValue Functions::IsNumber (triagens::aql::Query*,
                               triagens::arango::AqlTransaction* trx,
                               FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isNumber()));
+  return AqlValue::CreateBool(value.isNumber());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -543,7 +550,7 @@ AqlValue Functions::IsString (triagens::aql::Query*,
                               triagens::arango::AqlTransaction* trx,
                               FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isString()));
+  return AqlValue::CreateBool(value.isString());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -554,7 +561,7 @@ AqlValue Functions::IsArray (triagens::aql::Query*,
                              triagens::arango::AqlTransaction* trx,
                              FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isArray()));
+  return AqlValue::CreateBool(value.isArray());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -565,7 +572,7 @@ AqlValue Functions::IsObject (triagens::aql::Query*,
                               triagens::arango::AqlTransaction* trx,
                               FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
-  return AqlValue(new Json(value.isObject()));
+  return AqlValue::CreateBool(value.isObject());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -581,7 +588,7 @@ AqlValue Functions::ToNumber (triagens::aql::Query*,
   double v = ValueToNumber(value.json(), isValid);
 
   if (! isValid) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
   return AqlValue(new Json(v));
 }
@@ -615,7 +622,7 @@ AqlValue Functions::ToBool (triagens::aql::Query*,
                             FunctionParameters const& parameters) {
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  return AqlValue(new Json(ValueToBoolean(value.json())));
+  return AqlValue::CreateBool(ValueToBoolean(value.json()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -668,7 +675,7 @@ AqlValue Functions::Length (triagens::aql::Query*,
   if (! parameters.empty() &&
       parameters[0].first.isArray()) {
     // shortcut!
-    return AqlValue(new Json(static_cast<double>(parameters[0].first.arraySize())));
+    return AqlValue::CreateNumber(static_cast<double>(parameters[0].first.arraySize()));
   }
 
   auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
@@ -724,7 +731,7 @@ AqlValue Functions::Length (triagens::aql::Query*,
     }
   }
 
-  return AqlValue(new Json(static_cast<double>(length)));
+  return AqlValue::CreateNumber(static_cast<double>(length));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -743,11 +750,11 @@ AqlValue Functions::First (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "FIRST", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   if (value.size() == 0) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   auto j = new Json(TRI_UNKNOWN_MEM_ZONE, value.at(0).copy().steal(), Json::AUTOFREE);
@@ -770,13 +777,13 @@ AqlValue Functions::Last (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "LAST", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   size_t const n = value.size(); 
 
   if (n == 0) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   auto j = new Json(TRI_UNKNOWN_MEM_ZONE, value.at(n - 1).copy().steal(), Json::AUTOFREE);
@@ -799,13 +806,13 @@ AqlValue Functions::Nth (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "NTH", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   size_t const n = value.size(); 
 
   if (n == 0) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   Json indexJson = ExtractFunctionParameter(trx, parameters, 1, false);
@@ -813,13 +820,13 @@ AqlValue Functions::Nth (triagens::aql::Query* query,
   double numValue = ValueToNumber(indexJson.json(), isValid);
 
   if (! isValid || numValue < 0.0) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   size_t index = static_cast<size_t>(numValue);
 
   if (index >= n) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   auto j = new Json(TRI_UNKNOWN_MEM_ZONE, value.at(index).copy().steal(), Json::AUTOFREE);
@@ -927,7 +934,7 @@ AqlValue Functions::Like (triagens::aql::Query* query,
   if (matcher == nullptr) {
     // compiling regular expression failed
     RegisterWarning(query, "LIKE", TRI_ERROR_QUERY_INVALID_REGEX);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   // extract value
@@ -941,7 +948,7 @@ AqlValue Functions::Like (triagens::aql::Query* query,
   if (error) {
     // compiling regular expression failed
     RegisterWarning(query, "LIKE", TRI_ERROR_QUERY_INVALID_REGEX);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
         
   return AqlValue(new Json(result));
@@ -956,7 +963,7 @@ AqlValue Functions::Passthru (triagens::aql::Query*,
                               FunctionParameters const& parameters) {
 
   if (parameters.empty()) {
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   auto json = ExtractFunctionParameter(trx, parameters, 0, true);
@@ -974,7 +981,7 @@ AqlValue Functions::Unset (triagens::aql::Query* query,
 
   if (! value.isObject()) {
     RegisterInvalidArgumentWarning(query, "UNSET");
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   std::unordered_set<std::string> names;
@@ -1031,7 +1038,7 @@ AqlValue Functions::UnsetRecursive (triagens::aql::Query* query,
 
   if (! value.isObject()) {
     RegisterInvalidArgumentWarning(query, "UNSET_RECURSIVE");
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   std::unordered_set<std::string> names;
@@ -1099,7 +1106,7 @@ AqlValue Functions::Keep (triagens::aql::Query* query,
 
   if (! value.isObject()) {
     RegisterInvalidArgumentWarning(query, "KEEP");
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   std::unordered_set<std::string> names;
@@ -1171,7 +1178,7 @@ AqlValue Functions::Merge (triagens::aql::Query* query,
 
       if (! TRI_IsObjectJson(v)) {
         RegisterInvalidArgumentWarning(query, "MERGE");
-        return AqlValue(new Json(Json::Null));
+        return AqlValue::CreateNull();
       }
 
       auto merged = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, result.get(), v, false, false);
@@ -1190,7 +1197,7 @@ AqlValue Functions::Merge (triagens::aql::Query* query,
 
   if (! initial.isObject()) {
     RegisterInvalidArgumentWarning(query, "MERGE");
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   std::unique_ptr<TRI_json_t> result(initial.steal());
@@ -1201,7 +1208,7 @@ AqlValue Functions::Merge (triagens::aql::Query* query,
 
     if (! param.isObject()) {
       RegisterInvalidArgumentWarning(query, "MERGE");
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
     }
  
     auto merged = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, result.get(), param.json(), false, false);
@@ -1253,7 +1260,7 @@ AqlValue Functions::MergeRecursive (triagens::aql::Query* query,
 
       if (! TRI_IsObjectJson(v)) {
         RegisterInvalidArgumentWarning(query, "MERGE_RECURSIVE");
-        return AqlValue(new Json(Json::Null));
+        return AqlValue::CreateNull();
       }
 
       auto merged = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, result.get(), v, false, true);
@@ -1272,7 +1279,7 @@ AqlValue Functions::MergeRecursive (triagens::aql::Query* query,
 
   if (! initial.isObject()) {
     RegisterInvalidArgumentWarning(query, "MERGE_RECURSIVE");
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   std::unique_ptr<TRI_json_t> result(initial.steal());
@@ -1283,7 +1290,7 @@ AqlValue Functions::MergeRecursive (triagens::aql::Query* query,
 
     if (! param.isObject()) {
       RegisterInvalidArgumentWarning(query, "MERGE_RECURSIVE");
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
     }
  
     auto merged = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, result.get(), param.json(), false, true);
@@ -1311,14 +1318,14 @@ AqlValue Functions::Has (triagens::aql::Query* query,
 
   if (n < 2) {
     // no parameters
-    return AqlValue(new Json(false));
+    return AqlValue::CreateBool(false);
   }
     
   auto value = ExtractFunctionParameter(trx, parameters, 0, false);
 
   if (! value.isObject()) {
     // not an object
-    return AqlValue(new Json(false));
+    return AqlValue::CreateBool(false);
   }
  
   // process name parameter 
@@ -1336,7 +1343,7 @@ AqlValue Functions::Has (triagens::aql::Query* query,
   }
  
   bool const hasAttribute = (TRI_LookupObjectJson(value.json(), p) != nullptr);
-  return AqlValue(new Json(hasAttribute));
+  return AqlValue::CreateBool(hasAttribute);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1350,7 +1357,7 @@ AqlValue Functions::Attributes (triagens::aql::Query* query,
 
   if (n < 1) {
     // no parameters
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
     
   auto value = ExtractFunctionParameter(trx, parameters, 0, false);
@@ -1358,7 +1365,7 @@ AqlValue Functions::Attributes (triagens::aql::Query* query,
   if (! value.isObject()) {
     // not an object
     RegisterWarning(query, "ATTRIBUTES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   bool const removeInternal = GetBooleanParameter(trx, parameters, 1, false);
@@ -1426,7 +1433,7 @@ AqlValue Functions::Values (triagens::aql::Query* query,
 
   if (n < 1) {
     // no parameters
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
     
   auto value = ExtractFunctionParameter(trx, parameters, 0, false);
@@ -1434,7 +1441,7 @@ AqlValue Functions::Values (triagens::aql::Query* query,
   if (! value.isObject()) {
     // not an object
     RegisterWarning(query, "ATTRIBUTES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
  
   bool const removeInternal = GetBooleanParameter(trx, parameters, 1, false);
@@ -1485,7 +1492,7 @@ AqlValue Functions::Min (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "MIN", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   TRI_json_t const* valueJson = value.json();
@@ -1515,7 +1522,7 @@ AqlValue Functions::Min (triagens::aql::Query* query,
     }
   }
 
-  return AqlValue(new Json(Json::Null));
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1530,7 +1537,7 @@ AqlValue Functions::Max (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "MAX", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   TRI_json_t const* valueJson = value.json();
@@ -1560,7 +1567,7 @@ AqlValue Functions::Max (triagens::aql::Query* query,
     }
   }
 
-  return AqlValue(new Json(Json::Null));
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1575,7 +1582,7 @@ AqlValue Functions::Sum (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "SUM", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   TRI_json_t const* valueJson = value.json();
@@ -1591,7 +1598,7 @@ AqlValue Functions::Sum (triagens::aql::Query* query,
 
     if (! TRI_IsNumberJson(value)) {
       RegisterInvalidArgumentWarning(query, "SUM");
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
     }
 
     // got a numeric value
@@ -1606,7 +1613,7 @@ AqlValue Functions::Sum (triagens::aql::Query* query,
     return AqlValue(new Json(sum));
   } 
 
-  return AqlValue(new Json(Json::Null));
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1621,7 +1628,7 @@ AqlValue Functions::Average (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "AVERAGE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
 
   TRI_json_t const* valueJson = value.json();
@@ -1638,7 +1645,7 @@ AqlValue Functions::Average (triagens::aql::Query* query,
 
     if (! TRI_IsNumberJson(value)) {
       RegisterInvalidArgumentWarning(query, "AVERAGE");
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
     }
 
     // got a numeric value
@@ -1655,7 +1662,7 @@ AqlValue Functions::Average (triagens::aql::Query* query,
     return AqlValue(new Json(sum / static_cast<size_t>(count)));
   } 
 
-  return AqlValue(new Json(Json::Null));
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1730,7 +1737,7 @@ AqlValue Functions::Unique (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "UNIQUE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
   
   std::unordered_set<TRI_json_t const*, triagens::basics::JsonHash, triagens::basics::JsonEqual> values(
@@ -1785,7 +1792,7 @@ AqlValue Functions::SortedUnique (triagens::aql::Query* query,
   if (! value.isArray()) {
     // not an array
     RegisterWarning(query, "SORTED_UNIQUE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    return AqlValue::CreateNull();
   }
   
   std::set<TRI_json_t const*, triagens::basics::JsonLess<true>> values;
@@ -1841,7 +1848,7 @@ AqlValue Functions::Union (triagens::aql::Query* query,
     if (! value.isArray()) {
       // not an array
       RegisterInvalidArgumentWarning(query, "UNION");
-      return AqlValue(new Json(Json::Null));
+      return AqlValue::CreateNull();
     }
 
     TRI_json_t const* valueJson = value.json();
@@ -1915,7 +1922,7 @@ AqlValue Functions::UnionDistinct (triagens::aql::Query* query,
         // not an array
         freeValues();
         RegisterInvalidArgumentWarning(query, "UNION_DISTINCT");
-        return AqlValue(new Json(Json::Null));
+        return AqlValue::CreateNull();
       }
 
       TRI_json_t const* valueJson = value.json();
@@ -2006,7 +2013,7 @@ AqlValue Functions::Intersection (triagens::aql::Query* query,
         // not an array
         freeValues();
         RegisterWarning(query, "INTERSECTION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-        return AqlValue(new Json(Json::Null));
+        return AqlValue::CreateNull();
       }
 
       TRI_json_t const* valueJson = value.json();
@@ -2453,6 +2460,41 @@ AqlValue Functions::Neighbors (triagens::aql::Query* query,
   return VertexIdsToAqlValue(trx, resolver, neighbors, includeData);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function TRAVERSE
+/// the paths are collected in an array here. FOR loops over TRAVERSE are
+/// turned into a TraversalNode by the optimizer, which produces the paths
+/// in batches instead
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Traverse (triagens::aql::Query* query,
+                              triagens::arango::AqlTransaction* trx,
+                              FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n < 4 || n > 5) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "TRAVERSE", (int) 4, (int) 5);
+  }
+
+  Traversal traversal(trx,
+                      ExtractFunctionParameter(trx, parameters, 0, false),
+                      ExtractFunctionParameter(trx, parameters, 1, false),
+                      ExtractFunctionParameter(trx, parameters, 2, false),
+                      ExtractFunctionParameter(trx, parameters, 3, false),
+                      ExtractFunctionParameter(trx, parameters, 4, false));
+
+  std::unique_ptr<Json> result(new Json(Json::Array));
+
+  while (traversal.next()) {
+    result->add(traversal.current());
+  }
+
+  AqlValue v(result.get());
+  result.release();
+
+  return v;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief function NEAR
 ////////////////////////////////////////////////////////////////////////////////
@@ -2805,472 +2847,924 @@ AqlValue Functions::Within (triagens::aql::Query* query,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief internal recursive flatten helper
+/// @brief adds the collection of a geo function to the transaction
 ////////////////////////////////////////////////////////////////////////////////
 
-static void FlattenList (Json array, size_t maxDepth, size_t curDepth, Json& result) {
-  size_t elementCount = array.size();
-  for (size_t i = 0; i < elementCount; ++i) {
-    Json tmp = array.at(i);
-    if (tmp.isArray() && curDepth < maxDepth) {
-      FlattenList(tmp, maxDepth, curDepth + 1, result);
+static TRI_transaction_collection_t* GeoCollection (triagens::arango::AqlTransaction* trx,
+                                                    TRI_voc_cid_t cid,
+                                                    std::string const& colName) {
+  auto collection = trx->trxCollection(cid);
+
+  // ensure the collection is loaded
+  if (collection == nullptr) {
+    int res = TRI_AddCollectionTransaction(trx->getInternals(), 
+                                           cid,
+                                           TRI_TRANSACTION_READ,
+                                           trx->nestingLevel(),
+                                           true,
+                                           true);
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION_FORMAT(res, "'%s'", colName.c_str());
     }
-    else {
-      // Transfer the content of tmp into the result
-      result.transfer(tmp.json());
+
+    TRI_EnsureCollectionsTransaction(trx->getInternals());
+    collection = trx->trxCollection(cid);
+
+    if (collection == nullptr) {
+      THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
+                                    "'%s'",
+                                    colName.c_str());
     }
   }
+
+  if (trx->documentCollection(cid) == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND);
+  }
+
+  return collection;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function FLATTEN
+/// @brief finds the first index of a type in a collection
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Flatten (triagens::aql::Query* query,
-                             triagens::arango::AqlTransaction* trx,
-                             FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n == 0 || n > 2) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "FLATTEN", (int) 1, (int) 2);
-  }
-
-  Json listJson  = ExtractFunctionParameter(trx, parameters, 0, false);
-  if (! listJson.isArray()) {
-    RegisterWarning(query, "FLATTEN", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
-  }
-
-  size_t maxDepth = 1;
-  if (n == 2) {
-    Json maxDepthJson = ExtractFunctionParameter(trx, parameters, 1, false);
-    bool isValid = true;
-    double tmpMaxDepth = ValueToNumber(maxDepthJson.json(), isValid);
-    if (! isValid || tmpMaxDepth < 1) {
-      maxDepth = 1;
-    }
-    else {
-      maxDepth = static_cast<size_t>(tmpMaxDepth);
+static triagens::arango::Index* GeoIndexOfType (TRI_document_collection_t* document,
+                                                triagens::arango::Index::IndexType type) {
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == type) {
+      return idx;
     }
   }
 
-  Json result(Json::Array);
-  FlattenList(listJson.copy(), maxDepth, 0, result);
-
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  return nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function ZIP
+/// @brief builds the result of a geo function from the documents found
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Zip (triagens::aql::Query* query,
-                         triagens::arango::AqlTransaction* trx,
-                         FunctionParameters const& parameters) {
-  if (parameters.size() != 2) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ZIP", (int) 2, (int) 2);
-  }
+static AqlValue GeoDocumentsResult (triagens::arango::AqlTransaction* trx,
+                                    TRI_transaction_collection_t* collection,
+                                    TRI_voc_cid_t cid,
+                                    std::vector<TRI_doc_mptr_t const*> const& documents) {
+  auto shaper = collection->_collection->_collection->getShaper();
+  Json array(Json::Array, documents.size());
 
-  Json keysJson  = ExtractFunctionParameter(trx, parameters, 0, false);
-  Json valuesJson  = ExtractFunctionParameter(trx, parameters, 1, false);
-  if (! keysJson.isArray() ||
-      ! valuesJson.isArray() ||
-      keysJson.size() != valuesJson.size()) {
-    RegisterWarning(query, "ZIP", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
+  for (auto const& it : documents) {
+    array.add(ExpandShapedJson(shaper, trx->resolver(), cid, it));
   }
-  size_t const n = keysJson.size();
-
-  Json result(Json::Object, n);
 
-  // Buffer will temporarily hold the keys
-  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
-  for (size_t i = 0; i < n; ++i) {
-    buffer.reset();
-    AppendAsString(buffer, keysJson.at(i).json());
-    result.set(buffer.c_str(), valuesJson.at(i).copy().steal());
-  }
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, array.steal()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function PARSE_IDENTIFIER
+/// @brief function WITHIN_RECTANGLE
+///
+/// uses a geo cell index if there is one. otherwise the circle around the
+/// rectangle is looked up in a geo index and the points outside of the
+/// rectangle are dropped
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::ParseIdentifier (triagens::aql::Query* query,
+AqlValue Functions::WithinRectangle (triagens::aql::Query* query,
                                      triagens::arango::AqlTransaction* trx,
                                      FunctionParameters const& parameters) {
-  if (parameters.size() != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PARSE_IDENTIFIER", (int) 1, (int) 1);
+  if (parameters.size() != 5) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "WITHIN_RECTANGLE", (int) 5, (int) 5);
   }
 
-  Json value = ExtractFunctionParameter(trx, parameters, 0, false);
-  if (value.isObject() && value.has("_id")) {
-    value = value.get("_id");
-  }
-  if (value.isString()) {
-    std::string identifier = triagens::basics::JsonHelper::getStringValue(value.json(), "");
-    std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
-    if (parts.size() == 2) {
-      Json result(Json::Object, 2);
-      result.set("collection", Json(parts[0]));
-      result.set("key", Json(parts[1]));
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
-    }
-   
+  Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (! collectionJson.isString()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "WITHIN_RECTANGLE");
   }
 
-  RegisterWarning(query, "PARSE_IDENTIFIER", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-  return AqlValue(new Json(Json::Null));
-}
+  std::string colName = basics::JsonHelper::getStringValue(collectionJson.json(), "");
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief function Minus
-////////////////////////////////////////////////////////////////////////////////
+  double coordinates[4];
 
-AqlValue Functions::Minus (triagens::aql::Query* query,
-                           triagens::arango::AqlTransaction* trx,
-                           FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
+  for (size_t i = 0; i < 4; ++i) {
+    Json value = ExtractFunctionParameter(trx, parameters, i + 1, false);
 
-  if (n < 2) {
-    // The max number is arbitrary
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "MINUS", (int) 2, (int) 99999);
+    if (! value.isNumber()) {
+      THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "WITHIN_RECTANGLE");
+    }
+
+    coordinates[i] = value.json()->_value._number;
   }
 
-  Json baseArray = ExtractFunctionParameter(trx, parameters, 0, false);
-  std::unordered_map<std::string, size_t> contains;
-  contains.reserve(n);
+  TRI_voc_cid_t cid = trx->resolver()->getCollectionId(colName);
+  auto collection = GeoCollection(trx, cid, colName);
+  auto document = trx->documentCollection(cid);
 
-  if (! baseArray.isArray()) {
-    RegisterWarning(query, "MINUS", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
-  }
+  auto cellIndex = GeoIndexOfType(document, triagens::arango::Index::TRI_IDX_TYPE_GEO_CELL_INDEX);
+  triagens::arango::Index* index = nullptr;
 
-  // Fill the original map
-  for (size_t i = 0; i < baseArray.size(); ++i) {
-    contains.emplace(baseArray.at(i).toString(), i);
-  }
+  if (cellIndex == nullptr) {
+    index = GeoIndexOfType(document, triagens::arango::Index::TRI_IDX_TYPE_GEO1_INDEX);
 
-  // Iterate through all following parameters and delete found elements from the map
-  for (size_t k = 1; k < n; ++k) {
-    Json nextArray = ExtractFunctionParameter(trx, parameters, k, false);
-    if (! nextArray.isArray()) {
-      RegisterWarning(query, "MINUS", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-      return AqlValue(new Json(Json::Null));
+    if (index == nullptr) {
+      index = GeoIndexOfType(document, triagens::arango::Index::TRI_IDX_TYPE_GEO2_INDEX);
     }
 
-    for (size_t j = 0; j < nextArray.size(); ++j) {
-      std::string search = nextArray.at(j).toString();
-      auto find = contains.find(search);
-      if (find != contains.end()) {
-        contains.erase(find);
-      }
+    if (index == nullptr) {
+      THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_GEO_INDEX_MISSING, colName.c_str());
     }
   }
 
-  // We ommit the normalize part from js, cannot occur here
-  Json result(Json::Array, contains.size());
-  for (auto& it : contains) {
-    result.transfer(baseArray.at(it.second).json());
+  if (trx->orderDitch(collection) == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
 
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
-}
+  std::vector<TRI_doc_mptr_t const*> documents;
 
-static void RegisterCollectionInTransaction (triagens::arango::AqlTransaction* trx,
-                                             std::string const& collectionName,
-                                             TRI_voc_cid_t& cid,
-                                             TRI_transaction_collection_t*& collection) {
-  TRI_ASSERT(collection == nullptr);
-  cid = trx->resolver()->getCollectionId(collectionName);
-  if (cid == 0) {
-    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
-                                  "'%s'",
-                                  collectionName.c_str());
+  if (cellIndex != nullptr) {
+    static_cast<triagens::arango::GeoCellIndex*>(cellIndex)->withinRectangle(
+      coordinates[0], coordinates[1], coordinates[2], coordinates[3], documents
+    );
+
+    return GeoDocumentsResult(trx, collection, cid, documents);
   }
-  // ensure the collection is loaded
-  collection = trx->trxCollection(cid);
 
-  if (collection == nullptr) {
-    int res = TRI_AddCollectionTransaction(trx->getInternals(), 
-                                           cid,
-                                           TRI_TRANSACTION_READ,
-                                           trx->nestingLevel(),
-                                           true,
-                                           true);
-    if (res != TRI_ERROR_NO_ERROR) {
-      THROW_ARANGO_EXCEPTION_FORMAT(res, "'%s'", collectionName.c_str());
+  double const minLatitude  = (std::min)(coordinates[0], coordinates[2]);
+  double const maxLatitude  = (std::max)(coordinates[0], coordinates[2]);
+  double const minLongitude = (std::min)(coordinates[1], coordinates[3]);
+  double const maxLongitude = (std::max)(coordinates[1], coordinates[3]);
+
+  // the circle around the rectangle. the boundary is sampled because the
+  // point farthest from the center is not always a corner on the sphere
+  GeoCoordinate center;
+  center.latitude = (minLatitude + maxLatitude) / 2.0;
+  center.longitude = (minLongitude + maxLongitude) / 2.0;
+  center.data = nullptr;
+
+  double radius = 0.0;
+  int const samples = 8;
+
+  for (int i = 0; i <= samples; ++i) {
+    double const fraction = static_cast<double>(i) / samples;
+    double const latitude = minLatitude + (maxLatitude - minLatitude) * fraction;
+    double const longitude = minLongitude + (maxLongitude - minLongitude) * fraction;
+
+    GeoCoordinate boundary[4] = {
+      { latitude, minLongitude, nullptr },
+      { latitude, maxLongitude, nullptr },
+      { minLatitude, longitude, nullptr },
+      { maxLatitude, longitude, nullptr }
+    };
+
+    for (auto& it : boundary) {
+      radius = (std::max)(radius, GeoIndex_distance(&center, &it));
     }
-    TRI_EnsureCollectionsTransaction(trx->getInternals());
-    collection = trx->trxCollection(cid);
+  }
 
-    if (collection == nullptr) {
-      // This case should never occur
-      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "could not load collection");
+  // a little slack for the sampling and rounding
+  radius = radius * 1.01 + 1.0;
+
+  GeoCoordinates* cors = static_cast<triagens::arango::GeoIndex2*>(index)->withinQuery(
+    center.latitude,
+    center.longitude,
+    radius
+  );
+
+  if (cors != nullptr) {
+    try {
+      for (size_t i = 0; i < cors->length; ++i) {
+        GeoCoordinate const& it = cors->coordinates[i];
+
+        if (it.latitude >= minLatitude && it.latitude <= maxLatitude &&
+            it.longitude >= minLongitude && it.longitude <= maxLongitude) {
+          documents.emplace_back(static_cast<TRI_doc_mptr_t const*>(it.data));
+        }
+      }
     }
+    catch (...) {
+      GeoIndex_CoordinatesFree(cors);
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    GeoIndex_CoordinatesFree(cors);
   }
-  TRI_ASSERT(collection != nullptr);
+
+  return GeoDocumentsResult(trx, collection, cid, documents);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Helper function to get a document by it's identifier
-///        The collection has to be locked by the transaction before
+/// @brief function WITHIN_POLYGON
+///
+/// the polygon is a list of [ latitude, longitude ] pairs. this requires a
+/// geo cell index
 ////////////////////////////////////////////////////////////////////////////////
 
-static Json getDocumentByIdentifier (triagens::arango::AqlTransaction* trx,
-                                     CollectionNameResolver const* resolver,
-                                     TRI_transaction_collection_t* collection,
-                                     TRI_voc_cid_t const& cid,
-                                     std::string const& collectionName,
-                                     std::string const& identifier) {
-  std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
-  TRI_doc_mptr_copy_t mptr;
-  if (parts.size() == 1) {
-    int res = trx->readSingle(collection, &mptr, parts[0]);
-    if (res != TRI_ERROR_NO_ERROR) {
-      return Json(Json::Null);
-    }
+AqlValue Functions::WithinPolygon (triagens::aql::Query* query,
+                                   triagens::arango::AqlTransaction* trx,
+                                   FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "WITHIN_POLYGON", (int) 2, (int) 2);
   }
-  else if (parts.size() == 2) {
-    if (parts[0] != collectionName) {
-      // Reqesting an _id that cannot be stored in this collection
-      return Json(Json::Null);
-    }
-    int res = trx->readSingle(collection, &mptr, parts[1]);
-    if (res != TRI_ERROR_NO_ERROR) {
-      return Json(Json::Null);
+
+  Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json polygonJson = ExtractFunctionParameter(trx, parameters, 1, false);
+
+  if (! collectionJson.isString() || ! polygonJson.isArray()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "WITHIN_POLYGON");
+  }
+
+  std::string colName = basics::JsonHelper::getStringValue(collectionJson.json(), "");
+
+  std::vector<std::pair<double, double>> polygon;
+  size_t const n = polygonJson.size();
+  polygon.reserve(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    Json point = polygonJson.at(i);
+
+    if (! point.isArray() || point.size() != 2 ||
+        ! point.at(0).isNumber() || ! point.at(1).isNumber()) {
+      THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "WITHIN_POLYGON");
     }
+
+    polygon.emplace_back(point.at(0).json()->_value._number, point.at(1).json()->_value._number);
   }
-  else {
-    return Json(Json::Null);
+
+  TRI_voc_cid_t cid = trx->resolver()->getCollectionId(colName);
+  auto collection = GeoCollection(trx, cid, colName);
+  auto document = trx->documentCollection(cid);
+
+  auto index = GeoIndexOfType(document, triagens::arango::Index::TRI_IDX_TYPE_GEO_CELL_INDEX);
+
+  if (index == nullptr) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_GEO_INDEX_MISSING, colName.c_str());
   }
 
-  return ExpandShapedJson(
-    collection->_collection->_collection->getShaper(),
-    resolver,
-    cid,
-    &mptr
-  );
+  if (trx->orderDitch(collection) == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  std::vector<TRI_doc_mptr_t const*> documents;
+  static_cast<triagens::arango::GeoCellIndex*>(index)->withinPolygon(polygon, documents);
+
+  return GeoDocumentsResult(trx, collection, cid, documents);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Helper function to get a document by it's _id
-///        This function will lazy read-lock the collection.
+/// @brief function DISTANCE
+///
+/// returns the distance in meters between two points given as latitude and
+/// longitude, or null if any of the values is not a number. the distance is
+/// computed as in the geo index, so that sorting by it matches the order in
+/// which the index returns the nearest documents
 ////////////////////////////////////////////////////////////////////////////////
 
-static Json getDocumentByIdentifier (triagens::arango::AqlTransaction* trx,
-                                     CollectionNameResolver const* resolver,
-                                     std::string& identifier) {
-  std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
-  if (parts.size() != 2) {
-    return Json(Json::Null);
+AqlValue Functions::Distance (triagens::aql::Query* query,
+                              triagens::arango::AqlTransaction* trx,
+                              FunctionParameters const& parameters) {
+  if (parameters.size() != 4) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "DISTANCE", (int) 4, (int) 4);
   }
-  std::string collectionName = parts[0];
-  TRI_transaction_collection_t* collection = nullptr;
-  TRI_voc_cid_t cid = 0;
-  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
 
-  TRI_doc_mptr_copy_t mptr;
-  int res = trx->readSingle(collection, &mptr, parts[1]);
-  if (res != TRI_ERROR_NO_ERROR) {
-    return Json(Json::Null);
+  double values[4];
+
+  for (size_t i = 0; i < 4; ++i) {
+    Json value = ExtractFunctionParameter(trx, parameters, i, false);
+
+    if (! value.isNumber()) {
+      return AqlValue(new Json(Json::Null));
+    }
+
+    values[i] = value.json()->_value._number;
   }
 
-  return ExpandShapedJson(
-    collection->_collection->_collection->getShaper(),
-    resolver,
-    cid,
-    &mptr
-  );
-};
- 
+  GeoCoordinate first;
+  first.latitude = values[0];
+  first.longitude = values[1];
+  first.data = nullptr;
+
+  GeoCoordinate second;
+  second.latitude = values[2];
+  second.longitude = values[3];
+  second.data = nullptr;
+
+  return AqlValue(new Json(GeoIndex_distance(&first, &second)));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function Document
+/// @brief adds the words of the string values of a value to a list of words,
+/// taking the same values into account as a fulltext index: a string, the
+/// string values of an object, and the strings and the string values of the
+/// objects in an array
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Document (triagens::aql::Query* query,
-                              triagens::arango::AqlTransaction* trx,
-                              FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-
-  if (n < 1 || 2 < n) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "DOCUMENT", (int) 1, (int) 2);
+static bool AppendFulltextWords (TRI_vector_string_t*& words,
+                                 TRI_json_t const* json,
+                                 bool isMember) {
+  if (TRI_IsStringJson(json)) {
+    return TRI_get_words(words, json->_value._string.data, json->_value._string.length - 1,
+                         TRI_FULLTEXT_MIN_WORD_LENGTH_DEFAULT, TRI_FULLTEXT_MAX_WORD_LENGTH, true);
   }
 
-  auto resolver = trx->resolver();
+  if (TRI_IsObjectJson(json)) {
+    size_t const n = TRI_LengthVector(&json->_value._objects);
 
-   if (n == 1) {
-    Json id = ExtractFunctionParameter(trx, parameters, 0, false);
+    for (size_t i = 1; i < n; i += 2) {
+      auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
 
-   if (id.isString()) {
-      std::string identifier = triagens::basics::JsonHelper::getStringValue(id.json(), "");
-      Json result = getDocumentByIdentifier(trx, resolver, identifier);
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+      if (TRI_IsStringJson(value) && ! AppendFulltextWords(words, value, true)) {
+        return false;
+      }
     }
-    else if (id.isArray()) {
-      size_t const n = id.size();
-      Json result(Json::Array, n);
-      for (size_t i = 0; i < n; ++i) {
-        Json next = id.at(i);
-        try {
-          if (next.isString()) {
-            std::string identifier = triagens::basics::JsonHelper::getStringValue(next.json(), "");
-            Json tmp = getDocumentByIdentifier(trx, resolver, identifier);
-            if (! tmp.isNull()) {
-              result.add(tmp);
-            }
-          }
-        }
-        catch (triagens::basics::Exception const&) {
-          // Ignore all ArangoDB exceptions here
-        }
+  }
+  else if (TRI_IsArrayJson(json) && ! isMember) {
+    size_t const n = TRI_LengthArrayJson(json);
+
+    for (size_t i = 0; i < n; ++i) {
+      if (! AppendFulltextWords(words, TRI_LookupArrayJson(json, i), true)) {
+        return false;
       }
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
     }
-    return AqlValue(new Json(Json::Null));
   }
 
-  Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
-  if (! collectionJson.isString()) {
-    THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function FULLTEXT_MATCH
+///
+/// returns whether a value matches a fulltext query, with the query syntax
+/// of FULLTEXT(). words shorter than the default minimum word length of
+/// fulltext indexes are ignored. if the value is an attribute covered by a
+/// fulltext index, the optimizer reads the matching documents from the
+/// index instead of calling the function
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::FulltextMatch (triagens::aql::Query* query,
+                                   triagens::arango::AqlTransaction* trx,
+                                   FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "FULLTEXT_MATCH", (int) 2, (int) 2);
   }
-  std::string collectionName = triagens::basics::JsonHelper::getStringValue(collectionJson.json(), "");
 
-  TRI_transaction_collection_t* collection = nullptr;
-  TRI_voc_cid_t cid;
-  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
+  Json queryJson = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  Json id = ExtractFunctionParameter(trx, parameters, 1, false);
-  if (id.isString()) {
-    std::string identifier = triagens::basics::JsonHelper::getStringValue(id.json(), "");
-    Json result = getDocumentByIdentifier(trx, resolver, collection, cid, collectionName, identifier);
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  if (! queryJson.isString()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "FULLTEXT_MATCH");
   }
-  else if (id.isArray()) {
-    size_t const n = id.size();
-    Json result(Json::Array, n);
-    for (size_t i = 0; i < n; ++i) {
-      Json next = id.at(i);
-      try {
-        if (next.isString()) {
-          std::string identifier = triagens::basics::JsonHelper::getStringValue(next.json(), "");
-          Json tmp = getDocumentByIdentifier(trx, resolver, collection, cid, collectionName, identifier);
-          if (! tmp.isNull()) {
-            result.add(tmp);
-          }
-        }
-      }
-      catch (triagens::basics::Exception const&) {
-        // Ignore all ArangoDB exceptions here
+
+  TRI_fulltext_query_t* fulltextQuery = triagens::arango::FulltextIndex::ParseQuery(triagens::basics::JsonHelper::getStringValue(queryJson.json(), ""));
+  TRI_vector_string_t* words = nullptr;
+
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&fulltextQuery, &words]() -> void {
+      TRI_FreeQueryFulltextIndex(fulltextQuery);
+
+      if (words != nullptr) {
+        TRI_FreeVectorString(TRI_UNKNOWN_MEM_ZONE, words);
       }
     }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  };
+
+  Json value = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (! AppendFulltextWords(words, value.json(), false)) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
-  // Id has invalid format
-  return AqlValue(new Json(Json::Null));
+
+  return AqlValue(new Json(TRI_MatchQueryFulltextIndex(fulltextQuery, words)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function Edges
+/// @brief function MATERIALIZED_VIEW
+///
+/// returns the groups of the aggregate index with the given name, which are
+/// maintained with every write, so no documents are read
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Edges (triagens::aql::Query* query,
-                           triagens::arango::AqlTransaction* trx,
-                           FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-
-  if (n < 3 || 5 < n) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "EDGES", (int) 3, (int) 5);
+AqlValue Functions::MaterializedView (triagens::aql::Query* query,
+                                      triagens::arango::AqlTransaction* trx,
+                                      FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "MATERIALIZED_VIEW", (int) 2, (int) 2);
   }
 
   Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
-  if (! collectionJson.isString()) {
-    THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
-  }
-  std::string collectionName = triagens::basics::JsonHelper::getStringValue(collectionJson.json(), "");
+  Json nameJson = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  TRI_transaction_collection_t* collection = nullptr;
-  TRI_voc_cid_t cid;
-  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
-  if (collection->_collection->_type != TRI_COL_TYPE_EDGE) {
-    RegisterWarning(query, "EDGES", TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID);
-    return AqlValue(new Json(Json::Null));
+  if (! collectionJson.isString() || ! nameJson.isString()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "MATERIALIZED_VIEW");
   }
 
-  Json vertexJson = ExtractFunctionParameter(trx, parameters, 1, false);
-  if (! vertexJson.isString()) {
-    // Invalid Start vertex
-    return AqlValue(new Json(Json::Null));
-  }
+  std::string colName = basics::JsonHelper::getStringValue(collectionJson.json(), "");
+  std::string name = basics::JsonHelper::getStringValue(nameJson.json(), "");
 
-  std::string vertexId = basics::JsonHelper::getStringValue(vertexJson.json(), "");
-  std::vector<std::string> parts = triagens::basics::StringUtils::split(vertexId, "/");
-  if (parts.size() != 2) {
-    // Invalid Start vertex
-    return AqlValue(new Json(Json::Null));
-  }
+  TRI_voc_cid_t cid = trx->resolver()->getCollectionId(colName);
+  GeoCollection(trx, cid, colName);
+  auto document = trx->documentCollection(cid);
 
+  auto index = TRI_LookupAggregateIndexDocumentCollection(document, name);
 
-  Json directionJson = ExtractFunctionParameter(trx, parameters, 2, false);
-  if (! directionJson.isString()) {
-    RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
+  if (index == nullptr) {
+    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_INDEX_NOT_FOUND, "materialized view '%s'", name.c_str());
   }
-  std::string dirString = basics::JsonHelper::getStringValue(directionJson.json(), "");
-  // transform String to lower case
-  std::transform(dirString.begin(), dirString.end(), dirString.begin(), ::tolower);
 
-  TRI_edge_direction_e direction;
+  Json groups = static_cast<triagens::arango::AggregateIndex*>(index)->groups(TRI_UNKNOWN_MEM_ZONE);
 
-  if (dirString == "inbound") {
-    direction = TRI_EDGE_IN;
-  }
-  else if (dirString == "outbound") {
-    direction = TRI_EDGE_OUT;
-  }
-  else if (dirString == "any") {
-    direction = TRI_EDGE_ANY;
-  }
-  else {
-    RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
-  }
-  auto resolver = trx->resolver();
-  
-  TRI_voc_cid_t startCid = resolver->getCollectionId(parts[0]);
-  if (startCid == 0) {
-    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
-                                  "'%s'",
-                                  parts[0].c_str());
-  }
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, groups.steal()));
+}
 
-  char* key = const_cast<char*>(parts[1].c_str());
-  std::vector<TRI_doc_mptr_copy_t> edges = TRI_LookupEdgesDocumentCollection(
-    collection->_collection->_collection,
-    direction,
-    startCid,
-    key
-  );
+////////////////////////////////////////////////////////////////////////////////
+/// @brief internal recursive flatten helper
+////////////////////////////////////////////////////////////////////////////////
 
-  size_t resultCount = edges.size();
+static void FlattenList (Json array, size_t maxDepth, size_t curDepth, Json& result) {
+  size_t elementCount = array.size();
+  for (size_t i = 0; i < elementCount; ++i) {
+    Json tmp = array.at(i);
+    if (tmp.isArray() && curDepth < maxDepth) {
+      FlattenList(tmp, maxDepth, curDepth + 1, result);
+    }
+    else {
+      // Transfer the content of tmp into the result
+      result.transfer(tmp.json());
+    }
+  }
+}
 
-  auto shaper = collection->_collection->_collection->getShaper();
-  if (n > 3) {
-    // We might have examples
-    Json exampleJson = ExtractFunctionParameter(trx, parameters, 3, false);
-    if (! exampleJson.isNull()) {
-      bool buildMatcher = false;
-      if (exampleJson.isArray()) {
-        size_t exampleCount = exampleJson.size();
-        // We only support objects here so validate
-        for (size_t k = 0; k < exampleCount; /* nothing */) {
-          if (exampleJson.at(k).isObject()) {
-            ++k;
-            continue;
-          }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function FLATTEN
+////////////////////////////////////////////////////////////////////////////////
 
-          RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+AqlValue Functions::Flatten (triagens::aql::Query* query,
+                             triagens::arango::AqlTransaction* trx,
+                             FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n == 0 || n > 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "FLATTEN", (int) 1, (int) 2);
+  }
+
+  Json listJson  = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (! listJson.isArray()) {
+    RegisterWarning(query, "FLATTEN", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
+  }
+
+  size_t maxDepth = 1;
+  if (n == 2) {
+    Json maxDepthJson = ExtractFunctionParameter(trx, parameters, 1, false);
+    bool isValid = true;
+    double tmpMaxDepth = ValueToNumber(maxDepthJson.json(), isValid);
+    if (! isValid || tmpMaxDepth < 1) {
+      maxDepth = 1;
+    }
+    else {
+      maxDepth = static_cast<size_t>(tmpMaxDepth);
+    }
+  }
+
+  Json result(Json::Array);
+  FlattenList(listJson.copy(), maxDepth, 0, result);
+
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function ZIP
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Zip (triagens::aql::Query* query,
+                         triagens::arango::AqlTransaction* trx,
+                         FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ZIP", (int) 2, (int) 2);
+  }
+
+  Json keysJson  = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json valuesJson  = ExtractFunctionParameter(trx, parameters, 1, false);
+  if (! keysJson.isArray() ||
+      ! valuesJson.isArray() ||
+      keysJson.size() != valuesJson.size()) {
+    RegisterWarning(query, "ZIP", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+  size_t const n = keysJson.size();
+
+  Json result(Json::Object, n);
+
+  // Buffer will temporarily hold the keys
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
+  for (size_t i = 0; i < n; ++i) {
+    buffer.reset();
+    AppendAsString(buffer, keysJson.at(i).json());
+    result.set(buffer.c_str(), valuesJson.at(i).copy().steal());
+  }
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function PARSE_IDENTIFIER
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::ParseIdentifier (triagens::aql::Query* query,
+                                     triagens::arango::AqlTransaction* trx,
+                                     FunctionParameters const& parameters) {
+  if (parameters.size() != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PARSE_IDENTIFIER", (int) 1, (int) 1);
+  }
+
+  Json value = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (value.isObject() && value.has("_id")) {
+    value = value.get("_id");
+  }
+  if (value.isString()) {
+    std::string identifier = triagens::basics::JsonHelper::getStringValue(value.json(), "");
+    std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
+    if (parts.size() == 2) {
+      Json result(Json::Object, 2);
+      result.set("collection", Json(parts[0]));
+      result.set("key", Json(parts[1]));
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+    }
+   
+  }
+
+  RegisterWarning(query, "PARSE_IDENTIFIER", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+  return AqlValue::CreateNull();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function Minus
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Minus (triagens::aql::Query* query,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n < 2) {
+    // The max number is arbitrary
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "MINUS", (int) 2, (int) 99999);
+  }
+
+  Json baseArray = ExtractFunctionParameter(trx, parameters, 0, false);
+  std::unordered_map<std::string, size_t> contains;
+  contains.reserve(n);
+
+  if (! baseArray.isArray()) {
+    RegisterWarning(query, "MINUS", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+
+  // Fill the original map
+  for (size_t i = 0; i < baseArray.size(); ++i) {
+    contains.emplace(baseArray.at(i).toString(), i);
+  }
+
+  // Iterate through all following parameters and delete found elements from the map
+  for (size_t k = 1; k < n; ++k) {
+    Json nextArray = ExtractFunctionParameter(trx, parameters, k, false);
+    if (! nextArray.isArray()) {
+      RegisterWarning(query, "MINUS", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+      return AqlValue::CreateNull();
+    }
+
+    for (size_t j = 0; j < nextArray.size(); ++j) {
+      std::string search = nextArray.at(j).toString();
+      auto find = contains.find(search);
+      if (find != contains.end()) {
+        contains.erase(find);
+      }
+    }
+  }
+
+  // We ommit the normalize part from js, cannot occur here
+  Json result(Json::Array, contains.size());
+  for (auto& it : contains) {
+    result.transfer(baseArray.at(it.second).json());
+  }
+
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+}
+
+static void RegisterCollectionInTransaction (triagens::arango::AqlTransaction* trx,
+                                             std::string const& collectionName,
+                                             TRI_voc_cid_t& cid,
+                                             TRI_transaction_collection_t*& collection) {
+  TRI_ASSERT(collection == nullptr);
+  cid = trx->resolver()->getCollectionId(collectionName);
+  if (cid == 0) {
+    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
+                                  "'%s'",
+                                  collectionName.c_str());
+  }
+  // ensure the collection is loaded
+  collection = trx->trxCollection(cid);
+
+  if (collection == nullptr) {
+    int res = TRI_AddCollectionTransaction(trx->getInternals(), 
+                                           cid,
+                                           TRI_TRANSACTION_READ,
+                                           trx->nestingLevel(),
+                                           true,
+                                           true);
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION_FORMAT(res, "'%s'", collectionName.c_str());
+    }
+    TRI_EnsureCollectionsTransaction(trx->getInternals());
+    collection = trx->trxCollection(cid);
+
+    if (collection == nullptr) {
+      // This case should never occur
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "could not load collection");
+    }
+  }
+  TRI_ASSERT(collection != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Helper function to expand a document read by DOCUMENT
+///        Documents are taken from the document cache if it is active. Edges
+///        are not cached, as they refer to other collections by name. A cached
+///        document is found without reading the marker, by the key that was
+///        looked up and the revision from the primary index
+////////////////////////////////////////////////////////////////////////////////
+
+static Json ExpandCachedDocument (triagens::arango::AqlTransaction* trx,
+                                  CollectionNameResolver const* resolver,
+                                  TRI_transaction_collection_t* collection,
+                                  TRI_voc_cid_t cid,
+                                  std::string const& key,
+                                  TRI_doc_mptr_t const* mptr) {
+  VocShaper* shaper = collection->_collection->_collection->getShaper();
+  auto cache = triagens::arango::DocumentCache::instance();
+
+  if (! cache->isActive() || collection->_collection->_type == TRI_COL_TYPE_EDGE) {
+    return ExpandShapedJson(shaper, resolver, cid, mptr);
+  }
+
+  auto tree = cache->lookupJson(trx->vocbase()->_id,
+                                cid,
+                                key.c_str(),
+                                mptr->_rid,
+                                resolver->getCollectionName(cid),
+                                [&] () -> TRI_json_t* {
+    Json json = ExpandShapedJson(shaper, resolver, cid, mptr);
+    return TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json.json());
+  });
+
+  TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, tree.get());
+
+  if (copy == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  return Json(TRI_UNKNOWN_MEM_ZONE, copy);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Helper function to get a document by it's identifier
+///        The collection has to be locked by the transaction before
+////////////////////////////////////////////////////////////////////////////////
+
+static Json getDocumentByIdentifier (triagens::arango::AqlTransaction* trx,
+                                     CollectionNameResolver const* resolver,
+                                     TRI_transaction_collection_t* collection,
+                                     TRI_voc_cid_t const& cid,
+                                     std::string const& collectionName,
+                                     std::string const& identifier) {
+  std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
+  TRI_doc_mptr_copy_t mptr;
+  if (parts.size() == 1) {
+    int res = trx->readSingle(collection, &mptr, parts[0]);
+    if (res != TRI_ERROR_NO_ERROR) {
+      return Json(Json::Null);
+    }
+  }
+  else if (parts.size() == 2) {
+    if (parts[0] != collectionName) {
+      // Reqesting an _id that cannot be stored in this collection
+      return Json(Json::Null);
+    }
+    int res = trx->readSingle(collection, &mptr, parts[1]);
+    if (res != TRI_ERROR_NO_ERROR) {
+      return Json(Json::Null);
+    }
+  }
+  else {
+    return Json(Json::Null);
+  }
+
+  return ExpandCachedDocument(trx, resolver, collection, cid, parts.back(), &mptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Helper function to get a document by it's _id
+///        This function will lazy read-lock the collection.
+////////////////////////////////////////////////////////////////////////////////
+
+static Json getDocumentByIdentifier (triagens::arango::AqlTransaction* trx,
+                                     CollectionNameResolver const* resolver,
+                                     std::string& identifier) {
+  std::vector<std::string> parts = triagens::basics::StringUtils::split(identifier, "/");
+  if (parts.size() != 2) {
+    return Json(Json::Null);
+  }
+  std::string collectionName = parts[0];
+  TRI_transaction_collection_t* collection = nullptr;
+  TRI_voc_cid_t cid = 0;
+  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
+
+  TRI_doc_mptr_copy_t mptr;
+  int res = trx->readSingle(collection, &mptr, parts[1]);
+  if (res != TRI_ERROR_NO_ERROR) {
+    return Json(Json::Null);
+  }
+
+  return ExpandCachedDocument(trx, resolver, collection, cid, parts[1], &mptr);
+};
+ 
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function Document
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Document (triagens::aql::Query* query,
+                              triagens::arango::AqlTransaction* trx,
+                              FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n < 1 || 2 < n) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "DOCUMENT", (int) 1, (int) 2);
+  }
+
+  auto resolver = trx->resolver();
+
+   if (n == 1) {
+    Json id = ExtractFunctionParameter(trx, parameters, 0, false);
+
+   if (id.isString()) {
+      std::string identifier = triagens::basics::JsonHelper::getStringValue(id.json(), "");
+      Json result = getDocumentByIdentifier(trx, resolver, identifier);
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+    }
+    else if (id.isArray()) {
+      size_t const n = id.size();
+      Json result(Json::Array, n);
+      for (size_t i = 0; i < n; ++i) {
+        Json next = id.at(i);
+        try {
+          if (next.isString()) {
+            std::string identifier = triagens::basics::JsonHelper::getStringValue(next.json(), "");
+            Json tmp = getDocumentByIdentifier(trx, resolver, identifier);
+            if (! tmp.isNull()) {
+              result.add(tmp);
+            }
+          }
+        }
+        catch (triagens::basics::Exception const&) {
+          // Ignore all ArangoDB exceptions here
+        }
+      }
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+    }
+    return AqlValue::CreateNull();
+  }
+
+  Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (! collectionJson.isString()) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+  std::string collectionName = triagens::basics::JsonHelper::getStringValue(collectionJson.json(), "");
+
+  TRI_transaction_collection_t* collection = nullptr;
+  TRI_voc_cid_t cid;
+  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
+
+  Json id = ExtractFunctionParameter(trx, parameters, 1, false);
+  if (id.isString()) {
+    std::string identifier = triagens::basics::JsonHelper::getStringValue(id.json(), "");
+    Json result = getDocumentByIdentifier(trx, resolver, collection, cid, collectionName, identifier);
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
+  else if (id.isArray()) {
+    size_t const n = id.size();
+    Json result(Json::Array, n);
+    for (size_t i = 0; i < n; ++i) {
+      Json next = id.at(i);
+      try {
+        if (next.isString()) {
+          std::string identifier = triagens::basics::JsonHelper::getStringValue(next.json(), "");
+          Json tmp = getDocumentByIdentifier(trx, resolver, collection, cid, collectionName, identifier);
+          if (! tmp.isNull()) {
+            result.add(tmp);
+          }
+        }
+      }
+      catch (triagens::basics::Exception const&) {
+        // Ignore all ArangoDB exceptions here
+      }
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
+  // Id has invalid format
+  return AqlValue::CreateNull();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function Edges
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Edges (triagens::aql::Query* query,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n < 3 || 5 < n) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "EDGES", (int) 3, (int) 5);
+  }
+
+  Json collectionJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (! collectionJson.isString()) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+  }
+  std::string collectionName = triagens::basics::JsonHelper::getStringValue(collectionJson.json(), "");
+
+  TRI_transaction_collection_t* collection = nullptr;
+  TRI_voc_cid_t cid;
+  RegisterCollectionInTransaction(trx, collectionName, cid, collection);
+  if (collection->_collection->_type != TRI_COL_TYPE_EDGE) {
+    RegisterWarning(query, "EDGES", TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID);
+    return AqlValue::CreateNull();
+  }
+
+  Json vertexJson = ExtractFunctionParameter(trx, parameters, 1, false);
+  if (! vertexJson.isString()) {
+    // Invalid Start vertex
+    return AqlValue::CreateNull();
+  }
+
+  std::string vertexId = basics::JsonHelper::getStringValue(vertexJson.json(), "");
+  std::vector<std::string> parts = triagens::basics::StringUtils::split(vertexId, "/");
+  if (parts.size() != 2) {
+    // Invalid Start vertex
+    return AqlValue::CreateNull();
+  }
+
+
+  Json directionJson = ExtractFunctionParameter(trx, parameters, 2, false);
+  if (! directionJson.isString()) {
+    RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+  std::string dirString = basics::JsonHelper::getStringValue(directionJson.json(), "");
+  // transform String to lower case
+  std::transform(dirString.begin(), dirString.end(), dirString.begin(), ::tolower);
+
+  TRI_edge_direction_e direction;
+
+  if (dirString == "inbound") {
+    direction = TRI_EDGE_IN;
+  }
+  else if (dirString == "outbound") {
+    direction = TRI_EDGE_OUT;
+  }
+  else if (dirString == "any") {
+    direction = TRI_EDGE_ANY;
+  }
+  else {
+    RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+  auto resolver = trx->resolver();
+  
+  TRI_voc_cid_t startCid = resolver->getCollectionId(parts[0]);
+  if (startCid == 0) {
+    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
+                                  "'%s'",
+                                  parts[0].c_str());
+  }
+
+  char* key = const_cast<char*>(parts[1].c_str());
+
+  auto shaper = collection->_collection->_collection->getShaper();
+  // the examples are known before the lookup, so that the edges can be read
+  // from a vertex-centric index if there is a suitable one
+  std::unique_ptr<triagens::arango::ExampleMatcher> matcher;
+  bool canMatch = true;
+
+  if (n > 3) {
+    // We might have examples
+    Json exampleJson = ExtractFunctionParameter(trx, parameters, 3, false);
+    if (! exampleJson.isNull()) {
+      bool buildMatcher = false;
+      if (exampleJson.isArray()) {
+        size_t exampleCount = exampleJson.size();
+        // We only support objects here so validate
+        for (size_t k = 0; k < exampleCount; /* nothing */) {
+          if (exampleJson.at(k).isObject()) {
+            ++k;
+            continue;
+          }
+
+          RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
           if (TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, exampleJson.json(), k)) {
             // don't modify count
             --exampleCount;
@@ -3294,951 +3788,1378 @@ AqlValue Functions::Edges (triagens::aql::Query* query,
       else {
         RegisterWarning(query, "EDGES", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
       }
-      if (buildMatcher) {
-        try {
-          triagens::arango::ExampleMatcher matcher(exampleJson.json(), shaper, resolver);
-          for (size_t i = 0; i < resultCount; /* nothing */) {
-            if (! matcher.matches(cid, &edges[i])) {
-              edges.erase(edges.begin() + i);
-              --resultCount;
-            }
-            else {
-              ++i;
-            }
-          }
-        }
-        catch (triagens::basics::Exception const& e) {
-          if (e.code() != TRI_RESULT_ELEMENT_NOT_FOUND) {
-            throw;
-          }
-          // Illegal match, we cannot filter anything
-          edges.clear();
-          resultCount = 0;
-        }
+      if (buildMatcher) {
+        try {
+          matcher.reset(new triagens::arango::ExampleMatcher(exampleJson.json(), shaper, resolver));
+        }
+        catch (triagens::basics::Exception const& e) {
+          if (e.code() != TRI_RESULT_ELEMENT_NOT_FOUND) {
+            throw;
+          }
+          // Illegal match, we cannot filter anything
+          canMatch = false;
+        }
+      }
+    }
+  }
+
+  std::vector<TRI_doc_mptr_copy_t> edges;
+
+  if (canMatch) {
+    edges = TRI_LookupEdgesDocumentCollection(
+      collection->_collection->_collection,
+      direction,
+      startCid,
+      key,
+      matcher.get()
+    );
+
+    if (matcher != nullptr) {
+      edges.erase(std::remove_if(edges.begin(), edges.end(), [&] (TRI_doc_mptr_copy_t const& edge) -> bool {
+        return ! matcher->matches(cid, &edge);
+      }), edges.end());
+    }
+  }
+
+  size_t resultCount = edges.size();
+  
+  bool includeVertices = false;
+  if (n == 5) {
+    // We have options
+    Json options = ExtractFunctionParameter(trx, parameters, 4, false);
+    if (options.isObject() && options.has("includeVertices")) {
+      includeVertices = triagens::basics::JsonHelper::getBooleanValue(options.json(), "includeVertices", false);
+    }
+  }
+
+  if (includeVertices) {
+    Json result(Json::Array, resultCount);
+
+    for (size_t i = 0; i < resultCount; ++i) {
+      Json resultPair(Json::Object, 2);
+      resultPair.set("edge", ExpandShapedJson(
+        shaper,
+        resolver,
+        cid,
+        &(edges[i])
+      ));
+      char const* targetKey;
+      TRI_voc_cid_t targetCid;
+
+      switch (direction) {
+        case TRI_EDGE_OUT:
+          targetKey = TRI_EXTRACT_MARKER_TO_KEY(&edges[i]);
+          targetCid = TRI_EXTRACT_MARKER_TO_CID(&edges[i]);
+          break;
+        case TRI_EDGE_IN:
+          targetKey = TRI_EXTRACT_MARKER_FROM_KEY(&edges[i]);
+          targetCid = TRI_EXTRACT_MARKER_FROM_CID(&edges[i]);
+          break;
+        case TRI_EDGE_ANY:
+          targetKey = TRI_EXTRACT_MARKER_TO_KEY(&edges[i]);
+          targetCid = TRI_EXTRACT_MARKER_TO_CID(&edges[i]);
+          if (targetCid == startCid && strcmp(targetKey, key) == 0) {
+            targetKey = TRI_EXTRACT_MARKER_FROM_KEY(&edges[i]);
+            targetCid = TRI_EXTRACT_MARKER_FROM_CID(&edges[i]);
+          }; 
+          break;
+      }
+
+      resultPair.set("vertex", readDocument(trx, resolver, targetCid, targetKey));
+      result.add(resultPair);
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
+  Json result(Json::Array, resultCount);
+
+  for (size_t i = 0; i < resultCount; ++i) {
+    result.add(ExpandShapedJson(
+      shaper,
+      resolver,
+      cid,
+      &(edges[i])
+    ));
+  }
+
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function ROUND
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Round (triagens::aql::Query* query,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ROUND", (int) 1, (int) 1);
+  }
+
+  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  bool unused = false;
+  double input = TRI_ToDoubleJson(inputJson.json(), unused);
+  input = floor(input + 0.5); // Rounds down for < x.4999 and up for > x.50000
+  return AqlValue(new Json(input));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function ABS
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Abs (triagens::aql::Query* query,
+                         triagens::arango::AqlTransaction* trx,
+                         FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ABS", (int) 1, (int) 1);
+  }
+
+  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  bool unused = false;
+  double input = TRI_ToDoubleJson(inputJson.json(), unused);
+  input = std::abs(input);
+  return AqlValue(new Json(input));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function CEIL
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Ceil (triagens::aql::Query* query,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CEIL", (int) 1, (int) 1);
+  }
+
+  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  bool unused = false;
+  double input = TRI_ToDoubleJson(inputJson.json(), unused);
+  input = ceil(input);
+  return AqlValue(new Json(input));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function FLOOR
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Floor (triagens::aql::Query* query,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "FLOOR", (int) 1, (int) 1);
+  }
+
+  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  bool unused = false;
+  double input = TRI_ToDoubleJson(inputJson.json(), unused);
+  input = floor(input);
+  return AqlValue(new Json(input));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function SQRT
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Sqrt (triagens::aql::Query* query,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SQRT", (int) 1, (int) 1);
+  }
+
+  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  bool unused = false;
+  double input = TRI_ToDoubleJson(inputJson.json(), unused);
+  input = sqrt(input);
+  return AqlValue(new Json(input));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function RAND
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Rand (triagens::aql::Query* query,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+
+  if (n != 0) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "RAND", (int) 0, (int) 0);
+  }
+
+  // This Random functionality is not too good yet...
+  double output = static_cast<double>(std::rand()) / RAND_MAX;
+  return AqlValue(new Json(output));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function FIRST_DOCUMENT
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::FirstDocument (triagens::aql::Query* query,
+                                   triagens::arango::AqlTransaction* trx,
+                                   FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  for (size_t i = 0; i < n; ++i) {
+    Json element = ExtractFunctionParameter(trx, parameters, i, false);
+    if (element.isObject()) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal(), Json::AUTOFREE));
+    }
+  }
+  return AqlValue::CreateNull();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function FIRST_LIST
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::FirstList (triagens::aql::Query* query,
+                               triagens::arango::AqlTransaction* trx,
+                               FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  for (size_t i = 0; i < n; ++i) {
+    Json element = ExtractFunctionParameter(trx, parameters, i, false);
+    if (element.isArray()) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal(), Json::AUTOFREE));
+    }
+  }
+  return AqlValue::CreateNull();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function PUSH
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Push (triagens::aql::Query* query,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n != 2 && n != 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PUSH", (int) 2, (int) 3);
+  }
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json toPush = ExtractFunctionParameter(trx, parameters, 1, false);
+
+  if (list.isNull()) {
+    Json array(Json::Array, 1);
+    array.add(toPush.copy());
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, array.copy().steal()));
+  }
+  if (list.isArray()) {
+    if (n == 3) {
+      Json unique = ExtractFunctionParameter(trx, parameters, 2, false);
+      if (ValueToBoolean(unique.json()) &&
+          ListContainsElement(list, toPush)) {
+        return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+      }
+    }
+    list.add(toPush.copy());
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+  }
+
+  RegisterWarning(query, "PUSH", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+  return AqlValue::CreateNull();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function POP
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Pop (triagens::aql::Query* query,
+                         triagens::arango::AqlTransaction* trx,
+                         FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "POP", (int) 1, (int) 1);
+  }
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (list.isNull()) {
+    return AqlValue::CreateNull();
+  }
+  if (list.isArray()) {
+    if (list.size() > 0) {
+      if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, list.json(), list.size() - 1)) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
       }
     }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
   }
-  
-  bool includeVertices = false;
-  if (n == 5) {
-    // We have options
-    Json options = ExtractFunctionParameter(trx, parameters, 4, false);
-    if (options.isObject() && options.has("includeVertices")) {
-      includeVertices = triagens::basics::JsonHelper::getBooleanValue(options.json(), "includeVertices", false);
+
+  RegisterWarning(query, "POP", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+  return AqlValue::CreateNull();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function APPEND
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Append (triagens::aql::Query* query,
+                            triagens::arango::AqlTransaction* trx,
+                            FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n != 2 && n != 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "APPEND", (int) 2, (int) 3);
+  }
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json toAppend = ExtractFunctionParameter(trx, parameters, 1, false);
+
+  if (toAppend.isNull()) {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+  }
+  bool unique = false;
+  if (n == 3) {
+      Json uniqueJson = ExtractFunctionParameter(trx, parameters, 2, false);
+      unique = ValueToBoolean(uniqueJson.json());
+  }
+  if (list.isNull()) {
+    // Create a JSON array instead.
+    list = Json(Json::Array, 0);
+  }
+
+  if (! toAppend.isArray()) {
+    if (unique && ListContainsElement(list, toAppend)) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
     }
+    list.reserve(1);
+    list.add(toAppend.copy());
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
   }
 
-  if (includeVertices) {
-    Json result(Json::Array, resultCount);
+  size_t const expectedInserts = toAppend.size();
 
-    for (size_t i = 0; i < resultCount; ++i) {
-      Json resultPair(Json::Object, 2);
-      resultPair.set("edge", ExpandShapedJson(
-        shaper,
-        resolver,
-        cid,
-        &(edges[i])
-      ));
-      char const* targetKey;
-      TRI_voc_cid_t targetCid;
+  list.reserve(expectedInserts);
 
-      switch (direction) {
-        case TRI_EDGE_OUT:
-          targetKey = TRI_EXTRACT_MARKER_TO_KEY(&edges[i]);
-          targetCid = TRI_EXTRACT_MARKER_TO_CID(&edges[i]);
-          break;
-        case TRI_EDGE_IN:
-          targetKey = TRI_EXTRACT_MARKER_FROM_KEY(&edges[i]);
-          targetCid = TRI_EXTRACT_MARKER_FROM_CID(&edges[i]);
-          break;
-        case TRI_EDGE_ANY:
-          targetKey = TRI_EXTRACT_MARKER_TO_KEY(&edges[i]);
-          targetCid = TRI_EXTRACT_MARKER_TO_CID(&edges[i]);
-          if (targetCid == startCid && strcmp(targetKey, key) == 0) {
-            targetKey = TRI_EXTRACT_MARKER_FROM_KEY(&edges[i]);
-            targetCid = TRI_EXTRACT_MARKER_FROM_CID(&edges[i]);
-          }; 
-          break;
-      }
+  for (size_t i = 0; i < expectedInserts; ++i) {
+    auto toPush = toAppend.at(i);
+    if (unique && ListContainsElement(list, toPush)) {
+      continue;
+    }
+    list.add(toPush.copy());
+  }
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function UNSHIFT
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Unshift (triagens::aql::Query* query,
+                             triagens::arango::AqlTransaction* trx,
+                             FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n != 2 && n != 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "UNSHIFT", (int) 2, (int) 3);
+  }
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json toAppend = ExtractFunctionParameter(trx, parameters, 1, false);
 
-      resultPair.set("vertex", readDocument(trx, resolver, targetCid, targetKey));
-      result.add(resultPair);
-    }
+  if (list.isNull()) {
+    Json result(Json::Array, 1);
+    result.add(toAppend.copy());
     return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
   }
-  Json result(Json::Array, resultCount);
 
-  for (size_t i = 0; i < resultCount; ++i) {
-    result.add(ExpandShapedJson(
-      shaper,
-      resolver,
-      cid,
-      &(edges[i])
-    ));
+  if (list.isArray()) {
+    bool unique = false;
+    if (n == 3) {
+        Json uniqueJson = ExtractFunctionParameter(trx, parameters, 2, false);
+        unique = ValueToBoolean(uniqueJson.json());
+    }
+    if (unique && ListContainsElement(list, toAppend)) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+    }
+    Json copy = list.copy();
+    TRI_json_t* toAppendCopy = toAppend.copy().steal();
+
+    int res = TRI_InsertVector(&(copy.json()->_value._objects), toAppendCopy, 0);
+    // free the pointer, but not the contents
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, toAppendCopy);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, copy.steal()));
   }
 
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  RegisterInvalidArgumentWarning(query, "UNSHIFT");
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function ROUND
+/// @brief function SHIFT
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Round (triagens::aql::Query* query,
-                          triagens::arango::AqlTransaction* trx,
-                          FunctionParameters const& parameters) {
+AqlValue Functions::Shift (triagens::aql::Query* query,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
   size_t const n = parameters.size();
 
   if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ROUND", (int) 1, (int) 1);
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SHIFT", (int) 1, (int) 1);
   }
 
-  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (list.isNull()) {
+    return AqlValue::CreateNull();
+  }
+  if (list.isArray()) {
+    if (list.size() == 0) {
+      return AqlValue(new Json(Json::Array, 0));
+    }
+    if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, list.json(), 0)) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+  }
 
-  bool unused = false;
-  double input = TRI_ToDoubleJson(inputJson.json(), unused);
-  input = floor(input + 0.5); // Rounds down for < x.4999 and up for > x.50000
-  return AqlValue(new Json(input));
+  RegisterInvalidArgumentWarning(query, "SHIFT");
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function ABS
+/// @brief function REMOVE_VALUE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Abs (triagens::aql::Query* query,
-                         triagens::arango::AqlTransaction* trx,
-                         FunctionParameters const& parameters) {
+AqlValue Functions::RemoveValue (triagens::aql::Query* query,
+                                 triagens::arango::AqlTransaction* trx,
+                                 FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "ABS", (int) 1, (int) 1);
+  if (n != 2 && n != 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_VALUE", (int) 2, (int) 3);
   }
 
-  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  bool unused = false;
-  double input = TRI_ToDoubleJson(inputJson.json(), unused);
-  input = std::abs(input);
-  return AqlValue(new Json(input));
+  if (list.isNull()) {
+    return AqlValue(new Json(Json::Array, 0));
+  }
+  if (list.isArray()) {
+    bool useLimit = false;
+    Json result = list.copy();
+    size_t limit = result.size();
+    Json toRemove = ExtractFunctionParameter(trx, parameters, 1, false);
+    if (n == 3) {
+      Json limitJson = ExtractFunctionParameter(trx, parameters, 2, false);
+      if (! limitJson.isNull()) {
+        bool unused = false;
+        limit = static_cast<size_t>(ValueToNumber(limitJson.json(), unused));
+        useLimit = true;
+      }
+    }
+    for (size_t i = 0; i < result.size(); /* No increase */) {
+      if (useLimit && limit == 0) {
+        break;
+      }
+      if (TRI_CheckSameValueJson(toRemove.json(), result.at(i).json())) {
+        if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), i)) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+        }
+        --limit;
+      }
+      else {
+        ++i;
+      }
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
+
+  RegisterInvalidArgumentWarning(query, "REMOVE_VALUE");
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function CEIL
+/// @brief function REMOVE_VALUES
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Ceil (triagens::aql::Query* query,
-                          triagens::arango::AqlTransaction* trx,
-                          FunctionParameters const& parameters) {
+AqlValue Functions::RemoveValues (triagens::aql::Query* query,
+                                  triagens::arango::AqlTransaction* trx,
+                                  FunctionParameters const& parameters) {
   size_t const n = parameters.size();
+  if (n != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_VALUES", (int) 2, (int) 2);
+  }
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  Json values = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CEIL", (int) 1, (int) 1);
+  if (values.isNull()) {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
   }
 
-  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (list.isNull()) {
+    return AqlValue(new Json(Json::Array, 0));
+  }
 
-  bool unused = false;
-  double input = TRI_ToDoubleJson(inputJson.json(), unused);
-  input = ceil(input);
-  return AqlValue(new Json(input));
+  if (list.isArray() && values.isArray()) {
+    Json result = list.copy();
+    for (size_t i = 0; i < result.size(); /* No advance */) {
+      if (ListContainsElement(values, result.at(i))) {
+        if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), i)) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+        }
+      }
+      else {
+        ++i;
+      }
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
+
+  RegisterInvalidArgumentWarning(query, "REMOVE_VALUES");
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function FLOOR
+/// @brief function REMOVE_NTH
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Floor (triagens::aql::Query* query,
-                           triagens::arango::AqlTransaction* trx,
-                           FunctionParameters const& parameters) {
+AqlValue Functions::RemoveNth (triagens::aql::Query* query,
+                               triagens::arango::AqlTransaction* trx,
+                               FunctionParameters const& parameters) {
   size_t const n = parameters.size();
+  if (n != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_NTH", (int) 2, (int) 2);
+  }
 
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "FLOOR", (int) 1, (int) 1);
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (list.isNull()) {
+    return AqlValue(new Json(Json::Array, 0));
   }
 
-  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  if (list.isArray()) {
+    double const count = static_cast<double>(list.size());
+    Json position = ExtractFunctionParameter(trx, parameters, 1, false);
+    bool unused = false;
+    double p = TRI_ToDoubleJson(position.json(), unused);
+    if (p >= count || p < - count) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+    }
+    if (p < 0) {
+      p += count;
+    }
+    Json result = list.copy();
+    if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), static_cast<size_t>(p))) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  }
 
-  bool unused = false;
-  double input = TRI_ToDoubleJson(inputJson.json(), unused);
-  input = floor(input);
-  return AqlValue(new Json(input));
+  RegisterInvalidArgumentWarning(query, "REMOVE_NTH");
+  return AqlValue::CreateNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function SQRT
+/// @brief function NOT_NULL
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Sqrt (triagens::aql::Query* query,
-                          triagens::arango::AqlTransaction* trx,
-                          FunctionParameters const& parameters) {
+AqlValue Functions::NotNull (triagens::aql::Query* query,
+                             triagens::arango::AqlTransaction* trx,
+                             FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SQRT", (int) 1, (int) 1);
+  for (size_t i = 0; i < n; ++i) {
+    Json element = ExtractFunctionParameter(trx, parameters, i, false);
+    if (! element.isNull()) {
+      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal()));
+    }
   }
+  return AqlValue::CreateNull();
+}
 
-  Json inputJson = ExtractFunctionParameter(trx, parameters, 0, false);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function CURRENT_DATABASE
+////////////////////////////////////////////////////////////////////////////////
 
-  bool unused = false;
-  double input = TRI_ToDoubleJson(inputJson.json(), unused);
-  input = sqrt(input);
-  return AqlValue(new Json(input));
+AqlValue Functions::CurrentDatabase (triagens::aql::Query* query,
+                                     triagens::arango::AqlTransaction* trx,
+                                     FunctionParameters const& parameters) {
+  size_t const n = parameters.size();
+  if (n != 0) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CURRENT_DATABASE", (int) 0, (int) 0);
+  }
+  return AqlValue(new Json(query->vocbase()->_name));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function RAND
+/// @brief function VARIANCE_SAMPLE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Rand (triagens::aql::Query* query,
-                          triagens::arango::AqlTransaction* trx,
-                          FunctionParameters const& parameters) {
+AqlValue Functions::VarianceSample (triagens::aql::Query* query,
+                                    triagens::arango::AqlTransaction* trx,
+                                    FunctionParameters const& parameters) {
   size_t const n = parameters.size();
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "VARIANCE_SAMPLE", (int) 1, (int) 1);
+  }
+
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+
+  if (! list.isArray()) {
+    RegisterWarning(query, "VARIANCE_SAMPLE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
+  }
+
+  double value = 0.0;
+  size_t count = 0;
+
+  if (! Variance(list, value, count)) {
+    RegisterWarning(query, "VARIANCE_SAMPLE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
+  }
 
-  if (n != 0) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "RAND", (int) 0, (int) 0);
+  if (count < 2) {
+    return AqlValue::CreateNull();
   }
 
-  // This Random functionality is not too good yet...
-  double output = static_cast<double>(std::rand()) / RAND_MAX;
-  return AqlValue(new Json(output));
+  return AqlValue(new Json(value / (count - 1)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function FIRST_DOCUMENT
+/// @brief function VARIANCE_POPULATION
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::FirstDocument (triagens::aql::Query* query,
-                                   triagens::arango::AqlTransaction* trx,
-                                   FunctionParameters const& parameters) {
+AqlValue Functions::VariancePopulation (triagens::aql::Query* query,
+                                        triagens::arango::AqlTransaction* trx,
+                                        FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  for (size_t i = 0; i < n; ++i) {
-    Json element = ExtractFunctionParameter(trx, parameters, i, false);
-    if (element.isObject()) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal(), Json::AUTOFREE));
-    }
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "VARIANCE_POPULATION", (int) 1, (int) 1);
   }
-  return AqlValue(new Json(Json::Null));
-}
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief function FIRST_LIST
-////////////////////////////////////////////////////////////////////////////////
+  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-AqlValue Functions::FirstList (triagens::aql::Query* query,
-                               triagens::arango::AqlTransaction* trx,
-                               FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  for (size_t i = 0; i < n; ++i) {
-    Json element = ExtractFunctionParameter(trx, parameters, i, false);
-    if (element.isArray()) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal(), Json::AUTOFREE));
-    }
+  if (! list.isArray()) {
+    RegisterWarning(query, "VARIANCE_POPULATION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
+  }
+
+  double value = 0.0;
+  size_t count = 0;
+
+  if (! Variance(list, value, count)) {
+    RegisterWarning(query, "VARIANCE_POPULATION", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
+  }
+
+  if (count < 1) {
+    return AqlValue::CreateNull();
   }
-  return AqlValue(new Json(Json::Null));
+
+  return AqlValue(new Json(value / count));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function PUSH
+/// @brief function STDDEV_SAMPLE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Push (triagens::aql::Query* query,
-                          triagens::arango::AqlTransaction* trx,
-                          FunctionParameters const& parameters) {
+AqlValue Functions::StdDevSample (triagens::aql::Query* query,
+                                  triagens::arango::AqlTransaction* trx,
+                                  FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PUSH", (int) 2, (int) 3);
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "STDDEV_SAMPLE", (int) 1, (int) 1);
   }
+
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
-  Json toPush = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  if (list.isNull()) {
-    Json array(Json::Array, 1);
-    array.add(toPush.copy());
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, array.copy().steal()));
+  if (! list.isArray()) {
+    RegisterWarning(query, "STDDEV_SAMPLE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
-  if (list.isArray()) {
-    if (n == 3) {
-      Json unique = ExtractFunctionParameter(trx, parameters, 2, false);
-      if (ValueToBoolean(unique.json()) &&
-          ListContainsElement(list, toPush)) {
-        return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-      }
-    }
-    list.add(toPush.copy());
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+
+  double value = 0.0;
+  size_t count = 0;
+
+  if (! Variance(list, value, count)) {
+    RegisterWarning(query, "STDDEV_SAMPLE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
   }
 
-  RegisterWarning(query, "PUSH", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-  return AqlValue(new Json(Json::Null));
-}
+  if (count < 2) {
+    return AqlValue::CreateNull();
+  }
 
+  return AqlValue(new Json(sqrt(value / (count - 1))));
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function POP
+/// @brief function STDDEV_POPULATION
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Pop (triagens::aql::Query* query,
-                         triagens::arango::AqlTransaction* trx,
-                         FunctionParameters const& parameters) {
+AqlValue Functions::StdDevPopulation (triagens::aql::Query* query,
+                                      triagens::arango::AqlTransaction* trx,
+                                      FunctionParameters const& parameters) {
   size_t const n = parameters.size();
   if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "POP", (int) 1, (int) 1);
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "STDDEV_POPULATION", (int) 1, (int) 1);
   }
+
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  if (list.isNull()) {
-    return AqlValue(new Json(Json::Null));
+  if (! list.isArray()) {
+    RegisterWarning(query, "STDDEV_POPULATION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
-  if (list.isArray()) {
-    if (list.size() > 0) {
-      if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, list.json(), list.size() - 1)) {
-        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
-      }
-    }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+
+  double value = 0.0;
+  size_t count = 0;
+
+  if (! Variance(list, value, count)) {
+    RegisterWarning(query, "STDDEV_POPULATION", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
   }
 
-  RegisterWarning(query, "POP", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-  return AqlValue(new Json(Json::Null));
+  if (count < 1) {
+    return AqlValue::CreateNull();
+  }
+
+  return AqlValue(new Json(sqrt(value / count)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function APPEND
+/// @brief function MEDIAN
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Append (triagens::aql::Query* query,
+AqlValue Functions::Median (triagens::aql::Query* query,
                             triagens::arango::AqlTransaction* trx,
                             FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "APPEND", (int) 2, (int) 3);
+  if (n != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "MEDIAN", (int) 1, (int) 1);
   }
+
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
-  Json toAppend = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  if (toAppend.isNull()) {
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-  }
-  bool unique = false;
-  if (n == 3) {
-      Json uniqueJson = ExtractFunctionParameter(trx, parameters, 2, false);
-      unique = ValueToBoolean(uniqueJson.json());
-  }
-  if (list.isNull()) {
-    // Create a JSON array instead.
-    list = Json(Json::Array, 0);
+  if (! list.isArray()) {
+    RegisterWarning(query, "MEDIAN", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
 
-  if (! toAppend.isArray()) {
-    if (unique && ListContainsElement(list, toAppend)) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-    }
-    list.reserve(1);
-    list.add(toAppend.copy());
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+  std::vector<double> values;
+  if (! SortNumberList(list, values)) {
+    RegisterWarning(query, "MEDIAN", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
   }
 
-  size_t const expectedInserts = toAppend.size();
-
-  list.reserve(expectedInserts);
+  if (values.empty()) {
+    return AqlValue::CreateNull();
+  }
+  size_t const l = values.size();
+  size_t midpoint = l / 2;
 
-  for (size_t i = 0; i < expectedInserts; ++i) {
-    auto toPush = toAppend.at(i);
-    if (unique && ListContainsElement(list, toPush)) {
-      continue;
-    }
-    list.add(toPush.copy());
+  if (l % 2 == 0) {
+    return AqlValue(new Json((values[midpoint - 1] + values[midpoint]) / 2));
   }
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
+  return AqlValue(new Json(values[midpoint]));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function UNSHIFT
+/// @brief function PERCENTILE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Unshift (triagens::aql::Query* query,
-                             triagens::arango::AqlTransaction* trx,
-                             FunctionParameters const& parameters) {
+AqlValue Functions::Percentile (triagens::aql::Query* query,
+                                triagens::arango::AqlTransaction* trx,
+                                FunctionParameters const& parameters) {
   size_t const n = parameters.size();
   if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "UNSHIFT", (int) 2, (int) 3);
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PERCENTILE", (int) 2, (int) 3);
   }
+
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
-  Json toAppend = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  if (list.isNull()) {
-    Json result(Json::Array, 1);
-    result.add(toAppend.copy());
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  if (! list.isArray()) {
+    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
 
-  if (list.isArray()) {
-    bool unique = false;
-    if (n == 3) {
-        Json uniqueJson = ExtractFunctionParameter(trx, parameters, 2, false);
-        unique = ValueToBoolean(uniqueJson.json());
-    }
-    if (unique && ListContainsElement(list, toAppend)) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-    }
-    Json copy = list.copy();
-    TRI_json_t* toAppendCopy = toAppend.copy().steal();
+  Json border = ExtractFunctionParameter(trx, parameters, 1, false);
 
-    int res = TRI_InsertVector(&(copy.json()->_value._objects), toAppendCopy, 0);
-    // free the pointer, but not the contents
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, toAppendCopy);
+  if (! border.isNumber()) {
+    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
 
-    if (res != TRI_ERROR_NO_ERROR) {
-      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  bool unused = false;
+  double p = ValueToNumber(border.json(), unused);
+  if (p <= 0 || p > 100) {
+    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+
+  bool useInterpolation = false;
+
+  if (n == 3) {
+    Json methodJson = ExtractFunctionParameter(trx, parameters, 2, false);
+    if (! methodJson.isString()) {
+      RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+      return AqlValue::CreateNull();
+    }
+    std::string method = triagens::basics::JsonHelper::getStringValue(methodJson.json(), "");
+    if (method == "interpolation") {
+      useInterpolation = true;
+    }
+    else if (method == "rank") {
+      useInterpolation = false;
+    }
+    else {
+      RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+      return AqlValue::CreateNull();
     }
+  }
 
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, copy.steal()));
+  std::vector<double> values;
+  if (! SortNumberList(list, values)) {
+    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
+    return AqlValue::CreateNull();
+  }
+
+  if (values.empty()) {
+    return AqlValue::CreateNull();
+  }
+  size_t l = values.size();
+  if (l == 1) {
+    return AqlValue(new Json(values[0]));
   }
 
-  RegisterInvalidArgumentWarning(query, "UNSHIFT");
-  return AqlValue(new Json(Json::Null));
+  if (useInterpolation) {
+    double idx = p * (l + 1) / 100;
+    double pos = floor(idx);
+
+    if (pos >= l) {
+      return AqlValue(new Json(values[l - 1]));
+    }
+
+    double delta = idx - pos;
+    return AqlValue(new Json(delta * (values[pos] - values[pos - 1]) + values[pos - 1]));
+  }
+  double idx = p * l / 100;
+  double pos = ceil(idx);
+  if (pos >= l) {
+    return AqlValue(new Json(values[l - 1]));
+  }
+  return AqlValue(new Json(values[pos - 1]));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function SHIFT
+/// @brief function RANGE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Shift (triagens::aql::Query* query,
+AqlValue Functions::Range (triagens::aql::Query* query,
                            triagens::arango::AqlTransaction* trx,
                            FunctionParameters const& parameters) {
   size_t const n = parameters.size();
 
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SHIFT", (int) 1, (int) 1);
+  if (n != 2 && n != 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "RANGE", (int) 2, (int) 3);
   }
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
-  if (list.isNull()) {
-    return AqlValue(new Json(Json::Null));
+  auto const leftJson = ExtractFunctionParameter(trx, parameters, 0, false);
+  auto const rightJson = ExtractFunctionParameter(trx, parameters, 1, false);
+
+  bool unused = true;
+  double from = ValueToNumber(leftJson.json(), unused);
+  double to = ValueToNumber(rightJson.json(), unused);
+
+  double step = 0;
+  if (n == 3) {
+    auto const stepJson = ExtractFunctionParameter(trx, parameters, 2, false);
+    step = ValueToNumber(stepJson.json(), unused);
   }
-  if (list.isArray()) {
-    if (list.size() == 0) {
-      return AqlValue(new Json(Json::Array, 0));
+  if ( step == 0 ||
+      (from < to && step < 0) ||
+      (from > to && step > 0)) {
+    RegisterWarning(query, "RANGE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
+    return AqlValue::CreateNull();
+  }
+  Json result(Json::Array);
+  if (from < to) {
+    for (; from <= to; from += step) {
+      result.add(Json(from));
     }
-    if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, list.json(), 0)) {
-      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+  else {
+    for (; from >= to; from += step) {
+      result.add(Json(from));
     }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
   }
-
-  RegisterInvalidArgumentWarning(query, "SHIFT");
-  return AqlValue(new Json(Json::Null));
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function REMOVE_VALUE
+/// @brief function POSITION
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::RemoveValue (triagens::aql::Query* query,
-                                 triagens::arango::AqlTransaction* trx,
-                                 FunctionParameters const& parameters) {
+AqlValue Functions::Position (triagens::aql::Query* query,
+                              triagens::arango::AqlTransaction* trx,
+                              FunctionParameters const& parameters) {
   size_t const n = parameters.size();
   if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_VALUE", (int) 2, (int) 3);
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "POSITION", (int) 2, (int) 3);
   }
 
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  if (list.isNull()) {
-    return AqlValue(new Json(Json::Array, 0));
+  if (! list.isArray()) {
+    RegisterWarning(query, "POSITION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
-  if (list.isArray()) {
-    bool useLimit = false;
-    Json result = list.copy();
-    size_t limit = result.size();
-    Json toRemove = ExtractFunctionParameter(trx, parameters, 1, false);
-    if (n == 3) {
-      Json limitJson = ExtractFunctionParameter(trx, parameters, 2, false);
-      if (! limitJson.isNull()) {
-        bool unused = false;
-        limit = static_cast<size_t>(ValueToNumber(limitJson.json(), unused));
-        useLimit = true;
-      }
-    }
-    for (size_t i = 0; i < result.size(); /* No increase */) {
-      if (useLimit && limit == 0) {
-        break;
-      }
-      if (TRI_CheckSameValueJson(toRemove.json(), result.at(i).json())) {
-        if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), i)) {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
-        }
-        --limit;
-      }
-      else {
-        ++i;
+
+  bool returnIndex = false;
+  if (n == 3) {
+    Json returnIndexJson = ExtractFunctionParameter(trx, parameters, 2, false);
+    returnIndex = ValueToBoolean(returnIndexJson.json());
+  }
+
+  if (list.size() > 0) {
+    Json searchValue = ExtractFunctionParameter(trx, parameters, 1, false);
+
+    size_t index;
+    if (ListContainsElement(list, searchValue, index)) {
+      if (returnIndex) {
+        return AqlValue::CreateNumber(static_cast<double>(index));
       }
+      return AqlValue::CreateBool(true);
     }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
   }
 
-  RegisterInvalidArgumentWarning(query, "REMOVE_VALUE");
-  return AqlValue(new Json(Json::Null));
+  if (returnIndex) {
+    return AqlValue::CreateNumber(-1.0);
+  }
+  return AqlValue::CreateBool(false);
 }
 
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function REMOVE_VALUES
+/// @brief extract a function parameter as a string, using the same
+/// conversion rules as TO_STRING. the result uses the UTF-16 indexing that
+/// the JavaScript implementations of the string functions used
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::RemoveValues (triagens::aql::Query* query,
-                                  triagens::arango::AqlTransaction* trx,
-                                  FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 2) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_VALUES", (int) 2, (int) 2);
-  }
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
-  Json values = ExtractFunctionParameter(trx, parameters, 1, false);
-
-  if (values.isNull()) {
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-  }
-
-  if (list.isNull()) {
-    return AqlValue(new Json(Json::Array, 0));
-  }
+static UnicodeString ExtractUnicodeParameter (triagens::arango::AqlTransaction* trx,
+                                              FunctionParameters const& parameters,
+                                              size_t position) {
+  auto const value = ExtractFunctionParameter(trx, parameters, position, false);
 
-  if (list.isArray() && values.isArray()) {
-    Json result = list.copy();
-    for (size_t i = 0; i < result.size(); /* No advance */) {
-      if (ListContainsElement(values, result.at(i))) {
-        if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), i)) {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
-        }
-      }
-      else {
-        ++i;
-      }
-    }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
-  }
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
+  AppendAsString(buffer, value.json());
 
-  RegisterInvalidArgumentWarning(query, "REMOVE_VALUES");
-  return AqlValue(new Json(Json::Null));
+  return UnicodeString::fromUTF8(StringPiece(buffer.c_str(), static_cast<int32_t>(buffer.length())));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function REMOVE_NTH
+/// @brief extract a function parameter as an integer, truncating it the same
+/// way as JavaScript's string and array functions did. invalid values are 0
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::RemoveNth (triagens::aql::Query* query,
-                               triagens::arango::AqlTransaction* trx,
-                               FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 2) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REMOVE_NTH", (int) 2, (int) 2);
-  }
+static int64_t ExtractIntegerParameter (triagens::arango::AqlTransaction* trx,
+                                        FunctionParameters const& parameters,
+                                        size_t position) {
+  auto const value = ExtractFunctionParameter(trx, parameters, position, false);
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  bool isValid;
+  double number = ValueToNumber(value.json(), isValid);
 
-  if (list.isNull()) {
-    return AqlValue(new Json(Json::Array, 0));
+  if (! isValid || std::isnan(number)) {
+    return 0;
   }
-
-  if (list.isArray()) {
-    double const count = static_cast<double>(list.size());
-    Json position = ExtractFunctionParameter(trx, parameters, 1, false);
-    bool unused = false;
-    double p = TRI_ToDoubleJson(position.json(), unused);
-    if (p >= count || p < - count) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, list.copy().steal()));
-    }
-    if (p < 0) {
-      p += count;
-    }
-    Json result = list.copy();
-    if (! TRI_DeleteArrayJson(TRI_UNKNOWN_MEM_ZONE, result.json(), static_cast<size_t>(p))) {
-      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
-    }
-    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+  if (number >= static_cast<double>(INT32_MAX)) {
+    return INT32_MAX;
   }
-
-  RegisterInvalidArgumentWarning(query, "REMOVE_NTH");
-  return AqlValue(new Json(Json::Null));
+  if (number <= static_cast<double>(INT32_MIN)) {
+    return INT32_MIN;
+  }
+  return static_cast<int64_t>(number);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function NOT_NULL
+/// @brief create an AqlValue from a UnicodeString
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::NotNull (triagens::aql::Query* query,
-                             triagens::arango::AqlTransaction* trx,
-                             FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  for (size_t i = 0; i < n; ++i) {
-    Json element = ExtractFunctionParameter(trx, parameters, i, false);
-    if (! element.isNull()) {
-      return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, element.copy().steal()));
-    }
-  }
-  return AqlValue(new Json(Json::Null));
+static AqlValue UnicodeToAqlValue (UnicodeString const& value) {
+  std::string result;
+  value.toUTF8String(result);
+
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function CURRENT_DATABASE
+/// @brief JavaScript's String.prototype.substr
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::CurrentDatabase (triagens::aql::Query* query,
-                                     triagens::arango::AqlTransaction* trx,
-                                     FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 0) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CURRENT_DATABASE", (int) 0, (int) 0);
+static UnicodeString Substr (UnicodeString const& value,
+                             int64_t offset,
+                             int64_t length) {
+  int64_t const size = static_cast<int64_t>(value.length());
+
+  if (offset < 0) {
+    offset = (std::max)(size + offset, static_cast<int64_t>(0));
   }
-  return AqlValue(new Json(query->vocbase()->_name));
+  offset = (std::min)(offset, size);
+  length = (std::min)(length, size - offset);
+
+  if (length <= 0) {
+    return UnicodeString();
+  }
+
+  return UnicodeString(value, static_cast<int32_t>(offset), static_cast<int32_t>(length));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function VARIANCE_SAMPLE
+/// @brief function CONCAT_SEPARATOR
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::VarianceSample (triagens::aql::Query* query,
-                                    triagens::arango::AqlTransaction* trx,
-                                    FunctionParameters const& parameters) {
+AqlValue Functions::ConcatSeparator (triagens::aql::Query*,
+                                     triagens::arango::AqlTransaction* trx,
+                                     FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "VARIANCE_SAMPLE", (int) 1, (int) 1);
+
+  if (n < 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CONCAT_SEPARATOR", (int) 2, (int) Function::MaxArguments);
   }
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  triagens::basics::StringBuffer separator(TRI_UNKNOWN_MEM_ZONE, 24);
+  {
+    auto const value = ExtractFunctionParameter(trx, parameters, 0, false);
+    AppendAsString(separator, value.json());
+  }
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "VARIANCE_SAMPLE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
+  bool found = false;
+
+  for (size_t i = 1; i < n; ++i) {
+    auto const member = ExtractFunctionParameter(trx, parameters, i, false);
+
+    if (member.isEmpty() || member.isNull()) {
+      continue;
+    }
+      
+    TRI_json_t const* json = member.json();
+    
+    if (member.isArray()) {
+      // append each member individually
+      size_t const subLength = TRI_LengthArrayJson(json);
+
+      for (size_t j = 0; j < subLength; ++j) {
+        auto sub = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, j));
+
+        if (sub == nullptr || sub->_type == TRI_JSON_NULL) {
+          continue;
+        }
+
+        if (found) {
+          buffer.appendText(separator.c_str(), separator.length());
+        }
+        AppendAsString(buffer, sub);
+        found = true;
+      }
+      continue;
+    }
+
+    if (found) {
+      buffer.appendText(separator.c_str(), separator.length());
+    }
+    AppendAsString(buffer, json);
+    found = true;
   }
+  
+  // steal the StringBuffer's char* pointer so we can avoid copying data around
+  // multiple times
+  size_t length = buffer.length();
+  std::unique_ptr<TRI_json_t> j(TRI_CreateStringJson(TRI_UNKNOWN_MEM_ZONE, buffer.steal(), length));
 
-  double value = 0.0;
-  size_t count = 0;
+  auto jr = new Json(TRI_UNKNOWN_MEM_ZONE, j.get());
+  j.release();
+  return AqlValue(jr);
+}
 
-  if (! Variance(list, value, count)) {
-    RegisterWarning(query, "VARIANCE_SAMPLE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
-  }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function CHAR_LENGTH
+////////////////////////////////////////////////////////////////////////////////
 
-  if (count < 2) {
-    return AqlValue(new Json(Json::Null));
+AqlValue Functions::CharLength (triagens::aql::Query*,
+                                triagens::arango::AqlTransaction* trx,
+                                FunctionParameters const& parameters) {
+  if (parameters.size() != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CHAR_LENGTH", (int) 1, (int) 1);
   }
 
-  return AqlValue(new Json(value / (count - 1)));
+  UnicodeString const value = ExtractUnicodeParameter(trx, parameters, 0);
+
+  return AqlValue::CreateNumber(static_cast<double>(value.length()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function VARIANCE_POPULATION
+/// @brief function LOWER
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::VariancePopulation (triagens::aql::Query* query,
-                                        triagens::arango::AqlTransaction* trx,
-                                        FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "VARIANCE_POPULATION", (int) 1, (int) 1);
+AqlValue Functions::Lower (triagens::aql::Query*,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  if (parameters.size() != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "LOWER", (int) 1, (int) 1);
   }
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  UnicodeString value = ExtractUnicodeParameter(trx, parameters, 0);
+  value.toLower(Locale::getRoot());
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "VARIANCE_POPULATION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
-  }
+  return UnicodeToAqlValue(value);
+}
 
-  double value = 0.0;
-  size_t count = 0;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function UPPER
+////////////////////////////////////////////////////////////////////////////////
 
-  if (! Variance(list, value, count)) {
-    RegisterWarning(query, "VARIANCE_POPULATION", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
+AqlValue Functions::Upper (triagens::aql::Query*,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  if (parameters.size() != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "UPPER", (int) 1, (int) 1);
   }
 
-  if (count < 1) {
-    return AqlValue(new Json(Json::Null));
-  }
+  UnicodeString value = ExtractUnicodeParameter(trx, parameters, 0);
+  value.toUpper(Locale::getRoot());
 
-  return AqlValue(new Json(value / count));
+  return UnicodeToAqlValue(value);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function STDDEV_SAMPLE
+/// @brief function SUBSTRING
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::StdDevSample (triagens::aql::Query* query,
-                                  triagens::arango::AqlTransaction* trx,
-                                  FunctionParameters const& parameters) {
+AqlValue Functions::Substring (triagens::aql::Query*,
+                               triagens::arango::AqlTransaction* trx,
+                               FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "STDDEV_SAMPLE", (int) 1, (int) 1);
-  }
-
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "STDDEV_SAMPLE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+  if (n < 2 || n > 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SUBSTRING", (int) 2, (int) 3);
   }
 
-  double value = 0.0;
-  size_t count = 0;
-
-  if (! Variance(list, value, count)) {
-    RegisterWarning(query, "STDDEV_SAMPLE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
-  }
+  UnicodeString const value = ExtractUnicodeParameter(trx, parameters, 0);
+  int64_t const offset = ExtractIntegerParameter(trx, parameters, 1);
+  int64_t length = INT32_MAX;
 
-  if (count < 2) {
-    return AqlValue(new Json(Json::Null));
+  if (n == 3) {
+    length = ExtractIntegerParameter(trx, parameters, 2);
   }
 
-  return AqlValue(new Json(sqrt(value / (count - 1))));
+  return UnicodeToAqlValue(Substr(value, offset, length));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function STDDEV_POPULATION
+/// @brief function CONTAINS
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::StdDevPopulation (triagens::aql::Query* query,
-                                      triagens::arango::AqlTransaction* trx,
-                                      FunctionParameters const& parameters) {
+AqlValue Functions::Contains (triagens::aql::Query*,
+                              triagens::arango::AqlTransaction* trx,
+                              FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "STDDEV_POPULATION", (int) 1, (int) 1);
-  }
-
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "STDDEV_POPULATION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+  if (n < 2 || n > 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "CONTAINS", (int) 2, (int) 3);
   }
 
-  double value = 0.0;
-  size_t count = 0;
+  UnicodeString const value = ExtractUnicodeParameter(trx, parameters, 0);
+  UnicodeString const search = ExtractUnicodeParameter(trx, parameters, 1);
+  bool const returnIndex = GetBooleanParameter(trx, parameters, 2, false);
 
-  if (! Variance(list, value, count)) {
-    RegisterWarning(query, "STDDEV_POPULATION", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
+  int32_t result = -1;
+
+  if (search.length() > 0) {
+    result = value.indexOf(search);
   }
 
-  if (count < 1) {
-    return AqlValue(new Json(Json::Null));
+  if (returnIndex) {
+    return AqlValue::CreateNumber(static_cast<double>(result));
   }
 
-  return AqlValue(new Json(sqrt(value / count)));
+  return AqlValue::CreateBool(result != -1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function MEDIAN
+/// @brief function LEFT
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Median (triagens::aql::Query* query,
-                            triagens::arango::AqlTransaction* trx,
-                            FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 1) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "MEDIAN", (int) 1, (int) 1);
+AqlValue Functions::Left (triagens::aql::Query*,
+                          triagens::arango::AqlTransaction* trx,
+                          FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "LEFT", (int) 2, (int) 2);
   }
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  UnicodeString const value = ExtractUnicodeParameter(trx, parameters, 0);
+  int64_t const length = ExtractIntegerParameter(trx, parameters, 1);
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "MEDIAN", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
-  }
+  return UnicodeToAqlValue(Substr(value, 0, length));
+}
 
-  std::vector<double> values;
-  if (! SortNumberList(list, values)) {
-    RegisterWarning(query, "MEDIAN", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
-  }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function RIGHT
+////////////////////////////////////////////////////////////////////////////////
 
-  if (values.empty()) {
-    return AqlValue(new Json(Json::Null));
+AqlValue Functions::Right (triagens::aql::Query*,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
+  if (parameters.size() != 2) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "RIGHT", (int) 2, (int) 2);
   }
-  size_t const l = values.size();
-  size_t midpoint = l / 2;
 
-  if (l % 2 == 0) {
-    return AqlValue(new Json((values[midpoint - 1] + values[midpoint]) / 2));
-  }
-  return AqlValue(new Json(values[midpoint]));
+  UnicodeString const value = ExtractUnicodeParameter(trx, parameters, 0);
+  int64_t const length = ExtractIntegerParameter(trx, parameters, 1);
+  int64_t const left = (std::max)(static_cast<int64_t>(value.length()) - length, static_cast<int64_t>(0));
+
+  return UnicodeToAqlValue(Substr(value, left, length));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function PERCENTILE
+/// @brief function SLICE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Percentile (triagens::aql::Query* query,
-                                triagens::arango::AqlTransaction* trx,
-                                FunctionParameters const& parameters) {
+AqlValue Functions::Slice (triagens::aql::Query* query,
+                           triagens::arango::AqlTransaction* trx,
+                           FunctionParameters const& parameters) {
   size_t const n = parameters.size();
-  if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "PERCENTILE", (int) 2, (int) 3);
+
+  if (n < 2 || n > 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "SLICE", (int) 2, (int) 3);
   }
 
   Json list = ExtractFunctionParameter(trx, parameters, 0, false);
 
   if (! list.isArray()) {
-    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+    RegisterWarning(query, "SLICE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
 
-  Json border = ExtractFunctionParameter(trx, parameters, 1, false);
+  int64_t const length = static_cast<int64_t>(list.size());
+  int64_t const offset = ExtractIntegerParameter(trx, parameters, 1);
+  int64_t from = offset;
+  int64_t to = length;
 
-  if (! border.isNumber()) {
-    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
+  if (n == 3 && ! ExtractFunctionParameter(trx, parameters, 2, false).isNull()) {
+    int64_t const count = ExtractIntegerParameter(trx, parameters, 2);
+    // a negative count is an end position from the back of the array,
+    // a positive count is the number of elements
+    to = (count < 0) ? count : offset + count;
   }
 
-  bool unused = false;
-  double p = ValueToNumber(border.json(), unused);
-  if (p <= 0 || p > 100) {
-    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
-  }
+  // Array.prototype.slice semantics
+  from = (from < 0) ? (std::max)(length + from, static_cast<int64_t>(0)) : (std::min)(from, length);
+  to = (to < 0) ? (std::max)(length + to, static_cast<int64_t>(0)) : (std::min)(to, length);
 
-  bool useInterpolation = false;
+  Json result(Json::Array, static_cast<size_t>(to > from ? to - from : 0));
 
-  if (n == 3) {
-    Json methodJson = ExtractFunctionParameter(trx, parameters, 2, false);
-    if (! methodJson.isString()) {
-      RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-      return AqlValue(new Json(Json::Null));
-    }
-    std::string method = triagens::basics::JsonHelper::getStringValue(methodJson.json(), "");
-    if (method == "interpolation") {
-      useInterpolation = true;
-    }
-    else if (method == "rank") {
-      useInterpolation = false;
-    }
-    else {
-      RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-      return AqlValue(new Json(Json::Null));
-    }
+  for (int64_t i = from; i < to; ++i) {
+    result.add(TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, list.at(static_cast<int>(i)).json()));
   }
 
-  std::vector<double> values;
-  if (! SortNumberList(list, values)) {
-    RegisterWarning(query, "PERCENTILE", TRI_ERROR_QUERY_INVALID_ARITHMETIC_VALUE);
-    return AqlValue(new Json(Json::Null));
-  }
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
+}
 
-  if (values.empty()) {
-    return AqlValue(new Json(Json::Null));
-  }
-  size_t l = values.size();
-  if (l == 1) {
-    return AqlValue(new Json(values[0]));
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function REVERSE
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue Functions::Reverse (triagens::aql::Query* query,
+                             triagens::arango::AqlTransaction* trx,
+                             FunctionParameters const& parameters) {
+  if (parameters.size() != 1) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "REVERSE", (int) 1, (int) 1);
   }
 
-  if (useInterpolation) {
-    double idx = p * (l + 1) / 100;
-    double pos = floor(idx);
+  Json value = ExtractFunctionParameter(trx, parameters, 0, false);
 
-    if (pos >= l) {
-      return AqlValue(new Json(values[l - 1]));
-    }
+  if (value.isString()) {
+    UnicodeString reversed = ExtractUnicodeParameter(trx, parameters, 0);
+    reversed.reverse();
+    return UnicodeToAqlValue(reversed);
+  }
 
-    double delta = idx - pos;
-    return AqlValue(new Json(delta * (values[pos] - values[pos - 1]) + values[pos - 1]));
+  if (! value.isArray()) {
+    RegisterWarning(query, "REVERSE", TRI_ERROR_QUERY_ARRAY_EXPECTED);
+    return AqlValue::CreateNull();
   }
-  double idx = p * l / 100;
-  double pos = ceil(idx);
-  if (pos >= l) {
-    return AqlValue(new Json(values[l - 1]));
+
+  size_t const length = value.size();
+  Json result(Json::Array, length);
+
+  for (size_t i = length; i > 0; --i) {
+    result.add(TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value.at(static_cast<int>(i - 1)).json()));
   }
-  return AqlValue(new Json(values[pos - 1]));
+
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief function RANGE
+/// @brief function TRANSLATE
 ////////////////////////////////////////////////////////////////////////////////
 
-AqlValue Functions::Range (triagens::aql::Query* query,
-                           triagens::arango::AqlTransaction* trx,
-                           FunctionParameters const& parameters) {
+AqlValue Functions::Translate (triagens::aql::Query* query,
+                               triagens::arango::AqlTransaction* trx,
+                               FunctionParameters const& parameters) {
   size_t const n = parameters.size();
 
-  if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "RANGE", (int) 2, (int) 3);
+  if (n < 2 || n > 3) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "TRANSLATE", (int) 2, (int) 3);
   }
 
-  auto const leftJson = ExtractFunctionParameter(trx, parameters, 0, false);
-  auto const rightJson = ExtractFunctionParameter(trx, parameters, 1, false);
-
-  bool unused = true;
-  double from = ValueToNumber(leftJson.json(), unused);
-  double to = ValueToNumber(rightJson.json(), unused);
+  Json lookup = ExtractFunctionParameter(trx, parameters, 1, false);
 
-  double step = 0;
-  if (n == 3) {
-    auto const stepJson = ExtractFunctionParameter(trx, parameters, 2, false);
-    step = ValueToNumber(stepJson.json(), unused);
-  }
-  if ( step == 0 ||
-      (from < to && step < 0) ||
-      (from > to && step > 0)) {
-    RegisterWarning(query, "RANGE", TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH);
-    return AqlValue(new Json(Json::Null));
-  }
-  Json result(Json::Array);
-  if (from < to) {
-    for (; from <= to; from += step) {
-      result.add(Json(from));
-    }
+  if (! lookup.isObject()) {
+    RegisterInvalidArgumentWarning(query, "TRANSLATE");
+    return AqlValue::CreateNull();
   }
-  else {
-    for (; from >= to; from += step) {
-      result.add(Json(from));
-    }
-  }
-  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, result.steal()));
-}
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief function POSITION
-////////////////////////////////////////////////////////////////////////////////
+  Json value = ExtractFunctionParameter(trx, parameters, 0, false);
 
-AqlValue Functions::Position (triagens::aql::Query* query,
-                              triagens::arango::AqlTransaction* trx,
-                              FunctionParameters const& parameters) {
-  size_t const n = parameters.size();
-  if (n != 2 && n != 3) {
-    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "POSITION", (int) 2, (int) 3);
-  }
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE, 24);
+  AppendAsString(buffer, value.json());
 
-  Json list = ExtractFunctionParameter(trx, parameters, 0, false);
+  TRI_json_t const* found = TRI_LookupObjectJson(lookup.json(), buffer.c_str());
 
-  if (! list.isArray()) {
-    RegisterWarning(query, "POSITION", TRI_ERROR_QUERY_ARRAY_EXPECTED);
-    return AqlValue(new Json(Json::Null));
+  if (found != nullptr) {
+    return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, found)));
   }
 
-  bool returnIndex = false;
   if (n == 3) {
-    Json returnIndexJson = ExtractFunctionParameter(trx, parameters, 2, false);
-    returnIndex = ValueToBoolean(returnIndexJson.json());
+    // return the default value
+    return AqlValue(new Json(ExtractFunctionParameter(trx, parameters, 2, true)));
   }
 
-  if (list.size() > 0) {
-    Json searchValue = ExtractFunctionParameter(trx, parameters, 1, false);
+  // return the original value
+  return AqlValue(new Json(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value.json())));
+}
 
-    size_t index;
-    if (ListContainsElement(list, searchValue, index)) {
-      if (returnIndex) {
-        return AqlValue(new Json(static_cast<double>(index)));
-      }
-      return AqlValue(new Json(true));
-    }
-  }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief function DATE_NOW
+////////////////////////////////////////////////////////////////////////////////
 
-  if (returnIndex) {
-    return AqlValue(new Json(-1));
+AqlValue Functions::DateNow (triagens::aql::Query*,
+                             triagens::arango::AqlTransaction*,
+                             FunctionParameters const& parameters) {
+  if (! parameters.empty()) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "DATE_NOW", (int) 0, (int) 0);
   }
-  return AqlValue(new Json(false));
+
+  // milliseconds since the epoch, as Date.now() did
+  return AqlValue::CreateNumber(floor(TRI_microtime() * 1000.0));
 }
 
 
@@ -0,0 +1,370 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, hash join execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/HashJoinBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/Collection.h"
+#include "Aql/CollectionScanner.h"
+#include "Aql/ExecutionEngine.h"
+#include "Basics/Exceptions.h"
+#include "VocBase/vocbase.h"
+
+using namespace std;
+using namespace triagens::arango;
+using namespace triagens::aql;
+
+using Json = triagens::basics::Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class HashJoinBlock
+// -----------------------------------------------------------------------------
+
+HashJoinBlock::HashJoinBlock (ExecutionEngine* engine,
+                              HashJoinNode const* ep)
+  : ExecutionBlock(engine, ep),
+    _collection(ep->_collection),
+    _document(nullptr),
+    _attributePath(ep->_attributePath),
+    _keyRegister(ExecutionNode::MaxRegisterId),
+    _table(),
+    _tableBuilt(false),
+    _matches(nullptr),
+    _posInMatches(0),
+    _mustStoreResult(true),
+    _stringBuffer(TRI_UNKNOWN_MEM_ZONE) {
+
+  auto it = ep->getRegisterPlan()->varInfo.find(ep->_keyVariable->id);
+
+  if (it == ep->getRegisterPlan()->varInfo.end()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "variable not found");
+  }
+
+  _keyRegister = (*it).second.registerId;
+  TRI_ASSERT(_keyRegister < ExecutionNode::MaxRegisterId);
+
+  auto trxCollection = _trx->trxCollection(_collection->cid());
+  if (trxCollection != nullptr) {
+    _trx->orderDitch(trxCollection);
+  }
+}
+
+HashJoinBlock::~HashJoinBlock () {
+  clearTable();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the join key from a document
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue HashJoinBlock::extractKey (TRI_doc_mptr_copy_t const& mptr) {
+  AqlValue const document(reinterpret_cast<TRI_df_marker_t const*>(mptr.getDataPtr()));
+
+  AqlValue key(new Json(document.extractObjectMember(_trx, _document, _attributePath[0].c_str(), true, _stringBuffer)));
+
+  for (size_t i = 1; i < _attributePath.size(); ++i) {
+    // descend into sub-attributes. non-object values produce null,
+    // the same as in an attribute access
+    AqlValue sub(new Json(key.extractObjectMember(_trx, nullptr, _attributePath[i].c_str(), true, _stringBuffer)));
+    key.destroy();
+    key = sub;
+  }
+
+  return key;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the hash table from the collection
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::buildTable () {
+  TRI_ASSERT(! _tableBuilt);
+
+  auto trxCollection = _trx->trxCollection(_collection->cid());
+  _document = _trx->documentCollection(_collection->cid());
+
+  LinearCollectionScanner scanner(_trx, trxCollection);
+  std::vector<TRI_doc_mptr_copy_t> documents;
+
+  while (true) {
+    throwIfKilled(); // check if we were aborted
+
+    documents.clear();
+    int res = scanner.scan(documents, DefaultBatchSize);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    if (documents.empty()) {
+      break;
+    }
+
+    _engine->_stats.scannedFull += static_cast<int64_t>(documents.size());
+
+    for (auto const& mptr : documents) {
+      AqlValue key = extractKey(mptr);
+
+      try {
+        uint64_t const hash = key.hash(_trx, nullptr);
+        auto& bucket = _table[hash];
+        bool found = false;
+
+        for (auto& entry : bucket) {
+          if (AqlValue::Compare(_trx, entry.key, nullptr, key, nullptr, false) == 0) {
+            entry.documents.emplace_back(mptr);
+            found = true;
+            break;
+          }
+        }
+
+        if (found) {
+          key.destroy();
+        }
+        else {
+          bucket.emplace_back(KeyEntry{ key, std::vector<TRI_doc_mptr_copy_t>{ mptr } });
+          // key is now owned by the table
+        }
+      }
+      catch (...) {
+        key.destroy();
+        throw;
+      }
+    }
+  }
+
+  _tableBuilt = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the hash table
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::clearTable () {
+  for (auto& it : _table) {
+    for (auto& entry : it.second) {
+      entry.key.destroy();
+    }
+  }
+  _table.clear();
+  _tableBuilt = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the documents matching the key of the current input row
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::probe (AqlItemBlock const* cur) {
+  static std::vector<TRI_doc_mptr_copy_t> const NoMatches;
+
+  if (! _tableBuilt) {
+    buildTable();
+  }
+
+  AqlValue const& value = cur->getValueReference(_pos, _keyRegister);
+  TRI_document_collection_t const* collection = cur->getDocumentCollection(_keyRegister);
+
+  _matches = &NoMatches;
+  _posInMatches = 0;
+
+  auto it = _table.find(value.hash(_trx, collection));
+
+  if (it == _table.end()) {
+    return;
+  }
+
+  for (auto const& entry : (*it).second) {
+    if (AqlValue::Compare(_trx, value, collection, entry.key, nullptr, false) == 0) {
+      _matches = &entry.documents;
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinBlock::nextRow (AqlItemBlock* cur) {
+  _matches = nullptr;
+  _posInMatches = 0;
+
+  if (++_pos >= cur->size()) {
+    _buffer.pop_front();  // does not throw
+    returnBlock(cur);
+    _pos = 0;
+  }
+}
+
+int HashJoinBlock::initialize () {
+  auto ep = static_cast<HashJoinNode const*>(_exeNode);
+  _mustStoreResult = ep->isVarUsedLater(ep->_outVariable);
+
+  return ExecutionBlock::initialize();
+}
+
+int HashJoinBlock::initializeCursor (AqlItemBlock* items,
+                                     size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // the hash table is kept, only the probe state is reset
+  _matches = nullptr;
+  _posInMatches = 0;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* HashJoinBlock::getSome (size_t, // atLeast,
+                                      size_t atMost) {
+  if (_done) {
+    return nullptr;
+  }
+
+  while (true) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(DefaultBatchSize, atMost);
+      if (! ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        return nullptr;
+      }
+      _pos = 0;           // this is in the first block
+      _matches = nullptr;
+    }
+
+    // if we make it here, then _buffer.front() exists
+    AqlItemBlock* cur = _buffer.front();
+
+    if (_matches == nullptr) {
+      probe(cur);
+    }
+
+    if (_posInMatches >= _matches->size()) {
+      // no (more) matches for this row
+      nextRow(cur);
+      continue;
+    }
+
+    size_t const curRegs = cur->getNrRegs();
+    size_t const toSend = (std::min)(atMost, _matches->size() - _posInMatches);
+    RegisterId nrRegs = getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()];
+
+    std::unique_ptr<AqlItemBlock> res(requestBlock(toSend, nrRegs));
+    // automatically freed if we throw
+    TRI_ASSERT(curRegs <= res->getNrRegs());
+
+    // only copy 1st row of registers inherited from previous frame(s)
+    inheritRegisters(cur, res.get(), _pos);
+
+    // set our collection for our output register
+    res->setDocumentCollection(static_cast<triagens::aql::RegisterId>(curRegs), _document);
+
+    for (size_t j = 0; j < toSend; j++) {
+      if (j > 0) {
+        // re-use already copied aqlvalues
+        for (RegisterId i = 0; i < curRegs; i++) {
+          res->setValue(j, i, res->getValueReference(0, i));
+          // Note: if this throws, then all values will be deleted
+          // properly since the first one is.
+        }
+      }
+
+      if (_mustStoreResult) {
+        res->setShaped(j,
+                       static_cast<triagens::aql::RegisterId>(curRegs),
+                       reinterpret_cast<TRI_df_marker_t const*>((*_matches)[_posInMatches].getDataPtr()));
+      }
+
+      ++_posInMatches;
+    }
+
+    if (_posInMatches >= _matches->size()) {
+      nextRow(cur);
+    }
+
+    // Clear out registers no longer needed later:
+    clearRegisters(res.get());
+
+    return res.release();
+  }
+}
+
+size_t HashJoinBlock::skipSome (size_t atLeast, size_t atMost) {
+  size_t skipped = 0;
+
+  if (_done) {
+    return skipped;
+  }
+
+  while (skipped < atLeast) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(DefaultBatchSize, atMost);
+      if (! ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        return skipped;
+      }
+      _pos = 0;           // this is in the first block
+      _matches = nullptr;
+    }
+
+    // if we make it here, then _buffer.front() exists
+    AqlItemBlock* cur = _buffer.front();
+
+    if (_matches == nullptr) {
+      probe(cur);
+    }
+
+    size_t const available = _matches->size() - _posInMatches;
+
+    if (available > atMost - skipped) {
+      _posInMatches += atMost - skipped;
+      skipped = atMost;
+    }
+    else {
+      skipped += available;
+      nextRow(cur);
+    }
+  }
+
+  return skipped;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, hash join execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_HASH_JOIN_BLOCK_H
+#define ARANGODB_AQL_HASH_JOIN_BLOCK_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/HashJoinNode.h"
+#include "Basics/StringBuffer.h"
+#include "VocBase/document-collection.h"
+
+struct TRI_document_collection_t;
+
+namespace triagens {
+  namespace aql {
+
+    class AqlItemBlock;
+    struct Collection;
+    class ExecutionEngine;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class HashJoinBlock
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash join block
+///
+/// on first use, the block builds a hash table from all documents of the
+/// collection, keyed by the value of the join attribute. for each input row,
+/// the table is probed with the value of the key register, and one output
+/// row is produced for each matching document. the table is kept until the
+/// block is destroyed, so it is built only once even if the block is used
+/// inside a subquery
+////////////////////////////////////////////////////////////////////////////////
+
+    class HashJoinBlock : public ExecutionBlock {
+
+      public:
+
+        HashJoinBlock (ExecutionEngine* engine,
+                       HashJoinNode const* ep);
+
+        ~HashJoinBlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize
+////////////////////////////////////////////////////////////////////////////////
+
+        int initialize () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSome (size_t atLeast, size_t atMost) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+// skip between atLeast and atMost, returns the number actually skipped . . .
+// will only return less than atLeast if there aren't atLeast many
+// things to skip overall.
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSome (size_t atLeast, size_t atMost) override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a distinct join key and the documents that have it
+////////////////////////////////////////////////////////////////////////////////
+
+        struct KeyEntry {
+          AqlValue key;
+          std::vector<TRI_doc_mptr_copy_t> documents;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extract the join key from a document. the result is owned by the
+/// caller
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue extractKey (TRI_doc_mptr_copy_t const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the hash table from the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildTable ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the hash table
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearTable ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the documents matching the key of the current input row
+////////////////////////////////////////////////////////////////////////////////
+
+        void probe (AqlItemBlock const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+        void nextRow (AqlItemBlock*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection
+////////////////////////////////////////////////////////////////////////////////
+
+        Collection const* _collection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the collection's underlying document collection
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_document_collection_t const* _document;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief attribute path of the join key
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const _attributePath;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief register containing the probe value
+////////////////////////////////////////////////////////////////////////////////
+
+        RegisterId _keyRegister;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the hash table, mapping the hash of a key to the distinct keys
+/// with this hash value
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<uint64_t, std::vector<KeyEntry>> _table;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the hash table was built
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _tableBuilt;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief documents matching the current input row, nullptr if the row
+/// was not probed yet
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_doc_mptr_copy_t> const* _matches;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current position in _matches
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _posInMatches;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the out variable is used later
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _mustStoreResult;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief buffer for extracting system attributes
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::StringBuffer _stringBuffer;
+
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, hash join node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/HashJoinNode.h"
+#include "Aql/Ast.h"
+#include "Aql/Collection.h"
+#include "Aql/ExecutionPlan.h"
+
+using namespace std;
+using namespace triagens::basics;
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           methods of HashJoinNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor for HashJoinNode from Json
+////////////////////////////////////////////////////////////////////////////////
+
+HashJoinNode::HashJoinNode (ExecutionPlan* plan,
+                            triagens::basics::Json const& json)
+  : ExecutionNode(plan, json),
+    _vocbase(plan->getAst()->query()->vocbase()),
+    _collection(plan->getAst()->query()->collections()->get(JsonHelper::checkAndGetStringValue(json.json(), "collection"))),
+    _outVariable(varFromJson(plan->getAst(), json, "outVariable")),
+    _keyVariable(varFromJson(plan->getAst(), json, "keyVariable")),
+    _attributePath(JsonHelper::stringArray(JsonHelper::checkAndGetArrayValue(json.json(), "attributePath"))) {
+
+  if (_attributePath.empty()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid attribute path for HashJoinNode");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toJson, for HashJoinNode
+////////////////////////////////////////////////////////////////////////////////
+
+void HashJoinNode::toJsonHelper (triagens::basics::Json& nodes,
+                                 TRI_memory_zone_t* zone,
+                                 bool verbose) const {
+  triagens::basics::Json json(ExecutionNode::toJsonHelperGeneric(nodes, zone, verbose));
+  // call base class method
+
+  if (json.isEmpty()) {
+    return;
+  }
+
+  triagens::basics::Json attributePath(triagens::basics::Json::Array, _attributePath.size());
+  for (auto const& it : _attributePath) {
+    attributePath.add(triagens::basics::Json(it));
+  }
+
+  // Now put info about vocbase and cid in there
+  json("database",      triagens::basics::Json(_vocbase->_name))
+      ("collection",    triagens::basics::Json(_collection->getName()))
+      ("outVariable",   _outVariable->toJson())
+      ("keyVariable",   _keyVariable->toJson())
+      ("attributePath", attributePath);
+
+  // And add it:
+  nodes(json);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+ExecutionNode* HashJoinNode::clone (ExecutionPlan* plan,
+                                    bool withDependencies,
+                                    bool withProperties) const {
+  auto outVariable = _outVariable;
+  auto keyVariable = _keyVariable;
+
+  if (withProperties) {
+    outVariable = plan->getAst()->variables()->createVariable(outVariable);
+    keyVariable = plan->getAst()->variables()->createVariable(keyVariable);
+  }
+
+  auto c = new HashJoinNode(plan, _id, _vocbase, _collection,
+                            outVariable, keyVariable, _attributePath);
+
+  cloneHelper(c, plan, withDependencies, withProperties);
+
+  return static_cast<ExecutionNode*>(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cost of a hash join node is the cost of building the hash
+/// table from the collection once plus the cost of one probe per incoming
+/// item. building the table is weighted higher than scanning, so that of
+/// two join orders the one with the smaller build side wins
+////////////////////////////////////////////////////////////////////////////////
+
+double HashJoinNode::estimateCost (size_t& nrItems) const {
+  size_t incoming = 0;
+  double const dependencyCost = _dependencies.at(0)->getCost(incoming);
+  size_t const itemsInCollection = _collection->count();
+
+  // we assume every probe finds one matching document on average
+  nrItems = (itemsInCollection == 0) ? 0 : incoming;
+  return dependencyCost + 3.0 * static_cast<double>(itemsInCollection) + static_cast<double>(incoming);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, hash join node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_HASH_JOIN_NODE_H
+#define ARANGODB_AQL_HASH_JOIN_NODE_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/types.h"
+#include "Aql/Variable.h"
+#include "Basics/JsonHelper.h"
+#include "VocBase/voc-types.h"
+#include "VocBase/vocbase.h"
+
+namespace triagens {
+  namespace aql {
+    struct Collection;
+    class ExecutionBlock;
+    class ExecutionPlan;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class HashJoinNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief class HashJoinNode
+///
+/// the node replaces a full collection scan that is the inner side of an
+/// equi-join. it produces only those documents of the collection whose
+/// attribute <_attributePath> is equal to the value of <_keyVariable>.
+/// the key variable must be computed before the node, i.e. by the outer
+/// side of the join
+////////////////////////////////////////////////////////////////////////////////
+
+    class HashJoinNode : public ExecutionNode {
+
+      friend class ExecutionBlock;
+      friend class HashJoinBlock;
+
+      public:
+
+        HashJoinNode (ExecutionPlan* plan,
+                      size_t id,
+                      TRI_vocbase_t* vocbase,
+                      Collection const* collection,
+                      Variable const* outVariable,
+                      Variable const* keyVariable,
+                      std::vector<std::string> const& attributePath)
+          : ExecutionNode(plan, id),
+            _vocbase(vocbase),
+            _collection(collection),
+            _outVariable(outVariable),
+            _keyVariable(keyVariable),
+            _attributePath(attributePath) {
+
+          TRI_ASSERT(_vocbase != nullptr);
+          TRI_ASSERT(_collection != nullptr);
+          TRI_ASSERT(_outVariable != nullptr);
+          TRI_ASSERT(_keyVariable != nullptr);
+          TRI_ASSERT(! _attributePath.empty());
+        }
+
+        HashJoinNode (ExecutionPlan*, triagens::basics::Json const& base);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the type of the node
+////////////////////////////////////////////////////////////////////////////////
+
+        NodeType getType () const override final {
+          return HASH_JOIN;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the database
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_vocbase_t* vocbase () const {
+          return _vocbase;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        Collection const* collection () const {
+          return _collection;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return out variable
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* outVariable () const {
+          return _outVariable;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the variable that contains the probe value
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* keyVariable () const {
+          return _keyVariable;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the attribute path of the join key in the collection
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const& attributePath () const {
+          return _attributePath;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief export to JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        void toJsonHelper (triagens::basics::Json&,
+                           TRI_memory_zone_t*,
+                           bool) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNode* clone (ExecutionPlan* plan,
+                              bool withDependencies,
+                              bool withProperties) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesSetHere
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesSetHere () const override final {
+          return std::vector<Variable const*>{ _outVariable };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, returning a vector
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesUsedHere () const override final {
+          return std::vector<Variable const*>{ _keyVariable };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, modifying the set in-place
+////////////////////////////////////////////////////////////////////////////////
+
+        void getVariablesUsedHere (std::unordered_set<Variable const*>& vars) const override final {
+          vars.emplace(_keyVariable);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimateCost
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimateCost (size_t&) const override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the database
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_vocbase_t* _vocbase;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection
+////////////////////////////////////////////////////////////////////////////////
+
+        Collection const* _collection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief output variable
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* _outVariable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief variable containing the probe value
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* _keyVariable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief attribute path of the join key in the collection's documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const _attributePath;
+
+    };
+
+  }   // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
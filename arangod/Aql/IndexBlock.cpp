@@ -35,8 +35,12 @@
 #include "Basics/ScopeGuard.h"
 #include "Basics/json-utilities.h"
 #include "Basics/Exceptions.h"
+#include "Indexes/FulltextIndex.h"
+#include "Indexes/GeoIndex2.h"
 #include "Indexes/IndexIterator.h"
+#include "Indexes/Index.h"
 #include "V8/v8-globals.h"
+#include "VocBase/VocShaper.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -62,16 +66,64 @@ IndexBlock::IndexBlock (ExecutionEngine* engine,
                         IndexNode const* en)
   : ExecutionBlock(engine, en),
     _collection(en->collection()),
+    _projections(en->projections()),
+    _projectionPositions(),
+    _projected(),
+    _shaper(nullptr),
     _posInDocs(0),
     _currentIndex(0),
     _indexes(en->getIndexes()),
     _context(nullptr),
     _iterator(nullptr),
     _condition(en->_condition->root()),
+    _intersection(),
+    _hasIntersection(false),
+    _useUnion(false),
     _hasV8Expression(false) {
 
   _context = new IndexIteratorContext(en->_vocbase);
 
+  if (_indexes.size() > 1) {
+    _useUnion = true;
+    for (auto const& index : _indexes) {
+      if (index->isSorted()) {
+        _useUnion = false;
+        break;
+      }
+    }
+  }
+
+  if (! _projections.empty()) {
+    // determine where the projected attributes are stored in the elements
+    // of each index
+    for (auto const& index : _indexes) {
+      std::vector<size_t> positions;
+
+      for (auto const& projection : _projections) {
+        size_t const n = index->fields.size();
+        size_t i = 0;
+
+        for (; i < n; ++i) {
+          auto const& field = index->fields[i];
+
+          if (field.size() == 1 && ! field[0].shouldExpand && field[0].name == projection) {
+            break;
+          }
+        }
+
+        if (i == n) {
+          THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "projected attribute not covered by index");
+        }
+
+        positions.emplace_back(i);
+      }
+
+      _projectionPositions.emplace_back(std::move(positions));
+    }
+
+    _shaper = _trx->documentCollection(_collection->cid())->getShaper();
+  }
+
   auto trxCollection = _trx->trxCollection(_collection->cid());
 
   if (trxCollection != nullptr) {
@@ -80,6 +132,7 @@ IndexBlock::IndexBlock (ExecutionEngine* engine,
 }
 
 IndexBlock::~IndexBlock () {
+  clearProjected();
   delete _iterator;
   delete _context;
 
@@ -255,7 +308,10 @@ bool IndexBlock::initIndexes () {
     TRI_ASSERT(_condition != nullptr);
 
     if (_hasV8Expression) {
-      bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster();
+      // in the cluster and for streaming cursors, the next batch may be
+      // requested from a different thread
+      bool const isRunningInCluster = triagens::arango::ServerState::instance()->isRunningInCluster() ||
+                                      _engine->getQuery()->isStreaming();
 
       // must have a V8 context here to protect Expression::execute()
       auto engine = _engine;
@@ -267,10 +323,8 @@ bool IndexBlock::initIndexes () {
           if (isRunningInCluster) {
             // must invalidate the expression now as we might be called from
             // different threads
-            if (triagens::arango::ServerState::instance()->isRunningInCluster()) {
-              for (auto const& e : _nonConstExpressions) {
-                e->expression->invalidate();
-              }
+            for (auto const& e : _nonConstExpressions) {
+              e->expression->invalidate();
             }
           
             engine->getQuery()->exitContext(); 
@@ -345,14 +399,97 @@ triagens::arango::IndexIterator* IndexBlock::createIterator () {
   auto outVariable = node->outVariable();
   auto ast = node->_plan->getAst();
 
+  if (node->isNear()) {
+    // the documents of the geo index, nearest to the point first
+    TRI_ASSERT(_indexes[_currentIndex]->type == triagens::arango::Index::TRI_IDX_TYPE_GEO1_INDEX ||
+               _indexes[_currentIndex]->type == triagens::arango::Index::TRI_IDX_TYPE_GEO2_INDEX);
+    _hasIntersection = false;
+    auto index = static_cast<triagens::arango::GeoIndex2 const*>(_indexes[_currentIndex]->getInternals());
+    return index->nearIterator(node->nearLatitude(), node->nearLongitude());
+  }
+
+  if (node->isFulltext()) {
+    // the documents of the fulltext index matching the query
+    TRI_ASSERT(_indexes[_currentIndex]->type == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX);
+    _hasIntersection = false;
+    auto index = static_cast<triagens::arango::FulltextIndex const*>(_indexes[_currentIndex]->getInternals());
+    return index->queryIterator(node->fulltextQuery());
+  }
+
   if (_condition == nullptr) {
+    _hasIntersection = false;
     return _indexes[_currentIndex]->getIterator(_context, ast, nullptr, outVariable, node->_reverse);
   }
 
+  buildIntersection();
+
   TRI_ASSERT(_indexes.size() == _condition->numMembers());
   return _indexes[_currentIndex]->getIterator(_context, ast, _condition->getMember(_currentIndex), outVariable, node->_reverse);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the indexes intersected with the current index
+/// all documents found by these indexes are collected and sorted by address,
+/// so checking whether a document of the current index is in all of them is
+/// a binary search. the conditions of these indexes are constant, but they
+/// are looked up again for each input row, as the collection may have been
+/// modified by the query in between
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexBlock::buildIntersection () {
+  _intersection.clear();
+  _hasIntersection = false;
+
+  IndexNode const* node = static_cast<IndexNode const*>(getPlanNode());
+  auto const& intersections = node->intersections();
+
+  if (_currentIndex >= intersections.size() || intersections[_currentIndex].empty()) {
+    return;
+  }
+
+  auto outVariable = node->outVariable();
+  auto ast = node->_plan->getAst();
+  bool isFirst = true;
+
+  for (auto const& it : intersections[_currentIndex]) {
+    std::vector<TRI_doc_mptr_t*> found;
+    std::unique_ptr<triagens::arango::IndexIterator> iterator(it.first->getIterator(_context, ast, it.second, outVariable, false));
+
+    if (iterator != nullptr) {
+      while (true) {
+        TRI_doc_mptr_t* mptr = iterator->next();
+
+        if (mptr == nullptr) {
+          break;
+        }
+        found.emplace_back(mptr);
+      }
+    }
+
+    _engine->_stats.scannedIndex += static_cast<int64_t>(found.size());
+    std::sort(found.begin(), found.end());
+
+    if (isFirst) {
+      found.erase(std::unique(found.begin(), found.end()), found.end());
+      _intersection = std::move(found);
+      isFirst = false;
+    }
+    else {
+      std::vector<TRI_doc_mptr_t*> result;
+      std::set_intersection(_intersection.begin(), _intersection.end(),
+                            found.begin(), found.end(),
+                            std::back_inserter(result));
+      _intersection = std::move(result);
+    }
+
+    if (_intersection.empty()) {
+      break;
+    }
+  }
+
+  _hasIntersection = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Forwards _iterator to the next available index
 ////////////////////////////////////////////////////////////////////////////////
@@ -395,12 +532,17 @@ bool IndexBlock::readIndex (size_t atMost) {
   else { 
     _documents.clear();
   }
+  clearProjected();
 
   if (_iterator == nullptr) {
     // All indexes exhausted
     return false;
   }
 
+  if (_useUnion) {
+    return readIndexUnion();
+  }
+
   size_t lastIndexNr = _indexes.size() - 1;
   bool isReverse = (static_cast<IndexNode const*>(getPlanNode()))->_reverse;
   bool isLastIndex = (_currentIndex == lastIndexNr && ! isReverse) || (_currentIndex == 0 && isReverse);
@@ -415,12 +557,33 @@ bool IndexBlock::readIndex (size_t atMost) {
         TRI_IF_FAILURE("IndexBlock::readIndex") {
           THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
         }
-        if (_alreadyReturned.find(indexElement) == _alreadyReturned.end()) {
+        // the set is only filled if several indexes are used
+        if (isInIntersection(indexElement) &&
+            (_alreadyReturned.empty() ||
+             _alreadyReturned.find(indexElement) == _alreadyReturned.end())) {
           if (! isLastIndex) {
             _alreadyReturned.emplace(indexElement);
           }
 
           _documents.emplace_back(*indexElement);
+
+          if (! _projections.empty()) {
+            try {
+              AqlValue value = buildProjection(_iterator->element(), indexElement);
+
+              try {
+                _projected.emplace_back(value);
+              }
+              catch (...) {
+                value.destroy();
+                throw;
+              }
+            }
+            catch (...) {
+              _documents.pop_back();
+              throw;
+            }
+          }
           ++nrSent;
         }
         ++_engine->_stats.scannedIndex;
@@ -438,6 +601,88 @@ bool IndexBlock::readIndex (size_t atMost) {
   LEAVE_BLOCK;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the documents of all indexes at once
+/// this is used instead of readIndex if several unsorted indexes are used.
+/// instead of remembering each returned document in a hash set, the
+/// documents of all indexes are sorted by address, and duplicates are
+/// adjacent then
+////////////////////////////////////////////////////////////////////////////////
+
+bool IndexBlock::readIndexUnion () {
+  std::vector<std::pair<TRI_doc_mptr_t*, AqlValue>> found;
+
+  auto cleanup = [&found] () -> void {
+    for (auto& it : found) {
+      it.second.destroy();
+    }
+  };
+
+  try {
+    while (_iterator != nullptr) {
+      TRI_doc_mptr_t* mptr = _iterator->next();
+
+      if (mptr == nullptr) {
+        startNextIterator();
+        continue;
+      }
+
+      ++_engine->_stats.scannedIndex;
+
+      if (! isInIntersection(mptr)) {
+        continue;
+      }
+
+      AqlValue value;
+      if (! _projections.empty()) {
+        value = buildProjection(_iterator->element(), mptr);
+      }
+
+      try {
+        found.emplace_back(mptr, value);
+      }
+      catch (...) {
+        value.destroy();
+        throw;
+      }
+    }
+
+    std::sort(found.begin(), found.end(), [] (std::pair<TRI_doc_mptr_t*, AqlValue> const& lhs,
+                                              std::pair<TRI_doc_mptr_t*, AqlValue> const& rhs) {
+      return lhs.first < rhs.first;
+    });
+
+    _documents.reserve(found.size());
+    if (! _projections.empty()) {
+      _projected.reserve(found.size());
+    }
+
+    for (size_t i = 0; i < found.size(); ++i) {
+      if (i > 0 && found[i].first == found[i - 1].first) {
+        // found by more than one index
+        continue;
+      }
+
+      _documents.emplace_back(*found[i].first);
+
+      if (! _projections.empty()) {
+        _projected.emplace_back(found[i].second);
+        // the value is now owned by _projected
+        found[i].second.erase();
+      }
+    }
+  }
+  catch (...) {
+    cleanup();
+    throw;
+  }
+
+  cleanup();
+
+  _posInDocs = 0;
+  return (! _documents.empty());
+}
+
 int IndexBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   ENTER_BLOCK;
   int res = ExecutionBlock::initializeCursor(items, pos);
@@ -529,9 +774,10 @@ AqlItemBlock* IndexBlock::getSome (size_t atLeast,
       // only copy 1st row of registers inherited from previous frame(s)
       inheritRegisters(cur, res.get(), _pos);
 
-      // set our collection for our output register
+      // set our collection for our output register. the values built in
+      // an index-only scan are not documents
       res->setDocumentCollection(static_cast<triagens::aql::RegisterId>(curRegs),
-          _trx->documentCollection(_collection->cid()));
+          _projections.empty() ? _trx->documentCollection(_collection->cid()) : nullptr);
 
       for (size_t j = 0; j < toSend; j++) {
         if (j > 0) {
@@ -546,6 +792,14 @@ AqlItemBlock* IndexBlock::getSome (size_t atLeast,
         // The result is in the first variable of this depth,
         // we do not need to do a lookup in getPlanNode()->_registerPlan->varInfo,
         // but can just take cur->getNrRegs() as registerId:
+        if (! _projections.empty()) {
+          res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs),
+                        _projected[_posInDocs]);
+          // the value is now owned by the result block
+          _projected[_posInDocs++].erase();
+          continue;
+        }
+
         res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs),
                       AqlValue(reinterpret_cast<TRI_df_marker_t
                                const*>(_documents[_posInDocs++].getDataPtr())));
@@ -626,6 +880,66 @@ size_t IndexBlock::skipSome (size_t atLeast,
   return skipped; 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the result of an index-only scan from an index element
+/// values of up to 8 bytes (null, booleans, numbers and short strings) are
+/// stored inline in the index element. for all other values, the element
+/// only contains their position in the document's shaped json
+////////////////////////////////////////////////////////////////////////////////
+
+AqlValue IndexBlock::buildProjection (TRI_index_element_t const* element,
+                                      TRI_doc_mptr_t const* mptr) const {
+  if (element == nullptr) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "index iterator does not provide index elements");
+  }
+
+  TRI_ASSERT(_currentIndex < _projectionPositions.size());
+  auto const& positions = _projectionPositions[_currentIndex];
+  TRI_ASSERT(positions.size() == _projections.size());
+
+  auto subObjects = element->subObjects();
+  std::unique_ptr<Json> result(new Json(Json::Object, _projections.size()));
+
+  for (size_t i = 0; i < _projections.size(); ++i) {
+    TRI_shaped_sub_t const* sub = &subObjects[positions[i]];
+
+    // only touch the document if the value is not stored in the element
+    char const* shapedJson = nullptr;
+    if (sub->_sid > BasicShapes::TRI_SHAPE_SID_SHORT_STRING) {
+      shapedJson = mptr->getShapedJsonPtr();  // ONLY IN INDEX
+    }
+
+    TRI_shaped_json_t shaped;
+    shaped._sid = sub->_sid;
+    TRI_InspectShapedSub(sub, shapedJson, shaped);
+
+    TRI_json_t* value = TRI_JsonShapedJson(_shaper, &shaped);
+
+    if (value == nullptr) {
+      value = TRI_CreateNullJson(TRI_UNKNOWN_MEM_ZONE);
+
+      if (value == nullptr) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+      }
+    }
+
+    result->set(_projections[i].c_str(), value);
+  }
+
+  return AqlValue(result.release());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the values built in an index-only scan
+////////////////////////////////////////////////////////////////////////////////
+
+void IndexBlock::clearProjected () {
+  for (auto& it : _projected) {
+    it.destroy();
+  }
+  _projected.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief frees the memory for all non-constant expressions
 ////////////////////////////////////////////////////////////////////////////////
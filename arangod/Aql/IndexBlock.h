@@ -38,6 +38,8 @@
 struct TRI_doc_mptr_copy_t;
 struct TRI_edge_index_iterator_t;
 struct TRI_hash_index_element_multi_s;
+struct TRI_index_element_t;
+class VocShaper;
 
 namespace triagens {
   namespace arango {
@@ -164,6 +166,42 @@ namespace triagens {
 
         bool readIndex (size_t atMost);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read the documents of all indexes at once, and make them unique
+/// by sorting them by address
+////////////////////////////////////////////////////////////////////////////////
+
+        bool readIndexUnion ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief look up the indexes intersected with the current index
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildIntersection ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a document of the current index passes the
+/// intersection with the other indexes
+////////////////////////////////////////////////////////////////////////////////
+
+        inline bool isInIntersection (TRI_doc_mptr_t* mptr) const {
+          return (! _hasIntersection ||
+                  std::binary_search(_intersection.begin(), _intersection.end(), mptr));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the result of an index-only scan from an index element
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlValue buildProjection (TRI_index_element_t const*,
+                                  TRI_doc_mptr_t const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the values built in an index-only scan
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearProjected ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief frees the memory for all non-constant expressions
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,6 +226,32 @@ namespace triagens {
 
         std::vector<TRI_doc_mptr_copy_t> _documents;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes produced in an index-only scan. empty if the block
+/// produces complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const _projections;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief for each index, the positions of the projected attributes in the
+/// index elements
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::vector<size_t>> _projectionPositions;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief values built in an index-only scan, parallel to _documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<AqlValue> _projected;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the shaper of the collection, used in index-only scans
+////////////////////////////////////////////////////////////////////////////////
+
+        VocShaper* _shaper;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief current position in _allDocs
 ////////////////////////////////////////////////////////////////////////////////
@@ -253,6 +317,27 @@ namespace triagens {
         
         std::unordered_set<TRI_doc_mptr_t*> _alreadyReturned;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief documents found by the indexes intersected with the current index,
+/// sorted by address
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_doc_mptr_t*> _intersection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the current index is intersected with others
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _hasIntersection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the results of several indexes are united by
+/// sorting them by address. this is only done if the order of the results
+/// does not matter, i.e. if none of the indexes is sorted
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _useUnion;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not at least one expression uses v8
 ////////////////////////////////////////////////////////////////////////////////
@@ -69,6 +69,40 @@ void IndexNode::toJsonHelper (triagens::basics::Json& nodes,
   json("condition", _condition->toJson(TRI_UNKNOWN_MEM_ZONE, verbose)); 
   json("reverse",   triagens::basics::Json(_reverse));
 
+  if (! _projections.empty()) {
+    triagens::basics::Json projections(triagens::basics::Json::Array, _projections.size());
+    for (auto const& it : _projections) {
+      projections.add(triagens::basics::Json(it));
+    }
+    json("projections", projections);
+  }
+
+  if (! _intersections.empty()) {
+    triagens::basics::Json intersections(triagens::basics::Json::Array, _intersections.size());
+    for (auto const& it : _intersections) {
+      triagens::basics::Json intersection(triagens::basics::Json::Array, it.size());
+      for (auto const& part : it) {
+        triagens::basics::Json entry(triagens::basics::Json::Object, 2);
+        entry("index",     part.first->toJson())
+             ("condition", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, part.second->toJson(TRI_UNKNOWN_MEM_ZONE, verbose)));
+        intersection.add(entry);
+      }
+      intersections.add(intersection);
+    }
+    json("intersections", intersections);
+  }
+
+  if (_isNear) {
+    triagens::basics::Json near(triagens::basics::Json::Object, 2);
+    near("latitude",  triagens::basics::Json(_nearLatitude))
+        ("longitude", triagens::basics::Json(_nearLongitude));
+    json("near", near);
+  }
+
+  if (_isFulltext) {
+    json("fulltext", triagens::basics::Json(_fulltextQuery));
+  }
+
   // And add it:
   nodes(json);
 }
@@ -84,6 +118,13 @@ ExecutionNode* IndexNode::clone (ExecutionPlan* plan,
 
   auto c = new IndexNode(plan, _id, _vocbase, _collection, 
                          outVariable, _indexes, _condition->clone(), _reverse);
+  c->_projections = _projections;
+  c->_intersections = _intersections;
+  c->_isNear = _isNear;
+  c->_nearLatitude = _nearLatitude;
+  c->_nearLongitude = _nearLongitude;
+  c->_isFulltext = _isFulltext;
+  c->_fulltextQuery = _fulltextQuery;
 
   cloneHelper(c, plan, withDependencies, withProperties);
 
@@ -102,7 +143,14 @@ IndexNode::IndexNode (ExecutionPlan* plan,
     _outVariable(varFromJson(plan->getAst(), json, "outVariable")),
     _indexes(),
     _condition(nullptr),
-    _reverse(JsonHelper::checkAndGetBooleanValue(json.json(), "reverse")) { 
+    _reverse(JsonHelper::checkAndGetBooleanValue(json.json(), "reverse")),
+    _projections(),
+    _intersections(),
+    _isNear(false),
+    _nearLatitude(0.0),
+    _nearLongitude(0.0),
+    _isFulltext(false),
+    _fulltextQuery() { 
 
   auto indexes = JsonHelper::checkAndGetArrayValue(json.json(), "indexes");
 
@@ -127,6 +175,70 @@ IndexNode::IndexNode (ExecutionPlan* plan,
   _condition = Condition::fromJson(plan, conditionJson);
 
   TRI_ASSERT(_condition != nullptr);
+
+  auto projections = TRI_LookupObjectJson(json.json(), "projections");
+
+  if (TRI_IsArrayJson(projections)) {
+    size_t const n = TRI_LengthArrayJson(projections);
+    _projections.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      auto projection = TRI_LookupArrayJson(projections, i);
+
+      if (! TRI_IsStringJson(projection)) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid projection");
+      }
+
+      _projections.emplace_back(projection->_value._string.data, projection->_value._string.length - 1);
+    }
+  }
+
+  auto intersections = TRI_LookupObjectJson(json.json(), "intersections");
+
+  if (TRI_IsArrayJson(intersections)) {
+    size_t const n = TRI_LengthArrayJson(intersections);
+    _intersections.resize(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      auto intersection = TRI_LookupArrayJson(intersections, i);
+
+      if (! TRI_IsArrayJson(intersection)) {
+        THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid intersection");
+      }
+
+      size_t const m = TRI_LengthArrayJson(intersection);
+
+      for (size_t j = 0; j < m; ++j) {
+        auto entry = TRI_LookupArrayJson(intersection, j);
+        auto iid = JsonHelper::checkAndGetStringValue(JsonHelper::checkAndGetObjectValue(entry, "index"), "id");
+        auto index = _collection->getIndex(iid);
+
+        if (index == nullptr) {
+          THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "index not found");
+        }
+
+        triagens::basics::Json conditionJson(TRI_UNKNOWN_MEM_ZONE, JsonHelper::checkAndGetObjectValue(entry, "condition"), triagens::basics::Json::NOFREE);
+        // the node is registered with the query and freed by it
+        auto ast = plan->getAst();
+        _intersections[i].emplace_back(index, new (ast->query()->arena()) AstNode(ast, conditionJson));
+      }
+    }
+  }
+
+  auto near = TRI_LookupObjectJson(json.json(), "near");
+
+  if (TRI_IsObjectJson(near)) {
+    _isNear = true;
+    _nearLatitude = JsonHelper::checkAndGetNumericValue<double>(near, "latitude");
+    _nearLongitude = JsonHelper::checkAndGetNumericValue<double>(near, "longitude");
+  }
+
+  auto fulltext = TRI_LookupObjectJson(json.json(), "fulltext");
+
+  if (TRI_IsStringJson(fulltext)) {
+    _isFulltext = true;
+    _fulltextQuery = std::string(fulltext->_value._string.data, fulltext->_value._string.length - 1);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
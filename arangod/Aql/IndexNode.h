@@ -30,6 +30,7 @@
 
 #include "Basics/Common.h"
 #include "Aql/Ast.h"
+#include "Aql/Condition.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/types.h"
 #include "Aql/Variable.h"
@@ -70,7 +71,14 @@ namespace triagens {
             _outVariable(outVariable),
             _indexes(indexes),
             _condition(condition),
-            _reverse(reverse) {
+            _reverse(reverse),
+            _projections(),
+            _intersections(),
+            _isNear(false),
+            _nearLatitude(0.0),
+            _nearLongitude(0.0),
+            _isFulltext(false),
+            _fulltextQuery() {
           
           TRI_ASSERT(_vocbase != nullptr);
           TRI_ASSERT(_collection != nullptr);
@@ -130,6 +138,101 @@ namespace triagens {
           return _reverse;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief access all indexes in reverse order
+////////////////////////////////////////////////////////////////////////////////
+
+        void setReverse (bool reverse) {
+          _reverse = reverse;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes that are produced from the index entries in an
+/// index-only scan. if empty, the node produces complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const& projections () const {
+          return _projections;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turn the node into an index-only scan producing the given attributes
+////////////////////////////////////////////////////////////////////////////////
+
+        void setProjections (std::vector<std::string> const& projections) {
+          _projections = projections;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the indexes intersected with each of the node's indexes. either
+/// empty, or one (possibly empty) entry per index
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<IndexIntersection> const& intersections () const {
+          return _intersections;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the indexes intersected with each of the node's indexes
+////////////////////////////////////////////////////////////////////////////////
+
+        void setIntersections (std::vector<IndexIntersection> const& intersections) {
+          TRI_ASSERT(intersections.empty() || intersections.size() == _indexes.size());
+          _intersections = intersections;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the node returns the documents of its geo index nearest to
+/// a point first
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isNear () const {
+          return _isNear;
+        }
+
+        double nearLatitude () const {
+          return _nearLatitude;
+        }
+
+        double nearLongitude () const {
+          return _nearLongitude;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the documents of the geo index nearest to the point first
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNear (double latitude,
+                      double longitude) {
+          TRI_ASSERT(_indexes.size() == 1);
+          _isNear = true;
+          _nearLatitude = latitude;
+          _nearLongitude = longitude;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the node returns the documents of its fulltext index
+/// matching a query
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isFulltext () const {
+          return _isFulltext;
+        }
+
+        std::string const& fulltextQuery () const {
+          return _fulltextQuery;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the documents of the fulltext index matching the query
+////////////////////////////////////////////////////////////////////////////////
+
+        void setFulltext (std::string const& query) {
+          TRI_ASSERT(_indexes.size() == 1);
+          _isFulltext = true;
+          _fulltextQuery = query;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief export to JSON
 ////////////////////////////////////////////////////////////////////////////////
@@ -222,6 +325,36 @@ namespace triagens {
 
         bool _reverse;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes produced in an index-only scan
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _projections;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the indexes intersected with each of the node's indexes
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<IndexIntersection> _intersections;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the point the documents are ordered by their distance to, if any
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _isNear;
+
+        double _nearLatitude;
+
+        double _nearLongitude;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the query the documents of the fulltext index must match, if any
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _isFulltext;
+
+        std::string _fulltextQuery;
+
     };
 
   }   // namespace triagens::aql
@@ -41,6 +41,12 @@ using namespace triagens::aql;
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents an UPSERT inserts with one WAL write
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const UpsertBatchSize = 1000;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                           class ModificationBlock
 // -----------------------------------------------------------------------------
@@ -767,6 +773,47 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
   if (ep->_outVariableNew != nullptr) {
     result->setDocumentCollection(_outRegNew, trxCollection->_collection->_collection);
   }
+
+  // documents to insert and their rows. consecutive inserts into a document
+  // collection are collected and written with one WAL write. they are written
+  // before any other row is processed, so that writes and errors happen in
+  // the order of the rows
+  std::vector<std::pair<size_t, Json>> pendingInserts;
+
+  auto flushInserts = [&] () -> void {
+    if (pendingInserts.empty()) {
+      return;
+    }
+
+    std::vector<TRI_json_t const*> jsons;
+    jsons.reserve(pendingInserts.size());
+
+    for (auto const& pending : pendingInserts) {
+      jsons.emplace_back(pending.second.json());
+    }
+
+    std::vector<TRI_doc_mptr_copy_t> mptrs;
+    std::vector<int> results;
+    _trx->create(trxCollection, jsons, mptrs, results, ep->_options.waitForSync);
+
+    std::vector<size_t> rows;
+    rows.reserve(pendingInserts.size());
+
+    for (auto const& pending : pendingInserts) {
+      rows.emplace_back(pending.first);
+    }
+    pendingInserts.clear();
+
+    for (size_t j = 0; j < rows.size(); ++j) {
+      if (producesOutput && results[j] == TRI_ERROR_NO_ERROR) {
+        result->setValue(rows[j],
+                         _outRegNew,
+                         AqlValue(reinterpret_cast<TRI_df_marker_t const*>(mptrs[j].getDataPtr())));
+      }
+
+      handleResult(results[j], ep->_options.ignoreErrors, &errorMessage);
+    }
+  };
          
   // loop over all blocks
   size_t dstRow = 0;
@@ -793,6 +840,12 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
         
       int errorCode = TRI_ERROR_NO_ERROR;
 
+      if (a.isObject() || 
+          isEdgeCollection ||
+          pendingInserts.size() >= UpsertBatchSize) {
+        flushInserts();
+      }
+
       if (a.isObject()) {
 
         // old document present => update case
@@ -898,7 +951,7 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
           }
 
           if (errorCode == TRI_ERROR_NO_ERROR) {
-            auto const insertJson = insertDoc.toJson(_trx, insertDocument, true);
+            auto insertJson = insertDoc.toJson(_trx, insertDocument, true);
 
             // use default value
             errorCode = TRI_ERROR_OUT_OF_MEMORY;
@@ -908,6 +961,12 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
               if (_isDBServer && isShardKeyError(insertJson.json())) {
                 errorCode = TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
               }
+              else if (! isEdgeCollection) {
+                // document, written together with the following inserts
+                pendingInserts.emplace_back(dstRow, std::move(insertJson));
+                ++dstRow;
+                continue;
+              }
               else {
                 TRI_doc_mptr_copy_t mptr;
 
@@ -938,6 +997,9 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
 
       }
 
+      // results of earlier rows first
+      flushInserts();
+
       handleResult(errorCode, ep->_options.ignoreErrors, &errorMessage);
       ++dstRow; 
     }
@@ -948,6 +1010,8 @@ AqlItemBlock* UpsertBlock::work (std::vector<AqlItemBlock*>& blocks) {
     delete res;
   }
 
+  flushInserts();
+
   return result.release();
 }
 
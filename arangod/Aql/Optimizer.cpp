@@ -26,8 +26,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Aql/Optimizer.h"
+#include "Aql/Ast.h"
+#include "Aql/Collection.h"
+#include "Aql/Collections.h"
 #include "Aql/ExecutionEngine.h"
 #include "Aql/OptimizerRules.h"
+#include "Aql/Query.h"
 #include "Cluster/ServerState.h"
 
 using namespace triagens::aql;
@@ -136,7 +140,6 @@ int Optimizer::createPlans (ExecutionPlan* plan,
     return TRI_ERROR_NO_ERROR;
   }
 
-  bool runOnlyRequiredRules = false;
   int leastDoneLevel = 0;
 
   TRI_ASSERT(! _rules.empty());
@@ -196,10 +199,9 @@ int Optimizer::createPlans (ExecutionPlan* plan,
         level = (*it).first;
         auto& rule = (*it).second;
 
-        if ((runOnlyRequiredRules || disabledIds.find(level) != disabledIds.end()) &&
+        if (disabledIds.find(level) != disabledIds.end() &&
             rule.canBeDisabled) {
-          // we picked a disabled rule or we have reached the max number of plans
-          // and just skip this rule
+          // we picked a disabled rule and just skip this rule
 
           _newPlans.push_back(p, level);  // nothing to do, just keep it
 
@@ -222,10 +224,13 @@ int Optimizer::createPlans (ExecutionPlan* plan,
           // - if the rule throws, then the original plan will be deleted by the optimizer.
           //   thus the rule must not have deleted the plan itself or add it back to the
           //   optimizer
+          double const start = TRI_microtime();
+
           res = rule.func(this, p, &rule);
 
           if (! rule.isHidden) {
             ++_stats.rulesExecuted;
+            _stats.ruleTimes[level] += TRI_microtime() - start;
           }
         }
         catch (...) {
@@ -241,9 +246,6 @@ int Optimizer::createPlans (ExecutionPlan* plan,
         }
       }
 
-      // future optimization: abort early here if we found a good-enough plan
-      // a good-enough plan is probably every plan with costs below some
-      // defined threshold. this requires plan costs to be calculated here
     }
 
     _plans.steal(_newPlans);
@@ -255,17 +257,19 @@ int Optimizer::createPlans (ExecutionPlan* plan,
     }
     // std::cout << "Least done level is " << leastDoneLevel << std::endl;
 
-    // Stop if the result gets out of hand:
-    if (! runOnlyRequiredRules &&
-        _plans.size() >= _maxNumberOfPlans) {
-      // must still iterate over all REQUIRED remaining transformation rules 
-      // because there are some rules which are required to make the query
-      // work in cluster mode etc
-      runOnlyRequiredRules = true;
+    // Prune if the result gets out of hand:
+    if (_plans.size() >= _maxNumberOfPlans) {
+      // the costs of the partially optimized plans are a good enough guess
+      // for their final costs. only the cheapest plans are optimized further,
+      // with all remaining rules. the costs stay cached in the plans, and
+      // are only invalidated for the plans a rule modifies
+      estimatePlans();
+      size_t const pruned = _plans.keepCheapest((std::max)(static_cast<size_t>(1), _maxNumberOfPlans / 4));
+      _stats.plansPruned += static_cast<int64_t>(pruned);
     }
   }
   
-  _stats.plansCreated = _plans.size();
+  _stats.plansCreated = static_cast<int64_t>(_plans.size()) + _stats.plansPruned;
   
   TRI_ASSERT(_plans.size() >= 1);
 
@@ -326,10 +330,87 @@ char const* Optimizer::translateRule (int rule) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void Optimizer::estimatePlans () {
-  for (auto& p : _plans.list) {
-    p->getCost();
-    // this value is cached in the plan, so formally this step is
-    // unnecessary, but for the sake of cleanliness...
+  size_t const n = _plans.size();
+
+  if (n == 0) {
+    return;
+  }
+
+  // the first plan is estimated by this thread. this fills the caches the
+  // plans share, e.g. the document counts of the collections, the indexes
+  // and the flags of the shared AST nodes, so that the other plans only
+  // read them
+  auto collections = _plans.list[0]->getAst()->query()->collections()->collections();
+
+  for (auto const& it : *collections) {
+    it.second->count();
+  }
+
+  _plans.list[0]->getCost();
+
+  size_t numThreads = (std::min)(n / MinPlansPerEstimationThread,
+                                 static_cast<size_t>(std::thread::hardware_concurrency()));
+  if (numThreads > MaxEstimationThreads) {
+    numThreads = MaxEstimationThreads;
+  }
+
+  if (numThreads <= 1) {
+    for (auto& p : _plans.list) {
+      p->getCost();
+      // this value is cached in the plan, so formally this step is
+      // unnecessary, but for the sake of cleanliness...
+    }
+    return;
+  }
+
+  // each plan is estimated by exactly one thread, the plans do not share
+  // their nodes
+  std::atomic<size_t> next(1);
+  std::exception_ptr error;
+  triagens::basics::Mutex errorLock;
+
+  auto estimator = [&] () -> void {
+    while (true) {
+      size_t const i = next.fetch_add(1, std::memory_order_relaxed);
+
+      if (i >= n) {
+        return;
+      }
+
+      try {
+        _plans.list[i]->getCost();
+      }
+      catch (...) {
+        MUTEX_LOCKER(errorLock);
+
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        // the remaining plans are estimated anyway, the error wins
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(numThreads - 1);
+
+  try {
+    for (size_t i = 1; i < numThreads; ++i) {
+      threads.emplace_back(std::thread(estimator));
+    }
+  }
+  catch (...) {
+    // the remaining plans are estimated by this thread
+  }
+
+  estimator();
+
+  for (auto& it : threads) {
+    it.join();
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
   }
 }
 
@@ -571,6 +652,14 @@ void Optimizer::setupRules () {
                removeRedundantOrRule_pass6,
                true);
   
+  if (! triagens::arango::ServerState::instance()->isCoordinator()) {
+    // try to read the documents matching FULLTEXT_MATCH() from a fulltext index
+    registerRule("use-fulltext-index",
+                 useFulltextIndexRule,
+                 useFulltextIndexRule_pass6,
+                 true);
+  }
+
   // try to find a filter after an enumerate collection and find indexes
   registerRule("use-indexes",
                useIndexesRule,
@@ -589,6 +678,33 @@ void Optimizer::setupRules () {
                useIndexForSortRule_pass6,
                true);
 
+  if (! triagens::arango::ServerState::instance()->isCoordinator()) {
+    // try to read the documents nearest to a point first from a geo index
+    registerRule("use-geo-index-for-sort",
+                 useGeoIndexForSortRule,
+                 useGeoIndexForSortRule_pass6,
+                 true);
+
+    // try to produce index lookup results from the index entries only
+    registerRule("use-index-only",
+                 useIndexOnlyRule,
+                 useIndexOnlyRule_pass6,
+                 true);
+
+    // try to replace full collection scans in equi-joins with hash joins
+    registerRule("use-hash-joins",
+                 useHashJoinsRule,
+                 useHashJoinsRule_pass6,
+                 true);
+
+    // stream the paths of TRAVERSE() in FOR loops instead of building them
+    // all up front
+    registerRule("use-native-traversal",
+                 useNativeTraversalRule,
+                 useNativeTraversalRule_pass6,
+                 true);
+  }
+
   // finally, push calculations as far down as possible
   registerRule("move-calculations-down",
                moveCalculationsDownRule,
@@ -609,6 +725,14 @@ void Optimizer::setupRules () {
                patchUpdateStatementsRule_pass9,
                true);
 
+  if (! triagens::arango::ServerState::instance()->isCoordinator()) {
+    // cache the results of subqueries that are executed repeatedly
+    registerRule("cache-subquery-results",
+                 cacheSubqueryResultsRule,
+                 cacheSubqueryResultsRule_pass9,
+                 true);
+  }
+
   if (triagens::arango::ServerState::instance()->isCoordinator()) {
     // distribute operations in cluster
     registerRule("scatter-in-cluster",
@@ -627,10 +751,25 @@ void Optimizer::setupRules () {
                  distributeFilternCalcToClusterRule_pass10,
                  true);
 
+    registerRule("colocate-joins-in-cluster",
+                 colocateJoinsInClusterRule,
+                 colocateJoinsInClusterRule_pass10,
+                 true);
+
     registerRule("distribute-sort-to-cluster",
                  distributeSortToClusterRule,
                  distributeSortToClusterRule_pass10,
                  true);
+
+    registerRule("distribute-collect-to-cluster",
+                 distributeCollectToClusterRule,
+                 distributeCollectToClusterRule_pass10,
+                 true);
+
+    registerRule("distribute-limit-to-cluster",
+                 distributeLimitToClusterRule,
+                 distributeLimitToClusterRule_pass10,
+                 true);
     
     registerRule("remove-unnecessary-remote-scatter",
                  removeUnnecessaryRemoteScatterRule,
@@ -642,6 +781,16 @@ void Optimizer::setupRules () {
                  undistributeRemoveAfterEnumCollRule_pass10,
                  true);
 
+    registerRule("restrict-to-single-shard",
+                 restrictToSingleShardRule,
+                 restrictToSingleShardRule_pass10,
+                 true);
+
+    registerRule("reduce-extraction-to-projection",
+                 reduceExtractionToProjectionRule,
+                 reduceExtractionToProjectionRule_pass10,
+                 true);
+
   }
 }
 
@@ -52,9 +52,13 @@ namespace triagens {
         int64_t rulesExecuted = 0;
         int64_t rulesSkipped  = 0;
         int64_t plansCreated  = 1; // 1 for the initial plan
+        int64_t plansPruned   = 0;
+
+        // seconds spent in each executed rule, by rule level
+        std::map<int, double> ruleTimes;
 
         TRI_json_t* toJson (TRI_memory_zone_t* zone) const {
-          TRI_json_t* stats = TRI_CreateObjectJson(zone, 3);
+          TRI_json_t* stats = TRI_CreateObjectJson(zone, 5);
 
           if (stats == nullptr) {
             return nullptr;
@@ -63,6 +67,21 @@ namespace triagens {
           TRI_Insert3ObjectJson(zone, stats, "rulesExecuted", TRI_CreateNumberJson(zone, static_cast<double>(rulesExecuted)));
           TRI_Insert3ObjectJson(zone, stats, "rulesSkipped", TRI_CreateNumberJson(zone, static_cast<double>(rulesSkipped)));
           TRI_Insert3ObjectJson(zone, stats, "plansCreated", TRI_CreateNumberJson(zone, static_cast<double>(plansCreated)));
+          TRI_Insert3ObjectJson(zone, stats, "plansPruned", TRI_CreateNumberJson(zone, static_cast<double>(plansPruned)));
+
+          TRI_json_t* rules = TRI_CreateObjectJson(zone, ruleTimes.size());
+
+          if (rules != nullptr) {
+            for (auto const& it : ruleTimes) {
+              char const* name = translateRule(it.first);
+
+              if (name != nullptr) {
+                TRI_Insert3ObjectJson(zone, rules, name, TRI_CreateNumberJson(zone, it.second));
+              }
+            }
+
+            TRI_Insert3ObjectJson(zone, stats, "rules", rules);
+          }
 
           return stats;
         }
@@ -182,6 +201,9 @@ namespace triagens {
         
         // remove redundant OR conditions
         removeRedundantOrRule_pass6                   = 820,
+
+        // read the documents matching FULLTEXT_MATCH() from a fulltext index
+        useFulltextIndexRule_pass6                    = 825,
         
         useIndexesRule_pass6                          = 830,
         
@@ -191,6 +213,18 @@ namespace triagens {
         // try to find sort blocks which are superseeded by indexes
         useIndexForSortRule_pass6                     = 850,
 
+        // read the documents nearest to a point first from a geo index
+        useGeoIndexForSortRule_pass6                  = 852,
+
+        // produce index lookup results from the index entries only
+        useIndexOnlyRule_pass6                        = 855,
+
+        // replace full collection scans in equi-joins with hash joins
+        useHashJoinsRule_pass6                        = 860,
+
+        // stream the paths of TRAVERSE() in FOR loops
+        useNativeTraversalRule_pass6                  = 870,
+
 //////////////////////////////////////////////////////////////////////////////
 /// Pass 9: push down calculations beyond FILTERs and LIMITs
 //////////////////////////////////////////////////////////////////////////////
@@ -209,6 +243,12 @@ namespace triagens {
         
         patchUpdateStatementsRule_pass9               = 902,
 
+//////////////////////////////////////////////////////////////////////////////
+/// Pass 9: cache subquery results
+//////////////////////////////////////////////////////////////////////////////
+
+        cacheSubqueryResultsRule_pass9                = 903,
+
 //////////////////////////////////////////////////////////////////////////////
 /// "Pass 10": final transformations for the cluster
 //////////////////////////////////////////////////////////////////////////////
@@ -224,16 +264,35 @@ namespace triagens {
         // distributed to the cluster nodes.
         distributeFilternCalcToClusterRule_pass10     = 1020,
 
+        // execute joins of co-located collections on the DB servers
+        colocateJoinsInClusterRule_pass10             = 1025,
+
         // move SortNodes into the distribution.
         // adjust gathernode to also contain the sort criteria.
         distributeSortToClusterRule_pass10            = 1030,
+
+        // split COLLECTs into a shard-local COLLECT and a COLLECT on the
+        // coordinator that merges the partial results
+        distributeCollectToClusterRule_pass10         = 1033,
+
+        // copy LIMITs into the distribution, so that each shard returns
+        // at most offset + count documents
+        distributeLimitToClusterRule_pass10           = 1036,
         
         // try to get rid of a RemoteNode->ScatterNode combination which has
         // only a SingletonNode and possibly some CalculationNodes as dependencies
         removeUnnecessaryRemoteScatterRule_pass10     = 1040,
 
         //recognize that a RemoveNode can be moved to the shards
-        undistributeRemoveAfterEnumCollRule_pass10    = 1050
+        undistributeRemoveAfterEnumCollRule_pass10    = 1050,
+
+        // restrict the access to a collection to a single shard if the
+        // filters fix the values of all shard keys
+        restrictToSingleShardRule_pass10              = 1060,
+
+        // make collection scans on the DB servers produce only the attributes
+        // that are used on the coordinator
+        reduceExtractionToProjectionRule_pass10       = 1070
       };
     
       public:
@@ -391,6 +450,47 @@ namespace triagens {
             b.levelDone.clear();
           }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keeps the n cheapest plans and deletes the others, returns the
+/// number of plans deleted. the costs of the plans must have been estimated
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t keepCheapest (size_t n) {
+            if (list.size() <= n) {
+              return 0;
+            }
+
+            std::vector<size_t> order;
+            order.reserve(list.size());
+
+            for (size_t i = 0; i < list.size(); ++i) {
+              order.emplace_back(i);
+            }
+
+            std::stable_sort(order.begin(), order.end(), [this] (size_t a, size_t b) -> bool {
+              return list[a]->getCost() < list[b]->getCost();
+            });
+
+            std::deque<ExecutionPlan*> keptList;
+            std::deque<int> keptLevels;
+
+            for (size_t i = 0; i < n; ++i) {
+              keptList.push_back(list[order[i]]);
+              keptLevels.push_back(levelDone[order[i]]);
+            }
+
+            size_t const pruned = list.size() - n;
+
+            for (size_t i = n; i < order.size(); ++i) {
+              delete list[order[i]];
+            }
+
+            list.swap(keptList);
+            levelDone.swap(keptLevels);
+
+            return pruned;
+          }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief appends all the plans to the target and clears *this at the same time
 ////////////////////////////////////////////////////////////////////////////////
@@ -573,6 +673,8 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief estimatePlans
+///
+/// the costs of many plans are estimated by several threads
 ////////////////////////////////////////////////////////////////////////////////
 
         void estimatePlans ();
@@ -689,6 +791,18 @@ namespace triagens {
 
         static size_t const DefaultMaxNumberOfPlans = 192;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimal number of plans per thread when estimating costs
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MinPlansPerEstimationThread = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of threads estimating costs
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxEstimationThreads = 4;
+
     };
 
   }  // namespace aql
@@ -34,14 +34,19 @@
 #include "Aql/ExecutionEngine.h"
 #include "Aql/ExecutionNode.h"
 #include "Aql/Function.h"
+#include "Aql/HashJoinNode.h"
 #include "Aql/Index.h"
 #include "Aql/IndexNode.h"
 #include "Aql/ModificationNodes.h"
 #include "Aql/SortCondition.h"
 #include "Aql/SortNode.h"
+#include "Aql/TraversalNode.h"
 #include "Aql/Variable.h"
+#include "Aql/WindowNode.h"
 #include "Aql/types.h"
 #include "Basics/json-utilities.h"
+#include "Cluster/ClusterInfo.h"
+#include "Indexes/GeoIndex2.h"
 
 using namespace triagens::aql;
 using Json = triagens::basics::Json;
@@ -153,6 +158,7 @@ int triagens::aql::removeRedundantSortsRule (Optimizer* opt,
           }
         }
         else if (current->getType() == EN::ENUMERATE_LIST ||
+                 current->getType() == EN::TRAVERSAL ||
                  current->getType() == EN::ENUMERATE_COLLECTION) {
           // ok, but we cannot remove two different sorts if one of these node types is between them
           // example: in the following query, the one sort will be optimized away:
@@ -847,7 +853,10 @@ int triagens::aql::removeSortRandRule (Optimizer* opt,
         case EN::FILTER: 
         case EN::SUBQUERY:
         case EN::ENUMERATE_LIST:
-        case EN::INDEX: { 
+        case EN::INDEX: 
+        case EN::WINDOW:
+        case EN::HASH_JOIN: 
+        case EN::TRAVERSAL: { 
           // if we found another SortNode, an AggregateNode, FilterNode, a SubqueryNode, 
           // an EnumerateListNode or an IndexNode
           // this means we cannot apply our optimization
@@ -1047,9 +1056,12 @@ int triagens::aql::moveCalculationsDownRule (Optimizer* opt,
         shouldMove = true;
       } 
       else if (currentType == EN::INDEX ||
+               currentType == EN::HASH_JOIN ||
                currentType == EN::ENUMERATE_COLLECTION ||
                currentType == EN::ENUMERATE_LIST ||
+               currentType == EN::TRAVERSAL ||
                currentType == EN::AGGREGATE ||
+               currentType == EN::WINDOW ||
                currentType == EN::NORESULTS) {
         // we will not push further down than such nodes
         shouldMove = false;
@@ -1230,9 +1242,16 @@ int triagens::aql::specializeCollectRule (Optimizer* opt,
       auto newCollectNode = static_cast<AggregateNode*>(newPlan->getNodeById(collectNode->id()));
       TRI_ASSERT(newCollectNode != nullptr);
       
-      // specialize the AggregateNode so it will become a HashAggregateBlock later
-      // additionally, add a SortNode BEHIND the AggregateNode (to sort the final result)
-      newCollectNode->aggregationMethod(AggregationOptions::AggregationMethod::AGGREGATION_METHOD_HASH);
+      // specialize the AggregateNode so it will become a HashAggregateBlock later,
+      // or a DistinctAggregateBlock if it only needs to produce the distinct
+      // values. additionally, add a SortNode BEHIND the AggregateNode (to sort
+      // the final result)
+      if (collectNode->hasOutVariable()) {
+        newCollectNode->aggregationMethod(AggregationOptions::AggregationMethod::AGGREGATION_METHOD_HASH);
+      }
+      else {
+        newCollectNode->aggregationMethod(AggregationOptions::AggregationMethod::AGGREGATION_METHOD_DISTINCT);
+      }
       newCollectNode->specialized();
 
       if (! collectNode->isDistinctCommand()) {
@@ -1401,8 +1420,9 @@ int triagens::aql::moveFiltersUpRule (Optimizer* opt,
       auto current = stack.back();
       stack.pop_back();
 
-      if (current->getType() == EN::LIMIT) {
-        // cannot push a filter beyond a LIMIT node
+      if (current->getType() == EN::LIMIT ||
+          current->getType() == EN::WINDOW) {
+        // cannot push a filter beyond a LIMIT or WINDOW node
         break;
       }
 
@@ -1500,6 +1520,11 @@ class triagens::aql::RedundantCalculationsReplacer final : public WalkerWorker<E
           replaceInVariable<EnumerateListNode>(en);
           break;
         }
+
+        case EN::TRAVERSAL: {
+          replaceInVariable<TraversalNode>(en);
+          break;
+        }
       
         case EN::RETURN: {
           replaceInVariable<ReturnNode>(en);
@@ -1532,6 +1557,14 @@ class triagens::aql::RedundantCalculationsReplacer final : public WalkerWorker<E
           break;
         }
 
+        case EN::WINDOW: {
+          auto node = static_cast<WindowNode*>(en);
+          for (auto& aggregate : node->_aggregates) {
+            aggregate.inVariable = Variable::replace(aggregate.inVariable, _replacements);
+          }
+          break;
+        }
+
         default: {
           // ignore all other types of nodes
         }
@@ -1782,6 +1815,58 @@ int triagens::aql::useIndexesRule (Optimizer* opt,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the positions of the index attributes that an index
+/// condition compares with == in its only OR branch. these attributes have
+/// the same value in all results of the index lookup. no attribute counts as
+/// fixed if there is an IN list, because the index looks up its values in
+/// the order of the list
+////////////////////////////////////////////////////////////////////////////////
+
+static std::unordered_set<size_t> EqualityFixedAttributes (Condition const* condition,
+                                                           Variable const* variable,
+                                                           std::vector<std::vector<triagens::basics::AttributeName>> const& fields) {
+  std::unordered_set<size_t> result;
+  auto root = condition->root();
+
+  if (root == nullptr || root->numMembers() != 1) {
+    return result;
+  }
+
+  auto andNode = root->getMember(0);
+  size_t const n = andNode->numMembers();
+
+  for (size_t i = 0; i < n; ++i) {
+    auto op = andNode->getMember(i);
+
+    if (op->type == NODE_TYPE_OPERATOR_BINARY_IN) {
+      result.clear();
+      break;
+    }
+
+    if (op->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+      continue;
+    }
+
+    for (size_t side = 0; side < 2; ++side) {
+      std::pair<Variable const*, std::vector<triagens::basics::AttributeName>> attributeData;
+
+      if (! op->getMember(side)->isAttributeAccessForVariable(attributeData) ||
+          attributeData.first != variable) {
+        continue;
+      }
+
+      for (size_t j = 0; j < fields.size(); ++j) {
+        if (triagens::basics::AttributeName::isIdentical(fields[j], attributeData.second)) {
+          result.emplace(j);
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
 struct SortToIndexNode final : public WalkerWorker<ExecutionNode> {
   ExecutionPlan*                                 _plan;
   SortNode*                                      _sortNode;
@@ -1950,6 +2035,25 @@ struct SortToIndexNode final : public WalkerWorker<ExecutionNode> {
           // sort condition is fully covered by index... now we can remove the sort node from the plan
           _plan->unlinkNode(_plan->getNodeById(_sortNode->id()));
           _modified = true;
+          return true;
+        }
+      }
+
+      if (indexes.size() == 1 &&
+          ! sortCondition.isEmpty() && 
+          sortCondition.isOnlyAttributeAccess() &&
+          sortCondition.isUnidirectional()) {
+        // the sort may leave out index attributes that the condition compares
+        // with ==, e.g. FILTER doc.a == 1 SORT doc.b for an index on [ a, b ].
+        // a single index can then also be read in the direction of the sort
+        Variable const* outVariable = indexNode->outVariable();
+        auto fixed = EqualityFixedAttributes(indexNode->condition(), outVariable, index->fields);
+
+        if (! fixed.empty() &&
+            sortCondition.coveredAttributes(outVariable, index->fields, fixed) == sortCondition.numAttributes()) {
+          indexNode->setReverse(sortCondition.isDescending());
+          _plan->unlinkNode(_plan->getNodeById(_sortNode->id()));
+          _modified = true;
         }
       }
 
@@ -1989,6 +2093,9 @@ struct SortToIndexNode final : public WalkerWorker<ExecutionNode> {
         case EN::GATHER:
         case EN::REMOTE:
         case EN::ILLEGAL:
+        case EN::WINDOW:
+        case EN::HASH_JOIN:
+        case EN::TRAVERSAL:
         case EN::LIMIT:                      // LIMIT is criterion to stop
           return true;  // abort.
 
@@ -2040,181 +2147,1168 @@ int triagens::aql::useIndexForSortRule (Optimizer* opt,
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief try to remove filters which are covered by indexes
+/// @brief checks if an argument of DISTANCE() can be read from a geo index
+/// on the variable. this is either an attribute, or the position 0 or 1 of a
+/// list attribute. position is set to -1 for an attribute
 ////////////////////////////////////////////////////////////////////////////////
 
-int triagens::aql::removeFiltersCoveredByIndexRule (Optimizer* opt,
-                                                    ExecutionPlan* plan,
-                                                    Optimizer::Rule const* rule) {
-  std::unordered_set<ExecutionNode*> toUnlink;
+static bool GeoIndexArgument (AstNode const* node,
+                              Variable const* variable,
+                              std::vector<triagens::basics::AttributeName>& attribute,
+                              int64_t& position) {
+  std::pair<Variable const*, std::vector<triagens::basics::AttributeName>> attributeData;
+  position = -1;
+
+  if (node->type == NODE_TYPE_INDEXED_ACCESS) {
+    auto index = node->getMember(1);
+
+    if (index->type != NODE_TYPE_VALUE || 
+        ! index->isIntValue()) {
+      return false;
+    }
+
+    position = index->getIntValue();
+
+    if (position != 0 && position != 1) {
+      return false;
+    }
+
+    node = node->getMember(0);
+  }
+
+  if (! node->isAttributeAccessForVariable(attributeData) ||
+      attributeData.first != variable) {
+    return false;
+  }
+
+  attribute = std::move(attributeData.second);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a geo index that provides the latitude and longitude
+/// arguments of DISTANCE()
+////////////////////////////////////////////////////////////////////////////////
+
+static Index const* FindGeoIndex (EnumerateCollectionNode const* node,
+                                  AstNode const* latitude,
+                                  AstNode const* longitude) {
+  Variable const* outVariable = node->outVariable();
+  std::vector<triagens::basics::AttributeName> latitudeAttribute;
+  std::vector<triagens::basics::AttributeName> longitudeAttribute;
+  int64_t latitudePosition;
+  int64_t longitudePosition;
+
+  if (! GeoIndexArgument(latitude, outVariable, latitudeAttribute, latitudePosition) ||
+      ! GeoIndexArgument(longitude, outVariable, longitudeAttribute, longitudePosition)) {
+    return nullptr;
+  }
+
+  for (auto const& index : node->collection()->getIndexes()) {
+    if (index->type == triagens::arango::Index::TRI_IDX_TYPE_GEO2_INDEX) {
+      // separate latitude and longitude attributes
+      if (latitudePosition == -1 &&
+          longitudePosition == -1 &&
+          index->fields.size() == 2 &&
+          triagens::basics::AttributeName::isIdentical(index->fields[0], latitudeAttribute) &&
+          triagens::basics::AttributeName::isIdentical(index->fields[1], longitudeAttribute)) {
+        return index;
+      }
+    }
+    else if (index->type == triagens::arango::Index::TRI_IDX_TYPE_GEO1_INDEX) {
+      // a list attribute, [ latitude, longitude ] or [ longitude, latitude ]
+      if (latitudePosition == -1 ||
+          longitudePosition == -1 ||
+          index->fields.size() != 1 ||
+          ! triagens::basics::AttributeName::isIdentical(index->fields[0], latitudeAttribute) ||
+          ! triagens::basics::AttributeName::isIdentical(index->fields[0], longitudeAttribute)) {
+        continue;
+      }
+
+      bool const geoJson = static_cast<triagens::arango::GeoIndex2 const*>(index->getInternals())->isGeoJson();
+
+      if (latitudePosition == (geoJson ? 1 : 0) &&
+          longitudePosition == (geoJson ? 0 : 1)) {
+        return index;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use a geo index for SORT DISTANCE(...) LIMIT ...
+///
+/// the sort must be ascending, on the result of DISTANCE() with the latitude
+/// and longitude of the documents covered by a geo index and a constant
+/// point. the full collection scan is then replaced by a scan of the geo
+/// index returning the documents nearest to the point first, and the sort
+/// is removed. the LIMIT stops the scan after the first documents. as with
+/// NEAR(), documents without valid coordinates are not returned
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useGeoIndexForSortRule (Optimizer* opt,
+                                           ExecutionPlan* plan,
+                                           Optimizer::Rule const* rule) {
   bool modified = false;
-  std::vector<ExecutionNode*>&& nodes= plan->findNodesOfType(EN::FILTER, true); 
-  
-  for (auto const& node : nodes) {
-    auto fn = static_cast<FilterNode const*>(node);
-    // find the node with the filter expression
-    auto inVar = fn->getVariablesUsedHere();
-    TRI_ASSERT(inVar.size() == 1);
-          
-    auto setter = plan->getVarSetBy(inVar[0]->id);
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::SORT, true);
+
+  for (auto const& n : nodes) {
+    auto sortNode = static_cast<SortNode*>(n);
+    auto const& elements = sortNode->getElements();
+
+    if (elements.size() != 1 || ! elements[0].second) {
+      // only a single ascending sort criterion can be produced by the index
+      continue;
+    }
+
+    // only worth it if the sort is followed by a LIMIT
+    ExecutionNode* parent = sortNode;
+
+    do {
+      auto parents = parent->getParents();
+      parent = (parents.size() == 1 ? parents[0] : nullptr);
+    }
+    while (parent != nullptr && parent->getType() == EN::CALCULATION);
+
+    if (parent == nullptr || parent->getType() != EN::LIMIT) {
+      continue;
+    }
+
+    auto sortVariable = elements[0].first;
+    auto setter = plan->getVarSetBy(sortVariable->id);
 
     if (setter == nullptr || setter->getType() != EN::CALCULATION) {
       continue;
     }
-        
-    auto calculationNode = static_cast<CalculationNode*>(setter);
-    auto conditionNode = calculationNode->expression()->node();
 
-    // build the filter condition 
-    std::unique_ptr<Condition> condition(new Condition(plan->getAst()));
-    condition->andCombine(conditionNode);
-    condition->normalize(plan);
+    auto funcNode = static_cast<CalculationNode*>(setter)->expression()->node();
 
-    if (condition->root() == nullptr) {
+    if (funcNode == nullptr ||
+        funcNode->type != NODE_TYPE_FCALL ||
+        static_cast<Function const*>(funcNode->getData())->externalName != "DISTANCE") {
       continue;
     }
 
-    size_t const n = condition->root()->numMembers();
+    auto args = funcNode->getMember(0);
 
-    if (n != 1) {
-      // either no condition or multiple ORed conditions...
+    if (args->type != NODE_TYPE_ARRAY || args->numMembers() != 4) {
       continue;
     }
 
-    bool handled = false;
-    auto current = node;
+    // find the collection scan the sort is applied to. nodes in between must
+    // not change the order of its documents
+    ExecutionNode* current = sortNode->getFirstDependency();
+
     while (current != nullptr) {
-      if (current->getType() == EN::INDEX) {
-        auto indexNode = static_cast<IndexNode const*>(current);
+      auto type = current->getType();
 
-        // found an index node, now check if the expression is covered by the index
-        auto indexCondition = indexNode->condition();
+      if (type != EN::CALCULATION &&
+          type != EN::FILTER &&
+          type != EN::SUBQUERY &&
+          type != EN::ENUMERATE_LIST) {
+        break;
+      }
 
-        if (indexCondition != nullptr && ! indexCondition->isEmpty()) {
-          auto const& indexesUsed = indexNode->getIndexes();
+      current = current->getFirstDependency();
+    }
 
-          if (indexesUsed.size() == 1) {
-            // single index. this is something that we can handle
+    if (current == nullptr || current->getType() != EN::ENUMERATE_COLLECTION) {
+      continue;
+    }
 
-            auto newNode = condition->removeIndexCondition(indexNode->outVariable(), indexCondition->root());
+    auto enumerateCollectionNode = static_cast<EnumerateCollectionNode*>(current);
 
-            if (newNode == nullptr) {
-              // no condition left...
-              // FILTER node can be completely removed
-              toUnlink.emplace(setter);
-              toUnlink.emplace(node);
-              modified = true;
-              handled = true;
-            }
-            else if (newNode != condition->root()) {
-              // some condition is left, but it is a different one than
-              // the one from the FILTER node
-              std::unique_ptr<Expression> expr(new Expression(plan->getAst(), newNode));
-              CalculationNode* cn = new CalculationNode(plan, plan->nextId(), expr.get(), calculationNode->outVariable());
-              expr.release();
-              plan->registerNode(cn);
-              plan->replaceNode(setter, cn);
-              modified = true;
-              handled = true;
-            }
-          }
-        }
+    if (enumerateCollectionNode->isInInnerLoop() || 
+        enumerateCollectionNode->isRandom()) {
+      continue;
+    }
 
-        if (handled) {
-          break;
-        }
-      }
+    // the point may be given as the first or as the second pair of arguments
+    Index const* index = nullptr;
+    AstNode const* latitude = nullptr;
+    AstNode const* longitude = nullptr;
 
-      if (handled) {
-        break;
-      }
+    for (size_t i = 0; i < 2 && index == nullptr; ++i) {
+      latitude = args->getMember(2 - 2 * i);
+      longitude = args->getMember(3 - 2 * i);
 
-      if (! current->hasDependency()) {
-        break;
+      if (latitude->type != NODE_TYPE_VALUE || ! latitude->isNumericValue() ||
+          longitude->type != NODE_TYPE_VALUE || ! longitude->isNumericValue()) {
+        continue;
       }
 
-      current = current->getFirstDependency();
+      index = FindGeoIndex(enumerateCollectionNode, args->getMember(2 * i), args->getMember(2 * i + 1));
     }
-  }
-  if (! toUnlink.empty()) {
-    plan->unlinkNodes(toUnlink);
+
+    if (index == nullptr) {
+      continue;
+    }
+
+    std::unique_ptr<Condition> condition(new Condition(plan->getAst()));
+    condition->normalize(plan);
+
+    std::unique_ptr<IndexNode> newNode(new IndexNode(
+      plan,
+      plan->nextId(),
+      enumerateCollectionNode->vocbase(),
+      enumerateCollectionNode->collection(),
+      enumerateCollectionNode->outVariable(),
+      std::vector<Index const*>({ index }),
+      condition.get(),
+      false
+    ));
+
+    condition.release();
+    newNode->setNear(latitude->getDoubleValue(), longitude->getDoubleValue());
+
+    auto indexNode = newNode.release();
+    plan->registerNode(indexNode);
+    plan->replaceNode(enumerateCollectionNode, indexNode);
+    plan->unlinkNode(sortNode);
     plan->findVarUsage();
+
+    if (! setter->isVarUsedLater(sortVariable)) {
+      // nobody else needs the distance
+      plan->unlinkNode(setter);
+      plan->findVarUsage();
+    }
+
+    modified = true;
   }
-  
+
   opt->addPlan(plan, rule, modified);
 
   return TRI_ERROR_NO_ERROR;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief helper to compute lots of permutation tuples
-/// a permutation tuple is represented as a single vector together with
-/// another vector describing the boundaries of the tuples.
-/// Example:
-/// data:   0,1,2, 3,4, 5,6
-/// starts: 0,     3,   5,      (indices of starts of sections)
-/// means a tuple of 3 permutations of 3, 2 and 2 points respectively
-/// This function computes the next permutation tuple among the 
-/// lexicographically sorted list of all such tuples. It returns true
-/// if it has successfully computed this and false if the tuple is already
-/// the lexicographically largest one. If false is returned, the permutation
-/// tuple is back to the beginning.
+/// @brief finds a call of FULLTEXT_MATCH() with an attribute and a constant
+/// query in a condition or in one of its AND-combined parts
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool NextPermutationTuple (std::vector<size_t>& data,
-                                  std::vector<size_t>& starts) {
-  auto begin = data.begin();  // a random access iterator
+static AstNode const* FindFulltextMatch (AstNode const* node) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND) {
+    for (size_t i = 0; i < 2; ++i) {
+      auto found = FindFulltextMatch(node->getMember(i));
 
-  for (size_t i = starts.size(); i-- != 0; ) {
-    std::vector<size_t>::iterator from = begin + starts[i];
-    std::vector<size_t>::iterator to;
-    if (i == starts.size() - 1) {
-      to = data.end();
-    }
-    else {
-      to = begin + starts[i + 1];
-    }
-    if (std::next_permutation(from, to)) {
-      return true;
+      if (found != nullptr) {
+        return found;
+      }
     }
+
+    return nullptr;
   }
 
-  return false;
+  if (node->type != NODE_TYPE_FCALL ||
+      static_cast<Function const*>(node->getData())->externalName != "FULLTEXT_MATCH") {
+    return nullptr;
+  }
+
+  auto args = node->getMember(0);
+
+  if (args->type != NODE_TYPE_ARRAY || 
+      args->numMembers() != 2 ||
+      ! args->getMember(0)->isAttributeAccessForVariable()) {
+    return nullptr;
+  }
+
+  auto query = args->getMember(1);
+
+  if (query->type != NODE_TYPE_VALUE || ! query->isStringValue()) {
+    return nullptr;
+  }
+
+  return node;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief interchange adjacent EnumerateCollectionNodes in all possible ways
+/// @brief removes a part from an AND-combined condition, returns the
+/// remaining condition or a nullptr if nothing remains
 ////////////////////////////////////////////////////////////////////////////////
 
-int triagens::aql::interchangeAdjacentEnumerationsRule (Optimizer* opt,
-                                                        ExecutionPlan* plan,
-                                                        Optimizer::Rule const* rule) {
-  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::ENUMERATE_COLLECTION, true);
+static AstNode const* RemoveConditionPart (Ast* ast,
+                                           AstNode const* node,
+                                           AstNode const* part) {
+  if (node == part) {
+    return nullptr;
+  }
 
-  std::unordered_set<ExecutionNode*> nodesSet;
-  for (auto const& n : nodes) {
-    TRI_ASSERT(nodesSet.find(n) == nodesSet.end());
-    nodesSet.emplace(n);
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_AND) {
+    return node;
   }
 
-  std::vector<ExecutionNode*> nodesToPermute;
-  std::vector<size_t> permTuple;
-  std::vector<size_t> starts;
+  auto lhs = RemoveConditionPart(ast, node->getMember(0), part);
+  auto rhs = RemoveConditionPart(ast, node->getMember(1), part);
 
-  // We use that the order of the nodes is such that a node B that is among the
-  // recursive dependencies of a node A is later in the vector.
-  for (auto const& n : nodes) {
-    if (nodesSet.find(n) != nodesSet.end()) {
-      std::vector<ExecutionNode*> nn{ n };
-      nodesSet.erase(n);
+  if (lhs == nullptr) {
+    return rhs;
+  }
 
-      // Now follow the dependencies as long as we see further such nodes:
-      auto nwalker = n;
+  if (rhs == nullptr) {
+    return lhs;
+  }
 
-      while (true) {
-        if (! nwalker->hasDependency()) {
-          break;
-        }
+  if (lhs == node->getMember(0) && rhs == node->getMember(1)) {
+    return node;
+  }
+
+  return ast->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_AND, lhs, rhs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a variable is used by no node but <user> between the node
+/// that sets it and the end of the plan
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsVariableOnlyUsedBy (ExecutionNode const* user,
+                                  ExecutionNode const* setter,
+                                  Variable const* variable) {
+  if (user->isVarUsedLater(variable)) {
+    return false;
+  }
+
+  ExecutionNode const* current = user->getFirstDependency();
+
+  while (current != nullptr && current != setter) {
+    for (auto const& it : current->getVariablesUsedHere()) {
+      if (it == variable) {
+        return false;
+      }
+    }
+
+    current = current->getFirstDependency();
+  }
+
+  return (current == setter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use a fulltext index for FILTER FULLTEXT_MATCH(...)
+///
+/// the first argument must be an attribute of the documents of a full
+/// collection scan that is covered by a fulltext index, and the query must
+/// be constant. the scan is then replaced by a lookup of the query in the
+/// fulltext index, and the call is removed from the filter. other parts of
+/// the filter condition stay, and are checked for the documents found. the
+/// documents found are read as they are needed, so a LIMIT after the filter
+/// stops before all matching documents have been read
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useFulltextIndexRule (Optimizer* opt,
+                                         ExecutionPlan* plan,
+                                         Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::FILTER, true);
+
+  for (auto const& n : nodes) {
+    auto filterNode = static_cast<FilterNode*>(n);
+    auto inVar = filterNode->getVariablesUsedHere();
+    TRI_ASSERT(inVar.size() == 1);
+
+    auto setter = plan->getVarSetBy(inVar[0]->id);
+
+    if (setter == nullptr || setter->getType() != EN::CALCULATION) {
+      continue;
+    }
+
+    auto calculationNode = static_cast<CalculationNode*>(setter);
+    auto root = calculationNode->expression()->node();
+    auto funcNode = FindFulltextMatch(root);
+
+    if (funcNode == nullptr) {
+      continue;
+    }
+
+    if (funcNode != root &&
+        ! IsVariableOnlyUsedBy(filterNode, setter, inVar[0])) {
+      // the rest of the condition is needed elsewhere
+      continue;
+    }
+
+    auto args = funcNode->getMember(0);
+    std::pair<Variable const*, std::vector<triagens::basics::AttributeName>> attributeData;
+
+    if (! args->getMember(0)->isAttributeAccessForVariable(attributeData)) {
+      continue;
+    }
+
+    auto scan = plan->getVarSetBy(attributeData.first->id);
+
+    if (scan == nullptr ||
+        scan->getType() != EN::ENUMERATE_COLLECTION ||
+        static_cast<EnumerateCollectionNode const*>(scan)->isRandom()) {
+      continue;
+    }
+
+    // the filter is moved to the scan. nodes in between must not depend on
+    // the documents that are filtered out
+    ExecutionNode* current = filterNode->getFirstDependency();
+
+    while (current != nullptr && current != scan) {
+      auto type = current->getType();
+
+      if (type != EN::CALCULATION &&
+          type != EN::FILTER &&
+          type != EN::SORT &&
+          type != EN::ENUMERATE_LIST &&
+          type != EN::ENUMERATE_COLLECTION &&
+          type != EN::INDEX) {
+        break;
+      }
+
+      current = current->getFirstDependency();
+    }
+
+    if (current != scan) {
+      continue;
+    }
+
+    auto enumerateCollectionNode = static_cast<EnumerateCollectionNode*>(scan);
+    Index const* index = nullptr;
+
+    for (auto const& it : enumerateCollectionNode->collection()->getIndexes()) {
+      if (it->type == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX &&
+          it->fields.size() == 1 &&
+          triagens::basics::AttributeName::isIdentical(it->fields[0], attributeData.second)) {
+        index = it;
+        break;
+      }
+    }
+
+    if (index == nullptr) {
+      continue;
+    }
+
+    auto query = args->getMember(1);
+
+    std::unique_ptr<Condition> condition(new Condition(plan->getAst()));
+    condition->normalize(plan);
+
+    std::unique_ptr<IndexNode> newNode(new IndexNode(
+      plan,
+      plan->nextId(),
+      enumerateCollectionNode->vocbase(),
+      enumerateCollectionNode->collection(),
+      enumerateCollectionNode->outVariable(),
+      std::vector<Index const*>({ index }),
+      condition.get(),
+      false
+    ));
+
+    condition.release();
+    newNode->setFulltext(std::string(query->getStringValue(), query->getStringLength()));
+
+    auto indexNode = newNode.release();
+    plan->registerNode(indexNode);
+    plan->replaceNode(enumerateCollectionNode, indexNode);
+
+    if (funcNode == root) {
+      // nothing else to filter
+      plan->unlinkNode(filterNode);
+      plan->findVarUsage();
+
+      if (! setter->isVarUsedLater(inVar[0])) {
+        plan->unlinkNode(setter);
+      }
+    }
+    else {
+      auto remaining = RemoveConditionPart(plan->getAst(), root, funcNode);
+      TRI_ASSERT(remaining != nullptr);
+
+      std::unique_ptr<Expression> expr(new Expression(plan->getAst(), remaining));
+      auto cn = new CalculationNode(plan, plan->nextId(), expr.get(), calculationNode->outVariable());
+      expr.release();
+      plan->registerNode(cn);
+      plan->replaceNode(setter, cn);
+    }
+
+    plan->findVarUsage();
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief try to remove filters which are covered by indexes
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::removeFiltersCoveredByIndexRule (Optimizer* opt,
+                                                    ExecutionPlan* plan,
+                                                    Optimizer::Rule const* rule) {
+  std::unordered_set<ExecutionNode*> toUnlink;
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes= plan->findNodesOfType(EN::FILTER, true); 
+  
+  for (auto const& node : nodes) {
+    auto fn = static_cast<FilterNode const*>(node);
+    // find the node with the filter expression
+    auto inVar = fn->getVariablesUsedHere();
+    TRI_ASSERT(inVar.size() == 1);
+          
+    auto setter = plan->getVarSetBy(inVar[0]->id);
+
+    if (setter == nullptr || setter->getType() != EN::CALCULATION) {
+      continue;
+    }
+        
+    auto calculationNode = static_cast<CalculationNode*>(setter);
+    auto conditionNode = calculationNode->expression()->node();
+
+    // build the filter condition 
+    std::unique_ptr<Condition> condition(new Condition(plan->getAst()));
+    condition->andCombine(conditionNode);
+    condition->normalize(plan);
+
+    if (condition->root() == nullptr) {
+      continue;
+    }
+
+    size_t const n = condition->root()->numMembers();
+
+    if (n != 1) {
+      // either no condition or multiple ORed conditions...
+      continue;
+    }
+
+    bool handled = false;
+    auto current = node;
+    while (current != nullptr) {
+      if (current->getType() == EN::INDEX) {
+        auto indexNode = static_cast<IndexNode const*>(current);
+
+        // found an index node, now check if the expression is covered by the index
+        auto indexCondition = indexNode->condition();
+
+        if (indexCondition != nullptr && ! indexCondition->isEmpty()) {
+          auto const& indexesUsed = indexNode->getIndexes();
+
+          if (indexesUsed.size() == 1) {
+            // single index. this is something that we can handle
+
+            auto newNode = condition->removeIndexCondition(indexNode->outVariable(), indexCondition->root());
+
+            if (newNode == nullptr) {
+              // no condition left...
+              // FILTER node can be completely removed
+              toUnlink.emplace(setter);
+              toUnlink.emplace(node);
+              modified = true;
+              handled = true;
+            }
+            else if (newNode != condition->root()) {
+              // some condition is left, but it is a different one than
+              // the one from the FILTER node
+              std::unique_ptr<Expression> expr(new Expression(plan->getAst(), newNode));
+              CalculationNode* cn = new CalculationNode(plan, plan->nextId(), expr.get(), calculationNode->outVariable());
+              expr.release();
+              plan->registerNode(cn);
+              plan->replaceNode(setter, cn);
+              modified = true;
+              handled = true;
+            }
+          }
+        }
+
+        if (handled) {
+          break;
+        }
+      }
+
+      if (handled) {
+        break;
+      }
+
+      if (! current->hasDependency()) {
+        break;
+      }
+
+      current = current->getFirstDependency();
+    }
+  }
+  if (! toUnlink.empty()) {
+    plan->unlinkNodes(toUnlink);
+    plan->findVarUsage();
+  }
+  
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper for the use-hash-joins rule: checks whether <node> is an
+/// attribute access on <variable> that can be used as the build key of a
+/// hash join. if yes, the attribute path is returned in <path>
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsHashJoinAttribute (AstNode const* node,
+                                 Variable const* variable,
+                                 std::vector<std::string>& path) {
+  std::pair<Variable const*, std::vector<triagens::basics::AttributeName>> result;
+
+  if (node->type != NODE_TYPE_ATTRIBUTE_ACCESS ||
+      ! node->isAttributeAccessForVariable(result) ||
+      result.first != variable) {
+    return false;
+  }
+
+  path.clear();
+  for (auto const& it : result.second) {
+    if (it.shouldExpand) {
+      // [*] cannot be used as a join key
+      return false;
+    }
+    path.emplace_back(it.name);
+  }
+
+  return ! path.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper for the use-hash-joins rule: checks whether <node> can be
+/// used as the probe key of a hash join, i.e. it can be computed before the
+/// collection is enumerated
+////////////////////////////////////////////////////////////////////////////////
+
+static bool IsHashJoinProbe (AstNode const* node,
+                             ExecutionNode const* collectionNode) {
+  if (! node->isDeterministic() || node->canThrow()) {
+    // the expression will be evaluated once per outer row instead of
+    // once per pair of rows
+    return false;
+  }
+
+  std::unordered_set<Variable const*> vars;
+  Ast::getReferencedVariables(node, vars);
+
+  if (vars.empty()) {
+    // constant key. a full scan with a FILTER is as good as a hash join here
+    return false;
+  }
+
+  auto const& varsValid = collectionNode->getFirstDependency()->getVarsValid();
+
+  for (auto const& it : vars) {
+    if (varsValid.find(it) == varsValid.end()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace full collection scans that are the inner side of an
+/// equi-join with a hash join
+/// the rule looks for FILTER a.x == b.y where b is produced by an
+/// EnumerateCollectionNode and a is valid before that node. the value of a.x
+/// is computed by a new CalculationNode in front of the enumeration, and the
+/// enumeration is replaced with a HashJoinNode that returns only documents
+/// with b.y == a.x. the FILTER is kept, it becomes cheap
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useHashJoinsRule (Optimizer* opt,
+                                     ExecutionPlan* plan,
+                                     Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::FILTER, true);
+
+  for (auto const& node : nodes) {
+    auto inVar = node->getVariablesUsedHere();
+    TRI_ASSERT(inVar.size() == 1);
+
+    auto setter = plan->getVarSetBy(inVar[0]->id);
+
+    if (setter == nullptr || setter->getType() != EN::CALCULATION) {
+      continue;
+    }
+
+    auto conditionNode = static_cast<CalculationNode*>(setter)->expression()->node();
+
+    if (conditionNode->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+      continue;
+    }
+
+    // find the closest EnumerateCollectionNode in front of the FILTER.
+    // only calculations and filters may be in between, because any other
+    // node type would be affected by the FILTER being applied earlier
+    EnumerateCollectionNode* collectionNode = nullptr;
+    auto current = node->getFirstDependency();
+
+    while (current != nullptr) {
+      auto const type = current->getType();
+
+      if (type == EN::ENUMERATE_COLLECTION) {
+        collectionNode = static_cast<EnumerateCollectionNode*>(current);
+        break;
+      }
+
+      if (type != EN::CALCULATION && type != EN::FILTER) {
+        break;
+      }
+
+      current = current->getFirstDependency();
+    }
+
+    if (collectionNode == nullptr ||
+        collectionNode->isRandom() ||
+        ! collectionNode->hasDependency()) {
+      continue;
+    }
+
+    auto const outVariable = collectionNode->outVariable();
+    auto lhs = conditionNode->getMember(0);
+    auto rhs = conditionNode->getMember(1);
+    std::vector<std::string> attributePath;
+    AstNode const* probe = nullptr;
+
+    if (IsHashJoinAttribute(lhs, outVariable, attributePath) &&
+        IsHashJoinProbe(rhs, collectionNode)) {
+      probe = rhs;
+    }
+    else if (IsHashJoinAttribute(rhs, outVariable, attributePath) &&
+             IsHashJoinProbe(lhs, collectionNode)) {
+      probe = lhs;
+    }
+
+    if (probe == nullptr) {
+      continue;
+    }
+
+    // compute the probe value in front of the collection
+    auto ast = plan->getAst();
+    auto keyVariable = ast->variables()->createTemporaryVariable();
+
+    std::unique_ptr<Expression> expr(new Expression(ast, ast->clone(probe)));
+    auto calculationNode = new CalculationNode(plan, plan->nextId(), expr.get(), keyVariable);
+    expr.release();
+    plan->registerNode(calculationNode);
+    plan->insertDependency(collectionNode, calculationNode);
+
+    auto hashJoinNode = new HashJoinNode(plan, plan->nextId(), collectionNode->vocbase(),
+                                         collectionNode->collection(), outVariable,
+                                         keyVariable, attributePath);
+    plan->registerNode(hashJoinNode);
+    plan->replaceNode(collectionNode, hashJoinNode);
+
+    // the following FILTERs check the variables that are valid in front of
+    // the nodes we have just inserted
+    plan->findVarUsage();
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace a FOR loop over the result of TRAVERSE() with a
+/// TraversalNode
+/// the function would build all paths in memory before the loop starts. the
+/// TraversalNode produces them batch by batch instead, so a LIMIT stops the
+/// traversal early. the arguments of the function call are computed by a new
+/// CalculationNode in front of the loop, and the old CalculationNode is
+/// removed if its result is not used elsewhere
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useNativeTraversalRule (Optimizer* opt,
+                                           ExecutionPlan* plan,
+                                           Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::ENUMERATE_LIST, true);
+
+  for (auto const& n : nodes) {
+    auto inVariable = n->getVariablesUsedHere()[0];
+    auto setter = plan->getVarSetBy(inVariable->id);
+
+    if (setter == nullptr || setter->getType() != EN::CALCULATION) {
+      continue;
+    }
+
+    auto const expression = static_cast<CalculationNode*>(setter)->expression();
+
+    if (expression == nullptr ||
+        expression->node() == nullptr ||
+        expression->node()->type != NODE_TYPE_FCALL) {
+      continue;
+    }
+
+    auto funcNode = expression->node();
+    auto func = static_cast<Function const*>(funcNode->getData());
+
+    if (func->externalName != "TRAVERSE" ||
+        funcNode->numMembers() != 1) {
+      continue;
+    }
+
+    auto args = funcNode->getMember(0);
+
+    if (args->type != NODE_TYPE_ARRAY ||
+        args->numMembers() < 4 ||
+        args->numMembers() > 5) {
+      // let the function report the error
+      continue;
+    }
+
+    // compute the arguments in front of the loop
+    auto ast = plan->getAst();
+    auto argsVariable = ast->variables()->createTemporaryVariable();
+
+    std::unique_ptr<Expression> expr(new Expression(ast, ast->clone(args)));
+    auto calculationNode = new CalculationNode(plan, plan->nextId(), expr.get(), argsVariable);
+    expr.release();
+    plan->registerNode(calculationNode);
+    plan->insertDependency(n, calculationNode);
+
+    auto traversalNode = new TraversalNode(plan, plan->nextId(), argsVariable,
+                                           n->getVariablesSetHere()[0]);
+    plan->registerNode(traversalNode);
+    plan->replaceNode(n, traversalNode);
+
+    plan->findVarUsage();
+
+    if (! setter->isVarUsedLater(inVariable)) {
+      // nobody else needs the result of the function
+      plan->unlinkNode(setter);
+      plan->findVarUsage();
+    }
+
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks whether the results of a subquery can be cached by the values
+/// of the outer variables it uses. this is not the case if the subquery, or
+/// one of its own subqueries, modifies data, iterates in random order, calls
+/// a non-deterministic function or is distributed in a cluster
+////////////////////////////////////////////////////////////////////////////////
+
+struct CacheableSubqueryFinder final : public WalkerWorker<ExecutionNode> {
+  bool _cacheable;
+
+  CacheableSubqueryFinder ()
+    : _cacheable(true) {
+  }
+
+  bool enterSubquery (ExecutionNode*, ExecutionNode*) override final {
+    return true;
+  }
+
+  bool before (ExecutionNode* en) override final {
+    switch (en->getType()) {
+      case EN::INSERT:
+      case EN::REMOVE:
+      case EN::REPLACE:
+      case EN::UPDATE:
+      case EN::UPSERT:
+      case EN::SCATTER:
+      case EN::GATHER:
+      case EN::REMOTE:
+      case EN::DISTRIBUTE: {
+        _cacheable = false;
+        break;
+      }
+
+      case EN::ENUMERATE_COLLECTION: {
+        if (static_cast<EnumerateCollectionNode const*>(en)->isRandom()) {
+          _cacheable = false;
+        }
+        break;
+      }
+
+      case EN::CALCULATION: {
+        if (! static_cast<CalculationNode const*>(en)->expression()->isDeterministic()) {
+          _cacheable = false;
+        }
+        break;
+      }
+
+      default: {
+      }
+    }
+
+    // abort the walk once we know the answer
+    return ! _cacheable;
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache the results of subqueries that are executed repeatedly
+/// the SubqueryBlock of such a subquery keeps the results by the values of
+/// the outer variables the subquery uses. an uncorrelated subquery is thus
+/// executed once, and a correlated one once per distinct combination of the
+/// values of its outer variables. subqueries in the top-level plan are only
+/// considered if they are inside a loop, nested subqueries always
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::cacheSubqueryResultsRule (Optimizer* opt,
+                                             ExecutionPlan* plan,
+                                             Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::SUBQUERY, true);
+  std::vector<ExecutionNode*>&& topLevel = plan->findNodesOfType(EN::SUBQUERY, false);
+
+  for (auto const& n : nodes) {
+    auto sub = static_cast<SubqueryNode*>(n);
+
+    if (sub->cacheResults()) {
+      continue;
+    }
+
+    if (std::find(topLevel.begin(), topLevel.end(), n) != topLevel.end() &&
+        ! n->isInInnerLoop()) {
+      // the subquery is executed only once
+      continue;
+    }
+
+    CacheableSubqueryFinder finder;
+    sub->getSubquery()->walk(&finder);
+
+    if (! finder._cacheable) {
+      continue;
+    }
+
+    sub->setCacheResults();
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper for the use-index-only and reduce-extraction-to-projection
+/// rules: collects the names of all attributes of <variable> accessed in <node>. returns false if <variable>
+/// is used in any other way than a top-level attribute access
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CollectIndexOnlyAttributes (AstNode const* node,
+                                        Variable const* variable,
+                                        std::unordered_set<std::string>& attributes) {
+  if (node == nullptr) {
+    return true;
+  }
+
+  if (node->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+    auto sub = node->getMember(0);
+
+    if (sub->type == NODE_TYPE_REFERENCE &&
+        static_cast<Variable const*>(sub->getData()) == variable) {
+      attributes.emplace(std::string(node->getStringValue(), node->getStringLength()));
+      return true;
+    }
+  }
+  else if (node->type == NODE_TYPE_REFERENCE) {
+    // the complete value is used
+    return (static_cast<Variable const*>(node->getData()) != variable);
+  }
+
+  size_t const n = node->numMembers();
+
+  for (size_t i = 0; i < n; ++i) {
+    if (! CollectIndexOnlyAttributes(node->getMember(i), variable, attributes)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief produce the results of index lookups from the index entries only
+/// the rule applies to IndexNodes using hash or skiplist indexes if the out
+/// variable is only used in calculations, and only by accessing top-level
+/// attributes that are covered by all indexes of the node. the IndexBlock
+/// will then build small objects containing only these attributes from the
+/// values stored in the index, instead of returning the documents
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::useIndexOnlyRule (Optimizer* opt,
+                                     ExecutionPlan* plan,
+                                     Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::INDEX, true);
+
+  for (auto const& node : nodes) {
+    auto indexNode = static_cast<IndexNode*>(node);
+
+    if (! indexNode->projections().empty()) {
+      // already an index-only scan
+      continue;
+    }
+
+    // determine the attributes that can be taken from all indexes
+    std::unordered_set<std::string> covered;
+    bool isCovering = true;
+    bool isFirst = true;
+
+    for (auto const& index : indexNode->getIndexes()) {
+      if (index->type != triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX &&
+          index->type != triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX) {
+        isCovering = false;
+        break;
+      }
+
+      std::unordered_set<std::string> fields;
+      for (auto const& field : index->fields) {
+        if (field.size() == 1 &&
+            ! field[0].shouldExpand &&
+            ! field[0].name.empty() &&
+            field[0].name[0] != '_') {
+          fields.emplace(field[0].name);
+        }
+      }
+
+      if (isFirst) {
+        covered = std::move(fields);
+        isFirst = false;
+      }
+      else {
+        for (auto it = covered.begin(); it != covered.end(); /* no hoisting */) {
+          if (fields.find(*it) == fields.end()) {
+            it = covered.erase(it);
+          }
+          else {
+            ++it;
+          }
+        }
+      }
+    }
+
+    if (! isCovering || covered.empty()) {
+      continue;
+    }
+
+    // check all uses of the out variable
+    auto const outVariable = indexNode->outVariable();
+    std::unordered_set<std::string> attributes;
+    std::unordered_set<Variable const*> vars;
+    auto parents = node->getParents();
+
+    while (! parents.empty() && isCovering) {
+      auto current = parents[0];
+
+      vars.clear();
+      current->getVariablesUsedHere(vars);
+
+      if (vars.find(outVariable) != vars.end()) {
+        if (current->getType() != EN::CALCULATION ||
+            ! CollectIndexOnlyAttributes(static_cast<CalculationNode*>(current)->expression()->node(), outVariable, attributes)) {
+          isCovering = false;
+          break;
+        }
+      }
+
+      parents = current->getParents();
+    }
+
+    if (! isCovering || attributes.empty()) {
+      continue;
+    }
+
+    for (auto const& it : attributes) {
+      if (covered.find(it) == covered.end()) {
+        isCovering = false;
+        break;
+      }
+    }
+
+    if (! isCovering) {
+      continue;
+    }
+
+    std::vector<std::string> projections(attributes.begin(), attributes.end());
+    std::sort(projections.begin(), projections.end());
+    indexNode->setProjections(projections);
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief helper to compute lots of permutation tuples
+/// a permutation tuple is represented as a single vector together with
+/// another vector describing the boundaries of the tuples.
+/// Example:
+/// data:   0,1,2, 3,4, 5,6
+/// starts: 0,     3,   5,      (indices of starts of sections)
+/// means a tuple of 3 permutations of 3, 2 and 2 points respectively
+/// This function computes the next permutation tuple among the 
+/// lexicographically sorted list of all such tuples. It returns true
+/// if it has successfully computed this and false if the tuple is already
+/// the lexicographically largest one. If false is returned, the permutation
+/// tuple is back to the beginning.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool NextPermutationTuple (std::vector<size_t>& data,
+                                  std::vector<size_t>& starts) {
+  auto begin = data.begin();  // a random access iterator
+
+  for (size_t i = starts.size(); i-- != 0; ) {
+    std::vector<size_t>::iterator from = begin + starts[i];
+    std::vector<size_t>::iterator to;
+    if (i == starts.size() - 1) {
+      to = data.end();
+    }
+    else {
+      to = begin + starts[i + 1];
+    }
+    if (std::next_permutation(from, to)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interchange adjacent EnumerateCollectionNodes in all possible ways
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::interchangeAdjacentEnumerationsRule (Optimizer* opt,
+                                                        ExecutionPlan* plan,
+                                                        Optimizer::Rule const* rule) {
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::ENUMERATE_COLLECTION, true);
+
+  std::unordered_set<ExecutionNode*> nodesSet;
+  for (auto const& n : nodes) {
+    TRI_ASSERT(nodesSet.find(n) == nodesSet.end());
+    nodesSet.emplace(n);
+  }
+
+  std::vector<ExecutionNode*> nodesToPermute;
+  std::vector<size_t> permTuple;
+  std::vector<size_t> starts;
+
+  // We use that the order of the nodes is such that a node B that is among the
+  // recursive dependencies of a node A is later in the vector.
+  for (auto const& n : nodes) {
+    if (nodesSet.find(n) != nodesSet.end()) {
+      std::vector<ExecutionNode*> nn{ n };
+      nodesSet.erase(n);
+
+      // Now follow the dependencies as long as we see further such nodes:
+      auto nwalker = n;
+
+      while (true) {
+        if (! nwalker->hasDependency()) {
+          break;
+        }
 
         auto dep = nwalker->getFirstDependency();
 
@@ -2243,6 +3337,12 @@ int triagens::aql::interchangeAdjacentEnumerationsRule (Optimizer* opt,
   // plan, we need to compute all possible permutations of all of them,
   // independently. This is why we need to compute all permutation tuples.
 
+  if (! starts.empty()) {
+    // the clones take over the cost estimates of the plan. only the nodes
+    // above the permuted ones need to be estimated again for each clone
+    plan->getCost();
+  }
+
   opt->addPlan(plan, rule, false);
 
   if (! starts.empty()) {
@@ -2284,10 +3384,21 @@ int triagens::aql::interchangeAdjacentEnumerationsRule (Optimizer* opt,
           for (size_t j = highBound; j-- != lowBound; ) {
             newPlan->insertDependency(parent, newNodes[permTuple[j]]);
           }
+
+          for (size_t j = lowBound; j < highBound; j++) {
+            if (newNodes[j]->invalidateCostUpwards() != newPlan->root()) {
+              // the nodes are part of a subquery, whose node we cannot reach
+              newPlan->invalidateCost();
+            }
+          }
+        }
+
+        if (! rule->isHidden) {
+          newPlan->addAppliedRule(static_cast<int>(rule->level));
         }
     
         // OK, the new plan is ready, let's report it:
-        if (! opt->addPlan(newPlan, rule, true)) {
+        if (! opt->addPlan(newPlan, rule, false)) {
           // have enough plans. stop permutations
           break;
         }
@@ -2683,6 +3794,9 @@ int triagens::aql::distributeFilternCalcToClusterRule (Optimizer* opt,
         case EN::LIMIT:
         case EN::SORT:
         case EN::INDEX:
+        case EN::WINDOW:
+        case EN::HASH_JOIN:
+        case EN::TRAVERSAL:
         case EN::ENUMERATE_COLLECTION:
           //do break
           stopSearching = true;
@@ -2779,6 +3893,9 @@ int triagens::aql::distributeSortToClusterRule (Optimizer* opt,
         case EN::REMOTE:
         case EN::LIMIT:
         case EN::INDEX:
+        case EN::WINDOW:
+        case EN::HASH_JOIN:
+        case EN::TRAVERSAL:
         case EN::ENUMERATE_COLLECTION:
           // For all these, we do not want to pull a SortNode further down
           // out to the DBservers, note that potential FilterNodes and
@@ -2801,10 +3918,276 @@ int triagens::aql::distributeSortToClusterRule (Optimizer* opt,
           //ready to rumble!
       }
 
-      if (stopSearching) {
-        break;
-      }
+      if (stopSearching) {
+        break;
+      }
+    }
+  }
+  
+  if (modified) {
+    plan->findVarUsage();
+  }
+  
+  opt->addPlan(plan, rule, modified);
+  
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the shard-local part of the plan below a RemoteNode can
+/// be extended by further nodes. it cannot if it ends in a data-modification
+/// node, because fewer input rows would then lead to fewer modifications
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CanExtendShardPart (ExecutionNode const* remoteNode) {
+  if (remoteNode->getType() != EN::REMOTE || ! remoteNode->hasDependency()) {
+    return false;
+  }
+
+  switch (remoteNode->getFirstDependency()->getType()) {
+    case EN::INSERT:
+    case EN::REMOVE:
+    case EN::REPLACE:
+    case EN::UPDATE:
+    case EN::UPSERT:
+      return false;
+    default:
+      return true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief split COLLECTs into a shard-local and a coordinator part
+/// this rule modifies the plan in place
+/// a COLLECT directly above a GatherNode is copied into the shard-local part
+/// of the plan, writing into new variables. the COLLECT on the coordinator
+/// then merges the groups produced by all shards. the partial counts of
+/// COLLECT ... WITH COUNT are summed up by collecting them INTO a group and
+/// computing SUM() of it. COLLECT INTO without COUNT is not distributed,
+/// because it needs all documents on the coordinator anyway
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::distributeCollectToClusterRule (Optimizer* opt, 
+                                                   ExecutionPlan* plan,
+                                                   Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::GATHER, true);
+  
+  for (auto& n : nodes) {
+    auto const& remoteNodeList = n->getDependencies();
+    auto gatherNode = static_cast<GatherNode*>(n);
+    TRI_ASSERT(remoteNodeList.size() > 0);
+    auto rn = remoteNodeList[0];
+
+    if (! n->hasParent() || ! CanExtendShardPart(rn)) {
+      continue;
+    }
+
+    auto parent = n->getParents()[0];
+
+    if (parent->getType() != EN::AGGREGATE) {
+      continue;
+    }
+
+    auto collectNode = static_cast<AggregateNode*>(parent);
+
+    if (! collectNode->isSpecialized() ||
+        collectNode->hasExpressionVariable() ||
+        (collectNode->hasOutVariable() && ! collectNode->count())) {
+      continue;
+    }
+
+    auto const& aggregateVariables = collectNode->aggregateVariables();
+    bool const isHashed = (collectNode->aggregationMethod() != AggregationOptions::AggregationMethod::AGGREGATION_METHOD_SORTED);
+
+    if (aggregateVariables.empty() && ! collectNode->count()) {
+      continue;
+    }
+
+    if (! isHashed && 
+        ! aggregateVariables.empty() &&
+        gatherNode->getElements().empty()) {
+      // the sorted COLLECT relies on a sort that was not moved to the shards
+      continue;
+    }
+
+    auto ast = plan->getAst();
+
+    // the shard-local COLLECT writes its groups into new variables, which
+    // the COLLECT on the coordinator groups by
+    std::vector<std::pair<Variable const*, Variable const*>> localVariables;
+    std::vector<std::pair<Variable const*, Variable const*>> globalVariables;
+    std::unordered_map<Variable const*, Variable const*> replacements;
+
+    for (auto const& it : aggregateVariables) {
+      auto partial = ast->variables()->createTemporaryVariable();
+      localVariables.emplace_back(std::make_pair(partial, it.second));
+      globalVariables.emplace_back(std::make_pair(it.first, partial));
+      replacements.emplace(it.second, partial);
+    }
+
+    // the GatherNode now merges the shard-local groups
+    SortElementVector elements;
+    bool canMerge = true;
+    for (auto const& it : gatherNode->getElements()) {
+      auto it2 = replacements.find(it.first);
+
+      if (it2 == replacements.end()) {
+        canMerge = false;
+        break;
+      }
+      elements.emplace_back(std::make_pair((*it2).second, it.second));
+    }
+
+    if (! canMerge) {
+      continue;
+    }
+
+    Variable const* partialCount = nullptr;
+    if (collectNode->count()) {
+      partialCount = ast->variables()->createTemporaryVariable();
+    }
+
+    auto localNode = new AggregateNode(plan, 
+                                       plan->nextId(), 
+                                       collectNode->getOptions(), 
+                                       localVariables, 
+                                       nullptr, 
+                                       partialCount, 
+                                       std::vector<Variable const*>(), 
+                                       collectNode->variableMap(),
+                                       collectNode->count(),
+                                       collectNode->isDistinctCommand());
+    localNode->specialized();
+    plan->registerNode(localNode);
+    plan->insertDependency(rn, localNode);
+    gatherNode->setElements(elements);
+
+    if (! collectNode->count()) {
+      auto globalNode = new AggregateNode(plan, 
+                                          plan->nextId(), 
+                                          collectNode->getOptions(), 
+                                          globalVariables, 
+                                          nullptr, 
+                                          nullptr, 
+                                          std::vector<Variable const*>(), 
+                                          collectNode->variableMap(),
+                                          false,
+                                          collectNode->isDistinctCommand());
+      globalNode->specialized();
+      plan->registerNode(globalNode);
+      plan->replaceNode(collectNode, globalNode);
+    }
+    else {
+      // COLLECT ... INTO group = partialCount, needs its input sorted
+      auto groupVariable = ast->variables()->createTemporaryVariable();
+
+      auto globalNode = new AggregateNode(plan, 
+                                          plan->nextId(), 
+                                          collectNode->getOptions(), 
+                                          globalVariables, 
+                                          partialCount, 
+                                          groupVariable, 
+                                          std::vector<Variable const*>(), 
+                                          collectNode->variableMap(),
+                                          false,
+                                          collectNode->isDistinctCommand());
+      globalNode->aggregationMethod(AggregationOptions::AggregationMethod::AGGREGATION_METHOD_SORTED);
+      globalNode->specialized();
+      plan->registerNode(globalNode);
+      plan->replaceNode(collectNode, globalNode);
+
+      if (isHashed && ! globalVariables.empty()) {
+        // the shards return their groups unsorted
+        SortElementVector sortElements;
+        for (auto const& it : globalVariables) {
+          sortElements.emplace_back(std::make_pair(it.second, true));
+        }
+
+        auto sortNode = new SortNode(plan, plan->nextId(), sortElements, false);
+        plan->registerNode(sortNode);
+        plan->insertDependency(globalNode, sortNode);
+      }
+
+      // count = SUM(group)
+      auto arguments = ast->createNodeArray();
+      arguments->addMember(ast->createNodeReference(groupVariable));
+      auto sum = ast->createNodeFunctionCall("SUM", arguments);
+
+      std::unique_ptr<Expression> expr(new Expression(ast, sum));
+      auto calculationNode = new CalculationNode(plan, plan->nextId(), expr.get(), collectNode->outVariable());
+      expr.release();
+      plan->registerNode(calculationNode);
+
+      TRI_ASSERT(globalNode->hasParent());
+      plan->insertDependency(globalNode->getParents()[0], calculationNode);
+    }
+
+    modified = true;
+  }
+  
+  if (modified) {
+    plan->findVarUsage();
+  }
+  
+  opt->addPlan(plan, rule, modified);
+  
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy LIMITs into the cluster distribution part of the plan
+/// this rule modifies the plan in place
+/// a LIMIT that follows a GatherNode with only CalculationNodes in between
+/// is copied in front of the RemoteNode with an offset of 0 and a count of
+/// offset + count, so that each shard stops after the rows that can make it
+/// into the result. if a sort was moved to the shards before, the copy is
+/// placed behind it, so each shard returns its first rows in sort order.
+/// the original LIMIT remains on the coordinator. LIMITs with fullCount are
+/// not copied, because they need to see all rows
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::distributeLimitToClusterRule (Optimizer* opt, 
+                                                 ExecutionPlan* plan,
+                                                 Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::GATHER, true);
+  
+  for (auto& n : nodes) {
+    auto const& remoteNodeList = n->getDependencies();
+    TRI_ASSERT(remoteNodeList.size() > 0);
+    auto rn = remoteNodeList[0];
+
+    if (! n->hasParent() || ! CanExtendShardPart(rn)) {
+      continue;
+    }
+
+    auto inspectNode = n->getParents()[0];
+
+    while (inspectNode->getType() == EN::CALCULATION && inspectNode->hasParent()) {
+      inspectNode = inspectNode->getParents()[0];
+    }
+
+    if (inspectNode->getType() != EN::LIMIT) {
+      continue;
+    }
+
+    auto limitNode = static_cast<LimitNode const*>(inspectNode);
+
+    size_t const limit = limitNode->offset() + limitNode->limit();
+
+    if (limitNode->fullCount() || limit < limitNode->limit()) {
+      // fullCount needs all rows, or offset + count overflows
+      continue;
     }
+
+    auto localNode = new LimitNode(plan, plan->nextId(), 0, limit);
+    plan->registerNode(localNode);
+    plan->insertDependency(rn, localNode);
+
+    modified = true;
   }
   
   if (modified) {
@@ -3052,7 +4435,10 @@ class RemoveToEnumCollFinder final : public WalkerWorker<ExecutionNode> {
         case EN::ILLEGAL:
         case EN::LIMIT:           
         case EN::SORT:
-        case EN::INDEX: {
+        case EN::INDEX:
+        case EN::WINDOW:
+        case EN::HASH_JOIN:
+        case EN::TRAVERSAL: {
           // if we meet any of the above, then we abort . . .
         }
     }
@@ -3088,6 +4474,501 @@ int triagens::aql::undistributeRemoveAfterEnumCollRule (Optimizer* opt,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the collection and the out variable of a node that reads
+/// documents from a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static bool GetCollectionAccess (ExecutionNode const* node,
+                                 Collection const*& collection,
+                                 Variable const*& outVariable) {
+  if (node->getType() == EN::ENUMERATE_COLLECTION) {
+    auto n = static_cast<EnumerateCollectionNode const*>(node);
+    collection = n->collection();
+    outVariable = n->outVariable();
+    return true;
+  }
+
+  if (node->getType() == EN::INDEX) {
+    auto n = static_cast<IndexNode const*>(node);
+    collection = n->collection();
+    outVariable = n->outVariable();
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a plan contains data-modification nodes
+////////////////////////////////////////////////////////////////////////////////
+
+static bool HasModificationNodes (ExecutionPlan* plan) {
+  std::vector<ExecutionNode::NodeType> const types{ 
+    EN::INSERT, EN::UPDATE, EN::REPLACE, EN::REMOVE, EN::UPSERT 
+  };
+
+  return ! plan->findNodesOfType(types, true).empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief count how often each collection is read in a plan
+////////////////////////////////////////////////////////////////////////////////
+
+static std::unordered_map<std::string, size_t> CountCollectionAccesses (ExecutionPlan* plan) {
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(
+    std::vector<ExecutionNode::NodeType>{ EN::ENUMERATE_COLLECTION, EN::INDEX, EN::HASH_JOIN }, true);
+
+  std::unordered_map<std::string, size_t> usage;
+
+  for (auto const& n : nodes) {
+    Collection const* collection = nullptr;
+    Variable const* outVariable = nullptr;
+
+    if (! GetCollectionAccess(n, collection, outVariable)) {
+      collection = static_cast<HashJoinNode const*>(n)->collection();
+    }
+
+    ++usage[collection->name];
+  }
+
+  return usage;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the conditions that hold for every document produced by a
+/// collection node: its index condition and the filters after it. a LIMIT,
+/// COLLECT or WINDOW ends the search, as filters after them do not decide
+/// which documents are read
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<AstNode const*> FindFilterConditions (ExecutionPlan* plan,
+                                                         ExecutionNode* node) {
+  std::vector<AstNode const*> conditions;
+
+  if (node->getType() == EN::INDEX) {
+    // the index condition may have replaced the filter
+    auto root = static_cast<IndexNode const*>(node)->condition()->root();
+
+    if (root != nullptr && root->numMembers() == 1) {
+      conditions.emplace_back(root->getMember(0));
+    }
+  }
+
+  auto current = node;
+
+  while (current->hasParent()) {
+    current = current->getParents()[0];
+    auto const type = current->getType();
+
+    if (type == EN::LIMIT || 
+        type == EN::AGGREGATE ||
+        type == EN::WINDOW ||
+        type == EN::RETURN) {
+      break;
+    }
+
+    if (type == EN::FILTER) {
+      auto setter = plan->getVarSetBy(current->getVariablesUsedHere()[0]->id);
+
+      if (setter != nullptr && setter->getType() == EN::CALCULATION) {
+        conditions.emplace_back(static_cast<CalculationNode*>(setter)->expression()->node());
+      }
+    }
+  }
+
+  return conditions;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collect the values of all attributes of a variable that a condition
+/// compares for equality with a constant. only top-level conjunctions are
+/// inspected, because the values must hold for every document
+////////////////////////////////////////////////////////////////////////////////
+
+static void FindConstantAttributeValues (AstNode const* node,
+                                         Variable const* variable,
+                                         std::unordered_map<std::string, AstNode const*>& values) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      FindConstantAttributeValues(node->getMember(i), variable, values);
+    }
+    return;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return;
+  }
+
+  auto lhs = node->getMember(0);
+  auto rhs = node->getMember(1);
+
+  if (rhs->type == NODE_TYPE_ATTRIBUTE_ACCESS) {
+    std::swap(lhs, rhs);
+  }
+
+  if (lhs->type == NODE_TYPE_ATTRIBUTE_ACCESS &&
+      lhs->getMember(0)->type == NODE_TYPE_REFERENCE &&
+      static_cast<Variable const*>(lhs->getMember(0)->getData()) == variable &&
+      rhs->isConstant()) {
+    values.emplace(std::string(lhs->getStringValue(), lhs->getStringLength()), rhs);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collect the pairs of attributes of two variables that a condition
+/// compares for equality. only top-level conjunctions are inspected
+////////////////////////////////////////////////////////////////////////////////
+
+static void FindEqualAttributes (AstNode const* node,
+                                 Variable const* left,
+                                 Variable const* right,
+                                 std::vector<std::pair<std::string, std::string>>& pairs) {
+  if (node->type == NODE_TYPE_OPERATOR_BINARY_AND ||
+      node->type == NODE_TYPE_OPERATOR_NARY_AND) {
+    for (size_t i = 0; i < node->numMembers(); ++i) {
+      FindEqualAttributes(node->getMember(i), left, right, pairs);
+    }
+    return;
+  }
+
+  if (node->type != NODE_TYPE_OPERATOR_BINARY_EQ) {
+    return;
+  }
+
+  auto lhs = node->getMember(0);
+  auto rhs = node->getMember(1);
+
+  if (lhs->type != NODE_TYPE_ATTRIBUTE_ACCESS ||
+      rhs->type != NODE_TYPE_ATTRIBUTE_ACCESS ||
+      lhs->getMember(0)->type != NODE_TYPE_REFERENCE ||
+      rhs->getMember(0)->type != NODE_TYPE_REFERENCE) {
+    return;
+  }
+
+  if (static_cast<Variable const*>(lhs->getMember(0)->getData()) == right) {
+    std::swap(lhs, rhs);
+  }
+
+  if (static_cast<Variable const*>(lhs->getMember(0)->getData()) == left &&
+      static_cast<Variable const*>(rhs->getMember(0)->getData()) == right) {
+    pairs.emplace_back(std::string(lhs->getStringValue(), lhs->getStringLength()),
+                       std::string(rhs->getStringValue(), rhs->getStringLength()));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restrict the access to a collection to a single shard if the
+/// filter conditions fix the values of all shard keys
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::restrictToSingleShardRule (Optimizer* opt, 
+                                              ExecutionPlan* plan, 
+                                              Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  if (HasModificationNodes(plan)) {
+    // data-modification queries distribute their documents by the shard list
+    opt->addPlan(plan, rule, modified);
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // a collection can only be restricted if it is accessed exactly once
+  auto usage = CountCollectionAccesses(plan);
+
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(
+    std::vector<ExecutionNode::NodeType>{ EN::ENUMERATE_COLLECTION, EN::INDEX }, true);
+
+  for (auto const& n : nodes) {
+    Collection const* collection = nullptr;
+    Variable const* outVariable = nullptr;
+    GetCollectionAccess(n, collection, outVariable);
+
+    if (usage[collection->name] != 1) {
+      continue;
+    }
+
+    std::unordered_map<std::string, AstNode const*> values;
+
+    for (auto const& condition : FindFilterConditions(plan, n)) {
+      FindConstantAttributeValues(condition, outVariable, values);
+    }
+
+    if (values.empty()) {
+      continue;
+    }
+
+    std::vector<std::string> const shardKeys = collection->shardKeys();
+    Json document(Json::Object, shardKeys.size());
+    bool complete = true;
+
+    for (auto const& key : shardKeys) {
+      auto it = values.find(key);
+
+      if (it == values.end()) {
+        complete = false;
+        break;
+      }
+
+      TRI_json_t* value = (*it).second->toJsonValue(TRI_UNKNOWN_MEM_ZONE);
+
+      if (value == nullptr) {
+        complete = false;
+        break;
+      }
+
+      document.set(key.c_str(), value);
+    }
+
+    if (! complete) {
+      continue;
+    }
+
+    std::string shardId;
+    bool usesDefaultShardingAttributes;
+    int res = triagens::arango::ClusterInfo::instance()->getResponsibleShard(
+      std::to_string(collection->getPlanId()), document.json(), true, shardId, usesDefaultShardingAttributes);
+
+    if (res != TRI_ERROR_NO_ERROR || shardId.empty()) {
+      continue;
+    }
+
+    // the collection objects are shared by all plans of the query. this is
+    // fine, as the restriction only depends on the query, not on the plan
+    auto c = plan->getAst()->query()->collections()->get(collection->name);
+    TRI_ASSERT(c != nullptr);
+    c->restrictToShard(shardId);
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief make collection scans produce only the attributes that are used
+/// the rule applies to EnumerateCollectionNodes whose out variable is only
+/// used in calculations, and only by accessing top-level attributes, if at
+/// least one of these calculations is executed after a RemoteNode. the
+/// EnumerateCollectionBlock then builds small objects containing only these
+/// attributes, so the complete documents are not serialized and sent to the
+/// coordinator. within a server, attribute accesses on documents do not
+/// copy the documents anyway
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::reduceExtractionToProjectionRule (Optimizer* opt,
+                                                     ExecutionPlan* plan,
+                                                     Optimizer::Rule const* rule) {
+  bool modified = false;
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::ENUMERATE_COLLECTION, true);
+
+  for (auto const& node : nodes) {
+    auto collectionNode = static_cast<EnumerateCollectionNode*>(node);
+
+    if (! collectionNode->projections().empty()) {
+      continue;
+    }
+
+    // check all uses of the out variable
+    auto const outVariable = collectionNode->outVariable();
+    std::unordered_set<std::string> attributes;
+    std::unordered_set<Variable const*> vars;
+    bool isProjectable = true;
+    bool passedRemote = false;
+    bool usedAfterRemote = false;
+    auto parents = node->getParents();
+
+    while (! parents.empty()) {
+      auto current = parents[0];
+
+      if (current->getType() == EN::REMOTE) {
+        passedRemote = true;
+      }
+
+      vars.clear();
+      current->getVariablesUsedHere(vars);
+
+      if (vars.find(outVariable) != vars.end()) {
+        if (current->getType() != EN::CALCULATION ||
+            ! CollectIndexOnlyAttributes(static_cast<CalculationNode*>(current)->expression()->node(), outVariable, attributes)) {
+          isProjectable = false;
+          break;
+        }
+
+        if (passedRemote) {
+          usedAfterRemote = true;
+        }
+      }
+
+      parents = current->getParents();
+    }
+
+    if (! isProjectable || ! usedAfterRemote || attributes.empty()) {
+      // either the documents are used as a whole, or they are not sent
+      // anywhere
+      continue;
+    }
+
+    std::vector<std::string> projections(attributes.begin(), attributes.end());
+    std::sort(projections.begin(), projections.end());
+    collectionNode->setProjections(projections);
+    modified = true;
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute joins of co-located collections on the DB servers
+////////////////////////////////////////////////////////////////////////////////
+
+int triagens::aql::colocateJoinsInClusterRule (Optimizer* opt, 
+                                               ExecutionPlan* plan, 
+                                               Optimizer::Rule const* rule) {
+  bool modified = false;
+
+  if (HasModificationNodes(plan)) {
+    opt->addPlan(plan, rule, modified);
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // the inner collection must only be read by the join, as its shards are
+  // not accessed independently anymore
+  auto usage = CountCollectionAccesses(plan);
+
+  std::vector<ExecutionNode*>&& nodes = plan->findNodesOfType(EN::SCATTER, true);
+
+  for (auto& n : nodes) {
+    // we are looking for the pattern
+    //   ... -> REMOTE -> GATHER [-> CALCULATION | FILTER ...] -> 
+    //   SCATTER -> REMOTE -> inner collection -> ... -> REMOTE -> GATHER
+    // where the part of the plan before the first GATHER reads a collection
+    // that is joined with the inner collection on all shard keys
+    auto scatter = static_cast<ScatterNode*>(n);
+
+    if (! scatter->hasParent()) {
+      continue;
+    }
+
+    auto lowerRemote = scatter->getParents()[0];
+
+    if (lowerRemote->getType() != EN::REMOTE || ! lowerRemote->hasParent()) {
+      continue;
+    }
+
+    auto innerNode = lowerRemote->getParents()[0];
+    Collection const* inner = nullptr;
+    Variable const* innerVariable = nullptr;
+
+    if (! GetCollectionAccess(innerNode, inner, innerVariable) ||
+        inner != scatter->collection() ||
+        usage[inner->name] != 1) {
+      continue;
+    }
+
+    auto upperRemote = innerNode;
+
+    while (upperRemote->getType() != EN::REMOTE && upperRemote->hasParent()) {
+      upperRemote = upperRemote->getParents()[0];
+    }
+
+    if (upperRemote->getType() != EN::REMOTE ||
+        ! upperRemote->hasParent() ||
+        upperRemote->getParents()[0]->getType() != EN::GATHER) {
+      continue;
+    }
+
+    auto innerGather = static_cast<GatherNode*>(upperRemote->getParents()[0]);
+
+    auto dep = scatter->getFirstDependency();
+
+    while (dep != nullptr &&
+           (dep->getType() == EN::FILTER ||
+            (dep->getType() == EN::CALCULATION && 
+             static_cast<CalculationNode*>(dep)->expression()->canRunOnDBServer()))) {
+      dep = dep->getFirstDependency();
+    }
+
+    if (dep == nullptr || dep->getType() != EN::GATHER) {
+      continue;
+    }
+
+    auto outerGather = static_cast<GatherNode*>(dep);
+
+    if (! outerGather->getElements().empty()) {
+      // the sort order of the outer documents would be lost
+      continue;
+    }
+
+    auto outerRemote = outerGather->getFirstDependency();
+
+    if (outerRemote == nullptr || outerRemote->getType() != EN::REMOTE) {
+      continue;
+    }
+
+    // the DB server parts are sent to the shards of this collection
+    Collection const* outer = outerGather->collection();
+
+    if (! inner->isColocatedWith(outer)) {
+      continue;
+    }
+
+    // now look for a collection in the outer part that is joined with the
+    // inner collection on all shard keys
+    std::vector<AstNode const*> const conditions = FindFilterConditions(plan, innerNode);
+    std::vector<std::string> const innerKeys = inner->shardKeys();
+    bool joined = false;
+
+    auto current = outerRemote->getFirstDependency();
+
+    while (current != nullptr && current->getType() != EN::REMOTE && ! joined) {
+      Collection const* candidate = nullptr;
+      Variable const* candidateVariable = nullptr;
+
+      if (GetCollectionAccess(current, candidate, candidateVariable) &&
+          candidate->isColocatedWith(inner)) {
+        std::vector<std::pair<std::string, std::string>> pairs;
+
+        for (auto const& condition : conditions) {
+          FindEqualAttributes(condition, innerVariable, candidateVariable, pairs);
+        }
+
+        std::vector<std::string> const candidateKeys = candidate->shardKeys();
+        joined = (candidateKeys.size() == innerKeys.size());
+
+        for (size_t i = 0; joined && i < innerKeys.size(); ++i) {
+          joined = (std::find(pairs.begin(), pairs.end(), std::make_pair(innerKeys[i], candidateKeys[i])) != pairs.end());
+        }
+      }
+
+      current = current->getFirstDependency();
+    }
+
+    if (! joined) {
+      continue;
+    }
+
+    // join the two DB server parts. the result is gathered from the shards
+    // of the outer collection
+    plan->unlinkNodes(std::unordered_set<ExecutionNode*>{ outerGather, outerRemote, scatter, lowerRemote });
+    static_cast<RemoteNode*>(upperRemote)->setCollection(outer);
+    innerGather->setCollection(outer);
+    modified = true;
+  }
+
+  if (modified) {
+    plan->findVarUsage();
+  }
+
+  opt->addPlan(plan, rule, modified);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief auxilliary struct for finding common nodes in OR conditions
 ////////////////////////////////////////////////////////////////////////////////
@@ -3622,6 +5503,8 @@ int triagens::aql::patchUpdateStatementsRule (Optimizer* opt,
 
       if (type == EN::ENUMERATE_LIST || 
           type == EN::INDEX ||
+          type == EN::HASH_JOIN ||
+          type == EN::TRAVERSAL ||
           type == EN::SUBQUERY) {
         // not suitable
         modified = false;
@@ -148,18 +148,58 @@ namespace triagens {
 
     int useIndexesRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use a fulltext index to produce the documents matching
+/// FILTER FULLTEXT_MATCH(...)
+////////////////////////////////////////////////////////////////////////////////
+
+    int useFulltextIndexRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to use the index for sorting
 ////////////////////////////////////////////////////////////////////////////////
 
     int useIndexForSortRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use a geo index to produce the documents nearest to a point first
+/// for SORT DISTANCE(...) LIMIT ...
+////////////////////////////////////////////////////////////////////////////////
+
+    int useGeoIndexForSortRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief produce the results of index lookups from the index entries only
+/// if all attributes needed are covered by the index
+////////////////////////////////////////////////////////////////////////////////
+
+    int useIndexOnlyRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to remove filters which are covered by indexes
 ////////////////////////////////////////////////////////////////////////////////
 
     int removeFiltersCoveredByIndexRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace full collection scans in equi-joins with hash joins
+////////////////////////////////////////////////////////////////////////////////
+
+    int useHashJoinsRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace FOR loops over TRAVERSE() with a TraversalNode
+////////////////////////////////////////////////////////////////////////////////
+
+    int useNativeTraversalRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache the results of deterministic subqueries by the values of the
+/// outer variables they use
+////////////////////////////////////////////////////////////////////////////////
+
+    int cacheSubqueryResultsRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief interchange adjacent EnumerateCollectionNodes in all possible ways
 ////////////////////////////////////////////////////////////////////////////////
@@ -189,6 +229,21 @@ namespace triagens {
 
     int distributeSortToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief split a COLLECT directly above a GatherNode into a COLLECT on each
+/// shard and a COLLECT on the coordinator, which merges the groups and sums
+/// up the partial counts
+////////////////////////////////////////////////////////////////////////////////
+
+    int distributeCollectToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy a LIMIT above a GatherNode into the shard-local part of the
+/// plan, so that each shard returns at most offset + count documents
+////////////////////////////////////////////////////////////////////////////////
+
+    int distributeLimitToClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to get rid of a RemoteNode->ScatterNode combination which has
 /// only a SingletonNode and possibly some CalculationNodes as dependencies
@@ -226,6 +281,45 @@ namespace triagens {
 
     int undistributeRemoveAfterEnumCollRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restrict the access to a sharded collection to the one shard that
+/// is responsible for the documents, if the filters of the query compare all
+/// shard keys with constant values, e.g.
+///
+///   FOR x IN coll FILTER x._key == @key RETURN x
+///
+/// the scatter/gather nodes then only talk to this shard
+////////////////////////////////////////////////////////////////////////////////
+
+    int restrictToSingleShardRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief make a collection scan on the DB servers produce only the top-level
+/// attributes of the documents that the query uses, if the documents are
+/// sent to the coordinator, e.g.
+///
+///   FOR x IN coll SORT x.value RETURN x.name
+///
+/// the shards then send small objects with "name" and "value" instead of
+/// the complete documents
+////////////////////////////////////////////////////////////////////////////////
+
+    int reduceExtractionToProjectionRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute a join of two collections on the DB servers if the
+/// collections are co-located (see distributeShardsLike) and joined on all
+/// shard keys, e.g.
+///
+///   FOR x IN coll1 FOR y IN coll2 FILTER y.key == x.key RETURN [x, y]
+///
+/// with the shard key "key" for both collections. each shard of coll1 then
+/// joins its documents with the shard of coll2 on the same server, and only
+/// the join results are gathered on the coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+    int colocateJoinsInClusterRule (Optimizer*, ExecutionPlan*, Optimizer::Rule const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief this rule replaces expressions of the type: 
 ///   x.val == 1 || x.val == 2 || x.val == 3
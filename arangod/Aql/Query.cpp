@@ -32,14 +32,18 @@
 #include "Aql/Executor.h"
 #include "Aql/ExecutionEngine.h"
 #include "Aql/ExecutionPlan.h"
+#include "Aql/HashJoinNode.h"
+#include "Aql/IndexNode.h"
 #include "Aql/Optimizer.h"
 #include "Aql/Parser.h"
 #include "Aql/QueryCache.h"
 #include "Aql/QueryList.h"
-#include "Aql/ShortStringStorage.h"
+#include "Aql/QueryPlanCache.h"
+#include "Aql/Arena.h"
 #include "Basics/fasthash.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/json.h"
+#include "Basics/json-utilities.h"
 #include "Basics/tri-strings.h"
 #include "Basics/Exceptions.h"
 #include "Cluster/ServerState.h"
@@ -48,6 +52,7 @@
 #include "Utils/StandaloneTransactionContext.h"
 #include "Utils/V8TransactionContext.h"
 #include "V8/v8-conv.h"
+#include "V8/v8-json.h"
 #include "V8Server/ApplicationV8.h"
 #include "V8Server/v8-shape-conv.h"
 #include "VocBase/vocbase.h"
@@ -83,6 +88,293 @@ static std::string StateNames[] = {
 static_assert(sizeof(StateNames) / sizeof(std::string) == static_cast<size_t>(ExecutionState::INVALID_STATE), 
               "invalid number of ExecutionState values");
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collects the collections an expression refers to as a whole
+////////////////////////////////////////////////////////////////////////////////
+
+static void FindCollectionReferences (AstNode const* node,
+                                      std::unordered_set<std::string>& collections) {
+  if (node == nullptr) {
+    return;
+  }
+
+  if (node->type == NODE_TYPE_COLLECTION) {
+    collections.emplace(std::string(node->getStringValue(), node->getStringLength()));
+    return;
+  }
+
+  size_t const n = node->numMembers();
+
+  for (size_t i = 0; i < n; ++i) {
+    FindCollectionReferences(node->getMemberUnchecked(i), collections);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the comparison with the operands swapped
+////////////////////////////////////////////////////////////////////////////////
+
+static AstNodeType ReverseComparison (AstNodeType type) {
+  switch (type) {
+    case NODE_TYPE_OPERATOR_BINARY_LT:
+      return NODE_TYPE_OPERATOR_BINARY_GT;
+    case NODE_TYPE_OPERATOR_BINARY_LE:
+      return NODE_TYPE_OPERATOR_BINARY_GE;
+    case NODE_TYPE_OPERATOR_BINARY_GT:
+      return NODE_TYPE_OPERATOR_BINARY_LT;
+    case NODE_TYPE_OPERATOR_BINARY_GE:
+      return NODE_TYPE_OPERATOR_BINARY_LE;
+    default:
+      return type;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the intervals of attribute values an index node looks up to
+/// the dependency of the query cache on its collection
+///
+/// every document the node produces satisfies one of the OR branches of its
+/// condition. a branch is described by the constant comparisons of one of
+/// its attributes: the values of an equality or IN comparison, otherwise the
+/// intersection of the bounds. returns false if a branch has no such
+/// comparison, then the result depends on the whole collection
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AddIndexIntervals (IndexNode const* node,
+                               QueryCacheDependency& dependency) {
+  Condition const* condition = node->condition();
+
+  if (condition == nullptr || condition->isEmpty()) {
+    return false;
+  }
+
+  AstNode const* root = condition->root();
+
+  if (root->type != NODE_TYPE_OPERATOR_NARY_OR) {
+    return false;
+  }
+
+  Variable const* variable = node->outVariable();
+  std::pair<Variable const*, std::vector<triagens::basics::AttributeName>> access;
+
+  for (size_t i = 0; i < root->numMembers(); ++i) {
+    AstNode const* branch = root->getMemberUnchecked(i);
+
+    if (branch->type != NODE_TYPE_OPERATOR_NARY_AND) {
+      return false;
+    }
+
+    std::string attribute;
+    std::vector<QueryCacheInterval> values;
+    bool hasValues = false;
+    QueryCacheInterval bounds;
+
+    for (size_t j = 0; j < branch->numMembers(); ++j) {
+      AstNode const* part = branch->getMemberUnchecked(j);
+      AstNodeType type = part->type;
+
+      if (type != NODE_TYPE_OPERATOR_BINARY_EQ &&
+          type != NODE_TYPE_OPERATOR_BINARY_LT &&
+          type != NODE_TYPE_OPERATOR_BINARY_LE &&
+          type != NODE_TYPE_OPERATOR_BINARY_GT &&
+          type != NODE_TYPE_OPERATOR_BINARY_GE &&
+          type != NODE_TYPE_OPERATOR_BINARY_IN) {
+        continue;
+      }
+
+      AstNode const* lhs = part->getMember(0);
+      AstNode const* rhs = part->getMember(1);
+      AstNode const* value = nullptr;
+
+      if (lhs->isAttributeAccessForVariable(access) && 
+          access.first == variable && 
+          rhs->isConstant()) {
+        value = rhs;
+      }
+      else if (type != NODE_TYPE_OPERATOR_BINARY_IN &&
+               rhs->isAttributeAccessForVariable(access) && 
+               access.first == variable && 
+               lhs->isConstant()) {
+        value = lhs;
+        type = ReverseComparison(type);
+      }
+      else {
+        // e.g. a comparison with a variable of an outer loop
+        continue;
+      }
+
+      std::string name;
+      bool usable = true;
+
+      for (auto const& it : access.second) {
+        if (it.shouldExpand) {
+          usable = false;
+        }
+        if (! name.empty()) {
+          name.push_back('.');
+        }
+        name.append(it.name);
+      }
+
+      // the system attributes besides _key are not part of the shaped document
+      if (! usable ||
+          name == TRI_VOC_ATTRIBUTE_ID ||
+          name == TRI_VOC_ATTRIBUTE_REV ||
+          name == TRI_VOC_ATTRIBUTE_FROM ||
+          name == TRI_VOC_ATTRIBUTE_TO) {
+        continue;
+      }
+
+      if (attribute.empty()) {
+        attribute = name;
+      }
+      else if (attribute != name) {
+        continue;
+      }
+
+      if (type == NODE_TYPE_OPERATOR_BINARY_EQ || type == NODE_TYPE_OPERATOR_BINARY_IN) {
+        if (hasValues || (type == NODE_TYPE_OPERATOR_BINARY_IN && ! value->isArray())) {
+          // the values of one comparison are sufficient
+          continue;
+        }
+
+        size_t const n = (type == NODE_TYPE_OPERATOR_BINARY_IN ? value->numMembers() : 1);
+
+        for (size_t k = 0; k < n; ++k) {
+          AstNode const* member = (type == NODE_TYPE_OPERATOR_BINARY_IN ? value->getMemberUnchecked(k) : value);
+
+          QueryCacheInterval interval;
+          interval._lower.reset(member->toJsonValue(TRI_UNKNOWN_MEM_ZONE));
+          interval._upper.reset(member->toJsonValue(TRI_UNKNOWN_MEM_ZONE));
+
+          if (interval._lower == nullptr || interval._upper == nullptr) {
+            return false;
+          }
+
+          interval._lowerInclusive = true;
+          interval._upperInclusive = true;
+          values.emplace_back(std::move(interval));
+        }
+
+        hasValues = true;
+        continue;
+      }
+
+      std::unique_ptr<TRI_json_t> json(value->toJsonValue(TRI_UNKNOWN_MEM_ZONE));
+
+      if (json == nullptr) {
+        return false;
+      }
+
+      if (type == NODE_TYPE_OPERATOR_BINARY_LT || type == NODE_TYPE_OPERATOR_BINARY_LE) {
+        int res = (bounds._upper == nullptr ? -1 : TRI_CompareValuesJson(json.get(), bounds._upper.get(), true));
+
+        if (res < 0 || (res == 0 && type == NODE_TYPE_OPERATOR_BINARY_LT)) {
+          bounds._upper = std::move(json);
+          bounds._upperInclusive = (type == NODE_TYPE_OPERATOR_BINARY_LE);
+        }
+      }
+      else {
+        int res = (bounds._lower == nullptr ? 1 : TRI_CompareValuesJson(json.get(), bounds._lower.get(), true));
+
+        if (res > 0 || (res == 0 && type == NODE_TYPE_OPERATOR_BINARY_GT)) {
+          bounds._lower = std::move(json);
+          bounds._lowerInclusive = (type == NODE_TYPE_OPERATOR_BINARY_GE);
+        }
+      }
+    }
+
+    if (attribute.empty()) {
+      return false;
+    }
+
+    if (hasValues) {
+      for (auto& it : values) {
+        dependency.addInterval(attribute, std::move(it));
+      }
+    }
+    else {
+      dependency.addInterval(attribute, std::move(bounds));
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replace the bind parameter nodes in a plan from the plan cache with
+/// the values of the bind parameters. the plan is modified in place
+////////////////////////////////////////////////////////////////////////////////
+
+static void InjectBindParameters (Ast* ast,
+                                  TRI_json_t* json,
+                                  BindParametersType const& parameters) {
+  if (TRI_IsObjectJson(json)) {
+    TRI_json_t const* type = TRI_LookupObjectJson(json, "type");
+    TRI_json_t const* typeId = TRI_LookupObjectJson(json, "typeID");
+    TRI_json_t const* name = TRI_LookupObjectJson(json, "name");
+
+    if (TRI_IsNumberJson(typeId) &&
+        static_cast<int>(typeId->_value._number) == static_cast<int>(NODE_TYPE_PARAMETER) &&
+        TRI_IsStringJson(type) &&
+        strcmp(type->_value._string.data, "parameter") == 0 &&
+        TRI_IsStringJson(name)) {
+      // an AST node for a bind parameter
+      std::string const parameter(name->_value._string.data, name->_value._string.length - 1);
+      auto it = parameters.find(parameter);
+
+      if (it == parameters.end()) {
+        THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_BIND_PARAMETER_MISSING, parameter.c_str());
+      }
+
+      TRI_json_t* value = ast->nodeFromJson((*it).second.first, false)->toJson(TRI_UNKNOWN_MEM_ZONE, true);
+
+      // take over the contents of the value node
+      TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, json);
+      *json = *value;
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, value);
+      return;
+    }
+  }
+
+  if (TRI_IsObjectJson(json)) {
+    size_t const n = TRI_LengthVector(&json->_value._objects);
+
+    for (size_t i = 1; i < n; i += 2) {
+      InjectBindParameters(ast, static_cast<TRI_json_t*>(TRI_AtVector(&json->_value._objects, i)), parameters);
+    }
+  }
+  else if (TRI_IsArrayJson(json)) {
+    size_t const n = TRI_LengthVector(&json->_value._objects);
+
+    for (size_t i = 0; i < n; ++i) {
+      InjectBindParameters(ast, static_cast<TRI_json_t*>(TRI_AtVector(&json->_value._objects, i)), parameters);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the JSON for an executable plan from a plan of the plan cache
+////////////////////////////////////////////////////////////////////////////////
+
+static Json InstantiateCachedPlan (Ast* ast,
+                                   QueryPlanCacheEntry const* entry,
+                                   BindParameters& parameters) {
+  Json json(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, entry->_plan));
+
+  if (json.json() == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  InjectBindParameters(ast, json.json(), parameters());
+
+  return json;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    struct Profile
 // -----------------------------------------------------------------------------
@@ -95,7 +387,8 @@ Profile::Profile (Query* query)
   : query(query),
     results(),
     stamp(TRI_microtime()),
-    tracked(false) {
+    tracked(false),
+    plan() {
 
   auto queryList = static_cast<QueryList*>(query->vocbase()->_queries);
 
@@ -152,6 +445,9 @@ TRI_json_t* Profile::toJson (TRI_memory_zone_t*) {
   for (auto const& it : results) {
     result.set(StateNames[static_cast<int>(it.first)].c_str(), triagens::basics::Json(it.second));
   }
+  if (plan.json() != nullptr) {
+    result.set("plan", plan.copy());
+  }
   return result.steal();
 }
 
@@ -193,7 +489,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _options(options),
     _collections(vocbase),
     _strings(),
-    _shortStringStorage(1024),
+    _arena(4096),
     _ast(nullptr),
     _profile(nullptr),
     _state(INVALID_STATE),
@@ -206,7 +502,8 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _part(part),
     _contextOwnedByExterior(contextOwnedByExterior),
     _killed(false),
-    _isModificationQuery(false) {
+    _isModificationQuery(false),
+    _isResultCacheable(true) {
 
   // std::cout << TRI_CurrentThreadId() << ", QUERY " << this << " CTOR: " << queryString << "\n";
 
@@ -235,7 +532,7 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _options(options),
     _collections(vocbase),
     _strings(),
-    _shortStringStorage(1024),
+    _arena(4096),
     _ast(nullptr),
     _profile(nullptr),
     _state(INVALID_STATE),
@@ -248,7 +545,8 @@ Query::Query (triagens::arango::ApplicationV8* applicationV8,
     _part(part),
     _contextOwnedByExterior(contextOwnedByExterior),
     _killed(false),
-    _isModificationQuery(false) {
+    _isModificationQuery(false),
+    _isResultCacheable(true) {
 
   // std::cout << TRI_CurrentThreadId() << ", QUERY " << this << " CTOR (JSON): " << _queryJson.toString() << "\n";
 
@@ -296,9 +594,9 @@ Query::~Query () {
   for (auto& it : _strings) {
     TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, const_cast<char*>(it));
   }
-  // free nodes
+  // destruct nodes. their memory is owned by the arena
   for (auto& it : _nodes) {
-    delete it;
+    it->~AstNode();
   }
 }
 
@@ -506,21 +804,52 @@ QueryResult Query::prepare (QueryRegistry* registry) {
 
     std::unique_ptr<Parser> parser(new Parser(this));
     std::unique_ptr<ExecutionPlan> plan;
+
+    // plans for the plan cache are built with the bind parameters left in
+    // place, so they do not depend on the values and can be shared by all
+    // queries with the same bind parameter types
+    bool const usePlanCache = canUsePlanCache();
+    bool keepBindParameters = false;
+    uint64_t planHash = 0;
+    uint64_t planGeneration = 0;
+    std::string bindParameterTypes;
+    std::shared_ptr<QueryPlanCacheEntry> cachedPlan;
+
+    if (usePlanCache) {
+      // must be fetched before the plan is built, so a concurrent index or
+      // collection change prevents storing a stale plan
+      planGeneration = QueryPlanCache::instance()->generation();
+      bindParameterTypes = QueryPlanCache::BindParameterTypes(_bindParameters.json());
+      planHash = QueryPlanCache::Hash(_queryString, _queryLength, bindParameterTypes, _options);
+      cachedPlan = QueryPlanCache::instance()->lookup(_vocbase, planHash, _queryString, _queryLength, bindParameterTypes, _options);
+    }
     
-    if (_queryString != nullptr) {
-      parser->parse(false);
-      // put in bind parameters
-      parser->ast()->injectBindParameters(_bindParameters);
+    if (cachedPlan != nullptr) {
+      // no need to parse the query again
+      _isModificationQuery = cachedPlan->_isModificationQuery;
+      _isResultCacheable = cachedPlan->_isResultCacheable;
+
+      if (cachedPlan->_functionsMayAccessDocuments) {
+        parser->ast()->setFunctionsMayAccessDocuments();
+      }
     }
+    else {
+      if (_queryString != nullptr) {
+        parser->parse(false);
+        keepBindParameters = (usePlanCache && parser->ast()->canKeepBindParameters());
+        // put in bind parameters
+        parser->ast()->injectBindParameters(_bindParameters, keepBindParameters);
+      }
       
-    _isModificationQuery = parser->isModificationQuery();
+      _isModificationQuery = parser->isModificationQuery();
+    }
 
     // create the transaction object, but do not start it yet
     _trx = new triagens::arango::AqlTransaction(createTransactionContext(), _vocbase, _collections.collections(), _part == PART_MAIN);
 
     bool planRegisters;
 
-    if (_queryString != nullptr) {
+    if (_queryString != nullptr && cachedPlan == nullptr) {
       // we have an AST
       int res = _trx->begin();
 
@@ -550,12 +879,49 @@ QueryResult Query::prepare (QueryRegistry* registry) {
       // Now plan and all derived plans belong to the optimizer
       plan.reset(opt.stealBest()); // Now we own the best one again
       planRegisters = true;
+      _isResultCacheable = parser->ast()->root()->isCacheable();
+
+      if (keepBindParameters) {
+        // the plan still contains the bind parameters. the cached plan must
+        // already contain the register assignments, as it is instantiated
+        // from JSON later
+        plan->findVarUsage();
+        plan->planRegisters();
+
+        std::vector<std::string> collections;
+        for (auto const& it : *_collections.collections()) {
+          collections.emplace_back(it.first);
+        }
+
+        Json json = plan->toJson(parser->ast(), TRI_UNKNOWN_MEM_ZONE, true);
+        std::shared_ptr<QueryPlanCacheEntry> entry(new QueryPlanCacheEntry(planHash, _queryString, _queryLength, bindParameterTypes, _options, json.steal(), collections, _isModificationQuery, _isResultCacheable, parser->ast()->functionsMayAccessDocuments()));
+
+        if (_warnings.empty()) {
+          QueryPlanCache::instance()->store(_vocbase, entry, planGeneration);
+        }
+
+        // the plan to execute is created from the cached plan in the same way
+        // as on a cache hit. the AST reuses its variables for it
+        Json const planJson = InstantiateCachedPlan(parser->ast(), entry.get(), _bindParameters);
+        plan.reset();
+        plan.reset(ExecutionPlan::instantiateFromJson(parser->ast(), planJson));
+
+        if (plan.get() == nullptr) {
+          // oops
+          return QueryResult(TRI_ERROR_INTERNAL);
+        }
+
+        planRegisters = false;
+      }
     }
-    else {   // no queryString, we are instantiating from _queryJson
+    else {   // no queryString or cached plan, we are instantiating from JSON
       enterState(PLAN_INSTANTIATION);
-      ExecutionPlan::getCollectionsFromJson(parser->ast(), _queryJson);
+      Json const cachedJson = (cachedPlan != nullptr) ? InstantiateCachedPlan(parser->ast(), cachedPlan.get(), _bindParameters) : Json();
+      Json const& planJson = (cachedPlan != nullptr) ? cachedJson : _queryJson;
 
-      parser->ast()->variables()->fromJson(_queryJson);
+      ExecutionPlan::getCollectionsFromJson(parser->ast(), planJson);
+
+      parser->ast()->variables()->fromJson(planJson);
       // creating the plan may have produced some collections
       // we need to add them to the transaction now (otherwise the query will fail)
 
@@ -570,7 +936,7 @@ QueryResult Query::prepare (QueryRegistry* registry) {
       }
 
       // we have an execution plan in JSON format
-      plan.reset(ExecutionPlan::instantiateFromJson(parser->ast(), _queryJson));
+      plan.reset(ExecutionPlan::instantiateFromJson(parser->ast(), planJson));
       if (plan.get() == nullptr) {
         // oops
         return QueryResult(TRI_ERROR_INTERNAL);
@@ -635,6 +1001,7 @@ QueryResult Query::prepare (QueryRegistry* registry) {
 
 QueryResult Query::execute (QueryRegistry* registry) {
   try {
+    double const start = TRI_microtime();
     bool useQueryCache = canUseQueryCache();
     uint64_t queryStringHash = 0;
 
@@ -650,10 +1017,14 @@ QueryResult Query::execute (QueryRegistry* registry) {
         // got a result from the query cache
         QueryResult res(TRI_ERROR_NO_ERROR);
         res.warnings = warningsToJson(TRI_UNKNOWN_MEM_ZONE);
-        res.json     = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, cacheEntry->_queryResult);
+        res.json     = cacheEntry->queryResult();
         res.stats    = nullptr;
         res.cached   = true;
 
+        if (res.json == nullptr) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+        }
+
         return res;
       } 
     }
@@ -664,12 +1035,11 @@ QueryResult Query::execute (QueryRegistry* registry) {
       return res;
     }
 
-    if (useQueryCache && (_isModificationQuery || ! _warnings.empty() || ! _ast->root()->isCacheable())) {
+    if (useQueryCache && (_isModificationQuery || ! _warnings.empty() || ! _isResultCacheable)) {
       useQueryCache = false;
     }
 
     triagens::basics::Json jsonResult(triagens::basics::Json::Array, 16);
-    triagens::basics::Json stats;
 
     // this is the RegisterId our results can be found in
     auto const resultRegister = _engine->resultRegister();
@@ -704,8 +1074,10 @@ QueryResult Query::execute (QueryRegistry* registry) {
             queryStringHash, 
             _queryString, 
             _queryLength, 
-            TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, jsonResult.json()), 
-            _trx->collectionNames()
+            jsonResult.json(), 
+            TRI_microtime() - start,
+            _trx->collectionNames(),
+            cacheDependencies()
           );
         }
       }
@@ -735,7 +1107,47 @@ QueryResult Query::execute (QueryRegistry* registry) {
       throw;
     }
 
-    stats = _engine->_stats.toJson();
+    QueryResult result = finalize();
+    
+    if (result.code == TRI_ERROR_NO_ERROR) {
+      result.json = jsonResult.steal();
+    }
+
+    return result;
+  }
+  catch (triagens::basics::Exception const& ex) {
+    cleanupPlanAndEngine(ex.code());
+    return QueryResult(ex.code(), ex.message() + getStateString());
+  }
+  catch (std::bad_alloc const&) {
+    cleanupPlanAndEngine(TRI_ERROR_OUT_OF_MEMORY);
+    return QueryResult(TRI_ERROR_OUT_OF_MEMORY, TRI_errno_string(TRI_ERROR_OUT_OF_MEMORY) + getStateString());
+  }
+  catch (std::exception const& ex) {
+    cleanupPlanAndEngine(TRI_ERROR_INTERNAL);
+    return QueryResult(TRI_ERROR_INTERNAL, ex.what() + getStateString());
+  }
+  catch (...) {
+    cleanupPlanAndEngine(TRI_ERROR_INTERNAL);
+    return QueryResult(TRI_ERROR_INTERNAL, TRI_errno_string(TRI_ERROR_INTERNAL) + getStateString());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish a prepared query after its results have been fetched from
+/// the engine
+////////////////////////////////////////////////////////////////////////////////
+
+QueryResult Query::finalize () {
+  try {
+    TRI_ASSERT(_engine != nullptr);
+    TRI_ASSERT(_trx != nullptr);
+
+    triagens::basics::Json stats = _engine->_stats.toJson();
+
+    if (_profile != nullptr && profiling()) {
+      _profile->plan = profiledPlan();
+    }
 
     _trx->commit();
     
@@ -745,7 +1157,6 @@ QueryResult Query::execute (QueryRegistry* registry) {
 
     QueryResult result(TRI_ERROR_NO_ERROR);
     result.warnings = warningsToJson(TRI_UNKNOWN_MEM_ZONE);
-    result.json     = jsonResult.steal();
     result.stats    = stats.steal(); 
 
     if (_profile != nullptr && profiling()) {
@@ -780,6 +1191,7 @@ QueryResult Query::execute (QueryRegistry* registry) {
 QueryResultV8 Query::executeV8 (v8::Isolate* isolate, 
                                 QueryRegistry* registry) {
   try {
+    double const start = TRI_microtime();
     bool useQueryCache = canUseQueryCache();
     uint64_t queryStringHash = 0;
 
@@ -794,7 +1206,7 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate,
       if (cacheEntry != nullptr) {
         // got a result from the query cache
         QueryResultV8 res(TRI_ERROR_NO_ERROR);
-        res.result = v8::Handle<v8::Array>::Cast(TRI_ObjectJson(isolate, cacheEntry->_queryResult));
+        res.result = v8::Handle<v8::Array>::Cast(TRI_FromJsonString(isolate, cacheEntry->_queryResult, nullptr));
         res.cached = true;
         return res;
       } 
@@ -806,7 +1218,7 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate,
       return res;
     }
 
-    if (useQueryCache && (_isModificationQuery || ! _warnings.empty() || ! _ast->root()->isCacheable())) {
+    if (useQueryCache && (_isModificationQuery || ! _warnings.empty() || ! _isResultCacheable)) {
       useQueryCache = false;
     }
 
@@ -851,9 +1263,10 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate,
             _queryString, 
             _queryLength, 
             cacheResult.get(), 
-            _trx->collectionNames()
+            TRI_microtime() - start,
+            _trx->collectionNames(),
+            cacheDependencies()
           );
-          cacheResult.release();
         }
       }
       else {
@@ -883,6 +1296,10 @@ QueryResultV8 Query::executeV8 (v8::Isolate* isolate,
 
     stats = _engine->_stats.toJson();
 
+    if (_profile != nullptr && profiling()) {
+      _profile->plan = profiledPlan();
+    }
+
     _trx->commit();
     
     cleanupPlanAndEngine(TRI_ERROR_NO_ERROR);
@@ -1067,8 +1484,8 @@ char* Query::registerString (char const* p,
     return const_cast<char*>(EmptyString);
   }
 
-  if (length < ShortStringStorage::MaxStringLength) {
-    return _shortStringStorage.registerString(p, length); 
+  if (length < Arena::MaxStringLength) {
+    return _arena.registerString(p, length); 
   }
 
   char* copy = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, p, length);
@@ -1322,6 +1739,87 @@ bool Query::canUseQueryCache () const {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dependencies of the query result on the documents of the
+/// collections, for the query cache. collections without a dependency are
+/// fully depended on
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<QueryCacheDependency> Query::cacheDependencies () const {
+  std::vector<QueryCacheDependency> result;
+
+  if (_plan == nullptr || _ast->functionsMayAccessDocuments()) {
+    // functions may read documents of any collection
+    return result;
+  }
+
+  if (! _plan->findNodesOfType(ExecutionNode::TRAVERSAL, true).empty()) {
+    return result;
+  }
+
+  // collections that are scanned, joined or used as a whole in an expression
+  std::unordered_set<std::string> full;
+
+  for (auto const& it : _plan->findNodesOfType(ExecutionNode::ENUMERATE_COLLECTION, true)) {
+    full.emplace(static_cast<EnumerateCollectionNode const*>(it)->collection()->getName());
+  }
+
+  for (auto const& it : _plan->findNodesOfType(ExecutionNode::HASH_JOIN, true)) {
+    full.emplace(static_cast<HashJoinNode const*>(it)->collection()->getName());
+  }
+
+  for (auto const& it : _plan->findNodesOfType(ExecutionNode::CALCULATION, true)) {
+    FindCollectionReferences(static_cast<CalculationNode const*>(it)->expression()->node(), full);
+  }
+
+  std::unordered_map<std::string, QueryCacheDependency> dependencies;
+
+  for (auto const& it : _plan->findNodesOfType(ExecutionNode::INDEX, true)) {
+    auto node = static_cast<IndexNode const*>(it);
+    std::string const name = node->collection()->getName();
+
+    if (full.find(name) != full.end()) {
+      continue;
+    }
+
+    auto it2 = dependencies.find(name);
+
+    if (it2 == dependencies.end()) {
+      it2 = dependencies.emplace(name, QueryCacheDependency(name)).first;
+    }
+
+    if (! AddIndexIntervals(node, (*it2).second)) {
+      full.emplace(name);
+      dependencies.erase(it2);
+    }
+  }
+
+  for (auto& it : dependencies) {
+    it.second.finalize();
+    result.emplace_back(std::move(it.second));
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the plan cache can be used for the query
+////////////////////////////////////////////////////////////////////////////////
+
+bool Query::canUsePlanCache () const {
+  if (_queryString == nullptr || _part != PART_MAIN) {
+    return false;
+  }
+
+  if (! QueryPlanCache::instance()->isActive()) {
+    return false;
+  }
+
+  // plans on a coordinator contain remote nodes for the current cluster
+  // setup, so they are not cached 
+  return ! triagens::arango::ServerState::instance()->isRunningInCluster();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fetch a numeric value from the options
 ////////////////////////////////////////////////////////////////////////////////
@@ -1483,6 +1981,59 @@ void Query::setPlan (ExecutionPlan *plan) {
   _plan = plan;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the executed plan with the runtime figures of its nodes.
+/// the runtime of a node includes the time of its dependencies, selfTime
+/// does not
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json Query::profiledPlan () const {
+  TRI_ASSERT(_engine != nullptr);
+
+  if (_plan == nullptr) {
+    return triagens::basics::Json();
+  }
+
+  auto const profiles = _engine->blockProfiles();
+  triagens::basics::Json plan = _plan->toJson(_ast, TRI_UNKNOWN_MEM_ZONE, false);
+  triagens::basics::Json nodes = plan.get("nodes");
+
+  if (! nodes.isArray()) {
+    return plan;
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    triagens::basics::Json node = nodes.at(i);
+    auto it = profiles.find(triagens::basics::JsonHelper::getNumericValue<size_t>(node.json(), "id", 0));
+
+    if (it == profiles.end()) {
+      continue;
+    }
+
+    ExecutionBlockProfile const& profile = (*it).second;
+    double selfTime = profile.runtime;
+    triagens::basics::Json dependencies = node.get("dependencies");
+
+    for (size_t j = 0; dependencies.isArray() && j < dependencies.size(); ++j) {
+      auto dep = profiles.find(triagens::basics::JsonHelper::getNumericValue<size_t>(dependencies.at(j).json(), 0));
+
+      if (dep != profiles.end()) {
+        selfTime -= (*dep).second.runtime;
+      }
+    }
+
+    node.set("profile", triagens::basics::Json(triagens::basics::Json::Object, 6)
+      ("calls", triagens::basics::Json(static_cast<double>(profile.calls)))
+      ("items", triagens::basics::Json(static_cast<double>(profile.items)))
+      ("skipped", triagens::basics::Json(static_cast<double>(profile.skipped)))
+      ("runtime", triagens::basics::Json(profile.runtime))
+      ("selfTime", triagens::basics::Json(selfTime > 0.0 ? selfTime : 0.0))
+      ("peakMemory", triagens::basics::Json(static_cast<double>(profile.peakMemory))));
+  }
+
+  return plan;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a TransactionContext
 ////////////////////////////////////////////////////////////////////////////////
@@ -33,9 +33,9 @@
 #include "Basics/Common.h"
 #include "Basics/JsonHelper.h"
 #include "Aql/BindParameters.h"
+#include "Aql/Arena.h"
 #include "Aql/Collections.h"
 #include "Aql/QueryResultV8.h"
-#include "Aql/ShortStringStorage.h"
 #include "Aql/types.h"
 #include "Utils/AqlTransaction.h"
 #include "Utils/V8TransactionContext.h"
@@ -60,6 +60,7 @@ namespace triagens {
     class Expression;
     class Parser;
     class Query;
+    struct QueryCacheDependency;
     class QueryRegistry;
     struct Variable;
 
@@ -112,6 +113,12 @@ namespace triagens {
       std::vector<std::pair<ExecutionState, double>> results;
       double                                         stamp;
       bool                                           tracked;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the executed plan with the runtime figures of its nodes
+////////////////////////////////////////////////////////////////////////////////
+
+      triagens::basics::Json                         plan;
     };
 
 // -----------------------------------------------------------------------------
@@ -248,6 +255,14 @@ namespace triagens {
 
         void addNode (AstNode*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the query's memory arena, used for AstNodes and short strings
+////////////////////////////////////////////////////////////////////////////////
+
+        inline Arena* arena () {
+          return &_arena;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief should we return verbose plans?
 ////////////////////////////////////////////////////////////////////////////////
@@ -272,6 +287,74 @@ namespace triagens {
           return getBooleanOption("profile", false);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief should simple calculations be executed column-wise?
+////////////////////////////////////////////////////////////////////////////////
+
+        bool columnar () const {  
+          return getBooleanOption("columnar", false);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief are the results streamed into a cursor? if so, execution will be
+/// suspended after each batch and may be resumed by another thread
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isStreaming () const {  
+          return getBooleanOption("stream", false);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows a SORT may keep in memory before it writes sorted
+/// runs to temporary files. 0 means the SORT never spills to disk
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t sortSpillThreshold () const { 
+          double value = getNumericOption("sortSpillThreshold", 0.0);
+          if (value > 0) {
+            return static_cast<size_t>(value);
+          }
+          return 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of batches a coordinator requests ahead from each DB server
+/// while it processes the current batch. 0 turns read-ahead off
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t remotePrefetchDepth () const { 
+          double value = getNumericOption("remotePrefetchDepth", 1.0);
+          if (value > 0) {
+            return static_cast<size_t>(value);
+          }
+          return 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of groups a hashed COLLECT may keep in memory before it
+/// writes them to temporary files. 0 means the COLLECT never spills to disk
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t collectSpillThreshold () const { 
+          double value = getNumericOption("collectSpillThreshold", 0.0);
+          if (value > 0) {
+            return static_cast<size_t>(value);
+          }
+          return 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads a full collection scan may use
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t scanThreads () const { 
+          double value = getNumericOption("scanThreads", 1.0);
+          if (value > 1) {
+            return (std::min)(static_cast<size_t>(value), static_cast<size_t>(64));
+          }
+          return 1;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum number of plans to produce
 ////////////////////////////////////////////////////////////////////////////////
@@ -341,6 +424,14 @@ namespace triagens {
 
         QueryResult execute (QueryRegistry*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish a prepared query after its results have been fetched from
+/// the engine. commits the transaction and returns the warnings, statistics
+/// and profile of the query, but no result
+////////////////////////////////////////////////////////////////////////////////
+
+        QueryResult finalize ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief execute an AQL query 
 /// may only be called with an active V8 handle scope
@@ -507,6 +598,19 @@ namespace triagens {
 
         bool canUseQueryCache () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dependencies of the query result on the documents of the
+/// collections, for the query cache
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<QueryCacheDependency> cacheDependencies () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the plan cache can be used for the query
+////////////////////////////////////////////////////////////////////////////////
+
+        bool canUsePlanCache () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fetch a numeric value from the options
 ////////////////////////////////////////////////////////////////////////////////
@@ -550,6 +654,13 @@ namespace triagens {
 
         void cleanupPlanAndEngine (int);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the executed plan, with the runtime figures of the engine
+/// in the attribute "profile" of each node
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json profiledPlan () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a TransactionContext
 ////////////////////////////////////////////////////////////////////////////////
@@ -641,10 +752,11 @@ namespace triagens {
         std::vector<char const*>          _strings;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief short string storage. uses less memory allocations for short strings
+/// @brief memory arena for AstNodes and short strings. everything in it is
+/// released in one go when the query is destroyed
 ////////////////////////////////////////////////////////////////////////////////
 
-        ShortStringStorage                _shortStringStorage;
+        Arena                             _arena;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief _ast, we need an ast to manage the memory for AstNodes, even
@@ -727,6 +839,13 @@ namespace triagens {
 
         bool                              _isModificationQuery;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the query result may be stored in the query cache.
+/// this depends on the functions used in the query
+////////////////////////////////////////////////////////////////////////////////
+
+        bool                              _isResultCacheable;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not query tracking is disabled globally
 ////////////////////////////////////////////////////////////////////////////////
@@ -29,12 +29,16 @@
 
 #include "Aql/QueryCache.h"
 #include "Basics/fasthash.h"
+#include "Basics/hashes.h"
 #include "Basics/json.h"
+#include "Basics/json-utilities.h"
 #include "Basics/Exceptions.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/ReadLocker.h"
+#include "Basics/StringBuffer.h"
 #include "Basics/tri-strings.h"
 #include "Basics/WriteLocker.h"
+#include "Statistics/MetricsRegistry.h"
 #include "VocBase/vocbase.h"
 
 using namespace triagens::aql;
@@ -55,12 +59,173 @@ static triagens::aql::QueryCache Instance;
 
 static size_t MaxResults = 128; // default value. can be changed later
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory usage of the results in each per-database cache
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t MaxResultsSize = 64 * 1024 * 1024; // default value. can be changed later
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the execution time assumed for results that were computed faster,
+/// so that their priority still depends on their size
+////////////////////////////////////////////////////////////////////////////////
+
+static double const MinExecutionTime = 0.000001;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the cache is enabled
 ////////////////////////////////////////////////////////////////////////////////
 
 static std::atomic<triagens::aql::QueryCacheMode> Mode(CACHE_ON_DEMAND);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                         struct QueryCacheInterval
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a value is in the interval, nullptr is compared as null
+////////////////////////////////////////////////////////////////////////////////
+
+bool QueryCacheInterval::contains (TRI_json_t const* value) const {
+  if (_lower != nullptr) {
+    int res = TRI_CompareValuesJson(value, _lower.get(), true);
+
+    if (res < 0 || (res == 0 && ! _lowerInclusive)) {
+      return false;
+    }
+  }
+
+  if (_upper != nullptr) {
+    int res = TRI_CompareValuesJson(value, _upper.get(), true);
+
+    if (res > 0 || (res == 0 && ! _upperInclusive)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the memory used by the bounds
+////////////////////////////////////////////////////////////////////////////////
+
+size_t QueryCacheInterval::memoryUsage () const {
+  size_t result = sizeof(QueryCacheInterval);
+
+  if (_lower != nullptr) {
+    result += TRI_MemoryUsageJson(_lower.get());
+  }
+
+  if (_upper != nullptr) {
+    result += TRI_MemoryUsageJson(_upper.get());
+  }
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       struct QueryCacheDependency
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an interval of an attribute path
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCacheDependency::addInterval (std::string const& attribute,
+                                        QueryCacheInterval&& interval) {
+  TRI_ASSERT(_type == DEPENDENCY_RANGES);
+
+  _ranges[attribute].emplace_back(std::move(interval));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns a dependency on single values of _key into a key set, which
+/// is checked with a single lookup
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCacheDependency::finalize () {
+  if (_type != DEPENDENCY_RANGES || 
+      _ranges.size() != 1 ||
+      _ranges.begin()->first != TRI_VOC_ATTRIBUTE_KEY) {
+    return;
+  }
+
+  auto const& intervals = _ranges.begin()->second;
+
+  for (auto const& it : intervals) {
+    if (! TRI_IsStringJson(it._lower.get()) ||
+        ! it._lowerInclusive ||
+        ! it._upperInclusive ||
+        ! TRI_CheckSameValueJson(it._lower.get(), it._upper.get())) {
+      // not a single key
+      return;
+    }
+  }
+
+  for (auto const& it : intervals) {
+    _keys.emplace(std::string(it._lower->_value._string.data, it._lower->_value._string.length - 1));
+  }
+
+  _type = DEPENDENCY_KEYS;
+  _ranges.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a version of a written document may change the result
+////////////////////////////////////////////////////////////////////////////////
+
+bool QueryCacheDependency::isAffectedBy (QueryCacheDocument const* document) const {
+  switch (_type) {
+    case DEPENDENCY_FULL: {
+      return true;
+    }
+
+    case DEPENDENCY_KEYS: {
+      return (_keys.find(document->key()) != _keys.end());
+    }
+
+    case DEPENDENCY_RANGES: {
+      for (auto const& it : _ranges) {
+        std::unique_ptr<TRI_json_t> value(document->attribute(it.first));
+
+        for (auto const& interval : it.second) {
+          if (interval.contains(value.get())) {
+            return true;
+          }
+        }
+      }
+
+      return false;
+    }
+  }
+
+  TRI_ASSERT(false);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the memory used by the keys and intervals
+////////////////////////////////////////////////////////////////////////////////
+
+size_t QueryCacheDependency::memoryUsage () const {
+  size_t result = sizeof(QueryCacheDependency) + _collection.size();
+
+  for (auto const& it : _keys) {
+    result += sizeof(std::string) + it.size();
+  }
+
+  for (auto const& it : _ranges) {
+    result += it.first.size();
+
+    for (auto const& interval : it.second) {
+      result += interval.memoryUsage();
+    }
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      struct QueryCacheResultEntry
 // -----------------------------------------------------------------------------
@@ -72,23 +237,59 @@ static std::atomic<triagens::aql::QueryCacheMode> Mode(CACHE_ON_DEMAND);
 QueryCacheResultEntry::QueryCacheResultEntry (uint64_t hash,
                                               char const* queryString,
                                               size_t queryStringLength,
-                                              TRI_json_t* queryResult,
-                                              std::vector<std::string> const& collections)
+                                              TRI_json_t const* queryResult,
+                                              double executionTime,
+                                              std::vector<std::string> const& collections,
+                                              std::vector<QueryCacheDependency>&& dependencies)
   : _hash(hash),
     _queryString(nullptr),
     _queryStringLength(queryStringLength),
-    _queryResult(queryResult),
+    _queryResult(nullptr),
+    _queryResultLength(0),
+    _executionTime((std::max)(executionTime, MinExecutionTime)),
+    _frequency(1),
+    _clock(0.0),
     _collections(collections),
+    _dependencies(std::move(dependencies)),
     _prev(nullptr),
     _next(nullptr),
     _refCount(0),
-    _deletionRequested(0) {
+    _deletionRequested(0),
+    _memoryUsage(0) {
 
   _queryString = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, queryString, queryStringLength);
 
   if (_queryString == nullptr) {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
+
+  {
+    triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+    int res = TRI_StringifyJson(buffer.stringBuffer(), queryResult);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      // copy the result, so it does not keep the spare capacity of the buffer
+      _queryResultLength = buffer.length();
+      _queryResult = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, buffer.c_str(), _queryResultLength);
+
+      if (_queryResult == nullptr) {
+        res = TRI_ERROR_OUT_OF_MEMORY;
+      }
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, _queryString);
+      THROW_ARANGO_EXCEPTION(res);
+    }
+  }
+
+  _memoryUsage = sizeof(QueryCacheResultEntry) + queryStringLength + 1 + _queryResultLength + 1;
+
+  for (auto const& it : _dependencies) {
+    _memoryUsage += it.memoryUsage();
+  }
+
+  TRI_AddMemoryZoneUsage(TRI_QUERY_CACHE_MEM_ZONE, (int64_t) _memoryUsage, 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -96,8 +297,10 @@ QueryCacheResultEntry::QueryCacheResultEntry (uint64_t hash,
 ////////////////////////////////////////////////////////////////////////////////
 
 QueryCacheResultEntry::~QueryCacheResultEntry () {
-  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _queryResult);
+  TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, _queryResult);
   TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, _queryString);
+
+  TRI_AddMemoryZoneUsage(TRI_QUERY_CACHE_MEM_ZONE, - (int64_t) _memoryUsage, -1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,6 +338,38 @@ void QueryCacheResultEntry::unuse () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dependency on a collection, nullptr if the entry depends on
+/// all of its documents
+////////////////////////////////////////////////////////////////////////////////
+
+QueryCacheDependency const* QueryCacheResultEntry::dependency (std::string const& collection) const {
+  for (auto const& it : _dependencies) {
+    if (it._collection == collection) {
+      return (it._type == QueryCacheDependency::DEPENDENCY_FULL ? nullptr : &it);
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the query result, returns nullptr if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* QueryCacheResultEntry::queryResult () const {
+  return TRI_Json2StringLength(TRI_UNKNOWN_MEM_ZONE, _queryResult, _queryResultLength, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the eviction priority
+////////////////////////////////////////////////////////////////////////////////
+
+double QueryCacheResultEntry::priority () const {
+  return _clock.load(std::memory_order_relaxed) +
+         static_cast<double>(_frequency.load(std::memory_order_relaxed)) * _executionTime / static_cast<double>(_memoryUsage);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                    struct QueryCacheDatabaseEntry
 // -----------------------------------------------------------------------------
@@ -148,7 +383,13 @@ QueryCacheDatabaseEntry::QueryCacheDatabaseEntry ()
     _entriesByCollection(),
     _head(nullptr),
     _tail(nullptr),
-    _numElements(0) {
+    _numElements(0),
+    _memoryUsage(0),
+    _clock(0.0),
+    _hits(0),
+    _misses(0),
+    _evictions(0),
+    _invalidations(0) {
   
   _entriesByHash.reserve(128);
   _entriesByCollection.reserve(16);
@@ -178,6 +419,7 @@ QueryCacheResultEntry* QueryCacheDatabaseEntry::lookup (uint64_t hash,
 
   if (it == _entriesByHash.end()) {
     // not found in cache
+    ++_misses;
     return nullptr;
   }
 
@@ -186,6 +428,7 @@ QueryCacheResultEntry* QueryCacheDatabaseEntry::lookup (uint64_t hash,
   if (queryStringLength != (*it).second->_queryStringLength ||
       strcmp(queryString, (*it).second->_queryString) != 0) {
     // found something, but obviously the result of a different query with the same hash
+    ++_misses;
     return nullptr;
   }
 
@@ -194,6 +437,11 @@ QueryCacheResultEntry* QueryCacheDatabaseEntry::lookup (uint64_t hash,
 
   // mark the entry as being used so noone else can delete it while it is in use
   entry->use();
+
+  // raise its priority. the clock is only changed under the write lock
+  ++entry->_frequency;
+  entry->_clock.store(_clock, std::memory_order_relaxed);
+  ++_hits;
   
   return entry;
 }
@@ -202,17 +450,16 @@ QueryCacheResultEntry* QueryCacheDatabaseEntry::lookup (uint64_t hash,
 /// @brief store a query result in the database-specific cache
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCacheDatabaseEntry::store (uint64_t hash,
-                                     QueryCacheResultEntry* entry) {
+uint64_t QueryCacheDatabaseEntry::store (uint64_t hash,
+                                         QueryCacheResultEntry* entry) {
+  entry->_clock.store(_clock, std::memory_order_relaxed);
 
   // insert entry into the cache
   if (! _entriesByHash.emplace(hash, entry).second) {
     // remove previous entry
     auto it = _entriesByHash.find(hash);
     TRI_ASSERT(it != _entriesByHash.end());
-    unlink((*it).second);
-    _entriesByHash.erase(it);
-    tryDelete((*it).second);
+    remove((*it).second);
 
     // and insert again
     _entriesByHash.emplace(hash, entry);
@@ -244,25 +491,17 @@ void QueryCacheDatabaseEntry::store (uint64_t hash,
       }
     }
 
-    // finally remove entry itself from hash table
-    auto it = _entriesByHash.find(hash);
-    TRI_ASSERT(it != _entriesByHash.end());
-    _entriesByHash.erase(it);
-    unlink((*it).second);
-    tryDelete((*it).second);
+    // finally remove entry itself from hash table. it is not linked yet,
+    // and the caller still owns it
+    _entriesByHash.erase(hash);
     throw;
   }
 
 
   link(entry);
 
-  enforceMaxResults(MaxResults);
-
-  TRI_ASSERT(_numElements <= MaxResults);
-  TRI_ASSERT(_head != nullptr);
-  TRI_ASSERT(_tail != nullptr);
-  TRI_ASSERT(_tail == entry);
-  TRI_ASSERT(entry->_next == nullptr);
+  // the new entry may be evicted right away if its priority is the lowest
+  return enforceLimits(MaxResults, MaxResultsSize);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,10 +509,14 @@ void QueryCacheDatabaseEntry::store (uint64_t hash,
 /// database-specific cache
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCacheDatabaseEntry::invalidate (std::vector<char const*> const& collections) {
+uint64_t QueryCacheDatabaseEntry::invalidate (std::vector<char const*> const& collections) {
+  uint64_t count = 0;
+
   for (auto const& it : collections) {
-    invalidate(it);
+    count += invalidate(it);
   }
+
+  return count;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -281,54 +524,166 @@ void QueryCacheDatabaseEntry::invalidate (std::vector<char const*> const& collec
 /// cache
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCacheDatabaseEntry::invalidate (char const* collection) {
+uint64_t QueryCacheDatabaseEntry::invalidate (char const* collection) {
   auto it = _entriesByCollection.find(std::string(collection));
 
   if (it == _entriesByCollection.end()) {
-    return;
+    return 0;
   }
+
+  std::vector<QueryCacheResultEntry*> entries;
+  entries.reserve((*it).second.size());
  
   for (auto& it2 : (*it).second) {
     auto it3 = _entriesByHash.find(it2);
 
     if (it3 != _entriesByHash.end()) {
-      // remove entry from the linked list
-      auto entry = (*it3).second;
-      unlink(entry);
+      entries.emplace_back((*it3).second);
+    }
+  }
+
+  // removing the entries also removes them from the collection
+  for (auto& entry : entries) {
+    remove(entry);
+  }
+
+  _invalidations += entries.size();
+
+  return static_cast<uint64_t>(entries.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the entries for a collection in the database-specific
+/// cache that may be changed by the written document versions
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCacheDatabaseEntry::invalidate (char const* collection,
+                                          std::vector<QueryCacheDocument const*> const& documents,
+                                          QueryCacheInvalidations& invalidations) {
+  std::string const name(collection);
+  auto it = _entriesByCollection.find(name);
+
+  if (it == _entriesByCollection.end()) {
+    return;
+  }
+
+  std::vector<QueryCacheResultEntry*> entries;
+ 
+  for (auto& it2 : (*it).second) {
+    auto it3 = _entriesByHash.find(it2);
+
+    if (it3 == _entriesByHash.end()) {
+      continue;
+    }
+
+    auto entry = (*it3).second;
+    auto dependency = entry->dependency(name);
+
+    if (dependency == nullptr) {
+      // the entry depends on all documents of the collection
+      ++invalidations._full;
+      entries.emplace_back(entry);
+      continue;
+    }
+
+    bool affected = false;
 
-      // erase it from hash table
-      _entriesByHash.erase(it3);
+    for (auto const& document : documents) {
+      if (dependency->isAffectedBy(document)) {
+        affected = true;
+        break;
+      }
+    }
 
-      // delete the object itself
-      tryDelete(entry);
+    if (! affected) {
+      ++invalidations._kept;
+    }
+    else {
+      if (dependency->_type == QueryCacheDependency::DEPENDENCY_KEYS) {
+        ++invalidations._key;
+      }
+      else {
+        ++invalidations._range;
+      }
+
+      entries.emplace_back(entry);
     }
   }
 
-  _entriesByCollection.erase(it);
+  for (auto& entry : entries) {
+    remove(entry);
+  }
+
+  _invalidations += entries.size();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief enforce maximum number of results
+/// @brief enforce maximum number and memory usage of results
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCacheDatabaseEntry::enforceMaxResults (size_t value) {
-  while (_numElements > value) {
-    // too many elements. now wipe the first element from the list
+uint64_t QueryCacheDatabaseEntry::enforceLimits (size_t maxResults,
+                                                 size_t maxResultsSize) {
+  uint64_t evicted = 0;
 
-    // copy old _head value as unlink() will change it...
-    auto head = _head;
-    unlink(head);
-    auto it = _entriesByHash.find(head->_hash);
-    TRI_ASSERT(it != _entriesByHash.end());
-    _entriesByHash.erase(it);
-    tryDelete(head);
+  while (_numElements > maxResults || _memoryUsage > maxResultsSize) {
+    evict();
+    ++evicted;
   }
+
+  _evictions += evicted;
+
+  return evicted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the statistics of the database-specific cache
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json QueryCacheDatabaseEntry::statistics () const {
+  triagens::basics::Json json(triagens::basics::Json::Object, 6);
+  json("results", triagens::basics::Json(static_cast<double>(_numElements)));
+  json("memoryUsage", triagens::basics::Json(static_cast<double>(_memoryUsage)));
+  json("hits", triagens::basics::Json(static_cast<double>(_hits.load())));
+  json("misses", triagens::basics::Json(static_cast<double>(_misses.load())));
+  json("evictions", triagens::basics::Json(static_cast<double>(_evictions)));
+  json("invalidations", triagens::basics::Json(static_cast<double>(_invalidations)));
+
+  return json;
 }
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evict the entry with the lowest priority
+///
+/// this is greedy-dual-size-frequency: the clock advances to the priority of
+/// the evicted entry, and entries get the current clock added whenever they
+/// are stored or hit. entries that are not used anymore are thus evicted
+/// eventually, however expensive they were. the priorities change on hits,
+/// which only hold the read lock, so the entry is searched for linearly
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCacheDatabaseEntry::evict () {
+  TRI_ASSERT(_head != nullptr);
+
+  QueryCacheResultEntry* victim = _head;
+  double lowest = victim->priority();
+
+  for (auto e = _head->_next; e != nullptr; e = e->_next) {
+    double const priority = e->priority();
+
+    if (priority < lowest) {
+      victim = e;
+      lowest = priority;
+    }
+  }
+
+  _clock = (std::max)(_clock, lowest);
+  remove(victim);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check whether the element can be destroyed, and delete it if yes
 ////////////////////////////////////////////////////////////////////////////////
@@ -337,6 +692,33 @@ void QueryCacheDatabaseEntry::tryDelete (QueryCacheResultEntry* e) {
   e->tryDelete();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a linked result entry from the cache and delete it
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCacheDatabaseEntry::remove (QueryCacheResultEntry* e) {
+  for (auto const& it : e->_collections) {
+    auto it2 = _entriesByCollection.find(it);
+
+    if (it2 != _entriesByCollection.end()) {
+      (*it2).second.erase(e->_hash);
+
+      if ((*it2).second.empty()) {
+        _entriesByCollection.erase(it2);
+      }
+    }
+  }
+
+  auto it = _entriesByHash.find(e->_hash);
+
+  if (it != _entriesByHash.end() && (*it).second == e) {
+    _entriesByHash.erase(it);
+  }
+
+  unlink(e);
+  tryDelete(e);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief unlink the result entry from the list
 ////////////////////////////////////////////////////////////////////////////////
@@ -361,6 +743,9 @@ void QueryCacheDatabaseEntry::unlink (QueryCacheResultEntry* e) {
 
   TRI_ASSERT(_numElements > 0);
   --_numElements;
+
+  TRI_ASSERT(_memoryUsage >= e->_memoryUsage);
+  _memoryUsage -= e->_memoryUsage;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -369,6 +754,7 @@ void QueryCacheDatabaseEntry::unlink (QueryCacheResultEntry* e) {
  
 void QueryCacheDatabaseEntry::link (QueryCacheResultEntry* e) {
   ++_numElements;
+  _memoryUsage += e->_memoryUsage;
 
   if (_head == nullptr) {
     // list is empty
@@ -403,7 +789,15 @@ void QueryCacheDatabaseEntry::link (QueryCacheResultEntry* e) {
 QueryCache::QueryCache () 
   : _propertiesLock(),
     _entriesLock(),
-    _entries() {
+    _entries(),
+    _hits(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_hits_total", "Number of AQL query cache lookups that found a result")),
+    _misses(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_misses_total", "Number of AQL query cache lookups that did not find a result")),
+    _invalidatedCollection(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_invalidations_total", "Number of invalidated AQL query cache results", "reason=\"collection\"")),
+    _invalidatedFull(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_invalidations_total", "Number of invalidated AQL query cache results", "reason=\"full\"")),
+    _invalidatedKey(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_invalidations_total", "Number of invalidated AQL query cache results", "reason=\"key\"")),
+    _invalidatedRange(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_invalidations_total", "Number of invalidated AQL query cache results", "reason=\"range\"")),
+    _kept(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_kept_total", "Number of AQL query cache results kept on a write to one of their collections")),
+    _evictions(triagens::basics::MetricsRegistry::instance()->counter("arangodb_aql_query_cache_evictions_total", "Number of AQL query cache results evicted to stay within the limits")) {
 
 }
 
@@ -426,9 +820,10 @@ QueryCache::~QueryCache () {
 triagens::basics::Json QueryCache::properties () {
   MUTEX_LOCKER(_propertiesLock);
 
-  triagens::basics::Json json(triagens::basics::Json::Object, 2);
+  triagens::basics::Json json(triagens::basics::Json::Object, 3);
   json("mode", triagens::basics::Json(modeString(mode()))); 
   json("maxResults", triagens::basics::Json(static_cast<double>(MaxResults)));
+  json("maxResultsSize", triagens::basics::Json(static_cast<double>(MaxResultsSize)));
 
   return json;
 }
@@ -437,22 +832,42 @@ triagens::basics::Json QueryCache::properties () {
 /// @brief return the cache properties
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCache::properties (std::pair<std::string, size_t>& result) {
+void QueryCache::properties (QueryCacheProperties& result) {
   MUTEX_LOCKER(_propertiesLock);
   
-  result.first  = modeString(mode());
-  result.second = MaxResults;
+  result.mode           = modeString(mode());
+  result.maxResults     = MaxResults;
+  result.maxResultsSize = MaxResultsSize;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set the cache properties
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCache::setProperties (std::pair<std::string, size_t> const& properties) {
+void QueryCache::setProperties (QueryCacheProperties const& properties) {
   MUTEX_LOCKER(_propertiesLock);
 
-  setMode(properties.first);
-  setMaxResults(properties.second);
+  setMode(properties.mode);
+  setLimits(properties.maxResults, properties.maxResultsSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the statistics of the cache of a database
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json QueryCache::statistics (TRI_vocbase_t* vocbase) {
+  auto const part = getPart(vocbase);
+  READ_LOCKER(_entriesLock[part]);
+
+  auto it = _entries[part].find(vocbase);
+
+  if (it == _entries[part].end()) {
+    // no results stored for the database yet
+    QueryCacheDatabaseEntry empty;
+    return empty.statistics();
+  }
+
+  return (*it).second->statistics();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -506,49 +921,67 @@ QueryCacheResultEntry* QueryCache::lookup (TRI_vocbase_t* vocbase,
 
   if (it == _entries[part].end()) {
     // no entry found for the requested database
+    _misses->count();
     return nullptr;
   } 
 
-  return (*it).second->lookup(hash, queryString, queryStringLength);
+  QueryCacheResultEntry* result = (*it).second->lookup(hash, queryString, queryStringLength);
+
+  (result == nullptr ? _misses : _hits)->count();
+
+  return result;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief store a query in the cache
-/// if the call is successful, the cache has taken over ownership for the 
-/// query result!
 ////////////////////////////////////////////////////////////////////////////////
 
-QueryCacheResultEntry* QueryCache::store (TRI_vocbase_t* vocbase,
-                                          uint64_t hash,
-                                          char const* queryString,
-                                          size_t queryStringLength,
-                                          TRI_json_t* result,
-                                          std::vector<std::string> const& collections) {
+void QueryCache::store (TRI_vocbase_t* vocbase,
+                        uint64_t hash,
+                        char const* queryString,
+                        size_t queryStringLength,
+                        TRI_json_t const* result,
+                        double executionTime,
+                        std::vector<std::string> const& collections,
+                        std::vector<QueryCacheDependency>&& dependencies) {
 
   if (! TRI_IsArrayJson(result)) {
-    return nullptr;
+    return;
   }
 
   // get the right part of the cache to store the result in
   auto const part = getPart(vocbase);
 
   // create the cache entry outside the lock
-  std::unique_ptr<QueryCacheResultEntry> entry(new QueryCacheResultEntry(hash, queryString, queryStringLength, result, collections));
+  std::unique_ptr<QueryCacheResultEntry> entry(new QueryCacheResultEntry(hash, queryString, queryStringLength, result, executionTime, collections, std::move(dependencies)));
 
-  WRITE_LOCKER(_entriesLock[part]);
+  if (entry->_memoryUsage > MaxResultsSize) {
+    // the result would evict everything else and then itself
+    return;
+  }
 
-  auto it = _entries[part].find(vocbase);
+  uint64_t evicted = 0;
 
-  if (it == _entries[part].end()) { 
-    // create entry for the current database
-    std::unique_ptr<QueryCacheDatabaseEntry> db(new QueryCacheDatabaseEntry());
-    it = _entries[part].emplace(vocbase, db.get()).first;
-    db.release();
+  {
+    WRITE_LOCKER(_entriesLock[part]);
+
+    auto it = _entries[part].find(vocbase);
+
+    if (it == _entries[part].end()) { 
+      // create entry for the current database
+      std::unique_ptr<QueryCacheDatabaseEntry> db(new QueryCacheDatabaseEntry());
+      it = _entries[part].emplace(vocbase, db.get()).first;
+      db.release();
+    }
+
+    // store cache entry, the cache takes over ownership
+    evicted = (*it).second->store(hash, entry.get());
+    entry.release();
   }
 
-  // store cache entry
-  (*it).second->store(hash, entry.get());
-  return entry.release();
+  if (evicted > 0) {
+    _evictions->count(evicted);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -557,17 +990,23 @@ QueryCacheResultEntry* QueryCache::store (TRI_vocbase_t* vocbase,
 
 void QueryCache::invalidate (TRI_vocbase_t* vocbase,
                              std::vector<char const*> const& collections) {
-  auto const part = getPart(vocbase);
-  WRITE_LOCKER(_entriesLock[part]);
+  QueryCacheInvalidations invalidations;
 
-  auto it = _entries[part].find(vocbase);
+  {
+    auto const part = getPart(vocbase);
+    WRITE_LOCKER(_entriesLock[part]);
 
-  if (it == _entries[part].end()) { 
-    return;
-  } 
+    auto it = _entries[part].find(vocbase);
 
-  // invalidate while holding the lock
-  (*it).second->invalidate(collections);
+    if (it == _entries[part].end()) { 
+      return;
+    } 
+
+    // invalidate while holding the lock
+    invalidations._collection = (*it).second->invalidate(collections);
+  }
+
+  count(invalidations);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -576,17 +1015,50 @@ void QueryCache::invalidate (TRI_vocbase_t* vocbase,
 
 void QueryCache::invalidate (TRI_vocbase_t* vocbase,
                              char const* collection) {
-  auto const part = getPart(vocbase);
-  WRITE_LOCKER(_entriesLock[part]);
+  QueryCacheInvalidations invalidations;
 
-  auto it = _entries[part].find(vocbase);
+  {
+    auto const part = getPart(vocbase);
+    WRITE_LOCKER(_entriesLock[part]);
 
-  if (it == _entries[part].end()) { 
-    return;
-  } 
+    auto it = _entries[part].find(vocbase);
+
+    if (it == _entries[part].end()) { 
+      return;
+    } 
+
+    // invalidate while holding the lock
+    invalidations._collection = (*it).second->invalidate(collection);
+  }
+
+  count(invalidations);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the queries for a particular collection that may be
+/// changed by the written document versions
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCache::invalidate (TRI_vocbase_t* vocbase,
+                             char const* collection,
+                             std::vector<QueryCacheDocument const*> const& documents) {
+  QueryCacheInvalidations invalidations;
+
+  {
+    auto const part = getPart(vocbase);
+    WRITE_LOCKER(_entriesLock[part]);
 
-  // invalidate while holding the lock
-  (*it).second->invalidate(collection);
+    auto it = _entries[part].find(vocbase);
+
+    if (it == _entries[part].end()) { 
+      return;
+    } 
+
+    // invalidate while holding the lock
+    (*it).second->invalidate(collection, documents, invalidations);
+  }
+
+  count(invalidations);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -639,7 +1111,7 @@ uint64_t QueryCache::hashQueryString (char const* queryString,
                                       size_t queryLength) const {
   TRI_ASSERT(queryString !=  nullptr);
 
-  return fasthash64(queryString, queryLength, 0x3123456789abcdef);
+  return TRI_MemoryHash64(queryString, queryLength, 0x3123456789abcdef);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -655,17 +1127,25 @@ QueryCache* QueryCache::instance () {
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief enforce maximum number of elements in each database-specific cache
+/// @brief enforce maximum number and memory usage of elements in each
+/// database-specific cache
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCache::enforceMaxResults (size_t value) {
+void QueryCache::enforceLimits (size_t maxResults,
+                                size_t maxResultsSize) {
+  uint64_t evicted = 0;
+
   for (unsigned int i = 0; i < NumberOfParts; ++i) {
     WRITE_LOCKER(_entriesLock[i]);
 
     for (auto& it : _entries[i]) {
-      it.second->enforceMaxResults(value);
+      evicted += it.second->enforceLimits(maxResults, maxResultsSize);
     }
   }
+
+  if (evicted > 0) {
+    _evictions->count(evicted);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -690,19 +1170,27 @@ void QueryCache::invalidate (unsigned int part) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief sets the maximum number of results in each per-database cache
+/// @brief sets the maximum number and memory usage of results in each
+/// per-database cache. a value of 0 keeps the current limit
 ////////////////////////////////////////////////////////////////////////////////
 
-void QueryCache::setMaxResults (size_t value) {
-  if (value == 0) {
-    return;
+void QueryCache::setLimits (size_t maxResults,
+                            size_t maxResultsSize) {
+  if (maxResults == 0) {
+    maxResults = MaxResults;
   }
-
-  if (value > MaxResults) {
-    enforceMaxResults(value);
+  if (maxResultsSize == 0) {
+    maxResultsSize = MaxResultsSize;
   }
 
-  MaxResults = value;
+  bool const shrink = (maxResults < MaxResults || maxResultsSize < MaxResultsSize);
+
+  MaxResults = maxResults;
+  MaxResultsSize = maxResultsSize;
+
+  if (shrink) {
+    enforceLimits(maxResults, maxResultsSize);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -736,6 +1224,28 @@ void QueryCache::setMode (std::string const& value) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts invalidated and kept entries
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCache::count (QueryCacheInvalidations const& invalidations) {
+  if (invalidations._collection > 0) {
+    _invalidatedCollection->count(invalidations._collection);
+  }
+  if (invalidations._full > 0) {
+    _invalidatedFull->count(invalidations._full);
+  }
+  if (invalidations._key > 0) {
+    _invalidatedKey->count(invalidations._key);
+  }
+  if (invalidations._range > 0) {
+    _invalidatedRange->count(invalidations._range);
+  }
+  if (invalidations._kept > 0) {
+    _kept->count(invalidations._kept);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -39,6 +39,10 @@ struct TRI_json_t;
 struct TRI_vocbase_t;
 
 namespace triagens {
+  namespace basics {
+    class MetricsCounter;
+  }
+
   namespace aql {
 
 // -----------------------------------------------------------------------------
@@ -55,18 +59,163 @@ namespace triagens {
       CACHE_ON_DEMAND
     };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache properties
+////////////////////////////////////////////////////////////////////////////////
+
+    struct QueryCacheProperties {
+      std::string mode;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of results per database
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t maxResults;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory usage of the results per database, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t maxResultsSize;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class QueryCacheDocument
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a version of a written document, as seen by the invalidation
+////////////////////////////////////////////////////////////////////////////////
+
+    class QueryCacheDocument {
+
+      public:
+
+        virtual ~QueryCacheDocument () {
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the document key
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual std::string key () const = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the value of an attribute path like "a.b", nullptr if the document
+/// does not have it
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual std::unique_ptr<TRI_json_t> attribute (std::string const&) const = 0;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         struct QueryCacheInterval
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an interval of attribute values, compared like AQL compares values.
+/// a missing bound is unbounded
+////////////////////////////////////////////////////////////////////////////////
+
+    struct QueryCacheInterval {
+      QueryCacheInterval ()
+        : _lower(),
+          _upper(),
+          _lowerInclusive(false),
+          _upperInclusive(false) {
+      }
+
+      bool contains (TRI_json_t const*) const;
+
+      size_t memoryUsage () const;
+
+      std::unique_ptr<TRI_json_t> _lower;
+      std::unique_ptr<TRI_json_t> _upper;
+      bool                        _lowerInclusive;
+      bool                        _upperInclusive;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       struct QueryCacheDependency
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the documents of a collection a cached result depends on
+///
+/// a result that reads a collection only through index lookups with constant
+/// conditions depends on the documents with the looked-up keys (KEYS) or
+/// with attribute values in the looked-up intervals (RANGES) only. a write
+/// of any other document cannot change it. everything else, e.g. a full
+/// scan of the collection, depends on all documents (FULL)
+////////////////////////////////////////////////////////////////////////////////
+
+    struct QueryCacheDependency {
+
+      enum DependencyType {
+        DEPENDENCY_KEYS,
+        DEPENDENCY_RANGES,
+        DEPENDENCY_FULL
+      };
+
+      explicit QueryCacheDependency (std::string const& collection)
+        : _collection(collection),
+          _type(DEPENDENCY_RANGES),
+          _keys(),
+          _ranges() {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an interval of an attribute path
+////////////////////////////////////////////////////////////////////////////////
+
+      void addInterval (std::string const&,
+                        QueryCacheInterval&&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns a dependency on single values of _key into a key set
+////////////////////////////////////////////////////////////////////////////////
+
+      void finalize ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a version of a written document may change the result
+////////////////////////////////////////////////////////////////////////////////
+
+      bool isAffectedBy (QueryCacheDocument const*) const;
+
+      size_t memoryUsage () const;
+
+      std::string                     _collection;
+      DependencyType                  _type;
+      std::unordered_set<std::string> _keys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the intervals by attribute path, a document is affected if one of
+/// its attribute values is in one of the intervals of the attribute
+////////////////////////////////////////////////////////////////////////////////
+
+      std::unordered_map<std::string, std::vector<QueryCacheInterval>> _ranges;
+    };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      struct QueryCacheResultEntry
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a cached query result. the result is kept in its serialized form,
+/// which is a fraction of the size of a TRI_json_t tree
+////////////////////////////////////////////////////////////////////////////////
+
     struct QueryCacheResultEntry {
       QueryCacheResultEntry () = delete;
 
       QueryCacheResultEntry (uint64_t,
                              char const*,
                              size_t, 
-                             struct TRI_json_t*,
-                             std::vector<std::string> const&);
+                             struct TRI_json_t const*,
+                             double,
+                             std::vector<std::string> const&,
+                             std::vector<QueryCacheDependency>&&);
 
       ~QueryCacheResultEntry ();
 
@@ -88,6 +237,27 @@ namespace triagens {
 
       void unuse ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dependency on a collection, nullptr if the entry depends on
+/// all of its documents
+////////////////////////////////////////////////////////////////////////////////
+
+      QueryCacheDependency const* dependency (std::string const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the query result, returns nullptr if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+      struct TRI_json_t* queryResult () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the eviction priority: the cache clock when the entry was last
+/// used, plus its hits times its execution time per byte. results that are
+/// small, expensive to compute or often used are kept the longest
+////////////////////////////////////////////////////////////////////////////////
+
+      double priority () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  member variables
 // -----------------------------------------------------------------------------
@@ -95,12 +265,18 @@ namespace triagens {
       uint64_t const                  _hash;
       char*                           _queryString;
       size_t const                    _queryStringLength;
-      struct TRI_json_t*              _queryResult;
+      char*                           _queryResult;
+      size_t                          _queryResultLength;
+      double const                    _executionTime;
+      std::atomic<uint64_t>           _frequency;
+      std::atomic<double>             _clock;
       std::vector<std::string> const  _collections;
+      std::vector<QueryCacheDependency> const _dependencies;
       QueryCacheResultEntry*          _prev;
       QueryCacheResultEntry*          _next;
       std::atomic<uint32_t>           _refCount;
       std::atomic<uint32_t>           _deletionRequested;
+      size_t                          _memoryUsage;
       
     };
 
@@ -137,6 +313,31 @@ namespace triagens {
       
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                    struct QueryCacheInvalidations
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of entries invalidated by a write, by reason, and the
+/// number of entries kept
+////////////////////////////////////////////////////////////////////////////////
+
+    struct QueryCacheInvalidations {
+      QueryCacheInvalidations ()
+        : _collection(0),
+          _full(0),
+          _key(0),
+          _range(0),
+          _kept(0) {
+      }
+
+      uint64_t _collection;
+      uint64_t _full;
+      uint64_t _key;
+      uint64_t _range;
+      uint64_t _kept;
+    };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                    struct QueryCacheDatabaseEntry
 // -----------------------------------------------------------------------------
@@ -175,42 +376,72 @@ namespace triagens {
                                      size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief store a query result in the database-specific cache
+/// @brief store a query result in the database-specific cache, returns the
+/// number of evicted entries
 ////////////////////////////////////////////////////////////////////////////////
 
-      void store (uint64_t,
-                  QueryCacheResultEntry*);
+      uint64_t store (uint64_t,
+                      QueryCacheResultEntry*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief invalidate all entries for the given collections in the 
-/// database-specific cache
+/// database-specific cache, returns the number of invalidated entries
 ////////////////////////////////////////////////////////////////////////////////
 
-      void invalidate (std::vector<char const*> const&);
+      uint64_t invalidate (std::vector<char const*> const&);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief invalidate all entries for a collection in the database-specific 
-/// cache
+/// cache, returns the number of invalidated entries
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t invalidate (char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the entries for a collection in the database-specific
+/// cache that may be changed by the written document versions
+////////////////////////////////////////////////////////////////////////////////
+
+      void invalidate (char const*,
+                       std::vector<QueryCacheDocument const*> const&,
+                       QueryCacheInvalidations&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enforce maximum number and memory usage of results, returns the
+/// number of evicted entries
 ////////////////////////////////////////////////////////////////////////////////
 
-      void invalidate (char const*);
+      uint64_t enforceLimits (size_t,
+                              size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief enforce maximum number of results
+/// @brief returns the statistics of the database-specific cache
 ////////////////////////////////////////////////////////////////////////////////
 
-      void enforceMaxResults (size_t);
+      triagens::basics::Json statistics () const;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evict the entry with the lowest priority
+////////////////////////////////////////////////////////////////////////////////
+
+      void evict ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check whether the element can be destroyed, and delete it if yes
 ////////////////////////////////////////////////////////////////////////////////
 
       void tryDelete (QueryCacheResultEntry*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a linked result entry from the cache and delete it
+////////////////////////////////////////////////////////////////////////////////
+
+      void remove (QueryCacheResultEntry*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief unlink the result entry from the list
 ////////////////////////////////////////////////////////////////////////////////
@@ -259,6 +490,32 @@ namespace triagens {
 
       size_t _numElements;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory usage of the elements in this cache
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t _memoryUsage;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cache clock, which is the priority of the last evicted entry.
+/// it is only changed under the write lock, so readers can use it
+////////////////////////////////////////////////////////////////////////////////
+
+      double _clock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief statistics of this cache. lookups only hold the read lock, so hits
+/// and misses are counted atomically
+////////////////////////////////////////////////////////////////////////////////
+
+      std::atomic<uint64_t> _hits;
+
+      std::atomic<uint64_t> _misses;
+
+      uint64_t _evictions;
+
+      uint64_t _invalidations;
+
     };
 
 // -----------------------------------------------------------------------------
@@ -304,13 +561,19 @@ namespace triagens {
 /// @brief return the cache properties
 ////////////////////////////////////////////////////////////////////////////////
 
-        void properties (std::pair<std::string, size_t>&);
+        void properties (QueryCacheProperties&);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the cache properties
 ////////////////////////////////////////////////////////////////////////////////
 
-        void setProperties (std::pair<std::string, size_t> const&);
+        void setProperties (QueryCacheProperties const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the statistics of the cache of a database
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json statistics (TRI_vocbase_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief test whether the cache might be active
@@ -342,17 +605,19 @@ namespace triagens {
                                        size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief store a query in the cache
-/// if the call is successful, the cache has taken over ownership for the 
-/// query result!
+/// @brief store a query in the cache, together with the time it took to
+/// execute. the cache stores a serialized copy of the result, and nothing
+/// if the result alone exceeds the memory limit
 ////////////////////////////////////////////////////////////////////////////////
 
-        QueryCacheResultEntry* store (TRI_vocbase_t*, 
-                                      uint64_t,
-                                      char const*,
-                                      size_t,
-                                      struct TRI_json_t*,
-                                      std::vector<std::string> const&);
+        void store (TRI_vocbase_t*, 
+                    uint64_t,
+                    char const*,
+                    size_t,
+                    struct TRI_json_t const*,
+                    double,
+                    std::vector<std::string> const&,
+                    std::vector<QueryCacheDependency>&&);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief invalidate all queries for the given collections
@@ -368,6 +633,16 @@ namespace triagens {
         void invalidate (TRI_vocbase_t*,
                          char const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the queries for a particular collection that may be
+/// changed by the written document versions, i.e. the old and new versions
+/// of the inserted, updated and removed documents
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_vocbase_t*,
+                         char const*,
+                         std::vector<QueryCacheDocument const*> const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief invalidate all queries for a particular database
 ////////////////////////////////////////////////////////////////////////////////
@@ -398,10 +673,12 @@ namespace triagens {
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief enforce maximum number of results in each database-specific cache
+/// @brief enforce maximum number and memory usage of results in each
+/// database-specific cache
 ////////////////////////////////////////////////////////////////////////////////
 
-        void enforceMaxResults (size_t);
+        void enforceLimits (size_t,
+                            size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief determine which part of the cache to use for the cache entries
@@ -417,10 +694,11 @@ namespace triagens {
         void invalidate (unsigned int);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief sets the maximum number of elements in the cache
+/// @brief sets the maximum number and memory usage of elements in the cache
 ////////////////////////////////////////////////////////////////////////////////
 
-        void setMaxResults (size_t);
+        void setLimits (size_t,
+                        size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enable or disable the query cache
@@ -434,6 +712,12 @@ namespace triagens {
 
         void setMode (std::string const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts invalidated and kept entries
+////////////////////////////////////////////////////////////////////////////////
+
+        void count (QueryCacheInvalidations const&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -464,6 +748,45 @@ namespace triagens {
 
         std::unordered_map<TRI_vocbase_t*, QueryCacheDatabaseEntry*> _entries[NumberOfParts];
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of lookups that found a result
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::MetricsCounter* _hits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of lookups that did not find a result
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::MetricsCounter* _misses;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of invalidated entries, by reason: a collection-wide
+/// invalidation, a write to a collection the entry fully depends on, or a
+/// write to a key or into a range the entry depends on
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::MetricsCounter* _invalidatedCollection;
+
+        triagens::basics::MetricsCounter* _invalidatedFull;
+
+        triagens::basics::MetricsCounter* _invalidatedKey;
+
+        triagens::basics::MetricsCounter* _invalidatedRange;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of times an entry was kept on a write to one of its
+/// collections
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::MetricsCounter* _kept;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries evicted to stay within the limits
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::MetricsCounter* _evictions;
+
     };
 
   }
@@ -0,0 +1,542 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, query plan cache
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/QueryPlanCache.h"
+#include "Basics/fasthash.h"
+#include "Basics/hashes.h"
+#include "Basics/json.h"
+#include "Basics/json-utilities.h"
+#include "Basics/Exceptions.h"
+#include "Basics/ReadLocker.h"
+#include "Basics/WriteLocker.h"
+
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief singleton instance of the plan cache
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::aql::QueryPlanCache Instance;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copy an optional JSON value
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_json_t* CopyOptionalJson (TRI_json_t const* json) {
+  if (json == nullptr) {
+    return nullptr;
+  }
+
+  TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+  if (copy == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compare two optional JSON values
+////////////////////////////////////////////////////////////////////////////////
+
+static bool EqualOptionalJson (TRI_json_t const* lhs,
+                               TRI_json_t const* rhs) {
+  if (lhs == nullptr || rhs == nullptr) {
+    return (lhs == rhs);
+  }
+
+  return (TRI_CompareValuesJson(lhs, rhs, false) == 0 &&
+          lhs->_type == rhs->_type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief name of the type of a JSON value, for the plan cache key
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* JsonTypeName (TRI_json_t const* json) {
+  if (json == nullptr) {
+    return "none";
+  }
+
+  switch (json->_type) {
+    case TRI_JSON_NULL:
+      return "null";
+    case TRI_JSON_BOOLEAN:
+      return "bool";
+    case TRI_JSON_NUMBER:
+      return "number";
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE:
+      return "string";
+    case TRI_JSON_OBJECT:
+      return "object";
+    case TRI_JSON_ARRAY:
+      return "array";
+    default: {
+    }
+  }
+
+  return "none";
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        struct QueryPlanCacheEntry
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a plan cache entry. the entry takes over ownership of the
+/// plan, and copies the options
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCacheEntry::QueryPlanCacheEntry (uint64_t hash,
+                                          char const* queryString,
+                                          size_t queryStringLength,
+                                          std::string const& bindParameterTypes,
+                                          TRI_json_t const* options,
+                                          TRI_json_t* plan,
+                                          std::vector<std::string> const& collections,
+                                          bool isModificationQuery,
+                                          bool isResultCacheable,
+                                          bool functionsMayAccessDocuments)
+  : _hash(hash),
+    _queryString(queryString, queryStringLength),
+    _bindParameterTypes(bindParameterTypes),
+    _options(nullptr),
+    _plan(plan),
+    _collections(collections),
+    _isModificationQuery(isModificationQuery),
+    _isResultCacheable(isResultCacheable),
+    _functionsMayAccessDocuments(functionsMayAccessDocuments) {
+
+  TRI_ASSERT(_plan != nullptr);
+
+  try {
+    _options = CopyOptionalJson(options);
+  }
+  catch (...) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _plan);
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy a plan cache entry
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCacheEntry::~QueryPlanCacheEntry () {
+  if (_options != nullptr) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _options);
+  }
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _plan);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the entry was created for the query string, bind
+/// parameter types and options
+////////////////////////////////////////////////////////////////////////////////
+
+bool QueryPlanCacheEntry::matches (char const* queryString,
+                                   size_t queryStringLength,
+                                   std::string const& bindParameterTypes,
+                                   TRI_json_t const* options) const {
+  return (_queryString.size() == queryStringLength &&
+          memcmp(_queryString.c_str(), queryString, queryStringLength) == 0 &&
+          _bindParameterTypes == bindParameterTypes &&
+          EqualOptionalJson(_options, options));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the plan cache
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCache::QueryPlanCache () 
+  : _lock(),
+    _entries(),
+    _generation(0),
+    _removed(0),
+    _maxEntries(0) {
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the plan cache
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCache::~QueryPlanCache () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the cache is active
+////////////////////////////////////////////////////////////////////////////////
+
+bool QueryPlanCache::isActive () const {
+  return (_maxEntries.load(std::memory_order_relaxed) > 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum number of plans per database
+////////////////////////////////////////////////////////////////////////////////
+
+size_t QueryPlanCache::maxEntries () const {
+  return _maxEntries.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum number of plans per database
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::setMaxEntries (size_t value) {
+  WRITE_LOCKER(_lock);
+  _maxEntries = value;
+
+  for (auto& it : _entries) {
+    auto& database = it.second;
+
+    while (database._lru.size() > value) {
+      remove(database, database._lru.front());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup a plan in the cache
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<QueryPlanCacheEntry> QueryPlanCache::lookup (TRI_vocbase_t* vocbase,
+                                                             uint64_t hash,
+                                                             char const* queryString,
+                                                             size_t queryStringLength,
+                                                             std::string const& bindParameterTypes,
+                                                             TRI_json_t const* options) {
+  // the write lock is required for updating the LRU list
+  WRITE_LOCKER(_lock);
+
+  auto it = _entries.find(vocbase);
+
+  if (it == _entries.end()) {
+    return nullptr;
+  }
+
+  auto& database = (*it).second;
+  auto it2 = database._entriesByHash.find(hash);
+
+  if (it2 == database._entriesByHash.end()) {
+    return nullptr;
+  }
+
+  auto& entry = (*it2).second;
+
+  if (! entry.first->matches(queryString, queryStringLength, bindParameterTypes, options)) {
+    // hash collision
+    return nullptr;
+  }
+
+  // move to the end of the LRU list
+  database._lru.splice(database._lru.end(), database._lru, entry.second);
+
+  return entry.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the current invalidation counter
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t QueryPlanCache::generation () {
+  READ_LOCKER(_lock);
+
+  return _generation;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a plan in the cache
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::store (TRI_vocbase_t* vocbase,
+                            std::shared_ptr<QueryPlanCacheEntry> entry,
+                            uint64_t generation) {
+  TRI_ASSERT(entry != nullptr);
+
+  WRITE_LOCKER(_lock);
+
+  size_t const maxEntries = _maxEntries.load();
+
+  if (maxEntries == 0 || _removed > generation) {
+    return;
+  }
+
+  auto& database = _entries[vocbase];
+
+  if (database._invalidated > generation) {
+    // a collection of the database was dropped, renamed or had its indexes
+    // changed while the plan was built. the plan may be stale
+    return;
+  }
+
+  uint64_t const hash = entry->_hash;
+
+  // replace an existing entry with the same hash
+  remove(database, hash);
+
+  while (database._lru.size() >= maxEntries) {
+    remove(database, database._lru.front());
+  }
+
+  database._lru.emplace_back(hash);
+
+  try {
+    auto position = std::prev(database._lru.end());
+    database._entriesByHash.emplace(hash, std::make_pair(entry, position));
+
+    for (auto const& name : entry->_collections) {
+      database._entriesByCollection[name].emplace(hash);
+    }
+  }
+  catch (...) {
+    remove(database, hash);
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for the given collections
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::invalidate (TRI_vocbase_t* vocbase,
+                                 std::vector<char const*> const& collections) {
+  WRITE_LOCKER(_lock);
+
+  auto& database = invalidated(vocbase);
+
+  for (auto const& name : collections) {
+    invalidate(database, name);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for a particular collection
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::invalidate (TRI_vocbase_t* vocbase,
+                                 char const* collection) {
+  WRITE_LOCKER(_lock);
+
+  invalidate(invalidated(vocbase), collection);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for a particular database
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::invalidate (TRI_vocbase_t* vocbase) {
+  WRITE_LOCKER(_lock);
+
+  _removed = ++_generation;
+  _entries.erase(vocbase);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::invalidate () {
+  WRITE_LOCKER(_lock);
+
+  _removed = ++_generation;
+  _entries.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the key part for the bind parameters
+////////////////////////////////////////////////////////////////////////////////
+
+std::string QueryPlanCache::BindParameterTypes (TRI_json_t const* bindParameters) {
+  if (! TRI_IsObjectJson(bindParameters)) {
+    return std::string();
+  }
+
+  std::vector<std::string> parameters;
+  size_t const n = TRI_LengthVector(&bindParameters->_value._objects);
+  parameters.reserve(n / 2);
+
+  for (size_t i = 0; i < n; i += 2) {
+    auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&bindParameters->_value._objects, i));
+    auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&bindParameters->_value._objects, i + 1));
+
+    if (! TRI_IsStringJson(key)) {
+      continue;
+    }
+
+    std::string parameter(key->_value._string.data, key->_value._string.length - 1);
+
+    if (! parameter.empty() && parameter[0] == '@' && TRI_IsStringJson(value)) {
+      // collection parameters determine the collections of the plan
+      parameter.push_back('=');
+      parameter.append(value->_value._string.data, value->_value._string.length - 1);
+    }
+    else {
+      parameter.push_back(':');
+      parameter.append(JsonTypeName(value));
+    }
+
+    parameters.emplace_back(parameter);
+  }
+
+  // the order of the bind parameters does not matter
+  std::sort(parameters.begin(), parameters.end());
+
+  std::string result;
+
+  for (auto const& it : parameters) {
+    result.append(it);
+    result.push_back('\0');
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash a query string, its bind parameter types and options
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t QueryPlanCache::Hash (char const* queryString,
+                               size_t queryStringLength,
+                               std::string const& bindParameterTypes,
+                               TRI_json_t const* options) {
+  TRI_ASSERT(queryString != nullptr);
+
+  uint64_t hash = TRI_MemoryHash64(queryString, queryStringLength, 0x0123456789abcdef);
+
+  if (! bindParameterTypes.empty()) {
+    hash = fasthash64(bindParameterTypes.c_str(), bindParameterTypes.size(), hash);
+  }
+  if (options != nullptr) {
+    hash = fasthash64(&hash, sizeof(hash), TRI_FastHashJson(options));
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the plan cache instance
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCache* QueryPlanCache::instance () {
+  return &Instance;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a plan from a database entry
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::remove (DatabaseEntry& database,
+                             uint64_t hash) {
+  auto it = database._entriesByHash.find(hash);
+
+  if (it == database._entriesByHash.end()) {
+    return;
+  }
+
+  for (auto const& name : (*it).second.first->_collections) {
+    auto it2 = database._entriesByCollection.find(name);
+
+    if (it2 != database._entriesByCollection.end()) {
+      (*it2).second.erase(hash);
+
+      if ((*it2).second.empty()) {
+        database._entriesByCollection.erase(it2);
+      }
+    }
+  }
+
+  database._lru.erase((*it).second.second);
+  // the plan itself is freed when the last query using it is done
+  database._entriesByHash.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans of a collection in a database entry
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPlanCache::invalidate (DatabaseEntry& database,
+                                 char const* collection) {
+  auto it = database._entriesByCollection.find(std::string(collection));
+
+  if (it == database._entriesByCollection.end()) {
+    return;
+  }
+
+  // copy the hashes, as remove() modifies the set
+  std::vector<uint64_t> hashes((*it).second.begin(), (*it).second.end());
+
+  for (auto const& hash : hashes) {
+    remove(database, hash);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find or create the entry for a database and record an invalidation
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPlanCache::DatabaseEntry& QueryPlanCache::invalidated (TRI_vocbase_t* vocbase) {
+  // the entry must exist even if it has no plans yet, so that a plan that is
+  // built concurrently will not be stored
+  auto& database = _entries[vocbase];
+  database._invalidated = ++_generation;
+
+  return database;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
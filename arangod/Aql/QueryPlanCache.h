@@ -0,0 +1,352 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, query plan cache
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_QUERY_PLAN_CACHE_H
+#define ARANGODB_AQL_QUERY_PLAN_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ReadWriteLock.h"
+
+struct TRI_json_t;
+struct TRI_vocbase_t;
+
+namespace triagens {
+  namespace aql {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        struct QueryPlanCacheEntry
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an optimized execution plan in JSON format, together with the
+/// query string, bind parameter types and options it was created for. the
+/// plan contains the bind parameters as parameter nodes, which are replaced
+/// with the values of the bind parameters before the plan is executed.
+/// entries are immutable once created
+////////////////////////////////////////////////////////////////////////////////
+
+    struct QueryPlanCacheEntry {
+      QueryPlanCacheEntry () = delete;
+      QueryPlanCacheEntry (QueryPlanCacheEntry const&) = delete;
+      QueryPlanCacheEntry& operator= (QueryPlanCacheEntry const&) = delete;
+
+      QueryPlanCacheEntry (uint64_t,
+                           char const*,
+                           size_t,
+                           std::string const&,
+                           struct TRI_json_t const*,
+                           struct TRI_json_t*,
+                           std::vector<std::string> const&,
+                           bool,
+                           bool,
+                           bool);
+
+      ~QueryPlanCacheEntry ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the entry was created for the query string, bind
+/// parameter types and options
+////////////////////////////////////////////////////////////////////////////////
+
+      bool matches (char const*,
+                    size_t,
+                    std::string const&,
+                    struct TRI_json_t const*) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  member variables
+// -----------------------------------------------------------------------------
+
+      uint64_t const                  _hash;
+      std::string const               _queryString;
+      std::string const               _bindParameterTypes;
+      struct TRI_json_t*              _options;
+      struct TRI_json_t*              _plan;
+      std::vector<std::string> const  _collections;
+      bool const                      _isModificationQuery;
+      bool const                      _isResultCacheable;
+      bool const                      _functionsMayAccessDocuments;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class QueryPlanCache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief global cache for optimized execution plans, so repeated queries
+/// can skip parsing and optimization. plans are keyed on the query string,
+/// the bind parameter types and the options, so queries that differ only in
+/// their bind parameter values share a plan. the values of collection bind
+/// parameters are part of the key. entries are invalidated when a collection
+/// used by the plan is dropped or renamed, or when one of its indexes is
+/// created or dropped
+////////////////////////////////////////////////////////////////////////////////
+
+    class QueryPlanCache {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        QueryPlanCache (QueryPlanCache const&) = delete;
+        QueryPlanCache& operator= (QueryPlanCache const&) = delete;
+      
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        QueryPlanCache ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        ~QueryPlanCache ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the cache is active
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isActive () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum number of plans per database
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t maxEntries () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum number of plans per database. a value of 0 turns
+/// the cache off and removes all plans
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaxEntries (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup a plan in the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<QueryPlanCacheEntry> lookup (TRI_vocbase_t*,
+                                                     uint64_t,
+                                                     char const*,
+                                                     size_t,
+                                                     std::string const&,
+                                                     struct TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the current invalidation counter. it must be fetched before
+/// a plan is built, and be passed to store() together with the plan
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t generation ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a plan in the cache. the plan is not stored if one of its
+/// collections or its database was invalidated after the given invalidation
+/// counter was fetched, as the plan may then refer to indexes or collection
+/// names that do not exist anymore
+////////////////////////////////////////////////////////////////////////////////
+
+        void store (TRI_vocbase_t*,
+                    std::shared_ptr<QueryPlanCacheEntry>,
+                    uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for the given collections
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_vocbase_t*,
+                         std::vector<char const*> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for a particular collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_vocbase_t*,
+                         char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans for a particular database
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_vocbase_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the key part for the bind parameters. it contains the names
+/// and types of all bind parameters, and the values of collection parameters
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string BindParameterTypes (struct TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash a query string, its bind parameter types and options
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t Hash (char const*,
+                              size_t,
+                              std::string const&,
+                              struct TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the pointer to the global plan cache
+////////////////////////////////////////////////////////////////////////////////
+
+        static QueryPlanCache* instance ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the plans of a single database
+////////////////////////////////////////////////////////////////////////////////
+
+        struct DatabaseEntry {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief plans by hash, with their position in the LRU list
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unordered_map<uint64_t, std::pair<std::shared_ptr<QueryPlanCacheEntry>, std::list<uint64_t>::iterator>> _entriesByHash;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hashes of the plans that use a collection
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unordered_map<std::string, std::unordered_set<uint64_t>> _entriesByCollection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief plan hashes, least recently used first
+////////////////////////////////////////////////////////////////////////////////
+
+          std::list<uint64_t> _lru;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value of the invalidation counter when one of the collections of
+/// the database was last invalidated
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _invalidated = 0;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a plan from a database entry
+/// note that the caller of this method must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        static void remove (DatabaseEntry&,
+                            uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate all plans of a collection in a database entry
+/// note that the caller of this method must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        static void invalidate (DatabaseEntry&,
+                                char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find or create the entry for a database and record an invalidation
+/// in it
+/// note that the caller of this method must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        DatabaseEntry& invalidated (TRI_vocbase_t*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the entries
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ReadWriteLock _lock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the plans, by database
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<TRI_vocbase_t*, DatabaseEntry> _entries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidation counter, increased on every invalidation
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _generation;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value of the invalidation counter when the plans of a whole
+/// database or of all databases were last removed
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _removed;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of plans per database
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _maxEntries;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
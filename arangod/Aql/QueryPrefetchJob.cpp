@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief job that computes the next batch of a query snippet in advance
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/QueryPrefetchJob.h"
+#include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
+#include "Aql/QueryRegistry.h"
+#include "Basics/logging.h"
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/DispatcherQueue.h"
+#include "VocBase/vocbase.h"
+
+using namespace triagens::aql;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class QueryPrefetchJob
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the job
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPrefetchJob::QueryPrefetchJob (QueryRegistry* registry,
+                                    TRI_vocbase_t* vocbase,
+                                    QueryId qId,
+                                    size_t atLeast,
+                                    size_t atMost)
+  : Job("QueryPrefetchJob"),
+    _registry(registry),
+    _vocbase(vocbase),
+    _qId(qId),
+    _atLeast(atLeast),
+    _atMost(atMost) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroys the job
+////////////////////////////////////////////////////////////////////////////////
+
+QueryPrefetchJob::~QueryPrefetchJob () {
+  TRI_ReleaseVocBase(_vocbase);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+size_t QueryPrefetchJob::queue () const {
+  return Dispatcher::AQL_QUEUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+Job::status_t QueryPrefetchJob::work () {
+  Query* query = nullptr;
+
+  try {
+    query = _registry->open(_vocbase, _qId);
+  }
+  catch (...) {
+    // the query is in use, the request will compute the batch itself
+    return status_t(Job::JOB_DONE);
+  }
+
+  if (query == nullptr) {
+    // the query was shut down in the meantime
+    return status_t(Job::JOB_DONE);
+  }
+
+  try {
+    // errors are kept by the engine for the next request
+    query->engine()->prefetch(_atLeast, _atMost);
+  }
+  catch (...) {
+  }
+
+  try {
+    _registry->close(_vocbase, _qId);
+  }
+  catch (...) {
+    LOG_WARNING("unable to return prefetched query %llu to the registry",
+                (unsigned long long) _qId);
+  }
+
+  return status_t(Job::JOB_DONE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryPrefetchJob::cleanup (DispatcherQueue* queue) {
+  queue->removeJob(this);
+  delete this;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief job that computes the next batch of a query snippet in advance
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_QUERY_PREFETCH_JOB_H
+#define ARANGODB_AQL_QUERY_PREFETCH_JOB_H 1
+
+#include "Basics/Common.h"
+#include "Aql/types.h"
+#include "Dispatcher/Job.h"
+
+struct TRI_vocbase_t;
+
+namespace triagens {
+  namespace aql {
+
+    class QueryRegistry;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class QueryPrefetchJob
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes the next batch of a query snippet on a DB server while
+/// the coordinator is still busy with the previous one
+///
+/// the job takes the query out of the registry like a request would, so it
+/// never runs concurrently with a request for the same snippet. if the query
+/// is in use, the request computes the batch itself and the job gives up.
+/// the snippets of all shards of a DB server compute their batches in
+/// parallel this way, instead of one after the other as the requests of the
+/// coordinator come in
+////////////////////////////////////////////////////////////////////////////////
+
+    class QueryPrefetchJob : public triagens::rest::Job {
+
+      private:
+
+        QueryPrefetchJob (QueryPrefetchJob const&) = delete;
+        QueryPrefetchJob& operator= (QueryPrefetchJob const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the job. the job takes over a usage of the database that
+/// the caller acquired with TRI_UseVocBase()
+////////////////////////////////////////////////////////////////////////////////
+
+        QueryPrefetchJob (QueryRegistry*,
+                          TRI_vocbase_t*,
+                          QueryId,
+                          size_t,
+                          size_t);
+
+        ~QueryPrefetchJob ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t queue () const override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        priority_e priority () const override {
+          // requests of the coordinator go first
+          return PRIORITY_LOW;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        Job::status_t work () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool cancel () override {
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void cleanup (rest::DispatcherQueue*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleError (basics::Exception const&) override {
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        QueryRegistry* _registry;
+
+        TRI_vocbase_t* _vocbase;
+
+        QueryId const _qId;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the batch size of the last request of the coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t const _atLeast;
+
+        size_t const _atMost;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,301 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, cache of query snippets sent by coordinators
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/QuerySnippetCache.h"
+#include "Basics/hashes.h"
+#include "Basics/json.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/Exceptions.h"
+
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief singleton instance of the snippet cache
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::aql::QuerySnippetCache Instance;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free a kept request
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeRequest (TRI_json_t const* json) {
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, const_cast<TRI_json_t*>(json));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the snippet cache
+////////////////////////////////////////////////////////////////////////////////
+
+QuerySnippetCache::QuerySnippetCache ()
+  : _lock(),
+    _entries(),
+    _kept(),
+    _keptLru() {
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the snippet cache
+////////////////////////////////////////////////////////////////////////////////
+
+QuerySnippetCache::~QuerySnippetCache () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    public methods, for DB servers
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup a request, returns a copy owned by the caller or a nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* QuerySnippetCache::lookup (TRI_vocbase_t* vocbase,
+                                       uint64_t hash) {
+  std::shared_ptr<TRI_json_t const> request;
+
+  {
+    MUTEX_LOCKER(_lock);
+
+    auto it = _entries.find(vocbase);
+
+    if (it == _entries.end()) {
+      return nullptr;
+    }
+
+    auto& database = (*it).second;
+    auto it2 = database._entries.find(hash);
+
+    if (it2 == database._entries.end()) {
+      return nullptr;
+    }
+
+    // move to the end of the LRU list
+    database._lru.splice(database._lru.end(), database._lru, (*it2).second.second);
+    request = (*it2).second.first;
+  }
+
+  // the caller modifies the request, so copy it outside the lock
+  TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, request.get());
+
+  if (copy == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a copy of a request
+////////////////////////////////////////////////////////////////////////////////
+
+void QuerySnippetCache::store (TRI_vocbase_t* vocbase,
+                               uint64_t hash,
+                               TRI_json_t const* request) {
+  TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, request);
+
+  if (copy == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  std::shared_ptr<TRI_json_t const> entry(copy, FreeRequest);
+
+  MUTEX_LOCKER(_lock);
+
+  auto& database = _entries[vocbase];
+  auto it = database._entries.find(hash);
+
+  if (it != database._entries.end()) {
+    // another instantiation of the same snippet was faster
+    (*it).second.first = entry;
+    database._lru.splice(database._lru.end(), database._lru, (*it).second.second);
+    return;
+  }
+
+  while (database._lru.size() >= MaxEntries) {
+    database._entries.erase(database._lru.front());
+    database._lru.pop_front();
+  }
+
+  database._lru.emplace_back(hash);
+
+  try {
+    database._entries.emplace(hash, std::make_pair(entry, std::prev(database._lru.end())));
+  }
+  catch (...) {
+    database._lru.pop_back();
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a request
+////////////////////////////////////////////////////////////////////////////////
+
+void QuerySnippetCache::remove (TRI_vocbase_t* vocbase,
+                                uint64_t hash) {
+  MUTEX_LOCKER(_lock);
+
+  auto it = _entries.find(vocbase);
+
+  if (it == _entries.end()) {
+    return;
+  }
+
+  auto& database = (*it).second;
+  auto it2 = database._entries.find(hash);
+
+  if (it2 == database._entries.end()) {
+    return;
+  }
+
+  database._lru.erase((*it2).second.second);
+  database._entries.erase(it2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all requests of a database
+////////////////////////////////////////////////////////////////////////////////
+
+void QuerySnippetCache::invalidate (TRI_vocbase_t* vocbase) {
+  MUTEX_LOCKER(_lock);
+
+  _entries.erase(vocbase);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                  public methods, for coordinators
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+bool QuerySnippetCache::isKept (uint64_t hash) {
+  MUTEX_LOCKER(_lock);
+
+  auto it = _kept.find(hash);
+
+  if (it == _kept.end()) {
+    return false;
+  }
+
+  _keptLru.splice(_keptLru.end(), _keptLru, (*it).second);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remember that a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+void QuerySnippetCache::setKept (uint64_t hash) {
+  MUTEX_LOCKER(_lock);
+
+  if (_kept.find(hash) != _kept.end()) {
+    return;
+  }
+
+  while (_keptLru.size() >= MaxEntries) {
+    _kept.erase(_keptLru.front());
+    _keptLru.pop_front();
+  }
+
+  _keptLru.emplace_back(hash);
+
+  try {
+    _kept.emplace(hash, std::prev(_keptLru.end()));
+  }
+  catch (...) {
+    _keptLru.pop_back();
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief forget that a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+void QuerySnippetCache::unsetKept (uint64_t hash) {
+  MUTEX_LOCKER(_lock);
+
+  auto it = _kept.find(hash);
+
+  if (it == _kept.end()) {
+    return;
+  }
+
+  _keptLru.erase((*it).second);
+  _kept.erase(it);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash the URL and body of a request
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t QuerySnippetCache::Hash (std::string const& url,
+                                  std::string const& body) {
+  uint64_t hash = TRI_FnvHashBlockInitial();
+  hash = TRI_FnvHashBlock(hash, url.c_str(), url.size());
+  // the URL contains the database name, which cannot contain a NUL byte
+  hash = TRI_FnvHashBlock(hash, "\0", 1);
+  hash = TRI_FnvHashBlock(hash, body.c_str(), body.size());
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the snippet cache instance
+////////////////////////////////////////////////////////////////////////////////
+
+QuerySnippetCache* QuerySnippetCache::instance () {
+  return &Instance;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
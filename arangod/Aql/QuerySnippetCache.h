@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, cache of query snippets sent by coordinators
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_QUERY_SNIPPET_CACHE_H
+#define ARANGODB_AQL_QUERY_SNIPPET_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+
+struct TRI_json_t;
+struct TRI_vocbase_t;
+
+namespace triagens {
+  namespace aql {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class QuerySnippetCache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the snippets of cluster queries, by the hash of their request
+///
+/// a coordinator instantiates the snippets of a query on the DB servers by
+/// sending them the plan of each snippet. a DB server keeps the requests it
+/// has instantiated, and the coordinator remembers which hashes were kept.
+/// when the same query runs again, the coordinator only sends the hash and
+/// the id of its own part of the query, and the DB server instantiates the
+/// snippet from the kept request. if the DB server does not have the
+/// request anymore, it answers with TRI_ERROR_QUERY_SNIPPET_NOT_FOUND, and
+/// the coordinator sends the full request again
+////////////////////////////////////////////////////////////////////////////////
+
+    class QuerySnippetCache {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the snippets of a single database
+////////////////////////////////////////////////////////////////////////////////
+
+        struct DatabaseEntry {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief requests by hash, with their position in the LRU list
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unordered_map<uint64_t, std::pair<std::shared_ptr<TRI_json_t const>, std::list<uint64_t>::iterator>> _entries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request hashes, least recently used first
+////////////////////////////////////////////////////////////////////////////////
+
+          std::list<uint64_t> _lru;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        QuerySnippetCache (QuerySnippetCache const&) = delete;
+        QuerySnippetCache& operator= (QuerySnippetCache const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        QuerySnippetCache ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        ~QuerySnippetCache ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    public methods, for DB servers
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup a request, returns a copy owned by the caller or a nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+        struct TRI_json_t* lookup (TRI_vocbase_t*,
+                                   uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a copy of a request
+////////////////////////////////////////////////////////////////////////////////
+
+        void store (TRI_vocbase_t*,
+                    uint64_t,
+                    struct TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove a request
+////////////////////////////////////////////////////////////////////////////////
+
+        void remove (TRI_vocbase_t*,
+                     uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove all requests of a database
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_vocbase_t*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                  public methods, for coordinators
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isKept (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remember that a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+        void setKept (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief forget that a DB server has kept the request with the hash
+////////////////////////////////////////////////////////////////////////////////
+
+        void unsetKept (uint64_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash the URL and body of a request
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t Hash (std::string const&,
+                              std::string const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the pointer to the global snippet cache
+////////////////////////////////////////////////////////////////////////////////
+
+        static QuerySnippetCache* instance ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public variables
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of requests per database kept by a DB server, and
+/// maximum number of hashes remembered by a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxEntries = 1024;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the entries and the hashes
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex _lock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the requests, by database
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<TRI_vocbase_t*, DatabaseEntry> _entries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the hashes kept by DB servers, with their position in the LRU list
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<uint64_t, std::list<uint64_t>::iterator> _kept;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief kept hashes, least recently used first
+////////////////////////////////////////////////////////////////////////////////
+
+        std::list<uint64_t> _keptLru;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -31,8 +31,12 @@
 #include "Aql/ClusterBlocks.h"
 #include "Aql/ExecutionEngine.h"
 #include "Aql/ExecutionBlock.h"
+#include "Aql/QueryPrefetchJob.h"
+#include "Aql/QuerySnippetCache.h"
 #include "Basics/ConditionLocker.h"
+#include "Basics/StringBuffer.h"
 #include "Basics/StringUtils.h"
+#include "Dispatcher/Dispatcher.h"
 #include "Dispatcher/DispatcherThread.h"
 #include "HttpServer/HttpServer.h"
 #include "HttpServer/HttpHandlerFactory.h"
@@ -62,7 +66,9 @@ RestAqlHandler::RestAqlHandler (triagens::rest::HttpRequest* request,
     _context(static_cast<VocbaseContext*>(request->getRequestContext())),
     _vocbase(_context->getVocbase()),
     _queryRegistry(pair->second),
-    _qId(0) {
+    _qId(0),
+    _prefetchAtLeast(0),
+    _prefetchAtMost(0) {
 
   TRI_ASSERT(_vocbase != nullptr);
   TRI_ASSERT(_queryRegistry != nullptr);
@@ -96,6 +102,12 @@ bool RestAqlHandler::isDirect () const {
 /// @brief POST method for /_api/aql/instantiate
 /// The body is a JSON with attributes "plan" for the execution plan and
 /// "options" for the options, all exactly as in AQL_EXECUTEJSON.
+///
+/// If the request has an "x-arango-aql-snippet" header, the body is kept
+/// under the hash in the header. A later request with the same header and
+/// without a "plan" attribute then instantiates the kept body again. The
+/// "x-arango-aql-remote-query-id" header sets the query id of the remote
+/// nodes, which differs for every instantiation.
 ////////////////////////////////////////////////////////////////////////////////
 
 void RestAqlHandler::createQueryFromJson () {
@@ -105,6 +117,26 @@ void RestAqlHandler::createQueryFromJson () {
     return;
   }
 
+  bool found;
+  uint64_t snippet = 0;
+  char const* snippetString = _request->header("x-arango-aql-snippet", found);
+  if (found) {
+    snippet = StringUtils::uint64(snippetString);
+  }
+
+  auto snippets = QuerySnippetCache::instance();
+  bool fromCache = false;
+
+  if (snippet != 0 && queryJson.get("plan").isEmpty()) {
+    TRI_json_t* kept = snippets->lookup(_vocbase, snippet);
+    if (kept == nullptr) {
+      generateError(HttpResponse::NOT_FOUND, TRI_ERROR_QUERY_SNIPPET_NOT_FOUND);
+      return;
+    }
+    queryJson = triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, kept);
+    fromCache = true;
+  }
+
   triagens::basics::Json plan;
   triagens::basics::Json options;
 
@@ -119,20 +151,59 @@ void RestAqlHandler::createQueryFromJson () {
   
   std::string const part = JsonHelper::getStringValue(queryJson.json(), "part", "");
 
+  char const* remoteQueryId = _request->header("x-arango-aql-remote-query-id", found);
+  if (found) {
+    // the coordinator leaves the query id of the remote nodes out of the
+    // plan, so that the plan is the same for every instantiation
+    TRI_json_t* nodes = nullptr;
+    if (TRI_IsObjectJson(plan.json())) {
+      nodes = TRI_LookupObjectJson(plan.json(), "nodes");
+    }
+    size_t const n = (TRI_IsArrayJson(nodes) ? TRI_LengthArrayJson(nodes) : 0);
+
+    for (size_t i = 0; i < n; ++i) {
+      TRI_json_t* node = TRI_LookupArrayJson(nodes, i);
+
+      if (TRI_IsObjectJson(node) &&
+          JsonHelper::getStringValue(node, "type", "") == "RemoteNode") {
+        triagens::basics::Json id(remoteQueryId);
+        TRI_ReplaceObjectJson(TRI_UNKNOWN_MEM_ZONE, node, "queryId", id.json());
+      }
+    }
+  }
+
   auto query = new Query(_applicationV8, false, _vocbase, plan, options.steal(), (part == "main" ? PART_MAIN : PART_DEPENDENT));
   QueryResult res = query->prepare(_queryRegistry);
   if (res.code != TRI_ERROR_NO_ERROR) {
+    delete query;
+
+    if (fromCache) {
+      // the kept plan does not fit anymore, e.g. because an index has been
+      // dropped. let the coordinator send the current one
+      snippets->remove(_vocbase, snippet);
+      generateError(HttpResponse::NOT_FOUND, TRI_ERROR_QUERY_SNIPPET_NOT_FOUND);
+      return;
+    }
+
     LOG_ERROR("failed to instantiate the query: %s", res.details.c_str());
 
     generateError(HttpResponse::BAD, TRI_ERROR_QUERY_BAD_JSON_PLAN,
       res.details);
-    delete query;
     return;
   }
 
+  if (snippet != 0 && ! fromCache) {
+    try {
+      snippets->store(_vocbase, snippet, queryJson.json());
+    }
+    catch (...) {
+      // the coordinator will simply send the full plan again
+      snippet = 0;
+    }
+  }
+
   // Now the query is ready to go, store it in the registry and return:
   double ttl = 3600.0;
-  bool found;
   char const* ttlstring = _request->header("ttl", found);
   if (found) {
     ttl = StringUtils::doubleDecimal(ttlstring);
@@ -155,9 +226,10 @@ void RestAqlHandler::createQueryFromJson () {
 
   _response = createResponse(triagens::rest::HttpResponse::ACCEPTED);
   _response->setContentType("application/json; charset=utf-8");
-  triagens::basics::Json answerBody(triagens::basics::Json::Object, 2);
+  triagens::basics::Json answerBody(triagens::basics::Json::Object, 3);
   answerBody("queryId", triagens::basics::Json(StringUtils::itoa(_qId)))
-            ("ttl",     triagens::basics::Json(ttl));
+            ("ttl",     triagens::basics::Json(ttl))
+            ("snippet", triagens::basics::Json(snippet != 0));
 
   _response->body().appendText(answerBody.toString());
 }
@@ -361,6 +433,12 @@ void RestAqlHandler::createQueryFromString () {
 ///             than "atLeast" for internal reasons, for example to avoid
 ///             excessive copying. The result is the JSON representation of an 
 ///             AqlItemBlock.
+///             If the request's "Accept" header contains the content type
+///             AqlItemBlock::BinaryContentType, the result has this content
+///             type instead and consists of the binary encoding of the
+///             AqlItemBlock, directly followed by a JSON object with the
+///             attributes "error", "exhausted" and "stats". The result for
+///             an exhausted cursor is always JSON.
 ///             If "atLeast" is not given it defaults to 1, if "atMost" is not
 ///             given it defaults to ExecutionBlock::DefaultBatchSize.
 /// For the "skipSome" operation one has to give:
@@ -418,6 +496,7 @@ void RestAqlHandler::useQuery (std::string const& operation,
     if (_qId != 0) { 
       try {
         _queryRegistry->close(_vocbase, _qId);
+        schedulePrefetch();
       }
       catch (...) {
         // ignore errors on unregistering
@@ -661,6 +740,8 @@ bool RestAqlHandler::findQuery (std::string const& idString,
   static int64_t const MaxIterations = static_cast<int64_t>(30.0 * 1000000.0 / (double) SingleWaitPeriod); 
 
   int64_t iterations = 0;
+  auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+  bool blocked = false;
 
   // probably need to cycle here until we can get hold of the query
   while (++iterations < MaxIterations) {
@@ -672,11 +753,21 @@ bool RestAqlHandler::findQuery (std::string const& idString,
     }
     catch (...) {
       // we can only get here if the query is currently used by someone 
-      // else. in this case we sleep for a while and re-try
+      // else, e.g. a prefetch job. in this case we sleep for a while and
+      // re-try. the dispatcher may start another thread meanwhile, so the
+      // query we are waiting for does not starve
+      if (currentThread != nullptr && ! blocked) {
+        currentThread->block();
+        blocked = true;
+      }
       usleep(SingleWaitPeriod);
     }
   }
 
+  if (blocked) {
+    currentThread->unblock();
+  }
+
   if (query == nullptr) {
     _qId = 0;
     generateError(HttpResponse::NOT_FOUND, TRI_ERROR_QUERY_NOT_FOUND);
@@ -741,6 +832,12 @@ void RestAqlHandler::handleUseQuery (std::string const& operation,
     std::unique_ptr<AqlItemBlock> items;
     if (shardId.empty()) {
       items.reset(query->engine()->getSome(atLeast, atMost));
+
+      if (items.get() != nullptr && query->engine()->canPrefetch()) {
+        // compute the next batch while the coordinator works on this one
+        _prefetchAtLeast = atLeast;
+        _prefetchAtMost = atMost;
+      }
     }
     else {
       auto block = static_cast<BlockWithClients*>(query->engine()->root());
@@ -755,6 +852,29 @@ void RestAqlHandler::handleUseQuery (std::string const& operation,
         ("error", triagens::basics::Json(false))
         ("stats", query->getStats());
     }
+    else if (acceptsBinaryBlocks()) {
+      // the body is the binary encoded block, followed by the remaining
+      // attributes as JSON
+      StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+      try {
+        items->toBinary(query->trx(), buffer);
+        answerBody("error", triagens::basics::Json(false))
+          ("exhausted", triagens::basics::Json(false))
+          ("stats", query->getStats());
+        answerBody.dump(buffer);
+      }
+      catch (...) {
+        LOG_ERROR("cannot transform AqlItemBlock to binary");
+        generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_HTTP_SERVER_ERROR,
+                      "cannot transform AqlItemBlock to binary");
+        return;
+      }
+
+      _response = createResponse(triagens::rest::HttpResponse::OK);
+      _response->setContentType(AqlItemBlock::BinaryContentType);
+      _response->body().swap(&buffer);
+      return;
+    }
     else {
       try {
         answerBody = items->toJson(query->trx());
@@ -888,6 +1008,55 @@ void RestAqlHandler::handleUseQuery (std::string const& operation,
   _response->body().appendText(answerBody.toString());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the client accepts binary encoded AqlItemBlocks
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestAqlHandler::acceptsBinaryBlocks () const {
+  bool found;
+  char const* accept = _request->header("accept", found);
+
+  return (found && 
+          accept != nullptr && 
+          strstr(accept, AqlItemBlock::BinaryContentType) != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief has the next batch of the current query computed in the background
+////////////////////////////////////////////////////////////////////////////////
+
+void RestAqlHandler::schedulePrefetch () {
+  size_t const atLeast = _prefetchAtLeast;
+  size_t const atMost = _prefetchAtMost;
+  _prefetchAtLeast = 0;
+  _prefetchAtMost = 0;
+
+  auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+
+  if (atMost == 0 || currentThread == nullptr) {
+    return;
+  }
+
+  if (! TRI_UseVocBase(_vocbase)) {
+    return;
+  }
+
+  auto job = new QueryPrefetchJob(_queryRegistry, _vocbase, _qId, atLeast, atMost);
+  int res;
+
+  try {
+    res = currentThread->dispatcher()->addJob(job);
+  }
+  catch (...) {
+    res = TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // releases the database
+    delete job;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extract the JSON from the request
 ////////////////////////////////////////////////////////////////////////////////
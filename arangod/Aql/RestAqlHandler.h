@@ -188,6 +188,18 @@ namespace triagens {
 
         TRI_json_t* parseJsonBody ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the client accepts binary encoded AqlItemBlocks
+////////////////////////////////////////////////////////////////////////////////
+
+        bool acceptsBinaryBlocks () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief has the next batch of the current query computed in the background
+////////////////////////////////////////////////////////////////////////////////
+
+        void schedulePrefetch ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -237,6 +249,15 @@ namespace triagens {
                         
         QueryId _qId;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief batch size to prefetch for the current query, 0 if the query is
+/// not to be prefetched
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _prefetchAtLeast;
+
+        size_t _prefetchAtMost;
+
     };
   }
 }
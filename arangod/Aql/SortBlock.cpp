@@ -28,6 +28,9 @@
 #include "Aql/SortBlock.h"
 #include "Aql/ExecutionEngine.h"
 #include "Basics/Exceptions.h"
+#include "Basics/files.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/json-utilities.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -37,6 +40,42 @@ using namespace triagens::aql;
 using Json = triagens::basics::Json;
 using JsonHelper = triagens::basics::JsonHelper;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the sort key of a value, ordered like AqlValue::Compare with
+/// utf8 comparison. returns false for value types without a sort key
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AppendSortKey (AqlValue const& value,
+                           std::string& key) {
+  switch (value.type()) {
+    case AqlValue::EMPTY: {
+      // empty values are less than all others, the keys of json values
+      // start with a tag greater than 0
+      key.push_back('\0');
+      return true;
+    }
+
+    case AqlValue::INLINE: {
+      TRI_json_t json;
+      value.fillInlineJson(&json);
+      return TRI_AppendSortKeyJson(&json, true, key);
+    }
+
+    case AqlValue::JSON: {
+      return TRI_AppendSortKeyJson(value._json->json(), true, key);
+    }
+
+    default: {
+      // documents, ranges and document vectors are compared by AqlValue::Compare
+      return false;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   class SortBlock
 // -----------------------------------------------------------------------------
@@ -45,7 +84,11 @@ SortBlock::SortBlock (ExecutionEngine* engine,
                       SortNode const* en)
   : ExecutionBlock(engine, en),
     _sortRegisters(),
-    _stable(en->_stable) {
+    _stable(en->_stable),
+    _limit(0),
+    _spillThreshold(engine->getQuery()->sortSpillThreshold()),
+    _runs(),
+    _heap() {
   
   for (auto const& p : en->_elements) {
     auto it = en->getRegisterPlan()->varInfo.find(p.first->id);
@@ -53,9 +96,26 @@ SortBlock::SortBlock (ExecutionEngine* engine,
     TRI_ASSERT(it->second.registerId < ExecutionNode::MaxRegisterId);
     _sortRegisters.emplace_back(make_pair(it->second.registerId, p.second));
   }
+
+  // if the sort is directly followed by a LIMIT, only the first 
+  // offset + limit rows are ever needed. this does not hold if the
+  // LIMIT must count all rows
+  auto parents = en->getParents();
+
+  if (parents.size() == 1 && 
+      parents[0]->getType() == ExecutionNode::LIMIT) {
+    auto limitNode = static_cast<LimitNode const*>(parents[0]);
+
+    if (! limitNode->_fullCount && 
+        limitNode->_limit > 0 &&
+        limitNode->_offset < SIZE_MAX - limitNode->_limit) {
+      _limit = limitNode->_offset + limitNode->_limit;
+    }
+  }
 }
 
 SortBlock::~SortBlock () {
+  clearRuns();
 }
 
 int SortBlock::initialize () {
@@ -67,16 +127,51 @@ int SortBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
   }
+  clearRuns();
+
   // suck all blocks into _buffer
+  size_t rows = 0;
+
   while (getBlock(DefaultBatchSize, DefaultBatchSize)) {
+    rows += _buffer.back()->size();
+
+    if (_limit > 0 && 
+        rows >= (std::max)(2 * _limit, DefaultBatchSize)) {
+      // top-k: rows beyond the limit will never be returned
+      doSorting();
+      truncateBuffer(_limit);
+      rows = _limit;
+    }
+
+    if (_spillThreshold > 0 && 
+        rows >= _spillThreshold) {
+      doSorting();
+      spillBuffer();
+      rows = 0;
+    }
   }
 
-  if (_buffer.empty()) {
+  if (_buffer.empty() && _runs.empty()) {
     _done = true;
     return TRI_ERROR_NO_ERROR;
   }
 
-  doSorting();
+  if (_runs.empty()) {
+    doSorting();
+
+    if (_limit > 0) {
+      truncateBuffer(_limit);
+    }
+  }
+  else {
+    // external sort: write the remaining rows to a run as well, and
+    // produce the result by merging the runs
+    if (! _buffer.empty()) {
+      doSorting();
+      spillBuffer();
+    }
+    startMerge();
+  }
 
   _done = false;
   _pos = 0;
@@ -84,6 +179,24 @@ int SortBlock::initializeCursor (AqlItemBlock* items, size_t pos) {
   return TRI_ERROR_NO_ERROR;
 }
 
+bool SortBlock::hasMore () {
+  if (! _done && ! _heap.empty()) {
+    return true;
+  }
+  return ExecutionBlock::hasMore();
+}
+
+int SortBlock::getOrSkipSome (size_t atLeast,
+                              size_t atMost,
+                              bool skipping,
+                              AqlItemBlock*& result,
+                              size_t& skipped) {
+  if (! _done && ! _heap.empty()) {
+    fillFromRuns(atMost);
+  }
+  return ExecutionBlock::getOrSkipSome(atLeast, atMost, skipping, result, skipped);
+}
+
 void SortBlock::doSorting () {
   // coords[i][j] is the <j>th row of the <i>th block
   std::vector<std::pair<size_t, size_t>> coords;
@@ -108,20 +221,22 @@ void SortBlock::doSorting () {
     count++;
   }
 
-  std::vector<TRI_document_collection_t const*> colls;
-  for (RegisterId i = 0; i < _sortRegisters.size(); i++) {
-    colls.emplace_back(_buffer.front()->getDocumentCollection(_sortRegisters[i].first));
-  }
+  if (! sortByKeys(coords)) {
+    std::vector<TRI_document_collection_t const*> colls;
+    for (RegisterId i = 0; i < _sortRegisters.size(); i++) {
+      colls.emplace_back(_buffer.front()->getDocumentCollection(_sortRegisters[i].first));
+    }
 
-  // comparison function
-  OurLessThan ourLessThan(_trx, _buffer, _sortRegisters, colls);
+    // comparison function
+    OurLessThan ourLessThan(_trx, _buffer, _sortRegisters, colls);
 
-  // sort coords
-  if (_stable) {
-    std::stable_sort(coords.begin(), coords.end(), ourLessThan);
-  }
-  else {
-    std::sort(coords.begin(), coords.end(), ourLessThan);
+    // sort coords
+    if (_stable) {
+      std::stable_sort(coords.begin(), coords.end(), ourLessThan);
+    }
+    else {
+      std::sort(coords.begin(), coords.end(), ourLessThan);
+    }
   }
 
   // here we collect the new blocks (later swapped into _buffer):
@@ -174,8 +289,9 @@ void SortBlock::doSorting () {
               // valueCount there.
               auto vCount = _buffer[coords[count].first]->valueCount(a);
 
-              if (vCount == 0) {
-                // Was already stolen for another block
+              if (vCount == 0 || _buffer[coords[count].first]->hasReferencedValues()) {
+                // Was already stolen for another block, or may point into
+                // a value that only lives as long as the original block
                 AqlValue b = a.clone();
                 try {
                   TRI_IF_FAILURE("SortBlock::doSortingCache") {
@@ -252,6 +368,318 @@ void SortBlock::doSorting () {
   }
 }
 
+void SortBlock::truncateBuffer (size_t n) {
+  size_t count = 0;
+
+  for (size_t i = 0; i < _buffer.size(); ++i) {
+    size_t const size = _buffer[i]->size();
+
+    if (count + size >= n) {
+      _buffer[i]->shrink(n - count);
+
+      for (size_t j = i + 1; j < _buffer.size(); ++j) {
+        delete _buffer[j];
+      }
+      _buffer.resize(i + 1);
+      return;
+    }
+
+    count += size;
+  }
+}
+
+void SortBlock::spillBuffer () {
+  std::unique_ptr<SortedRun> run(new SortedRun());
+
+  for (auto const& block : _buffer) {
+    run->append(block, _trx);
+  }
+
+  _runs.emplace_back(run.get());
+  run.release();
+
+  for (auto& x : _buffer) {
+    delete x;
+  }
+  _buffer.clear();
+}
+
+void SortBlock::startMerge () {
+  _heap.clear();
+  _heap.reserve(_runs.size());
+
+  for (size_t i = 0; i < _runs.size(); ++i) {
+    _runs[i]->rewind();
+
+    if (_runs[i]->next()) {
+      _heap.emplace_back(i);
+    }
+  }
+
+  auto greater = [this] (size_t a, size_t b) -> bool {
+    return runLessThan(b, a);
+  };
+  std::make_heap(_heap.begin(), _heap.end(), greater);
+}
+
+void SortBlock::fillFromRuns (size_t atLeast) {
+  auto greater = [this] (size_t a, size_t b) -> bool {
+    return runLessThan(b, a);
+  };
+
+  size_t available = 0;
+  for (auto const& block : _buffer) {
+    available += block->size();
+  }
+  available -= _pos;
+
+  while (available < atLeast && ! _heap.empty()) {
+    RegisterId const nrregs = _runs[_heap.front()]->block()->getNrRegs();
+    std::unique_ptr<AqlItemBlock> next(new AqlItemBlock(DefaultBatchSize, nrregs));
+    size_t i = 0;
+
+    while (i < DefaultBatchSize && ! _heap.empty()) {
+      std::pop_heap(_heap.begin(), _heap.end(), greater);
+      SortedRun* run = _runs[_heap.back()];
+      AqlItemBlock* src = run->block();
+      size_t const pos = run->pos();
+
+      for (RegisterId j = 0; j < nrregs; j++) {
+        AqlValue const a = src->getValueReference(pos, j);
+
+        if (a.isEmpty()) {
+          continue;
+        }
+
+        if (! a.requiresDestruction()) {
+          next->setValue(i, j, a);
+        }
+        else if (src->valueCount(a) == 1 && ! src->hasReferencedValues()) {
+          // the only reference to the value, so we can steal it. values that
+          // may point into a value of the source block are copied instead
+          src->steal(a);
+          src->eraseValue(pos, j);
+          try {
+            next->setValue(i, j, a);
+          }
+          catch (...) {
+            AqlValue b = a;
+            b.destroy();
+            throw;
+          }
+        } 
+        else {
+          // the value is shared with other rows of the source block
+          AqlValue b = a.clone();
+          try {
+            next->setValue(i, j, b);
+          }
+          catch (...) {
+            b.destroy();
+            throw;
+          }
+        }
+      }
+      ++i;
+
+      if (run->next()) {
+        std::push_heap(_heap.begin(), _heap.end(), greater);
+      }
+      else {
+        _heap.pop_back();
+      }
+    }
+
+    TRI_ASSERT(i > 0);
+    next->shrink(i);
+
+    _buffer.emplace_back(next.get());
+    next.release();
+    available += i;
+  }
+}
+
+bool SortBlock::sortByKeys (std::vector<std::pair<size_t, size_t>>& coords) const {
+  struct Row {
+    std::string key;
+    std::pair<size_t, size_t> coord;
+  };
+
+  std::vector<Row> rows;
+  rows.reserve(coords.size());
+
+  for (auto const& coord : coords) {
+    rows.emplace_back();
+    Row& row = rows.back();
+    row.coord = coord;
+
+    for (auto const& reg : _sortRegisters) {
+      size_t const start = row.key.size();
+
+      if (! AppendSortKey(_buffer[coord.first]->getValueReference(coord.second, reg.first), row.key)) {
+        return false;
+      }
+
+      if (! reg.second) {
+        // descending. no key is a prefix of another one, so the keys of the
+        // following registers are only compared if these bytes are equal
+        for (size_t i = start; i < row.key.size(); ++i) {
+          row.key[i] = ~row.key[i];
+        }
+      }
+    }
+  }
+
+  auto less = [] (Row const& a, Row const& b) -> bool {
+    return a.key.compare(b.key) < 0;
+  };
+
+  if (_stable) {
+    std::stable_sort(rows.begin(), rows.end(), less);
+  }
+  else {
+    std::sort(rows.begin(), rows.end(), less);
+  }
+
+  for (size_t i = 0; i < rows.size(); ++i) {
+    coords[i] = rows[i].coord;
+  }
+
+  return true;
+}
+
+bool SortBlock::runLessThan (size_t a, 
+                             size_t b) const {
+  AqlItemBlock const* lhs = _runs[a]->block();
+  AqlItemBlock const* rhs = _runs[b]->block();
+
+  for (auto const& reg : _sortRegisters) {
+    int cmp = AqlValue::Compare(
+      _trx,
+      lhs->getValueReference(_runs[a]->pos(), reg.first),
+      lhs->getDocumentCollection(reg.first),
+      rhs->getValueReference(_runs[b]->pos(), reg.first),
+      rhs->getDocumentCollection(reg.first),
+      true
+    );
+    
+    if (cmp < 0) {
+      return reg.second;
+    } 
+    else if (cmp > 0) {
+      return ! reg.second;
+    }
+  }
+
+  return (a < b);
+}
+
+void SortBlock::clearRuns () {
+  for (auto& it : _runs) {
+    delete it;
+  }
+  _runs.clear();
+  _heap.clear();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        class SortBlock::SortedRun
+// -----------------------------------------------------------------------------
+
+SortBlock::SortedRun::SortedRun () 
+  : _filename(nullptr),
+    _fd(-1),
+    _numBlocks(0),
+    _numRead(0),
+    _block(nullptr),
+    _pos(0) {
+
+  long systemError;
+  std::string errorMessage;
+
+  if (TRI_GetTempName("aql-sort", &_filename, false, systemError, errorMessage) != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_CANNOT_CREATE_TEMP_FILE, errorMessage);
+  }
+
+  _fd = TRI_CREATE(_filename, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+  if (_fd < 0) {
+    TRI_Free(TRI_CORE_MEM_ZONE, _filename);
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CANNOT_CREATE_TEMP_FILE);
+  }
+}
+
+SortBlock::SortedRun::~SortedRun () {
+  delete _block;
+
+  TRI_CLOSE(_fd);
+  TRI_UnlinkFile(_filename);
+  TRI_Free(TRI_CORE_MEM_ZONE, _filename);
+}
+
+void SortBlock::SortedRun::append (AqlItemBlock const* block,
+                                   triagens::arango::AqlTransaction* trx) {
+  std::string const data = block->toJson(trx).toString();
+  uint64_t const length = static_cast<uint64_t>(data.size());
+
+  if (! TRI_WritePointer(_fd, &length, sizeof(length)) ||
+      ! TRI_WritePointer(_fd, data.c_str(), data.size())) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_CANNOT_WRITE_FILE);
+  }
+
+  ++_numBlocks;
+}
+
+void SortBlock::SortedRun::rewind () {
+  if (TRI_LSEEK(_fd, 0, SEEK_SET) != 0) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+
+  delete _block;
+  _block = nullptr;
+  _numRead = 0;
+  _pos = 0;
+}
+
+bool SortBlock::SortedRun::next () {
+  if (_block != nullptr && ++_pos < _block->size()) {
+    return true;
+  }
+
+  delete _block;
+  _block = nullptr;
+  _pos = 0;
+
+  if (_numRead == _numBlocks) {
+    return false;
+  }
+
+  uint64_t length;
+
+  if (! TRI_ReadPointer(_fd, &length, sizeof(length))) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+  
+  std::string data;
+  data.resize(static_cast<size_t>(length));
+
+  if (! TRI_ReadPointer(_fd, &data[0], data.size())) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_SYS_ERROR);
+  }
+
+  ++_numRead;
+  
+  Json json(TRI_UNKNOWN_MEM_ZONE, JsonHelper::fromString(data));
+
+  if (json.isEmpty()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid data in sort run");
+  }
+
+  _block = new AqlItemBlock(json);
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      class SortBlock::OurLessThan
 // -----------------------------------------------------------------------------
@@ -60,14 +60,130 @@ namespace triagens {
 
         int initializeCursor (AqlItemBlock* items, size_t pos) override final;
 
+        bool hasMore () override final;
+
+      private:
+
+        int getOrSkipSome (size_t atLeast,
+                           size_t atMost,
+                           bool skipping,
+                           AqlItemBlock*& result,
+                           size_t& skipped) override final;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dosorting
 ////////////////////////////////////////////////////////////////////////////////
 
-      private:
-
         void doSorting ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sort the coordinates of the rows in _buffer by binary sort keys,
+/// which are computed once per row. returns false if a sort value has no
+/// key, the coordinates must be sorted by OurLessThan then
+////////////////////////////////////////////////////////////////////////////////
+
+        bool sortByKeys (std::vector<std::pair<size_t, size_t>>&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keep only the first n rows of the sorted _buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        void truncateBuffer (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write the sorted _buffer to a new run and empty the buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        void spillBuffer ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepare the merge of all runs
+////////////////////////////////////////////////////////////////////////////////
+
+        void startMerge ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merge rows from the runs into _buffer until it contains at least
+/// the specified number of rows or all runs are exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+        void fillFromRuns (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compare the current rows of two runs. ties are broken by the run
+/// index, so the merge is stable
+////////////////////////////////////////////////////////////////////////////////
+
+        bool runLessThan (size_t, size_t) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief delete all runs and their temporary files
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearRuns ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief SortedRun, a sorted sequence of rows in a temporary file. the
+/// rows are stored as serialized AqlItemBlocks, in the same format that is
+/// used for sending blocks between cluster nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        class SortedRun {
+
+          public:
+
+            SortedRun (SortedRun const&) = delete;
+            SortedRun& operator= (SortedRun const&) = delete;
+
+            SortedRun ();
+
+            ~SortedRun ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a block to the run
+////////////////////////////////////////////////////////////////////////////////
+
+            void append (AqlItemBlock const*,
+                         triagens::arango::AqlTransaction*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finish writing and start reading the run from the beginning
+////////////////////////////////////////////////////////////////////////////////
+
+            void rewind ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief move to the next row. returns false if the run is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+            bool next ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the block containing the current row
+////////////////////////////////////////////////////////////////////////////////
+
+            AqlItemBlock* block () const {
+              return _block;
+            }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the position of the current row in the current block
+////////////////////////////////////////////////////////////////////////////////
+
+            size_t pos () const {
+              return _pos;
+            }
+
+          private:
+
+            char*         _filename;
+            int           _fd;
+            size_t        _numBlocks;
+            size_t        _numRead;
+            AqlItemBlock* _block;
+            size_t        _pos;
+        };
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief OurLessThan
 ////////////////////////////////////////////////////////////////////////////////
@@ -108,6 +224,32 @@ namespace triagens {
 
         bool _stable;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows the sort must produce if it is directly followed
+/// by a LIMIT (offset + limit), 0 if all rows must be produced
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _limit;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows kept in memory before a sorted run is written to
+/// disk, 0 if the sort never spills
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _spillThreshold;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sorted runs written to disk
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<SortedRun*> _runs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief min-heap of the indexes of all runs that still have rows
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _heap;
+
     };
 
   }  // namespace triagens::aql
@@ -173,39 +173,48 @@ SortCondition::~SortCondition () {
 
 size_t SortCondition::coveredAttributes (Variable const* reference,
                                          std::vector<std::vector<triagens::basics::AttributeName>> const& indexAttributes) const {
+  return coveredAttributes(reference, indexAttributes, std::unordered_set<size_t>());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of attributes in the sort condition covered
+/// by the specified index fields, leaving out fixed index fields
+////////////////////////////////////////////////////////////////////////////////
+
+size_t SortCondition::coveredAttributes (Variable const* reference,
+                                         std::vector<std::vector<triagens::basics::AttributeName>> const& indexAttributes,
+                                         std::unordered_set<size_t> const& fixedAttributes) const {
   size_t numAttributes = 0;
 
   for (size_t i = 0; i < indexAttributes.size(); ++i) {
-    if (i >= _fields.size()) {
+    if (numAttributes >= _fields.size()) {
       break;
     }
 
-    if (reference != _fields[i].first) {
-      break;
-    }
+    bool found = (reference == _fields[numAttributes].first);
 
-    auto const& fieldNames = _fields[i].second;
+    auto const& fieldNames = _fields[numAttributes].second;
     if (fieldNames.size() != indexAttributes[i].size()) {
       // different attribute path
-      break;
+      found = false;
     }
 
-    bool found = true;
-    for (size_t j = 0; j < indexAttributes[i].size(); ++j) {
+    for (size_t j = 0; found && j < indexAttributes[i].size(); ++j) {
       if (indexAttributes[i][j].shouldExpand ||
           fieldNames[j] != indexAttributes[i][j]) {
         // expanded attribute or different attribute
         found = false;
-        break;
       }
     }
 
-    if (! found) {
+    if (found) {
+      // same attribute
+      ++numAttributes;
+    }
+    else if (fixedAttributes.find(i) == fixedAttributes.end()) {
       break;
     }
-
-    // same attribute
-    ++numAttributes;
+    // else: the index attribute does not change the order of the results
   }
 
   return numAttributes;
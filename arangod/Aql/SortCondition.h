@@ -144,6 +144,16 @@ namespace triagens {
         size_t coveredAttributes (Variable const*,
                                   std::vector<std::vector<triagens::basics::AttributeName>> const&) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of attributes in the sort condition covered
+/// by the specified index fields. the index fields at the given positions
+/// have the same value in all results, and may be left out of the sort
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t coveredAttributes (Variable const*,
+                                  std::vector<std::vector<triagens::basics::AttributeName>> const&,
+                                  std::unordered_set<size_t> const&) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -37,18 +37,43 @@ using namespace triagens::aql;
 // -----------------------------------------------------------------------------
 // --SECTION--                                               class SubqueryBlock
 // -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of cache entries
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const SubqueryBlock::MaxCacheEntries = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of rows in all cached results
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const SubqueryBlock::MaxCachedRows = 100000;
         
 SubqueryBlock::SubqueryBlock (ExecutionEngine* engine,
                               SubqueryNode const* en,
                               ExecutionBlock* subquery)
   : ExecutionBlock(engine, en), 
     _outReg(ExecutionNode::MaxRegisterId),
-    _subquery(subquery) {
+    _subquery(subquery),
+    _cacheResults(en->cacheResults()),
+    _keyRegisters(),
+    _cache(),
+    _cacheEntries(0),
+    _cachedRows(0) {
   
   auto it = en->getRegisterPlan()->varInfo.find(en->_outVariable->id);
   TRI_ASSERT(it != en->getRegisterPlan()->varInfo.end());
   _outReg = it->second.registerId;
   TRI_ASSERT(_outReg < ExecutionNode::MaxRegisterId);
+
+  if (_cacheResults) {
+    for (auto const& v : en->getVariablesUsedHere()) {
+      auto it2 = en->getRegisterPlan()->varInfo.find(v->id);
+      TRI_ASSERT(it2 != en->getRegisterPlan()->varInfo.end());
+      _keyRegisters.emplace_back(it2->second.registerId);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -56,6 +81,7 @@ SubqueryBlock::SubqueryBlock (ExecutionEngine* engine,
 ////////////////////////////////////////////////////////////////////////////////
 
 SubqueryBlock::~SubqueryBlock () {
+  clearCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -84,41 +110,69 @@ AqlItemBlock* SubqueryBlock::getSome (size_t atLeast,
     return nullptr;
   }
 
-  // TODO: constant and deterministic subqueries only need to be executed once
-  bool const subqueryIsConst = false; // TODO 
-
-  std::vector<AqlItemBlock*>* subqueryResults = nullptr;
+  // results already used in this block, by cache entry. rows of the same
+  // block share their value, the item block counts the references
+  std::unordered_map<CacheEntry const*, AqlValue> used;
 
   for (size_t i = 0; i < res->size(); i++) {
+    uint64_t hash = 0;
+
+    if (_cacheResults) {
+      hash = hashKeys(res.get(), i);
+      CacheEntry const* entry = lookupCache(res.get(), i, hash);
+
+      if (entry != nullptr) {
+        auto it = used.find(entry);
+
+        if (it != used.end()) {
+          res->setValue(i, _outReg, (*it).second);
+        }
+        else {
+          AqlValue copy = entry->result.clone();
+
+          try {
+            res->setValue(i, _outReg, copy);
+          }
+          catch (...) {
+            copy.destroy();
+            throw;
+          }
+          used.emplace(entry, copy);
+        }
+
+        throwIfKilled(); // check if we were aborted
+        continue;
+      }
+    }
+
     int ret = _subquery->initializeCursor(res.get(), i);
 
     if (ret != TRI_ERROR_NO_ERROR) {
       THROW_ARANGO_EXCEPTION(ret);
     }
 
-    if (i > 0 && subqueryIsConst) {
-      // re-use already calculated subquery result
-      TRI_ASSERT(subqueryResults != nullptr);
+    // execute the subquery
+    std::vector<AqlItemBlock*>* subqueryResults = executeSubquery();
+    TRI_ASSERT(subqueryResults != nullptr);
+
+    try {
+      TRI_IF_FAILURE("SubqueryBlock::getSome") {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+      }
       res->setValue(i, _outReg, AqlValue(subqueryResults));
     }
-    else {
-      // initial subquery execution or subquery is not constant
+    catch (...) {
+      destroySubqueryResults(subqueryResults);
+      throw;
+    }
 
-      // execute the subquery
-      subqueryResults = executeSubquery();
-      TRI_ASSERT(subqueryResults != nullptr);
+    if (_cacheResults) {
+      CacheEntry const* entry = storeCache(res.get(), i, hash, subqueryResults);
 
-      try {
-        TRI_IF_FAILURE("SubqueryBlock::getSome") {
-          THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
-        }
-        res->setValue(i, _outReg, AqlValue(subqueryResults));
-      }
-      catch (...) {
-        destroySubqueryResults(subqueryResults);
-        throw;
+      if (entry != nullptr) {
+        used.emplace(entry, AqlValue(subqueryResults));
       }
-    } 
+    }
       
     throwIfKilled(); // check if we were aborted
   }
@@ -151,7 +205,7 @@ std::vector<AqlItemBlock*>* SubqueryBlock::executeSubquery () {
 
   try {
     do {
-      std::unique_ptr<AqlItemBlock> tmp(_subquery->getSome(DefaultBatchSize, DefaultBatchSize));
+      std::unique_ptr<AqlItemBlock> tmp(_subquery->profiledGetSome(DefaultBatchSize, DefaultBatchSize));
 
       if (tmp.get() == nullptr) {
         break;
@@ -173,6 +227,124 @@ std::vector<AqlItemBlock*>* SubqueryBlock::executeSubquery () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash the values of the outer variables in a row
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t SubqueryBlock::hashKeys (AqlItemBlock const* items,
+                                  size_t row) {
+  uint64_t hash = 0x012345678;
+
+  for (auto const& reg : _keyRegisters) {
+    uint64_t const h = items->getValueReference(row, reg).hash(_trx, items->getDocumentCollection(reg));
+    hash ^= h + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the cache entry for the values of the outer variables in a row
+////////////////////////////////////////////////////////////////////////////////
+
+SubqueryBlock::CacheEntry const* SubqueryBlock::lookupCache (AqlItemBlock const* items,
+                                                             size_t row,
+                                                             uint64_t hash) {
+  auto it = _cache.find(hash);
+
+  if (it == _cache.end()) {
+    return nullptr;
+  }
+
+  for (auto const& entry : (*it).second) {
+    bool equal = true;
+
+    for (size_t j = 0; j < _keyRegisters.size(); ++j) {
+      RegisterId const reg = _keyRegisters[j];
+
+      if (AqlValue::Compare(_trx,
+                            entry->keys[j], entry->collections[j],
+                            items->getValueReference(row, reg), items->getDocumentCollection(reg),
+                            false) != 0) {
+        equal = false;
+        break;
+      }
+    }
+
+    if (equal) {
+      return entry;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a copy of the results for the values of the outer variables
+////////////////////////////////////////////////////////////////////////////////
+
+SubqueryBlock::CacheEntry const* SubqueryBlock::storeCache (AqlItemBlock const* items,
+                                                            size_t row,
+                                                            uint64_t hash,
+                                                            std::vector<AqlItemBlock*> const* results) {
+  size_t rows = 0;
+  for (auto const& it : *results) {
+    rows += it->size();
+  }
+
+  if (_cacheEntries >= MaxCacheEntries ||
+      _cachedRows + rows > MaxCachedRows) {
+    return nullptr;
+  }
+
+  std::unique_ptr<CacheEntry> entry(new CacheEntry);
+
+  try {
+    entry->keys.reserve(_keyRegisters.size());
+    entry->collections.reserve(_keyRegisters.size());
+
+    for (auto const& reg : _keyRegisters) {
+      entry->keys.emplace_back(items->getValueReference(row, reg).clone());
+      entry->collections.emplace_back(items->getDocumentCollection(reg));
+    }
+
+    entry->result = AqlValue(const_cast<std::vector<AqlItemBlock*>*>(results)).clone();
+    _cache[hash].emplace_back(entry.get());
+  }
+  catch (...) {
+    for (auto& key : entry->keys) {
+      key.destroy();
+    }
+    entry->result.destroy();
+    throw;
+  }
+
+  ++_cacheEntries;
+  _cachedRows += rows;
+
+  return entry.release();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free all cache entries
+////////////////////////////////////////////////////////////////////////////////
+
+void SubqueryBlock::clearCache () {
+  for (auto& it : _cache) {
+    for (auto& entry : it.second) {
+      for (auto& key : entry->keys) {
+        key.destroy();
+      }
+      entry->result.destroy();
+      delete entry;
+    }
+  }
+
+  _cache.clear();
+  _cacheEntries = 0;
+  _cachedRows = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy the results of a subquery
 ////////////////////////////////////////////////////////////////////////////////
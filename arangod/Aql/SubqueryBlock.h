@@ -43,6 +43,16 @@ namespace triagens {
 // --SECTION--                                                     SubqueryBlock
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief subquery block
+///
+/// the subquery is executed for every input row. if the node allows it, the
+/// results are cached by the values of the outer variables the subquery
+/// uses, so that an uncorrelated subquery is executed once, and a correlated
+/// one once per distinct combination of these values. the cache is kept
+/// until the block is destroyed, and its size is limited
+////////////////////////////////////////////////////////////////////////////////
+
     class SubqueryBlock : public ExecutionBlock {
 
       public:
@@ -86,6 +96,58 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cached results of the subquery for one combination of values of
+/// the outer variables
+////////////////////////////////////////////////////////////////////////////////
+
+        struct CacheEntry {
+          std::vector<AqlValue>                          keys;
+          std::vector<TRI_document_collection_t const*>  collections;
+          AqlValue                                       result;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of cache entries
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxCacheEntries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of rows in all cached results
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxCachedRows;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash the values of the outer variables in a row
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t hashKeys (AqlItemBlock const*, size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the cache entry for the values of the outer variables in a
+/// row, returns nullptr if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        CacheEntry const* lookupCache (AqlItemBlock const*, size_t, uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a copy of the results for the values of the outer variables
+/// in a row, returns nullptr if the cache is full
+////////////////////////////////////////////////////////////////////////////////
+
+        CacheEntry const* storeCache (AqlItemBlock const*,
+                                      size_t,
+                                      uint64_t,
+                                      std::vector<AqlItemBlock*> const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free all cache entries
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearCache ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief execute the subquery and return its results
 ////////////////////////////////////////////////////////////////////////////////
@@ -109,6 +171,36 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         ExecutionBlock* _subquery;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the results are cached
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _cacheResults;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers of the outer variables used by the subquery
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<RegisterId> _keyRegisters;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cached results, by the hash of the outer variables
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<uint64_t, std::vector<CacheEntry*>> _cache;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of cache entries
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _cacheEntries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows in all cached results
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _cachedRows;
     };
 
   }  // namespace triagens::aql
@@ -0,0 +1,442 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, native graph traversal
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/Traversal.h"
+#include "Aql/AqlValue.h"
+#include "Basics/Exceptions.h"
+#include "Utils/CollectionNameResolver.h"
+#include "VocBase/KeyGenerator.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::aql;
+using namespace triagens::basics::traverser;
+
+using Json = triagens::basics::Json;
+using JsonHelper = triagens::basics::JsonHelper;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief throws an argument type mismatch for TRAVERSE
+////////////////////////////////////////////////////////////////////////////////
+
+static void ThrowTypeMismatch () {
+  THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_TYPE_MISMATCH, "TRAVERSE");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a uniqueness option
+////////////////////////////////////////////////////////////////////////////////
+
+static TraversalOptions::Uniqueness ParseUniqueness (Json const& value,
+                                                     TraversalOptions::Uniqueness defaultValue) {
+  if (value.isEmpty()) {
+    return defaultValue;
+  }
+
+  if (! value.isString()) {
+    ThrowTypeMismatch();
+  }
+
+  std::string const uniqueness = JsonHelper::getStringValue(value.json(), "");
+
+  if (uniqueness == "none") {
+    return TraversalOptions::UNIQUE_NONE;
+  }
+  if (uniqueness == "path") {
+    return TraversalOptions::UNIQUE_PATH;
+  }
+  if (uniqueness == "global") {
+    return TraversalOptions::UNIQUE_GLOBAL;
+  }
+
+  ThrowTypeMismatch();
+  return defaultValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wraps a single example into an array. examples in an array that
+/// use attributes unknown to the shaper do not match, while a single one
+/// would make the ExampleMatcher throw
+////////////////////////////////////////////////////////////////////////////////
+
+static Json ExampleArray (Json const& examples) {
+  if (examples.isArray()) {
+    return examples.copy();
+  }
+
+  Json result(Json::Array, 1);
+  result.add(examples.copy());
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the traversal
+////////////////////////////////////////////////////////////////////////////////
+
+Traversal::Traversal (triagens::arango::AqlTransaction* trx,
+                      Json const& vertexCollection,
+                      Json const& edgeCollection,
+                      Json const& startVertex,
+                      Json const& direction,
+                      Json const& options)
+  : _trx(trx),
+    _vertexCid(0),
+    _edgeCid(0),
+    _paths(true) {
+
+  auto resolver = _trx->resolver();
+
+  if (! vertexCollection.isString() ||
+      ! edgeCollection.isString()) {
+    ThrowTypeMismatch();
+  }
+
+  std::string const vColName = JsonHelper::getStringValue(vertexCollection.json(), "");
+  std::string const eColName = JsonHelper::getStringValue(edgeCollection.json(), "");
+
+  _vertexCid = resolver->getCollectionId(vColName);
+  _edgeCid = resolver->getCollectionId(eColName);
+
+  if (_vertexCid == 0) {
+    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND, "'%s'", vColName.c_str());
+  }
+  if (_edgeCid == 0) {
+    THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND, "'%s'", eColName.c_str());
+  }
+
+  // start vertex, given as _id, _key or document
+  std::string vertexId;
+
+  if (startVertex.isString()) {
+    vertexId = JsonHelper::getStringValue(startVertex.json(), "");
+  }
+  else if (startVertex.isObject() && startVertex.has("_id")) {
+    vertexId = JsonHelper::getStringValue(startVertex.get("_id").json(), "");
+  }
+  else {
+    ThrowTypeMismatch();
+  }
+
+  if (vertexId.find('/') != std::string::npos) {
+    size_t split;
+
+    if (! TRI_ValidateDocumentIdKeyGenerator(vertexId.c_str(), &split)) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_ARANGO_DOCUMENT_KEY_BAD);
+    }
+
+    std::string const collectionName = vertexId.substr(0, split);
+
+    if (collectionName != vColName) {
+      THROW_ARANGO_EXCEPTION_FORMAT(TRI_ERROR_GRAPH_INVALID_PARAMETER,
+                                    "specified vertex collection '%s' does not match start vertex collection '%s'",
+                                    vColName.c_str(),
+                                    collectionName.c_str());
+    }
+
+    _startKey = vertexId.substr(split + 1);
+  }
+  else {
+    _startKey = vertexId;
+  }
+
+  _opts.start = VertexId(_vertexCid, _startKey.c_str());
+
+  if (! direction.isString()) {
+    ThrowTypeMismatch();
+  }
+
+  std::string const dir = JsonHelper::getStringValue(direction.json(), "");
+
+  if (dir == "outbound") {
+    _opts.direction = TRI_EDGE_OUT;
+  }
+  else if (dir == "inbound") {
+    _opts.direction = TRI_EDGE_IN;
+  }
+  else if (dir == "any") {
+    _opts.direction = TRI_EDGE_ANY;
+  }
+  else {
+    ThrowTypeMismatch();
+  }
+
+  if (! options.isEmpty() && ! options.isNull() && ! options.isObject()) {
+    ThrowTypeMismatch();
+  }
+
+  try {
+    if (options.isObject()) {
+      parseOptions(options);
+    }
+    else {
+      parseOptions(Json(Json::Object));
+    }
+
+    _enumerator.reset(new PathEnumerator(_edgeCollectionInfos, _opts));
+  }
+  catch (...) {
+    // the destructor will not be called
+    for (auto& it : _edgeCollectionInfos) {
+      delete it;
+    }
+    throw;
+  }
+}
+
+Traversal::~Traversal () {
+  for (auto& it : _edgeCollectionInfos) {
+    delete it;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances to the next path
+////////////////////////////////////////////////////////////////////////////////
+
+bool Traversal::next () {
+  return _enumerator->next();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the result for the current path
+////////////////////////////////////////////////////////////////////////////////
+
+Json Traversal::current () {
+  if (! _paths) {
+    return vertexToJson(_enumerator->current().vertex);
+  }
+
+  _enumerator->path(_path);
+
+  Json vertices(Json::Array, _path.size());
+  Json edges(Json::Array, _path.size() - 1);
+
+  for (auto const& step : _path) {
+    vertices.add(vertexToJson(step->vertex));
+
+    if (step->edgeCollection != nullptr) {
+      edges.add(edgeToJson(step));
+    }
+  }
+
+  Json result(Json::Object, 2);
+  result("vertex", vertices.at(static_cast<int>(_path.size() - 1)).copy());
+  result("path", Json(Json::Object, 2)("edges", edges)("vertices", vertices));
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the options
+////////////////////////////////////////////////////////////////////////////////
+
+void Traversal::parseOptions (Json const& options) {
+  auto resolver = _trx->resolver();
+  TRI_json_t const* json = options.json();
+
+  std::string const strategy = JsonHelper::getStringValue(json, "strategy", "depthfirst");
+
+  if (strategy == "depthfirst") {
+    _opts.strategy = TraversalOptions::DEPTH_FIRST;
+  }
+  else if (strategy == "breadthfirst") {
+    _opts.strategy = TraversalOptions::BREADTH_FIRST;
+  }
+  else if (strategy == "weighted") {
+    _opts.strategy = TraversalOptions::WEIGHTED;
+  }
+  else {
+    ThrowTypeMismatch();
+  }
+
+  _opts.minDepth = JsonHelper::getNumericValue<uint64_t>(json, "minDepth", _opts.minDepth);
+  _opts.maxDepth = JsonHelper::getNumericValue<uint64_t>(json, "maxDepth", _opts.maxDepth);
+
+  Json uniqueness = options.get("uniqueness");
+
+  if (! uniqueness.isEmpty()) {
+    if (! uniqueness.isObject()) {
+      ThrowTypeMismatch();
+    }
+    _opts.uniqueVertices = ParseUniqueness(uniqueness.get("vertices"), _opts.uniqueVertices);
+    _opts.uniqueEdges = ParseUniqueness(uniqueness.get("edges"), _opts.uniqueEdges);
+  }
+
+  _paths = JsonHelper::getBooleanValue(json, "paths", true);
+
+  auto trxCollection = useCollection(_edgeCid);
+  auto document = trxCollection->_collection->_collection;
+  WeightCalculatorFunction weighter = [] (TRI_doc_mptr_copy_t&) -> double { return 1; };
+
+  if (_opts.strategy == TraversalOptions::WEIGHTED) {
+    std::string const weight = JsonHelper::getStringValue(json, "weight", "");
+    double const defaultWeight = JsonHelper::getNumericValue<double>(json, "defaultWeight", 1.0);
+
+    if (weight.empty()) {
+      weighter = [defaultWeight] (TRI_doc_mptr_copy_t&) -> double { return defaultWeight; };
+    }
+    else {
+      weighter = AttributeWeightCalculator(weight, defaultWeight, document->getShaper());
+    }
+  }
+
+  std::unique_ptr<EdgeCollectionInfo> eci(new EdgeCollectionInfo(_edgeCid, document, weighter));
+  _edgeCollectionInfos.emplace_back(eci.get());
+  eci.release();
+
+  Json edgeExamples = options.get("edgeExamples");
+
+  if (! edgeExamples.isEmpty() && ! edgeExamples.isNull()) {
+    if (! edgeExamples.isObject() && ! edgeExamples.isArray()) {
+      ThrowTypeMismatch();
+    }
+    _opts.addEdgeFilter(ExampleArray(edgeExamples), document->getShaper(), _edgeCid, resolver);
+  }
+
+  Json prune = options.get("prune");
+
+  if (! prune.isEmpty() && ! prune.isNull()) {
+    if (! prune.isObject() && ! prune.isArray()) {
+      ThrowTypeMismatch();
+    }
+
+    auto vertexCollection = useCollection(_vertexCid);
+    _prune.reset(new triagens::arango::ExampleMatcher(ExampleArray(prune).json(),
+                                                      vertexCollection->_collection->_collection->getShaper(),
+                                                      resolver));
+    _opts.prune = [this] (VertexId const& vertex) -> bool {
+      return mustPrune(vertex);
+    };
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a collection to the transaction if it is not yet part of it
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_transaction_collection_t* Traversal::useCollection (TRI_voc_cid_t cid) {
+  auto collection = _trx->trxCollection(cid);
+
+  if (collection == nullptr) {
+    int res = TRI_AddCollectionTransaction(_trx->getInternals(),
+                                           cid,
+                                           TRI_TRANSACTION_READ,
+                                           _trx->nestingLevel(),
+                                           true,
+                                           true);
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    TRI_EnsureCollectionsTransaction(_trx->getInternals());
+    collection = _trx->trxCollection(cid);
+
+    if (collection == nullptr) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "collection is a nullptr");
+    }
+  }
+
+  return collection;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+bool Traversal::readVertex (VertexId const& vertex,
+                            TRI_doc_mptr_copy_t& mptr) {
+  auto collection = useCollection(vertex.cid);
+
+  return (_trx->readSingle(collection, &mptr, vertex.key) == TRI_ERROR_NO_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the traversal must not continue from a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+bool Traversal::mustPrune (VertexId const& vertex) {
+  TRI_ASSERT(_prune != nullptr);
+
+  if (vertex.cid != _vertexCid) {
+    return false;
+  }
+
+  TRI_doc_mptr_copy_t mptr;
+
+  if (! readVertex(vertex, mptr)) {
+    return false;
+  }
+
+  return _prune->matches(vertex.cid, &mptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a vertex document, or null if it does not exist
+////////////////////////////////////////////////////////////////////////////////
+
+Json Traversal::vertexToJson (VertexId const& vertex) {
+  TRI_doc_mptr_copy_t mptr;
+
+  if (! readVertex(vertex, mptr)) {
+    return Json(Json::Null);
+  }
+
+  AqlValue value(static_cast<TRI_df_marker_t const*>(mptr.getDataPtr()));
+  return value.toJson(_trx, _trx->documentCollection(vertex.cid), true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the edge document of a step
+////////////////////////////////////////////////////////////////////////////////
+
+Json Traversal::edgeToJson (PathEnumerator::Step const* step) {
+  AqlValue value(static_cast<TRI_df_marker_t const*>(step->edge.getDataPtr()));
+  return value.toJson(_trx, _trx->documentCollection(step->edgeCollection->getCid()), true);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, native graph traversal
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_TRAVERSAL_H
+#define ARANGODB_AQL_TRAVERSAL_H 1
+
+#include "Basics/Common.h"
+#include "Basics/JsonHelper.h"
+#include "Utils/AqlTransaction.h"
+#include "V8Server/V8Traverser.h"
+
+namespace triagens {
+  namespace aql {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class Traversal
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a traversal with the arguments of the AQL function TRAVERSE:
+///
+///   TRAVERSE(vertexCollection, edgeCollection, startVertex, direction, options)
+///
+/// direction is "outbound", "inbound" or "any". the options are:
+/// - strategy: "depthfirst" (default), "breadthfirst" or "weighted"
+/// - minDepth, maxDepth: the depths of the paths returned (default 0, 256)
+/// - uniqueness: { vertices: "none", edges: "path" } by default, each of
+///   them can be "none", "path" or "global"
+/// - weight, defaultWeight: the edge attribute summed up by the weighted
+///   strategy, and its value for edges without it (default 1)
+/// - edgeExamples: only edges matching one of the examples are followed
+/// - prune: vertices of the vertex collection matching one of these
+///   examples are returned, but the traversal does not continue from them
+/// - paths: whether to return { vertex, path: { edges, vertices } } for
+///   every path (default) or only the vertex
+///
+/// the paths are produced one by one, so a caller can stop at any time
+////////////////////////////////////////////////////////////////////////////////
+
+    class Traversal {
+
+      public:
+
+        Traversal (Traversal const&) = delete;
+        Traversal& operator= (Traversal const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        Traversal (triagens::arango::AqlTransaction*,
+                   triagens::basics::Json const& vertexCollection,
+                   triagens::basics::Json const& edgeCollection,
+                   triagens::basics::Json const& startVertex,
+                   triagens::basics::Json const& direction,
+                   triagens::basics::Json const& options);
+
+        ~Traversal ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances to the next path. returns false if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        bool next ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the result for the current path
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json current ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the options
+////////////////////////////////////////////////////////////////////////////////
+
+        void parseOptions (triagens::basics::Json const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a collection to the transaction if it is not yet part of it
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_transaction_collection_t* useCollection (TRI_voc_cid_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a vertex. returns false if it does not exist
+////////////////////////////////////////////////////////////////////////////////
+
+        bool readVertex (VertexId const&,
+                         TRI_doc_mptr_copy_t&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the traversal must not continue from a vertex
+////////////////////////////////////////////////////////////////////////////////
+
+        bool mustPrune (VertexId const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a vertex document, or null if it does not exist
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json vertexToJson (VertexId const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the edge document of a step
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json edgeToJson (PathEnumerator::Step const*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        triagens::arango::AqlTransaction* _trx;
+
+        triagens::basics::traverser::TraversalOptions _opts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the key of the start vertex, _opts.start points into it
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _startKey;
+
+        TRI_voc_cid_t _vertexCid;
+
+        TRI_voc_cid_t _edgeCid;
+
+        std::vector<EdgeCollectionInfo*> _edgeCollectionInfos;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the prune examples, or nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unique_ptr<triagens::arango::ExampleMatcher> _prune;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether to return the paths or only the vertices
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _paths;
+
+        std::unique_ptr<PathEnumerator> _enumerator;
+
+        std::vector<PathEnumerator::Step const*> _path;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
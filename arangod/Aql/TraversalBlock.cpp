@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, traversal execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/TraversalBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionEngine.h"
+#include "Basics/Exceptions.h"
+
+using namespace std;
+using namespace triagens::arango;
+using namespace triagens::aql;
+
+using Json = triagens::basics::Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class TraversalBlock
+// -----------------------------------------------------------------------------
+
+TraversalBlock::TraversalBlock (ExecutionEngine* engine,
+                                TraversalNode const* ep)
+  : ExecutionBlock(engine, ep),
+    _inRegister(ExecutionNode::MaxRegisterId),
+    _traversal(nullptr),
+    _mustStoreResult(true) {
+
+  auto it = ep->getRegisterPlan()->varInfo.find(ep->_inVariable->id);
+
+  if (it == ep->getRegisterPlan()->varInfo.end()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "variable not found");
+  }
+
+  _inRegister = (*it).second.registerId;
+  TRI_ASSERT(_inRegister < ExecutionNode::MaxRegisterId);
+}
+
+TraversalBlock::~TraversalBlock () {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the traversal for the current input row
+////////////////////////////////////////////////////////////////////////////////
+
+void TraversalBlock::startTraversal (AqlItemBlock const* cur) {
+  AqlValue const& value = cur->getValueReference(_pos, _inRegister);
+  Json arguments(value.toJson(_trx, cur->getDocumentCollection(_inRegister), false));
+
+  if (! arguments.isArray() || 
+      arguments.size() < 4 ||
+      arguments.size() > 5) {
+    THROW_ARANGO_EXCEPTION_PARAMS(TRI_ERROR_QUERY_FUNCTION_ARGUMENT_NUMBER_MISMATCH, "TRAVERSE", (int) 4, (int) 5);
+  }
+
+  _traversal.reset(new Traversal(_trx,
+                                 arguments.at(0),
+                                 arguments.at(1),
+                                 arguments.at(2),
+                                 arguments.at(3),
+                                 arguments.at(4)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+void TraversalBlock::nextRow (AqlItemBlock* cur) {
+  _traversal.reset();
+
+  if (++_pos >= cur->size()) {
+    _buffer.pop_front();  // does not throw
+    returnBlock(cur);
+    _pos = 0;
+  }
+}
+
+int TraversalBlock::initialize () {
+  auto ep = static_cast<TraversalNode const*>(_exeNode);
+  _mustStoreResult = ep->isVarUsedLater(ep->_outVariable);
+
+  return ExecutionBlock::initialize();
+}
+
+int TraversalBlock::initializeCursor (AqlItemBlock* items,
+                                      size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  _traversal.reset();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+AqlItemBlock* TraversalBlock::getSome (size_t, // atLeast,
+                                       size_t atMost) {
+  if (_done) {
+    return nullptr;
+  }
+
+  while (true) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(DefaultBatchSize, atMost);
+      if (! ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        return nullptr;
+      }
+      _pos = 0;           // this is in the first block
+      _traversal.reset();
+    }
+
+    // if we make it here, then _buffer.front() exists
+    AqlItemBlock* cur = _buffer.front();
+
+    if (_traversal == nullptr) {
+      startTraversal(cur);
+    }
+
+    size_t const curRegs = cur->getNrRegs();
+    RegisterId nrRegs = getPlanNode()->getRegisterPlan()->nrRegs[getPlanNode()->getDepth()];
+
+    std::unique_ptr<AqlItemBlock> res(nullptr);
+    size_t j = 0;
+    bool exhausted = false;
+
+    while (j < atMost) {
+      throwIfKilled(); // check if we were aborted
+
+      if (! _traversal->next()) {
+        exhausted = true;
+        break;
+      }
+
+      if (res == nullptr) {
+        res.reset(requestBlock(atMost, nrRegs));
+        // automatically freed if we throw
+        TRI_ASSERT(curRegs <= res->getNrRegs());
+
+        // only copy 1st row of registers inherited from previous frame(s)
+        inheritRegisters(cur, res.get(), _pos);
+      }
+      else {
+        // re-use already copied aqlvalues
+        for (RegisterId i = 0; i < curRegs; i++) {
+          res->setValue(j, i, res->getValueReference(0, i));
+          // Note: if this throws, then all values will be deleted
+          // properly since the first one is.
+        }
+      }
+
+      if (_mustStoreResult) {
+        AqlValue a(new Json(_traversal->current()));
+
+        try {
+          res->setValue(j, static_cast<triagens::aql::RegisterId>(curRegs), a);
+        }
+        catch (...) {
+          a.destroy();
+          throw;
+        }
+      }
+
+      ++j;
+    }
+
+    if (exhausted) {
+      nextRow(cur);
+    }
+
+    if (res == nullptr) {
+      // no (more) paths for this row
+      continue;
+    }
+
+    if (j < atMost) {
+      res->shrink(j);
+    }
+
+    // Clear out registers no longer needed later:
+    clearRegisters(res.get());
+
+    return res.release();
+  }
+}
+
+size_t TraversalBlock::skipSome (size_t atLeast, size_t atMost) {
+  size_t skipped = 0;
+
+  if (_done) {
+    return skipped;
+  }
+
+  while (skipped < atLeast) {
+    if (_buffer.empty()) {
+      size_t toFetch = (std::min)(DefaultBatchSize, atMost);
+      if (! ExecutionBlock::getBlock(toFetch, toFetch)) {
+        _done = true;
+        return skipped;
+      }
+      _pos = 0;           // this is in the first block
+      _traversal.reset();
+    }
+
+    // if we make it here, then _buffer.front() exists
+    AqlItemBlock* cur = _buffer.front();
+
+    if (_traversal == nullptr) {
+      startTraversal(cur);
+    }
+
+    // skipped paths are found, but not converted to JSON
+    while (skipped < atMost) {
+      throwIfKilled(); // check if we were aborted
+
+      if (! _traversal->next()) {
+        nextRow(cur);
+        break;
+      }
+      ++skipped;
+    }
+  }
+
+  return skipped;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, traversal execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_TRAVERSAL_BLOCK_H
+#define ARANGODB_AQL_TRAVERSAL_BLOCK_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/Traversal.h"
+#include "Aql/TraversalNode.h"
+
+namespace triagens {
+  namespace aql {
+
+    class AqlItemBlock;
+    class ExecutionEngine;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class TraversalBlock
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief traversal block
+///
+/// for each input row, the block starts a traversal with the arguments in
+/// the input register and returns one output row per path. the traversal
+/// is kept between calls, so a LIMIT stops it early
+////////////////////////////////////////////////////////////////////////////////
+
+    class TraversalBlock : public ExecutionBlock {
+
+      public:
+
+        TraversalBlock (ExecutionEngine* engine,
+                        TraversalNode const* ep);
+
+        ~TraversalBlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize
+////////////////////////////////////////////////////////////////////////////////
+
+        int initialize () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getSome
+////////////////////////////////////////////////////////////////////////////////
+
+        AqlItemBlock* getSome (size_t atLeast, size_t atMost) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+// skip between atLeast and atMost, returns the number actually skipped . . .
+// will only return less than atLeast if there aren't atLeast many
+// things to skip overall.
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipSome (size_t atLeast, size_t atMost) override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the traversal for the current input row
+////////////////////////////////////////////////////////////////////////////////
+
+        void startTraversal (AqlItemBlock const* cur);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advance to the next input row
+////////////////////////////////////////////////////////////////////////////////
+
+        void nextRow (AqlItemBlock* cur);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the register containing the arguments of the traversal
+////////////////////////////////////////////////////////////////////////////////
+
+        RegisterId _inRegister;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the traversal of the current input row, or nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unique_ptr<Traversal> _traversal;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the paths are used later
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _mustStoreResult;
+
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, traversal node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/TraversalNode.h"
+#include "Aql/Ast.h"
+#include "Aql/ExecutionPlan.h"
+
+using namespace std;
+using namespace triagens::basics;
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          methods of TraversalNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor for TraversalNode from Json
+////////////////////////////////////////////////////////////////////////////////
+
+TraversalNode::TraversalNode (ExecutionPlan* plan,
+                              triagens::basics::Json const& json)
+  : ExecutionNode(plan, json),
+    _inVariable(varFromJson(plan->getAst(), json, "inVariable")),
+    _outVariable(varFromJson(plan->getAst(), json, "outVariable")) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toJson, for TraversalNode
+////////////////////////////////////////////////////////////////////////////////
+
+void TraversalNode::toJsonHelper (triagens::basics::Json& nodes,
+                                  TRI_memory_zone_t* zone,
+                                  bool verbose) const {
+  triagens::basics::Json json(ExecutionNode::toJsonHelperGeneric(nodes, zone, verbose));
+  // call base class method
+
+  if (json.isEmpty()) {
+    return;
+  }
+
+  json("inVariable",  _inVariable->toJson())
+      ("outVariable", _outVariable->toJson());
+
+  // And add it:
+  nodes(json);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+ExecutionNode* TraversalNode::clone (ExecutionPlan* plan,
+                                     bool withDependencies,
+                                     bool withProperties) const {
+  auto inVariable = _inVariable;
+  auto outVariable = _outVariable;
+
+  if (withProperties) {
+    inVariable = plan->getAst()->variables()->createVariable(inVariable);
+    outVariable = plan->getAst()->variables()->createVariable(outVariable);
+  }
+
+  auto c = new TraversalNode(plan, _id, inVariable, outVariable);
+
+  cloneHelper(c, plan, withDependencies, withProperties);
+
+  return static_cast<ExecutionNode*>(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of paths is unknown. we assume the same number of items
+/// as for a FOR loop over an unknown array, but every path is more expensive
+////////////////////////////////////////////////////////////////////////////////
+
+double TraversalNode::estimateCost (size_t& nrItems) const {
+  size_t incoming = 0;
+  double const depCost = _dependencies.at(0)->getCost(incoming);
+
+  nrItems = 100 * incoming;
+  return depCost + 10.0 * static_cast<double>(nrItems);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,181 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, traversal node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_TRAVERSAL_NODE_H
+#define ARANGODB_AQL_TRAVERSAL_NODE_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/types.h"
+#include "Aql/Variable.h"
+#include "Basics/JsonHelper.h"
+
+namespace triagens {
+  namespace aql {
+    class ExecutionBlock;
+    class ExecutionPlan;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class TraversalNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief class TraversalNode
+///
+/// the node runs a native graph traversal for every incoming item and
+/// produces one item per path found. <_inVariable> contains the arguments
+/// of the AQL function TRAVERSE as an array. the node replaces a FOR loop
+/// over TRAVERSE(), so the paths are produced in batches instead of being
+/// collected in one array first
+////////////////////////////////////////////////////////////////////////////////
+
+    class TraversalNode : public ExecutionNode {
+
+      friend class ExecutionBlock;
+      friend class TraversalBlock;
+      friend class RedundantCalculationsReplacer;
+
+      public:
+
+        TraversalNode (ExecutionPlan* plan,
+                       size_t id,
+                       Variable const* inVariable,
+                       Variable const* outVariable)
+          : ExecutionNode(plan, id),
+            _inVariable(inVariable),
+            _outVariable(outVariable) {
+
+          TRI_ASSERT(_inVariable != nullptr);
+          TRI_ASSERT(_outVariable != nullptr);
+        }
+
+        TraversalNode (ExecutionPlan*, triagens::basics::Json const& base);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the type of the node
+////////////////////////////////////////////////////////////////////////////////
+
+        NodeType getType () const override final {
+          return TRAVERSAL;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return in variable
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* inVariable () const {
+          return _inVariable;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return out variable
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* outVariable () const {
+          return _outVariable;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief export to JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        void toJsonHelper (triagens::basics::Json&,
+                           TRI_memory_zone_t*,
+                           bool) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNode* clone (ExecutionPlan* plan,
+                              bool withDependencies,
+                              bool withProperties) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesSetHere
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesSetHere () const override final {
+          return std::vector<Variable const*>{ _outVariable };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, returning a vector
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesUsedHere () const override final {
+          return std::vector<Variable const*>{ _inVariable };
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, modifying the set in-place
+////////////////////////////////////////////////////////////////////////////////
+
+        void getVariablesUsedHere (std::unordered_set<Variable const*>& vars) const override final {
+          vars.emplace(_inVariable);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimateCost
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimateCost (size_t&) const override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input variable, the arguments of the traversal
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* _inVariable;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief output variable
+////////////////////////////////////////////////////////////////////////////////
+
+        Variable const* _outVariable;
+
+    };
+
+  }   // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,439 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, window execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/WindowBlock.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionEngine.h"
+#include "Basics/Exceptions.h"
+
+using namespace std;
+using namespace triagens::arango;
+using namespace triagens::aql;
+
+using Json = triagens::basics::Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class WindowBlock
+// -----------------------------------------------------------------------------
+
+WindowBlock::WindowBlock (ExecutionEngine* engine,
+                          WindowNode const* en)
+  : ExecutionBlock(engine, en),
+    _preceding(en->_preceding),
+    _following(en->_following),
+    _types(),
+    _inRegisters(),
+    _outRegisters(),
+    _states(en->_aggregates.size()),
+    _row(0),
+    _frameStart(0),
+    _frameEnd(0),
+    _enterBlock(0),
+    _enterPos(0),
+    _exhausted(false) {
+
+  auto const& registerPlan = en->getRegisterPlan()->varInfo;
+
+  for (auto const& it : en->_aggregates) {
+    auto itIn = registerPlan.find(it.inVariable->id);
+    TRI_ASSERT(itIn != registerPlan.end());
+    TRI_ASSERT((*itIn).second.registerId < ExecutionNode::MaxRegisterId);
+
+    auto itOut = registerPlan.find(it.outVariable->id);
+    TRI_ASSERT(itOut != registerPlan.end());
+    TRI_ASSERT((*itOut).second.registerId < ExecutionNode::MaxRegisterId);
+
+    _types.emplace_back(it.type);
+    _inRegisters.emplace_back((*itIn).second.registerId);
+    _outRegisters.emplace_back((*itOut).second.registerId);
+  }
+}
+
+WindowBlock::~WindowBlock () {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+int WindowBlock::initializeCursor (AqlItemBlock* items,
+                                   size_t pos) {
+  int res = ExecutionBlock::initializeCursor(items, pos);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  _pos = 0;
+  resetFrame();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+int WindowBlock::getOrSkipSome (size_t atLeast,
+                                size_t atMost,
+                                bool skipping,
+                                AqlItemBlock*& result,
+                                size_t& skipped) {
+  TRI_ASSERT(result == nullptr && skipped == 0);
+
+  if (_done) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::vector<AqlItemBlock*> collector;
+
+  auto freeCollector = [&collector]() {
+    for (auto& x : collector) {
+      delete x;
+    }
+    collector.clear();
+  };
+
+  try {
+    while (skipped < atLeast) {
+      if (_buffer.empty()) {
+        // the next row to return is also the next row to enter the frame
+        TRI_ASSERT(_enterBlock == 0 && _enterPos == 0);
+
+        if (_exhausted ||
+            ! ExecutionBlock::getBlock(DefaultBatchSize, DefaultBatchSize)) {
+          _exhausted = true;
+          _done = true;
+          break;
+        }
+        _pos = 0;
+      }
+
+      AqlItemBlock* cur = _buffer.front();
+      size_t const from = _pos;
+      size_t const to = (std::min)(cur->size(), from + (atMost - skipped));
+
+      while (_pos < to) {
+        computeRow(cur, skipping);
+        ++_pos;
+      }
+
+      skipped += to - from;
+
+      if (to < cur->size()) {
+        if (! skipping) {
+          std::unique_ptr<AqlItemBlock> more(cur->slice(from, to));
+          collector.emplace_back(more.get());
+          more.release();
+        }
+        continue;
+      }
+
+      // all rows of the block have been computed. the rows after them have
+      // entered the frame already, so the block is not needed anymore
+      if (! skipping) {
+        if (from == 0) {
+          // if this throws, cur is not lost, as it is still contained in _buffer
+          collector.emplace_back(cur);
+          cur = nullptr;
+        }
+        else {
+          std::unique_ptr<AqlItemBlock> more(cur->slice(from, to));
+          collector.emplace_back(more.get());
+          more.release();
+        }
+      }
+
+      delete cur;
+      _buffer.pop_front();
+      _pos = 0;
+
+      TRI_ASSERT(_enterBlock > 0);
+      --_enterBlock;
+    }
+  }
+  catch (...) {
+    freeCollector();
+    throw;
+  }
+
+  if (! skipping) {
+    if (collector.size() == 1) {
+      result = collector[0];
+      collector.clear();
+    }
+    else if (! collector.empty()) {
+      try {
+        result = AqlItemBlock::concatenate(collector);
+      }
+      catch (...) {
+        freeCollector();
+        throw;
+      }
+    }
+  }
+
+  freeCollector();
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the frame
+////////////////////////////////////////////////////////////////////////////////
+
+void WindowBlock::resetFrame () {
+  for (auto& it : _states) {
+    it = AggregateState();
+  }
+
+  _row        = 0;
+  _frameStart = 0;
+  _frameEnd   = 0;
+  _enterBlock = 0;
+  _enterPos   = 0;
+  _exhausted  = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the next row enter the frame
+////////////////////////////////////////////////////////////////////////////////
+
+bool WindowBlock::enterRow () {
+  if (_enterBlock == _buffer.size()) {
+    if (_exhausted ||
+        ! ExecutionBlock::getBlock(DefaultBatchSize, DefaultBatchSize)) {
+      _exhausted = true;
+      return false;
+    }
+  }
+
+  TRI_ASSERT(_enterBlock < _buffer.size());
+  AqlItemBlock const* cur = _buffer[_enterBlock];
+
+  // without a preceding bound no row ever leaves the frame, and the values
+  // need not be kept
+  bool const keepValues = (_preceding != WindowNode::Unbounded);
+
+  for (size_t i = 0; i < _types.size(); ++i) {
+    auto const type = _types[i];
+
+    if (type == WindowNode::AGGREGATE_LENGTH) {
+      continue;
+    }
+
+    AqlValue const& value = cur->getValueReference(_enterPos, _inRegisters[i]);
+    double number = std::numeric_limits<double>::quiet_NaN();
+
+    if (value.isNumber()) {
+      bool failed = false;
+      double const d = value.toNumber(failed);
+
+      if (! failed) {
+        number = d;
+      }
+    }
+
+    auto& state = _states[i];
+
+    if (type == WindowNode::AGGREGATE_SUM ||
+        type == WindowNode::AGGREGATE_AVERAGE) {
+      if (! std::isnan(number)) {
+        state.sum += number;
+        ++state.count;
+      }
+      if (keepValues) {
+        state.values.emplace_back(number);
+      }
+      continue;
+    }
+
+    if (std::isnan(number)) {
+      continue;
+    }
+
+    bool const isMin = (type == WindowNode::AGGREGATE_MIN);
+    auto& extremes = state.extremes;
+
+    if (! keepValues && ! extremes.empty()) {
+      // the frame never shrinks, so only the best value is kept
+      double const best = extremes.front().second;
+
+      if (isMin ? (number >= best) : (number <= best)) {
+        continue;
+      }
+    }
+
+    // candidates that are not better than the new value will never be the
+    // result, because they leave the frame before it
+    while (! extremes.empty() &&
+           (isMin ? (extremes.back().second >= number) : (extremes.back().second <= number))) {
+      extremes.pop_back();
+    }
+
+    extremes.emplace_back(_frameEnd, number);
+  }
+
+  ++_frameEnd;
+
+  if (++_enterPos == cur->size()) {
+    ++_enterBlock;
+    _enterPos = 0;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the first row of the frame leave it
+////////////////////////////////////////////////////////////////////////////////
+
+void WindowBlock::leaveRow () {
+  TRI_ASSERT(_frameStart < _frameEnd);
+
+  for (size_t i = 0; i < _types.size(); ++i) {
+    auto& state = _states[i];
+
+    switch (_types[i]) {
+      case WindowNode::AGGREGATE_LENGTH: {
+        break;
+      }
+
+      case WindowNode::AGGREGATE_SUM:
+      case WindowNode::AGGREGATE_AVERAGE: {
+        TRI_ASSERT(! state.values.empty());
+        double const number = state.values.front();
+        state.values.pop_front();
+
+        if (! std::isnan(number)) {
+          if (--state.count == 0) {
+            // do not carry rounding errors into the next values
+            state.sum = 0.0;
+          }
+          else {
+            state.sum -= number;
+          }
+        }
+        break;
+      }
+
+      case WindowNode::AGGREGATE_MIN:
+      case WindowNode::AGGREGATE_MAX: {
+        if (! state.extremes.empty() &&
+            state.extremes.front().first == _frameStart) {
+          state.extremes.pop_front();
+        }
+        break;
+      }
+    }
+  }
+
+  ++_frameStart;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief move the frame to the current row, and write the aggregates
+////////////////////////////////////////////////////////////////////////////////
+
+void WindowBlock::computeRow (AqlItemBlock* cur,
+                              bool skipping) {
+  while (_following == WindowNode::Unbounded ||
+         _frameEnd <= _row + static_cast<uint64_t>(_following)) {
+    if (! enterRow()) {
+      break;
+    }
+  }
+
+  if (_preceding != WindowNode::Unbounded) {
+    while (_frameStart + static_cast<uint64_t>(_preceding) < _row) {
+      leaveRow();
+    }
+  }
+
+  TRI_ASSERT(_frameStart <= _row && _row < _frameEnd);
+  ++_row;
+
+  if (skipping) {
+    return;
+  }
+
+  for (size_t i = 0; i < _types.size(); ++i) {
+    auto const& state = _states[i];
+    std::unique_ptr<Json> json;
+
+    switch (_types[i]) {
+      case WindowNode::AGGREGATE_LENGTH: {
+        json.reset(new Json(static_cast<double>(_frameEnd - _frameStart)));
+        break;
+      }
+
+      case WindowNode::AGGREGATE_SUM: {
+        json.reset(new Json(state.sum));
+        break;
+      }
+
+      case WindowNode::AGGREGATE_AVERAGE: {
+        if (state.count == 0) {
+          json.reset(new Json(Json::Null));
+        }
+        else {
+          json.reset(new Json(state.sum / static_cast<double>(state.count)));
+        }
+        break;
+      }
+
+      case WindowNode::AGGREGATE_MIN:
+      case WindowNode::AGGREGATE_MAX: {
+        if (state.extremes.empty()) {
+          json.reset(new Json(Json::Null));
+        }
+        else {
+          json.reset(new Json(state.extremes.front().second));
+        }
+        break;
+      }
+    }
+
+    AqlValue a(json.get());
+    json.release();
+
+    try {
+      cur->setValue(_pos, _outRegisters[i], a);
+    }
+    catch (...) {
+      a.destroy();
+      throw;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
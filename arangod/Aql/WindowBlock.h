@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, window execution block
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_WINDOW_BLOCK_H
+#define ARANGODB_AQL_WINDOW_BLOCK_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/WindowNode.h"
+
+namespace triagens {
+  namespace aql {
+
+    class AqlItemBlock;
+    class ExecutionEngine;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class WindowBlock
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief window block
+///
+/// the block computes the aggregates of all rows in one pass. a row enters
+/// the frame when the first row whose frame contains it is computed, and
+/// leaves it when the first row whose frame does not contain it is computed.
+/// sums and counts are updated by the entering and leaving values, minimum
+/// and maximum are kept in a queue of candidates that are better than all
+/// values after them. so only the values of the frame and the input blocks
+/// of the rows that wait for their following rows are kept in memory. the
+/// aggregates are written into the input rows, which are passed on
+////////////////////////////////////////////////////////////////////////////////
+
+    class WindowBlock : public ExecutionBlock {
+
+      public:
+
+        WindowBlock (ExecutionEngine* engine,
+                     WindowNode const* ep);
+
+        ~WindowBlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializeCursor
+////////////////////////////////////////////////////////////////////////////////
+
+        int initializeCursor (AqlItemBlock* items, size_t pos) override;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+        int getOrSkipSome (size_t atLeast,
+                           size_t atMost,
+                           bool skipping,
+                           AqlItemBlock*& result,
+                           size_t& skipped) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the state of an aggregate for the current frame
+////////////////////////////////////////////////////////////////////////////////
+
+        struct AggregateState {
+          AggregateState ()
+            : sum(0.0), count(0), values(), extremes() {
+          }
+
+          double sum;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of numeric values in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t count;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the values of the rows in the frame, NaN for values that are not
+/// numbers. only kept for SUM and AVERAGE, and only if rows leave the frame
+////////////////////////////////////////////////////////////////////////////////
+
+          std::deque<double> values;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the candidates for MIN and MAX, as row numbers and values. the
+/// front is the result
+////////////////////////////////////////////////////////////////////////////////
+
+          std::deque<std::pair<uint64_t, double>> extremes;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reset the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void resetFrame ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the next row enter the frame, reading a new input block if
+/// required. returns false if there are no more rows
+////////////////////////////////////////////////////////////////////////////////
+
+        bool enterRow ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief let the first row of the frame leave it
+////////////////////////////////////////////////////////////////////////////////
+
+        void leaveRow ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief move the frame to the current row, and write the aggregates into
+/// it unless skipping
+////////////////////////////////////////////////////////////////////////////////
+
+        void computeRow (AqlItemBlock*,
+                         bool);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        int64_t const _preceding;
+
+        int64_t const _following;
+
+        std::vector<WindowNode::AggregateType> _types;
+
+        std::vector<RegisterId> _inRegisters;
+
+        std::vector<RegisterId> _outRegisters;
+
+        std::vector<AggregateState> _states;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of the current row, i.e. the next row to be returned
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _row;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of the first row in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _frameStart;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of the row after the last row in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _frameEnd;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of the next row to enter the frame, as the index of the
+/// block in _buffer and the position in the block
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _enterBlock;
+
+        size_t _enterPos;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not all input has been read
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _exhausted;
+
+    };
+
+  }  // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, window node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Aql/WindowNode.h"
+#include "Aql/Ast.h"
+#include "Aql/ExecutionPlan.h"
+#include "Basics/Exceptions.h"
+
+using namespace std;
+using namespace triagens::basics;
+using namespace triagens::aql;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             methods of WindowNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the value of a frame bound that extends to the end of the input
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t const WindowNode::Unbounded = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor for WindowNode from Json
+////////////////////////////////////////////////////////////////////////////////
+
+WindowNode::WindowNode (ExecutionPlan* plan,
+                        triagens::basics::Json const& json)
+  : ExecutionNode(plan, json),
+    _preceding(JsonHelper::checkAndGetNumericValue<int64_t>(json.json(), "preceding")),
+    _following(JsonHelper::checkAndGetNumericValue<int64_t>(json.json(), "following")),
+    _aggregates() {
+
+  triagens::basics::Json jsonAggregates = json.get("aggregates");
+
+  if (! jsonAggregates.isArray()) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid aggregates for WindowNode");
+  }
+
+  size_t const n = jsonAggregates.size();
+  _aggregates.reserve(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    triagens::basics::Json oneJsonAggregate = jsonAggregates.at(static_cast<int>(i));
+
+    Aggregate aggregate;
+    aggregate.outVariable = varFromJson(plan->getAst(), oneJsonAggregate, "outVariable");
+    aggregate.inVariable  = varFromJson(plan->getAst(), oneJsonAggregate, "inVariable");
+
+    if (! aggregateType(JsonHelper::checkAndGetStringValue(oneJsonAggregate.json(), "type"), aggregate.type)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "invalid aggregate type for WindowNode");
+    }
+
+    _aggregates.emplace_back(aggregate);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the name of an aggregate function
+////////////////////////////////////////////////////////////////////////////////
+
+bool WindowNode::aggregateType (std::string const& name,
+                                AggregateType& type) {
+  if (name == "LENGTH") {
+    type = AGGREGATE_LENGTH;
+  }
+  else if (name == "SUM") {
+    type = AGGREGATE_SUM;
+  }
+  else if (name == "AVERAGE") {
+    type = AGGREGATE_AVERAGE;
+  }
+  else if (name == "MIN") {
+    type = AGGREGATE_MIN;
+  }
+  else if (name == "MAX") {
+    type = AGGREGATE_MAX;
+  }
+  else {
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name of an aggregate function
+////////////////////////////////////////////////////////////////////////////////
+
+char const* WindowNode::aggregateName (AggregateType type) {
+  switch (type) {
+    case AGGREGATE_LENGTH:
+      return "LENGTH";
+    case AGGREGATE_SUM:
+      return "SUM";
+    case AGGREGATE_AVERAGE:
+      return "AVERAGE";
+    case AGGREGATE_MIN:
+      return "MIN";
+    case AGGREGATE_MAX:
+      return "MAX";
+  }
+
+  TRI_ASSERT(false);
+  return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief toJson, for WindowNode
+////////////////////////////////////////////////////////////////////////////////
+
+void WindowNode::toJsonHelper (triagens::basics::Json& nodes,
+                               TRI_memory_zone_t* zone,
+                               bool verbose) const {
+  triagens::basics::Json json(ExecutionNode::toJsonHelperGeneric(nodes, zone, verbose));
+  // call base class method
+
+  if (json.isEmpty()) {
+    return;
+  }
+
+  triagens::basics::Json aggregates(triagens::basics::Json::Array, _aggregates.size());
+
+  for (auto const& it : _aggregates) {
+    triagens::basics::Json aggregate(triagens::basics::Json::Object);
+    aggregate("outVariable", it.outVariable->toJson())
+             ("inVariable",  it.inVariable->toJson())
+             ("type",        triagens::basics::Json(aggregateName(it.type)));
+    aggregates(aggregate);
+  }
+
+  json("preceding",  triagens::basics::Json(static_cast<double>(_preceding)))
+      ("following",  triagens::basics::Json(static_cast<double>(_following)))
+      ("aggregates", aggregates);
+
+  // And add it:
+  nodes(json);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+ExecutionNode* WindowNode::clone (ExecutionPlan* plan,
+                                  bool withDependencies,
+                                  bool withProperties) const {
+  auto aggregates = _aggregates;
+
+  if (withProperties) {
+    for (auto& it : aggregates) {
+      it.outVariable = plan->getAst()->variables()->createVariable(it.outVariable);
+      it.inVariable  = plan->getAst()->variables()->createVariable(it.inVariable);
+    }
+  }
+
+  auto c = new WindowNode(plan, _id, _preceding, _following, aggregates);
+
+  cloneHelper(c, plan, withDependencies, withProperties);
+
+  return static_cast<ExecutionNode*>(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesSetHere
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Variable const*> WindowNode::getVariablesSetHere () const {
+  std::vector<Variable const*> v;
+  v.reserve(_aggregates.size());
+
+  for (auto const& it : _aggregates) {
+    v.emplace_back(it.outVariable);
+  }
+  return v;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, returning a vector
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Variable const*> WindowNode::getVariablesUsedHere () const {
+  std::unordered_set<Variable const*> vars;
+  getVariablesUsedHere(vars);
+
+  return std::vector<Variable const*>(vars.begin(), vars.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, modifying the set in-place
+////////////////////////////////////////////////////////////////////////////////
+
+void WindowNode::getVariablesUsedHere (std::unordered_set<Variable const*>& vars) const {
+  for (auto const& it : _aggregates) {
+    vars.emplace(it.inVariable);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cost of a window node is one update of the frame per incoming
+/// item. the number of items does not change
+////////////////////////////////////////////////////////////////////////////////
+
+double WindowNode::estimateCost (size_t& nrItems) const {
+  size_t incoming = 0;
+  double const dependencyCost = _dependencies.at(0)->getCost(incoming);
+
+  nrItems = incoming;
+  return dependencyCost + static_cast<double>(incoming);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Aql, window node
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_AQL_WINDOW_NODE_H
+#define ARANGODB_AQL_WINDOW_NODE_H 1
+
+#include "Basics/Common.h"
+#include "Aql/ExecutionNode.h"
+#include "Aql/types.h"
+#include "Aql/Variable.h"
+#include "Basics/JsonHelper.h"
+
+namespace triagens {
+  namespace aql {
+    class ExecutionBlock;
+    class ExecutionPlan;
+    class RedundantCalculationsReplacer;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  class WindowNode
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief class WindowNode
+///
+/// the node computes aggregates over a frame of neighboring rows, in the
+/// order in which the rows arrive, and adds them to each row:
+///
+///     FOR doc IN collection
+///       SORT doc.time
+///       WINDOW { preceding: 2, following: 0 }
+///         AGGREGATE moving = AVERAGE(doc.value), running = SUM(doc.value)
+///       RETURN { time: doc.time, moving, running }
+///
+/// the frame of a row consists of up to <_preceding> rows before it, the
+/// row itself and up to <_following> rows after it. a bound of Unbounded
+/// extends the frame to the start or the end of the input, so
+/// { preceding: "unbounded", following: 0 } computes cumulative aggregates.
+/// the node does not change the number or the order of rows
+////////////////////////////////////////////////////////////////////////////////
+
+    class WindowNode : public ExecutionNode {
+
+      friend class ExecutionBlock;
+      friend class WindowBlock;
+      friend class RedundantCalculationsReplacer;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aggregate functions. SUM, AVERAGE, MIN and MAX consider numeric
+/// values only, LENGTH counts the rows of the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        enum AggregateType {
+          AGGREGATE_LENGTH,
+          AGGREGATE_SUM,
+          AGGREGATE_AVERAGE,
+          AGGREGATE_MIN,
+          AGGREGATE_MAX
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an aggregate, computed from the values of <inVariable> in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Aggregate {
+          Variable const* outVariable;
+          Variable const* inVariable;
+          AggregateType type;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the value of a frame bound that extends to the end of the input
+////////////////////////////////////////////////////////////////////////////////
+
+        static int64_t const Unbounded;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        WindowNode (ExecutionPlan* plan,
+                    size_t id,
+                    int64_t preceding,
+                    int64_t following,
+                    std::vector<Aggregate> const& aggregates)
+          : ExecutionNode(plan, id),
+            _preceding(preceding),
+            _following(following),
+            _aggregates(aggregates) {
+
+          TRI_ASSERT(_preceding >= 0 || _preceding == Unbounded);
+          TRI_ASSERT(_following >= 0 || _following == Unbounded);
+          TRI_ASSERT(! _aggregates.empty());
+        }
+
+        WindowNode (ExecutionPlan*, triagens::basics::Json const& base);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the type of the node
+////////////////////////////////////////////////////////////////////////////////
+
+        NodeType getType () const override final {
+          return WINDOW;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses the name of an aggregate function, returns false if the
+/// function cannot be used in a window
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool aggregateType (std::string const&,
+                                   AggregateType&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name of an aggregate function
+////////////////////////////////////////////////////////////////////////////////
+
+        static char const* aggregateName (AggregateType);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of rows before the current row in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t preceding () const {
+          return _preceding;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of rows after the current row in the frame
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t following () const {
+          return _following;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the aggregates
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Aggregate> const& aggregates () const {
+          return _aggregates;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief export to JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        void toJsonHelper (triagens::basics::Json&,
+                           TRI_memory_zone_t*,
+                           bool) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clone ExecutionNode recursively
+////////////////////////////////////////////////////////////////////////////////
+
+        ExecutionNode* clone (ExecutionPlan* plan,
+                              bool withDependencies,
+                              bool withProperties) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesSetHere
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesSetHere () const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, returning a vector
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Variable const*> getVariablesUsedHere () const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief getVariablesUsedHere, modifying the set in-place
+////////////////////////////////////////////////////////////////////////////////
+
+        void getVariablesUsedHere (std::unordered_set<Variable const*>&) const override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimateCost
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimateCost (size_t&) const override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows before the current row in the frame, or Unbounded
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t const _preceding;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of rows after the current row in the frame, or Unbounded
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t const _following;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the aggregates
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Aggregate> _aggregates;
+
+    };
+
+  }   // namespace triagens::aql
+}  // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -496,16 +496,16 @@ union yyalloc
 /* YYFINAL -- State number of the termination state.  */
 #define YYFINAL  3
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   820
+#define YYLAST   805
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  63
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  76
+#define YYNNTS  78
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  164
+#define YYNRULES  167
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  278
+#define YYNSTATES  284
 
 /* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
    by yylex, with out-of-bounds checking.  */
@@ -559,21 +559,21 @@ static const yytype_uint16 yyrline[] =
 {
        0,   205,   205,   207,   209,   211,   213,   215,   220,   222,
      227,   231,   237,   239,   244,   246,   248,   250,   252,   254,
-     259,   268,   276,   281,   283,   288,   295,   305,   305,   319,
-     335,   362,   389,   421,   451,   453,   458,   465,   469,   476,
-     490,   507,   507,   521,   521,   532,   535,   541,   547,   550,
-     553,   556,   562,   567,   574,   582,   585,   591,   601,   611,
-     619,   630,   635,   643,   654,   659,   662,   668,   668,   719,
-     719,   729,   735,   738,   741,   744,   747,   750,   756,   759,
-     775,   775,   787,   790,   793,   799,   802,   805,   808,   811,
-     814,   817,   820,   823,   826,   829,   832,   835,   838,   841,
-     847,   853,   855,   860,   863,   863,   882,   885,   891,   894,
-     900,   900,   909,   911,   916,   919,   925,   928,   942,   942,
-     951,   953,   958,   960,   965,   979,   983,   992,   999,  1002,
-    1008,  1011,  1017,  1020,  1023,  1029,  1032,  1038,  1070,  1073,
-    1076,  1083,  1093,  1093,  1109,  1124,  1138,  1152,  1152,  1195,
-    1198,  1204,  1211,  1221,  1224,  1227,  1230,  1233,  1239,  1242,
-    1245,  1255,  1261,  1264,  1269
+     256,   261,   270,   278,   283,   285,   290,   297,   307,   307,
+     321,   337,   364,   391,   423,   453,   455,   460,   467,   471,
+     478,   492,   509,   509,   523,   523,   534,   537,   543,   549,
+     552,   555,   558,   564,   569,   576,   576,   600,   608,   611,
+     617,   627,   637,   645,   656,   661,   669,   680,   685,   688,
+     694,   694,   745,   745,   755,   761,   764,   767,   770,   773,
+     776,   782,   785,   801,   801,   813,   816,   819,   825,   828,
+     831,   834,   837,   840,   843,   846,   849,   852,   855,   858,
+     861,   864,   867,   873,   879,   881,   886,   889,   889,   908,
+     911,   917,   920,   926,   926,   935,   937,   942,   945,   951,
+     954,   968,   968,   977,   979,   984,   986,   991,  1005,  1009,
+    1018,  1025,  1028,  1034,  1037,  1043,  1046,  1049,  1055,  1058,
+    1064,  1096,  1099,  1102,  1109,  1119,  1119,  1135,  1150,  1164,
+    1178,  1178,  1221,  1224,  1230,  1237,  1247,  1250,  1253,  1256,
+    1259,  1265,  1268,  1271,  1281,  1287,  1290,  1295
 };
 #endif
 
@@ -605,21 +605,22 @@ static const char *const yytname[] =
   "let_element", "count_into", "collect_variable_list", "$@1",
   "collect_statement", "collect_list", "collect_element", "optional_into",
   "variable_list", "keep", "$@2", "sort_statement", "$@3", "sort_list",
-  "sort_element", "sort_direction", "limit_statement", "return_statement",
-  "in_or_into_collection", "remove_statement", "insert_statement",
-  "update_parameters", "update_statement", "replace_parameters",
-  "replace_statement", "update_or_replace", "upsert_statement", "$@4",
-  "distinct_expression", "$@5", "expression", "function_name",
-  "function_call", "$@6", "operator_unary", "operator_binary",
-  "operator_ternary", "optional_function_call_arguments",
-  "expression_or_query", "$@7", "function_arguments_list",
-  "compound_value", "array", "$@8", "optional_array_elements",
-  "array_elements_list", "options", "object", "$@9",
-  "optional_object_elements", "object_elements_list", "object_element",
-  "array_filter_operator", "optional_array_filter", "optional_array_limit",
-  "optional_array_return", "reference", "$@10", "$@11", "simple_value",
-  "numeric_value", "value_literal", "collection_name", "bind_parameter",
-  "object_element_name", "variable_name", YY_NULLPTR
+  "sort_element", "sort_direction", "limit_statement", "window_statement",
+  "$@4", "return_statement", "in_or_into_collection", "remove_statement",
+  "insert_statement", "update_parameters", "update_statement",
+  "replace_parameters", "replace_statement", "update_or_replace",
+  "upsert_statement", "$@5", "distinct_expression", "$@6", "expression",
+  "function_name", "function_call", "$@7", "operator_unary",
+  "operator_binary", "operator_ternary",
+  "optional_function_call_arguments", "expression_or_query", "$@8",
+  "function_arguments_list", "compound_value", "array", "$@9",
+  "optional_array_elements", "array_elements_list", "options", "object",
+  "$@10", "optional_object_elements", "object_elements_list",
+  "object_element", "array_filter_operator", "optional_array_filter",
+  "optional_array_limit", "optional_array_return", "reference", "$@11",
+  "$@12", "simple_value", "numeric_value", "value_literal",
+  "collection_name", "bind_parameter", "object_element_name",
+  "variable_name", YY_NULLPTR
 };
 #endif
 
@@ -638,12 +639,12 @@ static const yytype_uint16 yytoknum[] =
 };
 # endif
 
-#define YYPACT_NINF -118
+#define YYPACT_NINF -94
 
 #define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-118)))
+  (!!((Yystate) == (-94)))
 
-#define YYTABLE_NINF -163
+#define YYTABLE_NINF -166
 
 #define yytable_value_is_error(Yytable_value) \
   0
@@ -652,34 +653,35 @@ static const yytype_uint16 yytoknum[] =
      STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-    -118,    10,   709,  -118,   -12,   -12,   747,   268,    15,  -118,
-     278,   747,   747,   747,   747,  -118,  -118,  -118,  -118,  -118,
-      47,  -118,  -118,  -118,  -118,    37,    37,    37,    37,    37,
-    -118,    11,   -14,  -118,    13,  -118,  -118,  -118,   -29,  -118,
-    -118,  -118,  -118,   747,   747,   747,   747,  -118,  -118,   607,
-       5,  -118,  -118,  -118,  -118,  -118,  -118,  -118,   -31,  -118,
-    -118,  -118,  -118,  -118,   607,    38,    44,   -12,   747,    25,
-    -118,  -118,   474,   474,  -118,   371,  -118,   407,   747,   -12,
-      44,    51,    48,  -118,  -118,  -118,  -118,  -118,   747,   -12,
-     747,    58,    58,    58,   238,  -118,    -9,   747,   747,    78,
-     747,   747,   747,   747,   747,   747,   747,   747,   747,   747,
-     747,   747,   747,   747,   747,    69,    60,   681,    59,   747,
-      96,    63,  -118,    64,  -118,    86,    70,  -118,   301,   278,
-     767,    61,    44,    44,   747,    44,   747,    44,   507,    91,
-    -118,    63,    44,  -118,  -118,  -118,   607,  -118,   607,  -118,
-      73,    80,  -118,    82,   747,    77,    83,  -118,    89,   607,
-      84,    94,   157,   747,   654,   622,   387,   387,    16,    16,
-      16,    16,     6,     6,    58,    58,    58,   540,   111,  -118,
-     714,  -118,   128,    98,  -118,  -118,   607,   -12,  -118,   -12,
-     747,   747,  -118,  -118,  -118,  -118,  -118,    21,    26,    29,
-    -118,  -118,  -118,  -118,  -118,  -118,  -118,   474,  -118,   474,
-    -118,   747,   747,   -12,  -118,  -118,   747,   195,  -118,    -9,
-     747,  -118,   747,   157,   747,   607,    97,  -118,  -118,   101,
-    -118,  -118,   139,  -118,  -118,   607,  -118,    44,    44,   440,
-     574,   107,  -118,   607,   135,  -118,   607,   607,   607,  -118,
-    -118,   747,   747,   137,  -118,  -118,  -118,  -118,   747,  -118,
-     -12,   747,  -118,   607,   747,   167,   474,  -118,   607,   334,
-     747,   102,    44,   747,   607,  -118,  -118,   607
+     -94,    10,   694,   -94,   -12,   -12,   732,   131,    11,   -94,
+     278,   732,   732,   732,   732,   -94,   -94,   -94,   -94,   -94,
+      22,   -94,    39,   -94,   -94,    43,    43,    43,    43,    43,
+     -94,    18,    16,   -94,    42,   -94,   -94,   -94,     9,   -94,
+     -94,   -94,   -94,   732,   732,   732,   732,   -94,   -94,   624,
+      41,   -94,   -94,   -94,   -94,   -94,   -94,   -94,   -33,   -94,
+     -94,   -94,   -94,   -94,   624,    50,    61,   -12,   732,    25,
+     -94,   -94,   491,   491,   -94,   388,   -94,   424,   732,   -12,
+      61,    71,    60,   -94,    56,   -94,   -94,   -94,   -94,   -94,
+     732,   -12,   732,    82,    82,    82,   277,   -94,    -7,   732,
+     732,   102,   732,   732,   732,   732,   732,   732,   732,   732,
+     732,   732,   732,   732,   732,   732,   732,    93,    69,   666,
+      -2,   732,   105,    60,   -94,    72,   -94,    92,    74,   -94,
+     318,   278,   752,    20,    61,    61,   732,    61,   732,    61,
+     524,    94,   -94,    60,    61,   -94,   101,   -94,   -94,   624,
+     -94,   624,   -94,    77,    86,   -94,    88,   732,    91,    90,
+     -94,   100,   624,    95,    96,   472,   732,   639,   155,   404,
+     404,   295,   295,   295,   295,    99,    99,    82,    82,    82,
+     557,    49,   -94,   699,   -94,   200,   106,   -94,   -94,   624,
+     -12,   -94,   -12,   732,   732,   -94,   -94,   -94,   -94,   -94,
+      19,    27,    28,   -94,   -94,   -94,   -94,   -94,   -94,   -94,
+     491,   -94,   491,   -94,   732,   732,   -12,   -94,   -94,   -94,
+     732,   244,   -94,    -7,   732,   -94,   732,   472,   732,   624,
+     112,   -94,   -94,   117,   -94,   -94,   163,   -94,   -94,   624,
+     -94,    61,    61,   457,   591,   121,   -94,   -12,   624,   127,
+     -94,   624,   624,   624,   -94,   -94,   732,   732,   164,   -94,
+     -94,   -94,   -94,   732,   -94,   -12,    72,   732,   -94,   624,
+     732,   168,   491,   -94,   624,   351,   732,   122,    61,   732,
+     624,   -94,   -94,   624
 };
 
   /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -687,60 +689,61 @@ static const yytype_int16 yypact[] =
      means the default is an error.  */
 static const yytype_uint8 yydefact[] =
 {
-      12,     0,     0,     1,     0,     0,     0,     0,    27,    43,
-       0,     0,     0,     0,     0,    67,    13,    14,    16,    15,
-      37,    17,    18,    19,     2,    10,    10,    10,    10,    10,
-     164,     0,    22,    23,     0,   155,   156,   157,   137,   153,
-     151,   152,   161,     0,     0,     0,   142,   118,   110,    21,
-      80,   140,    72,    73,    74,   138,   108,   109,    76,   154,
-      75,   139,    69,    54,    71,     0,   116,     0,     0,    52,
-     149,   150,     0,     0,    61,     0,    64,     0,     0,     0,
-     116,   116,     0,     3,     4,     5,     6,     7,     0,     0,
-       0,    84,    82,    83,     0,    12,   120,   112,     0,     0,
+      12,     0,     0,     1,     0,     0,     0,     0,    28,    44,
+       0,     0,     0,     0,     0,    70,    13,    14,    16,    15,
+      38,    17,    18,    20,     2,    10,    10,    10,    10,    10,
+     167,     0,    23,    24,     0,   158,   159,   160,   140,   156,
+     154,   155,   164,     0,     0,     0,   145,   121,   113,    22,
+      83,   143,    75,    76,    77,   141,   111,   112,    79,   157,
+      78,   142,    72,    57,    74,     0,   119,     0,     0,    53,
+     152,   153,     0,     0,    64,     0,    67,     0,     0,     0,
+     119,   119,     0,    19,     0,     3,     4,     5,     6,     7,
+       0,     0,     0,    87,    85,    86,     0,    12,   123,   115,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,    29,    28,    34,     0,    44,    45,    48,     0,
-       0,     0,   116,   116,     0,   116,     0,   116,     0,    38,
-      30,    41,   116,    31,     9,    11,    20,    24,    25,   141,
-       0,   124,   163,     0,     0,     0,   121,   122,     0,   114,
-       0,   113,    98,     0,    86,    85,    92,    93,    94,    95,
-      96,    97,    87,    88,    89,    90,    91,     0,    77,    79,
-     104,   128,     0,   147,   144,   145,    70,     0,   117,     0,
-       0,     0,    49,    50,    47,    51,    53,   137,   153,   161,
-      55,   158,   159,   160,    56,    57,    58,     0,    59,     0,
-      62,     0,     0,     0,    32,   143,     0,     0,   119,     0,
-       0,   111,     0,    99,     0,   103,     0,   106,    12,   102,
-     146,   129,   130,    26,    35,    36,    46,   116,   116,     0,
-     116,    42,    39,   126,     0,   123,   125,   115,   100,    81,
-     105,   104,     0,   132,    60,    63,    65,    66,     0,    33,
-       0,     0,   107,   131,     0,   135,     0,    40,   127,   133,
-       0,     0,   116,     0,   136,   148,    68,   134
+       0,     0,     0,     0,    30,    29,    35,     0,    45,    46,
+      49,     0,     0,     0,   119,   119,     0,   119,     0,   119,
+       0,    39,    31,    42,   119,    32,     0,     9,    11,    21,
+      25,    26,   144,     0,   127,   166,     0,     0,     0,   124,
+     125,     0,   117,     0,   116,   101,     0,    89,    88,    95,
+      96,    97,    98,    99,   100,    90,    91,    92,    93,    94,
+       0,    80,    82,   107,   131,     0,   150,   147,   148,    73,
+       0,   120,     0,     0,     0,    50,    51,    48,    52,    54,
+     140,   156,   164,    58,   161,   162,   163,    59,    60,    61,
+       0,    62,     0,    65,     0,     0,     0,    33,    55,   146,
+       0,     0,   122,     0,     0,   114,     0,   102,     0,   106,
+       0,   109,    12,   105,   149,   132,   133,    27,    36,    37,
+      47,   119,   119,     0,   119,    43,    40,     0,   129,     0,
+     126,   128,   118,   103,    84,   108,   107,     0,   135,    63,
+      66,    68,    69,     0,    34,     0,    56,     0,   110,   134,
+       0,   138,     0,    41,   130,   136,     0,     0,   119,     0,
+     139,   151,    71,   137
 };
 
   /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -118,   -93,  -118,   150,  -118,  -118,  -118,  -118,    99,  -118,
-     100,   163,  -118,  -118,  -118,  -118,    -4,  -118,  -118,  -118,
-    -118,  -118,  -118,  -118,     0,  -118,  -118,   108,   -64,  -118,
-    -118,  -118,  -118,  -118,  -118,  -118,  -118,  -118,  -118,  -118,
-      -6,  -118,  -118,  -118,  -118,  -118,  -118,  -118,   -50,  -118,
-    -118,  -118,  -118,  -118,  -118,  -118,   -16,  -117,  -118,  -118,
-    -118,   -11,  -118,  -118,  -118,  -118,  -118,  -118,  -118,   -48,
-    -118,     8,    72,     4,  -118,    -1
+     -94,   -93,   -94,    54,   -94,   -94,   -94,   -94,    97,   -94,
+      84,   158,   -94,   -94,   -94,   -68,    -9,   -94,   -94,   -94,
+     -94,   -94,   -94,   -94,     5,   -94,   -94,   -94,   -94,   119,
+     -62,   -94,   -94,   -94,   -94,   -94,   -94,   -94,   -94,   -94,
+     -94,   -94,    -6,   -94,   -94,   -94,   -94,   -94,   -94,   -94,
+     -55,   -94,   -94,   -94,   -94,   -94,   -94,   -94,   -78,   -73,
+     -94,   -94,   -94,   -19,   -94,   -94,   -94,   -94,   -94,   -94,
+     -94,   -77,   -94,     6,    73,     4,   -94,    37
 };
 
   /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int16 yydefgoto[] =
 {
-      -1,     1,    82,    83,     2,    16,    17,    18,    19,    32,
-      33,    66,    20,    67,    21,   123,   124,    81,   241,   142,
-     213,    22,    68,   126,   127,   194,    23,    24,   132,    25,
-      26,    74,    27,    76,    28,   258,    29,    78,    63,   119,
-     128,    50,    51,   116,    52,    53,    54,   226,   227,   228,
-     229,    55,    56,    97,   160,   161,   122,    57,    96,   155,
-     156,   157,   183,   253,   265,   271,    58,    95,   232,    69,
-      59,    60,   200,    61,   158,    34
+      -1,     1,    84,    85,     2,    16,    17,    18,    19,    32,
+      33,    66,    20,    67,    21,   125,   126,    81,   245,   144,
+     216,    22,    68,   128,   129,   197,    23,    83,   247,    24,
+     134,    25,    26,    74,    27,    76,    28,   263,    29,    78,
+      63,   121,   130,    50,    51,   118,    52,    53,    54,   230,
+     231,   232,   233,    55,    56,    99,   163,   164,   124,    57,
+      98,   158,   159,   160,   186,   258,   271,   277,    58,    97,
+     236,    69,    59,    60,   203,    61,   161,   127
 };
 
   /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -748,176 +751,172 @@ static const yytype_int16 yydefgoto[] =
      number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      49,    64,   150,    31,   188,    72,    73,    75,    77,   133,
-       3,   135,    30,   137,    71,   151,   152,   -78,    70,   153,
-     -78,  -158,   117,    88,   188,  -158,  -159,  -158,    65,  -160,
-    -159,   118,  -159,  -160,    89,  -160,    99,    91,    92,    93,
-      94,    -8,    90,    -8,   154,  -158,    99,   110,   111,   112,
-    -159,   115,     5,  -160,     7,   108,   109,   110,   111,   112,
-      65,    79,   120,   114,   140,   143,   125,   -78,   121,  -158,
-     -78,  -158,   138,   129,  -159,   141,  -159,  -160,   139,  -160,
-     195,   196,   146,   184,   148,   201,   202,    42,    99,   203,
-     163,   159,   162,   179,   164,   165,   166,   167,   168,   169,
-     170,   171,   172,   173,   174,   175,   176,   177,   178,   180,
-     187,   182,   189,   186,    47,   190,   205,   206,   191,   208,
-     212,   210,   185,   215,   162,  -162,   214,   216,   207,   218,
-     209,   219,    71,    71,   220,   250,    70,    70,   221,   231,
-      98,    99,   222,   237,   252,   238,   264,   249,   217,   251,
-     108,   109,   110,   111,   112,   260,   275,   223,    99,   100,
+      49,    64,   142,   145,   153,    72,    73,    75,    77,   146,
+       3,   135,    30,   137,    71,   139,    70,   154,   155,  -161,
+     119,   156,   187,  -161,    65,  -161,    42,  -162,  -163,   120,
+      90,  -162,  -163,  -162,  -163,    65,    79,    93,    94,    95,
+      96,    31,    34,  -161,   204,   205,   157,    -8,   206,    -8,
+     191,  -162,  -163,   198,   199,   -81,   208,   209,   -81,   211,
+       5,   213,     7,    82,    91,   -81,   217,  -161,   -81,  -161,
+     191,    92,   140,   131,   122,  -162,  -163,  -162,  -163,   101,
+      86,    87,    88,    89,   149,   123,   151,   117,   110,   111,
+     112,   113,   114,   162,   165,   143,   167,   168,   169,   170,
+     171,   172,   173,   174,   175,   176,   177,   178,   179,   180,
+     181,    47,   101,   185,   166,   189,   141,   182,   183,   190,
+     192,   193,   194,   215,   188,   218,   165,   219,    34,   101,
+     210,  -165,   212,   220,    71,    71,    70,    70,   223,   255,
+     112,   113,   114,   222,   226,   224,    62,   235,   241,   225,
+     242,   221,    35,    36,    37,    38,    39,    40,    41,    42,
+     227,    43,   254,   259,   260,   256,   264,   100,   257,   265,
+      44,    45,   267,   270,   276,   150,   281,   229,    80,   266,
+      46,   147,    47,   238,    48,   101,   102,   239,   104,   105,
+     106,   107,   108,   109,   110,   111,   112,   113,   114,   240,
+     282,   268,   116,   148,   250,     0,   207,     0,   243,   244,
+     278,     0,   100,     0,   248,     0,     0,     0,   251,     0,
+     252,     0,   253,     0,     0,     0,     0,   237,     0,     0,
      101,   102,   103,   104,   105,   106,   107,   108,   109,   110,
-     111,   112,   113,   270,   225,   114,    84,    85,    86,    87,
-     261,   144,   230,    80,   235,   234,   233,    99,   125,   147,
-     145,   236,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,   262,   272,   204,   114,   239,   240,    98,   245,     0,
-     243,     0,   242,     0,   246,     0,   247,     0,   248,     0,
-       0,   254,   255,     0,   259,    99,   100,   101,   102,   103,
+     111,   112,   113,   114,   115,     0,     0,   116,     0,     0,
+     229,   269,     0,   246,   234,     0,   100,   272,     0,     0,
+       0,   274,     0,     0,   275,     0,     0,     0,     0,     0,
+     280,     0,     0,   283,   101,   102,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   115,   100,
+       0,   116,     0,     0,     0,     0,     0,     0,   249,    35,
+      36,    37,   273,    39,    40,    41,    42,   101,   102,   103,
      104,   105,   106,   107,   108,   109,   110,   111,   112,   113,
-       0,     0,   114,     0,     0,   225,   263,     0,     0,   244,
-      98,     0,   266,     0,     0,   268,   276,     0,   269,   267,
-       0,     0,     0,     0,   274,     0,     0,   277,    99,   100,
-     101,   102,   103,   104,   105,   106,   107,   108,   109,   110,
-     111,   112,   113,    62,     0,   114,     0,     0,   149,    35,
-      36,    37,    38,    39,    40,    41,    42,     0,    43,    35,
-      36,    37,     0,    39,    40,    41,    42,    44,    45,     0,
-       0,   192,   193,    98,     0,     0,     0,    46,     0,    47,
-       0,    48,    35,    36,    37,     0,    39,    40,    41,    42,
-       0,    99,   100,   101,   102,   103,   104,   105,   106,   107,
-     108,   109,   110,   111,   112,   113,    98,     0,   114,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    99,   100,   101,   102,   103,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,   113,     0,
-       0,   114,   273,   130,   134,   131,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,    98,
-       0,    99,   100,   101,   102,   103,   104,   105,   106,   107,
-     108,   109,   110,   111,   112,   113,     0,    99,   114,   130,
-     136,   131,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,     0,     0,     0,   114,     0,     0,    99,   100,   101,
-     102,   103,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,   113,    98,     0,   114,     0,     0,     0,   256,   257,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      99,   100,   101,   102,   103,   104,   105,   106,   107,   108,
-     109,   110,   111,   112,   113,     0,   130,   114,   131,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    99,   100,   101,   102,   103,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,   113,    98,
-       0,   114,     0,     0,   211,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,    99,   100,   101,
-     102,   103,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,   113,    98,     0,   114,     0,     0,     0,     0,     0,
+     114,   115,     0,     0,   116,   101,     0,   152,   195,   196,
+     100,     0,     0,     0,   110,   111,   112,   113,   114,    35,
+      36,    37,   116,    39,    40,    41,    42,     0,   101,   102,
+     103,   104,   105,   106,   107,   108,   109,   110,   111,   112,
+     113,   114,   115,   100,     0,   116,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      99,   100,   101,   102,   103,   104,   105,   106,   107,   108,
-     109,   110,   111,   112,   113,   224,    98,   114,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,   121,     0,
-       0,     0,     0,     0,    99,   100,   101,   102,   103,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,   113,    98,
-       0,   114,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    98,     0,     0,    99,   100,   101,
-     102,   103,   104,   105,   106,   107,   108,   109,   110,   111,
-     112,   113,    99,   100,   114,   102,   103,   104,   105,   106,
-     107,   108,   109,   110,   111,   112,    98,     0,     0,   114,
+       0,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,     0,     0,   116,   279,
+     132,   136,   133,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,   100,     0,   101,   102,
+     103,   104,   105,   106,   107,   108,   109,   110,   111,   112,
+     113,   114,   115,     0,   101,   116,   132,   138,   133,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,     0,     0,
+       0,   116,     0,     0,   101,   102,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   115,   100,
+       0,   116,     0,     0,     0,   261,   262,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,   101,   102,   103,
+     104,   105,   106,   107,   108,   109,   110,   111,   112,   113,
+     114,   115,   101,   132,   116,   133,     0,   106,   107,   108,
+     109,   110,   111,   112,   113,   114,     0,     0,     0,   116,
+       0,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   100,     0,   116,     0,
+       0,   214,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,   101,   102,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   115,   100,
+       0,   116,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,   101,   102,   103,
+     104,   105,   106,   107,   108,   109,   110,   111,   112,   113,
+     114,   115,   228,   100,   116,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,   123,     0,     0,     0,     0,
+       0,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   100,     0,   116,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    99,     0,     0,   102,   103,   104,
-     105,   106,   107,   108,   109,   110,   111,   112,     0,     0,
-       0,   114,    35,    36,    37,    38,    39,    40,    41,    42,
-       0,    43,     4,     5,     6,     7,     8,     9,    10,     0,
-      44,    45,   181,     0,     0,    11,    12,    13,    14,    15,
-      46,     0,    47,     0,    48,    35,    36,    37,    38,    39,
-      40,    41,    42,     0,    43,     0,     0,     0,     0,     0,
-       0,     0,     0,    44,    45,     0,     0,     0,     0,     0,
-       0,     0,     0,    46,  -101,    47,     0,    48,    35,    36,
-      37,    38,    39,    40,    41,    42,     0,    43,     0,     0,
-       0,     0,     0,     0,     0,     0,    44,    45,    35,    36,
-      37,   197,   198,    40,    41,   199,    46,    43,    47,     0,
-      48,     0,     0,     0,     0,     0,    44,    45,     0,     0,
-       0,     0,     0,     0,     0,     0,    46,     0,    47,     0,
-      48
+       0,   100,     0,     0,   101,   102,   103,   104,   105,   106,
+     107,   108,   109,   110,   111,   112,   113,   114,   115,   101,
+       0,   116,   104,   105,   106,   107,   108,   109,   110,   111,
+     112,   113,   114,     0,     0,     0,   116,    35,    36,    37,
+      38,    39,    40,    41,    42,     0,    43,     4,     5,     6,
+       7,     8,     9,    10,     0,    44,    45,   184,     0,     0,
+      11,    12,    13,    14,    15,    46,     0,    47,     0,    48,
+      35,    36,    37,    38,    39,    40,    41,    42,     0,    43,
+       0,     0,     0,     0,     0,     0,     0,     0,    44,    45,
+       0,     0,     0,     0,     0,     0,     0,     0,    46,  -104,
+      47,     0,    48,    35,    36,    37,    38,    39,    40,    41,
+      42,     0,    43,     0,     0,     0,     0,     0,     0,     0,
+       0,    44,    45,    35,    36,    37,   200,   201,    40,    41,
+     202,    46,    43,    47,     0,    48,     0,     0,     0,     0,
+       0,    44,    45,     0,     0,     0,     0,     0,     0,     0,
+       0,    46,     0,    47,     0,    48
 };
 
 static const yytype_int16 yycheck[] =
 {
-       6,     7,    95,     4,   121,    11,    12,    13,    14,    73,
-       0,    75,    24,    77,    10,    24,    25,    46,    10,    28,
-      49,     0,    53,    12,   141,     4,     0,     6,    13,     0,
-       4,    62,     6,     4,    48,     6,    30,    43,    44,    45,
-      46,     4,    29,     6,    53,    24,    30,    41,    42,    43,
-      24,    46,     4,    24,     6,    39,    40,    41,    42,    43,
-      13,    14,    24,    47,    80,    81,    67,    46,    24,    48,
-      49,    50,    78,    48,    48,    24,    50,    48,    79,    50,
-     128,   129,    88,    24,    90,    24,    25,    28,    30,    28,
-      12,    97,    98,    24,   100,   101,   102,   103,   104,   105,
-     106,   107,   108,   109,   110,   111,   112,   113,   114,    49,
-      14,   117,    48,   119,    51,    29,   132,   133,    48,   135,
-      29,   137,   118,    50,   130,    45,   142,    45,   134,    52,
-     136,    48,   128,   129,    45,   228,   128,   129,    54,    41,
-      12,    30,    48,   207,     5,   209,     9,    50,   154,    48,
-      39,    40,    41,    42,    43,    48,    54,   163,    30,    31,
-      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
-      42,    43,    44,     6,   180,    47,    26,    27,    28,    29,
-      45,    82,    54,    20,   190,   189,   187,    30,   189,    89,
-      82,   191,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,   251,   266,   131,    47,   211,   212,    12,   219,    -1,
-     216,    -1,   213,    -1,   220,    -1,   222,    -1,   224,    -1,
-      -1,   237,   238,    -1,   240,    30,    31,    32,    33,    34,
-      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
-      -1,    -1,    47,    -1,    -1,   251,   252,    -1,    -1,    54,
-      12,    -1,   258,    -1,    -1,   261,   272,    -1,   264,   260,
-      -1,    -1,    -1,    -1,   270,    -1,    -1,   273,    30,    31,
+       6,     7,    80,    81,    97,    11,    12,    13,    14,    82,
+       0,    73,    24,    75,    10,    77,    10,    24,    25,     0,
+      53,    28,    24,     4,    13,     6,    28,     0,     0,    62,
+      12,     4,     4,     6,     6,    13,    14,    43,    44,    45,
+      46,     4,     5,    24,    24,    25,    53,     4,    28,     6,
+     123,    24,    24,   130,   131,    46,   134,   135,    49,   137,
+       4,   139,     6,    24,    48,    46,   144,    48,    49,    50,
+     143,    29,    78,    48,    24,    48,    48,    50,    50,    30,
+      26,    27,    28,    29,    90,    24,    92,    46,    39,    40,
+      41,    42,    43,    99,   100,    24,   102,   103,   104,   105,
+     106,   107,   108,   109,   110,   111,   112,   113,   114,   115,
+     116,    51,    30,   119,    12,   121,    79,    24,    49,    14,
+      48,    29,    48,    29,   120,    24,   132,    50,    91,    30,
+     136,    45,   138,    45,   130,   131,   130,   131,    48,   232,
+      41,    42,    43,    52,    48,    45,    15,    41,   210,    54,
+     212,   157,    21,    22,    23,    24,    25,    26,    27,    28,
+     166,    30,    50,   241,   242,    48,   244,    12,     5,    48,
+      39,    40,    45,     9,     6,    91,    54,   183,    20,   247,
+      49,    84,    51,   192,    53,    30,    31,   193,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,   194,
+     278,   256,    47,    84,   223,    -1,   133,    -1,   214,   215,
+     272,    -1,    12,    -1,   220,    -1,    -1,    -1,   224,    -1,
+     226,    -1,   228,    -1,    -1,    -1,    -1,   190,    -1,    -1,
+      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
+      40,    41,    42,    43,    44,    -1,    -1,    47,    -1,    -1,
+     256,   257,    -1,   216,    54,    -1,    12,   263,    -1,    -1,
+      -1,   267,    -1,    -1,   270,    -1,    -1,    -1,    -1,    -1,
+     276,    -1,    -1,   279,    30,    31,    32,    33,    34,    35,
+      36,    37,    38,    39,    40,    41,    42,    43,    44,    12,
+      -1,    47,    -1,    -1,    -1,    -1,    -1,    -1,    54,    21,
+      22,    23,   265,    25,    26,    27,    28,    30,    31,    32,
+      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
+      43,    44,    -1,    -1,    47,    30,    -1,    50,    10,    11,
+      12,    -1,    -1,    -1,    39,    40,    41,    42,    43,    21,
+      22,    23,    47,    25,    26,    27,    28,    -1,    30,    31,
       32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
-      42,    43,    44,    15,    -1,    47,    -1,    -1,    50,    21,
-      22,    23,    24,    25,    26,    27,    28,    -1,    30,    21,
-      22,    23,    -1,    25,    26,    27,    28,    39,    40,    -1,
-      -1,    10,    11,    12,    -1,    -1,    -1,    49,    -1,    51,
-      -1,    53,    21,    22,    23,    -1,    25,    26,    27,    28,
-      -1,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    12,    -1,    47,    -1,
+      42,    43,    44,    12,    -1,    47,    -1,    -1,    -1,    -1,
       -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    30,    31,    32,    33,    34,    35,
-      36,    37,    38,    39,    40,    41,    42,    43,    44,    -1,
-      -1,    47,    48,    12,    13,    14,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    12,
       -1,    30,    31,    32,    33,    34,    35,    36,    37,    38,
-      39,    40,    41,    42,    43,    44,    -1,    30,    47,    12,
-      13,    14,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    -1,    -1,    -1,    47,    -1,    -1,    30,    31,    32,
-      33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    12,    -1,    47,    -1,    -1,    -1,    18,    19,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
-      40,    41,    42,    43,    44,    -1,    12,    47,    14,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    30,    31,    32,    33,    34,    35,
+      39,    40,    41,    42,    43,    44,    -1,    -1,    47,    48,
+      12,    13,    14,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    12,    -1,    30,    31,
+      32,    33,    34,    35,    36,    37,    38,    39,    40,    41,
+      42,    43,    44,    -1,    30,    47,    12,    13,    14,    35,
+      36,    37,    38,    39,    40,    41,    42,    43,    -1,    -1,
+      -1,    47,    -1,    -1,    30,    31,    32,    33,    34,    35,
       36,    37,    38,    39,    40,    41,    42,    43,    44,    12,
-      -1,    47,    -1,    -1,    17,    -1,    -1,    -1,    -1,    -1,
+      -1,    47,    -1,    -1,    -1,    18,    19,    -1,    -1,    -1,
       -1,    -1,    -1,    -1,    -1,    -1,    -1,    30,    31,    32,
       33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    12,    -1,    47,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      30,    31,    32,    33,    34,    35,    36,    37,    38,    39,
-      40,    41,    42,    43,    44,    45,    12,    47,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    24,    -1,
+      43,    44,    30,    12,    47,    14,    -1,    35,    36,    37,
+      38,    39,    40,    41,    42,    43,    -1,    -1,    -1,    47,
+      -1,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    12,    -1,    47,    -1,
+      -1,    17,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
       -1,    -1,    -1,    -1,    30,    31,    32,    33,    34,    35,
       36,    37,    38,    39,    40,    41,    42,    43,    44,    12,
       -1,    47,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    12,    -1,    -1,    30,    31,    32,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    30,    31,    32,
       33,    34,    35,    36,    37,    38,    39,    40,    41,    42,
-      43,    44,    30,    31,    47,    33,    34,    35,    36,    37,
-      38,    39,    40,    41,    42,    43,    12,    -1,    -1,    47,
+      43,    44,    45,    12,    47,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    24,    -1,    -1,    -1,    -1,
+      -1,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    12,    -1,    47,    -1,
       -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    -1,    30,    -1,    -1,    33,    34,    35,
-      36,    37,    38,    39,    40,    41,    42,    43,    -1,    -1,
-      -1,    47,    21,    22,    23,    24,    25,    26,    27,    28,
-      -1,    30,     3,     4,     5,     6,     7,     8,     9,    -1,
-      39,    40,    41,    -1,    -1,    16,    17,    18,    19,    20,
-      49,    -1,    51,    -1,    53,    21,    22,    23,    24,    25,
-      26,    27,    28,    -1,    30,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    39,    40,    -1,    -1,    -1,    -1,    -1,
-      -1,    -1,    -1,    49,    50,    51,    -1,    53,    21,    22,
-      23,    24,    25,    26,    27,    28,    -1,    30,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    39,    40,    21,    22,
-      23,    24,    25,    26,    27,    28,    49,    30,    51,    -1,
-      53,    -1,    -1,    -1,    -1,    -1,    39,    40,    -1,    -1,
-      -1,    -1,    -1,    -1,    -1,    -1,    49,    -1,    51,    -1,
-      53
+      -1,    12,    -1,    -1,    30,    31,    32,    33,    34,    35,
+      36,    37,    38,    39,    40,    41,    42,    43,    44,    30,
+      -1,    47,    33,    34,    35,    36,    37,    38,    39,    40,
+      41,    42,    43,    -1,    -1,    -1,    47,    21,    22,    23,
+      24,    25,    26,    27,    28,    -1,    30,     3,     4,     5,
+       6,     7,     8,     9,    -1,    39,    40,    41,    -1,    -1,
+      16,    17,    18,    19,    20,    49,    -1,    51,    -1,    53,
+      21,    22,    23,    24,    25,    26,    27,    28,    -1,    30,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    39,    40,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    49,    50,
+      51,    -1,    53,    21,    22,    23,    24,    25,    26,    27,
+      28,    -1,    30,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    39,    40,    21,    22,    23,    24,    25,    26,    27,
+      28,    49,    30,    51,    -1,    53,    -1,    -1,    -1,    -1,
+      -1,    39,    40,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    49,    -1,    51,    -1,    53
 };
 
   /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
@@ -926,32 +925,33 @@ static const yytype_uint8 yystos[] =
 {
        0,    64,    67,     0,     3,     4,     5,     6,     7,     8,
        9,    16,    17,    18,    19,    20,    68,    69,    70,    71,
-      75,    77,    84,    89,    90,    92,    93,    95,    97,    99,
-      24,   138,    72,    73,   138,    21,    22,    23,    24,    25,
-      26,    27,    28,    30,    39,    40,    49,    51,    53,   103,
-     104,   105,   107,   108,   109,   114,   115,   120,   129,   133,
-     134,   136,    15,   101,   103,    13,    74,    76,    85,   132,
-     134,   136,   103,   103,    94,   103,    96,   103,   100,    14,
-      74,    80,    65,    66,    66,    66,    66,    66,    12,    48,
-      29,   103,   103,   103,   103,   130,   121,   116,    12,    30,
-      31,    32,    33,    34,    35,    36,    37,    38,    39,    40,
-      41,    42,    43,    44,    47,    46,   106,    53,    62,   102,
-      24,    24,   119,    78,    79,   138,    86,    87,   103,    48,
-      12,    14,    91,    91,    13,    91,    13,    91,   103,   138,
-     119,    24,    82,   119,    71,    90,   103,    73,   103,    50,
-      64,    24,    25,    28,    53,   122,   123,   124,   137,   103,
-     117,   118,   103,    12,   103,   103,   103,   103,   103,   103,
-     103,   103,   103,   103,   103,   103,   103,   103,   103,    24,
-      49,    41,   103,   125,    24,   136,   103,    14,   120,    48,
-      29,    48,    10,    11,    88,   132,   132,    24,    25,    28,
-     135,    24,    25,    28,   135,   119,   119,   103,   119,   103,
-     119,    17,    29,    83,   119,    50,    45,   103,    52,    48,
-      45,    54,    48,   103,    45,   103,   110,   111,   112,   113,
-      54,    41,   131,   138,    79,   103,    87,    91,    91,   103,
-     103,    81,   138,   103,    54,   124,   103,   103,   103,    50,
-      64,    48,     5,   126,   119,   119,    18,    19,    98,   119,
-      48,    45,   111,   103,     9,   127,   103,   138,   103,   103,
-       6,   128,    91,    48,   103,    54,   119,   103
+      75,    77,    84,    89,    92,    94,    95,    97,    99,   101,
+      24,   140,    72,    73,   140,    21,    22,    23,    24,    25,
+      26,    27,    28,    30,    39,    40,    49,    51,    53,   105,
+     106,   107,   109,   110,   111,   116,   117,   122,   131,   135,
+     136,   138,    15,   103,   105,    13,    74,    76,    85,   134,
+     136,   138,   105,   105,    96,   105,    98,   105,   102,    14,
+      74,    80,    24,    90,    65,    66,    66,    66,    66,    66,
+      12,    48,    29,   105,   105,   105,   105,   132,   123,   118,
+      12,    30,    31,    32,    33,    34,    35,    36,    37,    38,
+      39,    40,    41,    42,    43,    44,    47,    46,   108,    53,
+      62,   104,    24,    24,   121,    78,    79,   140,    86,    87,
+     105,    48,    12,    14,    93,    93,    13,    93,    13,    93,
+     105,   140,   121,    24,    82,   121,   122,    71,    92,   105,
+      73,   105,    50,    64,    24,    25,    28,    53,   124,   125,
+     126,   139,   105,   119,   120,   105,    12,   105,   105,   105,
+     105,   105,   105,   105,   105,   105,   105,   105,   105,   105,
+     105,   105,    24,    49,    41,   105,   127,    24,   138,   105,
+      14,   122,    48,    29,    48,    10,    11,    88,   134,   134,
+      24,    25,    28,   137,    24,    25,    28,   137,   121,   121,
+     105,   121,   105,   121,    17,    29,    83,   121,    24,    50,
+      45,   105,    52,    48,    45,    54,    48,   105,    45,   105,
+     112,   113,   114,   115,    54,    41,   133,   140,    79,   105,
+      87,    93,    93,   105,   105,    81,   140,    91,   105,    54,
+     126,   105,   105,   105,    50,    64,    48,     5,   128,   121,
+     121,    18,    19,   100,   121,    48,    78,    45,   113,   105,
+       9,   129,   105,   140,   105,   105,     6,   130,    93,    48,
+     105,    54,   121,   105
 };
 
   /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
@@ -959,43 +959,43 @@ static const yytype_uint8 yyr1[] =
 {
        0,    63,    64,    64,    64,    64,    64,    64,    65,    65,
       66,    66,    67,    67,    68,    68,    68,    68,    68,    68,
-      69,    70,    71,    72,    72,    73,    74,    76,    75,    77,
-      77,    77,    77,    77,    78,    78,    79,    80,    80,    81,
-      81,    83,    82,    85,    84,    86,    86,    87,    88,    88,
-      88,    88,    89,    89,    90,    91,    91,    92,    93,    94,
-      94,    95,    96,    96,    97,    98,    98,   100,    99,   102,
-     101,   101,   103,   103,   103,   103,   103,   103,   104,   104,
-     106,   105,   107,   107,   107,   108,   108,   108,   108,   108,
-     108,   108,   108,   108,   108,   108,   108,   108,   108,   108,
-     109,   110,   110,   111,   112,   111,   113,   113,   114,   114,
-     116,   115,   117,   117,   118,   118,   119,   119,   121,   120,
-     122,   122,   123,   123,   124,   124,   124,   124,   125,   125,
-     126,   126,   127,   127,   127,   128,   128,   129,   129,   129,
-     129,   129,   130,   129,   129,   129,   129,   131,   129,   132,
-     132,   133,   133,   134,   134,   134,   134,   134,   135,   135,
-     135,   136,   137,   137,   138
+      68,    69,    70,    71,    72,    72,    73,    74,    76,    75,
+      77,    77,    77,    77,    77,    78,    78,    79,    80,    80,
+      81,    81,    83,    82,    85,    84,    86,    86,    87,    88,
+      88,    88,    88,    89,    89,    91,    90,    92,    93,    93,
+      94,    95,    96,    96,    97,    98,    98,    99,   100,   100,
+     102,   101,   104,   103,   103,   105,   105,   105,   105,   105,
+     105,   106,   106,   108,   107,   109,   109,   109,   110,   110,
+     110,   110,   110,   110,   110,   110,   110,   110,   110,   110,
+     110,   110,   110,   111,   112,   112,   113,   114,   113,   115,
+     115,   116,   116,   118,   117,   119,   119,   120,   120,   121,
+     121,   123,   122,   124,   124,   125,   125,   126,   126,   126,
+     126,   127,   127,   128,   128,   129,   129,   129,   130,   130,
+     131,   131,   131,   131,   131,   132,   131,   131,   131,   131,
+     133,   131,   134,   134,   135,   135,   136,   136,   136,   136,
+     136,   137,   137,   137,   138,   139,   139,   140
 };
 
   /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
 static const yytype_uint8 yyr2[] =
 {
        0,     2,     2,     3,     3,     3,     3,     3,     0,     2,
-       0,     2,     0,     2,     1,     1,     1,     1,     1,     1,
-       4,     2,     2,     1,     3,     3,     4,     0,     3,     3,
-       3,     3,     4,     6,     1,     3,     3,     0,     2,     1,
-       3,     0,     3,     0,     3,     1,     3,     2,     0,     1,
-       1,     1,     2,     4,     2,     2,     2,     4,     4,     3,
-       5,     2,     3,     5,     2,     1,     1,     0,     9,     0,
-       3,     1,     1,     1,     1,     1,     1,     3,     1,     3,
-       0,     5,     2,     2,     2,     3,     3,     3,     3,     3,
-       3,     3,     3,     3,     3,     3,     3,     3,     3,     4,
-       5,     0,     1,     1,     0,     2,     1,     3,     1,     1,
-       0,     4,     0,     1,     1,     3,     0,     2,     0,     4,
-       0,     1,     1,     3,     1,     3,     3,     5,     1,     2,
-       0,     2,     0,     2,     4,     0,     2,     1,     1,     1,
-       1,     3,     0,     4,     3,     3,     4,     0,     8,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1
+       0,     2,     0,     2,     1,     1,     1,     1,     1,     2,
+       1,     4,     2,     2,     1,     3,     3,     4,     0,     3,
+       3,     3,     3,     4,     6,     1,     3,     3,     0,     2,
+       1,     3,     0,     3,     0,     3,     1,     3,     2,     0,
+       1,     1,     1,     2,     4,     0,     5,     2,     2,     2,
+       4,     4,     3,     5,     2,     3,     5,     2,     1,     1,
+       0,     9,     0,     3,     1,     1,     1,     1,     1,     1,
+       3,     1,     3,     0,     5,     2,     2,     2,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     4,     5,     0,     1,     1,     0,     2,     1,
+       3,     1,     1,     0,     4,     0,     1,     1,     3,     0,
+       2,     0,     4,     0,     1,     1,     3,     1,     3,     3,
+       5,     1,     2,     0,     2,     0,     2,     4,     0,     2,
+       1,     1,     1,     1,     3,     0,     4,     3,     3,     4,
+       0,     8,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1
 };
 
 
@@ -1902,35 +1902,35 @@ yyreduce:
     break;
 
   case 20:
-#line 259 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 256 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
-      parser->ast()->scopes()->start(triagens::aql::AQL_SCOPE_FOR);
-     
-      auto node = parser->ast()->createNodeFor((yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[0].node), true);
-      parser->ast()->addOperation(node);
     }
-#line 1913 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1909 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
   case 21:
-#line 268 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 261 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
-      // operand is a reference. can use it directly
-      auto node = parser->ast()->createNodeFilter((yyvsp[0].node));
+      parser->ast()->scopes()->start(triagens::aql::AQL_SCOPE_FOR);
+     
+      auto node = parser->ast()->createNodeFor((yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[0].node), true);
       parser->ast()->addOperation(node);
     }
-#line 1923 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1920 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
   case 22:
-#line 276 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 270 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
+      // operand is a reference. can use it directly
+      auto node = parser->ast()->createNodeFilter((yyvsp[0].node));
+      parser->ast()->addOperation(node);
     }
 #line 1930 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
   case 23:
-#line 281 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 278 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
 #line 1937 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
@@ -1944,16 +1944,23 @@ yyreduce:
     break;
 
   case 25:
-#line 288 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 285 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+    {
+    }
+#line 1951 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+    break;
+
+  case 26:
+#line 290 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeLet((yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[0].node), true);
       parser->ast()->addOperation(node);
     }
-#line 1953 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1960 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 26:
-#line 295 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 27:
+#line 297 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! TRI_CaseEqualString((yyvsp[-2].strval).value, "COUNT")) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'COUNT'", (yyvsp[-2].strval).value, yylloc.first_line, yylloc.first_column);
@@ -1961,20 +1968,20 @@ yyreduce:
 
       (yyval.strval) = (yyvsp[0].strval);
     }
-#line 1965 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1972 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 27:
-#line 305 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 28:
+#line 307 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeArray();
       parser->pushStack(node);
     }
-#line 1974 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1981 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 28:
-#line 308 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 29:
+#line 310 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     { 
       auto list = static_cast<AstNode*>(parser->popStack());
 
@@ -1983,11 +1990,11 @@ yyreduce:
       }
       (yyval.node) = list;
     }
-#line 1987 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 1994 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 29:
-#line 319 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 30:
+#line 321 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
 
@@ -2004,11 +2011,11 @@ yyreduce:
       auto node = parser->ast()->createNodeCollectCount(parser->ast()->createNodeArray(), (yyvsp[-1].strval).value, (yyvsp[-1].strval).length, (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2008 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2015 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 30:
-#line 335 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 31:
+#line 337 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
 
@@ -2036,11 +2043,11 @@ yyreduce:
       auto node = parser->ast()->createNodeCollectCount((yyvsp[-2].node), (yyvsp[-1].strval).value, (yyvsp[-1].strval).length, (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2040 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2047 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 31:
-#line 362 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 32:
+#line 364 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
 
@@ -2068,11 +2075,11 @@ yyreduce:
       auto node = parser->ast()->createNodeCollect((yyvsp[-2].node), (yyvsp[-1].strval).value, (yyvsp[-1].strval).length, nullptr, (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2072 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2079 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 32:
-#line 389 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 33:
+#line 391 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
 
@@ -2105,11 +2112,11 @@ yyreduce:
       auto node = parser->ast()->createNodeCollect((yyvsp[-3].node), (yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2109 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2116 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 33:
-#line 421 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 34:
+#line 423 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
 
@@ -2137,13 +2144,6 @@ yyreduce:
       auto node = parser->ast()->createNodeCollectExpression((yyvsp[-5].node), (yyvsp[-3].strval).value, (yyvsp[-3].strval).length, (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2141 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
-    break;
-
-  case 34:
-#line 451 "arangod/Aql/grammar.y" /* yacc.c:1661  */
-    {
-    }
 #line 2148 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
@@ -2155,34 +2155,41 @@ yyreduce:
     break;
 
   case 36:
-#line 458 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+#line 455 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+    {
+    }
+#line 2162 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+    break;
+
+  case 37:
+#line 460 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeAssign((yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[0].node));
       parser->pushArrayElement(node);
     }
-#line 2164 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2171 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 37:
-#line 465 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 38:
+#line 467 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval).value = nullptr;
       (yyval.strval).length = 0;
     }
-#line 2173 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2180 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 38:
-#line 469 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 39:
+#line 471 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval).value = (yyvsp[0].strval).value;
       (yyval.strval).length = (yyvsp[0].strval).length;
     }
-#line 2182 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2189 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 39:
-#line 476 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 40:
+#line 478 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->ast()->scopes()->existsVariable((yyvsp[0].strval).value, (yyvsp[0].strval).length)) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "use of unknown variable '%s' for KEEP", (yyvsp[0].strval).value, yylloc.first_line, yylloc.first_column);
@@ -2197,11 +2204,11 @@ yyreduce:
       node->setFlag(FLAG_KEEP_VARIABLENAME);
       parser->pushArrayElement(node);
     }
-#line 2201 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2208 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 40:
-#line 490 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 41:
+#line 492 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->ast()->scopes()->existsVariable((yyvsp[0].strval).value, (yyvsp[0].strval).length)) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "use of unknown variable '%s' for KEEP", (yyvsp[0].strval).value, yylloc.first_line, yylloc.first_column);
@@ -2216,11 +2223,11 @@ yyreduce:
       node->setFlag(FLAG_KEEP_VARIABLENAME);
       parser->pushArrayElement(node);
     }
-#line 2220 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2227 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 41:
-#line 507 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 42:
+#line 509 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! TRI_CaseEqualString((yyvsp[0].strval).value, "KEEP")) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'KEEP'", (yyvsp[0].strval).value, yylloc.first_line, yylloc.first_column);
@@ -2229,140 +2236,172 @@ yyreduce:
       auto node = parser->ast()->createNodeArray();
       parser->pushStack(node);
     }
-#line 2233 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2240 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 42:
-#line 514 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 43:
+#line 516 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto list = static_cast<AstNode*>(parser->popStack());
       (yyval.node) = list;
     }
-#line 2242 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2249 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 43:
-#line 521 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 44:
+#line 523 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeArray();
       parser->pushStack(node);
     }
-#line 2251 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2258 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 44:
-#line 524 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 45:
+#line 526 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto list = static_cast<AstNode const*>(parser->popStack());
       auto node = parser->ast()->createNodeSort(list);
       parser->ast()->addOperation(node);
     }
-#line 2261 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2268 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 45:
-#line 532 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 46:
+#line 534 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2269 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2276 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 46:
-#line 535 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 47:
+#line 537 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2277 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2284 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 47:
-#line 541 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 48:
+#line 543 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeSortElement((yyvsp[-1].node), (yyvsp[0].node));
     }
-#line 2285 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2292 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 48:
-#line 547 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 49:
+#line 549 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueBool(true);
     }
-#line 2293 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2300 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 49:
-#line 550 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 50:
+#line 552 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueBool(true);
     }
-#line 2301 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2308 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 50:
-#line 553 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 51:
+#line 555 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueBool(false);
     }
-#line 2309 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2316 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 51:
-#line 556 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 52:
+#line 558 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2317 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2324 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 52:
-#line 562 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 53:
+#line 564 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto offset = parser->ast()->createNodeValueInt(0);
       auto node = parser->ast()->createNodeLimit(offset, (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2327 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2334 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 53:
-#line 567 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 54:
+#line 569 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeLimit((yyvsp[-2].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2336 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2343 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 54:
-#line 574 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 55:
+#line 576 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+    {
+      if (! TRI_CaseEqualString((yyvsp[-2].strval).value, "WINDOW")) {
+        parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'WINDOW'", (yyvsp[-2].strval).value, yylloc.first_line, yylloc.first_column);
+      }
+
+      if (! TRI_CaseEqualString((yyvsp[0].strval).value, "AGGREGATE")) {
+        parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'AGGREGATE'", (yyvsp[0].strval).value, yylloc.first_line, yylloc.first_column);
+      }
+
+      auto node = parser->ast()->createNodeArray();
+      parser->pushStack(node);
+    }
+#line 2360 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+    break;
+
+  case 56:
+#line 587 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+    {
+      auto list = static_cast<AstNode const*>(parser->popStack());
+
+      if (list == nullptr) {
+        ABORT_OOM
+      }
+
+      auto node = parser->ast()->createNodeWindow((yyvsp[-3].node), list);
+      parser->ast()->addOperation(node);
+    }
+#line 2375 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+    break;
+
+  case 57:
+#line 600 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeReturn((yyvsp[0].node));
       parser->ast()->addOperation(node);
       parser->ast()->scopes()->endNested();
     }
-#line 2346 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2385 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 55:
-#line 582 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 58:
+#line 608 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2354 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2393 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 56:
-#line 585 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 59:
+#line 611 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
        (yyval.node) = (yyvsp[0].node);
      }
-#line 2362 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2401 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 57:
-#line 591 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 60:
+#line 617 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2370,11 +2409,11 @@ yyreduce:
       auto node = parser->ast()->createNodeRemove((yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2374 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2413 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 58:
-#line 601 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 61:
+#line 627 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2382,11 +2421,11 @@ yyreduce:
       auto node = parser->ast()->createNodeInsert((yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2386 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2425 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 59:
-#line 611 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 62:
+#line 637 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2395,11 +2434,11 @@ yyreduce:
       AstNode* node = parser->ast()->createNodeUpdate(nullptr, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2399 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2438 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 60:
-#line 619 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 63:
+#line 645 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2408,18 +2447,18 @@ yyreduce:
       AstNode* node = parser->ast()->createNodeUpdate((yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2412 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2451 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 61:
-#line 630 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 64:
+#line 656 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2419 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2458 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 62:
-#line 635 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 65:
+#line 661 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2428,11 +2467,11 @@ yyreduce:
       AstNode* node = parser->ast()->createNodeReplace(nullptr, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2432 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2471 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 63:
-#line 643 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 66:
+#line 669 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2441,44 +2480,44 @@ yyreduce:
       AstNode* node = parser->ast()->createNodeReplace((yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2445 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2484 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 64:
-#line 654 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 67:
+#line 680 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2452 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2491 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 65:
-#line 659 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 68:
+#line 685 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.intval) = static_cast<int64_t>(NODE_TYPE_UPDATE);
     }
-#line 2460 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2499 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 66:
-#line 662 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 69:
+#line 688 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.intval) = static_cast<int64_t>(NODE_TYPE_REPLACE);
     }
-#line 2468 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2507 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 67:
-#line 668 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 70:
+#line 694 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     { 
       // reserve a variable named "$OLD", we might need it in the update expression
       // and in a later return thing
       parser->pushStack(parser->ast()->createNodeVariable(TRI_CHAR_LENGTH_PAIR(Variable::NAME_OLD), true));
     }
-#line 2478 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2517 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 68:
-#line 672 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 71:
+#line 698 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (! parser->configureWriteQuery((yyvsp[-1].node), (yyvsp[0].node))) {
         YYABORT;
@@ -2523,11 +2562,11 @@ yyreduce:
       auto node = parser->ast()->createNodeUpsert(static_cast<AstNodeType>((yyvsp[-3].intval)), parser->ast()->createNodeReference(TRI_CHAR_LENGTH_PAIR(Variable::NAME_OLD)), (yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node));
       parser->ast()->addOperation(node);
     }
-#line 2527 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2566 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 69:
-#line 719 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 72:
+#line 745 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto const scopeType = parser->ast()->scopes()->type();
 
@@ -2536,83 +2575,83 @@ yyreduce:
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "cannot use DISTINCT modifier on top-level query element", yylloc.first_line, yylloc.first_column);
       }
     }
-#line 2540 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2579 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 70:
-#line 726 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 73:
+#line 752 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeDistinct((yyvsp[0].node));
     }
-#line 2548 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2587 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 71:
-#line 729 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 74:
+#line 755 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2556 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2595 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 72:
-#line 735 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 75:
+#line 761 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2564 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2603 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 73:
-#line 738 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 76:
+#line 764 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2572 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2611 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 74:
-#line 741 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 77:
+#line 767 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2580 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2619 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 75:
-#line 744 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 78:
+#line 770 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2588 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2627 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 76:
-#line 747 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 79:
+#line 773 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2596 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2635 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 77:
-#line 750 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 80:
+#line 776 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeRange((yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2604 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2643 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 78:
-#line 756 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 81:
+#line 782 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval) = (yyvsp[0].strval);
     }
-#line 2612 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2651 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 79:
-#line 759 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 82:
+#line 785 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       std::string temp((yyvsp[-2].strval).value, (yyvsp[-2].strval).length);
       temp.append("::");
@@ -2626,205 +2665,205 @@ yyreduce:
       (yyval.strval).value = p;
       (yyval.strval).length = temp.size();
     }
-#line 2630 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2669 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 80:
-#line 775 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 83:
+#line 801 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushStack((yyvsp[0].strval).value);
 
       auto node = parser->ast()->createNodeArray();
       parser->pushStack(node);
     }
-#line 2641 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2680 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 81:
-#line 780 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 84:
+#line 806 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto list = static_cast<AstNode const*>(parser->popStack());
       (yyval.node) = parser->ast()->createNodeFunctionCall(static_cast<char const*>(parser->popStack()), list);
     }
-#line 2650 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2689 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 82:
-#line 787 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 85:
+#line 813 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeUnaryOperator(NODE_TYPE_OPERATOR_UNARY_PLUS, (yyvsp[0].node));
     }
-#line 2658 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2697 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 83:
-#line 790 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 86:
+#line 816 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeUnaryOperator(NODE_TYPE_OPERATOR_UNARY_MINUS, (yyvsp[0].node));
     }
-#line 2666 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2705 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 84:
-#line 793 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 87:
+#line 819 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     { 
       (yyval.node) = parser->ast()->createNodeUnaryOperator(NODE_TYPE_OPERATOR_UNARY_NOT, (yyvsp[0].node));
     }
-#line 2674 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2713 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 85:
-#line 799 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 88:
+#line 825 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_OR, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2682 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2721 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 86:
-#line 802 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 89:
+#line 828 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_AND, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2690 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2729 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 87:
-#line 805 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 90:
+#line 831 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_PLUS, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2698 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2737 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 88:
-#line 808 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 91:
+#line 834 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_MINUS, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2706 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2745 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 89:
-#line 811 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 92:
+#line 837 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_TIMES, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2714 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2753 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 90:
-#line 814 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 93:
+#line 840 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_DIV, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2722 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2761 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 91:
-#line 817 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 94:
+#line 843 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_MOD, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2730 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2769 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 92:
-#line 820 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 95:
+#line 846 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_EQ, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2738 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2777 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 93:
-#line 823 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 96:
+#line 849 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_NE, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2746 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2785 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 94:
-#line 826 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 97:
+#line 852 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_LT, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2754 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2793 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 95:
-#line 829 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 98:
+#line 855 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_GT, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2762 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2801 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 96:
-#line 832 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 99:
+#line 858 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_LE, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2770 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2809 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 97:
-#line 835 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 100:
+#line 861 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_GE, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2778 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2817 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 98:
-#line 838 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 101:
+#line 864 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_IN, (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2786 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2825 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 99:
-#line 841 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 102:
+#line 867 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeBinaryOperator(NODE_TYPE_OPERATOR_BINARY_NIN, (yyvsp[-3].node), (yyvsp[0].node));
     }
-#line 2794 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2833 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 100:
-#line 847 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 103:
+#line 873 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeTernaryOperator((yyvsp[-4].node), (yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 2802 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2841 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 101:
-#line 853 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 104:
+#line 879 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2809 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2848 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 102:
-#line 855 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 105:
+#line 881 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2816 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2855 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 103:
-#line 860 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 106:
+#line 886 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2824 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2863 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 104:
-#line 863 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 107:
+#line 889 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (parser->isModificationQuery()) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected subquery after data-modification operation", yylloc.first_line, yylloc.first_column);
@@ -2832,11 +2871,11 @@ yyreduce:
       parser->ast()->scopes()->start(triagens::aql::AQL_SCOPE_SUBQUERY);
       parser->ast()->startSubQuery();
     }
-#line 2836 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2875 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 105:
-#line 869 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 108:
+#line 895 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       AstNode* node = parser->ast()->endSubQuery();
       parser->ast()->scopes()->endCurrent();
@@ -2847,98 +2886,98 @@ yyreduce:
 
       (yyval.node) = parser->ast()->createNodeReference(variableName);
     }
-#line 2851 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2890 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 106:
-#line 882 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 109:
+#line 908 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2859 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2898 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 107:
-#line 885 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 110:
+#line 911 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2867 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2906 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 108:
-#line 891 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 111:
+#line 917 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2875 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2914 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 109:
-#line 894 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 112:
+#line 920 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2883 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2922 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 110:
-#line 900 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 113:
+#line 926 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeArray();
       parser->pushStack(node);
     }
-#line 2892 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2931 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 111:
-#line 903 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 114:
+#line 929 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = static_cast<AstNode*>(parser->popStack());
     }
-#line 2900 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2939 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 112:
-#line 909 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 115:
+#line 935 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2907 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2946 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 113:
-#line 911 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 116:
+#line 937 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2914 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2953 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 114:
-#line 916 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 117:
+#line 942 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2922 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2961 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 115:
-#line 919 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 118:
+#line 945 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       parser->pushArrayElement((yyvsp[0].node));
     }
-#line 2930 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2969 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 116:
-#line 925 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 119:
+#line 951 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = nullptr;
     }
-#line 2938 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2977 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 117:
-#line 928 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 120:
+#line 954 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if ((yyvsp[0].node) == nullptr) {
         ABORT_OOM
@@ -2950,56 +2989,56 @@ yyreduce:
 
       (yyval.node) = (yyvsp[0].node);
     }
-#line 2954 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 2993 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 118:
-#line 942 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 121:
+#line 968 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto node = parser->ast()->createNodeObject();
       parser->pushStack(node);
     }
-#line 2963 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3002 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 119:
-#line 945 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 122:
+#line 971 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = static_cast<AstNode*>(parser->popStack());
     }
-#line 2971 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3010 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 120:
-#line 951 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 123:
+#line 977 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2978 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3017 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 121:
-#line 953 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 124:
+#line 979 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2985 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3024 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 122:
-#line 958 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 125:
+#line 984 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2992 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3031 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 123:
-#line 960 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 126:
+#line 986 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
     }
-#line 2999 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3038 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 124:
-#line 965 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 127:
+#line 991 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // attribute-name-only (comparable to JS enhanced object literals, e.g. { foo, bar })
       auto ast = parser->ast();
@@ -3014,20 +3053,20 @@ yyreduce:
       auto node = ast->createNodeReference(variable);
       parser->pushObjectElement((yyvsp[0].strval).value, (yyvsp[0].strval).length, node);
     }
-#line 3018 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3057 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 125:
-#line 979 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 128:
+#line 1005 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // attribute-name : attribute-value
       parser->pushObjectElement((yyvsp[-2].strval).value, (yyvsp[-2].strval).length, (yyvsp[0].node));
     }
-#line 3027 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3066 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 126:
-#line 983 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 129:
+#line 1009 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // bind-parameter : attribute-value
       if ((yyvsp[-2].strval).length < 1 || (yyvsp[-2].strval).value[0] == '@') {
@@ -3037,92 +3076,92 @@ yyreduce:
       auto param = parser->ast()->createNodeParameter((yyvsp[-2].strval).value, (yyvsp[-2].strval).length);
       parser->pushObjectElement(param, (yyvsp[0].node));
     }
-#line 3041 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3080 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 127:
-#line 992 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 130:
+#line 1018 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // [ attribute-name-expression ] : attribute-value
       parser->pushObjectElement((yyvsp[-3].node), (yyvsp[0].node));
     }
-#line 3050 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3089 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 128:
-#line 999 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 131:
+#line 1025 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.intval) = 1;
     }
-#line 3058 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3097 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 129:
-#line 1002 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 132:
+#line 1028 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.intval) = (yyvsp[-1].intval) + 1;
     }
-#line 3066 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3105 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 130:
-#line 1008 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 133:
+#line 1034 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = nullptr;
     }
-#line 3074 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3113 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 131:
-#line 1011 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 134:
+#line 1037 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3082 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3121 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 132:
-#line 1017 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 135:
+#line 1043 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = nullptr;
     }
-#line 3090 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3129 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 133:
-#line 1020 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 136:
+#line 1046 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeArrayLimit(nullptr, (yyvsp[0].node));
     }
-#line 3098 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3137 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 134:
-#line 1023 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 137:
+#line 1049 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeArrayLimit((yyvsp[-2].node), (yyvsp[0].node));
     }
-#line 3106 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3145 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 135:
-#line 1029 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 138:
+#line 1055 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = nullptr;
     }
-#line 3114 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3153 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 136:
-#line 1032 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 139:
+#line 1058 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3122 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3161 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 137:
-#line 1038 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 140:
+#line 1064 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // variable or collection
       auto ast = parser->ast();
@@ -3155,27 +3194,27 @@ yyreduce:
 
       (yyval.node) = node;
     }
-#line 3159 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3198 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 138:
-#line 1070 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 141:
+#line 1096 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3167 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3206 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 139:
-#line 1073 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 142:
+#line 1099 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3175 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3214 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 140:
-#line 1076 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 143:
+#line 1102 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
       
@@ -3183,11 +3222,11 @@ yyreduce:
         ABORT_OOM
       }
     }
-#line 3187 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3226 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 141:
-#line 1083 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 144:
+#line 1109 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if ((yyvsp[-1].node)->type == NODE_TYPE_EXPANSION) {
         // create a dummy passthru node that reduces and evaluates the expansion first
@@ -3198,11 +3237,11 @@ yyreduce:
         (yyval.node) = (yyvsp[-1].node);
       }
     }
-#line 3202 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3241 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 142:
-#line 1093 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 145:
+#line 1119 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if (parser->isModificationQuery()) {
         parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected subquery after data-modification operation", yylloc.first_line, yylloc.first_column);
@@ -3210,11 +3249,11 @@ yyreduce:
       parser->ast()->scopes()->start(triagens::aql::AQL_SCOPE_SUBQUERY);
       parser->ast()->startSubQuery();
     }
-#line 3214 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3253 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 143:
-#line 1099 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 146:
+#line 1125 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       AstNode* node = parser->ast()->endSubQuery();
       parser->ast()->scopes()->endCurrent();
@@ -3225,11 +3264,11 @@ yyreduce:
 
       (yyval.node) = parser->ast()->createNodeReference(variableName);
     }
-#line 3229 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3268 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 144:
-#line 1109 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 147:
+#line 1135 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // named variable access, e.g. variable.reference
       if ((yyvsp[-2].node)->type == NODE_TYPE_EXPANSION) {
@@ -3245,11 +3284,11 @@ yyreduce:
         (yyval.node) = parser->ast()->createNodeAttributeAccess((yyvsp[-2].node), (yyvsp[0].strval).value, (yyvsp[0].strval).length);
       }
     }
-#line 3249 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3288 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 145:
-#line 1124 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 148:
+#line 1150 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // named variable access, e.g. variable.@reference
       if ((yyvsp[-2].node)->type == NODE_TYPE_EXPANSION) {
@@ -3264,11 +3303,11 @@ yyreduce:
         (yyval.node) = parser->ast()->createNodeBoundAttributeAccess((yyvsp[-2].node), (yyvsp[0].node));
       }
     }
-#line 3268 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3307 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 146:
-#line 1138 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 149:
+#line 1164 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // indexed variable access, e.g. variable[index]
       if ((yyvsp[-3].node)->type == NODE_TYPE_EXPANSION) {
@@ -3283,11 +3322,11 @@ yyreduce:
         (yyval.node) = parser->ast()->createNodeIndexedAccess((yyvsp[-3].node), (yyvsp[-1].node));
       }
     }
-#line 3287 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3326 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 147:
-#line 1152 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 150:
+#line 1178 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       // variable expansion, e.g. variable[*], with optional FILTER, LIMIT and RETURN clauses
       if ((yyvsp[0].intval) > 1 && (yyvsp[-2].node)->type == NODE_TYPE_EXPANSION) {
@@ -3311,11 +3350,11 @@ yyreduce:
       auto scopes = parser->ast()->scopes();
       scopes->stackCurrentVariable(scopes->getVariable(nextName));
     }
-#line 3315 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3354 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 148:
-#line 1174 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 151:
+#line 1200 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       auto scopes = parser->ast()->scopes();
       scopes->unstackCurrentVariable();
@@ -3334,27 +3373,27 @@ yyreduce:
         (yyval.node) = parser->ast()->createNodeExpansion((yyvsp[-5].intval), iterator, parser->ast()->createNodeReference(variable->name), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node));
       }
     }
-#line 3338 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3377 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 149:
-#line 1195 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 152:
+#line 1221 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3346 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3385 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 150:
-#line 1198 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 153:
+#line 1224 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3354 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3393 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 151:
-#line 1204 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 154:
+#line 1230 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if ((yyvsp[0].node) == nullptr) {
         ABORT_OOM
@@ -3362,11 +3401,11 @@ yyreduce:
       
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3366 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3405 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 152:
-#line 1211 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 155:
+#line 1237 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if ((yyvsp[0].node) == nullptr) {
         ABORT_OOM
@@ -3374,67 +3413,67 @@ yyreduce:
 
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3378 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3417 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 153:
-#line 1221 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 156:
+#line 1247 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueString((yyvsp[0].strval).value, (yyvsp[0].strval).length);
     }
-#line 3386 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3425 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 154:
-#line 1224 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 157:
+#line 1250 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = (yyvsp[0].node);
     }
-#line 3394 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3433 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 155:
-#line 1227 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 158:
+#line 1253 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueNull();
     }
-#line 3402 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3441 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 156:
-#line 1230 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 159:
+#line 1256 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueBool(true);
     }
-#line 3410 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3449 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 157:
-#line 1233 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 160:
+#line 1259 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeValueBool(false);
     }
-#line 3418 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3457 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 158:
-#line 1239 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 161:
+#line 1265 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeCollection((yyvsp[0].strval).value, TRI_TRANSACTION_WRITE);
     }
-#line 3426 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3465 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 159:
-#line 1242 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 162:
+#line 1268 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeCollection((yyvsp[0].strval).value, TRI_TRANSACTION_WRITE);
     }
-#line 3434 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3473 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 160:
-#line 1245 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 163:
+#line 1271 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       if ((yyvsp[0].strval).length < 2 || (yyvsp[0].strval).value[0] != '@') {
         parser->registerParseError(TRI_ERROR_QUERY_BIND_PARAMETER_TYPE, TRI_errno_string(TRI_ERROR_QUERY_BIND_PARAMETER_TYPE), (yyvsp[0].strval).value, yylloc.first_line, yylloc.first_column);
@@ -3442,43 +3481,43 @@ yyreduce:
 
       (yyval.node) = parser->ast()->createNodeParameter((yyvsp[0].strval).value, (yyvsp[0].strval).length);
     }
-#line 3446 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3485 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 161:
-#line 1255 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 164:
+#line 1281 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.node) = parser->ast()->createNodeParameter((yyvsp[0].strval).value, (yyvsp[0].strval).length);
     }
-#line 3454 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3493 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 162:
-#line 1261 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 165:
+#line 1287 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval) = (yyvsp[0].strval);
     }
-#line 3462 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3501 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 163:
-#line 1264 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 166:
+#line 1290 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval) = (yyvsp[0].strval);
     }
-#line 3470 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3509 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
-  case 164:
-#line 1269 "arangod/Aql/grammar.y" /* yacc.c:1661  */
+  case 167:
+#line 1295 "arangod/Aql/grammar.y" /* yacc.c:1661  */
     {
       (yyval.strval) = (yyvsp[0].strval);
     }
-#line 3478 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3517 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
     break;
 
 
-#line 3482 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
+#line 3521 "arangod/Aql/grammar.cpp" /* yacc.c:1661  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -251,6 +251,8 @@ statement_block_statement:
     }
   | sort_statement {
     }
+  | sort_statement window_statement {
+    }
   | limit_statement {
     }
   ;
@@ -570,6 +572,30 @@ limit_statement:
     }
   ;
 
+window_statement:
+    T_STRING object T_STRING {
+      if (! TRI_CaseEqualString($1.value, "WINDOW")) {
+        parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'WINDOW'", $1.value, yylloc.first_line, yylloc.first_column);
+      }
+
+      if (! TRI_CaseEqualString($3.value, "AGGREGATE")) {
+        parser->registerParseError(TRI_ERROR_QUERY_PARSE, "unexpected qualifier '%s', expecting 'AGGREGATE'", $3.value, yylloc.first_line, yylloc.first_column);
+      }
+
+      auto node = parser->ast()->createNodeArray();
+      parser->pushStack(node);
+    } collect_list {
+      auto list = static_cast<AstNode const*>(parser->popStack());
+
+      if (list == nullptr) {
+        ABORT_OOM
+      }
+
+      auto node = parser->ast()->createNodeWindow($2, list);
+      parser->ast()->addOperation(node);
+    }
+  ;
+
 return_statement:
     T_RETURN distinct_expression {
       auto node = parser->ast()->createNodeReturn($2);
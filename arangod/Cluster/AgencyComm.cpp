@@ -238,7 +238,8 @@ void AgencyCommResult::clear () {
 
 bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
                                       std::string const& stripKeyPrefix,
-                                      bool withDirs) {
+                                      bool withDirs,
+                                      std::unordered_map<std::string, uint64_t> const* knownIndexes) {
   if (! TRI_IsObjectJson(node)) {
     return true;
   }
@@ -293,7 +294,8 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
     for (size_t i = 0; i < n; ++i) {
       if (! parseJsonNode((TRI_json_t const*) TRI_AtVector(&nodes->_value._objects, i),
                            stripKeyPrefix,
-                           withDirs)) {
+                           withDirs,
+                           knownIndexes)) {
         return false;
       }
     }
@@ -310,9 +312,20 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
 
         // get "modifiedIndex"
         entry._index = triagens::basics::JsonHelper::stringUInt64(node, "modifiedIndex");
-        entry._json  = triagens::basics::JsonHelper::fromString(value->_value._string.data, value->_value._string.length - 1);
+        entry._json  = nullptr;
         entry._isDir = false;
 
+        bool known = false;
+
+        if (knownIndexes != nullptr) {
+          auto it = knownIndexes->find(prefix);
+          known = (it != knownIndexes->end() && (*it).second == entry._index);
+        }
+
+        if (! known) {
+          entry._json = triagens::basics::JsonHelper::fromString(value->_value._string.data, value->_value._string.length - 1);
+        }
+
         _values.emplace(prefix, entry);
       }
     }
@@ -327,7 +340,8 @@ bool AgencyCommResult::parseJsonNode (TRI_json_t const* node,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool AgencyCommResult::parse (std::string const& stripKeyPrefix,
-                              bool withDirs) {
+                              bool withDirs,
+                              std::unordered_map<std::string, uint64_t> const* knownIndexes) {
   TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, _body.c_str());
 
   if (! TRI_IsObjectJson(json)) {
@@ -340,7 +354,7 @@ bool AgencyCommResult::parse (std::string const& stripKeyPrefix,
   // get "node" attribute
   TRI_json_t const* node = TRI_LookupObjectJson(json, "node");
 
-  const bool result = parseJsonNode(node, stripKeyPrefix, withDirs);
+  const bool result = parseJsonNode(node, stripKeyPrefix, withDirs, knownIndexes);
   TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
   return result;
@@ -1070,6 +1084,33 @@ AgencyCommResult AgencyComm::getValues (std::string const& key,
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief gets several keys from the backend with a single request
+////////////////////////////////////////////////////////////////////////////////
+
+AgencyCommResult AgencyComm::getValues (std::vector<std::string> const& keys) {
+  TRI_ASSERT(! keys.empty());
+
+  // find the deepest directory that contains all keys
+  std::string directory = keys[0].substr(0, keys[0].rfind('/') + 1);
+
+  for (auto const& key : keys) {
+    while (! directory.empty() &&
+           key.compare(0, directory.size(), directory) != 0) {
+      size_t const pos = (directory.size() < 2 ? std::string::npos : directory.rfind('/', directory.size() - 2));
+      directory = (pos == std::string::npos ? "" : directory.substr(0, pos + 1));
+    }
+  }
+
+  if (directory.empty()) {
+    // reading the whole tree is never intended
+    TRI_ASSERT(false);
+    return AgencyCommResult();
+  }
+
+  return getValues(directory.substr(0, directory.size() - 1), true);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief removes one or multiple values from the backend
 ////////////////////////////////////////////////////////////////////////////////
@@ -1785,12 +1826,10 @@ bool AgencyComm::send (triagens::httpclient::GeneralClientConnection* connection
             result._message.c_str(),
             result._body.c_str());
 
-  if (result.successful()) {
-    return true;
-  }
-
-  connection->disconnect();
-  return false;
+  // the response was read completely, so the connection can be reused even
+  // if the request failed. failed compare-and-swaps and missing keys are
+  // regular answers of the agency
+  return result.successful();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
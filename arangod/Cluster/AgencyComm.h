@@ -219,15 +219,21 @@ namespace triagens {
 
       bool parseJsonNode (TRI_json_t const*,
                           std::string const&,
-                          bool);
+                          bool,
+                          std::unordered_map<std::string, uint64_t> const*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// parse an agency result
 /// note that stripKeyPrefix is a decoded, normal key!
+///
+/// values whose key and modifiedIndex are found in knownIndexes have not
+/// changed since the caller last saw them. they are not parsed, and their
+/// entries have a _json of nullptr
 ////////////////////////////////////////////////////////////////////////////////
 
       bool parse (std::string const&,
-                  bool);
+                  bool,
+                  std::unordered_map<std::string, uint64_t> const* knownIndexes = nullptr);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
@@ -469,6 +475,18 @@ namespace triagens {
 
         bool exists (std::string const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief gets several keys from the back end with a single request
+///
+/// the back end cannot read unrelated keys at once, so this reads the
+/// deepest directory that contains all keys recursively. it is meant for
+/// keys that are close to each other, and the keys must have a common
+/// directory. the result is to be parsed with an empty prefix, its values
+/// are then found under the full keys. all values are from the same index
+////////////////////////////////////////////////////////////////////////////////
+
+        AgencyCommResult getValues (std::vector<std::string> const&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief gets one or multiple values from the back end
 ////////////////////////////////////////////////////////////////////////////////
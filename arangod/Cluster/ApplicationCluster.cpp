@@ -81,6 +81,7 @@ ApplicationCluster::ApplicationCluster (TRI_server_t* server,
     _coordinatorConfig(),
     _disableDispatcherFrontend(true),
     _disableDispatcherKickstarter(true),
+    _commThreads(4),
     _enableCluster(false),
     _disableHeartbeat(false) {
 
@@ -120,6 +121,7 @@ void ApplicationCluster::setupOptions (std::map<std::string, basics::ProgramOpti
     ("cluster.coordinator-config", &_coordinatorConfig, "path to the coordinator configuration")
     ("cluster.disable-dispatcher-frontend", &_disableDispatcherFrontend, "do not show the dispatcher interface")
     ("cluster.disable-dispatcher-kickstarter", &_disableDispatcherKickstarter, "disable the kickstarter functionality")
+    ("cluster.comm-threads", &_commThreads, "number of threads sending cluster-internal requests")
   ;
 }
 
@@ -207,7 +209,7 @@ bool ApplicationCluster::prepare () {
 
   // initialize ClusterComm library
   // must call initialize while still single-threaded
-  ClusterComm::initialize();
+  ClusterComm::initialize(_commThreads);
 
   // disable error logging for a while
   ClusterComm::instance()->enableConnectionErrorLogging(false);
@@ -420,6 +420,21 @@ namespace triagens {
 
         bool _disableDispatcherKickstarter;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads sending cluster-internal requests
+///
+/// @CMDOPT{\--cluster.comm-threads @CA{number}}
+///
+/// Specifies the @CA{number} of background threads that send asynchronous
+/// requests to other servers of the cluster. Each thread uses its own
+/// keep-alive connection from the connection pool, so a request fanned out
+/// to many shards is sent to several servers in parallel.
+///
+/// The default is @LIT{4}.
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _commThreads;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the cluster feature is enabled
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,9 +32,12 @@
 #include "Basics/logging.h"
 #include "Basics/WriteLocker.h"
 #include "Basics/ConditionLocker.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/StringUtils.h"
 #include "SimpleHttpClient/ConnectionManager.h"
 #include "Dispatcher/DispatcherThread.h"
+#include "Statistics/MetricsRegistry.h"
+#include "Statistics/statistics.h"
 #include "Utils/Transaction.h"
 
 #include "VocBase/server.h"
@@ -64,8 +67,23 @@ void triagens::arango::ClusterCommRestCallback(string& coordinator,
 ////////////////////////////////////////////////////////////////////////////////
 
 ClusterComm::ClusterComm () :
-  _backgroundThread(nullptr),
+  _backgroundThreads(),
+  _latencyLock(),
+  _latencies(),
   _logConnectionErrors(false) {
+
+  auto metrics = triagens::basics::MetricsRegistry::instance();
+
+  metrics->addCallback("arangodb_cluster_comm_send_queue", "Number of cluster requests waiting to be sent",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    CONDITION_LOCKER(locker, somethingToSend);
+    return static_cast<double>(toSend.size());
+  });
+  metrics->addCallback("arangodb_cluster_comm_receive_queue", "Number of cluster requests sent and not yet picked up",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    CONDITION_LOCKER(locker, somethingReceived);
+    return static_cast<double>(received.size());
+  });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,13 +91,16 @@ ClusterComm::ClusterComm () :
 ////////////////////////////////////////////////////////////////////////////////
 
 ClusterComm::~ClusterComm () {
-  if (_backgroundThread != nullptr) {
-    _backgroundThread->stop();
-    _backgroundThread->shutdown();
-    delete _backgroundThread;
-    _backgroundThread = nullptr;
+  triagens::basics::MetricsRegistry::instance()->removeCallbacks(this);
+
+  for (auto& thread : _backgroundThreads) {
+    thread->stop();
+    thread->shutdown();
+    delete thread;
   }
 
+  _backgroundThreads.clear();
+
   cleanupAllQueues();
 }
 
@@ -96,9 +117,9 @@ ClusterComm* ClusterComm::instance () {
 /// @brief initialize the cluster comm singleton object
 ////////////////////////////////////////////////////////////////////////////////
 
-void ClusterComm::initialize () {
+void ClusterComm::initialize (size_t numThreads) {
   auto* i = instance();
-  i->startBackgroundThread();
+  i->startBackgroundThreads(numThreads);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -113,19 +134,53 @@ void ClusterComm::cleanup () {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief start the communication background thread
+/// @brief start the communication background threads
+///
+/// Each thread sends one request at a time over a connection leased from
+/// the ConnectionManager, so several threads can talk to the same or to
+/// different servers in parallel over their pooled keep-alive connections.
 ////////////////////////////////////////////////////////////////////////////////
 
-void ClusterComm::startBackgroundThread () {
-  _backgroundThread = new ClusterCommThread();
+void ClusterComm::startBackgroundThreads (size_t numThreads) {
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
 
-  if (nullptr == _backgroundThread) {
-    LOG_FATAL_AND_EXIT("unable to start ClusterComm background thread");
+  for (size_t i = 0;  i < numThreads;  ++i) {
+    ClusterCommThread* thread = new ClusterCommThread(i == 0);
+
+    if (! thread->init() || ! thread->start()) {
+      LOG_FATAL_AND_EXIT("ClusterComm background thread does not work");
+    }
+
+    _backgroundThreads.emplace_back(thread);
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a request round trip time for a server
+////////////////////////////////////////////////////////////////////////////////
 
-  if (! _backgroundThread->init() || ! _backgroundThread->start()) {
-    LOG_FATAL_AND_EXIT("ClusterComm background thread does not work");
+void ClusterComm::recordLatency (ServerID const& serverID, double latency) {
+  MUTEX_LOCKER(_latencyLock);
+
+  auto it = _latencies.find(serverID);
+
+  if (it == _latencies.end()) {
+    it = _latencies.emplace(serverID, basics::StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics)).first;
   }
+
+  (*it).second.addFigure(latency);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a copy of the round trip time distributions per server
+////////////////////////////////////////////////////////////////////////////////
+
+map<ServerID, triagens::basics::StatisticsDistribution> ClusterComm::latencyStatistics () {
+  MUTEX_LOCKER(_latencyLock);
+
+  return map<ServerID, basics::StatisticsDistribution>(_latencies.begin(), _latencies.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -394,6 +449,8 @@ ClusterCommResult* ClusterComm::syncRequest (
 #endif
 #endif
 #endif
+      double const sendTime = TRI_microtime();
+
       res->result = client->request(reqtype, path, body.c_str(), body.size(),
                                     headersCopy);
 
@@ -410,6 +467,8 @@ ClusterCommResult* ClusterComm::syncRequest (
       }
       else {
         cm->returnConnection(connection);
+        recordLatency(res->serverID, TRI_microtime() - sendTime);
+
         if (res->result->wasHttpError()) {
           res->status = CL_COMM_ERROR;
           res->errorMessage = client->getErrorMessage();
@@ -867,6 +926,9 @@ string ClusterComm::processAnswer (string& coordinatorHeader,
       op->answer_code = rest::HttpResponse::responseCode(
           answer->header("x-arango-response-code"));
       op->status = CL_COMM_RECEIVED;
+      if (op->sendTime > 0.0) {
+        recordLatency(op->serverID, TRI_microtime() - op->sendTime);
+      }
       // Do we have to do a callback?
       if (nullptr != op->callback) {
         if ((*op->callback)(static_cast<ClusterCommResult*>(op))) {
@@ -891,6 +953,9 @@ string ClusterComm::processAnswer (string& coordinatorHeader,
         op->answer_code = rest::HttpResponse::responseCode(
             answer->header("x-arango-response-code"));
         op->status = CL_COMM_RECEIVED;
+        if (op->sendTime > 0.0) {
+          recordLatency(op->serverID, TRI_microtime() - op->sendTime);
+        }
         if (nullptr != op->callback) {
           if ((*op->callback)(static_cast<ClusterCommResult*>(op))) {
             // This is fully processed, so let's remove it from the queue:
@@ -988,11 +1053,12 @@ void ClusterComm::cleanupAllQueues() {
 /// @brief constructs a ClusterCommThread
 ////////////////////////////////////////////////////////////////////////////////
 
-ClusterCommThread::ClusterCommThread ()
+ClusterCommThread::ClusterCommThread (bool checkTimeouts)
   : Thread("ClusterComm"),
     _agency(),
     _condition(),
-    _stop(0) {
+    _stop(0),
+    _checkTimeouts(checkTimeouts) {
 
   allowAsynchronousCancelation();
 }
@@ -1031,15 +1097,23 @@ void ClusterCommThread::run () {
       {
         CONDITION_LOCKER(locker, cc->somethingToSend);
 
-        if (cc->toSend.empty()) {
-          break;
+        // other threads may be sending operations at the head of the
+        // queue, so take the first one that was not picked up yet
+        op = nullptr;
+
+        for (auto* candidate : cc->toSend) {
+          if (candidate->status == CL_COMM_SUBMITTED) {
+            op = candidate;
+            break;
+          }
         }
-        else {
-          LOG_DEBUG("Noticed something to send");
-          op = cc->toSend.front();
-          TRI_ASSERT(op->status == CL_COMM_SUBMITTED);
-          op->status = CL_COMM_SENDING;
+
+        if (op == nullptr) {
+          break;
         }
+
+        LOG_DEBUG("Noticed something to send");
+        op->status = CL_COMM_SENDING;
       }
 
       // We release the lock, if the operation is dropped now, the
@@ -1105,6 +1179,8 @@ void ClusterCommThread::run () {
 
               client->keepConnectionOnDestruction(true);
 
+              op->sendTime = TRI_microtime();
+
               // We add this result to the operation struct without acquiring
               // a lock, since we know that only we do such a thing:
               if (nullptr != op->body) {
@@ -1147,7 +1223,7 @@ void ClusterCommThread::run () {
     // Now the send queue is empty (at least was empty, when we looked
     // just now, so we can check on our receive queue to detect timeouts:
 
-    {
+    if (_checkTimeouts) {
       double currentTime = TRI_microtime();
       CONDITION_LOCKER(locker, cc->somethingReceived);
 
@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "Basics/ReadWriteLock.h"
 #include "Basics/ConditionVariable.h"
+#include "Basics/Mutex.h"
 #include "Basics/Thread.h"
 #include "Rest/HttpRequest.h"
 #include "SimpleHttpClient/GeneralClientConnection.h"
@@ -42,6 +43,7 @@
 #include "Cluster/AgencyComm.h"
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/ServerState.h"
+#include "Statistics/figures.h"
 
 namespace triagens {
   namespace arango {
@@ -185,11 +187,13 @@ namespace triagens {
       std::map<std::string, std::string>* headerFields;
       ClusterCommCallback* callback;
       ClusterCommTimeout endTime;
+      double sendTime;       // when the request was sent, 0 before
 
       ClusterCommOperation () 
         : body(nullptr), 
           headerFields(nullptr), 
-          callback(nullptr) {
+          callback(nullptr),
+          sendTime(0.0) {
       }
 
       virtual ~ClusterCommOperation () {
@@ -261,7 +265,7 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 /// @brief initialize function to call once when still single-threaded
 ////////////////////////////////////////////////////////////////////////////////
 
-        static void initialize ();
+        static void initialize (size_t numThreads = 1);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief cleanup function to call once when shutting down
@@ -290,10 +294,22 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief start the communication background thread
+/// @brief start the communication background threads
 ////////////////////////////////////////////////////////////////////////////////
 
-        void startBackgroundThread ();
+        void startBackgroundThreads (size_t numThreads);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a request round trip time for a server
+////////////////////////////////////////////////////////////////////////////////
+
+        void recordLatency (ServerID const& serverID, double latency);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a copy of the round trip time distributions per server
+////////////////////////////////////////////////////////////////////////////////
+
+        std::map<ServerID, basics::StatisticsDistribution> latencyStatistics ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief submit an HTTP request to a shard asynchronously.
@@ -388,7 +404,7 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 ////////////////////////////////////////////////////////////////////////////////
 
         std::list<ClusterCommOperation*> toSend;
-        std::map<OperationID, std::list<ClusterCommOperation*>::iterator> toSendByOpID;
+        std::unordered_map<OperationID, std::list<ClusterCommOperation*>::iterator> toSendByOpID;
         triagens::basics::ConditionVariable somethingToSend;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -397,7 +413,7 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 
         // Receiving answers:
         std::list<ClusterCommOperation*> received;
-        std::map<OperationID, std::list<ClusterCommOperation*>::iterator> receivedByOpID;
+        std::unordered_map<OperationID, std::list<ClusterCommOperation*>::iterator> receivedByOpID;
         triagens::basics::ConditionVariable somethingReceived;
 
         // Note: If you really have to lock both `somethingToSend`
@@ -415,7 +431,7 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 /// @brief iterator type which is frequently used
 ////////////////////////////////////////////////////////////////////////////////
 
-        typedef std::map<OperationID, QueueIterator>::iterator IndexIterator;
+        typedef std::unordered_map<OperationID, QueueIterator>::iterator IndexIterator;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief internal function to match an operation:
@@ -439,10 +455,22 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
         void cleanupAllQueues();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief our background communications thread
+/// @brief our background communications threads
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ClusterCommThread*> _backgroundThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for the latency distributions
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Mutex _latencyLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief round trip time distribution per server
 ////////////////////////////////////////////////////////////////////////////////
 
-        ClusterCommThread* _backgroundThread;
+        std::unordered_map<ServerID, basics::StatisticsDistribution> _latencies;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not connection errors should be logged as errors
@@ -474,9 +502,11 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructs the ClusterCommThread
+///
+/// Only one of the threads checks the receive queue for timeouts.
 ////////////////////////////////////////////////////////////////////////////////
 
-        ClusterCommThread ();
+        explicit ClusterCommThread (bool checkTimeouts);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroys the ClusterCommThread
@@ -557,6 +587,12 @@ void ClusterCommRestCallback (std::string& coordinator, rest::HttpResponse* resp
 
         volatile sig_atomic_t _stop;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether this thread checks the receive queue for timeouts
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _checkTimeouts;
+
     };
   }  // namespace arango
 }  // namespace triagens
@@ -63,6 +63,20 @@ using triagens::basics::JsonHelper;
 
 static ClusterInfo Instance;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ranges of unique ids used up faster than this (in seconds) make
+/// the next range twice as large
+////////////////////////////////////////////////////////////////////////////////
+
+static double const UniqidFastRange = 60.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ranges of unique ids lasting longer than this (in seconds) make
+/// the next range half as large
+////////////////////////////////////////////////////////////////////////////////
+
+static double const UniqidSlowRange = 3600.0;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -76,6 +90,28 @@ static inline int setErrormsg (int ourerrno, string& errorMsg) {
   return ourerrno;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a version key such as Plan/Version from the agency. returns 0
+/// if the version is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t readAgencyVersion (AgencyComm& agency,
+                                   string const& key) {
+  AgencyCommResult result = agency.getValues(key, false);
+
+  if (! result.successful() || ! result.parse("", false)) {
+    return 0;
+  }
+
+  auto it = result._values.begin();
+
+  if (it == result._values.end()) {
+    return 0;
+  }
+
+  return JsonHelper::stringUInt64((*it).second._json);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check whether the JSON returns an error
 ////////////////////////////////////////////////////////////////////////////////
@@ -251,6 +287,59 @@ void CollectionInfoCurrent::copyAllJsons () {
   }
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 ShardRouter class
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a router for a collection
+////////////////////////////////////////////////////////////////////////////////
+
+ShardRouter::ShardRouter (vector<string> const& shardKeys,
+                          vector<ShardID> const& shards)
+  : _shardKeys(shardKeys),
+    _attributes(),
+    _shards(shards),
+    _usesDefaultShardingAttributes(shardKeys.size() == 1 &&
+                                   shardKeys[0] == TRI_VOC_ATTRIBUTE_KEY) {
+
+  _attributes.reserve(_shardKeys.size());
+
+  for (auto const& key : _shardKeys) {
+    _attributes.push_back(key.c_str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the shard that is responsible for a document
+///
+/// the hash must not change, as it determines where existing documents are
+/// stored
+////////////////////////////////////////////////////////////////////////////////
+
+int ShardRouter::route (TRI_json_t const* json,
+                        bool docComplete,
+                        ShardID& shardID) const {
+  if (_shards.empty()) {
+    return TRI_ERROR_CLUSTER_SHARD_GONE;
+  }
+
+  int error;
+  uint64_t hash = TRI_HashJsonByAttributes(json,
+                                           const_cast<char const**>(_attributes.data()),
+                                           static_cast<int>(_attributes.size()),
+                                           docComplete,
+                                           &error);
+  static char const* magicPhrase
+      = "Foxx you have stolen the goose, give she back again!";
+  static size_t const len = 52;
+  // To improve our hash function:
+  hash = TRI_FnvHashBlock(hash, magicPhrase, len);
+
+  shardID = _shards[hash % _shards.size()];
+  return error;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -269,9 +358,14 @@ ClusterInfo* ClusterInfo::instance () {
 
 ClusterInfo::ClusterInfo ()
   : _agency(),
+    _plannedCollectionsAgencyVersion(0),
+    _currentCollectionsAgencyVersion(0),
     _uniqid() {
 
-  _uniqid._currentValue = _uniqid._upperValue = 0ULL;
+  _uniqid._firstValue = _uniqid._currentValue = _uniqid._upperValue = 0ULL;
+  _uniqid._nextValue = _uniqid._nextUpperValue = 0ULL;
+  _uniqid._batchSize = MinIdsPerBatch;
+  _uniqid._rangeStart = 0.0;
 
   // Actual loading into caches is postponed until necessary
 }
@@ -290,37 +384,103 @@ ClusterInfo::~ClusterInfo () {
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief increase the uniqid value. if it exceeds the upper bound, fetch a
-/// new upper bound value from the agency
+/// @brief increase the uniqid value. if it exceeds the upper bound, continue
+/// with the prefetched range, or fetch a new range from the agency if there
+/// is none
 ////////////////////////////////////////////////////////////////////////////////
 
 uint64_t ClusterInfo::uniqid (uint64_t count) {
   MUTEX_LOCKER(_idLock);
 
-  if (_uniqid._currentValue + count - 1 >= _uniqid._upperValue) {
-    
-    uint64_t fetch = count;
+  if (_uniqid._currentValue != 0 &&
+      _uniqid._currentValue + count - 1 <= _uniqid._upperValue) {
+    uint64_t result = _uniqid._currentValue;
+    _uniqid._currentValue += count;
+
+    return result;
+  }
+
+  // the current range is used up
+  double const now = TRI_microtime();
+
+  if (_uniqid._rangeStart > 0.0) {
+    // adapt the size of the ranges to the rate at which ids are used
+    double const duration = now - _uniqid._rangeStart;
+
+    if (duration < UniqidFastRange) {
+      _uniqid._batchSize = (std::min)(_uniqid._batchSize * 2, MaxIdsPerBatch);
+    }
+    else if (duration > UniqidSlowRange) {
+      _uniqid._batchSize = (std::max)(_uniqid._batchSize / 2, MinIdsPerBatch);
+    }
+  }
+
+  if (_uniqid._nextValue != 0 &&
+      _uniqid._nextValue + count - 1 <= _uniqid._nextUpperValue) {
+    _uniqid._firstValue   = _uniqid._nextValue;
+    _uniqid._currentValue = _uniqid._nextValue + count;
+    _uniqid._upperValue   = _uniqid._nextUpperValue;
+    _uniqid._nextValue = _uniqid._nextUpperValue = 0;
+    _uniqid._rangeStart = now;
+
+    return _uniqid._firstValue;
+  }
+
+  // nothing prefetched, or a very large request: ask the agency now
+  uint64_t fetch = (std::max)(count, _uniqid._batchSize);
+
+  AgencyCommResult result = _agency.uniqid("Sync/LatestID", fetch, 0.0);
+
+  if (! result.successful() || result._index == 0) {
+    return 0;
+  }
+
+  _uniqid._firstValue   = result._index;
+  _uniqid._currentValue = result._index + count;
+  _uniqid._upperValue   = result._index + fetch - 1;
+  _uniqid._rangeStart   = now;
+
+  return result._index;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fetches the next range of unique IDs in advance
+////////////////////////////////////////////////////////////////////////////////
 
-    if (fetch < MinIdsPerBatch) {
-      fetch = MinIdsPerBatch;
+void ClusterInfo::prefetchUniqids () {
+  uint64_t fetch;
+
+  {
+    MUTEX_LOCKER(_idLock);
+
+    if (_uniqid._nextValue != 0 || _uniqid._currentValue == 0) {
+      // already prefetched, or this server does not use unique ids
+      return;
     }
 
-    AgencyCommResult result = _agency.uniqid("Sync/LatestID", fetch, 0.0);
+    uint64_t const size = _uniqid._upperValue - _uniqid._firstValue + 1;
 
-    if (! result.successful() || result._index == 0) {
-      return 0;
+    if (_uniqid._currentValue - _uniqid._firstValue < size / 2) {
+      return;
     }
 
-    _uniqid._currentValue = result._index + count;
-    _uniqid._upperValue   = _uniqid._currentValue + fetch - 1;
+    fetch = _uniqid._batchSize;
+  }
+
+  // the agency is asked without holding the lock, so uniqid() can go on
+  // handing out the rest of the current range
+  AgencyCommResult result = _agency.uniqid("Sync/LatestID", fetch, 0.0);
 
-    return result._index;
+  if (! result.successful() || result._index == 0) {
+    return;
   }
 
-  uint64_t result = _uniqid._currentValue;
-  _uniqid._currentValue += count;
+  MUTEX_LOCKER(_idLock);
 
-  return result;
+  if (_uniqid._nextValue == 0) {
+    _uniqid._nextValue      = result._index;
+    _uniqid._nextUpperValue = result._index + fetch - 1;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -658,27 +818,49 @@ void ClusterInfo::loadPlannedCollections (bool acquireLock) {
     return;
   }
 
-  // Now contact the agency:
+  // Now contact the agency. Every change of the plan increases Plan/Version
+  // when the plan lock is released, so nothing has to be fetched if the
+  // version is the one the cache was built from
   AgencyCommResult result;
+  uint64_t planVersion = 0;
   {
     if (acquireLock) {
       AgencyCommLocker locker("Plan", "READ");
 
       if (locker.successful()) {
+        planVersion = readAgencyVersion(_agency, "Plan/Version");
+
+        if (planVersion != 0 &&
+            planVersion == _plannedCollectionsAgencyVersion &&
+            _plannedCollectionsProt.isValid) {
+          return;
+        }
+
         result = _agency.getValues(prefixPlannedCollections, true);
       }
     }
     else {
+      // the caller holds the lock and may have changed the plan before the
+      // version is increased, so the version cannot be trusted
       result = _agency.getValues(prefixPlannedCollections, true);
     }
   }
 
   if (result.successful()) {
-    result.parse(prefixPlannedCollections + "/", false);
+    // collections whose entry has not been modified since the last load are
+    // not parsed again, their objects are taken over from the current cache.
+    // the cache is only modified while holding the mutex, so it can be read
+    // here without the lock
+    result.parse(prefixPlannedCollections + "/", false, &_plannedCollectionsIndexes);
+
+    shared_ptr<ShardRouters const> oldShardRouters = std::atomic_load(&_shardRouters);
 
     decltype(_plannedCollections) newCollections;
-    decltype(_shards)             newShards;
-    decltype(_shardKeys)          newShardKeys;
+    auto newShardRouters = std::make_shared<ShardRouters>();
+    decltype(_shardFollowers)     newShardFollowers;
+    decltype(_shardWriteConcerns) newShardWriteConcerns;
+    decltype(_plannedCollectionsIndexes) newIndexes;
+    bool complete = true;
 
     std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
 
@@ -697,50 +879,91 @@ void ClusterInfo::loadPlannedCollections (bool acquireLock) {
       const std::string database   = parts[0];
       const std::string collection = parts[1];
 
-      // check whether we have created an entry for the database already
-      AllCollections::iterator it2 = newCollections.find(database);
+      shared_ptr<CollectionInfo> collectionData;
+      shared_ptr<ShardRouter const> shardRouter;
+
+      if ((*it).second._json == nullptr) {
+        // unchanged since the last load
+        auto old = _plannedCollections.find(database);
+
+        if (old != _plannedCollections.end()) {
+          auto old2 = (*old).second.find(collection);
+
+          if (old2 != (*old).second.end()) {
+            collectionData = (*old2).second;
+          }
+        }
+
+        if (oldShardRouters != nullptr) {
+          auto old3 = oldShardRouters->find(collection);
+
+          if (old3 != oldShardRouters->end()) {
+            shardRouter = (*old3).second;
+          }
+        }
+
+        if (collectionData == nullptr || shardRouter == nullptr) {
+          // cannot happen, as the cache and the indexes are changed together.
+          // make sure the next load fetches everything
+          LOG_WARNING("collection '%s' is missing in the plan cache", key.c_str());
+          complete = false;
+          continue;
+        }
+      }
+      else {
+        TRI_json_t* json = (*it).second._json;
+        // steal the json
+        (*it).second._json = nullptr;
+
+        collectionData.reset(new CollectionInfo(json));
 
-      if (it2 == newCollections.end()) {
-        // not yet, so create an entry for the database
-        DatabaseCollections empty;
-        newCollections.emplace(std::make_pair(database, empty));
-        it2 = newCollections.find(database);
+        map<ShardID, ServerID> shardIDs = collectionData->shardIds();
+        vector<ShardID> shards;
+        shards.reserve(shardIDs.size());
+        for (auto const& it3 : shardIDs) {
+          shards.push_back(it3.first);
+        }
+        shardRouter = std::make_shared<ShardRouter const>(collectionData->shardKeys(), shards);
       }
 
-      TRI_json_t* json = (*it).second._json;
-      // steal the json
-      (*it).second._json = nullptr;
+      newIndexes.emplace(key, (*it).second._index);
+      newShardRouters->emplace(collection, shardRouter);
 
-      shared_ptr<CollectionInfo> collectionData (new CollectionInfo(json));
-      vector<string>* shardKeys = new vector<string>;
-      *shardKeys = collectionData->shardKeys();
-      newShardKeys.insert(
-             make_pair(collection, shared_ptr<vector<string> > (shardKeys)));
-      map<ShardID, ServerID> shardIDs = collectionData->shardIds();
-      vector<string>* shards = new vector<string>;
-      map<ShardID, ServerID>::iterator it3;
-      for (it3 = shardIDs.begin(); it3 != shardIDs.end(); ++it3) {
-        shards->push_back(it3->first);
+      // followers for synchronous replication, if any
+      uint32_t const writeConcern = collectionData->writeConcern();
+      for (auto& follower : collectionData->shardFollowers()) {
+        if (! follower.second.empty()) {
+          newShardFollowers.emplace(follower.first,
+                                    std::make_shared<vector<ServerID>>(std::move(follower.second)));
+          newShardWriteConcerns.emplace(follower.first, writeConcern);
+        }
       }
-      newShards.emplace(
-              std::make_pair(collection, shared_ptr<vector<string> >(shards)));
 
       // insert the collection into the existing map, insert it under its
       // ID as well as under its name, so that a lookup can be done with
       // either of the two.
 
-      (*it2).second.emplace(std::make_pair(collection, collectionData));
-      (*it2).second.emplace(std::make_pair(collectionData->name(),
-                                           collectionData));
+      auto& databaseCollections = newCollections[database];
+      databaseCollections.emplace(std::make_pair(collection, collectionData));
+      databaseCollections.emplace(std::make_pair(collectionData->name(),
+                                                 collectionData));
 
     }
 
+    if (! complete) {
+      planVersion = 0;
+      newIndexes.clear();
+    }
+
     // Now set the new value:
     {
       WRITE_LOCKER(_plannedCollectionsProt.lock);
       _plannedCollections.swap(newCollections);
-      _shards.swap(newShards);
-      _shardKeys.swap(newShardKeys);
+      std::atomic_store(&_shardRouters, shared_ptr<ShardRouters const>(newShardRouters));
+      _shardFollowers.swap(newShardFollowers);
+      _shardWriteConcerns.swap(newShardWriteConcerns);
+      _plannedCollectionsIndexes.swap(newIndexes);
+      _plannedCollectionsAgencyVersion = planVersion;
       _plannedCollectionsProt.version++;   // such that others notice our change
       _plannedCollectionsProt.isValid = true;  // will never be reset to false
     }
@@ -814,6 +1037,7 @@ TRI_col_info_t ClusterInfo::getCollectionProperties (CollectionInfo const& colle
   memcpy(info._name, name.c_str(), name.size());
   
   info._keyOptions   = collection.keyOptions();
+  info._stringDictionary = nullptr;
 
   info._deleted      = collection.deleted();
   info._doCompact    = collection.doCompact();
@@ -888,30 +1112,48 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
     return;
   }
 
-  // Now contact the agency:
+  // Now contact the agency, unless Current/Version shows that nothing has
+  // changed since the last load, see loadPlannedCollections
   AgencyCommResult result;
+  uint64_t currentVersion = 0;
   {
     if (acquireLock) {
       AgencyCommLocker locker("Current", "READ");
 
       if (locker.successful()) {
+        currentVersion = readAgencyVersion(_agency, "Current/Version");
+
+        if (currentVersion != 0 &&
+            currentVersion == _currentCollectionsAgencyVersion &&
+            _currentCollectionsProt.isValid) {
+          return;
+        }
+
         result = _agency.getValues(prefixCurrentCollections, true);
       }
     }
     else {
+      // the caller holds the lock and may have changed the current before the
+      // version is increased, so the version cannot be trusted
       result = _agency.getValues(prefixCurrentCollections, true);
     }
   }
 
   if (result.successful()) {
-    result.parse(prefixCurrentCollections + "/", false);
+    // shards whose entry has not been modified since the last load are not
+    // parsed again. a collection none of whose shards has changed is taken
+    // over from the current cache as a whole
+    result.parse(prefixCurrentCollections + "/", false, &_currentCollectionsIndexes);
 
     decltype(_currentCollections) newCollections;
     decltype(_shardIds)           newShardIds;
+    decltype(_currentCollectionsIndexes) newIndexes;
+    bool complete = true;
 
+    // the keys are sorted, so the shards of a collection are adjacent
     std::map<std::string, AgencyCommResultEntry>::iterator it = result._values.begin();
 
-    for (; it != result._values.end(); ++it) {
+    while (it != result._values.end()) {
       const std::string key = (*it).first;
 
       // each entry consists of a database id, a collection id, and a shardID,
@@ -921,38 +1163,86 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
       if (parts.size() != 3) {
         // invalid entry
         LOG_WARNING("found invalid collection key in current in agency: '%s'", key.c_str());
+        ++it;
         continue;
       }
 
       const std::string database   = parts[0];
       const std::string collection = parts[1];
-      const std::string shardID    = parts[2];
+      const std::string prefix     = database + "/" + collection + "/";
 
-      // check whether we have created an entry for the database already
-      AllCollectionsCurrent::iterator it2 = newCollections.find(database);
+      // find the shards of the collection
+      auto groupEnd = it;
+      size_t numShards = 0;
+      bool changed = false;
 
-      if (it2 == newCollections.end()) {
-        // not yet, so create an entry for the database
-        DatabaseCollectionsCurrent empty;
-        newCollections.insert(std::make_pair(database, empty));
-        it2 = newCollections.find(database);
+      while (groupEnd != result._values.end() &&
+             (*groupEnd).first.compare(0, prefix.size(), prefix) == 0) {
+        if ((*groupEnd).second._json != nullptr) {
+          changed = true;
+        }
+        ++numShards;
+        ++groupEnd;
       }
 
-      TRI_json_t* json = (*it).second._json;
-      // steal the json
-      (*it).second._json = nullptr;
+      shared_ptr<CollectionInfoCurrent> old;
+      {
+        auto old1 = _currentCollections.find(database);
+
+        if (old1 != _currentCollections.end()) {
+          auto old2 = (*old1).second.find(collection);
+
+          if (old2 != (*old1).second.end()) {
+            old = (*old2).second;
+          }
+        }
+      }
 
-      // check whether we already have a CollectionInfoCurrent:
-      DatabaseCollectionsCurrent::iterator it3;
-      it3 = it2->second.find(collection);
-      if (it3 == it2->second.end()) {
-        shared_ptr<CollectionInfoCurrent> collectionDataCurrent
-                    (new CollectionInfoCurrent(shardID, json));
-        it2->second.insert(make_pair(collection, collectionDataCurrent));
-        it3 = it2->second.find(collection);
+      shared_ptr<CollectionInfoCurrent> collectionDataCurrent;
+
+      if (! changed &&
+          old != nullptr &&
+          old->_jsons.size() == numShards) {
+        collectionDataCurrent = old;
       }
       else {
-        it3->second->add(shardID, json);
+        collectionDataCurrent.reset(new CollectionInfoCurrent());
+
+        for (auto it2 = it; it2 != groupEnd; ++it2) {
+          const std::string shardID = (*it2).first.substr(prefix.size());
+          TRI_json_t* json = (*it2).second._json;
+
+          if (json != nullptr) {
+            // steal the json
+            (*it2).second._json = nullptr;
+          }
+          else {
+            // unchanged shard of a changed collection
+            if (old != nullptr) {
+              auto oldJson = old->_jsons.find(shardID);
+
+              if (oldJson != old->_jsons.end() && (*oldJson).second != nullptr) {
+                json = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, (*oldJson).second);
+              }
+            }
+
+            if (json == nullptr) {
+              // cannot happen, as the cache and the indexes are changed
+              // together. make sure the next load fetches everything
+              LOG_WARNING("shard '%s' is missing in the current cache", (*it2).first.c_str());
+              complete = false;
+              continue;
+            }
+          }
+
+          if (! collectionDataCurrent->add(shardID, json)) {
+            TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+          }
+        }
+      }
+
+      for (auto it2 = it; it2 != groupEnd; ++it2) {
+        newIndexes.emplace((*it2).first, (*it2).second._index);
       }
 
       // Note that we have only inserted the CollectionInfoCurrent under
@@ -961,13 +1251,23 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
       // the correct place to hold the current name is in the plan.
       // Thus: Look there and get the collection ID from there. Then
       // ask about the current collection info.
-
-      // Now take note of this shard and its responsible server:
-      std::string DBserver = triagens::basics::JsonHelper::getStringValue
-                    (json, "DBServer", "");
-      if (DBserver != "") {
-        newShardIds.insert(make_pair(shardID, DBserver));
+      newCollections[database].emplace(collection, collectionDataCurrent);
+
+      // Now take note of the shards and their responsible servers:
+      for (auto const& shard : collectionDataCurrent->_jsons) {
+        std::string DBserver = triagens::basics::JsonHelper::getStringValue
+                      (shard.second, "DBServer", "");
+        if (DBserver != "") {
+          newShardIds.insert(make_pair(shard.first, DBserver));
+        }
       }
+
+      it = groupEnd;
+    }
+
+    if (! complete) {
+      currentVersion = 0;
+      newIndexes.clear();
     }
 
     // Now set the new value:
@@ -975,6 +1275,8 @@ void ClusterInfo::loadCurrentCollections (bool acquireLock) {
       WRITE_LOCKER(_currentCollectionsProt.lock);
       _currentCollections.swap(newCollections);
       _shardIds.swap(newShardIds);
+      _currentCollectionsIndexes.swap(newIndexes);
+      _currentCollectionsAgencyVersion = currentVersion;
       _currentCollectionsProt.version++;   // such that others notice our change
       _currentCollectionsProt.isValid = true;  // will never be reset to false
     }
@@ -2326,6 +2628,35 @@ ServerID ClusterInfo::getResponsibleServer (ShardID const& shardID) {
   return ServerID("");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the followers of a shard from the plan, and the write
+/// concern of its collection
+////////////////////////////////////////////////////////////////////////////////
+
+std::shared_ptr<std::vector<ServerID>> ClusterInfo::getShardFollowers (ShardID const& shardID,
+                                                                       uint32_t& writeConcern) {
+  writeConcern = 1;
+
+  if (! _plannedCollectionsProt.isValid) {
+    loadPlannedCollections(true);
+  }
+
+  READ_LOCKER(_plannedCollectionsProt.lock);
+  auto it = _shardFollowers.find(shardID);
+
+  if (it == _shardFollowers.end()) {
+    return std::shared_ptr<std::vector<ServerID>>();
+  }
+
+  auto it2 = _shardWriteConcerns.find(shardID);
+
+  if (it2 != _shardWriteConcerns.end()) {
+    writeConcern = (*it2).second;
+  }
+
+  return (*it).second;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief find the shard that is responsible for a document, which is given
 /// as a TRI_json_t const*.
@@ -2352,67 +2683,32 @@ int ClusterInfo::getResponsibleShard (CollectionID const& collectionID,
   // Note that currently we take the number of shards and the shardKeys
   // from Plan, since they are immutable. Later we will have to switch
   // this to Current, when we allow to add and remove shards.
-  if (! _plannedCollectionsProt.isValid) {
-    loadPlannedCollections();
-  }
-
   int tries = 0;
-  shared_ptr<vector<string> > shardKeysPtr;
-  char const** shardKeys = nullptr;
-  shared_ptr<vector<ShardID> > shards;
-  bool found = false;
 
   while (true) {
-    {
-      // Get the sharding keys and the number of shards:
-      READ_LOCKER(_plannedCollectionsProt.lock);
-      // _shards is a map-type <CollectionId, shared_ptr<vector<string>>>
-      auto it = _shards.find(collectionID);
-
-      if (it != _shards.end()) {
-        shards = it->second;
-        // _shardKeys is a map-type <CollectionID, shared_ptr<vector<string>>>
-        auto it2 = _shardKeys.find(collectionID);
-        if (it2 != _shardKeys.end()) {
-          shardKeysPtr = it2->second;
-          shardKeys = new char const* [shardKeysPtr->size()];
-          if (shardKeys != nullptr) {
-            size_t i;
-            for (i = 0; i < shardKeysPtr->size(); ++i) {
-              shardKeys[i] = shardKeysPtr->at(i).c_str();
-            }
-            usesDefaultShardingAttributes = shardKeysPtr->size() == 1 &&
-                                            shardKeysPtr->at(0) == TRI_VOC_ATTRIBUTE_KEY;
-            found = true;
-            break;  // all OK
-          }
-        }
+    // the routers are replaced as a whole when the plan changes, so the
+    // snapshot stays valid without holding a lock
+    shared_ptr<ShardRouters const> routers = std::atomic_load(&_shardRouters);
+
+    if (routers != nullptr) {
+      auto it = routers->find(collectionID);
+
+      if (it != routers->end()) {
+        ShardRouter const* router = (*it).second.get();
+
+        usesDefaultShardingAttributes = router->usesDefaultShardingAttributes();
+        return router->route(json, docComplete, shardID);
       }
     }
+
     if (++tries >= 2) {
       break;
     }
-    loadPlannedCollections(true);
-  }
 
-  if (! found) {
-    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+    loadPlannedCollections(true);
   }
 
-  int error;
-  uint64_t hash = TRI_HashJsonByAttributes(json, shardKeys,
-                                           (int) shardKeysPtr->size(),
-                                           docComplete, &error);
-  static char const* magicPhrase
-      = "Foxx you have stolen the goose, give she back again!";
-  static size_t const len = 52;
-  // To improve our hash function:
-  hash = TRI_FnvHashBlock(hash, magicPhrase, len);
-
-  delete[] shardKeys;
-
-  shardID = shards->at(hash % shards->size());
-  return error;
+  return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -252,6 +252,54 @@ namespace triagens {
           return triagens::basics::JsonHelper::stringObject(node);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the followers of the shards. the leader of a shard forwards
+/// all write operations to them
+////////////////////////////////////////////////////////////////////////////////
+
+        std::map<std::string, std::vector<std::string>> shardFollowers () const {
+          std::map<std::string, std::vector<std::string>> result;
+
+          TRI_json_t const* node = triagens::basics::JsonHelper::getObjectElement(_json, "shardFollowers");
+
+          if (TRI_IsObjectJson(node)) {
+            size_t const n = TRI_LengthVector(&node->_value._objects);
+
+            for (size_t i = 0; i < n; i += 2) {
+              auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&node->_value._objects, i));
+              auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&node->_value._objects, i + 1));
+
+              if (TRI_IsStringJson(key) && TRI_IsArrayJson(value)) {
+                result.emplace(std::string(key->_value._string.data, key->_value._string.length - 1),
+                               triagens::basics::JsonHelper::stringArray(value));
+              }
+            }
+          }
+
+          return result;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of servers, including the leader, that must have
+/// applied a write operation before it is acknowledged
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t writeConcern () const {
+          return triagens::basics::JsonHelper::getNumericValue<uint32_t>(_json, "writeConcern", 1);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of the collection whose shard distribution the
+/// collection follows, or an empty string. shard i of the collection (in the
+/// order of shardIds()) is then placed on the same server as shard i of the
+/// prototype, and documents with equal values of the shard keys end up in
+/// these shards
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string distributeShardsLike () const {
+          return triagens::basics::JsonHelper::getStringValue(_json, "distributeShardsLike", "");
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the number of shards
 ////////////////////////////////////////////////////////////////////////////////
@@ -692,6 +740,88 @@ namespace triagens {
         std::map<ShardID, TRI_json_t*> _jsons;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class ShardRouter
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maps documents of a collection to its shards
+///
+/// a router is built once per collection when the plan is loaded and is
+/// never changed afterwards, so it can be used without locks. the shard keys
+/// are kept in the form the JSON hash function takes them, so routing only
+/// hashes the document
+////////////////////////////////////////////////////////////////////////////////
+
+    class ShardRouter {
+
+      public:
+
+        ShardRouter (ShardRouter const&) = delete;
+        ShardRouter& operator= (ShardRouter const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        ShardRouter (std::vector<std::string> const& shardKeys,
+                     std::vector<ShardID> const& shards);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection is sharded by _key only
+////////////////////////////////////////////////////////////////////////////////
+
+        bool usesDefaultShardingAttributes () const {
+          return _usesDefaultShardingAttributes;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the shard that is responsible for a document
+////////////////////////////////////////////////////////////////////////////////
+
+        int route (TRI_json_t const*,
+                   bool docComplete,
+                   ShardID& shardID) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the names of the shard keys
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const _shardKeys;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pointers to the names of the shard keys, for the hash function
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<char const*> _attributes;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the shards, ordered by their ids
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ShardID> const _shards;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection is sharded by _key only
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _usesDefaultShardingAttributes;
+    };
+
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 class ClusterInfo
@@ -712,6 +842,10 @@ namespace triagens {
         typedef std::unordered_map<CollectionID,
                                    std::shared_ptr<CollectionInfoCurrent> >
                 DatabaseCollectionsCurrent;
+        typedef std::unordered_map<CollectionID,
+                                   std::shared_ptr<ShardRouter const>>
+                ShardRouters;
+
         typedef std::unordered_map<DatabaseID, DatabaseCollectionsCurrent>
                 AllCollectionsCurrent;
 
@@ -769,6 +903,14 @@ namespace triagens {
 
         uint64_t uniqid (uint64_t = 1);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fetches the next range of unique IDs from the agency once half of
+/// the current range is used, so that uniqid() does not have to wait for the
+/// agency. called regularly by the heartbeat thread
+////////////////////////////////////////////////////////////////////////////////
+
+        void prefetchUniqids ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief flush the caches (used for testing only)
 ////////////////////////////////////////////////////////////////////////////////
@@ -991,6 +1133,16 @@ namespace triagens {
 
         ServerID getResponsibleServer (ShardID const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the followers of a shard from the plan, and the write
+/// concern of its collection. returns an empty pointer if the shard has no
+/// followers. the plan is not reloaded for unknown shards, as this is called
+/// for every write operation on a DB server
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<std::vector<ServerID>> getShardFollowers (ShardID const&,
+                                                                  uint32_t& writeConcern);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief find the shard that is responsible for a document
 ////////////////////////////////////////////////////////////////////////////////
@@ -1114,8 +1266,9 @@ namespace triagens {
 
         // Finally, we need information about collections, again we have
         // data from Plan and from Current.
-        // The information for _shards and _shardKeys are filled from the 
-        // Plan (since they are fixed for the lifetime of the collection).
+        // The information for _shardRouters is filled from the Plan (since
+        // the shards and shard keys are fixed for the lifetime of the
+        // collection).
         // _shardIds is filled from Current, since we have to be able to
         // move shards between servers, and Plan contains who ought to be
         // responsible and Current contains the actual current responsibility.
@@ -1124,18 +1277,30 @@ namespace triagens {
         AllCollections
             _plannedCollections;               // from Plan/Collections/
         ProtectionData _plannedCollectionsProt;
-        std::unordered_map<CollectionID,
-                           std::shared_ptr<std::vector<std::string>>>
-            _shards;                    // from Plan/Collections/
-                               // (may later come from Current/Colletions/ )
-        std::unordered_map<CollectionID,
-                           std::shared_ptr<std::vector<std::string>>>
-            _shardKeys;                 // from Plan/Collections/
+        std::shared_ptr<ShardRouters const>
+            _shardRouters;              // from Plan/Collections/, replaced
+                                        // as a whole and accessed with
+                                        // std::atomic_load/atomic_store
+        uint64_t _plannedCollectionsAgencyVersion;
+                                        // Plan/Version of the last load
+        std::unordered_map<std::string, uint64_t>
+            _plannedCollectionsIndexes; // agency modifiedIndex of every
+                                        // entry of the last load
+        std::unordered_map<ShardID,
+                           std::shared_ptr<std::vector<ServerID>>>
+            _shardFollowers;            // from Plan/Collections/
+        std::unordered_map<ShardID, uint32_t>
+            _shardWriteConcerns;        // from Plan/Collections/
 
         // The Current state:
         AllCollectionsCurrent
             _currentCollections;        // from Current/Collections/
         ProtectionData _currentCollectionsProt;
+        uint64_t _currentCollectionsAgencyVersion;
+                                        // Current/Version of the last load
+        std::unordered_map<std::string, uint64_t>
+            _currentCollectionsIndexes; // agency modifiedIndex of every
+                                        // entry of the last load
         std::unordered_map<ShardID, ServerID>
             _shardIds;                  // from Current/Collections/
 
@@ -1144,8 +1309,14 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         struct {
-          uint64_t _currentValue;
-          uint64_t _upperValue;
+          uint64_t _firstValue;       // first id of the current range
+          uint64_t _currentValue;     // next id to hand out
+          uint64_t _upperValue;       // last id of the current range
+          uint64_t _nextValue;        // first id of the prefetched range,
+                                      // 0 if there is none
+          uint64_t _nextUpperValue;   // last id of the prefetched range
+          uint64_t _batchSize;        // size of the next range to fetch
+          double _rangeStart;         // when the current range was started
         }
         _uniqid;
 
@@ -1171,6 +1342,13 @@ namespace triagens {
 
         static const uint64_t MinIdsPerBatch = 1000000;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the largest batch of unique ids. the batch size grows up to this
+/// value while batches are used up quickly
+////////////////////////////////////////////////////////////////////////////////
+
+        static const uint64_t MaxIdsPerBatch = 128000000;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief default wait timeout
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +36,7 @@
 #include "Basics/json-utilities.h"
 #include "Basics/StringUtils.h"
 #include "Indexes/Index.h"
+#include "JsonParser/json-scanner.h"
 #include "VocBase/server.h"
 
 using namespace std;
@@ -102,26 +103,29 @@ void mergeResponseHeaders (HttpResponse* response,
 ////////////////////////////////////////////////////////////////////////////////
 
 std::map<std::string, std::string> getForwardableRequestHeaders (triagens::rest::HttpRequest* request) {
-  map<string, string> const& headers = request->headers();
-  map<string, string>::const_iterator it = headers.begin();
+  HttpRequest::header_fields_t::KeyValue const* begin;
+  HttpRequest::header_fields_t::KeyValue const* end;
 
   map<string, string> result;
 
-  while (it != headers.end()) {
-    const string& key = (*it).first;
+  // content-length is not part of the header fields
+  for (request->headerFields().range(begin, end);  begin < end;  ++begin) {
+    if (begin->_key == nullptr) {
+      continue;
+    }
+
+    string const key(begin->_key, begin->_keyLength);
 
     // ignore the following headers
     if (key != "x-arango-async" &&
         key != "authorization" &&
-        key != "content-length" &&
         key != "connection" &&
         key != "expect" &&
         key != "host" &&
         key != "origin" &&
         key.substr(0, 14) != "access-control") {
-      result.emplace(make_pair(key, (*it).second));
+      result.emplace(make_pair(key, string(begin->_value)));
     }
-    ++it;
   }
 
   return result;
@@ -413,10 +417,17 @@ int figuresOnCoordinator (string const& dbname,
     res = cc->wait( "", coordTransactionID, 0, "", 0.0);
     if (res->status == CL_COMM_RECEIVED) {
       if (res->answer_code == triagens::rest::HttpResponse::OK) {
-        TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, res->answer->body());
+        // only the figures are parsed, not the collection properties
+        char const* value;
+        size_t length;
+        TRI_json_t* json = nullptr;
 
-        if (JsonHelper::isObject(json)) {
-          TRI_json_t const* figures = TRI_LookupObjectJson(json, "figures");
+        if (TRI_FindAttributeJsonScanner(res->answer->body(), res->answer->bodySize(), "figures", &value, &length)) {
+          json = TRI_Json2StringLength(TRI_UNKNOWN_MEM_ZONE, value, length, nullptr);
+        }
+
+        if (json != nullptr) {
+          TRI_json_t const* figures = json;
 
           if (TRI_IsObjectJson(figures)) {
             // add to the total
@@ -426,12 +437,15 @@ int figuresOnCoordinator (string const& dbname,
             result->_numberShapes         += ExtractFigure<TRI_voc_ssize_t>(figures, "shapes", "count");
             result->_numberAttributes     += ExtractFigure<TRI_voc_ssize_t>(figures, "attributes", "count");
             result->_numberIndexes        += ExtractFigure<TRI_voc_ssize_t>(figures, "indexes", "count");
+            result->_numberDocumentReferences += ExtractFigure<TRI_voc_ssize_t>(figures, "documentReferences", "count");
+            result->_numberExpired        += ExtractFigure<uint64_t>(figures, "expired", "count");
 
             result->_sizeAlive            += ExtractFigure<int64_t>(figures, "alive", "size");
             result->_sizeDead             += ExtractFigure<int64_t>(figures, "dead", "size");
             result->_sizeShapes           += ExtractFigure<int64_t>(figures, "shapes", "size");
             result->_sizeAttributes       += ExtractFigure<int64_t>(figures, "attributes", "size");
             result->_sizeIndexes          += ExtractFigure<int64_t>(figures, "indexes", "size");
+            result->_sizeDocumentReferences += ExtractFigure<int64_t>(figures, "documentReferences", "size");
 
             result->_numberDatafiles      += ExtractFigure<TRI_voc_ssize_t>(figures, "datafiles", "count");
             result->_numberJournalfiles   += ExtractFigure<TRI_voc_ssize_t>(figures, "journals", "count");
@@ -511,17 +525,15 @@ int countOnCoordinator (
     res = cc->wait("", coordTransactionID, 0, "", 0.0);
     if (res->status == CL_COMM_RECEIVED) {
       if (res->answer_code == triagens::rest::HttpResponse::OK) {
-        TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, res->answer->body());
+        // only the count is looked at, the rest of the answer is not parsed
+        char const* value;
+        size_t length;
 
-        if (JsonHelper::isObject(json)) {
+        if (TRI_FindAttributeJsonScanner(res->answer->body(), res->answer->bodySize(), "count", &value, &length)) {
           // add to the total
-          result += JsonHelper::getNumericValue<uint64_t>(json, "count", 0);
+          result += static_cast<uint64_t>(TRI_DoubleString(string(value, length).c_str()));
           nrok++;
         }
-
-        if (json != 0) {
-          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
-        }
       }
     }
     delete res;
@@ -1022,9 +1034,11 @@ int getAllDocumentsOnCoordinator (
   responseCode = triagens::rest::HttpResponse::OK;
   contentType = "application/json; charset=utf-8";
 
-  triagens::basics::Json result(triagens::basics::Json::Object);
-  triagens::basics::Json documents(triagens::basics::Json::Array);
-  
+  // the documents of the shards are copied into the result as they are,
+  // without parsing them
+  resultBody = "{\"documents\":[";
+  bool first = true;
+
   for (count = (int) shards.size(); count > 0; count--) {
     res = cc->wait( "", coordTransactionID, 0, "", 0.0);
     if (res->status == CL_COMM_TIMEOUT) {
@@ -1039,36 +1053,38 @@ int getAllDocumentsOnCoordinator (
       return TRI_ERROR_INTERNAL;
     }
 
-    std::unique_ptr<TRI_json_t> shardResult(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, res->answer->body()));
+    char const* docs;
+    size_t length;
 
-    if (shardResult == nullptr || ! TRI_IsObjectJson(shardResult.get())) {
+    if (! TRI_FindAttributeJsonScanner(res->answer->body(), res->answer->bodySize(), "documents", &docs, &length) ||
+        length < 2 ||
+        docs[0] != '[') {
       delete res;
+      cc->drop( "", coordTransactionID, 0, "");
       return TRI_ERROR_INTERNAL;
     }
 
-    auto docs = TRI_LookupObjectJson(shardResult.get(), "documents");
+    // strip the brackets of the array
+    ++docs;
+    length -= 2;
 
-    if (! TRI_IsArrayJson(docs)) {
-      delete res;
-      return TRI_ERROR_INTERNAL;
+    while (length > 0 && isspace(static_cast<unsigned char>(*docs))) {
+      ++docs;
+      --length;
     }
 
-    size_t const n = TRI_LengthArrayJson(docs);
-    documents.reserve(n);
-
-    for (size_t j = 0; j < n; ++j) {
-      auto doc = static_cast<TRI_json_t*>(TRI_AtVector(&docs->_value._objects, j));
-
-      // this will transfer the ownership for the JSON into "documents"
-      documents.transfer(doc);
+    if (length > 0) {
+      if (! first) {
+        resultBody.push_back(',');
+      }
+      resultBody.append(docs, length);
+      first = false;
     }
 
     delete res;
   }
   
-  result("documents", documents);
-
-  resultBody = triagens::basics::JsonHelper::toString(result.json()); 
+  resultBody.append("]}");
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -1364,6 +1380,571 @@ int createEdgeOnCoordinator (
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the request for one document of a batch operation. parts without
+/// a shard are not sent
+////////////////////////////////////////////////////////////////////////////////
+
+struct BatchPart {
+  ShardID shard;
+  std::string path;
+  std::string body;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the document results from the answer of a DB server to a
+/// batch request. the Content-Id of a part is the position of its document
+////////////////////////////////////////////////////////////////////////////////
+
+static void ParseBatchAnswer (ShardID const& shardID,
+                              vector<BatchPart> const& parts,
+                              char const* data,
+                              size_t length,
+                              vector<ClusterDocumentResult>& results,
+                              vector<bool>& answered) {
+  std::string const answer(data, length);
+  size_t pos = 0;
+
+  while (true) {
+    pos = answer.find("Content-Id: ", pos);
+
+    if (pos == std::string::npos) {
+      return;
+    }
+
+    pos += 12;
+    size_t const idEnd = answer.find("\r\n", pos);
+    size_t const statusStart = answer.find("\r\n\r\n", pos);
+
+    if (idEnd == std::string::npos || statusStart == std::string::npos) {
+      return;
+    }
+
+    size_t const id = static_cast<size_t>(StringUtils::uint64(answer.substr(pos, idEnd - pos)));
+
+    // the part is a complete HTTP response
+    size_t const statusEnd = answer.find("\r\n", statusStart + 4);
+    size_t const headerEnd = answer.find("\r\n\r\n", statusStart + 4);
+
+    if (statusEnd == std::string::npos || headerEnd == std::string::npos) {
+      return;
+    }
+
+    std::string const statusLine = answer.substr(statusStart + 4, statusEnd - statusStart - 4);
+    size_t const space = statusLine.find(' ');
+
+    if (space == std::string::npos) {
+      return;
+    }
+
+    map<string, string> headers;
+    size_t bodyLength = 0;
+    size_t lineStart = statusEnd + 2;
+
+    while (lineStart < headerEnd) {
+      size_t lineEnd = answer.find("\r\n", lineStart);
+
+      if (lineEnd == std::string::npos || lineEnd > headerEnd) {
+        lineEnd = headerEnd;
+      }
+
+      std::string const line = answer.substr(lineStart, lineEnd - lineStart);
+      size_t const colon = line.find(':');
+
+      if (colon != std::string::npos) {
+        std::string const key = StringUtils::tolower(StringUtils::trim(line.substr(0, colon)));
+        std::string const value = StringUtils::trim(line.substr(colon + 1));
+
+        if (key == "content-length") {
+          bodyLength = static_cast<size_t>(StringUtils::uint64(value));
+        }
+        else {
+          headers[key] = value;
+        }
+      }
+
+      lineStart = lineEnd + 2;
+    }
+
+    size_t const bodyStart = headerEnd + 4;
+
+    if (bodyStart + bodyLength > answer.size()) {
+      return;
+    }
+
+    if (id < parts.size() && parts[id].shard == shardID) {
+      ClusterDocumentResult& result = results[id];
+
+      result.errorCode = TRI_ERROR_NO_ERROR;
+      result.responseCode = static_cast<HttpResponse::HttpResponseCode>(StringUtils::int32(statusLine.substr(space + 1, 3)));
+      result.resultHeaders.swap(headers);
+      result.resultBody = answer.substr(bodyStart, bodyLength);
+      answered[id] = true;
+    }
+
+    pos = bodyStart + bodyLength;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends the parts of a batch operation to their shards
+///
+/// every shard gets one /_api/batch request with its parts in their original
+/// order, so operations on the same document are executed in order. the
+/// requests to the shards are sent in parallel
+////////////////////////////////////////////////////////////////////////////////
+
+static void ExecuteBatchParts (string const& dbname,
+                               HttpRequest::HttpRequestType reqType,
+                               vector<BatchPart> const& parts,
+                               map<string, string> const& headers,
+                               vector<ClusterDocumentResult>& results) {
+  TRI_ASSERT(parts.size() == results.size());
+
+  map<ShardID, vector<size_t>> shards;
+
+  for (size_t i = 0; i < parts.size(); ++i) {
+    if (! parts[i].shard.empty()) {
+      shards[parts[i].shard].push_back(i);
+    }
+  }
+
+  if (shards.empty()) {
+    return;
+  }
+
+  ClusterComm* cc = ClusterComm::instance();
+  CoordTransactionID coordTransactionID = TRI_NewTickServer();
+
+  string const boundary = "XXXarangocoordinatorbatch" + StringUtils::itoa(coordTransactionID) + "XXX";
+  string const method = HttpRequest::translateMethod(reqType);
+
+  for (auto const& it : shards) {
+    string* body = new string();
+
+    for (auto const i : it.second) {
+      body->append("--" + boundary + "\r\nContent-Type: " + HttpRequest::BatchContentType +
+                   "\r\nContent-Id: " + StringUtils::itoa(i) + "\r\n\r\n");
+      body->append(method + " " + parts[i].path + " HTTP/1.1\r\n\r\n");
+      body->append(parts[i].body);
+      body->append("\r\n");
+    }
+
+    body->append("--" + boundary + "--\r\n");
+
+    map<string, string>* headersCopy = new map<string, string>(headers);
+    (*headersCopy)["content-type"] = HttpRequest::MultiPartContentType + "; boundary=" + boundary;
+
+    ClusterCommResult* res = cc->asyncRequest("", coordTransactionID, "shard:" + it.first,
+                                              HttpRequest::HTTP_REQUEST_POST,
+                                              "/_db/" + StringUtils::urlEncode(dbname) + "/_api/batch",
+                                              body,
+                                              true,
+                                              headersCopy,
+                                              nullptr,
+                                              120.0);
+    delete res;
+  }
+
+  vector<bool> answered(parts.size(), false);
+
+  for (size_t count = shards.size(); count > 0; --count) {
+    ClusterCommResult* res = cc->wait("", coordTransactionID, 0, "", 0.0);
+    auto it = shards.find(res->shardID);
+
+    if (it != shards.end()) {
+      vector<size_t> const& positions = (*it).second;
+
+      if (res->status == CL_COMM_RECEIVED &&
+          res->answer_code == HttpResponse::OK) {
+        ParseBatchAnswer(res->shardID,
+                         parts,
+                         res->answer->body(),
+                         res->answer->bodySize(),
+                         results,
+                         answered);
+      }
+
+      for (auto const i : positions) {
+        if (answered[i]) {
+          continue;
+        }
+
+        ClusterDocumentResult& result = results[i];
+
+        if (res->status == CL_COMM_TIMEOUT) {
+          result.errorCode = TRI_ERROR_CLUSTER_TIMEOUT;
+        }
+        else if (res->status != CL_COMM_RECEIVED) {
+          result.errorCode = TRI_ERROR_CLUSTER_CONNECTION_LOST;
+        }
+        else if (res->answer_code != HttpResponse::OK) {
+          // the whole batch failed, report its error for every document
+          result.errorCode = TRI_ERROR_NO_ERROR;
+          result.responseCode = res->answer_code;
+          result.resultHeaders = res->answer->headers();
+          result.resultBody = string(res->answer->body(), res->answer->bodySize());
+        }
+        else {
+          // the DB server did not answer for this document
+          result.errorCode = TRI_ERROR_INTERNAL;
+        }
+      }
+    }
+
+    delete res;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the documents of a batch operation
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeDocuments (vector<TRI_json_t*>& documents) {
+  for (auto& json : documents) {
+    if (json != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+      json = nullptr;
+    }
+  }
+
+  documents.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates many documents or edges in a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+int createDocumentsOnCoordinator (
+                 string const& dbname,
+                 string const& collname,
+                 bool waitForSync,
+                 vector<TRI_json_t*>& documents,
+                 map<string, string> const& headers,
+                 vector<ClusterDocumentResult>& results) {
+
+  ClusterInfo* ci = ClusterInfo::instance();
+
+  results.clear();
+  results.resize(documents.size());
+
+  // First determine the collection ID from the name:
+  shared_ptr<CollectionInfo> collinfo = ci->getCollection(dbname, collname);
+
+  if (collinfo->empty()) {
+    FreeDocuments(documents);
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  string const collid = StringUtils::itoa(collinfo->id());
+  bool const isEdgeCollection = (collinfo->type() == TRI_COL_TYPE_EDGE);
+
+  // the keys of the documents without _key are taken from one range of
+  // cluster-wide unique numbers, see createDocumentOnCoordinator
+  uint64_t missingKeys = 0;
+
+  for (auto const json : documents) {
+    if (TRI_IsObjectJson(json) &&
+        TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_KEY) == nullptr) {
+      ++missingKeys;
+    }
+  }
+
+  uint64_t uid = 0;
+
+  if (missingKeys > 0) {
+    uid = ci->uniqid(missingKeys);
+
+    if (uid == 0) {
+      FreeDocuments(documents);
+      return TRI_ERROR_CLUSTER_COULD_NOT_DETERMINE_ID;
+    }
+  }
+
+  string const syncstr = string("&waitForSync=") + (waitForSync ? "true" : "false");
+  vector<BatchPart> parts(documents.size());
+
+  for (size_t i = 0; i < documents.size(); ++i) {
+    TRI_json_t* json = documents[i];
+    ClusterDocumentResult& result = results[i];
+
+    if (! TRI_IsObjectJson(json)) {
+      result.errorCode = TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID;
+      continue;
+    }
+
+    bool userSpecifiedKey = true;
+
+    if (TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_KEY) == nullptr) {
+      string const key = StringUtils::itoa(uid++);
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_KEY,
+                            TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, key.c_str(), key.size()));
+      userSpecifiedKey = false;
+    }
+
+    bool usesDefaultShardingAttributes;
+    ShardID shardID;
+    int error = ci->getResponsibleShard(collid, json, true, shardID,
+                                        usesDefaultShardingAttributes);
+
+    if (error == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      result.errorCode = TRI_ERROR_CLUSTER_SHARD_GONE;
+      continue;
+    }
+
+    if (userSpecifiedKey &&
+        (! usesDefaultShardingAttributes || ! collinfo->allowUserKeys())) {
+      result.errorCode = TRI_ERROR_CLUSTER_MUST_NOT_SPECIFY_KEY;
+      continue;
+    }
+
+    BatchPart& part = parts[i];
+
+    if (isEdgeCollection) {
+      // the vertices are passed in the URL, as in createEdgeOnCoordinator
+      TRI_json_t const* from = TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_FROM);
+      TRI_json_t const* to = TRI_LookupObjectJson(json, TRI_VOC_ATTRIBUTE_TO);
+
+      if (! TRI_IsStringJson(from) || ! TRI_IsStringJson(to)) {
+        result.errorCode = TRI_ERROR_ARANGO_INVALID_EDGE_ATTRIBUTE;
+        continue;
+      }
+
+      part.path = "/_api/edge?collection=" + StringUtils::urlEncode(shardID) + syncstr +
+                  "&from=" + StringUtils::urlEncode(from->_value._string.data) +
+                  "&to=" + StringUtils::urlEncode(to->_value._string.data);
+
+      TRI_DeleteObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_FROM);
+      TRI_DeleteObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_TO);
+    }
+    else {
+      part.path = "/_api/document?collection=" + StringUtils::urlEncode(shardID) + syncstr;
+    }
+
+    part.shard = shardID;
+    part.body = JsonHelper::toString(json);
+  }
+
+  FreeDocuments(documents);
+
+  ExecuteBatchParts(dbname, HttpRequest::HTTP_REQUEST_POST, parts, headers, results);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes many documents in a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+int deleteDocumentsOnCoordinator (
+                 string const& dbname,
+                 string const& collname,
+                 vector<string> const& keys,
+                 vector<TRI_voc_rid_t> const& revs,
+                 TRI_doc_update_policy_e policy,
+                 bool waitForSync,
+                 map<string, string> const& headers,
+                 vector<ClusterDocumentResult>& results) {
+
+  TRI_ASSERT(revs.empty() || revs.size() == keys.size());
+
+  ClusterInfo* ci = ClusterInfo::instance();
+
+  results.clear();
+  results.resize(keys.size());
+
+  // First determine the collection ID from the name:
+  shared_ptr<CollectionInfo> collinfo = ci->getCollection(dbname, collname);
+
+  if (collinfo->empty()) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  string const collid = StringUtils::itoa(collinfo->id());
+
+  string policystr;
+  if (policy == TRI_DOC_UPDATE_LAST_WRITE) {
+    policystr = "&policy=last";
+  }
+
+  vector<BatchPart> parts(keys.size());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    string const& key = keys[i];
+    TRI_voc_rid_t const rev = (revs.empty() ? 0 : revs[i]);
+
+    TRI_json_t* json = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE);
+
+    if (json == nullptr) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_KEY,
+                          TRI_CreateStringReferenceJson(TRI_UNKNOWN_MEM_ZONE,
+                                                        key.c_str(), key.size()));
+    bool usesDefaultShardingAttributes;
+    ShardID shardID;
+    int error = ci->getResponsibleShard(collid, json, true, shardID,
+                                        usesDefaultShardingAttributes);
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    if (! usesDefaultShardingAttributes) {
+      // all shards have to be asked for every document
+      ClusterDocumentResult& result = results[i];
+      result.errorCode = deleteDocumentOnCoordinator(dbname, collname, key, rev, policy,
+                                                     waitForSync, headers,
+                                                     result.responseCode,
+                                                     result.resultHeaders,
+                                                     result.resultBody);
+      continue;
+    }
+
+    if (error == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      results[i].errorCode = TRI_ERROR_CLUSTER_SHARD_GONE;
+      continue;
+    }
+
+    BatchPart& part = parts[i];
+    part.shard = shardID;
+    part.path = "/_api/document/" + StringUtils::urlEncode(shardID) + "/" + StringUtils::urlEncode(key) +
+                "?waitForSync=" + (waitForSync ? "true" : "false") + policystr;
+
+    if (rev != 0) {
+      part.path += "&rev=" + StringUtils::itoa(rev);
+    }
+  }
+
+  ExecuteBatchParts(dbname, HttpRequest::HTTP_REQUEST_DELETE, parts, headers, results);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief modifies many documents in a coordinator
+///
+/// documents that cannot be sent to a single shard, or that were not found on
+/// their shard in a collection with custom sharding attributes, are handled
+/// by modifyDocumentOnCoordinator, which asks all shards
+////////////////////////////////////////////////////////////////////////////////
+
+int modifyDocumentsOnCoordinator (
+                 string const& dbname,
+                 string const& collname,
+                 vector<string> const& keys,
+                 vector<TRI_voc_rid_t> const& revs,
+                 TRI_doc_update_policy_e policy,
+                 bool waitForSync,
+                 bool isPatch,
+                 bool keepNull,
+                 bool mergeObjects,
+                 vector<TRI_json_t*>& documents,
+                 map<string, string> const& headers,
+                 vector<ClusterDocumentResult>& results) {
+
+  TRI_ASSERT(keys.size() == documents.size());
+  TRI_ASSERT(revs.empty() || revs.size() == keys.size());
+
+  ClusterInfo* ci = ClusterInfo::instance();
+
+  results.clear();
+  results.resize(documents.size());
+
+  // First determine the collection ID from the name:
+  shared_ptr<CollectionInfo> collinfo = ci->getCollection(dbname, collname);
+
+  if (collinfo->empty()) {
+    FreeDocuments(documents);
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
+  string const collid = StringUtils::itoa(collinfo->id());
+
+  string optionstr = string("?waitForSync=") + (waitForSync ? "true" : "false");
+  if (isPatch) {
+    if (! keepNull) {
+      optionstr += "&keepNull=false";
+    }
+    optionstr += string("&mergeObjects=") + (mergeObjects ? "true" : "false");
+  }
+  if (policy == TRI_DOC_UPDATE_LAST_WRITE) {
+    optionstr += "&policy=last";
+  }
+
+  vector<BatchPart> parts(documents.size());
+  // documents that may need all shards
+  vector<bool> retry(documents.size(), false);
+
+  for (size_t i = 0; i < documents.size(); ++i) {
+    TRI_json_t* json = documents[i];
+    TRI_voc_rid_t const rev = (revs.empty() ? 0 : revs[i]);
+
+    if (! TRI_IsObjectJson(json)) {
+      results[i].errorCode = TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID;
+      continue;
+    }
+
+    bool usesDefaultShardingAttributes;
+    ShardID shardID;
+    int error = ci->getResponsibleShard(collid, json, ! isPatch, shardID,
+                                        usesDefaultShardingAttributes);
+
+    if (error == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      results[i].errorCode = error;
+      continue;
+    }
+
+    retry[i] = ! usesDefaultShardingAttributes;
+
+    if (isPatch &&
+        error == TRI_ERROR_CLUSTER_NOT_ALL_SHARDING_ATTRIBUTES_GIVEN) {
+      // the slow path only
+      continue;
+    }
+
+    BatchPart& part = parts[i];
+    part.shard = shardID;
+    part.path = "/_api/document/" + StringUtils::urlEncode(shardID) + "/" + StringUtils::urlEncode(keys[i]) +
+                optionstr;
+
+    if (rev != 0) {
+      part.path += "&rev=" + StringUtils::itoa(rev);
+    }
+
+    part.body = JsonHelper::toString(json);
+  }
+
+  ExecuteBatchParts(dbname,
+                    isPatch ? HttpRequest::HTTP_REQUEST_PATCH : HttpRequest::HTTP_REQUEST_PUT,
+                    parts,
+                    headers,
+                    results);
+
+  for (size_t i = 0; i < documents.size(); ++i) {
+    ClusterDocumentResult& result = results[i];
+
+    if (retry[i] &&
+        (parts[i].shard.empty() || result.responseCode >= HttpResponse::BAD) &&
+        result.errorCode == TRI_ERROR_NO_ERROR) {
+      // the single-document variant takes over the document
+      TRI_json_t* json = documents[i];
+      documents[i] = nullptr;
+
+      result.errorCode = modifyDocumentOnCoordinator(dbname, collname, keys[i],
+                                                     (revs.empty() ? 0 : revs[i]),
+                                                     policy, waitForSync, isPatch,
+                                                     keepNull, mergeObjects, json,
+                                                     headers,
+                                                     result.responseCode,
+                                                     result.resultHeaders,
+                                                     result.resultBody);
+    }
+  }
+
+  FreeDocuments(documents);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief flush Wal on all DBservers
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,6 +50,28 @@ struct TRI_vector_pointer_s;
 namespace triagens {
   namespace arango {
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the result for one document of a batch operation on a coordinator
+///
+/// errorCode is what the single-document function would have returned. if
+/// it is TRI_ERROR_NO_ERROR, the other attributes hold the answer of the
+/// responsible DB server, which may report an error itself
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ClusterDocumentResult {
+      ClusterDocumentResult ()
+        : errorCode(TRI_ERROR_NO_ERROR),
+          responseCode(triagens::rest::HttpResponse::OK),
+          resultHeaders(),
+          resultBody() {
+      }
+
+      int errorCode;
+      triagens::rest::HttpResponse::HttpResponseCode responseCode;
+      std::map<std::string, std::string> resultHeaders;
+      std::string resultBody;
+    };
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief merge headers of a DB server response into the current response
 ////////////////////////////////////////////////////////////////////////////////
@@ -199,6 +221,60 @@ namespace triagens {
                  std::map<std::string, std::string>& resultHeaders,
                  std::string& resultBody);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates many documents or edges in a coordinator
+///
+/// the documents are grouped by their responsible shard, and every shard
+/// gets all of its documents in one batch request. the shards are contacted
+/// in parallel. the documents of edge collections must contain _from and _to.
+/// takes over the documents. results has one entry per document, in the
+/// order of the documents
+////////////////////////////////////////////////////////////////////////////////
+
+    int createDocumentsOnCoordinator (
+                 std::string const& dbname,
+                 std::string const& collname,
+                 bool waitForSync,
+                 std::vector<TRI_json_t*>& documents,
+                 std::map<std::string, std::string> const& headers,
+                 std::vector<ClusterDocumentResult>& results);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes many documents in a coordinator, see
+/// createDocumentsOnCoordinator. revs is either empty or has one entry per
+/// key
+////////////////////////////////////////////////////////////////////////////////
+
+    int deleteDocumentsOnCoordinator (
+                 std::string const& dbname,
+                 std::string const& collname,
+                 std::vector<std::string> const& keys,
+                 std::vector<TRI_voc_rid_t> const& revs,
+                 TRI_doc_update_policy_e policy,
+                 bool waitForSync,
+                 std::map<std::string, std::string> const& headers,
+                 std::vector<ClusterDocumentResult>& results);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief modifies many documents in a coordinator, see
+/// createDocumentsOnCoordinator. revs is either empty or has one entry per
+/// key. takes over the documents
+////////////////////////////////////////////////////////////////////////////////
+
+    int modifyDocumentsOnCoordinator (
+                 std::string const& dbname,
+                 std::string const& collname,
+                 std::vector<std::string> const& keys,
+                 std::vector<TRI_voc_rid_t> const& revs,
+                 TRI_doc_update_policy_e policy,
+                 bool waitForSync,
+                 bool isPatch,
+                 bool keepNull,   // only counts for isPatch == true
+                 bool mergeObjects,   // only counts for isPatch == true
+                 std::vector<TRI_json_t*>& documents,
+                 std::map<std::string, std::string> const& headers,
+                 std::vector<ClusterDocumentResult>& results);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief truncate a cluster collection on a coordinator
 ////////////////////////////////////////////////////////////////////////////////
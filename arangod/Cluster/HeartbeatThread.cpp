@@ -153,6 +153,9 @@ void HeartbeatThread::runDBServer () {
     // we don't care if this fails
     sendState();
 
+    // make sure the next range of unique ids is there before it is needed
+    ClusterInfo::instance()->prefetchUniqids();
+
     if (_stop) {
       break;
     }
@@ -162,6 +165,7 @@ void HeartbeatThread::runDBServer () {
       AgencyCommResult result = _agency.getValues("Sync/Commands/" + _myId, false);
 
       if (result.successful()) {
+        result.parse("", false);
         handleStateChange(result, lastCommandIndex);
       }
     }
@@ -303,17 +307,22 @@ void HeartbeatThread::runCoordinator () {
     // we don't care if this fails
     sendState();
 
+    // make sure the next range of unique ids is there before it is needed
+    ClusterInfo::instance()->prefetchUniqids();
+
     if (_stop) {
       break;
     }
 
-    {
-      // send an initial GET request to Sync/Commands/my-id
-      AgencyCommResult result = _agency.getValues("Sync/Commands/" + _myId, false);
+    // fetch Sync/Commands/my-id and Sync/UserVersion with one request
+    AgencyCommResult syncResult = _agency.getValues(std::vector<std::string>({
+      "Sync/Commands/" + _myId,
+      "Sync/UserVersion"
+    }));
 
-      if (result.successful()) {
-        handleStateChange(result, lastCommandIndex);
-      }
+    if (syncResult.successful()) {
+      syncResult.parse("", false);
+      handleStateChange(syncResult, lastCommandIndex);
     }
 
     if (_stop) {
@@ -342,14 +351,10 @@ void HeartbeatThread::runCoordinator () {
       }
     }
 
-    result.clear();
-
-    result = _agency.getValues("Sync/UserVersion", false);
-    if (result.successful()) {
-      result.parse("", false);
+    if (syncResult.successful()) {
       std::map<std::string, AgencyCommResultEntry>::iterator it
-          = result._values.begin();
-      if (it != result._values.end()) {
+          = syncResult._values.find("Sync/UserVersion");
+      if (it != syncResult._values.end()) {
         // there is a UserVersion
         uint64_t userVersion = triagens::basics::JsonHelper::stringUInt64((*it).second._json);
         if (userVersion != oldUserVersion) {
@@ -659,13 +664,12 @@ bool HeartbeatThread::handlePlanChangeDBServer (uint64_t currentPlanVersion) {
 /// when this is called, it will update the index value of the last command
 /// (we'll pass the updated index value to the next watches so we don't get
 /// notified about this particular change again).
+/// the result must have been parsed without a key prefix
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HeartbeatThread::handleStateChange (AgencyCommResult& result,
                                          uint64_t& lastCommandIndex) {
-  result.parse("Sync/Commands/", false);
-
-  std::map<std::string, AgencyCommResultEntry>::const_iterator it = result._values.find(_myId);
+  std::map<std::string, AgencyCommResultEntry>::const_iterator it = result._values.find("Sync/Commands/" + _myId);
 
   if (it != result._values.end()) {
     lastCommandIndex = (*it).second._index;
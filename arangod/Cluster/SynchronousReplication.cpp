@@ -0,0 +1,452 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief synchronous replication of shards from leaders to followers
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SynchronousReplication.h"
+#include "Basics/ConditionLocker.h"
+#include "Basics/logging.h"
+#include "Basics/StringUtils.h"
+#include "Basics/StringBuffer.h"
+#include "Cluster/ClusterComm.h"
+#include "Cluster/ServerState.h"
+#include "Utils/CollectionNameResolver.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/replication-common.h"
+#include "VocBase/server.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timeout for a batch sent to a follower
+////////////////////////////////////////////////////////////////////////////////
+
+static double const FollowerTimeout = 120.0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+struct SynchronousReplication::ShardQueue {
+  enum class State {
+    PENDING,
+    COMMITTED,
+    CANCELLED
+  };
+
+  struct Entry {
+    uint64_t    _id;
+    std::string _line;
+    State       _state;
+  };
+
+  ShardQueue (std::string const& database,
+              ShardID const& shard)
+    : _database(database),
+      _shard(shard),
+      _entries(),
+      _results(),
+      _sending(false) {
+  }
+
+  std::string const                  _database;
+  ShardID const                      _shard;
+  std::deque<Entry>                  _entries;
+  std::unordered_map<uint64_t, int>  _results;
+  bool                               _sending;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class SynchronousReplication
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+SynchronousReplication::SynchronousReplication ()
+  : _condition(),
+    _queues(),
+    _lastId(0) {
+}
+
+SynchronousReplication::~SynchronousReplication () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the instance
+////////////////////////////////////////////////////////////////////////////////
+
+SynchronousReplication* SynchronousReplication::instance () {
+  static SynchronousReplication Instance;
+
+  return &Instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues the insert or update of a document
+////////////////////////////////////////////////////////////////////////////////
+
+void SynchronousReplication::enqueueDocument (std::string const& database,
+                                              CollectionNameResolver const* resolver,
+                                              TRI_document_collection_t* document,
+                                              TRI_doc_mptr_t const* mptr,
+                                              ReplicationTicket& ticket) {
+  if (! isReplicated(document)) {
+    return;
+  }
+
+  auto marker = static_cast<TRI_df_marker_t const*>(mptr->getDataPtr());  // PROTECTED by trx of caller
+  char const* key = TRI_EXTRACT_MARKER_KEY(marker);
+  TRI_voc_rid_t const rid = TRI_EXTRACT_MARKER_RID(marker);
+  bool const isEdge = TRI_IS_EDGE_MARKER(marker);
+
+  // same format as in a collection dump, keys do not need escaping
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+  buffer.appendText("{\"type\":");
+  buffer.appendInteger(static_cast<uint64_t>(isEdge ? REPLICATION_MARKER_EDGE : REPLICATION_MARKER_DOCUMENT));
+  buffer.appendText(",\"key\":\"");
+  buffer.appendText(key);
+  buffer.appendText("\",\"rev\":\"");
+  buffer.appendInteger(rid);
+  buffer.appendText("\",\"data\":{\"" TRI_VOC_ATTRIBUTE_KEY "\":\"");
+  buffer.appendText(key);
+  buffer.appendText("\",\"" TRI_VOC_ATTRIBUTE_REV "\":\"");
+  buffer.appendInteger(rid);
+  buffer.appendChar('"');
+
+  if (isEdge) {
+    // the follower resolves the cluster-wide collection names
+    buffer.appendText(",\"" TRI_VOC_ATTRIBUTE_FROM "\":\"");
+    buffer.appendText(resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)));
+    buffer.appendChar('/');
+    buffer.appendText(TRI_EXTRACT_MARKER_FROM_KEY(marker));
+    buffer.appendText("\",\"" TRI_VOC_ATTRIBUTE_TO "\":\"");
+    buffer.appendText(resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)));
+    buffer.appendChar('/');
+    buffer.appendText(TRI_EXTRACT_MARKER_TO_KEY(marker));
+    buffer.appendChar('"');
+  }
+
+  TRI_shaped_json_t shaped;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+  TRI_StringifyArrayShapedJson(document->getShaper(), buffer.stringBuffer(), &shaped, true);  // PROTECTED by trx of caller
+
+  buffer.appendText("}}\n");
+
+  enqueue(database, document->_info._name, std::string(buffer.c_str(), buffer.length()), ticket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues the removal of a document
+////////////////////////////////////////////////////////////////////////////////
+
+void SynchronousReplication::enqueueRemove (std::string const& database,
+                                            TRI_document_collection_t* document,
+                                            std::string const& key,
+                                            TRI_voc_rid_t rid,
+                                            ReplicationTicket& ticket) {
+  if (! isReplicated(document)) {
+    return;
+  }
+
+  std::string line("{\"type\":");
+  line.append(StringUtils::itoa(static_cast<uint64_t>(REPLICATION_MARKER_REMOVE)));
+  line.append(",\"key\":\"");
+  line.append(key);
+  line.append("\",\"rev\":\"");
+  line.append(StringUtils::itoa(rid));
+  line.append("\"}\n");
+
+  enqueue(database, document->_info._name, std::move(line), ticket);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a shard has followers
+////////////////////////////////////////////////////////////////////////////////
+
+bool SynchronousReplication::hasFollowers (ShardID const& shard) {
+  uint32_t writeConcern;
+  auto followers = ClusterInfo::instance()->getShardFollowers(shard, writeConcern);
+
+  return (followers != nullptr && ! followers->empty());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether write operations on a collection may have to be replicated
+////////////////////////////////////////////////////////////////////////////////
+
+bool SynchronousReplication::isReplicated (TRI_document_collection_t const* document) {
+  return (ServerState::instance()->isDBServer() &&
+          hasFollowers(document->_info._name));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues an operation on a shard
+////////////////////////////////////////////////////////////////////////////////
+
+void SynchronousReplication::enqueue (std::string const& database,
+                                      ShardID const& shard,
+                                      std::string&& line,
+                                      ReplicationTicket& ticket) {
+  TRI_ASSERT(ticket.empty());
+
+  CONDITION_LOCKER(guard, _condition);
+
+  std::string const name = database + "/" + shard;
+  auto it = _queues.find(name);
+
+  if (it == _queues.end()) {
+    it = _queues.emplace(name, std::unique_ptr<ShardQueue>(new ShardQueue(database, shard))).first;
+  }
+
+  ticket._shard = (*it).second.get();
+  ticket._id = ++_lastId;
+
+  ticket._shard->_entries.emplace_back(ShardQueue::Entry({ ticket._id, std::move(line), ShardQueue::State::PENDING }));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marks an operation as committed or cancelled, and waits for the
+/// result of a committed one
+////////////////////////////////////////////////////////////////////////////////
+
+int SynchronousReplication::finish (ReplicationTicket& ticket,
+                                    bool committed) {
+  ShardQueue* queue = ticket._shard;
+  uint64_t const id = ticket._id;
+
+  ticket._shard = nullptr;
+  ticket._id = 0;
+
+  CONDITION_LOCKER(guard, _condition);
+
+  for (auto& entry : queue->_entries) {
+    if (entry._id == id) {
+      entry._state = (committed ? ShardQueue::State::COMMITTED : ShardQueue::State::CANCELLED);
+      break;
+    }
+  }
+
+  if (! committed) {
+    // a sender may be waiting for this entry to be decided
+    guard.broadcast();
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  while (true) {
+    auto it = queue->_results.find(id);
+
+    if (it != queue->_results.end()) {
+      int res = (*it).second;
+      queue->_results.erase(it);
+
+      return res;
+    }
+
+    if (! queue->_sending &&
+        ! queue->_entries.empty() &&
+        queue->_entries.front()._state != ShardQueue::State::PENDING) {
+      // take over all decided operations at the head of the queue
+      std::string batch;
+      std::vector<uint64_t> ids;
+
+      while (! queue->_entries.empty() &&
+             queue->_entries.front()._state != ShardQueue::State::PENDING) {
+        auto& entry = queue->_entries.front();
+
+        if (entry._state == ShardQueue::State::COMMITTED) {
+          batch.append(entry._line);
+          ids.emplace_back(entry._id);
+        }
+
+        queue->_entries.pop_front();
+      }
+
+      queue->_sending = true;
+      guard.unlock();
+
+      int res = TRI_ERROR_NO_ERROR;
+
+      if (! batch.empty()) {
+        res = send(queue->_database, queue->_shard, batch);
+      }
+
+      guard.lock();
+      queue->_sending = false;
+
+      for (auto const& other : ids) {
+        queue->_results.emplace(other, res);
+      }
+
+      guard.broadcast();
+      continue;
+    }
+
+    guard.wait();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a batch to the followers of a shard and waits until the write
+/// concern is reached
+///
+/// the batch goes out to all followers at once. as soon as enough followers
+/// acknowledged it, the remaining answers are dropped, so a slow follower
+/// does not hold up the leader
+////////////////////////////////////////////////////////////////////////////////
+
+int SynchronousReplication::send (std::string const& database,
+                                  ShardID const& shard,
+                                  std::string const& batch) {
+  uint32_t writeConcern;
+  auto followers = ClusterInfo::instance()->getShardFollowers(shard, writeConcern);
+
+  if (followers == nullptr || followers->empty()) {
+    // the followers were removed from the plan in the meantime
+    return (writeConcern > 1 ? TRI_ERROR_CLUSTER_WRITE_CONCERN_NOT_REACHED : TRI_ERROR_NO_ERROR);
+  }
+
+  ClusterComm* cc = ClusterComm::instance();
+  CoordTransactionID const coordTransactionID = TRI_NewTickServer();
+
+  std::string const path = "/_db/" + StringUtils::urlEncode(database) +
+                           "/_api/replication/restore-data?collection=" +
+                           StringUtils::urlEncode(shard) +
+                           "&recycleIds=true";
+
+  for (auto const& follower : *followers) {
+    auto headers = new std::map<std::string, std::string>;
+
+    // answers that are dropped may arrive after we have returned, so every
+    // request owns its body
+    ClusterCommResult* res = cc->asyncRequest("", coordTransactionID, "server:" + follower,
+                                              triagens::rest::HttpRequest::HTTP_REQUEST_PUT,
+                                              path,
+                                              new std::string(batch),
+                                              true,
+                                              headers,
+                                              nullptr,
+                                              FollowerTimeout);
+    delete res;
+  }
+
+  // the leader itself counts for the write concern
+  size_t const needed = (writeConcern > 1 ? writeConcern - 1 : 0);
+  size_t acknowledged = 0;
+  size_t answered = 0;
+
+  while (acknowledged < needed && answered < followers->size()) {
+    ClusterCommResult* res = cc->wait("", coordTransactionID, 0, "", FollowerTimeout);
+    ++answered;
+
+    if (res->status == CL_COMM_RECEIVED &&
+        res->answer_code == triagens::rest::HttpResponse::OK) {
+      ++acknowledged;
+    }
+    else {
+      LOG_WARNING("could not replicate operations on shard '%s' to follower '%s'",
+                  shard.c_str(),
+                  res->serverID.c_str());
+    }
+
+    delete res;
+  }
+
+  if (answered < followers->size()) {
+    cc->drop("", coordTransactionID, 0, "");
+  }
+
+  if (acknowledged < needed) {
+    return TRI_ERROR_CLUSTER_WRITE_CONCERN_NOT_REACHED;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class ReplicationTicket
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+ReplicationTicket::ReplicationTicket ()
+  : _shard(nullptr),
+    _id(0) {
+}
+
+ReplicationTicket::~ReplicationTicket () {
+  cancel();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the operation for sending and waits for the write concern
+////////////////////////////////////////////////////////////////////////////////
+
+int ReplicationTicket::commit () {
+  if (empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  return SynchronousReplication::instance()->finish(*this, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief drops the operation
+////////////////////////////////////////////////////////////////////////////////
+
+void ReplicationTicket::cancel () {
+  if (! empty()) {
+    SynchronousReplication::instance()->finish(*this, false);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief synchronous replication of shards from leaders to followers
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_CLUSTER_SYNCHRONOUS_REPLICATION_H
+#define ARANGODB_CLUSTER_SYNCHRONOUS_REPLICATION_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Cluster/ClusterInfo.h"
+
+struct TRI_doc_mptr_t;
+struct TRI_document_collection_t;
+
+namespace triagens {
+  namespace arango {
+
+    class CollectionNameResolver;
+    class ReplicationTicket;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class SynchronousReplication
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief forwards the write operations of shard leaders to the followers
+/// listed in the plan
+///
+/// operations are shipped in the dump format of the replication API and are
+/// applied by the followers via /_api/replication/restore-data with their
+/// original keys and revisions. every shard has a queue of operations in
+/// commit order. the first waiter that finds committed operations at the
+/// head of the queue sends all of them as one batch to all followers at
+/// once, so concurrent writers share a round trip, while the operations of
+/// a shard still reach the followers in the order of the leader
+////////////////////////////////////////////////////////////////////////////////
+
+    class SynchronousReplication {
+
+      friend class ReplicationTicket;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the queue of a shard
+////////////////////////////////////////////////////////////////////////////////
+
+        struct ShardQueue;
+
+      public:
+
+        SynchronousReplication (SynchronousReplication const&) = delete;
+        SynchronousReplication& operator= (SynchronousReplication const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      private:
+
+        SynchronousReplication ();
+
+        ~SynchronousReplication ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the instance
+////////////////////////////////////////////////////////////////////////////////
+
+        static SynchronousReplication* instance ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues the insert or update of a document on a DB server. the
+/// document must be protected by the running transaction. does nothing if
+/// the shard has no followers
+////////////////////////////////////////////////////////////////////////////////
+
+        void enqueueDocument (std::string const& database,
+                              CollectionNameResolver const*,
+                              TRI_document_collection_t*,
+                              TRI_doc_mptr_t const*,
+                              ReplicationTicket&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues the removal of a document on a DB server. does nothing if
+/// the shard has no followers
+////////////////////////////////////////////////////////////////////////////////
+
+        void enqueueRemove (std::string const& database,
+                            TRI_document_collection_t*,
+                            std::string const& key,
+                            TRI_voc_rid_t,
+                            ReplicationTicket&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a shard has followers
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool hasFollowers (ShardID const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether write operations on a collection may have to be replicated
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool isReplicated (TRI_document_collection_t const*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues an operation on a shard, given as a line in the dump format
+////////////////////////////////////////////////////////////////////////////////
+
+        void enqueue (std::string const& database,
+                      ShardID const& shard,
+                      std::string&& line,
+                      ReplicationTicket&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marks an operation as committed or cancelled, and waits for the
+/// result of a committed one
+////////////////////////////////////////////////////////////////////////////////
+
+        int finish (ReplicationTicket&,
+                    bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a batch to the followers of a shard and waits until the write
+/// concern is reached
+////////////////////////////////////////////////////////////////////////////////
+
+        static int send (std::string const& database,
+                         ShardID const& shard,
+                         std::string const& batch);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the queues, waiters are woken up when a batch is done
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::ConditionVariable _condition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the queues, by database and shard. queues are never removed, so
+/// tickets can point to them
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<std::string, std::unique_ptr<ShardQueue>> _queues;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the last ticket id handed out
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _lastId;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class ReplicationTicket
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a write operation of a shard leader that is queued for its followers
+///
+/// a ticket is taken inside the write transaction, so the order of the
+/// tickets of a shard is the order of the commits. after the transaction
+/// has finished, commit() waits until the followers acknowledged the
+/// operation. a ticket that is destroyed without commit() is cancelled, so
+/// it never holds up the operations queued behind it
+////////////////////////////////////////////////////////////////////////////////
+
+    class ReplicationTicket {
+
+      friend class SynchronousReplication;
+
+      public:
+
+        ReplicationTicket (ReplicationTicket const&) = delete;
+        ReplicationTicket& operator= (ReplicationTicket const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        ReplicationTicket ();
+
+        ~ReplicationTicket ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether an operation was queued
+////////////////////////////////////////////////////////////////////////////////
+
+        bool empty () const {
+          return _id == 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the operation for sending and waits until the write
+/// concern of the shard is reached. returns TRI_ERROR_NO_ERROR for an empty
+/// ticket
+////////////////////////////////////////////////////////////////////////////////
+
+        int commit ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief drops the operation because its transaction was aborted
+////////////////////////////////////////////////////////////////////////////////
+
+        void cancel ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        SynchronousReplication::ShardQueue* _shard;
+
+        uint64_t _id;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -2038,6 +2038,58 @@ static void JS_Wait (const v8::FunctionCallbackInfo<v8::Value>& args) {
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the round trip time distribution per server
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_Latencies (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  if (args.Length() != 0) {
+    TRI_V8_THROW_EXCEPTION_USAGE("latencies()");
+  }
+
+  ClusterComm* cc = ClusterComm::instance();
+
+  if (cc == nullptr) {
+    TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL,
+                             "clustercomm object not found");
+  }
+
+  auto const latencies = cc->latencyStatistics();
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  for (auto const& it : latencies) {
+    auto const& dist = it.second;
+    v8::Handle<v8::Object> entry = v8::Object::New(isolate);
+
+    entry->Set(TRI_V8_ASCII_STRING("sum"), v8::Number::New(isolate, dist._total));
+    entry->Set(TRI_V8_ASCII_STRING("count"), v8::Number::New(isolate, (double) dist._count));
+
+    v8::Handle<v8::Array> cuts = v8::Array::New(isolate, (int) dist._cuts.size());
+
+    for (uint32_t i = 0;  i < (uint32_t) dist._cuts.size();  ++i) {
+      cuts->Set(i, v8::Number::New(isolate, dist._cuts[i]));
+    }
+
+    v8::Handle<v8::Array> counts = v8::Array::New(isolate, (int) dist._counts.size());
+
+    for (uint32_t i = 0;  i < (uint32_t) dist._counts.size();  ++i) {
+      counts->Set(i, v8::Number::New(isolate, (double) dist._counts[i]));
+    }
+
+    entry->Set(TRI_V8_ASCII_STRING("cuts"), cuts);
+    entry->Set(TRI_V8_ASCII_STRING("counts"), counts);
+
+    result->Set(TRI_V8_STD_STRING(it.first), entry);
+  }
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief drop the result of an asynchronous request
 ////////////////////////////////////////////////////////////////////////////////
@@ -2251,6 +2303,7 @@ void TRI_InitV8Cluster (v8::Isolate* isolate, v8::Handle<v8::Context> context) {
   TRI_AddMethodVocbase(isolate, rt, TRI_V8_ASCII_STRING("enquire"), JS_Enquire);
   TRI_AddMethodVocbase(isolate, rt, TRI_V8_ASCII_STRING("wait"), JS_Wait);
   TRI_AddMethodVocbase(isolate, rt, TRI_V8_ASCII_STRING("drop"), JS_Drop);
+  TRI_AddMethodVocbase(isolate, rt, TRI_V8_ASCII_STRING("latencies"), JS_Latencies);
 
   v8g->ClusterCommTempl.Reset(isolate, rt);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("ArangoClusterCommCtor"), ft->GetFunction(), true);
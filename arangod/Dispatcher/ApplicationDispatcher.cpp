@@ -89,8 +89,10 @@ ApplicationDispatcher::ApplicationDispatcher ()
     _dispatcher(nullptr),
     _dispatcherReporterTask(nullptr),
     _reportInterval(0.0),
+    _overloadQueueTime(0.0),
     _nrStandardThreads(0),
-    _nrAQLThreads(0) {
+    _nrAQLThreads(0),
+    _nrBackgroundThreads(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -157,6 +159,24 @@ void ApplicationDispatcher::buildAQLQueue (size_t nrThreads,
   _nrAQLThreads = nrThreads;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the dispatcher queue for background JavaScript jobs
+////////////////////////////////////////////////////////////////////////////////
+
+void ApplicationDispatcher::buildBackgroundQueue (size_t nrThreads,
+                                                  size_t maxSize) {
+  if (_dispatcher == nullptr) {
+    LOG_FATAL_AND_EXIT("no dispatcher is known, cannot create dispatcher queue");
+  }
+
+  LOG_TRACE("setting up the background queue with %d threads", (int) nrThreads);
+
+  TRI_ASSERT(_dispatcher != nullptr);
+  _dispatcher->addBackgroundQueue(nrThreads, maxSize);
+
+  _nrBackgroundThreads = nrThreads;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief builds an additional dispatcher queue
 ////////////////////////////////////////////////////////////////////////////////
@@ -194,6 +214,16 @@ void ApplicationDispatcher::setProcessorAffinity (const vector<size_t>& cores) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the dispatcher threads over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void ApplicationDispatcher::setNumaAffinity (vector<vector<size_t>> const& nodes) {
+#ifdef TRI_HAVE_THREAD_AFFINITY
+  _dispatcher->setNumaAffinity(Dispatcher::STANDARD_QUEUE, nodes);
+#endif
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        ApplicationFeature methods
 // -----------------------------------------------------------------------------
@@ -205,6 +235,7 @@ void ApplicationDispatcher::setProcessorAffinity (const vector<size_t>& cores) {
 void ApplicationDispatcher::setupOptions (map<string, ProgramOptionsDescription>& options) {
   options["Server Options:help-admin"]
     ("dispatcher.report-interval", &_reportInterval, "dispatcher report interval")
+    ("dispatcher.overload-queue-time", &_overloadQueueTime, "average queue time in seconds above which low priority jobs are rejected (0 = never)")
   ;
 }
 
@@ -292,6 +323,7 @@ void ApplicationDispatcher::buildDispatcher (Scheduler* scheduler) {
   }
 
   _dispatcher = new Dispatcher(scheduler);
+  _dispatcher->setOverloadQueueTime(_overloadQueueTime);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -109,6 +109,13 @@ namespace triagens {
         void buildAQLQueue (size_t nrThreads,
                             size_t maxSize);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the dispatcher queue for background JavaScript jobs
+////////////////////////////////////////////////////////////////////////////////
+
+        void buildBackgroundQueue (size_t nrThreads,
+                                   size_t maxSize);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief builds an additional dispatcher queue
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,6 +136,12 @@ namespace triagens {
 
         void setProcessorAffinity (const std::vector<size_t>& cores);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the dispatcher threads over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumaAffinity (std::vector<std::vector<size_t>> const& nodes);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                        ApplicationFeature methods
 // -----------------------------------------------------------------------------
@@ -217,6 +230,22 @@ namespace triagens {
 
         double _reportInterval;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief average queue time above which low priority jobs are rejected
+/// @startDocuBlock dispatcherOverloadQueueTime
+/// `--dispatcher.overload-queue-time`
+///
+/// If set to a positive number of seconds, jobs of priority class *low* are
+/// rejected with HTTP 503 while the jobs of the classes *high* and *normal*
+/// have waited longer than this in the dispatcher queue on average. The
+/// priority class of a request can be set with the header
+/// *x-arango-priority* (*high*, *normal* or *low*), imports default to
+/// *low*. The default value is *0*, which never rejects any job.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _overloadQueueTime;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief total number of standard threads
 ////////////////////////////////////////////////////////////////////////////////
@@ -228,6 +257,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t _nrAQLThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total number of background threads
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nrBackgroundThreads;
     };
   }
 }
@@ -64,7 +64,8 @@ static DispatcherThread* CreateDispatcherThread (DispatcherQueue* queue) {
 
 Dispatcher::Dispatcher (Scheduler* scheduler)
   : _scheduler(scheduler),
-    _stopping(false) {
+    _stopping(false),
+    _overloadQueueTime(0.0) {
   _queues.resize(SYSTEM_QUEUE_SIZE, nullptr);
 }
 
@@ -114,6 +115,23 @@ void Dispatcher::addAQLQueue (size_t nrThreads, size_t maxSize) {
     maxSize);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the queue for background JavaScript jobs. its threads bound
+/// the number of background jobs running at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+void Dispatcher::addBackgroundQueue (size_t nrThreads, size_t maxSize) {
+  TRI_ASSERT(_queues[BACKGROUND_QUEUE] == nullptr);
+
+  _queues[BACKGROUND_QUEUE] = new DispatcherQueue(
+    _scheduler,
+    this,
+    BACKGROUND_QUEUE,
+    CreateDispatcherThread,
+    nrThreads,
+    maxSize);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief starts a new named queue
 ///
@@ -274,6 +292,20 @@ void Dispatcher::setProcessorAffinity (size_t id, std::vector<size_t> const& cor
   queue->setProcessorAffinity(cores);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the threads of a queue over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void Dispatcher::setNumaAffinity (size_t id, std::vector<std::vector<size_t>> const& nodes) {
+  DispatcherQueue* queue;
+
+  if (id >= _queues.size() || (queue = _queues[id]) == nullptr) {
+    return;
+  }
+
+  queue->setNumaAffinity(nodes);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -76,11 +76,17 @@ namespace triagens {
 
         static const size_t AQL_QUEUE = 1;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queue for background JavaScript jobs (tasks and Foxx queues)
+////////////////////////////////////////////////////////////////////////////////
+
+        static const size_t BACKGROUND_QUEUE = 2;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of queues
 ////////////////////////////////////////////////////////////////////////////////
 
-        static const size_t SYSTEM_QUEUE_SIZE = 2;
+        static const size_t SYSTEM_QUEUE_SIZE = 3;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
@@ -130,6 +136,12 @@ namespace triagens {
 
         void addAQLQueue (size_t nrThreads, size_t maxSize);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the queue for background JavaScript jobs
+////////////////////////////////////////////////////////////////////////////////
+
+        void addBackgroundQueue (size_t nrThreads, size_t maxSize);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief starts a new named queue
 ////////////////////////////////////////////////////////////////////////////////
@@ -179,6 +191,30 @@ namespace triagens {
 
         void setProcessorAffinity (size_t id, const std::vector<size_t>& cores);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the threads of a queue over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumaAffinity (size_t id, std::vector<std::vector<size_t>> const& nodes);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the average queue time above which low priority jobs are
+/// rejected, 0.0 disables the check
+////////////////////////////////////////////////////////////////////////////////
+
+        void setOverloadQueueTime (double value) {
+          _overloadQueueTime = value;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the average queue time above which low priority jobs are
+/// rejected
+////////////////////////////////////////////////////////////////////////////////
+
+        double overloadQueueTime () const {
+          return _overloadQueueTime;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -202,6 +238,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
 	std::vector<DispatcherQueue*> _queues;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief average queue time above which low priority jobs are rejected
+////////////////////////////////////////////////////////////////////////////////
+
+        double _overloadQueueTime;
     };
   }
 }
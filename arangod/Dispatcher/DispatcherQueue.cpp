@@ -35,10 +35,33 @@
 #include "Basics/logging.h"
 #include "Dispatcher/DispatcherThread.h"
 #include "Dispatcher/Job.h"
+#include "Statistics/MetricsRegistry.h"
 
 using namespace std;
 using namespace triagens::rest;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                            thread local variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief next producer id to hand out
+////////////////////////////////////////////////////////////////////////////////
+
+static atomic<size_t> NextProducerId(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief producer id of the current thread, -1 if not yet assigned
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local ssize_t ProducerId = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of jobs popped by the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local uint32_t PopCount = 0;
+
 // -----------------------------------------------------------------------------
 // constructors and destructors
 // -----------------------------------------------------------------------------
@@ -57,7 +80,9 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _nrThreads(nrThreads),
     _maxSize(maxSize),
     _waitLock(),
-    _readyJobs(maxSize),
+    _nrLanes(0 < nrThreads ? nrThreads : 1),
+    _readyJobs(),
+    _laneThreads(),
     _hazardLock(),
     _hazardPointer(nullptr),
     _stopping(false),
@@ -67,13 +92,13 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _nrRunning(0),
     _nrWaiting(0),
     _nrBlocked(0),
+    _nrQueued(0),
     _lastChanged(0.0),
     _gracePeriod(5.0),
     _scheduler(scheduler),
     _dispatcher(dispatcher),
     createDispatcherThread(creator),
     _affinityCores(),
-    _affinityPos(0),
     _jobs(),
     _jobPositions(_maxSize) {
 
@@ -85,6 +110,35 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
     _jobPositions.push(i);
     _jobs[i] = nullptr;
   }
+
+  // one list of ready jobs per priority class and lane
+  size_t const n = Job::PRIORITY_CLASSES * _nrLanes;
+
+  _readyJobs.reserve(n);
+
+  for (size_t i = 0;  i < n;  ++i) {
+    _readyJobs.push_back(new boost::lockfree::queue<Job*>(maxSize / n + 1));
+  }
+
+  _laneThreads.resize(_nrLanes, 0);
+
+  for (size_t i = 0;  i < Job::PRIORITY_CLASSES;  ++i) {
+    _queueTime[i] = 0.0;
+    _queueTimeUpdated[i] = 0.0;
+  }
+
+  auto metrics = triagens::basics::MetricsRegistry::instance();
+  std::string const labels = "queue=\"" + std::to_string(_id) + "\"";
+
+  metrics->addCallback("arangodb_dispatcher_queued_jobs", "Number of jobs waiting in a dispatcher queue",
+                       triagens::basics::MetricsRegistry::GAUGE, this,
+                       [this] () { return static_cast<double>(_nrQueued.load()); }, labels);
+  metrics->addCallback("arangodb_dispatcher_running_threads", "Number of running threads of a dispatcher queue",
+                       triagens::basics::MetricsRegistry::GAUGE, this,
+                       [this] () { return static_cast<double>(_nrRunning.load()); }, labels);
+  metrics->addCallback("arangodb_dispatcher_blocked_threads", "Number of blocked threads of a dispatcher queue",
+                       triagens::basics::MetricsRegistry::GAUGE, this,
+                       [this] () { return static_cast<double>(_nrBlocked.load()); }, labels);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,8 +146,14 @@ DispatcherQueue::DispatcherQueue (Scheduler* scheduler,
 ////////////////////////////////////////////////////////////////////////////////
 
 DispatcherQueue::~DispatcherQueue () {
+  triagens::basics::MetricsRegistry::instance()->removeCallbacks(this);
+
   beginShutdown();
   delete[] _jobs;
+
+  for (auto& it : _readyJobs) {
+    delete it;
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -111,6 +171,14 @@ DispatcherQueue::~DispatcherQueue () {
 int DispatcherQueue::addJob (Job* job) {
   TRI_ASSERT(job != nullptr);
 
+  Job::priority_e priority = job->priority();
+  double now = TRI_microtime();
+
+  // shed low priority work while the other jobs wait too long
+  if (priority == Job::PRIORITY_LOW && isOverloaded(now)) {
+    return TRI_ERROR_QUEUE_OVERLOADED;
+  }
+
   // get next free slot, return false is queue is full
   size_t pos;
 
@@ -123,14 +191,22 @@ int DispatcherQueue::addJob (Job* job) {
   // set the position inside the job
   job->setQueuePosition(pos);
 
-  // add the job to the list of ready jobs
-  bool ok = _readyJobs.push(job);
+  double maxQueueTime = job->maxQueueTime();
+  job->setQueueTimes(now, 0.0 < maxQueueTime ? now + maxQueueTime : 0.0);
+
+  RequestStatisticsAgentSetPriority(job, priority);
+
+  // add the job to the list of ready jobs of the producer's lane. count it
+  // first, so a fast consumer never makes the number negative
+  ++_nrQueued;
+  bool ok = readyJobs((size_t) priority, producerLane())->push(job);
 
   if (! ok) {
+    --_nrQueued;
     LOG_WARNING("cannot insert job into ready queue, giving up");
 
+    // the caller still owns the job
     removeJob(job);
-    delete job;
 
     return TRI_ERROR_QUEUE_FULL;
   }
@@ -257,7 +333,7 @@ void DispatcherQueue::beginShutdown () {
   {
     Job* job = nullptr;
     
-    while(_readyJobs.pop(job)) {
+    while (popJob(0, job)) {
       if (job != nullptr) {
         try {
           job->cancel();
@@ -380,26 +456,30 @@ void DispatcherQueue::shutdown () {
 void DispatcherQueue::startQueueThread () {
   DispatcherThread * thread = (*createDispatcherThread)(this);
 
-  if (! _affinityCores.empty()) {
-    size_t c = _affinityCores[_affinityPos];
+  {
+    MUTEX_LOCKER(_threadsLock);
 
-    LOG_DEBUG("using core %d for standard dispatcher thread", (int) c);
+    if (! notEnoughThreads()) {
+      delete thread;
+      return;
+    }
 
-    thread->setProcessorAffinity(c);
+    assignLane(thread);
 
-    ++_affinityPos;
+    // threads of the same lane share a core
+    if (! _affinityCores.empty()) {
+      size_t c = _affinityCores[thread->_lane % _affinityCores.size()];
 
-    if (_affinityPos >= _affinityCores.size()) {
-      _affinityPos = 0;
+      LOG_DEBUG("using core %d for dispatcher thread of lane %d", (int) c, (int) thread->_lane);
+
+      thread->setProcessorAffinity(c);
     }
-  }
+    else if (! _numaNodes.empty()) {
+      size_t node = thread->_lane % _numaNodes.size();
 
-  {
-    MUTEX_LOCKER(_threadsLock);
+      LOG_DEBUG("using NUMA node %d for dispatcher thread of lane %d", (int) node, (int) thread->_lane);
 
-    if (! notEnoughThreads()) {
-      delete thread;
-      return;
+      thread->setProcessorAffinity(_numaNodes[node]);
     }
 
     _startedThreads.insert(thread);
@@ -426,7 +506,10 @@ void DispatcherQueue::startQueueThread () {
 void DispatcherQueue::removeStartedThread (DispatcherThread* thread) {
   {
     MUTEX_LOCKER(_threadsLock);
-    _startedThreads.erase(thread);
+
+    if (_startedThreads.erase(thread) > 0) {
+      --_laneThreads[thread->_lane];
+    }
   }
 
   --_nrRunning;
@@ -476,6 +559,14 @@ void DispatcherQueue::setProcessorAffinity (const vector<size_t>& cores) {
   _affinityCores = cores;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the lanes over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void DispatcherQueue::setNumaAffinity (vector<vector<size_t>> const& nodes) {
+  _numaNodes = nodes;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -494,6 +585,145 @@ void DispatcherQueue::deleteOldThreads () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane a job added by the current thread goes to
+////////////////////////////////////////////////////////////////////////////////
+
+size_t DispatcherQueue::producerLane () const {
+  DispatcherThread* current = DispatcherThread::currentDispatcherThread;
+
+  if (current != nullptr && current->_queue == this) {
+    return current->_lane;
+  }
+
+  if (ProducerId < 0) {
+    ProducerId = (ssize_t) NextProducerId++;
+  }
+
+  size_t const n = _numaNodes.size();
+
+  if (n > 1) {
+    // feed one of the lanes of the node the producer runs on, these are
+    // node, node + n, node + 2n, ...
+    size_t node = TRI_currentNumaNode() % n;
+
+    if (node < _nrLanes) {
+      size_t lanes = (_nrLanes - node + n - 1) / n;
+
+      return node + n * (((size_t) ProducerId) % lanes);
+    }
+  }
+
+  return ((size_t) ProducerId) % _nrLanes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pops a job of the given priority class from the given lane or
+/// steals one from another lane
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::popJob (size_t priority, size_t lane, Job*& job) {
+  for (size_t i = 0;  i < _nrLanes;  ++i) {
+    if (readyJobs(priority, (lane + i) % _nrLanes)->pop(job)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pops the next job from the given lane or steals one
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::popJob (size_t lane, Job*& job) {
+  bool reverse = (++PopCount % 16) == 0;
+
+  for (size_t i = 0;  i < Job::PRIORITY_CLASSES;  ++i) {
+    size_t priority = reverse ? (Job::PRIORITY_CLASSES - 1 - i) : i;
+
+    if (popJob(priority, lane, job)) {
+      if (job != nullptr) {
+        --_nrQueued;
+
+        double now = TRI_microtime();
+        updateQueueTime(priority, now - job->queued(), now);
+      }
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the time a job of the given priority class has waited
+////////////////////////////////////////////////////////////////////////////////
+
+void DispatcherQueue::updateQueueTime (size_t priority, double queueTime, double now) {
+  double average = _queueTime[priority].load(memory_order_relaxed);
+
+  _queueTime[priority].store(0.875 * average + 0.125 * queueTime, memory_order_relaxed);
+  _queueTimeUpdated[priority].store(now, memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if low priority jobs must be rejected
+///
+/// The queue is overloaded if jobs of a higher class waited longer than the
+/// configured queue time on average. Averages not updated within the last
+/// second are stale and ignored, as no such jobs were started recently.
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::isOverloaded (double now) const {
+  double const threshold = _dispatcher->overloadQueueTime();
+
+  if (threshold <= 0.0) {
+    return false;
+  }
+
+  for (size_t i = 0;  i < Job::PRIORITY_LOW;  ++i) {
+    if (now - 1.0 < _queueTimeUpdated[i].load(memory_order_relaxed) &&
+        threshold < _queueTime[i].load(memory_order_relaxed)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if any lane has a ready job
+////////////////////////////////////////////////////////////////////////////////
+
+bool DispatcherQueue::hasReadyJobs () const {
+  for (auto const& it : _readyJobs) {
+    if (! it->empty()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief assigns the lane with the fewest threads to a new thread
+////////////////////////////////////////////////////////////////////////////////
+
+void DispatcherQueue::assignLane (DispatcherThread* thread) {
+  size_t lane = 0;
+
+  for (size_t i = 1;  i < _laneThreads.size();  ++i) {
+    if (_laneThreads[i] < _laneThreads[lane]) {
+      lane = i;
+    }
+  }
+
+  ++_laneThreads[lane];
+  thread->_lane = lane;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
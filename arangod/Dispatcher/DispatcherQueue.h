@@ -37,6 +37,7 @@
 
 #include "Basics/ConditionVariable.h"
 #include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/Job.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
@@ -45,7 +46,6 @@
 namespace triagens {
   namespace rest {
     class DispatcherThread;
-    class Job;
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                             class DispatcherQueue
@@ -163,6 +163,17 @@ namespace triagens {
 
         void setProcessorAffinity (const std::vector<size_t>& cores);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the lanes over NUMA nodes
+///
+/// Lane l belongs to node l modulo the number of nodes, its threads may run
+/// on all processors of the node. Producers that are not dispatcher threads
+/// feed a lane of the node they are running on, so that a job is picked up
+/// on the node that read the request.
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumaAffinity (std::vector<std::vector<size_t>> const& nodes);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -175,6 +186,65 @@ namespace triagens {
 
       void deleteOldThreads ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the lane a job added by the current thread goes to
+///
+/// A dispatcher thread of this queue uses its own lane, every other thread
+/// always feeds the same lane, so that jobs of one producer stay together.
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t producerLane () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the list of ready jobs for a priority class and lane
+////////////////////////////////////////////////////////////////////////////////
+
+      boost::lockfree::queue<Job*>* readyJobs (size_t priority, size_t lane) const {
+        return _readyJobs[priority * _nrLanes + lane];
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pops a job of the given priority class from the given lane or
+/// steals one from another lane
+////////////////////////////////////////////////////////////////////////////////
+
+      bool popJob (size_t priority, size_t lane, Job*& job);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the time a job of the given priority class has waited
+////////////////////////////////////////////////////////////////////////////////
+
+      void updateQueueTime (size_t priority, double queueTime, double now);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if low priority jobs must be rejected
+////////////////////////////////////////////////////////////////////////////////
+
+      bool isOverloaded (double now) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pops the next job from the given lane or steals one
+///
+/// Higher priority classes are served first. Every few jobs the classes are
+/// served in reverse order, so that lower classes cannot starve.
+////////////////////////////////////////////////////////////////////////////////
+
+      bool popJob (size_t lane, Job*& job);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks if any lane has a ready job
+////////////////////////////////////////////////////////////////////////////////
+
+      bool hasReadyJobs () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief assigns the lane with the fewest threads to a new thread
+///
+/// Must be called with _threadsLock held.
+////////////////////////////////////////////////////////////////////////////////
+
+      void assignLane (DispatcherThread* thread);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -210,10 +280,43 @@ namespace triagens {
         basics::ConditionVariable _waitLock;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief list of ready jobs
+/// @brief number of lanes, one lane per initial thread
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t const _nrLanes;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lists of ready jobs, one per priority class and lane
+///
+/// Each dispatcher thread takes jobs from its own lane first and only steals
+/// from the other lanes if its lane is empty. This keeps the dequeue
+/// contention on a lane between its owner and the producers feeding it.
+/// Use readyJobs() to access the list of a priority class and lane.
 ////////////////////////////////////////////////////////////////////////////////
 
-        boost::lockfree::queue<Job*> _readyJobs;
+        std::vector<boost::lockfree::queue<Job*>*> _readyJobs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief average queue time per priority class
+///
+/// This is a moving average of the time jobs of a class waited before they
+/// were started. Note that we ignore race conditions, the worst that can
+/// happen is that one sample is lost.
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<double> _queueTime[Job::PRIORITY_CLASSES];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief last time a job of the priority class was started
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<double> _queueTimeUpdated[Job::PRIORITY_CLASSES];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of started threads per lane, protected by _threadsLock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<size_t> _laneThreads;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief guard for hazard pointer
@@ -289,6 +392,12 @@ namespace triagens {
 
         std::atomic<ssize_t> _nrBlocked;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of jobs in the ready lists
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<ssize_t> _nrQueued;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief last time we created or deleted a queue thread
 ///
@@ -330,10 +439,11 @@ namespace triagens {
         std::vector<size_t> _affinityCores;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief next affinity core to use
+/// @brief processors per NUMA node, empty unless the lanes are spread over
+/// the nodes
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _affinityPos;
+        std::vector<std::vector<size_t>> _numaNodes;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief list of jobs
@@ -72,7 +72,8 @@ DispatcherThread::DispatcherThread (DispatcherQueue* queue)
             ? std::string("_std")
             : (queue->_id == Dispatcher::AQL_QUEUE 
                ? std::string("_aql") : ("_" + to_string(queue->_id))))),
-    _queue(queue) {
+    _queue(queue),
+    _lane(0) {
 
   allowAsynchronousCancelation();
 }
@@ -98,7 +99,7 @@ void DispatcherThread::run () {
     {
       Job* job = nullptr;
 
-      while (_queue->_readyJobs.pop(job)) {
+      while (_queue->popJob(_lane, job)) {
         if (job != nullptr) {
           worked = now;
           handleJob(job);
@@ -106,7 +107,7 @@ void DispatcherThread::run () {
       }
 
       // we need to check again if more work has arrived after we have
-      // aquired the lock. The lockfree queue and _nrWaiting are accessed
+      // aquired the lock. The lockfree queues and _nrWaiting are accessed
       // using "memory_order_seq_cst", this guaranties that we do not
       // miss a signal.
 
@@ -115,7 +116,7 @@ void DispatcherThread::run () {
 
         CONDITION_LOCKER(guard, _queue->_waitLock);
 
-        if (! _queue->_readyJobs.empty()) {
+        if (_queue->hasReadyJobs()) {
           --_queue->_nrWaiting;
           continue;
         }
@@ -165,6 +166,14 @@ void DispatcherThread::unblock () {
   _queue->unblockThread();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the dispatcher the thread belongs to
+////////////////////////////////////////////////////////////////////////////////
+
+Dispatcher* DispatcherThread::dispatcher () const {
+  return _queue->_dispatcher;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -184,6 +193,13 @@ void DispatcherThread::handleJob (Job* job) {
   try {
     RequestStatisticsAgentSetQueueEnd(job);
 
+    // shed the job if it was not started before its deadline
+    double deadline = job->deadline();
+
+    if (0.0 < deadline && deadline < TRI_microtime()) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_QUEUE_TIME_EXCEEDED);
+    }
+
     // set current thread
     job->setDispatcherThread(this);
 
@@ -261,6 +277,9 @@ void DispatcherThread::handleJob (Job* job) {
       job->cleanup(_queue);
     }
     else if (status.status == Job::JOB_REQUEUE) {
+      // give up the slot, adding the job again takes a new one
+      _queue->removeJob(job);
+
       if (0.0 < status.sleep) {
         _queue->_scheduler->registerTask(
           new RequeueTask(_queue->_scheduler,
@@ -269,7 +288,19 @@ void DispatcherThread::handleJob (Job* job) {
                           job));
       }
       else {
-        _queue->_dispatcher->addJob(job);
+        int res = _queue->_dispatcher->addJob(job);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          LOG_WARNING("cannot requeue job: %s", TRI_errno_string(res));
+
+          try {
+            job->handleError(Exception(res, __FILE__, __LINE__));
+          }
+          catch (...) {
+          }
+
+          delete job;
+        }
       }
     }
   }
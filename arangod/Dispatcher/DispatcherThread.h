@@ -39,6 +39,7 @@
 
 namespace triagens {
   namespace rest {
+    class Dispatcher;
     class DispatcherQueue;
     class Job;
     class Scheduler;
@@ -113,6 +114,12 @@ namespace triagens {
 
         void unblock ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the dispatcher the thread belongs to
+////////////////////////////////////////////////////////////////////////////////
+
+        Dispatcher* dispatcher () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -134,6 +141,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         DispatcherQueue* _queue;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the lane of the queue this thread takes its jobs from
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _lane;
     };
   }
 }
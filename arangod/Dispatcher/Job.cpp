@@ -46,7 +46,9 @@ using namespace std;
 Job::Job (string const& name)
   : _name(name),
     _id(0),
-    _queuePosition((size_t) -1) {
+    _queuePosition((size_t) -1),
+    _queued(0.0),
+    _deadline(0.0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -68,6 +70,22 @@ size_t Job::queue () const {
   return Dispatcher::STANDARD_QUEUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the priority class
+////////////////////////////////////////////////////////////////////////////////
+
+Job::priority_e Job::priority () const {
+  return PRIORITY_NORMAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal time in seconds the job may wait in the queue
+////////////////////////////////////////////////////////////////////////////////
+
+double Job::maxQueueTime () const {
+  return 0.0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,6 +92,25 @@ namespace triagens {
             double sleep;
         };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief priority class
+///
+/// A dispatcher queue runs jobs of a higher class before jobs of a lower
+/// class, jobs of the same class are run in order of arrival.
+////////////////////////////////////////////////////////////////////////////////
+
+        enum priority_e {
+          PRIORITY_HIGH = 0,
+          PRIORITY_NORMAL = 1,
+          PRIORITY_LOW = 2
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of priority classes
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const PRIORITY_CLASSES = 3;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -160,6 +179,33 @@ namespace triagens {
           return _queuePosition;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the time the job was queued and its deadline
+////////////////////////////////////////////////////////////////////////////////
+
+        void setQueueTimes (double queued, double deadline) {
+          _queued = queued;
+          _deadline = deadline;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the time the job was queued
+////////////////////////////////////////////////////////////////////////////////
+
+        double queued () const {
+          return _queued;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the time by which the job must have been started
+///
+/// Note: 0.0 means no deadline
+////////////////////////////////////////////////////////////////////////////////
+
+        double deadline () const {
+          return _deadline;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            virtual public methods
 // -----------------------------------------------------------------------------
@@ -172,6 +218,20 @@ namespace triagens {
 
         virtual size_t queue () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the priority class
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual priority_e priority () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal time in seconds the job may wait in the queue
+///
+/// Note: 0.0 means no limit
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual double maxQueueTime () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -225,6 +285,18 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t _queuePosition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time the job was queued
+////////////////////////////////////////////////////////////////////////////////
+
+        double _queued;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time by which the job must have been started, 0.0 for none
+////////////////////////////////////////////////////////////////////////////////
+
+        double _deadline;
     };
   }
 }
@@ -28,8 +28,10 @@
 
 #include "RequeueTask.h"
 
+#include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/Job.h"
 #include "Scheduler/Scheduler.h"
 
 using namespace std;
@@ -63,7 +65,20 @@ RequeueTask::RequeueTask (Scheduler* scheduler,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool RequeueTask::handleTimeout () {
-  _dispatcher->addJob(_job);
+  int res = _dispatcher->addJob(_job);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_WARNING("cannot requeue job: %s", TRI_errno_string(res));
+
+    try {
+      _job->handleError(triagens::basics::Exception(res, __FILE__, __LINE__));
+    }
+    catch (...) {
+    }
+
+    delete _job;
+  }
+
   _scheduler->destroyTask(this);
 
   return true;
@@ -49,9 +49,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 static void FreeSlot (TRI_fulltext_handle_slot_t* slot) {
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_documents);
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_deleted);
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot->_documents);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot->_deleted);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -66,26 +66,26 @@ static bool AllocateSlot (TRI_fulltext_handles_t* const handles,
     return true;
   }
 
-  auto slot = static_cast<TRI_fulltext_handle_slot_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_fulltext_handle_slot_t), false));
+  auto slot = static_cast<TRI_fulltext_handle_slot_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(TRI_fulltext_handle_slot_t), false));
 
   if (slot == nullptr) {
     return false;
   }
 
   // allocate and clear
-  slot->_documents = static_cast<TRI_fulltext_doc_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_fulltext_doc_t) * handles->_slotSize, true));
+  slot->_documents = static_cast<TRI_fulltext_doc_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(TRI_fulltext_doc_t) * handles->_slotSize, true));
 
   if (slot->_documents == nullptr) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot);
     return false;
   }
 
   // allocate and clear deleted flags
-  slot->_deleted = static_cast<uint8_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(uint8_t) * handles->_slotSize, true));
+  slot->_deleted = static_cast<uint8_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(uint8_t) * handles->_slotSize, true));
 
   if (slot->_deleted == nullptr) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot->_documents);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, slot);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot->_documents);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, slot);
     return false;
   }
 
@@ -121,7 +121,7 @@ static bool AllocateSlotList (TRI_fulltext_handles_t* const handles,
     return true;
   }
 
-  TRI_fulltext_handle_slot_t** slots = static_cast<TRI_fulltext_handle_slot_t**>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_fulltext_handle_slot_t*) * targetNumber, true));
+  TRI_fulltext_handle_slot_t** slots = static_cast<TRI_fulltext_handle_slot_t**>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(TRI_fulltext_handle_slot_t*) * targetNumber, true));
 
   if (slots == nullptr) {
     // out of memory
@@ -137,7 +137,7 @@ static bool AllocateSlotList (TRI_fulltext_handles_t* const handles,
 
   if (handles->_slots != nullptr) {
     // free old list pointer
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, handles->_slots);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, handles->_slots);
   }
 
   // new slot is empty
@@ -158,7 +158,7 @@ static bool AllocateSlotList (TRI_fulltext_handles_t* const handles,
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_handles_t* TRI_CreateHandlesFulltextIndex (const uint32_t slotSize) {
-  TRI_fulltext_handles_t* handles = static_cast<TRI_fulltext_handles_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_fulltext_handles_t), false));
+  TRI_fulltext_handles_t* handles = static_cast<TRI_fulltext_handles_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(TRI_fulltext_handles_t), false));
 
   if (handles == nullptr) {
     return nullptr;
@@ -190,14 +190,14 @@ void TRI_FreeHandlesFulltextIndex (TRI_fulltext_handles_t* handles) {
       }
     }
 
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, handles->_slots);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, handles->_slots);
   }
 
   if (handles->_map != nullptr) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, handles->_map);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, handles->_map);
   }
 
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, handles);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, handles);
 }
 
 // -----------------------------------------------------------------------------
@@ -246,7 +246,7 @@ TRI_fulltext_handles_t* TRI_CompactHandleFulltextIndex (TRI_fulltext_handles_t*
   uint32_t originalHandle, targetHandle;
   uint32_t i;
 
-  TRI_fulltext_handle_t* map = static_cast<TRI_fulltext_handle_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_fulltext_handle_t) * original->_next, false));
+  TRI_fulltext_handle_t* map = static_cast<TRI_fulltext_handle_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(TRI_fulltext_handle_t) * original->_next, false));
 
   if (map == nullptr) {
     return nullptr;
@@ -255,7 +255,7 @@ TRI_fulltext_handles_t* TRI_CompactHandleFulltextIndex (TRI_fulltext_handles_t*
   clone = TRI_CreateHandlesFulltextIndex(original->_slotSize);
 
   if (clone == nullptr) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, map);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, map);
     return nullptr;
   }
 
@@ -121,6 +121,7 @@ typedef struct {
   TRI_read_write_lock_t   _lock;
 
   size_t                  _memoryAllocated;     // total memory used by index
+  uint64_t                _modifications;       // number of inserts and removals
 #if TRI_FULLTEXT_DEBUG
   size_t                  _memoryBase;          // base memory
   size_t                  _memoryNodes;         // total memory used by nodes (node_t only)
@@ -268,7 +269,7 @@ static inline void* ReallocateMemory (index_t* const idx,
   TRI_ASSERT(oldSize > 0);
 #endif
 
-  data = TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, old, newSize);
+  data = TRI_Reallocate(TRI_FULLTEXT_INDEX_MEM_ZONE, old, newSize);
   if (data != nullptr) {
     idx->_memoryAllocated += newSize;
     idx->_memoryAllocated -= oldSize;
@@ -287,7 +288,7 @@ static inline void* AllocateMemory (index_t* const idx, const size_t size) {
   TRI_ASSERT(size > 0);
 #endif
 
-  data = TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, size, false);
+  data = TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, size, false);
   if (data != nullptr) {
     idx->_memoryAllocated += size;
   }
@@ -307,7 +308,7 @@ static inline void FreeMemory (index_t* const idx,
 #endif
 
   idx->_memoryAllocated -= size;
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, data);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, data);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -633,7 +634,7 @@ static void FreeNode (index_t* const idx, node_t* node) {
 
 static bool CleanupNodes (index_t* idx,
                           node_t* node,
-                          void* map) {
+                          void const* map) {
   bool isActive;
 
   // assume we can delete the node we are processing
@@ -698,11 +699,17 @@ static bool CleanupNodes (index_t* idx,
     }
   }
 
-  // rewrite the node's handle list if present
+  // rewrite the node's handle list if present. without a map, the lists
+  // have already been rewritten and only empty ones are removed
   if (node->_handles != nullptr) {
     uint32_t remain;
 
-    remain = TRI_RewriteListFulltextIndex(node->_handles, map);
+    if (map != nullptr) {
+      remain = TRI_RewriteListFulltextIndex(node->_handles, map);
+    }
+    else {
+      remain = TRI_NumEntriesListFulltextIndex(node->_handles);
+    }
     if (remain > 0) {
       // there are still handles left in the rewritten handles list
       // we must keep this node
@@ -720,6 +727,50 @@ static bool CleanupNodes (index_t* idx,
   return isActive;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recursively create rewritten copies of the handle lists of a node
+/// and its sub-nodes (used during compaction)
+/// the nodes themselves are left untouched, so this can run while queries
+/// are reading the index
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CopyRewrittenNodeHandles (node_t* node,
+                                      void const* map,
+                                      std::vector<std::pair<node_t*, TRI_fulltext_list_t*>>& lists) {
+  if (node->_handles != nullptr) {
+    TRI_fulltext_list_t* copy = TRI_CloneListFulltextIndex(node->_handles);
+
+    if (copy == nullptr) {
+      return false;
+    }
+
+    TRI_RewriteListFulltextIndex(copy, map);
+
+    try {
+      lists.emplace_back(node, copy);
+    }
+    catch (...) {
+      TRI_FreeListFulltextIndex(copy);
+      return false;
+    }
+  }
+
+  uint32_t const numFollowers = NodeNumFollowers(node);
+  if (numFollowers == 0) {
+    return true;
+  }
+
+  node_t** followerNodes = NodeFollowersNodes(node);
+
+  for (uint32_t i = 0; i < numFollowers; ++i) {
+    if (! CopyRewrittenNodeHandles(followerNodes[i], map, lists)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief find a sub-node of a node with only one sub-node
 /// the caller must make sure the node actually has exactly one sub-node!
@@ -908,11 +959,11 @@ static TRI_fulltext_list_t* GetDirectNodeHandles (const node_t* const node) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief recursively merge node and sub-node handles into the result list
+/// @brief recursively collect the handle lists of a node and its sub-nodes
 ////////////////////////////////////////////////////////////////////////////////
 
-static TRI_fulltext_list_t* MergeSubNodeHandles (const node_t* const node,
-                                                 TRI_fulltext_list_t* list) {
+static void CollectSubNodeHandles (const node_t* const node,
+                                   std::vector<TRI_fulltext_list_t const*>& lists) {
   node_t** followerNodes;
   uint32_t numFollowers;
   uint32_t i;
@@ -921,48 +972,48 @@ static TRI_fulltext_list_t* MergeSubNodeHandles (const node_t* const node,
   TRI_ASSERT(node != nullptr);
 #endif
 
+  if (node->_handles != nullptr) {
+    lists.emplace_back(node->_handles);
+  }
+
   numFollowers = NodeNumFollowers(node);
   if (numFollowers == 0) {
-    return list;
+    return;
   }
 
   followerNodes = NodeFollowersNodes(node);
 
   for (i = 0; i < numFollowers; ++i) {
-    node_t* follower;
-
-    follower = followerNodes[i];
 #if TRI_FULLTEXT_DEBUG
-  TRI_ASSERT(follower != nullptr);
+    TRI_ASSERT(followerNodes[i] != nullptr);
 #endif
-    if (follower->_handles != nullptr) {
-      // OR-merge the follower node's documents with what we already have found
-      list = TRI_UnioniseListFulltextIndex(list, GetDirectNodeHandles(follower));
-      if (list == nullptr) {
-        return nullptr;
-      }
-    }
-
-    // recurse into sub-nodes
-    list = MergeSubNodeHandles(follower, list);
-    if (list == nullptr) {
-      return nullptr;
-    }
+    CollectSubNodeHandles(followerNodes[i], lists);
   }
-
-  return list;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief recursively create a result list with the handles of a node and
 /// all of its sub-nodes
+/// the lists of all nodes are merged in one go. merging them pairwise would
+/// copy the handles found so far once per sub-node
 ////////////////////////////////////////////////////////////////////////////////
 
-static inline TRI_fulltext_list_t* GetSubNodeHandles (const node_t* const node) {
-  TRI_fulltext_list_t* list;
+static TRI_fulltext_list_t* GetSubNodeHandles (const node_t* const node) {
+  std::vector<TRI_fulltext_list_t const*> lists;
+
+  try {
+    CollectSubNodeHandles(node, lists);
+  }
+  catch (...) {
+    // out of memory
+    return nullptr;
+  }
+
+  if (lists.empty()) {
+    return TRI_CreateListFulltextIndex(0);
+  }
 
-  list = GetDirectNodeHandles(node);
-  return MergeSubNodeHandles(node, list);
+  return TRI_UnioniseMultipleListFulltextIndex(lists.data(), lists.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1162,7 +1213,8 @@ static TRI_fulltext_result_t* MakeListResult (index_t* const idx,
 
   // we have a list of handles
   // now turn the handles into documents and exclude deleted ones on the fly
-  numResults = TRI_NumEntriesListFulltextIndex(list);
+  uint32_t const numEntries = TRI_NumEntriesListFulltextIndex(list);
+  numResults = numEntries;
   if (static_cast<size_t>(numResults) > maxResults && maxResults > 0) {
     // cap the number of results
     numResults = static_cast<uint32_t>(maxResults);
@@ -1176,7 +1228,9 @@ static TRI_fulltext_result_t* MakeListResult (index_t* const idx,
   pos = 0;
   listEntries = TRI_StartListFulltextIndex(list);
 
-  for (i = 0; i < numResults; ++i) {
+  // deleted documents do not count towards the result limit, so keep going
+  // until enough documents have been found
+  for (i = 0; i < numEntries && pos < numResults; ++i) {
     TRI_fulltext_handle_t handle;
     TRI_fulltext_doc_t doc;
 
@@ -1260,13 +1314,14 @@ static inline size_t CommonPrefixLength (const char* const lhs,
 TRI_fts_index_t* TRI_CreateFtsIndex (uint32_t handleChunkSize,
                                      uint32_t nodeChunkSize,
                                      uint32_t initialNodeHandles) {
-  index_t* idx = static_cast<index_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(index_t), false));
+  index_t* idx = static_cast<index_t*>(TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, sizeof(index_t), false));
 
   if (idx == nullptr) {
     return nullptr;
   }
 
   idx->_memoryAllocated    = sizeof(index_t);
+  idx->_modifications      = 0;
 #if TRI_FULLTEXT_DEBUG
   idx->_memoryBase         = sizeof(index_t);
   idx->_memoryNodes        = 0;
@@ -1282,7 +1337,7 @@ TRI_fts_index_t* TRI_CreateFtsIndex (uint32_t handleChunkSize,
   idx->_root               = CreateNode(idx);
   if (idx->_root == nullptr) {
     // out of memory
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, idx);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, idx);
     return nullptr;
   }
 
@@ -1290,8 +1345,8 @@ TRI_fts_index_t* TRI_CreateFtsIndex (uint32_t handleChunkSize,
   idx->_handles = TRI_CreateHandlesFulltextIndex(handleChunkSize);
   if (idx->_handles == nullptr) {
     // out of memory
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, idx->_root);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, idx);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, idx->_root);
+    TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, idx);
     return nullptr;
   }
 
@@ -1331,7 +1386,7 @@ void TRI_FreeFtsIndex (TRI_fts_index_t* ftx) {
   TRI_DestroyReadWriteLock(&idx->_lock);
 
   // free index itself
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, idx);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, idx);
 }
 
 // -----------------------------------------------------------------------------
@@ -1348,6 +1403,7 @@ void TRI_DeleteDocumentFulltextIndex (TRI_fts_index_t* const ftx,
 
   TRI_WriteLockReadWriteLock(&idx->_lock);
   TRI_DeleteDocumentHandleFulltextIndex(idx->_handles, document);
+  ++idx->_modifications;
   TRI_WriteUnlockReadWriteLock(&idx->_lock);
 }
 
@@ -1387,6 +1443,7 @@ bool TRI_InsertWordsFulltextIndex (TRI_fts_index_t* const ftx,
   idx = (index_t*) ftx;
 
   TRI_WriteLockReadWriteLock(&idx->_lock);
+  ++idx->_modifications;
 
   // get a new handle for the document
   handle = TRI_InsertHandleFulltextIndex(idx->_handles, document);
@@ -1719,7 +1776,12 @@ size_t TRI_MemoryFulltextIndex (const TRI_fts_index_t* const ftx) {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compact the fulltext index
-/// note: the caller must hold a lock on the index before called this
+///
+/// the compacted handles and node handle lists are built as copies while
+/// holding only the read lock, so queries can go on meanwhile. the write lock
+/// is held just for swapping in the copies and pruning empty nodes. if the
+/// index is busy or got modified while the copies were built, the copies are
+/// thrown away and the next call will try again
 ////////////////////////////////////////////////////////////////////////////////
 
 bool TRI_CompactFulltextIndex (TRI_fts_index_t* const ftx) {
@@ -1728,39 +1790,81 @@ bool TRI_CompactFulltextIndex (TRI_fts_index_t* const ftx) {
 
   idx = (index_t*) ftx;
 
-  // but don't block if the index is busy
-  // try to acquire the write lock to clean up
-  if (! TRI_TryWriteLockReadWriteLock(&idx->_lock)) {
+  // don't block if the index is busy
+  if (! TRI_TryReadLockReadWriteLock(&idx->_lock)) {
     return true;
   }
 
   if (! TRI_ShouldCompactHandleFulltextIndex(idx->_handles)) {
     // not enough cleanup work to do
-    TRI_WriteUnlockReadWriteLock(&idx->_lock);
+    TRI_ReadUnlockReadWriteLock(&idx->_lock);
     return true;
   }
 
+  uint64_t const modifications = idx->_modifications;
+
   // this will create a copy of the handles from the existing index, but will
   // re-align the handle numbers consecutively, starting at 1.
-  // this will also populate the _map property, which can be used to clean up
-  // handles of existing nodes
+  // this will also populate the _map property, which is used to create
+  // rewritten copies of the handle lists of all nodes
   clone = TRI_CompactHandleFulltextIndex(idx->_handles);
   if (clone == nullptr) {
-    TRI_WriteUnlockReadWriteLock(&idx->_lock);
+    TRI_ReadUnlockReadWriteLock(&idx->_lock);
     return false;
   }
 
-  CleanupNodes(idx, idx->_root, clone->_map);
+  std::vector<std::pair<node_t*, TRI_fulltext_list_t*>> lists;
+  bool ok = CopyRewrittenNodeHandles(idx->_root, clone->_map, lists);
 
-  // delete the original handle list
-  TRI_FreeHandlesFulltextIndex(idx->_handles);
+  TRI_ReadUnlockReadWriteLock(&idx->_lock);
 
   // free the rewrite map
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, clone->_map);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, clone->_map);
   clone->_map = nullptr;
 
-  // cleanup finished, now switch over
+  auto discard = [&] () -> void {
+    for (auto& it : lists) {
+      TRI_FreeListFulltextIndex(it.second);
+    }
+    TRI_FreeHandlesFulltextIndex(clone);
+  };
+
+  if (! ok) {
+    // out of memory
+    discard();
+    return false;
+  }
+
+  if (! TRI_TryWriteLockReadWriteLock(&idx->_lock)) {
+    discard();
+    return true;
+  }
+
+  if (idx->_modifications != modifications) {
+    // the copies are outdated
+    TRI_WriteUnlockReadWriteLock(&idx->_lock);
+    discard();
+    return true;
+  }
+
+  // switch over the node handle lists
+  for (auto& it : lists) {
+    node_t* node = it.first;
+
+    idx->_memoryAllocated -= TRI_MemoryListFulltextIndex(node->_handles);
+    TRI_FreeListFulltextIndex(node->_handles);
+
+    node->_handles = it.second;
+    idx->_memoryAllocated += TRI_MemoryListFulltextIndex(node->_handles);
+  }
+
+  // remove the nodes that are empty now
+  CleanupNodes(idx, idx->_root, nullptr);
+
+  // delete the original handle list and switch over
+  TRI_FreeHandlesFulltextIndex(idx->_handles);
   idx->_handles = clone;
+
   TRI_WriteUnlockReadWriteLock(&idx->_lock);
 
   return true;
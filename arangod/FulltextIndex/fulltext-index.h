@@ -184,6 +184,8 @@ size_t TRI_MemoryFulltextIndex (const TRI_fts_index_t* const);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compact the fulltext index
+/// this does not block queries for most of the time. it returns false only
+/// when running out of memory
 ////////////////////////////////////////////////////////////////////////////////
 
 bool TRI_CompactFulltextIndex (TRI_fts_index_t* const);
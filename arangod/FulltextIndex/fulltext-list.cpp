@@ -50,6 +50,13 @@
 
 #define GROWTH_FACTOR 1.2
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size ratio from which on an intersection will gallop through the
+/// bigger list instead of stepping through both lists
+////////////////////////////////////////////////////////////////////////////////
+
+#define GALLOP_RATIO 8
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -176,6 +183,53 @@ static void SortList (TRI_fulltext_list_t* list) {
   SetIsSorted(list, true);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find the position of the first entry >= value in a sorted list,
+/// starting at position start
+/// the search doubles its step size until it overshoots and then does a
+/// binary search in the last step, so skipping n entries costs O(log n)
+/// comparisons
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Gallop (TRI_fulltext_list_entry_t const* entries,
+                        uint32_t numEntries,
+                        uint32_t start,
+                        TRI_fulltext_list_entry_t value) {
+  if (start >= numEntries || entries[start] >= value) {
+    return start;
+  }
+
+  // entries[low] < value holds throughout
+  uint32_t low = start;
+  uint32_t step = 1;
+
+  while (true) {
+    uint32_t high = low + step;
+
+    if (high >= numEntries || high < low) {
+      high = numEntries;
+    }
+    else if (entries[high] < value) {
+      low = high;
+      step *= 2;
+      continue;
+    }
+
+    // value is in (low, high]
+    ++low;
+    while (low < high) {
+      uint32_t mid = low + (high - low) / 2;
+      if (entries[mid] < value) {
+        low = mid + 1;
+      }
+      else {
+        high = mid;
+      }
+    }
+    return low;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the memory usage for a list of the specified size
 ////////////////////////////////////////////////////////////////////////////////
@@ -192,7 +246,7 @@ static inline size_t MemoryList (const uint32_t size) {
 
 static TRI_fulltext_list_t* IncreaseList (TRI_fulltext_list_t* list,
                                           const uint32_t size) {
-  TRI_fulltext_list_t* copy = TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, list, MemoryList(size));
+  TRI_fulltext_list_t* copy = TRI_Reallocate(TRI_FULLTEXT_INDEX_MEM_ZONE, list, MemoryList(size));
 
   if (copy != nullptr) {
     InitList(copy, size);
@@ -225,6 +279,8 @@ TRI_fulltext_list_t* TRI_CloneListFulltextIndex (TRI_fulltext_list_t const* sour
     if (numEntries > 0) {
       memcpy(GetStart(list), GetStart(source), numEntries * sizeof(TRI_fulltext_list_entry_t));
       SetNumEntries(list, numEntries);
+      // keep the sorted flag so the clone need not be sorted again
+      SetIsSorted(list, IsSorted(source));
     }
   }
 
@@ -236,7 +292,7 @@ TRI_fulltext_list_t* TRI_CloneListFulltextIndex (TRI_fulltext_list_t const* sour
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_fulltext_list_t* TRI_CreateListFulltextIndex (const uint32_t size) {
-  TRI_fulltext_list_t* list = TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, MemoryList(size), false);
+  TRI_fulltext_list_t* list = TRI_Allocate(TRI_FULLTEXT_INDEX_MEM_ZONE, MemoryList(size), false);
 
   if (list == nullptr) {
     // out of memory
@@ -253,7 +309,7 @@ TRI_fulltext_list_t* TRI_CreateListFulltextIndex (const uint32_t size) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_FreeListFulltextIndex (TRI_fulltext_list_t* list) {
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, list);
+  TRI_Free(TRI_FULLTEXT_INDEX_MEM_ZONE, list);
 }
 
 // -----------------------------------------------------------------------------
@@ -361,6 +417,59 @@ TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t* lhs,
   return list;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unionise multiple lists (a.k.a. logical OR)
+/// this will create a new list and leave the source lists untouched
+/// this is cheaper than unionising the lists pairwise when there are many
+/// of them, as is the case for prefix queries
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_t* TRI_UnioniseMultipleListFulltextIndex (TRI_fulltext_list_t const* const* sources,
+                                                            size_t numSources) {
+  uint64_t total = 0;
+
+  for (size_t i = 0; i < numSources; ++i) {
+    total += GetNumEntries(sources[i]);
+  }
+
+  if (total >= (uint64_t) SORTED_BIT) {
+    // the list size would not fit into the header
+    return nullptr;
+  }
+
+  TRI_fulltext_list_t* list = TRI_CreateListFulltextIndex((uint32_t) total);
+
+  if (list == nullptr) {
+    return nullptr;
+  }
+
+  TRI_fulltext_list_entry_t* listEntries = GetStart(list);
+  uint32_t listPos = 0;
+
+  for (size_t i = 0; i < numSources; ++i) {
+    uint32_t numEntries = GetNumEntries(sources[i]);
+
+    if (numEntries > 0) {
+      memcpy(listEntries + listPos, GetStart(sources[i]), numEntries * sizeof(TRI_fulltext_list_entry_t));
+      listPos += numEntries;
+    }
+  }
+
+  if (numSources > 1) {
+    // sort and remove duplicates in one go
+    std::sort(listEntries, listEntries + listPos);
+    listPos = (uint32_t) (std::unique(listEntries, listEntries + listPos) - listEntries);
+    SetIsSorted(list, true);
+  }
+  else if (numSources == 1) {
+    SetIsSorted(list, IsSorted(sources[0]));
+  }
+
+  SetNumEntries(list, listPos);
+
+  return list;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief intersect two lists (a.k.a. logical AND)
 /// this will create a new list and free both lhs & rhs
@@ -422,6 +531,42 @@ TRI_fulltext_list_t* TRI_IntersectListFulltextIndex (TRI_fulltext_list_t* lhs,
 
   listPos = 0;
   listEntries = GetStart(list);
+
+  if (numLhs / GALLOP_RATIO > numRhs || numRhs / GALLOP_RATIO > numLhs) {
+    // the lists differ a lot in size. walk the smaller list and gallop
+    // through the bigger one
+    TRI_fulltext_list_entry_t* smallEntries = lhsEntries;
+    TRI_fulltext_list_entry_t* bigEntries = rhsEntries;
+    uint32_t numSmall = numLhs;
+    uint32_t numBig = numRhs;
+
+    if (numLhs > numRhs) {
+      std::swap(smallEntries, bigEntries);
+      std::swap(numSmall, numBig);
+    }
+
+    uint32_t b = 0;
+    for (uint32_t s = 0; s < numSmall; ++s) {
+      TRI_fulltext_list_entry_t entry = smallEntries[s];
+
+      if (s > 0 && entry == smallEntries[s - 1]) {
+        continue;
+      }
+
+      b = Gallop(bigEntries, numBig, b, entry);
+      if (b >= numBig) {
+        break;
+      }
+
+      if (bigEntries[b] == entry) {
+        listEntries[listPos++] = entry;
+      }
+    }
+
+    l = numLhs;
+    r = numRhs;
+  }
+
   last = 0;
 
   while (true) {
@@ -496,6 +641,8 @@ TRI_fulltext_list_t* TRI_ExcludeListFulltextIndex (TRI_fulltext_list_t* list,
   }
 
   SortList(list);
+  // the exclusion list must be sorted too, otherwise entries would be missed
+  SortList(exclude);
 
   listEntries    = GetStart(list);
   excludeEntries = GetStart(exclude);
@@ -506,9 +653,7 @@ TRI_fulltext_list_t* TRI_ExcludeListFulltextIndex (TRI_fulltext_list_t* list,
     TRI_fulltext_list_entry_t entry;
 
     entry = listEntries[i];
-    while (j < numExclude && excludeEntries[j] < entry) {
-      ++j;
-    }
+    j = Gallop(excludeEntries, numExclude, j, entry);
 
     if (j < numExclude && excludeEntries[j] == entry) {
       // entry is contained in exclusion list
@@ -88,6 +88,14 @@ size_t TRI_MemoryListFulltextIndex (TRI_fulltext_list_t const*);
 TRI_fulltext_list_t* TRI_UnioniseListFulltextIndex (TRI_fulltext_list_t*,
                                                     TRI_fulltext_list_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unionise multiple lists
+/// this will create a new list and leave the source lists untouched
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_list_t* TRI_UnioniseMultipleListFulltextIndex (TRI_fulltext_list_t const* const*,
+                                                            size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief intersect two lists
 /// this will create a new list and free both lhs & rhs
@@ -303,6 +303,71 @@ bool TRI_SetQueryFulltextIndex (TRI_fulltext_query_t* query,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the words of a single document match a query
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_MatchQueryFulltextIndex (TRI_fulltext_query_t const* query,
+                                  TRI_vector_string_t const* words) {
+  // the index starts without a result, so the first word determines it
+  bool hasResult = false;
+  bool result = false;
+
+  for (size_t i = 0; i < query->_numWords; ++i) {
+    char const* word = query->_words[i];
+
+    if (word == nullptr) {
+      break;
+    }
+
+    TRI_fulltext_query_operation_e const operation = query->_operations[i];
+
+    if ((operation == TRI_FULLTEXT_AND || operation == TRI_FULLTEXT_EXCLUDE) &&
+        hasResult &&
+        ! result) {
+      continue;
+    }
+
+    if (operation == TRI_FULLTEXT_EXCLUDE && ! hasResult) {
+      // the index has nothing to exclude from and returns no documents
+      return false;
+    }
+
+    bool found = false;
+
+    if (words != nullptr) {
+      size_t const length = strlen(word);
+
+      for (size_t j = 0; j < words->_length && ! found; ++j) {
+        char const* other = words->_buffer[j];
+
+        if (query->_matches[i] == TRI_FULLTEXT_COMPLETE) {
+          found = (strcmp(other, word) == 0);
+        }
+        else if (query->_matches[i] == TRI_FULLTEXT_PREFIX) {
+          found = (strncmp(other, word, length) == 0);
+        }
+      }
+    }
+
+    if (! hasResult) {
+      result = found;
+      hasResult = true;
+    }
+    else if (operation == TRI_FULLTEXT_AND) {
+      result = (result && found);
+    }
+    else if (operation == TRI_FULLTEXT_OR) {
+      result = (result || found);
+    }
+    else {
+      result = (result && ! found);
+    }
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
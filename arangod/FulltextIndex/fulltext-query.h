@@ -32,6 +32,8 @@
 
 #include "Basics/Common.h"
 
+struct TRI_vector_string_s;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private defines
 // -----------------------------------------------------------------------------
@@ -122,6 +124,16 @@ bool TRI_SetQueryFulltextIndex (TRI_fulltext_query_t*,
                                 TRI_fulltext_query_match_e,
                                 TRI_fulltext_query_operation_e);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the words of a single document match a query
+/// the words must have been extracted with TRI_get_words, lower-cased and
+/// cut to TRI_FULLTEXT_MAX_WORD_LENGTH, as the index does. the operations
+/// are applied in the same order as TRI_QueryFulltextIndex does
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_MatchQueryFulltextIndex (TRI_fulltext_query_t const*,
+                                  struct TRI_vector_string_s const*);
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -337,7 +337,7 @@ int GeoIndexNewPot(GeoIx * gix)
         x=x/y;
         if(x>1000000000L) return -2;
         newpotct= (int) x;
-        gp = static_cast<GeoPot*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, gix->pots, newpotct * sizeof(GeoPot)));
+        gp = static_cast<GeoPot*>(TRI_Reallocate(TRI_GEO_INDEX_MEM_ZONE, gix->pots, newpotct * sizeof(GeoPot)));
 
         if (gp == NULL) {
           return -2;
@@ -382,15 +382,15 @@ GeoIndex * GeoIndex_new (void) {
     int i,j;
     double lat, lon, x, y, z;
 
-    gix = static_cast<GeoIx*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(GeoIx), false));
+    gix = static_cast<GeoIx*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, sizeof(GeoIx), false));
 
     if (gix == NULL) {
       return (GeoIndex *) gix;
     }
 
 /* try to allocate all the things we need  */
-    gix->pots       = static_cast<GeoPot*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, GEOPOTSTART * sizeof(GeoPot), false));
-    gix->gc         = static_cast<GeoCoordinate*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, GEOSLOTSTART * sizeof(GeoCoordinate), false));
+    gix->pots       = static_cast<GeoPot*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, GEOPOTSTART * sizeof(GeoPot), false));
+    gix->gc         = static_cast<GeoCoordinate*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, GEOSLOTSTART * sizeof(GeoCoordinate), false));
 
 /* if any of them fail, free the ones that succeeded  */
 /* and then return the NULL pointer for our user      */
@@ -398,14 +398,14 @@ GeoIndex * GeoIndex_new (void) {
          ( gix->gc         == NULL) )
     {
         if ( gix->pots       != NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix->pots);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix->pots);
         }
 
         if ( gix->gc         != NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix->gc);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix->gc);
         }
 
-        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix);
+        TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix);
 
         return NULL;
     }
@@ -595,9 +595,9 @@ void GeoIndex_free(GeoIndex * gi) {
     }
 
     gix = (GeoIx *) gi;
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix->gc);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix->pots);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gix);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix->gc);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix->pots);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gix);
 }
 /* =================================================== */
 /*        GeoMkHilbert   routine                       */
@@ -829,23 +829,23 @@ GeoResults * GeoResultsCons(int alloc)
       return NULL;
     }
 
-    gres = static_cast<GeoResults*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(GeoResults), false));
-    sa = static_cast<int*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, alloc*sizeof(int), false));
-    dd = static_cast<double*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, alloc*sizeof(double), false));
+    gres = static_cast<GeoResults*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, sizeof(GeoResults), false));
+    sa = static_cast<int*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, alloc*sizeof(int), false));
+    dd = static_cast<double*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, alloc*sizeof(double), false));
     if( (gres==NULL) ||
          (sa==NULL)  ||
          (dd==NULL)   )
     {
         if(gres!=NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gres);
         }
 
         if(sa!=NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, sa);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, sa);
         }
 
         if(dd!=NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, dd);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, dd);
         }
 
         return NULL;
@@ -956,8 +956,8 @@ int GeoResultsGrow(GeoResults * gr)
         /* otherwise grow by about 50%  */
     newsiz=gr->pointsct + (gr->pointsct/2) + 1;
     if(newsiz > 1000000000) return -1;
-    sa=static_cast<int*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, gr->slot, newsiz*sizeof(int)));
-    dd=static_cast<double*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, gr->snmd, newsiz*sizeof(double)));
+    sa=static_cast<int*>(TRI_Reallocate(TRI_GEO_INDEX_MEM_ZONE, gr->slot, newsiz*sizeof(int)));
+    dd=static_cast<double*>(TRI_Reallocate(TRI_GEO_INDEX_MEM_ZONE, gr->snmd, newsiz*sizeof(double)));
     if( (sa==NULL) || (dd==NULL) )
     {
         if(sa!=NULL) gr->slot = sa;
@@ -995,26 +995,26 @@ GeoCoordinates * GeoAnswers (GeoIx * gix, GeoResults * gr)
     double mole;
 
     if (gr->pointsct == 0) {
-      TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr->slot);
-      TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr->snmd);
-      TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr);
+      TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr->slot);
+      TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr->snmd);
+      TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr);
       return NULL;
     }
 
-    ans = static_cast<GeoCoordinates*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(GeoCoordinates), false));
-    gc  = static_cast<GeoCoordinate*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, gr->pointsct * sizeof(GeoCoordinate), false));
+    ans = static_cast<GeoCoordinates*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, sizeof(GeoCoordinates), false));
+    gc  = static_cast<GeoCoordinate*>(TRI_Allocate(TRI_GEO_INDEX_MEM_ZONE, gr->pointsct * sizeof(GeoCoordinate), false));
 
     if( (ans==NULL) || (gc==NULL) )
     {
         if(ans!=NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, ans);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, ans);
         }
         if(gc!=NULL) {
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, gc);
+          TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gc);
         }
-        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr->slot);
-        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr->snmd);
-        TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr);
+        TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr->slot);
+        TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr->snmd);
+        TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr);
         return NULL;
     }
     ans->length = gr->pointsct;
@@ -1038,8 +1038,8 @@ GeoCoordinates * GeoAnswers (GeoIx * gix, GeoResults * gr)
     }
     ans->distances = gr->snmd;
 
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr->slot);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gr);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr->slot);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gr);
 
     return ans;
 }
@@ -1145,9 +1145,9 @@ GeoCoordinates * GeoIndex_PointsWithinRadius(GeoIndex * gi,
                 r = GeoResultsGrow(gres);
                 if(r==-1)
                 {
-                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->snmd);
-                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres->slot);
-                    TRI_Free(TRI_UNKNOWN_MEM_ZONE, gres);
+                    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gres->snmd);
+                    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gres->slot);
+                    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, gres);
                     return NULL;
                 }
                 gres->slot[gres->pointsct]=slot;
@@ -1275,7 +1275,7 @@ int GeoIndexNewSlot(GeoIx * gix)
         x=x/y;
         if(x>2000000000L) return -2;
         newslotct= (int) x;
-        gc = static_cast<GeoCoordinate*>(TRI_Reallocate(TRI_UNKNOWN_MEM_ZONE, gix->gc, newslotct * sizeof(GeoCoordinate)));
+        gc = static_cast<GeoCoordinate*>(TRI_Reallocate(TRI_GEO_INDEX_MEM_ZONE, gix->gc, newslotct * sizeof(GeoCoordinate)));
 
         if (gc == NULL) {
           return -2;
@@ -2118,9 +2118,9 @@ int GeoIndex_remove(GeoIndex * gi, GeoCoordinate * c)
 /* =================================================== */
 void GeoIndex_CoordinatesFree(GeoCoordinates * clist)
 {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, clist->coordinates);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, clist->distances);
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, clist);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, clist->coordinates);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, clist->distances);
+    TRI_Free(TRI_GEO_INDEX_MEM_ZONE, clist);
 }
 /* =================================================== */
 /*            GeoIndex_hint does nothing!              */
@@ -33,6 +33,7 @@
 
 #include "Basics/FileUtils.h"
 #include "Basics/RandomGenerator.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/ReadLocker.h"
 #include "Basics/WriteLocker.h"
 #include "Basics/delete_object.h"
@@ -43,6 +44,8 @@
 #include "HttpServer/HttpHandlerFactory.h"
 #include "HttpServer/HttpServer.h"
 #include "HttpServer/HttpsServer.h"
+#include "HttpServer/MultiplexServer.h"
+#include "HttpServer/RequestCapture.h"
 #include "Rest/Version.h"
 #include "Scheduler/ApplicationScheduler.h"
 
@@ -97,20 +100,30 @@ ApplicationEndpointServer::ApplicationEndpointServer (ApplicationServer* applica
     _servers(),
     _basePath(),
     _endpointList(),
+    _multiplexEndpointList(),
     _httpPort(),
     _endpoints(),
+    _multiplexEndpoints(),
     _reuseAddress(true),
+    _reusePort(false),
     _keepAliveTimeout(300.0),
     _defaultApiCompatibility(0),
     _allowMethodOverride(false),
     _backlogSize(64),
+    _captureRequests(),
+    _captureRequestsLimit(0),
     _httpsKeyfile(),
     _cafile(),
     _sslProtocol(TLS_V1),
     _sslCache(false),
+    _sslSessionTimeout(300.0),
+    _sslSessionTickets(true),
+    _sslHandshakeThreads(0),
+    _sslKernelTls(false),
     _sslOptions((long) (SSL_OP_TLS_ROLLBACK_BUG | SSL_OP_CIPHER_SERVER_PREFERENCE)),
     _sslCipherList(""),
     _sslContext(nullptr),
+    _handshakePool(nullptr),
     _rctx() {
 
   // if our default value is too high, we'll use half of the max value provided by the system
@@ -137,6 +150,11 @@ ApplicationEndpointServer::~ApplicationEndpointServer () {
   for_each(_servers.begin(), _servers.end(), triagens::basics::DeleteObjectAny());
   _servers.clear();
 
+  if (_handshakePool != nullptr) {
+    delete _handshakePool;
+    _handshakePool = nullptr;
+  }
+
   if (_handlerFactory != nullptr) {
     delete _handlerFactory;
   }
@@ -168,6 +186,7 @@ bool ApplicationEndpointServer::buildServers () {
                           _jobManager,
                           _keepAliveTimeout);
 
+  server->setReusePort(_reusePort);
   server->setEndpointList(&_endpointList);
   _servers.push_back(server);
 
@@ -180,17 +199,38 @@ bool ApplicationEndpointServer::buildServers () {
     }
 
     // https
-    server = new HttpsServer(_applicationScheduler->scheduler(),
-                             _applicationDispatcher->dispatcher(),
-                             _handlerFactory,
-                             _jobManager,
-                             _keepAliveTimeout,
-                             _sslContext);
+    HttpsServer* httpsServer = new HttpsServer(_applicationScheduler->scheduler(),
+                                               _applicationDispatcher->dispatcher(),
+                                               _handlerFactory,
+                                               _jobManager,
+                                               _keepAliveTimeout,
+                                               _sslContext);
+    server = httpsServer;
+
+    if (_sslHandshakeThreads > 0) {
+      _handshakePool = new triagens::basics::ThreadPool(_sslHandshakeThreads, "SslHandshake");
+      httpsServer->setHandshakePool(_handshakePool);
+      LOG_DEBUG("using %d threads for SSL handshakes", (int) _sslHandshakeThreads);
+    }
 
+    server->setReusePort(_reusePort);
     server->setEndpointList(&_endpointList);
     _servers.push_back(server);
   }
 
+  // multiplexed endpoints
+  if (! _multiplexEndpointList.empty()) {
+    server = new MultiplexServer(_applicationScheduler->scheduler(),
+                                 _applicationDispatcher->dispatcher(),
+                                 _handlerFactory,
+                                 _jobManager,
+                                 _keepAliveTimeout);
+
+    server->setReusePort(_reusePort);
+    server->setEndpointList(&_multiplexEndpointList);
+    _servers.push_back(server);
+  }
+
   return true;
 }
 
@@ -210,14 +250,18 @@ void ApplicationEndpointServer::setupOptions (map<string, ProgramOptionsDescript
 
   options["Server Options:help-default"]
     ("server.endpoint", &_endpoints, "endpoint for client requests (e.g. \"tcp://127.0.0.1:8529\", or \"ssl://192.168.1.1:8529\")")
+    ("server.multiplex-endpoint", &_multiplexEndpoints, "endpoint for client requests using the multiplexed binary protocol (e.g. \"tcp://127.0.0.1:8539\")")
   ;
 
   options["Server Options:help-admin"]
     ("server.allow-method-override", &_allowMethodOverride, "allow HTTP method override using special headers")
     ("server.backlog-size", &_backlogSize, "listen backlog size")
+    ("server.capture-requests", &_captureRequests, "file to capture incoming requests in for a replay with arangob")
+    ("server.capture-requests-limit", &_captureRequestsLimit, "maximal number of requests to capture (0 = no limit)")
     ("server.default-api-compatibility", &_defaultApiCompatibility, "default API compatibility version")
     ("server.keep-alive-timeout", &_keepAliveTimeout, "keep-alive timeout in seconds")
     ("server.reuse-address", &_reuseAddress, "try to reuse address")
+    ("server.reuse-port", &_reusePort, "open one listen socket per scheduler thread using SO_REUSEPORT")
   ;
 
   options["SSL Options:help-ssl"]
@@ -225,6 +269,10 @@ void ApplicationEndpointServer::setupOptions (map<string, ProgramOptionsDescript
     ("server.cafile", &_cafile, "file containing the CA certificates of clients")
     ("server.ssl-protocol", &_sslProtocol, "1 = SSLv2, 2 = SSLv23, 3 = SSLv3, 4 = TLSv1")
     ("server.ssl-cache", &_sslCache, "use SSL session caching")
+    ("server.ssl-session-timeout", &_sslSessionTimeout, "number of seconds an SSL session can be resumed")
+    ("server.ssl-session-tickets", &_sslSessionTickets, "issue SSL session tickets")
+    ("server.ssl-handshake-threads", &_sslHandshakeThreads, "number of threads doing SSL handshakes (0 = scheduler threads)")
+    ("server.ssl-kernel-tls", &_sslKernelTls, "let the kernel encrypt sent data after the SSL handshake")
     ("server.ssl-options", &_sslOptions, "SSL options, see OpenSSL documentation")
     ("server.ssl-cipher-list", &_sslCipherList, "SSL cipher list, see OpenSSL documentation")
   ;
@@ -250,6 +298,13 @@ bool ApplicationEndpointServer::afterOptionParsing (ProgramOptions& options) {
     LOG_WARNING("value for --server.backlog-size exceeds default system header SOMAXCONN value %d. trying to use %d anyway", (int) SOMAXCONN, (int) SOMAXCONN);
   }
 
+#if defined(_WIN32) || ! defined(SO_REUSEPORT)
+  if (_reusePort) {
+    LOG_WARNING("--server.reuse-port is not supported on this platform, ignoring it");
+    _reusePort = false;
+  }
+#endif
+
   if (! _httpPort.empty()) {
     // issue #175: add hidden option --server.http-port for downwards-compatibility
     string httpEndpoint("tcp://" + _httpPort);
@@ -267,6 +322,18 @@ bool ApplicationEndpointServer::afterOptionParsing (ProgramOptions& options) {
     }
   }
 
+  for (auto const& it : _multiplexEndpoints) {
+    bool ok = _multiplexEndpointList.add(it, dbNames, _backlogSize, _reuseAddress);
+
+    if (! ok) {
+      LOG_FATAL_AND_EXIT("invalid multiplex endpoint '%s'", it.c_str());
+    }
+  }
+
+  if (_multiplexEndpointList.has(Endpoint::ENCRYPTION_SSL)) {
+    LOG_FATAL_AND_EXIT("ssl endpoints cannot be used with --server.multiplex-endpoint");
+  }
+
   if (_defaultApiCompatibility < HttpRequest::MinCompatibility) {
     LOG_FATAL_AND_EXIT("invalid value for --server.default-api-compatibility. minimum allowed value is %d",
                        (int) HttpRequest::MinCompatibility);
@@ -378,6 +445,10 @@ bool ApplicationEndpointServer::prepare () {
   // dump all endpoints for user information
   _endpointList.dump();
 
+  for (auto const& it : _multiplexEndpointList.getAll()) {
+    LOG_INFO("using endpoint '%s' for multiplexed requests", it.first.c_str());
+  }
+
   _handlerFactory = new HttpHandlerFactory(_authenticationRealm,
                                            _defaultApiCompatibility,
                                            _allowMethodOverride,
@@ -398,6 +469,12 @@ bool ApplicationEndpointServer::open () {
     return true;
   }
 
+  if (! _captureRequests.empty()) {
+    if (! RequestCapture::start(_captureRequests, _captureRequestsLimit)) {
+      LOG_FATAL_AND_EXIT("cannot capture requests in '%s'", _captureRequests.c_str());
+    }
+  }
+
   for (auto& server : _servers) {
     server->startListening();
   }
@@ -432,6 +509,10 @@ void ApplicationEndpointServer::stop () {
   for (auto& server : _servers) {
     server->stop();
   }
+
+  if (! _captureRequests.empty()) {
+    RequestCapture::stop();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -475,10 +556,27 @@ bool ApplicationEndpointServer::createSslContext () {
     LOG_TRACE("using SSL session caching");
   }
 
+  if (_sslSessionTimeout > 0.0) {
+    SSL_CTX_set_timeout(_sslContext, (long) _sslSessionTimeout);
+  }
+
   // set options
   SSL_CTX_set_options(_sslContext, (long) _sslOptions);
   LOG_INFO("using SSL options: %ld", (long) _sslOptions);
 
+  if (! _sslSessionTickets) {
+    SSL_CTX_set_options(_sslContext, SSL_OP_NO_TICKET);
+  }
+
+  if (_sslKernelTls) {
+#ifdef SSL_OP_ENABLE_KTLS
+    SSL_CTX_set_options(_sslContext, SSL_OP_ENABLE_KTLS);
+    LOG_INFO("using kernel TLS where available");
+#else
+    LOG_WARNING("kernel TLS is not supported by this OpenSSL version, ignoring --server.ssl-kernel-tls");
+#endif
+  }
+
   if (_sslCipherList.size() > 0) {
     if (SSL_CTX_set_cipher_list(_sslContext, _sslCipherList.c_str()) != 1) {
       LOG_ERROR("SSL error: %s", lastSSLError().c_str());
@@ -44,6 +44,10 @@
 // -----------------------------------------------------------------------------
 
 namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+
   namespace rest {
     class ApplicationDispatcher;
     class ApplicationScheduler;
@@ -263,6 +267,12 @@ namespace triagens {
 
         rest::EndpointList _endpointList;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief endpoint list container for the multiplexed binary protocol
+////////////////////////////////////////////////////////////////////////////////
+
+        rest::EndpointList _multiplexEndpointList;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief deprecated hidden option for downwards compatibility
 ////////////////////////////////////////////////////////////////////////////////
@@ -310,6 +320,31 @@ namespace triagens {
 
         std::vector<std::string> _endpoints;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief endpoints for the multiplexed binary protocol
+/// @startDocuBlock serverMultiplexEndpoint
+/// `--server.multiplex-endpoint endpoint`
+///
+/// Specifies an *endpoint* that speaks the multiplexed binary protocol
+/// instead of HTTP/1.1. A client connection to such an endpoint carries
+/// many concurrent requests as independent streams, using HTTP/2 framing
+/// and header compression, and responses are returned as soon as they are
+/// ready, in any order. The requests are handled exactly like HTTP requests.
+///
+/// Only *tcp://* and *unix://* endpoints can be used. The option can be
+/// repeated multiple times.
+///
+/// @EXAMPLES
+///
+/// ```
+/// unix> ./arangod --server.endpoint tcp://127.0.0.1:8529
+///                 --server.multiplex-endpoint tcp://127.0.0.1:8539 /tmp/vocbase
+/// ```
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _multiplexEndpoints;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief try to reuse address
 /// @startDocuBlock serverReuseAddress
@@ -332,6 +367,27 @@ namespace triagens {
 
         bool _reuseAddress;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief open one listen socket per scheduler thread
+/// @startDocuBlock serverReusePort
+/// `--server.reuse-port`
+///
+/// If this boolean option is set to *true*, every scheduler thread opens
+/// its own listen socket for each TCP endpoint, using the socket option
+/// SO_REUSEPORT. The kernel then distributes incoming connections among
+/// these sockets, and each connection is served by the scheduler thread
+/// that accepted it. This avoids funnelling all accepts through a single
+/// thread on machines with many cores.
+///
+/// The option is *false* by default. It is ignored with a warning on
+/// operating systems that do not support SO_REUSEPORT, and it has no
+/// effect on unix domain socket endpoints or with a single scheduler
+/// thread.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _reusePort;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief timeout for HTTP keep-alive
 /// @startDocuBlock keep_alive_timeout
@@ -416,6 +472,36 @@ namespace triagens {
 
         int _backlogSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief file to capture the incoming requests in
+/// @startDocuBlock serverCaptureRequests
+/// `--server.capture-requests filename`
+///
+/// Writes every incoming HTTP request as one line of JSON to *filename*:
+/// its arrival time, method, database, URL and body. The file can be
+/// replayed against a server with *arangob --replay filename*.
+///
+/// Request headers are not captured, but request bodies are, so the file
+/// contains the data sent by the clients.
+///
+/// The default is to not capture any requests.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _captureRequests;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of requests to capture
+/// @startDocuBlock serverCaptureRequestsLimit
+/// `--server.capture-requests-limit`
+///
+/// Stops the capture after this many requests. The default value 0 means
+/// no limit.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _captureRequestsLimit;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief keyfile containing server certificate
 /// @startDocuBlock serverKeyfile
@@ -530,6 +616,68 @@ namespace triagens {
 
         bool _sslCache;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lifetime of SSL sessions
+/// @startDocuBlock serverSSLSessionTimeout
+/// `--server.ssl-session-timeout value`
+///
+/// The number of seconds a client can resume an SSL session, with a session
+/// id from the session cache or with a session ticket. A resumed session
+/// skips the expensive part of the handshake.
+///
+/// *value* has a default value of *300*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _sslSessionTimeout;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not to issue session tickets
+/// @startDocuBlock serverSSLSessionTickets
+/// `--server.ssl-session-tickets value`
+///
+/// Set to true if the server should hand out session tickets (RFC 5077), with
+/// which clients can resume sessions without a server-side session cache.
+///
+/// *value* has a default value of *true*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _sslSessionTickets;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of threads doing SSL handshakes
+/// @startDocuBlock serverSSLHandshakeThreads
+/// `--server.ssl-handshake-threads value`
+///
+/// The number of threads that do the SSL handshakes of new connections. With
+/// a value of *0*, the handshakes are done by the scheduler threads, so many
+/// clients connecting at the same time delay the requests of established
+/// connections.
+///
+/// *value* has a default value of *0*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _sslHandshakeThreads;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not to use kernel TLS
+/// @startDocuBlock serverSSLKernelTls
+/// `--server.ssl-kernel-tls value`
+///
+/// Set to true to let the Linux kernel encrypt the data sent on SSL
+/// connections after the handshake (kTLS). Responses are then written with
+/// the same gathering writes as on unencrypted connections. This needs
+/// OpenSSL 3.0 or higher built with kTLS support and the tls kernel module,
+/// connections fall back to encryption by OpenSSL otherwise.
+///
+/// *value* has a default value of *false*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _sslKernelTls;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ssl options to use
 /// @startDocuBlock serverSSLOptions
@@ -601,6 +749,12 @@ namespace triagens {
 
         SSL_CTX* _sslContext;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pool doing the SSL handshakes
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _handshakePool;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief random string used for initialization
 ////////////////////////////////////////////////////////////////////////////////
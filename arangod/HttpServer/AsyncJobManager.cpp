@@ -30,10 +30,14 @@
 #include "AsyncJobManager.h"
 
 #include "Basics/ReadLocker.h"
+#include "Basics/StringUtils.h"
 #include "Basics/WriteLocker.h"
+#include "Basics/files.h"
 #include "Basics/logging.h"
+#include "Basics/tri-strings.h"
 #include "HttpServer/HttpHandler.h"
 #include "HttpServer/HttpServerJob.h"
+#include "Rest/HttpResponse.h"
 
 using namespace triagens::basics;
 using namespace triagens::rest;
@@ -124,7 +128,11 @@ AsyncJobResult::AsyncJobResult ()
     _response(nullptr),
     _stamp(0.0),
     _status(JOB_UNDEFINED),
-    _ctx(nullptr) {
+    _ctx(nullptr),
+    _database(),
+    _size(0),
+    _spillFile(),
+    _expiryTimer() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,7 +148,11 @@ AsyncJobResult::AsyncJobResult (IdType jobId,
     _response(response),
     _stamp(stamp),
     _status(status),
-    _ctx(ctx) {
+    _ctx(ctx),
+    _database(),
+    _size(0),
+    _spillFile(),
+    _expiryTimer() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -165,6 +177,12 @@ AsyncJobResult::~AsyncJobResult () {
 AsyncJobManager::AsyncJobManager (generate_fptr idFunc, callback_fptr callback)
   : _lock(),
     _jobs(),
+    _memoryUsage(),
+    _maxMemory(0),
+    _ttl(0.0),
+    _spillSize(0),
+    _spillPath(),
+    _expiries(static_cast<uint64_t>(TRI_microtime())),
     generate(idFunc),
     callback(callback) {
 }
@@ -182,35 +200,81 @@ AsyncJobManager::~AsyncJobManager () {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the limits for stored results
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::setLimits (uint64_t maxMemory,
+                                 double ttl,
+                                 uint64_t spillSize) {
+  string spillPath;
+
+  if (spillSize > 0) {
+    char* tempPath = TRI_GetUserTempPath();
+
+    if (tempPath != nullptr) {
+      spillPath = tempPath;
+      TRI_FreeString(TRI_CORE_MEM_ZONE, tempPath);
+    }
+  }
+
+  WRITE_LOCKER(_lock);
+
+  _maxMemory = maxMemory;
+  _ttl = ttl;
+  _spillSize = spillPath.empty() ? 0 : spillSize;
+  _spillPath = spillPath;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the result of an async job
+///
+/// The stored response is handed out as is, so its body is not copied. A
+/// spilled body is read straight into the response buffer.
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpResponse* AsyncJobManager::getJobResult (AsyncJobResult::IdType jobId,
                                              AsyncJobResult::Status& status,
                                              bool removeFromList) {
-  WRITE_LOCKER(_lock);
+  HttpResponse* response;
+  string spillFile;
 
-  auto it = _jobs.find(jobId);
+  {
+    WRITE_LOCKER(_lock);
 
-  if (it == _jobs.end()) {
-    status = AsyncJobResult::JOB_UNDEFINED;
-    return nullptr;
-  }
+    auto it = _jobs.find(jobId);
 
-  HttpResponse* response = (*it).second._response;
-  status = (*it).second._status;
+    if (it == _jobs.end()) {
+      status = AsyncJobResult::JOB_UNDEFINED;
+      return nullptr;
+    }
+
+    response = (*it).second._response;
+    status = (*it).second._status;
+
+    if (status == AsyncJobResult::JOB_PENDING) {
+      return nullptr;
+    }
 
-  if (status == AsyncJobResult::JOB_PENDING) {
-    return nullptr;
+    if (! removeFromList) {
+      return nullptr;
+    }
+
+    // remove the job from the list, but keep response and spill file
+    spillFile = (*it).second._spillFile;
+    (*it).second._spillFile.clear();
+
+    removeJobResult(it, false);
   }
 
-  if (! removeFromList) {
-    return nullptr;
+  if (! spillFile.empty()) {
+    if (response != nullptr) {
+      loadResponse(spillFile, response);
+    }
+
+    TRI_UnlinkFile(spillFile.c_str());
   }
 
-  // remove the job from the list
-  _jobs.erase(it);
   return response;
 }
 
@@ -227,14 +291,8 @@ bool AsyncJobManager::deleteJobResult (AsyncJobResult::IdType jobId) {
     return false;
   }
 
-  HttpResponse* response = (*it).second._response;
-
-  if (response != nullptr) {
-    delete response;
-  }
-
   // remove the job from the list
-  _jobs.erase(it);
+  removeJobResult(it, true);
   return true;
 }
 
@@ -248,16 +306,10 @@ void AsyncJobManager::deleteJobResults () {
   auto it = _jobs.begin();
 
   while (it != _jobs.end()) {
-    HttpResponse* response = (*it).second._response;
-
-    if (response != nullptr) {
-      delete response;
-    }
-
-    ++it;
+    it = removeJobResult(it, true);
   }
 
-  _jobs.clear();
+  _memoryUsage.clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -270,16 +322,8 @@ void AsyncJobManager::deleteExpiredJobResults (double stamp) {
   auto it = _jobs.begin();
 
   while (it != _jobs.end()) {
-    AsyncJobResult ajr = (*it).second;
-
-    if (ajr._stamp < stamp) {
-      HttpResponse* response = ajr._response;
-
-      if (response != nullptr) {
-        delete response;
-      }
-
-      _jobs.erase(it++);
+    if ((*it).second._stamp < stamp) {
+      it = removeJobResult(it, true);
     }
     else {
       ++it;
@@ -351,8 +395,10 @@ void AsyncJobManager::initAsyncJob (HttpServerJob* job, uint64_t* jobId) {
 
   AsyncCallbackContext* ctx = nullptr;
 
+  HttpRequest const* request = job->handler()->getRequest();
+
   bool found;
-  char const* hdr = job->handler()->getRequest()->header("x-arango-coordinator", found);
+  char const* hdr = request->header("x-arango-coordinator", found);
 
   if (found) {
     LOG_DEBUG("Found header X-Arango-Coordinator in async request");
@@ -365,6 +411,8 @@ void AsyncJobManager::initAsyncJob (HttpServerJob* job, uint64_t* jobId) {
                      AsyncJobResult::JOB_PENDING,
                      ctx);
 
+  ajr._database = request->databaseName();
+
   WRITE_LOCKER(_lock);
 
   _jobs.emplace(*jobId, ajr);
@@ -386,12 +434,11 @@ void AsyncJobManager::finishAsyncJob (HttpServerJob* job) {
     return;
   }
 
-  double const now = TRI_microtime();
   AsyncCallbackContext* ctx = nullptr;
-  HttpResponse* response    = nullptr;
+  uint64_t spillSize;
 
   {
-    WRITE_LOCKER(_lock);
+    READ_LOCKER(_lock);
     auto it = _jobs.find(jobId);
 
     if (it == _jobs.end()) {
@@ -400,20 +447,69 @@ void AsyncJobManager::finishAsyncJob (HttpServerJob* job) {
       // which will also dispose the response
       return;
     }
-    else {
-      response = handler->stealResponse();
 
-      (*it).second._response = response;
-      (*it).second._status = AsyncJobResult::JOB_DONE;
-      (*it).second._stamp = now;
+    ctx = (*it).second._ctx;
+    spillSize = _spillSize;
+  }
+
+  HttpResponse* response = handler->stealResponse();
+  size_t size = (response == nullptr) ? 0 : response->body().length();
+  string spillFile;
+
+  // large results are written to disk before they become visible, so that
+  // no client can fetch the response while its body is being written
+  if (ctx == nullptr && spillSize > 0 && size >= spillSize) {
+    spillFile = spillResponse(jobId, response);
+
+    if (! spillFile.empty()) {
+      size = 0;
+    }
+  }
+
+  double const now = TRI_microtime();
+
+  {
+    WRITE_LOCKER(_lock);
+    auto it = _jobs.find(jobId);
+
+    if (it == _jobs.end()) {
+      // job was deleted in the meantime
+      if (response != nullptr) {
+        delete response;
+      }
+
+      if (! spillFile.empty()) {
+        TRI_UnlinkFile(spillFile.c_str());
+      }
+
+      return;
+    }
+
+    (*it).second._response = response;
+    (*it).second._status = AsyncJobResult::JOB_DONE;
+    (*it).second._stamp = now;
 
-      ctx = (*it).second._ctx;
+    if (ctx != nullptr) {
+      // we have found a context object, so we can immediately remove the job
+      // from the list of "done" jobs
+      _jobs.erase(it);
+    }
+    else {
+      std::string const database = (*it).second._database;
+
+      (*it).second._size = size;
+      (*it).second._spillFile = spillFile;
+      _memoryUsage[database] += size;
 
-      if (ctx != nullptr) {
-        // we have found a context object, so we can immediately remove the job
-        // from the list of "done" jobs
-        _jobs.erase(it);
+      if (_ttl > 0.0) {
+        // round up, so the result is not removed before the ttl has passed
+        AsyncJobResult& ajr = (*it).second;
+        ajr._expiryTimer.setData(&ajr);
+        _expiries.insert(&ajr._expiryTimer, static_cast<uint64_t>(std::ceil(now + _ttl)));
       }
+
+      evictJobResults(database);
+      expireJobResults(now);
     }
   }
 
@@ -433,6 +529,186 @@ void AsyncJobManager::finishAsyncJob (HttpServerJob* job) {
   }
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a result from the list, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+AsyncJobManager::JobList::iterator AsyncJobManager::removeJobResult (JobList::iterator it,
+                                                                     bool deleteResponse) {
+  AsyncJobResult& ajr = (*it).second;
+
+  if (ajr._size > 0) {
+    auto mem = _memoryUsage.find(ajr._database);
+
+    if (mem != _memoryUsage.end()) {
+      if ((*mem).second <= ajr._size) {
+        _memoryUsage.erase(mem);
+      }
+      else {
+        (*mem).second -= ajr._size;
+      }
+    }
+  }
+
+  if (! ajr._spillFile.empty()) {
+    TRI_UnlinkFile(ajr._spillFile.c_str());
+  }
+
+  if (deleteResponse && ajr._response != nullptr) {
+    delete ajr._response;
+  }
+
+  _expiries.remove(&ajr._expiryTimer);
+
+  return _jobs.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evicts the oldest done results of a database until it is within
+/// the memory limit, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::evictJobResults (std::string const& database) {
+  if (_maxMemory == 0) {
+    return;
+  }
+
+  auto mem = _memoryUsage.find(database);
+
+  if (mem == _memoryUsage.end() || (*mem).second <= _maxMemory) {
+    return;
+  }
+
+  uint64_t excess = (*mem).second - _maxMemory;
+
+  // collect the in-memory results of the database, oldest first
+  vector<pair<double, AsyncJobResult::IdType>> candidates;
+
+  for (auto const& it : _jobs) {
+    AsyncJobResult const& ajr = it.second;
+
+    if (ajr._status == AsyncJobResult::JOB_DONE &&
+        ajr._size > 0 &&
+        ajr._database == database) {
+      candidates.emplace_back(ajr._stamp, ajr._jobId);
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+
+  size_t evicted = 0;
+
+  for (auto const& candidate : candidates) {
+    auto it = _jobs.find(candidate.second);
+    size_t const size = (*it).second._size;
+
+    removeJobResult(it, true);
+    ++evicted;
+
+    if (size >= excess) {
+      break;
+    }
+
+    excess -= size;
+  }
+
+  LOG_WARNING("evicted %d async job result(s) of database '%s', memory limit of %llu bytes exceeded",
+              (int) evicted,
+              database.c_str(),
+              (unsigned long long) _maxMemory);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes done results older than the ttl, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::expireJobResults (double now) {
+  // only the results whose timers have expired are looked at, and the wheel
+  // only moves once per second
+  _expiries.advance(static_cast<uint64_t>(now), [&] (TimerWheel::Timer* timer) {
+    AsyncJobResult* ajr = static_cast<AsyncJobResult*>(timer->data());
+    auto it = _jobs.find(ajr->_jobId);
+
+    TRI_ASSERT(it != _jobs.end());
+    removeJobResult(it, true);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the body of a response to a file and frees it
+///
+/// Returns the name of the file, or an empty string if the body stays in
+/// memory.
+////////////////////////////////////////////////////////////////////////////////
+
+string AsyncJobManager::spillResponse (AsyncJobResult::IdType jobId,
+                                       HttpResponse* response) {
+  string const name = "async-job-" + StringUtils::itoa(jobId);
+  char* path = TRI_Concatenate2File(_spillPath.c_str(), name.c_str());
+
+  if (path == nullptr) {
+    return "";
+  }
+
+  string const filename(path);
+  TRI_FreeString(TRI_CORE_MEM_ZONE, path);
+
+  StringBuffer& body = response->body();
+
+  int res = TRI_WriteFile(filename.c_str(), body.c_str(), body.length());
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    LOG_WARNING("cannot spill result of async job %llu to '%s': %s",
+                (unsigned long long) jobId,
+                filename.c_str(),
+                TRI_errno_string(res));
+    TRI_UnlinkFile(filename.c_str());
+    return "";
+  }
+
+  // release the memory of the body, the headers stay in memory
+  StringBuffer empty(TRI_UNKNOWN_MEM_ZONE);
+  body.swap(&empty);
+
+  return filename;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a spilled body back into its response
+////////////////////////////////////////////////////////////////////////////////
+
+void AsyncJobManager::loadResponse (std::string const& filename,
+                                    HttpResponse* response) {
+  StringBuffer& body = response->body();
+  int64_t size = TRI_SizeFile(filename.c_str());
+  bool ok = false;
+
+  if (size >= 0 && body.reserve((size_t) size) == TRI_ERROR_NO_ERROR) {
+    int fd = TRI_OPEN(filename.c_str(), O_RDONLY);
+
+    if (fd >= 0) {
+      // read directly into the response buffer
+      ok = TRI_ReadPointer(fd, body.end(), (size_t) size);
+      TRI_CLOSE(fd);
+
+      if (ok) {
+        body.increaseLength((size_t) size);
+      }
+    }
+  }
+
+  if (! ok) {
+    LOG_ERROR("cannot read spilled async job result from '%s'", filename.c_str());
+
+    body.clear();
+    response->setResponseCode(HttpResponse::SERVER_ERROR);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
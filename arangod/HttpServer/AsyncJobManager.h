@@ -32,6 +32,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/ReadWriteLock.h"
+#include "Basics/TimerWheel.h"
 
 namespace triagens {
   namespace rest {
@@ -131,6 +132,30 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         AsyncCallbackContext* _ctx;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief name of the database the job was started in
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _database;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of body bytes the result keeps in memory
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _size;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief file holding the body if it was spilled to disk, empty otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _spillFile;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief expiry timer of a done result, if there is a ttl
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::TimerWheel::Timer _expiryTimer;
     };
 
 // -----------------------------------------------------------------------------
@@ -191,6 +216,18 @@ namespace triagens {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the limits for stored results
+///
+/// maxMemory is the number of body bytes kept per database (0 = unlimited),
+/// ttl is the number of seconds a done result is kept (0 = until fetched),
+/// bodies of spillSize bytes or more are written to the temp path (0 = off).
+////////////////////////////////////////////////////////////////////////////////
+
+        void setLimits (uint64_t maxMemory,
+                        double ttl,
+                        uint64_t spillSize);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the result of an async job
 ////////////////////////////////////////////////////////////////////////////////
@@ -248,6 +285,43 @@ namespace triagens {
 
         void finishAsyncJob (HttpServerJob*);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a result from the list, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        JobList::iterator removeJobResult (JobList::iterator, bool deleteResponse);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evicts the oldest done results of a database until it is within
+/// the memory limit, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void evictJobResults (std::string const& database);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes done results older than the ttl, must hold the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void expireJobResults (double now);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the body of a response to a file and frees it
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string spillResponse (AsyncJobResult::IdType, HttpResponse*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a spilled body back into its response
+////////////////////////////////////////////////////////////////////////////////
+
+        void loadResponse (std::string const& filename, HttpResponse*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -266,6 +340,42 @@ namespace triagens {
 
         JobList _jobs;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief body bytes kept in memory per database
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<std::string, uint64_t> _memoryUsage;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of body bytes kept in memory per database
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _maxMemory;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of seconds a done result is kept
+////////////////////////////////////////////////////////////////////////////////
+
+        double _ttl;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimum body size for spilling to disk
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _spillSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief directory for spilled bodies
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _spillPath;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief expiry timers of the done results, with a tick of one second
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::TimerWheel _expiries;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief function pointer for id generation
 ////////////////////////////////////////////////////////////////////////////////
@@ -36,6 +36,7 @@
 #include "HttpServer/HttpHandlerFactory.h"
 #include "HttpServer/HttpServer.h"
 #include "HttpServer/HttpServerJob.h"
+#include "HttpServer/RequestCapture.h"
 #include "Scheduler/Scheduler.h"
 
 using namespace triagens::basics;
@@ -85,10 +86,8 @@ int AsyncChunkedTask::signalChunk (std::string const& data) {
 
       TRI_ASSERT(_data != nullptr);
 
-      _data->appendHex(data.size());
-      _data->appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
+      // the output task encodes the chunks for its protocol
       _data->appendText(data.c_str(), data.size());
-      _data->appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
     }
   }
 
@@ -145,6 +144,13 @@ bool AsyncChunkedTask::handleEvent (EventToken token,
 bool AsyncChunkedTask::handleAsync () {
   MUTEX_LOCKER(_dataLock);
 
+  if (! _output->isChunked()) {
+    // the response has not been handled yet. a producer may signal chunks
+    // as soon as it has created the response. they are delivered when the
+    // response is handled
+    return true;
+  }
+
   if (_data != nullptr) {
     _output->sendChunk(_data);
     _data = nullptr;
@@ -177,6 +183,24 @@ void AsyncChunkedTask::signal () {
 size_t const HttpCommTask::MaximalHeaderSize   =    1 * 1024 * 1024; //   1 MB
 size_t const HttpCommTask::MaximalBodySize     =  512 * 1024 * 1024; // 512 MB
 size_t const HttpCommTask::MaximalPipelineSize = 1024 * 1024 * 1024; //   1 GB
+size_t const HttpCommTask::MaximalPipelineRequests = 64;
+size_t const HttpCommTask::MinimalSeparateBodySize = 64 * 1024;     //  64 KB
+size_t const HttpCommTask::MinimalPooledBufferSize =  4 * 1024;     //   4 KB
+size_t const HttpCommTask::MaximalPooledBufferSize =  1 * 1024 * 1024; // 1 MB
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write buffers released by the tasks of a scheduler thread, for
+/// reuse by the next responses of the thread
+///
+/// the buffers of a thread are not freed when it ends, which only happens
+/// on shutdown
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const NumPooledBuffers = 4;
+
+static thread_local StringBuffer* PooledBuffers[NumPooledBuffers];
+
+static thread_local size_t NumPooled = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructs a new task
@@ -190,26 +214,32 @@ HttpCommTask::HttpCommTask (HttpServer* server,
     SocketTask(socket, keepAliveTimeout),
     _connectionInfo(info),
     _server(server),
-    _watcher(nullptr),
-    _job(nullptr),
-    _handler(nullptr),
+    _finishedJobs(),
+    _finishedJobsLock(),
     _writeBuffers(),
     _writeBuffersStats(),
-    _readPosition(0),
-    _bodyPosition(0),
-    _bodyLength(0),
-    _requestPending(false),
     _closeRequested(false),
-    _readRequestBody(false),
     _denyCredentials(false),
     _acceptDeflate(false),
-    _newRequest(true),
     _isChunked(false),
+    _chunkedBacklog(0),
+    _writeBufferLength(0),
     _request(nullptr),
     _httpVersion(HttpRequest::HTTP_UNKNOWN),
     _requestType(HttpRequest::HTTP_REQUEST_ILLEGAL),
     _fullUrl(),
     _origin(),
+    _watcher(nullptr),
+    _pipeline(),
+    _currentResponse(0),
+    _lastResponse(0),
+    _chunkedResponse(0),
+    _readPosition(0),
+    _bodyPosition(0),
+    _bodyLength(0),
+    _requestPending(false),
+    _readRequestBody(false),
+    _newRequest(true),
     _startPosition(0),
     _sinceCompactification(0),
     _originalBodyLength(0),
@@ -238,16 +268,33 @@ HttpCommTask::HttpCommTask (HttpServer* server,
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpCommTask::~HttpCommTask () {
-  if (_job != nullptr) {
-    _job->beginShutdown();
-    clearCurrentJob();
+  for (auto& job : releaseJobs()) {
+    job->beginShutdown();
   }
 
-  delete _handler;
+  {
+    MUTEX_LOCKER(_finishedJobsLock);
+
+    for (auto& it : _finishedJobs) {
+      delete it.second;
+    }
+    _finishedJobs.clear();
+  }
 
   LOG_TRACE("connection closed, client %d",
             (int) TRI_get_fd_or_handle_of_socket(_commSocket));
 
+  // free unwritten responses
+  for (auto& response : _pipeline) {
+    for (auto& i : response._buffers) {
+      delete i;
+    }
+
+    if (response._statistics != nullptr) {
+      TRI_ReleaseRequestStatistics(response._statistics);
+    }
+  }
+
   // free write buffers
   for (auto& i : _writeBuffers) {
     delete i;
@@ -265,11 +312,67 @@ HttpCommTask::~HttpCommTask () {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands back the handler of a finished job
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::setHandler (HttpServerJob* job,
+                               HttpHandler* handler) {
+  TRI_ASSERT(job != nullptr);
+  TRI_ASSERT(handler != nullptr);
+
+  MUTEX_LOCKER(_finishedJobsLock);
+  _finishedJobs.emplace_back(job, handler);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all jobs from the task and returns them
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<HttpServerJob*> HttpCommTask::releaseJobs () {
+  std::vector<HttpServerJob*> jobs;
+
+  for (auto& response : _pipeline) {
+    if (response._job != nullptr) {
+      jobs.emplace_back(response._job);
+      response._job = nullptr;
+    }
+  }
+
+  return jobs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the job of the current request
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::setCurrentJob (HttpServerJob* job) {
+  PipelinedResponse* response = findResponse(openResponse());
+
+  TRI_ASSERT(response != nullptr);
+  TRI_ASSERT(response->_job == nullptr);
+  response->_job = job;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clears the job of the current request
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::clearCurrentJob () {
+  PipelinedResponse* response = findResponse(_currentResponse);
+
+  if (response != nullptr) {
+    response->_job = nullptr;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief signals a new chunk
 ////////////////////////////////////////////////////////////////////////////////
 
 int HttpCommTask::signalChunk (const string& data) {
+  _chunkedBacklog.fetch_add(static_cast<int64_t>(data.size()), std::memory_order_relaxed);
+
   return _chunkedTask.signalChunk(data);
 }
 
@@ -278,16 +381,22 @@ int HttpCommTask::signalChunk (const string& data) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpCommTask::handleResponse (HttpResponse* response)  {
+  PipelinedResponse* pipelined = findResponse(openResponse());
+  TRI_ASSERT(pipelined != nullptr);
+
   if (response->isChunked()) {
-    _requestPending = true;
     _isChunked = true;
+    _chunkedResponse = pipelined->_id;
   }
   else {
-    _requestPending = false;
-    _isChunked = false;
+    pipelined->_done = true;
   }
 
-  addResponse(response);
+  addResponse(*pipelined, response);
+
+  if (_isChunked) {
+    resumeChunked();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -295,7 +404,17 @@ void HttpCommTask::handleResponse (HttpResponse* response)  {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpCommTask::processRead () {
-  if (_requestPending || _readBuffer->c_str() == nullptr) {
+  if (_requestPending) {
+    // a complete request waits for the requests before it
+    return executeRequest();
+  }
+
+  if (_closeRequested || _isChunked || _readBuffer->c_str() == nullptr) {
+    return false;
+  }
+
+  if (_newRequest && _pipeline.size() >= MaximalPipelineRequests) {
+    // too many unwritten responses, let the client wait
     return false;
   }
 
@@ -315,6 +434,7 @@ bool HttpCommTask::processRead () {
       _fullUrl         = "";
       _denyCredentials = false;
       _acceptDeflate   = false;
+      _currentResponse = 0;
 
       _sinceCompactification++;
     }
@@ -450,6 +570,7 @@ bool HttpCommTask::processRead () {
       _requestType = _request->requestType();
 
       RequestStatisticsAgentSetRequestType(this, _requestType);
+      RequestStatisticsAgentSetEndpoint(this, _request->requestPath());
 
       // handle different HTTP methods
       switch (_requestType) {
@@ -537,12 +658,14 @@ bool HttpCommTask::processRead () {
           std::unique_ptr<StringBuffer> buffer(new StringBuffer(TRI_UNKNOWN_MEM_ZONE));
           buffer->appendText(TRI_CHAR_LENGTH_PAIR("HTTP/1.1 100 (Continue)\r\n\r\n"));
 
-          _writeBuffers.push_back(buffer.get());
-          buffer.release();
+          // the interim response must not overtake the responses before
+          PipelinedResponse* response = findResponse(openResponse());
+          TRI_ASSERT(response != nullptr);
 
-          _writeBuffersStats.push_back(nullptr);
+          response->_buffers.push_back(buffer.get());
+          buffer.release();
 
-          fillWriteBuffer();
+          flushResponses();
         }
       }
     }
@@ -588,9 +711,30 @@ bool HttpCommTask::processRead () {
   RequestStatisticsAgentSetReadEnd(this);
   RequestStatisticsAgentAddReceivedBytes(this, _bodyPosition - _startPosition + _bodyLength);
 
-  bool const isOptionsRequest = (_requestType == HttpRequest::HTTP_REQUEST_OPTIONS);
+  if (RequestCapture::enabled()) {
+    RequestCapture::capture(_request);
+  }
+
   resetState(false);
 
+  return executeRequest();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a complete request, if the requests before allow it
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpCommTask::executeRequest () {
+  TRI_ASSERT(_requestPending);
+  TRI_ASSERT(_request != nullptr);
+
+  if (! canExecuteRequest()) {
+    // wait until the requests before have been answered
+    return false;
+  }
+
+  _requestPending = false;
+
   // .............................................................................
   // keep-alive handling
   // .............................................................................
@@ -616,6 +760,24 @@ bool HttpCommTask::processRead () {
 
   // we keep the connection open in all other cases (HTTP 1.1 or Keep-Alive header sent)
 
+  // the response takes its place in the pipeline now, responses are written
+  // in request order regardless of the order in which the handlers finish
+  openResponse();
+
+  dispatchRequest();
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief authenticates and dispatches the request object
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::dispatchRequest () {
+  TRI_ASSERT(_request != nullptr);
+
+  bool const isOptionsRequest = (_requestType == HttpRequest::HTTP_REQUEST_OPTIONS);
+
   // .............................................................................
   // authenticate
   // .............................................................................
@@ -682,22 +844,170 @@ bool HttpCommTask::processRead () {
     clearRequest();
     handleResponse(&response);
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the complete request may run next to the unanswered
+/// requests before it
+///
+/// reading requests run concurrently. any other request waits until all
+/// requests before it are answered, and blocks the requests after it, so
+/// that a pipelined read always sees the earlier writes
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpCommTask::canExecuteRequest () const {
+  auto isReading = [] (HttpRequest::HttpRequestType type) -> bool {
+    return (type == HttpRequest::HTTP_REQUEST_GET ||
+            type == HttpRequest::HTTP_REQUEST_HEAD ||
+            type == HttpRequest::HTTP_REQUEST_OPTIONS);
+  };
+
+  for (auto const& response : _pipeline) {
+    if (response._done || response._id == _currentResponse) {
+      continue;
+    }
+
+    if (! isReading(_requestType) || ! isReading(response._requestType)) {
+      return false;
+    }
+  }
 
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of the response of the current request, and adds
+/// the response to the pipeline if it is not there yet
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t HttpCommTask::openResponse () {
+  if (_currentResponse == 0) {
+    PipelinedResponse response;
+    response._id                 = ++_lastResponse;
+    response._job                = nullptr;
+    response._statistics         = nullptr;
+    response._requestType        = _requestType;
+    response._httpVersion        = _httpVersion;
+    response._fullUrl            = _fullUrl;
+    response._origin             = _origin;
+    response._originalBodyLength = _originalBodyLength;
+    response._readStart          = RequestStatisticsAgent::_lastReadStart;
+    response._denyCredentials    = _denyCredentials;
+    response._done               = false;
+
+    _pipeline.emplace_back(std::move(response));
+    _currentResponse = _lastResponse;
+  }
+
+  return _currentResponse;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns an empty write buffer for at least size characters
+////////////////////////////////////////////////////////////////////////////////
+
+StringBuffer* HttpCommTask::acquireWriteBuffer (size_t size) {
+  if (NumPooled > 0) {
+    StringBuffer* buffer = PooledBuffers[--NumPooled];
+
+    if (buffer->reserve(size) == TRI_ERROR_NO_ERROR) {
+      return buffer;
+    }
+
+    delete buffer;
+  }
+
+  return new StringBuffer(TRI_UNKNOWN_MEM_ZONE, size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a response of the pipeline
+////////////////////////////////////////////////////////////////////////////////
+
+HttpCommTask::PipelinedResponse* HttpCommTask::findResponse (uint64_t id) {
+  // the pipeline is short, and the current response is usually at the back
+  for (auto it = _pipeline.rbegin(); it != _pipeline.rend(); ++it) {
+    if ((*it)._id == id) {
+      return &(*it);
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the buffers of the responses at the front of the pipeline
+/// to the write buffers
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::flushResponses () {
+  while (! _pipeline.empty()) {
+    PipelinedResponse& response = _pipeline.front();
+
+    size_t const n = response._buffers.size();
+
+    for (size_t i = 0; i < n; ++i) {
+      StringBuffer* buffer = response._buffers[i];
+      _writeBuffers.push_back(buffer);
+
+      // the statistics go with the last buffer of the final response, so
+      // that the write time covers all buffers of the response
+      if (response._done && i == n - 1) {
+        _writeBuffersStats.push_back(response._statistics);
+        response._statistics = nullptr;
+      }
+      else {
+        _writeBuffersStats.push_back(nullptr);
+
+        if (response._statistics != nullptr) {
+          if (response._statistics->_writeStart == 0.0) {
+            response._statistics->_writeStart = TRI_StatisticsTime();
+          }
+          response._statistics->_sentBytes += buffer->length();
+        }
+      }
+    }
+
+    response._buffers.clear();
+
+    if (! response._done) {
+      // later responses must wait for this one
+      break;
+    }
+
+    _pipeline.pop_front();
+  }
+
+  // start output
+  fillWriteBuffer();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sends more chunked data
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpCommTask::sendChunk (StringBuffer* buffer) {
+  PipelinedResponse* response = nullptr;
+
   if (_isChunked) {
+    response = findResponse(_chunkedResponse);
+  }
+
+  if (response != nullptr) {
     TRI_ASSERT(buffer != nullptr);
+    std::unique_ptr<StringBuffer> data(buffer);
+
+    // the chunks signaled since the last call go out as one chunk
+    std::unique_ptr<StringBuffer> chunk(acquireWriteBuffer(data->length() + 32));
+    chunk->appendHex(data->length());
+    chunk->appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
+    chunk->appendText(*data);
+    chunk->appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
 
-    _writeBuffers.push_back(buffer);
-    _writeBuffersStats.push_back(nullptr);
+    response->_buffers.push_back(chunk.get());
+    chunk.release();
 
-    fillWriteBuffer();
+    flushResponses();
   }
   else {
     delete buffer;
@@ -709,18 +1019,25 @@ void HttpCommTask::sendChunk (StringBuffer* buffer) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpCommTask::finishedChunked () {
-  std::unique_ptr<StringBuffer> buffer(new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 6));
-  buffer->appendText(TRI_CHAR_LENGTH_PAIR("0\r\n\r\n"));
+  PipelinedResponse* response = findResponse(_chunkedResponse);
 
-  _writeBuffers.push_back(buffer.get());
-  buffer.release();
-  _writeBuffersStats.push_back(nullptr);
+  if (response != nullptr) {
+    std::unique_ptr<StringBuffer> buffer(new StringBuffer(TRI_UNKNOWN_MEM_ZONE, 6));
+    buffer->appendText(TRI_CHAR_LENGTH_PAIR("0\r\n\r\n"));
+
+    response->_buffers.push_back(buffer.get());
+    buffer.release();
+    response->_done = true;
+  }
 
   _isChunked = false;
-  _requestPending = false;
+  _chunkedResponse = 0;
 
-  fillWriteBuffer();
-  processRead();
+  flushResponses();
+
+  while (processRead()) {
+    // process the requests which were held back by the chunked response
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -736,39 +1053,52 @@ void HttpCommTask::setupDone () {
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief reads data from the socket
+/// @brief adds the CORS headers to a response
 ////////////////////////////////////////////////////////////////////////////////
 
-void HttpCommTask::addResponse (HttpResponse* response) {
-  // CORS response handling
-  if (! _origin.empty()) {
+void HttpCommTask::addCorsHeaders (HttpResponse* response,
+                                 std::string const& origin,
+                                 bool denyCredentials) {
+  if (origin.empty()) {
+    return;
+  }
 
-    // the request contained an Origin header. We have to send back the
-    // access-control-allow-origin header now
-    LOG_TRACE("handling CORS response");
+  // the request contained an Origin header. We have to send back the
+  // access-control-allow-origin header now
+  LOG_TRACE("handling CORS response");
 
-    response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-expose-headers"),
-                        "etag, content-encoding, content-length, location, server, x-arango-errors, x-arango-async-id");
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-expose-headers"),
+                      "etag, content-encoding, content-length, location, server, x-arango-errors, x-arango-async-id");
 
-    // TODO: check whether anyone actually needs these headers in the browser:
-    // x-arango-replication-checkmore, x-arango-replication-lastincluded,
-    // x-arango-replication-lasttick, x-arango-replication-active");
+  // TODO: check whether anyone actually needs these headers in the browser:
+  // x-arango-replication-checkmore, x-arango-replication-lastincluded,
+  // x-arango-replication-lasttick, x-arango-replication-active");
 
-    // send back original value of "Origin" header
-    response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-allow-origin"), _origin);
+  // send back original value of "Origin" header
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-allow-origin"), origin);
 
-    // send back "Access-Control-Allow-Credentials" header
-    response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-allow-credentials"), (_denyCredentials ? "false" : "true"));
-  }
-  // CORS request handling EOF
+  // send back "Access-Control-Allow-Credentials" header
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("access-control-allow-credentials"), (denyCredentials ? "false" : "true"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes a response into its place in the pipeline
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::addResponse (PipelinedResponse& pipelined,
+                                HttpResponse* response) {
+  // CORS response handling
+  addCorsHeaders(response, pipelined._origin, pipelined._denyCredentials);
 
   // set "connection" header
-  // keep-alive is the default
-  response->setHeader(TRI_CHAR_LENGTH_PAIR("connection"), (_closeRequested ? "Close" : "Keep-Alive"));
+  // keep-alive is the default. no requests are read after a close was
+  // requested, so only the last response closes the connection
+  bool const close = (_closeRequested && pipelined._id == _lastResponse);
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("connection"), (close ? "Close" : "Keep-Alive"));
 
   size_t const responseBodyLength = response->bodySize();
 
-  if (_requestType == HttpRequest::HTTP_REQUEST_HEAD) {
+  if (pipelined._requestType == HttpRequest::HTTP_REQUEST_HEAD) {
     // clear body if this is an HTTP HEAD request
     // HEAD must not return a body
     response->headResponse(responseBodyLength);
@@ -783,15 +1113,23 @@ void HttpCommTask::addResponse (HttpResponse* response) {
   //   }
   // }
 
+  bool const isHead = (pipelined._requestType == HttpRequest::HTTP_REQUEST_HEAD);
+
+  // a large body is not copied behind the header, but handed over as a
+  // buffer of its own. both are sent with one gathering write
+  bool const separateBody = (! isHead &&
+                             ! response->isChunked() &&
+                             responseBodyLength >= MinimalSeparateBodySize);
+
   // reserve a buffer with some spare capacity
-  std::unique_ptr<StringBuffer> buffer(new StringBuffer(TRI_UNKNOWN_MEM_ZONE, responseBodyLength + 128));
+  std::unique_ptr<StringBuffer> buffer(acquireWriteBuffer((separateBody ? 0 : responseBodyLength) + 128));
 
   // write header
   response->writeHeader(buffer.get());
 
   // write body
-  if (_requestType != HttpRequest::HTTP_REQUEST_HEAD) {
-    if (_isChunked) {
+  if (! isHead && ! separateBody) {
+    if (response->isChunked()) {
       if (0 != responseBodyLength) {
         buffer->appendHex(response->body().length());
         buffer->appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
@@ -804,32 +1142,41 @@ void HttpCommTask::addResponse (HttpResponse* response) {
     }
   }
 
-  _writeBuffers.push_back(buffer.get());
-  auto b = buffer.release();
-          
-  LOG_TRACE("HTTP WRITE FOR %p: %s", (void*) this, b->c_str());
+  LOG_TRACE("HTTP WRITE FOR %p: %s", (void*) this, buffer->c_str());
+
+  pipelined._buffers.push_back(buffer.get());
+  buffer.release();
+
+  if (separateBody) {
+    std::unique_ptr<StringBuffer> body(new StringBuffer(TRI_UNKNOWN_MEM_ZONE));
+    body->swap(&response->body());
+
+    pipelined._buffers.push_back(body.get());
+    body.release();
+  }
           
   // clear body
   response->body().clear();
           
       
-  double const totalTime = RequestStatisticsAgent::elapsedSinceReadStart();
+  double const totalTime = (pipelined._readStart != 0.0 ? TRI_StatisticsTime() - pipelined._readStart : 0.0);
       
-  _writeBuffersStats.push_back(RequestStatisticsAgent::transfer());
+  TRI_ASSERT(pipelined._statistics == nullptr);
+  pipelined._statistics = RequestStatisticsAgent::transfer();
 
   // disable the following statement to prevent excessive logging of incoming requests
   LOG_USAGE(",\"http-request\",\"%s\",\"%s\",\"%s\",%d,%llu,%llu,\"%s\",%.6f",
             _connectionInfo.clientAddress.c_str(),
-            HttpRequest::translateMethod(_requestType).c_str(),
-            HttpRequest::translateVersion(_httpVersion).c_str(),
+            HttpRequest::translateMethod(pipelined._requestType).c_str(),
+            HttpRequest::translateVersion(pipelined._httpVersion).c_str(),
             (int) response->responseCode(),
-            (unsigned long long) _originalBodyLength,
+            (unsigned long long) pipelined._originalBodyLength,
             (unsigned long long) responseBodyLength,
-            _fullUrl.c_str(),
+            pipelined._fullUrl.c_str(),
             totalTime);
           
-  // start output
-  fillWriteBuffer();
+  // write the responses which are complete and in order
+  flushResponses();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -891,6 +1238,7 @@ void HttpCommTask::fillWriteBuffer () {
     _writeBuffers.pop_front();
 
     TRI_ASSERT(buffer != nullptr);
+    _writeBufferLength = buffer->length();
 
     TRI_request_statistics_t* statistics = _writeBuffersStats.front();
     _writeBuffersStats.pop_front();
@@ -899,6 +1247,15 @@ void HttpCommTask::fillWriteBuffer () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief delivers the chunks signaled before the chunked response was
+/// handled
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::resumeChunked () {
+  _chunkedTask.signal();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handles CORS options
 ////////////////////////////////////////////////////////////////////////////////
@@ -1174,16 +1531,52 @@ bool HttpCommTask::handleEvent (EventToken token,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpCommTask::handleAsync () {
-  TRI_ASSERT(_job != nullptr);
-  TRI_ASSERT(_handler != nullptr);
-  TRI_ASSERT(! _job->hasHandler());
+  std::vector<std::pair<HttpServerJob*, HttpHandler*>> finished;
+
+  {
+    MUTEX_LOCKER(_finishedJobsLock);
+    finished.swap(_finishedJobs);
+  }
+
+  if (finished.empty()) {
+    // signals may be coalesced, the jobs have been handled already
+    return true;
+  }
+
+  // the statistics and the response id belong to the request currently read,
+  // the finished handlers must not touch them
+  TRI_request_statistics_t* statistics = RequestStatisticsAgent::transfer();
+  double const lastReadStart = RequestStatisticsAgent::_lastReadStart;
+  uint64_t const currentResponse = _currentResponse;
+
+  for (auto& it : finished) {
+    std::unique_ptr<HttpHandler> handler(it.second);
+    PipelinedResponse* response = nullptr;
+
+    for (auto& pipelined : _pipeline) {
+      if (pipelined._job == it.first) {
+        response = &pipelined;
+        break;
+      }
+    }
+
+    if (response == nullptr) {
+      // the job has been shut down already
+      continue;
+    }
+
+    TRI_ASSERT(! it.first->hasHandler());
 
-  _job->beginShutdown(); 
-  _job = nullptr;
+    response->_job = nullptr;
+    it.first->beginShutdown();
+
+    _currentResponse = response->_id;
+    _server->handleResponse(this, handler.get());
+  }
 
-  _server->handleResponse(this, _handler);
-  delete _handler;
-  _handler = nullptr;
+  _currentResponse = currentResponse;
+  RequestStatisticsAgent::replace(statistics);
+  RequestStatisticsAgent::_lastReadStart = lastReadStart;
 
   _server->handleAsync(this);
 
@@ -1251,6 +1644,11 @@ void HttpCommTask::completedWriteBuffer () {
   _writeBuffer = nullptr;
   _writeLength = 0;
 
+  if (_isChunked) {
+    _chunkedBacklog.fetch_sub(static_cast<int64_t>(_writeBufferLength), std::memory_order_relaxed);
+  }
+  _writeBufferLength = 0;
+
   if (_writeBufferStatistics != nullptr) {
     _writeBufferStatistics->_writeEnd = TRI_StatisticsTime();
 
@@ -1260,7 +1658,7 @@ void HttpCommTask::completedWriteBuffer () {
 
   fillWriteBuffer();
 
-  if (! _clientClosed && _closeRequested && ! hasWriteBuffer() && _writeBuffers.empty() && ! _isChunked) {
+  if (! _clientClosed && _closeRequested && ! hasWriteBuffer() && _writeBuffers.empty() && _pipeline.empty() && ! _isChunked) {
     _clientClosed = true;
     _server->handleCommunicationClosed(this);
   }
@@ -1270,6 +1668,51 @@ void HttpCommTask::completedWriteBuffer () {
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t HttpCommTask::queuedWriteBuffers (TRI_socket_buffer_t* buffers,
+                                         size_t maxBuffers) {
+  size_t n = 0;
+
+  for (auto const& buffer : _writeBuffers) {
+    if (n == maxBuffers) {
+      break;
+    }
+
+    if (buffer->empty()) {
+      // empty buffers are dropped when they become the write buffer
+      continue;
+    }
+
+    buffers[n]._data = buffer->c_str();
+    buffers[n]._length = buffer->length();
+    ++n;
+  }
+
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpCommTask::releaseWriteBuffer (StringBuffer* buffer) {
+  size_t const capacity = buffer->capacity();
+
+  if (NumPooled < NumPooledBuffers &&
+      capacity >= MinimalPooledBufferSize &&
+      capacity <= MaximalPooledBufferSize) {
+    // the appenders rely on the unused part of the buffer being zeroed
+    buffer->clear();
+    PooledBuffers[NumPooled++] = buffer;
+    return;
+  }
+
+  delete buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
 void HttpCommTask::handleTimeout () {
   _clientClosed = true;
   _server->handleCommunicationClosed(this);
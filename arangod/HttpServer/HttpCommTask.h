@@ -117,39 +117,31 @@ namespace triagens {
       public:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief sets the current handler for the task
+/// @brief hands back the handler of a finished job
+///
+/// this is called from a dispatcher thread, the handler is picked up by the
+/// next call to handleAsync
 ////////////////////////////////////////////////////////////////////////////////
 
-        void setHandler (HttpHandler* handler) {
-          TRI_ASSERT(_handler == nullptr);
-          TRI_ASSERT(handler != nullptr);
-          _handler = handler;
-        }
+        void setHandler (HttpServerJob*, HttpHandler*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief returns the current job. note: this may be a nullptr
+/// @brief removes all jobs from the task and returns them
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpServerJob* job () const {
-          return _job; 
-        }
+        virtual std::vector<HttpServerJob*> releaseJobs ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief sets the current job
+/// @brief sets the job of the current request
 ////////////////////////////////////////////////////////////////////////////////
 
-        void setCurrentJob (HttpServerJob* job) {
-          TRI_ASSERT(_job == nullptr);
-          _job = job;
-        }
+        virtual void setCurrentJob (HttpServerJob*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief clears the current job
+/// @brief clears the job of the current request
 ////////////////////////////////////////////////////////////////////////////////
 
-        void clearCurrentJob () {
-          _job = nullptr;
-        }
+        virtual void clearCurrentJob ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief signals a new chunk
@@ -157,29 +149,47 @@ namespace triagens {
 
         int signalChunk (const std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes of chunks not yet written to the socket
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t chunkedBacklog () const {
+          return _chunkedBacklog.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a chunked response is being sent
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isChunked () const {
+          return _isChunked;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handles response
 ////////////////////////////////////////////////////////////////////////////////
 
-        void handleResponse (HttpResponse*);
+        virtual void handleResponse (HttpResponse*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reads data from the socket
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool processRead ();
+        virtual bool processRead ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sends more chunked data
+///
+/// the buffer contains the raw data of one or more chunks
 ////////////////////////////////////////////////////////////////////////////////
 
-        void sendChunk (basics::StringBuffer*);
+        virtual void sendChunk (basics::StringBuffer*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief chunking is finished
 ////////////////////////////////////////////////////////////////////////////////
 
-        void finishedChunked ();
+        virtual void finishedChunked ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief task set up complete
@@ -188,22 +198,55 @@ namespace triagens {
         void setupDone ();
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                   private methods
+// --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
 
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief reads data from the socket
+/// @brief a response of the pipeline
+///
+/// responses are kept in request order. the buffers of a response are
+/// written once all responses before it are complete
+////////////////////////////////////////////////////////////////////////////////
+
+        struct PipelinedResponse {
+          uint64_t _id;
+          HttpServerJob* _job;
+          std::vector<basics::StringBuffer*> _buffers;
+          TRI_request_statistics_t* _statistics;
+          HttpRequest::HttpRequestType _requestType;
+          HttpRequest::HttpVersion _httpVersion;
+          std::string _fullUrl;
+          std::string _origin;
+          size_t _originalBodyLength;
+          double _readStart;
+          bool _denyCredentials;
+          bool _done;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 protected methods
+// -----------------------------------------------------------------------------
+
+      protected:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief authenticates and dispatches the request object
+///
+/// the response of the request must have been opened, the request object is
+/// handed over to a handler or deleted
 ////////////////////////////////////////////////////////////////////////////////
 
-        void addResponse (HttpResponse*);
+        void dispatchRequest ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// check the content-length header of a request and fail it is broken
+/// @brief adds the CORS headers to a response
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool checkContentLength (bool expectContentLength);
+        void addCorsHeaders (HttpResponse*,
+                             std::string const& origin,
+                             bool denyCredentials);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fills the write buffer
@@ -212,22 +255,93 @@ namespace triagens {
         void fillWriteBuffer ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief handles CORS options
+/// @brief delivers the chunks signaled before the chunked response was
+/// handled
 ////////////////////////////////////////////////////////////////////////////////
 
-        void processCorsOptions (uint32_t compatibility);
+        void resumeChunked ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief processes a request
+/// @brief clears the request object
 ////////////////////////////////////////////////////////////////////////////////
 
-        void processRequest (uint32_t compatibility);
+        void clearRequest ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief clears the request object
+/// @brief get request compatibility
 ////////////////////////////////////////////////////////////////////////////////
 
-        void clearRequest ();
+        int32_t getCompatibility () const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a complete request, if the requests before allow it
+////////////////////////////////////////////////////////////////////////////////
+
+        bool executeRequest ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the complete request may run next to the unanswered
+/// requests before it
+////////////////////////////////////////////////////////////////////////////////
+
+        bool canExecuteRequest () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of the response of the current request, and adds
+/// the response to the pipeline if it is not there yet
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t openResponse ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns an empty write buffer for at least size characters,
+/// reusing one that this thread has released before if possible
+////////////////////////////////////////////////////////////////////////////////
+
+        static basics::StringBuffer* acquireWriteBuffer (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a response of the pipeline
+////////////////////////////////////////////////////////////////////////////////
+
+        PipelinedResponse* findResponse (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the buffers of the responses at the front of the pipeline
+/// to the write buffers
+////////////////////////////////////////////////////////////////////////////////
+
+        void flushResponses ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes a response into its place in the pipeline
+////////////////////////////////////////////////////////////////////////////////
+
+        void addResponse (PipelinedResponse&, HttpResponse*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// check the content-length header of a request and fail it is broken
+////////////////////////////////////////////////////////////////////////////////
+
+        bool checkContentLength (bool expectContentLength);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles CORS options
+////////////////////////////////////////////////////////////////////////////////
+
+        void processCorsOptions (uint32_t compatibility);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief processes a request
+////////////////////////////////////////////////////////////////////////////////
+
+        void processRequest (uint32_t compatibility);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief resets the internal state
@@ -244,12 +358,6 @@ namespace triagens {
 
         bool sendWwwAuthenticateHeader () const;
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief get request compatibility
-////////////////////////////////////////////////////////////////////////////////
-
-        int32_t getCompatibility () const;
-
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      Task methods
 // -----------------------------------------------------------------------------
@@ -284,7 +392,7 @@ namespace triagens {
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool handleAsync ();
+        virtual bool handleAsync ();
 
       public:
 
@@ -314,6 +422,19 @@ namespace triagens {
 
         void completedWriteBuffer () override;
 
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t queuedWriteBuffers (TRI_socket_buffer_t*,
+                                   size_t) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void releaseWriteBuffer (basics::StringBuffer*) override;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
@@ -338,135 +459,185 @@ namespace triagens {
 
         HttpServer* const _server;
 
-// -----------------------------------------------------------------------------
-// --SECTION--                                                 private variables
-// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the handlers of finished jobs, with their jobs
+////////////////////////////////////////////////////////////////////////////////
 
-      private:
+        std::vector<std::pair<HttpServerJob*, HttpHandler*>> _finishedJobs;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief event for async signals
+/// @brief lock for the finished jobs
 ////////////////////////////////////////////////////////////////////////////////
 
-        EventToken _watcher;
-   
+        basics::Mutex _finishedJobsLock;
+
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the current job
+/// @brief write buffers
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpServerJob* _job;
+        std::deque<basics::StringBuffer*> _writeBuffers;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the current handler
+/// @brief statistics buffers
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpHandler* _handler;
+        std::deque<TRI_request_statistics_t*> _writeBuffersStats;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief write buffers
+/// @brief true if a close has been requested by the client
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::deque<basics::StringBuffer*> _writeBuffers;
+        bool _closeRequested;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief statistics buffers
+/// @brief whether or not to allow credentialed requests
+///
+/// this is only used for CORS
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::deque<TRI_request_statistics_t*> _writeBuffersStats;
+        bool _denyCredentials;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief current read position
+/// @brief whether the client accepts deflate algorithm
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _readPosition;
+        bool _acceptDeflate;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief start of the body position
+/// @brief true if within a chunked response
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _bodyPosition;
+        bool _isChunked;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief body length
+/// @brief bytes of chunks signaled but not yet written to the socket. this
+/// is approximate, as the headers and the framing of the chunks are counted
+/// as written too
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t _bodyLength;
+        std::atomic<int64_t> _chunkedBacklog;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief true if request is complete but not handled
+/// @brief length of the current write buffer
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _requestPending;
+        size_t _writeBufferLength;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief true if a close has been requested by the client
+/// @brief the request with possible incomplete body
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _closeRequested;
+        HttpRequest* _request;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief true if reading the request body
+/// @brief http version number used
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _readRequestBody;
+        HttpRequest::HttpVersion _httpVersion;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief whether or not to allow credentialed requests
+/// @brief type of request (GET, POST, ...)
+////////////////////////////////////////////////////////////////////////////////
+
+        HttpRequest::HttpRequestType _requestType;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value of requested URL
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _fullUrl;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value of the HTTP origin header the client sent (if any).
 ///
 /// this is only used for CORS
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _denyCredentials;
+        std::string _origin;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief whether the client accepts deflate algorithm
+/// @brief the maximal header size
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _acceptDeflate;
+        static size_t const MaximalHeaderSize;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief new request started
+/// @brief the maximal body size
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _newRequest;
+        static size_t const MaximalBodySize;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief true if within a chunked response
+/// @brief event for async signals
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _isChunked;
+        EventToken _watcher;
+   
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the responses which are not yet written, in request order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<PipelinedResponse> _pipeline;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the request with possible incomplete body
+/// @brief id of the response of the current request, 0 if not yet opened
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpRequest* _request;
+        uint64_t _currentResponse;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief http version number used
+/// @brief id of the last response opened
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpRequest::HttpVersion _httpVersion;
+        uint64_t _lastResponse;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief type of request (GET, POST, ...)
+/// @brief id of the chunked response being sent, if any
 ////////////////////////////////////////////////////////////////////////////////
 
-        HttpRequest::HttpRequestType _requestType;
+        uint64_t _chunkedResponse;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief value of requested URL
+/// @brief current read position
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::string _fullUrl;
+        size_t _readPosition;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief value of the HTTP origin header the client sent (if any).
-///
-/// this is only used for CORS
+/// @brief start of the body position
 ////////////////////////////////////////////////////////////////////////////////
 
-        std::string _origin;
+        size_t _bodyPosition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief body length
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _bodyLength;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief true if a request is complete but not yet executed
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _requestPending;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief true if reading the request body
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _readRequestBody;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief new request started
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _newRequest;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief start position of current request
@@ -499,22 +670,36 @@ namespace triagens {
         std::atomic<bool> _setupDone;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the maximal header size
+/// @brief the maximal pipeline size
 ////////////////////////////////////////////////////////////////////////////////
 
-        static size_t const MaximalHeaderSize;
+        static size_t const MaximalPipelineSize;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the maximal body size
+/// @brief the maximal number of unwritten responses
 ////////////////////////////////////////////////////////////////////////////////
 
-        static size_t const MaximalBodySize;
+        static size_t const MaximalPipelineRequests;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief the maximal pipeline size
+/// @brief the body size from which a body is written from its own buffer
+///
+/// smaller bodies are copied behind the header, which is cheaper than a
+/// separate buffer
 ////////////////////////////////////////////////////////////////////////////////
 
-        static size_t const MaximalPipelineSize;
+        static size_t const MinimalSeparateBodySize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the capacities of the write buffers that are kept for reuse
+///
+/// smaller buffers are cheap to allocate, and larger ones would hold on to
+/// too much memory
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MinimalPooledBufferSize;
+
+        static size_t const MaximalPooledBufferSize;
 
     };
   }
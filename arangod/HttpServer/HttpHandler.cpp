@@ -31,6 +31,7 @@
 
 #include "Basics/StringUtils.h"
 #include "Basics/logging.h"
+#include "Basics/tri-strings.h"
 #include "Dispatcher/Dispatcher.h"
 #include "HttpServer/HttpServerJob.h"
 #include "Rest/HttpRequest.h"
@@ -91,6 +92,45 @@ size_t HttpHandler::queue () const {
   return Dispatcher::STANDARD_QUEUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the priority class
+////////////////////////////////////////////////////////////////////////////////
+
+Job::priority_e HttpHandler::priority () const {
+  bool found;
+  const char* priority = _request->header("x-arango-priority", found);
+
+  if (found) {
+    if (TRI_CaseEqualString(priority, "high")) {
+      return Job::PRIORITY_HIGH;
+    }
+    else if (TRI_CaseEqualString(priority, "low")) {
+      return Job::PRIORITY_LOW;
+    }
+  }
+
+  return Job::PRIORITY_NORMAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal time the request may wait in the queue
+////////////////////////////////////////////////////////////////////////////////
+
+double HttpHandler::maxQueueTime () const {
+  bool found;
+  const char* deadline = _request->header("x-arango-deadline", found);
+
+  if (found) {
+    double value = StringUtils::doubleDecimal(deadline);
+
+    if (value > 0.0) {
+      return value;
+    }
+  }
+
+  return 0.0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
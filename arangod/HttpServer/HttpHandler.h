@@ -152,6 +152,19 @@ namespace triagens {
 
         virtual size_t queue () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the priority class
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual Job::priority_e priority () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal time in seconds the request may wait in the
+/// dispatcher queue, 0.0 for no limit
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual double maxQueueTime () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the thread which currently dealing with the job
 ////////////////////////////////////////////////////////////////////////////////
@@ -49,7 +49,19 @@ using namespace triagens::rest;
 HttpListenTask::HttpListenTask (HttpServer* server, Endpoint* endpoint)
   : Task("HttpListenTask"),
     ListenTask(endpoint),
-    _server(server) {
+    _server(server),
+    _thread(-1) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief listen to given port in the given scheduler thread
+////////////////////////////////////////////////////////////////////////////////
+
+HttpListenTask::HttpListenTask (HttpServer* server, Endpoint* endpoint, ssize_t thread)
+  : Task("HttpListenTask"),
+    ListenTask(endpoint),
+    _server(server),
+    _thread(thread) {
 }
 
 // -----------------------------------------------------------------------------
@@ -61,7 +73,7 @@ HttpListenTask::HttpListenTask (HttpServer* server, Endpoint* endpoint)
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpListenTask::handleConnected (TRI_socket_t s, const ConnectionInfo& info) {
-  _server->handleConnected(s, info);
+  _server->handleConnected(s, info, _thread);
   return true;
 }
 
@@ -62,6 +62,14 @@ namespace triagens {
 
         HttpListenTask (HttpServer* server, Endpoint* endpoint);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief listen to given port in the given scheduler thread
+///
+/// the accepted connections are handled by the same thread
+////////////////////////////////////////////////////////////////////////////////
+
+        HttpListenTask (HttpServer* server, Endpoint* endpoint, ssize_t thread);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                ListenTask methods
 // -----------------------------------------------------------------------------
@@ -85,6 +93,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         HttpServer* _server;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scheduler thread of the accepted connections, -1 for any
+////////////////////////////////////////////////////////////////////////////////
+
+        ssize_t _thread;
     };
   }
 }
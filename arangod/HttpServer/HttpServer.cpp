@@ -39,6 +39,7 @@
 #include "HttpServer/HttpHandler.h"
 #include "HttpServer/HttpListenTask.h"
 #include "HttpServer/HttpServerJob.h"
+#include "Rest/EndpointIp.h"
 #include "Rest/EndpointList.h"
 #include "Scheduler/ListenTask.h"
 #include "Scheduler/Scheduler.h"
@@ -92,6 +93,24 @@ int HttpServer::sendChunk (uint64_t taskId, const string& data) {
 
   return it->second->signalChunk(data);
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes of chunks a task has not yet written
+////////////////////////////////////////////////////////////////////////////////
+
+int HttpServer::chunkedBacklog (uint64_t taskId, int64_t& backlog) {
+  MUTEX_LOCKER(HttpCommTaskMapLock);
+
+  auto it = HttpCommTaskMap.find(taskId);
+
+  if (it == HttpCommTaskMap.end()) {
+    return TRI_ERROR_TASK_NOT_FOUND;
+  }
+
+  backlog = it->second->chunkedBacklog();
+
+  return TRI_ERROR_NO_ERROR;
+}
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
@@ -113,7 +132,9 @@ HttpServer::HttpServer (Scheduler* scheduler,
     _listenTasks(),
     _endpointList(nullptr),
     _commTasks(),
-    _keepAliveTimeout(keepAliveTimeout) {
+    _keepAliveTimeout(keepAliveTimeout),
+    _reusePort(false),
+    _sharedEndpoints() {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -127,6 +148,10 @@ HttpServer::~HttpServer () {
   }
 
   stopListening();
+
+  for (auto& endpoint : _sharedEndpoints) {
+    delete endpoint;
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -237,6 +262,14 @@ void HttpServer::stop () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpServer::handleConnected (TRI_socket_t s, const ConnectionInfo& info) {
+  handleConnected(s, info, -1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles connection request accepted by the listener of a thread
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpServer::handleConnected (TRI_socket_t s, const ConnectionInfo& info, ssize_t thread) {
   HttpCommTask* task = createCommTask(s, info);
 
   try {
@@ -250,8 +283,16 @@ void HttpServer::handleConnected (TRI_socket_t s, const ConnectionInfo& info) {
   }
 
   // registers the task and get the number of the scheduler thread
-  ssize_t n;
-  int res = _scheduler->registerTask(task, &n);
+  ssize_t n = thread;
+  int res;
+
+  if (0 <= thread) {
+    // stay in the thread which has accepted the connection
+    res = _scheduler->registerTaskInThread(task, thread);
+  }
+  else {
+    res = _scheduler->registerTask(task, &n);
+  }
 
   // register the ChunkedTask in the same thread
   if (res == TRI_ERROR_NO_ERROR) {
@@ -296,7 +337,9 @@ void HttpServer::handleCommunicationFailure (HttpCommTask* task) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpServer::handleAsync (HttpCommTask* task) {
-  task->processRead();
+  // a finished request may release several pipelined requests
+  while (task->processRead()) {
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -416,6 +459,13 @@ void HttpServer::handleResponse (HttpCommTask* task,
 ////////////////////////////////////////////////////////////////////////////////
 
 bool HttpServer::openEndpoint (Endpoint* endpoint) {
+  if (_reusePort &&
+      _scheduler->numberOfThreads() > 1 &&
+      (endpoint->getDomainType() == Endpoint::DOMAIN_IPV4 ||
+       endpoint->getDomainType() == Endpoint::DOMAIN_IPV6)) {
+    return openSharedEndpoint(endpoint);
+  }
+
   ListenTask* task = new HttpListenTask(this, endpoint);
 
   // ...................................................................
@@ -434,6 +484,53 @@ bool HttpServer::openEndpoint (Endpoint* endpoint) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief opens a listen port in each scheduler thread
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpServer::openSharedEndpoint (Endpoint* endpoint) {
+  EndpointIp* ip = dynamic_cast<EndpointIp*>(endpoint);
+  TRI_ASSERT(ip != nullptr);
+
+  ip->setReusePort(true);
+
+  size_t const n = _scheduler->numberOfThreads();
+
+  for (size_t i = 0; i < n; ++i) {
+    Endpoint* ep = endpoint;
+
+    if (i > 0) {
+      // every listener needs a socket of its own
+      ep = Endpoint::serverFactory(endpoint->getSpecification(),
+                                   endpoint->getListenBacklog(),
+                                   ip->reuseAddress());
+
+      if (ep == nullptr) {
+        return false;
+      }
+
+      _sharedEndpoints.emplace_back(ep);
+      static_cast<EndpointIp*>(ep)->setReusePort(true);
+    }
+
+    ListenTask* task = new HttpListenTask(this, ep, (ssize_t) i);
+
+    if (! task->isBound()) {
+      deleteTask(task);
+      return false;
+    }
+
+    _scheduler->registerTaskInThread(task, (ssize_t) i);
+    _listenTasks.emplace_back(task);
+  }
+
+  LOG_DEBUG("listening on endpoint '%s' in %d scheduler threads",
+            endpoint->getSpecification().c_str(),
+            (int) n);
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handle request directly
 ////////////////////////////////////////////////////////////////////////////////
@@ -503,10 +600,7 @@ void HttpServer::shutdownHandlerByTask (Task* task) {
   auto commTask = dynamic_cast<HttpCommTask*>(task);
   TRI_ASSERT(commTask != nullptr);
 
-  auto job = commTask->job();
-  commTask->clearCurrentJob();
-
-  if (job != nullptr) {
+  for (auto& job : commTask->releaseJobs()) {
     job->beginShutdown();
   }
 }
@@ -74,6 +74,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         static int sendChunk (uint64_t, const std::string&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes of chunks a task has not yet written, so that
+/// producers can wait for slow clients
+////////////////////////////////////////////////////////////////////////////////
+
+        static int chunkedBacklog (uint64_t, int64_t&);
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
@@ -169,6 +176,19 @@ namespace triagens {
 
         void setEndpointList (const EndpointList* list);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lets each scheduler thread listen on its own socket
+///
+/// the sockets of a TCP endpoint share the port with SO_REUSEPORT, and the
+/// kernel distributes the incoming connections among them. a connection
+/// stays in the thread whose socket accepted it. must be called before
+/// startListening
+////////////////////////////////////////////////////////////////////////////////
+
+        void setReusePort (bool value) {
+          _reusePort = value;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief starts listening
 ////////////////////////////////////////////////////////////////////////////////
@@ -205,6 +225,12 @@ namespace triagens {
 
         void handleConnected (TRI_socket_t s, const ConnectionInfo& info);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles connection request accepted by the listener of a thread
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleConnected (TRI_socket_t s, const ConnectionInfo& info, ssize_t thread);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handles a connection close
 ////////////////////////////////////////////////////////////////////////////////
@@ -272,6 +298,12 @@ namespace triagens {
 
         bool openEndpoint (Endpoint* endpoint);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief opens a listen port in each scheduler thread
+////////////////////////////////////////////////////////////////////////////////
+
+        bool openSharedEndpoint (Endpoint* endpoint);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handle request directly
 ////////////////////////////////////////////////////////////////////////////////
@@ -353,6 +385,18 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         double _keepAliveTimeout;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether each scheduler thread listens on its own socket
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _reusePort;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief additional endpoints for the listeners of the scheduler threads
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Endpoint*> _sharedEndpoints;
     };
   }
 }
@@ -103,6 +103,22 @@ size_t HttpServerJob::queue () const {
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
 
+Job::priority_e HttpServerJob::priority () const {
+  return _handler->priority();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+double HttpServerJob::maxQueueTime () const {
+  return _handler->maxQueueTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
 void HttpServerJob::setDispatcherThread (DispatcherThread* thread) {
   _handler->setDispatcherThread(thread);
 }
@@ -162,8 +178,11 @@ void HttpServerJob::cleanup (DispatcherQueue* queue) {
     _isInCleanup.store(true);
     
     if (_task != nullptr) {
-      _task->setHandler(_handler);
+      // the task may pick up the handler as soon as it is handed back
+      HttpHandler* handler = _handler;
       _handler = nullptr;
+
+      _task->setHandler(this, handler);
       _task->signal();
     }
     
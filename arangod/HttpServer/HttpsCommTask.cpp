@@ -32,15 +32,124 @@
 
 #include <openssl/err.h>
 
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
+#include "Basics/ConditionLocker.h"
+#include "Basics/ConditionVariable.h"
 #include "Basics/logging.h"
 #include "Basics/socket-utils.h"
 #include "Basics/ssl-helper.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/ThreadPool.h"
 #include "HttpServer/HttpsServer.h"
 #include "Scheduler/Scheduler.h"
 
+using namespace triagens::basics;
 using namespace triagens::rest;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                struct SslHandshake
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state of a handshake done by the handshake pool, shared by the task
+/// and the job. the job only uses the connection while it is started and
+/// not done, and does not start when the task has cancelled it before
+////////////////////////////////////////////////////////////////////////////////
+
+struct triagens::rest::SslHandshake {
+  SslHandshake ()
+    : condition(),
+      started(false),
+      done(false),
+      cancelled(false),
+      result(false) {
+  }
+
+  ConditionVariable condition;
+  bool started;
+  bool done;
+  bool cancelled;
+  bool result;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    private helper
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal time in milliseconds a handshake job waits for the socket
+/// before it checks whether it was cancelled
+////////////////////////////////////////////////////////////////////////////////
+
+  int const HandshakePollInterval = 100;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief does a handshake in a thread of the handshake pool. the socket is
+/// non-blocking, so it is polled until the handshake is done, fails, times
+/// out or is cancelled
+////////////////////////////////////////////////////////////////////////////////
+
+  bool acceptInPool (SslHandshake* handshake,
+                     SSL* ssl,
+                     TRI_socket_t socket,
+                     double timeout) {
+    double const deadline = TRI_microtime() + timeout;
+
+    while (true) {
+      {
+        CONDITION_LOCKER(guard, handshake->condition);
+
+        if (handshake->cancelled) {
+          return false;
+        }
+      }
+
+      ERR_clear_error();
+      int res = SSL_accept(ssl);
+
+      if (res == 1) {
+        return true;
+      }
+
+      int err = SSL_get_error(ssl, res);
+      short events;
+
+      if (err == SSL_ERROR_WANT_READ) {
+        events = POLLIN;
+      }
+      else if (err == SSL_ERROR_WANT_WRITE) {
+        events = POLLOUT;
+      }
+      else {
+        LOG_TRACE("error in SSL handshake: %s", triagens::basics::lastSSLError().c_str());
+        return false;
+      }
+
+      if (TRI_microtime() >= deadline) {
+        LOG_DEBUG("SSL handshake timed out");
+        return false;
+      }
+
+      struct pollfd pfd;
+      pfd.events = events;
+      pfd.revents = 0;
+
+#ifdef _WIN32
+      pfd.fd = socket.fileHandle;
+      WSAPoll(&pfd, 1, HandshakePollInterval);
+#else
+      pfd.fd = socket.fileDescriptor;
+      poll(&pfd, 1, HandshakePollInterval);
+#endif
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -55,17 +164,21 @@ HttpsCommTask::HttpsCommTask (HttpsServer* server,
                               double keepAliveTimeout,
                               SSL_CTX* ctx,
                               int verificationMode,
-                              int (*verificationCallback)(int, X509_STORE_CTX*))
+                              int (*verificationCallback)(int, X509_STORE_CTX*),
+                              ThreadPool* handshakePool)
   : Task("HttpsCommTask"),
     HttpCommTask(server, socket, info, keepAliveTimeout),
     _accepted(false),
     _readBlockedOnWrite(false),
     _writeBlockedOnRead(false),
+    _kernelTls(false),
     _tmpReadBuffer(nullptr),
     _ssl(nullptr),
     _ctx(ctx),
     _verificationMode(verificationMode),
-    _verificationCallback(verificationCallback) {
+    _verificationCallback(verificationCallback),
+    _handshakePool(handshakePool),
+    _handshake() {
 
   _tmpReadBuffer = new char[READ_BLOCK_SIZE];
 }
@@ -75,6 +188,7 @@ HttpsCommTask::HttpsCommTask (HttpsServer* server,
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpsCommTask::~HttpsCommTask () {
+  cancelHandshake();
   shutdownSsl(true);
 
   delete[] _tmpReadBuffer;
@@ -135,10 +249,42 @@ bool HttpsCommTask::handleEvent (EventToken token,
   if (! _accepted) {
     bool result = false; // be pessimistic
 
-    if ((token == _readWatcher && (revents & EVENT_SOCKET_READ)) ||
-        (token == _writeWatcher && (revents & EVENT_SOCKET_WRITE))) {
+    if (_handshake != nullptr) {
+      // the handshake pool is doing the handshake and has stopped the socket
+      // events, it reports the end of the handshake with an async event
+      if (token != _asyncWatcher) {
+        return true;
+      }
+
+      {
+        CONDITION_LOCKER(guard, _handshake->condition);
+
+        if (! _handshake->done) {
+          return true;
+        }
+
+        result = _handshake->result;
+      }
+
+      _handshake.reset();
+
+      if (result) {
+        handshakeCompleted();
+      }
+      else {
+        shutdownSsl(false);
+      }
+    }
+    else if ((token == _readWatcher && (revents & EVENT_SOCKET_READ)) ||
+             (token == _writeWatcher && (revents & EVENT_SOCKET_WRITE))) {
       // must do the SSL handshake first
-      result = trySSLAccept();
+      if (_handshakePool != nullptr && _ssl != nullptr) {
+        startHandshake();
+        result = true;
+      }
+      else {
+        result = trySSLAccept();
+      }
     }
 
     if (! result) {
@@ -177,6 +323,17 @@ bool HttpsCommTask::handleEvent (EventToken token,
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpsCommTask::cleanup () {
+  // the handshake pool must not send events to the uninstalled watchers
+  cancelHandshake();
+
+  HttpCommTask::cleanup();
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    Socket methods
 // -----------------------------------------------------------------------------
@@ -214,6 +371,12 @@ bool HttpsCommTask::handleWrite () {
     return false;
   }
 
+  if (_kernelTls) {
+    // the kernel encrypts what is written to the socket, so the write buffers
+    // go out with the plain gathering write
+    return SocketTask::handleWrite();
+  }
+
   return trySSLWrite();
 }
 
@@ -236,12 +399,7 @@ bool HttpsCommTask::trySSLAccept () {
 
   // accept successful
   if (res == 1) {
-    LOG_DEBUG("established SSL connection");
-    _accepted = true;
-
-    // accept done, remove write events
-    _scheduler->stopSocketEvents(_writeWatcher);
-
+    handshakeCompleted();
     return true;
   }
 
@@ -269,6 +427,98 @@ bool HttpsCommTask::trySSLAccept () {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands the SSL handshake over to the handshake pool
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpsCommTask::startHandshake () {
+  TRI_ASSERT(_handshake == nullptr);
+
+  // the connection belongs to the pool until it reports the end of the
+  // handshake
+  _scheduler->stopSocketEvents(_readWatcher);
+  _scheduler->stopSocketEvents(_writeWatcher);
+
+  auto handshake = std::make_shared<SslHandshake>();
+  _handshake = handshake;
+
+  SSL* ssl = _ssl;
+  TRI_socket_t socket = _commSocket;
+  Scheduler* scheduler = _scheduler;
+  EventToken watcher = _asyncWatcher;
+  double const timeout = (_keepAliveTimeout > 0.0) ? _keepAliveTimeout : 60.0;
+
+  _handshakePool->enqueue([handshake, ssl, socket, scheduler, watcher, timeout] () {
+    {
+      CONDITION_LOCKER(guard, handshake->condition);
+
+      if (handshake->cancelled) {
+        handshake->done = true;
+        return;
+      }
+
+      handshake->started = true;
+    }
+
+    bool result = acceptInPool(handshake.get(), ssl, socket, timeout);
+
+    CONDITION_LOCKER(guard, handshake->condition);
+
+    handshake->done = true;
+    handshake->result = result;
+
+    if (handshake->cancelled) {
+      guard.broadcast();
+    }
+    else {
+      scheduler->sendAsync(watcher);
+    }
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief abandons a handshake of the handshake pool
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpsCommTask::cancelHandshake () {
+  if (_handshake == nullptr) {
+    return;
+  }
+
+  {
+    CONDITION_LOCKER(guard, _handshake->condition);
+
+    _handshake->cancelled = true;
+
+    // a running job checks for the cancellation at least every poll interval
+    while (_handshake->started && ! _handshake->done) {
+      guard.wait();
+    }
+  }
+
+  _handshake.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief switches to request handling after the handshake
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpsCommTask::handshakeCompleted () {
+  _accepted = true;
+
+#ifdef SSL_OP_ENABLE_KTLS
+  _kernelTls = (BIO_get_ktls_send(SSL_get_wbio(_ssl)) != 0);
+#endif
+
+  LOG_DEBUG("established SSL connection%s%s",
+            SSL_session_reused(_ssl) ? ", resumed session" : "",
+            _kernelTls ? ", kernel TLS" : "");
+
+  // accept done, remove write events
+  _scheduler->stopSocketEvents(_writeWatcher);
+  _scheduler->startSocketEvents(_readWatcher);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reads from SSL connection
 ////////////////////////////////////////////////////////////////////////////////
@@ -428,7 +678,7 @@ bool HttpsCommTask::trySSLWrite () {
   }
 
   if (len == 0) {
-    delete _writeBuffer;
+    releaseWriteBuffer(_writeBuffer);
     _writeBuffer = nullptr;
 
     completedWriteBuffer();
@@ -40,8 +40,13 @@
 // -----------------------------------------------------------------------------
 
 namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+
   namespace rest {
     class HttpsServer;
+    struct SslHandshake;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief https communication
@@ -79,7 +84,8 @@ namespace triagens {
                        double keepAliveTimeout,
                        SSL_CTX* ctx,
                        int verificationMode,
-                       int (*verificationCallback)(int, X509_STORE_CTX*));
+                       int (*verificationCallback)(int, X509_STORE_CTX*),
+                       basics::ThreadPool* handshakePool);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destructs a task
@@ -106,6 +112,12 @@ namespace triagens {
 
         bool handleEvent (EventToken, EventType) override;
 
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void cleanup () override;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    Socket methods
 // -----------------------------------------------------------------------------
@@ -134,6 +146,25 @@ namespace triagens {
 
         bool trySSLAccept ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands the SSL handshake over to the handshake pool
+////////////////////////////////////////////////////////////////////////////////
+
+        void startHandshake ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief abandons a handshake of the handshake pool, and waits until the
+/// pool does not use the connection anymore
+////////////////////////////////////////////////////////////////////////////////
+
+        void cancelHandshake ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief switches to request handling after the handshake
+////////////////////////////////////////////////////////////////////////////////
+
+        void handshakeCompleted ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reads from SSL connection
 ////////////////////////////////////////////////////////////////////////////////
@@ -176,6 +207,12 @@ namespace triagens {
 
         bool _writeBlockedOnRead;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the kernel encrypts the data written to the socket
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _kernelTls;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief temporary buffer
 ////////////////////////////////////////////////////////////////////////////////
@@ -205,6 +242,18 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         int (*_verificationCallback)(int, X509_STORE_CTX*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pool doing the handshakes, or nullptr to do them in the event loop
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::ThreadPool* _handshakePool;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the handshake running in the handshake pool
+////////////////////////////////////////////////////////////////////////////////
+
+        std::shared_ptr<SslHandshake> _handshake;
     };
   }
 }
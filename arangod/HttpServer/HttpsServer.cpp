@@ -54,7 +54,8 @@ HttpsServer::HttpsServer (Scheduler* scheduler,
   : HttpServer(scheduler, dispatcher, handlerFactory, jobManager, keepAliveTimeout),
     _ctx(ctx),
     _verificationMode(SSL_VERIFY_NONE),
-    _verificationCallback(0) {
+    _verificationCallback(0),
+    _handshakePool(nullptr) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -86,6 +87,14 @@ void HttpsServer::setVerificationCallback (int (*func)(int, X509_STORE_CTX *)) {
   _verificationCallback = func;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the pool doing the SSL handshakes
+////////////////////////////////////////////////////////////////////////////////
+
+void HttpsServer::setHandshakePool (triagens::basics::ThreadPool* pool) {
+  _handshakePool = pool;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                HttpServer methods
 // -----------------------------------------------------------------------------
@@ -96,7 +105,7 @@ void HttpsServer::setVerificationCallback (int (*func)(int, X509_STORE_CTX *)) {
 
 HttpCommTask* HttpsServer::createCommTask (TRI_socket_t s, const ConnectionInfo& info) {
   return new HttpsCommTask(
-    this, s, info, _keepAliveTimeout, _ctx, _verificationMode, _verificationCallback);
+    this, s, info, _keepAliveTimeout, _ctx, _verificationMode, _verificationCallback, _handshakePool);
 }
 
 // -----------------------------------------------------------------------------
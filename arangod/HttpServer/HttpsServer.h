@@ -39,6 +39,10 @@
 // -----------------------------------------------------------------------------
 
 namespace triagens {
+  namespace basics {
+    class ThreadPool;
+  }
+
   namespace rest {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,6 +92,13 @@ namespace triagens {
 
         void setVerificationCallback (int (*func)(int, X509_STORE_CTX *));
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the pool doing the SSL handshakes. without a pool they are
+/// done in the event loops
+////////////////////////////////////////////////////////////////////////////////
+
+        void setHandshakePool (basics::ThreadPool*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                HttpServer methods
 // -----------------------------------------------------------------------------
@@ -139,6 +150,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         int (*_verificationCallback)(int, X509_STORE_CTX*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pool doing the SSL handshakes
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::ThreadPool* _handshakePool;
     };
   }
 }
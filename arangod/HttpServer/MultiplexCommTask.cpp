@@ -0,0 +1,1333 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary communication
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MultiplexCommTask.h"
+
+#include "Basics/MutexLocker.h"
+#include "Basics/StringBuffer.h"
+#include "Basics/logging.h"
+#include "HttpServer/HttpHandler.h"
+#include "HttpServer/HttpHandlerFactory.h"
+#include "HttpServer/HttpServer.h"
+#include "HttpServer/HttpServerJob.h"
+#include "Scheduler/Scheduler.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+typedef MultiplexProtocol Mux;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class MultiplexCommTask
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief static initializers
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t const MultiplexCommTask::MaximalConcurrentStreams = 256;
+uint32_t const MultiplexCommTask::ReceiveWindowSize = 1024 * 1024; // 1 MB
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a new task
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexCommTask::MultiplexCommTask (HttpServer* server,
+                                      TRI_socket_t socket,
+                                      ConnectionInfo const& info,
+                                      double keepAliveTimeout)
+  : Task("MultiplexCommTask"),
+    HttpCommTask(server, socket, info, keepAliveTimeout),
+    _streams(),
+    _sendQueue(),
+    _waitingStreams(),
+    _output(nullptr),
+    _decoder(),
+    _encoder(),
+    _readOffset(0),
+    _currentStream(0),
+    _chunkedStream(0),
+    _lastStreamId(0),
+    _sendWindow(Mux::DefaultWindowSize),
+    _receiveWindow(Mux::DefaultWindowSize),
+    _initialSendWindow(Mux::DefaultWindowSize),
+    _maxSendFrameSize(Mux::DefaultMaxFrameSize),
+    _prefaceReceived(false),
+    _goAwayReceived(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destructs a task
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexCommTask::~MultiplexCommTask () {
+  // the base class can only see its own pipeline
+  for (auto& job : releaseJobs()) {
+    job->beginShutdown();
+  }
+
+  for (auto& it : _streams) {
+    delete it.second._body;
+
+    if (it.second._statistics != nullptr) {
+      TRI_ReleaseRequestStatistics(it.second._statistics);
+    }
+  }
+
+  delete _output;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               HttpCommTask methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<HttpServerJob*> MultiplexCommTask::releaseJobs () {
+  std::vector<HttpServerJob*> jobs;
+
+  for (auto& it : _streams) {
+    if (it.second._job != nullptr) {
+      jobs.emplace_back(it.second._job);
+      it.second._job = nullptr;
+    }
+  }
+
+  return jobs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::setCurrentJob (HttpServerJob* job) {
+  Stream* stream = findStream(_currentStream);
+
+  TRI_ASSERT(stream != nullptr);
+  TRI_ASSERT(stream->_job == nullptr);
+  stream->_job = job;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::clearCurrentJob () {
+  Stream* stream = findStream(_currentStream);
+
+  if (stream != nullptr) {
+    stream->_job = nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleResponse (HttpResponse* response) {
+  TRI_request_statistics_t* statistics = RequestStatisticsAgent::transfer();
+  Stream* stream = findStream(_currentStream);
+
+  if (stream == nullptr || _closeRequested) {
+    // the client has reset the stream in the meantime
+    if (statistics != nullptr) {
+      TRI_ReleaseRequestStatistics(statistics);
+    }
+    return;
+  }
+
+  TRI_ASSERT(stream->_statistics == nullptr);
+  stream->_statistics = statistics;
+
+  addCorsHeaders(response, stream->_origin, stream->_denyCredentials);
+
+  bool const isChunked = response->isChunked();
+  size_t const responseBodyLength = response->bodySize();
+
+  if (stream->_requestType == HttpRequest::HTTP_REQUEST_HEAD) {
+    // HEAD must not return a body
+    response->headResponse(responseBodyLength);
+  }
+
+  // the status and the headers, without the ones that only make sense for
+  // a connection of its own
+  std::vector<Mux::Header> headers;
+  headers.emplace_back(":status", StringUtils::itoa((int) response->responseCode()));
+
+  for (auto const& it : response->headers()) {
+    std::string const& key = it.first;
+
+    if (key == "connection" ||
+        key == "keep-alive" ||
+        key == "transfer-encoding" ||
+        key == "content-length") {
+      continue;
+    }
+
+    headers.emplace_back(key, it.second);
+  }
+
+  if (! isChunked) {
+    headers.emplace_back("content-length", StringUtils::itoa((uint64_t) responseBodyLength));
+  }
+
+  for (auto const& it : response->cookies()) {
+    headers.emplace_back("set-cookie", it);
+  }
+
+  StringBuffer block(TRI_UNKNOWN_MEM_ZONE);
+  _encoder.encode(headers, &block);
+
+  if (block.length() > _maxSendFrameSize) {
+    // CONTINUATION frames are not supported, the encoder state is lost
+    LOG_WARNING("response header block of %d bytes exceeds the maximal frame size", (int) block.length());
+    connectionError(Mux::ERROR_INTERNAL, "response header block too large");
+    return;
+  }
+
+  // the response body replaces the request body
+  stream->_body->clear();
+  stream->_sendOffset = 0;
+
+  if (stream->_requestType != HttpRequest::HTTP_REQUEST_HEAD) {
+    stream->_body->swap(&response->body());
+  }
+
+  stream->_localClosed = ! isChunked;
+
+  bool const endStream = (stream->_localClosed && stream->_body->length() == 0);
+
+  Mux::appendFrameHeader(output(),
+                         (uint32_t) block.length(),
+                         Mux::FRAME_HEADERS,
+                         Mux::FLAG_END_HEADERS | (endStream ? Mux::FLAG_END_STREAM : 0),
+                         stream->_id);
+  output()->appendText(block);
+
+  LOG_USAGE(",\"mux-request\",\"%s\",\"%s\",%d,%llu,\"%s\",%.6f",
+            _connectionInfo.clientAddress.c_str(),
+            HttpRequest::translateMethod(stream->_requestType).c_str(),
+            (int) response->responseCode(),
+            (unsigned long long) responseBodyLength,
+            _fullUrl.c_str(),
+            (stream->_readStart != 0.0 ? TRI_StatisticsTime() - stream->_readStart : 0.0));
+
+  if (isChunked) {
+    _isChunked = true;
+    _chunkedStream = stream->_id;
+    resumeChunked();
+  }
+
+  if (endStream) {
+    statistics = stream->_statistics;
+    stream->_statistics = nullptr;
+
+    removeStream(stream->_id);
+    flushOutput(statistics);
+  }
+  else {
+    queueStream(*stream);
+    sendStreams();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+bool MultiplexCommTask::processRead () {
+  if (_closeRequested || _readBuffer->c_str() == nullptr) {
+    return false;
+  }
+
+  if (! _isChunked && ! _waitingStreams.empty()) {
+    dispatchWaitingStreams();
+  }
+
+  size_t const available = _readBuffer->length() - _readOffset;
+  char const* ptr = _readBuffer->c_str() + _readOffset;
+
+  if (! _prefaceReceived) {
+    size_t const n = (std::min)(available, Mux::ConnectionPrefaceLength);
+
+    if (memcmp(ptr, Mux::ConnectionPreface, n) != 0) {
+      LOG_DEBUG("invalid connection preface, closing connection");
+
+      // there is no way to talk to a client that does not know the protocol
+      _closeRequested = true;
+      _clientClosed = true;
+      return false;
+    }
+
+    if (n < Mux::ConnectionPrefaceLength) {
+      return false;
+    }
+
+    _readOffset += n;
+    _prefaceReceived = true;
+
+    // announce our settings, and open the connection receive window as wide
+    // as the stream windows
+    StringBuffer* out = output();
+    Mux::appendFrameHeader(out, 18, Mux::FRAME_SETTINGS, 0, 0);
+
+    out->appendChar(0);
+    out->appendChar((char) Mux::SETTINGS_MAX_CONCURRENT_STREAMS);
+    Mux::appendUInt32(out, MaximalConcurrentStreams);
+
+    out->appendChar(0);
+    out->appendChar((char) Mux::SETTINGS_INITIAL_WINDOW_SIZE);
+    Mux::appendUInt32(out, ReceiveWindowSize);
+
+    out->appendChar(0);
+    out->appendChar((char) Mux::SETTINGS_ENABLE_PUSH);
+    Mux::appendUInt32(out, 0);
+
+    sendWindowUpdate(0, ReceiveWindowSize - Mux::DefaultWindowSize);
+    _receiveWindow = ReceiveWindowSize;
+
+    flushOutput();
+
+    return true;
+  }
+
+  if (available < Mux::FrameHeaderSize) {
+    compactReadBuffer();
+    return false;
+  }
+
+  Mux::FrameHeader header;
+  Mux::parseFrameHeader(ptr, header);
+
+  if (header._length > Mux::DefaultMaxFrameSize) {
+    connectionError(Mux::ERROR_FRAME_SIZE, "frame too large");
+    return false;
+  }
+
+  if (available < Mux::FrameHeaderSize + header._length) {
+    // let client send more
+    compactReadBuffer();
+    return false;
+  }
+
+  _readOffset += Mux::FrameHeaderSize + header._length;
+
+  handleFrame(header, ptr + Mux::FrameHeaderSize);
+  flushOutput();
+
+  return ! _closeRequested;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::sendChunk (StringBuffer* buffer) {
+  std::unique_ptr<StringBuffer> data(buffer);
+  Stream* stream = nullptr;
+
+  if (_isChunked) {
+    stream = findStream(_chunkedStream);
+  }
+
+  if (stream == nullptr || _closeRequested) {
+    return;
+  }
+
+  if (stream->_sendOffset == stream->_body->length()) {
+    stream->_body->clear();
+    stream->_sendOffset = 0;
+  }
+
+  stream->_body->appendText(*data);
+
+  queueStream(*stream);
+  sendStreams();
+  flushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::finishedChunked () {
+  Stream* stream = findStream(_chunkedStream);
+
+  _isChunked = false;
+  _chunkedStream = 0;
+
+  if (stream != nullptr && ! _closeRequested) {
+    stream->_localClosed = true;
+
+    queueStream(*stream);
+    sendStreams();
+    flushOutput();
+  }
+
+  while (processRead()) {
+    // process the requests which were held back by the chunked response
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+bool MultiplexCommTask::handleAsync () {
+  std::vector<std::pair<HttpServerJob*, HttpHandler*>> finished;
+
+  {
+    MUTEX_LOCKER(_finishedJobsLock);
+    finished.swap(_finishedJobs);
+  }
+
+  for (auto& it : finished) {
+    std::unique_ptr<HttpHandler> handler(it.second);
+    Stream* stream = nullptr;
+
+    for (auto& s : _streams) {
+      if (s.second._job == it.first) {
+        stream = &s.second;
+        break;
+      }
+    }
+
+    if (stream == nullptr) {
+      // the job has been shut down already
+      continue;
+    }
+
+    TRI_ASSERT(! it.first->hasHandler());
+
+    stream->_job = nullptr;
+    it.first->beginShutdown();
+
+    _currentStream = stream->_id;
+    _server->handleResponse(this, handler.get());
+    _currentStream = 0;
+  }
+
+  _server->handleAsync(this);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::completedWriteBuffer () {
+  _writeBuffer = nullptr;
+  _writeLength = 0;
+
+  if (_isChunked) {
+    _chunkedBacklog.fetch_sub(static_cast<int64_t>(_writeBufferLength), std::memory_order_relaxed);
+  }
+  _writeBufferLength = 0;
+
+  if (_writeBufferStatistics != nullptr) {
+    _writeBufferStatistics->_writeEnd = TRI_StatisticsTime();
+
+    TRI_ReleaseRequestStatistics(_writeBufferStatistics);
+    _writeBufferStatistics = nullptr;
+  }
+
+  fillWriteBuffer();
+
+  if (! _clientClosed && _closeRequested && ! hasWriteBuffer() && _writeBuffers.empty()) {
+    _clientClosed = true;
+    _server->handleCommunicationClosed(this);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a complete frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleFrame (Mux::FrameHeader const& header,
+                                     char const* payload) {
+  switch (header._type) {
+    case Mux::FRAME_DATA: {
+      handleData(header, payload);
+      break;
+    }
+
+    case Mux::FRAME_HEADERS: {
+      handleHeaders(header, payload);
+      break;
+    }
+
+    case Mux::FRAME_PRIORITY: {
+      // priorities are accepted, but all streams are served alike
+      if (header._length != 5) {
+        connectionError(Mux::ERROR_FRAME_SIZE, "invalid PRIORITY frame");
+      }
+      break;
+    }
+
+    case Mux::FRAME_RST_STREAM: {
+      if (header._streamId == 0 || header._length != 4) {
+        connectionError(Mux::ERROR_PROTOCOL, "invalid RST_STREAM frame");
+        break;
+      }
+
+      LOG_TRACE("client reset stream %u", (unsigned int) header._streamId);
+      removeStream(header._streamId);
+      break;
+    }
+
+    case Mux::FRAME_SETTINGS: {
+      handleSettings(header, payload);
+      break;
+    }
+
+    case Mux::FRAME_PING: {
+      if (header._streamId != 0 || header._length != 8) {
+        connectionError(Mux::ERROR_PROTOCOL, "invalid PING frame");
+        break;
+      }
+
+      if ((header._flags & Mux::FLAG_ACK) == 0) {
+        Mux::appendFrameHeader(output(), 8, Mux::FRAME_PING, Mux::FLAG_ACK, 0);
+        output()->appendText(payload, 8);
+      }
+      break;
+    }
+
+    case Mux::FRAME_GOAWAY: {
+      // the client opens no more streams, the open ones are answered
+      _goAwayReceived = true;
+
+      if (_streams.empty()) {
+        sendGoAway(Mux::ERROR_NONE);
+      }
+      break;
+    }
+
+    case Mux::FRAME_WINDOW_UPDATE: {
+      handleWindowUpdate(header, payload);
+      break;
+    }
+
+    case Mux::FRAME_PUSH_PROMISE:
+    case Mux::FRAME_CONTINUATION: {
+      connectionError(Mux::ERROR_PROTOCOL, "unsupported frame type");
+      break;
+    }
+
+    default: {
+      // unknown frame types must be ignored
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a DATA frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleData (Mux::FrameHeader const& header,
+                                    char const* payload) {
+  if (header._streamId == 0) {
+    connectionError(Mux::ERROR_PROTOCOL, "DATA frame on stream 0");
+    return;
+  }
+
+  // the padding counts against the flow-control windows as well
+  _receiveWindow -= header._length;
+
+  if (_receiveWindow < 0) {
+    connectionError(Mux::ERROR_FLOW_CONTROL, "connection receive window exceeded");
+    return;
+  }
+
+  if (header._length > 0) {
+    sendWindowUpdate(0, header._length);
+    _receiveWindow += header._length;
+  }
+
+  size_t length = header._length;
+
+  if (! stripPadding(header, payload, length)) {
+    return;
+  }
+
+  Stream* stream = findStream(header._streamId);
+
+  if (stream == nullptr || stream->_remoteClosed) {
+    if (header._streamId > _lastStreamId) {
+      connectionError(Mux::ERROR_PROTOCOL, "DATA frame on idle stream");
+    }
+    else {
+      resetStream(header._streamId, Mux::ERROR_STREAM_CLOSED);
+    }
+    return;
+  }
+
+  stream->_receiveWindow -= header._length;
+
+  if (stream->_receiveWindow < 0) {
+    resetStream(header._streamId, Mux::ERROR_FLOW_CONTROL);
+    return;
+  }
+
+  if (stream->_body->length() + length > MaximalBodySize) {
+    LOG_WARNING("maximal body size is %d, request body size is at least %d",
+                (int) MaximalBodySize,
+                (int) (stream->_body->length() + length));
+
+    resetStream(header._streamId, Mux::ERROR_REFUSED_STREAM);
+    return;
+  }
+
+  stream->_body->appendText(payload, length);
+
+  if ((header._flags & Mux::FLAG_END_STREAM) != 0) {
+    stream->_remoteClosed = true;
+    dispatchStream(*stream);
+  }
+  else if (header._length > 0) {
+    sendWindowUpdate(header._streamId, header._length);
+    stream->_receiveWindow += header._length;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a HEADERS frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleHeaders (Mux::FrameHeader const& header,
+                                       char const* payload) {
+  uint32_t const id = header._streamId;
+
+  if (id == 0 || (id & 1) == 0) {
+    connectionError(Mux::ERROR_PROTOCOL, "HEADERS frame on invalid stream");
+    return;
+  }
+
+  if (id <= _lastStreamId) {
+    // trailers are not supported
+    connectionError(Mux::ERROR_PROTOCOL, "HEADERS frame on used stream");
+    return;
+  }
+
+  if ((header._flags & Mux::FLAG_END_HEADERS) == 0) {
+    connectionError(Mux::ERROR_PROTOCOL, "CONTINUATION frames are not supported");
+    return;
+  }
+
+  size_t length = header._length;
+
+  if (! stripPadding(header, payload, length)) {
+    return;
+  }
+
+  if ((header._flags & Mux::FLAG_PRIORITY) != 0) {
+    if (length < 5) {
+      connectionError(Mux::ERROR_FRAME_SIZE, "invalid HEADERS frame");
+      return;
+    }
+
+    payload += 5;
+    length -= 5;
+  }
+
+  // the block must be decoded in any case to keep the table in sync
+  std::vector<Mux::Header> headers;
+
+  if (! _decoder.decode(payload, length, MaximalHeaderSize, headers)) {
+    connectionError(Mux::ERROR_COMPRESSION, "invalid header block");
+    return;
+  }
+
+  _lastStreamId = id;
+
+  if (_goAwayReceived) {
+    resetStream(id, Mux::ERROR_REFUSED_STREAM);
+    return;
+  }
+
+  if (_streams.size() >= MaximalConcurrentStreams) {
+    LOG_DEBUG("too many concurrent streams, refusing stream %u", (unsigned int) id);
+    resetStream(id, Mux::ERROR_REFUSED_STREAM);
+    return;
+  }
+
+  Stream stream;
+  stream._id              = id;
+  stream._job             = nullptr;
+  stream._headers         = std::move(headers);
+  stream._body            = new StringBuffer(TRI_UNKNOWN_MEM_ZONE);
+  stream._sendOffset      = 0;
+  stream._sendWindow      = _initialSendWindow;
+  stream._receiveWindow   = ReceiveWindowSize;
+  stream._statistics      = nullptr;
+  stream._requestType     = HttpRequest::HTTP_REQUEST_ILLEGAL;
+  stream._readStart       = TRI_StatisticsTime();
+  stream._denyCredentials = false;
+  stream._remoteClosed    = ((header._flags & Mux::FLAG_END_STREAM) != 0);
+  stream._dispatched      = false;
+  stream._localClosed     = false;
+  stream._queued          = false;
+
+  auto it = _streams.emplace(id, std::move(stream)).first;
+
+  if (it->second._remoteClosed) {
+    dispatchStream(it->second);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a SETTINGS frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleSettings (Mux::FrameHeader const& header,
+                                        char const* payload) {
+  if (header._streamId != 0) {
+    connectionError(Mux::ERROR_PROTOCOL, "SETTINGS frame on a stream");
+    return;
+  }
+
+  if ((header._flags & Mux::FLAG_ACK) != 0) {
+    if (header._length != 0) {
+      connectionError(Mux::ERROR_FRAME_SIZE, "invalid SETTINGS acknowledgement");
+    }
+    return;
+  }
+
+  if (header._length % 6 != 0) {
+    connectionError(Mux::ERROR_FRAME_SIZE, "invalid SETTINGS frame");
+    return;
+  }
+
+  for (size_t i = 0; i < header._length; i += 6) {
+    uint16_t const id = (uint16_t) (((uint8_t) payload[i] << 8) | (uint8_t) payload[i + 1]);
+    uint32_t const value = Mux::readUInt32(payload + i + 2);
+
+    switch (id) {
+      case Mux::SETTINGS_HEADER_TABLE_SIZE: {
+        _encoder.setMaxTableSize(value);
+        break;
+      }
+
+      case Mux::SETTINGS_INITIAL_WINDOW_SIZE: {
+        if (value > Mux::MaximalWindowSize) {
+          connectionError(Mux::ERROR_FLOW_CONTROL, "invalid initial window size");
+          return;
+        }
+
+        // the change applies to the open streams as well
+        int64_t const delta = (int64_t) value - _initialSendWindow;
+        _initialSendWindow = value;
+
+        for (auto& it : _streams) {
+          it.second._sendWindow += delta;
+          queueStream(it.second);
+        }
+        break;
+      }
+
+      case Mux::SETTINGS_MAX_FRAME_SIZE: {
+        if (value < Mux::DefaultMaxFrameSize || value > Mux::MaximalMaxFrameSize) {
+          connectionError(Mux::ERROR_PROTOCOL, "invalid maximal frame size");
+          return;
+        }
+
+        _maxSendFrameSize = value;
+        break;
+      }
+
+      default: {
+        // the other settings concern features the server does not use
+        break;
+      }
+    }
+  }
+
+  Mux::appendFrameHeader(output(), 0, Mux::FRAME_SETTINGS, Mux::FLAG_ACK, 0);
+
+  sendStreams();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a WINDOW_UPDATE frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::handleWindowUpdate (Mux::FrameHeader const& header,
+                                            char const* payload) {
+  if (header._length != 4) {
+    connectionError(Mux::ERROR_FRAME_SIZE, "invalid WINDOW_UPDATE frame");
+    return;
+  }
+
+  uint32_t const increment = Mux::readUInt32(payload) & 0x7fffffff;
+
+  if (header._streamId == 0) {
+    if (increment == 0) {
+      connectionError(Mux::ERROR_PROTOCOL, "invalid window increment");
+      return;
+    }
+
+    _sendWindow += increment;
+
+    if (_sendWindow > (int64_t) Mux::MaximalWindowSize) {
+      connectionError(Mux::ERROR_FLOW_CONTROL, "connection send window too large");
+      return;
+    }
+  }
+  else {
+    Stream* stream = findStream(header._streamId);
+
+    if (stream == nullptr) {
+      // the stream may have been closed in the meantime
+      return;
+    }
+
+    if (increment == 0) {
+      resetStream(header._streamId, Mux::ERROR_PROTOCOL);
+      return;
+    }
+
+    stream->_sendWindow += increment;
+
+    if (stream->_sendWindow > (int64_t) Mux::MaximalWindowSize) {
+      resetStream(header._streamId, Mux::ERROR_FLOW_CONTROL);
+      return;
+    }
+
+    queueStream(*stream);
+  }
+
+  sendStreams();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief strips the padding of a DATA or HEADERS frame
+////////////////////////////////////////////////////////////////////////////////
+
+bool MultiplexCommTask::stripPadding (Mux::FrameHeader const& header,
+                                      char const*& payload,
+                                      size_t& length) {
+  if ((header._flags & Mux::FLAG_PADDED) == 0) {
+    return true;
+  }
+
+  if (length < 1) {
+    connectionError(Mux::ERROR_FRAME_SIZE, "invalid padded frame");
+    return false;
+  }
+
+  size_t const padding = (uint8_t) payload[0];
+
+  if (padding >= length) {
+    connectionError(Mux::ERROR_PROTOCOL, "invalid padding");
+    return false;
+  }
+
+  payload += 1;
+  length -= 1 + padding;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the request of a stream into an HttpRequest and dispatches it
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::dispatchStream (Stream& stream) {
+  TRI_ASSERT(stream._remoteClosed);
+  TRI_ASSERT(! stream._dispatched);
+
+  if (_isChunked) {
+    // the chunked response owns the output of the handlers until it is done
+    _waitingStreams.push_back(stream._id);
+    return;
+  }
+
+  stream._dispatched = true;
+
+  RequestStatisticsAgent::acquire();
+  RequestStatisticsAgentSetReadStart(this);
+
+  if (RequestStatisticsAgent::_statistics != nullptr) {
+    // the request started with its HEADERS frame
+    RequestStatisticsAgent::_statistics->_readStart = stream._readStart;
+  }
+
+  RequestStatisticsAgentSetReadEnd(this);
+  RequestStatisticsAgentAddReceivedBytes(this, stream._body->length());
+
+  _currentStream = stream._id;
+
+  std::string header;
+
+  if (! buildRequestHeader(stream, header)) {
+    respondWithError(HttpResponse::BAD);
+    _currentStream = 0;
+    return;
+  }
+
+  LOG_TRACE("MUX READ FOR %p, stream %u: %s", (void*) this, (unsigned int) stream._id, header.c_str());
+
+  _request = _server->handlerFactory()->createRequest(
+    _connectionInfo,
+    header.c_str(),
+    header.size());
+
+  if (_request == nullptr) {
+    LOG_ERROR("cannot generate request");
+
+    respondWithError(HttpResponse::SERVER_ERROR);
+    _currentStream = 0;
+    return;
+  }
+
+  _request->setClientTaskId(_taskId);
+  _request->setProtocol(_server->protocol());
+  _request->setBody(stream._body->c_str(), stream._body->length());
+
+  // the body has been copied into the request
+  stream._body->clear();
+
+  _httpVersion = _request->httpVersion();
+  _requestType = _request->requestType();
+  _fullUrl = _request->fullUrl();
+  _origin = _request->header("origin");
+  _denyCredentials = false;
+
+  if (! _origin.empty()) {
+    bool found;
+    std::string const& allowCredentials = _request->header("access-control-allow-credentials", found);
+
+    if (found) {
+      _denyCredentials = ! StringUtils::boolean(allowCredentials);
+    }
+  }
+
+  stream._requestType = _requestType;
+  stream._origin = _origin;
+  stream._denyCredentials = _denyCredentials;
+
+  RequestStatisticsAgentSetRequestType(this, _requestType);
+  RequestStatisticsAgentSetEndpoint(this, _request->requestPath());
+
+  if (_requestType == HttpRequest::HTTP_REQUEST_ILLEGAL) {
+    respondWithError(HttpResponse::METHOD_NOT_ALLOWED);
+    _currentStream = 0;
+    return;
+  }
+
+  Scheduler const* scheduler = _server->scheduler();
+
+  if (scheduler != nullptr && ! scheduler->isActive()) {
+    // server is inactive and will intentionally respond with HTTP 503
+    LOG_TRACE("cannot serve request - server is inactive");
+
+    respondWithError(HttpResponse::SERVICE_UNAVAILABLE);
+    _currentStream = 0;
+    return;
+  }
+
+  dispatchRequest();
+
+  _currentStream = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dispatches the complete requests held back by a chunked response
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::dispatchWaitingStreams () {
+  while (! _isChunked && ! _waitingStreams.empty()) {
+    uint32_t const id = _waitingStreams.front();
+    _waitingStreams.pop_front();
+
+    Stream* stream = findStream(id);
+
+    if (stream != nullptr && ! stream->_dispatched) {
+      dispatchStream(*stream);
+    }
+  }
+
+  flushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the HTTP header of a stream, fails for invalid headers
+///
+/// the header is parsed by the handler factory as for an HTTP request
+////////////////////////////////////////////////////////////////////////////////
+
+bool MultiplexCommTask::buildRequestHeader (Stream const& stream,
+                                            std::string& result) const {
+  std::string method;
+  std::string path;
+  std::string authority;
+  bool hasHost = false;
+
+  auto isValid = [] (std::string const& value) -> bool {
+    return value.find_first_of(std::string("\r\n\0", 3)) == std::string::npos;
+  };
+
+  for (auto const& it : stream._headers) {
+    if (! isValid(it.first) || ! isValid(it.second)) {
+      return false;
+    }
+
+    if (it.first == ":method") {
+      method = it.second;
+    }
+    else if (it.first == ":path") {
+      path = it.second;
+    }
+    else if (it.first == ":authority") {
+      authority = it.second;
+    }
+    else if (it.first == "host") {
+      hasHost = true;
+    }
+  }
+
+  if (method.empty() ||
+      path.empty() ||
+      method.find(' ') != std::string::npos ||
+      path.find(' ') != std::string::npos) {
+    return false;
+  }
+
+  result.reserve(256);
+  result.append(method);
+  result.push_back(' ');
+  result.append(path);
+  result.append(" HTTP/1.1\r\n");
+
+  if (! hasHost && ! authority.empty()) {
+    result.append("host: ");
+    result.append(authority);
+    result.append("\r\n");
+  }
+
+  for (auto const& it : stream._headers) {
+    std::string const& key = it.first;
+
+    if (key.empty() || key[0] == ':') {
+      continue;
+    }
+
+    if (key.find(':') != std::string::npos) {
+      return false;
+    }
+
+    if (key == "content-length" || key == "connection" || key == "transfer-encoding") {
+      // the body length is given by the DATA frames
+      continue;
+    }
+
+    result.append(key);
+    result.append(": ");
+    result.append(it.second);
+    result.append("\r\n");
+  }
+
+  if (stream._body->length() > 0) {
+    result.append("content-length: ");
+    result.append(StringUtils::itoa((uint64_t) stream._body->length()));
+    result.append("\r\n");
+  }
+
+  result.append("\r\n");
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief answers the current stream with an error response
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::respondWithError (HttpResponse::HttpResponseCode code) {
+  HttpResponse response(code, getCompatibility());
+
+  clearRequest();
+  handleResponse(&response);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a stream
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexCommTask::Stream* MultiplexCommTask::findStream (uint32_t id) {
+  auto it = _streams.find(id);
+
+  if (it == _streams.end()) {
+    return nullptr;
+  }
+
+  return &(it->second);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a stream, shutting down its job
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::removeStream (uint32_t id) {
+  auto it = _streams.find(id);
+
+  if (it == _streams.end()) {
+    return;
+  }
+
+  Stream& stream = it->second;
+
+  if (stream._job != nullptr) {
+    stream._job->beginShutdown();
+  }
+
+  delete stream._body;
+
+  if (stream._statistics != nullptr) {
+    TRI_ReleaseRequestStatistics(stream._statistics);
+  }
+
+  // the ids in the queues are skipped once the stream is gone
+  _streams.erase(it);
+
+  if (_goAwayReceived && _streams.empty() && ! _closeRequested) {
+    sendGoAway(Mux::ERROR_NONE);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a stream with unsent response data to the send queue
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::queueStream (Stream& stream) {
+  if (stream._queued || ! stream._dispatched) {
+    return;
+  }
+
+  if (stream._sendOffset == stream._body->length() && ! stream._localClosed) {
+    // nothing to send yet
+    return;
+  }
+
+  stream._queued = true;
+  _sendQueue.push_back(stream._id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes DATA frames of the queued streams as the windows allow
+///
+/// the streams take turns with one frame each, so that a large response
+/// does not hold back the small ones
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::sendStreams () {
+  while (! _sendQueue.empty() && ! _closeRequested) {
+    uint32_t const id = _sendQueue.front();
+    _sendQueue.pop_front();
+
+    Stream* stream = findStream(id);
+
+    if (stream == nullptr) {
+      continue;
+    }
+
+    size_t const remaining = stream->_body->length() - stream->_sendOffset;
+
+    if (remaining > 0 && _sendWindow <= 0) {
+      // the connection window is exhausted, wait for a WINDOW_UPDATE
+      _sendQueue.push_front(id);
+      break;
+    }
+
+    if (remaining > 0 && stream->_sendWindow <= 0) {
+      // wait for a WINDOW_UPDATE of the stream
+      stream->_queued = false;
+      continue;
+    }
+
+    size_t n = (std::min)(remaining, (size_t) _maxSendFrameSize);
+    n = (std::min)(n, (size_t) _sendWindow);
+    n = (std::min)(n, (size_t) stream->_sendWindow);
+
+    bool const endStream = (stream->_localClosed && n == remaining);
+
+    if (n == 0 && ! endStream) {
+      stream->_queued = false;
+      continue;
+    }
+
+    Mux::appendFrameHeader(output(),
+                           (uint32_t) n,
+                           Mux::FRAME_DATA,
+                           endStream ? Mux::FLAG_END_STREAM : 0,
+                           id);
+    output()->appendText(stream->_body->c_str() + stream->_sendOffset, n);
+
+    stream->_sendOffset += n;
+    stream->_sendWindow -= n;
+    _sendWindow -= n;
+
+    if (endStream) {
+      TRI_request_statistics_t* statistics = stream->_statistics;
+      stream->_statistics = nullptr;
+
+      removeStream(id);
+      flushOutput(statistics);
+      continue;
+    }
+
+    if (stream->_sendOffset < stream->_body->length()) {
+      _sendQueue.push_back(id);
+    }
+    else {
+      // all data of a chunked response is sent, wait for the next chunk
+      stream->_body->clear();
+      stream->_sendOffset = 0;
+      stream->_queued = false;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resets a stream
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::resetStream (uint32_t id,
+                                     Mux::ErrorCode code) {
+  Mux::appendFrameHeader(output(), 4, Mux::FRAME_RST_STREAM, 0, id);
+  Mux::appendUInt32(output(), code);
+
+  removeStream(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fails the connection
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::connectionError (Mux::ErrorCode code,
+                                         char const* reason) {
+  LOG_DEBUG("closing multiplexed connection: %s", reason);
+
+  sendGoAway(code);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a GOAWAY frame and closes the connection once it is written
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::sendGoAway (Mux::ErrorCode code) {
+  if (_closeRequested) {
+    return;
+  }
+
+  Mux::appendFrameHeader(output(), 8, Mux::FRAME_GOAWAY, 0, 0);
+  Mux::appendUInt32(output(), _lastStreamId);
+  Mux::appendUInt32(output(), code);
+
+  _closeRequested = true;
+
+  flushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a WINDOW_UPDATE frame
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::sendWindowUpdate (uint32_t streamId,
+                                          uint32_t increment) {
+  Mux::appendFrameHeader(output(), 4, Mux::FRAME_WINDOW_UPDATE, 0, streamId);
+  Mux::appendUInt32(output(), increment);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the buffer for outgoing frames
+////////////////////////////////////////////////////////////////////////////////
+
+StringBuffer* MultiplexCommTask::output () {
+  if (_output == nullptr) {
+    _output = new StringBuffer(TRI_UNKNOWN_MEM_ZONE);
+  }
+
+  return _output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the outgoing frames to the write buffers
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::flushOutput (TRI_request_statistics_t* statistics) {
+  if (_output == nullptr || _output->length() == 0) {
+    TRI_ASSERT(statistics == nullptr);
+    return;
+  }
+
+  _writeBuffers.push_back(_output);
+  _writeBuffersStats.push_back(statistics);
+  _output = nullptr;
+
+  // start output
+  fillWriteBuffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the consumed frames from the read buffer
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexCommTask::compactReadBuffer () {
+  if (_readOffset == 0) {
+    return;
+  }
+
+  if (_readOffset == _readBuffer->length()) {
+    _readBuffer->clear();
+  }
+  else {
+    _readBuffer->erase_front(_readOffset);
+  }
+
+  _readOffset = 0;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
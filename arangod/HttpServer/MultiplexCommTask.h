@@ -0,0 +1,451 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary communication
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_HTTP_SERVER_MULTIPLEX_COMM_TASK_H
+#define ARANGODB_HTTP_SERVER_MULTIPLEX_COMM_TASK_H 1
+
+#include "HttpServer/HttpCommTask.h"
+
+#include "Rest/MultiplexProtocol.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class MultiplexCommTask
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace rest {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary communication
+///
+/// speaks the protocol described in MultiplexProtocol. each stream carries
+/// one request, which is turned into an HttpRequest and dispatched like an
+/// HTTP request, so all handlers work unchanged. the requests of different
+/// streams run concurrently, and their responses are interleaved on the
+/// connection as their handlers finish
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexCommTask : public HttpCommTask {
+      MultiplexCommTask (MultiplexCommTask const&) = delete;
+      MultiplexCommTask const& operator= (MultiplexCommTask const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a new task
+////////////////////////////////////////////////////////////////////////////////
+
+        MultiplexCommTask (HttpServer*,
+                           TRI_socket_t,
+                           ConnectionInfo const&,
+                           double keepAliveTimeout);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destructs a task
+////////////////////////////////////////////////////////////////////////////////
+
+      protected:
+        ~MultiplexCommTask ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               HttpCommTask methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<HttpServerJob*> releaseJobs () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void setCurrentJob (HttpServerJob*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearCurrentJob () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleResponse (HttpResponse*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool processRead () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void sendChunk (basics::StringBuffer*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void finishedChunked () override;
+
+      protected:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool handleAsync () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void completedWriteBuffer () override;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a stream, i. e. one request and its response
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Stream {
+          uint32_t _id;
+          HttpServerJob* _job;
+          std::vector<MultiplexProtocol::Header> _headers;
+
+          // the request body, and the response body once the response is there
+          basics::StringBuffer* _body;
+          size_t _sendOffset;
+
+          int64_t _sendWindow;
+          int64_t _receiveWindow;
+          TRI_request_statistics_t* _statistics;
+          HttpRequest::HttpRequestType _requestType;
+          std::string _origin;
+          double _readStart;
+          bool _denyCredentials;
+
+          // the client has sent its END_STREAM
+          bool _remoteClosed;
+
+          // the request has been handed to a handler
+          bool _dispatched;
+
+          // the complete response is in the body
+          bool _localClosed;
+
+          // the stream is in the send queue
+          bool _queued;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a complete frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleFrame (MultiplexProtocol::FrameHeader const&,
+                          char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a DATA frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleData (MultiplexProtocol::FrameHeader const&,
+                         char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a HEADERS frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleHeaders (MultiplexProtocol::FrameHeader const&,
+                            char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a SETTINGS frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleSettings (MultiplexProtocol::FrameHeader const&,
+                             char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles a WINDOW_UPDATE frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleWindowUpdate (MultiplexProtocol::FrameHeader const&,
+                                 char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief strips the padding of a DATA or HEADERS frame
+////////////////////////////////////////////////////////////////////////////////
+
+        bool stripPadding (MultiplexProtocol::FrameHeader const&,
+                           char const*&,
+                           size_t&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the request of a stream into an HttpRequest and dispatches it
+////////////////////////////////////////////////////////////////////////////////
+
+        void dispatchStream (Stream&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dispatches the complete requests held back by a chunked response
+////////////////////////////////////////////////////////////////////////////////
+
+        void dispatchWaitingStreams ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the HTTP header of a stream, fails for invalid headers
+////////////////////////////////////////////////////////////////////////////////
+
+        bool buildRequestHeader (Stream const&,
+                                 std::string&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief answers the current stream with an error response
+////////////////////////////////////////////////////////////////////////////////
+
+        void respondWithError (HttpResponse::HttpResponseCode);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a stream
+////////////////////////////////////////////////////////////////////////////////
+
+        Stream* findStream (uint32_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a stream, shutting down its job
+////////////////////////////////////////////////////////////////////////////////
+
+        void removeStream (uint32_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a stream with unsent response data to the send queue
+////////////////////////////////////////////////////////////////////////////////
+
+        void queueStream (Stream&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes DATA frames of the queued streams as the windows allow
+////////////////////////////////////////////////////////////////////////////////
+
+        void sendStreams ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resets a stream
+////////////////////////////////////////////////////////////////////////////////
+
+        void resetStream (uint32_t,
+                          MultiplexProtocol::ErrorCode);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fails the connection
+////////////////////////////////////////////////////////////////////////////////
+
+        void connectionError (MultiplexProtocol::ErrorCode,
+                              char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a GOAWAY frame and closes the connection once it is written
+////////////////////////////////////////////////////////////////////////////////
+
+        void sendGoAway (MultiplexProtocol::ErrorCode);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a WINDOW_UPDATE frame
+////////////////////////////////////////////////////////////////////////////////
+
+        void sendWindowUpdate (uint32_t streamId,
+                               uint32_t increment);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the buffer for outgoing frames
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::StringBuffer* output ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the outgoing frames to the write buffers
+///
+/// the statistics belong to the last response completed by the frames
+////////////////////////////////////////////////////////////////////////////////
+
+        void flushOutput (TRI_request_statistics_t* = nullptr);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the consumed frames from the read buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        void compactReadBuffer ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the open streams
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<uint32_t, Stream> _streams;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ids of the streams with unsent response data, in send order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<uint32_t> _sendQueue;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ids of the complete requests held back by a chunked response
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<uint32_t> _waitingStreams;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frames not yet moved to the write buffers
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::StringBuffer* _output;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decoder for request header blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        MultiplexHeaderDecoder _decoder;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief encoder for response header blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        MultiplexHeaderEncoder _encoder;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read position in the read buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _readOffset;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief id of the stream whose response is written right now
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _currentStream;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief id of the stream with the chunked response, if any
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _chunkedStream;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief highest stream id the client has opened
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _lastStreamId;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief connection send window
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t _sendWindow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief connection receive window
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t _receiveWindow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initial send window of new streams, as set by the client
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t _initialSendWindow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal DATA payload the client accepts
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _maxSendFrameSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the connection preface has been received
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _prefaceReceived;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the client has sent a GOAWAY
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _goAwayReceived;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of concurrent streams per connection
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const MaximalConcurrentStreams;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief receive window of the connection and of each stream
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const ReceiveWindowSize;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary server
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MultiplexServer.h"
+
+#include "HttpServer/MultiplexCommTask.h"
+
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class MultiplexServer
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a new multiplex server
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexServer::MultiplexServer (Scheduler* scheduler,
+                                  Dispatcher* dispatcher,
+                                  HttpHandlerFactory* handlerFactory,
+                                  AsyncJobManager* jobManager,
+                                  double keepAliveTimeout)
+  : HttpServer(scheduler, dispatcher, handlerFactory, jobManager, keepAliveTimeout) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destructor
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexServer::~MultiplexServer () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                HttpServer methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+HttpCommTask* MultiplexServer::createCommTask (TRI_socket_t s, const ConnectionInfo& info) {
+  return new MultiplexCommTask(this, s, info, _keepAliveTimeout);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
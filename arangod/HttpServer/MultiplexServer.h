@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary server
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_HTTP_SERVER_MULTIPLEX_SERVER_H
+#define ARANGODB_HTTP_SERVER_MULTIPLEX_SERVER_H 1
+
+#include "HttpServer/HttpServer.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class MultiplexServer
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace rest {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief server for the multiplexed binary protocol
+///
+/// the requests arrive as streams of a single connection, but are handled by
+/// the same handlers as plain http requests
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexServer : public HttpServer {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a new multiplex server
+////////////////////////////////////////////////////////////////////////////////
+
+        MultiplexServer (Scheduler*,
+                         Dispatcher*,
+                         HttpHandlerFactory*,
+                         AsyncJobManager*,
+                         double keepAliveTimeout);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destructor
+////////////////////////////////////////////////////////////////////////////////
+
+        ~MultiplexServer ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                HttpServer methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        HttpCommTask* createCommTask (TRI_socket_t, const ConnectionInfo&) override;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
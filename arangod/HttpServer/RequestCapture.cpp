@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief capture of incoming HTTP requests for a later replay
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RequestCapture.h"
+#include "Basics/files.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/logging.h"
+#include "Basics/Mutex.h"
+#include "Basics/MutexLocker.h"
+#include "Rest/HttpRequest.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the file and the counter
+////////////////////////////////////////////////////////////////////////////////
+
+static Mutex CaptureLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the capture file, or -1
+////////////////////////////////////////////////////////////////////////////////
+
+static int CaptureFd = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the start of the capture
+////////////////////////////////////////////////////////////////////////////////
+
+static double CaptureStart = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal number of requests, 0 means no limit
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t CaptureLimit = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of requests written
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t CaptureCount = 0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class RequestCapture
+// -----------------------------------------------------------------------------
+
+std::atomic<bool> RequestCapture::Enabled(false);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the capture into a file
+////////////////////////////////////////////////////////////////////////////////
+
+bool RequestCapture::start (std::string const& filename,
+                            uint64_t limit) {
+  MUTEX_LOCKER(CaptureLock);
+
+  TRI_ASSERT(CaptureFd < 0);
+
+  int fd = TRI_CREATE(filename.c_str(), O_APPEND | O_CREAT | O_WRONLY, S_IRUSR | S_IWUSR);
+
+  if (fd < 0) {
+    LOG_ERROR("cannot open request capture file '%s': %s", filename.c_str(), TRI_LAST_ERROR_STR);
+    return false;
+  }
+
+  TRI_SetCloseOnExitFile(fd);
+
+  CaptureFd = fd;
+  CaptureStart = TRI_microtime();
+  CaptureLimit = limit;
+  CaptureCount = 0;
+
+  Enabled.store(true, std::memory_order_relaxed);
+
+  LOG_INFO("capturing requests in '%s'", filename.c_str());
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stops the capture and closes the file
+////////////////////////////////////////////////////////////////////////////////
+
+void RequestCapture::stop () {
+  MUTEX_LOCKER(CaptureLock);
+
+  Enabled.store(false, std::memory_order_relaxed);
+
+  if (CaptureFd >= 0) {
+    TRI_CLOSE(CaptureFd);
+    CaptureFd = -1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes a complete request to the capture file
+////////////////////////////////////////////////////////////////////////////////
+
+void RequestCapture::capture (HttpRequest const* request) {
+  double const now = TRI_microtime();
+
+  std::string line;
+
+  try {
+    Json json(Json::Object, 5);
+
+    json("time", Json(now - CaptureStart))
+        ("method", Json(HttpRequest::translateMethod(request->requestType())))
+        ("database", Json(request->databaseName()))
+        ("url", Json(request->fullUrl()))
+        ("body", Json(std::string(request->body(), request->bodySize())));
+
+    line = json.toString();
+    line.push_back('\n');
+  }
+  catch (...) {
+    // a request that cannot be captured is simply missing in the file
+    return;
+  }
+
+  MUTEX_LOCKER(CaptureLock);
+
+  if (CaptureFd < 0) {
+    return;
+  }
+
+  if (! TRI_WritePointer(CaptureFd, line.c_str(), line.size())) {
+    LOG_ERROR("cannot write request capture file, stopping the capture");
+    Enabled.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  if (CaptureLimit > 0 && ++CaptureCount >= CaptureLimit) {
+    LOG_INFO("captured %llu requests, stopping the capture", (unsigned long long) CaptureCount);
+    Enabled.store(false, std::memory_order_relaxed);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
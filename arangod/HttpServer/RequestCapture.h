@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief capture of incoming HTTP requests for a later replay
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_HTTP_SERVER_REQUEST_CAPTURE_H
+#define ARANGODB_HTTP_SERVER_REQUEST_CAPTURE_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+
+namespace triagens {
+  namespace rest {
+    class HttpRequest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class RequestCapture
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes incoming requests to a file, which arangob can replay
+///
+/// every request is written as one line of JSON:
+///
+///   { "time": 1.234567, "method": "POST", "database": "_system",
+///     "url": "/_api/document?collection=users", "body": "..." }
+///
+/// time is the arrival of the request in seconds since the capture started.
+/// headers are not captured, so credentials do not end up in the file. the
+/// bodies are, so the file must be protected like the data itself
+////////////////////////////////////////////////////////////////////////////////
+
+    class RequestCapture {
+
+      public:
+
+        RequestCapture () = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the capture into a file. at most limit requests are written,
+/// 0 means no limit
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool start (std::string const& filename,
+                           uint64_t limit);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stops the capture and closes the file
+////////////////////////////////////////////////////////////////////////////////
+
+        static void stop ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether requests are captured
+////////////////////////////////////////////////////////////////////////////////
+
+        static inline bool enabled () {
+          return Enabled.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes a complete request to the capture file
+////////////////////////////////////////////////////////////////////////////////
+
+        static void capture (HttpRequest const*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether requests are captured, checked for every request
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::atomic<bool> Enabled;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,463 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aggregate index, a materialized view of grouped aggregates
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "AggregateIndex.h"
+#include "Basics/StringBuffer.h"
+#include "Indexes/GeoIndex2.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        struct AggregateDefinition
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a function name, returns false if it is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+bool AggregateDefinition::function (std::string const& name,
+                                    AggregateFunction& result) {
+  if (name == "COUNT" || name == "LENGTH") {
+    result = AGGREGATE_COUNT;
+  }
+  else if (name == "SUM") {
+    result = AGGREGATE_SUM;
+  }
+  else if (name == "AVERAGE" || name == "AVG") {
+    result = AGGREGATE_AVERAGE;
+  }
+  else if (name == "MIN") {
+    result = AGGREGATE_MIN;
+  }
+  else if (name == "MAX") {
+    result = AGGREGATE_MAX;
+  }
+  else {
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name of a function
+////////////////////////////////////////////////////////////////////////////////
+
+char const* AggregateDefinition::functionName (AggregateFunction function) {
+  switch (function) {
+    case AGGREGATE_COUNT:
+      return "COUNT";
+    case AGGREGATE_SUM:
+      return "SUM";
+    case AGGREGATE_AVERAGE:
+      return "AVERAGE";
+    case AGGREGATE_MIN:
+      return "MIN";
+    case AGGREGATE_MAX:
+      return "MAX";
+  }
+
+  return "";
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class AggregateIndex
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a new aggregate index
+////////////////////////////////////////////////////////////////////////////////
+
+AggregateIndex::AggregateIndex (TRI_idx_iid_t iid,
+                                TRI_document_collection_t* collection,
+                                std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
+                                std::vector<TRI_shape_pid_t> const& paths,
+                                std::string const& name,
+                                std::vector<AggregateDefinition> const& aggregates)
+  : Index(iid, collection, fields, false, false),
+    _paths(paths),
+    _name(name),
+    _aggregates(aggregates),
+    _groups() {
+
+  TRI_ASSERT(iid != 0);
+  TRI_ASSERT(_paths.size() == _fields.size());
+}
+
+AggregateIndex::~AggregateIndex () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+size_t AggregateIndex::memory () const {
+  size_t memory = _groups.size() * (sizeof(std::string) + sizeof(Group) + 2 * sizeof(void*));
+
+  for (auto const& it : _groups) {
+    memory += it.first.capacity() +
+              TRI_MemoryUsageJson(it.second._values.get()) +
+              it.second._aggregates.size() * sizeof(AggregateState);
+
+    for (auto const& aggregate : it.second._aggregates) {
+      // a node of the tree per distinct value
+      memory += aggregate._values.size() * (sizeof(double) + sizeof(uint64_t) + 4 * sizeof(void*));
+    }
+  }
+
+  return memory;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json AggregateIndex::toJson (TRI_memory_zone_t* zone,
+                                               bool withFigures) const {
+  auto json = Index::toJson(zone, withFigures);
+
+  triagens::basics::Json aggregates(zone, triagens::basics::Json::Array, _aggregates.size());
+
+  for (auto const& it : _aggregates) {
+    triagens::basics::Json aggregate(zone, triagens::basics::Json::Object, 3);
+    aggregate("name", triagens::basics::Json(zone, it._name))
+             ("function", triagens::basics::Json(zone, AggregateDefinition::functionName(it._function)));
+
+    if (! it._attribute.empty()) {
+      aggregate("attribute", triagens::basics::Json(zone, it._attribute));
+    }
+
+    aggregates.add(aggregate);
+  }
+
+  json("name", triagens::basics::Json(zone, _name))
+      ("aggregates", aggregates)
+      ("unique", triagens::basics::Json(zone, false))
+      ("sparse", triagens::basics::Json(zone, false));
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index figures
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json AggregateIndex::toJsonFigures (TRI_memory_zone_t* zone) const {
+  triagens::basics::Json json(triagens::basics::Json::Object);
+  json("memory", triagens::basics::Json(static_cast<double>(memory())));
+  json("groups", triagens::basics::Json(static_cast<double>(_groups.size())));
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a document to its group
+////////////////////////////////////////////////////////////////////////////////
+
+int AggregateIndex::insert (TRI_doc_mptr_t const* doc,
+                            bool) {
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  std::unique_ptr<TRI_json_t> values;
+  std::string key;
+
+  int res = groupValues(&shapedJson, values, key);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  try {
+    auto it = _groups.find(key);
+
+    if (it == _groups.end()) {
+      it = _groups.emplace(key, Group()).first;
+      (*it).second._values = std::move(values);
+      (*it).second._aggregates.resize(_aggregates.size());
+    }
+
+    Group& group = (*it).second;
+    ++group._count;
+
+    for (size_t i = 0; i < _aggregates.size(); ++i) {
+      auto const& definition = _aggregates[i];
+      double value;
+
+      if (definition._function == AggregateDefinition::AGGREGATE_COUNT ||
+          ! GeoIndex2::extractDoubleObject(shaper, &shapedJson, definition._path, &value) ||
+          value != value) {
+        continue;
+      }
+
+      AggregateState& state = group._aggregates[i];
+      ++state._count;
+      state._sum += value;
+
+      if (definition._function == AggregateDefinition::AGGREGATE_MIN ||
+          definition._function == AggregateDefinition::AGGREGATE_MAX) {
+        ++state._values[value];
+      }
+    }
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document from its group
+////////////////////////////////////////////////////////////////////////////////
+
+int AggregateIndex::remove (TRI_doc_mptr_t const* doc,
+                            bool) {
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  std::unique_ptr<TRI_json_t> values;
+  std::string key;
+
+  int res = groupValues(&shapedJson, values, key);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  auto it = _groups.find(key);
+
+  if (it == _groups.end()) {
+    // the document was not added
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  Group& group = (*it).second;
+
+  if (--group._count == 0) {
+    _groups.erase(it);
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  for (size_t i = 0; i < _aggregates.size(); ++i) {
+    auto const& definition = _aggregates[i];
+    double value;
+
+    if (definition._function == AggregateDefinition::AGGREGATE_COUNT ||
+        ! GeoIndex2::extractDoubleObject(shaper, &shapedJson, definition._path, &value) ||
+        value != value) {
+      continue;
+    }
+
+    AggregateState& state = group._aggregates[i];
+
+    if (state._count == 0) {
+      continue;
+    }
+
+    if (--state._count == 0) {
+      // start over, so that rounding errors do not accumulate
+      state._sum = 0.0;
+    }
+    else {
+      state._sum -= value;
+    }
+
+    if (definition._function == AggregateDefinition::AGGREGATE_MIN ||
+        definition._function == AggregateDefinition::AGGREGATE_MAX) {
+      auto it2 = state._values.find(value);
+
+      if (it2 != state._values.end() && --(*it2).second == 0) {
+        state._values.erase(it2);
+      }
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the index has the same definition
+////////////////////////////////////////////////////////////////////////////////
+
+bool AggregateIndex::isSame (std::vector<TRI_shape_pid_t> const& paths,
+                             std::vector<AggregateDefinition> const& aggregates) const {
+  if (paths != _paths || aggregates.size() != _aggregates.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < aggregates.size(); ++i) {
+    if (aggregates[i]._name != _aggregates[i]._name ||
+        aggregates[i]._function != _aggregates[i]._function ||
+        aggregates[i]._path != _aggregates[i]._path) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the groups
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json AggregateIndex::groups (TRI_memory_zone_t* zone) const {
+  triagens::basics::Json result(zone, triagens::basics::Json::Array, _groups.size());
+
+  for (auto const& it : _groups) {
+    Group const& group = it.second;
+    triagens::basics::Json object(zone, triagens::basics::Json::Object, _fields.size() + _aggregates.size());
+
+    for (size_t i = 0; i < _fields.size(); ++i) {
+      std::string name;
+      TRI_AttributeNamesToString(_fields[i], name);
+
+      auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&group._values->_value._objects, i));
+      object(name.c_str(), triagens::basics::Json(zone, TRI_CopyJson(zone, value), triagens::basics::Json::AUTOFREE));
+    }
+
+    for (size_t i = 0; i < _aggregates.size(); ++i) {
+      auto const& definition = _aggregates[i];
+      AggregateState const& state = group._aggregates[i];
+
+      switch (definition._function) {
+        case AggregateDefinition::AGGREGATE_COUNT:
+          object(definition._name.c_str(), triagens::basics::Json(zone, static_cast<double>(group._count)));
+          break;
+
+        case AggregateDefinition::AGGREGATE_SUM:
+          object(definition._name.c_str(), triagens::basics::Json(zone, state._sum));
+          break;
+
+        case AggregateDefinition::AGGREGATE_AVERAGE:
+          if (state._count == 0) {
+            object(definition._name.c_str(), triagens::basics::Json(zone, triagens::basics::Json::Null));
+          }
+          else {
+            object(definition._name.c_str(), triagens::basics::Json(zone, state._sum / static_cast<double>(state._count)));
+          }
+          break;
+
+        case AggregateDefinition::AGGREGATE_MIN:
+          if (state._values.empty()) {
+            object(definition._name.c_str(), triagens::basics::Json(zone, triagens::basics::Json::Null));
+          }
+          else {
+            object(definition._name.c_str(), triagens::basics::Json(zone, (*state._values.begin()).first));
+          }
+          break;
+
+        case AggregateDefinition::AGGREGATE_MAX:
+          if (state._values.empty()) {
+            object(definition._name.c_str(), triagens::basics::Json(zone, triagens::basics::Json::Null));
+          }
+          else {
+            object(definition._name.c_str(), triagens::basics::Json(zone, (*state._values.rbegin()).first));
+          }
+          break;
+      }
+    }
+
+    result.add(object);
+  }
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the values of the index fields of a document. documents
+/// without an attribute are grouped under null, as in AQL
+////////////////////////////////////////////////////////////////////////////////
+
+int AggregateIndex::groupValues (TRI_shaped_json_t const* document,
+                                 std::unique_ptr<TRI_json_t>& values,
+                                 std::string& key) const {
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  values.reset(TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, _paths.size()));
+
+  if (values == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  for (auto const& path : _paths) {
+    TRI_shaped_json_t shapedJson;
+    TRI_shape_t const* shape = nullptr;
+    TRI_json_t* value = nullptr;
+
+    if (shaper->extractShapedJson(document, 0, path, &shapedJson, &shape) && shape != nullptr) {
+      value = TRI_JsonShapedJson(shaper, &shapedJson);
+    }
+    else {
+      value = TRI_CreateNullJson(TRI_UNKNOWN_MEM_ZONE);
+    }
+
+    if (value == nullptr) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, values.get(), value);
+  }
+
+  triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+  int res = TRI_StringifyJson(buffer.stringBuffer(), values.get());
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  try {
+    key.assign(buffer.c_str(), buffer.length());
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
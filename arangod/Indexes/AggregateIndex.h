@@ -0,0 +1,293 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aggregate index, a materialized view of grouped aggregates
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_INDEXES_AGGREGATE_INDEX_H
+#define ARANGODB_INDEXES_AGGREGATE_INDEX_H 1
+
+#include "Basics/Common.h"
+#include "Basics/JsonHelper.h"
+#include "Indexes/Index.h"
+#include "VocBase/shaped-json.h"
+#include "VocBase/vocbase.h"
+#include "VocBase/voc-types.h"
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an aggregate computed per group
+////////////////////////////////////////////////////////////////////////////////
+
+    struct AggregateDefinition {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aggregate functions
+////////////////////////////////////////////////////////////////////////////////
+
+      enum AggregateFunction {
+        AGGREGATE_COUNT,
+        AGGREGATE_SUM,
+        AGGREGATE_AVERAGE,
+        AGGREGATE_MIN,
+        AGGREGATE_MAX
+      };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a function name, returns false if it is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+      static bool function (std::string const&,
+                            AggregateFunction&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name of a function
+////////////////////////////////////////////////////////////////////////////////
+
+      static char const* functionName (AggregateFunction);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attribute the aggregate is stored under in the result
+////////////////////////////////////////////////////////////////////////////////
+
+      std::string _name;
+
+      AggregateFunction _function;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the aggregated attribute, empty for COUNT
+////////////////////////////////////////////////////////////////////////////////
+
+      std::string _attribute;
+
+      TRI_shape_pid_t _path;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class AggregateIndex
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a materialized view that groups the documents of a collection by
+/// the values of the index fields and keeps aggregates per group. it is the
+/// stored result of
+///
+///     FOR doc IN collection
+///       COLLECT a = doc.a, b = doc.b INTO group
+///       RETURN { a, b, count: LENGTH(group), total: SUM(group[*].doc.value) }
+///
+/// the aggregates are maintained on every insert, update and remove of a
+/// document, in the same way the other indexes are, so they are always
+/// consistent with the collection and rolled back with aborted transactions.
+/// reading the view thus only copies the groups. SUM, AVERAGE, MIN and MAX
+/// consider numeric values only. MIN and MAX keep the count of each distinct
+/// value per group, so that removals do not require a rescan. a group is
+/// dropped when its last document is removed
+///
+/// the view is named, and read with the AQL function MATERIALIZED_VIEW
+////////////////////////////////////////////////////////////////////////////////
+
+    class AggregateIndex final : public Index {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the state of an aggregate in a group
+////////////////////////////////////////////////////////////////////////////////
+
+        struct AggregateState {
+          AggregateState ()
+            : _count(0), _sum(0.0), _values() {
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of numeric values
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _count;
+
+          double _sum;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief count per distinct value, only for MIN and MAX
+////////////////////////////////////////////////////////////////////////////////
+
+          std::map<double, uint64_t> _values;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a group
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Group {
+          Group ()
+            : _values(), _count(0), _aggregates() {
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the values of the index fields, as an array
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unique_ptr<TRI_json_t> _values;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _count;
+
+          std::vector<AggregateState> _aggregates;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        AggregateIndex () = delete;
+
+        AggregateIndex (TRI_idx_iid_t,
+                        struct TRI_document_collection_t*,
+                        std::vector<std::vector<triagens::basics::AttributeName>> const&,
+                        std::vector<TRI_shape_pid_t> const&,
+                        std::string const&,
+                        std::vector<AggregateDefinition> const&);
+
+        ~AggregateIndex ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+        IndexType type () const override final {
+          return Index::TRI_IDX_TYPE_AGGREGATE_INDEX;
+        }
+
+        bool isSorted () const override final {
+          return false;
+        }
+
+        bool hasSelectivityEstimate () const override final {
+          return false;
+        }
+
+        bool dumpFields () const override final {
+          return true;
+        }
+
+        size_t memory () const override final;
+
+        triagens::basics::Json toJson (TRI_memory_zone_t*, bool) const override final;
+        triagens::basics::Json toJsonFigures (TRI_memory_zone_t*) const override final;
+
+        int insert (struct TRI_doc_mptr_t const*, bool) override final;
+
+        int remove (struct TRI_doc_mptr_t const*, bool) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the name of the view
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string const& name () const {
+          return _name;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the index has the same definition
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isSame (std::vector<TRI_shape_pid_t> const&,
+                     std::vector<AggregateDefinition> const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the groups, one object per group with the index fields and
+/// the aggregates
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::Json groups (TRI_memory_zone_t*) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the values of the index fields of a document, and their
+/// serialization, which identifies the group
+////////////////////////////////////////////////////////////////////////////////
+
+        int groupValues (TRI_shaped_json_t const*,
+                         std::unique_ptr<TRI_json_t>&,
+                         std::string&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attribute paths of the index fields
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_shape_pid_t> const _paths;
+
+        std::string const _name;
+
+        std::vector<AggregateDefinition> const _aggregates;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the groups, by the serialized values of the index fields
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<std::string, Group> _groups;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -44,6 +44,12 @@ using namespace triagens::arango;
 
 int64_t const CapConstraint::MinSize = 16384;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents removed by one call to evict
+////////////////////////////////////////////////////////////////////////////////
+
+size_t const CapConstraint::EvictionBatchSize = 1000;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -51,10 +57,12 @@ int64_t const CapConstraint::MinSize = 16384;
 CapConstraint::CapConstraint (TRI_idx_iid_t iid,
                               TRI_document_collection_t* collection,
                               size_t count,
-                              int64_t size)
+                              int64_t size,
+                              double tolerance)
   : Index(iid, collection, std::vector<std::vector<triagens::basics::AttributeName>>(), false, false),
     _count(count),
-    _size(static_cast<int64_t>(size)) {
+    _size(static_cast<int64_t>(size)),
+    _tolerance(tolerance) {
 
   initialize();
 }
@@ -80,6 +88,7 @@ triagens::basics::Json CapConstraint::toJson (TRI_memory_zone_t* zone,
 
   json("size",     triagens::basics::Json(zone, static_cast<double>(_count)))
       ("byteSize", triagens::basics::Json(zone, static_cast<double>(_size)))
+      ("tolerance", triagens::basics::Json(zone, _tolerance))
       ("unique",   triagens::basics::Json(zone, false));
 
   return json;
@@ -120,7 +129,48 @@ int CapConstraint::postInsert (TRI_transaction_collection_t* trxCollection,
                                TRI_doc_mptr_t const*) {
   TRI_ASSERT(_count > 0 || _size > 0);
 
-  return apply(trxCollection->_collection->_collection, trxCollection);
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+
+  if (_tolerance > 0.0 && ! exceeds(1.0 + _tolerance)) {
+    // within the tolerance, the cleanup thread removes the oldest documents
+    // in batches. this keeps inserts from paying for the removals
+    if (exceeds(1.0)) {
+      document->_capEvictionPending.store(true, std::memory_order_relaxed);
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  return apply(document, trxCollection, SIZE_MAX);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection exceeds the limits scaled by a factor
+////////////////////////////////////////////////////////////////////////////////
+
+bool CapConstraint::exceeds (double factor) const {
+  TRI_headers_t const* headers = _collection->_headersPtr;  // PROTECTED by trx of the caller
+
+  if (_count > 0 &&
+      static_cast<double>(headers->count()) > static_cast<double>(_count) * factor) {
+    return true;
+  }
+
+  if (_size > 0 &&
+      static_cast<double>(headers->size()) > static_cast<double>(_size) * factor) {
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes at most EvictionBatchSize of the oldest documents while
+/// the collection exceeds its limits
+////////////////////////////////////////////////////////////////////////////////
+
+int CapConstraint::evict (TRI_transaction_collection_t* trxCollection) {
+  return apply(_collection, trxCollection, EvictionBatchSize);
 }
 
 // -----------------------------------------------------------------------------
@@ -134,12 +184,7 @@ int CapConstraint::postInsert (TRI_transaction_collection_t* trxCollection,
 int CapConstraint::initialize () {
   TRI_ASSERT(_count > 0 || _size > 0);
 
-  TRI_headers_t* headers = _collection->_headersPtr;  // ONLY IN INDEX (CAP)
-  int64_t currentCount   = static_cast<int64_t>(headers->count());
-  int64_t currentSize    = headers->size();
-
-  if ((_count > 0 && currentCount <= _count) &&
-      (_size > 0 && currentSize <= _size)) {
+  if (! exceeds(1.0)) {
     // nothing to do
     return TRI_ERROR_NO_ERROR;
   }
@@ -160,7 +205,7 @@ int CapConstraint::initialize () {
     }
 
     TRI_transaction_collection_t* trxCollection = trx.trxCollection();
-    res = apply(_collection, trxCollection);
+    res = apply(_collection, trxCollection, SIZE_MAX);
 
     res = trx.finish(res);
 
@@ -169,11 +214,13 @@ int CapConstraint::initialize () {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief apply the cap constraint for the collection
+/// @brief apply the cap constraint for the collection, removing at most
+/// the given number of documents
 ////////////////////////////////////////////////////////////////////////////////
 
 int CapConstraint::apply (TRI_document_collection_t* document,
-                          TRI_transaction_collection_t* trxCollection) {
+                          TRI_transaction_collection_t* trxCollection,
+                          size_t maxRemovals) {
   TRI_headers_t* headers = document->_headersPtr;  // PROTECTED by trx in trxCollection
   int64_t currentCount   = static_cast<int64_t>(headers->count());
   int64_t currentSize    = headers->size();
@@ -181,8 +228,9 @@ int CapConstraint::apply (TRI_document_collection_t* document,
   int res = TRI_ERROR_NO_ERROR;
 
   // delete while at least one of the constraints is still violated
-  while ((_count > 0 && currentCount > _count) ||
-         (_size > 0 && currentSize > _size)) {
+  while (maxRemovals > 0 &&
+         ((_count > 0 && currentCount > _count) ||
+          (_size > 0 && currentSize > _size))) {
     TRI_doc_mptr_t* oldest = headers->front();
 
     if (oldest != nullptr) {
@@ -205,6 +253,7 @@ int CapConstraint::apply (TRI_document_collection_t* document,
 
       currentCount--;
       currentSize -= (int64_t) oldSize;
+      maxRemovals--;
     }
     else {
       // we should not get here
@@ -55,7 +55,8 @@ namespace triagens {
         CapConstraint (TRI_idx_iid_t,
                        struct TRI_document_collection_t*,
                        size_t,
-                       int64_t);
+                       int64_t,
+                       double);
 
         ~CapConstraint ();
 
@@ -80,6 +81,15 @@ namespace triagens {
         int64_t size () const {
           return _size;
         }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fraction by which the collection may exceed its limits before
+/// inserts evict documents themselves
+////////////////////////////////////////////////////////////////////////////////
+
+        double tolerance () const {
+          return _tolerance;
+        }
         
         IndexType type () const override final {
           return Index::TRI_IDX_TYPE_CAP_CONSTRAINT;
@@ -108,6 +118,21 @@ namespace triagens {
         
         int postInsert (struct TRI_transaction_collection_s*, struct TRI_doc_mptr_t const*) override final;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the collection exceeds the limits scaled by a factor
+////////////////////////////////////////////////////////////////////////////////
+
+        bool exceeds (double) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes at most EvictionBatchSize of the oldest documents while
+/// the collection exceeds its limits
+///
+/// The caller must hold the collection's write lock.
+////////////////////////////////////////////////////////////////////////////////
+
+        int evict (struct TRI_transaction_collection_s*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -125,7 +150,8 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         int apply (TRI_document_collection_t*,
-                   struct TRI_transaction_collection_s*);
+                   struct TRI_transaction_collection_s*,
+                   size_t);
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -145,6 +171,12 @@ namespace triagens {
 
         int64_t const _size;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fraction by which the collection may exceed its limits
+////////////////////////////////////////////////////////////////////////////////
+
+        double const _tolerance;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -156,6 +188,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         static int64_t const MinSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents removed by one call to evict
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const EvictionBatchSize;
     };
 
   }
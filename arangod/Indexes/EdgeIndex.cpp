@@ -419,7 +419,8 @@ EdgeIndex::EdgeIndex (TRI_idx_iid_t iid,
                                        IsEqualElementEdgeFromByKey,
                                        _numBuckets, 
                                        64,
-                                       context);
+                                       context,
+                                       TRI_EDGE_INDEX_MEM_ZONE);
 
   _edgesTo = new TRI_EdgeIndexHash_t(HashElementKey,
                                      HashElementEdgeTo,
@@ -428,7 +429,14 @@ EdgeIndex::EdgeIndex (TRI_idx_iid_t iid,
                                      IsEqualElementEdgeToByKey,
                                      _numBuckets,
                                      64,
-                                     context);
+                                     context,
+                                     TRI_EDGE_INDEX_MEM_ZONE);
+
+  if (collection != nullptr) {
+    int node = TRI_NumaNodeLargeTable(collection->_info._cid);
+    _edgesFrom->setNumaNode(node);
+    _edgesTo->setNumaNode(node);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -532,10 +540,13 @@ int EdgeIndex::remove (TRI_doc_mptr_t const* doc,
         
 int EdgeIndex::batchInsert (std::vector<TRI_doc_mptr_t const*> const* documents, 
                             size_t numThreads) {
-  _edgesFrom->batchInsert(reinterpret_cast<std::vector<TRI_doc_mptr_t *> const*>(documents), numThreads);
-  _edgesTo->batchInsert(reinterpret_cast<std::vector<TRI_doc_mptr_t *> const*>(documents), numThreads);
+  int res = _edgesFrom->batchInsert(reinterpret_cast<std::vector<TRI_doc_mptr_t *> const*>(documents), numThreads);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = _edgesTo->batchInsert(reinterpret_cast<std::vector<TRI_doc_mptr_t *> const*>(documents), numThreads);
+  }
   
-  return TRI_ERROR_NO_ERROR;
+  return res;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,9 +28,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "FulltextIndex.h"
+#include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "Basics/Utf8Helper.h"
 #include "FulltextIndex/fulltext-index.h"
+#include "FulltextIndex/fulltext-query.h"
+#include "FulltextIndex/fulltext-result.h"
 #include "FulltextIndex/fulltext-wordlist.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/transaction.h"
@@ -90,7 +93,8 @@ static bool ListTextExtractor (VocShaper* shaper,
     TRI_IterateShapeDataArray(static_cast<TextExtractorContext*>(data)->_shaper, shape, shapedJson, ArrayTextExtractor, data);
   }
   else if (shape->_type == TRI_SHAPE_SHORT_STRING ||
-           shape->_type == TRI_SHAPE_LONG_STRING) {
+           shape->_type == TRI_SHAPE_LONG_STRING ||
+           shape->_type == TRI_SHAPE_DICTIONARY_STRING) {
 
     char* text;
     size_t textLength;
@@ -181,7 +185,14 @@ triagens::basics::Json FulltextIndex::toJson (TRI_memory_zone_t* zone,
         
 triagens::basics::Json FulltextIndex::toJsonFigures (TRI_memory_zone_t* zone) const {
   triagens::basics::Json json(triagens::basics::Json::Object);
-  json("memory", triagens::basics::Json(static_cast<double>(memory())));
+
+  TRI_fulltext_stats_t const stats = TRI_StatsFulltextIndex(_fulltextIndex);
+
+  json("memory", triagens::basics::Json(static_cast<double>(stats._memoryTotal)))
+      ("memoryHandles", triagens::basics::Json(static_cast<double>(stats._memoryHandles)))
+      ("handles", triagens::basics::Json(static_cast<double>(stats._numDocuments)))
+      ("deletedHandles", triagens::basics::Json(static_cast<double>(stats._numDeleted)))
+      ("fillRatio", triagens::basics::Json(1.0 - stats._handleDeletionGrade));
 
   return json;
 }
@@ -232,6 +243,52 @@ int FulltextIndex::cleanup () {
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an iterator returning the documents matching a query
+////////////////////////////////////////////////////////////////////////////////
+
+IndexIterator* FulltextIndex::queryIterator (std::string const& queryString) const {
+  TRI_fulltext_query_t* query = ParseQuery(queryString);
+
+  try {
+    return new FulltextIndexIterator(this, queryString, query);
+  }
+  catch (...) {
+    TRI_FreeQueryFulltextIndex(query);
+    throw;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a query, throws if it is invalid
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_fulltext_query_t* FulltextIndex::ParseQuery (std::string const& queryString) {
+  TRI_fulltext_query_t* query = TRI_CreateQueryFulltextIndex(TRI_FULLTEXT_SEARCH_MAX_WORDS, 0);
+
+  if (query == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  bool isSubstringQuery = false;
+  int res = TRI_ParseQueryFulltextIndex(query, queryString.c_str(), &isSubstringQuery);
+
+  if (res == TRI_ERROR_NO_ERROR && isSubstringQuery) {
+    res = TRI_ERROR_NOT_IMPLEMENTED;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_FreeQueryFulltextIndex(query);
+    THROW_ARANGO_EXCEPTION(res);
+  }
+
+  return query;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -259,7 +316,9 @@ TRI_fulltext_wordlist_t* FulltextIndex::wordlist (TRI_doc_mptr_t const* document
   TRI_vector_string_t* words;
 
   // extract the string value for the indexed attribute
-  if (shape->_type == TRI_SHAPE_SHORT_STRING || shape->_type == TRI_SHAPE_LONG_STRING) {
+  if (shape->_type == TRI_SHAPE_SHORT_STRING ||
+      shape->_type == TRI_SHAPE_LONG_STRING ||
+      shape->_type == TRI_SHAPE_DICTIONARY_STRING) {
     char* text;
     size_t textLength;
     ok = TRI_StringValueShapedJson(shape, shapedJson._data.data, &text, &textLength);
@@ -328,6 +387,73 @@ TRI_fulltext_wordlist_t* FulltextIndex::wordlist (TRI_doc_mptr_t const* document
   return wordlist;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                       class FulltextIndexIterator
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+FulltextIndexIterator::FulltextIndexIterator (FulltextIndex const* index,
+                                              std::string const& queryString,
+                                              TRI_fulltext_query_t* query)
+  : _index(index),
+    _queryString(queryString),
+    _query(query),
+    _result(nullptr),
+    _position(0) {
+}
+
+FulltextIndexIterator::~FulltextIndexIterator () {
+  if (_query != nullptr) {
+    TRI_FreeQueryFulltextIndex(_query);
+  }
+
+  if (_result != nullptr) {
+    TRI_FreeResultFulltextIndex(_result);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+TRI_doc_mptr_t* FulltextIndexIterator::next () {
+  if (_result == nullptr) {
+    if (_query == nullptr) {
+      // the query has been run before and reset since
+      _query = FulltextIndex::ParseQuery(_queryString);
+    }
+
+    // the index frees the query
+    auto query = _query;
+    _query = nullptr;
+    _result = TRI_QueryFulltextIndex(const_cast<FulltextIndex*>(_index)->internals(), query);
+
+    if (_result == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    _position = 0;
+  }
+
+  if (_position >= _result->_numDocuments) {
+    return nullptr;
+  }
+
+  return reinterpret_cast<TRI_doc_mptr_t*>(_result->_documents[_position++]);
+}
+
+void FulltextIndexIterator::reset () {
+  if (_result != nullptr) {
+    TRI_FreeResultFulltextIndex(_result);
+    _result = nullptr;
+  }
+
+  _position = 0;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -33,10 +33,13 @@
 #include "Basics/Common.h"
 #include "FulltextIndex/fulltext-common.h"
 #include "Indexes/Index.h"
+#include "Indexes/IndexIterator.h"
 #include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
  
+struct TRI_fulltext_query_s;
+struct TRI_fulltext_result_s;
 struct TRI_fulltext_wordlist_s;
 
 // -----------------------------------------------------------------------------
@@ -106,6 +109,19 @@ namespace triagens {
           return _fulltextIndex;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an iterator returning the documents matching a query
+/// throws if the query is invalid
+////////////////////////////////////////////////////////////////////////////////
+
+        IndexIterator* queryIterator (std::string const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a query, throws if it is invalid
+////////////////////////////////////////////////////////////////////////////////
+
+        static struct TRI_fulltext_query_s* ParseQuery (std::string const&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -140,6 +156,42 @@ namespace triagens {
 
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                       class FulltextIndexIterator
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the documents of a fulltext index matching a query
+///
+/// the index combines the document lists of all words of the query before
+/// it knows the first match, so the query is run once, when the first
+/// document is requested. the documents are then handed out one at a time,
+/// and only those actually read are turned into query results
+////////////////////////////////////////////////////////////////////////////////
+
+    class FulltextIndexIterator final : public IndexIterator {
+
+      public:
+
+        FulltextIndexIterator (FulltextIndex const*,
+                               std::string const&,
+                               struct TRI_fulltext_query_s*);
+
+        ~FulltextIndexIterator ();
+
+        TRI_doc_mptr_t* next () override;
+
+        void reset () override;
+
+      private:
+
+        FulltextIndex const*           _index;
+        std::string const              _queryString;
+        struct TRI_fulltext_query_s*   _query;
+        struct TRI_fulltext_result_s*  _result;
+        size_t                         _position;
+    };
+
   }
 }
 
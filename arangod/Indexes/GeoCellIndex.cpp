@@ -0,0 +1,358 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cell-based geo index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "GeoCellIndex.h"
+#include "Basics/logging.h"
+#include "Indexes/GeoIndex2.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+using triagens::basics::GeoCell;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of cells in the covering of a query region
+/// more cells mean more tree seeks, but fewer points outside the region
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxCoverCells = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two elements, by cell id and then by document
+////////////////////////////////////////////////////////////////////////////////
+
+static int CmpElmElm (TRI_geo_cell_element_t const* left,
+                      TRI_geo_cell_element_t const* right,
+                      triagens::basics::SkipListCmpType cmptype) {
+  if (left->_cell != right->_cell) {
+    return left->_cell < right->_cell ? -1 : 1;
+  }
+
+  if (cmptype == triagens::basics::SKIPLIST_CMP_PREORDER) {
+    return 0;
+  }
+
+  // total order: break ties by the document
+  if (left->_document != right->_document) {
+    return left->_document < right->_document ? -1 : 1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a cell id with an element
+////////////////////////////////////////////////////////////////////////////////
+
+static int CmpKeyElm (uint64_t const* key,
+                      TRI_geo_cell_element_t const* element) {
+  if (*key != element->_cell) {
+    return *key < element->_cell ? -1 : 1;
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an element
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeElm (TRI_geo_cell_element_t* element) {
+  delete element;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the cell ids are order preserving prefixes of the elements
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t ElmPrefix (TRI_geo_cell_element_t const* element) {
+  return element->_cell;
+}
+
+static uint64_t KeyPrefix (uint64_t const* key) {
+  return *key;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class GeoCellIndex
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a new geo cell index
+////////////////////////////////////////////////////////////////////////////////
+
+GeoCellIndex::GeoCellIndex (TRI_idx_iid_t iid,
+                            TRI_document_collection_t* collection,
+                            std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
+                            std::vector<TRI_shape_pid_t> const& paths,
+                            bool geoJson)
+  : Index(iid, collection, fields, false, true),
+    _paths(paths),
+    _geoJson(geoJson),
+    _tree(nullptr) {
+
+  TRI_ASSERT(iid != 0);
+  TRI_ASSERT(paths.size() == 1 || paths.size() == 2);
+  TRI_ASSERT(paths.size() == 1 || ! geoJson);
+
+  _tree = new TRI_GeoCellTree(CmpElmElm, CmpKeyElm, FreeElm, false, false, ElmPrefix, KeyPrefix);
+}
+
+GeoCellIndex::~GeoCellIndex () {
+  delete _tree;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+size_t GeoCellIndex::memory () const {
+  return _tree->memoryUsage() +
+         static_cast<size_t>(_tree->getNrUsed()) * sizeof(TRI_geo_cell_element_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json GeoCellIndex::toJson (TRI_memory_zone_t* zone,
+                                             bool withFigures) const {
+  auto json = Index::toJson(zone, withFigures);
+
+  if (_paths.size() == 1) {
+    json("geoJson", triagens::basics::Json(zone, _geoJson));
+  }
+
+  // geo cell indexes are always non-unique and sparse
+  json("unique", triagens::basics::Json(zone, false))
+      ("sparse", triagens::basics::Json(zone, true));
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index figures
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json GeoCellIndex::toJsonFigures (TRI_memory_zone_t* zone) const {
+  triagens::basics::Json json(triagens::basics::Json::Object);
+  json("memory", triagens::basics::Json(static_cast<double>(memory())));
+  _tree->appendToJson(zone, json);
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document into the index
+////////////////////////////////////////////////////////////////////////////////
+
+int GeoCellIndex::insert (TRI_doc_mptr_t const* doc,
+                          bool) {
+  double latitude;
+  double longitude;
+
+  if (! coordinates(doc, latitude, longitude)) {
+    // sparse index: no or invalid coordinates
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  TRI_geo_cell_element_t* element = new (std::nothrow) TRI_geo_cell_element_t;
+
+  if (element == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  element->_cell = GeoCell::id(latitude, longitude);
+  element->_latitude = latitude;
+  element->_longitude = longitude;
+  element->_document = doc;
+
+  int res = _tree->insert(element);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // the tree has not taken over the element
+    delete element;
+
+    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED) {
+      // the document is indexed already
+      res = TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document from the index
+////////////////////////////////////////////////////////////////////////////////
+
+int GeoCellIndex::remove (TRI_doc_mptr_t const* doc,
+                          bool) {
+  double latitude;
+  double longitude;
+
+  if (! coordinates(doc, latitude, longitude)) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  TRI_geo_cell_element_t element;
+  element._cell = GeoCell::id(latitude, longitude);
+  element._latitude = latitude;
+  element._longitude = longitude;
+  element._document = doc;
+
+  // the tree frees its own element. ignore elements that are not found
+  _tree->remove(&element);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points in a rectangle
+////////////////////////////////////////////////////////////////////////////////
+
+void GeoCellIndex::withinRectangle (double latitude1,
+                                    double longitude1,
+                                    double latitude2,
+                                    double longitude2,
+                                    std::vector<TRI_doc_mptr_t const*>& result) const {
+  double const minLatitude  = std::max(std::min(latitude1, latitude2), -90.0);
+  double const maxLatitude  = std::min(std::max(latitude1, latitude2), 90.0);
+  double const minLongitude = std::max(std::min(longitude1, longitude2), -180.0);
+  double const maxLongitude = std::min(std::max(longitude1, longitude2), 180.0);
+
+  if (minLatitude > maxLatitude || minLongitude > maxLongitude) {
+    // the rectangle is outside of the world
+    return;
+  }
+
+  auto covering = GeoCell::coverRectangle(minLatitude, minLongitude, maxLatitude, maxLongitude, MaxCoverCells);
+
+  scan(covering, [&] (double latitude, double longitude) -> bool {
+    return (latitude >= minLatitude && latitude <= maxLatitude &&
+            longitude >= minLongitude && longitude <= maxLongitude);
+  }, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points in a polygon
+////////////////////////////////////////////////////////////////////////////////
+
+void GeoCellIndex::withinPolygon (std::vector<std::pair<double, double>> const& polygon,
+                                  std::vector<TRI_doc_mptr_t const*>& result) const {
+  if (polygon.size() < 3) {
+    return;
+  }
+
+  auto covering = GeoCell::coverPolygon(polygon, MaxCoverCells);
+
+  scan(covering, [&] (double latitude, double longitude) -> bool {
+    return GeoCell::isInPolygon(polygon, latitude, longitude);
+  }, result);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the coordinates of a document
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeoCellIndex::coordinates (TRI_doc_mptr_t const* doc,
+                                double& latitude,
+                                double& longitude) const {
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  bool ok;
+
+  if (_paths.size() == 1) {
+    if (_geoJson) {
+      ok = GeoIndex2::extractDoubleArray(shaper, &shapedJson, _paths[0], &longitude, &latitude);
+    }
+    else {
+      ok = GeoIndex2::extractDoubleArray(shaper, &shapedJson, _paths[0], &latitude, &longitude);
+    }
+  }
+  else {
+    ok = GeoIndex2::extractDoubleObject(shaper, &shapedJson, _paths[0], &latitude);
+    ok = ok && GeoIndex2::extractDoubleObject(shaper, &shapedJson, _paths[1], &longitude);
+  }
+
+  if (ok && ! GeoCell::isValid(latitude, longitude)) {
+    LOG_DEBUG("illegal geo-coordinates, ignoring entry");
+    ok = false;
+  }
+
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans the id ranges of a covering
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename F>
+void GeoCellIndex::scan (std::vector<GeoCell::Range> const& covering,
+                         F const& accept,
+                         std::vector<TRI_doc_mptr_t const*>& result) const {
+  for (auto const& range : covering) {
+    auto pos = _tree->lowerBound(&range._min);
+
+    while (! pos.isEnd()) {
+      TRI_geo_cell_element_t const* element = _tree->at(pos);
+
+      if (element->_cell > range._max) {
+        break;
+      }
+
+      if (accept(element->_latitude, element->_longitude)) {
+        result.emplace_back(element->_document);
+      }
+
+      _tree->next(pos);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
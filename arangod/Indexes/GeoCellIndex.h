@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cell-based geo index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_INDEXES_GEO_CELL_INDEX_H
+#define ARANGODB_INDEXES_GEO_CELL_INDEX_H 1
+
+#include "Basics/Common.h"
+#include "Basics/BTree.h"
+#include "Basics/GeoCell.h"
+#include "Indexes/Index.h"
+#include "VocBase/shaped-json.h"
+#include "VocBase/vocbase.h"
+#include "VocBase/voc-types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an element of a geo cell index
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_geo_cell_element_t {
+  uint64_t              _cell;
+  double                _latitude;
+  double                _longitude;
+  TRI_doc_mptr_t const* _document;
+};
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class GeoCellIndex
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a geo index storing points by their cell id in a sorted tree
+///
+/// the indexed attributes are the same as for the geo1 and geo2 indexes:
+/// either one attribute with a [ latitude, longitude ] list (or
+/// [ longitude, latitude ] with geoJson), or two attributes with the
+/// latitude and the longitude. the index is sparse, documents without valid
+/// coordinates are not indexed.
+///
+/// region queries cover the region with a few cells, scan the id ranges of
+/// these cells and check the points found against the region
+////////////////////////////////////////////////////////////////////////////////
+
+    class GeoCellIndex final : public Index {
+
+      typedef triagens::basics::BTree<uint64_t, TRI_geo_cell_element_t> TRI_GeoCellTree;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        GeoCellIndex () = delete;
+
+        GeoCellIndex (TRI_idx_iid_t,
+                      struct TRI_document_collection_t*,
+                      std::vector<std::vector<triagens::basics::AttributeName>> const&,
+                      std::vector<TRI_shape_pid_t> const&,
+                      bool);
+
+        ~GeoCellIndex ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+        IndexType type () const override final {
+          return Index::TRI_IDX_TYPE_GEO_CELL_INDEX;
+        }
+
+        bool isSorted () const override final {
+          return false;
+        }
+
+        bool hasSelectivityEstimate () const override final {
+          return false;
+        }
+
+        bool dumpFields () const override final {
+          return true;
+        }
+
+        size_t memory () const override final;
+
+        triagens::basics::Json toJson (TRI_memory_zone_t*, bool) const override final;
+        triagens::basics::Json toJsonFigures (TRI_memory_zone_t*) const override final;
+
+        int insert (struct TRI_doc_mptr_t const*, bool) override final;
+
+        int remove (struct TRI_doc_mptr_t const*, bool) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points in a rectangle given by two corners
+///
+/// the rectangle is spanned by the smaller and the bigger latitude and
+/// longitude, it never crosses the antimeridian
+////////////////////////////////////////////////////////////////////////////////
+
+        void withinRectangle (double,
+                              double,
+                              double,
+                              double,
+                              std::vector<TRI_doc_mptr_t const*>&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up all points in a polygon, given as a list of
+/// (latitude, longitude) vertices
+////////////////////////////////////////////////////////////////////////////////
+
+        void withinPolygon (std::vector<std::pair<double, double>> const&,
+                            std::vector<TRI_doc_mptr_t const*>&) const;
+
+        bool isSame (std::vector<TRI_shape_pid_t> const& paths,
+                     bool geoJson) const {
+          return (_paths == paths && _geoJson == geoJson);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the coordinates of a document
+////////////////////////////////////////////////////////////////////////////////
+
+        bool coordinates (TRI_doc_mptr_t const*,
+                          double&,
+                          double&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans the id ranges of a covering, adding the documents whose
+/// coordinates are accepted by the predicate
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        void scan (std::vector<triagens::basics::GeoCell::Range> const&,
+                   F const&,
+                   std::vector<TRI_doc_mptr_t const*>&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attribute paths, [ location ] or [ latitude, longitude ]
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_shape_pid_t> const _paths;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a location is a [ longitude, latitude ] list
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _geoJson;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the points, sorted by cell id
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_GeoCellTree* _tree;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
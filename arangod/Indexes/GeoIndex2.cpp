@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "GeoIndex2.h"
+#include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/transaction.h"
@@ -195,15 +196,15 @@ int GeoIndex2::insert (TRI_doc_mptr_t const* doc,
 
   if (_location != 0) {
     if (_geoJson) {
-      ok = extractDoubleArray(shaper, &shapedJson, &longitude, &latitude);
+      ok = extractDoubleArray(shaper, &shapedJson, _location, &longitude, &latitude);
     }
     else {
-      ok = extractDoubleArray(shaper, &shapedJson, &latitude, &longitude);
+      ok = extractDoubleArray(shaper, &shapedJson, _location, &latitude, &longitude);
     }
   }
   else {
-    ok = extractDoubleObject(shaper, &shapedJson, 0, &latitude);
-    ok = ok && extractDoubleObject(shaper, &shapedJson, 1, &longitude);
+    ok = extractDoubleObject(shaper, &shapedJson, _latitude, &latitude);
+    ok = ok && extractDoubleObject(shaper, &shapedJson, _longitude, &longitude);
   }
 
   if (! ok) {
@@ -249,11 +250,11 @@ int GeoIndex2::remove (TRI_doc_mptr_t const* doc,
   double longitude;
 
   if (_location != 0) {
-    ok = extractDoubleArray(shaper, &shapedJson, &latitude, &longitude);
+    ok = extractDoubleArray(shaper, &shapedJson, _location, &latitude, &longitude);
   }
   else {
-    ok = extractDoubleObject(shaper, &shapedJson, 0, &latitude);
-    ok = ok && extractDoubleObject(shaper, &shapedJson, 1, &longitude);
+    ok = extractDoubleObject(shaper, &shapedJson, _latitude, &latitude);
+    ok = ok && extractDoubleObject(shaper, &shapedJson, _longitude, &longitude);
   }
 
   // and remove old entry
@@ -298,9 +299,18 @@ GeoCoordinates* GeoIndex2::nearQuery (double lat,
   return GeoIndex_NearestCountPoints(_geoIndex, &gc, static_cast<int>(count));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an iterator returning all documents of the index, nearest
+/// to the point first
+////////////////////////////////////////////////////////////////////////////////
+
+IndexIterator* GeoIndex2::nearIterator (double latitude,
+                                        double longitude) const {
+  return new GeoIndex2NearIterator(this, latitude, longitude);
+}
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                   private methods
+// --SECTION--                                             public static methods
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -309,10 +319,8 @@ GeoCoordinates* GeoIndex2::nearQuery (double lat,
 
 bool GeoIndex2::extractDoubleObject (VocShaper* shaper,
                                      TRI_shaped_json_t const* document,
-                                     int which,
+                                     TRI_shape_pid_t pid,
                                      double* result) {
-  TRI_shape_pid_t const pid = (which == 0 ? _latitude : _longitude);
-
   TRI_shape_t const* shape;
   TRI_shaped_json_t json;
 
@@ -340,12 +348,13 @@ bool GeoIndex2::extractDoubleObject (VocShaper* shaper,
 
 bool GeoIndex2::extractDoubleArray (VocShaper* shaper,
                                     TRI_shaped_json_t const* document,
+                                    TRI_shape_pid_t pid,
                                     double* latitude,
                                     double* longitude) {
   TRI_shape_t const* shape;
   TRI_shaped_json_t list;
 
-  bool ok = shaper->extractShapedJson(document, 0, _location, &list, &shape);
+  bool ok = shaper->extractShapedJson(document, 0, pid, &list, &shape);
 
   if (! ok) {
     return false;
@@ -464,6 +473,91 @@ bool GeoIndex2::extractDoubleArray (VocShaper* shaper,
   return false;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                       class GeoIndex2NearIterator
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+TRI_doc_mptr_t* GeoIndex2NearIterator::next () {
+  while (_position >= _found.size()) {
+    if (! lookup()) {
+      return nullptr;
+    }
+  }
+
+  auto result = _found[_position++].second;
+  _returned.emplace(result);
+
+  return result;
+}
+
+void GeoIndex2NearIterator::reset () {
+  _count = 0;
+  _exhausted = false;
+  _found.clear();
+  _position = 0;
+  _returned.clear();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the next points, returns false if there are none
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeoIndex2NearIterator::lookup () {
+  if (_exhausted) {
+    return false;
+  }
+
+  size_t const maxCount = static_cast<size_t>(INT_MAX);
+
+  _count = (_count == 0 ? InitialCount : (std::min)(_count * 2, maxCount));
+  _found.clear();
+  _position = 0;
+
+  GeoCoordinates* cors = _index->nearQuery(_latitude, _longitude, _count);
+
+  if (cors == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  try {
+    size_t const n = cors->length;
+    // fewer points than requested means that the index has no more
+    _exhausted = (n < _count || _count == maxCount);
+
+    _found.reserve(n - (std::min)(n, _returned.size()));
+
+    for (size_t i = 0; i < n; ++i) {
+      auto mptr = static_cast<TRI_doc_mptr_t*>(cors->coordinates[i].data);
+
+      if (_returned.find(mptr) == _returned.end()) {
+        _found.emplace_back(cors->distances[i], mptr);
+      }
+    }
+  }
+  catch (...) {
+    GeoIndex_CoordinatesFree(cors);
+    throw;
+  }
+
+  GeoIndex_CoordinatesFree(cors);
+
+  // the points of a lookup are not ordered by distance
+  std::sort(_found.begin(), _found.end(), [] (std::pair<double, TRI_doc_mptr_t*> const& lhs,
+                                              std::pair<double, TRI_doc_mptr_t*> const& rhs) {
+    return lhs.first < rhs.first;
+  });
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
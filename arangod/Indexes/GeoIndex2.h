@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "GeoIndex/GeoIndex.h"
 #include "Indexes/Index.h"
+#include "Indexes/IndexIterator.h"
 #include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
@@ -134,6 +135,22 @@ namespace triagens {
 
         GeoCoordinates* nearQuery (double, double, size_t) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an iterator returning all documents of the index, nearest
+/// to the point first
+////////////////////////////////////////////////////////////////////////////////
+
+        IndexIterator* nearIterator (double latitude,
+                                     double longitude) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the location attribute stores [ longitude, latitude ]
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isGeoJson () const {
+          return _geoJson;
+        }
+
         bool isSame (TRI_shape_pid_t location, bool geoJson) const {
           return (_location != 0 && _location == location && _geoJson == geoJson);
         }
@@ -143,28 +160,29 @@ namespace triagens {
         }
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                   private methods
+// --SECTION--                                             public static methods
 // -----------------------------------------------------------------------------
 
-      private:
+      public:
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extracts a double value from an object
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool extractDoubleObject (VocShaper*,
-                                  struct TRI_shaped_json_s const*,
-                                  int,
-                                  double*);
+        static bool extractDoubleObject (VocShaper*,
+                                         struct TRI_shaped_json_s const*,
+                                         TRI_shape_pid_t,
+                                         double*);
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief extracts a double value from an array
+/// @brief extracts the first two values of a list of doubles
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool extractDoubleArray (VocShaper*,
-                                 struct TRI_shaped_json_s const*,
-                                 double*,
-                                 double*);
+        static bool extractDoubleArray (VocShaper*,
+                                        struct TRI_shaped_json_s const*,
+                                        TRI_shape_pid_t,
+                                        double*,
+                                        double*);
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -205,6 +223,68 @@ namespace triagens {
         GeoIndex* _geoIndex;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                       class GeoIndex2NearIterator
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the documents of a geo index, nearest to a point first
+///
+/// the geo index can only look up a given number of nearest points, so the
+/// iterator looks up twice as many points whenever it has returned all
+/// points of the previous lookup, and skips the ones already returned. the
+/// points returned before are the nearest ones, so the remaining ones of the
+/// new lookup are not nearer than any of them
+////////////////////////////////////////////////////////////////////////////////
+
+    class GeoIndex2NearIterator final : public IndexIterator {
+
+      public:
+
+        GeoIndex2NearIterator (GeoIndex2 const* index,
+                               double latitude,
+                               double longitude)
+          : _index(index),
+            _latitude(latitude),
+            _longitude(longitude),
+            _count(0),
+            _exhausted(false),
+            _found(),
+            _position(0),
+            _returned() {
+        }
+
+        ~GeoIndex2NearIterator () {
+        }
+
+        TRI_doc_mptr_t* next () override;
+
+        void reset () override;
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the next points, returns false if there are none
+////////////////////////////////////////////////////////////////////////////////
+
+        bool lookup ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of points looked up first
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const InitialCount = 64;
+
+        GeoIndex2 const*                                _index;
+        double const                                    _latitude;
+        double const                                    _longitude;
+        size_t                                          _count;
+        bool                                            _exhausted;
+        std::vector<std::pair<double, TRI_doc_mptr_t*>> _found;
+        size_t                                          _position;
+        std::unordered_set<TRI_doc_mptr_t const*>       _returned;
+    };
+
   }
 }
 
@@ -47,7 +47,7 @@ using namespace triagens::arango;
 ////////////////////////////////////////////////////////////////////////////////
 
 static void FreeElement(TRI_index_element_t* element) {
-  TRI_index_element_t::free(element);
+  TRI_index_element_t::free(element, TRI_HASH_INDEX_MEM_ZONE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,8 +67,8 @@ static uint64_t HashKey (TRI_hash_index_search_value_t const* key) {
   uint64_t hash = 0x0123456789abcdef;
 
   for (size_t j = 0;  j < key->_length;  ++j) {
-    // ignore the sid for hashing
-    hash = fasthash64(key->_values[j]._data.data, key->_values[j]._data.length, hash);
+    // ignore the sid for hashing. must be the same as in HashElementFunc
+    hash = TRI_MemoryHash64(key->_values[j]._data.data, key->_values[j]._data.length, hash);
   }
 
   return hash;
@@ -130,11 +130,16 @@ TRI_doc_mptr_t* HashIndexIterator::next () {
         return nullptr;
       }
 
-      // We have to refill the buffer
+      // We have to refill the buffer. the keys are looked up in batches,
+      // so the index can probe them together
       _buffer.clear();
       _posInBuffer = 0;
 
-      int res = _index->lookup(_keys[_position++], _buffer);
+      size_t const end = (std::min)(_keys.size(), _position + LookupBatchSize);
+      std::vector<TRI_hash_index_search_value_t const*> batch(_keys.begin() + _position, _keys.begin() + end);
+      _position = end;
+
+      int res = _index->lookup(batch, _buffer);
 
       if (res != TRI_ERROR_NO_ERROR) {
         THROW_ARANGO_EXCEPTION(res);
@@ -143,7 +148,7 @@ TRI_doc_mptr_t* HashIndexIterator::next () {
   
     if (! _buffer.empty()) {
       // found something
-      return _buffer.at(_posInBuffer++);
+      return _buffer.at(_posInBuffer++)->document();
     }
   }
 }
@@ -154,6 +159,13 @@ void HashIndexIterator::reset () {
   _posInBuffer = 0;
 }
 
+TRI_index_element_t const* HashIndexIterator::element () const {
+  if (_posInBuffer == 0 || _posInBuffer > _buffer.size()) {
+    return nullptr;
+  }
+  return _buffer[_posInBuffer - 1];
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      class HashIndex::UniqueArray
 // -----------------------------------------------------------------------------
@@ -278,8 +290,9 @@ HashIndex::HashIndex (TRI_idx_iid_t iid,
                       TRI_document_collection_t* collection,
                       std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
                       bool unique,
-                      bool sparse) 
-  : PathBasedIndex(iid, collection, fields, unique, sparse, false),
+                      bool sparse,
+                      TRI_json_t const* filter) 
+  : PathBasedIndex(iid, collection, fields, unique, sparse, false, filter),
     _uniqueArray(nullptr) {
 
   uint32_t indexBuckets = 1;
@@ -299,7 +312,12 @@ HashIndex::HashIndex (TRI_idx_iid_t iid,
                                                                IsEqualElementElement,
                                                                *(compare.get()),
                                                                indexBuckets,
-                                                               [] () -> std::string { return "unique hash-array"; }));
+                                                               [] () -> std::string { return "unique hash-array"; },
+                                                               TRI_HASH_INDEX_MEM_ZONE));
+
+    if (collection != nullptr) {
+      array->setNumaNode(TRI_NumaNodeLargeTable(collection->_info._cid));
+    }
 
     _uniqueArray = new HashIndex::UniqueArray(array.get(), func.get(), compare.get());
     array.release();
@@ -314,7 +332,12 @@ HashIndex::HashIndex (TRI_idx_iid_t iid,
                                                                          *(compare.get()),
                                                                          indexBuckets,
                                                                          64,
-                                                                         [] () -> std::string { return "multi hash-array"; }));
+                                                                         [] () -> std::string { return "multi hash-array"; },
+                                                                         TRI_HASH_INDEX_MEM_ZONE));
+
+    if (collection != nullptr) {
+      array->setNumaNode(TRI_NumaNodeLargeTable(collection->_info._cid));
+    }
       
     _multiArray = new HashIndex::MultiArray(array.get(), func.get(), compare.get());
 
@@ -397,6 +420,8 @@ triagens::basics::Json HashIndex::toJson (TRI_memory_zone_t* zone,
   json("unique", triagens::basics::Json(zone, _unique))
       ("sparse", triagens::basics::Json(zone, _sparse));
 
+  filterToJson(json, zone);
+
   return json;
 }
 
@@ -505,6 +530,65 @@ int HashIndex::lookup (TRI_hash_index_search_value_t* searchValue,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locates index elements in the hash index given shaped json objects
+////////////////////////////////////////////////////////////////////////////////
+
+int HashIndex::lookup (TRI_hash_index_search_value_t* searchValue,
+                       std::vector<TRI_index_element_t*>& elements) const {
+
+  if (_unique) {
+    TRI_index_element_t* found = _uniqueArray->_hashArray->findByKey(searchValue);
+
+    if (found != nullptr) {
+      // unique hash index: maximum number is 1
+      elements.emplace_back(found);
+    }
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::vector<TRI_index_element_t*>* results = nullptr;
+  try {
+    results = _multiArray->_hashArray->lookupByKey(searchValue);
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+  if (results != nullptr) {
+    try {
+      elements.insert(elements.end(), results->begin(), results->end());
+      delete results;
+    }
+    catch (...) {
+      delete results;
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+  }
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locates index elements in the hash index for a batch of search
+/// values
+////////////////////////////////////////////////////////////////////////////////
+
+int HashIndex::lookup (std::vector<TRI_hash_index_search_value_t const*> const& searchValues,
+                       std::vector<TRI_index_element_t*>& elements) const {
+  try {
+    if (_unique) {
+      _uniqueArray->_hashArray->findByKeys(searchValues, elements);
+    }
+    else {
+      _multiArray->_hashArray->lookupByKeys(searchValues, elements);
+    }
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locates entries in the hash index given shaped json objects
 ////////////////////////////////////////////////////////////////////////////////
@@ -615,21 +699,13 @@ int HashIndex::insertUnique (TRI_doc_mptr_t const* doc,
 int HashIndex::batchInsertUnique (std::vector<TRI_doc_mptr_t const*> const* documents, 
                                   size_t numThreads) {
   std::vector<TRI_index_element_t*> elements;
-  elements.reserve(documents->size());
-
-  for (auto& doc : *documents) {
-    int res = fillElement(elements, doc);
+  int res = fillElements(elements, *documents, numThreads);
 
-    if (res != TRI_ERROR_NO_ERROR) {
-      for (auto& it : elements) {
-        // free all elements to prevent leak
-        FreeElement(it);
-      }
-      return res;
-    }
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
   }
 
-  int res = _uniqueArray->_hashArray->batchInsert(&elements, numThreads);
+  res = _uniqueArray->_hashArray->batchInsert(&elements, numThreads);
 
   if (res != TRI_ERROR_NO_ERROR) {
     // TODO check leaks
@@ -708,18 +784,11 @@ int HashIndex::batchInsertMulti (std::vector<TRI_doc_mptr_t const*> const* docum
                                  size_t numThreads) {
 
   std::vector<TRI_index_element_t*> elements;
+  int res = fillElements(elements, *documents, numThreads);
 
-  for (auto& doc : *documents) {
-    int res = fillElement(elements, doc);
-
-    if (res != TRI_ERROR_NO_ERROR) {
-      // Filling the elements failed for some reason. Assume loading as failed
-      for (auto& el : elements) {
-        // Free all elements that are not yet in the index
-        FreeElement(el);
-      }
-      return res;
-    }
+  if (res != TRI_ERROR_NO_ERROR) {
+    // Filling the elements failed for some reason. Assume loading as failed
+    return res;
   }
   return _multiArray->_hashArray->batchInsert(&elements, numThreads);
 }
@@ -811,6 +880,13 @@ bool HashIndex::supportsFilterCondition (triagens::aql::AstNode const* node,
                                          size_t itemsInIndex,
                                          size_t& estimatedItems,
                                          double& estimatedCost) const {
+  if (! conditionImpliesFilter(node, reference)) {
+    // partial index: the condition may match documents not in the index
+    estimatedItems = itemsInIndex;
+    estimatedCost = static_cast<double>(itemsInIndex);
+    return false;
+  }
+
   SimpleAttributeEqualityMatcher matcher(fields());
   return matcher.matchAll(this, node, reference, itemsInIndex, estimatedItems, estimatedCost);
 }
@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "Basics/AssocMulti.h"
 #include "Basics/AssocUnique.h"
+#include "Basics/hashes.h"
 #include "Indexes/PathBasedIndex.h"
 #include "Indexes/IndexIterator.h"
 #include "VocBase/shaped-json.h"
@@ -94,12 +95,20 @@ namespace triagens {
 
         void reset () override;
 
+        TRI_index_element_t const* element () const override;
+
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of keys looked up at once
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const LookupBatchSize = 1000;
+
         HashIndex const*                             _index;
         std::vector<TRI_hash_index_search_value_t*>  _keys;
         size_t                                       _position;
-        std::vector<TRI_doc_mptr_t*>                 _buffer;
+        std::vector<TRI_index_element_t*>            _buffer;
         size_t                                       _posInBuffer;
 
     };
@@ -118,7 +127,8 @@ namespace triagens {
                    struct TRI_document_collection_t*,
                    std::vector<std::vector<triagens::basics::AttributeName>> const&,
                    bool,
-                   bool);
+                   bool,
+                   struct TRI_json_t const*);
         
         explicit HashIndex (struct TRI_json_t const*);
 
@@ -173,6 +183,21 @@ namespace triagens {
         int lookup (TRI_hash_index_search_value_t*,
                     std::vector<TRI_doc_mptr_t*>&) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locates index elements in the hash index given shaped json objects
+////////////////////////////////////////////////////////////////////////////////
+
+        int lookup (TRI_hash_index_search_value_t*,
+                    std::vector<TRI_index_element_t*>&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locates index elements in the hash index for a batch of search
+/// values. equal search values produce their elements only once
+////////////////////////////////////////////////////////////////////////////////
+
+        int lookup (std::vector<TRI_hash_index_search_value_t const*> const&,
+                    std::vector<TRI_index_element_t*>&) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locates entries in the hash index given shaped json objects
 ////////////////////////////////////////////////////////////////////////////////
@@ -203,6 +228,14 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the zone the index elements are accounted in
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* elementMemoryZone () const override final {
+          return TRI_HASH_INDEX_MEM_ZONE;
+        }
+
         int insertUnique (struct TRI_doc_mptr_t const*, bool);
 
         int batchInsertUnique (std::vector<TRI_doc_mptr_t const*> const*, size_t);
@@ -256,7 +289,7 @@ namespace triagens {
 
                 // ignore the sid for hashing
                 // only hash the data block
-                hash = fasthash64(data, length, hash);
+                hash = TRI_MemoryHash64(data, length, hash);
               }
 
               if (byKey) {
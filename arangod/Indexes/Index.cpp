@@ -104,7 +104,7 @@ Index::Index (TRI_json_t const* json)
   TRI_json_t const* se = TRI_LookupObjectJson(json, "selectivityEstimate");
 
   if (TRI_IsNumberJson(se)) {
-    _selectivityEstimate = json->_value._number;
+    _selectivityEstimate = se->_value._number;
   }
 }
 
@@ -144,6 +144,18 @@ Index::IndexType Index::type (char const* type) {
   if (::strcmp(type, "geo2") == 0) {
     return TRI_IDX_TYPE_GEO2_INDEX;
   }
+  if (::strcmp(type, "vertex-centric") == 0) {
+    return TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX;
+  }
+  if (::strcmp(type, "geo-cell") == 0) {
+    return TRI_IDX_TYPE_GEO_CELL_INDEX;
+  }
+  if (::strcmp(type, "ttl") == 0) {
+    return TRI_IDX_TYPE_TTL_INDEX;
+  }
+  if (::strcmp(type, "aggregate") == 0) {
+    return TRI_IDX_TYPE_AGGREGATE_INDEX;
+  }
 
   return TRI_IDX_TYPE_UNKNOWN;
 }
@@ -170,6 +182,14 @@ char const* Index::typeName (Index::IndexType type) {
       return "geo1";
     case TRI_IDX_TYPE_GEO2_INDEX:
       return "geo2";
+    case TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX:
+      return "vertex-centric";
+    case TRI_IDX_TYPE_GEO_CELL_INDEX:
+      return "geo-cell";
+    case TRI_IDX_TYPE_TTL_INDEX:
+      return "ttl";
+    case TRI_IDX_TYPE_AGGREGATE_INDEX:
+      return "aggregate";
     case TRI_IDX_TYPE_PRIORITY_QUEUE_INDEX:
     case TRI_IDX_TYPE_BITARRAY_INDEX:
     case TRI_IDX_TYPE_UNKNOWN: {
@@ -287,7 +307,16 @@ bool Index::Compare (TRI_json_t const* lhs,
   }
 
 
-  if (type == IndexType::TRI_IDX_TYPE_GEO1_INDEX) {
+  if (type == IndexType::TRI_IDX_TYPE_HASH_INDEX ||
+      type == IndexType::TRI_IDX_TYPE_SKIPLIST_INDEX) {
+    // the filter of a partial index must be identical, or absent in both
+    if (! TRI_CheckSameValueJson(TRI_LookupObjectJson(lhs, "filter"), TRI_LookupObjectJson(rhs, "filter"))) {
+      return false;
+    }
+  }
+
+  if (type == IndexType::TRI_IDX_TYPE_GEO1_INDEX ||
+      type == IndexType::TRI_IDX_TYPE_GEO_CELL_INDEX) {
     // geoJson must be identical if present
     value = TRI_LookupObjectJson(lhs, "geoJson");
     if (TRI_IsBooleanJson(value)) {
@@ -296,6 +325,22 @@ bool Index::Compare (TRI_json_t const* lhs,
       }
     }
   }
+  else if (type == IndexType::TRI_IDX_TYPE_TTL_INDEX) {
+    // expireAfter
+    value = TRI_LookupObjectJson(lhs, "expireAfter");
+    if (TRI_IsNumberJson(value)) {
+      if (! TRI_CheckSameValueJson(value, TRI_LookupObjectJson(rhs, "expireAfter"))) {
+        return false;
+      }
+    }
+  }
+  else if (type == IndexType::TRI_IDX_TYPE_AGGREGATE_INDEX) {
+    // name and aggregates
+    if (! TRI_CheckSameValueJson(TRI_LookupObjectJson(lhs, "name"), TRI_LookupObjectJson(rhs, "name")) ||
+        ! TRI_CheckSameValueJson(TRI_LookupObjectJson(lhs, "aggregates"), TRI_LookupObjectJson(rhs, "aggregates"))) {
+      return false;
+    }
+  }
   else if (type == IndexType::TRI_IDX_TYPE_FULLTEXT_INDEX) {
     // minLength
     value = TRI_LookupObjectJson(lhs, "minLength");
@@ -306,7 +351,7 @@ bool Index::Compare (TRI_json_t const* lhs,
     }
   }
   else if (type == IndexType::TRI_IDX_TYPE_CAP_CONSTRAINT) {
-    // size, byteSize
+    // size, byteSize, tolerance
     value = TRI_LookupObjectJson(lhs, "size");
     if (TRI_IsNumberJson(value)) {
       if (! TRI_CheckSameValueJson(value, TRI_LookupObjectJson(rhs, "size"))) {
@@ -320,6 +365,13 @@ bool Index::Compare (TRI_json_t const* lhs,
         return false;
       }
     }
+
+    value = TRI_LookupObjectJson(lhs, "tolerance");
+    if (TRI_IsNumberJson(value)) {
+      if (! TRI_CheckSameValueJson(value, TRI_LookupObjectJson(rhs, "tolerance"))) {
+        return false;
+      }
+    }
   }
 
   // other index types: fields must be identical if present
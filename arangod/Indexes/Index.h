@@ -106,9 +106,10 @@ struct TRI_index_element_t {
 /// @brief Allocate a new index Element
 ////////////////////////////////////////////////////////////////////////////////
 
-    static TRI_index_element_t* allocate (size_t numSubs) {
+    static TRI_index_element_t* allocate (size_t numSubs,
+                                          TRI_memory_zone_t* zone) {
       void* space = TRI_Allocate(
-        TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_doc_mptr_t*) + (sizeof(TRI_shaped_sub_t) * numSubs), false
+        zone, sizeof(TRI_doc_mptr_t*) + (sizeof(TRI_shaped_sub_t) * numSubs), false
       );
       return new (space) TRI_index_element_t();
     }
@@ -125,12 +126,13 @@ struct TRI_index_element_t {
 /// @brief Free the index element.
 ////////////////////////////////////////////////////////////////////////////////
 
-    static void free (TRI_index_element_t* el) {
+    static void free (TRI_index_element_t* el,
+                      TRI_memory_zone_t* zone) {
       TRI_ASSERT_EXPENSIVE(el != nullptr);
       TRI_ASSERT_EXPENSIVE(el->document() != nullptr);
       TRI_ASSERT_EXPENSIVE(el->subObjects() != nullptr);
 
-      TRI_Free(TRI_UNKNOWN_MEM_ZONE, el);
+      TRI_Free(zone, el);
     }
 
 };
@@ -183,7 +185,11 @@ namespace triagens {
           TRI_IDX_TYPE_PRIORITY_QUEUE_INDEX, // DEPRECATED and not functional anymore
           TRI_IDX_TYPE_SKIPLIST_INDEX,
           TRI_IDX_TYPE_BITARRAY_INDEX,       // DEPRECATED and not functional anymore
-          TRI_IDX_TYPE_CAP_CONSTRAINT
+          TRI_IDX_TYPE_CAP_CONSTRAINT,
+          TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX,
+          TRI_IDX_TYPE_GEO_CELL_INDEX,
+          TRI_IDX_TYPE_TTL_INDEX,
+          TRI_IDX_TYPE_AGGREGATE_INDEX
         };
 
 // -----------------------------------------------------------------------------
@@ -125,6 +125,14 @@ TRI_doc_mptr_t* IndexIterator::next () {
 void IndexIterator::reset () {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief default implementation for element
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_index_element_t const* IndexIterator::element () const {
+  return nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -34,6 +34,8 @@
 #include "VocBase/document-collection.h"
 #include "VocBase/vocbase.h"
 
+struct TRI_index_element_t;
+
 namespace triagens {
   namespace arango {
     class CollectionNameResolver;
@@ -86,6 +88,13 @@ namespace triagens {
         virtual TRI_doc_mptr_t* next ();
 
         virtual void reset ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the index element of the document last returned by next(), or a
+/// nullptr if the iterator does not work on index elements
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual TRI_index_element_t const* element () const;
     };
 
   }
@@ -29,8 +29,11 @@
 
 #include "PathBasedIndex.h"
 #include "Aql/AstNode.h"
+#include "Basics/json-utilities.h"
 #include "Basics/logging.h"
 
+#include <thread>
+
 using namespace triagens::arango;
 
 // -----------------------------------------------------------------------------
@@ -69,12 +72,14 @@ PathBasedIndex::PathBasedIndex (TRI_idx_iid_t iid,
                                 std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
                                 bool unique,
                                 bool sparse,
-                                bool allowPartialIndex) 
+                                bool allowPartialIndex,
+                                TRI_json_t const* filter) 
   : Index(iid, collection, fields, unique, sparse),
     _shaper(_collection->getShaper()),
     _paths(fillPidPaths()),
     _useExpansion(false),
-    _allowPartialIndex(allowPartialIndex) {
+    _allowPartialIndex(allowPartialIndex),
+    _filter(nullptr) {
 
   TRI_ASSERT(! fields.empty());
 
@@ -86,6 +91,27 @@ PathBasedIndex::PathBasedIndex (TRI_idx_iid_t iid,
       break;
     }
   }
+
+  if (filter != nullptr && TRI_LengthVector(&filter->_value._objects) > 0) {
+    TRI_ASSERT(validateFilter(filter) == TRI_ERROR_NO_ERROR);
+
+    _filter = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, filter);
+
+    if (_filter == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    try {
+      fillFilterValues();
+    }
+    catch (...) {
+      for (auto& it : _filterValues) {
+        TRI_FreeShapedJson(_shaper->memoryZone(), it);
+      }
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _filter);
+      throw;
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -98,7 +124,8 @@ PathBasedIndex::PathBasedIndex (TRI_json_t const* json, bool allowPartialIndex)
     _shaper(nullptr),
     _paths(),
     _useExpansion(false),
-    _allowPartialIndex(allowPartialIndex) {
+    _allowPartialIndex(allowPartialIndex),
+    _filter(nullptr) {
 
   TRI_ASSERT(! _fields.empty());
 
@@ -108,6 +135,17 @@ PathBasedIndex::PathBasedIndex (TRI_json_t const* json, bool allowPartialIndex)
       break;
     }
   }
+
+  // the stub only needs the filter to decide which conditions it supports
+  TRI_json_t const* filter = TRI_LookupObjectJson(json, "filter");
+
+  if (TRI_IsObjectJson(filter) && TRI_LengthVector(&filter->_value._objects) > 0) {
+    _filter = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, filter);
+
+    if (_filter == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -115,6 +153,130 @@ PathBasedIndex::PathBasedIndex (TRI_json_t const* json, bool allowPartialIndex)
 ////////////////////////////////////////////////////////////////////////////////
 
 PathBasedIndex::~PathBasedIndex () {
+  for (auto& it : _filterValues) {
+    TRI_FreeShapedJson(_shaper->memoryZone(), it);
+  }
+
+  if (_filter != nullptr) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _filter);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the index has the given filter
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathBasedIndex::hasFilter (TRI_json_t const* filter) const {
+  if (filter == nullptr || TRI_LengthVector(&filter->_value._objects) == 0) {
+    return (_filter == nullptr);
+  }
+
+  return (_filter != nullptr && TRI_CheckSameValueJson(_filter, filter));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a condition implies the filter of the index
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathBasedIndex::conditionImpliesFilter (triagens::aql::AstNode const* node,
+                                             triagens::aql::Variable const* reference) const {
+  if (_filter == nullptr) {
+    return true;
+  }
+
+  TRI_ASSERT(node->type == triagens::aql::NODE_TYPE_OPERATOR_NARY_AND);
+
+  size_t const n = TRI_LengthVector(&_filter->_value._objects);
+  size_t const m = node->numMembers();
+
+  for (size_t i = 0; i < n; i += 2) {
+    auto name = static_cast<TRI_json_t const*>(TRI_AtVector(&_filter->_value._objects, i));
+    auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&_filter->_value._objects, i + 1));
+
+    std::vector<triagens::basics::AttributeName> attribute;
+    TRI_ParseAttributeString(std::string(name->_value._string.data, name->_value._string.length - 1), attribute);
+
+    bool found = false;
+
+    for (size_t j = 0; j < m && ! found; ++j) {
+      auto op = node->getMemberUnchecked(j);
+
+      if (op->type != triagens::aql::NODE_TYPE_OPERATOR_BINARY_EQ) {
+        continue;
+      }
+
+      for (size_t k = 0; k < 2 && ! found; ++k) {
+        auto access = op->getMember(k);
+        auto other = op->getMember(1 - k);
+
+        std::pair<triagens::aql::Variable const*, std::vector<triagens::basics::AttributeName>> attributeData;
+
+        if (! other->isConstant() ||
+            ! access->isAttributeAccessForVariable(attributeData) ||
+            attributeData.first != reference ||
+            attributeData.second != attribute) {
+          continue;
+        }
+
+        TRI_json_t const* json = other->computeJson();
+
+        if (json != nullptr && TRI_CheckSameValueJson(json, value)) {
+          found = true;
+        }
+      }
+    }
+
+    if (! found) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief validates the filter of a partial index
+////////////////////////////////////////////////////////////////////////////////
+
+int PathBasedIndex::validateFilter (TRI_json_t const* filter) {
+  if (! TRI_IsObjectJson(filter)) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  size_t const n = TRI_LengthVector(&filter->_value._objects);
+
+  for (size_t i = 0; i < n; i += 2) {
+    auto name = static_cast<TRI_json_t const*>(TRI_AtVector(&filter->_value._objects, i));
+    auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&filter->_value._objects, i + 1));
+
+    if (! TRI_IsStringJson(name) ||
+        name->_value._string.length <= 1 ||
+        name->_value._string.data[0] == '_') {
+      // system attributes are not supported
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    std::vector<triagens::basics::AttributeName> attribute;
+    TRI_ParseAttributeString(std::string(name->_value._string.data, name->_value._string.length - 1), attribute);
+
+    if (TRI_AttributeNamesHaveExpansion(attribute)) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    if (! TRI_IsBooleanJson(value) &&
+        ! TRI_IsNumberJson(value) &&
+        ! TRI_IsStringJson(value)) {
+      // null would not match documents without the attribute, and objects
+      // and lists would compare by their memory layout
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
 }
 
 // -----------------------------------------------------------------------------
@@ -143,6 +305,11 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
   TRI_IF_FAILURE("FillElementIllegalShape") {
     return TRI_ERROR_INTERNAL;
   }
+
+  if (_filter != nullptr && ! matchesFilter(&shapedJson)) {
+    // partial index: the document is not part of the index
+    return TRI_ERROR_NO_ERROR;
+  }
   
   size_t const n = _paths.size();
   std::vector<TRI_shaped_json_t> shapes;
@@ -156,14 +323,14 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
       // index sparsity!
       char const* ptr = document->getShapedJsonPtr();  // ONLY IN INDEX, PROTECTED by RUNTIME
 
-      TRI_index_element_t* element = TRI_index_element_t::allocate(n);
+      TRI_index_element_t* element = TRI_index_element_t::allocate(n, elementMemoryZone());
 
       if (element == nullptr) {
         return TRI_ERROR_OUT_OF_MEMORY;
       }
       TRI_IF_FAILURE("FillElementOOM") {
         // clean up manually
-        TRI_index_element_t::free(element);
+        TRI_index_element_t::free(element, elementMemoryZone());
         return TRI_ERROR_OUT_OF_MEMORY;
       }
 
@@ -182,7 +349,7 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
         elements.emplace_back(element);
       }
       catch (...) {
-        TRI_index_element_t::free(element);
+        TRI_index_element_t::free(element, elementMemoryZone());
         return TRI_ERROR_OUT_OF_MEMORY;
       }
     }
@@ -200,14 +367,14 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
 
       for (auto& info : toInsert) {
         TRI_ASSERT(info.size() == n);
-        TRI_index_element_t* element = TRI_index_element_t::allocate(n);
+        TRI_index_element_t* element = TRI_index_element_t::allocate(n, elementMemoryZone());
 
         if (element == nullptr) {
           return TRI_ERROR_OUT_OF_MEMORY;
         }
         TRI_IF_FAILURE("FillElementOOM") {
           // clean up manually
-          TRI_index_element_t::free(element);
+          TRI_index_element_t::free(element, elementMemoryZone());
           return TRI_ERROR_OUT_OF_MEMORY;
         }
 
@@ -226,7 +393,7 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
           elements.emplace_back(element);
         }
         catch (...) {
-          TRI_index_element_t::free(element);
+          TRI_index_element_t::free(element, elementMemoryZone());
           return TRI_ERROR_OUT_OF_MEMORY;
         }
       }
@@ -236,10 +403,200 @@ int PathBasedIndex::fillElement (std::vector<TRI_index_element_t*>& elements,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the index elements for a batch of documents
+////////////////////////////////////////////////////////////////////////////////
+
+int PathBasedIndex::fillElements (std::vector<TRI_index_element_t*>& elements,
+                                  std::vector<TRI_doc_mptr_t const*> const& documents,
+                                  size_t numThreads) {
+  size_t const n = documents.size();
+
+  if (numThreads > n / 1024) {
+    // not worth starting threads for few documents
+    numThreads = n / 1024;
+  }
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
+
+  size_t const chunkSize = n / numThreads;
+
+  std::vector<std::vector<TRI_index_element_t*>> partitions(numThreads);
+  std::vector<int> results(numThreads, TRI_ERROR_NO_ERROR);
+
+  // extracting the attribute values is the expensive part, and only reads
+  // the documents and the shaper. filling multiple indexes of a collection
+  // concurrently does the same
+  auto filler = [&] (size_t chunk) -> void {
+    size_t const lower = chunk * chunkSize;
+    size_t const upper = (chunk + 1 == numThreads) ? n : lower + chunkSize;
+
+    auto& partition = partitions[chunk];
+
+    try {
+      partition.reserve(upper - lower);
+
+      for (size_t i = lower; i < upper; ++i) {
+        int res = fillElement(partition, documents[i]);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          results[chunk] = res;
+          return;
+        }
+      }
+    }
+    catch (...) {
+      results[chunk] = TRI_ERROR_OUT_OF_MEMORY;
+    }
+  };
+
+  if (numThreads == 1) {
+    filler(0);
+  }
+  else {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    try {
+      for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back(std::thread(filler, i));
+      }
+    }
+    catch (...) {
+      // threads that could not be started are handled below
+    }
+
+    // the calling thread takes the first chunk
+    filler(0);
+
+    for (auto& it : threads) {
+      // must join threads, otherwise the program will crash
+      it.join();
+    }
+
+    for (size_t i = threads.size() + 1; i < numThreads; ++i) {
+      filler(i);
+    }
+  }
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  for (auto const& it : results) {
+    if (it != TRI_ERROR_NO_ERROR) {
+      res = it;
+      break;
+    }
+  }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    try {
+      size_t total = 0;
+      for (auto const& it : partitions) {
+        total += it.size();
+      }
+      elements.reserve(elements.size() + total);
+    }
+    catch (...) {
+      res = TRI_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    for (auto const& it : partitions) {
+      for (auto& element : it) {
+        TRI_index_element_t::free(element, elementMemoryZone());
+      }
+    }
+    return res;
+  }
+
+  for (auto const& it : partitions) {
+    elements.insert(elements.end(), it.begin(), it.end());
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the filter to the JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+void PathBasedIndex::filterToJson (triagens::basics::Json& json,
+                                   TRI_memory_zone_t* zone) const {
+  if (_filter != nullptr) {
+    json("filter", triagens::basics::Json(zone, TRI_CopyJson(zone, _filter)));
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the shaped filter values
+////////////////////////////////////////////////////////////////////////////////
+
+void PathBasedIndex::fillFilterValues () {
+  TRI_ASSERT(_filter != nullptr);
+
+  size_t const n = TRI_LengthVector(&_filter->_value._objects);
+  _filterPids.reserve(n / 2);
+  _filterValues.reserve(n / 2);
+
+  for (size_t i = 0; i < n; i += 2) {
+    auto name = static_cast<TRI_json_t const*>(TRI_AtVector(&_filter->_value._objects, i));
+    auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&_filter->_value._objects, i + 1));
+
+    TRI_shape_pid_t pid = _shaper->findOrCreateAttributePathByName(name->_value._string.data);
+
+    if (pid == 0) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    TRI_shaped_json_t* shaped = TRI_ShapedJsonJson(_shaper, value, true);
+
+    if (shaped == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    try {
+      _filterValues.emplace_back(shaped);
+    }
+    catch (...) {
+      TRI_FreeShapedJson(_shaper->memoryZone(), shaped);
+      throw;
+    }
+
+    _filterPids.emplace_back(pid);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a document matches the filter of the index
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathBasedIndex::matchesFilter (TRI_shaped_json_t const* documentShape) const {
+  size_t const n = _filterValues.size();
+
+  for (size_t i = 0; i < n; ++i) {
+    TRI_shaped_json_t const* expected = _filterValues[i];
+    TRI_shaped_json_t shapedJson;
+    TRI_shape_t const* shape = nullptr;
+
+    bool ok = _shaper->extractShapedJson(documentShape, expected->_sid, _filterPids[i], &shapedJson, &shape);
+
+    if (! ok || 
+        shape == nullptr ||
+        shapedJson._data.length != expected->_data.length ||
+        memcmp(shapedJson._data.data, expected->_data.data, expected->_data.length) != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief helper function to create the sole index value insert
 ////////////////////////////////////////////////////////////////////////////////
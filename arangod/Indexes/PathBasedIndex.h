@@ -47,6 +47,7 @@ class VocShaper;
 namespace triagens {
   namespace aql {
     enum AstNodeType : uint32_t;
+    struct Variable;
   }
 
   namespace arango {
@@ -91,7 +92,8 @@ namespace triagens {
                         std::vector<std::vector<triagens::basics::AttributeName>> const&,
                         bool unique,
                         bool sparse,
-                        bool allowPartialIndex);
+                        bool allowPartialIndex,
+                        struct TRI_json_t const*);
         
         explicit PathBasedIndex (struct TRI_json_t const*, bool);
 
@@ -127,6 +129,42 @@ namespace triagens {
           return TRI_index_element_t::memoryUsage(_paths.size());
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the filter of a partial index, or nullptr if the index
+/// contains all documents
+////////////////////////////////////////////////////////////////////////////////
+
+        struct TRI_json_t const* filter () const {
+          return _filter;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the index has the given filter
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasFilter (struct TRI_json_t const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a condition implies the filter of the index
+///
+/// the condition (an n-ary AND) must compare each filter attribute for
+/// equality with the filter value. indexes without a filter can be used
+/// for any condition
+////////////////////////////////////////////////////////////////////////////////
+
+        bool conditionImpliesFilter (triagens::aql::AstNode const*,
+                                     triagens::aql::Variable const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief validates the filter of a partial index
+///
+/// the filter is an object mapping attribute names to the values the
+/// documents of the index must have. values must be booleans, numbers or
+/// strings, and attributes must not be system attributes or expanded
+////////////////////////////////////////////////////////////////////////////////
+
+        static int validateFilter (struct TRI_json_t const*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
@@ -140,6 +178,16 @@ namespace triagens {
         int fillElement (std::vector<TRI_index_element_t*>& elements,
                          TRI_doc_mptr_t const* document);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds the index elements for a batch of documents, using up to
+/// numThreads threads. the elements are appended in document order. if an
+/// error occurs, no elements are appended
+////////////////////////////////////////////////////////////////////////////////
+
+        int fillElements (std::vector<TRI_index_element_t*>& elements,
+                          std::vector<TRI_doc_mptr_t const*> const& documents,
+                          size_t numThreads);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the number of paths
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,6 +196,19 @@ namespace triagens {
           return _paths.size();
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the zone the index elements are accounted in
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual TRI_memory_zone_t* elementMemoryZone () const = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the filter to the JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+        void filterToJson (triagens::basics::Json&,
+                           TRI_memory_zone_t*) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -161,6 +222,18 @@ namespace triagens {
 
         std::vector<std::vector<std::pair<TRI_shape_pid_t, bool>>> fillPidPaths ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the shaped filter values
+////////////////////////////////////////////////////////////////////////////////
+
+        void fillFilterValues ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not a document matches the filter of the index
+////////////////////////////////////////////////////////////////////////////////
+
+        bool matchesFilter (TRI_shaped_json_t const*) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief helper function to create a set of index combinations to insert
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,6 +282,26 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
         
         bool _allowPartialIndex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the filter of a partial index: documents are only indexed if
+/// they have all attribute values of the filter. nullptr if the index
+/// contains all documents
+////////////////////////////////////////////////////////////////////////////////
+
+        struct TRI_json_t* _filter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attribute paths of the filter
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_shape_pid_t> _filterPids;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the shaped values of the filter
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<TRI_shaped_json_t*> _filterValues;
     };
 
   }
@@ -129,8 +129,13 @@ PrimaryIndex::PrimaryIndex (TRI_document_collection_t* collection)
                                          IsEqualElementElement,
                                          IsEqualElementElement,
                                          indexBuckets,
-                                         [] () -> std::string { return "primary"; }
+                                         [] () -> std::string { return "primary"; },
+                                         TRI_PRIMARY_INDEX_MEM_ZONE
   );
+
+  if (collection != nullptr) {
+    _primaryIndex->setNumaNode(TRI_NumaNodeLargeTable(collection->_info._cid));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -262,6 +267,45 @@ TRI_doc_mptr_t* PrimaryIndex::lookupSequentialReverse (triagens::basics::BucketP
   return _primaryIndex->findSequentialReverse(position);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback for the next at most limit documents of a
+///        scan in chunks, and returns the number of documents visited
+////////////////////////////////////////////////////////////////////////////////
+
+size_t PrimaryIndex::scanChunk (triagens::basics::ScanCursor& cursor,
+                                size_t limit,
+                                std::function<void(TRI_doc_mptr_t*)> const& callback) const {
+  return _primaryIndex->scanChunk(cursor, limit, callback);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a scan in chunks is complete
+////////////////////////////////////////////////////////////////////////////////
+
+bool PrimaryIndex::isScanDone (triagens::basics::ScanCursor const& cursor) const {
+  return _primaryIndex->isScanDone(cursor);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a method to iterate over the elements of a single bucket of the
+///        index in sequential order. 
+///        Returns nullptr if all documents of the bucket have been returned.
+///        Convention: position === 0 indicates a new start.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_doc_mptr_t* PrimaryIndex::lookupSequentialInBucket (size_t bucketId,
+                                                        uint64_t& position) const {
+  return _primaryIndex->findSequentialInBucket(bucketId, position);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of buckets of the index
+////////////////////////////////////////////////////////////////////////////////
+
+size_t PrimaryIndex::numberOfBuckets () const {
+  return _primaryIndex->numberOfBuckets();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief adds a key/element to the index
 /// returns a status code, and *found will contain a found element (if any)
@@ -182,6 +182,38 @@ namespace triagens {
 
         TRI_doc_mptr_t* lookupSequentialReverse (triagens::basics::BucketPosition& position);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a method to iterate over the elements of a single bucket of the
+///        index in sequential order. 
+///        Returns nullptr if all documents of the bucket have been returned.
+///        Convention: position === 0 indicates a new start.
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_doc_mptr_t* lookupSequentialInBucket (size_t bucketId,
+                                                  uint64_t& position) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback for the next at most limit documents of a
+///        scan in chunks, and returns the number of documents visited.
+///        The caller may release the collection lock between two chunks.
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t scanChunk (triagens::basics::ScanCursor&,
+                          size_t,
+                          std::function<void(TRI_doc_mptr_t*)> const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a scan in chunks is complete
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isScanDone (triagens::basics::ScanCursor const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of buckets of the index
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numberOfBuckets () const;
+
         int insertKey (TRI_doc_mptr_t*, void const**);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +32,7 @@
 #include "Aql/SortCondition.h"
 #include "Basics/AttributeNameParser.h"
 #include "Basics/debugging.h"
+#include "Basics/fasthash.h"
 #include "Basics/json-utilities.h"
 #include "Basics/logging.h"
 #include "VocBase/document-collection.h"
@@ -162,7 +163,7 @@ static TRI_index_operator_t* buildRangeOperator (TRI_json_t const* lowerBound,
 
 static void FreeElm (void* e) {
   auto element = static_cast<TRI_index_element_t*>(e);
-  TRI_index_element_t::free(element);
+  TRI_index_element_t::free(element, TRI_SKIPLIST_INDEX_MEM_ZONE);
 }
 
 // .............................................................................
@@ -313,6 +314,24 @@ static int FillLookupOperator (TRI_index_operator_t* slOperator,
 // --SECTION--                                            class SkiplistIterator
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create an iterator. the iterator registers itself as a reader of
+/// the skiplist, so that the nodes it points to are not freed while it lives
+////////////////////////////////////////////////////////////////////////////////
+
+SkiplistIterator::SkiplistIterator (SkiplistIndex const* idx,
+                                    bool reverse) 
+  : _index(idx),
+    _readGuard(idx->_skiplistIndex->readProtect()),
+    _currentInterval(0),
+    _reverse(reverse),
+    _cursor(nullptr) {
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -739,6 +758,8 @@ TRI_index_element_t* SkiplistIterator::nextIteration () {
 // -----------------------------------------------------------------------------
 
 TRI_doc_mptr_t* SkiplistIndexIterator::next () {
+  _element = nullptr;
+
   while (_iterator == nullptr) {
     if (_currentOperator == _operators.size()) {
       // Sorry nothing found at all
@@ -765,6 +786,7 @@ TRI_doc_mptr_t* SkiplistIndexIterator::next () {
     _iterator = _index->lookup(_operators[_currentOperator], _reverse);
     res = _iterator->next();
   }
+  _element = res;
   return res->document();
 }
 
@@ -772,6 +794,153 @@ void SkiplistIndexIterator::reset () {
   delete _iterator;
   _iterator = nullptr;
   _currentOperator = 0;
+  _element = nullptr;
+}
+
+TRI_index_element_t const* SkiplistIndexIterator::element () const {
+  return _element;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    class SkiplistSkipScanIterator
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the iterator. it takes over the values and the bounds
+////////////////////////////////////////////////////////////////////////////////
+
+SkiplistSkipScanIterator::SkiplistSkipScanIterator (SkiplistIndex const* index,
+                                                    TRI_json_t* values,
+                                                    TRI_json_t* lower,
+                                                    bool includeLower,
+                                                    TRI_json_t* upper,
+                                                    bool includeUpper,
+                                                    bool reverse)
+  : _index(index),
+    _readGuard(index->_skiplistIndex->readProtect()),
+    _values(values),
+    _lower(lower),
+    _includeLower(includeLower),
+    _upper(upper),
+    _includeUpper(includeUpper),
+    _reverse(reverse),
+    _done(false),
+    _group(nullptr),
+    _operator(),
+    _iterator(nullptr),
+    _element(nullptr) {
+}
+
+SkiplistSkipScanIterator::~SkiplistSkipScanIterator () {
+  delete _iterator;
+}
+
+TRI_doc_mptr_t* SkiplistSkipScanIterator::next () {
+  _element = nullptr;
+
+  while (true) {
+    if (_iterator != nullptr) {
+      TRI_index_element_t* res = _iterator->next();
+
+      if (res != nullptr) {
+        _element = res;
+        return res->document();
+      }
+
+      delete _iterator;
+      _iterator = nullptr;
+    }
+
+    if (_done) {
+      return nullptr;
+    }
+
+    // continue with the next value of the first index attribute
+    _group = _index->nextLeadingValue(_group, _reverse);
+
+    if (_group == nullptr) {
+      _done = true;
+      return nullptr;
+    }
+
+    _iterator = lookupGroup();
+  }
+}
+
+void SkiplistSkipScanIterator::reset () {
+  delete _iterator;
+  _iterator = nullptr;
+  _operator.reset();
+  _group = nullptr;
+  _done = false;
+  _element = nullptr;
+}
+
+TRI_index_element_t const* SkiplistSkipScanIterator::element () const {
+  return _element;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the condition for the current value of the first
+/// attribute
+////////////////////////////////////////////////////////////////////////////////
+
+SkiplistIterator* SkiplistSkipScanIterator::lookupGroup () {
+  TRI_ASSERT(_group != nullptr);
+
+  TRI_shaped_sub_t const* sub = &_group->subObjects()[0];
+  TRI_shaped_json_t shaped;
+  shaped._sid = sub->_sid;
+  TRI_InspectShapedSub(sub, _group->document()->getShapedJsonPtr(), shaped);  // ONLY IN INDEX
+
+  std::unique_ptr<TRI_json_t> parameter(TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, TRI_LengthArrayJson(_values.get()) + 1));
+
+  if (parameter == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  TRI_json_t* leading = TRI_JsonShapedJson(_index->_shaper, &shaped);
+
+  if (leading == nullptr) {
+    leading = TRI_CreateNullJson(TRI_UNKNOWN_MEM_ZONE);
+
+    if (leading == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+  }
+
+  TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, parameter.get(), leading);
+
+  size_t const n = TRI_LengthArrayJson(_values.get());
+  for (size_t i = 0; i < n; ++i) {
+    TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, parameter.get(), TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, TRI_LookupArrayJson(_values.get(), i)));
+  }
+
+  size_t const numFields = n + 1;
+  std::unique_ptr<TRI_index_operator_t> eqOperator(TRI_CreateIndexOperator(TRI_EQ_INDEX_OPERATOR,
+                                                                           nullptr,
+                                                                           nullptr,
+                                                                           parameter.get(),
+                                                                           _index->_shaper,
+                                                                           numFields));
+  std::unique_ptr<TRI_index_operator_t> rangeOperator(buildRangeOperator(_lower.get(), _includeLower, _upper.get(), _includeUpper, parameter.get(), _index->_shaper));
+  parameter.release();
+
+  if (rangeOperator != nullptr) {
+    _operator.reset(TRI_CreateIndexOperator(TRI_AND_INDEX_OPERATOR,
+                                            eqOperator.get(),
+                                            rangeOperator.get(),
+                                            nullptr,
+                                            _index->_shaper,
+                                            2));
+    rangeOperator.release();
+    eqOperator.release();
+  }
+  else {
+    _operator.reset(eqOperator.release());
+  }
+
+  return _index->lookup(_operator.get(), _reverse);
 }
 
 // -----------------------------------------------------------------------------
@@ -790,13 +959,15 @@ SkiplistIndex::SkiplistIndex (TRI_idx_iid_t iid,
                               TRI_document_collection_t* collection,
                               std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
                               bool unique,
-                              bool sparse) 
-  : PathBasedIndex(iid, collection, fields, unique, sparse, true),
+                              bool sparse,
+                              TRI_json_t const* filter) 
+  : PathBasedIndex(iid, collection, fields, unique, sparse, true, filter),
     CmpElmElm(this),
     CmpKeyElm(this),
-    _skiplistIndex(nullptr) {
+    _skiplistIndex(nullptr),
+    _distinct(fields.size()) {
 
-  _skiplistIndex = new TRI_Skiplist(CmpElmElm, CmpKeyElm, FreeElm, unique, _useExpansion);
+  _skiplistIndex = new TRI_Skiplist(CmpElmElm, CmpKeyElm, FreeElm, unique, _useExpansion, TRI_SKIPLIST_INDEX_MEM_ZONE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -825,8 +996,37 @@ SkiplistIndex::~SkiplistIndex () {
 // -----------------------------------------------------------------------------
         
 size_t SkiplistIndex::memory () const {
+  size_t sketches = 0;
+  for (auto const& it : _distinct) {
+    sketches += it.memory();
+  }
+
   return _skiplistIndex->memoryUsage() +
-         static_cast<size_t>(_skiplistIndex->getNrUsed()) * elementSize();
+         static_cast<size_t>(_skiplistIndex->getNrUsed()) * elementSize() +
+         sketches;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the selectivity estimate of the index
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex::selectivityEstimate () const {
+  if (_unique) {
+    return 1.0;
+  }
+
+  if (_skiplistIndex == nullptr) {
+    // use hard-coded selectivity estimate in case of cluster coordinator
+    return _selectivityEstimate;
+  }
+
+  double const itemsPerValue = estimatedItemsPerValue(_distinct.size());
+
+  if (itemsPerValue <= 0.0) {
+    return 1.0;
+  }
+
+  return 1.0 / itemsPerValue;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -840,6 +1040,8 @@ triagens::basics::Json SkiplistIndex::toJson (TRI_memory_zone_t* zone,
   json("unique", triagens::basics::Json(zone, _unique))
       ("sparse", triagens::basics::Json(zone, _sparse));
 
+  filterToJson(json, zone);
+
   return json;
 }
 
@@ -869,7 +1071,7 @@ int SkiplistIndex::insert (TRI_doc_mptr_t const* doc,
   if (res != TRI_ERROR_NO_ERROR) {
     for (auto& it : elements) {
       // free all elements to prevent leak
-      TRI_index_element_t::free(it);
+      TRI_index_element_t::free(it, TRI_SKIPLIST_INDEX_MEM_ZONE);
     }
 
     return res;
@@ -889,10 +1091,10 @@ int SkiplistIndex::insert (TRI_doc_mptr_t const* doc,
     }
 
     if (res != TRI_ERROR_NO_ERROR) {
-      TRI_index_element_t::free(elements[i]);
+      TRI_index_element_t::free(elements[i], TRI_SKIPLIST_INDEX_MEM_ZONE);
       // Note: this element is freed already
       for (size_t j = i + 1; j < count; ++j) {
-        TRI_index_element_t::free(elements[j]);
+        TRI_index_element_t::free(elements[j], TRI_SKIPLIST_INDEX_MEM_ZONE);
       }
       for (size_t j = 0; j < i; ++j) {
         _skiplistIndex->remove(elements[j]);
@@ -902,6 +1104,13 @@ int SkiplistIndex::insert (TRI_doc_mptr_t const* doc,
       break;
     }
   }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    for (auto const& it : elements) {
+      updateStatistics(it);
+    }
+  }
+
   return res;
 }
 
@@ -922,11 +1131,30 @@ int SkiplistIndex::remove (TRI_doc_mptr_t const* doc,
   size_t count = elements.size();
   for (size_t i = 0; i < count; ++i) {
     res = _skiplistIndex->remove(elements[i]);
-    TRI_index_element_t::free(elements[i]);
+    TRI_index_element_t::free(elements[i], TRI_SKIPLIST_INDEX_MEM_ZONE);
   }
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the removed skiplist nodes no iterator can see any more
+///
+/// removed nodes are only unlinked by remove(), because concurrent readers
+/// may still be positioned on them. this is called by the cleanup thread
+////////////////////////////////////////////////////////////////////////////////
+
+int SkiplistIndex::cleanup () {
+  if (_skiplistIndex != nullptr) {
+    size_t const n = _skiplistIndex->reclaim();
+
+    if (n > 0) {
+      LOG_TRACE("freed %llu removed skiplist nodes", (unsigned long long) n);
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief attempts to locate an entry in the skip list index
 ///
@@ -1104,6 +1332,147 @@ bool SkiplistIndex::accessFitsIndex (triagens::aql::AstNode const* access,
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the attribute values of an element to the cardinality sketches
+/// the hash for sketch i covers the values of the first i + 1 attributes
+////////////////////////////////////////////////////////////////////////////////
+
+void SkiplistIndex::updateStatistics (TRI_index_element_t const* element) {
+  TRI_ASSERT(_distinct.size() == numPaths());
+
+  uint64_t hash = 0x0123456789abcdef;
+
+  for (size_t i = 0; i < _distinct.size(); ++i) {
+    auto sub = &element->subObjects()[i];
+    char const* data;
+    size_t length;
+    TRI_InspectShapedSub(sub, element->document(), data, length);
+
+    // values with the same data block but different shapes are different
+    hash = fasthash64(data, length, hash ^ static_cast<uint64_t>(sub->_sid));
+    _distinct[i].add(hash);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the estimated number of index entries per distinct value
+/// of the first n index attributes, or 0 if there is no estimate
+///
+/// the sketches cannot forget removed values, so the number of distinct
+/// values may be overestimated after many removals. this is the optimistic
+/// direction, and it is bounded by the number of entries still in the index
+////////////////////////////////////////////////////////////////////////////////
+
+double SkiplistIndex::estimatedItemsPerValue (size_t n) const {
+  if (n == 0) {
+    return 0.0;
+  }
+
+  if (_skiplistIndex == nullptr) {
+    // cluster coordinator: only the estimate for all attributes is known
+    if (n == _fields.size() && _selectivityEstimate > 0.0) {
+      return 1.0 / _selectivityEstimate;
+    }
+    return 0.0;
+  }
+
+  TRI_ASSERT(n <= _distinct.size());
+
+  double const items = static_cast<double>(_skiplistIndex->getNrUsed());
+
+  if (items <= 0.0) {
+    // no data yet, so the estimate would be meaningless
+    return 0.0;
+  }
+
+  double const distinct = (std::max)(_distinct[n - 1].estimate(), 1.0);
+  return (std::max)(items / distinct, 1.0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of index attributes after the first one that
+/// are compared with equality, if the matched condition parts can be looked
+/// up with a skip-scan, and 0 otherwise
+///
+/// a skip-scan requires that the first attribute is not restricted at all,
+/// and at least the second one is compared with ==. the equality run may be
+/// followed by a range on the next attribute. sparse indexes and array
+/// indexes do not contain all values of the first attribute, so they cannot
+/// be skip-scanned
+////////////////////////////////////////////////////////////////////////////////
+
+size_t SkiplistIndex::skipScanAttributes (std::unordered_map<size_t, std::vector<triagens::aql::AstNode const*>> const& found) const {
+  if (_fields.size() < 2 || _sparse || _useExpansion || found.find(0) != found.end()) {
+    return 0;
+  }
+
+  size_t attributes = 0;
+
+  for (size_t i = 1; i < _fields.size(); ++i) {
+    auto it = found.find(i);
+
+    if (it == found.end()) {
+      break;
+    }
+
+    bool containsEquality = false;
+    for (auto const& node : (*it).second) {
+      if (node->type == triagens::aql::NODE_TYPE_OPERATOR_BINARY_EQ) {
+        containsEquality = true;
+        break;
+      }
+    }
+
+    if (! containsEquality) {
+      // IN lists are not supported, ranges end the equality run
+      break;
+    }
+
+    ++attributes;
+  }
+
+  return attributes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns an index element with the next distinct value of the
+/// first index attribute after the one of the given element
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_index_element_t const* SkiplistIndex::nextLeadingValue (TRI_index_element_t const* element,
+                                                            bool reverse) const {
+  SkiplistIterator::Node* node;
+
+  if (element == nullptr) {
+    node = reverse ? _skiplistIndex->prevNode(nullptr) : _skiplistIndex->startNode()->nextNode();
+  }
+  else {
+    TRI_shaped_sub_t const* sub = &element->subObjects()[0];
+    TRI_shaped_json_t shaped;
+    shaped._sid = sub->_sid;
+    TRI_InspectShapedSub(sub, element->document()->getShapedJsonPtr(), shaped);  // ONLY IN INDEX
+
+    TRI_skiplist_index_key_t key;
+    key._fields = &shaped;
+    key._numFields = 1;
+
+    if (reverse) {
+      // the last node before the value
+      node = _skiplistIndex->leftKeyLookup(&key);
+    }
+    else {
+      // the first node after the value
+      node = _skiplistIndex->rightKeyLookup(&key)->nextNode();
+    }
+  }
+
+  if (node == nullptr || node == _skiplistIndex->startNode()) {
+    return nullptr;
+  }
+
+  return node->document();
+}
+
 void SkiplistIndex::matchAttributes (triagens::aql::AstNode const* node,
                                      triagens::aql::Variable const* reference,
                                      std::unordered_map<size_t, std::vector<triagens::aql::AstNode const*>>& found,
@@ -1147,14 +1516,52 @@ bool SkiplistIndex::supportsFilterCondition (triagens::aql::AstNode const* node,
                                              size_t itemsInIndex,
                                              size_t& estimatedItems,
                                              double& estimatedCost) const {
+  if (! conditionImpliesFilter(node, reference)) {
+    // partial index: the condition may match documents not in the index
+    estimatedItems = itemsInIndex;
+    estimatedCost = static_cast<double>(itemsInIndex);
+    return false;
+  }
+
   std::unordered_map<size_t, std::vector<triagens::aql::AstNode const*>> found;
   size_t values = 0;
   matchAttributes(node, reference, found, values, false);
 
+  size_t const skipScanned = skipScanAttributes(found);
+
+  if (skipScanned > 0) {
+    // skip-scan: one lookup per distinct value of the first attribute. this
+    // is only worth it if there are few of them, so it requires estimates
+    double const itemsPerValue = estimatedItemsPerValue(skipScanned + 1);
+    double const distinct = (_skiplistIndex == nullptr ? 0.0 : _distinct[0].estimate());
+
+    if (itemsPerValue > 0.0 && distinct > 0.0) {
+      double rangeReductionFactor = 1.0;
+      auto it = found.find(skipScanned + 1);
+
+      if (it != found.end()) {
+        rangeReductionFactor = ((*it).second.size() >= 2 ? 7.5 : 2.0);
+      }
+
+      double const items = distinct * itemsPerValue / rangeReductionFactor;
+      estimatedCost = distinct + items;
+
+      if (estimatedCost < static_cast<double>(itemsInIndex)) {
+        estimatedItems = (std::max)(static_cast<size_t>(items), static_cast<size_t>(1));
+        return true;
+      }
+    }
+
+    estimatedItems = itemsInIndex;
+    estimatedCost  = static_cast<double>(itemsInIndex);
+    return false;
+  }
+
   bool lastContainsEquality = true;
   size_t attributesCovered = 0;
   size_t attributesCoveredByEquality = 0;
   double equalityReductionFactor = 20.0;
+  double rangeReductionFactor = 1.0;
   estimatedCost = static_cast<double>(itemsInIndex);
 
   for (size_t i = 0; i < _fields.size(); ++i) {
@@ -1198,12 +1605,13 @@ bool SkiplistIndex::supportsFilterCondition (triagens::aql::AstNode const* node,
       if (nodes.size() >= 2) {
         // at least two (non-equality) conditions. probably a range with lower
         // and upper bound defined
-        estimatedCost /= 7.5;
+        rangeReductionFactor *= 7.5;
       }
       else {
         // one (non-equality). this is either a lower or a higher bound
-        estimatedCost /= 2.0;
+        rangeReductionFactor *= 2.0;
       }
+      estimatedCost /= rangeReductionFactor;
     }
 
     lastContainsEquality = containsEquality;
@@ -1213,15 +1621,23 @@ bool SkiplistIndex::supportsFilterCondition (triagens::aql::AstNode const* node,
     values = 1;
   }
 
+  // replace the guess for the equality-covered attributes with the number of
+  // entries per distinct value as measured by the cardinality sketches
+  double const itemsPerValue = estimatedItemsPerValue(attributesCoveredByEquality);
+  if (itemsPerValue > 0.0) {
+    estimatedCost = itemsPerValue / rangeReductionFactor;
+  }
+
   if (attributesCoveredByEquality == _fields.size() && unique()) {
     // index is unique and condition covers all attributes by equality
-    if (estimatedItems >= values) {
+    if (estimatedCost >= static_cast<double>(values)) {
       // reduce costs due to uniqueness
       estimatedItems = values;
       estimatedCost  = static_cast<double>(estimatedItems);
     }
     else {
       // cost is already low... now slightly prioritize the unique index
+      estimatedItems = (std::max)(static_cast<size_t>(estimatedCost), static_cast<size_t>(1));
       estimatedCost *= 0.995;
     }
     return true;
@@ -1250,8 +1666,8 @@ bool SkiplistIndex::supportsSortCondition (triagens::aql::SortCondition const* s
                                            double& estimatedCost) const {
   TRI_ASSERT(sortCondition != nullptr);
 
-  if (! _sparse) {
-    // only non-sparse indexes can be used for sorting
+  if (! _sparse && _filter == nullptr) {
+    // only non-sparse and non-partial indexes can be used for sorting
     if (! _useExpansion &&
         sortCondition->isUnidirectional() && 
         sortCondition->isOnlyAttributeAccess()) {
@@ -1328,12 +1744,15 @@ IndexIterator* SkiplistIndex::iteratorForCondition (IndexIteratorContext* contex
     return false;
   };
 
+  // the first attribute is not restricted in a skip-scan
+  size_t const skipScanned = skipScanAttributes(found);
+
   // initialize permutations
   std::vector<PermutationState> permutationStates;
   permutationStates.reserve(_fields.size());
   size_t maxPermutations = 1;
 
-  size_t usedFields = 0;
+  size_t usedFields = (skipScanned > 0 ? 1 : 0);
   for (; usedFields < _fields.size(); ++usedFields) {
     // We are in the equality range, we only allow one == or IN node per attribute
     auto it = found.find(usedFields);
@@ -1435,6 +1854,25 @@ IndexIterator* SkiplistIndex::iteratorForCondition (IndexIteratorContext* contex
     }
   }
 
+  if (skipScanned > 0) {
+    std::unique_ptr<TRI_json_t> values(TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, permutationStates.size()));
+
+    if (values == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+
+    for (auto& state : permutationStates) {
+      std::unique_ptr<TRI_json_t> json(state.getValue()->toJsonValue(TRI_UNKNOWN_MEM_ZONE));
+
+      if (json == nullptr) {
+        return nullptr;
+      }
+      TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, values.get(), json.release());
+    }
+
+    return new SkiplistSkipScanIterator(this, values.release(), lower.release(), includeLower, upper.release(), includeUpper, reverse);
+  }
+
   std::vector<TRI_index_operator_t*> searchValues;
   searchValues.reserve(maxPermutations);
 
@@ -1550,7 +1988,10 @@ triagens::aql::AstNode* SkiplistIndex::specializeCondition (triagens::aql::AstNo
   std::vector<triagens::aql::AstNode const*> children;  
   bool lastContainsEquality = true;
 
-  for (size_t i = 0; i < _fields.size(); ++i) {
+  // a skip-scan starts with the second attribute
+  size_t const skipScanned = skipScanAttributes(found);
+
+  for (size_t i = (skipScanned > 0 ? 1 : 0); i < _fields.size(); ++i) {
     auto it = found.find(i);
 
     if (it == found.end()) {
@@ -1569,6 +2010,11 @@ triagens::aql::AstNode* SkiplistIndex::specializeCondition (triagens::aql::AstNo
       }
     }
 
+    if (skipScanned > 0 && i > skipScanned && containsEquality) {
+      // IN lists after the equality run are not supported by a skip-scan
+      break;
+    }
+
     if (! lastContainsEquality) {
       // unsupported condition. must abort
       break;
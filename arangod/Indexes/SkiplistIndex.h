@@ -32,6 +32,7 @@
 
 #include "Basics/Common.h"
 #include "Aql/AstNode.h"
+#include "Basics/HyperLogLog.h"
 #include "Basics/SkipList.h"
 #include "Indexes/IndexIterator.h"
 #include "Indexes/PathBasedIndex.h"
@@ -101,6 +102,7 @@ namespace triagens {
       private:
 
         SkiplistIndex const* _index;
+        triagens::basics::DataProtector::UnUser _readGuard; // keeps the nodes alive
         size_t _currentInterval; // starts with 0, current interval used
         bool _reverse;
         Node* _cursor;
@@ -112,13 +114,8 @@ namespace triagens {
       
       public:
 
-        SkiplistIterator (SkiplistIndex const* idx,
-                          bool reverse) 
-          : _index(idx),
-            _currentInterval(0),
-            _reverse(reverse),
-            _cursor(nullptr) {
-        }
+        SkiplistIterator (SkiplistIndex const*,
+                          bool);
 
         ~SkiplistIterator () {
         }
@@ -186,7 +183,8 @@ namespace triagens {
           _operators(op),
           _reverse(reverse),
           _currentOperator(0),
-          _iterator(nullptr) {
+          _iterator(nullptr),
+          _element(nullptr) {
         }
 
         ~SkiplistIndexIterator () {
@@ -200,6 +198,7 @@ namespace triagens {
 
         void reset () override;
 
+        TRI_index_element_t const* element () const override;
 
       private:
 
@@ -208,6 +207,67 @@ namespace triagens {
         bool                                 _reverse;
         size_t                               _currentOperator;
         SkiplistIterator*                    _iterator;
+        TRI_index_element_t const*           _element;
+
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterator for a skip-scan. the first index attribute is not
+/// restricted by the condition, but the following ones are compared with
+/// equality, and possibly the next one with a range. the iterator jumps
+/// from one distinct value of the first attribute to the next, and looks up
+/// the condition for each of them. the results are in index order
+////////////////////////////////////////////////////////////////////////////////
+
+    class SkiplistSkipScanIterator final : public IndexIterator {
+
+      public:
+
+        SkiplistSkipScanIterator (SkiplistIndex const*,
+                                  TRI_json_t*,
+                                  TRI_json_t*,
+                                  bool,
+                                  TRI_json_t*,
+                                  bool,
+                                  bool);
+
+        ~SkiplistSkipScanIterator ();
+
+        TRI_doc_mptr_t* next () override;
+
+        void reset () override;
+
+        TRI_index_element_t const* element () const override;
+
+      private:
+
+        SkiplistIterator* lookupGroup ();
+
+      private:
+
+        SkiplistIndex const*                     _index;
+        triagens::basics::DataProtector::UnUser  _readGuard; // keeps _group alive
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the values the attributes after the first one are compared with
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unique_ptr<TRI_json_t>              _values;
+        std::unique_ptr<TRI_json_t>              _lower;
+        bool                                     _includeLower;
+        std::unique_ptr<TRI_json_t>              _upper;
+        bool                                     _includeUpper;
+        bool                                     _reverse;
+        bool                                     _done;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an index element with the current value of the first attribute
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_index_element_t const*               _group;
+        std::unique_ptr<TRI_index_operator_t>    _operator;
+        SkiplistIterator*                        _iterator;
+        TRI_index_element_t const*               _element;
 
     };
 // -----------------------------------------------------------------------------
@@ -244,6 +304,7 @@ namespace triagens {
       };
 
       friend class SkiplistIterator;
+      friend class SkiplistSkipScanIterator;
       friend struct KeyElementComparator;
       friend struct ElementElementComparator;
 
@@ -261,7 +322,8 @@ namespace triagens {
                         struct TRI_document_collection_t*,
                         std::vector<std::vector<triagens::basics::AttributeName>> const&,
                         bool,
-                        bool);
+                        bool,
+                        struct TRI_json_t const*);
         
         explicit SkiplistIndex (struct TRI_json_t const*);
 
@@ -282,8 +344,10 @@ namespace triagens {
         }
 
         bool hasSelectivityEstimate () const override final {
-          return false;
+          return true;
         }
+
+        double selectivityEstimate () const override final;
         
         size_t memory () const override final;
 
@@ -294,6 +358,12 @@ namespace triagens {
          
         int remove (struct TRI_doc_mptr_t const*, bool) override final;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the removed skiplist nodes no iterator can see any more
+////////////////////////////////////////////////////////////////////////////////
+
+        int cleanup () override final;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief attempts to locate an entry in the skip list index
 ///
@@ -330,6 +400,14 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the zone the index elements are accounted in
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* elementMemoryZone () const override final {
+          return TRI_SKIPLIST_INDEX_MEM_ZONE;
+        }
+
         bool isDuplicateOperator (triagens::aql::AstNode const*,
                                   std::unordered_set<int> const&) const;
 
@@ -353,6 +431,37 @@ namespace triagens {
                               size_t&,
                               bool) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of index attributes after the first one that
+/// are compared with equality, if the matched condition parts can be looked
+/// up with a skip-scan, and 0 otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t skipScanAttributes (std::unordered_map<size_t, std::vector<triagens::aql::AstNode const*>> const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns an index element with the next distinct value of the
+/// first index attribute after the one of the given element, in index order
+/// or reverse. starts with the first (last) element if the given element is
+/// a nullptr, and returns a nullptr if there is no further value
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_index_element_t const* nextLeadingValue (TRI_index_element_t const*,
+                                                     bool) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the attribute values of an element to the cardinality sketches
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateStatistics (TRI_index_element_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the estimated number of index entries per distinct value
+/// of the first n index attributes, or 0 if there is no estimate
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimatedItemsPerValue (size_t) const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -369,6 +478,13 @@ namespace triagens {
 
         TRI_Skiplist* _skiplistIndex;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cardinality sketches for the index attributes. sketch i estimates
+/// the number of distinct combinations of the first i + 1 attributes
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<triagens::basics::HyperLogLog> _distinct;
+
     };
 
   }
@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time-to-live index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "TtlIndex.h"
+#include "Indexes/GeoIndex2.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two elements, by expiration time and then by document
+////////////////////////////////////////////////////////////////////////////////
+
+static int CmpElmElm (TRI_ttl_element_t const* left,
+                      TRI_ttl_element_t const* right,
+                      triagens::basics::SkipListCmpType cmptype) {
+  if (left->_expires != right->_expires) {
+    return left->_expires < right->_expires ? -1 : 1;
+  }
+
+  if (cmptype == triagens::basics::SKIPLIST_CMP_PREORDER) {
+    return 0;
+  }
+
+  // total order: break ties by the document
+  if (left->_document != right->_document) {
+    return left->_document < right->_document ? -1 : 1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares an expiration time with an element
+////////////////////////////////////////////////////////////////////////////////
+
+static int CmpKeyElm (double const* key,
+                      TRI_ttl_element_t const* element) {
+  if (*key != element->_expires) {
+    return *key < element->_expires ? -1 : 1;
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an element
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeElm (TRI_ttl_element_t* element) {
+  delete element;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    class TtlIndex
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a new ttl index
+////////////////////////////////////////////////////////////////////////////////
+
+TtlIndex::TtlIndex (TRI_idx_iid_t iid,
+                    TRI_document_collection_t* collection,
+                    std::vector<std::vector<triagens::basics::AttributeName>> const& fields,
+                    TRI_shape_pid_t path,
+                    double expireAfter)
+  : Index(iid, collection, fields, false, true),
+    _path(path),
+    _expireAfter(expireAfter),
+    _tree(nullptr) {
+
+  TRI_ASSERT(iid != 0);
+  TRI_ASSERT(path != 0);
+
+  _tree = new TRI_TtlTree(CmpElmElm, CmpKeyElm, FreeElm, false, false);
+}
+
+TtlIndex::~TtlIndex () {
+  delete _tree;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+size_t TtlIndex::memory () const {
+  return _tree->memoryUsage() +
+         static_cast<size_t>(_tree->getNrUsed()) * sizeof(TRI_ttl_element_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json TtlIndex::toJson (TRI_memory_zone_t* zone,
+                                         bool withFigures) const {
+  auto json = Index::toJson(zone, withFigures);
+
+  // ttl indexes are always non-unique and sparse
+  json("expireAfter", triagens::basics::Json(zone, _expireAfter))
+      ("unique", triagens::basics::Json(zone, false))
+      ("sparse", triagens::basics::Json(zone, true));
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index figures
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json TtlIndex::toJsonFigures (TRI_memory_zone_t* zone) const {
+  triagens::basics::Json json(triagens::basics::Json::Object);
+  json("memory", triagens::basics::Json(static_cast<double>(memory())));
+  _tree->appendToJson(zone, json);
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document into the index
+////////////////////////////////////////////////////////////////////////////////
+
+int TtlIndex::insert (TRI_doc_mptr_t const* doc,
+                      bool) {
+  double expires;
+
+  if (! this->expires(doc, expires)) {
+    // sparse index: no or invalid timestamp
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  TRI_ttl_element_t* element = new (std::nothrow) TRI_ttl_element_t;
+
+  if (element == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  element->_expires = expires;
+  element->_document = doc;
+
+  int res = _tree->insert(element);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // the tree has not taken over the element
+    delete element;
+
+    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED) {
+      // the document is indexed already
+      res = TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document from the index
+////////////////////////////////////////////////////////////////////////////////
+
+int TtlIndex::remove (TRI_doc_mptr_t const* doc,
+                      bool) {
+  TRI_ttl_element_t element;
+
+  if (! expires(doc, element._expires)) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  element._document = doc;
+
+  // the tree frees its own element. ignore elements that are not found
+  _tree->remove(&element);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether any document has expired at the given time
+////////////////////////////////////////////////////////////////////////////////
+
+bool TtlIndex::hasExpired (double now) const {
+  auto pos = _tree->begin();
+
+  return (! pos.isEnd() && _tree->at(pos)->_expires <= now);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends at most the given number of expired documents
+////////////////////////////////////////////////////////////////////////////////
+
+void TtlIndex::expired (double now,
+                        size_t limit,
+                        std::vector<TRI_doc_mptr_t const*>& result) const {
+  auto pos = _tree->begin();
+
+  while (limit > 0 && ! pos.isEnd()) {
+    TRI_ttl_element_t const* element = _tree->at(pos);
+
+    if (element->_expires > now) {
+      break;
+    }
+
+    result.emplace_back(element->_document);
+    --limit;
+
+    _tree->next(pos);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the expiration time of a document
+////////////////////////////////////////////////////////////////////////////////
+
+bool TtlIndex::expires (TRI_doc_mptr_t const* doc,
+                        double& expires) const {
+  auto shaper = _collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, doc->getDataPtr());  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  double timestamp;
+
+  if (! GeoIndex2::extractDoubleObject(shaper, &shapedJson, _path, &timestamp) ||
+      timestamp != timestamp) {
+    return false;
+  }
+
+  expires = timestamp + _expireAfter;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
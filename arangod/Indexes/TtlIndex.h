@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time-to-live index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_INDEXES_TTL_INDEX_H
+#define ARANGODB_INDEXES_TTL_INDEX_H 1
+
+#include "Basics/Common.h"
+#include "Basics/BTree.h"
+#include "Indexes/Index.h"
+#include "VocBase/shaped-json.h"
+#include "VocBase/vocbase.h"
+#include "VocBase/voc-types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an element of a ttl index
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_ttl_element_t {
+  double                _expires;
+  TRI_doc_mptr_t const* _document;
+};
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    class TtlIndex
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an index on a timestamp attribute, sorted by expiration time
+///
+/// the indexed attribute holds a number of seconds since the epoch. a
+/// document expires expireAfter seconds after that timestamp, and the
+/// cleanup thread removes expired documents. the index is sparse, documents
+/// without a numeric timestamp are not indexed and never expire.
+////////////////////////////////////////////////////////////////////////////////
+
+    class TtlIndex final : public Index {
+
+      typedef triagens::basics::BTree<double, TRI_ttl_element_t> TRI_TtlTree;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        TtlIndex () = delete;
+
+        TtlIndex (TRI_idx_iid_t,
+                  struct TRI_document_collection_t*,
+                  std::vector<std::vector<triagens::basics::AttributeName>> const&,
+                  TRI_shape_pid_t,
+                  double);
+
+        ~TtlIndex ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+        IndexType type () const override final {
+          return Index::TRI_IDX_TYPE_TTL_INDEX;
+        }
+
+        bool isSorted () const override final {
+          return false;
+        }
+
+        bool hasSelectivityEstimate () const override final {
+          return false;
+        }
+
+        bool dumpFields () const override final {
+          return true;
+        }
+
+        size_t memory () const override final;
+
+        triagens::basics::Json toJson (TRI_memory_zone_t*, bool) const override final;
+        triagens::basics::Json toJsonFigures (TRI_memory_zone_t*) const override final;
+
+        int insert (struct TRI_doc_mptr_t const*, bool) override final;
+
+        int remove (struct TRI_doc_mptr_t const*, bool) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of seconds after the timestamp at which a document expires
+////////////////////////////////////////////////////////////////////////////////
+
+        double expireAfter () const {
+          return _expireAfter;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether any document has expired at the given time
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasExpired (double) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends at most the given number of documents that have expired
+/// at the given time, the ones that expired first come first
+////////////////////////////////////////////////////////////////////////////////
+
+        void expired (double,
+                      size_t,
+                      std::vector<TRI_doc_mptr_t const*>&) const;
+
+        bool isSame (TRI_shape_pid_t path,
+                     double expireAfter) const {
+          return (_path == path && _expireAfter == expireAfter);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the expiration time of a document
+////////////////////////////////////////////////////////////////////////////////
+
+        bool expires (TRI_doc_mptr_t const*,
+                      double&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attribute path of the timestamp
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shape_pid_t const _path;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of seconds after the timestamp at which a document expires
+////////////////////////////////////////////////////////////////////////////////
+
+        double const _expireAfter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the documents, sorted by expiration time
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_TtlTree* _tree;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,448 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief vertex-centric edge index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "VertexCentricIndex.h"
+#include "Basics/debugging.h"
+#include "Basics/logging.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an element in the tree
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeElm (TRI_index_element_t* element) {
+  TRI_index_element_t::free(element, TRI_EDGE_INDEX_MEM_ZONE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two vertices, first by collection id, then by key
+////////////////////////////////////////////////////////////////////////////////
+
+static int CompareVertex (TRI_voc_cid_t leftCid,
+                          char const* leftKey,
+                          TRI_voc_cid_t rightCid,
+                          char const* rightKey) {
+  if (leftCid != rightCid) {
+    return leftCid < rightCid ? -1 : 1;
+  }
+
+  int compareResult = strcmp(leftKey, rightKey);
+
+  if (compareResult < 0) {
+    return -1;
+  }
+  else if (compareResult > 0) {
+    return 1;
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a key value with an element value
+////////////////////////////////////////////////////////////////////////////////
+
+static int CompareKeyElement (TRI_shaped_json_t const* left,
+                              TRI_index_element_t const* right,
+                              size_t rightPosition,
+                              VocShaper* shaper) {
+  TRI_ASSERT(nullptr != left);
+  TRI_ASSERT(nullptr != right);
+
+  auto rightSubobjects = right->subObjects();
+
+  return TRI_CompareShapeTypes(nullptr,
+                               nullptr,
+                               left,
+                               shaper,
+                               right->document()->getShapedJsonPtr(),
+                               &rightSubobjects[rightPosition],
+                               nullptr,
+                               shaper);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares the values of two elements at a position
+////////////////////////////////////////////////////////////////////////////////
+
+static int CompareElementElement (TRI_index_element_t const* left,
+                                  TRI_index_element_t const* right,
+                                  size_t position,
+                                  VocShaper* shaper) {
+  TRI_ASSERT(nullptr != left);
+  TRI_ASSERT(nullptr != right);
+
+  auto leftSubobjects = left->subObjects();
+  auto rightSubobjects = right->subObjects();
+
+  return TRI_CompareShapeTypes(left->document()->getShapedJsonPtr(),
+                               &leftSubobjects[position],
+                               nullptr,
+                               shaper,
+                               right->document()->getShapedJsonPtr(),
+                               &rightSubobjects[position],
+                               nullptr,
+                               shaper);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          class VertexCentricIndex
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the index
+///
+/// the first field must be _from or _to. as edges do not store these in
+/// their shaped json, the first value of all elements is null and the
+/// vertex is taken from the edge marker instead
+////////////////////////////////////////////////////////////////////////////////
+
+VertexCentricIndex::VertexCentricIndex (TRI_idx_iid_t iid,
+                                        TRI_document_collection_t* collection,
+                                        std::vector<std::vector<triagens::basics::AttributeName>> const& fields)
+  : PathBasedIndex(iid, collection, fields, false, false, true, nullptr),
+    CmpElmElm(this),
+    CmpKeyElm(this),
+    _isFrom(fields[0][0].name == TRI_VOC_ATTRIBUTE_FROM),
+    _tree(nullptr) {
+
+  TRI_ASSERT(fields.size() >= 2);
+  TRI_ASSERT(! _useExpansion);
+  TRI_ASSERT(_isFrom || fields[0][0].name == TRI_VOC_ATTRIBUTE_TO);
+
+  _tree = new TRI_VertexCentricTree(CmpElmElm, CmpKeyElm, FreeElm, false, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the index
+////////////////////////////////////////////////////////////////////////////////
+
+VertexCentricIndex::~VertexCentricIndex () {
+  delete _tree;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+size_t VertexCentricIndex::memory () const {
+  return _tree->memoryUsage() +
+         static_cast<size_t>(_tree->getNrUsed()) * elementSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json VertexCentricIndex::toJson (TRI_memory_zone_t* zone,
+                                                   bool withFigures) const {
+  auto json = Index::toJson(zone, withFigures);
+
+  json("unique", triagens::basics::Json(zone, false))
+      ("sparse", triagens::basics::Json(zone, false));
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return a JSON representation of the index figures
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::basics::Json VertexCentricIndex::toJsonFigures (TRI_memory_zone_t* zone) const {
+  triagens::basics::Json json(triagens::basics::Json::Object);
+  json("memory", triagens::basics::Json(static_cast<double>(memory())));
+  _tree->appendToJson(zone, json);
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts an edge into the index
+////////////////////////////////////////////////////////////////////////////////
+
+int VertexCentricIndex::insert (TRI_doc_mptr_t const* doc,
+                                bool) {
+  std::vector<TRI_index_element_t*> elements;
+
+  int res = fillElement(elements, doc);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    for (auto& it : elements) {
+      // free all elements to prevent leak
+      TRI_index_element_t::free(it, TRI_EDGE_INDEX_MEM_ZONE);
+    }
+
+    return res;
+  }
+
+  // without expansion, there is exactly one element per edge
+  TRI_ASSERT(elements.size() == 1);
+
+  res = _tree->insert(elements[0]);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // the tree has not taken over the element
+    TRI_index_element_t::free(elements[0], TRI_EDGE_INDEX_MEM_ZONE);
+
+    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED) {
+      // the edge is indexed already
+      res = TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an edge from the index
+////////////////////////////////////////////////////////////////////////////////
+
+int VertexCentricIndex::remove (TRI_doc_mptr_t const* doc,
+                                bool) {
+  std::vector<TRI_index_element_t*> elements;
+
+  int res = fillElement(elements, doc);
+
+  for (auto& it : elements) {
+    if (res == TRI_ERROR_NO_ERROR) {
+      // the tree frees its own copy of the element
+      res = _tree->remove(it);
+    }
+    TRI_index_element_t::free(it, TRI_EDGE_INDEX_MEM_ZONE);
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the edges of a vertex with the given leading values
+////////////////////////////////////////////////////////////////////////////////
+
+void VertexCentricIndex::lookup (TRI_voc_cid_t cid,
+                                 char const* key,
+                                 std::vector<TRI_shaped_json_t const*> const& values,
+                                 std::vector<TRI_doc_mptr_copy_t>& result) const {
+  lookup(cid, key, values, nullptr, false, nullptr, false, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the edges of a vertex with the given leading values and
+/// a range of values for the next attribute
+////////////////////////////////////////////////////////////////////////////////
+
+void VertexCentricIndex::lookup (TRI_voc_cid_t cid,
+                                 char const* key,
+                                 std::vector<TRI_shaped_json_t const*> const& values,
+                                 TRI_shaped_json_t const* lower,
+                                 bool includeLower,
+                                 TRI_shaped_json_t const* upper,
+                                 bool includeUpper,
+                                 std::vector<TRI_doc_mptr_copy_t>& result) const {
+  TRI_ASSERT(key != nullptr);
+  TRI_ASSERT(values.size() + 1 <= numPaths());
+  TRI_ASSERT((lower == nullptr && upper == nullptr) || values.size() + 1 < numPaths());
+
+  // the bounds are appended to the equality values
+  std::vector<TRI_shaped_json_t const*> bounded(values);
+  bounded.emplace_back(nullptr);
+
+  TRI_vertex_centric_key_t prefixKey{ cid, key, values.data(), values.size() };
+  TRI_vertex_centric_key_t boundKey{ cid, key, bounded.data(), bounded.size() };
+
+  TRI_VertexCentricTree::Position pos;
+
+  if (lower != nullptr) {
+    bounded.back() = lower;
+    pos = includeLower ? _tree->lowerBound(&boundKey) : _tree->upperBound(&boundKey);
+  }
+  else {
+    pos = _tree->lowerBound(&prefixKey);
+  }
+
+  if (upper != nullptr) {
+    bounded.back() = upper;
+  }
+
+  while (! pos.isEnd()) {
+    TRI_index_element_t const* element = _tree->at(pos);
+
+    // the end is checked on the elements rather than with a second search,
+    // which also handles an empty range with lower > upper
+    if (upper != nullptr) {
+      int compareResult = CmpKeyElm(&boundKey, element);
+
+      if (compareResult < 0 || (compareResult == 0 && ! includeUpper)) {
+        break;
+      }
+    }
+    else if (CmpKeyElm(&prefixKey, element) != 0) {
+      break;
+    }
+
+    if (result.capacity() == 0) {
+      // edges of a vertex usually come in bulk
+      result.reserve(64);
+    }
+    result.emplace_back(*(element->document()));
+
+    _tree->next(pos);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the indexed vertex of an edge
+////////////////////////////////////////////////////////////////////////////////
+
+void VertexCentricIndex::vertexOf (TRI_doc_mptr_t const* mptr,
+                                   TRI_voc_cid_t& cid,
+                                   char const*& key) const {
+  TRI_df_marker_t const* marker = static_cast<TRI_df_marker_t const*>(mptr->getDataPtrUnchecked());  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  if (_isFrom) {
+    cid = TRI_EXTRACT_MARKER_FROM_CID(marker);
+    key = TRI_EXTRACT_MARKER_FROM_KEY(marker);
+  }
+  else {
+    cid = TRI_EXTRACT_MARKER_TO_CID(marker);
+    key = TRI_EXTRACT_MARKER_TO_KEY(marker);
+  }
+
+  TRI_ASSERT(key != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a key with an element in the preorder
+////////////////////////////////////////////////////////////////////////////////
+
+int VertexCentricIndex::KeyElementComparator::operator() (TRI_vertex_centric_key_t const* leftKey,
+                                                          TRI_index_element_t const* rightElement) const {
+  TRI_ASSERT(nullptr != leftKey);
+  TRI_ASSERT(nullptr != rightElement);
+
+  TRI_voc_cid_t rightCid;
+  char const* rightVertexKey;
+  _idx->vertexOf(rightElement->document(), rightCid, rightVertexKey);
+
+  int compareResult = CompareVertex(leftKey->_cid, leftKey->_key, rightCid, rightVertexKey);
+
+  if (compareResult != 0) {
+    return compareResult;
+  }
+
+  auto shaper = _idx->_collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  // the key may contain fewer values than there are indexed attributes.
+  // value j belongs to index field j + 1, as field 0 is the vertex
+  for (size_t j = 0; j < leftKey->_numValues; ++j) {
+    compareResult = CompareKeyElement(leftKey->_values[j], rightElement, j + 1, shaper);
+
+    if (compareResult != 0) {
+      return compareResult;
+    }
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two elements: by vertex, the attribute values and, in
+/// the proper total order, the edge key
+////////////////////////////////////////////////////////////////////////////////
+
+int VertexCentricIndex::ElementElementComparator::operator() (TRI_index_element_t const* leftElement,
+                                                              TRI_index_element_t const* rightElement,
+                                                              triagens::basics::SkipListCmpType cmptype) const {
+  TRI_ASSERT(nullptr != leftElement);
+  TRI_ASSERT(nullptr != rightElement);
+
+  if (leftElement == rightElement ||
+      leftElement->document() == rightElement->document()) {
+    return 0;
+  }
+
+  TRI_voc_cid_t leftCid;
+  TRI_voc_cid_t rightCid;
+  char const* leftVertexKey;
+  char const* rightVertexKey;
+  _idx->vertexOf(leftElement->document(), leftCid, leftVertexKey);
+  _idx->vertexOf(rightElement->document(), rightCid, rightVertexKey);
+
+  int compareResult = CompareVertex(leftCid, leftVertexKey, rightCid, rightVertexKey);
+
+  if (compareResult != 0) {
+    return compareResult;
+  }
+
+  auto shaper = _idx->_collection->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  for (size_t j = 1; j < _idx->numPaths(); ++j) {
+    compareResult = CompareElementElement(leftElement, rightElement, j, shaper);
+
+    if (compareResult != 0) {
+      return compareResult;
+    }
+  }
+
+  if (triagens::basics::SKIPLIST_CMP_PREORDER == cmptype) {
+    return 0;
+  }
+
+  // break the tie by the edge key
+  compareResult = strcmp(TRI_EXTRACT_MARKER_KEY(leftElement->document()),    // ONLY IN INDEX, PROTECTED by RUNTIME
+                         TRI_EXTRACT_MARKER_KEY(rightElement->document()));  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  if (compareResult < 0) {
+    return -1;
+  }
+  else if (compareResult > 0) {
+    return 1;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
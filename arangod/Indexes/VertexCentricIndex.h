@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief vertex-centric edge index
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_INDEXES_VERTEX_CENTRIC_INDEX_H
+#define ARANGODB_INDEXES_VERTEX_CENTRIC_INDEX_H 1
+
+#include "Basics/Common.h"
+#include "Basics/BTree.h"
+#include "Indexes/PathBasedIndex.h"
+#include "VocBase/shaped-json.h"
+#include "VocBase/vocbase.h"
+#include "VocBase/voc-types.h"
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup key for a vertex-centric index: the vertex and the values
+/// of the first _numValues indexed attributes
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_vertex_centric_key_t {
+  TRI_voc_cid_t                   _cid;
+  char const*                     _key;
+  TRI_shaped_json_t const* const* _values;
+  size_t                          _numValues;
+};
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          class VertexCentricIndex
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a sorted index on (_from, attributes...) or (_to, attributes...)
+/// of an edge collection
+///
+/// the first field of the index is _from or _to, the others are regular
+/// attributes. all edges of a vertex are stored next to each other, sorted
+/// by the attribute values, so that the edges of a vertex with given values
+/// for the leading attributes, or with a range of values for the next
+/// attribute, can be found without looking at the vertex's other edges.
+/// the index is neither unique nor sparse, documents missing an attribute
+/// are indexed with null
+////////////////////////////////////////////////////////////////////////////////
+
+    class VertexCentricIndex final : public PathBasedIndex {
+
+      struct KeyElementComparator {
+        int operator() (TRI_vertex_centric_key_t const* leftKey,
+                        TRI_index_element_t const* rightElement) const;
+
+        explicit KeyElementComparator (VertexCentricIndex* idx) {
+          _idx = idx;
+        }
+
+        private:
+          VertexCentricIndex* _idx;
+
+      };
+
+      struct ElementElementComparator {
+        int operator() (TRI_index_element_t const* leftElement,
+                        TRI_index_element_t const* rightElement,
+                        triagens::basics::SkipListCmpType cmptype) const;
+
+        explicit ElementElementComparator (VertexCentricIndex* idx) {
+          _idx = idx;
+        }
+
+        private:
+          VertexCentricIndex* _idx;
+
+      };
+
+      friend struct KeyElementComparator;
+      friend struct ElementElementComparator;
+
+      typedef triagens::basics::BTree<TRI_vertex_centric_key_t, TRI_index_element_t> TRI_VertexCentricTree;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        VertexCentricIndex () = delete;
+
+        VertexCentricIndex (TRI_idx_iid_t,
+                            struct TRI_document_collection_t*,
+                            std::vector<std::vector<triagens::basics::AttributeName>> const&);
+
+        ~VertexCentricIndex ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+        IndexType type () const override final {
+          return Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX;
+        }
+
+        bool isSorted () const override final {
+          return true;
+        }
+
+        bool hasSelectivityEstimate () const override final {
+          return false;
+        }
+
+        size_t memory () const override final;
+
+        triagens::basics::Json toJson (TRI_memory_zone_t*, bool) const override final;
+        triagens::basics::Json toJsonFigures (TRI_memory_zone_t*) const override final;
+
+        int insert (struct TRI_doc_mptr_t const*, bool) override final;
+
+        int remove (struct TRI_doc_mptr_t const*, bool) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the index is on _from (outbound edges) or on _to
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isFrom () const {
+          return _isFrom;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the edges of a vertex with the given values for the
+/// leading attributes
+///
+/// the values are compared in the index order, i.e. the result may contain
+/// edges whose values are equal but not identical to the ones given, e.g.
+/// numbers of different representation. the caller must hold the
+/// collection's read lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void lookup (TRI_voc_cid_t,
+                     char const*,
+                     std::vector<TRI_shaped_json_t const*> const&,
+                     std::vector<TRI_doc_mptr_copy_t>&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the edges of a vertex with the given values for the
+/// leading attributes and a value in a range for the following attribute
+///
+/// each bound may be a nullptr for an open range. the edges are returned in
+/// the order of the range attribute
+////////////////////////////////////////////////////////////////////////////////
+
+        void lookup (TRI_voc_cid_t,
+                     char const*,
+                     std::vector<TRI_shaped_json_t const*> const&,
+                     TRI_shaped_json_t const*,
+                     bool,
+                     TRI_shaped_json_t const*,
+                     bool,
+                     std::vector<TRI_doc_mptr_copy_t>&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the zone the index elements are accounted in
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* elementMemoryZone () const override final {
+          return TRI_EDGE_INDEX_MEM_ZONE;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the indexed vertex of an edge
+////////////////////////////////////////////////////////////////////////////////
+
+        void vertexOf (TRI_doc_mptr_t const*,
+                       TRI_voc_cid_t&,
+                       char const*&) const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        ElementElementComparator CmpElmElm;
+
+        KeyElementComparator CmpKeyElm;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the first index field is _from
+////////////////////////////////////////////////////////////////////////////////
+
+        bool const _isFrom;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the actual tree
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_VertexCentricTree* _tree;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
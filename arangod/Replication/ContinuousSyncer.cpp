@@ -32,6 +32,7 @@
 #include "Basics/Exceptions.h"
 #include "Basics/json.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/ScopeGuard.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/WriteLocker.h"
 #include "Rest/HttpRequest.h"
@@ -39,6 +40,7 @@
 #include "SimpleHttpClient/GeneralClientConnection.h"
 #include "SimpleHttpClient/SimpleHttpClient.h"
 #include "SimpleHttpClient/SimpleHttpResult.h"
+#include "Statistics/statistics.h"
 #include "Utils/CollectionGuard.h"
 #include "Utils/transactions.h"
 #include "VocBase/document-collection.h"
@@ -46,12 +48,39 @@
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
 
+#include <thread>
+
 using namespace std;
 using namespace triagens::basics;
 using namespace triagens::rest;
 using namespace triagens::arango;
 using namespace triagens::httpclient;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time (in seconds) the master may wait for new log entries before
+/// it responds to a logger-follow request
+////////////////////////////////////////////////////////////////////////////////
+
+static double const LongPollWait = 1.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of collections that standalone operations are
+/// applied to at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const MaxParallelism = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of standalone operations that are collected before
+/// they are applied
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxPendingDocuments = 10000;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -75,7 +104,9 @@ ContinuousSyncer::ContinuousSyncer (TRI_server_t* server,
     _includeSystem(configuration->_includeSystem),
     _requireFromPresent(configuration->_requireFromPresent),
     _verbose(configuration->_verbose),
+    _parallelism(configuration->_applyParallelism),
     _masterIs27OrHigher(false),
+    _masterIs28OrHigher(false),
     _hasWrittenState(false) {
 
   uint64_t c = configuration->_chunkSize;
@@ -87,6 +118,13 @@ ContinuousSyncer::ContinuousSyncer (TRI_server_t* server,
 
   _chunkSize = StringUtils::itoa(c);
 
+  if (_parallelism == 0) {
+    _parallelism = 1;
+  }
+  else if (_parallelism > MaxParallelism) {
+    _parallelism = MaxParallelism;
+  }
+
   if (configuration->_restrictType == "include") {
     _restrictType = RESTRICT_INCLUDE;
   }
@@ -170,6 +208,8 @@ int ContinuousSyncer::run () {
   if (res == TRI_ERROR_NO_ERROR) {
     _masterIs27OrHigher = (_masterInfo._majorVersion > 2 || 
                            (_masterInfo._majorVersion == 2 && _masterInfo._minorVersion >= 7));
+    _masterIs28OrHigher = (_masterInfo._majorVersion > 2 || 
+                           (_masterInfo._majorVersion == 2 && _masterInfo._minorVersion >= 8));
     if (_requireFromPresent && ! _masterIs27OrHigher) {
       LOG_WARNING("requireFromPresent feature is not supported on master server < ArangoDB 2.7");
     }
@@ -370,21 +410,21 @@ int ContinuousSyncer::getLocalState (string& errorMsg) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief inserts a document, based on the JSON provided
+/// @brief returns the local collection id for a document operation
 ////////////////////////////////////////////////////////////////////////////////
 
-int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
-                                       TRI_json_t const* json,
-                                       string& errorMsg) {
+TRI_voc_cid_t ContinuousSyncer::documentCollectionId (TRI_json_t const* json,
+                                                      bool& isSystem) const {
   // extract "cid"
   TRI_voc_cid_t cid = getCid(json);
 
+  isSystem = false;
+
   if (cid == 0) {
-    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+    return 0;
   }
 
   // extract optional "cname"
-  bool isSystem = false;
   TRI_json_t const* cnameJson = JsonHelper::getObjectElement(json, "cname");
 
   if (JsonHelper::isString(cnameJson)) {
@@ -401,6 +441,18 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
     }
   }
 
+  return cid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies a document operation in an existing transaction
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyDocument (TRI_transaction_collection_t* trxCollection,
+                                     TRI_replication_operation_e type,
+                                     TRI_json_t const* json,
+                                     bool isSystem,
+                                     string& errorMsg) {
   // extract "key"
   TRI_json_t const* keyJson = JsonHelper::getObjectElement(json, "key");
 
@@ -423,6 +475,35 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
   // extract "data"
   TRI_json_t const* doc = JsonHelper::getObjectElement(json, "data");
 
+  int res = applyCollectionDumpMarker(trxCollection,
+                                      type,
+                                      (const TRI_voc_key_t) keyJson->_value._string.data,
+                                      rid,
+                                      doc,
+                                      errorMsg);
+
+  if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
+    // ignore unique constraint violations for system collections
+    res = TRI_ERROR_NO_ERROR;
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a document, based on the JSON provided
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
+                                       TRI_json_t const* json,
+                                       string& errorMsg) {
+  bool isSystem;
+  TRI_voc_cid_t const cid = documentCollectionId(json, isSystem);
+
+  if (cid == 0) {
+    return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
+  }
+
   // extract "tid"
   string const id = JsonHelper::getStringValue(json, "tid", "");
   TRI_voc_tid_t tid;
@@ -457,19 +538,7 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
       return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
     }
 
-    int res = applyCollectionDumpMarker(trxCollection,
-                                        type,
-                                        (const TRI_voc_key_t) keyJson->_value._string.data,
-                                        rid,
-                                        doc,
-                                        errorMsg);
-
-    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
-      // ignore unique constraint violations for system collections
-      res = TRI_ERROR_NO_ERROR;
-    }
-
-    return res;
+    return applyDocument(trxCollection, type, json, isSystem, errorMsg);
   }
 
   else {
@@ -491,17 +560,7 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
       return TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND;
     }
 
-    res = applyCollectionDumpMarker(trxCollection,
-                                    type,
-                                    (const TRI_voc_key_t) keyJson->_value._string.data,
-                                    rid,
-                                    doc,
-                                    errorMsg);
-    
-    if (res == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED && isSystem) {
-      // ignore unique constraint violations for system collections
-      res = TRI_ERROR_NO_ERROR;
-    }
+    res = applyDocument(trxCollection, type, json, isSystem, errorMsg);
 
     res = trx.finish(res);
 
@@ -509,6 +568,207 @@ int ContinuousSyncer::processDocument (TRI_replication_operation_e type,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies pending document operations of one collection in a single
+/// transaction
+///
+/// errors are counted against the number of errors to ignore, which is shared
+/// by all collections and protected by the lock. if an error cannot be
+/// ignored, the whole transaction is aborted
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyPendingDocuments (std::vector<PendingDocument const*> const& operations,
+                                             uint64_t& ignoreCount,
+                                             std::mutex& ignoreLock,
+                                             string& errorMsg) {
+  TRI_ASSERT(! operations.empty());
+
+  SingleCollectionWriteTransaction<UINT64_MAX> trx(new StandaloneTransactionContext(), _vocbase, operations[0]->cid);
+
+  int res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    errorMsg = "unable to create replication transaction: " + string(TRI_errno_string(res));
+
+    return res;
+  }
+
+  TRI_transaction_collection_t* trxCollection = trx.trxCollection();
+
+  if (trxCollection == nullptr) {
+    return trx.finish(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND);
+  }
+
+  for (auto const& it : operations) {
+    string msg;
+    res = applyDocument(trxCollection, it->type, it->json, it->isSystem, msg);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      continue;
+    }
+
+    if (msg.empty()) {
+      msg = TRI_errno_string(res);
+    }
+
+    std::lock_guard<std::mutex> locker(ignoreLock);
+
+    if (ignoreCount == 0) {
+      if (it->lineLength > 256) {
+        msg += ", offending marker: " + std::string(it->line, 256) + "...";
+      }
+      else {
+        msg += ", offending marker: " + std::string(it->line, it->lineLength);
+      }
+
+      errorMsg = msg;
+
+      return trx.finish(res);
+    }
+
+    ignoreCount--;
+    LOG_WARNING("ignoring replication error for database '%s': %s",
+                _applier->databaseName(),
+                msg.c_str());
+  }
+
+  return trx.finish(TRI_ERROR_NO_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies all pending document operations
+///
+/// the operations are grouped by collection, keeping their order within each
+/// collection. each group is applied in one local transaction, and up to
+/// _parallelism groups are applied at the same time. as standalone operations
+/// on different collections do not depend on each other, this yields the
+/// same state as applying them one by one. if a group fails, the ticks are
+/// not advanced, so all pending operations are applied again after a restart
+////////////////////////////////////////////////////////////////////////////////
+
+int ContinuousSyncer::applyPendingDocuments (std::vector<PendingDocument>& pending,
+                                             TRI_voc_tick_t firstRegularTick,
+                                             uint64_t& ignoreCount,
+                                             string& errorMsg) {
+  if (pending.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::vector<std::vector<PendingDocument const*>> groups;
+  std::unordered_map<TRI_voc_cid_t, size_t> positions;
+  TRI_voc_tick_t maxTick = 0;
+
+  for (auto const& it : pending) {
+    auto position = positions.find(it.cid);
+
+    if (position == positions.end()) {
+      positions.emplace(it.cid, groups.size());
+      groups.emplace_back(std::vector<PendingDocument const*>({ &it }));
+    }
+    else {
+      groups[(*position).second].emplace_back(&it);
+    }
+
+    if (it.tick > maxTick) {
+      maxTick = it.tick;
+    }
+  }
+
+  std::atomic<size_t> next(0);
+  std::mutex resultLock;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&] () -> void {
+    while (true) {
+      size_t const i = next++;
+
+      if (i >= groups.size()) {
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> locker(resultLock);
+
+        if (result != TRI_ERROR_NO_ERROR) {
+          return;
+        }
+      }
+
+      string msg;
+      int res;
+
+      try {
+        res = applyPendingDocuments(groups[i], ignoreCount, resultLock, msg);
+      }
+      catch (triagens::basics::Exception const& ex) {
+        res = ex.code();
+      }
+      catch (...) {
+        res = TRI_ERROR_INTERNAL;
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        std::lock_guard<std::mutex> locker(resultLock);
+
+        if (result == TRI_ERROR_NO_ERROR) {
+          result = res;
+          errorMsg = msg;
+        }
+
+        return;
+      }
+    }
+  };
+
+  size_t const numThreads = static_cast<size_t>((std::min)(_parallelism, static_cast<uint64_t>(groups.size())));
+  std::vector<std::thread> threads;
+
+  for (size_t i = 1; i < numThreads; ++i) {
+    try {
+      threads.emplace_back(work);
+    }
+    catch (...) {
+      // go on with the threads we have
+      break;
+    }
+  }
+
+  work();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  size_t const applied = pending.size();
+  pending.clear();
+
+  if (result != TRI_ERROR_NO_ERROR) {
+    return result;
+  }
+
+  // update tick values
+  WRITE_LOCKER_EVENTUAL(_applier->_statusLock, 1000);
+
+  if (maxTick >= firstRegularTick &&
+      maxTick > _applier->_state._lastProcessedContinuousTick) {
+    _applier->_state._lastProcessedContinuousTick = maxTick;
+  }
+
+  if (_applier->_state._lastProcessedContinuousTick > _applier->_state._lastAppliedContinuousTick) {
+    _applier->_state._lastAppliedContinuousTick = _applier->_state._lastProcessedContinuousTick;
+  }
+
+  if (_ongoingTransactions.empty()) {
+    _applier->_state._safeResumeTick = _applier->_state._lastProcessedContinuousTick;
+  }
+
+  LOG_TRACE("applied %llu standalone operations on %llu collections",
+            (unsigned long long) applied,
+            (unsigned long long) groups.size());
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief starts a transaction, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -785,6 +1045,11 @@ int ContinuousSyncer::applyLogMarker (TRI_json_t const* json,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief apply the data from the continuous log
+///
+/// standalone document operations are collected and applied together by
+/// applyPendingDocuments. all other markers, including the operations of
+/// transactions, first apply the pending operations and are then applied in
+/// order, so transaction boundaries and collection changes are kept
 ////////////////////////////////////////////////////////////////////////////////
 
 int ContinuousSyncer::applyLog (SimpleHttpResult* response,
@@ -793,6 +1058,21 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
                                 uint64_t& processedMarkers,
                                 uint64_t& ignoreCount) {
 
+  // lines are parsed into an arena that is reset when no operations are
+  // pending
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(64 * 1024);
+
+  if (zone == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&zone]() -> void {
+      TRI_FreeArenaMemoryZone(zone);
+    }
+  };
+
   StringBuffer& data = response->getBody();
   char* p = data.begin(); 
   char* end = p + data.length();
@@ -800,6 +1080,8 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
   // buffer must end with a NUL byte
   TRI_ASSERT(*end == '\0');
 
+  std::vector<PendingDocument> pending;
+
   while (p < end) {
     char* q = strchr(p, '\n');
 
@@ -812,7 +1094,7 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
     
     if (lineLength < 2) {
       // we are done
-      return TRI_ERROR_NO_ERROR;
+      break;
     }
 
     TRI_ASSERT(q <= end);
@@ -820,7 +1102,11 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
 
     processedMarkers++;
 
-    std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, p));
+    if (pending.empty()) {
+      TRI_ResetArenaMemoryZone(zone);
+    }
+
+    TRI_json_t* json = TRI_JsonString(zone, p);
     
     p = q + 1;
 
@@ -828,7 +1114,7 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
       return TRI_ERROR_OUT_OF_MEMORY;
     }
   
-    if (! TRI_IsObjectJson(json.get())) {
+    if (! TRI_IsObjectJson(json)) {
       errorMsg = "received invalid JSON data";
 
       return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
@@ -836,13 +1122,53 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
 
     int res;
     bool skipped;
-    if (skipMarker(firstRegularTick, json.get())) {
+    if (skipMarker(firstRegularTick, json)) {
       // entry is skipped
       res = TRI_ERROR_NO_ERROR;
       skipped = true;
     }
     else {
-      res = applyLogMarker(json.get(), firstRegularTick, errorMsg);
+      TRI_replication_operation_e const type = static_cast<TRI_replication_operation_e>(JsonHelper::getNumericValue<int>(json, "type", 0));
+
+      if ((type == REPLICATION_MARKER_DOCUMENT || 
+           type == REPLICATION_MARKER_EDGE || 
+           type == REPLICATION_MARKER_REMOVE) &&
+          JsonHelper::getStringValue(json, "tid", "").empty()) {
+        // standalone operation
+        PendingDocument operation;
+        operation.cid = documentCollectionId(json, operation.isSystem);
+
+        if (operation.cid != 0) {
+          string const tick = JsonHelper::getStringValue(json, "tick", "");
+
+          operation.json       = json;
+          operation.line       = lineStart;
+          operation.lineLength = lineLength;
+          operation.tick       = tick.empty() ? 0 : static_cast<TRI_voc_tick_t>(StringUtils::uint64(tick.c_str(), tick.size()));
+          operation.type       = type;
+
+          pending.emplace_back(operation);
+
+          if (pending.size() >= MaxPendingDocuments) {
+            res = applyPendingDocuments(pending, firstRegularTick, ignoreCount, errorMsg);
+
+            if (res != TRI_ERROR_NO_ERROR) {
+              return res;
+            }
+          }
+
+          continue;
+        }
+      }
+
+      // apply the pending operations before anything else
+      res = applyPendingDocuments(pending, firstRegularTick, ignoreCount, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      res = applyLogMarker(json, firstRegularTick, errorMsg);
       skipped = false;
     }
 
@@ -889,7 +1215,7 @@ int ContinuousSyncer::applyLog (SimpleHttpResult* response,
   }
 
   // reached the end      
-  return TRI_ERROR_NO_ERROR;
+  return applyPendingDocuments(pending, firstRegularTick, ignoreCount, errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1015,6 +1341,11 @@ int ContinuousSyncer::runContinuousSync (string& errorMsg) {
         inactiveCycles = 0;
         sleepTime      = 0;
       }
+      else if (_masterIs28OrHigher && masterActive) {
+        // the master has already waited for new log entries, so ask again
+        // right away
+        sleepTime = 0;
+      }
       else {
         if (masterActive) {
           sleepTime = 500 * 1000;
@@ -1045,9 +1376,15 @@ int ContinuousSyncer::runContinuousSync (string& errorMsg) {
 
     // this will make the applier thread sleep if there is nothing to do,
     // but will also check for cancelation
+    double const waitStart = TRI_microtime();
+
     if (! _applier->wait(sleepTime)) {
       return TRI_ERROR_REPLICATION_APPLIER_STOPPED;
     }
+
+    if (sleepTime > 0) {
+      _applier->addWaitTime(TRI_microtime() - waitStart);
+    }
   }
 
   // won't be reached
@@ -1175,7 +1512,8 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
                      "&from=" + StringUtils::itoa(fetchTick) +
                      "&firstRegular=" + StringUtils::itoa(firstRegularTick) + 
                      "&serverId=" + _localServerIdString + 
-                     "&includeSystem=" + (_includeSystem ? "true" : "false");
+                     "&includeSystem=" + (_includeSystem ? "true" : "false") +
+                     (_masterIs28OrHigher ? "&wait=" + StringUtils::ftoa(LongPollWait) : "");
 
   LOG_TRACE("running continuous replication request with from tick %llu, first regular tick %llu, url %s",
             (unsigned long long) fetchTick,
@@ -1211,13 +1549,18 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
     }
   }
 
+  double const fetchStart = TRI_microtime();
+
   std::unique_ptr<SimpleHttpResult> response(
     _client->request(_masterIs27OrHigher ? HttpRequest::HTTP_REQUEST_PUT : HttpRequest::HTTP_REQUEST_GET,
                      url,
                      body.c_str(),
-                     body.size())
+                     body.size(),
+                     CompressionHeaders)
   );
 
+  double const fetchTime = TRI_microtime() - fetchStart;
+
   if (response == nullptr || ! response->isComplete()) {
     errorMsg = "got invalid response from master at " + string(_masterInfo._endpoint) +
                ": " + _client->getErrorMessage();
@@ -1307,9 +1650,25 @@ int ContinuousSyncer::followMasterLog (string& errorMsg,
       lastAppliedTick = _applier->_state._lastAppliedContinuousTick;
     }
 
+    uint64_t const bytesReceived = response->getBody().length();
+    double const applyStart = TRI_microtime();
+
     uint64_t processedMarkers = 0;
     res = applyLog(response.get(), firstRegularTick, errorMsg, processedMarkers, ignoreCount);
 
+    if (res == TRI_ERROR_NO_ERROR) {
+      double const applyTime = TRI_microtime() - applyStart;
+
+      if (processedMarkers > 0) {
+        _applier->addBatch(fetchTime, applyTime, 0.0, bytesReceived, processedMarkers, ! checkMore);
+        TRI_AddReplicationStatistics(fetchTime, applyTime, static_cast<double>(bytesReceived));
+      }
+      else {
+        // an empty response means the master waited for new log entries
+        _applier->addBatch(0.0, applyTime, fetchTime, bytesReceived, 0, ! checkMore);
+      }
+    }
+
     if (processedMarkers > 0) {
       worked = true;
 
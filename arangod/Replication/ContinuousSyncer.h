@@ -35,6 +35,8 @@
 #include "Utils/ReplicationTransaction.h"
 #include "VocBase/replication-applier.h"
 
+#include <mutex>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
 // -----------------------------------------------------------------------------
@@ -64,6 +66,27 @@ namespace triagens {
 
     class ContinuousSyncer : public Syncer {
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a standalone document operation that has been read from the log
+/// but not yet applied
+////////////////////////////////////////////////////////////////////////////////
+
+        struct PendingDocument {
+          struct TRI_json_t const*    json;
+          char const*                 line;
+          size_t                      lineLength;
+          TRI_voc_tick_t              tick;
+          TRI_voc_cid_t               cid;
+          TRI_replication_operation_e type;
+          bool                        isSystem;
+        };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -163,6 +186,23 @@ namespace triagens {
 
         int commitTransaction (struct TRI_json_t const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the local collection id for a document operation
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_cid_t documentCollectionId (struct TRI_json_t const*,
+                                            bool&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies a document operation in an existing transaction
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyDocument (struct TRI_transaction_collection_s*,
+                           TRI_replication_operation_e,
+                           struct TRI_json_t const*,
+                           bool,
+                           std::string&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief process a document operation, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +211,25 @@ namespace triagens {
                              struct TRI_json_t const*,
                              std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies pending document operations of one collection in a single
+/// transaction
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyPendingDocuments (std::vector<PendingDocument const*> const&,
+                                   uint64_t&,
+                                   std::mutex&,
+                                   std::string&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief applies all pending document operations
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyPendingDocuments (std::vector<PendingDocument>&,
+                                   TRI_voc_tick_t,
+                                   uint64_t&,
+                                   std::string&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief renames a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -288,6 +347,13 @@ namespace triagens {
 
         bool _verbose;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of collections that standalone operations are applied to
+/// at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _parallelism;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the master is a 2.7 or higher (and supports some
 /// newer replication APIs)
@@ -295,6 +361,13 @@ namespace triagens {
 
         bool _masterIs27OrHigher;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the master is a 2.8 or higher (and lets logger-follow
+/// requests wait for new log entries)
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _masterIs28OrHigher;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the replication state file has been written at least
 /// once with non-empty values. this is required in situations when the
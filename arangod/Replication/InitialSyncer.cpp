@@ -33,7 +33,9 @@
 #include "Basics/json.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/logging.h"
+#include "Basics/MerkleTree.h"
 #include "Basics/ReadLocker.h"
+#include "Basics/ScopeGuard.h"
 #include "Basics/StringUtils.h"
 #include "Basics/tri-strings.h"
 #include "Indexes/Index.h"
@@ -43,9 +45,15 @@
 #include "Utils/CollectionGuard.h"
 #include "Utils/transactions.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/edge-collection.h"
+#include "VocBase/Legends.h"
+#include "VocBase/replication-dump.h"
+#include "VocBase/ShapeMapper.h"
 #include "VocBase/vocbase.h"
 #include "VocBase/voc-types.h"
 
+#include <thread>
+
 using namespace std;
 using namespace triagens::basics;
 using namespace triagens::arango;
@@ -125,6 +133,8 @@ static bool FindRange (std::vector<TRI_df_marker_t const*> const& markers,
 
 size_t const InitialSyncer::MaxChunkSize = 10 * 1024 * 1024;
 
+uint64_t const InitialSyncer::MaxParallelism = 16;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructor
 ////////////////////////////////////////////////////////////////////////////////
@@ -136,6 +146,8 @@ InitialSyncer::InitialSyncer (TRI_vocbase_t* vocbase,
                               bool verbose) 
   : Syncer(vocbase, configuration),
     _progress("not started"),
+    _progressLock(),
+    _leader(nullptr),
     _restrictCollections(restrictCollections),
     _restrictType(restrictType),
     _processedCollections(),
@@ -144,6 +156,7 @@ InitialSyncer::InitialSyncer (TRI_vocbase_t* vocbase,
     _batchTtl(180),
     _includeSystem(false),
     _chunkSize(configuration->_chunkSize),
+    _parallelism(configuration->_syncParallelism),
     _verbose(verbose),
     _hasFlushed(false) {
 
@@ -154,15 +167,48 @@ InitialSyncer::InitialSyncer (TRI_vocbase_t* vocbase,
     _chunkSize = 128 * 1024;
   }
 
+  if (_parallelism == 0) {
+    _parallelism = 1;
+  }
+  else if (_parallelism > MaxParallelism) {
+    _parallelism = MaxParallelism;
+  }
+
   _includeSystem = configuration->_includeSystem;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor for a worker that dumps collections for a leader
+////////////////////////////////////////////////////////////////////////////////
+
+InitialSyncer::InitialSyncer (InitialSyncer* leader)
+  : InitialSyncer(leader->_vocbase,
+                  &leader->_configuration,
+                  leader->_restrictCollections,
+                  leader->_restrictType,
+                  leader->_verbose) {
+
+  _leader          = leader;
+  _batchId         = leader->_batchId;
+  _batchUpdateTime = leader->_batchUpdateTime;
+  _parallelism     = 1;
+  // the leader has flushed the WAL on the master already
+  _hasFlushed      = true;
+
+  _masterInfo._serverId     = leader->_masterInfo._serverId;
+  _masterInfo._majorVersion = leader->_masterInfo._majorVersion;
+  _masterInfo._minorVersion = leader->_masterInfo._minorVersion;
+  _masterInfo._lastLogTick  = leader->_masterInfo._lastLogTick;
+  _masterInfo._active       = leader->_masterInfo._active;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destructor
 ////////////////////////////////////////////////////////////////////////////////
 
 InitialSyncer::~InitialSyncer () {
-  if (_batchId > 0) {
+  // the batch of a worker belongs to its leader
+  if (_batchId > 0 && _leader == nullptr) {
     sendFinishBatch();
   }
 }
@@ -193,6 +239,8 @@ int InitialSyncer::run (string& errorMsg,
 
   TRI_DEFER(_vocbase->_replicationApplier->allowStart());
 
+  _vocbase->_replicationApplier->startSync();
+
   setProgress("fetching master state");
 
   res = getMasterState(errorMsg);
@@ -233,7 +281,8 @@ int InitialSyncer::run (string& errorMsg,
   std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_GET,
                                                               url,
                                                               nullptr,
-                                                              0));
+                                                              0,
+                                                              CompressionHeaders));
 
   if (response == nullptr || ! response->isComplete()) {
     errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
@@ -281,6 +330,30 @@ int InitialSyncer::run (string& errorMsg,
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set a progress message and add to the dump statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void InitialSyncer::reportProgress (std::string const& message,
+                                    uint64_t bytesReceived,
+                                    uint64_t markersProcessed) {
+  if (_leader != nullptr) {
+    _leader->reportProgress(message, bytesReceived, markersProcessed);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> locker(_progressLock);
+    _progress = message;
+  }
+
+  if (_verbose) {
+    LOG_INFO("synchronization progress: %s", message.c_str());
+  }
+
+  _vocbase->_replicationApplier->setSyncProgress(message.c_str(), bytesReceived, markersProcessed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief send a WAL flush command
 ////////////////////////////////////////////////////////////////////////////////
@@ -477,6 +550,20 @@ int InitialSyncer::applyCollectionDump (TRI_transaction_collection_t* trxCollect
   const string invalidMsg = "received invalid JSON data for collection " +
                             StringUtils::itoa(trxCollection->_cid);
 
+  // lines are parsed into an arena that is reset for each line
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(64 * 1024);
+
+  if (zone == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&zone]() -> void {
+      TRI_FreeArenaMemoryZone(zone);
+    }
+  };
+
   StringBuffer& data = response->getBody();
   char* p = data.begin(); 
   char* end = p + data.length();
@@ -499,11 +586,12 @@ int InitialSyncer::applyCollectionDump (TRI_transaction_collection_t* trxCollect
     TRI_ASSERT(q <= end);
     *q = '\0';
 
-    std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, p));
+    TRI_ResetArenaMemoryZone(zone);
+    TRI_json_t* json = TRI_JsonString(zone, p);
     
     p = q + 1;
 
-    if (! JsonHelper::isObject(json.get())) {
+    if (! JsonHelper::isObject(json)) {
       errorMsg = invalidMsg;
 
       return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
@@ -514,7 +602,7 @@ int InitialSyncer::applyCollectionDump (TRI_transaction_collection_t* trxCollect
     TRI_json_t const* doc = nullptr;
     TRI_voc_rid_t rid     = 0;
 
-    auto objects = &(json.get()->_value._objects);
+    auto objects = &(json->_value._objects);
     size_t const n = TRI_LengthVector(objects);
 
     for (size_t i = 0; i < n; i += 2) {
@@ -573,6 +661,128 @@ int InitialSyncer::applyCollectionDump (TRI_transaction_collection_t* trxCollect
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the data from a binary collection dump
+////////////////////////////////////////////////////////////////////////////////
+
+int InitialSyncer::applyCollectionDumpBinary (TRI_transaction_collection_t* trxCollection,
+                                              SimpleHttpResult* response,
+                                              ShapeMapper& mapper,
+                                              uint64_t& markersProcessed,
+                                              string& errorMsg) {
+
+  const string invalidMsg = "received invalid binary data for collection " +
+                            StringUtils::itoa(trxCollection->_cid);
+
+  StringBuffer& data = response->getBody();
+  char const* p = data.begin();
+  char const* end = p + data.length();
+
+  CollectionNameResolver resolver(_vocbase);
+
+  while (p < end) {
+    if (static_cast<size_t>(end - p) < sizeof(TRI_replication_dump_marker_t)) {
+      errorMsg = invalidMsg;
+
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    auto header = reinterpret_cast<TRI_replication_dump_marker_t const*>(p);
+    size_t const markerSize = TRI_DF_ALIGN_BLOCK(static_cast<size_t>(header->_markerSize));
+    size_t const namesSize = TRI_DF_ALIGN_BLOCK(static_cast<size_t>(header->_namesSize));
+
+    if (header->_size != sizeof(TRI_replication_dump_marker_t) + markerSize + namesSize + header->_legendSize ||
+        header->_markerSize < sizeof(TRI_df_marker_t) ||
+        static_cast<size_t>(end - p) < header->_size) {
+      errorMsg = invalidMsg;
+
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    auto marker = reinterpret_cast<TRI_df_marker_t const*>(p + sizeof(TRI_replication_dump_marker_t));
+    char const* names = reinterpret_cast<char const*>(marker) + markerSize;
+    char const* legend = names + namesSize;
+
+    p += header->_size;
+
+    if (marker->_size != header->_markerSize) {
+      errorMsg = invalidMsg;
+
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    ++markersProcessed;
+
+    if (marker->_type == TRI_DOC_MARKER_KEY_DELETION) {
+      auto m = reinterpret_cast<TRI_doc_deletion_key_marker_t const*>(marker);
+      auto key = const_cast<TRI_voc_key_t>(reinterpret_cast<char const*>(m) + m->_offsetKey);
+
+      int res = applyCollectionDumpMarker(trxCollection, REPLICATION_MARKER_REMOVE, key, m->_rid, nullptr, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      continue;
+    }
+
+    if ((marker->_type != TRI_DOC_MARKER_KEY_DOCUMENT &&
+         marker->_type != TRI_DOC_MARKER_KEY_EDGE) ||
+        header->_legendSize == 0) {
+      errorMsg = invalidMsg;
+
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    auto m = reinterpret_cast<TRI_doc_document_key_marker_t const*>(marker);
+    auto key = const_cast<TRI_voc_key_t>(reinterpret_cast<char const*>(m) + m->_offsetKey);
+
+    TRI_shaped_json_t foreign;
+    TRI_EXTRACT_SHAPED_JSON_MARKER(foreign, marker);
+
+    LegendReader reader(legend);
+    TRI_shaped_json_t* shaped = mapper.translate(&reader, &foreign);
+
+    if (shaped == nullptr) {
+      errorMsg = TRI_errno_string(TRI_ERROR_OUT_OF_MEMORY);
+
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    int res;
+
+    if (marker->_type == TRI_DOC_MARKER_KEY_EDGE) {
+      auto e = reinterpret_cast<TRI_doc_edge_key_marker_t const*>(marker);
+
+      // the names of the _from and _to collections follow the marker
+      char const* fromName = names;
+      char const* toName = (header->_namesSize > 0 ? names + strlen(names) + 1 : names);
+
+      TRI_document_edge_t edge;
+      edge._fromCid = resolver.getCollectionId(fromName);
+      edge._fromKey = const_cast<TRI_voc_key_t>(reinterpret_cast<char const*>(e) + e->_offsetFromKey);
+      edge._toCid   = resolver.getCollectionId(toName);
+      edge._toKey   = const_cast<TRI_voc_key_t>(reinterpret_cast<char const*>(e) + e->_offsetToKey);
+
+      bool const valid = (header->_namesSize > 0 && edge._fromCid != 0 && edge._toCid != 0);
+
+      res = applyCollectionDumpDocument(trxCollection, REPLICATION_MARKER_EDGE, key, m->_rid, shaped, valid ? &edge : nullptr);
+    }
+    else {
+      res = applyCollectionDumpDocument(trxCollection, REPLICATION_MARKER_DOCUMENT, key, m->_rid, shaped, nullptr);
+    }
+
+    TRI_FreeShapedJson(trxCollection->_collection->_collection->getShaper()->memoryZone(), shaped);  // PROTECTED by trx in trxCollection
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  // reached the end
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief incrementally fetch data from a collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -594,20 +804,42 @@ int InitialSyncer::handleCollectionDump (string const& cid,
     _hasFlushed = true;
   }
 
+  if (_masterInfo._majorVersion > 2 ||
+      (_masterInfo._majorVersion == 2 && _masterInfo._minorVersion >= 8)) {
+    // ship the datafile markers and their shapes instead of JSON
+    appendix += "&format=binary";
+  }
+
   uint64_t chunkSize = _chunkSize;
 
   string const baseUrl = BaseUrl +
                          "/dump?collection=" + cid +
                          appendix;
 
+  std::string const typeString = (trxCollection->_collection->_collection->_info._type == TRI_COL_TYPE_EDGE ? "edge" : "document");
+
   TRI_voc_tick_t fromTick = 0;
   int batch = 1;
   uint64_t bytesReceived = 0;
   uint64_t markersProcessed = 0;
+  uint64_t bytesReported = 0;
+  uint64_t markersReported = 0;
 
-  while (true) {
-    sendExtendBatch();
+  // reports the progress and the statistics not yet reported
+  auto report = [&] (std::string const& what) -> void {
+    string const progress = what + " master collection dump for collection '" + collectionName +
+                            "', type: " + typeString + ", id " + cid + ", batch " + StringUtils::itoa(batch) +
+                            ", markers processed: " + StringUtils::itoa(markersProcessed) + 
+                            ", bytes received: " + StringUtils::itoa(bytesReceived);
+
+    reportProgress(progress, bytesReceived - bytesReported, markersProcessed - markersReported);
+
+    bytesReported = bytesReceived;
+    markersReported = markersProcessed;
+  };
 
+  // fetches the chunk starting at fromTick
+  auto fetch = [&] () -> SimpleHttpResult* {
     std::string url = baseUrl + "&from=" + StringUtils::itoa(fromTick);
 
     if (maxTick > 0) {
@@ -616,22 +848,28 @@ int InitialSyncer::handleCollectionDump (string const& cid,
 
     url += "&serverId=" + _localServerIdString;
     url += "&chunkSize=" + StringUtils::itoa(chunkSize);
-  
-    std::string const typeString = (trxCollection->_collection->_collection->_info._type == TRI_COL_TYPE_EDGE ? "edge" : "document");
 
-    // send request
-    string const progress = "fetching master collection dump for collection '" + collectionName +
-                            "', type: " + typeString + ", id " + cid + ", batch " + StringUtils::itoa(batch) +
-                            ", markers processed: " + StringUtils::itoa(markersProcessed) + 
-                            ", bytes received: " + StringUtils::itoa(bytesReceived);
+    try {
+      return _client->request(HttpRequest::HTTP_REQUEST_GET,
+                              url,
+                              nullptr,
+                              0,
+                              CompressionHeaders);
+    }
+    catch (...) {
+      return nullptr;
+    }
+  };
 
-    setProgress(progress.c_str());
+  // translates the shapes of the master for all chunks of the collection
+  ShapeMapper mapper(trxCollection->_collection->_collection->getShaper());  // PROTECTED by trx in trxCollection
 
-    std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_GET,
-                                                                url,
-                                                                nullptr,
-                                                                0));
+  sendExtendBatch();
+  report("fetching");
+
+  std::unique_ptr<SimpleHttpResult> response(fetch());
 
+  while (true) {
     if (response == nullptr || ! response->isComplete()) {
       errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
                  ": " + _client->getErrorMessage();
@@ -682,31 +920,74 @@ int InitialSyncer::handleCollectionDump (string const& cid,
     if (! found) {
       errorMsg = "got invalid response from master at " + string(_masterInfo._endpoint) +
                  ": required header is missing";
-      res = TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
     }
 
-    if (res == TRI_ERROR_NO_ERROR) {
-      res = applyCollectionDump(trxCollection, response.get(), markersProcessed, errorMsg);
+    bool const hasMore = (checkMore && fromTick != 0);
+
+    // the next chunk starts at the last tick of this one. fetch it while this
+    // one is applied
+    std::unique_ptr<SimpleHttpResult> next;
+    std::thread prefetcher;
+
+    if (hasMore) {
+      // increase chunk size for next fetch
+      if (chunkSize < MaxChunkSize) {
+        chunkSize = static_cast<uint64_t>(chunkSize * 1.5);
+        if (chunkSize > MaxChunkSize) {
+          chunkSize = MaxChunkSize;
+        }
+      }
+
+      batch++;
+      sendExtendBatch();
+      report("fetching");
+
+      prefetcher = std::thread([&] () -> void {
+        next.reset(fetch());
+      });
     }
 
-    if (res != TRI_ERROR_NO_ERROR) {
-      return res;
+    try {
+      string const contentType = response->getHeaderField("content-type", found);
+
+      if (contentType.compare(0, strlen(TRI_REPLICATION_DUMP_BINARY_CONTENT_TYPE), TRI_REPLICATION_DUMP_BINARY_CONTENT_TYPE) == 0) {
+        res = applyCollectionDumpBinary(trxCollection, response.get(), mapper, markersProcessed, errorMsg);
+      }
+      else {
+        res = applyCollectionDump(trxCollection, response.get(), markersProcessed, errorMsg);
+      }
+    }
+    catch (...) {
+      if (prefetcher.joinable()) {
+        prefetcher.join();
+      }
+      throw;
     }
 
-    if (! checkMore || fromTick == 0) {
-      // done
+    if (prefetcher.joinable()) {
+      prefetcher.join();
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
       return res;
     }
 
-    // increase chunk size for next fetch
-    if (chunkSize < MaxChunkSize) {
-      chunkSize = static_cast<uint64_t>(chunkSize * 1.5);
-      if (chunkSize > MaxChunkSize) {
-        chunkSize = MaxChunkSize;
+    if (! hasMore) {
+      // done
+      if (mapper.mapped() + mapper.converted() > 0) {
+        LOG_DEBUG("translated shapes of %llu documents for collection '%s' by id, converted %llu",
+                  (unsigned long long) mapper.mapped(),
+                  collectionName.c_str(),
+                  (unsigned long long) mapper.converted());
       }
+
+      report("fetched");
+      return res;
     }
 
-    batch++;
+    response = std::move(next);
   }
 
   TRI_ASSERT(false);
@@ -723,6 +1004,29 @@ int InitialSyncer::handleCollectionSync (std::string const& cid,
                                          TRI_voc_tick_t maxTick,
                                          string& errorMsg) {
 
+  if (_masterInfo._majorVersion > 2 ||
+      (_masterInfo._majorVersion == 2 && _masterInfo._minorVersion >= 8)) {
+    // compare the key trees, which needs no list of all keys
+    int res;
+
+    try {
+      res = handleSyncTree(cid, trx, collectionName, errorMsg);
+    }
+    catch (triagens::basics::Exception const& ex) {
+      res = ex.code();
+    }
+    catch (...) {
+      res = TRI_ERROR_INTERNAL;
+    }
+
+    if (res != TRI_ERROR_NOT_IMPLEMENTED) {
+      return res;
+    }
+
+    // fall back to comparing sorted key chunks
+    errorMsg.clear();
+  }
+
   string const baseUrl = BaseUrl + "/keys";
   string url = baseUrl + "?collection=" + cid + "&to=" + std::to_string(maxTick);
   
@@ -892,7 +1196,8 @@ int InitialSyncer::handleSyncKeys (std::string const& keysId,
   std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_GET,
                                                               url,
                                                               nullptr,
-                                                              0));
+                                                              0,
+                                                              CompressionHeaders));
 
   if (response == nullptr || ! response->isComplete()) {
     errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
@@ -1032,7 +1337,8 @@ int InitialSyncer::handleSyncKeys (std::string const& keysId,
       std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                                   url,
                                                                   nullptr,
-                                                                  0));
+                                                                  0,
+                                                                  CompressionHeaders));
 
       if (response == nullptr || ! response->isComplete()) {
         errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
@@ -1185,7 +1491,8 @@ int InitialSyncer::handleSyncKeys (std::string const& keysId,
         std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                                     url,
                                                                     keyJsonString.c_str(),
-                                                                    keyJsonString.size()));
+                                                                    keyJsonString.size(),
+                                                                    CompressionHeaders));
 
         if (response == nullptr || ! response->isComplete()) {
           errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
@@ -1314,6 +1621,392 @@ int InitialSyncer::handleSyncKeys (std::string const& keysId,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a request for the key tree of a collection to the master
+///
+/// returns TRI_ERROR_NOT_IMPLEMENTED if the master does not know key trees
+////////////////////////////////////////////////////////////////////////////////
+
+int InitialSyncer::sendTreeRequest (std::string const& url,
+                                    std::string const& body,
+                                    std::unique_ptr<TRI_json_t>& json,
+                                    std::string& errorMsg) {
+  std::unique_ptr<SimpleHttpResult> response(_client->request(HttpRequest::HTTP_REQUEST_PUT,
+                                                              url,
+                                                              body.c_str(),
+                                                              body.size(),
+                                                              CompressionHeaders));
+
+  if (response == nullptr || ! response->isComplete()) {
+    errorMsg = "could not connect to master at " + string(_masterInfo._endpoint) +
+               ": " + _client->getErrorMessage();
+
+    return TRI_ERROR_REPLICATION_NO_RESPONSE;
+  }
+
+  if (response->wasHttpError()) {
+    int const code = response->getHttpReturnCode();
+
+    if (code == HttpResponse::BAD ||
+        code == HttpResponse::NOT_FOUND ||
+        code == HttpResponse::METHOD_NOT_ALLOWED ||
+        code == HttpResponse::NOT_IMPLEMENTED) {
+      return TRI_ERROR_NOT_IMPLEMENTED;
+    }
+
+    errorMsg = "got invalid response from master at " + string(_masterInfo._endpoint) +
+               ": HTTP " + StringUtils::itoa(code) +
+               ": " + response->getHttpReturnMessage();
+
+    return TRI_ERROR_REPLICATION_MASTER_ERROR;
+  }
+
+  json.reset(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, response->getBody().c_str()));
+
+  if (json == nullptr) {
+    errorMsg = "got invalid response from master at " + string(_masterInfo._endpoint) +
+               ": invalid JSON";
+
+    return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief incrementally sync a collection by comparing key trees
+///
+/// the trees are compared top-down, several levels per request, so that only
+/// the keys below differing leaves are transferred. this needs neither a
+/// snapshot nor a sorted list of all keys on either side. the master's tree
+/// is not a snapshot either, documents changed during the sync are fixed by
+/// the continuous replication afterwards. returns TRI_ERROR_NOT_IMPLEMENTED
+/// if the master does not provide key trees
+////////////////////////////////////////////////////////////////////////////////
+
+int InitialSyncer::handleSyncTree (std::string const& cid,
+                                   SingleCollectionWriteTransaction<UINT64_MAX>& trx,
+                                   std::string const& collectionName,
+                                   std::string& errorMsg) {
+  typedef triagens::basics::MerkleTree MerkleTree;
+
+  // number of levels compared per request
+  static uint32_t const LevelsPerRequest = 4;
+  // maximum number of nodes, keys or documents per request
+  static size_t const BatchSize = 5000;
+
+  TRI_document_collection_t* document = trx.documentCollection();
+  MerkleTree const* tree = document->_keyTree;  // PROTECTED by trx
+
+  if (tree == nullptr) {
+    return TRI_ERROR_NOT_IMPLEMENTED;
+  }
+
+  std::string const invalidMsg = "got invalid response from master at " + string(_masterInfo._endpoint) +
+                                 ": invalid key tree data for collection '" + collectionName + "'";
+
+  string const baseUrl = BaseUrl + "/tree";
+
+  // fetches the master's nodes on a level, in batches
+  uint32_t remoteDepth = 0;
+
+  auto fetchNodes = [&] (uint32_t level,
+                         std::vector<uint64_t> const& nodes,
+                         std::vector<MerkleTree::Node>& result) -> int {
+    result.clear();
+
+    for (size_t from = 0; from < nodes.size(); from += BatchSize) {
+      size_t const to = (std::min)(from + BatchSize, nodes.size());
+
+      triagens::basics::Json body(triagens::basics::Json::Array, to - from);
+      for (size_t i = from; i < to; ++i) {
+        body.add(triagens::basics::Json(static_cast<double>(nodes[i])));
+      }
+
+      std::unique_ptr<TRI_json_t> json;
+      int res = sendTreeRequest(baseUrl + "?collection=" + cid + "&level=" + std::to_string(level),
+                                JsonHelper::toString(body.json()),
+                                json,
+                                errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      TRI_json_t const* depthJson = TRI_LookupObjectJson(json.get(), "depth");
+      TRI_json_t const* nodesJson = TRI_LookupObjectJson(json.get(), "nodes");
+
+      if (! TRI_IsNumberJson(depthJson) ||
+          ! TRI_IsArrayJson(nodesJson) ||
+          TRI_LengthArrayJson(nodesJson) != to - from) {
+        errorMsg = invalidMsg;
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      remoteDepth = static_cast<uint32_t>(depthJson->_value._number);
+
+      for (size_t i = 0; i < to - from; ++i) {
+        auto pair = static_cast<TRI_json_t const*>(TRI_AtVector(&nodesJson->_value._objects, i));
+
+        if (! TRI_IsArrayJson(pair) || TRI_LengthArrayJson(pair) != 2) {
+          errorMsg = invalidMsg;
+          return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+        }
+
+        auto hashJson = static_cast<TRI_json_t const*>(TRI_AtVector(&pair->_value._objects, 0));
+        auto countJson = static_cast<TRI_json_t const*>(TRI_AtVector(&pair->_value._objects, 1));
+
+        if (! TRI_IsStringJson(hashJson) || ! TRI_IsNumberJson(countJson)) {
+          errorMsg = invalidMsg;
+          return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+        }
+
+        MerkleTree::Node node;
+        node._hash = StringUtils::uint64(hashJson->_value._string.data, hashJson->_value._string.length - 1);
+        node._count = static_cast<uint64_t>(countJson->_value._number);
+        result.emplace_back(node);
+      }
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  };
+
+  setProgress("comparing key tree of collection '" + collectionName + "'");
+
+  // compare the roots
+  std::vector<uint64_t> divergent({ 0 });
+  std::vector<MerkleTree::Node> remote;
+
+  int res = fetchNodes(0, divergent, remote);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  if (remote[0] == tree->node(0, 0)) {
+    // nothing to do
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  // both trees can be compared down to the smaller depth
+  uint32_t const depth = (std::min)(remoteDepth, tree->depth());
+
+  uint32_t level = 0;
+  std::vector<uint64_t> children;
+
+  while (level < depth && ! divergent.empty()) {
+    uint32_t const next = (std::min)(level + LevelsPerRequest, depth);
+    uint32_t const shift = next - level;
+
+    children.clear();
+    for (auto const& it : divergent) {
+      for (uint64_t i = 0; i < (static_cast<uint64_t>(1) << shift); ++i) {
+        children.emplace_back((it << shift) | i);
+      }
+    }
+
+    res = fetchNodes(next, children, remote);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    std::vector<uint64_t> counts;
+    divergent.clear();
+
+    for (size_t i = 0; i < children.size(); ++i) {
+      if (remote[i] != tree->node(next, children[i])) {
+        divergent.emplace_back(children[i]);
+        counts.emplace_back(remote[i]._count);
+      }
+    }
+
+    level = next;
+    remote.clear();
+
+    for (auto const& it : counts) {
+      MerkleTree::Node node;
+      node._hash = 0;
+      node._count = it;
+      remote.emplace_back(node);
+    }
+  }
+
+  setProgress("key tree of collection '" + collectionName + "' differs in " +
+              std::to_string(divergent.size()) + " of " +
+              std::to_string(static_cast<uint64_t>(1) << level) + " buckets");
+
+  // collect the local keys in the differing buckets
+  std::unordered_set<uint64_t> buckets(divergent.begin(), divergent.end());
+  std::unordered_map<std::string, TRI_voc_rid_t> local;
+
+  auto idx = document->primaryIndex();
+
+  {
+    triagens::basics::BucketPosition position;
+    uint64_t total = 0;
+
+    while (true) {
+      auto ptr = idx->lookupSequential(position, total);
+
+      if (ptr == nullptr) {
+        // done
+        break;
+      }
+
+      if (buckets.find(MerkleTree::bucket(level, ptr->_hash)) != buckets.end()) {
+        local.emplace(std::string(TRI_EXTRACT_MARKER_KEY(ptr)), ptr->_rid);  // PROTECTED by trx
+      }
+    }
+  }
+
+  // fetch the master's keys in the differing buckets
+  std::vector<std::string> toFetch;
+
+  size_t from = 0;
+  while (from < divergent.size()) {
+    // the master told us how many keys each bucket holds
+    size_t to = from;
+    uint64_t keys = 0;
+
+    while (to < divergent.size() && (to == from || keys + remote[to]._count <= BatchSize)) {
+      keys += remote[to]._count;
+      ++to;
+    }
+
+    triagens::basics::Json body(triagens::basics::Json::Array, to - from);
+    for (size_t i = from; i < to; ++i) {
+      body.add(triagens::basics::Json(static_cast<double>(divergent[i])));
+    }
+
+    from = to;
+
+    std::unique_ptr<TRI_json_t> json;
+    res = sendTreeRequest(baseUrl + "/keys?collection=" + cid + "&level=" + std::to_string(level),
+                          JsonHelper::toString(body.json()),
+                          json,
+                          errorMsg);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    if (! TRI_IsArrayJson(json.get())) {
+      errorMsg = invalidMsg;
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    size_t const n = TRI_LengthArrayJson(json.get());
+
+    for (size_t i = 0; i < n; ++i) {
+      auto pair = static_cast<TRI_json_t const*>(TRI_AtVector(&json.get()->_value._objects, i));
+
+      if (! TRI_IsArrayJson(pair) || TRI_LengthArrayJson(pair) != 2) {
+        errorMsg = invalidMsg;
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      auto keyJson = static_cast<TRI_json_t const*>(TRI_AtVector(&pair->_value._objects, 0));
+      auto ridJson = static_cast<TRI_json_t const*>(TRI_AtVector(&pair->_value._objects, 1));
+
+      if (! TRI_IsStringJson(keyJson) || ! TRI_IsStringJson(ridJson)) {
+        errorMsg = invalidMsg;
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      std::string key(keyJson->_value._string.data, keyJson->_value._string.length - 1);
+      TRI_voc_rid_t const rid = StringUtils::uint64(ridJson->_value._string.data, ridJson->_value._string.length - 1);
+
+      auto it = local.find(key);
+
+      if (it == local.end() || (*it).second != rid) {
+        toFetch.emplace_back(std::move(key));
+      }
+
+      if (it != local.end()) {
+        local.erase(it);
+      }
+    }
+  }
+
+  // the remaining local keys do not exist on the master. remove them first,
+  // so they cannot violate unique constraints for the fetched documents
+  TRI_doc_update_policy_t policy(TRI_DOC_UPDATE_LAST_WRITE, 0, nullptr);
+
+  for (auto const& it : local) {
+    TRI_RemoveShapedJsonDocumentCollection(trx.trxCollection(), (TRI_voc_key_t) it.first.c_str(), 0, nullptr, &policy, false, false);
+  }
+
+  setProgress("fetching " + std::to_string(toFetch.size()) + " document(s) of collection '" +
+              collectionName + "', removed " + std::to_string(local.size()) + " document(s)");
+
+  bool const isEdge = (document->_info._type == TRI_COL_TYPE_EDGE);
+
+  for (size_t from = 0; from < toFetch.size(); from += BatchSize) {
+    size_t const to = (std::min)(from + BatchSize, toFetch.size());
+
+    triagens::basics::Json body(triagens::basics::Json::Array, to - from);
+    for (size_t i = from; i < to; ++i) {
+      body.add(triagens::basics::Json(toFetch[i]));
+    }
+
+    std::unique_ptr<TRI_json_t> json;
+    res = sendTreeRequest(baseUrl + "/docs?collection=" + cid,
+                          JsonHelper::toString(body.json()),
+                          json,
+                          errorMsg);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    if (! TRI_IsArrayJson(json.get())) {
+      errorMsg = invalidMsg;
+      return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+    }
+
+    size_t const n = TRI_LengthArrayJson(json.get());
+
+    for (size_t i = 0; i < n; ++i) {
+      auto doc = static_cast<TRI_json_t const*>(TRI_AtVector(&json.get()->_value._objects, i));
+
+      if (! TRI_IsObjectJson(doc)) {
+        errorMsg = invalidMsg;
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      auto keyJson = TRI_LookupObjectJson(doc, TRI_VOC_ATTRIBUTE_KEY);
+      auto revJson = TRI_LookupObjectJson(doc, TRI_VOC_ATTRIBUTE_REV);
+
+      if (! TRI_IsStringJson(keyJson) || ! TRI_IsStringJson(revJson)) {
+        errorMsg = invalidMsg;
+        return TRI_ERROR_REPLICATION_INVALID_RESPONSE;
+      }
+
+      TRI_voc_key_t key = keyJson->_value._string.data;
+      TRI_voc_rid_t const rid = StringUtils::uint64(revJson->_value._string.data, revJson->_value._string.length - 1);
+
+      if (isEdge && idx->lookupKey(key) != nullptr) {
+        // an update cannot change _from and _to
+        TRI_RemoveShapedJsonDocumentCollection(trx.trxCollection(), key, 0, nullptr, &policy, false, false);
+      }
+
+      res = applyCollectionDumpMarker(trx.trxCollection(),
+                                      isEdge ? REPLICATION_MARKER_EDGE : REPLICATION_MARKER_DOCUMENT,
+                                      key,
+                                      rid,
+                                      doc,
+                                      errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief changes the properties of a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -1731,7 +2424,7 @@ int InitialSyncer::handleInventoryResponse (TRI_json_t const* json,
   // STEP 4: sync collection data from master and create initial indexes
   // ----------------------------------------------------------------------------------
 
-  return iterateCollections(collections, incremental, errorMsg, PHASE_DUMP);
+  return dumpCollections(collections, incremental, errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1763,6 +2456,118 @@ int InitialSyncer::iterateCollections (std::vector<std::pair<TRI_json_t const*,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dump the collections from an array with multiple workers
+///
+/// the chunks of one collection are chained by their ticks and are fetched
+/// one after the other, so collections are the unit of parallelism. the
+/// leader dumps collections itself, each other worker has its own connection
+/// to the master. all workers use the batch of the leader
+////////////////////////////////////////////////////////////////////////////////
+
+int InitialSyncer::dumpCollections (std::vector<std::pair<TRI_json_t const*, TRI_json_t const*>> const& collections,
+                                    bool incremental,
+                                    std::string& errorMsg) {
+  uint64_t numWorkers = _parallelism;
+
+  if (numWorkers > collections.size()) {
+    numWorkers = collections.size();
+  }
+
+  if (numWorkers <= 1) {
+    return iterateCollections(collections, incremental, errorMsg, PHASE_DUMP);
+  }
+
+  if (! _hasFlushed) {
+    // flush the WAL on the master once, before any of the workers dumps
+    int res = sendFlush(errorMsg);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  std::atomic<size_t> nextCollection(0);
+  std::atomic<bool> failed(false);
+  std::mutex resultLock;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&] (InitialSyncer* syncer) -> void {
+    while (! failed.load()) {
+      size_t const i = nextCollection++;
+
+      if (i >= collections.size()) {
+        return;
+      }
+
+      TRI_json_t const* parameters = collections[i].first;
+      TRI_json_t const* indexes    = collections[i].second;
+
+      TRI_ASSERT(parameters != nullptr);
+      TRI_ASSERT(indexes != nullptr);
+
+      std::string msg;
+      int res;
+
+      try {
+        res = syncer->handleCollection(parameters, indexes, incremental, msg, PHASE_DUMP);
+      }
+      catch (triagens::basics::Exception const& ex) {
+        res = ex.code();
+        msg = ex.what();
+      }
+      catch (...) {
+        res = TRI_ERROR_INTERNAL;
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        std::lock_guard<std::mutex> locker(resultLock);
+
+        if (result == TRI_ERROR_NO_ERROR) {
+          result = res;
+          errorMsg = msg;
+        }
+
+        failed = true;
+        return;
+      }
+    }
+  };
+
+  std::vector<std::unique_ptr<InitialSyncer>> workers;
+  std::vector<std::thread> threads;
+
+  for (uint64_t i = 1; i < numWorkers; ++i) {
+    std::unique_ptr<InitialSyncer> worker(new InitialSyncer(this));
+
+    if (worker->_client == nullptr) {
+      // go on with the workers we have
+      break;
+    }
+
+    try {
+      threads.emplace_back(work, worker.get());
+    }
+    catch (...) {
+      break;
+    }
+
+    workers.emplace_back(std::move(worker));
+  }
+
+  std::string phaseMsg("starting phase " + translatePhase(PHASE_DUMP) + " with " + std::to_string(collections.size()) + 
+                       " collections and " + std::to_string(workers.size() + 1) + " workers");
+  setProgress(phaseMsg); 
+
+  work(this);
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
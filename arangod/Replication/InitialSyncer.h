@@ -34,6 +34,8 @@
 #include "Replication/Syncer.h"
 #include "Utils/transactions.h"
 
+#include <mutex>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
 // -----------------------------------------------------------------------------
@@ -51,6 +53,8 @@ namespace triagens {
 
   namespace arango {
 
+    class ShapeMapper;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                     InitialSyncer
 // -----------------------------------------------------------------------------
@@ -99,6 +103,17 @@ namespace triagens {
 
         ~InitialSyncer ();
 
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor for a worker that dumps collections for a leader
+///
+/// the worker has its own connection to the master and uses the batch of the
+/// leader
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit InitialSyncer (InitialSyncer*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -160,13 +175,19 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         void setProgress (std::string const& message) {
-          _progress = message;
-
-          if (_verbose) {
-            LOG_INFO("synchronization progress: %s", message.c_str());
-          }
+          reportProgress(message, 0, 0);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set a progress message and add to the dump statistics
+///
+/// workers report to their leader, the leader reports to the applier state
+////////////////////////////////////////////////////////////////////////////////
+
+        void reportProgress (std::string const&,
+                             uint64_t,
+                             uint64_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief send a WAL flush command
 ////////////////////////////////////////////////////////////////////////////////
@@ -200,6 +221,16 @@ namespace triagens {
                                  uint64_t&,
                                  std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the data from a binary collection dump
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyCollectionDumpBinary (struct TRI_transaction_collection_s*,
+                                       httpclient::SimpleHttpResult*,
+                                       ShapeMapper&,
+                                       uint64_t&,
+                                       std::string&);
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief incrementally fetch data from a collection
@@ -232,6 +263,24 @@ namespace triagens {
                             TRI_voc_tick_t,
                             std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a request for the key tree of a collection to the master
+////////////////////////////////////////////////////////////////////////////////
+
+        int sendTreeRequest (std::string const&,
+                             std::string const&,
+                             std::unique_ptr<struct TRI_json_t>&,
+                             std::string&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief incrementally sync a collection by comparing key trees
+////////////////////////////////////////////////////////////////////////////////
+
+        int handleSyncTree (std::string const&,
+                            SingleCollectionWriteTransaction<UINT64_MAX>&,
+                            std::string const&,
+                            std::string&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief changes the properties of a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -266,6 +315,14 @@ namespace triagens {
                                 std::string&,
                                 sync_phase_e);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dump the collections from an array with multiple workers
+////////////////////////////////////////////////////////////////////////////////
+
+        int dumpCollections (std::vector<std::pair<struct TRI_json_t const*, struct TRI_json_t const*>> const&,
+                             bool,
+                             std::string&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -278,6 +335,19 @@ namespace triagens {
 
         std::string _progress;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the progress message, the workers report concurrently
+////////////////////////////////////////////////////////////////////////////////
+
+        std::mutex _progressLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the syncer this worker dumps collections for, nullptr if this is
+/// not a worker
+////////////////////////////////////////////////////////////////////////////////
+
+        InitialSyncer* _leader;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief collection restriction
 ////////////////////////////////////////////////////////////////////////////////
@@ -326,6 +396,12 @@ namespace triagens {
 
         uint64_t _chunkSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of collections to dump at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _parallelism;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief verbosity
 ////////////////////////////////////////////////////////////////////////////////
@@ -343,6 +419,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         static size_t const MaxChunkSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of collections to dump at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const MaxParallelism;
     };
 
   }
@@ -65,6 +65,15 @@ using namespace triagens::httpclient;
 
 const std::string Syncer::BaseUrl = "/_api/replication";
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request headers for fetching dumps and logs, which allow the
+/// master to send them compressed
+////////////////////////////////////////////////////////////////////////////////
+
+const std::map<std::string, std::string> Syncer::CompressionHeaders = { 
+  { "Accept-Encoding", "deflate" } 
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -226,71 +235,28 @@ int Syncer::applyCollectionDumpMarker (TRI_transaction_collection_t* trxCollecti
       return TRI_ERROR_OUT_OF_MEMORY;
     }
 
-    try {
-      TRI_doc_mptr_copy_t mptr;
-
-      bool const isLocked = TRI_IsLockedCollectionTransaction(trxCollection);
-      int res = TRI_ReadShapedJsonDocumentCollection(trxCollection, key, &mptr, ! isLocked);
-
-      if (res == TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND) {
-        // insert
-
-        if (type == REPLICATION_MARKER_EDGE) {
-          // edge
-          if (document->_info._type != TRI_COL_TYPE_EDGE) {
-            res = TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID;
-          }
-          else {
-            res = TRI_ERROR_NO_ERROR;
-          }
-
-          string const from = JsonHelper::getStringValue(json, TRI_VOC_ATTRIBUTE_FROM, "");
-          string const to   = JsonHelper::getStringValue(json, TRI_VOC_ATTRIBUTE_TO, "");
-
-          CollectionNameResolver resolver(_vocbase);
-
-          // parse _from
-          TRI_document_edge_t edge;
-          if (! DocumentHelper::parseDocumentId(resolver, from.c_str(), edge._fromCid, &edge._fromKey)) {
-            res = TRI_ERROR_ARANGO_DOCUMENT_HANDLE_BAD;
-          }
-
-          // parse _to
-          if (! DocumentHelper::parseDocumentId(resolver, to.c_str(), edge._toCid, &edge._toKey)) {
-            res = TRI_ERROR_ARANGO_DOCUMENT_HANDLE_BAD;
-          }
-
-          if (res == TRI_ERROR_NO_ERROR) {
-            res = TRI_InsertShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, &edge, ! isLocked, false, true);
-          }
-        }
-        else {
-          // document
-          if (document->_info._type != TRI_COL_TYPE_DOCUMENT) {
-            res = TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID;
-          }
-          else {
-            res = TRI_InsertShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, nullptr, ! isLocked, false, true);
-          }
-        }
-      }
-      else {
-        // update
-        res = TRI_UpdateShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, &_policy, ! isLocked, false);
-      }
+    int res;
 
-      TRI_FreeShapedJson(zone, shaped);
+    if (type == REPLICATION_MARKER_EDGE) {
+      string const from = JsonHelper::getStringValue(json, TRI_VOC_ATTRIBUTE_FROM, "");
+      string const to   = JsonHelper::getStringValue(json, TRI_VOC_ATTRIBUTE_TO, "");
 
-      return res;
-    }
-    catch (triagens::basics::Exception const& ex) {
-      TRI_FreeShapedJson(zone, shaped);
-      return ex.code();
+      CollectionNameResolver resolver(_vocbase);
+
+      // parse _from and _to
+      TRI_document_edge_t edge;
+      bool const valid = (DocumentHelper::parseDocumentId(resolver, from.c_str(), edge._fromCid, &edge._fromKey) &&
+                          DocumentHelper::parseDocumentId(resolver, to.c_str(), edge._toCid, &edge._toKey));
+
+      res = applyCollectionDumpDocument(trxCollection, type, key, rid, shaped, valid ? &edge : nullptr);
     }
-    catch (...) {
-      TRI_FreeShapedJson(zone, shaped);
-      return TRI_ERROR_INTERNAL;
+    else {
+      res = applyCollectionDumpDocument(trxCollection, type, key, rid, shaped, nullptr);
     }
+
+    TRI_FreeShapedJson(zone, shaped);
+
+    return res;
   }
 
   else if (type == REPLICATION_MARKER_REMOVE) {
@@ -328,6 +294,59 @@ int Syncer::applyCollectionDumpMarker (TRI_transaction_collection_t* trxCollecti
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert or update a document or edge from the collection dump
+////////////////////////////////////////////////////////////////////////////////
+
+int Syncer::applyCollectionDumpDocument (TRI_transaction_collection_t* trxCollection,
+                                         TRI_replication_operation_e type,
+                                         const TRI_voc_key_t key,
+                                         const TRI_voc_rid_t rid,
+                                         TRI_shaped_json_t const* shaped,
+                                         TRI_document_edge_t const* edge) {
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+
+  try {
+    TRI_doc_mptr_copy_t mptr;
+
+    bool const isLocked = TRI_IsLockedCollectionTransaction(trxCollection);
+    int res = TRI_ReadShapedJsonDocumentCollection(trxCollection, key, &mptr, ! isLocked);
+
+    if (res == TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND) {
+      // insert
+
+      if (type == REPLICATION_MARKER_EDGE) {
+        // edge
+        if (document->_info._type != TRI_COL_TYPE_EDGE) {
+          return TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID;
+        }
+
+        if (edge == nullptr) {
+          return TRI_ERROR_ARANGO_DOCUMENT_HANDLE_BAD;
+        }
+
+        return TRI_InsertShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, edge, ! isLocked, false, true);
+      }
+
+      // document
+      if (document->_info._type != TRI_COL_TYPE_DOCUMENT) {
+        return TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID;
+      }
+
+      return TRI_InsertShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, nullptr, ! isLocked, false, true);
+    }
+
+    // update
+    return TRI_UpdateShapedJsonDocumentCollection(trxCollection, key, rid, nullptr, &mptr, shaped, &_policy, ! isLocked, false);
+  }
+  catch (triagens::basics::Exception const& ex) {
+    return ex.code();
+  }
+  catch (...) {
+    return TRI_ERROR_INTERNAL;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -394,6 +413,11 @@ int Syncer::createCollection (TRI_json_t const* json,
   params._planId       = 0;
   params._indexBuckets = JsonHelper::getNumericValue<uint32_t>(json, "indexBuckets", (uint32_t) TRI_DEFAULT_INDEX_BUCKETS);
 
+  if (JsonHelper::isArray(JsonHelper::getObjectElement(json, "stringDictionary"))) {
+    // the slave collection stores the same values as dictionary codes
+    params._stringDictionary = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, JsonHelper::getObjectElement(json, "stringDictionary"));
+  }
+
   TRI_voc_cid_t planId = JsonHelper::stringUInt64(json, "planId");
   if (planId > 0) {
     params._planId = planId;
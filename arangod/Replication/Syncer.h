@@ -44,6 +44,7 @@
 
 struct TRI_json_t;
 struct TRI_replication_applier_configuration_s;
+struct TRI_shaped_json_s;
 struct TRI_transaction_collection_s;
 struct TRI_vocbase_t;
 struct TRI_vocbase_col_s;
@@ -120,6 +121,19 @@ namespace triagens {
                                        struct TRI_json_t const*,
                                        std::string&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert or update a document or edge from the collection dump
+///
+/// edge is nullptr for documents and for edges with invalid _from or _to
+////////////////////////////////////////////////////////////////////////////////
+
+        int applyCollectionDumpDocument (struct TRI_transaction_collection_s*,
+                                         TRI_replication_operation_e,
+                                         const TRI_voc_key_t,
+                                         const TRI_voc_rid_t,
+                                         struct TRI_shaped_json_s const*,
+                                         TRI_document_edge_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a collection, based on the JSON provided
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,6 +244,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         static const std::string BaseUrl;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request headers for fetching dumps and logs, which allow the
+/// master to send them compressed
+////////////////////////////////////////////////////////////////////////////////
+
+        static const std::map<std::string, std::string> CompressionHeaders;
     };
 
   }
@@ -29,11 +29,13 @@
 
 #include "RestBaseHandler.h"
 
+#include "Basics/json-binary.h"
 #include "Basics/logging.h"
 #include "Basics/tri-strings.h"
 #include "Basics/StringUtils.h"
 #include "Rest/HttpRequest.h"
 #include "Rest/HttpResponse.h"
+#include "Wal/LogfileManager.h"
 
 using namespace std;
 using namespace triagens::basics;
@@ -85,9 +87,17 @@ void RestBaseHandler::generateResult (TRI_json_t const* json) {
 void RestBaseHandler::generateResult (HttpResponse::HttpResponseCode code,
                                       TRI_json_t const* json) {
   _response = createResponse(code);
-  _response->setContentType("application/json; charset=utf-8");
 
-  int res = TRI_StringifyJson(_response->body().stringBuffer(), json);
+  int res;
+
+  if (_request != nullptr && _request->acceptsBinaryJson()) {
+    _response->setContentType(TRI_BINARY_JSON_CONTENT_TYPE);
+    res = TRI_StringifyBinaryJson(_response->body().stringBuffer(), json);
+  }
+  else {
+    _response->setContentType("application/json; charset=utf-8");
+    res = TRI_StringifyJson(_response->body().stringBuffer(), json);
+  }
 
   if (res != TRI_ERROR_NO_ERROR) {
     generateError(HttpResponse::SERVER_ERROR,
@@ -146,6 +156,12 @@ void RestBaseHandler::generateError (HttpResponse::HttpResponseCode code, int er
   _response = createResponse(code);
   _response->setContentType("application/json; charset=utf-8");
 
+  if (errorCode == TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT) {
+    // tell the client when to try again
+    uint64_t const retryAfter = triagens::wal::LogfileManager::instance()->writeThrottle().retryAfter();
+    _response->setHeader("retry-after", strlen("retry-after"), StringUtils::itoa(retryAfter));
+  }
+
   _response->body().appendText("{\"error\":true,\"errorMessage\":\"");
   if (message.empty()) {
     // prevent empty error messages
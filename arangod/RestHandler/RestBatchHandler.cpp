@@ -31,15 +31,23 @@
 
 #include "Basics/StringUtils.h"
 #include "Basics/logging.h"
+#include "Dispatcher/DispatcherThread.h"
 #include "HttpServer/HttpHandlerFactory.h"
 #include "HttpServer/HttpServer.h"
 #include "Rest/HttpRequest.h"
+#include "Utils/BatchExecution.h"
 
 using namespace std;
 using namespace triagens::basics;
 using namespace triagens::rest;
 using namespace triagens::arango;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of parts executed at once
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxParallelism = 64;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -73,15 +81,30 @@ RestBatchHandler::~RestBatchHandler () {
 /// The multipart batch request, consisting of the envelope and the individual
 /// batch parts.
 ///
+/// @RESTQUERYPARAMETERS
+///
+/// @RESTQUERYPARAM{parallelism,number,optional}
+/// The maximal number of parts executed at the same time, between 1 (the
+/// default) and 64.
+///
 /// @RESTDESCRIPTION
 /// Executes a batch request. A batch request can contain any number of
 /// other requests that can be sent to ArangoDB in isolation. The benefit of
 /// using batch requests is that batching requests requires less client/server
 /// roundtrips than when sending isolated requests.
 ///
-/// All parts of a batch request are executed serially on the server. The
-/// server will return the results of all parts in a single response when all
-/// parts are finished.
+/// By default, all parts of a batch request are executed serially on the
+/// server, and the server will return the results of all parts in a single
+/// response when all parts are finished.
+///
+/// With the URL parameter *parallelism*, several parts are executed at the
+/// same time. A part with the MIME header `X-Arango-Sequential: true` is
+/// only started after all parts before it have finished, and the parts after
+/// it are only started after it has finished. The responses are returned in
+/// the order of the parts nevertheless. When parts are executed in parallel,
+/// the server sends the response with chunked transfer encoding: the
+/// response of a part is sent as soon as it and all parts before it have
+/// finished. The error summary header `x-arango-errors` is not sent then.
 ///
 /// Technically, a batch request is a multipart HTTP request, with
 /// content-type `multipart/form-data`. A batch request consists of an
@@ -206,14 +229,30 @@ HttpHandler::status_t RestBatchHandler::execute () {
 
   LOG_TRACE("boundary of multipart-message is '%s'", boundary.c_str());
 
-  size_t errors = 0;
-
   // get authorization header. we will inject this into the subparts
   string authorization = _request->header("authorization");
 
-  // create the response
-  _response = createResponse(HttpResponse::OK);
-  _response->setContentType(_request->header("content-type"));
+  // number of parts executed at once
+  size_t parallelism = 1;
+  bool found;
+  char const* value = _request->value("parallelism", found);
+
+  if (found) {
+    parallelism = static_cast<size_t>(StringUtils::uint64(value));
+
+    if (parallelism == 0 || parallelism > MaxParallelism) {
+      generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER, "invalid value for 'parallelism'");
+      return status_t(HttpHandler::HANDLER_FAILED);
+    }
+  }
+
+  Dispatcher* dispatcher = nullptr;
+
+  if (parallelism > 1 && DispatcherThread::currentDispatcherThread != nullptr) {
+    dispatcher = DispatcherThread::currentDispatcherThread->dispatcher();
+  }
+
+  auto execution = std::make_shared<BatchExecution>(_server, boundary, parallelism);
 
   // setup some auxiliary structures to parse the multipart message
   MultipartMessage message(boundary.c_str(),
@@ -225,7 +264,8 @@ HttpHandler::status_t RestBatchHandler::execute () {
   helper.message = &message;
   helper.searchStart = (char*) message.messageStart;
 
-  // iterate over all parts of the multipart message
+  // iterate over all parts of the multipart message. all parts are parsed
+  // before the first one is executed
   while (true) {
     // get the next part from the multipart message
     if (! extractPart(&helper)) {
@@ -273,12 +313,6 @@ HttpHandler::status_t RestBatchHandler::execute () {
     LOG_TRACE("part header is: %s", string(headerStart, headerLength).c_str());
     HttpRequest* request = new HttpRequest(_request->connectionInfo(), headerStart, headerLength, _request->compatibility(), false);
 
-    if (request == nullptr) {
-      generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
-
-      return status_t(HttpHandler::HANDLER_FAILED);
-    }
-
     // we do not have a client task id here
     request->setClientTaskId(0);
 
@@ -297,95 +331,48 @@ HttpHandler::status_t RestBatchHandler::execute () {
       request->setHeader("authorization", 13, authorization.c_str());
     }
 
-    HttpHandler* handler = _server->createHandler(request);
-
-    if (! handler) {
-      delete request;
-
-      generateError(HttpResponse::BAD, TRI_ERROR_INTERNAL, "could not create handler for batch part processing");
-
-      return status_t(HttpHandler::HANDLER_FAILED);
-    }
-
-    HttpHandler::status_t status(HttpHandler::HANDLER_FAILED);
-
-    do {
-      handler->prepareExecute();
-      try {
-        status = handler->execute();
-      }
-      catch (triagens::basics::Exception const& ex) {
-        handler->handleError(ex);
-      }
-      catch (std::exception const& ex) {
-        triagens::basics::Exception err(TRI_ERROR_INTERNAL, ex.what(), __FILE__, __LINE__);
-        handler->handleError(err);
-      }
-      catch (...) {
-        triagens::basics::Exception err(TRI_ERROR_INTERNAL, __FILE__, __LINE__);
-        handler->handleError(err);
-      }
-      handler->finalizeExecute();
-    }
-    while (status.status == HttpHandler::HANDLER_REQUEUE);
-
-
-    if (status.status == HttpHandler::HANDLER_FAILED) {
-      // one of the handlers failed, we must exit now
-      delete handler;
-      generateError(HttpResponse::BAD, TRI_ERROR_INTERNAL, "executing a handler for batch part failed");
-
-      return status_t(HttpHandler::HANDLER_FAILED);
-    }
-
-    HttpResponse* partResponse = handler->getResponse();
-
-    if (partResponse == nullptr) {
-      delete handler;
-      generateError(HttpResponse::BAD, TRI_ERROR_INTERNAL, "could not create a response for batch part request");
+    string contentId;
 
-      return status_t(HttpHandler::HANDLER_FAILED);
+    if (helper.contentId != 0) {
+      contentId = string(helper.contentId, helper.contentIdLength);
     }
 
-    const HttpResponse::HttpResponseCode code = partResponse->responseCode();
+    execution->addPart(request, contentId, helper.sequential);
 
-    if (code >= 400) {
-      // error
-      ++errors;
+    if (! helper.containsMore) {
+      // we've read the last part
+      break;
     }
+  } // next part
 
-    // append the boundary for this subpart
-    _response->body().appendText(boundary + "\r\nContent-Type: ");
-    _response->body().appendText(triagens::rest::HttpRequest::BatchContentType);
+  // create the response
+  _response = createResponse(HttpResponse::OK);
+  _response->setContentType(_request->header("content-type"));
 
-    if (helper.contentId != 0) {
-      // append content-id
-      _response->body().appendText("\r\nContent-Id: " + string(helper.contentId, helper.contentIdLength));
-    }
+  uint64_t const taskId = _request->clientTaskId();
 
-    _response->body().appendText(TRI_CHAR_LENGTH_PAIR("\r\n\r\n"));
+  if (dispatcher != nullptr && taskId != 0) {
+    // send the responses of the parts as they finish. the status of the
+    // parts is not known yet, so there is no error summary header
+    _response->setHeader("transfer-encoding", strlen("transfer-encoding"), "chunked");
 
-    // remove some headers we don't need
-    partResponse->setHeader(TRI_CHAR_LENGTH_PAIR("connection"), "");
-    partResponse->setHeader(TRI_CHAR_LENGTH_PAIR("server"), "");
+    // the parts share the context of the batch request, so the execution
+    // keeps the request until all parts have finished
+    execution->stream(dispatcher, stealRequest(), taskId);
 
-    // append the part response header
-    partResponse->writeHeader(&_response->body());
-    // append the part response body
-    _response->body().appendText(partResponse->body());
-    _response->body().appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
+    return status_t(HttpHandler::HANDLER_DONE);
+  }
 
-    delete handler;
+  if (! execution->execute(dispatcher)) {
+    // one of the handlers failed
+    generateError(HttpResponse::BAD, TRI_ERROR_INTERNAL, execution->errorMessage());
 
+    return status_t(HttpHandler::HANDLER_FAILED);
+  }
 
-    if (! helper.containsMore) {
-      // we've read the last part
-      break;
-    }
-  } // next part
+  execution->appendResponse(_response->body());
 
-  // append final boundary + "--"
-  _response->body().appendText(boundary + "--");
+  size_t const errors = execution->errors();
 
   if (errors > 0) {
     _response->setHeader(HttpResponse::BatchErrorHeader, StringUtils::itoa(errors));
@@ -504,6 +491,7 @@ bool RestBatchHandler::extractPart (SearchHelper* helper) {
   helper->containsMore = false;
   helper->contentId = 0;
   helper->contentIdLength = 0;
+  helper->sequential = false;
 
   const char* searchEnd = helper->message->messageEnd;
 
@@ -597,7 +585,7 @@ bool RestBatchHandler::extractPart (SearchHelper* helper) {
     string key(found, colon - found);
     StringUtils::trimInPlace(key);
 
-    if (key[0] == 'c' || key[0] == 'C') {
+    if (key[0] == 'c' || key[0] == 'C' || key[0] == 'x' || key[0] == 'X') {
       // got an interesting key. now process it
       StringUtils::tolowerInPlace(&key);
     
@@ -626,6 +614,12 @@ bool RestBatchHandler::extractPart (SearchHelper* helper) {
         helper->contentId = colon;
         helper->contentIdLength = eol - colon;
       }
+      else if ("x-arango-sequential" == key) {
+        string value(colon, eol - colon);
+        StringUtils::trimInPlace(value);
+
+        helper->sequential = StringUtils::boolean(value);
+      }
       else {
         // ignore other headers
       }
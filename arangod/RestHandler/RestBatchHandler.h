@@ -77,6 +77,7 @@ namespace triagens {
       size_t foundLength;
       char* contentId;
       size_t contentIdLength;
+      bool sequential;
       bool containsMore;
     };
 
@@ -34,6 +34,7 @@
 #include "Basics/json.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/ScopeGuard.h"
+#include "Cluster/ServerState.h"
 #include "Utils/Cursor.h"
 #include "Utils/CursorRepository.h"
 #include "V8Server/ApplicationV8.h"
@@ -133,6 +134,14 @@ void RestCursorHandler::processQuery (TRI_json_t const* json) {
   
   auto options = buildOptions(json);
 
+  if (triagens::basics::JsonHelper::getBooleanValue(options.json(), "stream", false) &&
+      ! triagens::arango::ServerState::instance()->isCoordinator()) {
+    // the coordinator cannot suspend its part of a cluster query, so it
+    // always materializes the result
+    processStreamingQuery(queryString, bindVars, options);
+    return;
+  }
+
   triagens::aql::Query query(_applicationV8, 
                              false, 
                              _vocbase, 
@@ -238,6 +247,69 @@ void RestCursorHandler::processQuery (TRI_json_t const* json) {
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepares the query and returns its first results from a streaming
+/// cursor
+////////////////////////////////////////////////////////////////////////////////
+
+void RestCursorHandler::processStreamingQuery (TRI_json_t const* queryString,
+                                               TRI_json_t const* bindVars,
+                                               triagens::basics::Json const& options) {
+  // the query will outlive the request, so it needs its own copy of the
+  // query string. the string must be destroyed after the query
+  std::unique_ptr<std::string> queryCopy(new std::string(queryString->_value._string.data, queryString->_value._string.length - 1));
+
+  std::unique_ptr<triagens::aql::Query> query(new triagens::aql::Query(
+    _applicationV8, 
+    false, 
+    _vocbase, 
+    queryCopy->c_str(),
+    queryCopy->size(),
+    (bindVars != nullptr ? TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, bindVars) : nullptr),
+    TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, options.json()), 
+    triagens::aql::PART_MAIN
+  ));
+
+  registerQuery(query.get()); 
+  auto queryResult = query->prepare(_queryRegistry);
+  unregisterQuery(); 
+
+  if (queryResult.code != TRI_ERROR_NO_ERROR) {
+    if (queryResult.code == TRI_ERROR_REQUEST_CANCELED ||
+        (queryResult.code == TRI_ERROR_QUERY_KILLED && wasCanceled())) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_REQUEST_CANCELED);
+    }
+
+    THROW_ARANGO_EXCEPTION_MESSAGE(queryResult.code, queryResult.details);
+  }
+
+  _response = createResponse(HttpResponse::CREATED);
+  _response->setContentType("application/json; charset=utf-8");
+
+  auto cursors = static_cast<triagens::arango::CursorRepository*>(_vocbase->_cursorRepository);
+  TRI_ASSERT(cursors != nullptr);
+
+  size_t batchSize = triagens::basics::JsonHelper::getNumericValue<size_t>(options.json(), "batchSize", 1000);
+  double ttl = triagens::basics::JsonHelper::getNumericValue<double>(options.json(), "ttl", 30);
+
+  // the cursor will take over the ownership of the query and the string
+  triagens::arango::QueryCursor* cursor = cursors->createFromQuery(query.release(), queryCopy.release(), batchSize, ttl);
+
+  try {
+    _response->body().appendChar('{');
+    cursor->dump(_response->body());
+    _response->body().appendText(",\"error\":false,\"code\":");
+    _response->body().appendInteger(static_cast<uint32_t>(_response->responseCode()));
+    _response->body().appendChar('}');
+
+    cursors->release(cursor);
+  }
+  catch (...) {
+    cursors->release(cursor);
+    throw;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief register the currently running query
 ////////////////////////////////////////////////////////////////////////////////
@@ -443,8 +515,21 @@ triagens::basics::Json RestCursorHandler::buildExtra (triagens::aql::QueryResult
 ///
 /// @RESTSTRUCT{profile,JSF_post_api_cursor_opts,boolean,optional,}
 /// if set to *true*, then the additional query profiling information
-/// will be returned in the *extra.stats* return attribute if the query result is not
-/// served from the query cache.
+/// will be returned in the *extra.profile* return attribute if the query result is not
+/// served from the query cache. Besides the time spent in each phase of the query,
+/// *extra.profile.plan* contains the executed plan. Each of its nodes has a *profile*
+/// attribute with the number of *calls* made to it, the number of *items* it returned
+/// and *skipped*, its *runtime* including and its *selfTime* excluding its dependencies
+/// in seconds, and the size of the largest block of items it returned in *peakMemory*.
+///
+/// @RESTSTRUCT{stream,JSF_post_api_cursor_opts,boolean,optional,}
+/// if set to *true*, the query result is not built up completely before the
+/// first batch is returned. Instead, the query is kept alive on the server and
+/// each batch is computed when it is requested. The query's collections stay
+/// locked until the cursor is exhausted, deleted or its *ttl* expires. 
+/// Streaming cursors do not support *count* and the query cache, and return 
+/// the *extra* attribute with the last batch only. The option is ignored on a
+/// cluster coordinator.
 ///
 /// @RESTDESCRIPTION
 /// The query details include the query string plus optional query options and
@@ -737,13 +822,13 @@ void RestCursorHandler::createCursor () {
   }
 
   try { 
-    std::unique_ptr<TRI_json_t> json(parseJsonBody());
+    TRI_json_t* json = parseJsonBody();
 
-    if (json.get() == nullptr) {
+    if (json == nullptr) {
       return;
     }
 
-    processQuery(json.get());
+    processQuery(json);
   }  
   catch (triagens::basics::Exception const& ex) {
     unregisterQuery(); 
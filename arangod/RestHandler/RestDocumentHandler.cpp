@@ -32,13 +32,17 @@
 #include "Basics/StringUtils.h"
 #include "Basics/conversions.h"
 #include "Basics/json.h"
+#include "Basics/StringBuffer.h"
 #include "Basics/string-buffer.h"
 #include "Basics/json-utilities.h"
+#include "Basics/JsonHelper.h"
 #include "Cluster/ServerState.h"
+#include "Cluster/SynchronousReplication.h"
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/ClusterComm.h"
 #include "Cluster/ClusterMethods.h"
 #include "Rest/HttpRequest.h"
+#include "Utils/DocumentCache.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/vocbase.h"
 
@@ -302,20 +306,43 @@ bool RestDocumentHandler::createDocument () {
 
   bool const waitForSync = extractWaitForSync();
 
-  std::unique_ptr<TRI_json_t> json(parseJsonBody());
+  if (ServerState::instance()->isCoordinator()) {
+    TRI_json_t* json = parseJsonBody();
 
-  if (json == nullptr) {
-    return false;
-  }
+    if (json == nullptr) {
+      return false;
+    }
 
-  if (json->_type != TRI_JSON_OBJECT) {
-    generateTransactionError(collection, TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
-    return false;
+    if (json->_type != TRI_JSON_OBJECT) {
+      generateTransactionError(collection, TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
+      return false;
+    }
+
+    // json will be freed inside, so hand over a copy outside of the arena
+    TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    if (copy == nullptr) {
+      generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+      return false;
+    }
+
+    return createDocumentCoordinator(collection, waitForSync, copy);
   }
 
-  if (ServerState::instance()->isCoordinator()) {
-    // json will be freed inside!
-    return createDocumentCoordinator(collection, waitForSync, json.release());
+  // binary json bodies are decoded up front, json text is shaped while it
+  // is parsed
+  bool const binary = _request->hasBinaryJsonBody();
+  TRI_json_t* json = (binary ? parseJsonBody() : nullptr);
+
+  if (binary) {
+    if (json == nullptr) {
+      return false;
+    }
+
+    if (! TRI_IsObjectJson(json)) {
+      generateTransactionError(collection, TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
+      return false;
+    }
   }
 
   if (! checkCreateCollection(collection, getCollectionType())) {
@@ -345,13 +372,53 @@ bool RestDocumentHandler::createDocument () {
   TRI_voc_cid_t const cid = trx.cid();
 
   TRI_doc_mptr_copy_t mptr;
-  res = trx.createDocument(&mptr, json.get(), waitForSync);
+  char* errmsg = nullptr;
+  ReplicationTicket ticket;
+
+  if (binary) {
+    res = trx.createDocument(&mptr, json, waitForSync);
+  }
+  else {
+    // the body is shaped while it is parsed, without building a json object
+    res = trx.createDocument(&mptr, _request->body(), _request->bodySize(), true, waitForSync, &errmsg);
+  }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // queue the document for the followers of the shard while it is protected
+    SynchronousReplication::instance()->enqueueDocument(_request->databaseName(), trx.resolver(), trx.documentCollection(), &mptr, ticket);
+  }
+
   res = trx.finish(res);
 
   // .............................................................................
   // outside write transaction
   // .............................................................................
 
+  if (res == TRI_ERROR_HTTP_CORRUPTED_JSON) {
+    if (errmsg == nullptr) {
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_CORRUPTED_JSON,
+                    "cannot parse json object");
+    }
+    else {
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_CORRUPTED_JSON,
+                    errmsg);
+
+      TRI_FreeString(TRI_CORE_MEM_ZONE, errmsg);
+    }
+
+    return false;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    ticket.cancel();
+    generateTransactionError(collection, res);
+    return false;
+  }
+
+  res = ticket.commit();
+
   if (res != TRI_ERROR_NO_ERROR) {
     generateTransactionError(collection, res);
     return false;
@@ -578,6 +645,7 @@ bool RestDocumentHandler::readSingleDocument (bool generateBody) {
   TRI_document_collection_t* document = trx.documentCollection();
   TRI_ASSERT(document != nullptr);
   auto shaper = document->getShaper();  // PROTECTED by trx here
+  bool const isEdge = (document->_info._type == TRI_COL_TYPE_EDGE);
 
   res = trx.finish(res);
 
@@ -597,37 +665,66 @@ bool RestDocumentHandler::readSingleDocument (bool generateBody) {
     return false;
   }
 
-  // generate result
+  // generate result. the preconditions are checked with the revision from
+  // the primary index and the key from the request, so that a not modified
+  // or failed precondition response does not read the document itself
   TRI_voc_rid_t const rid = mptr._rid;
 
-  if (ifNoneRid == 0) {
-    if (ifRid == 0 || ifRid == rid) {
-      generateDocument(trx, cid, mptr, shaper, generateBody);
-    }
-    else {
-      generatePreconditionFailed(trx, cid, mptr, rid);
-    }
+  if (ifRid != 0 && ifRid != rid) {
+    generatePreconditionFailed(trx.resolver()->getCollectionName(cid), (TRI_voc_key_t) key.c_str(), rid);
   }
-  else if (ifNoneRid == rid) {
-    if (ifRid == 0 || ifRid == rid) {
-      generateNotModified(rid);
-    }
-    else {
-      generatePreconditionFailed(trx, cid, mptr, rid);
-    }
+  else if (ifNoneRid != 0 && ifNoneRid == rid) {
+    generateNotModified(rid);
   }
   else {
-    if (ifRid == 0 || ifRid == rid) {
-      generateDocument(trx, cid, mptr, shaper, generateBody);
-    }
-    else {
-      generatePreconditionFailed(trx, cid, mptr, rid);
-    }
+    generateCachedDocument(trx, cid, key, mptr, shaper, isEdge, generateBody);
   }
 
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates a document response, using the document cache if active
+///
+/// Edges are not cached, because their _from and _to values contain the names
+/// of other collections, which may be renamed without changing the edge. The
+/// cache holds json text, so binary json responses are not cached either.
+/// A cached body is found by the key from the request and the revision from
+/// the primary index, so that neither a GET nor a HEAD request reads the
+/// document if its body is cached.
+////////////////////////////////////////////////////////////////////////////////
+
+void RestDocumentHandler::generateCachedDocument (SingleCollectionReadOnlyTransaction& trx,
+                                                  TRI_voc_cid_t cid,
+                                                  string const& key,
+                                                  TRI_doc_mptr_copy_t const& mptr,
+                                                  VocShaper* shaper,
+                                                  bool isEdge,
+                                                  bool generateBody) {
+  DocumentCache* cache = DocumentCache::instance();
+
+  if (! cache->isActive() ||
+      _request->acceptsBinaryJson() ||
+      isEdge) {
+    generateDocument(trx, cid, mptr, shaper, generateBody);
+    return;
+  }
+
+  auto body = cache->lookup(_vocbase->_id,
+                            cid,
+                            key.c_str(),
+                            mptr._rid,
+                            trx.resolver()->getCollectionName(cid),
+                            [&] () -> string {
+    StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+    stringifyDocument(trx, cid, mptr, shaper, buffer.stringBuffer());
+
+    return string(buffer.c_str(), buffer.length());
+  });
+
+  generateDocument(mptr._rid, body->c_str(), body->size(), generateBody);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reads a single a document, coordinator case in a cluster
 ////////////////////////////////////////////////////////////////////////////////
@@ -1395,7 +1492,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   }
 
   if (json->_type != TRI_JSON_OBJECT) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     generateTransactionError(collection, TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
     return false;
   }
@@ -1404,7 +1500,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   bool isValidRevision;
   TRI_voc_rid_t const revision = extractRevision("if-match", "rev", isValidRevision);
   if (! isValidRevision) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     generateError(HttpResponse::BAD,
                   TRI_ERROR_HTTP_BAD_PARAMETER,
                   "invalid revision number");
@@ -1416,9 +1511,16 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   bool const waitForSync = extractWaitForSync();
 
   if (ServerState::instance()->isCoordinator()) {
-    // json will be freed inside
+    // json will be freed inside, so hand over a copy outside of the arena
+    TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    if (copy == nullptr) {
+      generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+      return false;
+    }
+
     return modifyDocumentCoordinator(collection, key, revision, policy,
-                                     waitForSync, isPatch, json);
+                                     waitForSync, isPatch, copy);
   }
 
   TRI_doc_mptr_copy_t mptr;
@@ -1433,7 +1535,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   int res = trx.begin();
 
   if (res != TRI_ERROR_NO_ERROR) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     generateTransactionError(collection, res);
     return false;
   }
@@ -1454,7 +1555,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   string const&& cidString = StringUtils::itoa(document->_info._planId);
 
   if (trx.orderDitch(trx.trxCollection()) == nullptr) {
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     generateTransactionError(collectionName, TRI_ERROR_OUT_OF_MEMORY);
     return false;
   }
@@ -1495,7 +1595,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
     if (res != TRI_ERROR_NO_ERROR) {
       trx.abort();
       generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
-      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
       return false;
     }
@@ -1503,7 +1602,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
     if (oldDocument.getDataPtr() == nullptr) {  // PROTECTED by trx here
       trx.abort();
       generateTransactionError(collectionName, TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, (TRI_voc_key_t) key.c_str(), rid);
-      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
       return false;
     }
@@ -1515,7 +1613,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
     if (old == nullptr) {
       trx.abort();
       generateTransactionError(collectionName, TRI_ERROR_OUT_OF_MEMORY);
-      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
       return false;
     }
@@ -1524,7 +1621,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
       // compare attributes in shardKeys
       if (shardKeysChanged(_request->databaseName(), cidString, old, json, true)) {
         TRI_FreeJson(shaper->memoryZone(), old);
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
         trx.abort();
         generateTransactionError(collectionName, TRI_ERROR_CLUSTER_MUST_NOT_CHANGE_SHARDING_ATTRIBUTES);
@@ -1535,7 +1631,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
 
     TRI_json_t* patchedJson = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, old, json, nullMeansRemove, mergeObjects);
     TRI_FreeJson(shaper->memoryZone(), old);
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
     if (patchedJson == nullptr) {
       trx.abort();
@@ -1564,7 +1659,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
       if (res != TRI_ERROR_NO_ERROR) {
         trx.abort();
         generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
         return false;
       }
@@ -1572,7 +1666,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
       if (oldDocument.getDataPtr() == nullptr) {  // PROTECTED by trx here
         trx.abort();
         generateTransactionError(collectionName, TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND, (TRI_voc_key_t) key.c_str(), rid);
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
         return false;
       }
@@ -1583,7 +1676,6 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
 
       if (shardKeysChanged(_request->databaseName(), cidString, old, json, false)) {
         TRI_FreeJson(shaper->memoryZone(), old);
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
 
         trx.abort();
         generateTransactionError(collectionName, TRI_ERROR_CLUSTER_MUST_NOT_CHANGE_SHARDING_ATTRIBUTES);
@@ -1597,7 +1689,13 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
     }
 
     res = trx.updateDocument(key, &mptr, json, policy, waitForSync, revision, &rid);
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+  }
+
+  ReplicationTicket ticket;
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // queue the document for the followers of the shard while it is protected
+    SynchronousReplication::instance()->enqueueDocument(_request->databaseName(), trx.resolver(), document, &mptr, ticket);
   }
 
   res = trx.finish(res);
@@ -1606,6 +1704,15 @@ bool RestDocumentHandler::modifyDocument (bool isPatch) {
   // outside write transaction
   // .............................................................................
 
+  if (res != TRI_ERROR_NO_ERROR) {
+    ticket.cancel();
+    generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
+
+    return false;
+  }
+
+  res = ticket.commit();
+
   if (res != TRI_ERROR_NO_ERROR) {
     generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
 
@@ -1847,9 +1954,11 @@ bool RestDocumentHandler::deleteDocument () {
   }
 
   TRI_voc_rid_t rid = 0;
+  ReplicationTicket ticket;
   res = trx.deleteDocument(key, policy, waitForSync, revision, &rid);
 
   if (res == TRI_ERROR_NO_ERROR) {
+    SynchronousReplication::instance()->enqueueRemove(_request->databaseName(), trx.documentCollection(), key, rid, ticket);
     res = trx.commit();
   }
   else {
@@ -1860,6 +1969,14 @@ bool RestDocumentHandler::deleteDocument () {
   // outside write transaction
   // .............................................................................
 
+  if (res != TRI_ERROR_NO_ERROR) {
+    ticket.cancel();
+    generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
+    return false;
+  }
+
+  res = ticket.commit();
+
   if (res != TRI_ERROR_NO_ERROR) {
     generateTransactionError(collectionName, res, (TRI_voc_key_t) key.c_str(), rid);
     return false;
@@ -165,6 +165,18 @@ namespace triagens {
                                    std::string const& key,
                                    bool generateBody);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates a document response, using the document cache if active
+////////////////////////////////////////////////////////////////////////////////
+
+      void generateCachedDocument (SingleCollectionReadOnlyTransaction& trx,
+                                   TRI_voc_cid_t,
+                                   std::string const&,
+                                   TRI_doc_mptr_copy_t const&,
+                                   VocShaper*,
+                                   bool,
+                                   bool);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read all documents, coordinator case in a cluster
 ////////////////////////////////////////////////////////////////////////////////
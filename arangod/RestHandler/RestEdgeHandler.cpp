@@ -34,6 +34,7 @@
 #include "Cluster/ClusterInfo.h"
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/ServerState.h"
+#include "Cluster/SynchronousReplication.h"
 #include "Rest/HttpRequest.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/edge-collection.h"
@@ -201,20 +202,27 @@ bool RestEdgeHandler::createDocument () {
 
   bool const waitForSync = extractWaitForSync();
 
-  std::unique_ptr<TRI_json_t> json(parseJsonBody());
+  TRI_json_t* json = parseJsonBody();
   
   if (json == nullptr) {
     return false;
   }
 
-  if (! TRI_IsObjectJson(json.get())) {
+  if (! TRI_IsObjectJson(json)) {
     generateTransactionError(collection, TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
     return false;
   }
 
   if (ServerState::instance()->isCoordinator()) {
-    // json will be freed inside!
-    return createDocumentCoordinator(collection, waitForSync, json.release(), from, to);
+    // json will be freed inside, so hand over a copy outside of the arena
+    TRI_json_t* copy = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    if (copy == nullptr) {
+      generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+      return false;
+    }
+
+    return createDocumentCoordinator(collection, waitForSync, copy, from, to);
   }
 
   if (! checkCreateCollection(collection, getCollectionType())) {
@@ -291,7 +299,14 @@ bool RestEdgeHandler::createDocument () {
 
   // will hold the result
   TRI_doc_mptr_copy_t mptr;
-  res = trx.createEdge(&mptr, json.get(), waitForSync, &edge);
+  ReplicationTicket ticket;
+  res = trx.createEdge(&mptr, json, waitForSync, &edge);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // queue the edge for the followers of the shard while it is protected
+    SynchronousReplication::instance()->enqueueDocument(_request->databaseName(), trx.resolver(), trx.documentCollection(), &mptr, ticket);
+  }
+
   res = trx.finish(res);
 
   FREE_STRING(TRI_CORE_MEM_ZONE, edge._fromKey);
@@ -301,6 +316,14 @@ bool RestEdgeHandler::createDocument () {
   // outside write transaction
   // .............................................................................
 
+  if (res != TRI_ERROR_NO_ERROR) {
+    ticket.cancel();
+    generateTransactionError(collection, res);
+    return false;
+  }
+
+  res = ticket.commit();
+
   if (res != TRI_ERROR_NO_ERROR) {
     generateTransactionError(collection, res);
     return false;
@@ -31,9 +31,14 @@
 #include "Basics/Exceptions.h"
 #include "Basics/json.h"
 #include "Basics/MutexLocker.h"
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/DispatcherThread.h"
+#include "Indexes/PrimaryIndex.h"
 #include "Utils/CollectionExport.h"
 #include "Utils/Cursor.h"
 #include "Utils/CursorRepository.h"
+#include "Utils/ExportStreamJob.h"
+#include "VocBase/document-collection.h"
 #include "Wal/LogfileManager.h"
 
 using namespace triagens::arango;
@@ -132,6 +137,27 @@ triagens::basics::Json RestExportHandler::buildOptions (TRI_json_t const* json)
   attribute = getAttribute("flushWait");
   options.set("flushWait", triagens::basics::Json(TRI_IsNumberJson(attribute) ? attribute->_value._number : 10.0));
 
+  attribute = getAttribute("stream");
+  options.set("stream", triagens::basics::Json(TRI_IsBooleanJson(attribute) ? attribute->_value._boolean : false));
+
+  attribute = getAttribute("streams");
+  options.set("streams", triagens::basics::Json(TRI_IsNumberJson(attribute) ? attribute->_value._number : 1.0));
+
+  if (TRI_IsNumberJson(attribute) && static_cast<size_t>(attribute->_value._number) == 0) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_TYPE_ERROR, "expecting non-zero value for 'streams'");
+  }
+
+  attribute = getAttribute("streamId");
+  options.set("streamId", triagens::basics::Json(TRI_IsNumberJson(attribute) ? attribute->_value._number : 0.0));
+
+  attribute = getAttribute("order");
+  if (attribute != nullptr) {
+    if (! TRI_IsStringJson(attribute)) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_TYPE_ERROR, "expecting string for 'order'");
+    }
+    options.set("order", triagens::basics::Json(std::string(attribute->_value._string.data, attribute->_value._string.length - 1)));
+  }
+
   // handle "restrict" parameter
   attribute = getAttribute("restrict");
   if (attribute != nullptr) {
@@ -233,6 +259,19 @@ triagens::basics::Json RestExportHandler::buildOptions (TRI_json_t const* json)
 /// for *inclusion* or *exclusion* will be done on the top level only.
 /// Specifying names of nested attributes is not supported at the moment.
 ///
+/// @RESTBODYPARAM{stream,boolean,optional,}
+/// if set to *true*, no cursor is created. Instead, all documents are written
+/// into the response as they are read, see below.
+///
+/// @RESTBODYPARAM{streams,integer,optional,int64}
+/// the number of streams a streaming export is split into. Defaults to *1*.
+///
+/// @RESTBODYPARAM{streamId,integer,optional,int64}
+/// the stream to return, from *0* to *streams - 1*. Defaults to *0*.
+///
+/// @RESTBODYPARAM{order,string,optional,string}
+/// the order of a streaming export, either *index* (the default) or *physical*.
+///
 ///
 /// @RESTQUERYPARAMETERS
 ///
@@ -304,10 +343,32 @@ triagens::basics::Json RestExportHandler::buildOptions (TRI_json_t const* json)
 /// after a server-defined idle time, and clients can adjust this idle time by setting
 /// the *ttl* value.
 ///
+/// If the *stream* attribute is set, the server responds with *HTTP 200* and
+/// writes the documents as a chunked response with content type
+/// *application/x-arango-dump*, one JSON document per line. The documents are
+/// read in batches while the response is sent, and the server waits for slow
+/// clients, so a stream uses little memory regardless of the size of the
+/// collection. Writers are only blocked while a batch is read. The export ends
+/// with the end of the response. An error that occurs after the response has
+/// started is reported as a last line containing an object with the attributes
+/// *error*, *errorNum* and *errorMessage*.
+///
+/// A streaming export can be split into *streams* parts, which clients can
+/// request in parallel with the same options and different values of *streamId*.
+/// The parts do not overlap and together contain all exported documents. In
+/// *index* order, the streams scan distinct parts of the primary index, so
+/// there can be at most as many streams as the collection has index buckets.
+/// In *physical* order, the streams read distinct datafiles sequentially, and
+/// return the documents in the order they are stored on disk. Each stream
+/// applies *limit* on its own.
+///
 /// Note: this API is currently not supported on cluster coordinators.
 ///
 /// @RESTRETURNCODES
 ///
+/// @RESTRETURNCODE{200}
+/// is returned if a streaming export has been started.
+///
 /// @RESTRETURNCODE{201}
 /// is returned if the result set can be created by the server.
 ///
@@ -351,21 +412,21 @@ void RestExportHandler::createCursor () {
   }
 
   try { 
-    std::unique_ptr<TRI_json_t> json(parseJsonBody());
+    TRI_json_t* json = parseJsonBody();
     
-    if (json.get() == nullptr) {
+    if (json == nullptr) {
       return;
     }
  
     triagens::basics::Json options;
 
-    if (json.get() != nullptr) {
-      if (! TRI_IsObjectJson(json.get())) {
+    if (json != nullptr) {
+      if (! TRI_IsObjectJson(json)) {
         generateError(HttpResponse::BAD, TRI_ERROR_QUERY_EMPTY);
         return;
       }
    
-      options = buildOptions(json.get());
+      options = buildOptions(json);
     }
     else {
       // create an empty options object
@@ -390,6 +451,11 @@ void RestExportHandler::createCursor () {
     
     size_t limit = triagens::basics::JsonHelper::getNumericValue<size_t>(options.json(), "limit", 0);
 
+    if (triagens::basics::JsonHelper::getBooleanValue(options.json(), "stream", false)) {
+      createStream(name, options, waitTime, limit);
+      return;
+    }
+
     // this may throw!
     std::unique_ptr<CollectionExport> collectionExport(new CollectionExport(_vocbase, name, _restrictions));
     collectionExport->run(waitTime, limit);
@@ -432,6 +498,65 @@ void RestExportHandler::createCursor () {
   }
 }
 
+void RestExportHandler::createStream (char const* name,
+                                      triagens::basics::Json const& options,
+                                      uint64_t waitTime,
+                                      size_t limit) {
+  size_t const streams = triagens::basics::JsonHelper::getNumericValue<size_t>(options.json(), "streams", 1);
+  size_t const streamId = triagens::basics::JsonHelper::getNumericValue<size_t>(options.json(), "streamId", 0);
+  std::string const orderString = triagens::basics::JsonHelper::getStringValue(options.json(), "order", "index");
+
+  if (streamId >= streams) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "expecting 'streamId' to be less than 'streams'");
+  }
+
+  ExportStreamJob::Order order;
+
+  if (orderString == "index") {
+    order = ExportStreamJob::ORDER_INDEX;
+  }
+  else if (orderString == "physical") {
+    order = ExportStreamJob::ORDER_PHYSICAL;
+  }
+  else {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "expecting either 'index' or 'physical' for 'order'");
+  }
+
+  auto dispatcherThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+
+  if (dispatcherThread == nullptr) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "streaming export needs a dispatcher thread");
+  }
+
+  // this may throw!
+  std::unique_ptr<CollectionExport> collectionExport(new CollectionExport(_vocbase, name, _restrictions));
+
+  if (order == ExportStreamJob::ORDER_INDEX &&
+      streams > collectionExport->document()->primaryIndex()->numberOfBuckets()) {
+    // index order splits the buckets of the primary index between the streams
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "expecting 'streams' to be at most the number of index buckets of the collection");
+  }
+
+  collectionExport->prepare(waitTime);
+
+  // from here on, errors are reported in the body
+  _response = createResponse(HttpResponse::OK);
+  _response->setContentType("application/x-arango-dump; charset=utf-8");
+  _response->setHeader("transfer-encoding", strlen("transfer-encoding"), "chunked");
+
+  TRI_UseVocBase(_vocbase);
+
+  auto job = new ExportStreamJob(_vocbase, collectionExport.release(), _request->clientTaskId(), order, streamId, streams, limit);
+
+  int res = dispatcherThread->dispatcher()->addJob(job);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // ends the response with an error line
+    job->handleError(triagens::basics::Exception(res, __FILE__, __LINE__));
+    delete job;
+  }
+}
+
 void RestExportHandler::modifyCursor () {
   std::vector<std::string> const& suffix = _request->suffix();
 
@@ -91,6 +91,16 @@ namespace triagens {
 
         void createCursor ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief start a streaming export, which writes the documents as a chunked
+/// response
+////////////////////////////////////////////////////////////////////////////////
+
+        void createStream (char const*,
+                           triagens::basics::Json const&,
+                           uint64_t,
+                           size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the next results from an existing cursor
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,10 +31,15 @@
 
 #include "Basics/JsonHelper.h"
 #include "Basics/StringUtils.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/tri-strings.h"
+#include "Cluster/ClusterMethods.h"
+#include "Cluster/ServerState.h"
+#include "JsonParser/json-scanner.h"
 #include "Rest/HttpRequest.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/edge-collection.h"
+#include "VocBase/server.h"
 #include "VocBase/vocbase.h"
 
 using namespace std;
@@ -42,6 +47,19 @@ using namespace triagens::basics;
 using namespace triagens::rest;
 using namespace triagens::arango;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents that are inserted with one WAL write
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const ImportBatchSize = 1000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents that are shaped and inserted together in a
+/// bulk import
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const BulkImportBatchSize = 16384;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -64,13 +82,6 @@ RestImportHandler::RestImportHandler (HttpRequest* request)
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpHandler::status_t RestImportHandler::execute () {
-  if (ServerState::instance()->isCoordinator()) {
-    generateError(HttpResponse::NOT_IMPLEMENTED,
-                  TRI_ERROR_CLUSTER_UNSUPPORTED,
-                  "'/_api/import' is not yet supported in a cluster");
-    return status_t(HANDLER_DONE);
-  }
-  
   // set default value for onDuplicate
   _onDuplicateAction = DUPLICATE_ERROR;
       
@@ -105,6 +116,11 @@ HttpHandler::status_t RestImportHandler::execute () {
            documentType == "auto")) {
         createFromJson(documentType);
       }
+      else if (ServerState::instance()->isCoordinator()) {
+        generateError(HttpResponse::NOT_IMPLEMENTED,
+                      TRI_ERROR_CLUSTER_UNSUPPORTED,
+                      "importing key/value lists is not yet supported in a cluster");
+      }
       else {
         // CSV
         createFromKeyValueList();
@@ -121,6 +137,21 @@ HttpHandler::status_t RestImportHandler::execute () {
   return status_t(HANDLER_DONE);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief imports run with low priority unless requested otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+Job::priority_e RestImportHandler::priority () const {
+  bool found;
+  _request->header("x-arango-priority", found);
+
+  if (found) {
+    return RestVocbaseBaseHandler::priority();
+  }
+
+  return Job::PRIORITY_LOW;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -155,6 +186,21 @@ bool RestImportHandler::extractComplete () const {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the "bulk" value
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::extractBulk () const {
+  bool found;
+  char const* bulk = _request->value("bulk", found);
+
+  if (found) {
+    return StringUtils::boolean(bulk);
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a position string
 ////////////////////////////////////////////////////////////////////////////////
@@ -357,6 +403,55 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a batch of JSON documents
+////////////////////////////////////////////////////////////////////////////////
+
+int RestImportHandler::handleDocuments (RestImportTransaction& trx,
+                                        RestImportResult& result,
+                                        std::vector<std::pair<char const*, size_t>>& texts,
+                                        std::vector<size_t>& positions,
+                                        bool linewise,
+                                        bool waitForSync,
+                                        bool complete,
+                                        size_t numThreads) {
+  std::vector<int> results;
+  trx.createDocuments(texts, results, waitForSync, numThreads);
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  for (size_t i = 0; i < texts.size(); ++i) {
+    if (i < results.size() && results[i] == TRI_ERROR_NO_ERROR) {
+      ++result._numCreated;
+      continue;
+    }
+
+    // process failed documents again on their own. this produces the usual
+    // error messages
+    char const* text = texts[i].first;
+    TRI_json_t* json = parseJsonLine(text, text + texts[i].second);
+    res = handleSingleDocument(trx, result, linewise ? text : nullptr, json, false, waitForSync, positions[i]);
+
+    if (json != nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      if (complete) {
+        // only perform a full import: abort
+        break;
+      }
+
+      res = TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  texts.clear();
+  positions.clear();
+
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock JSF_import_json
 /// @brief imports documents from JSON
@@ -426,6 +521,12 @@ int RestImportHandler::handleSingleDocument (RestImportTransaction& trx,
 /// If set to `true` or `yes`, the result will include an attribute `details`
 /// with details about documents that could not be imported.
 ///
+/// @RESTQUERYPARAM{bulk,boolean,optional}
+/// If set to `true` or `yes`, the documents are parsed and shaped by several
+/// threads, in larger batches. This is meant for loading large amounts of
+/// data into a document collection. The documents only become visible when
+/// the whole request has been imported, as in a regular import.
+///
 /// @RESTDESCRIPTION
 /// **NOTE** Swagger examples won't work due to the anchor.
 ///
@@ -780,6 +881,10 @@ bool RestImportHandler::createFromJson (string const& type) {
     return false;
   }
 
+  if (ServerState::instance()->isCoordinator()) {
+    return createFromJsonCoordinator(collection, linewise, waitForSync, overwrite);
+  }
+
   // find and load collection given by name or identifier
   RestImportTransaction trx(new StandaloneTransactionContext(), _vocbase, collection);
 
@@ -797,6 +902,20 @@ bool RestImportHandler::createFromJson (string const& type) {
   TRI_document_collection_t* document = trx.documentCollection();
   bool const isEdgeCollection = (document->_info._type == TRI_COL_TYPE_EDGE);
 
+  // a bulk import shapes larger batches on the index threads
+  size_t batchSize = ImportBatchSize;
+  size_t shapeThreads = 1;
+
+  if (extractBulk()) {
+    auto indexPool = _vocbase->_server->_indexPool;
+
+    batchSize = BulkImportBatchSize;
+
+    if (indexPool != nullptr) {
+      shapeThreads = indexPool->numThreads();
+    }
+  }
+
   trx.lockWrite();
 
   if (overwrite) {
@@ -804,6 +923,10 @@ bool RestImportHandler::createFromJson (string const& type) {
     trx.truncate(false);
   }
 
+  // documents waiting to be inserted, and their positions in the input
+  std::vector<std::pair<char const*, size_t>> texts;
+  std::vector<size_t> positions;
+
   if (linewise) {
     // each line is a separate JSON document
     char const* ptr = _request->body();
@@ -829,6 +952,7 @@ bool RestImportHandler::createFromJson (string const& type) {
       // now find end of line
       char const* pos = strchr(ptr, '\n');
       char const* oldPtr = nullptr;
+      char const* lineEnd = nullptr;
 
       TRI_json_t* json = nullptr;
 
@@ -843,7 +967,7 @@ bool RestImportHandler::createFromJson (string const& type) {
         *(const_cast<char*>(pos)) = '\0';
         TRI_ASSERT(ptr != nullptr);
         oldPtr = ptr;
-        json = parseJsonLine(ptr, pos);
+        lineEnd = pos;
         ptr = pos + 1;
       }
       else {
@@ -851,10 +975,28 @@ bool RestImportHandler::createFromJson (string const& type) {
         TRI_ASSERT(pos == nullptr);
         TRI_ASSERT(ptr != nullptr);
         oldPtr = ptr;
-        json = parseJsonLine(ptr);
+        lineEnd = end;
         ptr = end;
       }
 
+      if (! isEdgeCollection) {
+        // shape the line directly, together with the following lines. lines
+        // that fail for whatever reason are processed again on their own
+        texts.emplace_back(oldPtr, static_cast<size_t>(lineEnd - oldPtr));
+        positions.push_back(i);
+
+        if (texts.size() >= batchSize) {
+          res = handleDocuments(trx, result, texts, positions, true, waitForSync, complete, shapeThreads);
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            break;
+          }
+        }
+
+        continue;
+      }
+
+      json = parseJsonLine(oldPtr, lineEnd);
       res = handleSingleDocument(trx, result, oldPtr, json, isEdgeCollection, waitForSync, i);
 
       if (json != nullptr) {
@@ -870,29 +1012,53 @@ bool RestImportHandler::createFromJson (string const& type) {
         res = TRI_ERROR_NO_ERROR;
       }
     }
+
+    if (res == TRI_ERROR_NO_ERROR && ! texts.empty()) {
+      res = handleDocuments(trx, result, texts, positions, true, waitForSync, complete, shapeThreads);
+    }
   }
 
   else {
-    // the entire request body is one JSON document
-    TRI_json_t* documents = TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, _request->body(), nullptr);
+    // the entire request body is one JSON array. its elements are split off
+    // and imported in batches, so the array itself is never built
+    TRI_json_array_reader_t reader;
+    bool valid = TRI_InitJsonArrayReader(&reader, _request->body(), _request->bodySize());
+    size_t i = 0;
+
+    while (valid) {
+      char const* value;
+      size_t length;
+
+      valid = TRI_NextJsonArrayReader(&reader, &value, &length);
 
-    if (! TRI_IsArrayJson(documents)) {
-      if (documents != nullptr) {
-        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
+      if (! valid || value == nullptr) {
+        break;
       }
 
-      generateError(HttpResponse::BAD,
-                    TRI_ERROR_HTTP_BAD_PARAMETER,
-                    "expecting a JSON array in the request");
-      return false;
-    }
+      ++i;
 
-    size_t const n = TRI_LengthArrayJson(documents);
+      if (! isEdgeCollection) {
+        // shape the element directly, see above
+        texts.emplace_back(value, length);
+        positions.push_back(i);
 
-    for (size_t i = 0; i < n; ++i) {
-      TRI_json_t const* json = static_cast<TRI_json_t const*>(TRI_AtVector(&documents->_value._objects, i));
+        if (texts.size() >= batchSize) {
+          res = handleDocuments(trx, result, texts, positions, false, waitForSync, complete, shapeThreads);
 
-      res = handleSingleDocument(trx, result, nullptr, json, isEdgeCollection, waitForSync, i + 1);
+          if (res != TRI_ERROR_NO_ERROR) {
+            break;
+          }
+        }
+
+        continue;
+      }
+
+      TRI_json_t* json = parseJsonLine(value, value + length);
+      res = handleSingleDocument(trx, result, nullptr, json, isEdgeCollection, waitForSync, i);
+
+      if (json != nullptr) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+      }
       
       if (res != TRI_ERROR_NO_ERROR) {
         if (complete) {
@@ -904,9 +1070,21 @@ bool RestImportHandler::createFromJson (string const& type) {
       }
     }
 
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, documents);
-  }
+    if (valid && res == TRI_ERROR_NO_ERROR && ! texts.empty()) {
+      res = handleDocuments(trx, result, texts, positions, false, waitForSync, complete, shapeThreads);
+    }
 
+    if (! valid) {
+      // nothing is imported from a malformed body
+      LOG_DEBUG("invalid JSON array in import request: '%s'", reader._scanner._message);
+      trx.finish(TRI_ERROR_HTTP_BAD_PARAMETER);
+
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "expecting a JSON array in the request");
+      return false;
+    }
+  }
 
   // this may commit, even if previous errors occurred
   res = trx.finish(res);
@@ -926,6 +1104,243 @@ bool RestImportHandler::createFromJson (string const& type) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates documents by JSON objects in a coordinator
+///
+/// the documents are parsed here and sent to the shards in batches of
+/// ImportBatchSize documents, with one request per shard and batch. there is
+/// no transaction spanning the shards, so "complete" imports and updating or
+/// replacing duplicates are not supported
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestImportHandler::createFromJsonCoordinator (string const& collection,
+                                                   bool linewise,
+                                                   bool waitForSync,
+                                                   bool overwrite) {
+  if (extractComplete() ||
+      _onDuplicateAction == DUPLICATE_UPDATE ||
+      _onDuplicateAction == DUPLICATE_REPLACE) {
+    generateError(HttpResponse::NOT_IMPLEMENTED,
+                  TRI_ERROR_CLUSTER_UNSUPPORTED,
+                  "'complete' and 'onDuplicate' update or replace are not supported in a cluster");
+    return false;
+  }
+
+  string const& dbname = _request->databaseName();
+  int res = TRI_ERROR_NO_ERROR;
+
+  if (overwrite) {
+    res = truncateCollectionOnCoordinator(dbname, collection);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      generateTransactionError(collection, res);
+      return false;
+    }
+  }
+
+  RestImportResult result;
+
+  // documents waiting to be sent, and their positions in the input
+  vector<TRI_json_t*> documents;
+  vector<size_t> positions;
+
+  if (linewise) {
+    // each line is a separate JSON document
+    char const* ptr = _request->body();
+    char const* end = ptr + _request->bodySize();
+    size_t i = 0;
+
+    while (ptr < end) {
+      i++;
+
+      // trim whitespace at start of line
+      while (ptr < end && 
+             (*ptr == ' ' || *ptr == '\t' || *ptr == '\r' || *ptr == '\b' || *ptr == '\f')) {
+        ++ptr;
+      }
+
+      if (ptr == end || *ptr == '\0') {
+        break;
+      }
+
+      char const* pos = static_cast<char const*>(memchr(ptr, '\n', static_cast<size_t>(end - ptr)));
+
+      if (pos == ptr) {
+        // empty line
+        ptr = pos + 1;
+        ++result._numEmpty;
+        continue;
+      }
+
+      char const* lineStart = ptr;
+      char const* lineEnd = (pos != nullptr ? pos : end);
+      ptr = (pos != nullptr ? pos + 1 : end);
+
+      TRI_json_t* json = parseJsonLine(lineStart, lineEnd);
+
+      if (! TRI_IsObjectJson(json)) {
+        if (json != nullptr) {
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        }
+
+        registerError(result, buildParseError(i, string(lineStart, lineEnd - lineStart).c_str()));
+        continue;
+      }
+
+      documents.push_back(json);
+      positions.push_back(i);
+
+      if (documents.size() >= ImportBatchSize) {
+        res = handleDocumentsCoordinator(result, collection, documents, positions, waitForSync);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          break;
+        }
+      }
+    }
+  }
+
+  else {
+    TRI_json_array_reader_t reader;
+    bool valid = TRI_InitJsonArrayReader(&reader, _request->body(), _request->bodySize());
+    size_t i = 0;
+
+    while (valid) {
+      char const* value;
+      size_t length;
+
+      valid = TRI_NextJsonArrayReader(&reader, &value, &length);
+
+      if (! valid || value == nullptr) {
+        break;
+      }
+
+      ++i;
+
+      TRI_json_t* json = parseJsonLine(value, value + length);
+
+      if (! TRI_IsObjectJson(json)) {
+        if (json != nullptr) {
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+        }
+
+        registerError(result, buildParseError(i, nullptr));
+        continue;
+      }
+
+      documents.push_back(json);
+      positions.push_back(i);
+
+      if (documents.size() >= ImportBatchSize) {
+        res = handleDocumentsCoordinator(result, collection, documents, positions, waitForSync);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          break;
+        }
+      }
+    }
+
+    if (! valid) {
+      // unlike on a single server, the batches sent so far stay imported
+      for (auto json : documents) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+      }
+
+      LOG_DEBUG("invalid JSON array in import request: '%s'", reader._scanner._message);
+
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "expecting a JSON array in the request");
+      return false;
+    }
+  }
+
+  if (res == TRI_ERROR_NO_ERROR && ! documents.empty()) {
+    res = handleDocumentsCoordinator(result, collection, documents, positions, waitForSync);
+  }
+
+  for (auto json : documents) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    generateTransactionError(collection, res);
+  }
+  else {
+    generateDocumentsCreated(result);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a batch of documents to the shards and registers the results.
+/// the documents are freed
+////////////////////////////////////////////////////////////////////////////////
+
+int RestImportHandler::handleDocumentsCoordinator (RestImportResult& result,
+                                                   string const& collection,
+                                                   vector<TRI_json_t*>& documents,
+                                                   vector<size_t>& positions,
+                                                   bool waitForSync) {
+  vector<ClusterDocumentResult> results;
+
+  int res = createDocumentsOnCoordinator(_request->databaseName(),
+                                         collection,
+                                         waitForSync,
+                                         documents,
+                                         getForwardableRequestHeaders(_request),
+                                         results);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    positions.clear();
+    return res;
+  }
+
+  TRI_ASSERT(results.size() == positions.size());
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    ClusterDocumentResult const& r = results[i];
+
+    if (r.errorCode != TRI_ERROR_NO_ERROR) {
+      registerError(result, positionise(positions[i]) + TRI_errno_string(r.errorCode));
+      continue;
+    }
+
+    if (r.responseCode == HttpResponse::CREATED ||
+        r.responseCode == HttpResponse::ACCEPTED) {
+      ++result._numCreated;
+      continue;
+    }
+
+    int errorNum = TRI_ERROR_INTERNAL;
+    string errorMessage;
+    TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, r.resultBody.c_str());
+
+    if (json != nullptr) {
+      errorNum = JsonHelper::getNumericValue<int>(json, "errorNum", errorNum);
+      errorMessage = JsonHelper::getStringValue(json, "errorMessage", "");
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+
+    if (errorNum == TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED &&
+        _onDuplicateAction == DUPLICATE_IGNORE) {
+      ++result._numIgnored;
+      continue;
+    }
+
+    if (errorMessage.empty()) {
+      errorMessage = TRI_errno_string(errorNum);
+    }
+
+    registerError(result, positionise(positions[i]) + errorMessage);
+  }
+
+  positions.clear();
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock JSF_import_document
 /// @brief imports documents from JSON-encoded lists
@@ -1454,7 +1869,7 @@ TRI_json_t* RestImportHandler::parseJsonLine (string const& line) {
 
 TRI_json_t* RestImportHandler::parseJsonLine (char const* start,
                                               char const* end) {
-  return TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, start, nullptr);
+  return TRI_Json2StringLength(TRI_UNKNOWN_MEM_ZONE, start, static_cast<size_t>(end - start), nullptr);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +101,12 @@ namespace triagens {
 
         status_t execute ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief imports run with low priority unless requested otherwise
+////////////////////////////////////////////////////////////////////////////////
+
+        rest::Job::priority_e priority () const override;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -119,6 +125,12 @@ namespace triagens {
 
         bool extractComplete () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief extracts the "bulk" value
+////////////////////////////////////////////////////////////////////////////////
+
+        bool extractBulk () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a position string
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +163,20 @@ namespace triagens {
                                   bool,
                                   size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process a batch of JSON documents, shaped by the given number of
+/// threads. the batch is emptied afterwards
+////////////////////////////////////////////////////////////////////////////////
+
+        int handleDocuments (RestImportTransaction&,
+                             RestImportResult&,
+                             std::vector<std::pair<char const*, size_t>>&,
+                             std::vector<size_t>&,
+                             bool,
+                             bool,
+                             bool,
+                             size_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates documents by JSON objects
 /// each line of the input stream contains an individual JSON object
@@ -158,6 +184,25 @@ namespace triagens {
 
         bool createFromJson (std::string const&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates documents by JSON objects in a coordinator
+////////////////////////////////////////////////////////////////////////////////
+
+        bool createFromJsonCoordinator (std::string const&,
+                                        bool,
+                                        bool,
+                                        bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a batch of documents to the shards and registers the results
+////////////////////////////////////////////////////////////////////////////////
+
+        int handleDocumentsCoordinator (RestImportResult&,
+                                        std::string const&,
+                                        std::vector<TRI_json_t*>&,
+                                        std::vector<size_t>&,
+                                        bool);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates documents by JSON objects
 /// the input stream is one big JSON array containing all documents
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock profiler request handler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RestLocksHandler.h"
+#include "Rest/HttpRequest.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/LockProfiler.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+using namespace triagens::admin;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor
+////////////////////////////////////////////////////////////////////////////////
+
+RestLocksHandler::RestLocksHandler (HttpRequest* request)
+  : RestBaseHandler(request) {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   Handler methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestLocksHandler::isDirect () const {
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSF_get_admin_locks
+/// @brief returns the lock statistics
+///
+/// @RESTHEADER{GET /_admin/locks, Return the lock statistics}
+///
+/// @RESTDESCRIPTION
+/// Returns how long threads waited for and held locks, by the place in the
+/// code the lock is acquired at. The statistics are only recorded by servers
+/// built with the lock profiler (*-DUSE_LOCK_PROFILER=ON*), otherwise
+/// *enabled* is *false* and *sites* is empty.
+///
+/// Each entry of *sites* has the attributes *file*, *line*, *type* (*mutex*,
+/// *read*, *write* or *condition*), *acquisitions*, *waitTime*, *holdTime*
+/// and *maxHoldTime* (in seconds), *conditionWaits* and *conditionWaitTime*
+/// for the time spent waiting on a condition, and *waitCounts*, the number
+/// of waits shorter than each of the *waitBounds* (in seconds) plus the
+/// number of longer waits. The sites are sorted by *waitTime*.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// is returned in all cases.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSF_delete_admin_locks
+/// @brief clears the lock statistics
+///
+/// @RESTHEADER{DELETE /_admin/locks, Clear the lock statistics}
+///
+/// @RESTDESCRIPTION
+/// Sets all lock statistics to zero, e.g. before a benchmark, and returns
+/// them.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// is returned in all cases.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+HttpHandler::status_t RestLocksHandler::execute () {
+  HttpRequest::HttpRequestType type = _request->requestType();
+
+  if (type == HttpRequest::HTTP_REQUEST_DELETE) {
+    LockProfiler::reset();
+  }
+  else if (type != HttpRequest::HTTP_REQUEST_GET) {
+    generateError(HttpResponse::METHOD_NOT_ALLOWED, TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return status_t(HANDLER_DONE);
+  }
+
+  Json result = LockProfiler::toJson();
+  generateResult(result.json());
+
+  return status_t(HANDLER_DONE);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief metrics request handler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RestMetricsHandler.h"
+#include "Rest/HttpRequest.h"
+#include "Statistics/MetricsRegistry.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+using namespace triagens::admin;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor
+////////////////////////////////////////////////////////////////////////////////
+
+RestMetricsHandler::RestMetricsHandler (HttpRequest* request)
+  : RestBaseHandler(request) {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   Handler methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestMetricsHandler::isDirect () const {
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSF_get_admin_metrics
+/// @brief returns the metrics of the server
+///
+/// @RESTHEADER{GET /_admin/metrics, Return the server metrics}
+///
+/// @RESTDESCRIPTION
+/// Returns the counters, gauges and histograms of the server in the text
+/// format of Prometheus, one sample per line. The values are read when the
+/// request is made; the endpoint does not compute any aggregates and can be
+/// scraped frequently.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// is returned in all cases.
+///
+/// @RESTRETURNCODE{405}
+/// is returned if the HTTP method is not *GET*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+HttpHandler::status_t RestMetricsHandler::execute () {
+  if (_request->requestType() != HttpRequest::HTTP_REQUEST_GET) {
+    generateError(HttpResponse::METHOD_NOT_ALLOWED, TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return status_t(HANDLER_DONE);
+  }
+
+  std::string const metrics = MetricsRegistry::instance()->toPrometheus();
+
+  _response = createResponse(HttpResponse::OK);
+  _response->setContentType("text/plain; version=0.0.4");
+  _response->body().appendText(metrics);
+
+  return status_t(HANDLER_DONE);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
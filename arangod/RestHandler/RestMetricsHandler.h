@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief metrics request handler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_REST_HANDLER_REST_METRICS_HANDLER_H
+#define ARANGODB_REST_HANDLER_REST_METRICS_HANDLER_H 1
+
+#include "Basics/Common.h"
+#include "Rest/HttpResponse.h"
+#include "RestHandler/RestBaseHandler.h"
+
+namespace triagens {
+  namespace admin {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          class RestMetricsHandler
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief metrics request handler
+////////////////////////////////////////////////////////////////////////////////
+
+    class RestMetricsHandler : public RestBaseHandler {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit RestMetricsHandler (rest::HttpRequest*);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   Handler methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isDirect () const override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the metrics of the server
+////////////////////////////////////////////////////////////////////////////////
+
+        status_t execute () override;
+
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sampling profiler request handler
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "RestProfileHandler.h"
+#include "Basics/SamplingProfiler.h"
+#include "Basics/StringUtils.h"
+#include "Dispatcher/DispatcherThread.h"
+#include "Rest/HttpRequest.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+using namespace triagens::admin;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal duration of a profile in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static double const MaxSeconds = 60.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal sampling frequency
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t const MaxFrequency = 1000;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructor
+////////////////////////////////////////////////////////////////////////////////
+
+RestProfileHandler::RestProfileHandler (HttpRequest* request)
+  : RestBaseHandler(request) {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   Handler methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestProfileHandler::isDirect () const {
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock JSF_get_admin_profile
+/// @brief samples the thread stacks of the server
+///
+/// @RESTHEADER{GET /_admin/profile, Sample the thread stacks}
+///
+/// @RESTQUERYPARAMETERS
+///
+/// @RESTQUERYPARAM{seconds,number,optional}
+/// The duration of the profile, 10 seconds by default and at most 60.
+///
+/// @RESTQUERYPARAM{frequency,number,optional}
+/// The number of samples per second of consumed CPU time, 99 by default and
+/// at most 1000.
+///
+/// @RESTDESCRIPTION
+/// Samples the stacks of the threads that consume CPU time for the given
+/// duration and returns them as folded stacks in plain text, one line per
+/// distinct stack and the number of its samples:
+///
+/// *role;outermost function;...;innermost function count*
+///
+/// The role is the name of the thread, e.g. *scheduler*, *dispat_std* (the
+/// dispatcher threads, which also run the V8 contexts), *WalCollector* or
+/// *compactor*, and *other* for threads not started by the server. The
+/// output can be given to flame graph tools as it is. The headers
+/// *x-arango-samples* and *x-arango-samples-dropped* contain the number of
+/// samples and the number of samples that did not fit into the buffer.
+///
+/// The request returns after the profile has ended. Only one profile can
+/// run at a time.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// is returned when the profile has ended.
+///
+/// @RESTRETURNCODE{400}
+/// is returned if *seconds* or *frequency* are invalid.
+///
+/// @RESTRETURNCODE{409}
+/// is returned if another profile is running.
+///
+/// @RESTRETURNCODE{501}
+/// is returned if the platform does not support sampling.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+HttpHandler::status_t RestProfileHandler::execute () {
+  if (_request->requestType() != HttpRequest::HTTP_REQUEST_GET) {
+    generateError(HttpResponse::METHOD_NOT_ALLOWED, TRI_ERROR_HTTP_METHOD_NOT_ALLOWED);
+    return status_t(HANDLER_DONE);
+  }
+
+  RequestStatisticsAgentSetIgnore(this);
+
+  bool found;
+  double seconds = 10.0;
+  uint32_t frequency = 99;
+
+  char const* value = _request->value("seconds", found);
+
+  if (found) {
+    seconds = StringUtils::doubleDecimal(value);
+  }
+
+  value = _request->value("frequency", found);
+
+  if (found) {
+    frequency = StringUtils::uint32(value);
+  }
+
+  if (seconds <= 0.0 || seconds > MaxSeconds || frequency == 0 || frequency > MaxFrequency) {
+    generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting 0 < seconds <= 60 and 0 < frequency <= 1000");
+    return status_t(HANDLER_DONE);
+  }
+
+  // the dispatcher may start another thread while this one waits
+  if (_dispatcherThread != nullptr) {
+    _dispatcherThread->block();
+  }
+
+  std::string folded;
+  uint64_t samples = 0;
+  uint64_t dropped = 0;
+
+  int res = SamplingProfiler::profile(seconds, frequency, folded, samples, dropped);
+
+  if (_dispatcherThread != nullptr) {
+    _dispatcherThread->unblock();
+  }
+
+  if (res == TRI_ERROR_LOCKED) {
+    generateError(HttpResponse::CONFLICT, res, "another profile is running");
+    return status_t(HANDLER_DONE);
+  }
+
+  if (res == TRI_ERROR_NOT_IMPLEMENTED) {
+    generateError(HttpResponse::NOT_IMPLEMENTED, res, "stack sampling is not supported on this platform");
+    return status_t(HANDLER_DONE);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    generateError(HttpResponse::SERVER_ERROR, res);
+    return status_t(HANDLER_DONE);
+  }
+
+  _response = createResponse(HttpResponse::OK);
+  _response->setContentType("text/plain; charset=utf-8");
+  _response->setHeader("x-arango-samples", StringUtils::itoa(samples));
+  _response->setHeader("x-arango-samples-dropped", StringUtils::itoa(dropped));
+  _response->body().appendText(folded);
+
+  return status_t(HANDLER_DONE);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
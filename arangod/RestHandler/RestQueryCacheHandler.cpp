@@ -73,7 +73,17 @@ HttpHandler::status_t RestQueryCacheHandler::execute () {
 
   switch (type) {
     case HttpRequest::HTTP_REQUEST_DELETE: clearCache(); break;
-    case HttpRequest::HTTP_REQUEST_GET:    readProperties(); break;
+    case HttpRequest::HTTP_REQUEST_GET: {
+      auto const& suffix = _request->suffix();
+
+      if (suffix.size() == 1 && suffix[0] == "statistics") {
+        readStatistics();
+      }
+      else {
+        readProperties();
+      }
+      break;
+    }
     case HttpRequest::HTTP_REQUEST_PUT:    replaceProperties(); break;
 
     case HttpRequest::HTTP_REQUEST_POST:   
@@ -143,6 +153,9 @@ bool RestQueryCacheHandler::clearCache () {
 /// - *maxResults*: the maximum number of query results that will be stored per database-specific
 ///   cache.
 ///
+/// - *maxResultsSize*: the maximum memory usage, in bytes, of the query results that will be 
+///   stored per database-specific cache.
+///
 /// @RESTRETURNCODES
 ///
 /// @RESTRETURNCODE{200}
@@ -176,6 +189,61 @@ bool RestQueryCacheHandler::readProperties () {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @startDocuBlock GetApiQueryCacheStatistics
+/// @brief returns the statistics of the AQL query cache of the current database
+///
+/// @RESTHEADER{GET /_api/query-cache/statistics, Returns the statistics of the AQL query cache}
+///
+/// @RESTDESCRIPTION
+/// Returns the statistics of the AQL query cache of the current database as a
+/// JSON object with the following attributes:
+///
+/// - *results*: the number of query results in the cache.
+///
+/// - *memoryUsage*: the memory used by the query results, in bytes.
+///
+/// - *hits*: the number of lookups that found a result.
+///
+/// - *misses*: the number of lookups that did not find a result.
+///
+/// - *evictions*: the number of results removed to stay within the limits.
+///
+/// - *invalidations*: the number of results removed because of changes to
+///   their collections.
+///
+/// The figures are reset when the cache of the database is cleared.
+///
+/// @RESTRETURNCODES
+///
+/// @RESTRETURNCODE{200}
+/// Is returned if the statistics can be retrieved successfully.
+///
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+bool RestQueryCacheHandler::readStatistics () {
+  try {
+    auto queryCache = triagens::aql::QueryCache::instance();
+
+    Json result = queryCache->statistics(_vocbase);
+    generateResult(HttpResponse::OK, result.json());
+  }
+  catch (Exception const& err) {
+    handleError(err);
+  }
+  catch (std::exception const& ex) {
+    triagens::basics::Exception err(TRI_ERROR_INTERNAL, ex.what(), __FILE__, __LINE__);
+    handleError(err);
+  }
+  catch (...) {
+    triagens::basics::Exception err(TRI_ERROR_INTERNAL, __FILE__, __LINE__);
+    handleError(err);
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock PutApiQueryCacheProperties
 /// @brief changes the configuration for the AQL query cache
@@ -198,6 +266,11 @@ bool RestQueryCacheHandler::readProperties () {
 /// @RESTBODYPARAM{maxResults,integer,required,int64}
 /// the maximum number of query results that will be stored per database-specific cache.
 ///
+/// @RESTBODYPARAM{maxResultsSize,integer,optional,int64}
+/// the maximum memory usage, in bytes, of the query results that will be stored 
+/// per database-specific cache. If either limit is exceeded, the results with 
+/// the lowest ratio of hits and execution time to size are removed.
+///
 ///
 /// @RESTRETURNCODES
 ///
@@ -220,7 +293,7 @@ bool RestQueryCacheHandler::replaceProperties () {
     return true;
   }
 
-  std::unique_ptr<TRI_json_t> body(parseJsonBody());
+  TRI_json_t* body = parseJsonBody();
 
   if (body == nullptr) {
     // error message generated in parseJsonBody
@@ -230,19 +303,25 @@ bool RestQueryCacheHandler::replaceProperties () {
   auto queryCache = triagens::aql::QueryCache::instance();
 
   try {
-    std::pair<std::string, size_t> cacheProperties;
+    QueryCacheProperties cacheProperties;
     queryCache->properties(cacheProperties);
 
-    auto attribute = static_cast<TRI_json_t const*>(TRI_LookupObjectJson(body.get(), "mode"));
+    auto attribute = static_cast<TRI_json_t const*>(TRI_LookupObjectJson(body, "mode"));
 
     if (TRI_IsStringJson(attribute)) {
-      cacheProperties.first = std::string(attribute->_value._string.data, attribute->_value._string.length - 1);
+      cacheProperties.mode = std::string(attribute->_value._string.data, attribute->_value._string.length - 1);
     }
 
-    attribute = static_cast<TRI_json_t const*>(TRI_LookupObjectJson(body.get(), "maxResults"));
+    attribute = static_cast<TRI_json_t const*>(TRI_LookupObjectJson(body, "maxResults"));
    
     if (TRI_IsNumberJson(attribute)) {
-      cacheProperties.second = static_cast<size_t>(attribute->_value._number);
+      cacheProperties.maxResults = static_cast<size_t>(attribute->_value._number);
+    }
+
+    attribute = static_cast<TRI_json_t const*>(TRI_LookupObjectJson(body, "maxResultsSize"));
+   
+    if (TRI_IsNumberJson(attribute) && attribute->_value._number > 0.0) {
+      cacheProperties.maxResultsSize = static_cast<size_t>(attribute->_value._number);
     }
 
     queryCache->setProperties(cacheProperties);
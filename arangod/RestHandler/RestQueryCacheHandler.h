@@ -88,6 +88,12 @@ namespace triagens {
 
         bool readProperties ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the statistics of the cache of the current database
+////////////////////////////////////////////////////////////////////////////////
+
+        bool readStatistics ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief changes the properties
 ////////////////////////////////////////////////////////////////////////////////
@@ -493,7 +493,7 @@ bool RestQueryHandler::replaceProperties () {
     return true;
   }
 
-  unique_ptr<TRI_json_t> body(parseJsonBody());
+  TRI_json_t* body = parseJsonBody();
 
   if (body == nullptr) {
     // error message generated in parseJsonBody
@@ -511,24 +511,24 @@ bool RestQueryHandler::replaceProperties () {
 
     // TODO(fc) add a "hasSomething" to JsonHelper?
 
-    if (JsonHelper::getObjectElement(body.get(), "enabled") != nullptr) {
-      enabled = JsonHelper::checkAndGetBooleanValue(body.get(), "enabled");
+    if (JsonHelper::getObjectElement(body, "enabled") != nullptr) {
+      enabled = JsonHelper::checkAndGetBooleanValue(body, "enabled");
     }
 
-    if (JsonHelper::getObjectElement(body.get(), "trackSlowQueries") != nullptr) {
-      trackSlowQueries = JsonHelper::checkAndGetBooleanValue(body.get(), "trackSlowQueries");
+    if (JsonHelper::getObjectElement(body, "trackSlowQueries") != nullptr) {
+      trackSlowQueries = JsonHelper::checkAndGetBooleanValue(body, "trackSlowQueries");
     }
 
-    if (JsonHelper::getObjectElement(body.get(), "maxSlowQueries") != nullptr) {
-      maxSlowQueries = JsonHelper::checkAndGetNumericValue<size_t>(body.get(), "maxSlowQueries");
+    if (JsonHelper::getObjectElement(body, "maxSlowQueries") != nullptr) {
+      maxSlowQueries = JsonHelper::checkAndGetNumericValue<size_t>(body, "maxSlowQueries");
     }
 
-    if (JsonHelper::getObjectElement(body.get(), "slowQueryThreshold") != nullptr) {
-      slowQueryThreshold = JsonHelper::checkAndGetNumericValue<double>(body.get(), "slowQueryThreshold");
+    if (JsonHelper::getObjectElement(body, "slowQueryThreshold") != nullptr) {
+      slowQueryThreshold = JsonHelper::checkAndGetNumericValue<double>(body, "slowQueryThreshold");
     }
 
-    if (JsonHelper::getObjectElement(body.get(), "maxQueryStringLength") != nullptr) {
-      maxQueryStringLength = JsonHelper::checkAndGetNumericValue<size_t>(body.get(), "maxQueryStringLength");
+    if (JsonHelper::getObjectElement(body, "maxQueryStringLength") != nullptr) {
+      maxQueryStringLength = JsonHelper::checkAndGetNumericValue<size_t>(body, "maxQueryStringLength");
     }
 
     queryList->enabled(enabled);
@@ -623,15 +623,15 @@ bool RestQueryHandler::parseQuery () {
     return true;
   }
 
-  unique_ptr<TRI_json_t> body(parseJsonBody());
+  TRI_json_t* body = parseJsonBody();
 
-  if (body.get() == nullptr) {
+  if (body == nullptr) {
     // error message generated in parseJsonBody
     return true;
   }
 
   try {
-    const string&& queryString = JsonHelper::checkAndGetStringValue(body.get(), "query");
+    const string&& queryString = JsonHelper::checkAndGetStringValue(body, "query");
 
     Query query(_applicationV8, true, _vocbase, queryString.c_str(), queryString.size(), nullptr, nullptr, PART_MAIN);
     
@@ -32,7 +32,9 @@
 #include "Basics/files.h"
 #include "Basics/JsonHelper.h"
 #include "Basics/logging.h"
+#include "Basics/MerkleTree.h"
 #include "Basics/ReadLocker.h"
+#include "Basics/ScopeGuard.h"
 #include "Cluster/ClusterMethods.h"
 #include "Cluster/ClusterComm.h"
 #include "HttpServer/HttpServer.h"
@@ -51,6 +53,7 @@
 #include "VocBase/server.h"
 #include "VocBase/update-policy.h"
 #include "Wal/LogfileManager.h"
+#include "Wal/Slots.h"
 
 using namespace std;
 using namespace triagens::basics;
@@ -65,6 +68,8 @@ uint64_t const RestReplicationHandler::defaultChunkSize = 128 * 1024;
 
 uint64_t const RestReplicationHandler::maxChunkSize     = 128 * 1024 * 1024;
 
+double const RestReplicationHandler::maxLoggerFollowWait = 10.0;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -188,6 +193,17 @@ HttpHandler::status_t RestReplicationHandler::execute () {
         handleCommandRemoveKeys();
       }
     }
+    else if (command == "tree") {
+      if (type != HttpRequest::HTTP_REQUEST_PUT) {
+        goto BAD_CALL;
+      }
+
+      if (isCoordinatorError()) {
+        return status_t(HttpHandler::HANDLER_DONE);
+      }
+
+      handleCommandTree();
+    }
     else if (command == "dump") {
       if (type != HttpRequest::HTTP_REQUEST_GET) {
         goto BAD_CALL;
@@ -408,10 +424,12 @@ bool RestReplicationHandler::isCoordinatorError () {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief insert the applier action into an action list
+/// @brief insert the applier action into an action list, and keep the
+/// logfiles after the fetched tick for the client
 ////////////////////////////////////////////////////////////////////////////////
 
-void RestReplicationHandler::insertClient (TRI_voc_tick_t lastServedTick) {
+void RestReplicationHandler::insertClient (TRI_voc_tick_t lastServedTick,
+                                           TRI_voc_tick_t fetchedTick) {
   bool found;
   char const* value = _request->value("serverId", found);
 
@@ -420,6 +438,7 @@ void RestReplicationHandler::insertClient (TRI_voc_tick_t lastServedTick) {
 
     if (serverId > 0) {
       _vocbase->updateReplicationClient(serverId, lastServedTick);
+      triagens::wal::LogfileManager::instance()->updateReplicationClient(_vocbase->_id, serverId, fetchedTick);
     }
   }
 }
@@ -474,6 +493,20 @@ uint64_t RestReplicationHandler::determineChunkSize () const {
 ///   - *totalEvents*: total number of events logged since the server was started.
 ///     The value is not reset between multiple stops and re-starts of the logger.
 ///
+///   - *totalSyncs*: total number of disk syncs of the write-ahead log since the
+///     server was started. Each sync can cover the events of many operations.
+///
+///   - *totalSyncedEvents*: total number of events covered by these syncs. The
+///     ratio of *totalSyncedEvents* and *totalSyncs* is the average number of
+///     events handled by one group commit.
+///
+///   - *pendingCollectorOperations*: number of operations the write-ahead log
+///     collector has transferred to datafiles, but not yet applied.
+///
+///   - *uncollectedLogfiles*: number of sealed write-ahead logfiles that still
+///     wait for collection. Together with *pendingCollectorOperations* this
+///     shows how far the collector lags behind.
+///
 ///   - *time*: the current date and time on the logger server
 ///
 /// - *server*: a JSON object with the following sub-attributes:
@@ -543,6 +576,10 @@ void RestReplicationHandler::handleCommandLoggerState () {
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "running", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, true));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "lastLogTick", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, lastTickString.c_str(), lastTickString.size()));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "totalEvents", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) s.numEvents));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "totalSyncs", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) s.numSyncs));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "totalSyncedEvents", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) s.numSyncedSlots));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "pendingCollectorOperations", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) s.numPendingCollectorOperations));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "uncollectedLogfiles", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) s.numUncollectedLogfiles));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, state, "time", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, s.timeString.c_str(), s.timeString.size()));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "state", state);
 
@@ -1070,6 +1107,11 @@ void RestReplicationHandler::handleTrampolineCoordinator () {
 /// @RESTQUERYPARAM{includeSystem,boolean,optional}
 /// Include system collections in the result. The default value is *true*.
 ///
+/// @RESTQUERYPARAM{wait,number,optional}
+/// Maximum number of seconds to wait for new log entries if there are none
+/// yet. The default value is *0*, which makes the server respond immediately.
+/// Values larger than 10 are reduced to 10.
+///
 /// @RESTDESCRIPTION
 /// Returns data from the server's replication log. This method can be called
 /// by replication clients after an initial synchronization of data. The method
@@ -1106,6 +1148,14 @@ void RestReplicationHandler::handleTrampolineCoordinator () {
 ///
 /// If *chunkSize* is not specified, some server-side default value will be used.
 ///
+/// The *wait* URL parameter turns the request into a long poll. If there are
+/// no log entries to return, the server keeps the request open until new log
+/// entries have been synced to disk or the specified number of seconds has
+/// passed. Clients that follow the log continuously can then send the next
+/// request right away instead of sleeping between requests, and get new log
+/// entries as soon as they are available. The *wait* parameter is ignored if
+/// the *to* parameter is used.
+///
 /// The *Content-Type* of the result is *application/x-arango-dump*. This is an
 /// easy-to-process format, with all log events going onto separate lines in the
 /// response body. Each log event itself is a JSON object, with at least the
@@ -1280,6 +1330,8 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
     return;
   }
 
+  bool const hasTo = found;
+
   bool includeSystem = true;
   value = _request->value("includeSystem", found);
 
@@ -1287,6 +1339,18 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
     includeSystem = StringUtils::boolean(value);
   }
 
+  // maximum time to wait for new log entries
+  double waitTime = 0.0;
+  value = _request->value("wait", found);
+
+  if (found && ! hasTo) {
+    waitTime = StringUtils::doubleDecimal(value);
+
+    if (waitTime > maxLoggerFollowWait) {
+      waitTime = maxLoggerFollowWait;
+    }
+  }
+
   // grab list of transactions from the body value
   std::unordered_set<TRI_voc_tid_t> transactionIds;
 
@@ -1329,6 +1393,29 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
     // and dump
     res = TRI_DumpLogReplication(&dump, transactionIds, firstRegularTick, tickStart, tickEnd, false);
 
+    if (waitTime > 0.0) {
+      double const end = TRI_microtime() + waitTime;
+      auto slots = triagens::wal::LogfileManager::instance()->slots();
+
+      // long poll: wait for new log entries while there are none to return.
+      // the new entries may belong to other databases or be filtered out,
+      // so check again until the time is up
+      while (res == TRI_ERROR_NO_ERROR &&
+             TRI_LengthStringBuffer(dump._buffer) == 0) {
+        double const now = TRI_microtime();
+
+        if (now >= end ||
+            ! slots->waitForDataTick(state.lastDataTick, static_cast<uint64_t>((end - now) * 1000000.0))) {
+          break;
+        }
+
+        state = triagens::wal::LogfileManager::instance()->state();
+        tickEnd = state.lastDataTick;
+
+        res = TRI_DumpLogReplication(&dump, transactionIds, firstRegularTick, tickStart, tickEnd, false);
+      }
+    }
+
     if (res == TRI_ERROR_NO_ERROR) {
       bool const checkMore = (dump._lastFoundTick > 0 && dump._lastFoundTick != state.lastDataTick);
 
@@ -1371,9 +1458,19 @@ void RestReplicationHandler::handleCommandLoggerFollow () {
 
         // to avoid double freeing
         TRI_StealStringBuffer(dump._buffer);
+
+        deflateResponse();
+      }
+
+      // the client has everything up to the start tick, but may still need
+      // to read open transactions from before
+      TRI_voc_tick_t fetchedTick = tickStart;
+
+      if (firstRegularTick > 0 && firstRegularTick <= fetchedTick) {
+        fetchedTick = firstRegularTick - 1;
       }
 
-      insertClient(dump._lastFoundTick);
+      insertClient(dump._lastFoundTick, fetchedTick);
     }
   }
   catch (triagens::basics::Exception const& ex) {
@@ -1652,7 +1749,12 @@ void RestReplicationHandler::handleCommandInventory () {
   std::string const tickString(std::to_string(tick));
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, &json, "tick", TRI_CreateStringCopyJson(TRI_CORE_MEM_ZONE, tickString.c_str(), tickString.size()));
 
+  // a client that starts a full synchronization will follow the log from
+  // the inventory tick on, so keep the logfiles from there
+  insertClient(0, tick);
+
   generateResult(&json);
+  deflateResponse();
   TRI_DestroyJson(TRI_CORE_MEM_ZONE, &json);
 }
 
@@ -1861,6 +1963,11 @@ int RestReplicationHandler::createCollection (TRI_json_t const* json,
   params._isVolatile   = JsonHelper::getBooleanValue(json, "isVolatile", false);
   params._isSystem     = (name[0] == '_');
   params._indexBuckets = JsonHelper::getNumericValue<uint32_t>(json, "indexBuckets", TRI_DEFAULT_INDEX_BUCKETS);
+
+  if (JsonHelper::isArray(JsonHelper::getObjectElement(json, "stringDictionary"))) {
+    // the slave collection stores the same values as dictionary codes
+    params._stringDictionary = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, JsonHelper::getObjectElement(json, "stringDictionary"));
+  }
   params._planId       = 0;
 
   TRI_voc_cid_t planId = JsonHelper::stringUInt64(json, "planId");
@@ -2595,6 +2702,20 @@ int RestReplicationHandler::processRestoreDataBatch (CollectionNameResolver cons
   string const invalidMsg = "received invalid JSON data for collection " +
                             StringUtils::itoa(trxCollection->_cid);
 
+  // lines are parsed into an arena that is reset for each line
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(64 * 1024);
+
+  if (zone == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&zone]() -> void {
+      TRI_FreeArenaMemoryZone(zone);
+    }
+  };
+
   char const* ptr = _request->body();
   char const* end = ptr + _request->bodySize();
 
@@ -2610,13 +2731,10 @@ int RestReplicationHandler::processRestoreDataBatch (CollectionNameResolver cons
 
     if (pos - ptr > 1) {
       // found something
-      TRI_json_t* json = TRI_JsonString(TRI_CORE_MEM_ZONE, ptr);
+      TRI_ResetArenaMemoryZone(zone);
+      TRI_json_t* json = TRI_JsonString(zone, ptr);
 
       if (! JsonHelper::isObject(json)) {
-        if (json != nullptr) {
-          TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
-        }
-
         errorMsg = invalidMsg;
 
         return TRI_ERROR_HTTP_CORRUPTED_JSON;
@@ -2633,7 +2751,6 @@ int RestReplicationHandler::processRestoreDataBatch (CollectionNameResolver cons
         TRI_json_t const* element = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
 
         if (! JsonHelper::isString(element)) {
-          TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
           errorMsg = invalidMsg;
 
           return TRI_ERROR_HTTP_CORRUPTED_JSON;
@@ -2669,7 +2786,6 @@ int RestReplicationHandler::processRestoreDataBatch (CollectionNameResolver cons
 
       // key must not be 0, but doc can be 0!
       if (key == nullptr) {
-        TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
         errorMsg = invalidMsg;
 
         return TRI_ERROR_HTTP_BAD_PARAMETER;
@@ -2677,8 +2793,6 @@ int RestReplicationHandler::processRestoreDataBatch (CollectionNameResolver cons
 
       int res = applyCollectionDumpMarker(resolver, trxCollection, type, (const TRI_voc_key_t) key, rid, doc, errorMsg);
 
-      TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
-
       if (res != TRI_ERROR_NO_ERROR && ! force) {
         return res;
       }
@@ -2830,6 +2944,21 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
   const string invalidMsg = string("received invalid JSON data for collection ")
                             + name;
 
+  // lines are parsed into an arena that is reset for each line
+  TRI_memory_zone_t* zone = TRI_CreateArenaMemoryZone(64 * 1024);
+
+  if (zone == nullptr) {
+    generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+    return;
+  }
+
+  triagens::basics::ScopeGuard guard{
+    []() -> void { },
+    [&zone]() -> void {
+      TRI_FreeArenaMemoryZone(zone);
+    }
+  };
+
   char const* ptr = _request->body();
   char const* end = ptr + _request->bodySize();
 
@@ -2847,13 +2976,10 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
 
     if (pos - ptr > 1) {
       // found something
-      TRI_json_t* json = TRI_JsonString(TRI_CORE_MEM_ZONE, ptr);
+      TRI_ResetArenaMemoryZone(zone);
+      TRI_json_t* json = TRI_JsonString(zone, ptr);
 
       if (! JsonHelper::isObject(json)) {
-        if (json != nullptr) {
-          TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
-        }
-
         errorMsg = invalidMsg;
 
         res = TRI_ERROR_HTTP_CORRUPTED_JSON;
@@ -2870,7 +2996,6 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
         TRI_json_t const* element = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
 
         if (! JsonHelper::isString(element)) {
-          TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
           errorMsg = invalidMsg;
 
           res = TRI_ERROR_HTTP_CORRUPTED_JSON;
@@ -2904,7 +3029,6 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
 
       // key must not be 0, but doc can be 0!
       if (key == nullptr) {
-        TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
         errorMsg = invalidMsg;
 
         res = TRI_ERROR_HTTP_BAD_PARAMETER;
@@ -2917,7 +3041,6 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
         res = ci->getResponsibleShard(col->id_as_string(), doc, true,
                                       responsibleShard, usesDefaultSharding);
         if (res != TRI_ERROR_NO_ERROR) {
-          TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
           errorMsg = "error during determining responsible shard";
           res = TRI_ERROR_INTERNAL;
           break;
@@ -2925,7 +3048,6 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
         else {
           it2 = shardTab.find(responsibleShard);
           if (it2 == shardTab.end()) {
-            TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
             errorMsg = "cannot find responsible shard";
             res = TRI_ERROR_INTERNAL;
             break;
@@ -2945,14 +3067,11 @@ void RestReplicationHandler::handleCommandRestoreDataCoordinator () {
       }
       else {
         // How very strange!
-        TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
         errorMsg = invalidMsg;
 
         res = TRI_ERROR_HTTP_BAD_PARAMETER;
         break;
       }
-
-      TRI_FreeJson(TRI_CORE_MEM_ZONE, json);
     }
 
     ptr = pos + 1;
@@ -3233,6 +3352,7 @@ void RestReplicationHandler::handleCommandGetKeys () {
       collectionKeys->release();
 
       generateResult(HttpResponse::OK, json.json());
+      deflateResponse();
     }
     catch (...) {
       collectionKeys->release();
@@ -3330,13 +3450,14 @@ void RestReplicationHandler::handleCommandFetchKeys () {
         collectionKeys->dumpKeys(json, chunk, chunkSize);
       }
       else {
-        std::unique_ptr<TRI_json_t> idsJson(parseJsonBody());
-        collectionKeys->dumpDocs(json, chunk, chunkSize, idsJson.get());
+        TRI_json_t* idsJson = parseJsonBody();
+        collectionKeys->dumpDocs(json, chunk, chunkSize, idsJson);
       }
 
       collectionKeys->release();
 
       generateResult(HttpResponse::OK, json.json());
+      deflateResponse();
     }
     catch (...) {
       collectionKeys->release();
@@ -3355,6 +3476,214 @@ void RestReplicationHandler::handleCommandFetchKeys () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns parts of the key tree of a collection
+///
+/// the body is an array. the following requests are supported:
+///
+/// - PUT /_api/replication/tree?collection=<name>&level=<level>: the body
+///   contains node indexes on the given level. returns the depth of the tree,
+///   the number of documents and the hash and count of each node
+///
+/// - PUT /_api/replication/tree/keys?collection=<name>&level=<level>: the
+///   body contains node indexes on the given level. returns the keys and
+///   revisions of all documents below these nodes
+///
+/// - PUT /_api/replication/tree/docs?collection=<name>: the body contains
+///   document keys. returns the documents that exist
+////////////////////////////////////////////////////////////////////////////////
+
+void RestReplicationHandler::handleCommandTree () {
+  std::vector<std::string> const& suffix = _request->suffix();
+
+  if (suffix.size() > 2 ||
+      (suffix.size() == 2 && suffix[1] != "keys" && suffix[1] != "docs")) {
+    generateError(HttpResponse::BAD,
+                  TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting PUT /_api/replication/tree[/keys|/docs]");
+    return;
+  }
+
+  std::string const what = (suffix.size() == 2 ? suffix[1] : "nodes");
+
+  char const* collection = _request->value("collection");
+
+  if (collection == nullptr) {
+    generateError(HttpResponse::BAD,
+                  TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "invalid collection parameter");
+    return;
+  }
+
+  uint32_t level = 0;
+  bool found;
+  char const* value = _request->value("level", found);
+
+  if (found) {
+    level = static_cast<uint32_t>(StringUtils::uint32(value));
+  }
+
+  if (level > triagens::basics::MerkleTree::MaxDepth) {
+    generateError(HttpResponse::BAD,
+                  TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "invalid level parameter");
+    return;
+  }
+
+  TRI_vocbase_col_t* c = TRI_LookupCollectionByNameVocBase(_vocbase, collection);
+
+  if (c == nullptr) {
+    generateError(HttpResponse::NOT_FOUND, TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND);
+    return;
+  }
+
+  TRI_json_t const* body = parseJsonBody();
+
+  if (body == nullptr) {
+    // error already generated
+    return;
+  }
+
+  if (! TRI_IsArrayJson(body)) {
+    generateError(HttpResponse::BAD,
+                  TRI_ERROR_HTTP_BAD_PARAMETER,
+                  "expecting an array as body");
+    return;
+  }
+
+  size_t const n = TRI_LengthArrayJson(body);
+  int res = TRI_ERROR_NO_ERROR;
+
+  try {
+    triagens::arango::CollectionGuard guard(_vocbase, c->_cid, false);
+
+    // the read lock keeps the tree and the primary index consistent
+    SingleCollectionReadOnlyTransaction trx(new StandaloneTransactionContext(), _vocbase, c->_cid);
+
+    res = trx.begin();
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      THROW_ARANGO_EXCEPTION(res);
+    }
+
+    TRI_document_collection_t* document = trx.documentCollection();
+    auto tree = document->_keyTree;
+
+    if (tree == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_INTERNAL);
+    }
+
+    triagens::basics::Json json(triagens::basics::Json::Object);
+
+    if (what == "nodes") {
+      if (level > tree->depth()) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+      }
+
+      triagens::basics::Json nodes(triagens::basics::Json::Array, n);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto index = static_cast<TRI_json_t const*>(TRI_AtVector(&body->_value._objects, i));
+
+        if (! TRI_IsNumberJson(index) ||
+            index->_value._number < 0.0 ||
+            index->_value._number >= static_cast<double>(static_cast<uint64_t>(1) << level)) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+        }
+
+        auto const& node = tree->node(level, static_cast<uint64_t>(index->_value._number));
+
+        triagens::basics::Json pair(triagens::basics::Json::Array, 2);
+        pair.add(triagens::basics::Json(std::to_string(node._hash)));
+        pair.add(triagens::basics::Json(static_cast<double>(node._count)));
+        nodes.add(pair);
+      }
+
+      json.set("depth", triagens::basics::Json(static_cast<double>(tree->depth())));
+      json.set("count", triagens::basics::Json(static_cast<double>(tree->count())));
+      json.set("nodes", nodes);
+    }
+    else if (what == "keys") {
+      std::unordered_set<uint64_t> buckets;
+
+      for (size_t i = 0; i < n; ++i) {
+        auto index = static_cast<TRI_json_t const*>(TRI_AtVector(&body->_value._objects, i));
+
+        if (! TRI_IsNumberJson(index) ||
+            index->_value._number < 0.0) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+        }
+
+        buckets.emplace(static_cast<uint64_t>(index->_value._number));
+      }
+
+      triagens::basics::Json keys(triagens::basics::Json::Array);
+      auto idx = document->primaryIndex();
+
+      triagens::basics::BucketPosition position;
+      uint64_t total = 0;
+
+      while (! buckets.empty()) {
+        auto ptr = idx->lookupSequential(position, total);
+
+        if (ptr == nullptr) {
+          // done
+          break;
+        }
+
+        if (buckets.find(triagens::basics::MerkleTree::bucket(level, ptr->_hash)) == buckets.end()) {
+          continue;
+        }
+
+        triagens::basics::Json pair(triagens::basics::Json::Array, 2);
+        pair.add(triagens::basics::Json(std::string(TRI_EXTRACT_MARKER_KEY(ptr))));  // PROTECTED by trx
+        pair.add(triagens::basics::Json(std::to_string(ptr->_rid)));
+        keys.add(pair);
+      }
+
+      json = keys;
+    }
+    else {
+      triagens::basics::Json docs(triagens::basics::Json::Array, n);
+      auto idx = document->primaryIndex();
+
+      for (size_t i = 0; i < n; ++i) {
+        auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&body->_value._objects, i));
+
+        if (! TRI_IsStringJson(key)) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+        }
+
+        auto ptr = idx->lookupKey(key->_value._string.data);
+
+        if (ptr == nullptr) {
+          // removed in the meantime
+          continue;
+        }
+
+        docs.transfer(CollectionKeys::documentToJson(document, *trx.resolver(), static_cast<TRI_df_marker_t const*>(ptr->getDataPtr())));  // PROTECTED by trx
+      }
+
+      json = docs;
+    }
+
+    trx.finish(TRI_ERROR_NO_ERROR);
+
+    generateResult(HttpResponse::OK, json.json());
+    deflateResponse();
+  }
+  catch (triagens::basics::Exception const& ex) {
+    res = ex.code();
+  }
+  catch (...) {
+    res = TRI_ERROR_INTERNAL;
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    generateError(HttpResponse::responseCode(res), res);
+  }
+}
+
 void RestReplicationHandler::handleCommandRemoveKeys () {
   std::vector<std::string> const& suffix = _request->suffix();
 
@@ -3418,6 +3747,9 @@ void RestReplicationHandler::handleCommandRemoveKeys () {
 /// @RESTQUERYPARAM{flush,boolean,optional}
 /// Whether or not to flush the WAL before dumping. The default value is *true*.
 ///
+/// @RESTQUERYPARAM{format,string,optional}
+/// The format of the result, either *json* (the default) or *binary*.
+///
 /// @RESTDESCRIPTION
 /// Returns the data from the collection for the requested range.
 ///
@@ -3467,6 +3799,14 @@ void RestReplicationHandler::handleCommandRemoveKeys () {
 ///
 /// **Note**: there will be no distinction between inserts and updates when calling this method.
 ///
+/// With *format=binary*, the *Content-Type* of the result is
+/// *application/x-arango-dump-binary*. The body then contains the markers as
+/// they are stored in the datafiles, each preceded by a small header and
+/// followed by the names of the collections an edge points to and the shapes
+/// and attribute names of the document. This format is used by the initial
+/// synchronization of followers, which can then store documents without
+/// converting them to and from JSON. It ignores *ticks* and *translateIds*.
+///
 /// @RESTRETURNCODES
 ///
 /// @RESTRETURNCODE{200}
@@ -3595,6 +3935,21 @@ void RestReplicationHandler::handleCommandDump () {
     translateCollectionIds = StringUtils::boolean(value);
   }
 
+  bool binary = false;
+  value = _request->value("format", found);
+
+  if (found) {
+    if (strcmp(value, "binary") == 0) {
+      binary = true;
+    }
+    else if (strcmp(value, "json") != 0) {
+      generateError(HttpResponse::BAD,
+                    TRI_ERROR_HTTP_BAD_PARAMETER,
+                    "invalid value for 'format'");
+      return;
+    }
+  }
+
   TRI_vocbase_col_t* c = TRI_LookupCollectionByNameVocBase(_vocbase, collection);
 
   if (c == nullptr) {
@@ -3621,6 +3976,7 @@ void RestReplicationHandler::handleCommandDump () {
 
     // initialize the dump container
     TRI_replication_dump_t dump(_vocbase, (size_t) determineChunkSize(), includeSystem);
+    dump._binary = binary;
 
     res = TRI_DumpCollectionReplication(&dump, col, tickStart, tickEnd, withTicks, translateCollectionIds);
 
@@ -3638,7 +3994,12 @@ void RestReplicationHandler::handleCommandDump () {
       _response = createResponse(HttpResponse::OK);
     }
 
-    _response->setContentType("application/x-arango-dump; charset=utf-8");
+    if (binary) {
+      _response->setContentType(TRI_REPLICATION_DUMP_BINARY_CONTENT_TYPE);
+    }
+    else {
+      _response->setContentType("application/x-arango-dump; charset=utf-8");
+    }
 
     // set headers
     _response->setHeader(TRI_REPLICATION_HEADER_CHECKMORE,
@@ -3654,6 +4015,12 @@ void RestReplicationHandler::handleCommandDump () {
 
     // avoid double freeing
     TRI_StealStringBuffer(dump._buffer);
+
+    deflateResponse();
+
+    // a full synchronization may take longer than the retention time of the
+    // logfiles, so the client counts as seen while it is dumping
+    insertClient(0, 0);
   }
   catch (triagens::basics::Exception const& ex) {
     res = ex.code();
@@ -3715,6 +4082,14 @@ void RestReplicationHandler::handleCommandDump () {
 /// the requested maximum size for log transfer packets that
 /// is used when the endpoint is contacted.
 ///
+/// @RESTBODYPARAM{syncParallelism,integer,optional,int64}
+/// the number of collections that the initial synchronization dumps from
+/// the endpoint at the same time. The default value is *1*.
+///
+/// @RESTBODYPARAM{applyParallelism,integer,optional,int64}
+/// the number of collections that the replication applier writes to at the
+/// same time. The default value is *1*.
+///
 /// @RESTBODYPARAM{adaptivePolling,boolean,required,}
 /// whether or not the replication applier will use adaptive polling.
 ///
@@ -3839,24 +4214,24 @@ void RestReplicationHandler::handleCommandDump () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void RestReplicationHandler::handleCommandMakeSlave () {
-  std::unique_ptr<TRI_json_t> json(parseJsonBody());
+  TRI_json_t* json = parseJsonBody();
 
   if (json == nullptr) {
     generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER);
     return;
   }
 
-  std::string const endpoint = JsonHelper::getStringValue(json.get(), "endpoint", "");
-  std::string const database = JsonHelper::getStringValue(json.get(), "database", _vocbase->_name);
-  std::string const username = JsonHelper::getStringValue(json.get(), "username", "");
-  std::string const password = JsonHelper::getStringValue(json.get(), "password", "");
+  std::string const endpoint = JsonHelper::getStringValue(json, "endpoint", "");
+  std::string const database = JsonHelper::getStringValue(json, "database", _vocbase->_name);
+  std::string const username = JsonHelper::getStringValue(json, "username", "");
+  std::string const password = JsonHelper::getStringValue(json, "password", "");
 
   if (endpoint.empty()) {
     generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER, "<endpoint> must be a valid endpoint");
     return;
   }
 
-  std::string const restrictType = JsonHelper::getStringValue(json.get(), "restrictType", "");
+  std::string const restrictType = JsonHelper::getStringValue(json, "restrictType", "");
 
   // initialize some defaults to copy from
   TRI_replication_applier_configuration_t defaults;
@@ -3870,20 +4245,22 @@ void RestReplicationHandler::handleCommandMakeSlave () {
   config._database           = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, database.c_str(), database.size());
   config._username           = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, username.c_str(), username.size());
   config._password           = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, password.c_str(), password.size());
-  config._includeSystem      = JsonHelper::getBooleanValue(json.get(), "includeSystem", true);
+  config._includeSystem      = JsonHelper::getBooleanValue(json, "includeSystem", true);
   config._autoStart          = true;
-  config._requestTimeout     = JsonHelper::getNumericValue<double>(json.get(), "requestTimeout", defaults._requestTimeout);
-  config._connectTimeout     = JsonHelper::getNumericValue<double>(json.get(), "connectTimeout", defaults._connectTimeout);
-  config._ignoreErrors       = JsonHelper::getNumericValue<uint64_t>(json.get(), "ignoreErrors", defaults._ignoreErrors);
-  config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json.get(), "maxConnectRetries", defaults._maxConnectRetries);
-  config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json.get(), "sslProtocol", defaults._sslProtocol);
-  config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json.get(), "chunkSize", defaults._chunkSize);
-  config._adaptivePolling    = JsonHelper::getBooleanValue(json.get(), "adaptivePolling", defaults._adaptivePolling);
-  config._verbose            = JsonHelper::getBooleanValue(json.get(), "verbose", defaults._verbose);
-  config._requireFromPresent = JsonHelper::getBooleanValue(json.get(), "requireFromPresent", defaults._requireFromPresent);
-  config._restrictType       = JsonHelper::getStringValue(json.get(), "restrictType", defaults._restrictType);
+  config._requestTimeout     = JsonHelper::getNumericValue<double>(json, "requestTimeout", defaults._requestTimeout);
+  config._connectTimeout     = JsonHelper::getNumericValue<double>(json, "connectTimeout", defaults._connectTimeout);
+  config._ignoreErrors       = JsonHelper::getNumericValue<uint64_t>(json, "ignoreErrors", defaults._ignoreErrors);
+  config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json, "maxConnectRetries", defaults._maxConnectRetries);
+  config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json, "sslProtocol", defaults._sslProtocol);
+  config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json, "chunkSize", defaults._chunkSize);
+  config._syncParallelism    = JsonHelper::getNumericValue<uint64_t>(json, "syncParallelism", defaults._syncParallelism);
+  config._applyParallelism   = JsonHelper::getNumericValue<uint64_t>(json, "applyParallelism", defaults._applyParallelism);
+  config._adaptivePolling    = JsonHelper::getBooleanValue(json, "adaptivePolling", defaults._adaptivePolling);
+  config._verbose            = JsonHelper::getBooleanValue(json, "verbose", defaults._verbose);
+  config._requireFromPresent = JsonHelper::getBooleanValue(json, "requireFromPresent", defaults._requireFromPresent);
+  config._restrictType       = JsonHelper::getStringValue(json, "restrictType", defaults._restrictType);
   
-  TRI_json_t* restriction = JsonHelper::getObjectElement(json.get(), "restrictCollections");
+  TRI_json_t* restriction = JsonHelper::getObjectElement(json, "restrictCollections");
 
   if (TRI_IsArrayJson(restriction)) {
     size_t const n = TRI_LengthArrayJson(restriction);
@@ -4005,6 +4382,10 @@ void RestReplicationHandler::handleCommandMakeSlave () {
 /// The default value is *false*, meaning that the complete data from the remote 
 /// collection will be transferred.
 ///
+/// @RESTBODYPARAM{syncParallelism,integer,optional,int64}
+/// the number of collections that the initial synchronization dumps from
+/// the endpoint at the same time. The default value is *1*.
+///
 /// @RESTBODYPARAM{restrictType,string,optional,string}
 /// an optional string value for collection filtering. When
 /// specified, the allowed values are *include* or *exclude*.
@@ -4067,29 +4448,30 @@ void RestReplicationHandler::handleCommandMakeSlave () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void RestReplicationHandler::handleCommandSync () {
-  std::unique_ptr<TRI_json_t> json(parseJsonBody());
+  TRI_json_t* json = parseJsonBody();
 
   if (json == nullptr) {
     generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER);
     return;
   }
 
-  std::string const endpoint = JsonHelper::getStringValue(json.get(), "endpoint", "");
-  std::string const database = JsonHelper::getStringValue(json.get(), "database", _vocbase->_name);
-  std::string const username = JsonHelper::getStringValue(json.get(), "username", "");
-  std::string const password = JsonHelper::getStringValue(json.get(), "password", "");
+  std::string const endpoint = JsonHelper::getStringValue(json, "endpoint", "");
+  std::string const database = JsonHelper::getStringValue(json, "database", _vocbase->_name);
+  std::string const username = JsonHelper::getStringValue(json, "username", "");
+  std::string const password = JsonHelper::getStringValue(json, "password", "");
 
   if (endpoint.empty()) {
     generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER, "<endpoint> must be a valid endpoint");
     return;
   }
 
-  bool const verbose       = JsonHelper::getBooleanValue(json.get(), "verbose", false);
-  bool const includeSystem = JsonHelper::getBooleanValue(json.get(), "includeSystem", true);
-  bool const incremental   = JsonHelper::getBooleanValue(json.get(), "incremental", false);
+  bool const verbose       = JsonHelper::getBooleanValue(json, "verbose", false);
+  bool const includeSystem = JsonHelper::getBooleanValue(json, "includeSystem", true);
+  bool const incremental   = JsonHelper::getBooleanValue(json, "incremental", false);
+  uint64_t const syncParallelism = JsonHelper::getNumericValue<uint64_t>(json, "syncParallelism", 1);
 
   std::unordered_map<string, bool> restrictCollections;
-  TRI_json_t* restriction = JsonHelper::getObjectElement(json.get(), "restrictCollections");
+  TRI_json_t* restriction = JsonHelper::getObjectElement(json, "restrictCollections");
 
   if (TRI_IsArrayJson(restriction)) {
     size_t const n = TRI_LengthArrayJson(restriction);
@@ -4103,7 +4485,7 @@ void RestReplicationHandler::handleCommandSync () {
     }
   }
 
-  string restrictType = JsonHelper::getStringValue(json.get(), "restrictType", "");
+  string restrictType = JsonHelper::getStringValue(json, "restrictType", "");
 
   if ((restrictType.empty() && ! restrictCollections.empty()) ||
       (! restrictType.empty() && restrictCollections.empty()) ||
@@ -4120,6 +4502,7 @@ void RestReplicationHandler::handleCommandSync () {
   config._password = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, password.c_str(), password.size());
   config._includeSystem = includeSystem;
   config._verbose = verbose;
+  config._syncParallelism = syncParallelism;
       
   InitialSyncer syncer(_vocbase, &config, restrictCollections, restrictType, verbose);
   TRI_DestroyConfigurationReplicationApplier(&config);
@@ -4366,6 +4749,14 @@ void RestReplicationHandler::handleCommandApplierGetConfig () {
 /// the requested maximum size for log transfer packets that
 /// is used when the endpoint is contacted.
 ///
+/// @RESTBODYPARAM{syncParallelism,integer,optional,int64}
+/// the number of collections that the initial synchronization dumps from
+/// the endpoint at the same time. The default value is *1*.
+///
+/// @RESTBODYPARAM{applyParallelism,integer,optional,int64}
+/// the number of collections that the replication applier writes to at the
+/// same time. The default value is *1*.
+///
 /// @RESTBODYPARAM{autoStart,boolean,required,}
 /// whether or not to auto-start the replication applier on
 /// (next and following) server starts
@@ -4461,7 +4852,7 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
   TRI_replication_applier_configuration_t config;
   TRI_InitConfigurationReplicationApplier(&config);
 
-  std::unique_ptr<TRI_json_t> json(parseJsonBody());
+  TRI_json_t* json = parseJsonBody();
 
   if (json == nullptr) {
     generateError(HttpResponse::BAD, TRI_ERROR_HTTP_BAD_PARAMETER);
@@ -4474,7 +4865,7 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
   }
 
   TRI_json_t const* value;
-  const string endpoint = JsonHelper::getStringValue(json.get(), "endpoint", "");
+  const string endpoint = JsonHelper::getStringValue(json, "endpoint", "");
 
   if (! endpoint.empty()) {
     if (config._endpoint != nullptr) {
@@ -4483,7 +4874,7 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
     config._endpoint = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, endpoint.c_str(), endpoint.size());
   }
 
-  value = JsonHelper::getObjectElement(json.get(), "database");
+  value = JsonHelper::getObjectElement(json, "database");
   if (config._database != nullptr) {
     // free old value
     TRI_FreeString(TRI_CORE_MEM_ZONE, config._database);
@@ -4496,7 +4887,7 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
     config._database = TRI_DuplicateStringZ(TRI_CORE_MEM_ZONE, _vocbase->_name);
   }
 
-  value = JsonHelper::getObjectElement(json.get(), "username");
+  value = JsonHelper::getObjectElement(json, "username");
   if (JsonHelper::isString(value)) {
     if (config._username != nullptr) {
       TRI_FreeString(TRI_CORE_MEM_ZONE, config._username);
@@ -4504,7 +4895,7 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
     config._username = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, value->_value._string.data, value->_value._string.length - 1);
   }
 
-  value = JsonHelper::getObjectElement(json.get(), "password");
+  value = JsonHelper::getObjectElement(json, "password");
   if (JsonHelper::isString(value)) {
     if (config._password != nullptr) {
       TRI_FreeString(TRI_CORE_MEM_ZONE, config._password);
@@ -4512,20 +4903,22 @@ void RestReplicationHandler::handleCommandApplierSetConfig () {
     config._password = TRI_DuplicateString2Z(TRI_CORE_MEM_ZONE, value->_value._string.data, value->_value._string.length - 1);
   }
 
-  config._requestTimeout     = JsonHelper::getNumericValue<double>(json.get(), "requestTimeout", config._requestTimeout);
-  config._connectTimeout     = JsonHelper::getNumericValue<double>(json.get(), "connectTimeout", config._connectTimeout);
-  config._ignoreErrors       = JsonHelper::getNumericValue<uint64_t>(json.get(), "ignoreErrors", config._ignoreErrors);
-  config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json.get(), "maxConnectRetries", config._maxConnectRetries);
-  config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json.get(), "sslProtocol", config._sslProtocol);
-  config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json.get(), "chunkSize", config._chunkSize);
-  config._autoStart          = JsonHelper::getBooleanValue(json.get(), "autoStart", config._autoStart);
-  config._adaptivePolling    = JsonHelper::getBooleanValue(json.get(), "adaptivePolling", config._adaptivePolling);
-  config._includeSystem      = JsonHelper::getBooleanValue(json.get(), "includeSystem", config._includeSystem);
-  config._verbose            = JsonHelper::getBooleanValue(json.get(), "verbose", config._verbose);
-  config._requireFromPresent = JsonHelper::getBooleanValue(json.get(), "requireFromPresent", config._requireFromPresent);
-  config._restrictType       = JsonHelper::getStringValue(json.get(), "restrictType", config._restrictType);
+  config._requestTimeout     = JsonHelper::getNumericValue<double>(json, "requestTimeout", config._requestTimeout);
+  config._connectTimeout     = JsonHelper::getNumericValue<double>(json, "connectTimeout", config._connectTimeout);
+  config._ignoreErrors       = JsonHelper::getNumericValue<uint64_t>(json, "ignoreErrors", config._ignoreErrors);
+  config._maxConnectRetries  = JsonHelper::getNumericValue<uint64_t>(json, "maxConnectRetries", config._maxConnectRetries);
+  config._sslProtocol        = JsonHelper::getNumericValue<uint32_t>(json, "sslProtocol", config._sslProtocol);
+  config._chunkSize          = JsonHelper::getNumericValue<uint64_t>(json, "chunkSize", config._chunkSize);
+  config._syncParallelism    = JsonHelper::getNumericValue<uint64_t>(json, "syncParallelism", config._syncParallelism);
+  config._applyParallelism   = JsonHelper::getNumericValue<uint64_t>(json, "applyParallelism", config._applyParallelism);
+  config._autoStart          = JsonHelper::getBooleanValue(json, "autoStart", config._autoStart);
+  config._adaptivePolling    = JsonHelper::getBooleanValue(json, "adaptivePolling", config._adaptivePolling);
+  config._includeSystem      = JsonHelper::getBooleanValue(json, "includeSystem", config._includeSystem);
+  config._verbose            = JsonHelper::getBooleanValue(json, "verbose", config._verbose);
+  config._requireFromPresent = JsonHelper::getBooleanValue(json, "requireFromPresent", config._requireFromPresent);
+  config._restrictType       = JsonHelper::getStringValue(json, "restrictType", config._restrictType);
 
-  value = JsonHelper::getObjectElement(json.get(), "restrictCollections");
+  value = JsonHelper::getObjectElement(json, "restrictCollections");
 
   if (TRI_IsArrayJson(value)) {
     config._restrictCollections.clear();
@@ -4747,6 +5140,29 @@ void RestReplicationHandler::handleCommandApplierStop () {
 ///   - *totalOperationsExcluded*: the total number of log events excluded because
 ///     of *restrictCollections*.
 ///
+///   - *continuousSync*: a JSON object with statistics about the batches fetched
+///     from the endpoint since the applier was started. It is only present after
+///     the first batch and contains the following sub-attributes:
+///
+///     - *batches*, *bytesReceived*, *markersReceived*: the number of batches
+///       and the bytes and log events they contained
+///
+///     - *fetchTime*, *applyTime*, *waitTime*: the seconds spent fetching
+///       batches, applying them and waiting for new log events
+///
+///     - *bytesPerSecond*, *markersPerSecond*: the throughput over the time
+///       spent fetching, applying and waiting
+///
+///     - *applyTimeDistribution*: the apply time of batches with log events,
+///       with *sum*, *count* and *counts* per bucket of the request time
+///       distribution
+///
+///     - *lagTicks*: the difference between *lastAvailableContinuousTick* and
+///       *lastAppliedContinuousTick*
+///
+///     - *lagSeconds*: the time since the applier last fetched everything the
+///       endpoint had, or *0* if it has caught up
+///
 ///   - *progress*: a JSON object with details about the replication applier progress.
 ///     It contains the following sub-attributes if there is progress to report:
 ///
@@ -4853,6 +5269,41 @@ void RestReplicationHandler::handleCommandApplierDeleteState () {
   handleCommandApplierGetState();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress the response body if the client accepts it
+///
+/// dumps and logs of big documents compress well, and sending them is
+/// usually more expensive than compressing them. small bodies are sent
+/// as they are
+////////////////////////////////////////////////////////////////////////////////
+
+void RestReplicationHandler::deflateResponse () {
+  static size_t const MinDeflateSize = 16384;
+  static size_t const DeflateBufferSize = 65536;
+
+  size_t const length = _response->body().length();
+
+  if (length < MinDeflateSize) {
+    return;
+  }
+
+  bool found;
+  std::string const& acceptEncoding = _request->header("accept-encoding", found);
+
+  if (! found || acceptEncoding.find("deflate") == std::string::npos) {
+    return;
+  }
+
+  // the fastest level compresses JSON almost as well as the default one, but
+  // in a fraction of the time. if deflating fails, the body is left unchanged
+  // and sent uncompressed
+  if (_response->deflate(DeflateBufferSize, Z_BEST_SPEED) == TRI_ERROR_NO_ERROR) {
+    LOG_TRACE("deflated replication response from %llu to %llu bytes",
+              (unsigned long long) length,
+              (unsigned long long) _response->body().length());
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
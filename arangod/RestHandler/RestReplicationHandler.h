@@ -120,10 +120,12 @@ namespace triagens {
         bool isCoordinatorError ();
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief insert the applier action into an action list
+/// @brief insert the applier action into an action list, and keep the
+/// logfiles after the fetched tick for the client
 ////////////////////////////////////////////////////////////////////////////////
 
-        void insertClient (TRI_voc_tick_t);
+        void insertClient (TRI_voc_tick_t,
+                           TRI_voc_tick_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief determine chunk size from request
@@ -322,6 +324,12 @@ namespace triagens {
 
         void handleCommandRemoveKeys ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns parts of the key tree of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleCommandTree ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handle a dump command for a specific collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -376,6 +384,12 @@ namespace triagens {
 
         void handleCommandApplierDeleteState ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compress the response body if the client accepts it
+////////////////////////////////////////////////////////////////////////////////
+
+        void deflateResponse ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -394,6 +408,12 @@ namespace triagens {
 
         static const uint64_t maxChunkSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum time (in seconds) logger-follow waits for new log entries
+////////////////////////////////////////////////////////////////////////////////
+
+        static const double maxLoggerFollowWait;
+
      };
   }
 }
@@ -71,13 +71,13 @@ HttpHandler::status_t RestSimpleHandler::execute () {
   HttpRequest::HttpRequestType type = _request->requestType();
 
   if (type == HttpRequest::HTTP_REQUEST_PUT) {
-    std::unique_ptr<TRI_json_t> json(parseJsonBody());
+    TRI_json_t* json = parseJsonBody();
 
-    if (json.get() == nullptr) {
+    if (json == nullptr) {
       return status_t(HANDLER_DONE);
     }
 
-    if (! TRI_IsObjectJson(json.get())) {
+    if (! TRI_IsObjectJson(json)) {
       generateError(HttpResponse::BAD, TRI_ERROR_TYPE_ERROR, "expecting JSON object body");
       return status_t(HANDLER_DONE);
     }
@@ -85,10 +85,10 @@ HttpHandler::status_t RestSimpleHandler::execute () {
     char const* prefix = _request->requestPath();
 
     if (strcmp(prefix, RestVocbaseBaseHandler::SIMPLE_REMOVE_PATH.c_str()) == 0) {
-      removeByKeys(json.get());
+      removeByKeys(json);
     }
     else if (strcmp(prefix, RestVocbaseBaseHandler::SIMPLE_LOOKUP_PATH.c_str()) == 0) {
-      lookupByKeys(json.get());
+      lookupByKeys(json);
     }
     else {
       generateError(HttpResponse::BAD, TRI_ERROR_TYPE_ERROR, "unsupported value for <operation>");
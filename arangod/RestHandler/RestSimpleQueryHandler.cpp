@@ -173,13 +173,13 @@ HttpHandler::status_t RestSimpleQueryHandler::execute () {
 
 void RestSimpleQueryHandler::allDocuments () {
   try { 
-    std::unique_ptr<TRI_json_t> json(parseJsonBody());
+    TRI_json_t* json = parseJsonBody();
 
-    if (json.get() == nullptr) {
+    if (json == nullptr) {
       return;
     }
 
-    auto const value = TRI_LookupObjectJson(json.get(), "collection");
+    auto const value = TRI_LookupObjectJson(json, "collection");
 
     if (! TRI_IsStringJson(value)) {
       generateError(HttpResponse::BAD, TRI_ERROR_TYPE_ERROR, "expecting string for <collection>");
@@ -203,8 +203,8 @@ void RestSimpleQueryHandler::allDocuments () {
 
     std::string aql("FOR doc IN @@collection ");
       
-    auto const skip  = TRI_LookupObjectJson(json.get(), "skip");
-    auto const limit = TRI_LookupObjectJson(json.get(), "limit");
+    auto const skip  = TRI_LookupObjectJson(json, "skip");
+    auto const limit = TRI_LookupObjectJson(json, "limit");
 
     if (TRI_IsNumberJson(skip) || TRI_IsNumberJson(limit)) {
       aql.append("LIMIT @skip, @limit ");
@@ -233,13 +233,13 @@ void RestSimpleQueryHandler::allDocuments () {
 
     // pass on standard options
     {
-      auto value = TRI_LookupObjectJson(json.get(), "ttl");
+      auto value = TRI_LookupObjectJson(json, "ttl");
 
       if (value != nullptr) {
         data("ttl", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value)));
       }
 
-      value = TRI_LookupObjectJson(json.get(), "batchSize");
+      value = TRI_LookupObjectJson(json, "batchSize");
 
       if (value != nullptr) {
         data("batchSize", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value)));
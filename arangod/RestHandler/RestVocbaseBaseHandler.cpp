@@ -32,6 +32,7 @@
 #include "Basics/JsonHelper.h"
 #include "Basics/StringUtils.h"
 #include "Basics/conversions.h"
+#include "Basics/json-binary.h"
 #include "Basics/string-buffer.h"
 #include "Basics/tri-strings.h"
 #include "Rest/HttpRequest.h"
@@ -130,6 +131,7 @@ RestVocbaseBaseHandler::RestVocbaseBaseHandler (HttpRequest* request)
   : RestBaseHandler(request),
     _context(static_cast<VocbaseContext*>(request->getRequestContext())),
     _vocbase(_context->getVocbase()),
+    _jsonZone(nullptr),
     _nolockHeaderSet(nullptr) {
 }
 
@@ -138,6 +140,9 @@ RestVocbaseBaseHandler::RestVocbaseBaseHandler (HttpRequest* request)
 ////////////////////////////////////////////////////////////////////////////////
 
 RestVocbaseBaseHandler::~RestVocbaseBaseHandler () {
+  if (_jsonZone != nullptr) {
+    TRI_FreeArenaMemoryZone(_jsonZone);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -203,7 +208,6 @@ void RestVocbaseBaseHandler::generate20x (HttpResponse::HttpResponseCode respons
   string const&& rev = StringUtils::itoa(rid);
 
   _response = createResponse(responseCode);
-  _response->setContentType("application/json; charset=utf-8");
 
   if (responseCode != HttpResponse::OK) {
     // 200 OK is sent is case of delete or update.
@@ -227,6 +231,33 @@ void RestVocbaseBaseHandler::generate20x (HttpResponse::HttpResponseCode respons
     }
   }
 
+  if (_request->acceptsBinaryJson()) {
+    TRI_json_t* json = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE, 4);
+
+    if (json == nullptr) {
+      generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+      return;
+    }
+
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "error", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_ID, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, handle.c_str(), handle.size()));
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_REV, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, rev.c_str(), rev.size()));
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, TRI_VOC_ATTRIBUTE_KEY, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, key, strlen(key)));
+
+    _response->setContentType(TRI_BINARY_JSON_CONTENT_TYPE);
+    int res = TRI_StringifyBinaryJson(_response->body().stringBuffer(), json);
+
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      generateError(HttpResponse::SERVER_ERROR, res);
+    }
+
+    return;
+  }
+
+  _response->setContentType("application/json; charset=utf-8");
+
   // _id and _key are safe and do not need to be JSON-encoded
   _response->body()
     .appendText("{\"error\":false,\"" TRI_VOC_ATTRIBUTE_ID "\":\"")
@@ -307,91 +338,66 @@ void RestVocbaseBaseHandler::generateDocument (SingleCollectionReadOnlyTransacti
                                                TRI_doc_mptr_copy_t const& mptr,
                                                VocShaper* shaper,
                                                bool generateBody) {
+  TRI_string_buffer_t buffer;
+  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
 
-  CollectionNameResolver const* resolver = trx.resolver();
-
-  char const* key = TRI_EXTRACT_MARKER_KEY(&mptr);  // PROTECTED by trx from above
-  string const&& id = DocumentHelper::assembleDocumentId(resolver->getCollectionName(cid), key);
-
-  TRI_json_t augmented;
-  TRI_InitObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, 5);
-
-  TRI_json_t* idJson = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, id.c_str(), id.size());
-
-  if (idJson != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_ID, idJson);
-  }
-
-  // convert rid from uint64_t to string
-  string const&& rid = StringUtils::itoa(mptr._rid);
-  TRI_json_t* rev = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, rid.c_str(), rid.size());
-
-  if (rev != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_REV, rev);
-  }
-
-  TRI_json_t* keyJson = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, key, strlen(key));
-
-  if (keyJson != nullptr) {
-    TRI_Insert2ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_KEY, keyJson);
-  }
-
-  TRI_df_marker_type_t type = static_cast<TRI_df_marker_t const*>(mptr.getDataPtr())->_type;  // PROTECTED by trx passed from above
-
-  if (type == TRI_DOC_MARKER_KEY_EDGE) {
-    TRI_doc_edge_key_marker_t const* marker = static_cast<TRI_doc_edge_key_marker_t const*>(mptr.getDataPtr());  // PROTECTED by trx passed from above
-    string const&& from = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_fromCid), string((char*) marker + marker->_offsetFromKey));
-    string const&& to = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_toCid), string((char*) marker +  marker->_offsetToKey));
-
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, from.c_str(), from.size()));
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, to.c_str(), to.size()));
+  if (_request->acceptsBinaryJson()) {
+    DocumentHelper::encodeBinaryDocument(trx.resolver(),
+                                         cid,
+                                         static_cast<TRI_df_marker_t const*>(mptr.getDataPtr()),  // PROTECTED by trx passed from above
+                                         shaper,
+                                         &buffer);
   }
-  else if (type == TRI_WAL_MARKER_EDGE) {
-    triagens::wal::edge_marker_t const* marker = static_cast<triagens::wal::edge_marker_t const*>(mptr.getDataPtr());  // PROTECTED by trx passed from above
-    string const&& from = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_fromCid), string((char*) marker + marker->_offsetFromKey));
-    string const&& to = DocumentHelper::assembleDocumentId(resolver->getCollectionNameCluster(marker->_toCid), string((char*) marker +  marker->_offsetToKey));
-
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_FROM, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, from.c_str(), from.size()));
-    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, &augmented, TRI_VOC_ATTRIBUTE_TO, TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, to.c_str(), to.size()));
+  else {
+    stringifyDocument(trx, cid, mptr, shaper, &buffer);
   }
 
-  // add document identifier to buffer
-  TRI_string_buffer_t buffer;
-
-  // convert object to string
-  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+  generateDocument(mptr._rid, TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer), generateBody);
 
-  TRI_shaped_json_t shapedJson;
-  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, mptr.getDataPtr());  // PROTECTED by trx passed from above
-  TRI_StringifyAugmentedShapedJson(shaper, &buffer, &shapedJson, &augmented);
+  TRI_DestroyStringBuffer(&buffer);
+}
 
-  TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, &augmented);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates a document response from an already serialized body
+////////////////////////////////////////////////////////////////////////////////
 
-  if (idJson) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, idJson);
-  }
+void RestVocbaseBaseHandler::generateDocument (TRI_voc_rid_t rid,
+                                               char const* body,
+                                               size_t length,
+                                               bool generateBody) {
+  _response = createResponse(HttpResponse::OK);
 
-  if (rev) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, rev);
+  if (_request->acceptsBinaryJson()) {
+    _response->setContentType(TRI_BINARY_JSON_CONTENT_TYPE);
   }
-
-  if (keyJson) {
-    TRI_Free(TRI_UNKNOWN_MEM_ZONE, keyJson);
+  else {
+    _response->setContentType("application/json; charset=utf-8");
   }
 
-  // and generate a response
-  _response = createResponse(HttpResponse::OK);
-  _response->setContentType("application/json; charset=utf-8");
-  _response->setHeader("etag", 4, "\"" + rid + "\"");
+  _response->setHeader("etag", 4, "\"" + StringUtils::itoa(rid) + "\"");
 
   if (generateBody) {
-    _response->body().appendText(TRI_BeginStringBuffer(&buffer), TRI_LengthStringBuffer(&buffer));
+    _response->body().appendText(body, length);
   }
   else {
-    _response->headResponse(TRI_LengthStringBuffer(&buffer));
+    _response->headResponse(length);
   }
+}
 
-  TRI_DestroyStringBuffer(&buffer);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON representation of a document to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+void RestVocbaseBaseHandler::stringifyDocument (SingleCollectionReadOnlyTransaction& trx,
+                                                TRI_voc_cid_t cid,
+                                                TRI_doc_mptr_copy_t const& mptr,
+                                                VocShaper* shaper,
+                                                TRI_string_buffer_t* buffer) {
+  DocumentHelper::stringifyDocument(trx.resolver(),
+                                    cid,
+                                    static_cast<TRI_df_marker_t const*>(mptr.getDataPtr()),  // PROTECTED by trx passed from above
+                                    shaper,
+                                    buffer);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -466,6 +472,11 @@ void RestVocbaseBaseHandler::generateTransactionError (string const& collectionN
       return;
     }
 
+    case TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT: {
+      generateError(HttpResponse::SERVICE_UNAVAILABLE, res);
+      return;
+    }
+
     default:
       generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_INTERNAL, "failed with error: " + string(TRI_errno_string(res)));
   }
@@ -566,8 +577,15 @@ bool RestVocbaseBaseHandler::extractWaitForSync () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_json_t* RestVocbaseBaseHandler::parseJsonBody () {
+  TRI_memory_zone_t* zone = jsonZone();
+
+  if (zone == nullptr) {
+    generateError(HttpResponse::SERVER_ERROR, TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
   char* errmsg = nullptr;
-  TRI_json_t* json = _request->toJson(&errmsg);
+  TRI_json_t* json = _request->toJson(zone, &errmsg);
 
   if (json == nullptr) {
     if (errmsg == nullptr) {
@@ -592,13 +610,36 @@ TRI_json_t* RestVocbaseBaseHandler::parseJsonBody () {
     generateError(HttpResponse::BAD,
                   TRI_ERROR_HTTP_CORRUPTED_JSON,
                   "cannot parse json object");
-    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
     return nullptr;
   }
 
   return json;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena zone for request-scoped json
+///
+/// the block size is derived from the body size, as parsed json takes roughly
+/// twice the space of its text
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* RestVocbaseBaseHandler::jsonZone () {
+  if (_jsonZone == nullptr) {
+    size_t blockSize = _request->bodySize() * 2;
+
+    if (blockSize < 4096) {
+      blockSize = 4096;
+    }
+    else if (blockSize > 1024 * 1024) {
+      blockSize = 1024 * 1024;
+    }
+
+    _jsonZone = TRI_CreateArenaMemoryZone(blockSize);
+  }
+
+  return _jsonZone;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                           HANDLER
 // -----------------------------------------------------------------------------
@@ -331,6 +331,27 @@ namespace triagens {
                                VocShaper*,
                                bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates a document response from an already serialized body
+///
+/// The body must be binary json if the client accepts it, json otherwise.
+////////////////////////////////////////////////////////////////////////////////
+
+        void generateDocument (TRI_voc_rid_t,
+                               char const*,
+                               size_t,
+                               bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON representation of a document to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        void stringifyDocument (SingleCollectionReadOnlyTransaction& trx,
+                                TRI_voc_cid_t,
+                                TRI_doc_mptr_copy_t const&,
+                                VocShaper*,
+                                TRI_string_buffer_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief generate an error message for a transaction error
 ////////////////////////////////////////////////////////////////////////////////
@@ -364,10 +385,21 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief parses the body
+///
+/// The result is allocated in the request's arena zone (see jsonZone) and is
+/// released together with the handler. Callers must not free it, nor hand it
+/// to anything that outlives the request without copying it.
 ////////////////////////////////////////////////////////////////////////////////
 
         TRI_json_t* parseJsonBody ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena zone for request-scoped json, creating it on
+/// first use. returns nullptr if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* jsonZone ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extract a string attribute from a JSON array
 ///
@@ -406,6 +438,14 @@ namespace triagens {
 
         TRI_vocbase_t* _vocbase;
 
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arena zone for request-scoped json, created on first use
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_memory_zone_t* _jsonZone;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   Handler methods
 // -----------------------------------------------------------------------------
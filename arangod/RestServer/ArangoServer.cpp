@@ -36,6 +36,7 @@
 #include "Actions/actions.h"
 #include "Aql/Query.h"
 #include "Aql/QueryCache.h"
+#include "Aql/QueryPlanCache.h"
 #include "Aql/RestAqlHandler.h"
 #include "Basics/FileUtils.h"
 #include "Basics/Nonce.h"
@@ -46,6 +47,7 @@
 #include "Basics/files.h"
 #include "Basics/init.h"
 #include "Basics/logging.h"
+#include "Basics/memory-map.h"
 #include "Basics/messages.h"
 #include "Basics/ThreadPool.h"
 #include "Basics/tri-strings.h"
@@ -71,7 +73,10 @@
 #include "RestHandler/RestHandlerCreator.h"
 #include "RestHandler/RestImportHandler.h"
 #include "RestHandler/RestJobHandler.h"
+#include "RestHandler/RestLocksHandler.h"
+#include "RestHandler/RestMetricsHandler.h"
 #include "RestHandler/RestPleaseUpgradeHandler.h"
+#include "RestHandler/RestProfileHandler.h"
 #include "RestHandler/RestQueryCacheHandler.h"
 #include "RestHandler/RestQueryHandler.h"
 #include "RestHandler/RestReplicationHandler.h"
@@ -84,11 +89,15 @@
 #include "RestServer/VocbaseContext.h"
 #include "Scheduler/ApplicationScheduler.h"
 #include "Statistics/statistics.h"
+#include "Utils/DocumentCache.h"
 #include "V8/V8LineEditor.h"
 #include "V8/v8-conv.h"
 #include "V8/v8-utils.h"
 #include "V8Server/ApplicationV8.h"
+#include "VocBase/AuthCache.h"
 #include "VocBase/auth.h"
+#include "VocBase/cleanup.h"
+#include "VocBase/compactor.h"
 #include "VocBase/KeyGenerator.h"
 #include "VocBase/server.h"
 #include "Wal/LogfileManager.h"
@@ -232,6 +241,18 @@ void ArangoServer::defineHandlers (HttpHandlerFactory* factory) {
                       RestHandlerCreator<triagens::admin::RestAdminLogHandler>::createNoData, 
                       nullptr);
 
+  factory->addHandler("/_admin/locks",
+                      RestHandlerCreator<triagens::admin::RestLocksHandler>::createNoData,
+                      nullptr);
+
+  factory->addHandler("/_admin/metrics",
+                      RestHandlerCreator<triagens::admin::RestMetricsHandler>::createNoData,
+                      nullptr);
+
+  factory->addHandler("/_admin/profile",
+                      RestHandlerCreator<triagens::admin::RestProfileHandler>::createNoData,
+                      nullptr);
+
   factory->addPrefixHandler("/_admin/shutdown",
                             RestHandlerCreator<triagens::admin::RestShutdownHandler>::createData<void*>,
                             static_cast<void*>(_applicationServer));
@@ -359,12 +380,27 @@ ArangoServer::ArangoServer (int argc, char** argv)
     _disableAuthentication(false),
     _disableAuthenticationUnixSockets(false),
     _dispatcherThreads(8),
+    _backgroundThreads(2),
     _dispatcherQueueSize(16384),
+    _asyncJobMemory(256 * 1024 * 1024),
+    _asyncJobTtl(0.0),
+    _asyncJobSpillSize(4 * 1024 * 1024),
     _v8Contexts(8),
-    _indexThreads(2),
+    _v8ContextsMinimum(0),
+    _v8ContextsBackground(2),
+    _indexThreads(static_cast<int>((std::max)((size_t) 2, (std::min)(TRI_numberProcessors(), (size_t) 16)))),
     _databasePath(),
     _queryCacheMode("off"),
+    _hugePages("none"),
     _queryCacheMaxResults(128),
+    _queryCacheMaxResultsSize(64 * 1024 * 1024),
+    _queryPlanCacheMaxEntries(0),
+    _documentCacheMaxEntries(0),
+    _documentCacheMaxSize(0),
+    _compactionMaxRate(0),
+    _coldDatafileInterval(0.0),
+    _memoryTarget(0),
+    _unloadIdleTime(60.0),
     _defaultMaximalSize(TRI_JOURNAL_DEFAULT_MAXIMAL_SIZE),
     _defaultWaitForSync(false),
     _forceSyncProperties(true),
@@ -520,7 +556,7 @@ void ArangoServer::buildApplicationServer () {
     ("no-upgrade", "skip a database upgrade")
     ("start-service", "used to start as windows service")
     ("no-server", "do not start the server, if console is requested")
-    ("use-thread-affinity", &_threadAffinity, "try to set thread affinity (0=disable, 1=disjunct, 2=overlap, 3=scheduler, 4=dispatcher)")
+    ("use-thread-affinity", &_threadAffinity, "try to set thread affinity (0=disable, 1=disjunct, 2=overlap, 3=scheduler, 4=dispatcher, 5=numa)")
   ;
 
   // .............................................................................
@@ -572,6 +608,14 @@ void ArangoServer::buildApplicationServer () {
     ("database.disable-query-tracking", &_disableQueryTracking, "turn off AQL query tracking by default")
     ("database.query-cache-mode", &_queryCacheMode, "mode for the AQL query cache (on, off, demand)")
     ("database.query-cache-max-results", &_queryCacheMaxResults, "maximum number of results in query cache per database")
+    ("database.query-cache-max-results-size", &_queryCacheMaxResultsSize, "maximum memory usage (in bytes) of the results in query cache per database")
+    ("database.query-plan-cache-max-entries", &_queryPlanCacheMaxEntries, "maximum number of AQL execution plans in plan cache per database (0 = off)")
+    ("database.document-cache-max-entries", &_documentCacheMaxEntries, "maximum number of serialized documents in the single document read cache (0 = off)")
+    ("database.document-cache-max-size", &_documentCacheMaxSize, "maximum memory usage (in bytes) of the single document read cache (0 = unlimited)")
+    ("database.compaction-max-rate", &_compactionMaxRate, "maximum number of megabytes per second copied by the compactor of a database (0 = unlimited)")
+    ("database.cold-datafile-interval", &_coldDatafileInterval, "interval (in seconds) for releasing the memory of sealed datafiles (0 = off)")
+    ("database.memory-target", &_memoryTarget, "memory (in bytes) of the loaded collections of all databases above which idle collections are unloaded (0 = off)")
+    ("database.unload-idle-time", &_unloadIdleTime, "time (in seconds) a collection must not have been used before it is unloaded to reach the memory target")
     ("database.index-threads", &_indexThreads, "threads to start for parallel background index creation")
     ("database.throw-collection-not-loaded-error", &_throwCollectionNotLoadedError, "throw an error when accessing a collection that is still loading")
   ;
@@ -601,10 +645,13 @@ void ArangoServer::buildApplicationServer () {
     ("server.allow-use-database", &ALLOW_USE_DATABASE_IN_REST_ACTIONS, "allow change of database in REST actions, only needed for unittests")
     ("server.threads", &_dispatcherThreads, "number of threads for basic operations")
     ("server.additional-threads", &_additionalThreads, "number of threads in additional queues")
+    ("server.background-threads", &_backgroundThreads, "number of threads for tasks and Foxx queue jobs")
     ("server.hide-product-header", &HttpResponse::HideProductHeader, "do not expose \"Server: ArangoDB\" header in HTTP responses")
     ("server.foxx-queues", &_foxxQueues, "enable Foxx queues")
     ("server.foxx-queues-poll-interval", &_foxxQueuesPollInterval, "Foxx queue manager poll interval (in seconds)")
     ("server.session-timeout", &VocbaseContext::ServerSessionTtl, "timeout of web interface server sessions (in seconds)")
+    ("server.authentication-cache-timeout", &AuthCache::Timeout, "time for which verified credentials are remembered (in seconds, 0 = off)")
+    ("server.huge-pages", &_hugePages, "huge pages for large index tables (none, transparent, explicit)")
   ;
 
   bool disableStatistics = false;
@@ -614,11 +661,16 @@ void ArangoServer::buildApplicationServer () {
   ;
 
   additional["Javascript Options:help-admin"]
-    ("javascript.v8-contexts", &_v8Contexts, "number of V8 contexts that are created for executing JavaScript actions")
+    ("javascript.v8-contexts", &_v8Contexts, "maximum number of V8 contexts that are created for executing JavaScript actions")
+    ("javascript.v8-contexts-minimum", &_v8ContextsMinimum, "number of V8 contexts that are created at startup (0 = all)")
+    ("javascript.v8-contexts-background", &_v8ContextsBackground, "number of additional V8 contexts for tasks and Foxx queue jobs (0 = share all contexts)")
   ;
 
   additional["Server Options:help-admin"]
     ("scheduler.maximal-queue-size", &_dispatcherQueueSize, "maximum size of queue for asynchronous operations")
+    ("server.async-job-memory", &_asyncJobMemory, "maximum memory for stored async job results per database (0 = unlimited)")
+    ("server.async-job-ttl", &_asyncJobTtl, "seconds after which unfetched async job results are discarded (0 = never)")
+    ("server.async-job-spill-size", &_asyncJobSpillSize, "minimum body size of async job results written to disk (0 = never)")
   ;
 
   // .............................................................................
@@ -656,6 +708,9 @@ void ArangoServer::buildApplicationServer () {
   char* pp = TRI_GetTempPath();
   TRI_FreeString(TRI_CORE_MEM_ZONE, pp);
 
+  // limits for stored async job results, spilled bodies go to the temp-path
+  _jobManager->setLimits(_asyncJobMemory, _asyncJobTtl, _asyncJobSpillSize);
+
 
   IGNORE_DATAFILE_ERRORS = _ignoreDatafileErrors;
   
@@ -741,16 +796,57 @@ void ArangoServer::buildApplicationServer () {
   }
  
   TRI_SetThrowCollectionNotLoadedVocBase(nullptr, _throwCollectionNotLoadedError);
+
+  // throttle the compactors
+  TRI_SetMaxRateCompactorVocBase(_compactionMaxRate * 1024 * 1024);
+
+  // release the memory of sealed datafiles periodically
+  if (_coldDatafileInterval < 0.0) {
+    LOG_FATAL_AND_EXIT("invalid value for '--database.cold-datafile-interval'. expected a value >= 0");
+  }
+  TRI_SetColdDatafileIntervalVocBase(_coldDatafileInterval);
+
+  // unload idle collections when the loaded collections use too much memory
+  if (_unloadIdleTime < 0.0) {
+    LOG_FATAL_AND_EXIT("invalid value for '--database.unload-idle-time'. expected a value >= 0");
+  }
+  TRI_SetMemoryTargetVocBase(_memoryTarget, _unloadIdleTime);
   
   // set global query tracking flag
   triagens::aql::Query::DisableQueryTracking(_disableQueryTracking);
 
   // configure the query cache
   {
-    std::pair<std::string, size_t> cacheProperties{ _queryCacheMode, _queryCacheMaxResults };
+    triagens::aql::QueryCacheProperties cacheProperties{ _queryCacheMode, 
+                                                         static_cast<size_t>(_queryCacheMaxResults),
+                                                         static_cast<size_t>(_queryCacheMaxResultsSize) };
     triagens::aql::QueryCache::instance()->setProperties(cacheProperties);
   }
 
+  // configure huge pages for the tables of the primary and hash indexes
+  if (_hugePages == "none") {
+    TRI_SetHugePagesLargeTable(TRI_HUGE_PAGES_NONE);
+  }
+  else if (_hugePages == "transparent") {
+    TRI_SetHugePagesLargeTable(TRI_HUGE_PAGES_TRANSPARENT);
+  }
+  else if (_hugePages == "explicit") {
+    TRI_SetHugePagesLargeTable(TRI_HUGE_PAGES_EXPLICIT);
+  }
+  else {
+    LOG_FATAL_AND_EXIT("invalid value '%s' for --server.huge-pages", _hugePages.c_str());
+  }
+
+  // place the index tables of a collection on one NUMA node
+  TRI_SetNumaLargeTable(_threadAffinity == 5 && TRI_numberNumaNodes() > 1);
+
+  // configure the plan cache
+  triagens::aql::QueryPlanCache::instance()->setMaxEntries(static_cast<size_t>(_queryPlanCacheMaxEntries));
+
+  // configure the document cache
+  DocumentCache::instance()->setMaxSize(static_cast<size_t>(_documentCacheMaxSize));
+  DocumentCache::instance()->setMaxEntries(static_cast<size_t>(_documentCacheMaxEntries));
+
   // .............................................................................
   // now run arangod
   // .............................................................................
@@ -912,6 +1008,10 @@ int ArangoServer::startupServer () {
     // one V8 instance is taken by the console
     if (startServer) {
       ++_v8Contexts;
+
+      if (_v8ContextsMinimum > 0) {
+        ++_v8ContextsMinimum;
+      }
     }
   }
   else if (mode == OperationMode::MODE_UNITTESTS || mode == OperationMode::MODE_SCRIPT) {
@@ -924,7 +1024,14 @@ int ArangoServer::startupServer () {
   startupProgress();
 
   _applicationV8->setVocbase(vocbase);
-  _applicationV8->setConcurrency(_v8Contexts);
+  if (_v8ContextsBackground < 0) {
+    _v8ContextsBackground = 0;
+  }
+
+  // the contexts for background jobs come on top of the ones for requests
+  _applicationV8->setConcurrency(_v8ContextsMinimum,
+                                 _v8Contexts + _v8ContextsBackground,
+                                 _v8ContextsBackground);
   _applicationV8->defineDouble("DISPATCHER_THREADS", _dispatcherThreads);
   _applicationV8->defineDouble("V8_CONTEXTS", _v8Contexts);
 
@@ -960,6 +1067,13 @@ int ArangoServer::startupServer () {
                                             (int) _dispatcherQueueSize);
     }
 
+    if (_backgroundThreads < 1) {
+      _backgroundThreads = 1;
+    }
+
+    _applicationDispatcher->buildBackgroundQueue(_backgroundThreads,
+                                                 (int) _dispatcherQueueSize);
+
     for (size_t i = 0;  i < _additionalThreads.size();  ++i) {
       int n = _additionalThreads[i];
 
@@ -1096,12 +1210,35 @@ int ArangoServer::startupServer () {
 
         break;
 
+      case 5:
+        // threads are bound to NUMA nodes instead of cores
+        break;
+
       default:
         _threadAffinity = 0;
         break;
     }
 
-    if (_threadAffinity > 0) {
+    if (_threadAffinity == 5) {
+      size_t nodes = TRI_numberNumaNodes();
+
+      if (nodes > 1) {
+        vector<vector<size_t>> numaNodes;
+
+        for (size_t i = 0;  i < nodes;  ++i) {
+          numaNodes.emplace_back(TRI_numaNodeProcessors(i));
+        }
+
+        _applicationScheduler->setNumaAffinity(numaNodes);
+        _applicationDispatcher->setNumaAffinity(numaNodes);
+
+        LOG_INFO("spreading scheduler and dispatcher threads over %d NUMA nodes", (int) nodes);
+      }
+      else {
+        LOG_INFO("the server has a single NUMA node, not setting thread affinity");
+      }
+    }
+    else if (_threadAffinity > 0) {
       TRI_ASSERT(ns <= n);
       TRI_ASSERT(nd <= n);
 
@@ -327,6 +327,20 @@ namespace triagens {
 
 	std::vector<int> _additionalThreads;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of dispatcher threads for background JavaScript jobs
+/// @startDocuBlock backgroundThreads
+/// `--server.background-threads number`
+///
+/// Specifies the *number* of threads that run tasks and Foxx queue jobs. This
+/// is the maximum number of such jobs running at the same time. They are
+/// queued separately from HTTP requests, so a long-running job never delays
+/// a request in the dispatcher queue. The default value is *2*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _backgroundThreads;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum size of the dispatcher queue for asynchronous requests
 /// @startDocuBlock schedulerMaximalQueueSize
@@ -342,21 +356,92 @@ namespace triagens {
 
         int _dispatcherQueueSize;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory limit for stored async job results
+/// @startDocuBlock serverAsyncJobMemory
+/// `--server.async-job-memory size`
+///
+/// Specifies the number of body bytes that the stored results of async jobs
+/// (*x-arango-async: store*) may occupy in memory, per database. If the limit
+/// is exceeded, the oldest results of the database are discarded. A value of
+/// *0* disables the limit. The default is 256 MB.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _asyncJobMemory;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lifetime of stored async job results
+/// @startDocuBlock serverAsyncJobTtl
+/// `--server.async-job-ttl seconds`
+///
+/// Discards the result of an async job if it has not been fetched within
+/// *seconds* after the job has finished. A value of *0* keeps results until
+/// they are fetched or deleted, which is the default.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _asyncJobTtl;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spill size for stored async job results
+/// @startDocuBlock serverAsyncJobSpillSize
+/// `--server.async-job-spill-size size`
+///
+/// Results of async jobs with a body of *size* bytes or more are written to
+/// the temp path and read back when they are fetched. They do not count
+/// against `--server.async-job-memory`. A value of *0* keeps all results in
+/// memory. The default is 4 MB.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _asyncJobSpillSize;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of V8 contexts for executing JavaScript actions
 /// @startDocuBlock v8Contexts
 /// `--server.v8-contexts number`
 ///
-/// Specifies the *number* of V8 contexts that are created for executing 
-/// JavaScript code. More contexts allow execute more JavaScript actions in 
-/// parallel, provided that there are also enough threads available. Please
-/// note that each V8 context will use a substantial amount of memory and 
-/// requires periodic CPU processing time for garbage collection. 
+/// Specifies the maximum *number* of V8 contexts that are created for
+/// executing JavaScript code. More contexts allow execute more JavaScript
+/// actions in parallel, provided that there are also enough threads
+/// available. Please note that each V8 context will use a substantial amount
+/// of memory and requires periodic CPU processing time for garbage collection. 
 /// @endDocuBlock
 ////////////////////////////////////////////////////////////////////////////////
 
         int _v8Contexts;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of V8 contexts created at startup
+/// @startDocuBlock v8ContextsMinimum
+/// `--javascript.v8-contexts-minimum number`
+///
+/// Specifies the *number* of V8 contexts that are created at startup and that
+/// are always kept. When all contexts are busy, further contexts are created
+/// up to the number given in *--javascript.v8-contexts*. Contexts beyond the
+/// minimum are disposed again after they have not been used for a minute.
+/// The default value *0* creates all contexts at startup.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _v8ContextsMinimum;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of V8 contexts for background jobs
+/// @startDocuBlock v8ContextsBackground
+/// `--javascript.v8-contexts-background number`
+///
+/// Specifies the *number* of V8 contexts that are added for tasks and Foxx
+/// queue jobs. Background jobs never use more contexts at the same time, and
+/// the contexts given in *--javascript.v8-contexts* remain available for
+/// requests. With the value *0*, background jobs and requests share all
+/// contexts. The default value is *2*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        int _v8ContextsBackground;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of background threads for parallel index creation
 /// @startDocuBlock indexThreads
@@ -371,6 +456,12 @@ namespace triagens {
 /// If the number of index threads is greater than 1, it will also be used to
 /// built the edge index of a collection in parallel (this also requires the
 /// edge index in the collection to be split into multiple buckets).
+///
+/// The index threads are also used to open the datafiles of a collection in
+/// parallel when the collection is loaded.
+///
+/// The default value is the number of cores of the server, but at least 2
+/// and at most 16.
 /// @endDocuBlock
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -423,6 +514,29 @@ namespace triagens {
 
         std::string _queryCacheMode;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief huge pages for large index tables
+/// @startDocuBlock serverHugePages
+/// `--server.huge-pages`
+///
+/// Controls whether the tables of the primary index and the hash indexes
+/// are backed by huge pages, which reduces TLB misses when looking up
+/// documents in large collections. Possible values are:
+///
+/// * *none*: use regular pages (the default)
+/// * *transparent*: align large tables to huge pages and let the kernel
+///   back them with transparent huge pages
+/// * *explicit*: allocate large tables from the huge pages reserved in
+///   *vm.nr_hugepages*, and fall back to transparent huge pages if they are
+///   exhausted
+///
+/// Only tables of 2 MB and above are affected. Huge pages are only
+/// supported under Linux.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _hugePages;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum number of elements in the query cache per database
 /// @startDocuBlock queryCacheMaxResults
@@ -431,7 +545,9 @@ namespace triagens {
 /// Maximum number of query results that can be stored per database-specific 
 /// query cache. If a query is eligible for caching and the number of items in 
 /// the database's query cache is equal to this threshold value, another cached
-/// query result will be removed from the cache.
+/// query result will be removed from the cache. This is the result with the
+/// lowest ratio of hits and execution time to size, not necessarily the least
+/// recently used one.
 ///
 /// This option only has an effect if the query cache mode is set to either
 /// *on* or *demand*.
@@ -440,6 +556,170 @@ namespace triagens {
 
         uint64_t _queryCacheMaxResults;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory usage of the query cache per database
+/// @startDocuBlock queryCacheMaxResultsSize
+/// `--database.query-cache-max-results-size`
+///
+/// Maximum memory usage, in bytes, of the query results that are stored per
+/// database-specific query cache. Results are stored in their serialized form.
+/// When either this limit or the maximum number of results is exceeded,
+/// results are removed from the cache, preferring large results that were
+/// computed quickly and are rarely used. A single result larger than the
+/// limit is not stored at all.
+///
+/// The default value is *67108864* (64 MB).
+///
+/// This option only has an effect if the query cache mode is set to either
+/// *on* or *demand*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _queryCacheMaxResultsSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of execution plans in the plan cache per database
+/// @startDocuBlock queryPlanCacheMaxEntries
+/// `--database.query-plan-cache-max-entries`
+///
+/// Maximum number of optimized AQL execution plans that are kept per database.
+/// A query that is executed again with the same query string, bind parameter
+/// types and options will reuse the cached plan and skip parsing and 
+/// optimization. If the number of cached plans reaches this value, the least
+/// recently used plan will be removed from the cache.
+///
+/// Cached plans do not depend on the values of the bind parameters, so queries
+/// that differ only in their bind parameter values share a plan. The optimizer
+/// therefore cannot use the values, e.g. for constant folding or for sparse
+/// indexes. The values of collection bind parameters are part of the cache key.
+/// Queries that use bind parameters for LIMIT values, OPTIONS, WINDOW frames
+/// or attribute names are not cached.
+///
+/// Plans are invalidated when one of their collections is dropped or renamed,
+/// or when an index is created or dropped on one of their collections.
+///
+/// The default value is *0*, which turns the plan cache off.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _queryPlanCacheMaxEntries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of documents in the document cache
+/// @startDocuBlock documentCacheMaxEntries
+/// `--database.document-cache-max-entries`
+///
+/// Maximum number of documents that are kept for single document reads via
+/// the HTTP API and the AQL function DOCUMENT. A cached document is only used
+/// for the document revision it was built from, and is removed from the cache
+/// when the document is updated or removed. Concurrent reads of the same document revision share one
+/// serialization, even if the document is not cached yet. If the number of
+/// cached documents reaches this value, the least recently read document is
+/// removed from the cache. Edges are never cached.
+///
+/// The default value is *0*, which turns the document cache off.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _documentCacheMaxEntries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory usage of the document cache
+/// @startDocuBlock documentCacheMaxSize
+/// `--database.document-cache-max-size`
+///
+/// Maximum memory usage (in bytes) of the documents in the document cache.
+/// If the cached documents use more memory, the least recently read documents
+/// are removed from the cache. A document that alone exceeds the share of a
+/// cache partition is not cached.
+///
+/// The default value is *0*, which means the memory usage is only limited by
+/// the number of cached documents.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _documentCacheMaxSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum compaction rate
+/// @startDocuBlock databaseCompactionMaxRate
+/// `--database.compaction-max-rate`
+///
+/// Maximum number of megabytes per second the compactor of a database will
+/// copy from old datafiles into compacted ones. Limiting the rate reduces the
+/// I/O impact of compaction on other operations, at the price of dead data
+/// being reclaimed more slowly. While the compactor waits for its rate, it
+/// does not block writes into the collection being compacted.
+///
+/// Independent of this setting, the compactor copies at most 256 MB per
+/// round and compacts the collections with the most dead data first.
+///
+/// The default value is *0*, which does not limit the compaction rate.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _compactionMaxRate;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interval for releasing the memory of sealed datafiles
+/// @startDocuBlock databaseColdDatafileInterval
+/// `--database.cold-datafile-interval`
+///
+/// Interval (in seconds) in which the resident memory pages of all sealed
+/// datafiles of loaded collections are released. The datafiles remain mapped
+/// into memory, and their pages are read back from the operating system's
+/// page cache or from disk when they are accessed again. Setting this option
+/// keeps datafiles that are rarely read from occupying memory, which allows
+/// working with collections that are much larger than the available RAM.
+/// Regularly used data will be faulted in again after each release, so the
+/// interval should not be too small.
+///
+/// Journals and the datafiles of volatile collections are not affected.
+///
+/// The default value is *0*, which turns releasing datafiles off.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _coldDatafileInterval;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory target for the loaded collections
+/// @startDocuBlock databaseMemoryTarget
+/// `--database.memory-target`
+///
+/// The memory (in bytes) that the loaded collections of all databases should
+/// not exceed. The memory of a collection is estimated from its indexes, the
+/// master pointers of its documents and the size of its mapped datafiles and
+/// journals. When the loaded collections exceed the target, the collections
+/// that have not been used for the longest time are unloaded until the
+/// estimate is below the target again. Unloaded collections are loaded again
+/// automatically on their next use.
+///
+/// Only collections that have been idle for at least
+/// *--database.unload-idle-time* seconds are unloaded. System collections
+/// are never unloaded. The memory is checked about every ten seconds, so the
+/// target may be exceeded temporarily.
+///
+/// The default value is *0*, which never unloads collections.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _memoryTarget;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief minimum idle time of collections unloaded for the memory target
+/// @startDocuBlock databaseUnloadIdleTime
+/// `--database.unload-idle-time`
+///
+/// The time (in seconds) a collection must not have been used before it may
+/// be unloaded to reach *--database.memory-target*.
+///
+/// The default value is *60*.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _unloadIdleTime;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @startDocuBlock databaseMaximalJournalSize
 /// 
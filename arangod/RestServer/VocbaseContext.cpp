@@ -348,17 +348,11 @@ HttpResponse::HttpResponseCode VocbaseContext::authenticate () {
 
   // look up the info in the cache first
   bool mustChange;
-  char* cached = TRI_CheckCacheAuthInfo(_vocbase, auth, &mustChange);
   string username;
 
-  // found a cached entry, access must be granted
-  if (cached != 0) {
-    username = string(cached);
-    TRI_Free(TRI_CORE_MEM_ZONE, cached);
-  }
-
-  // no entry found in cache, decode the basic auth info and look it up
-  else {
+  // no entry found in cache, decode the basic auth info and look it up.
+  // a cached entry means that access must be granted
+  if (! TRI_CheckCacheAuthInfo(_vocbase, auth, username, &mustChange)) {
     string const up = StringUtils::decodeBase64(auth);
     std::string::size_type n = up.find(':', 0);
 
@@ -38,6 +38,7 @@
 #include "Basics/logging.h"
 #include "Basics/process-utils.h"
 #include "Scheduler/PeriodicTask.h"
+#include "Scheduler/SchedulerEpoll.h"
 #include "Scheduler/SchedulerLibev.h"
 #include "Scheduler/SignalTask.h"
 
@@ -342,6 +343,7 @@ ApplicationScheduler::ApplicationScheduler (ApplicationServer* applicationServer
     _multiSchedulerAllowed(true),
     _nrSchedulerThreads(4),
     _backend(0),
+    _nativeEpoll(false),
     _descriptorMinimum(1024),
     _disableControlCHandler(false) {
 }
@@ -418,6 +420,26 @@ void ApplicationScheduler::setProcessorAffinity (std::vector<size_t> const& core
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the scheduler threads over NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void ApplicationScheduler::setNumaAffinity (std::vector<std::vector<size_t>> const& nodes) {
+#ifdef TRI_HAVE_THREAD_AFFINITY
+  if (nodes.empty()) {
+    return;
+  }
+
+  for (uint32_t i = 0;  i < _nrSchedulerThreads;  ++i) {
+    size_t node = i % nodes.size();
+
+    LOG_DEBUG("using NUMA node %d for scheduler thread %d", (int) node, (int) i);
+
+    _scheduler->setProcessorAffinity(i, nodes[node]);
+  }
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables CTRL-C handling (because taken over by console input)
 ////////////////////////////////////////////////////////////////////////////////
@@ -458,6 +480,9 @@ void ApplicationScheduler::setupOptions (std::map<std::string, ProgramOptionsDes
     //("scheduler.backend", &_backend, "1: select, 2: poll, 4: epoll")
 #else
     ("scheduler.backend", &_backend, "1: select, 2: poll, 4: epoll")
+#endif
+#ifdef TRI_HAVE_LINUX_EPOLL
+    ("scheduler.native-epoll", &_nativeEpoll, "use epoll directly instead of libev")
 #endif
     ("scheduler.report-interval", &_reportInterval, "scheduler report interval")
 #ifdef TRI_HAVE_GETRLIMIT
@@ -602,6 +627,13 @@ void ApplicationScheduler::buildScheduler () {
     LOG_FATAL_AND_EXIT("a scheduler has already been created");
   }
 
+#ifdef TRI_HAVE_LINUX_EPOLL
+  if (_nativeEpoll) {
+    _scheduler = new SchedulerEpoll(_nrSchedulerThreads);
+    return;
+  }
+#endif
+
   _scheduler = new SchedulerLibev(_nrSchedulerThreads, _backend);
 }
 
@@ -710,7 +742,7 @@ void ApplicationScheduler::adjustFileDescriptors () {
     }
 
     // the select backend has more restrictions
-    if (_backend == 1) {
+    if (_backend == 1 && ! _nativeEpoll) {
       if (FD_SETSIZE < _descriptorMinimum) {
         LOG_FATAL_AND_EXIT("i/o backend 'select' has been selected, which supports only %d descriptors, but %d are required",
                            (int) FD_SETSIZE,
@@ -112,6 +112,13 @@ namespace triagens {
 
         void setProcessorAffinity (const std::vector<size_t>& cores);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the scheduler threads over NUMA nodes, thread i runs on
+/// the processors of node i modulo the number of nodes
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumaAffinity (std::vector<std::vector<size_t>> const& nodes);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables CTRL-C handling (because taken over by console input)
 ////////////////////////////////////////////////////////////////////////////////
@@ -252,6 +259,21 @@ namespace triagens {
 
         uint32_t _backend;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief use the native epoll scheduler
+/// @startDocuBlock schedulerNativeEpoll
+/// `--scheduler.native-epoll`
+///
+/// If true, the IO scheduler uses epoll directly instead of libev. Every
+/// scheduler thread runs its own edge-triggered epoll instance, which saves
+/// system calls and watcher bookkeeping with many connections. The option
+/// is only available on Linux, and `--scheduler.backend` is ignored if it
+/// is set. The default is false.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _nativeEpoll;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief minimum number of file descriptors
 ////////////////////////////////////////////////////////////////////////////////
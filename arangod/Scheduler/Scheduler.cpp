@@ -359,6 +359,19 @@ int Scheduler::registerTaskInThread (Task* task, ssize_t tn) {
   return registerTask(task, nullptr, tn);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of open client connections of each thread
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<uint64_t> Scheduler::connectionsPerThread () {
+  MUTEX_LOCKER(schedulerLock);
+
+  std::vector<uint64_t> result(threadConnections);
+  result.resize(nrThreads, 0);
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief unregisters a task
 ////////////////////////////////////////////////////////////////////////////////
@@ -381,6 +394,10 @@ int Scheduler::unregisterTask (Task* task) {
 
     thread = (*it).second;
 
+    if (task->isConnection()) {
+      countConnection(thread, -1);
+    }
+
     taskRegistered.erase(task);
     task2thread.erase(it);
   }
@@ -412,6 +429,10 @@ int Scheduler::destroyTask (Task* task) {
 
     thread = (*it).second;
 
+    if (task->isConnection()) {
+      countConnection(thread, -1);
+    }
+
     taskRegistered.erase(task);
     task2thread.erase(it);
   }
@@ -438,6 +459,16 @@ void Scheduler::setProcessorAffinity (size_t i, size_t c) {
   threads[i]->setProcessorAffinity(c);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+void Scheduler::setProcessorAffinity (size_t i, std::vector<size_t> const& cores) {
+  MUTEX_LOCKER(schedulerLock);
+
+  threads[i]->setProcessorAffinity(cores);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -485,6 +516,10 @@ int Scheduler::registerTask (Task* task, ssize_t* got, ssize_t want) {
 
     task2thread[task] = thread;
     taskRegistered.emplace(task);
+
+    if (task->isConnection()) {
+      countConnection(thread, 1);
+    }
   }
     
   if (nullptr != got) {
@@ -522,6 +557,29 @@ int Scheduler::checkInsertTask (Task const* task) {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a connection task of a thread
+/// the caller must ensure the schedulerLock is held
+////////////////////////////////////////////////////////////////////////////////
+
+void Scheduler::countConnection (SchedulerThread* thread, int delta) {
+  if (threadConnections.size() < nrThreads) {
+    threadConnections.resize(nrThreads, 0);
+  }
+
+  for (size_t i = 0; i < nrThreads; ++i) {
+    if (threads[i] == thread) {
+      if (delta > 0) {
+        ++threadConnections[i];
+      }
+      else if (threadConnections[i] > 0) {
+        --threadConnections[i];
+      }
+      return;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            static private methods
 // -----------------------------------------------------------------------------
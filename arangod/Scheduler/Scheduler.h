@@ -187,6 +187,20 @@ namespace triagens {
 
         int registerTaskInThread (Task* task, ssize_t tn);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of scheduler threads
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numberOfThreads () const {
+          return nrThreads;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of open client connections of each thread
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint64_t> connectionsPerThread ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief unregisters a task
 ///
@@ -233,6 +247,12 @@ namespace triagens {
 
        void setProcessorAffinity (size_t i, size_t c);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+       void setProcessorAffinity (size_t i, std::vector<size_t> const& cores);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            virtual public methods
 // -----------------------------------------------------------------------------
@@ -343,6 +363,14 @@ namespace triagens {
 
         int checkInsertTask (Task const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a connection task of a thread
+///
+/// the caller must ensure the schedulerLock is held
+////////////////////////////////////////////////////////////////////////////////
+
+        void countConnection (SchedulerThread*, int);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                               protected variables
 // -----------------------------------------------------------------------------
@@ -415,6 +443,12 @@ namespace triagens {
 
         std::unordered_set<Task*> taskRegistered;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief open client connections per thread
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint64_t> threadConnections;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief scheduler activity flag
 ////////////////////////////////////////////////////////////////////////////////
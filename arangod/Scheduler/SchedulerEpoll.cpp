@@ -0,0 +1,1016 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input-output scheduler using epoll
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Scheduler/SchedulerEpoll.h"
+
+#ifdef TRI_HAVE_LINUX_EPOLL
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "Basics/Exceptions.h"
+#include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
+#include "Scheduler/SchedulerThread.h"
+#include "Scheduler/SchedulerTimers.h"
+#include "Scheduler/Task.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    private helper
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of events handled per epoll_wait call
+////////////////////////////////////////////////////////////////////////////////
+
+  int const MaxEvents = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief signals caught and not yet handled
+////////////////////////////////////////////////////////////////////////////////
+
+  volatile sig_atomic_t SignalPending[NSIG];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief eventfd of the loop watching a signal, plus one. 0 if the signal
+/// is not watched
+////////////////////////////////////////////////////////////////////////////////
+
+  std::atomic<int> SignalNotify[NSIG];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief signal handler, only uses async-signal-safe functions
+////////////////////////////////////////////////////////////////////////////////
+
+  void signalHandler (int signal) {
+    int const savedErrno = errno;
+
+    SignalPending[signal] = 1;
+
+    int const fd = SignalNotify[signal].load() - 1;
+
+    if (fd >= 0) {
+      uint64_t one = 1;
+      ssize_t n = write(fd, &one, sizeof(one));
+      (void) n;
+    }
+
+    errno = savedErrno;
+  }
+
+  struct FdEntry;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief event watcher base class. watchers are deleted after the events
+/// of the current iteration have been handled, so a handler may uninstall
+/// any watcher of its loop
+////////////////////////////////////////////////////////////////////////////////
+
+  struct EpollWatcher : public Watcher {
+    EpollWatcher (EventType type, EpollLoop* loop, Task* task)
+      : Watcher(type),
+        loop(loop),
+        task(task),
+        dead(false) {
+    }
+
+    virtual ~EpollWatcher () {
+    }
+
+    EpollLoop* loop;
+    Task* task;
+    bool dead;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief socket event watcher
+////////////////////////////////////////////////////////////////////////////////
+
+  struct SocketWatcher final : public EpollWatcher {
+    SocketWatcher (EpollLoop* loop, Task* task, FdEntry* entry, EventType events)
+      : EpollWatcher(EVENT_SOCKET_READ, loop, task),
+        entry(entry),
+        events(events),
+        active(true) {
+    }
+
+    FdEntry* entry;
+    EventType const events;
+    bool active;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a descriptor in the epoll set, with its read and write watchers
+////////////////////////////////////////////////////////////////////////////////
+
+  struct FdEntry {
+    explicit FdEntry (int fd)
+      : fd(fd),
+        reader(nullptr),
+        writer(nullptr),
+        dispatched(0),
+        queued(false),
+        dead(false) {
+    }
+
+    int const fd;
+    SocketWatcher* reader;
+    SocketWatcher* writer;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the iteration in which events were last handled
+////////////////////////////////////////////////////////////////////////////////
+
+    uint64_t dispatched;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the descriptor is to be checked in the next
+/// iteration
+////////////////////////////////////////////////////////////////////////////////
+
+    bool queued;
+
+    bool dead;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief async event watcher
+////////////////////////////////////////////////////////////////////////////////
+
+  struct AsyncWatcher final : public EpollWatcher {
+    AsyncWatcher (EpollLoop* loop, Task* task)
+      : EpollWatcher(EVENT_ASYNC, loop, task),
+        pending(false) {
+    }
+
+    bool pending;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timer and periodic event watcher
+////////////////////////////////////////////////////////////////////////////////
+
+  struct TimerWatcher final : public EpollWatcher {
+    TimerWatcher (EventType type, EpollLoop* loop, Task* task)
+      : EpollWatcher(type, loop, task),
+        entry(this, task) {
+    }
+
+    SchedulerTimers::Entry entry;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief signal event watcher
+////////////////////////////////////////////////////////////////////////////////
+
+  struct SignalWatcher final : public EpollWatcher {
+    SignalWatcher (EpollLoop* loop, Task* task, int signal)
+      : EpollWatcher(EVENT_SIGNAL, loop, task),
+        signal(signal) {
+    }
+
+    int const signal;
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  struct EpollLoop
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace rest {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the state of an event loop. apart from the async queue and the
+/// notification flags, it is only used by the thread of the loop
+////////////////////////////////////////////////////////////////////////////////
+
+    struct EpollLoop {
+      EpollLoop ()
+        : epollFd(-1),
+          eventFd(-1),
+          iteration(0),
+          fds(),
+          ready(),
+          timers(),
+          signals(),
+          asyncLock(),
+          asyncQueue(),
+          notified(false),
+          wakeup(false),
+          garbage(),
+          garbageEntries() {
+      }
+
+      int epollFd;
+
+      int eventFd;
+
+      uint64_t iteration;
+
+      std::unordered_map<int, FdEntry*> fds;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief descriptors to check in the next iteration
+////////////////////////////////////////////////////////////////////////////////
+
+      std::vector<FdEntry*> ready;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief active timers and periodic events
+////////////////////////////////////////////////////////////////////////////////
+
+      SchedulerTimers timers;
+
+      std::vector<SignalWatcher*> signals;
+
+      Mutex asyncLock;
+
+      std::vector<AsyncWatcher*> asyncQueue;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the eventfd has been written since it was last read
+////////////////////////////////////////////////////////////////////////////////
+
+      std::atomic<bool> notified;
+
+      std::atomic<bool> wakeup;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief uninstalled watchers and descriptors, deleted after the iteration
+////////////////////////////////////////////////////////////////////////////////
+
+      std::vector<EpollWatcher*> garbage;
+
+      std::vector<FdEntry*> garbageEntries;
+    };
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    private helper
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the eventfd of a loop, unless it has been written already
+////////////////////////////////////////////////////////////////////////////////
+
+  void notifyLoop (EpollLoop* loop) {
+    if (! loop->notified.exchange(true)) {
+      uint64_t one = 1;
+      ssize_t n = write(loop->eventFd, &one, sizeof(one));
+      (void) n;
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queues a descriptor to be checked in the next iteration
+////////////////////////////////////////////////////////////////////////////////
+
+  void queueEntry (EpollLoop* loop, FdEntry* entry) {
+    if (! entry->queued && ! entry->dead) {
+      entry->queued = true;
+      loop->ready.emplace_back(entry);
+    }
+  }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    event dispatch
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the active watchers of a descriptor
+///
+/// a watcher that has handled an event is checked again in the next
+/// iteration, because the handler may have left data in the socket, and
+/// an edge-triggered descriptor would not report it again
+////////////////////////////////////////////////////////////////////////////////
+
+  void dispatchSocket (EpollLoop* loop, FdEntry* entry, EventType revents) {
+    entry->dispatched = loop->iteration;
+
+    for (size_t i = 0;  i < 2 && ! entry->dead;  ++i) {
+      SocketWatcher* watcher = (i == 0) ? entry->reader : entry->writer;
+
+      if (watcher == nullptr || ! watcher->active) {
+        continue;
+      }
+
+      EventType const events = revents & watcher->events;
+
+      if (events == 0) {
+        continue;
+      }
+
+      // note: the handler may uninstall the watchers of the descriptor
+      watcher->task->handleEvent(watcher, events);
+
+      if (! watcher->dead && watcher->active) {
+        queueEntry(loop, entry);
+      }
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks the descriptors queued in the last iteration with a single
+/// poll call, and calls the watchers of those that are ready
+////////////////////////////////////////////////////////////////////////////////
+
+  void dispatchQueued (EpollLoop* loop, std::vector<FdEntry*> const& queued) {
+    std::vector<FdEntry*> entries;
+    std::vector<struct pollfd> pfds;
+
+    entries.reserve(queued.size());
+    pfds.reserve(queued.size());
+
+    for (auto& entry : queued) {
+      if (entry->dead || entry->dispatched == loop->iteration) {
+        // events have been handled in this iteration already
+        continue;
+      }
+
+      short events = 0;
+
+      for (auto& watcher : { entry->reader, entry->writer }) {
+        if (watcher != nullptr && watcher->active) {
+          if (watcher->events & EVENT_SOCKET_READ) {
+            events |= POLLIN;
+          }
+          if (watcher->events & EVENT_SOCKET_WRITE) {
+            events |= POLLOUT;
+          }
+        }
+      }
+
+      if (events != 0) {
+        struct pollfd pfd;
+        pfd.fd = entry->fd;
+        pfd.events = events;
+        pfd.revents = 0;
+
+        entries.emplace_back(entry);
+        pfds.emplace_back(pfd);
+      }
+    }
+
+    if (pfds.empty()) {
+      return;
+    }
+
+    int n = poll(pfds.data(), pfds.size(), 0);
+
+    if (n <= 0) {
+      return;
+    }
+
+    for (size_t i = 0;  i < pfds.size();  ++i) {
+      short const r = pfds[i].revents;
+      EventType revents = 0;
+
+      if (r & (POLLIN | POLLHUP | POLLERR)) {
+        revents |= EVENT_SOCKET_READ;
+      }
+      if (r & (POLLOUT | POLLHUP | POLLERR)) {
+        revents |= EVENT_SOCKET_WRITE;
+      }
+
+      if (revents != 0 && ! entries[i]->dead) {
+        dispatchSocket(loop, entries[i], revents);
+      }
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief handles the eventfd of a loop: signals and async events
+////////////////////////////////////////////////////////////////////////////////
+
+  void dispatchNotification (EpollLoop* loop) {
+    loop->notified.store(false);
+
+    uint64_t value;
+    ssize_t n = read(loop->eventFd, &value, sizeof(value));
+    (void) n;
+
+    // signals
+    if (! loop->signals.empty()) {
+      std::vector<int> caught;
+
+      for (auto& watcher : loop->signals) {
+        int const signal = watcher->signal;
+
+        if (SignalPending[signal] != 0) {
+          SignalPending[signal] = 0;
+          caught.emplace_back(signal);
+        }
+      }
+
+      if (! caught.empty()) {
+        auto watchers = loop->signals;
+
+        for (auto& watcher : watchers) {
+          if (! watcher->dead &&
+              std::find(caught.begin(), caught.end(), watcher->signal) != caught.end()) {
+            watcher->task->handleEvent(watcher, EVENT_SIGNAL);
+          }
+        }
+      }
+    }
+
+    // async events
+    std::vector<AsyncWatcher*> pending;
+
+    {
+      MUTEX_LOCKER(loop->asyncLock);
+      pending.swap(loop->asyncQueue);
+
+      for (auto& watcher : pending) {
+        watcher->pending = false;
+      }
+    }
+
+    for (auto& watcher : pending) {
+      if (! watcher->dead) {
+        watcher->task->handleEvent(watcher, EVENT_ASYNC);
+      }
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes the watchers and descriptors uninstalled in the iteration
+////////////////////////////////////////////////////////////////////////////////
+
+  void collectGarbage (EpollLoop* loop) {
+    for (auto& watcher : loop->garbage) {
+      delete watcher;
+    }
+    loop->garbage.clear();
+
+    for (auto& entry : loop->garbageEntries) {
+      delete entry;
+    }
+    loop->garbageEntries.clear();
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timeout for epoll_wait in milliseconds
+////////////////////////////////////////////////////////////////////////////////
+
+  int waitTimeout (EpollLoop* loop) {
+    if (! loop->ready.empty()) {
+      return 0;
+    }
+
+    double const wait = loop->timers.arm();
+
+    if (wait < 0.0) {
+      return -1;
+    }
+
+    // round up, so the timer has expired when the loop wakes up
+    return static_cast<int>((std::min)(std::ceil(wait * 1000.0), 3600000.0));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class SchedulerEpoll
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+SchedulerEpoll::SchedulerEpoll (size_t concurrency)
+  : Scheduler(concurrency),
+    _loops() {
+
+  _loops.reserve(nrThreads);
+
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    std::unique_ptr<EpollLoop> loop(new EpollLoop());
+
+    loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (loop->epollFd < 0) {
+      LOG_FATAL_AND_EXIT("cannot create epoll instance: %s", strerror(errno));
+    }
+
+    loop->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (loop->eventFd < 0) {
+      LOG_FATAL_AND_EXIT("cannot create eventfd: %s", strerror(errno));
+    }
+
+    // the eventfd is level-triggered, and is the only descriptor without an entry
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+
+    if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->eventFd, &ev) != 0) {
+      LOG_FATAL_AND_EXIT("cannot add eventfd to epoll instance: %s", strerror(errno));
+    }
+
+    _loops.emplace_back(loop.get());
+    loop.release();
+  }
+
+  // construct the scheduler threads
+  threads = new SchedulerThread* [nrThreads];
+
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    threads[i] = new SchedulerThread(this, EventLoop(i), i == 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes a scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+SchedulerEpoll::~SchedulerEpoll () {
+
+  // begin shutdown sequence within threads
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    threads[i]->beginShutdown();
+  }
+
+  // force threads to shutdown
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    threads[i]->stop();
+  }
+
+  for (size_t i = 0;  i < 100 && isRunning();  ++i) {
+    usleep(100);
+  }
+
+  // and delete threads
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    delete threads[i];
+  }
+
+  delete[] threads;
+
+  // shutdown loops. watchers still installed belong to tasks that have not
+  // been cleaned up, and are not deleted here, like with libev
+  for (auto& loop : _loops) {
+    for (auto& watcher : loop->signals) {
+      SignalNotify[watcher->signal].store(0);
+    }
+
+    collectGarbage(loop);
+
+    close(loop->eventFd);
+    close(loop->epollFd);
+
+    delete loop;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 Scheduler methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::eventLoop (EventLoop loop) {
+  EpollLoop* l = lookupLoop(loop);
+  struct epoll_event events[MaxEvents];
+
+  while (true) {
+    ++l->iteration;
+
+    // descriptors queued in the last iteration
+    std::vector<FdEntry*> queued;
+    queued.swap(l->ready);
+
+    for (auto& entry : queued) {
+      entry->queued = false;
+    }
+
+    int timeout = queued.empty() ? waitTimeout(l) : 0;
+    int n = epoll_wait(l->epollFd, events, MaxEvents, timeout);
+
+    if (n < 0) {
+      if (errno != EINTR) {
+        LOG_ERROR("epoll_wait failed: %s", strerror(errno));
+      }
+      n = 0;
+    }
+
+    for (int i = 0;  i < n;  ++i) {
+      FdEntry* entry = static_cast<FdEntry*>(events[i].data.ptr);
+
+      if (entry == nullptr) {
+        dispatchNotification(l);
+        continue;
+      }
+
+      if (entry->dead) {
+        continue;
+      }
+
+      uint32_t const e = events[i].events;
+      EventType revents = 0;
+
+      if (e & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        revents |= EVENT_SOCKET_READ;
+      }
+      if (e & (EPOLLOUT | EPOLLHUP | EPOLLERR)) {
+        revents |= EVENT_SOCKET_WRITE;
+      }
+
+      dispatchSocket(l, entry, revents);
+    }
+
+    l->timers.dispatch();
+    dispatchQueued(l, queued);
+
+    collectGarbage(l);
+
+    if (l->wakeup.exchange(false)) {
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::wakeupLoop (EventLoop loop) {
+  EpollLoop* l = lookupLoop(loop);
+
+  l->wakeup.store(true);
+  notifyLoop(l);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::uninstallEvent (EventToken token) {
+  if (token == nullptr) {
+    return;
+  }
+
+  EpollWatcher* watcher = static_cast<EpollWatcher*>(token);
+  EpollLoop* loop = watcher->loop;
+
+  TRI_ASSERT(! watcher->dead);
+
+  switch (watcher->type) {
+    case EVENT_ASYNC: {
+      AsyncWatcher* w = static_cast<AsyncWatcher*>(watcher);
+      MUTEX_LOCKER(loop->asyncLock);
+
+      if (w->pending) {
+        auto& queue = loop->asyncQueue;
+        queue.erase(std::remove(queue.begin(), queue.end(), w), queue.end());
+        w->pending = false;
+      }
+      break;
+    }
+
+    case EVENT_PERIODIC:
+    case EVENT_TIMER: {
+      loop->timers.stop(&static_cast<TimerWatcher*>(watcher)->entry);
+      break;
+    }
+
+    case EVENT_SIGNAL: {
+      SignalWatcher* w = static_cast<SignalWatcher*>(watcher);
+      auto& signals = loop->signals;
+      signals.erase(std::remove(signals.begin(), signals.end(), w), signals.end());
+
+      bool watched = false;
+
+      for (auto& other : signals) {
+        if (other->signal == w->signal) {
+          watched = true;
+          break;
+        }
+      }
+
+      if (! watched) {
+        // like libev, restore the default action
+        SignalNotify[w->signal].store(0);
+        signal(w->signal, SIG_DFL);
+      }
+      break;
+    }
+
+    case EVENT_SOCKET_READ: {
+      SocketWatcher* w = static_cast<SocketWatcher*>(watcher);
+      FdEntry* entry = w->entry;
+
+      if (entry->reader == w) {
+        entry->reader = nullptr;
+      }
+      else {
+        TRI_ASSERT(entry->writer == w);
+        entry->writer = nullptr;
+      }
+
+      if (entry->reader == nullptr && entry->writer == nullptr) {
+        // the descriptor may have been closed already, so errors are ignored
+        epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, entry->fd, nullptr);
+        loop->fds.erase(entry->fd);
+
+        if (entry->queued) {
+          auto& ready = loop->ready;
+          ready.erase(std::remove(ready.begin(), ready.end(), entry), ready.end());
+          entry->queued = false;
+        }
+
+        entry->dead = true;
+        loop->garbageEntries.emplace_back(entry);
+      }
+      break;
+    }
+  }
+
+  watcher->dead = true;
+  loop->garbage.emplace_back(watcher);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+EventToken SchedulerEpoll::installAsyncEvent (EventLoop loop, Task* task) {
+  return new AsyncWatcher(lookupLoop(loop), task);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::sendAsync (EventToken token) {
+  AsyncWatcher* watcher = static_cast<AsyncWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  EpollLoop* loop = watcher->loop;
+
+  {
+    MUTEX_LOCKER(loop->asyncLock);
+
+    if (watcher->pending) {
+      // the loop has not yet handled the last event
+      return;
+    }
+
+    watcher->pending = true;
+    loop->asyncQueue.emplace_back(watcher);
+  }
+
+  notifyLoop(loop);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+EventToken SchedulerEpoll::installPeriodicEvent (EventLoop loop, Task* task, double offset, double interval) {
+  TimerWatcher* watcher = new TimerWatcher(EVENT_PERIODIC, lookupLoop(loop), task);
+
+  watcher->entry.offset = offset;
+  watcher->entry.interval = interval;
+  watcher->loop->timers.startPeriodic(&watcher->entry);
+
+  return watcher;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::rearmPeriodic (EventToken token, double offset, double interval) {
+  TimerWatcher* watcher = static_cast<TimerWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  watcher->entry.offset = offset;
+  watcher->entry.interval = interval;
+  watcher->loop->timers.startPeriodic(&watcher->entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+EventToken SchedulerEpoll::installSignalEvent (EventLoop loop, Task* task, int signal) {
+  if (signal <= 0 || signal >= NSIG) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_BAD_PARAMETER, "invalid signal number");
+  }
+
+  EpollLoop* l = lookupLoop(loop);
+  SignalWatcher* watcher = new SignalWatcher(l, task, signal);
+
+  l->signals.emplace_back(watcher);
+  SignalNotify[signal].store(l->eventFd + 1);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = signalHandler;
+  action.sa_flags = SA_RESTART;
+  sigfillset(&action.sa_mask);
+  sigaction(signal, &action, nullptr);
+
+  return watcher;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+EventToken SchedulerEpoll::installSocketEvent (EventLoop loop, EventType type, Task* task, TRI_socket_t socket) {
+  EpollLoop* l = lookupLoop(loop);
+  int const fd = socket.fileDescriptor;
+
+  FdEntry* entry;
+  auto it = l->fds.find(fd);
+
+  if (it == l->fds.end()) {
+    std::unique_ptr<FdEntry> created(new FdEntry(fd));
+
+    // the descriptor is added once, for all events. starting and stopping
+    // the events of a watcher only changes the watcher
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = created.get();
+
+    if (epoll_ctl(l->epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_SYS_ERROR,
+                                     std::string("cannot add descriptor to epoll instance: ") + strerror(errno));
+    }
+
+    l->fds.emplace(fd, created.get());
+    entry = created.release();
+  }
+  else {
+    entry = (*it).second;
+  }
+
+  SocketWatcher* watcher = new SocketWatcher(l, task, entry, type & (EVENT_SOCKET_READ | EVENT_SOCKET_WRITE));
+
+  if ((type & EVENT_SOCKET_READ) && entry->reader == nullptr) {
+    entry->reader = watcher;
+  }
+  else {
+    TRI_ASSERT(entry->writer == nullptr);
+    entry->writer = watcher;
+  }
+
+  // the descriptor may have been ready before the watcher was installed
+  queueEntry(l, entry);
+
+  return watcher;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::startSocketEvents (EventToken token) {
+  SocketWatcher* watcher = static_cast<SocketWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  watcher->active = true;
+
+  // the edge may have been reported while the watcher was stopped, or, for
+  // an active watcher, before new data to write was set
+  queueEntry(watcher->loop, watcher->entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::stopSocketEvents (EventToken token) {
+  SocketWatcher* watcher = static_cast<SocketWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  watcher->active = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+EventToken SchedulerEpoll::installTimerEvent (EventLoop loop, Task* task, double timeout) {
+  TimerWatcher* watcher = new TimerWatcher(EVENT_TIMER, lookupLoop(loop), task);
+
+  watcher->loop->timers.start(&watcher->entry, timeout);
+
+  return watcher;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::clearTimer (EventToken token) {
+  TimerWatcher* watcher = static_cast<TimerWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  watcher->loop->timers.stop(&watcher->entry);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+///
+/// like ev_timer_again, the timer repeats with the timeout until it is cleared
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerEpoll::rearmTimer (EventToken token, double timeout) {
+  TimerWatcher* watcher = static_cast<TimerWatcher*>(token);
+
+  if (watcher == nullptr) {
+    return;
+  }
+
+  watcher->entry.repeat = timeout;
+
+  if (timeout > 0.0) {
+    watcher->loop->timers.start(&watcher->entry, timeout);
+  }
+  else {
+    watcher->loop->timers.stop(&watcher->entry);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up an event loop
+////////////////////////////////////////////////////////////////////////////////
+
+EpollLoop* SchedulerEpoll::lookupLoop (EventLoop loop) {
+  if (size_t(loop) >= nrThreads) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "unknown loop");
+  }
+
+  return _loops[loop];
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
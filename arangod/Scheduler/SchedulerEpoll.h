@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input-output scheduler using epoll
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_SCHEDULER_SCHEDULER_EPOLL_H
+#define ARANGODB_SCHEDULER_SCHEDULER_EPOLL_H 1
+
+#include "Basics/Common.h"
+#include "Scheduler/Scheduler.h"
+
+#ifdef TRI_HAVE_LINUX_EPOLL
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class SchedulerEpoll
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace rest {
+
+    struct EpollLoop;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief input-output scheduler using epoll directly
+///
+/// every scheduler thread runs its own epoll instance. a descriptor is added
+/// once, edge-triggered for reading and writing, so starting and stopping the
+/// socket events of a task does not need a system call. as edges are only
+/// reported once, a descriptor whose task has handled an event, or whose
+/// events have been restarted, is checked again in the next iteration, with
+/// a single poll call for all such descriptors. timers and periodic events
+/// are kept in a timer wheel per loop, and asynchronous events, wakeups and signals
+/// are delivered through one eventfd per loop
+////////////////////////////////////////////////////////////////////////////////
+
+    class SchedulerEpoll : public Scheduler {
+      private:
+        SchedulerEpoll (SchedulerEpoll const&) = delete;
+        SchedulerEpoll& operator= (SchedulerEpoll const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit
+        SchedulerEpoll (size_t nrThreads = 1);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes a scheduler
+////////////////////////////////////////////////////////////////////////////////
+
+        ~SchedulerEpoll ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 Scheduler methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void eventLoop (EventLoop) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void wakeupLoop (EventLoop) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        EventToken installSocketEvent (EventLoop, EventType, Task*, TRI_socket_t) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void startSocketEvents (EventToken) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void stopSocketEvents (EventToken) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        EventToken installAsyncEvent (EventLoop, Task*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void sendAsync (EventToken) override final;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        EventToken installTimerEvent (EventLoop, Task*, double timeout) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void clearTimer (EventToken) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void rearmTimer (EventToken, double timeout) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        EventToken installPeriodicEvent (EventLoop, Task*, double offset, double interval) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void rearmPeriodic (EventToken, double offset, double timeout) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        EventToken installSignalEvent (EventLoop, Task*, int signal) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void uninstallEvent (EventToken) override;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up an event loop
+////////////////////////////////////////////////////////////////////////////////
+
+        EpollLoop* lookupLoop (EventLoop);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief event loops
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<EpollLoop*> _loops;
+
+    };
+  }
+}
+
+#endif
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
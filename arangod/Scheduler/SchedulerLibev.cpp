@@ -40,6 +40,7 @@
 #include "Basics/Exceptions.h"
 #include "Basics/logging.h"
 #include "Scheduler/SchedulerThread.h"
+#include "Scheduler/SchedulerTimers.h"
 #include "Scheduler/Task.h"
 
 using namespace triagens::basics;
@@ -145,86 +146,98 @@ namespace {
   }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief periodic event watcher
+/// @brief signal event watcher
 ////////////////////////////////////////////////////////////////////////////////
 
-  struct PeriodicWatcher final : public ev_periodic, Watcher {
+  struct SignalWatcher final : public ev_signal, Watcher {
     struct ev_loop* loop;
     Task* task;
     
-    PeriodicWatcher (struct ev_loop* loop, Task* task) 
-      : Watcher(EVENT_PERIODIC),
+    SignalWatcher (struct ev_loop* loop, Task* task) 
+      : Watcher(EVENT_SIGNAL),
         loop(loop),
         task(task) {
     }
   };
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief periodic event callback
+/// @brief signal event callback
 ////////////////////////////////////////////////////////////////////////////////
 
-  void periodicCallback (struct ev_loop*, ev_periodic* w, int revents) {
-    PeriodicWatcher* watcher = (PeriodicWatcher*) w; // cast from C type to C++ class
+  void signalCallback (struct ev_loop*, ev_signal* w, int revents) {
+    SignalWatcher* watcher = (SignalWatcher*) w; // cast from C type to C++ class
     Task* task = watcher->task;
 
-    if (task != nullptr && (revents & EV_PERIODIC)) {
-      task->handleEvent(watcher, EVENT_PERIODIC);
+    if (task != nullptr && (revents & EV_SIGNAL)) {
+      task->handleEvent(watcher, EVENT_SIGNAL);
     }
   }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief signal event watcher
+/// @brief the timers of a loop, with the libev timer driving them
 ////////////////////////////////////////////////////////////////////////////////
 
-  struct SignalWatcher final : public ev_signal, Watcher {
+  struct LoopTimers final : public ev_timer {
     struct ev_loop* loop;
-    Task* task;
-    
-    SignalWatcher (struct ev_loop* loop, Task* task) 
-      : Watcher(EVENT_SIGNAL),
-        loop(loop),
-        task(task) {
+    SchedulerTimers timers;
+
+    explicit LoopTimers (struct ev_loop* loop)
+      : loop(loop),
+        timers() {
     }
   };
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief signal event callback
+/// @brief timer and periodic event watcher
 ////////////////////////////////////////////////////////////////////////////////
 
-  void signalCallback (struct ev_loop*, ev_signal* w, int revents) {
-    SignalWatcher* watcher = (SignalWatcher*) w; // cast from C type to C++ class
-    Task* task = watcher->task;
+  struct TimerWatcher final : public Watcher {
+    LoopTimers* timers;
+    SchedulerTimers::Entry entry;
 
-    if (task != nullptr && (revents & EV_SIGNAL)) {
-      task->handleEvent(watcher, EVENT_SIGNAL);
+    TimerWatcher (EventType type, LoopTimers* timers, Task* task)
+      : Watcher(type),
+        timers(timers),
+        entry(this, task) {
+    }
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the libev timer of a loop to the next expiry of its timers
+////////////////////////////////////////////////////////////////////////////////
+
+  void armTimers (LoopTimers* t) {
+    double const wait = t->timers.arm();
+    ev_timer* w = (ev_timer*) t;
+
+    ev_timer_stop(t->loop, w);
+
+    if (wait >= 0.0) {
+      ev_timer_set(w, wait, 0.0);
+      ev_timer_start(t->loop, w);
     }
   }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief timer event watcher
+/// @brief sets the libev timer of a loop, if a timer fires before it
 ////////////////////////////////////////////////////////////////////////////////
 
-  struct TimerWatcher final : public ev_timer, Watcher {
-    struct ev_loop* loop;
-    Task* task;
-    
-    TimerWatcher (struct ev_loop* loop, Task* task) 
-      : Watcher(EVENT_TIMER),
-        loop(loop),
-        task(task) {
+  void updateTimers (LoopTimers* t) {
+    if (t->timers.needsArming()) {
+      armTimers(t);
     }
-  };
+  }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief timer event callback
+/// @brief libev timer callback, calls the expired timers of the loop
 ////////////////////////////////////////////////////////////////////////////////
 
-  void timerCallback (struct ev_loop*, ev_timer* w, int revents) {
-    TimerWatcher* watcher = (TimerWatcher*) w; // cast from C type to C++ class
-    Task* task = watcher->task;
+  void timersCallback (struct ev_loop*, ev_timer* w, int revents) {
+    LoopTimers* t = (LoopTimers*) w; // cast from C type to C++ class
 
-    if (task != nullptr && (revents & EV_TIMER)) {
-      task->handleEvent(watcher, EVENT_TIMER);
+    if (revents & EV_TIMER) {
+      t->timers.dispatch();
+      armTimers(t);
     }
   }
 }
@@ -286,7 +299,8 @@ SchedulerLibev::SchedulerLibev (size_t concurrency, int backend)
   : Scheduler(concurrency),
     _backend(backend),
     _loops(nullptr),
-    _wakers(nullptr) {
+    _wakers(nullptr),
+    _timers(nullptr) {
 
   switchAllocator();
 
@@ -310,6 +324,7 @@ SchedulerLibev::SchedulerLibev (size_t concurrency, int backend)
   // construct the scheduler threads
   threads = new SchedulerThread* [nrThreads];
   _wakers = new ev_async*[nrThreads];
+  _timers = new LoopTimers*[nrThreads];
 
   for (size_t i = 0;  i < nrThreads;  ++i) {
     threads[i] = new SchedulerThread(this, EventLoop(i), i == 0);
@@ -320,6 +335,11 @@ SchedulerLibev::SchedulerLibev (size_t concurrency, int backend)
     ev_async_start(((struct ev_loop**) _loops)[i], w);
 
     ((ev_async**) _wakers)[i] = w;
+
+    LoopTimers* t = new LoopTimers(((struct ev_loop**) _loops)[i]);
+    ev_timer_init((ev_timer*) t, timersCallback, 0.0, 0.0);
+
+    ((LoopTimers**) _timers)[i] = t;
   }
 }
 
@@ -344,6 +364,11 @@ SchedulerLibev::~SchedulerLibev () {
   }
 
   // shutdown loops
+  for (size_t i = 0;  i < nrThreads;  ++i) {
+    LoopTimers* t = ((LoopTimers**) _timers)[i];
+    ev_timer_stop(t->loop, (ev_timer*) t);
+  }
+
   for (size_t i = 1;  i < nrThreads;  ++i) {
     ev_async_stop(((struct ev_loop**) _loops)[i], ((ev_async**) _wakers)[i]);
     ev_loop_destroy(((struct ev_loop**) _loops)[i]);
@@ -356,6 +381,7 @@ SchedulerLibev::~SchedulerLibev () {
   for (size_t i = 0;  i < nrThreads;  ++i) {
     delete threads[i];
     delete ((ev_async**) _wakers)[i];
+    delete ((LoopTimers**) _timers)[i];
   }
 
   // delete loops buffer
@@ -364,6 +390,7 @@ SchedulerLibev::~SchedulerLibev () {
   // delete threads buffer and wakers
   delete[] threads;
   delete[] (ev_async**)_wakers;
+  delete[] (LoopTimers**) _timers;
 }
 
 // -----------------------------------------------------------------------------
@@ -412,9 +439,10 @@ void SchedulerLibev::uninstallEvent (EventToken watcher) {
       break;
     }
 
-    case EVENT_PERIODIC: {
-      PeriodicWatcher* w = (PeriodicWatcher*) watcher;
-      ev_periodic_stop(w->loop, (ev_periodic*) w);
+    case EVENT_PERIODIC:
+    case EVENT_TIMER: {
+      TimerWatcher* w = (TimerWatcher*) watcher;
+      w->timers->timers.stop(&w->entry);
       delete w;
 
       break;
@@ -435,14 +463,6 @@ void SchedulerLibev::uninstallEvent (EventToken watcher) {
 
       break;
     }
-
-    case EVENT_TIMER: {
-      TimerWatcher* w = (TimerWatcher*) watcher;
-      ev_timer_stop(w->loop, (ev_timer*) w);
-      delete w;
-
-      break;
-    }
   }
 }
 
@@ -480,11 +500,12 @@ void SchedulerLibev::sendAsync (EventToken token) {
 ////////////////////////////////////////////////////////////////////////////////
 
 EventToken SchedulerLibev::installPeriodicEvent (EventLoop loop, Task* task, double offset, double interval) {
-  PeriodicWatcher* watcher = new PeriodicWatcher((struct ev_loop*) lookupLoop(loop), task);
+  TimerWatcher* watcher = new TimerWatcher(EVENT_PERIODIC, (LoopTimers*) lookupTimers(loop), task);
 
-  ev_periodic* w = (ev_periodic*) watcher;
-  ev_periodic_init(w, periodicCallback, offset, interval, 0);
-  ev_periodic_start(watcher->loop, w);
+  watcher->entry.offset = offset;
+  watcher->entry.interval = interval;
+  watcher->timers->timers.startPeriodic(&watcher->entry);
+  updateTimers(watcher->timers);
 
   return watcher;
 }
@@ -494,15 +515,16 @@ EventToken SchedulerLibev::installPeriodicEvent (EventLoop loop, Task* task, dou
 ////////////////////////////////////////////////////////////////////////////////
 
 void SchedulerLibev::rearmPeriodic (EventToken token, double offset, double interval) {
-  PeriodicWatcher* watcher = (PeriodicWatcher*) token;
+  TimerWatcher* watcher = (TimerWatcher*) token;
   
   if (watcher == nullptr) {
     return;
   }
 
-  ev_periodic* w = (ev_periodic*) watcher;
-  ev_periodic_set(w, offset, interval, 0);
-  ev_periodic_again(watcher->loop, w);
+  watcher->entry.offset = offset;
+  watcher->entry.interval = interval;
+  watcher->timers->timers.startPeriodic(&watcher->entry);
+  updateTimers(watcher->timers);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -593,11 +615,10 @@ void SchedulerLibev::stopSocketEvents (EventToken token) {
 ////////////////////////////////////////////////////////////////////////////////
 
 EventToken SchedulerLibev::installTimerEvent (EventLoop loop, Task* task, double timeout) {
-  TimerWatcher* watcher = new TimerWatcher((struct ev_loop*) lookupLoop(loop), task);
+  TimerWatcher* watcher = new TimerWatcher(EVENT_TIMER, (LoopTimers*) lookupTimers(loop), task);
 
-  ev_timer* w = (ev_timer*) watcher;
-  ev_timer_init(w, timerCallback, timeout, 0.0);
-  ev_timer_start(watcher->loop, w);
+  watcher->timers->timers.start(&watcher->entry, timeout);
+  updateTimers(watcher->timers);
 
   return watcher;
 }
@@ -613,8 +634,7 @@ void SchedulerLibev::clearTimer (EventToken token) {
     return;
   }
 
-  ev_timer* w = (ev_timer*) watcher;
-  ev_timer_stop(watcher->loop, w);
+  watcher->timers->timers.stop(&watcher->entry);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -628,9 +648,17 @@ void SchedulerLibev::rearmTimer (EventToken token, double timeout) {
     return;
   }
 
-  ev_timer* w = (ev_timer*) watcher;
-  ev_timer_set(w, 0.0, timeout);
-  ev_timer_again(watcher->loop, w);
+  // like ev_timer_again, the timer repeats with the timeout until it is
+  // cleared
+  watcher->entry.repeat = timeout;
+
+  if (timeout > 0.0) {
+    watcher->timers->timers.start(&watcher->entry, timeout);
+    updateTimers(watcher->timers);
+  }
+  else {
+    watcher->timers->timers.stop(&watcher->entry);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -649,6 +677,18 @@ void* SchedulerLibev::lookupLoop (EventLoop loop) {
   return ((struct ev_loop**) _loops)[loop];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the timers of an event loop
+////////////////////////////////////////////////////////////////////////////////
+
+void* SchedulerLibev::lookupTimers (EventLoop loop) {
+  if (size_t(loop) >= nrThreads) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "unknown loop");
+  }
+
+  return ((LoopTimers**) _timers)[loop];
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
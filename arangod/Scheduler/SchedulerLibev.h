@@ -191,6 +191,12 @@ namespace triagens {
 
         void* lookupLoop (EventLoop);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the timers of an event loop
+////////////////////////////////////////////////////////////////////////////////
+
+        void* lookupTimers (EventLoop);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -215,6 +221,12 @@ namespace triagens {
 
         void* _wakers;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timers of the event loops, each driven by a single libev timer
+////////////////////////////////////////////////////////////////////////////////
+
+        void* _timers;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the allocator was switched
 ////////////////////////////////////////////////////////////////////////////////
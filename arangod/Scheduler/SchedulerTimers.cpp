@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timers of a scheduler thread
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Scheduler/SchedulerTimers.h"
+
+#include "Scheduler/Task.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    private helper
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ticks per second
+////////////////////////////////////////////////////////////////////////////////
+
+  double const TicksPerSecond = 1000.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the wall clock time in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+  double wallTime () {
+    return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class SchedulerTimers
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+SchedulerTimers::SchedulerTimers ()
+  : _wheel(),
+    _start(std::chrono::steady_clock::now()),
+    _armed(UINT64_MAX),
+    _needsArming(false) {
+}
+
+SchedulerTimers::~SchedulerTimers () {
+  _wheel.clear();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief (re-)starts a timer, firing after the timeout in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerTimers::start (Entry* entry, double timeout) {
+  insert(entry, elapsed() + timeout);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief (re-)starts a periodic event
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerTimers::startPeriodic (Entry* entry) {
+  double const wall = wallTime();
+  double next = entry->offset;
+
+  if (entry->interval > 0.0) {
+    next += std::ceil((wall - entry->offset) / entry->interval) * entry->interval;
+
+    if (next <= wall) {
+      next += entry->interval;
+    }
+  }
+
+  insert(entry, elapsed() + (next - wall));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stops a timer or periodic event, if it is active
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerTimers::stop (Entry* entry) {
+  _wheel.remove(&entry->timer);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the tasks of the expired events, and returns their number
+////////////////////////////////////////////////////////////////////////////////
+
+size_t SchedulerTimers::dispatch () {
+  double const now = elapsed();
+
+  return _wheel.advance(static_cast<uint64_t>(now * TicksPerSecond), [&] (TimerWheel::Timer* timer) {
+    Entry* entry = static_cast<Entry*>(timer->data());
+    EventType const type = entry->watcher->type;
+
+    if (type == EVENT_PERIODIC) {
+      if (entry->interval > 0.0) {
+        startPeriodic(entry);
+      }
+    }
+    else if (entry->repeat > 0.0) {
+      insert(entry, now + entry->repeat);
+    }
+
+    // note: the task may uninstall the event, and the entry is gone then
+    entry->task->handleEvent(entry->watcher, type);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the seconds until dispatch must be called
+///
+/// for events further away than 256 ticks this is the time at which the
+/// wheel moves them closer, so the loop may wake up before an event fires
+////////////////////////////////////////////////////////////////////////////////
+
+double SchedulerTimers::arm () {
+  _armed = _wheel.nextExpiry();
+  _needsArming = false;
+
+  if (_armed == UINT64_MAX) {
+    return -1.0;
+  }
+
+  double const wait = static_cast<double>(_armed) / TicksPerSecond - elapsed();
+
+  return (wait > 0.0) ? wait : 0.0;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the seconds since the construction on the monotonic clock
+////////////////////////////////////////////////////////////////////////////////
+
+double SchedulerTimers::elapsed () const {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts an event firing at the given elapsed time
+////////////////////////////////////////////////////////////////////////////////
+
+void SchedulerTimers::insert (Entry* entry, double at) {
+  // round up, so an event never fires early
+  double const ticks = std::ceil(at * TicksPerSecond);
+  uint64_t const expires = (ticks > 0.0) ? static_cast<uint64_t>(ticks) : 0;
+
+  _wheel.insert(&entry->timer, expires);
+
+  if (entry->timer.expires() < _armed) {
+    _needsArming = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
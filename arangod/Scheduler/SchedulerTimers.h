@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timers of a scheduler thread
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_SCHEDULER_SCHEDULER_TIMERS_H
+#define ARANGODB_SCHEDULER_SCHEDULER_TIMERS_H 1
+
+#include "Basics/Common.h"
+
+#include <chrono>
+
+#include "Basics/TimerWheel.h"
+#include "Scheduler/events.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class SchedulerTimers
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace rest {
+
+    class Task;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the timer and periodic events of one event loop
+///
+/// the events are kept in a timer wheel with a tick of one millisecond on
+/// the monotonic clock, so that starting, rearming and stopping a timer,
+/// which happens for every request of a keep-alive connection, takes
+/// constant time. the loop calls dispatch when the time returned by arm has
+/// passed. the class is only used by the thread of its loop
+////////////////////////////////////////////////////////////////////////////////
+
+    class SchedulerTimers {
+      private:
+        SchedulerTimers (SchedulerTimers const&) = delete;
+        SchedulerTimers& operator= (SchedulerTimers const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a timer or periodic event, embedded in the watcher of a scheduler
+///
+/// a timer with a repeat value other than 0 is restarted with it when it
+/// fires. a periodic event fires at the wall clock times offset +
+/// n * interval, or once at offset if the interval is 0
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Entry {
+          Entry (Watcher* watcher, Task* task)
+            : watcher(watcher),
+              task(task),
+              repeat(0.0),
+              offset(0.0),
+              interval(0.0),
+              timer(this) {
+          }
+
+          Watcher* const watcher;
+          Task* task;
+          double repeat;
+          double offset;
+          double interval;
+          basics::TimerWheel::Timer timer;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        SchedulerTimers ();
+
+        ~SchedulerTimers ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief (re-)starts a timer, firing after the timeout in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+        void start (Entry*, double timeout);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief (re-)starts a periodic event
+////////////////////////////////////////////////////////////////////////////////
+
+        void startPeriodic (Entry*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stops a timer or periodic event, if it is active
+////////////////////////////////////////////////////////////////////////////////
+
+        void stop (Entry*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the tasks of the expired events, and returns their number
+///
+/// a task may start, stop and uninstall any event of the loop
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t dispatch ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not an event has been started that fires before the
+/// time returned by the last call to arm
+////////////////////////////////////////////////////////////////////////////////
+
+        bool needsArming () const {
+          return _needsArming;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the seconds until dispatch must be called, or a negative
+/// value if there are no events
+////////////////////////////////////////////////////////////////////////////////
+
+        double arm ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the seconds since the construction on the monotonic clock
+////////////////////////////////////////////////////////////////////////////////
+
+        double elapsed () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts an event firing at the given elapsed time
+////////////////////////////////////////////////////////////////////////////////
+
+        void insert (Entry*, double at);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        basics::TimerWheel _wheel;
+
+        std::chrono::steady_clock::time_point const _start;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the tick returned by the last call to arm
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _armed;
+
+        bool _needsArming;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
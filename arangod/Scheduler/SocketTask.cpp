@@ -169,17 +169,33 @@ bool SocketTask::fillReadBuffer () {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool SocketTask::handleWrite () {
+  TRI_socket_buffer_t buffers[TRI_MAX_SOCKET_BUFFERS];
+  size_t numBuffers = 0;
   size_t len = 0;
 
   if (nullptr != _writeBuffer) {
     TRI_ASSERT(_writeBuffer->length() >= _writeLength);
     len = _writeBuffer->length() - _writeLength;
+
+    buffers[0]._data = _writeBuffer->begin() + _writeLength;
+    buffers[0]._length = len;
+    numBuffers = 1;
+
+    if (0 < len) {
+      // the buffers queued behind the current one go out with the same call
+      numBuffers += queuedWriteBuffers(buffers + 1, TRI_MAX_SOCKET_BUFFERS - 1);
+    }
   }
 
   int nr = 0;
 
   if (0 < len) {
-    nr = TRI_WRITE_SOCKET(_commSocket, _writeBuffer->begin() + _writeLength, (int) len, 0);
+    if (numBuffers == 1) {
+      nr = TRI_WRITE_SOCKET(_commSocket, buffers[0]._data, (int) len, 0);
+    }
+    else {
+      nr = TRI_writevsocket(_commSocket, buffers, numBuffers);
+    }
 
     if (nr < 0) {
       int myerrno = errno;
@@ -200,13 +216,18 @@ bool SocketTask::handleWrite () {
     }
 
     TRI_ASSERT(nr >= 0);
+  }
+
+  size_t written = (size_t) nr;
 
-    len -= nr;
+  if (written < len) {
+    _writeLength += written;
   }
+  else {
+    written -= len;
 
-  if (len == 0) {
     if (nullptr != _writeBuffer) {
-      delete _writeBuffer;
+      releaseWriteBuffer(_writeBuffer);
       _writeBuffer = nullptr;
     }
 
@@ -214,12 +235,30 @@ bool SocketTask::handleWrite () {
 
     completedWriteBuffer();
 
+    // completedWriteBuffer has installed the next queued buffer, which may
+    // have been written partially or completely by the same call
+    while (0 < written && nullptr != _writeBuffer) {
+      size_t const remaining = _writeBuffer->length() - _writeLength;
+
+      if (written < remaining) {
+        _writeLength += written;
+        written = 0;
+        break;
+      }
+
+      written -= remaining;
+
+      releaseWriteBuffer(_writeBuffer);
+      _writeBuffer = nullptr;
+
+      completedWriteBuffer();
+    }
+
+    TRI_ASSERT(written == 0);
+
     // rearm timer for keep-alive timeout
     setKeepAliveTimeout(_keepAliveTimeout);
   }
-  else {
-    _writeLength += nr;
-  }
 
   if (_clientClosed) {
     return false;
@@ -251,20 +290,23 @@ void SocketTask::setWriteBuffer (StringBuffer* buffer,
   _writeBufferStatistics = statistics;
 
   if (_writeBufferStatistics != nullptr) {
-    _writeBufferStatistics->_writeStart = TRI_StatisticsTime();
+    if (_writeBufferStatistics->_writeStart == 0.0) {
+      // a response may have been started with earlier buffers
+      _writeBufferStatistics->_writeStart = TRI_StatisticsTime();
+    }
     _writeBufferStatistics->_sentBytes += buffer->length();
   }
 
   _writeLength = 0;
 
   if (buffer->empty()) {
-    delete buffer;
+    releaseWriteBuffer(buffer);
 
     completedWriteBuffer();
   }
   else {
     if (_writeBuffer != nullptr) {
-      delete _writeBuffer;
+      releaseWriteBuffer(_writeBuffer);
     }
 
     _writeBuffer = buffer;
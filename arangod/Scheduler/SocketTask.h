@@ -145,6 +145,28 @@ namespace triagens {
 
         virtual void completedWriteBuffer () = 0;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief describes the non-empty buffers queued behind the write buffer
+///
+/// handleWrite sends these together with the write buffer in one gathering
+/// write. they must be the buffers which completedWriteBuffer installs next,
+/// in this order. the default is to have no queue
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual size_t queuedWriteBuffers (TRI_socket_buffer_t*,
+                                           size_t) {
+          return 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief disposes of a write buffer that has been sent. the default is to
+/// delete it
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual void releaseWriteBuffer (basics::StringBuffer* buffer) {
+          delete buffer;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief handles a keep-alive timeout
 ////////////////////////////////////////////////////////////////////////////////
@@ -174,6 +196,16 @@ namespace triagens {
 // --SECTION--                                                      Task methods
 // -----------------------------------------------------------------------------
 
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isConnection () const override {
+          return true;
+        }
+
       protected:
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -114,6 +114,14 @@ bool Task::needsMainEventLoop () const {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the task handles a client connection
+////////////////////////////////////////////////////////////////////////////////
+
+bool Task::isConnection () const {
+  return false;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
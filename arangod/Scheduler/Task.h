@@ -138,6 +138,12 @@ namespace triagens {
 
         virtual bool needsMainEventLoop () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the task handles a client connection
+////////////////////////////////////////////////////////////////////////////////
+
+        virtual bool isConnection () const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief called by scheduler to indicate an event
 ///
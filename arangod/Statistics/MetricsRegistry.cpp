@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registry of server metrics
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MetricsRegistry.h"
+#include "Basics/Exceptions.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/StringUtils.h"
+
+#include <cmath>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a metric with its labels
+////////////////////////////////////////////////////////////////////////////////
+
+struct MetricsRegistry::Metric {
+  std::string _labels;
+  std::unique_ptr<MetricsCounter> _counter;
+  std::unique_ptr<MetricsGauge> _gauge;
+  std::unique_ptr<MetricsHistogram> _histogram;
+  std::function<double()> _callback;
+  void const* _owner;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief all metrics of a name
+////////////////////////////////////////////////////////////////////////////////
+
+struct MetricsRegistry::Family {
+  std::string _help;
+  MetricType _type;
+  std::vector<std::unique_ptr<Metric>> _metrics;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a value in the export format
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendValue (std::string& out,
+                         double value) {
+  // integral values are written without exponent, e.g. large counters
+  if (std::abs(value) < 9007199254740992.0 && value == std::floor(value)) {
+    out.append(StringUtils::itoa(static_cast<int64_t>(value)));
+  }
+  else {
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.15g", value);
+    out.append(buffer, static_cast<size_t>(length));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a sample line
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendSample (std::string& out,
+                          std::string const& name,
+                          char const* suffix,
+                          std::string const& labels,
+                          std::string const& extraLabel,
+                          double value) {
+  out.append(name);
+  out.append(suffix);
+
+  if (! labels.empty() || ! extraLabel.empty()) {
+    out.push_back('{');
+    out.append(labels);
+    if (! labels.empty() && ! extraLabel.empty()) {
+      out.push_back(',');
+    }
+    out.append(extraLabel);
+    out.push_back('}');
+  }
+
+  out.push_back(' ');
+  AppendValue(out, value);
+  out.push_back('\n');
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  MetricsHistogram
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a histogram
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsHistogram::MetricsHistogram (std::vector<double> const& bounds)
+  : _bounds(bounds),
+    _counts(new std::atomic<uint64_t>[bounds.size() + 1]),
+    _sum(0.0) {
+
+  for (size_t i = 0;  i <= _bounds.size();  ++i) {
+    _counts[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a value
+////////////////////////////////////////////////////////////////////////////////
+
+void MetricsHistogram::observe (double value) {
+  size_t bucket = 0;
+
+  while (bucket < _bounds.size() && value > _bounds[bucket]) {
+    ++bucket;
+  }
+
+  _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+
+  double sum = _sum.load(std::memory_order_relaxed);
+
+  while (! _sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) {
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+MetricsRegistry::MetricsRegistry ()
+  : _lock(),
+    _families() {
+}
+
+MetricsRegistry::~MetricsRegistry () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the instance
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsRegistry* MetricsRegistry::instance () {
+  // never destroyed, as metrics may be updated until the process ends
+  static MetricsRegistry* Instance = new MetricsRegistry();
+
+  return Instance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a counter, creating it if needed
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsCounter* MetricsRegistry::counter (std::string const& name,
+                                          std::string const& help,
+                                          std::string const& labels) {
+  MUTEX_LOCKER(_lock);
+
+  Metric* metric = lookup(name, help, COUNTER, labels);
+
+  if (metric->_counter == nullptr) {
+    if (metric->_callback) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "metric '" + name + "' is read from a callback");
+    }
+    metric->_counter.reset(new MetricsCounter());
+  }
+
+  return metric->_counter.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a gauge, creating it if needed
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsGauge* MetricsRegistry::gauge (std::string const& name,
+                                      std::string const& help,
+                                      std::string const& labels) {
+  MUTEX_LOCKER(_lock);
+
+  Metric* metric = lookup(name, help, GAUGE, labels);
+
+  if (metric->_gauge == nullptr) {
+    if (metric->_callback) {
+      THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "metric '" + name + "' is read from a callback");
+    }
+    metric->_gauge.reset(new MetricsGauge());
+  }
+
+  return metric->_gauge.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a histogram, creating it with the bounds if needed
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsHistogram* MetricsRegistry::histogram (std::string const& name,
+                                              std::string const& help,
+                                              std::vector<double> const& bounds,
+                                              std::string const& labels) {
+  MUTEX_LOCKER(_lock);
+
+  Metric* metric = lookup(name, help, HISTOGRAM, labels);
+
+  if (metric->_histogram == nullptr) {
+    metric->_histogram.reset(new MetricsHistogram(bounds));
+  }
+
+  return metric->_histogram.get();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers a counter or gauge whose value is read from a callback
+////////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::addCallback (std::string const& name,
+                                   std::string const& help,
+                                   MetricType type,
+                                   void const* owner,
+                                   std::function<double()> const& callback,
+                                   std::string const& labels) {
+  TRI_ASSERT(type != HISTOGRAM);
+
+  MUTEX_LOCKER(_lock);
+
+  Metric* metric = lookup(name, help, type, labels);
+
+  if (metric->_counter != nullptr || metric->_gauge != nullptr) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "metric '" + name + "' is not read from a callback");
+  }
+
+  // a new owner replaces the previous one, e.g. after a restart of a feature
+  metric->_callback = callback;
+  metric->_owner = owner;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all callbacks of an owner
+////////////////////////////////////////////////////////////////////////////////
+
+void MetricsRegistry::removeCallbacks (void const* owner) {
+  MUTEX_LOCKER(_lock);
+
+  for (auto& family : _families) {
+    for (auto& metric : family.second->_metrics) {
+      if (metric->_callback && metric->_owner == owner) {
+        metric->_callback = nullptr;
+        metric->_owner = nullptr;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief exports all metrics in the Prometheus text format
+////////////////////////////////////////////////////////////////////////////////
+
+std::string MetricsRegistry::toPrometheus () const {
+  static char const* TypeNames[] = { "counter", "gauge", "histogram" };
+
+  std::string out;
+  out.reserve(8192);
+
+  MUTEX_LOCKER(_lock);
+
+  for (auto const& it : _families) {
+    std::string const& name = it.first;
+    Family const* family = it.second.get();
+
+    out.append("# HELP ");
+    out.append(name);
+    out.push_back(' ');
+    out.append(family->_help);
+    out.append("\n# TYPE ");
+    out.append(name);
+    out.push_back(' ');
+    out.append(TypeNames[family->_type]);
+    out.push_back('\n');
+
+    for (auto const& metric : family->_metrics) {
+      if (metric->_counter != nullptr) {
+        AppendSample(out, name, "", metric->_labels, "", static_cast<double>(metric->_counter->value()));
+      }
+      else if (metric->_gauge != nullptr) {
+        AppendSample(out, name, "", metric->_labels, "", static_cast<double>(metric->_gauge->value()));
+      }
+      else if (metric->_histogram != nullptr) {
+        MetricsHistogram const* histogram = metric->_histogram.get();
+        std::vector<double> const& bounds = histogram->bounds();
+        uint64_t total = 0;
+
+        for (size_t i = 0;  i <= bounds.size();  ++i) {
+          std::string le("le=\"");
+
+          if (i < bounds.size()) {
+            AppendValue(le, bounds[i]);
+          }
+          else {
+            le.append("+Inf");
+          }
+          le.push_back('"');
+
+          total += histogram->count(i);
+          AppendSample(out, name, "_bucket", metric->_labels, le, static_cast<double>(total));
+        }
+
+        AppendSample(out, name, "_sum", metric->_labels, "", histogram->sum());
+        AppendSample(out, name, "_count", metric->_labels, "", static_cast<double>(total));
+      }
+      else if (metric->_callback) {
+        double value;
+
+        try {
+          value = metric->_callback();
+        }
+        catch (...) {
+          continue;
+        }
+
+        AppendSample(out, name, "", metric->_labels, "", value);
+      }
+    }
+  }
+
+  return out;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates a metric
+////////////////////////////////////////////////////////////////////////////////
+
+MetricsRegistry::Metric* MetricsRegistry::lookup (std::string const& name,
+                                                  std::string const& help,
+                                                  MetricType type,
+                                                  std::string const& labels) {
+  auto it = _families.find(name);
+
+  if (it == _families.end()) {
+    std::unique_ptr<Family> family(new Family());
+    family->_help = help;
+    family->_type = type;
+
+    it = _families.emplace(name, std::move(family)).first;
+  }
+  else if ((*it).second->_type != type) {
+    THROW_ARANGO_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "metric '" + name + "' was registered with another type");
+  }
+
+  Family* family = (*it).second.get();
+
+  for (auto& metric : family->_metrics) {
+    if (metric->_labels == labels) {
+      return metric.get();
+    }
+  }
+
+  std::unique_ptr<Metric> metric(new Metric());
+  metric->_labels = labels;
+  metric->_owner = nullptr;
+
+  family->_metrics.emplace_back(std::move(metric));
+
+  return family->_metrics.back().get();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
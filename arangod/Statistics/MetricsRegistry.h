@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registry of server metrics
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_STATISTICS_METRICS_REGISTRY_H
+#define ARANGODB_STATISTICS_METRICS_REGISTRY_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+
+#include <atomic>
+#include <functional>
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    MetricsCounter
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a counter that only goes up
+////////////////////////////////////////////////////////////////////////////////
+
+    class MetricsCounter {
+
+      public:
+
+        MetricsCounter ()
+          : _value(0) {
+        }
+
+        void count (uint64_t n = 1) {
+          _value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        uint64_t value () const {
+          return _value.load(std::memory_order_relaxed);
+        }
+
+      private:
+
+        std::atomic<uint64_t> _value;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      MetricsGauge
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a value that goes up and down
+////////////////////////////////////////////////////////////////////////////////
+
+    class MetricsGauge {
+
+      public:
+
+        MetricsGauge ()
+          : _value(0) {
+        }
+
+        void set (int64_t value) {
+          _value.store(value, std::memory_order_relaxed);
+        }
+
+        void add (int64_t n) {
+          _value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        int64_t value () const {
+          return _value.load(std::memory_order_relaxed);
+        }
+
+      private:
+
+        std::atomic<int64_t> _value;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  MetricsHistogram
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a histogram with fixed upper bounds. the last bucket takes all
+/// values above the largest bound
+////////////////////////////////////////////////////////////////////////////////
+
+    class MetricsHistogram {
+
+      public:
+
+        MetricsHistogram (MetricsHistogram const&) = delete;
+        MetricsHistogram& operator= (MetricsHistogram const&) = delete;
+
+        explicit MetricsHistogram (std::vector<double> const& bounds);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a value
+////////////////////////////////////////////////////////////////////////////////
+
+        void observe (double value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the upper bounds of the buckets, without the last one
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<double> const& bounds () const {
+          return _bounds;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of values in a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t count (size_t bucket) const {
+          return _counts[bucket].load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the sum of all values
+////////////////////////////////////////////////////////////////////////////////
+
+        double sum () const {
+          return _sum.load(std::memory_order_relaxed);
+        }
+
+      private:
+
+        std::vector<double> const _bounds;
+
+        std::unique_ptr<std::atomic<uint64_t>[]> _counts;
+
+        std::atomic<double> _sum;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   MetricsRegistry
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the metrics of all subsystems, exported in the text format of
+/// Prometheus
+///
+/// a subsystem either asks the registry for a counter, gauge or histogram
+/// once and updates it without any locking, or registers a callback that
+/// reads a value it already keeps when the metrics are exported. metrics are
+/// never removed, so the pointers handed out stay valid. callbacks are
+/// removed by their owner before it goes away.
+///
+/// a metric is identified by its name and its labels, which are given in
+/// the export format, e.g. 'method="GET"'. asking for an existing metric
+/// returns it
+////////////////////////////////////////////////////////////////////////////////
+
+    class MetricsRegistry {
+
+      public:
+
+        MetricsRegistry (MetricsRegistry const&) = delete;
+        MetricsRegistry& operator= (MetricsRegistry const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief metric types
+////////////////////////////////////////////////////////////////////////////////
+
+        enum MetricType {
+          COUNTER,
+          GAUGE,
+          HISTOGRAM
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      private:
+
+        MetricsRegistry ();
+
+        ~MetricsRegistry ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the instance
+////////////////////////////////////////////////////////////////////////////////
+
+        static MetricsRegistry* instance ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a counter, creating it if needed
+////////////////////////////////////////////////////////////////////////////////
+
+        MetricsCounter* counter (std::string const& name,
+                                 std::string const& help,
+                                 std::string const& labels = "");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a gauge, creating it if needed
+////////////////////////////////////////////////////////////////////////////////
+
+        MetricsGauge* gauge (std::string const& name,
+                             std::string const& help,
+                             std::string const& labels = "");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a histogram, creating it with the bounds if needed
+////////////////////////////////////////////////////////////////////////////////
+
+        MetricsHistogram* histogram (std::string const& name,
+                                     std::string const& help,
+                                     std::vector<double> const& bounds,
+                                     std::string const& labels = "");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers a counter or gauge whose value is read from a callback.
+/// the callback is called with the registry locked, so it must be cheap and
+/// must not use the registry
+////////////////////////////////////////////////////////////////////////////////
+
+        void addCallback (std::string const& name,
+                          std::string const& help,
+                          MetricType type,
+                          void const* owner,
+                          std::function<double()> const& callback,
+                          std::string const& labels = "");
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all callbacks of an owner
+////////////////////////////////////////////////////////////////////////////////
+
+        void removeCallbacks (void const* owner);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief exports all metrics in the Prometheus text format
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string toPrometheus () const;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+        struct Metric;
+        struct Family;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates a metric. the caller must hold the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        Metric* lookup (std::string const& name,
+                        std::string const& help,
+                        MetricType type,
+                        std::string const& labels);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the families, not the values of the metrics
+////////////////////////////////////////////////////////////////////////////////
+
+        mutable Mutex _lock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the metrics by name, sorted for a stable export
+////////////////////////////////////////////////////////////////////////////////
+
+        std::map<std::string, std::unique_ptr<Family>> _families;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -212,6 +212,20 @@ namespace triagens {
   }                                                                                   \
   while (0)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the endpoint from the request path
+////////////////////////////////////////////////////////////////////////////////
+
+#define RequestStatisticsAgentSetEndpoint(a,b)                                        \
+  do {                                                                                \
+    if (TRI_ENABLE_STATISTICS) {                                                      \
+      if ((a)->RequestStatisticsAgent::_statistics != nullptr) {                      \
+        (a)->RequestStatisticsAgent::_statistics->_endpoint = TRI_RequestStatisticsEndpoint(b); \
+      }                                                                               \
+    }                                                                                 \
+  }                                                                                   \
+  while (0)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the async flag
 ////////////////////////////////////////////////////////////////////////////////
@@ -298,6 +312,20 @@ namespace triagens {
   }                                                                                   \
   while (0)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the priority class
+////////////////////////////////////////////////////////////////////////////////
+
+#define RequestStatisticsAgentSetPriority(a,b)                                        \
+  do {                                                                                \
+    if (TRI_ENABLE_STATISTICS) {                                                      \
+      if ((a)->RequestStatisticsAgent::_statistics != nullptr) {                      \
+        (a)->RequestStatisticsAgent::_statistics->_priority = (int) (b);              \
+      }                                                                               \
+    }                                                                                 \
+  }                                                                                   \
+  while (0)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the queue end
 ////////////////////////////////////////////////////////////////////////////////
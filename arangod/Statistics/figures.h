@@ -32,6 +32,8 @@
 
 #include "Basics/Common.h"
 
+#include <cmath>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -112,6 +114,167 @@ namespace triagens {
       std::vector<double> _cuts;
       std::vector<uint64_t> _counts;
     };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a log-linear histogram of non-negative integer values
+///
+/// values below 2^SubBucketBits have a bucket of their own. above, every
+/// power of two is split into 2^(SubBucketBits - 1) buckets, so a bucket is
+/// at most 1/32 of its values wide and percentiles are accurate to about 3%
+/// at any scale. values of 2^MaxBits and above share the last bucket
+////////////////////////////////////////////////////////////////////////////////
+
+    struct StatisticsHistogram {
+      static int const SubBucketBits = 6;
+      static int const MaxBits = 36;
+      static size_t const HalfSubBuckets = static_cast<size_t>(1) << (SubBucketBits - 1);
+      static size_t const NumBuckets = (MaxBits - SubBucketBits + 2) * HalfSubBuckets;
+
+      StatisticsHistogram ()
+        : _count(0), _total(0), _min(UINT64_MAX), _max(0), _counts(NumBuckets, 0) {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bucket of a value
+////////////////////////////////////////////////////////////////////////////////
+
+      static size_t bucket (uint64_t value) {
+        if (value < 2 * HalfSubBuckets) {
+          return static_cast<size_t>(value);
+        }
+
+        if (value >= (static_cast<uint64_t>(1) << MaxBits)) {
+          return NumBuckets - 1;
+        }
+
+        int const shift = highestBit(value) - SubBucketBits + 1;
+
+        return static_cast<size_t>(shift) * HalfSubBuckets + static_cast<size_t>(value >> shift);
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the smallest value of a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+      static uint64_t lowerBound (size_t bucket) {
+        if (bucket < 2 * HalfSubBuckets) {
+          return static_cast<uint64_t>(bucket);
+        }
+
+        size_t const shift = bucket / HalfSubBuckets - 1;
+
+        return static_cast<uint64_t>(bucket - shift * HalfSubBuckets) << shift;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the largest value of a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+      static uint64_t upperBound (size_t bucket) {
+        if (bucket + 1 >= NumBuckets) {
+          return UINT64_MAX;
+        }
+
+        return lowerBound(bucket + 1) - 1;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a value
+////////////////////////////////////////////////////////////////////////////////
+
+      void addFigure (uint64_t value) {
+        ++_counts[bucket(value)];
+        ++_count;
+        _total += value;
+
+        if (value < _min) {
+          _min = value;
+        }
+        if (value > _max) {
+          _max = value;
+        }
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the values of another histogram
+////////////////////////////////////////////////////////////////////////////////
+
+      void merge (StatisticsHistogram const& other) {
+        for (size_t i = 0;  i < NumBuckets;  ++i) {
+          _counts[i] += other._counts[i];
+        }
+
+        _count += other._count;
+        _total += other._total;
+
+        if (other._min < _min) {
+          _min = other._min;
+        }
+        if (other._max > _max) {
+          _max = other._max;
+        }
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the value below or at which the given fraction of the
+/// values lies, e.g. 0.99 for the 99th percentile. the result is the middle
+/// of the bucket of that value, but never outside the smallest and largest
+/// value added. returns 0 for an empty histogram
+////////////////////////////////////////////////////////////////////////////////
+
+      uint64_t percentile (double fraction) const {
+        if (_count == 0) {
+          return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(_count)));
+
+        if (rank < 1) {
+          rank = 1;
+        }
+        else if (rank > _count) {
+          rank = _count;
+        }
+
+        uint64_t seen = 0;
+
+        for (size_t i = 0;  i < NumBuckets;  ++i) {
+          seen += _counts[i];
+
+          if (seen >= rank) {
+            uint64_t const lower = lowerBound(i);
+            uint64_t const upper = (i + 1 == NumBuckets ? _max : upperBound(i));
+            uint64_t const value = lower + (upper - lower) / 2;
+
+            return (std::max)(_min, (std::min)(_max, value));
+          }
+        }
+
+        return _max;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of the highest bit set in a non-zero value
+////////////////////////////////////////////////////////////////////////////////
+
+      static int highestBit (uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63 - __builtin_clzll(value);
+#else
+        int n = 0;
+        while (value >>= 1) {
+          ++n;
+        }
+        return n;
+#endif
+      }
+
+      uint64_t _count;
+      uint64_t _total;
+      uint64_t _min;
+      uint64_t _max;
+      std::vector<uint64_t> _counts;
+    };
   }
 }
 
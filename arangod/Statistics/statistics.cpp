@@ -29,9 +29,14 @@
 
 #include "statistics.h"
 
+#include "Basics/logging.h"
+#include "Basics/memory-map.h"
 #include "Basics/Mutex.h"
 #include "Basics/MutexLocker.h"
 #include "Basics/threads.h"
+#include "Statistics/MetricsRegistry.h"
+
+#include <atomic>
 
 #include <boost/lockfree/queue.hpp>
 
@@ -95,6 +100,12 @@ static void ProcessRequestStatistics (TRI_request_statistics_t* statistics) {
       if (statistics->_queueStart != 0.0 && statistics->_queueEnd != 0.0) {
         queueTime = statistics->_queueEnd - statistics->_queueStart;
         TRI_QueueTimeDistributionStatistics->addFigure(queueTime);
+
+        int priority = statistics->_priority;
+
+        if (0 <= priority && priority < TRI_STATISTICS_PRIORITY_CLASSES) {
+          TRI_QueueTimeClassDistributionStatistics[priority]->addFigure(queueTime);
+        }
       }
 
       double ioTime = totalTime - requestTime - queueTime;
@@ -138,6 +149,258 @@ static size_t ProcessAllRequestStatistics () {
   return count;
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                            private request histogram variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of endpoints, the last one is "other"
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MAX_ENDPOINTS = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum length of an endpoint name
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MAX_ENDPOINT_LENGTH = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of HTTP methods, including the illegal one
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const NUM_METHODS = static_cast<size_t>(triagens::rest::HttpRequest::HTTP_REQUEST_ILLEGAL) + 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief histogram groups: all requests, one per method, one per endpoint
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const NUM_GROUPS = 1 + NUM_METHODS + MAX_ENDPOINTS;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recorded times: total, request, queue and IO time
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const NUM_TIMES = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief names of the endpoints. a name is written once before the number
+/// of endpoints is increased, so it can be read without the lock
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string EndpointNames[MAX_ENDPOINTS];
+
+static std::atomic<size_t> NumEndpoints(0);
+
+static triagens::basics::Mutex EndpointLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a histogram that is written by a single thread without locking and
+/// read by others
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+  struct RecordingHistogram {
+    RecordingHistogram () {
+      for (size_t i = 0;  i < StatisticsHistogram::NumBuckets;  ++i) {
+        _counts[i].store(0, std::memory_order_relaxed);
+      }
+      _total.store(0, std::memory_order_relaxed);
+      _min.store(UINT64_MAX, std::memory_order_relaxed);
+      _max.store(0, std::memory_order_relaxed);
+    }
+
+    // only the owning thread writes, so there is no need for atomic increments
+    void addFigure (uint64_t value) {
+      auto& count = _counts[StatisticsHistogram::bucket(value)];
+      count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+      _total.store(_total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+
+      if (value < _min.load(std::memory_order_relaxed)) {
+        _min.store(value, std::memory_order_relaxed);
+      }
+      if (value > _max.load(std::memory_order_relaxed)) {
+        _max.store(value, std::memory_order_relaxed);
+      }
+    }
+
+    void mergeInto (StatisticsHistogram& histogram) const {
+      for (size_t i = 0;  i < StatisticsHistogram::NumBuckets;  ++i) {
+        uint64_t const count = _counts[i].load(std::memory_order_relaxed);
+
+        histogram._counts[i] += count;
+        // the count is taken from the buckets, so percentiles stay consistent
+        // while the owner keeps writing
+        histogram._count += count;
+      }
+
+      histogram._total += _total.load(std::memory_order_relaxed);
+      histogram._min = (std::min)(histogram._min, _min.load(std::memory_order_relaxed));
+      histogram._max = (std::max)(histogram._max, _max.load(std::memory_order_relaxed));
+    }
+
+    std::atomic<uint64_t> _counts[StatisticsHistogram::NumBuckets];
+    std::atomic<uint64_t> _total;
+    std::atomic<uint64_t> _min;
+    std::atomic<uint64_t> _max;
+  };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the histograms of a thread, created on first use
+////////////////////////////////////////////////////////////////////////////////
+
+  struct ThreadHistograms {
+    ThreadHistograms () {
+      for (size_t i = 0;  i < NUM_GROUPS;  ++i) {
+        for (size_t j = 0;  j < NUM_TIMES;  ++j) {
+          _histograms[i][j].store(nullptr, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    void addFigure (size_t group,
+                    size_t time,
+                    uint64_t value) {
+      RecordingHistogram* histogram = _histograms[group][time].load(std::memory_order_relaxed);
+
+      if (histogram == nullptr) {
+        histogram = new RecordingHistogram();
+        _histograms[group][time].store(histogram, std::memory_order_release);
+      }
+
+      histogram->addFigure(value);
+    }
+
+    std::atomic<RecordingHistogram*> _histograms[NUM_GROUPS][NUM_TIMES];
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the histograms of all threads. they are kept until the process
+/// ends, as threads may record until then
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<ThreadHistograms*> AllThreadHistograms;
+
+static triagens::basics::Mutex ThreadHistogramsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the histograms of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local ThreadHistograms* LocalHistograms = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief total time of the requests, exported as metric
+////////////////////////////////////////////////////////////////////////////////
+
+static MetricsHistogram* RequestDurationMetric = nullptr;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                            private request histogram functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the endpoint name of a request path
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string EndpointName (char const* path) {
+  std::string name(path);
+
+  // strip the database prefix
+  if (name.compare(0, 5, "/_db/") == 0) {
+    size_t const pos = name.find('/', 5);
+    name = (pos == std::string::npos ? "/" : name.substr(pos));
+  }
+
+  // system APIs are told apart by their second segment
+  size_t const segments = (name.compare(0, 2, "/_") == 0 ? 2 : 1);
+  size_t pos = 0;
+
+  for (size_t i = 0;  i < segments && pos != std::string::npos;  ++i) {
+    pos = name.find('/', pos + 1);
+  }
+
+  if (pos != std::string::npos) {
+    name.resize(pos);
+  }
+
+  if (name.size() > MAX_ENDPOINT_LENGTH) {
+    name.resize(MAX_ENDPOINT_LENGTH);
+  }
+
+  return name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts seconds into microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t Microseconds (double seconds) {
+  return (seconds <= 0.0 ? 0 : static_cast<uint64_t>(seconds * 1000000.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the times of a finished request in the histograms of the
+/// current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static void RecordRequestHistograms (TRI_request_statistics_t const* statistics) {
+  // check that the request was completely received and transmitted
+  if (statistics->_readStart == 0.0 || statistics->_writeEnd == 0.0) {
+    return;
+  }
+
+  ThreadHistograms* local = LocalHistograms;
+
+  if (local == nullptr) {
+    local = new ThreadHistograms();
+
+    MUTEX_LOCKER(ThreadHistogramsLock);
+    AllThreadHistograms.emplace_back(local);
+    LocalHistograms = local;
+  }
+
+  size_t groups[3];
+  size_t numGroups = 0;
+
+  groups[numGroups++] = 0;
+
+  size_t const method = static_cast<size_t>(statistics->_requestType);
+
+  if (method < NUM_METHODS) {
+    groups[numGroups++] = 1 + method;
+  }
+
+  if (statistics->_endpoint >= 0) {
+    groups[numGroups++] = 1 + NUM_METHODS + static_cast<size_t>(statistics->_endpoint);
+  }
+
+  double const totalTime = statistics->_writeEnd - statistics->_readStart;
+  double const requestTime = statistics->_requestEnd - statistics->_requestStart;
+  bool const queued = (statistics->_queueStart != 0.0 && statistics->_queueEnd != 0.0);
+  double const queueTime = (queued ? statistics->_queueEnd - statistics->_queueStart : 0.0);
+  double const ioTime = totalTime - requestTime - queueTime;
+
+  if (RequestDurationMetric != nullptr) {
+    RequestDurationMetric->observe(totalTime);
+  }
+
+  for (size_t i = 0;  i < numGroups;  ++i) {
+    local->addFigure(groups[i], 0, Microseconds(totalTime));
+    local->addFigure(groups[i], 1, Microseconds(requestTime));
+
+    if (queued) {
+      local->addFigure(groups[i], 2, Microseconds(queueTime));
+    }
+
+    if (ioTime >= 0.0) {
+      local->addFigure(groups[i], 3, Microseconds(ioTime));
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                               public request statistics functions
 // -----------------------------------------------------------------------------
@@ -166,6 +429,14 @@ void TRI_ReleaseRequestStatistics (TRI_request_statistics_t* statistics) {
   }
  
   if (! statistics->_ignore) {
+    // the histograms are recorded right here by the request's thread, without
+    // waiting for the statistics thread and without a lock
+    try {
+      RecordRequestHistograms(statistics);
+    }
+    catch (...) {
+    }
+
 #ifdef TRI_ENABLE_MAINTAINER_MODE
     bool ok = RequestFinishedList.push(statistics);
     TRI_ASSERT(ok);
@@ -205,6 +476,256 @@ void TRI_FillRequestStatistics (StatisticsDistribution& totalTime,
   bytesReceived = *TRI_BytesReceivedDistributionStatistics;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the queue time statistics per priority class
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillQueueTimeStatistics (vector<StatisticsDistribution>& queueTimes) {
+  MUTEX_LOCKER(RequestDataLock);
+
+  queueTimes.clear();
+
+  for (size_t i = 0;  i < TRI_STATISTICS_PRIORITY_CLASSES;  ++i) {
+    queueTimes.emplace_back(*TRI_QueueTimeClassDistributionStatistics[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the endpoint of a request path
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_RequestStatisticsEndpoint (char const* path) {
+  if (path == nullptr) {
+    return -1;
+  }
+
+  std::string const name = EndpointName(path);
+
+  size_t n = NumEndpoints.load(std::memory_order_acquire);
+
+  for (size_t i = 0;  i < n;  ++i) {
+    if (EndpointNames[i] == name) {
+      return static_cast<int>(i);
+    }
+  }
+
+  MUTEX_LOCKER(EndpointLock);
+
+  // another thread may have added the endpoint in the meantime
+  for (size_t i = n;  i < NumEndpoints.load(std::memory_order_relaxed);  ++i) {
+    if (EndpointNames[i] == name) {
+      return static_cast<int>(i);
+    }
+  }
+
+  n = NumEndpoints.load(std::memory_order_relaxed);
+
+  if (n == MAX_ENDPOINTS - 1) {
+    return static_cast<int>(MAX_ENDPOINTS - 1);
+  }
+
+  EndpointNames[n] = name;
+  NumEndpoints.store(n + 1, std::memory_order_release);
+
+  return static_cast<int>(n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the request time histograms
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillRequestHistograms (TRI_request_histograms_t& all,
+                                std::vector<TRI_request_histograms_t>& methods,
+                                std::vector<TRI_request_histograms_t>& endpoints) {
+  methods.clear();
+  endpoints.clear();
+
+  size_t const numEndpoints = NumEndpoints.load(std::memory_order_acquire);
+
+  MUTEX_LOCKER(ThreadHistogramsLock);
+
+  for (size_t group = 0;  group < NUM_GROUPS;  ++group) {
+    TRI_request_histograms_t* result = nullptr;
+
+    for (auto const* local : AllThreadHistograms) {
+      for (size_t time = 0;  time < NUM_TIMES;  ++time) {
+        RecordingHistogram const* histogram = local->_histograms[group][time].load(std::memory_order_acquire);
+
+        if (histogram == nullptr) {
+          continue;
+        }
+
+        if (result == nullptr) {
+          if (group == 0) {
+            result = &all;
+          }
+          else if (group < 1 + NUM_METHODS) {
+            methods.emplace_back();
+            result = &methods.back();
+            result->_name = triagens::rest::HttpRequest::translateMethod(
+              static_cast<triagens::rest::HttpRequest::HttpRequestType>(group - 1));
+          }
+          else {
+            size_t const endpoint = group - 1 - NUM_METHODS;
+
+            endpoints.emplace_back();
+            result = &endpoints.back();
+            result->_name = (endpoint < numEndpoints ? EndpointNames[endpoint] : "other");
+          }
+        }
+
+        switch (time) {
+          case 0:
+            histogram->mergeInto(result->_totalTime);
+            break;
+          case 1:
+            histogram->mergeInto(result->_requestTime);
+            break;
+          case 2:
+            histogram->mergeInto(result->_queueTime);
+            break;
+          default:
+            histogram->mergeInto(result->_ioTime);
+            break;
+        }
+      }
+    }
+  }
+
+  all._name = "all";
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                          private replication statistics variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for replication statistics data
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex ReplicationDataLock;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                           public replication statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a batch of the continuous replication applier
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddReplicationStatistics (double fetchTime,
+                                   double applyTime,
+                                   double bytesReceived) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  MUTEX_LOCKER(ReplicationDataLock);
+
+  if (TRI_ReplicationFetchTimeDistributionStatistics == nullptr) {
+    // statistics are shut down
+    return;
+  }
+
+  TRI_ReplicationFetchTimeDistributionStatistics->addFigure(fetchTime);
+  TRI_ReplicationApplyTimeDistributionStatistics->addFigure(applyTime);
+  TRI_ReplicationBytesDistributionStatistics->addFigure(bytesReceived);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the replication applier statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillReplicationStatistics (StatisticsDistribution& fetchTime,
+                                    StatisticsDistribution& applyTime,
+                                    StatisticsDistribution& bytesReceived) {
+  MUTEX_LOCKER(ReplicationDataLock);
+
+  if (TRI_ReplicationFetchTimeDistributionStatistics == nullptr) {
+    return;
+  }
+
+  fetchTime = *TRI_ReplicationFetchTimeDistributionStatistics;
+  applyTime = *TRI_ReplicationApplyTimeDistributionStatistics;
+  bytesReceived = *TRI_ReplicationBytesDistributionStatistics;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                           private V8 context statistics variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for V8 context statistics data
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex V8ContextDataLock;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                            public V8 context statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a request waited for a V8 context
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddV8ContextStatistics (double waitTime,
+                                 bool background) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  MUTEX_LOCKER(V8ContextDataLock);
+
+  if (TRI_V8ContextWaitTimeDistributionStatistics == nullptr) {
+    // statistics are shut down
+    return;
+  }
+
+  if (background) {
+    TRI_V8BackgroundWaitTimeDistributionStatistics->addFigure(waitTime);
+  }
+  else {
+    TRI_V8ContextWaitTimeDistributionStatistics->addFigure(waitTime);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a V8 context spent in garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddV8GcStatistics (double gcTime) {
+  if (! TRI_ENABLE_STATISTICS) {
+    return;
+  }
+
+  MUTEX_LOCKER(V8ContextDataLock);
+
+  if (TRI_V8GcTimeDistributionStatistics == nullptr) {
+    // statistics are shut down
+    return;
+  }
+
+  TRI_V8GcTimeDistributionStatistics->addFigure(gcTime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the V8 context statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillV8ContextStatistics (StatisticsDistribution& waitTime,
+                                  StatisticsDistribution& backgroundWaitTime,
+                                  StatisticsDistribution& gcTime) {
+  MUTEX_LOCKER(V8ContextDataLock);
+
+  if (TRI_V8ContextWaitTimeDistributionStatistics == nullptr) {
+    return;
+  }
+
+  waitTime = *TRI_V8ContextWaitTimeDistributionStatistics;
+  backgroundWaitTime = *TRI_V8BackgroundWaitTimeDistributionStatistics;
+  gcTime = *TRI_V8GcTimeDistributionStatistics;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                           private connection statistics variables
 // -----------------------------------------------------------------------------
@@ -356,10 +877,38 @@ static void StatisticsQueueWorker (void* data) {
   delete TRI_TotalTimeDistributionStatistics;
   delete TRI_RequestTimeDistributionStatistics;
   delete TRI_QueueTimeDistributionStatistics;
+
+  for (size_t i = 0;  i < TRI_STATISTICS_PRIORITY_CLASSES;  ++i) {
+    delete TRI_QueueTimeClassDistributionStatistics[i];
+  }
   delete TRI_IoTimeDistributionStatistics;
   delete TRI_BytesSentDistributionStatistics;
   delete TRI_BytesReceivedDistributionStatistics;
 
+  {
+    MUTEX_LOCKER(ReplicationDataLock);
+
+    delete TRI_ReplicationFetchTimeDistributionStatistics;
+    delete TRI_ReplicationApplyTimeDistributionStatistics;
+    delete TRI_ReplicationBytesDistributionStatistics;
+
+    TRI_ReplicationFetchTimeDistributionStatistics = nullptr;
+    TRI_ReplicationApplyTimeDistributionStatistics = nullptr;
+    TRI_ReplicationBytesDistributionStatistics = nullptr;
+  }
+
+  {
+    MUTEX_LOCKER(V8ContextDataLock);
+
+    delete TRI_V8ContextWaitTimeDistributionStatistics;
+    delete TRI_V8BackgroundWaitTimeDistributionStatistics;
+    delete TRI_V8GcTimeDistributionStatistics;
+
+    TRI_V8ContextWaitTimeDistributionStatistics = nullptr;
+    TRI_V8BackgroundWaitTimeDistributionStatistics = nullptr;
+    TRI_V8GcTimeDistributionStatistics = nullptr;
+  }
+
   {
     TRI_request_statistics_t* entry = nullptr;
     while (RequestFreeList.pop(entry)) {
@@ -452,6 +1001,12 @@ StatisticsDistribution* TRI_RequestTimeDistributionStatistics;
 
 StatisticsDistribution* TRI_QueueTimeDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queue time distribution per priority class
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_QueueTimeClassDistributionStatistics[TRI_STATISTICS_PRIORITY_CLASSES];
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief i/o distribution
 ////////////////////////////////////////////////////////////////////////////////
@@ -482,6 +1037,54 @@ StatisticsVector TRI_BytesReceivedDistributionVectorStatistics;
 
 StatisticsDistribution* TRI_BytesReceivedDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication batch size distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsVector TRI_ReplicationBytesDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication fetch time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_ReplicationFetchTimeDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication apply time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_ReplicationApplyTimeDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication batch size distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_ReplicationBytesDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsVector TRI_V8ContextWaitTimeDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_V8ContextWaitTimeDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution of background jobs
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_V8BackgroundWaitTimeDistributionStatistics = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 garbage collection time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticsDistribution* TRI_V8GcTimeDistributionStatistics = nullptr;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief global server statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -520,15 +1123,37 @@ void TRI_InitializeStatistics () {
   TRI_BytesSentDistributionVectorStatistics << (250) << (1000) << (2 * 1000) << (5 * 1000) << (10 * 1000);
   TRI_BytesReceivedDistributionVectorStatistics << (250) << (1000) << (2 * 1000) << (5 * 1000) << (10 * 1000);
   TRI_RequestTimeDistributionVectorStatistics << (0.01) << (0.05) << (0.1) << (0.2) << (0.5) << (1.0);
+  TRI_ReplicationBytesDistributionVectorStatistics << (16 * 1024) << (64 * 1024) << (256 * 1024) << (1024 * 1024) << (4 * 1024 * 1024);
+  TRI_V8ContextWaitTimeDistributionVectorStatistics << (0.0001) << (0.001) << (0.01) << (0.1) << (1.0) << (10.0);
 
   TRI_ConnectionTimeDistributionStatistics = new StatisticsDistribution(TRI_ConnectionTimeDistributionVectorStatistics);
   TRI_TotalTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
   TRI_RequestTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
   TRI_QueueTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
+
+  for (size_t i = 0;  i < TRI_STATISTICS_PRIORITY_CLASSES;  ++i) {
+    TRI_QueueTimeClassDistributionStatistics[i] = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
+  }
   TRI_IoTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
   TRI_BytesSentDistributionStatistics = new StatisticsDistribution(TRI_BytesSentDistributionVectorStatistics);
   TRI_BytesReceivedDistributionStatistics = new StatisticsDistribution(TRI_BytesReceivedDistributionVectorStatistics);
 
+  {
+    MUTEX_LOCKER(ReplicationDataLock);
+
+    TRI_ReplicationFetchTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
+    TRI_ReplicationApplyTimeDistributionStatistics = new StatisticsDistribution(TRI_RequestTimeDistributionVectorStatistics);
+    TRI_ReplicationBytesDistributionStatistics = new StatisticsDistribution(TRI_ReplicationBytesDistributionVectorStatistics);
+  }
+
+  {
+    MUTEX_LOCKER(V8ContextDataLock);
+
+    TRI_V8ContextWaitTimeDistributionStatistics = new StatisticsDistribution(TRI_V8ContextWaitTimeDistributionVectorStatistics);
+    TRI_V8BackgroundWaitTimeDistributionStatistics = new StatisticsDistribution(TRI_V8ContextWaitTimeDistributionVectorStatistics);
+    TRI_V8GcTimeDistributionStatistics = new StatisticsDistribution(TRI_V8ContextWaitTimeDistributionVectorStatistics);
+  }
+
   // initialize counters for all HTTP request types
   TRI_MethodRequestsStatistics.clear();
 
@@ -537,6 +1162,76 @@ void TRI_InitializeStatistics () {
     TRI_MethodRequestsStatistics.emplace_back(c);
   }
 
+  // .............................................................................
+  // export the counters as metrics
+  // .............................................................................
+
+  auto metrics = MetricsRegistry::instance();
+
+  metrics->addCallback("arangodb_http_connections", "Number of open HTTP connections",
+                       MetricsRegistry::GAUGE, &TRI_ServerStatistics, [] () {
+    MUTEX_LOCKER(ConnectionDataLock);
+    return static_cast<double>(TRI_HttpConnectionsStatistics._count);
+  });
+  metrics->addCallback("arangodb_http_async_requests_total", "Number of asynchronous HTTP requests",
+                       MetricsRegistry::COUNTER, &TRI_ServerStatistics, [] () {
+    MUTEX_LOCKER(RequestDataLock);
+    return static_cast<double>(TRI_AsyncRequestsStatistics._count);
+  });
+
+  for (size_t i = 0; i < TRI_MethodRequestsStatistics.size(); ++i) {
+    auto const method = static_cast<triagens::rest::HttpRequest::HttpRequestType>(i);
+    std::string const labels = "method=\"" + triagens::rest::HttpRequest::translateMethod(method) + "\"";
+
+    metrics->addCallback("arangodb_http_requests_total", "Number of HTTP requests",
+                         MetricsRegistry::COUNTER, &TRI_ServerStatistics, [i] () {
+      MUTEX_LOCKER(RequestDataLock);
+      return static_cast<double>(TRI_MethodRequestsStatistics[i]._count);
+    }, labels);
+  }
+
+  metrics->addCallback("arangodb_log_dropped_messages_total", "Number of log messages dropped because the logging thread could not keep up",
+                       MetricsRegistry::COUNTER, &TRI_ServerStatistics, [] () {
+    return static_cast<double>(TRI_DroppedMessagesLogging());
+  });
+
+  for (TRI_memory_zone_id_t zid = 0; zid < TRI_FIRST_ARENA_MEMORY_ZONE_ID; ++zid) {
+    std::string const labels = std::string("zone=\"") + TRI_MemoryZoneName(zid) + "\"";
+
+    metrics->addCallback("arangodb_memory_zone_bytes", "Memory accounted in a memory zone",
+                         MetricsRegistry::GAUGE, &TRI_ServerStatistics, [zid] () {
+      int64_t bytes;
+      int64_t allocations;
+      TRI_MemoryZoneUsage(zid, &bytes, &allocations);
+      return static_cast<double>(bytes);
+    }, labels);
+    metrics->addCallback("arangodb_memory_zone_allocations", "Number of allocations accounted in a memory zone",
+                         MetricsRegistry::GAUGE, &TRI_ServerStatistics, [zid] () {
+      int64_t bytes;
+      int64_t allocations;
+      TRI_MemoryZoneUsage(zid, &bytes, &allocations);
+      return static_cast<double>(allocations);
+    }, labels);
+  }
+
+  metrics->addCallback("arangodb_huge_pages_bytes", "Memory of index tables backed by huge pages",
+                       MetricsRegistry::GAUGE, &TRI_ServerStatistics, [] () {
+    int64_t bytes;
+    int64_t fallbacks;
+    TRI_HugePagesStatistics(&bytes, &fallbacks);
+    return static_cast<double>(bytes);
+  });
+  metrics->addCallback("arangodb_huge_pages_fallbacks_total", "Number of index tables that could not be backed by huge pages",
+                       MetricsRegistry::COUNTER, &TRI_ServerStatistics, [] () {
+    int64_t bytes;
+    int64_t fallbacks;
+    TRI_HugePagesStatistics(&bytes, &fallbacks);
+    return static_cast<double>(fallbacks);
+  });
+
+  RequestDurationMetric = metrics->histogram("arangodb_http_request_duration_seconds", "Total time of the HTTP requests",
+                                             { 0.001, 0.005, 0.01, 0.05, 0.1, 0.2, 0.5, 1.0, 5.0 });
+
   // .............................................................................
   // generate the request statistics queue
   // .............................................................................
@@ -38,6 +38,18 @@
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of dispatcher priority classes, see Job::priority_e
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_STATISTICS_PRIORITY_CLASSES (3)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief default dispatcher priority class
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_STATISTICS_PRIORITY_NORMAL (1)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief request statistics
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,6 +67,8 @@ struct TRI_request_statistics_t {
       _receivedBytes(0.0),
       _sentBytes(0.0),
       _requestType(triagens::rest::HttpRequest::HTTP_REQUEST_ILLEGAL),
+      _priority(TRI_STATISTICS_PRIORITY_NORMAL),
+      _endpoint(-1),
       _async(false),
       _tooLarge(false),
       _executeError(false),
@@ -73,6 +87,8 @@ struct TRI_request_statistics_t {
     _receivedBytes = 0.0;
     _sentBytes     = 0.0;
     _requestType   = triagens::rest::HttpRequest::HTTP_REQUEST_ILLEGAL;
+    _priority      = TRI_STATISTICS_PRIORITY_NORMAL;
+    _endpoint      = -1;
     _async         = false;
     _tooLarge      = false;
     _executeError  = false;
@@ -93,6 +109,12 @@ struct TRI_request_statistics_t {
 
   triagens::rest::HttpRequest::HttpRequestType _requestType;
 
+  // priority class of the dispatcher job, see Job::priority_e
+  int _priority;
+
+  // endpoint of the request, see TRI_RequestStatisticsEndpoint
+  int _endpoint;
+
   bool _async;
   bool _tooLarge;
   bool _executeError;
@@ -139,6 +161,20 @@ struct TRI_server_statistics_t {
   double _uptime;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request time histograms of all requests, of an HTTP method or of an
+/// endpoint. times are in microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_request_histograms_t {
+  std::string _name;
+
+  triagens::basics::StatisticsHistogram _totalTime;
+  triagens::basics::StatisticsHistogram _requestTime;
+  triagens::basics::StatisticsHistogram _queueTime;
+  triagens::basics::StatisticsHistogram _ioTime;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                               public request statistics functions
 // -----------------------------------------------------------------------------
@@ -166,6 +202,78 @@ void TRI_FillRequestStatistics (triagens::basics::StatisticsDistribution& totalT
                                 triagens::basics::StatisticsDistribution& bytesSent,
                                 triagens::basics::StatisticsDistribution& bytesReceived);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the queue time statistics per priority class
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillQueueTimeStatistics (std::vector<triagens::basics::StatisticsDistribution>& queueTimes);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the endpoint of a request path, to be stored in the request
+/// statistics
+///
+/// the endpoint is the path without the database prefix, cut after two
+/// segments for system APIs (e.g. /_api/document) and after one segment
+/// otherwise. the number of endpoints is limited, further ones are counted
+/// as "other"
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_RequestStatisticsEndpoint (char const* path);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the request time histograms of all requests, per HTTP method
+/// and per endpoint. methods and endpoints without requests are left out
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillRequestHistograms (TRI_request_histograms_t& all,
+                                std::vector<TRI_request_histograms_t>& methods,
+                                std::vector<TRI_request_histograms_t>& endpoints);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                           public replication statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a batch of the continuous replication applier
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddReplicationStatistics (double fetchTime,
+                                   double applyTime,
+                                   double bytesReceived);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the replication applier statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillReplicationStatistics (triagens::basics::StatisticsDistribution& fetchTime,
+                                    triagens::basics::StatisticsDistribution& applyTime,
+                                    triagens::basics::StatisticsDistribution& bytesReceived);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                            public V8 context statistics functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a request or a background job waited for a V8 context
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddV8ContextStatistics (double waitTime,
+                                 bool background);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the time a V8 context spent in garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddV8GcStatistics (double gcTime);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the V8 context statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FillV8ContextStatistics (triagens::basics::StatisticsDistribution& waitTime,
+                                  triagens::basics::StatisticsDistribution& backgroundWaitTime,
+                                  triagens::basics::StatisticsDistribution& gcTime);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                            public connection statistics functions
 // -----------------------------------------------------------------------------
@@ -272,6 +380,12 @@ extern triagens::basics::StatisticsDistribution* TRI_RequestTimeDistributionStat
 
 extern triagens::basics::StatisticsDistribution* TRI_QueueTimeDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief queue time distribution per priority class
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_QueueTimeClassDistributionStatistics[TRI_STATISTICS_PRIORITY_CLASSES];
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief i/o distribution
 ////////////////////////////////////////////////////////////////////////////////
@@ -302,6 +416,54 @@ extern triagens::basics::StatisticsVector TRI_BytesReceivedDistributionVectorSta
 
 extern triagens::basics::StatisticsDistribution* TRI_BytesReceivedDistributionStatistics;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication batch size distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsVector TRI_ReplicationBytesDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication fetch time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_ReplicationFetchTimeDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication apply time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_ReplicationApplyTimeDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication batch size distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_ReplicationBytesDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution vector
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsVector TRI_V8ContextWaitTimeDistributionVectorStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_V8ContextWaitTimeDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 context wait time distribution of background jobs
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_V8BackgroundWaitTimeDistributionStatistics;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 garbage collection time distribution
+////////////////////////////////////////////////////////////////////////////////
+
+extern triagens::basics::StatisticsDistribution* TRI_V8GcTimeDistributionStatistics;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief global server statistics
 ////////////////////////////////////////////////////////////////////////////////
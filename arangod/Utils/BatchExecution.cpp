@@ -0,0 +1,597 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execution of the parts of a batch request
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/BatchExecution.h"
+
+#include "Basics/ConditionLocker.h"
+#include "Basics/Exceptions.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
+#include "Basics/StringBuffer.h"
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/DispatcherQueue.h"
+#include "HttpServer/HttpHandler.h"
+#include "HttpServer/HttpHandlerFactory.h"
+#include "HttpServer/HttpServer.h"
+#include "Rest/HttpRequest.h"
+#include "Rest/HttpResponse.h"
+
+using namespace triagens::arango;
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class BatchExecution
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+BatchExecution::BatchExecution (HttpHandlerFactory* factory,
+                                std::string const& boundary,
+                                size_t parallelism)
+  : _factory(factory),
+    _boundary(boundary),
+    _parallelism(parallelism > 0 ? parallelism : 1),
+    _parts(),
+    _dispatcher(nullptr),
+    _request(nullptr),
+    _taskId(0),
+    _condition(),
+    _next(0),
+    _running(0),
+    _sequentialRunning(false),
+    _workers(0),
+    _failed(false),
+    _errorMessage(),
+    _flushLock(),
+    _flushed(0),
+    _streamEnded(false) {
+}
+
+BatchExecution::~BatchExecution () {
+  for (auto& part : _parts) {
+    // parts that have not been started still own their request
+    delete part.request;
+  }
+
+  // the requests of the parts share the context of the batch request
+  delete _request;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a part, taking over the request
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::addPart (HttpRequest* request,
+                              std::string const& contentId,
+                              bool sequential) {
+  try {
+    _parts.emplace_back(request, contentId, sequential);
+  }
+  catch (...) {
+    delete request;
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs all parts and waits until they have finished
+////////////////////////////////////////////////////////////////////////////////
+
+bool BatchExecution::execute (Dispatcher* dispatcher) {
+  _dispatcher = dispatcher;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+    // the calling thread is a worker, too
+    ++_workers;
+  }
+
+  if (_dispatcher != nullptr) {
+    spawn();
+  }
+
+  while (true) {
+    int64_t const part = claim(true);
+
+    if (part < 0) {
+      break;
+    }
+
+    run(static_cast<size_t>(part));
+  }
+
+  CONDITION_LOCKER(guard, _condition);
+
+  // wait for the parts still running on the dispatcher
+  while (_running > 0) {
+    guard.wait();
+  }
+
+  --_workers;
+
+  return ! _failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of parts that returned an HTTP error
+////////////////////////////////////////////////////////////////////////////////
+
+size_t BatchExecution::errors () const {
+  size_t errors = 0;
+
+  for (auto const& part : _parts) {
+    if (part.code >= 400) {
+      ++errors;
+    }
+  }
+
+  return errors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the responses of the parts and the final boundary
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::appendResponse (StringBuffer& buffer) const {
+  for (auto const& part : _parts) {
+    buffer.appendText(part.response);
+  }
+
+  buffer.appendText(_boundary + "--");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs all parts on the dispatcher and streams the responses
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::stream (Dispatcher* dispatcher,
+                             HttpRequest* request,
+                             uint64_t taskId) {
+  TRI_ASSERT(dispatcher != nullptr);
+  TRI_ASSERT(taskId != 0);
+
+  _dispatcher = dispatcher;
+  _request = request;
+  _taskId = taskId;
+
+  spawn();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs parts until none can be started
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::work () {
+  while (true) {
+    int64_t const part = claim(false);
+
+    if (part < 0) {
+      // a thread that runs a part continues with the next ones
+      break;
+    }
+
+    run(static_cast<size_t>(part));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unregisters a job
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::leave () {
+  bool abandoned;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    TRI_ASSERT(_workers > 0);
+    --_workers;
+
+    // only possible if the dispatcher has dropped the jobs
+    abandoned = (_workers == 0 && _taskId != 0 && _flushed < _parts.size());
+    guard.broadcast();
+  }
+
+  if (abandoned) {
+    MUTEX_LOCKER(_flushLock);
+
+    if (! _streamEnded) {
+      std::string data;
+      endStream(data);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next part that may start
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t BatchExecution::claim (bool wait) {
+  CONDITION_LOCKER(guard, _condition);
+
+  while (! _failed && _next < _parts.size()) {
+    Part const& part = _parts[_next];
+
+    if (! _sequentialRunning && (! part.sequential || _running == 0)) {
+      ++_running;
+      _sequentialRunning = part.sequential;
+
+      return static_cast<int64_t>(_next++);
+    }
+
+    if (! wait) {
+      // the thread that runs the blocking part starts this one later
+      break;
+    }
+
+    guard.wait();
+  }
+
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a part and stores its response
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::run (size_t position) {
+  Part& part = _parts[position];
+  HttpRequest* request = part.request;
+  int32_t const compatibility = request->compatibility();
+
+  // the handler takes over the request
+  part.request = nullptr;
+  std::unique_ptr<HttpHandler> handler(_factory->createHandler(request));
+
+  if (handler == nullptr) {
+    delete request;
+    finish(position, "could not create handler for batch part processing");
+    return;
+  }
+
+  HttpHandler::status_t status(HttpHandler::HANDLER_FAILED);
+
+  do {
+    handler->prepareExecute();
+    try {
+      status = handler->execute();
+    }
+    catch (triagens::basics::Exception const& ex) {
+      handler->handleError(ex);
+    }
+    catch (std::exception const& ex) {
+      triagens::basics::Exception err(TRI_ERROR_INTERNAL, ex.what(), __FILE__, __LINE__);
+      handler->handleError(err);
+    }
+    catch (...) {
+      triagens::basics::Exception err(TRI_ERROR_INTERNAL, __FILE__, __LINE__);
+      handler->handleError(err);
+    }
+    handler->finalizeExecute();
+  }
+  while (status.status == HttpHandler::HANDLER_REQUEUE);
+
+  char const* error = nullptr;
+  HttpResponse* response = handler->getResponse();
+  std::unique_ptr<HttpResponse> errorResponse;
+
+  if (status.status == HttpHandler::HANDLER_FAILED) {
+    error = "executing a handler for batch part failed";
+  }
+  else if (response == nullptr) {
+    error = "could not create a response for batch part request";
+  }
+
+  if (error != nullptr && (_taskId != 0 || response == nullptr)) {
+    // a streamed batch cannot fail as a whole anymore, so the client gets
+    // the error as the response of the part
+    errorResponse.reset(new HttpResponse(HttpResponse::SERVER_ERROR, compatibility));
+
+    triagens::basics::Json json(triagens::basics::Json::Object, 4);
+    json("error", triagens::basics::Json(true));
+    json("code", triagens::basics::Json(static_cast<double>(HttpResponse::SERVER_ERROR)));
+    json("errorNum", triagens::basics::Json(static_cast<double>(TRI_ERROR_INTERNAL)));
+    json("errorMessage", triagens::basics::Json(error));
+
+    errorResponse->setContentType("application/json; charset=utf-8");
+    errorResponse->body().appendText(json.toString());
+    response = errorResponse.get();
+  }
+
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+
+  // append the boundary for this subpart
+  buffer.appendText(_boundary + "\r\nContent-Type: ");
+  buffer.appendText(triagens::rest::HttpRequest::BatchContentType);
+
+  if (! part.contentId.empty()) {
+    // append content-id
+    buffer.appendText("\r\nContent-Id: " + part.contentId);
+  }
+
+  buffer.appendText(TRI_CHAR_LENGTH_PAIR("\r\n\r\n"));
+
+  // remove some headers we don't need
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("connection"), "");
+  response->setHeader(TRI_CHAR_LENGTH_PAIR("server"), "");
+
+  // append the part response header
+  response->writeHeader(&buffer);
+  // append the part response body
+  buffer.appendText(response->body());
+  buffer.appendText(TRI_CHAR_LENGTH_PAIR("\r\n"));
+
+  part.code = static_cast<int>(response->responseCode());
+  part.response.assign(buffer.c_str(), buffer.length());
+
+  // the handler may use the shared request context until here
+  handler.reset();
+
+  finish(position, error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marks a part as finished
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::finish (size_t position, char const* error) {
+  bool sequential;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    Part& part = _parts[position];
+    part.done = true;
+    sequential = part.sequential;
+
+    TRI_ASSERT(_running > 0);
+    --_running;
+
+    if (sequential) {
+      _sequentialRunning = false;
+    }
+
+    if (error != nullptr && ! _failed) {
+      _failed = true;
+      _errorMessage = error;
+    }
+
+    guard.broadcast();
+  }
+
+  if (_taskId != 0) {
+    flush();
+  }
+
+  if (sequential) {
+    // the jobs have left while the part was running
+    spawn();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts jobs until parallelism threads work on the batch
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::spawn () {
+  if (_dispatcher == nullptr) {
+    return;
+  }
+
+  size_t count = 0;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    if (_failed || _next >= _parts.size()) {
+      return;
+    }
+
+    if (_workers < _parallelism) {
+      count = (std::min)(_parallelism - _workers, _parts.size() - _next);
+      _workers += count;
+    }
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    // the job unregisters itself when it is destroyed
+    std::unique_ptr<BatchPartJob> job;
+
+    int res = TRI_ERROR_NO_ERROR;
+
+    try {
+      job.reset(new BatchPartJob(shared_from_this()));
+      res = _dispatcher->addJob(job.get());
+    }
+    catch (...) {
+      res = TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      job.release();
+      continue;
+    }
+
+    // the remaining parts are run by the current workers
+    {
+      CONDITION_LOCKER(guard, _condition);
+      _workers -= count - i - 1;
+    }
+
+    if (job != nullptr) {
+      job.reset();
+    }
+    else {
+      leave();
+    }
+
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends the responses of the finished parts in order
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::flush () {
+  MUTEX_LOCKER(_flushLock);
+
+  if (_streamEnded) {
+    return;
+  }
+
+  std::string data;
+  bool complete;
+
+  {
+    CONDITION_LOCKER(guard, _condition);
+
+    while (_flushed < _parts.size() && _parts[_flushed].done) {
+      data.append(_parts[_flushed].response);
+      _parts[_flushed].response.clear();
+      ++_flushed;
+    }
+
+    // after a failure, no further parts are started
+    complete = (_flushed == _parts.size() ||
+                (_failed && _flushed == _next && _running == 0));
+  }
+
+  if (complete) {
+    endStream(data);
+    return;
+  }
+
+  if (! data.empty() && HttpServer::sendChunk(_taskId, data) != TRI_ERROR_NO_ERROR) {
+    // the client has gone away, do not start any further parts
+    _streamEnded = true;
+
+    CONDITION_LOCKER(guard, _condition);
+
+    if (! _failed) {
+      _failed = true;
+      _errorMessage = "client has gone away";
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ends the chunked response
+///
+/// @note the caller must hold _flushLock
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchExecution::endStream (std::string& data) {
+  _streamEnded = true;
+
+  try {
+    data.append(_boundary + "--");
+
+    if (HttpServer::sendChunk(_taskId, data) == TRI_ERROR_NO_ERROR) {
+      // an empty chunk ends the response
+      HttpServer::sendChunk(_taskId, "");
+    }
+  }
+  catch (...) {
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class BatchPartJob
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+BatchPartJob::BatchPartJob (std::shared_ptr<BatchExecution> execution)
+  : Job("BatchPartJob"),
+    _execution(execution) {
+}
+
+BatchPartJob::~BatchPartJob () {
+  _execution->leave();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+size_t BatchPartJob::queue () const {
+  return Dispatcher::STANDARD_QUEUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+Job::status_t BatchPartJob::work () {
+  _execution->work();
+
+  return status_t(Job::JOB_DONE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchPartJob::cleanup (DispatcherQueue* queue) {
+  queue->removeJob(this);
+  delete this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void BatchPartJob::handleError (basics::Exception const& ex) {
+  LOG_WARNING("executing batch parts failed: %s", ex.what());
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,373 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execution of the parts of a batch request
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_UTILS_BATCH_EXECUTION_H
+#define ARANGODB_UTILS_BATCH_EXECUTION_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/Mutex.h"
+#include "Dispatcher/Job.h"
+
+namespace triagens {
+  namespace basics {
+    class StringBuffer;
+  }
+
+  namespace rest {
+    class Dispatcher;
+    class HttpHandlerFactory;
+    class HttpRequest;
+  }
+
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class BatchExecution
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes the parts of a batch request, up to parallelism at once
+///
+/// the parts are started in the order of the request. a sequential part
+/// starts only after all parts before it have finished, and the parts after
+/// it start only after it has finished. the parts are run by the calling
+/// thread and by jobs on the dispatcher. a job leaves when no part can be
+/// started, so a batch never holds a dispatcher thread that only waits.
+///
+/// the responses of the parts are either collected and written by the
+/// caller, or sent as chunks to the comm task of the request as soon as all
+/// parts before them have finished
+////////////////////////////////////////////////////////////////////////////////
+
+    class BatchExecution : public std::enable_shared_from_this<BatchExecution> {
+      private:
+        BatchExecution (BatchExecution const&) = delete;
+        BatchExecution& operator= (BatchExecution const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+        struct Part {
+          Part (rest::HttpRequest* request,
+                std::string const& contentId,
+                bool sequential)
+            : request(request),
+              contentId(contentId),
+              sequential(sequential),
+              done(false),
+              code(0),
+              response() {
+          }
+
+          rest::HttpRequest* request;
+          std::string const contentId;
+          bool const sequential;
+          bool done;
+          int code;
+          std::string response;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        BatchExecution (rest::HttpHandlerFactory*,
+                        std::string const& boundary,
+                        size_t parallelism);
+
+        ~BatchExecution ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a part, taking over the request
+////////////////////////////////////////////////////////////////////////////////
+
+        void addPart (rest::HttpRequest*,
+                      std::string const& contentId,
+                      bool sequential);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs all parts and waits until they have finished
+///
+/// returns false if a part could not be executed, and does not start any
+/// further parts then. the dispatcher may be a nullptr, all parts are run
+/// by the calling thread then
+////////////////////////////////////////////////////////////////////////////////
+
+        bool execute (rest::Dispatcher*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the reason why execute failed
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string const& errorMessage () const {
+          return _errorMessage;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of parts that returned an HTTP error
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t errors () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the responses of the parts and the final boundary
+////////////////////////////////////////////////////////////////////////////////
+
+        void appendResponse (basics::StringBuffer&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs all parts on the dispatcher, and sends their responses as
+/// chunks to the comm task. the execution takes over the batch request,
+/// whose context the parts share
+////////////////////////////////////////////////////////////////////////////////
+
+        void stream (rest::Dispatcher*,
+                     rest::HttpRequest*,
+                     uint64_t taskId);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs parts until none can be started, called by the jobs
+////////////////////////////////////////////////////////////////////////////////
+
+        void work ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unregisters a job, called when it is destroyed
+////////////////////////////////////////////////////////////////////////////////
+
+        void leave ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next part that may start, or -1 if there is none. if
+/// wait is true, this waits until a blocked part may start
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t claim (bool wait);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief executes a part and stores its response
+////////////////////////////////////////////////////////////////////////////////
+
+        void run (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marks a part as finished
+////////////////////////////////////////////////////////////////////////////////
+
+        void finish (size_t, char const* error);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts jobs until parallelism threads work on the batch
+////////////////////////////////////////////////////////////////////////////////
+
+        void spawn ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends the responses of the finished parts in order
+////////////////////////////////////////////////////////////////////////////////
+
+        void flush ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ends the chunked response
+////////////////////////////////////////////////////////////////////////////////
+
+        void endStream (std::string&);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        rest::HttpHandlerFactory* _factory;
+
+        std::string const _boundary;
+
+        size_t const _parallelism;
+
+        std::vector<Part> _parts;
+
+        rest::Dispatcher* _dispatcher;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the batch request while streaming, owned by the execution
+////////////////////////////////////////////////////////////////////////////////
+
+        rest::HttpRequest* _request;
+
+        uint64_t _taskId;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the scheduling state below, signaled when a part finishes
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::ConditionVariable _condition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the next part to start
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _next;
+
+        size_t _running;
+
+        bool _sequentialRunning;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of threads working on the batch, including queued jobs
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _workers;
+
+        bool _failed;
+
+        std::string _errorMessage;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes the sending of chunks
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _flushLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of parts sent, protected by _condition
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _flushed;
+
+        bool _streamEnded;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class BatchPartJob
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a dispatcher job working on the parts of a batch
+////////////////////////////////////////////////////////////////////////////////
+
+    class BatchPartJob : public rest::Job {
+      private:
+        BatchPartJob (BatchPartJob const&) = delete;
+        BatchPartJob& operator= (BatchPartJob const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        explicit BatchPartJob (std::shared_ptr<BatchExecution>);
+
+        ~BatchPartJob ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t queue () const override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        priority_e priority () const override {
+          // the batch itself has been admitted already
+          return PRIORITY_NORMAL;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        Job::status_t work () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool cancel () override {
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void cleanup (rest::DispatcherQueue*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleError (basics::Exception const&) override;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        std::shared_ptr<BatchExecution> _execution;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -32,13 +32,22 @@
 #include "Indexes/PrimaryIndex.h"
 #include "Utils/CollectionGuard.h"
 #include "Utils/CollectionReadLocker.h"
+#include "Utils/DocumentHelper.h"
 #include "Utils/transactions.h"
 #include "VocBase/compactor.h"
 #include "VocBase/Ditch.h"
+#include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
+#include "VocBase/VocShaper.h"
 
 using namespace triagens::arango;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents copied per read lock of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const ScanChunkSize = 10000;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                            class CollectionExport
 // -----------------------------------------------------------------------------
@@ -80,7 +89,15 @@ CollectionExport::~CollectionExport () {
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
-void CollectionExport::run (uint64_t maxWaitTime, size_t limit) {
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the ditch that keeps the datafiles of the collection, and
+/// waits at most maxWaitTime microseconds for the collector to move the
+/// documents out of the write-ahead log
+////////////////////////////////////////////////////////////////////////////////
+
+void CollectionExport::prepare (uint64_t maxWaitTime) {
+  TRI_ASSERT(_ditch == nullptr);
+
   // try to acquire the exclusive lock on the compaction
   while (! TRI_CheckAndLockCompactorVocBase(_document->_vocbase)) {
     // didn't get it. try again...
@@ -98,23 +115,29 @@ void CollectionExport::run (uint64_t maxWaitTime, size_t limit) {
     THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
   }
 
+  static const uint64_t SleepTime = 10000;
 
-  TRI_ASSERT(_documents == nullptr);
-  _documents = new std::vector<void const*>();
- 
-  { 
-    static const uint64_t SleepTime = 10000;
+  uint64_t tries = 0;
+  uint64_t const maxTries = maxWaitTime / SleepTime;
 
-    uint64_t tries = 0;
-    uint64_t const maxTries = maxWaitTime / SleepTime;
-
-    while (++tries < maxTries) {
-      if (TRI_IsFullyCollectedDocumentCollection(_document)) {
-        break;
-      }
-      usleep(SleepTime);
+  while (++tries < maxTries) {
+    if (TRI_IsFullyCollectedDocumentCollection(_document)) {
+      break;
     }
+    usleep(SleepTime);
   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copies the pointers to at most limit documents that are in
+/// datafiles, all if limit is 0
+////////////////////////////////////////////////////////////////////////////////
+
+void CollectionExport::run (uint64_t maxWaitTime, size_t limit) {
+  prepare(maxWaitTime);
+
+  TRI_ASSERT(_documents == nullptr);
+  _documents = new std::vector<void const*>();
 
   {
     SingleCollectionReadOnlyTransaction trx(new StandaloneTransactionContext(), _document->_vocbase, _name);
@@ -135,21 +158,20 @@ void CollectionExport::run (uint64_t maxWaitTime, size_t limit) {
     _documents->reserve(maxDocuments);
 
     if (maxDocuments > 0) { 
-      triagens::basics::BucketPosition position;
-      uint64_t total = 0;
-      while (limit > 0) {
-        auto ptr = idx->lookupSequential(position, total);
-
-        if (ptr == nullptr) {
-          break;
-        }
-
-        void const* marker = ptr->getDataPtr();
+      // copy the markers in chunks, so writers are not blocked for long
+      res = TRI_ChunkedDocumentIteratorDocumentCollection(trx.trxCollection(), ScanChunkSize, [&] (TRI_doc_mptr_t const* mptr) -> bool {
+        void const* marker = mptr->getDataPtr();
 
         if (! TRI_IsWalDataMarkerDatafile(marker)) {
           _documents->emplace_back(marker);
           --limit;
         }
+
+        return (limit > 0);
+      });
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
       }
     }
 
@@ -157,6 +179,109 @@ void CollectionExport::run (uint64_t maxWaitTime, size_t limit) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON of an exported document to the buffer, applying
+/// the restrictions
+////////////////////////////////////////////////////////////////////////////////
+
+void CollectionExport::dumpDocument (TRI_df_marker_t const* marker,
+                                     triagens::basics::StringBuffer& buffer) const {
+  auto shaper = _document->getShaper();
+  auto const restrictionType = _restrictions.type;
+
+  if (restrictionType == Restrictions::RESTRICTION_NONE) {
+    // no restrictions: print the document directly from the shaped data
+    if (! DocumentHelper::stringifyDocument(&_resolver, _document->_info._cid, marker, shaper, buffer.stringBuffer())) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
+    return;
+  }
+
+  TRI_shaped_json_t shaped;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+  triagens::basics::Json json(shaper->memoryZone(), TRI_JsonShapedJson(shaper, &shaped));
+
+  // append the internal attributes
+
+  // _id, _key, _rev
+  char const* key = TRI_EXTRACT_MARKER_KEY(marker);
+  std::string id(_resolver.getCollectionName(_document->_info._cid));
+  id.push_back('/');
+  id.append(key);
+
+  json(TRI_VOC_ATTRIBUTE_ID, triagens::basics::Json(id));
+  json(TRI_VOC_ATTRIBUTE_REV, triagens::basics::Json(std::to_string(TRI_EXTRACT_MARKER_RID(marker))));
+  json(TRI_VOC_ATTRIBUTE_KEY, triagens::basics::Json(key));
+
+  if (TRI_IS_EDGE_MARKER(marker)) {
+    // _from
+    std::string from(_resolver.getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)));
+    from.push_back('/');
+    from.append(TRI_EXTRACT_MARKER_FROM_KEY(marker));
+    json(TRI_VOC_ATTRIBUTE_FROM, triagens::basics::Json(from));
+      
+    // _to
+    std::string to(_resolver.getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)));
+    to.push_back('/');
+    to.append(TRI_EXTRACT_MARKER_TO_KEY(marker));
+    json(TRI_VOC_ATTRIBUTE_TO, triagens::basics::Json(to));
+  }
+
+  TRI_ASSERT(restrictionType == Restrictions::RESTRICTION_INCLUDE ||
+             restrictionType == Restrictions::RESTRICTION_EXCLUDE);
+
+  // only include the specified fields
+  // for this we'll modify the JSON that we already have, in place
+  // we'll scan through the JSON attributs from left to right and
+  // keep all those that we want to keep. we'll overwrite existing
+  // other values in the JSON 
+  TRI_json_t* obj = json.json();
+  TRI_ASSERT(TRI_IsObjectJson(obj));
+
+  size_t const n = TRI_LengthVector(&obj->_value._objects);
+
+  size_t j = 0;
+  for (size_t i = 0; i < n; i += 2) {
+    auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&obj->_value._objects, i));
+
+    if (! TRI_IsStringJson(key)) {
+      continue;
+    }
+
+    bool const keyContainedInRestrictions = (_restrictions.fields.find(key->_value._string.data) != _restrictions.fields.end());
+
+    if ((restrictionType == Restrictions::RESTRICTION_INCLUDE && keyContainedInRestrictions) ||
+        (restrictionType == Restrictions::RESTRICTION_EXCLUDE && ! keyContainedInRestrictions)) {
+      // include the field
+      if (i != j) {
+        // steal the key and the value
+        void* src = TRI_AddressVector(&obj->_value._objects, i);
+        void* dst = TRI_AddressVector(&obj->_value._objects, j);
+        memcpy(dst, src, 2 * sizeof(TRI_json_t));
+      }
+      j += 2;
+    }
+    else {
+      // do not include the field
+      // key
+      auto src = static_cast<TRI_json_t*>(TRI_AddressVector(&obj->_value._objects, i));
+      TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, src);
+      // value
+      TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, src + 1);
+    }
+  }
+
+  // finally adjust the length of the patched JSON so the NULL fields at
+  // the end will not be dumped
+  TRI_SetLengthVector(&obj->_value._objects, j); 
+      
+  int res = TRI_StringifyJson(buffer.stringBuffer(), json.json());
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -31,9 +31,11 @@
 #define ARANGODB_ARANGO_COLLECTION_EXPORT_H 1
 
 #include "Basics/Common.h"
+#include "Basics/StringBuffer.h"
 #include "Utils/CollectionNameResolver.h"
 #include "VocBase/voc-types.h"
 
+struct TRI_df_marker_s;
 struct TRI_document_collection_t;
 struct TRI_vocbase_t;
 
@@ -86,8 +88,37 @@ namespace triagens {
 
       public:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the ditch and waits for the collector
+////////////////////////////////////////////////////////////////////////////////
+
+        void prepare (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepares the export and copies the document pointers
+////////////////////////////////////////////////////////////////////////////////
+
         void run (uint64_t, size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON of an exported document to the buffer
+////////////////////////////////////////////////////////////////////////////////
+
+        void dumpDocument (struct TRI_df_marker_s const*,
+                           triagens::basics::StringBuffer&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the exported collection
+////////////////////////////////////////////////////////////////////////////////
+
+        struct TRI_document_collection_t* document () const {
+          return _document;
+        }
+
+        std::string const& name () const {
+          return _name;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -140,6 +140,14 @@ namespace triagens {
                        size_t,
                        size_t,
                        TRI_json_t const*) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a document marker into JSON, with _key, _rev, _from and _to
+////////////////////////////////////////////////////////////////////////////////
+
+        static TRI_json_t* documentToJson (struct TRI_document_collection_t*,
+                                           CollectionNameResolver const&,
+                                           TRI_df_marker_t const*);
         
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
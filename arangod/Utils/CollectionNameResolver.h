@@ -162,12 +162,9 @@ namespace triagens {
 
             if (nullptr != found) {
               if (found->_planId == 0) {
-                // DBserver local case
-                char* n = TRI_GetCollectionNameByIdVocBase(_vocbase, cid);
-                if (n != nullptr) {
-                  name = n;
-                  TRI_Free(TRI_UNKNOWN_MEM_ZONE, n);
-                }
+                // DBserver local case. the lock is already held, so the
+                // name is read directly
+                name = found->_name;
               }
               else {
                 // DBserver case of a shard:
@@ -28,8 +28,13 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Utils/Cursor.h"
+#include "Aql/AqlItemBlock.h"
+#include "Aql/ExecutionBlock.h"
+#include "Aql/ExecutionEngine.h"
+#include "Aql/Query.h"
 #include "Basics/JsonHelper.h"
 #include "Utils/CollectionExport.h"
+#include "Utils/DocumentHelper.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
@@ -58,14 +63,18 @@ Cursor::Cursor (CursorId id,
     _expires(TRI_microtime() + _ttl),
     _hasCount(hasCount),
     _isDeleted(false),
-    _isUsed(false) {
+    _isUsed(false),
+    _expiryTimer(this) {
 
+  TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, 0, 1);
 }
         
 Cursor::~Cursor () {
   if (_extra != nullptr) {
     TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _extra);
   }
+
+  TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, 0, -1);
 }
 
 // -----------------------------------------------------------------------------
@@ -88,8 +97,10 @@ JsonCursor::JsonCursor (TRI_vocbase_t* vocbase,
     _vocbase(vocbase),
     _json(json),
     _size(TRI_LengthArrayJson(_json)),
-    _cached(cached) {
+    _cached(cached),
+    _memoryUsage(TRI_MemoryUsageJson(_json)) {
 
+  TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, (int64_t) _memoryUsage, 0);
   TRI_UseVocBase(vocbase);
 }
         
@@ -220,6 +231,8 @@ void JsonCursor::freeJson () {
   if (_json != nullptr) {
     TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, _json);
     _json = nullptr;
+
+    TRI_AddMemoryZoneUsage(TRI_CURSORS_MEM_ZONE, - (int64_t) _memoryUsage, 0);
   }
 
   _isDeleted = true;
@@ -292,9 +305,6 @@ size_t ExportCursor::count () const {
 void ExportCursor::dump (triagens::basics::StringBuffer& buffer) {
   TRI_ASSERT(_ex != nullptr);
 
-  auto shaper = _ex->_document->getShaper();
-  auto const restrictionType = _ex->_restrictions.type;
-
   buffer.appendText("\"result\":[");
 
   size_t const n = batchSize();
@@ -310,119 +320,285 @@ void ExportCursor::dump (triagens::basics::StringBuffer& buffer) {
     
     auto marker = static_cast<TRI_df_marker_t const*>(_ex->_documents->at(_position++));
 
-    TRI_shaped_json_t shaped;
-    TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
-    triagens::basics::Json json(shaper->memoryZone(), TRI_JsonShapedJson(shaper, &shaped));
+    _ex->dumpDocument(marker, buffer);
+  }
 
-    // append the internal attributes
+  buffer.appendText("],\"hasMore\":");
+  buffer.appendText(hasNext() ? "true" : "false");
 
-    // _id, _key, _rev
-    char const* key = TRI_EXTRACT_MARKER_KEY(marker);
-    std::string id(_ex->_resolver.getCollectionName(_ex->_document->_info._cid));
-    id.push_back('/');
-    id.append(key);
+  if (hasNext()) {
+    // only return cursor id if there are more documents
+    buffer.appendText(",\"id\":\"");
+    buffer.appendInteger(id());
+    buffer.appendText("\"");
+  }
 
-    json(TRI_VOC_ATTRIBUTE_ID, triagens::basics::Json(id));
-    json(TRI_VOC_ATTRIBUTE_REV, triagens::basics::Json(std::to_string(TRI_EXTRACT_MARKER_RID(marker))));
-    json(TRI_VOC_ATTRIBUTE_KEY, triagens::basics::Json(key));
+  if (hasCount()) {
+    buffer.appendText(",\"count\":");
+    buffer.appendInteger(static_cast<uint64_t>(count()));
+  }
 
-    if (TRI_IS_EDGE_MARKER(marker)) {
-      // _from
-      std::string from(_ex->_resolver.getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)));
-      from.push_back('/');
-      from.append(TRI_EXTRACT_MARKER_FROM_KEY(marker));
-      json(TRI_VOC_ATTRIBUTE_FROM, triagens::basics::Json(from));
+  if (! hasNext()) {
+    delete _ex;
+    _ex = nullptr;
+
+    // mark the cursor as deleted
+    this->deleted();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class QueryCursor
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+QueryCursor::QueryCursor (TRI_vocbase_t* vocbase,
+                          CursorId id,
+                          triagens::aql::Query* query,
+                          std::string* queryString,
+                          size_t batchSize,
+                          double ttl)
+  : Cursor(id, batchSize, nullptr, ttl, false),
+    _vocbase(vocbase),
+    _query(query),
+    _queryString(queryString),
+    _block(nullptr),
+    _blockPosition(0),
+    _suspended(false) {
+
+  TRI_ASSERT(_query != nullptr);
+  TRI_ASSERT(_query->engine() != nullptr);
+
+  TRI_UseVocBase(vocbase);
+}
         
-      // _to
-      std::string to(_ex->_resolver.getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)));
-      to.push_back('/');
-      to.append(TRI_EXTRACT_MARKER_TO_KEY(marker));
-      json(TRI_VOC_ATTRIBUTE_TO, triagens::basics::Json(to));
-    }
+QueryCursor::~QueryCursor () {
+  freeQuery();
 
-    if (restrictionType == CollectionExport::Restrictions::RESTRICTION_INCLUDE ||
-        restrictionType == CollectionExport::Restrictions::RESTRICTION_EXCLUDE) {
-      // only include the specified fields
-      // for this we'll modify the JSON that we already have, in place
-      // we'll scan through the JSON attributs from left to right and
-      // keep all those that we want to keep. we'll overwrite existing
-      // other values in the JSON 
-      TRI_json_t* obj = json.json();
-      TRI_ASSERT(TRI_IsObjectJson(obj));
+  TRI_ReleaseVocBase(_vocbase);
+}
 
-      size_t const n = TRI_LengthVector(&obj->_value._objects);
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief check whether the cursor contains more data
+/// this will fetch the next block of results from the query if required
+////////////////////////////////////////////////////////////////////////////////
 
-      size_t j = 0;
-      for (size_t i = 0; i < n; i += 2) {
-        auto key = static_cast<TRI_json_t const*>(TRI_AtVector(&obj->_value._objects, i));
+bool QueryCursor::hasNext () {
+  while (_query != nullptr) {
+    auto engine = _query->engine();
 
-        if (! TRI_IsStringJson(key)) {
-          continue;
-        }
+    if (_block != nullptr) {
+      auto const resultRegister = engine->resultRegister();
 
-        bool const keyContainedInRestrictions = (_ex->_restrictions.fields.find(key->_value._string.data) != _ex->_restrictions.fields.end());
-
-        if ((restrictionType == CollectionExport::Restrictions::RESTRICTION_INCLUDE && keyContainedInRestrictions) ||
-            (restrictionType == CollectionExport::Restrictions::RESTRICTION_EXCLUDE && ! keyContainedInRestrictions)) {
-          // include the field
-          if (i != j) {
-            // steal the key and the value
-            void* src = TRI_AddressVector(&obj->_value._objects, i);
-            void* dst = TRI_AddressVector(&obj->_value._objects, j);
-            memcpy(dst, src, 2 * sizeof(TRI_json_t));
-          }
-          j += 2;
-        }
-        else {
-          // do not include the field
-          // key
-          auto src = static_cast<TRI_json_t*>(TRI_AddressVector(&obj->_value._objects, i));
-          TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, src);
-          // value
-          TRI_DestroyJson(TRI_UNKNOWN_MEM_ZONE, src + 1);
+      while (_blockPosition < _block->size()) {
+        if (! _block->getValueReference(_blockPosition, resultRegister).isEmpty()) {
+          return true;
         }
+        ++_blockPosition;
       }
 
-      // finally adjust the length of the patched JSON so the NULL fields at
-      // the end will not be dumped
-      TRI_SetLengthVector(&obj->_value._objects, j); 
+      delete _block;
+      _block = nullptr;
+      _blockPosition = 0;
     }
-    else {
-      // no restrictions
-      TRI_ASSERT(restrictionType == CollectionExport::Restrictions::RESTRICTION_NONE);
+
+    _block = engine->getSome(1, triagens::aql::ExecutionBlock::DefaultBatchSize);
+
+    if (_block == nullptr) {
+      // query is exhausted
+      finish();
     }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the next element (not implemented)
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* QueryCursor::next () {
+  // should not be called directly
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the cursor size (unknown for streaming cursors)
+////////////////////////////////////////////////////////////////////////////////
+
+size_t QueryCursor::count () const {
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dump the next batch of results into a string buffer
+////////////////////////////////////////////////////////////////////////////////
         
-    int res = TRI_StringifyJson(buffer.stringBuffer(), json.json());
+void QueryCursor::dump (triagens::basics::StringBuffer& buffer) {
+  resume();
 
-    if (res != TRI_ERROR_NO_ERROR) {
-      THROW_ARANGO_EXCEPTION(res);
+  try {
+    buffer.appendText("\"result\":[");
+
+    size_t const n = batchSize();
+
+    for (size_t i = 0; i < n; ++i) {
+      if (! hasNext()) {
+        break;
+      }
+
+      if (i > 0) {
+        buffer.appendChar(',');
+      }
+
+      auto const resultRegister = _query->engine()->resultRegister();
+      auto doc = _block->getDocumentCollection(resultRegister);
+      auto const& value = _block->getValueReference(_blockPosition++, resultRegister);
+
+      triagens::basics::Json json = value.toJson(_query->trx(), doc, false);
+
+      int res = TRI_StringifyJson(buffer.stringBuffer(), json.json());
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
+    }
+
+    bool const more = hasNext();
+
+    buffer.appendText("],\"hasMore\":");
+    buffer.appendText(more ? "true" : "false");
+
+    if (more) {
+      // only return cursor id if there are more documents
+      buffer.appendText(",\"id\":\"");
+      buffer.appendInteger(id());
+      buffer.appendText("\"");
+    }
+
+    TRI_json_t const* extraJson = extra();
+
+    if (TRI_IsObjectJson(extraJson)) {
+      // only present in the last batch
+      buffer.appendText(",\"extra\":");
+      TRI_StringifyJson(buffer.stringBuffer(), extraJson);
+    }
+
+    buffer.appendText(",\"cached\":false");
+
+    if (more) {
+      suspend();
+    }
+    else {
+      // mark the cursor as deleted
+      this->deleted();
     }
   }
+  catch (...) {
+    // the query cannot be continued after an error
+    freeQuery();
+    this->deleted();
+    throw;
+  }
+}
 
-  buffer.appendText("],\"hasMore\":");
-  buffer.appendText(hasNext() ? "true" : "false");
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
 
-  if (hasNext()) {
-    // only return cursor id if there are more documents
-    buffer.appendText(",\"id\":\"");
-    buffer.appendInteger(id());
-    buffer.appendText("\"");
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finalize the exhausted query and keep its statistics and warnings
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCursor::finish () {
+  TRI_ASSERT(_query != nullptr);
+
+  auto queryResult = _query->finalize();
+
+  if (queryResult.code != TRI_ERROR_NO_ERROR) {
+    freeQuery();
+    THROW_ARANGO_EXCEPTION_MESSAGE(queryResult.code, queryResult.details);
   }
 
-  if (hasCount()) {
-    buffer.appendText(",\"count\":");
-    buffer.appendInteger(static_cast<uint64_t>(count()));
+  triagens::basics::Json extra(triagens::basics::Json::Object, 3); 
+
+  if (queryResult.stats != nullptr) {
+    extra.set("stats", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, queryResult.stats, triagens::basics::Json::AUTOFREE));
+    queryResult.stats = nullptr;
+  }
+  if (queryResult.profile != nullptr) {
+    extra.set("profile", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, queryResult.profile, triagens::basics::Json::AUTOFREE));
+    queryResult.profile = nullptr;
+  }
+  if (queryResult.warnings == nullptr) {
+    extra.set("warnings", triagens::basics::Json(triagens::basics::Json::Array));
+  }
+  else {
+    extra.set("warnings", triagens::basics::Json(TRI_UNKNOWN_MEM_ZONE, queryResult.warnings, triagens::basics::Json::AUTOFREE));
+    queryResult.warnings = nullptr;
   }
 
-  if (! hasNext()) {
-    delete _ex;
-    _ex = nullptr;
+  TRI_ASSERT(_extra == nullptr);
+  _extra = extra.steal();
 
-    // mark the cursor as deleted
-    this->deleted();
+  freeQuery();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief suspend the query after a batch. the next batch may be requested
+/// from a different thread, so the query must neither keep its V8 context
+/// nor count its transaction as being in scope of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCursor::suspend () {
+  TRI_ASSERT(_query != nullptr);
+  TRI_ASSERT(! _suspended);
+
+  _query->exitContext();
+  triagens::arango::TransactionBase::increaseNumbers(-1, -1);
+  _suspended = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resume a suspended query in the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCursor::resume () {
+  if (_suspended) {
+    triagens::arango::TransactionBase::increaseNumbers(1, 1);
+    _suspended = false;
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free the query. if the query was not finished yet, its transaction
+/// is aborted
+////////////////////////////////////////////////////////////////////////////////
+
+void QueryCursor::freeQuery () {
+  delete _block;
+  _block = nullptr;
+  _blockPosition = 0;
+
+  if (_query != nullptr) {
+    resume();
+
+    delete _query;
+    _query = nullptr;
+  }
+
+  // the query string must outlive the query
+  delete _queryString;
+  _queryString = nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -32,12 +32,18 @@
 
 #include "Basics/Common.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/TimerWheel.h"
 #include "VocBase/voc-types.h"
 
 struct TRI_json_t;
 struct TRI_vocbase_t;
 
 namespace triagens {
+  namespace aql {
+    class AqlItemBlock;
+    class Query;
+  }
+
   namespace arango {
 
     class CollectionExport;
@@ -116,6 +122,15 @@ namespace triagens {
           TRI_ASSERT(_isUsed);
           _isUsed = false;
         }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the expiry timer of the cursor, used by the repository while the
+/// cursor is not in use
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::TimerWheel::Timer* expiryTimer () {
+          return &_expiryTimer;
+        }
         
         virtual bool hasNext () = 0;
 
@@ -140,6 +155,7 @@ namespace triagens {
         bool const            _hasCount;
         bool                  _isDeleted;
         bool                  _isUsed;
+        triagens::basics::TimerWheel::Timer _expiryTimer;
     };
 
 // -----------------------------------------------------------------------------
@@ -192,6 +208,7 @@ namespace triagens {
         struct TRI_json_t*    _json;
         size_t const          _size;
         bool                  _cached;
+        size_t                _memoryUsage;
     };
 
 // -----------------------------------------------------------------------------
@@ -235,6 +252,79 @@ namespace triagens {
         size_t const                        _size;
     };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class QueryCursor
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a cursor that streams the results of a prepared query
+///
+/// the query is kept alive between requests, and each dump() pulls only as
+/// many rows from the execution engine as fit into one batch. the query's
+/// transaction and its collection locks are held until the cursor is
+/// exhausted, deleted or expires. the total number of results is not known
+/// in advance, so the cursor cannot report a count. statistics and warnings
+/// are returned with the last batch
+////////////////////////////////////////////////////////////////////////////////
+    
+    class QueryCursor : public Cursor {
+      public:
+
+        QueryCursor (TRI_vocbase_t*,
+                     CursorId,
+                     triagens::aql::Query*,
+                     std::string*,
+                     size_t,
+                     double);
+
+        ~QueryCursor ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+      public:
+
+        triagens::aql::Query* query () const {
+          return _query;
+        }
+
+        bool hasNext () override final;
+
+        struct TRI_json_t* next () override final;
+        
+        size_t count () const override final;
+
+        void dump (triagens::basics::StringBuffer&) override final;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+      private:
+
+        void finish ();
+
+        void suspend ();
+
+        void resume ();
+
+        void freeQuery ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        TRI_vocbase_t*                      _vocbase;
+        triagens::aql::Query*               _query;
+        std::string*                        _queryString;
+        triagens::aql::AqlItemBlock*        _block;
+        size_t                              _blockPosition;
+        bool                                _suspended;
+    };
+
   }
 }
 
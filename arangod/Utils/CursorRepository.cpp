@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Utils/CursorRepository.h"
+#include "Aql/Query.h"
 #include "Basics/json.h"
 #include "Basics/logging.h"
 #include "Basics/MutexLocker.h"
@@ -54,7 +55,8 @@ size_t const CursorRepository::MaxCollectCount = 32;
 CursorRepository::CursorRepository (TRI_vocbase_t* vocbase) 
   : _vocbase(vocbase),
     _lock(),
-    _cursors() {
+    _cursors(),
+    _expiries(static_cast<uint64_t>(TRI_microtime())) {
 
   _cursors.reserve(64);
 }
@@ -92,6 +94,8 @@ CursorRepository::~CursorRepository () {
   {
     MUTEX_LOCKER(_lock);
 
+    _expiries.clear();
+
     for (auto it : _cursors) {
       delete it.second;
     }
@@ -172,6 +176,43 @@ ExportCursor* CursorRepository::createFromExport (triagens::arango::CollectionEx
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a streaming cursor for a prepared query and stores it in
+/// the registry
+////////////////////////////////////////////////////////////////////////////////
+
+QueryCursor* CursorRepository::createFromQuery (triagens::aql::Query* query,
+                                                std::string* queryString,
+                                                size_t batchSize,
+                                                double ttl) {
+  TRI_ASSERT(query != nullptr);
+  TRI_ASSERT(queryString != nullptr);
+
+  CursorId const id = TRI_NewTickServer();
+  triagens::arango::QueryCursor* cursor = nullptr;
+
+  try {
+    cursor = new triagens::arango::QueryCursor(_vocbase, id, query, queryString, batchSize, ttl);
+  }
+  catch (...) {
+    delete query;
+    delete queryString;
+    throw;
+  }
+
+  cursor->use();
+
+  try {
+    MUTEX_LOCKER(_lock);
+    _cursors.emplace(std::make_pair(id, cursor));
+    return cursor;
+  }
+  catch (...) {
+    delete cursor;
+    throw;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief remove a cursor by id
 ////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +243,7 @@ bool CursorRepository::remove (CursorId id) {
     }
 
     // cursor not in use by someone else
+    _expiries.remove(cursor->expiryTimer());
     _cursors.erase(it);
   }
 
@@ -243,6 +285,7 @@ Cursor* CursorRepository::find (CursorId id,
       return nullptr;
     }
 
+    _expiries.remove(cursor->expiryTimer());
     cursor->use();
   }
 
@@ -261,6 +304,7 @@ void CursorRepository::release (Cursor* cursor) {
     cursor->release();
 
     if (! cursor->isDeleted()) {
+      startExpiry(cursor);
       return;
     }
 
@@ -296,43 +340,51 @@ bool CursorRepository::garbageCollect (bool force) {
   std::vector<triagens::arango::Cursor*> found;
   found.reserve(MaxCollectCount);
 
-  auto const now = TRI_microtime();
-
   {
     MUTEX_LOCKER(_lock);
 
-    for (auto it = _cursors.begin(); it != _cursors.end(); /* no hoisting */) {
-      auto cursor = (*it).second;
+    if (force) {
+      for (auto it = _cursors.begin(); it != _cursors.end(); /* no hoisting */) {
+        auto cursor = (*it).second;
 
-      if (cursor->isUsed()) {
-        // must not destroy used cursors
-        ++it;
-        continue;
-      } 
-   
-      if (force || cursor->expires() < now) {
-        cursor->deleted();
-      }  
+        if (cursor->isUsed()) {
+          // must not destroy used cursors
+          ++it;
+          continue;
+        } 
 
-      if (cursor->isDeleted()) {
         try {
           found.emplace_back(cursor);
-          it = _cursors.erase(it);
         }
         catch (...) {
           // stop iteration
           break;
         }
 
-        if (! force &&
-            found.size() >= MaxCollectCount) {
-          break;
-        }
-      }
-      else {
-        ++it;
+        cursor->deleted();
+        _expiries.remove(cursor->expiryTimer());
+        it = _cursors.erase(it);
       }
     }
+    else {
+      // only unused cursors have an expiry timer. cursors beyond the
+      // maximum number are collected in the next run
+      auto const now = static_cast<uint64_t>(TRI_microtime());
+
+      _expiries.advance(now, [&] (triagens::basics::TimerWheel::Timer* timer) {
+        auto cursor = static_cast<triagens::arango::Cursor*>(timer->data());
+        TRI_ASSERT(! cursor->isUsed());
+
+        if (found.size() >= MaxCollectCount) {
+          _expiries.insert(timer, now + 1);
+          return;
+        }
+
+        found.emplace_back(cursor);
+        cursor->deleted();
+        _cursors.erase(cursor->id());
+      });
+    }
   }
 
   // remove cursors outside the lock
@@ -343,6 +395,20 @@ bool CursorRepository::garbageCollect (bool force) {
   return (! found.empty());
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the expiry timer of a cursor that is not in use anymore
+/// must be called with the lock held
+////////////////////////////////////////////////////////////////////////////////
+
+void CursorRepository::startExpiry (Cursor* cursor) {
+  // round up, so the cursor is not collected before it expires
+  _expiries.insert(cursor->expiryTimer(), static_cast<uint64_t>(std::ceil(cursor->expires())));
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
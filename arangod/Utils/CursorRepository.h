@@ -32,6 +32,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/Mutex.h"
+#include "Basics/TimerWheel.h"
 #include "Utils/Cursor.h"
 #include "VocBase/voc-types.h"
 
@@ -39,6 +40,10 @@ struct TRI_json_t;
 struct TRI_vocbase_t;
 
 namespace triagens {
+  namespace aql {
+    class Query;
+  }
+
   namespace arango {
 
     class CollectionExport;
@@ -96,6 +101,19 @@ namespace triagens {
                                         double, 
                                         bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a streaming cursor for a prepared query and stores it in
+/// the registry
+/// the cursor will be returned with the usage flag set to true. it must be
+/// returned later using release() 
+/// the cursor will take ownership of both the query and the query string
+////////////////////////////////////////////////////////////////////////////////
+
+        QueryCursor* createFromQuery (triagens::aql::Query*,
+                                      std::string*,
+                                      size_t,
+                                      double);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief remove a cursor by id
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,6 +147,18 @@ namespace triagens {
 
         bool garbageCollect (bool);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the expiry timer of a cursor that is not in use anymore
+////////////////////////////////////////////////////////////////////////////////
+
+        void startExpiry (Cursor*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -153,6 +183,13 @@ namespace triagens {
 
         std::unordered_map<CursorId, Cursor*> _cursors;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief expiry timers of the unused cursors, with a tick of one second, so
+/// the garbage collection does not need to look at all cursors
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::TimerWheel _expiries;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum number of cursors to garbage-collect in one go
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,457 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache for serialized documents
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/DocumentCache.h"
+#include "Basics/ConditionLocker.h"
+#include "Basics/Exceptions.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief singleton instance of the document cache
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::DocumentCache Instance;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the cache
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache::DocumentCache ()
+  : _maxEntries(0),
+    _maxSize(0) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the cache
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache::~DocumentCache () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the cache is active
+////////////////////////////////////////////////////////////////////////////////
+
+bool DocumentCache::isActive () const {
+  return (_maxEntries.load(std::memory_order_relaxed) > 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum number of cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+size_t DocumentCache::maxEntries () const {
+  return _maxEntries.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum number of cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::setMaxEntries (size_t value) {
+  _maxEntries = value;
+
+  size_t const perBucket = (value + NumBuckets - 1) / NumBuckets;
+  size_t const sizePerBucket = (_maxSize.load() + NumBuckets - 1) / NumBuckets;
+
+  for (size_t i = 0;  i < NumBuckets;  ++i) {
+    CONDITION_LOCKER(guard, _buckets[i]._condition);
+    shrink(_buckets[i], perBucket, sizePerBucket);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum memory used by cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+size_t DocumentCache::maxSize () const {
+  return _maxSize.load();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum memory used by cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::setMaxSize (size_t value) {
+  _maxSize = value;
+
+  size_t const perBucket = (_maxEntries.load() + NumBuckets - 1) / NumBuckets;
+  size_t const sizePerBucket = (value + NumBuckets - 1) / NumBuckets;
+
+  for (size_t i = 0;  i < NumBuckets;  ++i) {
+    CONDITION_LOCKER(guard, _buckets[i]._condition);
+    shrink(_buckets[i], perBucket, sizePerBucket);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the body of a document revision, building it if required
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache::Body DocumentCache::lookup (TRI_voc_tick_t databaseId,
+                                           TRI_voc_cid_t cid,
+                                           char const* key,
+                                           TRI_voc_rid_t rid,
+                                           std::string const& collectionName,
+                                           std::function<std::string()> const& build) {
+  if (! isActive()) {
+    return std::make_shared<std::string const>(build());
+  }
+
+  std::string const ck = cacheKey(databaseId, cid, key);
+  Bucket& b = bucket(ck);
+  std::shared_ptr<InFlight> flight;
+
+  {
+    CONDITION_LOCKER(guard, b._condition);
+
+    while (true) {
+      auto it = b._entries.find(ck);
+
+      if (it != b._entries.end() &&
+          (*it).second._rid == rid &&
+          (*it).second._collectionName == collectionName &&
+          (*it).second._body != nullptr) {
+        // move to the end of the LRU list
+        b._lru.splice(b._lru.end(), b._lru, (*it).second._position);
+
+        return (*it).second._body;
+      }
+
+      auto it2 = b._inFlight.find(ck);
+
+      if (it2 == b._inFlight.end()) {
+        // nobody is building this document, so we do
+        flight.reset(new InFlight{ rid, collectionName, false, nullptr });
+        b._inFlight.emplace(ck, flight);
+        break;
+      }
+
+      std::shared_ptr<InFlight> other = (*it2).second;
+
+      if (other->_rid != rid || other->_collectionName != collectionName) {
+        // another revision is being built, build ours without sharing it
+        break;
+      }
+
+      while (! other->_done) {
+        guard.wait();
+      }
+
+      if (other->_body != nullptr) {
+        return other->_body;
+      }
+
+      // the other thread failed, try again
+    }
+  }
+
+  Body body;
+
+  try {
+    body = std::make_shared<std::string const>(build());
+  }
+  catch (...) {
+    if (flight != nullptr) {
+      CONDITION_LOCKER(guard, b._condition);
+
+      b._inFlight.erase(ck);
+      flight->_done = true;
+      guard.broadcast();
+    }
+
+    throw;
+  }
+
+  {
+    CONDITION_LOCKER(guard, b._condition);
+
+    if (flight != nullptr) {
+      b._inFlight.erase(ck);
+      flight->_body = body;
+      flight->_done = true;
+      guard.broadcast();
+    }
+
+    store(b, ck, rid, collectionName, body, nullptr);
+  }
+
+  return body;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the parsed document revision, building it if required
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache::Tree DocumentCache::lookupJson (TRI_voc_tick_t databaseId,
+                                               TRI_voc_cid_t cid,
+                                               char const* key,
+                                               TRI_voc_rid_t rid,
+                                               std::string const& collectionName,
+                                               std::function<TRI_json_t*()> const& build) {
+  auto deleter = [] (TRI_json_t const* json) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, const_cast<TRI_json_t*>(json));
+  };
+
+  if (! isActive()) {
+    return Tree(build(), deleter);
+  }
+
+  std::string const ck = cacheKey(databaseId, cid, key);
+  Bucket& b = bucket(ck);
+
+  {
+    CONDITION_LOCKER(guard, b._condition);
+
+    auto it = b._entries.find(ck);
+
+    if (it != b._entries.end() &&
+        (*it).second._rid == rid &&
+        (*it).second._collectionName == collectionName &&
+        (*it).second._json != nullptr) {
+      b._lru.splice(b._lru.end(), b._lru, (*it).second._position);
+
+      return (*it).second._json;
+    }
+  }
+
+  TRI_json_t* json = build();
+
+  if (json == nullptr) {
+    THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+  }
+
+  Tree tree(json, deleter);
+
+  {
+    CONDITION_LOCKER(guard, b._condition);
+    store(b, ck, rid, collectionName, nullptr, tree);
+  }
+
+  return tree;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove the entry of a document
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::invalidate (TRI_voc_tick_t databaseId,
+                                TRI_voc_cid_t cid,
+                                char const* key) {
+  if (! isActive()) {
+    return;
+  }
+
+  std::string const ck = cacheKey(databaseId, cid, key);
+  Bucket& b = bucket(ck);
+
+  CONDITION_LOCKER(guard, b._condition);
+
+  auto it = b._entries.find(ck);
+
+  if (it != b._entries.end()) {
+    remove(b, it);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the document cache instance
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache* DocumentCache::instance () {
+  return &Instance;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the cache key of a document
+////////////////////////////////////////////////////////////////////////////////
+
+std::string DocumentCache::cacheKey (TRI_voc_tick_t databaseId,
+                                     TRI_voc_cid_t cid,
+                                     char const* key) {
+  // the cache key is the binary database id and collection id plus the key
+  std::string result;
+  size_t const keyLength = strlen(key);
+  result.reserve(sizeof(TRI_voc_tick_t) + sizeof(TRI_voc_cid_t) + keyLength);
+  result.append(reinterpret_cast<char const*>(&databaseId), sizeof(TRI_voc_tick_t));
+  result.append(reinterpret_cast<char const*>(&cid), sizeof(TRI_voc_cid_t));
+  result.append(key, keyLength);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the bucket of a cache key
+////////////////////////////////////////////////////////////////////////////////
+
+DocumentCache::Bucket& DocumentCache::bucket (std::string const& cacheKey) {
+  return _buckets[std::hash<std::string>()(cacheKey) % NumBuckets];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a body or a parsed document in a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::store (Bucket& bucket,
+                           std::string const& cacheKey,
+                           TRI_voc_rid_t rid,
+                           std::string const& collectionName,
+                           Body const& body,
+                           Tree const& json) {
+  size_t const maxEntries = _maxEntries.load();
+
+  if (maxEntries == 0) {
+    return;
+  }
+
+  size_t const maxSize = _maxSize.load();
+  size_t const perBucket = (maxEntries + NumBuckets - 1) / NumBuckets;
+  size_t const sizePerBucket = (maxSize + NumBuckets - 1) / NumBuckets;
+
+  size_t added = 0;
+
+  if (body != nullptr) {
+    added += body->size();
+  }
+  if (json != nullptr) {
+    added += TRI_MemoryUsageJson(json.get());
+  }
+
+  auto it = bucket._entries.find(cacheKey);
+
+  if (it != bucket._entries.end()) {
+    Entry& entry = (*it).second;
+
+    if (entry._rid > rid) {
+      // a newer revision was stored in the meantime
+      return;
+    }
+
+    if (entry._rid != rid || entry._collectionName != collectionName) {
+      // replace the entry of an older revision
+      remove(bucket, it);
+    }
+    else {
+      // complete the entry of the same revision
+      if (body != nullptr) {
+        if (entry._body != nullptr) {
+          added -= body->size();
+        }
+        else {
+          entry._body = body;
+        }
+      }
+      if (json != nullptr) {
+        if (entry._json != nullptr) {
+          added -= TRI_MemoryUsageJson(json.get());
+        }
+        else {
+          entry._json = json;
+        }
+      }
+
+      entry._size += added;
+      bucket._size += added;
+      bucket._lru.splice(bucket._lru.end(), bucket._lru, entry._position);
+      shrink(bucket, perBucket, sizePerBucket);
+      return;
+    }
+  }
+
+  size_t const size = sizeof(Entry) + 2 * cacheKey.size() + collectionName.size() + added;
+
+  if (sizePerBucket > 0 && size >= sizePerBucket) {
+    // the document alone would exceed the limit
+    return;
+  }
+
+  shrink(bucket, perBucket - 1, sizePerBucket > 0 ? sizePerBucket - size : 0);
+
+  bucket._lru.emplace_back(cacheKey);
+
+  try {
+    bucket._entries.emplace(cacheKey, Entry{ rid, collectionName, body, json, size, std::prev(bucket._lru.end()) });
+  }
+  catch (...) {
+    bucket._lru.pop_back();
+    throw;
+  }
+
+  bucket._size += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove an entry from a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::remove (Bucket& bucket,
+                            std::unordered_map<std::string, Entry>::iterator it) {
+  bucket._size -= (*it).second._size;
+  bucket._lru.erase((*it).second._position);
+  bucket._entries.erase(it);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove the least recently used entries of a bucket
+////////////////////////////////////////////////////////////////////////////////
+
+void DocumentCache::shrink (Bucket& bucket,
+                            size_t maxEntries,
+                            size_t maxSize) {
+  while (! bucket._lru.empty() &&
+         (bucket._lru.size() > maxEntries ||
+          (maxSize > 0 && bucket._size > maxSize))) {
+    remove(bucket, bucket._entries.find(bucket._lru.front()));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,346 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache for serialized documents
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_UTILS_DOCUMENT_CACHE_H
+#define ARANGODB_UTILS_DOCUMENT_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/json.h"
+#include "VocBase/voc-types.h"
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class DocumentCache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief global cache for the JSON bodies of single document reads
+///
+/// entries are keyed by database id, collection id and document key, and are
+/// only valid for the revision and collection name they were built for. a
+/// changed document therefore never matches a stale entry, it replaces it
+/// once it is read again. concurrent reads of a document revision that is
+/// not yet cached are coalesced, so that only one of them builds the body
+/// and the others wait for it
+///
+/// besides the serialized body used by the REST API, an entry can hold the
+/// parsed document for AQL. updates and removals of a document invalidate
+/// its entry, so a replaced revision does not occupy memory until it is
+/// evicted. the cache is bounded by the number of entries and by the memory
+/// used by the bodies, whichever limit is reached first
+////////////////////////////////////////////////////////////////////////////////
+
+    class DocumentCache {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a serialized document body, shared between requests
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::shared_ptr<std::string const> Body;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a parsed document, shared between queries
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::shared_ptr<TRI_json_t const> Tree;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        DocumentCache (DocumentCache const&) = delete;
+        DocumentCache& operator= (DocumentCache const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        DocumentCache ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        ~DocumentCache ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the cache is active
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isActive () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum number of cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t maxEntries () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum number of cached documents. a value of 0 turns
+/// the cache off and removes all documents
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaxEntries (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the maximum memory used by cached documents, in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t maxSize () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the maximum memory used by cached documents, in bytes. a value
+/// of 0 means no limit
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaxSize (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the body of a document revision, building it if required
+///
+/// build is called without any lock held. if another thread is already
+/// building the body of the same revision, this waits for its result
+/// instead. if build throws, the waiting threads build the body themselves
+////////////////////////////////////////////////////////////////////////////////
+
+        Body lookup (TRI_voc_tick_t databaseId,
+                     TRI_voc_cid_t cid,
+                     char const* key,
+                     TRI_voc_rid_t rid,
+                     std::string const& collectionName,
+                     std::function<std::string()> const& build);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the parsed document revision, building it if required
+///
+/// build is called without any lock held and must return a document in the
+/// unknown memory zone, which the cache takes over. concurrent builds are
+/// not coalesced
+////////////////////////////////////////////////////////////////////////////////
+
+        Tree lookupJson (TRI_voc_tick_t databaseId,
+                         TRI_voc_cid_t cid,
+                         char const* key,
+                         TRI_voc_rid_t rid,
+                         std::string const& collectionName,
+                         std::function<TRI_json_t*()> const& build);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove the entry of a document, after it was updated or removed
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate (TRI_voc_tick_t databaseId,
+                         TRI_voc_cid_t cid,
+                         char const* key);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the pointer to the global document cache
+////////////////////////////////////////////////////////////////////////////////
+
+        static DocumentCache* instance ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private defines
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of partitions of the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NumBuckets = 16;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a cached document body
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Entry {
+          TRI_voc_rid_t                    _rid;
+          std::string                      _collectionName;
+          Body                             _body;
+          Tree                             _json;
+          size_t                           _size;
+          std::list<std::string>::iterator _position;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a body that is being built
+////////////////////////////////////////////////////////////////////////////////
+
+        struct InFlight {
+          TRI_voc_rid_t _rid;
+          std::string   _collectionName;
+          bool          _done;
+          Body          _body;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief one partition of the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        struct TRI_ALIGNAS(64) Bucket {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the bucket, and is signalled when a body was built
+////////////////////////////////////////////////////////////////////////////////
+
+          triagens::basics::ConditionVariable _condition;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cached bodies by cache key
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unordered_map<std::string, Entry> _entries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache keys, least recently used first
+////////////////////////////////////////////////////////////////////////////////
+
+          std::list<std::string> _lru;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bodies being built, by cache key
+////////////////////////////////////////////////////////////////////////////////
+
+          std::unordered_map<std::string, std::shared_ptr<InFlight>> _inFlight;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory used by the cached bodies and documents
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _size = 0;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief build the cache key of a document
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string cacheKey (TRI_voc_tick_t,
+                                     TRI_voc_cid_t,
+                                     char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the bucket of a cache key
+////////////////////////////////////////////////////////////////////////////////
+
+        Bucket& bucket (std::string const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief store a body or a parsed document in a bucket. the other one is
+/// kept if the entry is for the same revision
+/// note that the caller of this method must hold the bucket's lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void store (Bucket&,
+                    std::string const&,
+                    TRI_voc_rid_t,
+                    std::string const&,
+                    Body const&,
+                    Tree const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove an entry from a bucket
+/// note that the caller of this method must hold the bucket's lock
+////////////////////////////////////////////////////////////////////////////////
+
+        static void remove (Bucket&,
+                            std::unordered_map<std::string, Entry>::iterator);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief remove the least recently used entries of a bucket until it holds
+/// at most maxEntries entries and maxSize bytes (0 means no limit)
+/// note that the caller of this method must hold the bucket's lock
+////////////////////////////////////////////////////////////////////////////////
+
+        static void shrink (Bucket&, size_t, size_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the partitions of the cache
+////////////////////////////////////////////////////////////////////////////////
+
+        Bucket _buckets[NumBuckets];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of cached documents
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _maxEntries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum memory used by cached documents, 0 if unlimited
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _maxSize;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
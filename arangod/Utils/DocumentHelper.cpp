@@ -30,12 +30,60 @@
 #include "DocumentHelper.h"
 
 #include "Basics/json.h"
+#include "Basics/json-binary.h"
 #include "Basics/StringUtils.h"
+#include "Basics/string-buffer.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/shaped-json.h"
 #include "VocBase/vocbase.h"
+#include "VocBase/VocShaper.h"
 
 using namespace triagens::arango;
 using namespace triagens::basics;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends an attribute holding a document id to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+static bool AppendIdAttribute (TRI_string_buffer_t* buffer,
+                               bool separator,
+                               char const* name,
+                               std::string const& collectionName,
+                               char const* key) {
+  if (separator && TRI_AppendCharStringBuffer(buffer, ',') != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  return (TRI_AppendCharStringBuffer(buffer, '"') == TRI_ERROR_NO_ERROR &&
+          TRI_AppendStringStringBuffer(buffer, name) == TRI_ERROR_NO_ERROR &&
+          TRI_AppendString2StringBuffer(buffer, "\":\"", 3) == TRI_ERROR_NO_ERROR &&
+          TRI_AppendJsonEncodedStringStringBuffer(buffer, collectionName.c_str(), collectionName.size(), false) == TRI_ERROR_NO_ERROR &&
+          TRI_AppendCharStringBuffer(buffer, TRI_DOCUMENT_HANDLE_SEPARATOR_CHR) == TRI_ERROR_NO_ERROR &&
+          TRI_AppendJsonEncodedStringStringBuffer(buffer, key, false) == TRI_ERROR_NO_ERROR &&
+          TRI_AppendCharStringBuffer(buffer, '"') == TRI_ERROR_NO_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a string attribute to a json object
+////////////////////////////////////////////////////////////////////////////////
+
+static bool InsertStringAttribute (TRI_json_t* json,
+                                   char const* name,
+                                   std::string const& value) {
+  TRI_json_t* sub = TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, value.c_str(), value.size());
+
+  if (sub == nullptr) {
+    return false;
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, name, sub);
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              class DocumentHelper
 // -----------------------------------------------------------------------------
@@ -136,6 +184,96 @@ int DocumentHelper::getKey (TRI_json_t const* json,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON representation of a document marker to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+bool DocumentHelper::stringifyDocument (CollectionNameResolver const* resolver,
+                                        TRI_voc_cid_t cid,
+                                        TRI_df_marker_t const* marker,
+                                        VocShaper* shaper,
+                                        TRI_string_buffer_t* buffer) {
+  TRI_shaped_json_t shaped;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+
+  if (TRI_AppendCharStringBuffer(buffer, '{') != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  size_t const length = TRI_LengthStringBuffer(buffer);
+
+  if (! TRI_StringifyArrayShapedJson(shaper, buffer, &shaped, false)) {
+    return false;
+  }
+
+  char const* key = TRI_EXTRACT_MARKER_KEY(marker);
+
+  // _id, _rev, _key
+  if (! AppendIdAttribute(buffer, TRI_LengthStringBuffer(buffer) > length, TRI_VOC_ATTRIBUTE_ID, resolver->getCollectionName(cid), key)) {
+    return false;
+  }
+
+  if (TRI_AppendString2StringBuffer(buffer, ",\"" TRI_VOC_ATTRIBUTE_REV "\":\"", strlen(TRI_VOC_ATTRIBUTE_REV) + 5) != TRI_ERROR_NO_ERROR ||
+      TRI_AppendUInt64StringBuffer(buffer, TRI_EXTRACT_MARKER_RID(marker)) != TRI_ERROR_NO_ERROR ||
+      TRI_AppendString2StringBuffer(buffer, "\",\"" TRI_VOC_ATTRIBUTE_KEY "\":\"", strlen(TRI_VOC_ATTRIBUTE_KEY) + 6) != TRI_ERROR_NO_ERROR ||
+      TRI_AppendJsonEncodedStringStringBuffer(buffer, key, false) != TRI_ERROR_NO_ERROR ||
+      TRI_AppendCharStringBuffer(buffer, '"') != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  // _from, _to
+  if (TRI_IS_EDGE_MARKER(marker)) {
+    if (! AppendIdAttribute(buffer, true, TRI_VOC_ATTRIBUTE_FROM, resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)), TRI_EXTRACT_MARKER_FROM_KEY(marker)) ||
+        ! AppendIdAttribute(buffer, true, TRI_VOC_ATTRIBUTE_TO, resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)), TRI_EXTRACT_MARKER_TO_KEY(marker))) {
+      return false;
+    }
+  }
+
+  return (TRI_AppendCharStringBuffer(buffer, '}') == TRI_ERROR_NO_ERROR);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the binary json representation of a document marker to a
+/// buffer
+////////////////////////////////////////////////////////////////////////////////
+
+bool DocumentHelper::encodeBinaryDocument (CollectionNameResolver const* resolver,
+                                           TRI_voc_cid_t cid,
+                                           TRI_df_marker_t const* marker,
+                                           VocShaper* shaper,
+                                           TRI_string_buffer_t* buffer) {
+  TRI_shaped_json_t shaped;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+
+  TRI_json_t* json = TRI_JsonShapedJson(shaper, &shaped);
+
+  if (json == nullptr) {
+    return false;
+  }
+
+  std::string const key(TRI_EXTRACT_MARKER_KEY(marker));
+
+  // _id, _rev, _key
+  bool ok = TRI_IsObjectJson(json) &&
+            InsertStringAttribute(json, TRI_VOC_ATTRIBUTE_ID, assembleDocumentId(resolver->getCollectionName(cid), key)) &&
+            InsertStringAttribute(json, TRI_VOC_ATTRIBUTE_REV, StringUtils::itoa(TRI_EXTRACT_MARKER_RID(marker))) &&
+            InsertStringAttribute(json, TRI_VOC_ATTRIBUTE_KEY, key);
+
+  // _from, _to
+  if (ok && TRI_IS_EDGE_MARKER(marker)) {
+    ok = InsertStringAttribute(json, TRI_VOC_ATTRIBUTE_FROM, assembleDocumentId(resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_FROM_CID(marker)), std::string(TRI_EXTRACT_MARKER_FROM_KEY(marker)))) &&
+         InsertStringAttribute(json, TRI_VOC_ATTRIBUTE_TO, assembleDocumentId(resolver->getCollectionNameCluster(TRI_EXTRACT_MARKER_TO_CID(marker)), std::string(TRI_EXTRACT_MARKER_TO_KEY(marker))));
+  }
+
+  if (ok) {
+    ok = (TRI_StringifyBinaryJson(buffer, json) == TRI_ERROR_NO_ERROR);
+  }
+
+  TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+
+  return ok;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
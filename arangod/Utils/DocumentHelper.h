@@ -34,7 +34,10 @@
 #include "Utils/CollectionNameResolver.h"
 #include "VocBase/voc-types.h"
 
+struct TRI_df_marker_s;
 struct TRI_json_t;
+struct TRI_string_buffer_s;
+class VocShaper;
 
 namespace triagens {
   namespace arango {
@@ -93,6 +96,31 @@ namespace triagens {
         static int getKey (struct TRI_json_t const*,
                            TRI_voc_key_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the JSON representation of a document marker to a buffer
+///
+/// The shaped attributes are followed by _id, _rev, _key and, for edges,
+/// _from and _to. The text is written directly from the shaped data, no
+/// intermediate TRI_json_t is built.
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool stringifyDocument (triagens::arango::CollectionNameResolver const*,
+                                       TRI_voc_cid_t,
+                                       struct TRI_df_marker_s const*,
+                                       VocShaper*,
+                                       struct TRI_string_buffer_s*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the binary json representation of a document marker to a
+/// buffer, with the same attributes as stringifyDocument
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool encodeBinaryDocument (triagens::arango::CollectionNameResolver const*,
+                                          TRI_voc_cid_t,
+                                          struct TRI_df_marker_s const*,
+                                          VocShaper*,
+                                          struct TRI_string_buffer_s*);
+
     };
   }
 }
@@ -0,0 +1,420 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief streams an export of a collection in chunks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Utils/ExportStreamJob.h"
+#include "Basics/Exceptions.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/logging.h"
+#include "Basics/StringBuffer.h"
+#include "Dispatcher/Dispatcher.h"
+#include "Dispatcher/DispatcherQueue.h"
+#include "HttpServer/HttpServer.h"
+#include "Indexes/PrimaryIndex.h"
+#include "Utils/CollectionExport.h"
+#include "Utils/transactions.h"
+#include "VocBase/datafile.h"
+#include "VocBase/document-collection.h"
+#include "VocBase/vocbase.h"
+
+using namespace triagens::arango;
+using namespace triagens::rest;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of documents per chunk
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const BatchSize = 1000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of markers looked at per chunk in physical order
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxMarkersPerBatch = 10000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes a client may lag behind before the job waits
+////////////////////////////////////////////////////////////////////////////////
+
+static int64_t const MaxBacklog = 4 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seconds to wait for a lagging client
+////////////////////////////////////////////////////////////////////////////////
+
+static double const BacklogSleep = 0.01;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class ExportStreamJob
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the job
+////////////////////////////////////////////////////////////////////////////////
+
+ExportStreamJob::ExportStreamJob (TRI_vocbase_t* vocbase,
+                                  CollectionExport* ex,
+                                  uint64_t taskId,
+                                  Order order,
+                                  size_t streamId,
+                                  size_t streams,
+                                  size_t limit)
+  : Job("ExportStreamJob"),
+    _vocbase(vocbase),
+    _ex(ex),
+    _taskId(taskId),
+    _order(order),
+    _streamId(streamId),
+    _streams(streams),
+    _remaining(limit),
+    _initialized(false),
+    _finished(false),
+    _cursor(),
+    _datafiles(),
+    _datafile(0),
+    _offset(0),
+    _readahead() {
+
+  TRI_ASSERT(_streamId < _streams);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroys the job
+////////////////////////////////////////////////////////////////////////////////
+
+ExportStreamJob::~ExportStreamJob () {
+  if (! _finished) {
+    // the dispatcher is going down, do not leave the client waiting
+    finish(TRI_ERROR_DISPATCHER_IS_STOPPING);
+  }
+
+  delete _ex;
+  TRI_ReleaseVocBase(_vocbase);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+size_t ExportStreamJob::queue () const {
+  return Dispatcher::STANDARD_QUEUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+Job::status_t ExportStreamJob::work () {
+  int64_t backlog = 0;
+
+  if (HttpServer::chunkedBacklog(_taskId, backlog) != TRI_ERROR_NO_ERROR) {
+    // the client has gone away
+    _finished = true;
+    return status_t(Job::JOB_DONE);
+  }
+
+  if (backlog > MaxBacklog) {
+    // wait until the client has caught up
+    status_t status(Job::JOB_REQUEUE);
+    status.sleep = BacklogSleep;
+    return status;
+  }
+
+  std::vector<TRI_df_marker_t const*> markers;
+  markers.reserve(BatchSize);
+
+  bool done;
+
+  if (_order == ORDER_INDEX) {
+    done = nextFromIndex(markers);
+  }
+  else {
+    done = nextFromDatafiles(markers);
+  }
+
+  if (_remaining > 0) {
+    if (markers.size() >= _remaining) {
+      markers.resize(_remaining);
+      done = true;
+    }
+    _remaining -= markers.size();
+  }
+
+  if (! markers.empty()) {
+    // the ditch keeps the markers valid without the lock
+    triagens::basics::StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+
+    for (auto const& marker : markers) {
+      _ex->dumpDocument(marker, buffer);
+      buffer.appendChar('\n');
+    }
+
+    if (HttpServer::sendChunk(_taskId, std::string(buffer.c_str(), buffer.length())) != TRI_ERROR_NO_ERROR) {
+      _finished = true;
+      return status_t(Job::JOB_DONE);
+    }
+  }
+
+  if (done) {
+    finish(TRI_ERROR_NO_ERROR);
+    return status_t(Job::JOB_DONE);
+  }
+
+  // let the other jobs run before the next batch
+  return status_t(Job::JOB_REQUEUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void ExportStreamJob::cleanup (DispatcherQueue* queue) {
+  queue->removeJob(this);
+  delete this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+void ExportStreamJob::handleError (basics::Exception const& ex) {
+  LOG_WARNING("export of collection '%s' failed: %s", _ex->name().c_str(), ex.what());
+
+  finish(ex.code());
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the next batch in index order
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExportStreamJob::nextFromIndex (std::vector<TRI_df_marker_t const*>& markers) {
+  auto idx = _ex->document()->primaryIndex();
+
+  if (! _initialized) {
+    // streams get ranges of buckets of about the same size
+    size_t const buckets = idx->numberOfBuckets();
+    TRI_ASSERT(_streams <= buckets);
+
+    _cursor = triagens::basics::ScanCursor(_streamId * buckets / _streams,
+                                           (_streamId + 1) * buckets / _streams);
+    _initialized = true;
+  }
+
+  SingleCollectionReadOnlyTransaction trx(new StandaloneTransactionContext(), _vocbase, _ex->name());
+
+  int res = trx.begin();
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = trx.lockRead();
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+
+  bool done;
+
+  try {
+    idx->scanChunk(_cursor, BatchSize, [&] (TRI_doc_mptr_t* mptr) -> void {
+      void const* marker = mptr->getDataPtr();
+
+      if (! TRI_IsWalDataMarkerDatafile(marker)) {
+        markers.emplace_back(static_cast<TRI_df_marker_t const*>(marker));
+      }
+    });
+
+    done = idx->isScanDone(_cursor);
+  }
+  catch (...) {
+    trx.unlockRead();
+    throw;
+  }
+
+  trx.unlockRead();
+  trx.finish(TRI_ERROR_NO_ERROR);
+
+  return done;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the next batch in physical order
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExportStreamJob::nextFromDatafiles (std::vector<TRI_df_marker_t const*>& markers) {
+  auto document = _ex->document();
+
+  if (! _initialized) {
+    // stream i gets every i-th datafile, in the state they are in now. the
+    // ditch of the export keeps them from being compacted away
+    TRI_READ_LOCK_DATAFILES_DOC_COLLECTION(document);
+
+    size_t i = 0;
+
+    try {
+      for (auto const* files : { &document->_datafiles, &document->_journals }) {
+        size_t const n = files->_length;
+
+        for (size_t j = 0; j < n; ++j, ++i) {
+          if (i % _streams == _streamId) {
+            auto df = static_cast<TRI_datafile_t*>(TRI_AtVectorPointer(files, j));
+            _datafiles.emplace_back(df, static_cast<size_t>(df->_currentSize));
+          }
+        }
+      }
+    }
+    catch (...) {
+      TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(document);
+      throw;
+    }
+
+    TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(document);
+
+    _initialized = true;
+  }
+
+  if (_datafile >= _datafiles.size()) {
+    return true;
+  }
+
+  auto idx = document->primaryIndex();
+
+  SingleCollectionReadOnlyTransaction trx(new StandaloneTransactionContext(), _vocbase, _ex->name());
+
+  int res = trx.begin();
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // the lock also protects journals that are written to in parallel
+    res = trx.lockRead();
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    THROW_ARANGO_EXCEPTION(res);
+  }
+
+  size_t visited = 0;
+
+  while (_datafile < _datafiles.size() &&
+         markers.size() < BatchSize &&
+         visited < MaxMarkersPerBatch) {
+    auto const& df = _datafiles[_datafile];
+    char const* ptr = df.first->_data + _offset;
+    char const* end = df.first->_data + df.second;
+
+    if (ptr >= end) {
+      TRI_FinishReadaheadDatafile(&_readahead);
+      ++_datafile;
+      _offset = 0;
+      continue;
+    }
+
+    if (_offset == 0) {
+      // an export reads each datafile once, so the pages of sealed datafiles
+      // are released behind the scan position
+      TRI_InitReadaheadDatafile(&_readahead, df.first, df.first->_isSealed);
+    }
+
+    auto marker = reinterpret_cast<TRI_df_marker_t const*>(ptr);
+
+    if (marker->_size == 0 || marker->_type <= TRI_MARKER_MIN) {
+      // end of datafile
+      TRI_FinishReadaheadDatafile(&_readahead);
+      ++_datafile;
+      _offset = 0;
+      continue;
+    }
+
+    TRI_AdvanceReadaheadDatafile(&_readahead, ptr);
+
+    _offset += TRI_DF_ALIGN_BLOCK(marker->_size);
+    ++visited;
+
+    if (marker->_type != TRI_DOC_MARKER_KEY_DOCUMENT &&
+        marker->_type != TRI_DOC_MARKER_KEY_EDGE) {
+      continue;
+    }
+
+    // the marker is alive if it is the current revision of its document
+    TRI_doc_mptr_t const* mptr = idx->lookupKey(TRI_EXTRACT_MARKER_KEY(marker));
+
+    if (mptr != nullptr && mptr->getDataPtr() == marker) {
+      markers.emplace_back(marker);
+    }
+  }
+
+  trx.unlockRead();
+  trx.finish(TRI_ERROR_NO_ERROR);
+
+  return (_datafile >= _datafiles.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends the last chunk
+////////////////////////////////////////////////////////////////////////////////
+
+void ExportStreamJob::finish (int res) {
+  if (_finished) {
+    return;
+  }
+
+  _finished = true;
+
+  try {
+    if (res != TRI_ERROR_NO_ERROR) {
+      // the client cannot get a status code anymore, so tell it in the body
+      triagens::basics::Json error(triagens::basics::Json::Object, 3);
+      error("error", triagens::basics::Json(true));
+      error("errorNum", triagens::basics::Json(static_cast<double>(res)));
+      error("errorMessage", triagens::basics::Json(TRI_errno_string(res)));
+
+      HttpServer::sendChunk(_taskId, error.toString() + "\n");
+    }
+
+    // an empty chunk ends the response
+    HttpServer::sendChunk(_taskId, "");
+  }
+  catch (...) {
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
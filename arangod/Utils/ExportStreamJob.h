@@ -0,0 +1,247 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief streams an export of a collection in chunks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_UTILS_EXPORT_STREAM_JOB_H
+#define ARANGODB_UTILS_EXPORT_STREAM_JOB_H 1
+
+#include "Basics/Common.h"
+#include "Basics/AssocUnique.h"
+#include "Dispatcher/Job.h"
+#include "VocBase/datafile.h"
+
+struct TRI_vocbase_t;
+
+namespace triagens {
+  namespace arango {
+
+    class CollectionExport;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class ExportStreamJob
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the documents of a collection export as a chunked HTTP
+/// response, one JSON document per line
+///
+/// every call of work() reads one batch of documents under a short read
+/// lock and sends it as a chunk, then the job is queued again, so a long
+/// export neither blocks writers nor occupies a dispatcher thread. while
+/// the client has not yet received enough of the previous chunks, the job
+/// waits, so a slow client does not make the server buffer the collection.
+///
+/// an export can be split into several streams, which clients request in
+/// parallel. in index order, each stream scans a disjoint range of buckets
+/// of the primary index. in physical order, each stream reads a disjoint
+/// set of datafiles sequentially and writes the documents that are still
+/// alive, in the order they are stored on disk. like the cursor based
+/// export, both only write documents that have been moved out of the
+/// write-ahead log
+////////////////////////////////////////////////////////////////////////////////
+
+    class ExportStreamJob : public triagens::rest::Job {
+
+      private:
+
+        ExportStreamJob (ExportStreamJob const&) = delete;
+        ExportStreamJob& operator= (ExportStreamJob const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+        enum Order {
+          ORDER_INDEX,
+          ORDER_PHYSICAL
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the job for stream streamId of streams. the job takes over
+/// the prepared export, and a usage of the database that the caller acquired
+/// with TRI_UseVocBase()
+////////////////////////////////////////////////////////////////////////////////
+
+        ExportStreamJob (TRI_vocbase_t*,
+                         CollectionExport*,
+                         uint64_t,
+                         Order,
+                         size_t,
+                         size_t,
+                         size_t);
+
+        ~ExportStreamJob ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Job methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t queue () const override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        priority_e priority () const override {
+          // a running export must not be shed half-way
+          return PRIORITY_NORMAL;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        Job::status_t work () override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        bool cancel () override {
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void cleanup (rest::DispatcherQueue*) override;
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
+        void handleError (basics::Exception const&) override;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the next batch in index order, returns whether the stream
+/// is complete
+////////////////////////////////////////////////////////////////////////////////
+
+        bool nextFromIndex (std::vector<struct TRI_df_marker_s const*>&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the next batch in physical order, returns whether the
+/// stream is complete
+////////////////////////////////////////////////////////////////////////////////
+
+        bool nextFromDatafiles (std::vector<struct TRI_df_marker_s const*>&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends the last chunk, preceded by an error line if res is an error
+////////////////////////////////////////////////////////////////////////////////
+
+        void finish (int);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        TRI_vocbase_t* _vocbase;
+
+        CollectionExport* _ex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the comm task the chunks are sent to
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t const _taskId;
+
+        Order const _order;
+
+        size_t const _streamId;
+
+        size_t const _streams;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents still to write, 0 if unlimited
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _remaining;
+
+        bool _initialized;
+
+        bool _finished;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the position in the primary index, in index order
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ScanCursor _cursor;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the datafiles of the stream and their sizes at the start, in
+/// physical order
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::pair<struct TRI_datafile_s*, size_t>> _datafiles;
+
+        size_t _datafile;
+
+        size_t _offset;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the read-ahead state of the current datafile, in physical order
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_df_readahead_t _readahead;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
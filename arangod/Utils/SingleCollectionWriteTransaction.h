@@ -143,6 +143,78 @@ namespace triagens {
                               forceSync);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a single document within a transaction, using a json text
+////////////////////////////////////////////////////////////////////////////////
+
+        int createDocument (TRI_doc_mptr_copy_t* mptr,
+                            char const* text,
+                            size_t length,
+                            bool checkDuplicates,
+                            bool forceSync,
+                            char** errmsg) {
+#ifdef TRI_ENABLE_MAINTAINER_MODE
+          if (_numWrites++ > N) {
+            return TRI_ERROR_TRANSACTION_INTERNAL;
+          }
+#endif
+
+          TRI_ASSERT(mptr != nullptr);
+
+          return this->create(this->trxCollection(),
+                              mptr,
+                              text,
+                              length,
+                              checkDuplicates,
+                              nullptr,
+                              forceSync,
+                              errmsg);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create several documents within a transaction, using json texts.
+/// the texts are shaped by numThreads threads
+////////////////////////////////////////////////////////////////////////////////
+
+        int createDocuments (std::vector<std::pair<char const*, size_t>> const& texts,
+                             std::vector<int>& results,
+                             bool forceSync,
+                             size_t numThreads = 1) {
+#ifdef TRI_ENABLE_MAINTAINER_MODE
+          _numWrites += texts.size();
+
+          if (_numWrites > N) {
+            return TRI_ERROR_TRANSACTION_INTERNAL;
+          }
+#endif
+
+          return this->create(this->trxCollection(),
+                              texts,
+                              results,
+                              forceSync,
+                              numThreads);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create several documents within a transaction, using shaped json.
+/// the per-document results are returned in the documents
+////////////////////////////////////////////////////////////////////////////////
+
+        int createDocuments (std::vector<TRI_doc_insert_t>& documents,
+                             bool forceSync) {
+#ifdef TRI_ENABLE_MAINTAINER_MODE
+          _numWrites += documents.size();
+
+          if (_numWrites > N) {
+            return TRI_ERROR_TRANSACTION_INTERNAL;
+          }
+#endif
+
+          return this->create(this->trxCollection(),
+                              documents,
+                              forceSync);
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create a single edge within a transaction, using json
 ////////////////////////////////////////////////////////////////////////////////
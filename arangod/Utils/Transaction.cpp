@@ -167,6 +167,131 @@ int Transaction::readRandom (TRI_transaction_collection_t* trxCollection,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read master pointers from the buckets of the primary index using
+/// multiple threads
+////////////////////////////////////////////////////////////////////////////////
+
+int Transaction::readParallel (TRI_transaction_collection_t* trxCollection,
+                               std::vector<TRI_doc_mptr_copy_t>& docs,
+                               std::vector<uint64_t>& positions,
+                               uint64_t batchSize,
+                               size_t numThreads,
+                               uint64_t& total) {
+  TRI_document_collection_t* document = documentCollection(trxCollection);
+
+  // READ-LOCK START
+  int res = this->lock(trxCollection, TRI_TRANSACTION_READ);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  if (orderDitch(trxCollection) == nullptr) {
+    this->unlock(trxCollection, TRI_TRANSACTION_READ);
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  auto primaryIndex = document->primaryIndex();
+  size_t const numBuckets = primaryIndex->numberOfBuckets();
+
+  if (positions.empty()) {
+    // new scan
+    positions.assign(numBuckets, 0);
+    total = static_cast<uint64_t>(primaryIndex->size());
+  }
+
+  // the bucket count of an index never changes
+  TRI_ASSERT(positions.size() == numBuckets);
+
+  if (numThreads > numBuckets) {
+    numThreads = numBuckets;
+  }
+  if (numThreads == 0) {
+    numThreads = 1;
+  }
+
+  uint64_t const perThread = (batchSize + numThreads - 1) / numThreads;
+  std::vector<std::vector<TRI_doc_mptr_copy_t>> results(numThreads);
+  std::atomic<int> threadRes(TRI_ERROR_NO_ERROR);
+
+  // each thread only reads from buckets with bucketId % numThreads == chunk,
+  // and only modifies the positions of these buckets
+  auto reader = [&] (size_t chunk) -> void {
+    try {
+      auto& result = results[chunk];
+      result.reserve(static_cast<size_t>(perThread));
+
+      for (size_t bucketId = chunk; bucketId < numBuckets; bucketId += numThreads) {
+        uint64_t& position = positions[bucketId];
+
+        while (result.size() < perThread) {
+          TRI_doc_mptr_t const* mptr = primaryIndex->lookupSequentialInBucket(bucketId, position);
+
+          if (mptr == nullptr) {
+            break;
+          }
+
+          result.emplace_back(*mptr);
+        }
+
+        if (result.size() >= perThread) {
+          break;
+        }
+      }
+    }
+    catch (...) {
+      threadRes = TRI_ERROR_OUT_OF_MEMORY;
+    }
+  };
+
+  if (numThreads == 1) {
+    reader(0);
+  }
+  else {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+
+    try {
+      for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(std::thread(reader, i));
+      }
+    }
+    catch (...) {
+      threadRes = TRI_ERROR_INTERNAL;
+    }
+
+    for (size_t i = 0; i < threads.size(); ++i) {
+      // must join threads, otherwise the program will crash
+      threads[i].join();
+    }
+  }
+  
+  this->unlock(trxCollection, TRI_TRANSACTION_READ);
+  // READ-LOCK END
+
+  if (threadRes.load() != TRI_ERROR_NO_ERROR) {
+    return threadRes.load();
+  }
+
+  try {
+    size_t n = 0;
+    for (auto const& it : results) {
+      n += it.size();
+    }
+    docs.reserve(docs.size() + n);
+
+    for (auto const& it : results) {
+      docs.insert(docs.end(), it.begin(), it.end());
+    }
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read any (random) document
 ////////////////////////////////////////////////////////////////////////////////
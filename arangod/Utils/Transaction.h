@@ -49,6 +49,8 @@
 #include "VocBase/VocShaper.h"
 #include "VocBase/voc-types.h"
 
+#include <thread>
+
 namespace triagens {
   namespace arango {
 
@@ -421,6 +423,21 @@ namespace triagens {
                         uint64_t&,
                         uint64_t&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read master pointers from the buckets of the primary index using
+/// multiple threads. each thread reads from its own subset of the buckets,
+/// and the position vector keeps one offset per bucket so the scan can be
+/// continued by the next call. an empty position vector starts a new scan.
+/// the order of the documents returned is unspecified
+////////////////////////////////////////////////////////////////////////////////
+
+        int readParallel (TRI_transaction_collection_t*,
+                          std::vector<TRI_doc_mptr_copy_t>&,
+                          std::vector<uint64_t>&,
+                          uint64_t,
+                          size_t,
+                          uint64_t&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief delete a single document
 ////////////////////////////////////////////////////////////////////////////////
@@ -490,6 +507,232 @@ namespace triagens {
           return res;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a single document, using a JSON text
+///
+/// The text is shaped directly, without building a TRI_json_t first. For
+/// TRI_ERROR_HTTP_CORRUPTED_JSON, errmsg may contain the parser message,
+/// which must be freed by the caller.
+////////////////////////////////////////////////////////////////////////////////
+
+        int create (TRI_transaction_collection_t* trxCollection,
+                    TRI_doc_mptr_copy_t* mptr,
+                    char const* text,
+                    size_t length,
+                    bool checkDuplicates,
+                    void const* data,
+                    bool forceSync,
+                    char** errmsg) {
+
+          auto shaper = this->shaper(trxCollection);
+          TRI_memory_zone_t* zone = shaper->memoryZone();
+          TRI_shaped_json_t* shaped = nullptr;
+          char* key = nullptr;
+
+          int res = TRI_ShapedJsonString(shaper, text, length, true, checkDuplicates, &shaped, &key, errmsg);
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            return res;
+          }
+
+          res = create(trxCollection,
+                       key,
+                       0,
+                       mptr,
+                       shaped,
+                       data,
+                       forceSync);
+
+          TRI_FreeShapedJson(zone, shaped);
+
+          if (key != nullptr) {
+            TRI_FreeString(TRI_CORE_MEM_ZONE, key);
+          }
+
+          return res;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create several documents, using JSON texts
+/// results receives one error code per text. the documents are inserted
+/// with a single WAL write where possible. parsing and shaping the texts is
+/// split across numThreads threads
+////////////////////////////////////////////////////////////////////////////////
+
+        int create (TRI_transaction_collection_t* trxCollection,
+                    std::vector<std::pair<char const*, size_t>> const& texts,
+                    std::vector<int>& results,
+                    bool forceSync,
+                    size_t numThreads = 1) {
+
+          auto shaper = this->shaper(trxCollection);
+          TRI_memory_zone_t* zone = shaper->memoryZone();
+          size_t const n = texts.size();
+
+          std::vector<TRI_shaped_json_t*> shapeds(n, nullptr);
+          std::vector<char*> keys(n, nullptr);
+
+          results.assign(n, TRI_ERROR_NO_ERROR);
+
+          // the shaper may be used concurrently, it serializes the creation
+          // of new attributes and shapes itself
+          auto shapeTexts = [&] (size_t lower, size_t upper) -> void {
+            for (size_t i = lower; i < upper; ++i) {
+              try {
+                results[i] = TRI_ShapedJsonString(shaper, texts[i].first, texts[i].second, true, false, &shapeds[i], &keys[i], nullptr);
+              }
+              catch (...) {
+                results[i] = TRI_ERROR_OUT_OF_MEMORY;
+              }
+            }
+          };
+
+          if (numThreads > n / 256) {
+            // not worth starting threads for few documents
+            numThreads = n / 256;
+          }
+
+          if (numThreads <= 1) {
+            shapeTexts(0, n);
+          }
+          else {
+            size_t const chunkSize = n / numThreads;
+            std::vector<std::thread> threads;
+            threads.reserve(numThreads - 1);
+            size_t started = 1;
+
+            try {
+              for (; started < numThreads; ++started) {
+                size_t const lower = started * chunkSize;
+                size_t const upper = (started + 1 == numThreads) ? n : lower + chunkSize;
+                threads.emplace_back(shapeTexts, lower, upper);
+              }
+            }
+            catch (...) {
+              // chunks whose threads could not be started are shaped below
+            }
+
+            // the calling thread takes the first chunk
+            shapeTexts(0, chunkSize);
+
+            for (auto& it : threads) {
+              it.join();
+            }
+
+            if (started < numThreads) {
+              shapeTexts(started * chunkSize, n);
+            }
+          }
+
+          std::vector<TRI_doc_insert_t> documents;
+          std::vector<size_t> positions;
+
+          try {
+            documents.reserve(n);
+            positions.reserve(n);
+          }
+          catch (...) {
+            for (size_t i = 0; i < n; ++i) {
+              if (shapeds[i] != nullptr) {
+                TRI_FreeShapedJson(zone, shapeds[i]);
+              }
+              if (keys[i] != nullptr) {
+                TRI_FreeString(TRI_CORE_MEM_ZONE, keys[i]);
+              }
+            }
+            return TRI_ERROR_OUT_OF_MEMORY;
+          }
+
+          for (size_t i = 0; i < n; ++i) {
+            if (results[i] == TRI_ERROR_NO_ERROR) {
+              documents.emplace_back(keys[i], shapeds[i], nullptr);
+              positions.push_back(i);
+            }
+          }
+
+          int res = create(trxCollection, documents, forceSync);
+
+          for (size_t j = 0; j < documents.size(); ++j) {
+            auto& document = documents[j];
+
+            results[positions[j]] = (res != TRI_ERROR_NO_ERROR ? res : document._errorCode);
+
+            TRI_FreeShapedJson(zone, const_cast<TRI_shaped_json_t*>(document._shaped));
+
+            if (document._key != nullptr) {
+              TRI_FreeString(TRI_CORE_MEM_ZONE, document._key);
+            }
+          }
+
+          return res;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create several documents, using JSON
+/// results receives one error code and mptrs one master pointer per
+/// document. the documents are inserted with a single WAL write where
+/// possible
+////////////////////////////////////////////////////////////////////////////////
+
+        int create (TRI_transaction_collection_t* trxCollection,
+                    std::vector<TRI_json_t const*> const& jsons,
+                    std::vector<TRI_doc_mptr_copy_t>& mptrs,
+                    std::vector<int>& results,
+                    bool forceSync) {
+
+          auto shaper = this->shaper(trxCollection);
+          TRI_memory_zone_t* zone = shaper->memoryZone();
+          size_t const n = jsons.size();
+
+          std::vector<TRI_doc_insert_t> documents;
+          std::vector<size_t> positions;
+
+          results.assign(n, TRI_ERROR_NO_ERROR);
+          mptrs.resize(n);
+          documents.reserve(n);
+          positions.reserve(n);
+
+          int res = TRI_ERROR_NO_ERROR;
+
+          try {
+            for (size_t i = 0; i < n; ++i) {
+              TRI_voc_key_t key = nullptr;
+              results[i] = DocumentHelper::getKey(jsons[i], &key);
+
+              if (results[i] != TRI_ERROR_NO_ERROR) {
+                continue;
+              }
+
+              TRI_shaped_json_t* shaped = TRI_ShapedJsonJson(shaper, jsons[i], true);
+
+              if (shaped == nullptr) {
+                results[i] = TRI_ERROR_ARANGO_SHAPER_FAILED;
+                continue;
+              }
+
+              documents.emplace_back(key, shaped, nullptr);
+              positions.push_back(i);
+            }
+
+            res = create(trxCollection, documents, forceSync);
+          }
+          catch (...) {
+            res = TRI_ERROR_OUT_OF_MEMORY;
+          }
+
+          for (size_t j = 0; j < documents.size(); ++j) {
+            auto& document = documents[j];
+
+            results[positions[j]] = (res != TRI_ERROR_NO_ERROR ? res : document._errorCode);
+            mptrs[positions[j]] = document._mptr;
+
+            // the keys point into the JSON documents
+            TRI_FreeShapedJson(zone, const_cast<TRI_shaped_json_t*>(document._shaped));
+          }
+
+          return res;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief update a single document, using JSON
 ////////////////////////////////////////////////////////////////////////////////
@@ -849,6 +1092,31 @@ namespace triagens {
           }
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create several documents, using shaped json
+/// the per-document results are returned in the documents
+////////////////////////////////////////////////////////////////////////////////
+
+        inline int create (TRI_transaction_collection_t* trxCollection,
+                           std::vector<TRI_doc_insert_t>& documents,
+                           bool forceSync) {
+
+          bool lock = ! isLocked(trxCollection, TRI_TRANSACTION_WRITE);
+
+          try {
+            return TRI_InsertShapedJsonDocumentsCollection(trxCollection,
+                                                           documents,
+                                                           lock,
+                                                           forceSync);
+          }
+          catch (triagens::basics::Exception const& ex) {
+            return ex.code();
+          }
+          catch (...) {
+            return TRI_ERROR_INTERNAL;
+          }
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief update a single document, using shaped json
 ////////////////////////////////////////////////////////////////////////////////
@@ -1047,15 +1315,14 @@ namespace triagens {
         int setupToplevel () {
           TRI_ASSERT(_nestingLevel == 0);
 
-          // we are not embedded. now start our own transaction
-          _trx = TRI_CreateTransaction(_vocbase,
-                                       _externalId,
-                                       _timeout,
-                                       _waitForSync);
-
-          if (_trx == nullptr) {
-            return TRI_ERROR_OUT_OF_MEMORY;
-          }
+          // we are not embedded. now start our own transaction. its state
+          // lives inside this object, so no allocation is needed
+          TRI_InitTransaction(&_trxStorage,
+                              _vocbase,
+                              _externalId,
+                              _timeout,
+                              _waitForSync);
+          _trx = &_trxStorage;
 
           // register the transaction in the context
           return this->_transactionContext->registerTransaction(_trx);
@@ -1071,7 +1338,7 @@ namespace triagens {
           if (_trx != nullptr) {
             this->_transactionContext->unregisterTransaction();
 
-            TRI_FreeTransaction(_trx);
+            TRI_DestroyTransaction(_trx);
             _trx = nullptr;
           }
 
@@ -1150,6 +1417,12 @@ namespace triagens {
 
         TRI_transaction_t* _trx;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief storage for the C transaction struct of a top-level transaction
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_transaction_t _trxStorage;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief the vocbase
 ////////////////////////////////////////////////////////////////////////////////
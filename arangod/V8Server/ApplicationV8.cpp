@@ -52,6 +52,8 @@
 #include "Rest/HttpRequest.h"
 #include "Scheduler/ApplicationScheduler.h"
 #include "Scheduler/Scheduler.h"
+#include "Statistics/MetricsRegistry.h"
+#include "Statistics/statistics.h"
 #include "V8/v8-buffer.h"
 #include "V8/v8-conv.h"
 #include "V8/v8-shell.h"
@@ -105,6 +107,30 @@ char const* GlobalContextMethods::CodeBootstrapCoordinator
 char const* GlobalContextMethods::CodeWarmupExports 
   = "require(\"org/arangodb/actions\").warmupExports()";
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seconds a context above the minimum pool size may stay unused
+/// before it is disposed
+////////////////////////////////////////////////////////////////////////////////
+
+static double const ContextIdleTimeout = 60.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seconds of a single incremental garbage collection step, and the
+/// maximum time a context is kept out of service for garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+static double const GcSliceTime = 0.01;
+
+static double const GcMaxTime = 1.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief growth of the used heap since the last garbage collection that
+/// makes a context dirty, at least GcMinHeapGrowth bytes or half of the heap
+/// that survived the last garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const GcMinHeapGrowth = 16 * 1024 * 1024;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief we'll store deprecated config option values in here
 ////////////////////////////////////////////////////////////////////////////////
@@ -113,6 +139,17 @@ static std::string DeprecatedPath;
 
 static bool DeprecatedOption;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the total heap size of a context and accounts the difference
+/// in the V8 memory zone
+////////////////////////////////////////////////////////////////////////////////
+
+static void SetTotalHeapSize (size_t& totalHeapSize,
+                              size_t value) {
+  TRI_AddMemoryZoneUsage(TRI_V8_MEM_ZONE, (int64_t) value - (int64_t) totalHeapSize, 0);
+  totalHeapSize = value;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  class V8GcThread
 // -----------------------------------------------------------------------------
@@ -295,12 +332,21 @@ ApplicationV8::ApplicationV8 (TRI_server_t* server,
     _startupLoader(),
     _vocbase(nullptr),
     _nrInstances(0),
+    _minInstances(0),
+    _nrBackgroundInstances(0),
+    _busyBackgroundContexts(0),
+    _nrContexts(0),
+    _creatingContexts(0),
+    _serverPrepared(false),
     _contexts(),
+    _contextCreationLock(),
+    _addedGlobalMethods(),
     _contextCondition(),
     _freeContexts(),
     _dirtyContexts(),
     _busyContexts(),
     _stopping(false),
+    _waitingRequests(0),
     _gcThread(nullptr),
     _scheduler(scheduler),
     _dispatcher(dispatcher),
@@ -328,12 +374,27 @@ ApplicationV8::~ApplicationV8 () {
 /// @brief sets the concurrency
 ////////////////////////////////////////////////////////////////////////////////
 
-void ApplicationV8::setConcurrency (size_t n) {
-  _nrInstances = n;
+void ApplicationV8::setConcurrency (size_t minimum,
+                                    size_t maximum,
+                                    size_t background) {
+  if (maximum < 1) {
+    maximum = 1;
+  }
+  if (minimum < 1 || minimum > maximum) {
+    minimum = maximum;
+  }
+  if (background >= maximum) {
+    // requests need at least one context of their own
+    background = maximum - 1;
+  }
+
+  _nrInstances = maximum;
+  _minInstances = minimum;
+  _nrBackgroundInstances = background;
 
-  _busyContexts.reserve(n);
-  _freeContexts.reserve(n);
-  _dirtyContexts.reserve(n);
+  _busyContexts.reserve(maximum);
+  _freeContexts.reserve(maximum);
+  _dirtyContexts.reserve(maximum);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -350,7 +411,8 @@ void ApplicationV8::setVocbase (TRI_vocbase_t* vocbase) {
 
 ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
                                                        bool allowUseDatabase,
-						       ssize_t forceContext) {
+						       ssize_t forceContext,
+                                                       bool background) {
   v8::Isolate* isolate = nullptr;
   V8Context* context   = nullptr;
 
@@ -402,28 +464,59 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
 
   // look for a free context
   else {
+    double const startTime = TRI_microtime();
+
+    // whether we have asked for an additional context already
+    bool requestedContext = false;
+
     CONDITION_LOCKER(guard, _contextCondition);
 
-    while (_freeContexts.empty() && ! _stopping) {
-      LOG_DEBUG("waiting for unused V8 context");
+    while (! _stopping) {
+      // a background job at its limit waits for another background job to
+      // finish, even if there are free contexts. so does a request when all
+      // contexts not reserved for background jobs are busy
+      bool const mayEnter = mayEnterContext(background);
 
-      if (! _dirtyContexts.empty()) {
-        // we'll use a dirty context in this case
-        auto context = _dirtyContexts.back();
-        _freeContexts.emplace_back(context);
-        _dirtyContexts.pop_back();
-      }
-      else {
-        auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+      if (mayEnter) {
+        if (! _freeContexts.empty()) {
+          break;
+        }
+
+        LOG_DEBUG("waiting for unused V8 context");
 
-        if (currentThread != nullptr) {
-          triagens::rest::DispatcherThread::currentDispatcherThread->block();
+        if (! _dirtyContexts.empty()) {
+          // we'll use a dirty context in this case
+          auto context = _dirtyContexts.back();
+          _freeContexts.emplace_back(context);
+          _dirtyContexts.pop_back();
+          continue;
         }
-        guard.wait();
-        if (currentThread != nullptr) {
-          triagens::rest::DispatcherThread::currentDispatcherThread->unblock();
+
+        if (! requestedContext &&
+            _serverPrepared &&
+            _nrContexts < _nrInstances) {
+          // all contexts are busy, but the pool may still grow. the new
+          // context is handed to whoever waits when it becomes free
+          requestedContext = startContextCreation();
         }
       }
+
+      auto currentThread = triagens::rest::DispatcherThread::currentDispatcherThread;
+
+      if (currentThread != nullptr) {
+        triagens::rest::DispatcherThread::currentDispatcherThread->block();
+      }
+      // only waiters that could use a free context hurry the garbage collection
+      if (mayEnter) {
+        ++_waitingRequests;
+      }
+      guard.wait();
+      if (mayEnter) {
+        --_waitingRequests;
+      }
+      if (currentThread != nullptr) {
+        triagens::rest::DispatcherThread::currentDispatcherThread->unblock();
+      }
     }
 
     // in case we are in the shutdown phase, do not enter a context!
@@ -435,15 +528,33 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
     LOG_TRACE("found unused V8 context");
     TRI_ASSERT(! _freeContexts.empty());
 
-    context = _freeContexts.back();
+    // prefer the most recently used context that was last entered for the
+    // same database, its module and routing caches are still warm
+    size_t position = _freeContexts.size() - 1;
+
+    for (size_t j = _freeContexts.size();  j > 0;  --j) {
+      if (_freeContexts[j - 1]->_lastDatabaseId == vocbase->_id) {
+        position = j - 1;
+        break;
+      }
+    }
+
+    context = _freeContexts[position];
     TRI_ASSERT(context != nullptr);
 
     isolate = context->isolate;
 
-    _freeContexts.pop_back();
+    _freeContexts.erase(_freeContexts.begin() + position);
 
     // should not fail because we reserved enough space beforehand
     _busyContexts.emplace(context);
+
+    if (background) {
+      context->_isBackground = true;
+      ++_busyBackgroundContexts;
+    }
+
+    TRI_AddV8ContextStatistics(TRI_microtime() - startTime, background);
   }
   
   // when we get here, we should have a context and an isolate  
@@ -470,6 +581,7 @@ ApplicationV8::V8Context* ApplicationV8::enterContext (TRI_vocbase_t* vocbase,
     v8g->_allowUseDatabase   = allowUseDatabase;
   
     TRI_UseVocBase(vocbase);
+    context->_lastDatabaseId = vocbase->_id;
 
     LOG_TRACE("entering V8 context %d", (int) context->_id);
     context->handleGlobalContextMethods();
@@ -499,6 +611,9 @@ void ApplicationV8::exitContext (V8Context* context) {
   context->_hasActiveExternals = v8g->hasActiveExternals();
   ++context->_numExecutions;
 
+  v8::HeapStatistics heapStatistics;
+  isolate->GetHeapStatistics(&heapStatistics);
+
   TRI_ASSERT(v8g->_vocbase != nullptr);
   // release last recently used vocbase
   TRI_ReleaseVocBase(static_cast<TRI_vocbase_t*>(v8g->_vocbase));
@@ -565,10 +680,21 @@ void ApplicationV8::exitContext (V8Context* context) {
     LOG_TRACE("V8 context has reached maximum number of requests and will be scheduled for GC");
     performGarbageCollection = true;
   }
+  else if (heapStatistics.used_heap_size() > context->_usedHeapSizeAfterGc + 
+           (std::max)(GcMinHeapGrowth, context->_usedHeapSizeAfterGc / 2)) {
+    LOG_TRACE("V8 context heap has grown and will be scheduled for GC");
+    performGarbageCollection = true;
+  }
   
+  context->_lastUsedStamp = TRI_microtime();
+
   { 
     CONDITION_LOCKER(guard, _contextCondition);
 
+    context->_usedHeapSize  = heapStatistics.used_heap_size();
+    SetTotalHeapSize(context->_totalHeapSize, heapStatistics.total_heap_size());
+    context->_heapSizeLimit = heapStatistics.heap_size_limit();
+
     if (performGarbageCollection && ! _freeContexts.empty()) {
       // only add the context to the dirty list if there is at least one other free context
       _dirtyContexts.emplace_back(context);
@@ -579,6 +705,11 @@ void ApplicationV8::exitContext (V8Context* context) {
 
     _busyContexts.erase(context);
 
+    if (context->_isBackground) {
+      context->_isBackground = false;
+      --_busyBackgroundContexts;
+    }
+
     guard.broadcast();
   }
 }
@@ -589,14 +720,20 @@ void ApplicationV8::exitContext (V8Context* context) {
 
 bool ApplicationV8::addGlobalContextMethod (string const& method) {
   bool result = true;
-  size_t nrInstances = _nrInstances;
+
+  CONDITION_LOCKER(guard, _contextCondition);
 
   try {
-    for (size_t i = 0; i < nrInstances; ++i) {
-      if (! _contexts[i]->addGlobalContextMethod(method)) {
+    for (size_t i = 0; i < _nrInstances; ++i) {
+      if (_contexts[i] != nullptr &&
+          ! _contexts[i]->addGlobalContextMethod(method)) {
         result = false;
       }
     }
+
+    if (result) {
+      _addedGlobalMethods.emplace(method);
+    }
   }
   catch (...) {
     result = false;
@@ -628,6 +765,7 @@ void ApplicationV8::collectGarbage () {
 
   while (_stopping == 0) {
     V8Context* context = nullptr;
+    V8Context* idleContext = nullptr;
 
     {
       bool gotSignal = false;
@@ -659,12 +797,22 @@ void ApplicationV8::collectGarbage () {
         // already. increase the wait time so we don't cycle too much in the GC loop
         // and waste CPU unnecessary
         useReducedWait = (context != nullptr);
+
+        if (context == nullptr) {
+          // shrink the pool if it has grown beyond the minimum
+          idleContext = pickIdleContextForShutdown();
+        }
       }
       else {
         useReducedWait = false; 
       }
     }
 
+    if (idleContext != nullptr) {
+      LOG_DEBUG("disposing idle V8 context #%d", (int) idleContext->_id);
+      shutdownV8Instance(idleContext);
+    }
+
     // update last gc time
     double lastGc = TRI_microtime();
     gc->updateGcStamp(lastGc);
@@ -672,6 +820,8 @@ void ApplicationV8::collectGarbage () {
     if (context != nullptr) {
       LOG_TRACE("collecting V8 garbage");
       bool hasActiveExternals = false;
+      bool finished = false;
+      v8::HeapStatistics heapStatistics;
       auto isolate = context->isolate;
       TRI_ASSERT(context->_locker == nullptr);
       context->_locker = new v8::Locker(isolate);
@@ -689,7 +839,8 @@ void ApplicationV8::collectGarbage () {
 
         TRI_GET_GLOBALS();
         hasActiveExternals = v8g->hasActiveExternals();
-        TRI_RunGarbageCollectionV8(isolate, 1.0);
+        finished = collectGarbageIncrementally(context);
+        isolate->GetHeapStatistics(&heapStatistics);
 
         localContext->Exit();
       }
@@ -698,14 +849,32 @@ void ApplicationV8::collectGarbage () {
       delete context->_locker;
       context->_locker = nullptr;
 
-      // update garbage collection statistics
+      double const duration = TRI_microtime() - lastGc;
+      TRI_AddV8GcStatistics(duration);
+
+      // update garbage collection statistics. an interrupted collection
+      // leaves the counters alone, so the context is picked again
       context->_hasActiveExternals = hasActiveExternals;
-      context->_numExecutions      = 0;
-      context->_lastGcStamp        = lastGc;
+
+      if (finished) {
+        context->_numExecutions = 0;
+        context->_lastGcStamp   = lastGc;
+      }
 
       {
         CONDITION_LOCKER(guard, _contextCondition);
 
+        context->_usedHeapSize  = heapStatistics.used_heap_size();
+        SetTotalHeapSize(context->_totalHeapSize, heapStatistics.total_heap_size());
+        context->_heapSizeLimit = heapStatistics.heap_size_limit();
+
+        if (finished) {
+          context->_usedHeapSizeAfterGc = heapStatistics.used_heap_size();
+        }
+
+        ++context->_numGcRuns;
+        context->_lastGcDuration = duration;
+
         _freeContexts.emplace_back(context);
         guard.broadcast();
       }
@@ -715,6 +884,57 @@ void ApplicationV8::collectGarbage () {
   _gcFinished = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the state and heap figures of all contexts
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<ApplicationV8::V8ContextStatistics> ApplicationV8::contextStatistics () {
+  std::vector<V8ContextStatistics> result;
+
+  CONDITION_LOCKER(guard, _contextCondition);
+
+  if (_contexts == nullptr) {
+    return result;
+  }
+
+  result.reserve(_nrContexts);
+
+  for (size_t i = 0;  i < _nrInstances;  ++i) {
+    V8Context* context = _contexts[i];
+
+    if (context == nullptr) {
+      continue;
+    }
+
+    // contexts being created or garbage collected are in no list
+    char const* state = "unavailable";
+
+    if (_busyContexts.find(context) != _busyContexts.end()) {
+      state = context->_isBackground ? "background" : "busy";
+    }
+    else if (std::find(_freeContexts.begin(), _freeContexts.end(), context) != _freeContexts.end()) {
+      state = "free";
+    }
+    else if (std::find(_dirtyContexts.begin(), _dirtyContexts.end(), context) != _dirtyContexts.end()) {
+      state = "dirty";
+    }
+
+    result.push_back(V8ContextStatistics({
+      i,
+      state,
+      context->_usedHeapSize,
+      context->_totalHeapSize,
+      context->_heapSizeLimit,
+      context->_usedHeapSizeAfterGc,
+      context->_numExecutions,
+      context->_numGcRuns,
+      context->_lastGcDuration
+    }));
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -919,11 +1139,14 @@ void ApplicationV8::versionCheck () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ApplicationV8::prepareServer () {
-  size_t nrInstances = _nrInstances;
+  size_t nrInstances = _minInstances;
 
   for (size_t i = 0;  i < nrInstances;  ++i) {
     prepareV8Server(i, _startupFile);
   }
+
+  CONDITION_LOCKER(guard, _contextCondition);
+  _serverPrepared = true;
 }
 
 // -----------------------------------------------------------------------------
@@ -1018,7 +1241,7 @@ bool ApplicationV8::prepare () {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool ApplicationV8::prepare2 () {
-  size_t nrInstances = _nrInstances;
+  size_t nrInstances = _minInstances;
   v8::V8::InitializeICU();
 
   TRI_ASSERT(_platform == nullptr);
@@ -1028,10 +1251,16 @@ bool ApplicationV8::prepare2 () {
   
   v8::V8::SetArrayBufferAllocator(&_bufferAllocator);
 
-  // setup instances
+  // setup instances. the remaining slots are filled on demand
   {
     CONDITION_LOCKER(guard, _contextCondition);
-    _contexts = new V8Context*[nrInstances];
+    _contexts = new V8Context*[_nrInstances];
+
+    for (size_t i = 0; i < _nrInstances; ++i) {
+      _contexts[i] = (i < nrInstances ? new V8Context() : nullptr);
+    }
+
+    _nrContexts = nrInstances;
   }
 
   std::vector<std::thread> threads;
@@ -1059,6 +1288,29 @@ bool ApplicationV8::start () {
   _gcThread->start();
 
   _gcFinished = false;
+
+  auto metrics = triagens::basics::MetricsRegistry::instance();
+
+  metrics->addCallback("arangodb_v8_contexts_busy", "Number of V8 contexts in use",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    CONDITION_LOCKER(guard, _contextCondition);
+    return static_cast<double>(_busyContexts.size());
+  });
+  metrics->addCallback("arangodb_v8_contexts_free", "Number of V8 contexts ready for use",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    CONDITION_LOCKER(guard, _contextCondition);
+    return static_cast<double>(_freeContexts.size());
+  });
+  metrics->addCallback("arangodb_v8_contexts_dirty", "Number of V8 contexts waiting for garbage collection",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    CONDITION_LOCKER(guard, _contextCondition);
+    return static_cast<double>(_dirtyContexts.size());
+  });
+  metrics->addCallback("arangodb_v8_context_waiting_requests", "Number of requests waiting for a V8 context",
+                       triagens::basics::MetricsRegistry::GAUGE, this, [this] () {
+    return static_cast<double>(_waitingRequests.load());
+  });
+
   return true;
 }
 
@@ -1095,6 +1347,7 @@ void ApplicationV8::close () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ApplicationV8::stop () {
+  triagens::basics::MetricsRegistry::instance()->removeCallbacks(this);
 
   // send all busy contexts a termate signal
   {
@@ -1111,7 +1364,7 @@ void ApplicationV8::stop () {
     CONDITION_LOCKER(guard, _contextCondition);
 
     for (size_t n = 0;  n < 10 * 60;  ++n) {
-      if (_busyContexts.empty()) {
+      if (_busyContexts.empty() && _creatingContexts == 0) {
         break;
       }
 
@@ -1134,10 +1387,11 @@ void ApplicationV8::stop () {
   {
     CONDITION_LOCKER(guard, _contextCondition);
 
-    size_t nrInstances = _nrInstances;
-
-    for (size_t i = 0;  i < nrInstances;  ++i) {
-      shutdownV8Instance(i);
+    for (size_t i = 0;  i < _nrInstances;  ++i) {
+      if (_contexts[i] != nullptr) {
+        shutdownV8Instance(_contexts[i]);
+        _contexts[i] = nullptr;
+      }
     }
 
     delete[] _contexts;
@@ -1220,23 +1474,156 @@ ApplicationV8::V8Context* ApplicationV8::pickFreeContextForGc () {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief prepares a V8 instance
+/// @brief determine which of the free contexts has been idle long enough to
+/// be disposed. returns nullptr if the pool is at its minimum size
 ////////////////////////////////////////////////////////////////////////////////
 
-bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
+ApplicationV8::V8Context* ApplicationV8::pickIdleContextForShutdown () {
+  if (_nrContexts <= _minInstances || _freeContexts.size() < 2) {
+    return nullptr;
+  }
+
+  double const now = TRI_microtime();
+
+  for (auto it = _freeContexts.begin();  it != _freeContexts.end();  ++it) {
+    V8Context* context = (*it);
+
+    // context 0 is used for upgrades and version checks and is always kept
+    if (context->_id != 0 &&
+        context->_lastUsedStamp + ContextIdleTimeout < now) {
+      _freeContexts.erase(it);
+      _contexts[context->_id] = nullptr;
+      --_nrContexts;
+
+      return context;
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs incremental garbage collection steps on a context that is
+/// not in use. returns whether V8 has finished its work
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::collectGarbageIncrementally (V8Context* context) {
+  auto isolate = context->isolate;
+
+  TRI_ClearObjectCacheV8(isolate);
+
+  double const start = TRI_microtime();
+
+  while (true) {
+    // short slices let V8 mark incrementally instead of pausing for a full
+    // collection
+    if (isolate->IdleNotificationDeadline(_platform->MonotonicallyIncreasingTime() + GcSliceTime)) {
+      return true;
+    }
+
+    if (_waitingRequests > 0 || 
+        _stopping ||
+        TRI_microtime() - start >= GcMaxTime) {
+      // return the context to service, marking continues next time
+      return false;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a request or a background job may take another context
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::mayEnterContext (bool background) const {
+  if (_nrBackgroundInstances == 0) {
+    // all contexts are shared
+    return true;
+  }
+
+  if (background) {
+    return _busyBackgroundContexts < _nrBackgroundInstances;
+  }
+
+  return _busyContexts.size() - _busyBackgroundContexts < _nrInstances - _nrBackgroundInstances;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the creation of an additional context in the background
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::startContextCreation () {
+  size_t i = 0;
+
+  while (i < _nrInstances && _contexts[i] != nullptr) {
+    ++i;
+  }
+
+  if (i == _nrInstances) {
+    return false;
+  }
+
+  V8Context* context = new V8Context();
+
+  // the new context must catch up with the global methods it missed
+  for (auto const& method : _addedGlobalMethods) {
+    context->addGlobalContextMethod(method);
+  }
+
+  _contexts[i] = context;
+  ++_nrContexts;
+  ++_creatingContexts;
+
+  try {
+    std::thread(&ApplicationV8::createContextInThread, this, i).detach();
+  }
+  catch (...) {
+    _contexts[i] = nullptr;
+    --_nrContexts;
+    --_creatingContexts;
+    delete context;
+
+    return false;
+  }
+
+  LOG_DEBUG("creating additional V8 context #%d", (int) i);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an additional context, called by startContextCreation
+////////////////////////////////////////////////////////////////////////////////
+
+void ApplicationV8::createContextInThread (size_t i) {
+  prepareV8Instance(i, _useActions);
+
+  {
+    MUTEX_LOCKER(_contextCreationLock);
+    prepareV8Server(i, _startupFile);
+  }
+
   CONDITION_LOCKER(guard, _contextCondition);
 
+  _freeContexts.emplace_back(_contexts[i]);
+  --_creatingContexts;
+
+  guard.broadcast();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prepares a V8 instance
+////////////////////////////////////////////////////////////////////////////////
+
+bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
   vector<string> files;
 
   files.push_back("server/initialize.js");
 
   v8::Isolate* isolate = v8::Isolate::New();
   
-  V8Context* context = _contexts[i] = new V8Context();
-
-  if (context == nullptr) {
-    LOG_FATAL_AND_EXIT("cannot initialize V8 context #%d", (int) i);
-  }
+  // the slot was filled when the context was requested
+  V8Context* context = _contexts[i];
+  TRI_ASSERT(context != nullptr);
   
   TRI_ASSERT(context->_locker == nullptr);
 
@@ -1347,11 +1734,10 @@ bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
   context->_numExecutions      = 0;
   context->_hasActiveExternals = true;
   context->_lastGcStamp        = TRI_microtime() + randomWait;
+  context->_lastUsedStamp      = TRI_microtime();
 
   LOG_TRACE("initialized V8 context #%d", (int) i);
 
-  _freeContexts.emplace_back(context);
-
   return true;
 }
 
@@ -1360,9 +1746,14 @@ bool ApplicationV8::prepareV8Instance (size_t i, bool useActions) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ApplicationV8::prepareV8InstanceInThread (size_t i, bool useAction) {
+  // contexts are independent of each other and are set up in parallel
   if (! prepareV8Instance(i, useAction)) {
     _ok = false;
+    return;
   }
+
+  CONDITION_LOCKER(guard, _contextCondition);
+  _freeContexts.emplace_back(_contexts[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1401,10 +1792,26 @@ void ApplicationV8::prepareV8Server (const size_t i, const string& startupFile)
     // and return from the context
     localContext->Exit();
   }
+
+  // the heap after startup is the baseline for heap growth
+  v8::HeapStatistics heapStatistics;
+  isolate->GetHeapStatistics(&heapStatistics);
+
   isolate->Exit();
   delete context->_locker;
   context->_locker = nullptr;
 
+  {
+    CONDITION_LOCKER(guard, _contextCondition);
+
+    context->_usedHeapSize        = heapStatistics.used_heap_size();
+    SetTotalHeapSize(context->_totalHeapSize, heapStatistics.total_heap_size());
+    context->_heapSizeLimit       = heapStatistics.heap_size_limit();
+
+    TRI_AddMemoryZoneUsage(TRI_V8_MEM_ZONE, 0, 1);
+    context->_usedHeapSizeAfterGc = heapStatistics.used_heap_size();
+  }
+
   // initialize garbage collection for context
   LOG_TRACE("initialized V8 server #%d", (int) i);
 }
@@ -1413,10 +1820,10 @@ void ApplicationV8::prepareV8Server (const size_t i, const string& startupFile)
 /// @brief shut downs a V8 instances
 ////////////////////////////////////////////////////////////////////////////////
 
-void ApplicationV8::shutdownV8Instance (size_t i) {
-  LOG_TRACE("shutting down V8 context #%d", (int) i);
+void ApplicationV8::shutdownV8Instance (V8Context* context) {
+  size_t const i = context->_id;
 
-  V8Context* context = _contexts[i];
+  LOG_TRACE("shutting down V8 context #%d", (int) i);
 
   auto isolate = context->isolate;
   isolate->Enter();
@@ -1455,6 +1862,9 @@ void ApplicationV8::shutdownV8Instance (size_t i) {
 
   isolate->Dispose();
 
+  SetTotalHeapSize(context->_totalHeapSize, 0);
+  TRI_AddMemoryZoneUsage(TRI_V8_MEM_ZONE, 0, -1);
+
   delete context;
 
   LOG_TRACE("closed V8 context #%d", (int) i);
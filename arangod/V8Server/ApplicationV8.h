@@ -35,7 +35,9 @@
 #include <v8.h>
 
 #include "Basics/ConditionVariable.h"
+#include "Basics/Mutex.h"
 #include "V8/JSLoader.h"
+#include "VocBase/voc-types.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
@@ -274,6 +276,45 @@ namespace triagens {
 
           double _lastGcStamp;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timestamp of the last exit from the context
+////////////////////////////////////////////////////////////////////////////////
+
+          double _lastUsedStamp;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief id of the database the context was last entered for
+////////////////////////////////////////////////////////////////////////////////
+
+          TRI_voc_tick_t _lastDatabaseId = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the context is currently used by a background job
+////////////////////////////////////////////////////////////////////////////////
+
+          bool _isBackground = false;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief heap sizes when the context was last exited or collected
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _usedHeapSize = 0;
+          size_t _totalHeapSize = 0;
+          size_t _heapSizeLimit = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief used heap size after the last completed garbage collection
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t _usedHeapSizeAfterGc = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of garbage collection runs and the duration of the last one
+////////////////////////////////////////////////////////////////////////////////
+
+          uint64_t _numGcRuns = 0;
+          double _lastGcDuration = 0.0;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not the context has dead (ex-v8 wrapped) objects
 ////////////////////////////////////////////////////////////////////////////////
@@ -281,6 +322,23 @@ namespace triagens {
           bool _hasActiveExternals;
         };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state and heap figures of a context, as returned by
+/// contextStatistics()
+////////////////////////////////////////////////////////////////////////////////
+
+        struct V8ContextStatistics {
+          size_t _id;
+          char const* _state;
+          size_t _usedHeapSize;
+          size_t _totalHeapSize;
+          size_t _heapSizeLimit;
+          size_t _usedHeapSizeAfterGc;
+          size_t _numExecutions;
+          uint64_t _numGcRuns;
+          double _lastGcDuration;
+        };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -316,9 +374,17 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the concurrency
+///
+/// the minimum number of contexts is created at startup, further contexts up
+/// to the maximum are created when all existing contexts are busy. background
+/// jobs may use at most the given number of contexts at the same time, and
+/// requests may use all others. with background set to 0, all contexts are
+/// shared
 ////////////////////////////////////////////////////////////////////////////////
 
-        void setConcurrency (size_t);
+        void setConcurrency (size_t minimum,
+                             size_t maximum,
+                             size_t background = 0);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the database
@@ -332,7 +398,18 @@ namespace triagens {
 
         V8Context* enterContext (TRI_vocbase_t*,
                                  bool useDatabase,
-				 ssize_t forceContext = -1);
+				 ssize_t forceContext = -1,
+                                 bool background = false);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enters a context for a background job, i.e. a task or a job of a
+/// Foxx queue. these never take the contexts reserved for requests
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* enterBackgroundContext (TRI_vocbase_t* vocbase,
+                                           bool useDatabase) {
+          return enterContext(vocbase, useDatabase, -1, true);
+        }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief exists an context
@@ -352,6 +429,12 @@ namespace triagens {
 
         void collectGarbage ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the state and heap figures of all contexts
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<V8ContextStatistics> contextStatistics ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief disables actions
 ////////////////////////////////////////////////////////////////////////////////
@@ -446,6 +529,42 @@ namespace triagens {
 
         V8Context* pickFreeContextForGc ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine which of the free contexts has been idle long enough to
+/// be disposed. returns nullptr if the pool is at its minimum size
+////////////////////////////////////////////////////////////////////////////////
+
+        V8Context* pickIdleContextForShutdown ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs incremental garbage collection steps on a context that is
+/// not in use. returns whether V8 has finished its work
+////////////////////////////////////////////////////////////////////////////////
+
+        bool collectGarbageIncrementally (V8Context*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the creation of an additional context in the background
+///
+/// Caller must hold the _contextCondition.
+////////////////////////////////////////////////////////////////////////////////
+
+        bool startContextCreation ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a request or a background job may take another context
+///
+/// Caller must hold the _contextCondition.
+////////////////////////////////////////////////////////////////////////////////
+
+        bool mayEnterContext (bool background) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an additional context, called by startContextCreation
+////////////////////////////////////////////////////////////////////////////////
+
+        void createContextInThread (size_t i);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief prepares a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
@@ -468,7 +587,7 @@ namespace triagens {
 /// @brief shuts down a V8 instance
 ////////////////////////////////////////////////////////////////////////////////
 
-        void shutdownV8Instance (size_t i);
+        void shutdownV8Instance (V8Context*);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
@@ -606,17 +725,70 @@ namespace triagens {
         TRI_vocbase_t* _vocbase;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief number of instances to create
+/// @brief maximum number of instances
 ////////////////////////////////////////////////////////////////////////////////
 
         size_t _nrInstances;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief V8 contexts
+/// @brief number of instances to create at startup and to keep when idle
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _minInstances;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of instances used by background jobs at the same
+/// time, 0 if background jobs share all instances with requests
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nrBackgroundInstances;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of instances currently used by background jobs
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _busyBackgroundContexts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of existing instances, including the ones being created
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nrContexts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of instances being created in the background
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _creatingContexts;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the startup file has been loaded into the initial contexts,
+/// additional contexts are only created afterwards
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _serverPrepared;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief V8 contexts, one slot per possible instance. unused slots are
+/// nullptr, slot 0 always holds a context
 ////////////////////////////////////////////////////////////////////////////////
 
         V8Context** _contexts;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes loading the startup file into additional contexts, as
+/// it is loaded into the initial contexts one after the other
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _contextCreationLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief global methods added so far, additional contexts execute them on
+/// their first use
+////////////////////////////////////////////////////////////////////////////////
+
+        std::set<std::string> _addedGlobalMethods;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief V8 contexts queue lock
 ////////////////////////////////////////////////////////////////////////////////
@@ -647,6 +819,13 @@ namespace triagens {
 
         std::atomic<bool> _stopping;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of requests waiting for a free context. garbage collection
+/// returns a context as soon as requests are waiting
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _waitingRequests;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief garbage collection thread
 ////////////////////////////////////////////////////////////////////////////////
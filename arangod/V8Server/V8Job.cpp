@@ -30,6 +30,7 @@
 
 #include "Basics/json.h"
 #include "Basics/logging.h"
+#include "Dispatcher/Dispatcher.h"
 #include "Dispatcher/DispatcherQueue.h"
 #include "V8/v8-conv.h"
 #include "V8/v8-utils.h"
@@ -86,12 +87,20 @@ V8Job::~V8Job () {
 /// {@inheritDoc}
 ////////////////////////////////////////////////////////////////////////////////
 
+size_t V8Job::queue () const {
+  return Dispatcher::BACKGROUND_QUEUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// {@inheritDoc}
+////////////////////////////////////////////////////////////////////////////////
+
 Job::status_t V8Job::work () {
   if (_canceled) {
     return status_t(JOB_DONE);
   }
 
-  ApplicationV8::V8Context* context = _v8Dealer->enterContext(_vocbase, _allowUseDatabase);
+  ApplicationV8::V8Context* context = _v8Dealer->enterBackgroundContext(_vocbase, _allowUseDatabase);
 
   // note: the context might be 0 in case of shut-down
   if (context == nullptr) {
@@ -98,7 +98,7 @@ Job::status_t V8QueueJob::work () {
     return status_t(JOB_DONE);
   }
 
-  ApplicationV8::V8Context* context = _v8Dealer->enterContext(_vocbase, false);
+  ApplicationV8::V8Context* context = _v8Dealer->enterBackgroundContext(_vocbase, false);
 
   // note: the context might be 0 in case of shut-down
   if (context == nullptr) {
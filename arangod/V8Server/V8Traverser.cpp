@@ -112,7 +112,7 @@ class MultiCollectionEdgeExpander {
 
 
     void operator() (VertexId& source,
-                     vector<ArangoDBPathFinder::Step*>& result) {
+                     vector<ArangoDBPathFinder::Step>& result) {
       TransactionBase fake(true); // Fake a transaction to please checks. 
                                   // This is due to multi-threading
 
@@ -134,15 +134,14 @@ class MultiCollectionEdgeExpander {
               auto cand = candidates.find(t);
               if (cand == candidates.end()) {
                 // Add weight
-                result.emplace_back(new ArangoDBPathFinder::Step(t, s, currentWeight,
-                                    edgeId));
+                result.emplace_back(t, s, currentWeight, edgeId);
                 candidates.emplace(t, result.size() - 1);
               } 
               else {
                 // Compare weight
-                auto oldWeight = result[cand->second]->weight();
+                auto oldWeight = result[cand->second].weight();
                 if (currentWeight < oldWeight) {
-                  result[cand->second]->setWeight(currentWeight);
+                  result[cand->second].setWeight(currentWeight);
                 }
               }
             }
@@ -181,7 +180,7 @@ class SimpleEdgeExpander {
     };
 
     void operator() (VertexId& source,
-                     vector<ArangoDBPathFinder::Step*>& result) {
+                     vector<ArangoDBPathFinder::Step>& result) {
       TransactionBase fake(true); // Fake a transaction to please checks. 
                                   // This is due to multi-threading
       auto edges = _edgeCollection->getEdges(_direction, source); 
@@ -196,15 +195,15 @@ class SimpleEdgeExpander {
           auto cand = candidates.find(t);
           if (cand == candidates.end()) {
             // Add weight
-            result.emplace_back(new ArangoDBPathFinder::Step(t, s, currentWeight, 
-                                _edgeCollection->extractEdgeId(edges[j])));
+            EdgeId edgeId = _edgeCollection->extractEdgeId(edges[j]);
+            result.emplace_back(t, s, currentWeight, edgeId);
             candidates.emplace(t, result.size() - 1);
           } 
           else {
             // Compare weight
-            auto oldWeight = result[cand->second]->weight();
+            auto oldWeight = result[cand->second].weight();
             if (currentWeight < oldWeight) {
-              result[cand->second]->setWeight(currentWeight);
+              result[cand->second].setWeight(currentWeight);
             }
           }
         };
@@ -347,6 +346,24 @@ bool BasicOptions::matchesEdge (EdgeId& e, TRI_doc_mptr_copy_t* edge) const {
   return it->second->matches(e.cid, edge);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the edge examples of a collection, or nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+ExampleMatcher const* BasicOptions::edgeFilter (TRI_voc_cid_t cid) const {
+  if (! useEdgeFilter) {
+    return nullptr;
+  }
+
+  auto it = _edgeFilter.find(cid);
+
+  if (it == _edgeFilter.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                     ShortestPathOptions FUNCTIONS
 // -----------------------------------------------------------------------------
@@ -396,6 +413,18 @@ void NeighborsOptions::addCollectionRestriction (TRI_voc_cid_t cid) {
 // --SECTION--                                          private Helper Functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands the edge examples to the collections, so that they can read
+/// only the edges with the example values from a vertex-centric index
+////////////////////////////////////////////////////////////////////////////////
+
+static void SetEdgeFilters (vector<EdgeCollectionInfo*>& collectionInfos,
+                            BasicOptions const& opts) {
+  for (auto& it : collectionInfos) {
+    it->setEdgeFilter(opts.edgeFilter(it->getCid()));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Wrapper for the shortest path computation
 ////////////////////////////////////////////////////////////////////////////////
@@ -420,6 +449,8 @@ unique_ptr<ArangoDBPathFinder::Path> TRI_RunShortestPathSearch (
     backward = TRI_EDGE_ANY;
   }
 
+  SetEdgeFilters(collectionInfos, opts);
+
   auto edgeFilterClosure = [&opts] (EdgeId& e, TRI_doc_mptr_copy_t* edge) -> bool { 
     return opts.matchesEdge(e, edge); 
   };
@@ -683,6 +714,8 @@ void TRI_RunNeighborsSearch (
   startVertices.emplace(opts.start);
   visited.emplace(opts.start);
 
+  SetEdgeFilters(collectionInfos, opts);
+
   switch (opts.direction) {
     case TRI_EDGE_IN:
       InboundNeighbors(collectionInfos, opts, startVertices, visited, result);
@@ -696,3 +729,323 @@ void TRI_RunNeighborsSearch (
   }
 }
 
+
+// -----------------------------------------------------------------------------
+// --SECTION--                               AttributeWeightCalculator FUNCTIONS
+// -----------------------------------------------------------------------------
+
+AttributeWeightCalculator::AttributeWeightCalculator (string const& keyWeight,
+                                                      double defaultWeight,
+                                                      VocShaper* shaper) 
+  : _defaultWeight(defaultWeight),
+    _shaper(shaper) {
+
+  _shapePid = _shaper->lookupAttributePathByName(keyWeight.c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Callable weight calculator for edge
+////////////////////////////////////////////////////////////////////////////////
+
+double AttributeWeightCalculator::operator() (TRI_doc_mptr_copy_t const& edge) {
+  if (_shapePid == 0) {
+    return _defaultWeight;
+  }
+
+  TRI_shape_sid_t sid;
+  TRI_EXTRACT_SHAPE_IDENTIFIER_MARKER(sid, edge.getDataPtr());
+  TRI_shape_access_t const* accessor = _shaper->findAccessor(sid, _shapePid);
+
+  if (accessor == nullptr) {
+    return _defaultWeight;
+  }
+
+  TRI_shaped_json_t shapedJson;
+  TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, edge.getDataPtr());
+  TRI_shaped_json_t resultJson;
+
+  if (! TRI_ExecuteShapeAccessor(accessor, &shapedJson, &resultJson) ||
+      resultJson._sid != BasicShapes::TRI_SHAPE_SID_NUMBER) {
+    return _defaultWeight;
+  }
+
+  // numbers are stored as plain doubles, no need to convert to JSON
+  return * (TRI_shape_number_t const*) resultJson._data.data;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                          PathEnumerator FUNCTIONS
+// -----------------------------------------------------------------------------
+
+PathEnumerator::PathEnumerator (vector<EdgeCollectionInfo*> const& collectionInfos,
+                                TraversalOptions& opts)
+  : _collectionInfos(collectionInfos),
+    _opts(opts),
+    _current(0),
+    _started(false) {
+
+  SetEdgeFilters(_collectionInfos, _opts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances to the next path
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathEnumerator::next () {
+  if (! _started) {
+    _started = true;
+
+    Step start;
+    start.vertex = _opts.start;
+    start.edgeCollection = nullptr;
+    start.parent = 0;
+    start.depth = 0;
+    start.weight = 0.0;
+    _steps.emplace_back(start);
+
+    if (_opts.uniqueVertices == TraversalOptions::UNIQUE_GLOBAL &&
+        _opts.strategy != TraversalOptions::WEIGHTED) {
+      _visitedVertices.emplace(_opts.start);
+    }
+
+    switch (_opts.strategy) {
+      case TraversalOptions::DEPTH_FIRST:
+        _stack.emplace_back(0);
+        break;
+      case TraversalOptions::BREADTH_FIRST:
+        _queue.emplace_back(0);
+        break;
+      case TraversalOptions::WEIGHTED:
+        _heap.emplace(0.0, 0);
+        break;
+    }
+  }
+
+  size_t id;
+
+  while (pop(id)) {
+    // copy the values we need, expand() may move the steps
+    VertexId const vertex = _steps[id].vertex;
+    uint64_t const depth = _steps[id].depth;
+
+    if (_opts.strategy == TraversalOptions::WEIGHTED &&
+        _opts.uniqueVertices == TraversalOptions::UNIQUE_GLOBAL &&
+        ! _visitedVertices.emplace(vertex).second) {
+      // a cheaper path to this vertex has been returned already
+      continue;
+    }
+
+    if (depth < _opts.maxDepth &&
+        (! _opts.prune || ! _opts.prune(vertex))) {
+      expand(id);
+    }
+
+    if (depth >= _opts.minDepth) {
+      _current = id;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the steps of the current path
+////////////////////////////////////////////////////////////////////////////////
+
+void PathEnumerator::path (vector<Step const*>& result) const {
+  result.clear();
+
+  size_t id = _current;
+  result.emplace_back(&_steps[id]);
+
+  while (id != 0) {
+    id = _steps[id].parent;
+    result.emplace_back(&_steps[id]);
+  }
+
+  std::reverse(result.begin(), result.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief takes the next step to visit
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathEnumerator::pop (size_t& id) {
+  switch (_opts.strategy) {
+    case TraversalOptions::DEPTH_FIRST: {
+      if (_stack.empty()) {
+        return false;
+      }
+      id = _stack.back();
+      _stack.pop_back();
+      return true;
+    }
+
+    case TraversalOptions::BREADTH_FIRST: {
+      if (_queue.empty()) {
+        return false;
+      }
+      id = _queue.front();
+      _queue.pop_front();
+      return true;
+    }
+
+    case TraversalOptions::WEIGHTED: {
+      if (_heap.empty()) {
+        return false;
+      }
+      id = _heap.top().second;
+      _heap.pop();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds the steps reachable from a step
+////////////////////////////////////////////////////////////////////////////////
+
+void PathEnumerator::expand (size_t id) {
+  VertexId const vertex = _steps[id].vertex;
+  size_t const first = _steps.size();
+
+  for (auto const& col : _collectionInfos) {
+    if (_opts.direction == TRI_EDGE_OUT || _opts.direction == TRI_EDGE_ANY) {
+      auto edges = col->getEdges(TRI_EDGE_OUT, vertex);
+
+      for (auto const& edge : edges) {
+        addStep(id, col, edge, ExtractToId(edge));
+      }
+    }
+
+    if (_opts.direction == TRI_EDGE_IN || _opts.direction == TRI_EDGE_ANY) {
+      auto edges = col->getEdges(TRI_EDGE_IN, vertex);
+
+      for (auto const& edge : edges) {
+        addStep(id, col, edge, ExtractFromId(edge));
+      }
+    }
+  }
+
+  switch (_opts.strategy) {
+    case TraversalOptions::DEPTH_FIRST: {
+      // the first edge must be on top of the stack
+      for (size_t i = _steps.size(); i > first; --i) {
+        _stack.emplace_back(i - 1);
+      }
+      break;
+    }
+
+    case TraversalOptions::BREADTH_FIRST: {
+      for (size_t i = first; i < _steps.size(); ++i) {
+        _queue.emplace_back(i);
+      }
+      break;
+    }
+
+    case TraversalOptions::WEIGHTED: {
+      for (size_t i = first; i < _steps.size(); ++i) {
+        _heap.emplace(_steps[i].weight, i);
+      }
+      break;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a step if the edge and the vertex may be visited
+////////////////////////////////////////////////////////////////////////////////
+
+void PathEnumerator::addStep (size_t parent,
+                              EdgeCollectionInfo* col,
+                              TRI_doc_mptr_copy_t const& edge,
+                              VertexId const& vertex) {
+  TRI_doc_mptr_copy_t copy(edge);
+  EdgeId edgeId = col->extractEdgeId(copy);
+
+  if (! _opts.matchesEdge(edgeId, &copy)) {
+    return;
+  }
+
+  void const* data = edge.getDataPtr();
+
+  if (_opts.uniqueEdges == TraversalOptions::UNIQUE_PATH) {
+    if (isEdgeOnPath(parent, data)) {
+      return;
+    }
+  }
+  else if (_opts.uniqueEdges == TraversalOptions::UNIQUE_GLOBAL) {
+    if (! _visitedEdges.emplace(data).second) {
+      return;
+    }
+  }
+
+  if (_opts.uniqueVertices == TraversalOptions::UNIQUE_PATH) {
+    if (isVertexOnPath(parent, vertex)) {
+      return;
+    }
+  }
+  else if (_opts.uniqueVertices == TraversalOptions::UNIQUE_GLOBAL) {
+    if (_opts.strategy == TraversalOptions::WEIGHTED) {
+      // vertices are marked when they are taken from the heap
+      if (_visitedVertices.find(vertex) != _visitedVertices.end()) {
+        return;
+      }
+    }
+    else if (! _visitedVertices.emplace(vertex).second) {
+      return;
+    }
+  }
+
+  double weight = 1.0;
+
+  if (_opts.strategy == TraversalOptions::WEIGHTED) {
+    weight = col->weightEdge(copy);
+  }
+
+  Step step;
+  step.vertex = vertex;
+  step.edge = copy;
+  step.edgeCollection = col;
+  step.parent = parent;
+  step.depth = _steps[parent].depth + 1;
+  step.weight = _steps[parent].weight + weight;
+
+  _steps.emplace_back(step);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a vertex is on the path to a step
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathEnumerator::isVertexOnPath (size_t id,
+                                     VertexId const& vertex) const {
+  while (true) {
+    if (_steps[id].vertex == vertex) {
+      return true;
+    }
+    if (id == 0) {
+      return false;
+    }
+    id = _steps[id].parent;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether an edge is on the path to a step
+////////////////////////////////////////////////////////////////////////////////
+
+bool PathEnumerator::isEdgeOnPath (size_t id,
+                                   void const* edge) const {
+  while (id != 0) {
+    if (_steps[id].edge.getDataPtr() == edge) {
+      return true;
+    }
+    id = _steps[id].parent;
+  }
+
+  return false;
+}
@@ -188,6 +188,8 @@ namespace triagens {
 
           bool matchesEdge (EdgeId& e, TRI_doc_mptr_copy_t* edge) const;
 
+          triagens::arango::ExampleMatcher const* edgeFilter (TRI_voc_cid_t cid) const;
+
           bool matchesVertex (VertexId const& v) const;
 
       };
@@ -238,6 +240,46 @@ namespace triagens {
           bool matchesVertex (VertexId const&) const;
 
       };
+
+      struct TraversalOptions : BasicOptions {
+
+        public:
+
+          enum Strategy {
+            DEPTH_FIRST,
+            BREADTH_FIRST,
+            WEIGHTED
+          };
+
+          enum Uniqueness {
+            UNIQUE_NONE,
+            UNIQUE_PATH,
+            UNIQUE_GLOBAL
+          };
+
+          TRI_edge_direction_e direction;
+          Strategy strategy;
+          Uniqueness uniqueVertices;
+          Uniqueness uniqueEdges;
+          uint64_t minDepth;
+          uint64_t maxDepth;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief optional callback that decides whether a vertex must not be
+/// expanded. the vertex itself is still returned
+////////////////////////////////////////////////////////////////////////////////
+
+          std::function<bool(VertexId const&)> prune;
+
+          TraversalOptions ()
+            : direction(TRI_EDGE_OUT),
+              strategy(DEPTH_FIRST),
+              uniqueVertices(UNIQUE_NONE),
+              uniqueEdges(UNIQUE_PATH),
+              minDepth(0),
+              maxDepth(256) {
+          }
+      };
     }
   }
 }
@@ -249,6 +291,29 @@ namespace triagens {
 
 typedef std::function<double(TRI_doc_mptr_copy_t& edge)> WeightCalculatorFunction;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Define edge weight by ony special attribute.
+///        Respectively 1 for any edge.
+////////////////////////////////////////////////////////////////////////////////
+
+class AttributeWeightCalculator {
+
+  TRI_shape_pid_t _shapePid;
+  double _defaultWeight;
+  VocShaper* _shaper;
+
+  public: 
+    AttributeWeightCalculator (std::string const& keyWeight,
+                               double defaultWeight,
+                               VocShaper* shaper);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief Callable weight calculator for edge
+////////////////////////////////////////////////////////////////////////////////
+
+    double operator() (TRI_doc_mptr_copy_t const& edge);
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Information required internally of the traverser.
 ///        Used to easily pass around collections.
@@ -276,6 +341,13 @@ class EdgeCollectionInfo {
 
     WeightCalculatorFunction _weighter;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief examples the edges are filtered with, used to select the edges to
+/// read with a vertex-centric index. not owned
+////////////////////////////////////////////////////////////////////////////////
+
+    triagens::arango::ExampleMatcher const* _edgeFilter;
+
   public:
 
     EdgeCollectionInfo (TRI_voc_cid_t& edgeCollectionCid,
@@ -283,17 +355,27 @@ class EdgeCollectionInfo {
                         WeightCalculatorFunction weighter)
       : _edgeCollectionCid(edgeCollectionCid),
         _edgeCollection(edgeCollection),
-        _weighter(weighter) {
+        _weighter(weighter),
+        _edgeFilter(nullptr) {
     }
 
     EdgeId extractEdgeId (TRI_doc_mptr_copy_t& ptr) {
       return EdgeId(_edgeCollectionCid, TRI_EXTRACT_MARKER_KEY(&ptr));
     }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the edges of a vertex. if an edge filter is set, this may
+/// leave out edges not matching it, but the edges must still be checked
+////////////////////////////////////////////////////////////////////////////////
+
     std::vector<TRI_doc_mptr_copy_t> getEdges (TRI_edge_direction_e direction,
                                                VertexId const& vertexId) const {
       return TRI_LookupEdgesDocumentCollection(_edgeCollection,
-                   direction, vertexId.cid, const_cast<char*>(vertexId.key));
+                   direction, vertexId.cid, const_cast<char*>(vertexId.key), _edgeFilter);
+    }
+
+    void setEdgeFilter (triagens::arango::ExampleMatcher const* edgeFilter) {
+      _edgeFilter = edgeFilter;
     }
 
     TRI_voc_cid_t getCid () {
@@ -351,6 +433,100 @@ class VertexCollectionInfo {
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enumerates the paths from a start vertex one by one
+///
+/// the paths are found in depth-first or breadth-first order, or ordered by
+/// the sum of their edge weights. every step of the search is kept in a
+/// vector and refers to the step it was reached from, so the paths share
+/// their common prefixes. the keys of vertices and edges point into the
+/// markers, which must be protected by the transaction, and into the
+/// options for the start vertex
+////////////////////////////////////////////////////////////////////////////////
+
+class PathEnumerator {
+
+  public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a step of the search. the start vertex has no edge
+////////////////////////////////////////////////////////////////////////////////
+
+    struct Step {
+      VertexId vertex;
+      TRI_doc_mptr_copy_t edge;
+      EdgeCollectionInfo* edgeCollection;
+      size_t parent;
+      uint64_t depth;
+      double weight;
+    };
+
+    PathEnumerator (std::vector<EdgeCollectionInfo*> const& collectionInfos,
+                    triagens::basics::traverser::TraversalOptions& opts);
+
+    PathEnumerator (PathEnumerator const&) = delete;
+    PathEnumerator& operator= (PathEnumerator const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances to the next path. returns false if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+    bool next ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the last step of the current path
+////////////////////////////////////////////////////////////////////////////////
+
+    Step const& current () const {
+      return _steps[_current];
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the steps of the current path, starting at the start vertex
+////////////////////////////////////////////////////////////////////////////////
+
+    void path (std::vector<Step const*>& result) const;
+
+  private:
+
+    bool pop (size_t& id);
+
+    void expand (size_t id);
+
+    void addStep (size_t parent,
+                  EdgeCollectionInfo* col,
+                  TRI_doc_mptr_copy_t const& edge,
+                  VertexId const& vertex);
+
+    bool isVertexOnPath (size_t id,
+                         VertexId const& vertex) const;
+
+    bool isEdgeOnPath (size_t id,
+                       void const* edge) const;
+
+    std::vector<EdgeCollectionInfo*> _collectionInfos;
+
+    triagens::basics::traverser::TraversalOptions& _opts;
+
+    std::vector<Step> _steps;
+
+    std::vector<size_t> _stack;
+
+    std::deque<size_t> _queue;
+
+    std::priority_queue<std::pair<double, size_t>,
+                        std::vector<std::pair<double, size_t>>,
+                        std::greater<std::pair<double, size_t>>> _heap;
+
+    std::unordered_set<VertexId> _visitedVertices;
+
+    std::unordered_set<void const*> _visitedEdges;
+
+    size_t _current;
+
+    bool _started;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Wrapper for the shortest path computation
 ////////////////////////////////////////////////////////////////////////////////
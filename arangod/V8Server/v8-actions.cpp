@@ -349,6 +349,162 @@ static void AddCookie (v8::Isolate* isolate,
   response->setCookie(name, value, lifeTimeSeconds, path, domain, secure, httpOnly);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the attributes of a request object that are converted on first
+/// access
+////////////////////////////////////////////////////////////////////////////////
+
+enum LazyRequestAttribute {
+  LAZY_HEADERS,
+  LAZY_PARAMETERS,
+  LAZY_COOKIES,
+  LAZY_BODY
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the header fields of a request
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Object> HeadersCppToV8 (v8::Isolate* isolate,
+                                              HttpRequest* request) {
+  v8::Handle<v8::Object> headerFields = v8::Object::New(isolate);
+
+  HttpRequest::header_fields_t::KeyValue const* hBegin;
+  HttpRequest::header_fields_t::KeyValue const* hEnd;
+
+  for (request->headerFields().range(hBegin, hEnd);  hBegin < hEnd;  ++hBegin) {
+    if (hBegin->_key != nullptr) {
+      headerFields->ForceSet(TRI_V8_PAIR_STRING(hBegin->_key, (int) hBegin->_keyLength), TRI_V8_STRING(hBegin->_value));
+    }
+  }
+
+  headerFields->ForceSet(TRI_V8_ASCII_STRING("content-length"), TRI_V8_STD_STRING(StringUtils::itoa(request->contentLength())));
+
+  return headerFields;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the parameters of a request
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Object> ParametersCppToV8 (v8::Isolate* isolate,
+                                                 HttpRequest* request) {
+  v8::Handle<v8::Object> valuesObject = v8::Object::New(isolate);
+  HttpRequest::value_fields_t::KeyValue const* vBegin;
+  HttpRequest::value_fields_t::KeyValue const* vEnd;
+
+  for (request->valueFields().range(vBegin, vEnd);  vBegin < vEnd;  ++vBegin) {
+    if (vBegin->_key != nullptr) {
+      valuesObject->ForceSet(TRI_V8_PAIR_STRING(vBegin->_key, (int) vBegin->_keyLength), TRI_V8_STRING(vBegin->_value));
+    }
+  }
+
+  // copy request array parameter (a[]=1&a[]=2&...)
+  map<string, vector<char const*>* > arrayValues = request->arrayValues();
+
+  for (map<string, vector<char const*>* >::iterator i = arrayValues.begin();
+       i != arrayValues.end();  ++i) {
+    string const& k = i->first;
+    vector<char const*>* v = i->second;
+
+    v8::Handle<v8::Array> list = v8::Array::New(isolate, static_cast<int>(v->size()));
+
+    for (size_t i = 0; i < v->size(); ++i) {
+      list->Set((uint32_t) i, TRI_V8_ASCII_STRING(v->at(i)));
+    }
+
+    valuesObject->ForceSet(TRI_V8_STD_STRING(k), list);
+  }
+
+  return valuesObject;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the cookies of a request
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Object> CookiesCppToV8 (v8::Isolate* isolate,
+                                              HttpRequest* request) {
+  v8::Handle<v8::Object> cookiesObject = v8::Object::New(isolate);
+
+  HttpRequest::cookie_fields_t::KeyValue const* cBegin;
+  HttpRequest::cookie_fields_t::KeyValue const* cEnd;
+
+  for (request->cookieFields().range(cBegin, cEnd);  cBegin < cEnd;  ++cBegin) {
+    if (cBegin->_key != nullptr) {
+      cookiesObject->ForceSet(TRI_V8_PAIR_STRING(cBegin->_key, (int) cBegin->_keyLength),
+                              TRI_V8_STRING(cBegin->_value));
+    }
+  }
+
+  return cookiesObject;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the request of a request object, or nullptr if the action
+/// has already finished
+////////////////////////////////////////////////////////////////////////////////
+
+static HttpRequest* RequestOfObject (v8::Isolate* isolate,
+                                     v8::Handle<v8::Object> obj) {
+  v8::Handle<v8::Value> property = obj->Get(TRI_V8_ASCII_STRING("internals"));
+
+  if (! property->IsExternal()) {
+    return nullptr;
+  }
+
+  return static_cast<HttpRequest*>(v8::Handle<v8::External>::Cast(property)->Value());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts an attribute of the request on first access. the result
+/// replaces the accessor, so later accesses and modifications see a plain
+/// attribute
+////////////////////////////////////////////////////////////////////////////////
+
+static void LazyRequestGetter (v8::Local<v8::Name> property,
+                               v8::PropertyCallbackInfo<v8::Value> const& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  HttpRequest* request = RequestOfObject(isolate, args.Holder());
+
+  if (request == nullptr) {
+    TRI_V8_RETURN_UNDEFINED();
+  }
+
+  v8::Handle<v8::Value> result;
+
+  switch (static_cast<LazyRequestAttribute>(TRI_ObjectToInt64(args.Data()))) {
+    case LAZY_HEADERS:
+      result = HeadersCppToV8(isolate, request);
+      break;
+    case LAZY_PARAMETERS:
+      result = ParametersCppToV8(isolate, request);
+      break;
+    case LAZY_COOKIES:
+      result = CookiesCppToV8(isolate, request);
+      break;
+    case LAZY_BODY:
+      result = TRI_V8_PAIR_STRING(request->body(), (int) request->bodySize());
+      break;
+  }
+
+  args.Holder()->ForceSet(property, result);
+
+  TRI_V8_RETURN(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replaces a lazy attribute of the request without converting it
+////////////////////////////////////////////////////////////////////////////////
+
+static void LazyRequestSetter (v8::Local<v8::Name> property,
+                               v8::Local<v8::Value> value,
+                               v8::PropertyCallbackInfo<void> const& args) {
+  args.Holder()->ForceSet(property, value);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief convert a C++ HttpRequest to a V8 request object
 ////////////////////////////////////////////////////////////////////////////////
@@ -443,25 +599,23 @@ static v8::Handle<v8::Object> RequestCppToV8 (v8::Isolate* isolate,
   TRI_GET_GLOBAL_STRING(ClientKey);
   req->ForceSet(ClientKey, clientArray);
 
-  req->ForceSet(TRI_V8_ASCII_STRING("internals"), v8::External::New(isolate, request));
-
   // copy prefix
   string path = request->prefix();
   TRI_GET_GLOBAL_STRING(PrefixKey);
   req->ForceSet(PrefixKey, TRI_V8_STD_STRING(path));
 
-  // copy header fields
-  v8::Handle<v8::Object> headerFields = v8::Object::New(isolate);
-
-  map<string, string> const& headers = request->headers();
-  map<string, string>::const_iterator iter = headers.begin();
-
-  for (; iter != headers.end(); ++iter) {
-    headerFields->ForceSet(TRI_V8_STD_STRING(iter->first), TRI_V8_STD_STRING(iter->second));
-  }
+  // the header fields, parameters, cookies and the body are converted on
+  // first access only
+  v8::Handle<v8::Value> internals = v8::External::New(isolate, request);
+  req->ForceSet(TRI_V8_ASCII_STRING("internals"), internals);
 
   TRI_GET_GLOBAL_STRING(HeadersKey);
-  req->ForceSet(HeadersKey, headerFields);
+  req->SetAccessor(HeadersKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_HEADERS));
+  TRI_GET_GLOBAL_STRING(ParametersKey);
+  req->SetAccessor(ParametersKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_PARAMETERS));
+  TRI_GET_GLOBAL_STRING(CookiesKey);
+  req->SetAccessor(CookiesKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_COOKIES));
+
   TRI_GET_GLOBAL_STRING(RequestTypeKey);
   TRI_GET_GLOBAL_STRING(RequestBodyKey);
 
@@ -470,24 +624,21 @@ static v8::Handle<v8::Object> RequestCppToV8 (v8::Isolate* isolate,
     case HttpRequest::HTTP_REQUEST_POST: {
         TRI_GET_GLOBAL_STRING(PostConstant);
         req->ForceSet(RequestTypeKey, PostConstant);
-        req->ForceSet(RequestBodyKey, TRI_V8_PAIR_STRING(request->body(),
-                                                        (int) request->bodySize()));
+        req->SetAccessor(RequestBodyKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_BODY));
         break;
     }
 
     case HttpRequest::HTTP_REQUEST_PUT: {
         TRI_GET_GLOBAL_STRING(PutConstant);
         req->ForceSet(RequestTypeKey, PutConstant);
-        req->ForceSet(RequestBodyKey, TRI_V8_PAIR_STRING(request->body(),
-                                                        (int) request->bodySize()));
+        req->SetAccessor(RequestBodyKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_BODY));
         break;
     }
 
     case HttpRequest::HTTP_REQUEST_PATCH: {
         TRI_GET_GLOBAL_STRING(PatchConstant);
         req->ForceSet(RequestTypeKey, PatchConstant);
-        req->ForceSet(RequestBodyKey, TRI_V8_PAIR_STRING(request->body(),
-                                                        (int) request->bodySize()));
+        req->SetAccessor(RequestBodyKey, LazyRequestGetter, LazyRequestSetter, v8::Integer::New(isolate, LAZY_BODY));
         break;
     }
     case HttpRequest::HTTP_REQUEST_OPTIONS: {
@@ -513,50 +664,6 @@ static v8::Handle<v8::Object> RequestCppToV8 (v8::Isolate* isolate,
     }
   }
 
-  // copy request parameter
-  v8::Handle<v8::Object> valuesObject = v8::Object::New(isolate);
-  map<string, string> values = request->values();
-
-  for (map<string, string>::iterator i = values.begin();
-       i != values.end();
-       ++i) {
-    valuesObject->ForceSet(TRI_V8_STD_STRING(i->first), TRI_V8_STD_STRING(i->second));
-  }
-
-  // copy request array parameter (a[]=1&a[]=2&...)
-  map<string, vector<char const*>* > arrayValues = request->arrayValues();
-
-  for (map<string, vector<char const*>* >::iterator i = arrayValues.begin();
-       i != arrayValues.end();  ++i) {
-    string const& k = i->first;
-    vector<char const*>* v = i->second;
-
-    v8::Handle<v8::Array> list = v8::Array::New(isolate, static_cast<int>(v->size()));
-
-    for (size_t i = 0; i < v->size(); ++i) {
-      list->Set((uint32_t) i, TRI_V8_ASCII_STRING(v->at(i)));
-    }
-
-    valuesObject->ForceSet(TRI_V8_STD_STRING(k), list);
-  }
-
-  TRI_GET_GLOBAL_STRING(ParametersKey);
-  req->ForceSet(ParametersKey, valuesObject);
-
-  // copy cookies
-  v8::Handle<v8::Object> cookiesObject = v8::Object::New(isolate);
-
-  map<string, string> const& cookies = request->cookieValues();
-  iter = cookies.begin();
-
-  for (; iter != cookies.end(); ++iter) {
-    cookiesObject->ForceSet(TRI_V8_STD_STRING(iter->first),
-                            TRI_V8_STD_STRING(iter->second));
-  }
-
-  TRI_GET_GLOBAL_STRING(CookiesKey);
-  req->ForceSet(CookiesKey, cookiesObject);
-
   // determine API compatibility version
   int32_t compatibility = request->compatibility();
   TRI_GET_GLOBAL_STRING(CompatibilityKey);
@@ -786,7 +893,9 @@ static TRI_action_result_t ExecuteActionVocbase (TRI_vocbase_t* vocbase,
     errorCode = TRI_ERROR_INTERNAL;
   }
 
-  // invalidate request / response objects
+  // invalidate request / response objects. the request object may still be
+  // referenced from JavaScript, so it must not point to the request anymore
+  req->ForceSet(TRI_V8_ASCII_STRING("internals"), v8::External::New(isolate, nullptr));
   v8g->_currentRequest  = v8::Undefined(isolate);
   v8g->_currentResponse = v8::Undefined(isolate);
 
@@ -1020,6 +1129,10 @@ static void JS_RequestParts (const v8::FunctionCallbackInfo<v8::Value>& args) {
       v8::Handle<v8::External> e = v8::Handle<v8::External>::Cast(property);
       auto request = static_cast<triagens::rest::HttpRequest*>(e->Value());
 
+      if (request == nullptr) {
+        TRI_V8_RETURN_UNDEFINED();
+      }
+
       char const* beg = request->body();
       char const* end = beg + request->bodySize();
 
@@ -765,6 +765,411 @@ static void ModifyVocbaseColCoordinator (TRI_vocbase_col_t const* collection,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts an array of documents in one transaction
+///
+/// the documents are shaped first and then written into the WAL in one go.
+/// if any of them fails, none is inserted
+////////////////////////////////////////////////////////////////////////////////
+
+static void InsertDocumentsVocbaseCol (TRI_vocbase_col_t* col,
+                                       v8::Handle<v8::Array> const data,
+                                       InsertOptions const& options,
+                                       const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+  TRI_GET_GLOBALS();
+
+  uint32_t const n = data->Length();
+
+  // set the document keys
+  std::vector<std::unique_ptr<char[]>> keys;
+  keys.reserve(n);
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    v8::Handle<v8::Value> value = data->Get(i);
+
+    if (! value->IsObject() || value->IsArray()) {
+      TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
+    }
+
+    std::unique_ptr<char[]> key;
+    int res = ExtractDocumentKey(isolate, v8g, value->ToObject(), key);
+
+    if (res != TRI_ERROR_NO_ERROR && res != TRI_ERROR_ARANGO_DOCUMENT_KEY_MISSING) {
+      TRI_V8_THROW_EXCEPTION(res);
+    }
+
+    keys.emplace_back(std::move(key));
+  }
+
+  SingleCollectionWriteTransaction<UINT64_MAX> trx(new V8TransactionContext(true), col->_vocbase, col->_cid);
+
+  int res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  // fetch a barrier so nobody unlinks datafiles with the shapes & attributes we might
+  // need for these documents
+  if (trx.orderDitch(trx.trxCollection()) == nullptr) {
+    TRI_V8_THROW_EXCEPTION_MEMORY();
+  }
+
+  TRI_document_collection_t* document = trx.documentCollection();
+  TRI_memory_zone_t* zone = document->getShaper()->memoryZone();  // PROTECTED by trx from above
+
+  std::vector<TRI_doc_insert_t> documents;
+  documents.reserve(n);
+
+  bool converted = true;
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    TRI_shaped_json_t* shaped = TRI_ShapedJsonV8Object(isolate, data->Get(i), document->getShaper(), true);  // PROTECTED by trx from above
+
+    if (shaped == nullptr) {
+      converted = false;
+      res = TRI_errno();
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+      }
+      break;
+    }
+
+    documents.emplace_back(keys[i].get(), shaped, nullptr);
+  }
+
+  if (converted) {
+    res = trx.createDocuments(documents, options.waitForSync);
+
+    for (auto const& it : documents) {
+      if (res != TRI_ERROR_NO_ERROR) {
+        break;
+      }
+      res = it._errorCode;
+    }
+  }
+
+  res = trx.finish(res);
+
+  for (auto const& it : documents) {
+    TRI_FreeShapedJson(zone, const_cast<TRI_shaped_json_t*>(it._shaped));
+  }
+
+  if (! converted) {
+    TRI_V8_THROW_EXCEPTION_MESSAGE(res, "<data> cannot be converted into JSON shape");
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  if (options.silent) {
+    TRI_V8_RETURN_TRUE();
+  }
+
+  std::string const collectionName = trx.resolver()->getCollectionName(col->_cid);
+
+  v8::Handle<v8::Array> result = v8::Array::New(isolate, static_cast<int>(n));
+  TRI_GET_GLOBAL_STRING(_IdKey);
+  TRI_GET_GLOBAL_STRING(_RevKey);
+  TRI_GET_GLOBAL_STRING(_KeyKey);
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    TRI_doc_mptr_copy_t const& mptr = documents[i]._mptr;
+    TRI_ASSERT(mptr.getDataPtr() != nullptr);  // PROTECTED by trx here
+
+    char const* docKey = TRI_EXTRACT_MARKER_KEY(&mptr);  // PROTECTED by trx here
+
+    v8::Handle<v8::Object> item = v8::Object::New(isolate);
+    item->Set(_IdKey,  V8DocumentId(isolate, collectionName, docKey));
+    item->Set(_RevKey, V8RevisionId(isolate, mptr._rid));
+    item->Set(_KeyKey, TRI_V8_STRING(docKey));
+
+    result->Set(i, item);
+  }
+
+  TRI_V8_RETURN(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses an array of documents or document handles of a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static int ParseDocumentsOrDocumentHandles (TRI_vocbase_col_t const* col,
+                                            CollectionNameResolver const* resolver,
+                                            v8::Handle<v8::Array> const selectors,
+                                            std::vector<std::string>& keys,
+                                            std::vector<TRI_voc_rid_t>& revisions,
+                                            const v8::FunctionCallbackInfo<v8::Value>& args) {
+  uint32_t const n = selectors->Length();
+
+  keys.reserve(n);
+  revisions.reserve(n);
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    TRI_vocbase_col_t const* c = col;
+    std::unique_ptr<char[]> key;
+    TRI_voc_rid_t rid;
+
+    int res = ParseDocumentOrDocumentHandle(col->_vocbase, resolver, c, key, rid, selectors->Get(i), args);
+
+    if (key.get() == nullptr) {
+      return TRI_ERROR_ARANGO_DOCUMENT_HANDLE_BAD;
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    keys.emplace_back(key.get());
+    revisions.emplace_back(rid);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replaces or updates (patches) an array of documents in one
+/// transaction. if any of them fails, none is modified
+////////////////////////////////////////////////////////////////////////////////
+
+static void ModifyDocumentsVocbaseCol (TRI_vocbase_col_t const* col,
+                                       v8::Handle<v8::Array> const selectors,
+                                       v8::Handle<v8::Value> const values,
+                                       bool isPatch,
+                                       UpdateOptions const& options,
+                                       TRI_doc_update_policy_e policy,
+                                       const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+  TRI_GET_GLOBALS();
+
+  uint32_t const n = selectors->Length();
+
+  if (! values->IsArray() || v8::Handle<v8::Array>::Cast(values)->Length() != n) {
+    TRI_V8_THROW_EXCEPTION_PARAMETER("<data> must be an array with one object per document");
+  }
+
+  v8::Handle<v8::Array> data = v8::Handle<v8::Array>::Cast(values);
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    v8::Handle<v8::Value> value = data->Get(i);
+
+    if (! value->IsObject() || value->IsArray()) {
+      // we're only accepting "real" object documents
+      TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
+    }
+  }
+
+  V8ResolverGuard resolver(col->_vocbase);
+
+  std::vector<std::string> keys;
+  std::vector<TRI_voc_rid_t> revisions;
+
+  int res = ParseDocumentsOrDocumentHandles(col, resolver.getResolver(), selectors, keys, revisions, args);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  SingleCollectionWriteTransaction<UINT64_MAX> trx(new V8TransactionContext(true), col->_vocbase, col->_cid);
+  res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  if (trx.orderDitch(trx.trxCollection()) == nullptr) {
+    TRI_V8_THROW_EXCEPTION_MEMORY();
+  }
+
+  // one write lock for all documents. it also spans reading the old documents
+  // and modifying them, so each modification is atomic
+  trx.lockWrite();
+
+  TRI_document_collection_t* document = trx.documentCollection();
+  auto shaper = document->getShaper();  // PROTECTED by trx here
+  TRI_memory_zone_t* zone = shaper->memoryZone();
+
+  bool const isDBServer = ServerState::instance()->isDBServer();
+  std::string const cidString = StringUtils::itoa(document->_info._planId);
+
+  std::vector<TRI_doc_mptr_copy_t> mptrs(n);
+  std::vector<TRI_voc_rid_t> oldRevisions(n, 0);
+
+  for (uint32_t i = 0;  i < n && res == TRI_ERROR_NO_ERROR;  ++i) {
+    TRI_json_t* old = nullptr;
+
+    if (isPatch || isDBServer) {
+      // the old document is needed for the merge and to compare the shard keys
+      TRI_doc_mptr_copy_t mptr;
+      res = trx.read(&mptr, keys[i]);
+
+      if (res == TRI_ERROR_NO_ERROR && mptr.getDataPtr() == nullptr) {  // PROTECTED by trx here
+        res = TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        break;
+      }
+
+      TRI_shaped_json_t shaped;
+      TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, mptr.getDataPtr());  // PROTECTED by trx here
+      old = TRI_JsonShapedJson(shaper, &shaped);  // PROTECTED by trx here
+
+      if (old == nullptr) {
+        res = TRI_ERROR_OUT_OF_MEMORY;
+        break;
+      }
+    }
+
+    if (old == nullptr) {
+      // a plain replace converts the V8 object directly
+      TRI_shaped_json_t* shaped = TRI_ShapedJsonV8Object(isolate, data->Get(i), shaper, true);  // PROTECTED by trx here
+
+      if (shaped == nullptr) {
+        res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+        break;
+      }
+
+      res = trx.updateDocument(keys[i], &mptrs[i], shaped, policy, options.waitForSync, revisions[i], &oldRevisions[i]);
+
+      TRI_FreeShapedJson(zone, shaped);
+    }
+    else {
+      TRI_json_t* json = TRI_ObjectToJson(isolate, data->Get(i));
+
+      if (json == nullptr) {
+        TRI_FreeJson(zone, old);
+        res = TRI_ERROR_OUT_OF_MEMORY;
+        break;
+      }
+
+      if (isDBServer && shardKeysChanged(col->_dbName, cidString, old, json, isPatch)) {
+        res = TRI_ERROR_CLUSTER_MUST_NOT_CHANGE_SHARDING_ATTRIBUTES;
+      }
+      else if (isPatch) {
+        TRI_json_t* patchedJson = TRI_MergeJson(TRI_UNKNOWN_MEM_ZONE, old, json, ! options.keepNull, options.mergeObjects);
+
+        if (patchedJson == nullptr) {
+          res = TRI_ERROR_OUT_OF_MEMORY;
+        }
+        else {
+          res = trx.updateDocument(keys[i], &mptrs[i], patchedJson, policy, options.waitForSync, revisions[i], &oldRevisions[i]);
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, patchedJson);
+        }
+      }
+      else {
+        res = trx.updateDocument(keys[i], &mptrs[i], json, policy, options.waitForSync, revisions[i], &oldRevisions[i]);
+      }
+
+      TRI_FreeJson(zone, old);
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+  }
+
+  res = trx.finish(res);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  if (options.silent) {
+    TRI_V8_RETURN_TRUE();
+  }
+
+  std::string const collectionName = trx.resolver()->getCollectionName(col->_cid);
+
+  v8::Handle<v8::Array> result = v8::Array::New(isolate, static_cast<int>(n));
+  TRI_GET_GLOBAL_STRING(_IdKey);
+  TRI_GET_GLOBAL_STRING(_RevKey);
+  TRI_GET_GLOBAL_STRING(_OldRevKey);
+  TRI_GET_GLOBAL_STRING(_KeyKey);
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    TRI_ASSERT(mptrs[i].getDataPtr() != nullptr);  // PROTECTED by trx here
+
+    char const* docKey = TRI_EXTRACT_MARKER_KEY(&mptrs[i]);  // PROTECTED by trx here
+
+    v8::Handle<v8::Object> item = v8::Object::New(isolate);
+    item->Set(_IdKey,     V8DocumentId(isolate, collectionName, docKey));
+    item->Set(_RevKey,    V8RevisionId(isolate, mptrs[i]._rid));
+    item->Set(_OldRevKey, V8RevisionId(isolate, oldRevisions[i]));
+    item->Set(_KeyKey,    TRI_V8_STRING(docKey));
+
+    result->Set(i, item);
+  }
+
+  TRI_V8_RETURN(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an array of documents in one transaction
+///
+/// returns one boolean per document, which is false for a document that was
+/// not found when overwrite is set. any other error removes none of them
+////////////////////////////////////////////////////////////////////////////////
+
+static void RemoveDocumentsVocbaseCol (TRI_vocbase_col_t const* col,
+                                       v8::Handle<v8::Array> const selectors,
+                                       RemoveOptions const& options,
+                                       TRI_doc_update_policy_e policy,
+                                       const v8::FunctionCallbackInfo<v8::Value>& args) {
+  v8::Isolate* isolate = args.GetIsolate();
+  v8::HandleScope scope(isolate);
+
+  uint32_t const n = selectors->Length();
+
+  V8ResolverGuard resolver(col->_vocbase);
+
+  std::vector<std::string> keys;
+  std::vector<TRI_voc_rid_t> revisions;
+
+  int res = ParseDocumentsOrDocumentHandles(col, resolver.getResolver(), selectors, keys, revisions, args);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  SingleCollectionWriteTransaction<UINT64_MAX> trx(new V8TransactionContext(true), col->_vocbase, col->_cid);
+  res = trx.begin();
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  trx.lockWrite();
+
+  v8::Handle<v8::Array> result = v8::Array::New(isolate, static_cast<int>(n));
+
+  for (uint32_t i = 0;  i < n;  ++i) {
+    TRI_voc_rid_t actualRevision = 0;
+    res = trx.deleteDocument(keys[i], policy, options.waitForSync, revisions[i], &actualRevision);
+
+    if (res == TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND && policy == TRI_DOC_UPDATE_LAST_WRITE) {
+      res = TRI_ERROR_NO_ERROR;
+      result->Set(i, v8::False(isolate));
+    }
+    else if (res == TRI_ERROR_NO_ERROR) {
+      result->Set(i, v8::True(isolate));
+    }
+    else {
+      break;
+    }
+  }
+
+  res = trx.finish(res);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_V8_THROW_EXCEPTION(res);
+  }
+
+  TRI_V8_RETURN(result);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief replaces a document
 ////////////////////////////////////////////////////////////////////////////////
@@ -784,8 +1189,9 @@ static void ReplaceVocbaseCol (bool useCollection,
     TRI_V8_THROW_EXCEPTION_USAGE("replace(<document>, <data>, {overwrite: booleanValue, waitForSync: booleanValue})");
   }
 
-  // we're only accepting "real" object documents
-  if (! args[1]->IsObject() || args[1]->IsArray()) {
+  // we're only accepting "real" object documents, or arrays of documents
+  // together with arrays of document handles
+  if (! args[1]->IsObject() || args[1]->IsArray() != args[0]->IsArray()) {
     TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID);
   }
 
@@ -841,6 +1247,16 @@ static void ReplaceVocbaseCol (bool useCollection,
     TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
   }
 
+  if (useCollection && args[0]->IsArray()) {
+    // db.collection.replace(<documents>, <data>)
+    if (ServerState::instance()->isCoordinator()) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_NOT_IMPLEMENTED, "arrays of documents are not supported in a cluster");
+    }
+
+    ModifyDocumentsVocbaseCol(col, args[0].As<v8::Array>(), args[1], false, options, policy, args);
+    return;
+  }
+
   V8ResolverGuard resolver(vocbase);
   int err = ParseDocumentOrDocumentHandle(vocbase, resolver.getResolver(), col, key, rid, args[0], args);
 
@@ -996,11 +1412,16 @@ static void InsertVocbaseCol (TRI_vocbase_col_t* col,
     options.waitForSync = ExtractWaitForSync(args, 2);
   }
 
+  if (args[0]->IsArray()) {
+    InsertDocumentsVocbaseCol(col, args[0].As<v8::Array>(), options, args);
+    return;
+  }
+
   // set document key
   std::unique_ptr<char[]> key;
   int res;
 
-  if (args[0]->IsObject() && ! args[0]->IsArray()) {
+  if (args[0]->IsObject()) {
     res = ExtractDocumentKey(isolate, v8g, args[0]->ToObject(), key);
 
     if (res != TRI_ERROR_NO_ERROR && res != TRI_ERROR_ARANGO_DOCUMENT_KEY_MISSING) {
@@ -1147,6 +1568,16 @@ static void UpdateVocbaseCol (bool useCollection,
     TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
   }
 
+  if (useCollection && args[0]->IsArray()) {
+    // db.collection.update(<documents>, <data>)
+    if (ServerState::instance()->isCoordinator()) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_NOT_IMPLEMENTED, "arrays of documents are not supported in a cluster");
+    }
+
+    ModifyDocumentsVocbaseCol(col, args[0].As<v8::Array>(), args[1], true, options, policy, args);
+    return;
+  }
+
   V8ResolverGuard resolver(vocbase);
   int err = ParseDocumentOrDocumentHandle(vocbase, resolver.getResolver(), col, key, rid, args[0], args);
 
@@ -1419,6 +1850,16 @@ static void RemoveVocbaseCol (bool useCollection,
     TRI_V8_THROW_EXCEPTION(TRI_ERROR_ARANGO_DATABASE_NOT_FOUND);
   }
 
+  if (useCollection && args[0]->IsArray()) {
+    // db.collection.remove(<documents>)
+    if (ServerState::instance()->isCoordinator()) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_NOT_IMPLEMENTED, "arrays of documents are not supported in a cluster");
+    }
+
+    RemoveDocumentsVocbaseCol(col, args[0].As<v8::Array>(), options, policy, args);
+    return;
+  }
+
   V8ResolverGuard resolver(vocbase);
   int err = ParseDocumentOrDocumentHandle(vocbase, resolver.getResolver(), col, key, rid, args[0], args);
 
@@ -1742,6 +2183,11 @@ static TRI_doc_collection_info_t* GetFigures (TRI_vocbase_col_t* collection) {
 /// * *indexes.count*: The total number of indexes defined for the
 ///   collection, including the pre-defined indexes (e.g. primary index).
 /// * *indexes.size*: The total memory allocated for indexes in bytes.
+/// * *documentReferences.count*: The number of in-memory document references
+///   (master pointers) in use by the collection.
+/// * *documentReferences.size*: The total memory allocated for document
+///   references in bytes, including unused references in the allocated
+///   blocks. This memory is also contained in *indexes.size*.
 /// * *maxTick*: The tick of the last marker that was stored in a journal
 ///   of the collection. This might be 0 if the collection does not yet have
 ///   a journal.
@@ -1861,7 +2307,16 @@ static void JS_FiguresVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& arg
   indexes->Set(TRI_V8_ASCII_STRING("count"),     v8::Number::New(isolate, (double) info->_numberIndexes));
   indexes->Set(TRI_V8_ASCII_STRING("size"),      v8::Number::New(isolate, (double) info->_sizeIndexes));
 
+  v8::Handle<v8::Object> references = v8::Object::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("documentReferences"), references);
+  references->Set(TRI_V8_ASCII_STRING("count"),  v8::Number::New(isolate, (double) info->_numberDocumentReferences));
+  references->Set(TRI_V8_ASCII_STRING("size"),   v8::Number::New(isolate, (double) info->_sizeDocumentReferences));
+
   result->Set(TRI_V8_ASCII_STRING("lastTick"),   V8TickId(isolate, info->_tickMax));
+  v8::Handle<v8::Object> expired = v8::Object::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("expired"),    expired);
+  expired->Set(TRI_V8_ASCII_STRING("count"),     v8::Number::New(isolate, (double) info->_numberExpired));
+
   result->Set(TRI_V8_ASCII_STRING("uncollectedLogfileEntries"), v8::Number::New(isolate, (double) info->_uncollectedLogfileEntries));
 
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, info);
@@ -2017,6 +2472,10 @@ static void JS_PlanIdVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& args
 ///   * *offset*: initial offset value for *autoincrement* key generator.
 ///     Not used for other key generator types.
 ///
+/// * *stringDictionary* (optional): the string values that are stored as
+///   dictionary codes in this collection. Only present if the collection
+///   was created with a string dictionary.
+///
 /// * *indexBuckets*: number of buckets into which indexes using a hash
 ///   table are split. The default is 16 and this number has to be a
 ///   power of 2 and less than or equal to 1024. 
@@ -2056,7 +2515,8 @@ static void JS_PlanIdVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& args
 /// then size of the largest document already stored in the collection.
 ///
 /// **Note**: some other collection properties, such as *type*, *isVolatile*,
-/// or *keyOptions* cannot be changed once the collection is created.
+/// *keyOptions* or *stringDictionary* cannot be changed once the collection
+/// is created.
 ///
 /// @EXAMPLES
 ///
@@ -2344,6 +2804,11 @@ static void JS_PropertiesVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>&
   else {
     result->Set(KeyOptionsKey, v8::Array::New(isolate));
   }
+
+  if (base->_info._stringDictionary != nullptr) {
+    result->Set(TRI_V8_ASCII_STRING("stringDictionary"), TRI_ObjectJson(isolate, base->_info._stringDictionary));
+  }
+
   TRI_GET_GLOBAL_STRING(WaitForSyncKey);
   result->Set(WaitForSyncKey, v8::Boolean::New(isolate, base->_info._waitForSync));
 
@@ -2384,6 +2849,13 @@ static void JS_PropertiesVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>&
 /// As before. Instead of document a *document-handle* can be passed as
 /// first argument.
 ///
+/// `collection.remove(array, options)`
+///
+/// Removes the documents or document handles in the *array* in a single
+/// transaction and returns one boolean per element. If one of them cannot be
+/// removed, none of them is. With *overwrite*, documents that do not exist
+/// are ignored and reported as *false*.
+///
 /// @EXAMPLES
 ///
 /// Remove a document:
@@ -2542,6 +3014,13 @@ static void JS_RenameVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& args
 /// As before. Instead of document a *document-handle* can be passed as
 /// first argument.
 ///
+/// `collection.replace(array, dataArray, options)`
+///
+/// Replaces the documents or document handles in the *array* with the
+/// element at the same position of *dataArray*, in a single transaction. The
+/// result is an array with one result per document. If one of them cannot be
+/// replaced, none of them is.
+///
 /// @EXAMPLES
 ///
 /// Create and update a document:
@@ -2756,6 +3235,13 @@ static void JS_RotateVocbaseCol (const v8::FunctionCallbackInfo<v8::Value>& args
 /// As before. Instead of document a document-handle can be passed as
 /// first argument.
 ///
+/// `collection.update(array, dataArray, options)`
+///
+/// Updates the documents or document handles in the *array* with the element
+/// at the same position of *dataArray*, in a single transaction. The result
+/// is an array with one result per document. If one of them cannot be
+/// updated, none of them is.
+///
 /// *Examples*
 ///
 /// Create and update a document:
@@ -3224,6 +3710,14 @@ static void InsertEdgeColCoordinator (TRI_vocbase_col_t* collection,
 ///
 /// Note: since ArangoDB 2.2, *insert* is an alias for *save*.
 ///
+/// `collection.insert(array)`
+///
+/// Creates one document per element of the *array* in a single transaction
+/// and returns an array with the *_id*, *_rev* and *_key* of each of them.
+/// If one of the documents cannot be created, none of them is. This is much
+/// faster than calling *insert* for every document. Edge collections and
+/// collections in a cluster do not support arrays.
+///
 /// @EXAMPLES
 ///
 /// @EXAMPLE_ARANGOSH_OUTPUT{documentsCollectionInsert}
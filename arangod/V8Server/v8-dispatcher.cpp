@@ -351,6 +351,41 @@ static void JS_GetTask (const v8::FunctionCallbackInfo<v8::Value>& args) {
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of open connections per scheduler thread
+///
+/// @FUN{internal.schedulerStatistics()}
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_SchedulerStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  if (args.Length() != 0) {
+    TRI_V8_THROW_EXCEPTION_USAGE("schedulerStatistics()");
+  }
+
+  if (GlobalScheduler == nullptr) {
+    TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_INTERNAL, "no scheduler found");
+  }
+
+  std::vector<uint64_t> const connections = GlobalScheduler->connectionsPerThread();
+
+  v8::Handle<v8::Array> list = v8::Array::New(isolate, (int) connections.size());
+  uint32_t i = 0;
+
+  for (auto const& it : connections) {
+    list->Set(i++, v8::Number::New(isolate, (double) it));
+  }
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+  result->Set(TRI_V8_ASCII_STRING("threads"), v8::Number::New(isolate, (double) GlobalScheduler->numberOfThreads()));
+  result->Set(TRI_V8_ASCII_STRING("connections"), list);
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -381,6 +416,7 @@ void TRI_InitV8Dispatcher (v8::Isolate* isolate,
     TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_REGISTER_TASK"), JS_RegisterTask);
     TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_UNREGISTER_TASK"), JS_UnregisterTask);
     TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_GET_TASK"), JS_GetTask);
+    TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_SCHEDULER_STATISTICS"), JS_SchedulerStatistics);
   }
   else {
     LOG_ERROR("cannot initialize tasks, scheduler or dispatcher unknown");
@@ -1419,6 +1419,10 @@ template<bool WR, bool WD> static bool ChecksumCalculator (TRI_doc_mptr_t const*
 /// actual document data is also checksummed. Including the document data in
 /// checksumming will make the calculation slower, but is more accurate.
 ///
+/// The checksums of the keys and revisions of a document collection are
+/// maintained with every write, so calling *checksum* without *withData*
+/// on a document collection does not scan the collection.
+///
 /// **Note**: this method is not available in a cluster.
 ///
 /// @endDocuBlock
@@ -1475,7 +1479,19 @@ static void JS_ChecksumCollection (const v8::FunctionCallbackInfo<v8::Value>& ar
   // get last tick
   string const rid = StringUtils::itoa(document->_info._revision);
 
-  if (withData) {
+  if (! withData &&
+      document->_keyTree != nullptr &&
+      document->_info._type == TRI_COL_TYPE_DOCUMENT) {
+    // the checksums of keys and revisions are maintained on every write.
+    // edges also checksum the names of their vertex collections, which can
+    // change with a rename, so they are still calculated with a scan
+    helper._checksum = document->_keysChecksum;
+
+    if (withRevisions) {
+      helper._checksum += document->_revisionsChecksum;
+    }
+  }
+  else if (withData) {
     TRI_InitStringBuffer(&helper._buffer, TRI_CORE_MEM_ZONE);
 
     if (withRevisions) {
@@ -61,6 +61,10 @@ static void JS_StateLoggerReplication (const v8::FunctionCallbackInfo<v8::Value>
   state->Set(TRI_V8_ASCII_STRING("running"),     v8::True(isolate));
   state->Set(TRI_V8_ASCII_STRING("lastLogTick"), V8TickId(isolate, s.lastTick));
   state->Set(TRI_V8_ASCII_STRING("totalEvents"), v8::Number::New(isolate, (double) s.numEvents));
+  state->Set(TRI_V8_ASCII_STRING("totalSyncs"),  v8::Number::New(isolate, (double) s.numSyncs));
+  state->Set(TRI_V8_ASCII_STRING("totalSyncedEvents"), v8::Number::New(isolate, (double) s.numSyncedSlots));
+  state->Set(TRI_V8_ASCII_STRING("pendingCollectorOperations"), v8::Number::New(isolate, (double) s.numPendingCollectorOperations));
+  state->Set(TRI_V8_ASCII_STRING("uncollectedLogfiles"), v8::Number::New(isolate, (double) s.numUncollectedLogfiles));
   state->Set(TRI_V8_ASCII_STRING("time"),        TRI_V8_STD_STRING(s.timeString));
   result->Set(TRI_V8_ASCII_STRING("state"),      state);
 
@@ -266,6 +270,12 @@ static void JS_SynchronizeReplication (const v8::FunctionCallbackInfo<v8::Value>
       config._chunkSize = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("chunkSize")), true);
     }
   }
+
+  if (object->Has(TRI_V8_ASCII_STRING("syncParallelism"))) {
+    if (object->Get(TRI_V8_ASCII_STRING("syncParallelism"))->IsNumber()) {
+      config._syncParallelism = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("syncParallelism")), true);
+    }
+  }
  
   if (object->Has(TRI_V8_ASCII_STRING("includeSystem"))) {
     if (object->Get(TRI_V8_ASCII_STRING("includeSystem"))->IsBoolean()) {
@@ -488,6 +498,18 @@ static void JS_ConfigureApplierReplication (const v8::FunctionCallbackInfo<v8::V
       }
     }
 
+    if (object->Has(TRI_V8_ASCII_STRING("syncParallelism"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("syncParallelism"))->IsNumber()) {
+        config._syncParallelism = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("syncParallelism")), true);
+      }
+    }
+
+    if (object->Has(TRI_V8_ASCII_STRING("applyParallelism"))) {
+      if (object->Get(TRI_V8_ASCII_STRING("applyParallelism"))->IsNumber()) {
+        config._applyParallelism = TRI_ObjectToUInt64(object->Get(TRI_V8_ASCII_STRING("applyParallelism")), true);
+      }
+    }
+
     if (object->Has(TRI_V8_ASCII_STRING("autoStart"))) {
       if (object->Get(TRI_V8_ASCII_STRING("autoStart"))->IsBoolean()) {
         config._autoStart = TRI_ObjectToBoolean(object->Get(TRI_V8_ASCII_STRING("autoStart")));
@@ -208,12 +208,33 @@ static int FillShapeValueNumber (VocShaper* shaper,
 
 static int FillShapeValueString (VocShaper* shaper,
                                  TRI_shape_value_t* dst,
-                                 v8::Handle<v8::String> const json) {
+                                 v8::Handle<v8::String> const json,
+                                 bool create) {
   char* ptr;
 
   TRI_Utf8ValueNFC str(TRI_UNKNOWN_MEM_ZONE, json);
 
-  if (*str == nullptr) {
+  TRI_shape_sid_t sid;
+  TRI_shape_dictionary_code_t code;
+
+  if (shaper->lookupDictionaryCode(*str == nullptr ? "" : *str,
+                                   *str == nullptr ? 0 : str.length(),
+                                   create,
+                                   &sid,
+                                   &code)) {
+    dst->_type = TRI_SHAPE_DICTIONARY_STRING;
+    dst->_sid = sid;
+    dst->_fixedSized = true;
+    dst->_size = sizeof(TRI_shape_dictionary_code_t);
+    dst->_value = (ptr = (char*) TRI_Allocate(shaper->memoryZone(), dst->_size, false));
+
+    if (dst->_value == nullptr) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    * ((TRI_shape_dictionary_code_t*) ptr) = code;
+  }
+  else if (*str == nullptr) {
     // empty string
     dst->_type = TRI_SHAPE_SHORT_STRING;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_SHORT_STRING;
@@ -874,11 +895,11 @@ static int FillShapeValueJson (v8::Isolate* isolate,
   }
 
   if (json->IsString()) {
-    return FillShapeValueString(shaper, dst, json->ToString());
+    return FillShapeValueString(shaper, dst, json->ToString(), create);
   }
 
   if (json->IsStringObject()) {
-    return FillShapeValueString(shaper, dst, v8::Handle<v8::StringObject>::Cast(json)->ValueOf());
+    return FillShapeValueString(shaper, dst, v8::Handle<v8::StringObject>::Cast(json)->ValueOf(), create);
   }
 
   else if (json->IsArray()) {
@@ -897,7 +918,7 @@ static int FillShapeValueJson (v8::Isolate* isolate,
         v8::Handle<v8::Value> result = toJson->Call(o, 0, &args);
 
         if (! result.IsEmpty()) {
-          return FillShapeValueString(shaper, dst, result->ToString());
+          return FillShapeValueString(shaper, dst, result->ToString(), create);
         }
       }
     }
@@ -1000,6 +1021,29 @@ static v8::Handle<v8::Value> JsonShapeDataLongString (v8::Isolate* isolate,
   return TRI_V8_PAIR_STRING(data, l - 1);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a data dictionary string blob into a json object
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Value> JsonShapeDataDictionaryString (v8::Isolate* isolate,
+                                                            VocShaper* shaper,
+                                                            TRI_shape_t const* shape,
+                                                            char const* data,
+                                                            size_t size) {
+  char const* value;
+  size_t length;
+
+  if (! TRI_ValueDictionaryStringShape((TRI_dictionary_string_shape_t const*) shape,
+                                       * (TRI_shape_dictionary_code_t const*) data,
+                                       &value,
+                                       &length)) {
+    v8::EscapableHandleScope scope(isolate);
+    return scope.Escape<v8::Value>(v8::Null(isolate));
+  }
+
+  return TRI_V8_PAIR_STRING(value, length);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief merges a data array blob into an existing json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -1421,6 +1465,9 @@ static v8::Handle<v8::Value> JsonShapeData (v8::Isolate* isolate,
     case TRI_SHAPE_LONG_STRING:
       return JsonShapeDataLongString(isolate, shaper, shape, data, size);
 
+    case TRI_SHAPE_DICTIONARY_STRING:
+      return JsonShapeDataDictionaryString(isolate, shaper, shape, data, size);
+
     case TRI_SHAPE_ARRAY:
       return JsonShapeDataArray(isolate, shaper, shape, data, size);
 
@@ -32,6 +32,7 @@
 #include "Basics/StringUtils.h"
 #include "Statistics/statistics.h"
 #include "V8/v8-conv.h"
+#include "V8Server/ApplicationV8.h"
 #include "V8/v8-globals.h"
 #include "V8/v8-utils.h"
 
@@ -82,6 +83,49 @@ static void FillDistribution (v8::Isolate* isolate,
   list->Set(name, result);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the percentiles of a histogram of microseconds, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+static void FillHistogram (v8::Isolate* isolate,
+                           v8::Handle<v8::Object> list,
+                           v8::Handle<v8::String> name,
+                           StatisticsHistogram const& histogram) {
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  double const count = (double) histogram._count;
+
+  result->Set(TRI_V8_ASCII_STRING("count"), v8::Number::New(isolate, count));
+
+  if (histogram._count > 0) {
+    result->Set(TRI_V8_ASCII_STRING("min"),  v8::Number::New(isolate, histogram._min / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("max"),  v8::Number::New(isolate, histogram._max / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("mean"), v8::Number::New(isolate, histogram._total / count / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("p50"),  v8::Number::New(isolate, histogram.percentile(0.5) / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("p90"),  v8::Number::New(isolate, histogram.percentile(0.9) / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("p99"),  v8::Number::New(isolate, histogram.percentile(0.99) / 1000000.0));
+    result->Set(TRI_V8_ASCII_STRING("p999"), v8::Number::New(isolate, histogram.percentile(0.999) / 1000000.0));
+  }
+
+  list->Set(name, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fills the request time histograms of a method or an endpoint
+////////////////////////////////////////////////////////////////////////////////
+
+static v8::Handle<v8::Object> RequestHistograms (v8::Isolate* isolate,
+                                                 TRI_request_histograms_t const& histograms) {
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  FillHistogram(isolate, result, TRI_V8_ASCII_STRING("totalTime"),   histograms._totalTime);
+  FillHistogram(isolate, result, TRI_V8_ASCII_STRING("requestTime"), histograms._requestTime);
+  FillHistogram(isolate, result, TRI_V8_ASCII_STRING("queueTime"),   histograms._queueTime);
+  FillHistogram(isolate, result, TRI_V8_ASCII_STRING("ioTime"),      histograms._ioTime);
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      JS functions
 // -----------------------------------------------------------------------------
@@ -148,6 +192,41 @@ static void JS_ClientStatistics (const v8::FunctionCallbackInfo<v8::Value>& args
   FillDistribution(isolate, result, TRI_V8_ASCII_STRING("bytesSent"),     bytesSent);
   FillDistribution(isolate, result, TRI_V8_ASCII_STRING("bytesReceived"), bytesReceived);
 
+  vector<StatisticsDistribution> queueTimes;
+
+  TRI_FillQueueTimeStatistics(queueTimes);
+
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("queueTimeHigh"),   queueTimes[0]);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("queueTimeNormal"), queueTimes[1]);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("queueTimeLow"),    queueTimes[2]);
+
+  TRI_request_histograms_t all;
+  vector<TRI_request_histograms_t> methods;
+  vector<TRI_request_histograms_t> endpoints;
+
+  TRI_FillRequestHistograms(all, methods, endpoints);
+
+  v8::Handle<v8::Object> percentiles = v8::Object::New(isolate);
+  percentiles->Set(TRI_V8_ASCII_STRING("all"), RequestHistograms(isolate, all));
+
+  v8::Handle<v8::Object> byMethod = v8::Object::New(isolate);
+
+  for (auto const& it : methods) {
+    byMethod->Set(TRI_V8_STD_STRING(it._name), RequestHistograms(isolate, it));
+  }
+
+  percentiles->Set(TRI_V8_ASCII_STRING("methods"), byMethod);
+
+  v8::Handle<v8::Object> byEndpoint = v8::Object::New(isolate);
+
+  for (auto const& it : endpoints) {
+    byEndpoint->Set(TRI_V8_STD_STRING(it._name), RequestHistograms(isolate, it));
+  }
+
+  percentiles->Set(TRI_V8_ASCII_STRING("endpoints"), byEndpoint);
+
+  result->Set(TRI_V8_ASCII_STRING("percentiles"), percentiles);
+
   TRI_V8_RETURN(result);
   TRI_V8_TRY_CATCH_END
 }
@@ -186,6 +265,87 @@ static void JS_HttpStatistics (const v8::FunctionCallbackInfo<v8::Value>& args)
   TRI_V8_TRY_CATCH_END
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current replication applier statistics
+///
+/// the distributions cover the batches of the continuous replication appliers
+/// of all databases: the time to fetch a batch from the master, the time to
+/// apply it and its size in bytes
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_ReplicationStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  StatisticsDistribution fetchTime;
+  StatisticsDistribution applyTime;
+  StatisticsDistribution bytesReceived;
+
+  TRI_FillReplicationStatistics(fetchTime, applyTime, bytesReceived);
+
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("fetchTime"),     fetchTime);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("applyTime"),     applyTime);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("bytesReceived"), bytesReceived);
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current V8 context statistics
+///
+/// the distributions cover the time requests waited in enterContext until a
+/// V8 context became available, and the time contexts spent in garbage
+/// collection. "contexts" lists the state and the heap sizes of every context
+////////////////////////////////////////////////////////////////////////////////
+
+static void JS_V8ContextStatistics (const v8::FunctionCallbackInfo<v8::Value>& args) {
+  TRI_V8_TRY_CATCH_BEGIN(isolate);
+  v8::HandleScope scope(isolate);
+
+  v8::Handle<v8::Object> result = v8::Object::New(isolate);
+
+  StatisticsDistribution waitTime;
+  StatisticsDistribution backgroundWaitTime;
+  StatisticsDistribution gcTime;
+
+  TRI_FillV8ContextStatistics(waitTime, backgroundWaitTime, gcTime);
+
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("waitTime"),           waitTime);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("backgroundWaitTime"), backgroundWaitTime);
+  FillDistribution(isolate, result, TRI_V8_ASCII_STRING("gcTime"),             gcTime);
+
+  TRI_GET_GLOBALS();
+  v8::Handle<v8::Array> contexts = v8::Array::New(isolate);
+
+  if (v8g->_applicationV8 != nullptr) {
+    uint32_t i = 0;
+
+    for (auto const& it : v8g->_applicationV8->contextStatistics()) {
+      v8::Handle<v8::Object> context = v8::Object::New(isolate);
+
+      context->Set(TRI_V8_ASCII_STRING("id"),                 v8::Number::New(isolate, (double) it._id));
+      context->Set(TRI_V8_ASCII_STRING("state"),              TRI_V8_ASCII_STRING(it._state));
+      context->Set(TRI_V8_ASCII_STRING("usedHeapSize"),       v8::Number::New(isolate, (double) it._usedHeapSize));
+      context->Set(TRI_V8_ASCII_STRING("totalHeapSize"),      v8::Number::New(isolate, (double) it._totalHeapSize));
+      context->Set(TRI_V8_ASCII_STRING("heapSizeLimit"),      v8::Number::New(isolate, (double) it._heapSizeLimit));
+      context->Set(TRI_V8_ASCII_STRING("usedHeapSizeAfterGc"), v8::Number::New(isolate, (double) it._usedHeapSizeAfterGc));
+      context->Set(TRI_V8_ASCII_STRING("executions"),         v8::Number::New(isolate, (double) it._numExecutions));
+      context->Set(TRI_V8_ASCII_STRING("gcRuns"),             v8::Number::New(isolate, (double) it._numGcRuns));
+      context->Set(TRI_V8_ASCII_STRING("lastGcTime"),         v8::Number::New(isolate, it._lastGcDuration));
+
+      contexts->Set(i++, context);
+    }
+  }
+
+  result->Set(TRI_V8_ASCII_STRING("contexts"), contexts);
+
+  TRI_V8_RETURN(result);
+  TRI_V8_TRY_CATCH_END
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                             module initialization
 // -----------------------------------------------------------------------------
@@ -205,11 +365,15 @@ void TRI_InitV8Statistics (v8::Isolate* isolate,
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_CLIENT_STATISTICS"), JS_ClientStatistics);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_HTTP_STATISTICS"), JS_HttpStatistics);
   TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_SERVER_STATISTICS"), JS_ServerStatistics);
+  TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_REPLICATION_STATISTICS"), JS_ReplicationStatistics);
+  TRI_AddGlobalFunctionVocbase(isolate, context, TRI_V8_ASCII_STRING("SYS_V8_CONTEXT_STATISTICS"), JS_V8ContextStatistics);
 
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("CONNECTION_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_ConnectionTimeDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("REQUEST_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_RequestTimeDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("BYTES_SENT_DISTRIBUTION"), DistributionList(isolate, TRI_BytesSentDistributionVectorStatistics));
   TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("BYTES_RECEIVED_DISTRIBUTION"), DistributionList(isolate, TRI_BytesReceivedDistributionVectorStatistics));
+  TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("REPLICATION_BYTES_DISTRIBUTION"), DistributionList(isolate, TRI_ReplicationBytesDistributionVectorStatistics));
+  TRI_AddGlobalVariableVocbase(isolate, context, TRI_V8_ASCII_STRING("V8_CONTEXT_WAIT_TIME_DISTRIBUTION"), DistributionList(isolate, TRI_V8ContextWaitTimeDistributionVectorStatistics));
 }
 
 // -----------------------------------------------------------------------------
@@ -49,14 +49,24 @@ struct KeySpaceElement {
   
   KeySpaceElement (char const* k,
                    size_t length,
-                   TRI_json_t* json) 
+                   TRI_json_t* value,
+                   double expires = 0.0) 
     : key(nullptr),
-      json(json) {
+      json(nullptr),
+      number(0.0),
+      expires(expires) {
+
+    if (value == nullptr) {
+      THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+    }
 
     key = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, k, length);
     if (key == nullptr) {
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, value);
       THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
     }
+
+    setValue(value);
   }
 
   ~KeySpaceElement () {
@@ -68,49 +78,130 @@ struct KeySpaceElement {
     }
   }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the value, taking over the json
+///
+/// numbers are not kept as json, but in an atomic, so that they can be
+/// incremented while other threads read the keyspace
+////////////////////////////////////////////////////////////////////////////////
+
   void setValue (TRI_json_t* value) {
     if (json != nullptr) {
       TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
       json = nullptr;
     }
-    json = value;
+
+    if (TRI_IsNumberJson(value)) {
+      number.store(value->_value._number, std::memory_order_relaxed);
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, value);
+    }
+    else {
+      json = value;
+    }
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the value as json. for numbers, the json is built in the
+/// buffer provided
+////////////////////////////////////////////////////////////////////////////////
+
+  TRI_json_t const* value (TRI_json_t& buffer) const {
+    if (json != nullptr) {
+      return json;
+    }
+
+    TRI_InitNumberJson(&buffer, number.load(std::memory_order_relaxed));
+    return &buffer;
   }
 
-  char*        key;
-  TRI_json_t*  json;
+  bool isNumber () const {
+    return json == nullptr;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds to a number, and returns the new value
+///
+/// this needs only the read lock of the shard
+////////////////////////////////////////////////////////////////////////////////
+
+  double increment (double value) {
+    double current = number.load(std::memory_order_relaxed);
+
+    while (! number.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+    }
+
+    return current + value;
+  }
+
+  bool isExpired () const {
+    return expires > 0.0 && expires <= TRI_microtime();
+  }
+
+  char*                key;
+  TRI_json_t*          json;
+  std::atomic<double>  number;
+  double const         expires;
 };
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    class KeySpace
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a keyspace
+///
+/// the keys are distributed over shards by their hash, and each shard has
+/// its own lock, so that operations on different keys rarely wait for each
+/// other. operations on all keys lock one shard after the other, and do not
+/// see a consistent state of the keyspace if it is modified concurrently.
+///
+/// keys may have a time to live. expired keys are invisible, and are freed
+/// when their shard is modified next
+////////////////////////////////////////////////////////////////////////////////
+
 class KeySpace {
-  public:
-    KeySpace (uint32_t initialSize) 
-      : _lock() {
 
-      TRI_InitAssociativePointer(&_hash, 
-                                 TRI_UNKNOWN_MEM_ZONE,
-                                 TRI_HashStringKeyAssociativePointer,
-                                 HashHash,
-                                 EqualHash,
-                                 nullptr);
+  private:
+
+    struct Shard {
+      triagens::basics::ReadWriteLock lock; 
+      TRI_associative_pointer_t       hash;
+    };
+
+    static size_t const NumShards = 16;
 
-      if (initialSize > 0) {
-        TRI_ReserveAssociativePointer(&_hash, initialSize);
+  public:
+    KeySpace (uint32_t initialSize) 
+      : _hasExpiring(false) {
+
+      for (size_t i = 0; i < NumShards; ++i) {
+        TRI_InitAssociativePointer(&_shards[i].hash, 
+                                   TRI_UNKNOWN_MEM_ZONE,
+                                   TRI_HashStringKeyAssociativePointer,
+                                   HashHash,
+                                   EqualHash,
+                                   nullptr);
+
+        if (initialSize > 0) {
+          TRI_ReserveAssociativePointer(&_shards[i].hash, initialSize / NumShards + 1);
+        }
       }
     } 
 
     ~KeySpace () {
-      uint32_t const n = _hash._nrAlloc;
-      for (uint32_t i = 0; i < n; ++i) {
-        auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
+      for (size_t i = 0; i < NumShards; ++i) {
+        auto& hash = _shards[i].hash;
 
-        if (element != nullptr) {
-          delete element;
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
+
+          if (element != nullptr) {
+            delete element;
+          }
         }
+        TRI_DestroyAssociativePointer(&hash);
       }
-      TRI_DestroyAssociativePointer(&_hash);
     }
 
     static uint64_t HashHash (TRI_associative_pointer_t*,
@@ -125,20 +216,23 @@ class KeySpace {
     }
 
     uint32_t keyspaceCount () {
-      READ_LOCKER(_lock);
-      return _hash._nrUsed;
-    }
-
-    uint32_t keyspaceCount (std::string const& prefix) {
       uint32_t count = 0;
-      READ_LOCKER(_lock);
 
-      uint32_t const n = _hash._nrAlloc;
-      for (uint32_t i = 0; i < n; ++i) {
-        auto data = static_cast<KeySpaceElement*>(_hash._table[i]);
+      for (size_t i = 0; i < NumShards; ++i) {
+        READ_LOCKER(_shards[i].lock);
+
+        if (! _hasExpiring.load(std::memory_order_relaxed)) {
+          count += _shards[i].hash._nrUsed;
+          continue;
+        }
+
+        auto& hash = _shards[i].hash;
+
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
 
-        if (data != nullptr) {
-          if (TRI_IsPrefixString(data->key, prefix.c_str())) {
+          if (element != nullptr && ! element->isExpired()) {
             ++count;
           }
         }
@@ -147,91 +241,108 @@ class KeySpace {
       return count;
     }
 
-    v8::Handle<v8::Value> keyspaceRemove (v8::Isolate* isolate) {
-      v8::EscapableHandleScope scope(isolate);
+    uint32_t keyspaceCount (std::string const& prefix) {
+      uint32_t count = 0;
 
-      WRITE_LOCKER(_lock);
+      for (size_t i = 0; i < NumShards; ++i) {
+        READ_LOCKER(_shards[i].lock);
+        auto& hash = _shards[i].hash;
 
-      uint32_t const n = _hash._nrAlloc;
-      uint32_t deleted = 0;
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
 
-      for (uint32_t i = 0; i < n; ++i) {
-        auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
-
-        if (element != nullptr) {
-          delete element;
-          _hash._table[i] = nullptr;
-          ++deleted;
+          if (element != nullptr && ! element->isExpired()) {
+            if (TRI_IsPrefixString(element->key, prefix.c_str())) {
+              ++count;
+            }
+          }
         }
       }
-      _hash._nrUsed = 0;
 
-      return scope.Escape<v8::Value>(v8::Number::New(isolate, static_cast<int>(deleted)));
+      return count;
     }
 
-    v8::Handle<v8::Value> keyspaceRemove (v8::Isolate* isolate,
-                                          std::string const& prefix) {
+    v8::Handle<v8::Value> keyspaceRemove (v8::Isolate* isolate) {
       v8::EscapableHandleScope scope(isolate);
-      WRITE_LOCKER(_lock);
 
-      uint32_t const n = _hash._nrAlloc;
-      uint32_t i = 0;
       uint32_t deleted = 0;
 
-      while (i < n) {
-        auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
+      for (size_t i = 0; i < NumShards; ++i) {
+        WRITE_LOCKER(_shards[i].lock);
+        auto& hash = _shards[i].hash;
 
-        if (element != nullptr) {
-          if (TRI_IsPrefixString(element->key, prefix.c_str())) {
-            if (TRI_RemoveKeyAssociativePointer(&_hash, element->key) != nullptr) {
-              delete element;
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
+
+          if (element != nullptr) {
+            if (! element->isExpired()) {
               ++deleted;
-              continue;
             }
+            delete element;
+            hash._table[j] = nullptr;
           }
         }
-        ++i;
+        hash._nrUsed = 0;
       }
 
       return scope.Escape<v8::Value>(v8::Number::New(isolate, static_cast<int>(deleted)));
     }
 
-    v8::Handle<v8::Value> keyspaceKeys (v8::Isolate* isolate) {
+    v8::Handle<v8::Value> keyspaceRemove (v8::Isolate* isolate,
+                                          std::string const& prefix) {
       v8::EscapableHandleScope scope(isolate);
-      v8::Handle<v8::Array> result;
-      {
-        READ_LOCKER(_lock);
 
-        uint32_t const n = _hash._nrAlloc;
-        uint32_t count = 0;
-        result = v8::Array::New(isolate, static_cast<int>(_hash._nrUsed));
+      uint32_t deleted = 0;
+
+      for (size_t i = 0; i < NumShards; ++i) {
+        WRITE_LOCKER(_shards[i].lock);
+        auto& hash = _shards[i].hash;
 
-        for (uint32_t i = 0; i < n; ++i) {
-          auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
+        uint32_t const n = hash._nrAlloc;
+        uint32_t j = 0;
+
+        while (j < n) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
 
           if (element != nullptr) {
-            result->Set(count++, TRI_V8_STRING(element->key));
+            if (TRI_IsPrefixString(element->key, prefix.c_str())) {
+              if (TRI_RemoveKeyAssociativePointer(&hash, element->key) != nullptr) {
+                if (! element->isExpired()) {
+                  ++deleted;
+                }
+                delete element;
+                continue;
+              }
+            }
           }
+          ++j;
         }
       }
 
-      return scope.Escape<v8::Value>(result);
+      return scope.Escape<v8::Value>(v8::Number::New(isolate, static_cast<int>(deleted)));
     }
 
-   v8::Handle<v8::Value> keyspaceKeys (v8::Isolate* isolate, std::string const& prefix) {
-     v8::EscapableHandleScope scope(isolate);
-      v8::Handle<v8::Array> result;
-      {
-        READ_LOCKER(_lock);
+    v8::Handle<v8::Value> keyspaceKeys (v8::Isolate* isolate) {
+      return keyspaceKeys(isolate, "");
+    }
 
-        uint32_t const n = _hash._nrAlloc;
-        uint32_t count = 0;
-        result = v8::Array::New(isolate);
+    v8::Handle<v8::Value> keyspaceKeys (v8::Isolate* isolate, 
+                                        std::string const& prefix) {
+      v8::EscapableHandleScope scope(isolate);
+      v8::Handle<v8::Array> result = v8::Array::New(isolate);
+      uint32_t count = 0;
 
-        for (uint32_t i = 0; i < n; ++i) {
-          auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
+      for (size_t i = 0; i < NumShards; ++i) {
+        READ_LOCKER(_shards[i].lock);
+        auto& hash = _shards[i].hash;
 
-          if (element != nullptr) {
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
+
+          if (element != nullptr && ! element->isExpired()) {
             if (TRI_IsPrefixString(element->key, prefix.c_str())) {
               result->Set(count++, TRI_V8_STRING(element->key));
             }
@@ -243,39 +354,26 @@ class KeySpace {
     }
 
     v8::Handle<v8::Value> keyspaceGet (v8::Isolate* isolate) {
-      v8::EscapableHandleScope scope(isolate);
-      v8::Handle<v8::Object> result = v8::Object::New(isolate);
-      {
-        READ_LOCKER(_lock);
-
-        uint32_t const n = _hash._nrAlloc;
-
-        for (uint32_t i = 0; i < n; ++i) {
-          auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
-
-          if (element != nullptr) {
-            result->Set(TRI_V8_STRING(element->key), TRI_ObjectJson(isolate, element->json));
-          }
-        }
-      }
-
-      return scope.Escape<v8::Value>(result);
+      return keyspaceGet(isolate, "");
     }
 
-    v8::Handle<v8::Value> keyspaceGet (v8::Isolate* isolate, std::string const& prefix) {
+    v8::Handle<v8::Value> keyspaceGet (v8::Isolate* isolate, 
+                                       std::string const& prefix) {
       v8::EscapableHandleScope scope(isolate);
       v8::Handle<v8::Object> result = v8::Object::New(isolate);
-      {
-        READ_LOCKER(_lock);
+      TRI_json_t buffer;
 
-        uint32_t const n = _hash._nrAlloc;
+      for (size_t i = 0; i < NumShards; ++i) {
+        READ_LOCKER(_shards[i].lock);
+        auto& hash = _shards[i].hash;
 
-        for (uint32_t i = 0; i < n; ++i) {
-          auto element = static_cast<KeySpaceElement*>(_hash._table[i]);
+        uint32_t const n = hash._nrAlloc;
+        for (uint32_t j = 0; j < n; ++j) {
+          auto element = static_cast<KeySpaceElement*>(hash._table[j]);
 
-          if (element != nullptr) {
+          if (element != nullptr && ! element->isExpired()) {
             if (TRI_IsPrefixString(element->key, prefix.c_str())) {
-              result->Set(TRI_V8_STRING(element->key), TRI_ObjectJson(isolate, element->json));
+              result->Set(TRI_V8_STRING(element->key), TRI_ObjectJson(isolate, element->value(buffer)));
             }
           }
         }
@@ -286,9 +384,10 @@ class KeySpace {
 
     bool keyCount (std::string const& key, 
                    uint32_t& result) {
-      READ_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      READ_LOCKER(shard.lock);
 
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+      auto found = lookup(shard, key);
 
       if (found != nullptr) {
         TRI_json_t const* value = found->json;
@@ -310,15 +409,17 @@ class KeySpace {
     v8::Handle<v8::Value> keyGet (v8::Isolate* isolate, std::string const& key) {
       v8::Handle<v8::Value> result;
       {
-        READ_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        READ_LOCKER(shard.lock);
 
-        auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+        auto found = lookup(shard, key);
 
         if (found == nullptr) {
           result = v8::Undefined(isolate);
         }
         else {
-          result = TRI_ObjectJson(isolate, found->json);
+          TRI_json_t buffer;
+          result = TRI_ObjectJson(isolate, found->value(buffer));
         }
       }
 
@@ -328,14 +429,24 @@ class KeySpace {
     bool keySet (v8::Isolate* isolate,
                  std::string const& key,
                  v8::Handle<v8::Value> const& value,
-                 bool replace) {
-      auto element = new KeySpaceElement(key.c_str(), key.size(), TRI_ObjectToJson(isolate, value));
+                 bool replace,
+                 double ttl) {
+      double expires = 0.0;
+
+      if (ttl > 0.0) {
+        expires = TRI_microtime() + ttl;
+        _hasExpiring.store(true, std::memory_order_relaxed);
+      }
+
+      auto element = new KeySpaceElement(key.c_str(), key.size(), TRI_ObjectToJson(isolate, value), expires);
       KeySpaceElement* found = nullptr;
 
       {
-        WRITE_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        WRITE_LOCKER(shard.lock);
  
-        found = static_cast<KeySpaceElement*>(TRI_InsertKeyAssociativePointer(&_hash, element->key, element, replace));
+        lookupForWrite(shard, key);
+        found = static_cast<KeySpaceElement*>(TRI_InsertKeyAssociativePointer(&shard.hash, element->key, element, replace));
       }
    
       if (found == nullptr) {
@@ -358,9 +469,11 @@ class KeySpace {
                 bool& match) {
       auto element = new KeySpaceElement(key.c_str(), key.size(), TRI_ObjectToJson(isolate, value));
 
-      WRITE_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      WRITE_LOCKER(shard.lock);
  
-      auto found = static_cast<KeySpaceElement*>(TRI_InsertKeyAssociativePointer(&_hash, element->key, element, false));
+      lookupForWrite(shard, key);
+      auto found = static_cast<KeySpaceElement*>(TRI_InsertKeyAssociativePointer(&shard.hash, element->key, element, false));
   
       if (found == nullptr) {
         // no object saved yet
@@ -386,7 +499,8 @@ class KeySpace {
         return TRI_ERROR_OUT_OF_MEMORY;
       }
         
-      int res = TRI_CompareValuesJson(found->json, other);
+      TRI_json_t buffer;
+      int res = TRI_CompareValuesJson(found->value(buffer), other);
       TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, other); 
 
       if (res != 0) {
@@ -394,7 +508,7 @@ class KeySpace {
         match = false;
       }
       else {
-        TRI_InsertKeyAssociativePointer(&_hash, element->key, element, true);
+        TRI_InsertKeyAssociativePointer(&shard.hash, element->key, element, true);
         delete found;
         match = true;
       }
@@ -406,50 +520,70 @@ class KeySpace {
       KeySpaceElement* found = nullptr;
 
       {
-        WRITE_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        WRITE_LOCKER(shard.lock);
 
-        found = static_cast<KeySpaceElement*>(TRI_RemoveKeyAssociativePointer(&_hash, key.c_str()));
+        found = static_cast<KeySpaceElement*>(TRI_RemoveKeyAssociativePointer(&shard.hash, key.c_str()));
       }
 
       if (found != nullptr) {
+        bool const expired = found->isExpired();
         delete found;
-        return true;
+        return ! expired;
       }
 
       return false;
     }
  
     bool keyExists (std::string const& key) {
-      READ_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      READ_LOCKER(shard.lock);
 
-      return (TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()) != nullptr);
+      return (lookup(shard, key) != nullptr);
     }
  
     int keyIncr (std::string const& key,
                  double value,
                  double& result) {
-      WRITE_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+
+      {
+        // an existing number is incremented under the read lock
+        READ_LOCKER(shard.lock);
 
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+        auto found = lookup(shard, key);
+
+        if (found != nullptr) {
+          if (! found->isNumber()) {
+            // TODO: change error code
+            return TRI_ERROR_ILLEGAL_NUMBER;
+          }
+
+          result = found->increment(value);
+          return TRI_ERROR_NO_ERROR;
+        }
+      }
+
+      WRITE_LOCKER(shard.lock);
+
+      auto found = lookupForWrite(shard, key);
 
       if (found == nullptr) {
         auto element = new KeySpaceElement(key.c_str(), key.size(), TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, value));
 
-        if (TRI_InsertKeyAssociativePointer(&_hash, element->key, static_cast<void*>(element), false) != TRI_ERROR_NO_ERROR) {
+        if (TRI_InsertKeyAssociativePointer(&shard.hash, element->key, static_cast<void*>(element), false) != nullptr) {
           delete element;
           return TRI_ERROR_OUT_OF_MEMORY;
         }
         result = value;
       }
       else {
-        TRI_json_t* current = found->json;
-
-        if (! TRI_IsNumberJson(current)) {
+        if (! found->isNumber()) {
           // TODO: change error code
           return TRI_ERROR_ILLEGAL_NUMBER;
         }
 
-        result = current->_value._number += value;
+        result = found->increment(value);
       }
 
       return TRI_ERROR_NO_ERROR;
@@ -458,9 +592,10 @@ class KeySpace {
     int keyPush (v8::Isolate* isolate,
                  std::string const& key,
                  v8::Handle<v8::Value> const& value) {
-      WRITE_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      WRITE_LOCKER(shard.lock);
 
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+      auto found = lookupForWrite(shard, key);
 
       if (found == nullptr) {
         TRI_json_t* list = TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, 1);
@@ -476,7 +611,7 @@ class KeySpace {
 
         auto element = new KeySpaceElement(key.c_str(), key.size(), list);
 
-        if (TRI_InsertKeyAssociativePointer(&_hash, element->key, static_cast<void*>(element), false) != TRI_ERROR_NO_ERROR) {
+        if (TRI_InsertKeyAssociativePointer(&shard.hash, element->key, static_cast<void*>(element), false) != nullptr) {
           delete element;
           return TRI_ERROR_OUT_OF_MEMORY;
         }
@@ -500,9 +635,11 @@ class KeySpace {
     void keyPop (const v8::FunctionCallbackInfo<v8::Value>& args, std::string const& key) {
       v8::Isolate* isolate = args.GetIsolate();
       v8::HandleScope scope(isolate);
-      WRITE_LOCKER(_lock);
 
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+      Shard& shard = shardFor(key);
+      WRITE_LOCKER(shard.lock);
+
+      auto found = lookupForWrite(shard, key);
 
       if (found == nullptr) {
         // TODO: change error code
@@ -538,9 +675,25 @@ class KeySpace {
       v8::Isolate* isolate = args.GetIsolate();
       v8::HandleScope scope(isolate);
 
-      WRITE_LOCKER(_lock);
+      Shard& sourceShard = shardFor(keyFrom);
+      Shard& destShard = shardFor(keyTo);
+
+      // lock both shards in the same order as any other transfer
+      Shard* first = &sourceShard;
+      Shard* second = &destShard;
+
+      if (second < first) {
+        std::swap(first, second);
+      }
+
+      WRITE_LOCKER(first->lock);
+      std::unique_ptr<triagens::basics::WriteLocker> secondLocker;
 
-      auto source = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, keyFrom.c_str()));
+      if (second != first) {
+        secondLocker.reset(new triagens::basics::WriteLocker(&second->lock));
+      }
+
+      auto source = lookupForWrite(sourceShard, keyFrom);
 
       if (source == nullptr) {
         TRI_V8_RETURN_UNDEFINED();
@@ -561,7 +714,7 @@ class KeySpace {
 
       TRI_json_t* sourceItem = static_cast<TRI_json_t*>(TRI_AtVector(&source->json->_value._objects, n - 1));
 
-      auto dest = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, keyTo.c_str()));
+      auto dest = lookupForWrite(destShard, keyTo);
 
       if (dest == nullptr) {
         TRI_json_t* list = TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, 1);
@@ -574,7 +727,7 @@ class KeySpace {
  
         try {
           auto element = new KeySpaceElement(keyTo.c_str(), keyTo.size(), list);
-          TRI_InsertKeyAssociativePointer(&_hash, element->key, element, false);
+          TRI_InsertKeyAssociativePointer(&destShard.hash, element->key, element, false);
           // hack: decrease the vector size
           TRI_SetLengthVector(&current->_value._objects, TRI_LengthVector(&current->_value._objects) - 1);
         
@@ -601,15 +754,17 @@ class KeySpace {
     v8::Handle<v8::Value> keyKeys (v8::Isolate* isolate, std::string const& key) {
       v8::Handle<v8::Value> result;
       {
-        READ_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        READ_LOCKER(shard.lock);
 
-        auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+        auto found = lookup(shard, key);
 
         if (found == nullptr) {
           result = v8::Undefined(isolate);
         }
         else {
-          result = TRI_KeysJson(isolate, found->json);
+          TRI_json_t buffer;
+          result = TRI_KeysJson(isolate, found->value(buffer));
         }
       }
 
@@ -621,15 +776,17 @@ class KeySpace {
       v8::EscapableHandleScope scope(isolate);
       v8::Handle<v8::Value> result;
       {
-        READ_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        READ_LOCKER(shard.lock);
 
-        auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+        auto found = lookup(shard, key);
 
         if (found == nullptr) {
           result = v8::Undefined(isolate);
         }
         else {
-          result = TRI_ValuesJson(isolate, found->json);
+          TRI_json_t buffer;
+          result = TRI_ValuesJson(isolate, found->value(buffer));
         }
       }
 
@@ -644,9 +801,10 @@ class KeySpace {
 
       v8::Handle<v8::Value> result;
       {
-        READ_LOCKER(_lock);
+        Shard& shard = shardFor(key);
+        READ_LOCKER(shard.lock);
 
-        auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+        auto found = lookup(shard, key);
 
         if (found == nullptr) {
           result = v8::Undefined(isolate);
@@ -680,9 +838,10 @@ class KeySpace {
                    std::string const& key,
                    int64_t index,
                    v8::Handle<v8::Value> const& value) {
-      WRITE_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      WRITE_LOCKER(shard.lock);
 
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+      auto found = lookupForWrite(shard, key);
 
       if (found == nullptr) {
         // TODO: change error code
@@ -729,12 +888,14 @@ class KeySpace {
     }
 
     char const* keyType (std::string const& key) {
-      READ_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      READ_LOCKER(shard.lock);
 
-      void* found = TRI_LookupByKeyAssociativePointer(&_hash, key.c_str());
+      auto found = lookup(shard, key);
 
       if (found != nullptr) {
-        TRI_json_t const* value = static_cast<KeySpaceElement*>(found)->json;
+        TRI_json_t buffer;
+        TRI_json_t const* value = found->value(buffer);
 
         switch (value->_type) {
           case TRI_JSON_NULL:
@@ -770,13 +931,14 @@ class KeySpace {
         TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
       }
 
-      WRITE_LOCKER(_lock);
+      Shard& shard = shardFor(key);
+      WRITE_LOCKER(shard.lock);
  
-      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&_hash, key.c_str()));
+      auto found = lookupForWrite(shard, key);
    
       if (found == nullptr) {
         auto element = new KeySpaceElement(key.c_str(), key.size(), TRI_ObjectToJson(isolate, value));
-        TRI_InsertKeyAssociativePointer(&_hash, element->key, element, false);
+        TRI_InsertKeyAssociativePointer(&shard.hash, element->key, element, false);
 
         TRI_V8_RETURN(value);
       }
@@ -805,9 +967,58 @@ class KeySpace {
     }
 
   private:
-        
-    triagens::basics::ReadWriteLock _lock; 
-    TRI_associative_pointer_t       _hash;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the shard of a key
+////////////////////////////////////////////////////////////////////////////////
+
+    Shard& shardFor (std::string const& key) {
+      // the hash tables use the lower bits of the same hash
+      return _shards[(TRI_FnvHashString(key.c_str()) >> 32) % NumShards];
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a key that has not expired, the caller must hold the lock
+/// of the shard
+////////////////////////////////////////////////////////////////////////////////
+
+    static KeySpaceElement* lookup (Shard& shard,
+                                    std::string const& key) {
+      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&shard.hash, key.c_str()));
+
+      if (found != nullptr && found->isExpired()) {
+        return nullptr;
+      }
+
+      return found;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a key that has not expired, and frees it if it has
+/// expired. the caller must hold the write lock of the shard
+////////////////////////////////////////////////////////////////////////////////
+
+    static KeySpaceElement* lookupForWrite (Shard& shard,
+                                            std::string const& key) {
+      auto found = static_cast<KeySpaceElement*>(TRI_LookupByKeyAssociativePointer(&shard.hash, key.c_str()));
+
+      if (found != nullptr && found->isExpired()) {
+        TRI_RemoveKeyAssociativePointer(&shard.hash, key.c_str());
+        delete found;
+        return nullptr;
+      }
+
+      return found;
+    }
+
+    Shard              _shards[NumShards];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether any key has ever been given a time to live. counting the
+/// keys needs to look at each key only then
+////////////////////////////////////////////////////////////////////////////////
+
+    std::atomic<bool>  _hasExpiring;
    
 };
 
@@ -1198,7 +1409,7 @@ static void JS_KeySet (const v8::FunctionCallbackInfo<v8::Value>& args) {
   v8::HandleScope scope(isolate);
 
   if (args.Length() < 3 || ! args[0]->IsString() || ! args[1]->IsString()) {
-    TRI_V8_THROW_EXCEPTION_USAGE("KEY_SET(<name>, <key>, <value>, <replace>)");
+    TRI_V8_THROW_EXCEPTION_USAGE("KEY_SET(<name>, <key>, <value>, <replace>, <ttl>)");
   }
 
   TRI_vocbase_t* vocbase = GetContextVocBase(isolate);
@@ -1215,6 +1426,17 @@ static void JS_KeySet (const v8::FunctionCallbackInfo<v8::Value>& args) {
     replace = TRI_ObjectToBoolean(args[3]);
   }
 
+  // time to live in seconds, 0 means forever
+  double ttl = 0.0;
+
+  if (args.Length() > 4) {
+    ttl = TRI_ObjectToDouble(args[4]);
+
+    if (ttl < 0.0) {
+      TRI_V8_THROW_EXCEPTION_PARAMETER("invalid value for <ttl>");
+    }
+  }
+
   auto h = &(static_cast<UserStructures*>(vocbase->_userStructures)->hashes);
   bool result;
   {
@@ -1227,7 +1449,7 @@ static void JS_KeySet (const v8::FunctionCallbackInfo<v8::Value>& args) {
       TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
     }
 
-    result = hash->keySet(isolate, key, args[2], replace);
+    result = hash->keySet(isolate, key, args[2], replace, ttl);
   }
 
   if (result) {
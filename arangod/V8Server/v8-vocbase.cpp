@@ -1663,19 +1663,23 @@ static void JS_QueryCachePropertiesAql (const v8::FunctionCallbackInfo<v8::Value
     // called with options
     auto obj = args[0]->ToObject();
 
-    std::pair<std::string, size_t> cacheProperties;
+    triagens::aql::QueryCacheProperties cacheProperties;
     // fetch current configuration
     queryCache->properties(cacheProperties);
 
     if (obj->Has(TRI_V8_ASCII_STRING("mode"))) {
-      cacheProperties.first = TRI_ObjectToString(obj->Get(TRI_V8_ASCII_STRING("mode")));
+      cacheProperties.mode = TRI_ObjectToString(obj->Get(TRI_V8_ASCII_STRING("mode")));
     }
 
     if (obj->Has(TRI_V8_ASCII_STRING("maxResults"))) {
-      cacheProperties.second = static_cast<size_t>(TRI_ObjectToInt64(obj->Get(TRI_V8_ASCII_STRING("maxResults"))));
+      cacheProperties.maxResults = static_cast<size_t>(TRI_ObjectToInt64(obj->Get(TRI_V8_ASCII_STRING("maxResults"))));
     }
 
-    // set mode and max elements
+    if (obj->Has(TRI_V8_ASCII_STRING("maxResultsSize"))) {
+      cacheProperties.maxResultsSize = static_cast<size_t>(TRI_ObjectToInt64(obj->Get(TRI_V8_ASCII_STRING("maxResultsSize"))));
+    }
+
+    // set mode and limits
     queryCache->setProperties(cacheProperties);
   }
 
@@ -2082,59 +2086,6 @@ class HopWeightCalculator {
     }
 };
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief Define edge weight by ony special attribute.
-///        Respectively 1 for any edge.
-////////////////////////////////////////////////////////////////////////////////
-
-class AttributeWeightCalculator {
-
-  TRI_shape_pid_t _shapePid;
-  double _defaultWeight;
-  VocShaper* _shaper;
-
-  public: 
-    AttributeWeightCalculator (string const& keyWeight,
-                               double defaultWeight,
-                               VocShaper* shaper) : 
-      _defaultWeight(defaultWeight),
-      _shaper(shaper) {
-
-      _shapePid = _shaper->lookupAttributePathByName(keyWeight.c_str());
-    }
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief Callable weight calculator for edge
-////////////////////////////////////////////////////////////////////////////////
-
-    double operator() (TRI_doc_mptr_copy_t const& edge) {
-      if (_shapePid == 0) {
-        return _defaultWeight;
-      }
-
-      TRI_shape_sid_t sid;
-      TRI_EXTRACT_SHAPE_IDENTIFIER_MARKER(sid, edge.getDataPtr());
-      TRI_shape_access_t const* accessor = _shaper->findAccessor(sid, _shapePid);
-      TRI_shaped_json_t shapedJson;
-      TRI_EXTRACT_SHAPED_JSON_MARKER(shapedJson, edge.getDataPtr());
-      TRI_shaped_json_t resultJson;
-      TRI_ExecuteShapeAccessor(accessor, &shapedJson, &resultJson);
-
-      if (resultJson._sid != TRI_SHAPE_NUMBER) {
-        return _defaultWeight;
-      }
-
-      std::unique_ptr<TRI_json_t> json(TRI_JsonShapedJson(_shaper, &resultJson));
-
-      if (json == nullptr) {
-        return _defaultWeight;
-      }
-
-      return json.get()->_value._number;
-    }
-};
-
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Helper to transform a vertex _id string to VertexId struct.
 ////////////////////////////////////////////////////////////////////////////////
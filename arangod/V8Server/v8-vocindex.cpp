@@ -30,14 +30,18 @@
 #include "v8-vocindex.h"
 #include "Basics/conversions.h"
 #include "FulltextIndex/fulltext-index.h"
+#include "Indexes/AggregateIndex.h"
 #include "Indexes/CapConstraint.h"
 #include "Indexes/EdgeIndex.h"
 #include "Indexes/FulltextIndex.h"
+#include "Indexes/GeoCellIndex.h"
 #include "Indexes/GeoIndex2.h"
 #include "Indexes/HashIndex.h"
 #include "Indexes/Index.h"
 #include "Indexes/PrimaryIndex.h"
 #include "Indexes/SkiplistIndex.h"
+#include "Indexes/TtlIndex.h"
+#include "Indexes/VertexCentricIndex.h"
 #include "Utils/transactions.h"
 #include "Utils/V8TransactionContext.h"
 #include "V8/v8-conv.h"
@@ -219,6 +223,38 @@ static int ProcessIndexSparseFlag (v8::Isolate* isolate,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process the filter of a partial index and add it to the json
+////////////////////////////////////////////////////////////////////////////////
+
+static int ProcessIndexFilter (v8::Isolate* isolate,
+                               v8::Handle<v8::Object> const obj,
+                               TRI_json_t* json) {
+  v8::HandleScope scope(isolate);
+  v8::Handle<v8::String> filterString = TRI_V8_ASCII_STRING("filter");
+
+  if (! obj->Has(filterString) || obj->Get(filterString)->IsUndefined()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  TRI_json_t* filterJson = TRI_ObjectToJson(isolate, obj->Get(filterString));
+
+  if (filterJson == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  int res = triagens::arango::PathBasedIndex::validateFilter(filterJson);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, filterJson);
+    return res;
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "filter", filterJson);
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief process the unique flag and add it to the json
 ////////////////////////////////////////////////////////////////////////////////
@@ -271,6 +307,35 @@ static int EnhanceJsonIndexGeo2 (v8::Isolate* isolate,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enhances the json of a geo cell index
+////////////////////////////////////////////////////////////////////////////////
+
+static int EnhanceJsonIndexGeoCell (v8::Isolate* isolate,
+                                    v8::Handle<v8::Object> const obj,
+                                    TRI_json_t* json,
+                                    bool create) {
+  int res = ProcessIndexFields(isolate, obj, json, 0, create);
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    // either [ location ] or [ latitude, longitude ]
+    TRI_json_t const* fields = TRI_LookupObjectJson(json, "fields");
+    size_t const n = TRI_LengthArrayJson(fields);
+
+    if (n != 1 && n != 2) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    if (n == 1) {
+      ProcessIndexGeoJsonFlag(isolate, obj, json);
+    }
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "sparse", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, true));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "unique", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enhances the json of a hash index
 ////////////////////////////////////////////////////////////////////////////////
@@ -282,6 +347,9 @@ static int EnhanceJsonIndexHash (v8::Isolate* isolate,
   int res = ProcessIndexFields(isolate, obj, json, 0, create);
   ProcessIndexSparseFlag(isolate, obj, json, create);
   ProcessIndexUniqueFlag(isolate, obj, json);
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = ProcessIndexFilter(isolate, obj, json);
+  }
   return res;
 }
 
@@ -296,9 +364,84 @@ static int EnhanceJsonIndexSkiplist (v8::Isolate* isolate,
   int res = ProcessIndexFields(isolate, obj, json, 0, create);
   ProcessIndexSparseFlag(isolate, obj, json, create);
   ProcessIndexUniqueFlag(isolate, obj, json);
+  if (res == TRI_ERROR_NO_ERROR) {
+    res = ProcessIndexFilter(isolate, obj, json);
+  }
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enhances the json of a vertex-centric index
+///
+/// the first field must be _from or _to, followed by at least one regular
+/// attribute. the index is never unique nor sparse
+////////////////////////////////////////////////////////////////////////////////
+
+static int EnhanceJsonIndexVertexCentric (v8::Isolate* isolate,
+                                          v8::Handle<v8::Object> const obj,
+                                          TRI_json_t* json,
+                                          bool create) {
+  v8::HandleScope scope(isolate);
+  std::set<string> fields;
+
+  v8::Handle<v8::String> fieldsString = TRI_V8_ASCII_STRING("fields");
+  if (! obj->Has(fieldsString) || ! obj->Get(fieldsString)->IsArray()) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  v8::Handle<v8::Array> fieldList = v8::Handle<v8::Array>::Cast(obj->Get(fieldsString));
+
+  uint32_t const n = fieldList->Length();
+
+  if (n < 2) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  for (uint32_t i = 0; i < n; ++i) {
+    if (! fieldList->Get(i)->IsString()) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    string const f = TRI_ObjectToString(fieldList->Get(i));
+
+    if (i == 0) {
+      if (f != TRI_VOC_ATTRIBUTE_FROM && f != TRI_VOC_ATTRIBUTE_TO) {
+        // the vertex must come first
+        return TRI_ERROR_BAD_PARAMETER;
+      }
+    }
+    else if (f.empty() || (create && f[0] == '_')) {
+      // accessing internal attributes is disallowed
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    if (fields.find(f) != fields.end()) {
+      // duplicate attribute name
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    fields.insert(f);
+  }
+
+  TRI_json_t* fieldJson = TRI_ObjectToJson(isolate, obj->Get(fieldsString));
+
+  if (fieldJson == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "fields", fieldJson);
+
+  if (ExtractBoolFlag(isolate, obj, TRI_V8_ASCII_STRING("unique"), false) ||
+      ExtractBoolFlag(isolate, obj, TRI_V8_ASCII_STRING("sparse"), false)) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "unique", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "sparse", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enhances the json of a fulltext index
 ////////////////////////////////////////////////////////////////////////////////
@@ -327,6 +470,136 @@ static int EnhanceJsonIndexFulltext (v8::Isolate* isolate,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enhances the json of a ttl index
+////////////////////////////////////////////////////////////////////////////////
+
+static int EnhanceJsonIndexTtl (v8::Isolate* isolate,
+                                v8::Handle<v8::Object> const obj,
+                                TRI_json_t* json,
+                                bool create) {
+  int res = ProcessIndexFields(isolate, obj, json, 1, create);
+
+  // handle "expireAfter" attribute
+  double expireAfter = 0.0;
+  if (obj->Has(TRI_V8_ASCII_STRING("expireAfter"))) {
+    if (! obj->Get(TRI_V8_ASCII_STRING("expireAfter"))->IsNumber()) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    expireAfter = TRI_ObjectToDouble(obj->Get(TRI_V8_ASCII_STRING("expireAfter")));
+
+    if (expireAfter < 0.0 || expireAfter != expireAfter) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "expireAfter", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, expireAfter));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "sparse", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, true));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "unique", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enhances the json of an aggregate index
+////////////////////////////////////////////////////////////////////////////////
+
+static int EnhanceJsonIndexAggregate (v8::Isolate* isolate,
+                                      v8::Handle<v8::Object> const obj,
+                                      TRI_json_t* json,
+                                      bool create) {
+  int res = ProcessIndexFields(isolate, obj, json, 0, create);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  // handle "name" attribute
+  if (! obj->Has(TRI_V8_ASCII_STRING("name")) ||
+      ! obj->Get(TRI_V8_ASCII_STRING("name"))->IsString()) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  std::string const name = TRI_ObjectToString(obj->Get(TRI_V8_ASCII_STRING("name")));
+
+  if (name.empty()) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  // handle "aggregates" attribute, the functions are stored with their
+  // canonical names so that equal definitions compare equal
+  if (! obj->Has(TRI_V8_ASCII_STRING("aggregates")) ||
+      ! obj->Get(TRI_V8_ASCII_STRING("aggregates"))->IsArray()) {
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  v8::Handle<v8::Array> list = v8::Handle<v8::Array>::Cast(obj->Get(TRI_V8_ASCII_STRING("aggregates")));
+  uint32_t const n = list->Length();
+
+  std::unique_ptr<TRI_json_t> aggregates(TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, n));
+
+  if (aggregates == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  std::set<std::string> names;
+
+  for (uint32_t i = 0; i < n; ++i) {
+    if (! list->Get(i)->IsObject()) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    v8::Handle<v8::Object> entry = list->Get(i)->ToObject();
+
+    if (! entry->Get(TRI_V8_ASCII_STRING("name"))->IsString() ||
+        ! entry->Get(TRI_V8_ASCII_STRING("function"))->IsString()) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    std::string const aggregateName = TRI_ObjectToString(entry->Get(TRI_V8_ASCII_STRING("name")));
+    triagens::arango::AggregateDefinition::AggregateFunction function;
+
+    if (aggregateName.empty() ||
+        ! names.emplace(aggregateName).second ||
+        ! triagens::arango::AggregateDefinition::function(TRI_ObjectToString(entry->Get(TRI_V8_ASCII_STRING("function"))), function)) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+
+    TRI_json_t* aggregate = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE, 3);
+
+    if (aggregate == nullptr) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, aggregate, "name", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, aggregateName.c_str(), aggregateName.size()));
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, aggregate, "function", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, triagens::arango::AggregateDefinition::functionName(function), strlen(triagens::arango::AggregateDefinition::functionName(function))));
+
+    if (function != triagens::arango::AggregateDefinition::AGGREGATE_COUNT) {
+      if (! entry->Get(TRI_V8_ASCII_STRING("attribute"))->IsString()) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, aggregate);
+        return TRI_ERROR_BAD_PARAMETER;
+      }
+
+      std::string const attribute = TRI_ObjectToString(entry->Get(TRI_V8_ASCII_STRING("attribute")));
+
+      if (attribute.empty()) {
+        TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, aggregate);
+        return TRI_ERROR_BAD_PARAMETER;
+      }
+
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, aggregate, "attribute", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, attribute.c_str(), attribute.size()));
+    }
+
+    TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, aggregates.get(), aggregate);
+  }
+
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "name", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, name.c_str(), name.size()));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "aggregates", aggregates.release());
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "sparse", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "unique", TRI_CreateBooleanJson(TRI_UNKNOWN_MEM_ZONE, false));
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief enhances the json of a cap constraint
 ////////////////////////////////////////////////////////////////////////////////
@@ -359,8 +632,19 @@ static int EnhanceJsonIndexCap (v8::Isolate* isolate,
     return TRI_ERROR_BAD_PARAMETER;
   }
 
+  // handle "tolerance" attribute
+  double tolerance = 0.0;
+  if (obj->Has(TRI_V8_ASCII_STRING("tolerance")) && obj->Get(TRI_V8_ASCII_STRING("tolerance"))->IsNumber()) {
+    tolerance = TRI_ObjectToDouble(obj->Get(TRI_V8_ASCII_STRING("tolerance")));
+
+    if (tolerance < 0.0 || tolerance != tolerance) {
+      return TRI_ERROR_BAD_PARAMETER;
+    }
+  }
+
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "size", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) count));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "byteSize", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) byteSize));
+  TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "tolerance", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, tolerance));
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -459,6 +743,10 @@ static int EnhanceIndexJson (const v8::FunctionCallbackInfo<v8::Value>& args,
       res = EnhanceJsonIndexGeo2(isolate, obj, json, create);
       break;
 
+    case triagens::arango::Index::TRI_IDX_TYPE_GEO_CELL_INDEX:
+      res = EnhanceJsonIndexGeoCell(isolate, obj, json, create);
+      break;
+
     case triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX:
       res = EnhanceJsonIndexHash(isolate, obj, json, create);
       break;
@@ -474,6 +762,18 @@ static int EnhanceIndexJson (const v8::FunctionCallbackInfo<v8::Value>& args,
     case triagens::arango::Index::TRI_IDX_TYPE_CAP_CONSTRAINT:
       res = EnhanceJsonIndexCap(isolate, obj, json);
       break;
+
+    case triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX:
+      res = EnhanceJsonIndexVertexCentric(isolate, obj, json, create);
+      break;
+
+    case triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX:
+      res = EnhanceJsonIndexTtl(isolate, obj, json, create);
+      break;
+
+    case triagens::arango::Index::TRI_IDX_TYPE_AGGREGATE_INDEX:
+      res = EnhanceJsonIndexAggregate(isolate, obj, json, create);
+      break;
   }
 
   return res;
@@ -567,6 +867,9 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
     sparsity = sparse ? 1 : 0;
   }
 
+  // extract the filter of a partial index
+  TRI_json_t const* filter = TRI_LookupObjectJson(json, "filter");
+
   // extract id
   TRI_idx_iid_t iid = 0;
   value = TRI_LookupObjectJson(json, "id");
@@ -696,6 +999,32 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
       break;
     }
 
+    case triagens::arango::Index::TRI_IDX_TYPE_GEO_CELL_INDEX: {
+      if (attributes.size() != 1 && attributes.size() != 2) {
+        TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+      }
+
+      bool geoJson = false;
+      value = TRI_LookupObjectJson(json, "geoJson");
+      if (TRI_IsBooleanJson(value)) {
+        geoJson = value->_value._boolean;
+      }
+
+      if (create) {
+        idx = static_cast<triagens::arango::GeoCellIndex*>(TRI_EnsureGeoCellIndexDocumentCollection(document,
+                                                                                                    iid,
+                                                                                                    attributes,
+                                                                                                    geoJson,
+                                                                                                    &created));
+      }
+      else {
+        idx = static_cast<triagens::arango::GeoCellIndex*>(TRI_LookupGeoCellIndexDocumentCollection(document,
+                                                                                                    attributes,
+                                                                                                    geoJson));
+      }
+      break;
+    }
+
     case triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX: {
       if (attributes.empty()) {
         TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
@@ -707,13 +1036,15 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
                                                                                               attributes,
                                                                                               sparse,
                                                                                               unique,
+                                                                                              filter,
                                                                                               &created));
       }
       else {
         idx = static_cast<triagens::arango::HashIndex*>(TRI_LookupHashIndexDocumentCollection(document,
                                                                                               attributes,
                                                                                               sparsity,
-                                                                                              unique));
+                                                                                              unique,
+                                                                                              filter));
       }
 
       break;
@@ -730,13 +1061,15 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
                                                                                                        attributes,
                                                                                                        sparse,
                                                                                                        unique,
+                                                                                                       filter,
                                                                                                        &created));
       }
       else {
         idx = static_cast<triagens::arango::SkiplistIndex*>(TRI_LookupSkiplistIndexDocumentCollection(document,
                                                                                                        attributes,
                                                                                                        sparsity,
-                                                                                                       unique));
+                                                                                                       unique,
+                                                                                                       filter));
       }
       break;
     }
@@ -784,11 +1117,18 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
         byteSize = (int64_t) value->_value._number;
       }
 
+      double tolerance = 0.0;
+      value = TRI_LookupObjectJson(json, "tolerance");
+      if (TRI_IsNumberJson(value)) {
+        tolerance = value->_value._number;
+      }
+
       if (create) {
         idx = static_cast<triagens::arango::Index*>(TRI_EnsureCapConstraintDocumentCollection(document,
                                                                                               iid,
                                                                                               size,
                                                                                               byteSize,
+                                                                                              tolerance,
                                                                                               &created));
       }
       else {
@@ -796,6 +1136,92 @@ static void EnsureIndexLocal (const v8::FunctionCallbackInfo<v8::Value>& args,
       }
       break;
     }
+
+    case triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX: {
+      if (attributes.size() < 2) {
+        TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+      }
+
+      if (create) {
+        idx = static_cast<triagens::arango::VertexCentricIndex*>(TRI_EnsureVertexCentricIndexDocumentCollection(document,
+                                                                                                                iid,
+                                                                                                                attributes,
+                                                                                                                &created));
+      }
+      else {
+        idx = static_cast<triagens::arango::VertexCentricIndex*>(TRI_LookupVertexCentricIndexDocumentCollection(document,
+                                                                                                                attributes));
+      }
+      break;
+    }
+
+    case triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX: {
+      if (attributes.size() != 1) {
+        TRI_V8_THROW_EXCEPTION(TRI_ERROR_INTERNAL);
+      }
+
+      double expireAfter = 0.0;
+      value = TRI_LookupObjectJson(json, "expireAfter");
+      if (TRI_IsNumberJson(value)) {
+        expireAfter = value->_value._number;
+      }
+
+      if (create) {
+        idx = static_cast<triagens::arango::TtlIndex*>(TRI_EnsureTtlIndexDocumentCollection(document,
+                                                                                            iid,
+                                                                                            attributes[0],
+                                                                                            expireAfter,
+                                                                                            &created));
+      }
+      else {
+        idx = static_cast<triagens::arango::TtlIndex*>(TRI_LookupTtlIndexDocumentCollection(document,
+                                                                                            attributes[0],
+                                                                                            expireAfter));
+      }
+      break;
+    }
+
+    case triagens::arango::Index::TRI_IDX_TYPE_AGGREGATE_INDEX: {
+      std::string name;
+      value = TRI_LookupObjectJson(json, "name");
+      if (TRI_IsStringJson(value)) {
+        name = std::string(value->_value._string.data, value->_value._string.length - 1);
+      }
+
+      std::vector<triagens::arango::AggregateDefinition> aggregates;
+      value = TRI_LookupObjectJson(json, "aggregates");
+      if (TRI_IsArrayJson(value)) {
+        size_t const n = TRI_LengthArrayJson(value);
+
+        for (size_t i = 0; i < n; ++i) {
+          auto entry = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i));
+          triagens::arango::AggregateDefinition aggregate;
+
+          aggregate._name = triagens::basics::JsonHelper::getStringValue(entry, "name", "");
+          aggregate._attribute = triagens::basics::JsonHelper::getStringValue(entry, "attribute", "");
+          aggregate._path = 0;
+
+          if (! triagens::arango::AggregateDefinition::function(triagens::basics::JsonHelper::getStringValue(entry, "function", ""), aggregate._function)) {
+            TRI_V8_THROW_EXCEPTION(TRI_ERROR_BAD_PARAMETER);
+          }
+
+          aggregates.emplace_back(aggregate);
+        }
+      }
+
+      if (create) {
+        idx = TRI_EnsureAggregateIndexDocumentCollection(document,
+                                                         iid,
+                                                         name,
+                                                         attributes,
+                                                         aggregates,
+                                                         &created);
+      }
+      else {
+        idx = TRI_LookupAggregateIndexDocumentCollection(document, name);
+      }
+      break;
+    }
   }
 
   if (idx == nullptr && create) {
@@ -939,6 +1365,9 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
 
   bool allowUserKeys = true;
   uint64_t numberOfShards = 1;
+  bool numberOfShardsGiven = false;
+  uint64_t replicationFactor = 1;
+  uint64_t writeConcern = 1;
   vector<string> shardKeys;
 
   // default shard key
@@ -973,6 +1402,15 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
 
     if (p->Has(TRI_V8_ASCII_STRING("numberOfShards"))) {
       numberOfShards = TRI_ObjectToUInt64(p->Get(TRI_V8_ASCII_STRING("numberOfShards")), false);
+      numberOfShardsGiven = true;
+    }
+
+    if (p->Has(TRI_V8_ASCII_STRING("replicationFactor"))) {
+      replicationFactor = TRI_ObjectToUInt64(p->Get(TRI_V8_ASCII_STRING("replicationFactor")), false);
+    }
+
+    if (p->Has(TRI_V8_ASCII_STRING("writeConcern"))) {
+      writeConcern = TRI_ObjectToUInt64(p->Get(TRI_V8_ASCII_STRING("writeConcern")), false);
     }
 
     if (p->Has(TRI_V8_ASCII_STRING("shardKeys"))) {
@@ -1002,6 +1440,41 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
     }
   }
 
+  ClusterInfo* ci = ClusterInfo::instance();
+
+  // the collection whose shard distribution we follow
+  shared_ptr<CollectionInfo> prototype;
+
+  if (! distributeShardsLike.empty()) {
+    CollectionNameResolver resolver(vocbase);
+    TRI_voc_cid_t otherCid = resolver.getCollectionIdCluster(distributeShardsLike);
+
+    if (otherCid != 0) {
+      prototype = ci->getCollection(databaseName, StringUtils::itoa(otherCid));
+
+      if (! prototype->empty() && ! prototype->distributeShardsLike().empty()) {
+        // all collections of a group refer to the same prototype
+        prototype = ci->getCollection(databaseName, prototype->distributeShardsLike());
+      }
+    }
+
+    if (prototype == nullptr || prototype->empty()) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND,
+                                     "prototype collection for distributeShardsLike not found");
+    }
+
+    if (! numberOfShardsGiven) {
+      numberOfShards = static_cast<uint64_t>(prototype->numberOfShards());
+    }
+    else if (numberOfShards != static_cast<uint64_t>(prototype->numberOfShards())) {
+      TRI_V8_THROW_EXCEPTION_PARAMETER("number of shards must be the same as in the prototype collection");
+    }
+
+    if (shardKeys.size() != prototype->shardKeys().size()) {
+      TRI_V8_THROW_EXCEPTION_PARAMETER("number of shard keys must be the same as in the prototype collection");
+    }
+  }
+
   if (numberOfShards == 0 || numberOfShards > 1000) {
     TRI_V8_THROW_EXCEPTION_PARAMETER("invalid number of shards");
   }
@@ -1010,7 +1483,13 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
     TRI_V8_THROW_EXCEPTION_PARAMETER("invalid number of shard keys");
   }
 
-  ClusterInfo* ci = ClusterInfo::instance();
+  if (replicationFactor == 0 || replicationFactor > 10) {
+    TRI_V8_THROW_EXCEPTION_PARAMETER("invalid replication factor");
+  }
+
+  if (writeConcern == 0 || writeConcern > replicationFactor) {
+    TRI_V8_THROW_EXCEPTION_PARAMETER("invalid write concern");
+  }
 
   // fetch a unique id for the new collection plus one for each shard to create
   uint64_t const id = ci->uniqid(1 + numberOfShards);
@@ -1020,7 +1499,7 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
 
   vector<string> dbServers;
 
-  if (distributeShardsLike.empty()) {
+  if (prototype == nullptr) {
     // fetch list of available servers in cluster, and shuffle them randomly
     dbServers = ci->getCurrentDBServers();
 
@@ -1031,28 +1510,49 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
     random_shuffle(dbServers.begin(), dbServers.end());
   }
   else {
-    CollectionNameResolver resolver(vocbase);
-    TRI_voc_cid_t otherCid 
-      = resolver.getCollectionIdCluster(distributeShardsLike);
-    shared_ptr<CollectionInfo> collInfo = ci->getCollection(databaseName,
-                               triagens::basics::StringUtils::itoa(otherCid));
-    auto shards = collInfo->shardIds();
-    for (auto it = shards.begin(); it != shards.end(); ++it) {
-      dbServers.push_back(it->second);
+    for (auto const& it : prototype->shardIds()) {
+      dbServers.push_back(it.second);
     }
-    // FIXME: need to sort shards numerically and not alphabetically
   }
 
-  // now create the shards
-  std::map<std::string, std::string> shards;
+  // now create the shards. the shard ids are assigned to the servers in the
+  // order of their names, as this is the order used for routing documents.
+  // this puts shard i of a collection next to shard i of its prototype
+  std::set<std::string> shardIds;
   for (uint64_t i = 0; i < numberOfShards; ++i) {
+    shardIds.emplace("s" + StringUtils::itoa(id + 1 + i));
+  }
+
+  std::map<std::string, std::string> shards;
+  size_t position = 0;
+  for (auto const& shardId : shardIds) {
     // determine responsible server
-    string serverId = dbServers[i % dbServers.size()];
+    shards.insert(std::make_pair(shardId, dbServers[position % dbServers.size()]));
+    ++position;
+  }
 
-    // determine shard id
-    string shardId = "s" + StringUtils::itoa(id + 1 + i);
+  // the followers of a shard are the servers following its leader in the
+  // list of all servers
+  std::map<std::string, std::vector<std::string>> shardFollowers;
 
-    shards.insert(std::make_pair(shardId, serverId));
+  if (replicationFactor > 1) {
+    vector<string> allServers = ci->getCurrentDBServers();
+
+    if (allServers.size() < replicationFactor) {
+      TRI_V8_THROW_EXCEPTION_MESSAGE(TRI_ERROR_CLUSTER_UNSUPPORTED,
+                                     "replication factor is higher than the number of database servers");
+    }
+
+    sort(allServers.begin(), allServers.end());
+
+    for (auto const& shard : shards) {
+      size_t const leader = static_cast<size_t>(find(allServers.begin(), allServers.end(), shard.second) - allServers.begin());
+      auto& followers = shardFollowers[shard.first];
+
+      for (uint64_t i = 1; i < replicationFactor; ++i) {
+        followers.push_back(allServers[(leader + i) % allServers.size()]);
+      }
+    }
   }
 
   // now create the JSON for the collection
@@ -1085,6 +1585,25 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "shardKeys", JsonHelper::stringArray(TRI_UNKNOWN_MEM_ZONE, shardKeys));
   TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "shards", JsonHelper::stringObject(TRI_UNKNOWN_MEM_ZONE, shards));
 
+  if (prototype != nullptr) {
+    string const prototypeId = StringUtils::itoa(prototype->id());
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "distributeShardsLike", TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, prototypeId.c_str(), prototypeId.size()));
+  }
+
+  if (! shardFollowers.empty()) {
+    TRI_json_t* followers = TRI_CreateObjectJson(TRI_UNKNOWN_MEM_ZONE);
+
+    if (followers != nullptr) {
+      for (auto const& it : shardFollowers) {
+        TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, followers, it.first.c_str(), JsonHelper::stringArray(TRI_UNKNOWN_MEM_ZONE, it.second));
+      }
+
+      TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "shardFollowers", followers);
+    }
+
+    TRI_Insert3ObjectJson(TRI_UNKNOWN_MEM_ZONE, json, "writeConcern", TRI_CreateNumberJson(TRI_UNKNOWN_MEM_ZONE, (double) writeConcern));
+  }
+
   TRI_json_t* indexes = TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE);
 
   if (indexes == nullptr) {
@@ -1157,6 +1676,12 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
 ///
 /// **unique** can be *true* or *false* and is supported by *hash* or *skiplist*
 ///
+/// **filter** can be an object of attribute names and values for *hash* and
+/// *skiplist* indexes. The index then is a partial index, and only contains
+/// the documents with all of these attribute values. Queries use it only if
+/// their FILTER compares all of these attributes with the same values using
+/// `==`. Partial indexes are not used for sorting.
+///
 /// Calling this method returns an index object. Whether or not the index
 /// object existed before the call is indicated in the return attribute
 /// *isNewlyCreated*.
@@ -1167,6 +1692,7 @@ static void CreateCollectionCoordinator (const v8::FunctionCallbackInfo<v8::Valu
 /// ~db._create("test");
 /// db.test.ensureIndex({ type: "hash", fields: [ "a" ], sparse: true });
 /// db.test.ensureIndex({ type: "hash", fields: [ "a", "b" ], unique: true });
+/// db.test.ensureIndex({ type: "skiplist", fields: [ "created" ], filter: { status: "open" } });
 /// ~db._drop("test");
 /// @END_EXAMPLE_ARANGOSH_OUTPUT
 ///
@@ -1653,6 +2179,24 @@ static void CreateVocBase (const v8::FunctionCallbackInfo<v8::Value>& args,
         TRI_V8_THROW_EXCEPTION_PARAMETER("indexBuckets must be a two-power between 1 and 1024");
       }
     }
+
+    if (p->Has(TRI_V8_ASCII_STRING("stringDictionary"))) {
+      TRI_json_t* dictionary = TRI_ObjectToJson(isolate, p->Get(TRI_V8_ASCII_STRING("stringDictionary")));
+
+      // validate by building the shape once
+      TRI_shape_t* shape = TRI_CreateDictionaryStringShape(dictionary);
+
+      if (shape == nullptr) {
+        if (dictionary != nullptr) {
+          TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, dictionary);
+        }
+        TRI_FreeCollectionInfoOptions(&parameters);
+        TRI_V8_THROW_EXCEPTION_PARAMETER("stringDictionary must be an array of at most 65536 strings with at most 256 bytes each");
+      }
+
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, shape);
+      parameters._stringDictionary = dictionary;
+    }
   }
   else {
     TRI_InitCollectionInfo(vocbase, &parameters, name.c_str(), collectionType, effectiveSize, nullptr);
@@ -1738,6 +2282,13 @@ static void CreateVocBase (const v8::FunctionCallbackInfo<v8::Value>& args,
 ///   * *offset*: initial offset value for *autoincrement* key generator.
 ///     Not used for other key generator types.
 ///
+/// * *stringDictionary* (optional): an array of up to 65536 distinct strings
+///   of at most 256 bytes each. Attribute values equal to one of these
+///   strings are stored as a 4 byte code instead of the full string, which
+///   saves space for low-cardinality attributes such as status or country
+///   values. The dictionary cannot be changed once the collection is created
+///   and is not supported in a cluster.
+///
 /// * *numberOfShards* (optional, default is *1*): in a cluster, this value
 ///   determines the number of shards to create for the collection. In a single
 ///   server setup, this option is meaningless.
@@ -1765,6 +2316,15 @@ static void CreateVocBase (const v8::FunctionCallbackInfo<v8::Value>& args,
 ///   attribute and this can only be done efficiently if this is the
 ///   only shard key by delegating to the individual shards.
 ///
+/// * *distributeShardsLike* (optional): in a cluster, the name of another
+///   collection whose shard distribution the new collection follows. The new
+///   collection gets the same number of shards, which are placed on the same
+///   servers as the shards of the other collection. Documents with the same
+///   values in their shard key attributes are then stored on the same server
+///   in both collections, so that AQL can join the two collections on their
+///   shard keys on the DB servers. The number of shard keys must be the same
+///   in both collections.
+///
 /// `db._create(collection-name, properties, type)`
 ///
 /// Specifies the optional *type* of the collection, it can either be *document* 
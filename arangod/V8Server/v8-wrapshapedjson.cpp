@@ -262,8 +262,73 @@ static void WeakDocumentDitchCallback (const v8::WeakCallbackData<v8::External,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief private copy of a WAL marker owned by a ShapedJson object
+////////////////////////////////////////////////////////////////////////////////
+
+struct MarkerCopy {
+  v8::Persistent<v8::Object> _object;
+  char* _data;
+  size_t _size;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief weak reference callback for a marker copy
+////////////////////////////////////////////////////////////////////////////////
+
+static void WeakMarkerCopyCallback (const v8::WeakCallbackData<v8::Object, MarkerCopy>& data) {
+  auto isolate = data.GetIsolate();
+  auto copy    = data.GetParameter();
+
+  TRI_GET_GLOBALS();
+
+  v8g->decreaseActiveExternals();
+  isolate->AdjustAmountOfExternalAllocatedMemory(- static_cast<int64_t>(copy->_size));
+
+  LOG_TRACE("weak-callback for marker copy called");
+
+  copy->_object.Reset();
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, copy->_data);
+  delete copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copies a WAL marker. the logfile may be collected while the
+/// ShapedJson object is still alive, but the copy can be read lazily just
+/// like a marker in a datafile. returns nullptr if out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+static MarkerCopy* CopyWalMarker (TRI_df_marker_t const* marker) {
+  size_t const size = static_cast<size_t>(marker->_size);
+  char* data = static_cast<char*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, size, false));
+
+  if (data == nullptr) {
+    return nullptr;
+  }
+
+  MarkerCopy* copy = nullptr;
+
+  try {
+    copy = new MarkerCopy();
+  }
+  catch (...) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, data);
+    return nullptr;
+  }
+
+  memcpy(data, marker, size);
+  copy->_data = data;
+  copy->_size = size;
+
+  return copy;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wraps a TRI_shaped_json_t
+///
+/// the attributes are converted on first access only. markers that are still
+/// in the WAL are copied into memory owned by the object, which is much
+/// cheaper than converting the whole document upfront
 ////////////////////////////////////////////////////////////////////////////////
 
 v8::Handle<v8::Value> TRI_WrapShapedJson (v8::Isolate* isolate,
@@ -279,10 +344,19 @@ v8::Handle<v8::Value> TRI_WrapShapedJson (v8::Isolate* isolate,
   TRI_ASSERT(collection != nullptr);
 
   TRI_GET_GLOBALS();
-  bool const doCopy = TRI_IsWalDataMarkerDatafile(marker);
+  bool const isWal = TRI_IsWalDataMarkerDatafile(marker);
+  MarkerCopy* copy = nullptr;
+
+  if (isWal) {
+    copy = CopyWalMarker(marker);
+
+    if (copy != nullptr) {
+      marker = reinterpret_cast<TRI_df_marker_t const*>(copy->_data);
+    }
+  }
 
-  if (doCopy) {
-    // we'll create a full copy of the document
+  if (isWal && copy == nullptr) {
+    // out of memory for the copy, we'll create a full copy of the document
     auto shaper = collection->getShaper();  // PROTECTED by trx from above
 
     TRI_shaped_json_t json;
@@ -300,7 +374,7 @@ v8::Handle<v8::Value> TRI_WrapShapedJson (v8::Isolate* isolate,
     return scope.Escape<v8::Value>(TRI_JsonShapeData(isolate, result, shaper, shape, json._data.data, json._data.length));
   }
 
-  // we'll create a document stub, with a pointer into the datafile
+  // we'll create a document stub, with a pointer into the datafile or the copy
 
   // create the new handle to return, and set its template type
   TRI_GET_GLOBAL(ShapedJsonTempl, v8::ObjectTemplate);
@@ -308,9 +382,21 @@ v8::Handle<v8::Value> TRI_WrapShapedJson (v8::Isolate* isolate,
 
   if (result.IsEmpty()) {
     // error
+    if (copy != nullptr) {
+      TRI_Free(TRI_UNKNOWN_MEM_ZONE, copy->_data);
+      delete copy;
+    }
     return scope.Escape<v8::Value>(result);
   }
 
+  if (copy != nullptr) {
+    // the copy lives as long as the object
+    copy->_object.Reset(isolate, result);
+    copy->_object.SetWeak(copy, WeakMarkerCopyCallback);
+    isolate->AdjustAmountOfExternalAllocatedMemory(static_cast<int64_t>(copy->_size));
+    v8g->increaseActiveExternals();
+  }
+
   // point the 0 index Field to the c++ pointer for unwrapping later
   result->SetInternalField(SLOT_CLASS_TYPE, v8::Integer::New(isolate, WRP_SHAPED_JSON_TYPE));
   result->SetInternalField(SLOT_CLASS, v8::External::New(isolate, const_cast<void*>(static_cast<void const*>(marker))));
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache of verified credentials
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "AuthCache.h"
+
+#include "Basics/hashes.h"
+#include "Basics/MutexLocker.h"
+
+using namespace triagens::arango;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class AuthCache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time to live of an entry
+////////////////////////////////////////////////////////////////////////////////
+
+double AuthCache::Timeout = 600.0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+AuthCache::AuthCache ()
+  : _slots(new std::atomic<Entry*>[NumSlots]),
+    _protector(),
+    _generation(0),
+    _lock() {
+
+  for (size_t i = 0; i < NumSlots; ++i) {
+    _slots[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+AuthCache::~AuthCache () {
+  for (size_t i = 0; i < NumSlots; ++i) {
+    delete _slots[i].load(std::memory_order_relaxed);
+  }
+
+  // the replaced entries are freed by the protector
+  delete[] _slots;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a header value, returns false if it is not cached
+////////////////////////////////////////////////////////////////////////////////
+
+bool AuthCache::lookup (char const* header,
+                        std::string& username,
+                        bool& mustChange) {
+  uint64_t const hash = TRI_FnvHashString(header);
+
+  auto unuser(_protector.use());
+  Entry const* entry = _slots[hash & (NumSlots - 1)].load(std::memory_order_acquire);
+
+  if (entry == nullptr ||
+      entry->hash != hash ||
+      entry->generation != _generation.load(std::memory_order_acquire) ||
+      entry->header != header) {
+    return false;
+  }
+
+  if (entry->expires < TRI_microtime()) {
+    // leave it to insert to replace the entry
+    return false;
+  }
+
+  username = entry->username;
+  mustChange = entry->mustChange;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a verified header value
+////////////////////////////////////////////////////////////////////////////////
+
+void AuthCache::insert (char const* header,
+                        std::string const& username,
+                        bool mustChange,
+                        uint64_t generation) {
+  if (Timeout <= 0.0) {
+    return;
+  }
+
+  uint64_t const hash = TRI_FnvHashString(header);
+  Entry* entry = new Entry(hash, header, username, mustChange, generation, TRI_microtime() + Timeout);
+
+  MUTEX_LOCKER(_lock);
+
+  if (generation != _generation.load(std::memory_order_relaxed)) {
+    // the users have been reloaded since the credentials were verified
+    delete entry;
+    return;
+  }
+
+  Entry* old = _slots[hash & (NumSlots - 1)].exchange(entry, std::memory_order_acq_rel);
+
+  if (old != nullptr) {
+    _protector.retire(old);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidates all entries
+////////////////////////////////////////////////////////////////////////////////
+
+void AuthCache::invalidate () {
+  MUTEX_LOCKER(_lock);
+
+  // lookups reject the old entries from now on, and insert rejects entries
+  // verified before this point
+  _generation.fetch_add(1, std::memory_order_acq_rel);
+
+  for (size_t i = 0; i < NumSlots; ++i) {
+    Entry* old = _slots[i].exchange(nullptr, std::memory_order_acq_rel);
+
+    if (old != nullptr) {
+      _protector.retire(old);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
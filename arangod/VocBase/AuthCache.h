@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cache of verified credentials
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_AUTH_CACHE_H
+#define ARANGODB_VOC_BASE_AUTH_CACHE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/DataProtector.h"
+#include "Basics/Mutex.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class AuthCache
+// -----------------------------------------------------------------------------
+
+namespace triagens {
+  namespace arango {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maps authorization header values to the users they authenticate
+///
+/// a header value is only inserted after its password has been verified.
+/// lookups take no lock: the entries are immutable, and the slot of a value
+/// is picked by its hash. a hit costs one hash of the header value and one
+/// string comparison. entries expire after Timeout seconds, and all entries
+/// become invalid at once when the users are reloaded
+////////////////////////////////////////////////////////////////////////////////
+
+    class AuthCache {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+        struct Entry {
+          Entry (uint64_t hash,
+                 std::string const& header,
+                 std::string const& username,
+                 bool mustChange,
+                 uint64_t generation,
+                 double expires)
+            : hash(hash),
+              header(header),
+              username(username),
+              mustChange(mustChange),
+              generation(generation),
+              expires(expires) {
+          }
+
+          uint64_t const hash;
+          std::string const header;
+          std::string const username;
+          bool const mustChange;
+          uint64_t const generation;
+          double const expires;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        AuthCache (AuthCache const&) = delete;
+        AuthCache& operator= (AuthCache const&) = delete;
+
+        AuthCache ();
+
+        ~AuthCache ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a header value, returns false if it is not cached
+////////////////////////////////////////////////////////////////////////////////
+
+        bool lookup (char const* header,
+                     std::string& username,
+                     bool& mustChange);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current generation of the cache
+///
+/// the generation must be fetched before the credentials are verified, and
+/// be passed to insert, so that an entry verified against users that have
+/// been reloaded in between is not inserted
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t generation () const {
+          return _generation.load(std::memory_order_acquire);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a verified header value
+////////////////////////////////////////////////////////////////////////////////
+
+        void insert (char const* header,
+                     std::string const& username,
+                     bool mustChange,
+                     uint64_t generation);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidates all entries
+///
+/// the removed entries are freed once no lookup uses them anymore
+////////////////////////////////////////////////////////////////////////////////
+
+        void invalidate ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public variables
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time to live of an entry
+/// @startDocuBlock AuthenticationCacheTimeout
+/// `--server.authentication-cache-timeout value`
+///
+/// The number of seconds for which successfully verified credentials are
+/// remembered. Requests with the same *Authorization* header within this
+/// time are authenticated without hashing the password again. Changing or
+/// removing a user invalidates the remembered credentials immediately.
+///
+/// A value of *0* turns the cache off.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        static double Timeout;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of slots, must be a power of two
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NumSlots = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the slots, at most one entry per slot
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<Entry*>* _slots;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the entries used by lookups, and frees the replaced ones
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::DataProtector _protector;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the generation, incremented by invalidate
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<uint64_t> _generation;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes the writers
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _lock;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
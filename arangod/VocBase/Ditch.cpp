@@ -333,13 +333,20 @@ Ditch* Ditches::process (bool& popped,
   // to document data in a datafile. We must then not unload or remove a file
   if (type == Ditch::TRI_DITCH_DOCUMENT ||
       type == Ditch::TRI_DITCH_REPLICATION ||
-      type == Ditch::TRI_DITCH_COMPACTION ||
-      _numDocumentDitches > 0) {
+      type == Ditch::TRI_DITCH_COMPACTION) {
     // did not find anything at the head of the barrier list or found an element marker
     // this means we must exit and cannot throw away datafiles and can unload collections
     return nullptr;
   }
 
+  // unloading or dropping the collection must wait for all DocumentDitches,
+  // as even the newest ones reference data in the collection's datafiles
+  if ((type == Ditch::TRI_DITCH_COLLECTION_UNLOAD ||
+       type == Ditch::TRI_DITCH_COLLECTION_DROP) &&
+      _numDocumentDitches > 0) {
+    return nullptr;
+  }
+
   // no DocumentDitch at the head of the ditches list. This means that there is
   // some other action we can perform (i.e. unloading a datafile or a collection)
 
@@ -353,6 +360,8 @@ Ditch* Ditches::process (bool& popped,
   // ditches list after changing the pointers in all headers. After the pointers are
   // changed, it is safe to unload/remove an old datafile (that noone points to). And
   // any newer TRI_DITCH_DOCUMENTs will always reference data inside other datafiles.
+  // So readers that started after a datafile was compacted do not delay its
+  // removal, only readers that were already running do.
 
   if (! callback(ditch)) {
     return ditch;
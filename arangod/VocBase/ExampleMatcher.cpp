@@ -35,12 +35,41 @@
 #include "V8/v8-conv.h"
 #include "V8Server/v8-shape-conv.h"
 #include "V8Server/v8-vocbaseprivate.h"
+#include "VocBase/shape-accessor.h"
 #include "VocBase/VocShaper.h"
 
 using namespace std;
 using namespace triagens::arango;
 using namespace triagens::basics;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether an attribute is stored in the marker and not in the shaped
+/// json. such attributes can still have an attribute path, e.g. if an index
+/// was created on them
+////////////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of document shapes accessors are kept for
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxCompiledShapes = 1024;
+
+static bool IsInternalAttribute (char const* name) {
+  return (strcmp(name, TRI_VOC_ATTRIBUTE_KEY) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_REV) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_ID) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_FROM) == 0 ||
+          strcmp(name, TRI_VOC_ATTRIBUTE_TO) == 0);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private methods
+// -----------------------------------------------------------------------------
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief cleans up the example object
 ////////////////////////////////////////////////////////////////////////////////
@@ -55,6 +84,21 @@ void ExampleMatcher::cleanup () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the accessors of all example values for a document shape
+////////////////////////////////////////////////////////////////////////////////
+
+void ExampleMatcher::compileAccessors (TRI_shape_sid_t sid,
+                                       Accessors& accessors) const {
+  accessors.clear();
+
+  for (auto const& def : definitions) {
+    for (auto const& pid : def._pids) {
+      accessors.emplace_back(_shaper->findAccessor(sid, pid));
+    }
+  }
+}
+
 void ExampleMatcher::fillExampleDefinition (v8::Isolate* isolate,
                                             v8::Handle<v8::Object> const& example,
                                             v8::Handle<v8::Array> const& names,
@@ -80,7 +124,7 @@ void ExampleMatcher::fillExampleDefinition (v8::Isolate* isolate,
     v8::Handle<v8::Value> val = example->Get(key);
     TRI_Utf8ValueNFC keyStr(TRI_UNKNOWN_MEM_ZONE, key);
     if (*keyStr != nullptr) {
-      auto pid = _shaper->lookupAttributePathByName(*keyStr);
+      auto pid = IsInternalAttribute(*keyStr) ? 0 : _shaper->lookupAttributePathByName(*keyStr);
 
       if (pid == 0) {
         // Internal attributes do have pid == 0.
@@ -165,7 +209,7 @@ void ExampleMatcher::fillExampleDefinition (TRI_json_t const* example,
       auto keyObj = static_cast<TRI_json_t const*>(TRI_AtVector(&objects, i));
       TRI_ASSERT(TRI_IsStringJson(keyObj));
       char const* keyStr = keyObj->_value._string.data;
-      auto pid = _shaper->lookupAttributePathByName(keyStr);
+      auto pid = IsInternalAttribute(keyStr) ? 0 : _shaper->lookupAttributePathByName(keyStr);
 
       if (pid == 0) {
         // Internal attributes do have pid == 0.
@@ -340,7 +384,31 @@ bool ExampleMatcher::matches (TRI_voc_cid_t cid, TRI_doc_mptr_t const* mptr) con
   }
   TRI_shaped_json_t document;
   TRI_EXTRACT_SHAPED_JSON_MARKER(document, mptr->getDataPtr());
-  for (auto def : definitions) {
+
+  Accessors uncached;
+  Accessors const* accessors;
+  auto found = _accessors.find(document._sid);
+
+  if (found != _accessors.end()) {
+    accessors = &(*found).second;
+  }
+  else if (_accessors.size() < MaxCompiledShapes) {
+    auto& compiled = _accessors[document._sid];
+    compileAccessors(document._sid, compiled);
+    accessors = &compiled;
+  }
+  else {
+    compileAccessors(document._sid, uncached);
+    accessors = &uncached;
+  }
+
+  // position of the accessor of the first value of the current example
+  size_t offset = 0;
+
+  for (auto const& def : definitions) {
+    Accessors::const_iterator accessor = accessors->begin() + offset;
+    offset += def._values.size();
+
     if (def._internal.size() > 0) {
       // Match _key
       auto it = def._internal.find(internalAttr::key);
@@ -388,18 +456,19 @@ bool ExampleMatcher::matches (TRI_voc_cid_t cid, TRI_doc_mptr_t const* mptr) con
       }
     }
     TRI_shaped_json_t result;
-    TRI_shape_t const* shape;
 
-    for (size_t i = 0;  i < def._values.size();  ++i) {
+    for (size_t i = 0;  i < def._values.size();  ++i, ++accessor) {
       TRI_shaped_json_t* example = def._values[i];
 
-      bool ok = _shaper->extractShapedJson(&document,
-                                           example->_sid,
-                                           def._pids[i],
-                                           &result,
-                                           &shape);
+      // the shape of the value is known from the accessor, so values of
+      // another type are rejected without extracting them
+      if (*accessor == nullptr ||
+          (*accessor)->_resultShape == nullptr ||
+          (*accessor)->_resultSid != example->_sid) {
+        goto nextExample;
+      }
 
-      if (! ok || shape == nullptr) {
+      if (! TRI_ExecuteShapeAccessor(*accessor, &document, &result)) {
         goto nextExample;
       }
 
@@ -427,3 +496,77 @@ bool ExampleMatcher::matches (TRI_voc_cid_t cid, TRI_doc_mptr_t const* mptr) con
   }
   return false;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the values the examples require for a list of attributes
+///
+/// for each example, the values for the longest leading run of the given
+/// attributes that the example restricts are returned. returns false if an
+/// example does not restrict the first attribute, i.e. if the examples do
+/// not restrict the values of the first attribute at all
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExampleMatcher::requiredValues (std::vector<TRI_shape_pid_t> const& pids,
+                                     std::vector<std::vector<TRI_shaped_json_t const*>>& values) const {
+  TRI_ASSERT(! pids.empty());
+
+  values.clear();
+  values.reserve(definitions.size());
+
+  for (auto const& def : definitions) {
+    std::vector<TRI_shaped_json_t const*> prefix;
+
+    for (auto const& pid : pids) {
+      TRI_shaped_json_t const* value = nullptr;
+
+      for (size_t i = 0; i < def._pids.size(); ++i) {
+        if (def._pids[i] == pid) {
+          value = def._values[i];
+          break;
+        }
+      }
+
+      if (value == nullptr) {
+        break;
+      }
+      prefix.emplace_back(value);
+    }
+
+    if (prefix.empty()) {
+      values.clear();
+      return false;
+    }
+
+    values.emplace_back(std::move(prefix));
+  }
+
+  return ! values.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the document keys the examples require. returns false if
+/// an example does not restrict the key
+////////////////////////////////////////////////////////////////////////////////
+
+bool ExampleMatcher::requiredKeys (std::vector<std::string>& keys) const {
+  keys.clear();
+  keys.reserve(definitions.size());
+
+  for (auto const& def : definitions) {
+    auto it = def._internal.find(internalAttr::key);
+
+    if (it == def._internal.end()) {
+      // _id contains the key as well, the collection is checked by matches()
+      it = def._internal.find(internalAttr::id);
+    }
+
+    if (it == def._internal.end()) {
+      keys.clear();
+      return false;
+    }
+
+    keys.emplace_back(it->second.key);
+  }
+
+  return ! keys.empty();
+}
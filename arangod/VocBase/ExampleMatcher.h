@@ -39,6 +39,7 @@
 // -----------------------------------------------------------------------------
 
 struct TRI_doc_mptr_t;
+struct TRI_shape_access_s;
 class VocShaper;
 
 // -----------------------------------------------------------------------------
@@ -77,6 +78,19 @@ namespace triagens {
       VocShaper* _shaper;
       std::vector<ExampleDefinition> definitions;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the accessors for the values of all examples, per document shape.
+/// documents of a collection mostly have few shapes, so the accessors are
+/// looked up once per shape instead of once per document and value
+////////////////////////////////////////////////////////////////////////////////
+
+      typedef std::vector<struct TRI_shape_access_s const*> Accessors;
+
+      mutable std::unordered_map<TRI_shape_sid_t, Accessors> _accessors;
+
+      void compileAccessors (TRI_shape_sid_t,
+                             Accessors&) const;
+
       void fillExampleDefinition (TRI_json_t const* example,
                                   triagens::arango::CollectionNameResolver const* resolver,
                                   ExampleDefinition& def);
@@ -111,6 +125,11 @@ namespace triagens {
         bool matches (TRI_voc_cid_t cid, 
                       TRI_doc_mptr_t const* mptr) const;
 
+        bool requiredValues (std::vector<TRI_shape_pid_t> const& pids,
+                             std::vector<std::vector<TRI_shaped_json_t const*>>& values) const;
+
+        bool requiredKeys (std::vector<std::string>& keys) const;
+
       private:
 
         void cleanup ();
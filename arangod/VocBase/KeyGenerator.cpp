@@ -34,7 +34,6 @@
 #include "Basics/logging.h"
 #include "Basics/tri-strings.h"
 #include "Basics/voc-errors.h"
-#include "Basics/MutexLocker.h"
 #include "Basics/StringUtils.h"
 
 #include "VocBase/vocbase.h"
@@ -407,17 +406,16 @@ bool AutoIncrementKeyGenerator::validateKey (char const* key) {
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string AutoIncrementKeyGenerator::generate (TRI_voc_tick_t tick) {
+  uint64_t lastValue = _lastValue.load(std::memory_order_relaxed);
   uint64_t keyValue;
 
-  {
-    MUTEX_LOCKER(_lock);
-
+  do {
     // user has not specified a key, generate one based on algorithm
-    if (_lastValue < _offset) {
+    if (lastValue < _offset) {
       keyValue = _offset;
     }
     else {
-      uint64_t next = _lastValue + _increment - ((_lastValue - _offset) % _increment);
+      uint64_t next = lastValue + _increment - ((lastValue - _offset) % _increment);
 
       // TODO: check if we can remove the following if
       if (next < _offset) {
@@ -428,14 +426,14 @@ std::string AutoIncrementKeyGenerator::generate (TRI_voc_tick_t tick) {
     }
 
     // bounds and sanity checks
-    if (keyValue == UINT64_MAX || keyValue < _lastValue) {
+    if (keyValue == UINT64_MAX || keyValue < lastValue) {
       return "";
     }
 
-    TRI_ASSERT(keyValue > _lastValue);
-    // update our last value
-    _lastValue = keyValue;
+    TRI_ASSERT(keyValue > lastValue);
+    // update our last value, unless another thread was faster
   }
+  while (! _lastValue.compare_exchange_weak(lastValue, keyValue, std::memory_order_relaxed));
 
   return triagens::basics::StringUtils::itoa(keyValue);
 }
@@ -457,13 +455,7 @@ int AutoIncrementKeyGenerator::validate (std::string const& key,
     return TRI_ERROR_ARANGO_DOCUMENT_KEY_BAD;
   }
 
-  uint64_t intValue = triagens::basics::StringUtils::uint64(key);
-
-  if (intValue > _lastValue) {
-    MUTEX_LOCKER(_lock);
-    // update our last value
-    _lastValue = intValue;
-  }
+  update(triagens::basics::StringUtils::uint64(key));
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -474,11 +466,22 @@ int AutoIncrementKeyGenerator::validate (std::string const& key,
 
 void AutoIncrementKeyGenerator::track (TRI_voc_key_t key) {
   // check the numeric key part
-  uint64_t value = TRI_UInt64String(key);
+  update(TRI_UInt64String(key));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief raise the last value to at least the given value
+////////////////////////////////////////////////////////////////////////////////
+
+void AutoIncrementKeyGenerator::update (uint64_t value) {
+  uint64_t lastValue = _lastValue.load(std::memory_order_relaxed);
 
-  if (value > _lastValue) {
-    // and update our last value
-    _lastValue = value;
+  while (value > lastValue &&
+         ! _lastValue.compare_exchange_weak(lastValue, value, std::memory_order_relaxed)) {
   }
 }
 
@@ -31,7 +31,6 @@
 #define ARANGODB_VOC_BASE_KEY__GENERATOR_H 1
 
 #include "Basics/Common.h"
-#include "Basics/Mutex.h"
 
 #include "VocBase/vocbase.h"
 
@@ -337,14 +336,24 @@ class AutoIncrementKeyGenerator : public KeyGenerator {
     struct TRI_json_t* toJson (TRI_memory_zone_t*) const override;
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                 private variables
+// --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
 
   private:
 
-    triagens::basics::Mutex _lock;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief raise the last value to at least the given value
+////////////////////////////////////////////////////////////////////////////////
+
+    void update (uint64_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+  private:
 
-    uint64_t    _lastValue;     // last value assigned
+    std::atomic<uint64_t> _lastValue;     // last value assigned
 
     uint64_t    _offset;        // start value
 
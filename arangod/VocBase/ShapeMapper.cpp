@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json from a legend to a local shaper
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "ShapeMapper.h"
+#include "Basics/json.h"
+#include "Basics/string-buffer.h"
+#include "VocBase/VocShaper.h"
+
+using namespace triagens::arango;
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class ShapeMapper
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create a mapper for the given local shaper
+////////////////////////////////////////////////////////////////////////////////
+
+ShapeMapper::ShapeMapper (VocShaper* shaper)
+  : _shaper(shaper),
+    _sids(),
+    _mapped(0),
+    _converted(0) {
+}
+
+ShapeMapper::~ShapeMapper () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json, creating local shapes if required
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shaped_json_t* ShapeMapper::translate (LegendReader* legend,
+                                           TRI_shaped_json_t const* foreign) {
+  auto it = _sids.find(foreign->_sid);
+
+  if (it == _sids.end()) {
+    // first document with this shape: convert it and compare the shapes
+    TRI_shaped_json_t* shaped = convert(legend, foreign);
+
+    if (shaped != nullptr) {
+      TRI_shape_sid_t sid = 0;
+
+      if (isEquivalent(legend, foreign->_sid, shaped->_sid)) {
+        sid = shaped->_sid;
+      }
+
+      _sids.emplace(foreign->_sid, sid);
+    }
+
+    return shaped;
+  }
+
+  if ((*it).second == 0) {
+    return convert(legend, foreign);
+  }
+
+  // same layout, only the shape id differs
+  TRI_memory_zone_t* zone = _shaper->memoryZone();
+  auto shaped = static_cast<TRI_shaped_json_t*>(TRI_Allocate(zone, sizeof(TRI_shaped_json_t), false));
+
+  if (shaped == nullptr) {
+    return nullptr;
+  }
+
+  shaped->_sid = (*it).second;
+  shaped->_data.length = foreign->_data.length;
+  shaped->_data.data = nullptr;
+
+  if (foreign->_data.length > 0) {
+    shaped->_data.data = static_cast<char*>(TRI_Allocate(zone, foreign->_data.length, false));
+
+    if (shaped->_data.data == nullptr) {
+      TRI_Free(zone, shaped);
+      return nullptr;
+    }
+
+    memcpy(shaped->_data.data, foreign->_data.data, foreign->_data.length);
+  }
+
+  ++_mapped;
+
+  return shaped;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json via JSON
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shaped_json_t* ShapeMapper::convert (LegendReader* legend,
+                                         TRI_shaped_json_t const* foreign) {
+  TRI_string_buffer_t buffer;
+  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+
+  TRI_shaped_json_t* shaped = nullptr;
+
+  if (TRI_AppendCharStringBuffer(&buffer, '{') == TRI_ERROR_NO_ERROR &&
+      TRI_StringifyArrayShapedJson(legend, &buffer, foreign, false) &&
+      TRI_AppendCharStringBuffer(&buffer, '}') == TRI_ERROR_NO_ERROR) {
+    TRI_json_t* json = TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, TRI_BeginStringBuffer(&buffer));
+
+    if (json != nullptr) {
+      shaped = TRI_ShapedJsonJson(_shaper, json, true);
+      TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, json);
+    }
+  }
+
+  TRI_DestroyStringBuffer(&buffer);
+
+  if (shaped != nullptr) {
+    ++_converted;
+  }
+
+  return shaped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether data of a foreign shape can be read with a local shape
+////////////////////////////////////////////////////////////////////////////////
+
+bool ShapeMapper::isEquivalent (LegendReader* legend,
+                                TRI_shape_sid_t foreignSid,
+                                TRI_shape_sid_t localSid) {
+  if (foreignSid < Shaper::firstCustomShapeId() ||
+      localSid < Shaper::firstCustomShapeId()) {
+    // basic shapes have the same ids everywhere
+    return (foreignSid == localSid);
+  }
+
+  TRI_shape_t const* foreign = legend->lookupShapeId(foreignSid);
+  TRI_shape_t const* local = _shaper->lookupShapeId(localSid);
+
+  if (foreign == nullptr ||
+      local == nullptr ||
+      foreign->_type != local->_type ||
+      foreign->_size != local->_size ||
+      foreign->_dataSize != local->_dataSize) {
+    return false;
+  }
+
+  switch (foreign->_type) {
+    case TRI_SHAPE_NULL:
+    case TRI_SHAPE_BOOLEAN:
+    case TRI_SHAPE_NUMBER:
+    case TRI_SHAPE_SHORT_STRING:
+    case TRI_SHAPE_LONG_STRING: {
+      return true;
+    }
+
+    case TRI_SHAPE_DICTIONARY_STRING: {
+      // the data holds codes into the dictionary of the shape
+      return (memcmp(reinterpret_cast<char const*>(foreign) + sizeof(TRI_shape_t),
+                     reinterpret_cast<char const*>(local) + sizeof(TRI_shape_t),
+                     static_cast<size_t>(foreign->_size - sizeof(TRI_shape_t))) == 0);
+    }
+
+    case TRI_SHAPE_ARRAY: {
+      auto f = reinterpret_cast<TRI_array_shape_t const*>(foreign);
+      auto l = reinterpret_cast<TRI_array_shape_t const*>(local);
+
+      if (f->_fixedEntries != l->_fixedEntries ||
+          f->_variableEntries != l->_variableEntries) {
+        return false;
+      }
+
+      TRI_shape_size_t const n = f->_fixedEntries + f->_variableEntries;
+
+      char const* fp = reinterpret_cast<char const*>(f) + sizeof(TRI_array_shape_t);
+      char const* lp = reinterpret_cast<char const*>(l) + sizeof(TRI_array_shape_t);
+
+      auto fSids = reinterpret_cast<TRI_shape_sid_t const*>(fp);
+      auto lSids = reinterpret_cast<TRI_shape_sid_t const*>(lp);
+      auto fAids = reinterpret_cast<TRI_shape_aid_t const*>(fp + n * sizeof(TRI_shape_sid_t));
+      auto lAids = reinterpret_cast<TRI_shape_aid_t const*>(lp + n * sizeof(TRI_shape_sid_t));
+      auto fOffsets = reinterpret_cast<TRI_shape_size_t const*>(fAids + n);
+      auto lOffsets = reinterpret_cast<TRI_shape_size_t const*>(lAids + n);
+
+      if (memcmp(fOffsets, lOffsets, static_cast<size_t>((f->_fixedEntries + 1) * sizeof(TRI_shape_size_t))) != 0) {
+        return false;
+      }
+
+      for (TRI_shape_size_t i = 0; i < n; ++i) {
+        char const* fName = legend->lookupAttributeId(fAids[i]);
+        char const* lName = _shaper->lookupAttributeId(lAids[i]);
+
+        if (fName == nullptr ||
+            lName == nullptr ||
+            strcmp(fName, lName) != 0) {
+          return false;
+        }
+
+        if (! isEquivalent(legend, fSids[i], lSids[i])) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    case TRI_SHAPE_HOMOGENEOUS_LIST: {
+      auto f = reinterpret_cast<TRI_homogeneous_list_shape_t const*>(foreign);
+      auto l = reinterpret_cast<TRI_homogeneous_list_shape_t const*>(local);
+
+      return isEquivalent(legend, f->_sidEntry, l->_sidEntry);
+    }
+
+    case TRI_SHAPE_HOMOGENEOUS_SIZED_LIST: {
+      auto f = reinterpret_cast<TRI_homogeneous_sized_list_shape_t const*>(foreign);
+      auto l = reinterpret_cast<TRI_homogeneous_sized_list_shape_t const*>(local);
+
+      return (f->_sizeEntry == l->_sizeEntry &&
+              isEquivalent(legend, f->_sidEntry, l->_sidEntry));
+    }
+
+    case TRI_SHAPE_LIST: {
+      // the data contains the shape ids of the entries
+      return false;
+    }
+
+    case TRI_SHAPE_ILLEGAL: {
+      return false;
+    }
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json from a legend to a local shaper
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_VOC_BASE_SHAPE_MAPPER_H
+#define ARANGODB_VOC_BASE_SHAPE_MAPPER_H 1
+
+#include "Basics/Common.h"
+#include "VocBase/Legends.h"
+#include "VocBase/shaped-json.h"
+
+class VocShaper;
+
+namespace triagens {
+  namespace arango {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class ShapeMapper
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json described by a legend to a local shaper
+///
+/// The first document of a foreign shape is converted to JSON and shaped
+/// again. If the resulting local shape has the same layout as the foreign
+/// one, i.e. the same attribute names in the same order, the same offsets
+/// and equivalent sub-shapes, the mapping is remembered and all further
+/// documents of the foreign shape are translated by replacing the shape id
+/// only. Shapes with inhomogeneous lists store shape ids in the data and
+/// always take the slow path.
+////////////////////////////////////////////////////////////////////////////////
+
+    class ShapeMapper {
+
+      public:
+
+        ShapeMapper (ShapeMapper const&) = delete;
+        ShapeMapper& operator= (ShapeMapper const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        explicit ShapeMapper (VocShaper*);
+
+        ~ShapeMapper ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json, creating local shapes if required
+///
+/// the result is allocated in the memory zone of the local shaper and must be
+/// freed with TRI_FreeShapedJson. returns nullptr on error
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shaped_json_t* translate (triagens::basics::LegendReader*,
+                                      TRI_shaped_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents translated by replacing the shape id
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t mapped () const {
+          return _mapped;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents translated via JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t converted () const {
+          return _converted;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief translates shaped json via JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_shaped_json_t* convert (triagens::basics::LegendReader*,
+                                    TRI_shaped_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether data of a foreign shape can be read with a local shape
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isEquivalent (triagens::basics::LegendReader*,
+                           TRI_shape_sid_t,
+                           TRI_shape_sid_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the local shaper
+////////////////////////////////////////////////////////////////////////////////
+
+        VocShaper* _shaper;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief local shape ids of foreign shape ids, 0 if the data of the foreign
+/// shape must be converted
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<TRI_shape_sid_t, TRI_shape_sid_t> _sids;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents translated by replacing the shape id
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _mapped;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of documents translated via JSON
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _converted;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -30,13 +30,8 @@
 
 #include "VocShaper.h"
 #include "Basics/Exceptions.h"
-#include "Basics/fasthash.h"
 #include "Basics/Mutex.h"
 #include "Basics/MutexLocker.h"
-#include "Basics/ReadLocker.h"
-#include "Basics/ReadWriteLock.h"
-#include "Basics/WriteLocker.h"
-#include "Basics/associative.h"
 #include "Basics/hashes.h"
 #include "Basics/logging.h"
 #include "Basics/tri-strings.h"
@@ -91,7 +86,7 @@ static inline char const* GetAttributeName (void const* marker) {
 /// @brief hashs the attribute name of a key
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashKeyAttributeName (TRI_associative_pointer_t*, void const* key) {
+static uint64_t HashKeyAttributeName (void const* key) {
   return TRI_FnvHashString((char const*) key);
 }
 
@@ -99,7 +94,7 @@ static uint64_t HashKeyAttributeName (TRI_associative_pointer_t*, void const* ke
 /// @brief hashs the attribute name of an element
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashElementAttributeName (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashElementAttributeName (void const* element) {
   return TRI_FnvHashString(GetAttributeName(element));
 }
 
@@ -107,7 +102,7 @@ static uint64_t HashElementAttributeName (TRI_associative_pointer_t*, void const
 /// @brief compares an attribute name and an attribute
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualKeyAttributeName (TRI_associative_pointer_t*, void const* key, void const* element) {
+static bool EqualKeyAttributeName (void const* key, void const* element) {
   return TRI_EqualString((char const*) key, GetAttributeName(element));
 }
 
@@ -115,7 +110,7 @@ static bool EqualKeyAttributeName (TRI_associative_pointer_t*, void const* key,
 /// @brief hashes the attribute id
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashKeyAttributeId (TRI_associative_pointer_t*, void const* key) {
+static uint64_t HashKeyAttributeId (void const* key) {
   TRI_shape_aid_t const* k = static_cast<TRI_shape_aid_t const*>(key);
   return TRI_FnvHashPointer(k, sizeof(TRI_shape_aid_t));
 }
@@ -124,7 +119,7 @@ static uint64_t HashKeyAttributeId (TRI_associative_pointer_t*, void const* key)
 /// @brief hashes the attribute
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashElementAttributeId (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashElementAttributeId (void const* element) {
   TRI_shape_aid_t aid = GetAttributeId(element);
   return TRI_FnvHashPointer(&aid, sizeof(TRI_shape_aid_t));
 }
@@ -133,7 +128,7 @@ static uint64_t HashElementAttributeId (TRI_associative_pointer_t*, void const*
 /// @brief compares an attribute name and an attribute
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualKeyAttributeId (TRI_associative_pointer_t*, void const* key, void const* element) {
+static bool EqualKeyAttributeId (void const* key, void const* element) {
   TRI_shape_aid_t const* k = static_cast<TRI_shape_aid_t const*>(key);
   TRI_shape_aid_t aid = GetAttributeId(element);
 
@@ -144,7 +139,7 @@ static bool EqualKeyAttributeId (TRI_associative_pointer_t*, void const* key, vo
 /// @brief hashes the shapes
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashElementShape (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashElementShape (void const* element) {
   auto shape = static_cast<TRI_shape_t const*>(element);
   TRI_ASSERT(shape != nullptr);
   char const* s = reinterpret_cast<char const*>(shape);
@@ -155,7 +150,7 @@ static uint64_t HashElementShape (TRI_associative_pointer_t*, void const* elemen
 /// @brief compares shapes
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualElementShape (TRI_associative_pointer_t*, void const* left, void const* right) {
+static bool EqualElementShape (void const* left, void const* right) {
   auto l = static_cast<TRI_shape_t const*>(left);
   auto r = static_cast<TRI_shape_t const*>(right);
   char const* ll = reinterpret_cast<char const*>(l);
@@ -171,7 +166,7 @@ static bool EqualElementShape (TRI_associative_pointer_t*, void const* left, voi
 /// @brief hashes the shape id
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashKeyShapeId (TRI_associative_pointer_t*, void const* key) {
+static uint64_t HashKeyShapeId (void const* key) {
   auto k = static_cast<TRI_shape_sid_t const*>(key);
   return TRI_FnvHashPointer(k, sizeof(TRI_shape_sid_t));
 }
@@ -180,7 +175,7 @@ static uint64_t HashKeyShapeId (TRI_associative_pointer_t*, void const* key) {
 /// @brief hashes the shape
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashElementShapeId (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashElementShapeId (void const* element) {
   auto shape = static_cast<TRI_shape_t const*>(element);
   TRI_ASSERT(shape != nullptr);
   return TRI_FnvHashPointer(&shape->_sid, sizeof(TRI_shape_sid_t));
@@ -190,7 +185,7 @@ static uint64_t HashElementShapeId (TRI_associative_pointer_t*, void const* elem
 /// @brief compares a shape id and a shape
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualKeyShapeId (TRI_associative_pointer_t*, void const* key, void const* element) {
+static bool EqualKeyShapeId (void const* key, void const* element) {
   auto k = static_cast<TRI_shape_sid_t const*>(key);
   auto shape = static_cast<TRI_shape_t const*>(element);
   TRI_ASSERT(shape != nullptr);
@@ -202,7 +197,7 @@ static bool EqualKeyShapeId (TRI_associative_pointer_t*, void const* key, void c
 /// @brief hashes the accessor
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashElementAccessor (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashElementAccessor (void const* element) {
   auto ee = static_cast<TRI_shape_access_t const*>(element);
   uint64_t v[2];
 
@@ -216,18 +211,38 @@ static uint64_t HashElementAccessor (TRI_associative_pointer_t*, void const* ele
 /// @brief compares an accessor
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualElementAccessor (TRI_associative_pointer_t*, void const* left, void const* right) {
+static bool EqualElementAccessor (void const* left, void const* right) {
   auto l = static_cast<TRI_shape_access_t const*>(left);
   auto r = static_cast<TRI_shape_access_t const*>(right);
 
   return l->_sid == r->_sid && l->_pid == r->_pid;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hashes the shape id of a stringification template
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t HashElementShapeTemplate (void const* element) {
+  auto tpl = static_cast<TRI_shape_template_t const*>(element);
+  return TRI_FnvHashPointer(&tpl->_sid, sizeof(TRI_shape_sid_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a shape id and a stringification template
+////////////////////////////////////////////////////////////////////////////////
+
+static bool EqualKeyShapeTemplate (void const* key, void const* element) {
+  auto k = static_cast<TRI_shape_sid_t const*>(key);
+  auto tpl = static_cast<TRI_shape_template_t const*>(element);
+
+  return *k == tpl->_sid;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief hashes the attribute path identifier
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashPidKeyAttributePath (TRI_associative_pointer_t*, void const* key) {
+static uint64_t HashPidKeyAttributePath (void const* key) {
   return TRI_FnvHashPointer(key, sizeof(TRI_shape_pid_t));
 }
 
@@ -235,7 +250,7 @@ static uint64_t HashPidKeyAttributePath (TRI_associative_pointer_t*, void const*
 /// @brief hashs the attribute path
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashPidElementAttributePath (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashPidElementAttributePath (void const* element) {
   auto e = static_cast<TRI_shape_path_t const*>(element);
 
   return TRI_FnvHashPointer(&e->_pid, sizeof(TRI_shape_pid_t));
@@ -245,7 +260,7 @@ static uint64_t HashPidElementAttributePath (TRI_associative_pointer_t*, void co
 /// @brief compares an attribute path identifier and an attribute path
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualPidKeyAttributePath (TRI_associative_pointer_t*, void const* key, void const* element) {
+static bool EqualPidKeyAttributePath (void const* key, void const* element) {
   auto k = static_cast<TRI_shape_pid_t const*>(key);
   auto e = static_cast<TRI_shape_path_t const*>(element);
 
@@ -256,7 +271,7 @@ static bool EqualPidKeyAttributePath (TRI_associative_pointer_t*, void const* ke
 /// @brief hashs the attribute path name
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashNameKeyAttributePath (TRI_associative_pointer_t*, void const* key) {
+static uint64_t HashNameKeyAttributePath (void const* key) {
   return TRI_FnvHashString(static_cast<char const*>(key));
 }
 
@@ -264,7 +279,7 @@ static uint64_t HashNameKeyAttributePath (TRI_associative_pointer_t*, void const
 /// @brief hashs the attribute path
 ////////////////////////////////////////////////////////////////////////////////
 
-static uint64_t HashNameElementAttributePath (TRI_associative_pointer_t*, void const* element) {
+static uint64_t HashNameElementAttributePath (void const* element) {
   char const* e = static_cast<char const*>(element);
   TRI_shape_path_t const* ee = static_cast<TRI_shape_path_t const*>(element);
 
@@ -276,7 +291,7 @@ static uint64_t HashNameElementAttributePath (TRI_associative_pointer_t*, void c
 /// @brief compares an attribute name and an attribute
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool EqualNameKeyAttributePath (TRI_associative_pointer_t*, void const* key, void const* element) {
+static bool EqualNameKeyAttributePath (void const* key, void const* element) {
   char const* k = static_cast<char const*>(key);
   char const* e = static_cast<char const*>(element);
   TRI_shape_path_t const* ee = static_cast<TRI_shape_path_t const*>(element);
@@ -301,61 +316,50 @@ VocShaper::VocShaper (TRI_memory_zone_t* memoryZone,
   : Shaper(),
     _memoryZone(memoryZone),
     _collection(document),
+    _attributePathsByName(HashNameKeyAttributePath, HashNameElementAttributePath, EqualNameKeyAttributePath),
+    _attributePathsByPid(HashPidKeyAttributePath, HashPidElementAttributePath, EqualPidKeyAttributePath),
+    _attributeNames(HashKeyAttributeName, HashElementAttributeName, EqualKeyAttributeName),
+    _attributeIds(HashKeyAttributeId, HashElementAttributeId, EqualKeyAttributeId),
+    _shapeDictionary(HashElementShape, HashElementShape, EqualElementShape),
+    _shapeIds(HashKeyShapeId, HashElementShapeId, EqualKeyShapeId),
+    _accessors(HashElementAccessor, HashElementAccessor, EqualElementAccessor),
+    _templates(HashKeyShapeId, HashElementShapeTemplate, EqualKeyShapeTemplate),
+    _dictionaryCodes(),
+    _dictionaryShape(nullptr),
+    _dictionaryMinLength(0),
+    _dictionaryMaxLength(0),
+    _dictionarySid(0),
     _nextPid(1), 
     _nextAid(1),                                // id of next attribute to hand out
     _nextSid(Shaper::firstCustomShapeId()) {    // id of next shape to hand out
 
-  TRI_InitAssociativePointer(&_attributeNames,
-                             TRI_UNKNOWN_MEM_ZONE,
-                             HashKeyAttributeName,
-                             HashElementAttributeName,
-                             EqualKeyAttributeName,
-                             0);
-  
-  TRI_InitAssociativePointer(&_attributeIds,
-                             TRI_UNKNOWN_MEM_ZONE,
-                             HashKeyAttributeId,
-                             HashElementAttributeId,
-                             EqualKeyAttributeId,
-                             0);
+  if (document->_info._stringDictionary == nullptr) {
+    return;
+  }
 
-  
-  TRI_InitAssociativePointer(&_shapeDictionary,
-                             TRI_UNKNOWN_MEM_ZONE,
-                             0,
-                             HashElementShape,
-                             0,
-                             EqualElementShape);
-  
-  TRI_InitAssociativePointer(&_shapeIds,
-                             TRI_UNKNOWN_MEM_ZONE,
-                             HashKeyShapeId,
-                             HashElementShapeId,
-                             EqualKeyShapeId,
-                             0);
-
-  for (size_t i = 0; i < NUM_SHAPE_ACCESSORS; ++i) {
-    TRI_InitAssociativePointer(&_accessors[i],
-                               TRI_UNKNOWN_MEM_ZONE,
-                               0,
-                               HashElementAccessor,
-                               0,
-                               EqualElementAccessor);
+  _dictionaryShape = TRI_CreateDictionaryStringShape(document->_info._stringDictionary);
+
+  if (_dictionaryShape == nullptr) {
+    LOG_WARNING("ignoring invalid string dictionary of collection '%s'", document->_info._name);
+    return;
   }
-  
-  TRI_InitAssociativePointer(&_attributePathsByName,
-                             _memoryZone,
-                             HashNameKeyAttributePath,
-                             HashNameElementAttributePath,
-                             EqualNameKeyAttributePath,
-                             0);
-
-  TRI_InitAssociativePointer(&_attributePathsByPid,
-                             _memoryZone,
-                             HashPidKeyAttributePath,
-                             HashPidElementAttributePath,
-                             EqualPidKeyAttributePath,
-                             0);
+
+  auto shape = reinterpret_cast<TRI_dictionary_string_shape_t const*>(_dictionaryShape);
+  _dictionaryCodes.reserve(shape->_numberOfValues);
+  _dictionaryMinLength = SIZE_MAX;
+
+  for (TRI_shape_dictionary_code_t code = 0;  code < shape->_numberOfValues;  ++code) {
+    char const* value;
+    size_t length;
+
+    TRI_ValueDictionaryStringShape(shape, code, &value, &length);
+    _dictionaryCodes.emplace_back(std::string(value, length), code);
+
+    _dictionaryMinLength = (std::min)(_dictionaryMinLength, length);
+    _dictionaryMaxLength = (std::max)(_dictionaryMaxLength, length);
+  }
+
+  std::sort(_dictionaryCodes.begin(), _dictionaryCodes.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -363,35 +367,22 @@ VocShaper::VocShaper (TRI_memory_zone_t* memoryZone,
 ////////////////////////////////////////////////////////////////////////////////
 
 VocShaper::~VocShaper () {
-  size_t const n = _attributePathsByName._nrAlloc;
-
   // only free pointers in attributePathsByName
   // (attributePathsByPid contains the same pointers!)
-  for (size_t i = 0; i < n; ++i) {
-    void* data = _attributePathsByName._table[i];
-
-    if (data != nullptr) {
-      TRI_Free(_memoryZone, data);
-    }
-  }
+  _attributePathsByName.invokeOnAllElements([this] (void* data) {
+    TRI_Free(_memoryZone, data);
+  });
 
-  TRI_DestroyAssociativePointer(&_attributePathsByName);
-  TRI_DestroyAssociativePointer(&_attributePathsByPid);
+  _accessors.invokeOnAllElements([] (void* data) {
+    TRI_FreeShapeAccessor(static_cast<TRI_shape_access_t*>(data));
+  });
 
-  TRI_DestroyAssociativePointer(&_attributeNames);
-  TRI_DestroyAssociativePointer(&_attributeIds);
-  TRI_DestroyAssociativePointer(&_shapeDictionary);
-  TRI_DestroyAssociativePointer(&_shapeIds);
+  _templates.invokeOnAllElements([] (void* data) {
+    TRI_FreeShapeTemplate(static_cast<TRI_shape_template_t*>(data));
+  });
 
-  for (size_t i = 0; i < NUM_SHAPE_ACCESSORS; ++i) {
-    for (size_t j = 0; j < _accessors[i]._nrAlloc; ++j) {
-      auto accessor = static_cast<TRI_shape_access_t*>(_accessors[i]._table[j]);
-
-      if (accessor != nullptr) { 
-        TRI_FreeShapeAccessor(accessor);
-      }
-    }
-    TRI_DestroyAssociativePointer(&_accessors[i]);
+  if (_dictionaryShape != nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, _dictionaryShape);
   }
 }
 
@@ -407,9 +398,7 @@ TRI_shape_t const* VocShaper::lookupShapeId (TRI_shape_sid_t sid) {
   TRI_shape_t const* shape = Shaper::lookupSidBasicShape(sid);
 
   if (shape == nullptr) {
-    READ_LOCKER(_shapeIdsLock);
-
-    shape = static_cast<TRI_shape_t const*>(TRI_LookupByKeyAssociativePointer(&_shapeIds, &sid));
+    shape = static_cast<TRI_shape_t const*>(_shapeIds.lookup(&sid));
   }
 
   return shape;
@@ -420,14 +409,10 @@ TRI_shape_t const* VocShaper::lookupShapeId (TRI_shape_sid_t sid) {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* VocShaper::lookupAttributeId (TRI_shape_aid_t aid) {
-  {
-    READ_LOCKER(_attributeIdsLock);
-  
-    auto element = static_cast<void const*>(TRI_LookupByKeyAssociativePointer(&_attributeIds, &aid));
+  void const* element = _attributeIds.lookup(&aid);
 
-    if (element != nullptr) {
-      return GetAttributeName(element);
-    }
+  if (element != nullptr) {
+    return GetAttributeName(element);
   }
 
   return nullptr;
@@ -438,9 +423,7 @@ char const* VocShaper::lookupAttributeId (TRI_shape_aid_t aid) {
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_shape_path_t const* VocShaper::lookupAttributePathByPid (TRI_shape_pid_t pid) {
-  READ_LOCKER(_attributePathsByPidLock);
-
-  return static_cast<TRI_shape_path_t const*>(TRI_LookupByKeyAssociativePointer(&_attributePathsByPid, &pid));
+  return static_cast<TRI_shape_path_t const*>(_attributePathsByPid.lookup(&pid));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -481,14 +464,10 @@ char const* VocShaper::attributeNameShapePid (TRI_shape_pid_t pid) {
 TRI_shape_aid_t VocShaper::lookupAttributeByName (char const* name) {
   TRI_ASSERT(name != nullptr);
 
-  {
-    READ_LOCKER(_attributeNamesLock);
-  
-    auto element = static_cast<void const*>(TRI_LookupByKeyAssociativePointer(&_attributeNames, name));
+  void const* element = _attributeNames.lookup(name);
 
-    if (element != nullptr) {
-      return GetAttributeId(element);
-    }
+  if (element != nullptr) {
+    return GetAttributeId(element);
   }
 
   return 0;
@@ -520,11 +499,7 @@ TRI_shape_aid_t VocShaper::findOrCreateAttributeByName (char const* name) {
     {
       MUTEX_LOCKER(_attributeCreateLock);
 
-      void const* p;
-      {
-        READ_LOCKER(_attributeNamesLock);
-        p = TRI_LookupByKeyAssociativePointer(&_attributeNames, name);
-      }
+      void const* p = _attributeNames.lookup(name);
 
       // if the element appeared, return the aid
       if (p != nullptr) {
@@ -544,18 +519,18 @@ TRI_shape_aid_t VocShaper::findOrCreateAttributeByName (char const* name) {
       }
 
       void* TRI_UNUSED f;
-      {
-        WRITE_LOCKER(_attributeIdsLock);
-        f = TRI_InsertKeyAssociativePointer(&_attributeIds, &aid, const_cast<void*>(slotInfo.mem), false);
-      }
+      int res = _attributeIds.insert(&aid, const_cast<void*>(slotInfo.mem), false, &f);
       TRI_ASSERT(f == nullptr);
 
       // enter into the dictionaries
-      {
-        WRITE_LOCKER(_attributeNamesLock);
-        f = TRI_InsertKeyAssociativePointer(&_attributeNames, name, const_cast<void*>(slotInfo.mem), false);
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = _attributeNames.insert(name, const_cast<void*>(slotInfo.mem), false, &f);
+        TRI_ASSERT(f == nullptr);
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
       }
-      TRI_ASSERT(f == nullptr);
     }
 
     return aid;
@@ -585,8 +560,7 @@ TRI_shape_t const* VocShaper::findShape (TRI_shape_t* shape,
   TRI_shape_t const* found = Shaper::lookupBasicShape(shape);
 
   if (found == nullptr) {
-    READ_LOCKER(_shapeDictionaryLock);
-    found = static_cast<TRI_shape_t const*>(TRI_LookupByElementAssociativePointer(&_shapeDictionary, shape));
+    found = static_cast<TRI_shape_t const*>(_shapeDictionary.lookup(shape));
   }
 
   // shape found, free argument and return
@@ -615,10 +589,7 @@ TRI_shape_t const* VocShaper::findShape (TRI_shape_t* shape,
     // lock the index and check the element is still missing
     MUTEX_LOCKER(_shapeCreateLock);
 
-    {
-      READ_LOCKER(_shapeDictionaryLock);
-      found = static_cast<TRI_shape_t const*>(TRI_LookupByElementAssociativePointer(&_shapeDictionary, shape));
-    }
+    found = static_cast<TRI_shape_t const*>(_shapeDictionary.lookup(shape));
 
     if (found != nullptr) {
       TRI_Free(TRI_UNKNOWN_MEM_ZONE, shape);
@@ -641,25 +612,33 @@ TRI_shape_t const* VocShaper::findShape (TRI_shape_t* shape,
     TRI_shape_t const* result = reinterpret_cast<TRI_shape_t const*>(m);
 
     {
-      WRITE_LOCKER(_shapeIdsLock);
-      void* f = TRI_InsertKeyAssociativePointer(&_shapeIds, &sid, (void*) m, false);
+      void* f;
+      int res = _shapeIds.insert(&sid, (void*) m, false, &f);
 
       if (f != nullptr) {
         LOG_ERROR("logic error when inserting shape into id dictionary");
       }
 
       TRI_ASSERT(f == nullptr); // will abort here
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
     }
 
     {
-      WRITE_LOCKER(_shapeDictionaryLock);
-      void* f = TRI_InsertElementAssociativePointer(&_shapeDictionary, (void*) m, false);
+      void* f;
+      int res = _shapeDictionary.insert(m, (void*) m, false, &f);
 
       if (f != nullptr) {
         LOG_ERROR("logic error when inserting shape into dictionary");
       }
 
       TRI_ASSERT(f == nullptr); // will abort here
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
     }
 
     TRI_Free(TRI_UNKNOWN_MEM_ZONE, shape);
@@ -679,6 +658,60 @@ TRI_shape_t const* VocShaper::findShape (TRI_shape_t* shape,
   return nullptr;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the dictionary code of a string value
+////////////////////////////////////////////////////////////////////////////////
+
+bool VocShaper::lookupDictionaryCode (char const* value,
+                                      size_t length,
+                                      bool create,
+                                      TRI_shape_sid_t* sid,
+                                      TRI_shape_dictionary_code_t* code) {
+  if (length < _dictionaryMinLength || length > _dictionaryMaxLength) {
+    // also true if there is no dictionary
+    return false;
+  }
+
+  // binary search, comparing like std::string does
+  size_t lo = 0;
+  size_t hi = _dictionaryCodes.size();
+
+  while (lo < hi) {
+    size_t const mid = lo + (hi - lo) / 2;
+    std::string const& other = _dictionaryCodes[mid].first;
+    int res = memcmp(other.c_str(), value, (std::min)(other.size(), length));
+
+    if (res == 0) {
+      if (other.size() == length) {
+        TRI_shape_sid_t s = _dictionarySid.load();
+
+        if (s == 0) {
+          s = findDictionaryShape(create);
+
+          if (s == 0) {
+            return false;
+          }
+        }
+
+        *sid = s;
+        *code = _dictionaryCodes[mid].second;
+        return true;
+      }
+
+      res = (other.size() < length ? -1 : 1);
+    }
+
+    if (res < 0) {
+      lo = mid + 1;
+    }
+    else {
+      hi = mid;
+    }
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief move a shape marker, called during compaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -693,11 +726,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
 
     if (expectedOldPosition != nullptr) {
       char* old = static_cast<char*>(expectedOldPosition);
-      void const* found;
-      {
-        READ_LOCKER(_shapeIdsLock);
-        found = TRI_LookupByKeyAssociativePointer(&_shapeIds, &l->_sid);
-      }
+      void const* found = _shapeIds.lookup(&l->_sid);
 
       if (found != nullptr) {
         if (old + sizeof(TRI_df_shape_marker_t) != found &&
@@ -714,10 +743,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
     // remove the old marker
     // and re-insert the marker with the new pointer
     void* f;
-    {
-      WRITE_LOCKER(_shapeIdsLock);
-      f = TRI_InsertKeyAssociativePointer(&_shapeIds, &l->_sid, l, true);
-    }
+    _shapeIds.insert(&l->_sid, l, true, &f);
 
     // note: this assertion is wrong if the recovery collects the shape in the WAL and it has not been transferred
     // into the collection datafile yet
@@ -728,10 +754,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
 
     // same for the shape dictionary
     // delete and re-insert
-    {
-      WRITE_LOCKER(_shapeDictionaryLock);
-      f = TRI_InsertElementAssociativePointer(&_shapeDictionary, l, true);
-    }
+    _shapeDictionary.insert(l, l, true, &f);
 
     // note: this assertion is wrong if the recovery collects the shape in the WAL and it has not been transferred
     // into the collection datafile yet
@@ -747,11 +770,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
     MUTEX_LOCKER(_attributeCreateLock);
     
     if (expectedOldPosition != nullptr) {
-      void const* found;
-      {
-        READ_LOCKER(_attributeNamesLock);
-        found = TRI_LookupByKeyAssociativePointer(&_attributeNames, p);
-      }
+      void const* found = _attributeNames.lookup(p);
 
       if (found != nullptr && found != expectedOldPosition) {
         // do not insert if position doesn't match the expectation
@@ -766,10 +785,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
     // are identical in old and new marker)
     // and re-insert same attribute with adjusted pointer
     void* f;
-    {
-      WRITE_LOCKER(_attributeNamesLock);
-      f = TRI_InsertKeyAssociativePointer(&_attributeNames, p, m, true);
-    }
+    _attributeNames.insert(p, m, true, &f);
 
     // note: this assertion is wrong if the recovery collects the attribute in the WAL and it has not been transferred
     // into the collection datafile yet
@@ -780,10 +796,7 @@ int VocShaper::moveMarker (TRI_df_marker_t* marker,
 
     // same for attribute ids
     // delete and re-insert same attribute with adjusted pointer
-    {
-      WRITE_LOCKER(_attributeIdsLock);
-      f = TRI_InsertKeyAssociativePointer(&_attributeIds, &m->_aid, m, true);
-    }
+    _attributeIds.insert(&m->_aid, m, true, &f);
 
     // note: this assertion is wrong if the recovery collects the attribute in the WAL and it has not been transferred
     // into the collection datafile yet
@@ -821,14 +834,15 @@ int VocShaper::insertShape (TRI_df_marker_t const* marker,
   MUTEX_LOCKER(_shapeCreateLock);
 
   void* f;
-  {
-    WRITE_LOCKER(_shapeDictionaryLock);
-    f = TRI_InsertElementAssociativePointer(&_shapeDictionary, l, false);
+  int res = _shapeDictionary.insert(l, l, false, &f);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
   }
 
   if (warnIfDuplicate && f != nullptr) {
     char const* name = _collection->_info._name;
-    bool const isIdentical = EqualElementShape(nullptr, f, l); 
+    bool const isIdentical = EqualElementShape(f, l); 
     if (isIdentical) {
       // duplicate shape, but with identical content. simply ignore it
       LOG_TRACE("found duplicate shape markers for id %llu in collection '%s' in shape dictionary", (unsigned long long) l->_sid, name);
@@ -841,14 +855,15 @@ int VocShaper::insertShape (TRI_df_marker_t const* marker,
     }
   }
 
-  {
-    WRITE_LOCKER(_shapeIdsLock);
-    f = TRI_InsertKeyAssociativePointer(&_shapeIds, &l->_sid, l, false);
+  res = _shapeIds.insert(&l->_sid, l, false, &f);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
   }
 
   if (warnIfDuplicate && f != nullptr) {
     char const* name = _collection->_info._name;
-    bool const isIdentical = EqualElementShape(nullptr, f, l); 
+    bool const isIdentical = EqualElementShape(f, l); 
 
     if (isIdentical) {
       // duplicate shape, but with identical content. simply ignore it
@@ -898,9 +913,10 @@ int VocShaper::insertAttribute (TRI_df_marker_t const* marker,
   MUTEX_LOCKER(_attributeCreateLock);
 
   void* found;
-  {
-    WRITE_LOCKER(_attributeNamesLock);
-    found = TRI_InsertKeyAssociativePointer(&_attributeNames, name, (void*) marker, false);
+  int res = _attributeNames.insert(name, (void*) marker, false, &found);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
   }
 
   if (warnIfDuplicate && found != nullptr) {
@@ -916,9 +932,10 @@ int VocShaper::insertAttribute (TRI_df_marker_t const* marker,
     }
   }
 
-  {
-    WRITE_LOCKER(_attributeIdsLock);
-    found = TRI_InsertKeyAssociativePointer(&_attributeIds, &aid, (void*) marker, false);
+  res = _attributeIds.insert(&aid, (void*) marker, false, &found);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
   }
 
   if (warnIfDuplicate && found != nullptr) {
@@ -948,19 +965,12 @@ int VocShaper::insertAttribute (TRI_df_marker_t const* marker,
 
 TRI_shape_access_t const* VocShaper::findAccessor (TRI_shape_sid_t sid,
                                                    TRI_shape_pid_t pid) {
-  TRI_shape_access_t search = { sid, pid, 0, nullptr };
-
-  size_t const i = static_cast<size_t>(fasthash64(&sid, sizeof(TRI_shape_sid_t), fasthash64(&pid, sizeof(TRI_shape_pid_t), 0x87654321)) % NUM_SHAPE_ACCESSORS);
+  TRI_shape_access_t search = { sid, pid, 0, nullptr, nullptr, false, 0, 0 };
 
-  TRI_shape_access_t const* found = nullptr;
-  {
-    READ_LOCKER(_accessorLock[i]);
+  auto found = static_cast<TRI_shape_access_t const*>(_accessors.lookup(&search));
 
-    found = static_cast<TRI_shape_access_t const*>(TRI_LookupByElementAssociativePointer(&_accessors[i], &search));
-
-    if (found != nullptr) {
-      return found;
-    }
+  if (found != nullptr) {
+    return found;
   }
 
   // not found... time for us to create the accessor ourselves!
@@ -971,25 +981,62 @@ TRI_shape_access_t const* VocShaper::findAccessor (TRI_shape_sid_t sid,
     return nullptr;
   }
 
-  // acquire the write-lock and try to insert our own accessor
-
+  // acquire the create lock and try to insert our own accessor
+  int res;
+  void* other;
   {
-    WRITE_LOCKER(_accessorLock[i]);
-    found = static_cast<TRI_shape_access_t const*>(TRI_InsertElementAssociativePointer(&_accessors[i], const_cast<void*>(static_cast<void const*>(accessor)), false));
+    MUTEX_LOCKER(_accessorCreateLock);
+    res = _accessors.insert(accessor, accessor, false, &other);
   }
 
-  if (found != nullptr) {
-    // someone else inserted the same accessor in the period after we release the read-lock
-    // but before we acquired the write-lock
-    // this is ok, and we can return the concurrently built accessor now
+  if (res != TRI_ERROR_NO_ERROR || other != nullptr) {
+    // either out of memory, or someone else inserted the same accessor in
+    // the meantime. this is ok, and we can return the concurrently built
+    // accessor now
     TRI_FreeShapeAccessor(accessor);
 
-    return found;
+    return static_cast<TRI_shape_access_t const*>(other);
   }
 
   return const_cast<TRI_shape_access_t const*>(accessor);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates the stringification template of an array shape
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_template_t const* VocShaper::findShapeTemplate (TRI_shape_t const* shape) {
+  TRI_shape_sid_t const sid = shape->_sid;
+
+  auto found = static_cast<TRI_shape_template_t const*>(_templates.lookup(&sid));
+
+  if (found != nullptr) {
+    return found;
+  }
+
+  TRI_shape_template_t* tpl = TRI_CreateShapeTemplate(this, shape);
+
+  if (tpl == nullptr) {
+    return nullptr;
+  }
+
+  int res;
+  void* other;
+  {
+    MUTEX_LOCKER(_templateCreateLock);
+    res = _templates.insert(&tpl->_sid, tpl, false, &other);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR || other != nullptr) {
+    // either out of memory, or built concurrently by another thread
+    TRI_FreeShapeTemplate(tpl);
+
+    return static_cast<TRI_shape_template_t const*>(other);
+  }
+
+  return tpl;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extracts a sub-shape
 ////////////////////////////////////////////////////////////////////////////////
@@ -1021,18 +1068,8 @@ bool VocShaper::extractShapedJson (TRI_shaped_json_t const* document,
     return sid == TRI_SHAPE_ILLEGAL;
   }
 
-  *shape = lookupShapeId(accessor->_resultSid);
-
-  if (*shape == nullptr) {
-#ifdef TRI_ENABLE_MAINTAINER_MODE
-    LOG_TRACE("expecting any object for path %llu, got unknown shape id %llu",
-              (unsigned long long) pid,
-              (unsigned long long) accessor->_resultSid);
-#endif
-    *shape = nullptr;
-
-    return sid == TRI_SHAPE_ILLEGAL;
-  }
+  // the accessor already resolved the resulting shape
+  *shape = accessor->_resultShape;
 
   if (sid != 0 && sid != accessor->_resultSid) {
 #ifdef TRI_ENABLE_MAINTAINER_MODE
@@ -1075,11 +1112,7 @@ TRI_shape_path_t const* VocShaper::findShapePathByName (char const* name,
 
   TRI_ASSERT(name != nullptr);
 
-  void const* p;
-  {
-    READ_LOCKER(_attributePathsByNameLock);
-    p = TRI_LookupByKeyAssociativePointer(&_attributePathsByName, name);
-  }
+  void const* p = _attributePathsByName.lookup(name);
 
   if (p != nullptr) {
     return (TRI_shape_path_t const*) p;
@@ -1092,10 +1125,7 @@ TRI_shape_path_t const* VocShaper::findShapePathByName (char const* name,
   MUTEX_LOCKER(_attributePathsCreateLock);
 
   // if the element appeared, return the pid
-  {
-    READ_LOCKER(_attributePathsByNameLock);
-    p = TRI_LookupByKeyAssociativePointer(&_attributePathsByName, name);
-  }
+  p = _attributePathsByName.lookup(name);
 
   if (p != nullptr) {
     return (TRI_shape_path_t const*) p;
@@ -1167,32 +1197,70 @@ TRI_shape_path_t const* VocShaper::findShapePathByName (char const* name,
 
   TRI_Free(_memoryZone, aids);
 
-  {
-    WRITE_LOCKER(_attributePathsByNameLock);
-    void const* f = TRI_InsertKeyAssociativePointer(&_attributePathsByName, name, result, false);
+  // enter into the pid dictionary first, the name dictionary owns the path
+  void* f;
+  int res = _attributePathsByPid.insert(&result->_pid, result, false, &f);
 
-    if (f != nullptr) {
-      LOG_WARNING("duplicate shape path %lu", (unsigned long) result->_pid);
-    }
+  if (f != nullptr) {
+    LOG_WARNING("duplicate shape path %lu", (unsigned long) result->_pid);
+  }
+
+  TRI_ASSERT(f == nullptr); // will abort here
 
-    TRI_ASSERT(f == nullptr); // will abort here
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_Free(_memoryZone, result);
+    LOG_ERROR("out of memory in shaper");
+    return nullptr;
   }
 
-  {
-    WRITE_LOCKER(_attributePathsByPidLock);
-    void const* f = TRI_InsertKeyAssociativePointer(&_attributePathsByPid, &result->_pid, result, false);
+  res = _attributePathsByName.insert(name, result, false, &f);
 
-    if (f != nullptr) {
-      LOG_WARNING("duplicate shape path %lu", (unsigned long)result->_pid);
-    }
+  if (f != nullptr) {
+    LOG_WARNING("duplicate shape path %lu", (unsigned long) result->_pid);
+  }
 
-    TRI_ASSERT(f == nullptr); // will abort here
+  TRI_ASSERT(f == nullptr); // will abort here
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // the path stays reachable by its pid
+    LOG_ERROR("out of memory in shaper");
   }
 
   // return pid
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates the dictionary string shape, returns its sid
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_sid_t VocShaper::findDictionaryShape (bool create) {
+  TRI_ASSERT(_dictionaryShape != nullptr);
+
+  // findShape takes ownership of its argument, so hand over a copy. the
+  // shape is built from the same values every time, so it is found again
+  // after a restart
+  size_t const size = static_cast<size_t>(_dictionaryShape->_size);
+  TRI_shape_t* copy = static_cast<TRI_shape_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, size, false));
+
+  if (copy == nullptr) {
+    return 0;
+  }
+
+  memcpy(copy, _dictionaryShape, size);
+
+  TRI_shape_t const* found = findShape(copy, create);
+
+  if (found == nullptr) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, copy);
+    return 0;
+  }
+
+  _dictionarySid = found->_sid;
+
+  return found->_sid;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                               non-class functions
 // -----------------------------------------------------------------------------
@@ -1415,6 +1483,14 @@ int TRI_CompareShapeTypes (char const* leftDocument,
   TRI_shape_type_t leftType   = leftShape->_type;
   TRI_shape_type_t rightType  = rightShape->_type;
 
+  // values from the same string dictionary are equal if their codes are,
+  // this saves the collation
+  if (leftType == TRI_SHAPE_DICTIONARY_STRING &&
+      leftShape == rightShape &&
+      *((TRI_shape_dictionary_code_t const*) left._data.data) == *((TRI_shape_dictionary_code_t const*) right._data.data)) {
+    return 0;
+  }
+
   // ...........................................................................
   // check ALL combinations of leftType and rightType
   // ...........................................................................
@@ -1435,6 +1511,7 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         case TRI_SHAPE_NUMBER:
         case TRI_SHAPE_SHORT_STRING:
         case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING:
         case TRI_SHAPE_ARRAY:
         case TRI_SHAPE_LIST:
         case TRI_SHAPE_HOMOGENEOUS_LIST:
@@ -1460,6 +1537,7 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         case TRI_SHAPE_NUMBER:
         case TRI_SHAPE_SHORT_STRING:
         case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING:
         case TRI_SHAPE_ARRAY:
         case TRI_SHAPE_LIST:
         case TRI_SHAPE_HOMOGENEOUS_LIST:
@@ -1492,6 +1570,7 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         case TRI_SHAPE_NUMBER:
         case TRI_SHAPE_SHORT_STRING:
         case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING:
         case TRI_SHAPE_ARRAY:
         case TRI_SHAPE_LIST:
         case TRI_SHAPE_HOMOGENEOUS_LIST:
@@ -1524,6 +1603,7 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         }
         case TRI_SHAPE_SHORT_STRING:
         case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING:
         case TRI_SHAPE_ARRAY:
         case TRI_SHAPE_LIST:
         case TRI_SHAPE_HOMOGENEOUS_LIST:
@@ -1538,7 +1618,8 @@ int TRI_CompareShapeTypes (char const* leftDocument,
     // .........................................................................
 
     case TRI_SHAPE_SHORT_STRING:
-    case TRI_SHAPE_LONG_STRING: {
+    case TRI_SHAPE_LONG_STRING:
+    case TRI_SHAPE_DICTIONARY_STRING: {
       switch (rightType) {
         case TRI_SHAPE_ILLEGAL:
         case TRI_SHAPE_NULL:
@@ -1547,7 +1628,8 @@ int TRI_CompareShapeTypes (char const* leftDocument,
           return 1;
         }
         case TRI_SHAPE_SHORT_STRING:
-        case TRI_SHAPE_LONG_STRING: {
+        case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING: {
           char* leftString;
           char* rightString;
           size_t leftLength;
@@ -1559,19 +1641,25 @@ int TRI_CompareShapeTypes (char const* leftDocument,
             leftString = (char*) (sizeof(TRI_shape_length_short_string_t) + left._data.data);
             leftLength = (size_t) *((TRI_shape_length_short_string_t*) left._data.data) - 1;
           }
-          else {
+          else if (leftType == TRI_SHAPE_LONG_STRING) {
             leftString = (char*) (sizeof(TRI_shape_length_long_string_t) + left._data.data);
             leftLength = (size_t) *((TRI_shape_length_long_string_t*) left._data.data) - 1;
           }
+          else {
+            TRI_StringValueShapedJson(leftShape, left._data.data, &leftString, &leftLength);
+          }
 
           if (rightType == TRI_SHAPE_SHORT_STRING) {
             rightString = (char*) (sizeof(TRI_shape_length_short_string_t) + right._data.data);
             rightLength = (size_t) *((TRI_shape_length_short_string_t*) right._data.data) - 1;
           }
-          else {
+          else if (rightType == TRI_SHAPE_LONG_STRING) {
             rightString = (char*) (sizeof(TRI_shape_length_long_string_t) + right._data.data);
             rightLength = (size_t) *((TRI_shape_length_long_string_t*) right._data.data) - 1;
           }
+          else {
+            TRI_StringValueShapedJson(rightShape, right._data.data, &rightString, &rightLength);
+          }
 
           return TRI_compare_utf8(leftString, leftLength, rightString, rightLength);
         }
@@ -1598,7 +1686,8 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         case TRI_SHAPE_BOOLEAN:
         case TRI_SHAPE_NUMBER:
         case TRI_SHAPE_SHORT_STRING:
-        case TRI_SHAPE_LONG_STRING: {
+        case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING: {
           return 1;
         }
         case TRI_SHAPE_HOMOGENEOUS_LIST:
@@ -1701,6 +1790,7 @@ int TRI_CompareShapeTypes (char const* leftDocument,
         case TRI_SHAPE_NUMBER:
         case TRI_SHAPE_SHORT_STRING:
         case TRI_SHAPE_LONG_STRING:
+        case TRI_SHAPE_DICTIONARY_STRING:
         case TRI_SHAPE_HOMOGENEOUS_LIST:
         case TRI_SHAPE_HOMOGENEOUS_SIZED_LIST:
         case TRI_SHAPE_LIST: {
@@ -32,6 +32,8 @@
 #define ARANGODB_VOC_BASE_VOC_SHAPER_H 1
 
 #include "Basics/Common.h"
+#include "Basics/AssocAppendOnly.h"
+#include "Basics/Mutex.h"
 #include "VocBase/datafile.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/shape-accessor.h"
@@ -39,8 +41,6 @@
 #include "VocBase/Shaper.h"
 #include "Wal/Marker.h"
 
-#define NUM_SHAPE_ACCESSORS 8
-
 // -----------------------------------------------------------------------------
 // --SECTION--                                                         VocShaper
 // -----------------------------------------------------------------------------
@@ -134,6 +134,20 @@ class VocShaper : public Shaper {
     TRI_shape_t const* findShape (TRI_shape_t*,
                                   bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the dictionary code of a string value
+///
+/// Returns false if the collection has no string dictionary, if the value is
+/// not part of it or if the dictionary shape does not exist yet and create is
+/// false. In the latter case, no document can contain a code yet.
+////////////////////////////////////////////////////////////////////////////////
+
+    bool lookupDictionaryCode (char const*,
+                               size_t,
+                               bool,
+                               TRI_shape_sid_t*,
+                               TRI_shape_dictionary_code_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief move a shape marker, called during compaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -162,6 +176,12 @@ class VocShaper : public Shaper {
     TRI_shape_access_t const* findAccessor (TRI_shape_sid_t,
                                             TRI_shape_pid_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates the stringification template of an array shape
+////////////////////////////////////////////////////////////////////////////////
+
+    TRI_shape_template_t const* findShapeTemplate (TRI_shape_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief extracts a sub-shape
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,49 +205,57 @@ class VocShaper : public Shaper {
     TRI_shape_path_t const* findShapePathByName (char const* name,
                                                  bool create);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates the dictionary string shape, returns its sid
+////////////////////////////////////////////////////////////////////////////////
+
+    TRI_shape_sid_t findDictionaryShape (bool create);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
 
   private:
     
-    TRI_memory_zone_t*              _memoryZone;
-    TRI_document_collection_t*      _collection;
+    TRI_memory_zone_t*                _memoryZone;
+    TRI_document_collection_t*        _collection;
 
-    // attribute paths   
-    triagens::basics::Mutex         _attributePathsCreateLock;
-
-    triagens::basics::ReadWriteLock _attributePathsByNameLock; 
-    TRI_associative_pointer_t       _attributePathsByName;
+    // all dictionaries below are append-only and can be read without
+    // locking. modifications are serialized by the create locks
 
-    triagens::basics::ReadWriteLock _attributePathsByPidLock; 
-    TRI_associative_pointer_t       _attributePathsByPid;
+    // attribute paths   
+    triagens::basics::Mutex           _attributePathsCreateLock;
+    triagens::basics::AssocAppendOnly _attributePathsByName;
+    triagens::basics::AssocAppendOnly _attributePathsByPid;
 
     // attributes 
-    triagens::basics::Mutex         _attributeCreateLock;
-
-    triagens::basics::ReadWriteLock _attributeNamesLock; 
-    TRI_associative_pointer_t       _attributeNames;
-
-    triagens::basics::ReadWriteLock _attributeIdsLock; 
-    TRI_associative_pointer_t       _attributeIds;
+    triagens::basics::Mutex           _attributeCreateLock;
+    triagens::basics::AssocAppendOnly _attributeNames;
+    triagens::basics::AssocAppendOnly _attributeIds;
 
     // shapes 
-    triagens::basics::Mutex         _shapeCreateLock;
-
-    triagens::basics::ReadWriteLock _shapeDictionaryLock; 
-    TRI_associative_pointer_t       _shapeDictionary;
-
-    triagens::basics::ReadWriteLock _shapeIdsLock; 
-    TRI_associative_pointer_t       _shapeIds;
+    triagens::basics::Mutex           _shapeCreateLock;
+    triagens::basics::AssocAppendOnly _shapeDictionary;
+    triagens::basics::AssocAppendOnly _shapeIds;
 
     // accessors
-    triagens::basics::ReadWriteLock _accessorLock[NUM_SHAPE_ACCESSORS];
-    TRI_associative_pointer_t       _accessors[NUM_SHAPE_ACCESSORS];
-
-    TRI_shape_pid_t                 _nextPid;
-    std::atomic<TRI_shape_aid_t>    _nextAid;
-    std::atomic<TRI_shape_sid_t>    _nextSid;
+    triagens::basics::Mutex           _accessorCreateLock;
+    triagens::basics::AssocAppendOnly _accessors;
+
+    // stringification templates
+    triagens::basics::Mutex           _templateCreateLock;
+    triagens::basics::AssocAppendOnly _templates;
+
+    // string dictionary, sorted by value. immutable after construction
+    std::vector<std::pair<std::string, TRI_shape_dictionary_code_t>> _dictionaryCodes;
+    TRI_shape_t*                      _dictionaryShape;
+    size_t                            _dictionaryMinLength;
+    size_t                            _dictionaryMaxLength;
+    std::atomic<TRI_shape_sid_t>      _dictionarySid;
+
+    TRI_shape_pid_t                   _nextPid;
+    std::atomic<TRI_shape_aid_t>      _nextAid;
+    std::atomic<TRI_shape_sid_t>      _nextSid;
 
 };
 
@@ -41,6 +41,7 @@
 #include "VocBase/vocbase.h"
 #include "VocBase/VocShaper.h"
 #include "Utils/transactions.h"
+#include "VocBase/AuthCache.h"
 
 using namespace triagens::arango;
 
@@ -83,30 +84,6 @@ static bool EqualKeyAuthInfo (TRI_associative_pointer_t* array,
   return TRI_EqualString(k, e->_username);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief hashes the cache entry
-////////////////////////////////////////////////////////////////////////////////
-
-static uint64_t HashElementAuthCache (TRI_associative_pointer_t* array,
-                                      void const* element) {
-  TRI_vocbase_auth_cache_t const* e = static_cast<TRI_vocbase_auth_cache_t const*>(element);
-
-  return TRI_FnvHashString(e->_hash);
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief compares a auth cache entry and a hash
-////////////////////////////////////////////////////////////////////////////////
-
-static bool EqualKeyAuthCache (TRI_associative_pointer_t* array,
-                               void const* key,
-                               void const* element) {
-  char const* k = (char const*) key;
-  TRI_vocbase_auth_cache_t const* e = static_cast<TRI_vocbase_auth_cache_t const*>(element);
-
-  return TRI_EqualString(k, e->_hash);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief frees the auth information
 ////////////////////////////////////////////////////////////////////////////////
@@ -119,22 +96,6 @@ static void FreeAuthInfo (TRI_vocbase_auth_t* auth) {
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, auth);
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief frees the cache information
-////////////////////////////////////////////////////////////////////////////////
-
-static void FreeAuthCacheInfo (TRI_vocbase_auth_cache_t* cached) {
-  if (cached->_hash != nullptr) {
-    TRI_Free(TRI_CORE_MEM_ZONE, cached->_hash);
-  }
-
-  if (cached->_username != nullptr) {
-    TRI_Free(TRI_CORE_MEM_ZONE, cached->_username);
-  }
-
-  TRI_Free(TRI_CORE_MEM_ZONE, cached);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief constructs auth information from JSON
 ////////////////////////////////////////////////////////////////////////////////
@@ -269,20 +230,9 @@ static void ClearAuthInfo (TRI_vocbase_t* vocbase) {
   vocbase->_authInfo._nrUsed = 0;
 
   // clear cache
-  beg = vocbase->_authCache._table;
-  end = vocbase->_authCache._table + vocbase->_authCache._nrAlloc;
-  ptr = beg;
-
-  for (;  ptr < end;  ++ptr) {
-    if (*ptr) {
-      TRI_vocbase_auth_cache_t* auth = static_cast<TRI_vocbase_auth_cache_t*>(*ptr);
-
-      FreeAuthCacheInfo(auth);
-      *ptr = nullptr;
-    }
+  if (vocbase->_authCache != nullptr) {
+    vocbase->_authCache->invalidate();
   }
-
-  vocbase->_authCache._nrUsed = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -301,12 +251,13 @@ int TRI_InitAuthInfo (TRI_vocbase_t* vocbase) {
                              EqualKeyAuthInfo,
                              nullptr);
 
-  TRI_InitAssociativePointer(&vocbase->_authCache,
-                             TRI_CORE_MEM_ZONE,
-                             HashKey,
-                             HashElementAuthCache,
-                             EqualKeyAuthCache,
-                             nullptr);
+  try {
+    vocbase->_authCache = new AuthCache();
+  }
+  catch (...) {
+    TRI_DestroyAssociativePointer(&vocbase->_authInfo);
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
 
   TRI_InitReadWriteLock(&vocbase->_authInfoLock);
 
@@ -321,7 +272,8 @@ void TRI_DestroyAuthInfo (TRI_vocbase_t* vocbase) {
   TRI_ClearAuthInfo(vocbase);
 
   TRI_DestroyReadWriteLock(&vocbase->_authInfoLock);
-  TRI_DestroyAssociativePointer(&vocbase->_authCache);
+  delete vocbase->_authCache;
+  vocbase->_authCache = nullptr;
   TRI_DestroyAssociativePointer(&vocbase->_authInfo);
 }
 
@@ -498,23 +450,11 @@ void TRI_ClearAuthInfo (TRI_vocbase_t* vocbase) {
 /// @brief looks up authentication data in the cache
 ////////////////////////////////////////////////////////////////////////////////
 
-char* TRI_CheckCacheAuthInfo (TRI_vocbase_t* vocbase,
-                              char const* hash,
-                              bool* mustChange) {
-  char* username = nullptr;
-
-  TRI_ReadLockReadWriteLock(&vocbase->_authInfoLock);
-  TRI_vocbase_auth_cache_t* cached = static_cast<TRI_vocbase_auth_cache_t*>(TRI_LookupByKeyAssociativePointer(&vocbase->_authCache, hash));
-
-  if (cached != nullptr) {
-    username = TRI_DuplicateStringZ(TRI_CORE_MEM_ZONE, cached->_username);
-    *mustChange = cached->_mustChange;
-  }
-
-  TRI_ReadUnlockReadWriteLock(&vocbase->_authInfoLock);
-
-  // might be NULL
-  return username;
+bool TRI_CheckCacheAuthInfo (TRI_vocbase_t* vocbase,
+                             char const* hash,
+                             std::string& username,
+                             bool* mustChange) {
+  return vocbase->_authCache->lookup(hash, username, *mustChange);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -557,6 +497,10 @@ bool TRI_CheckAuthenticationAuthInfo (TRI_vocbase_t* vocbase,
 
   *mustChange = auth->_mustChange;
 
+  // the cache is invalidated under the write lock, so an entry verified
+  // against the current users is tagged with the current generation
+  uint64_t const generation = vocbase->_authCache->generation();
+
   size_t const n = strlen(auth->_passwordSalt);
   size_t const p = strlen(password);
 
@@ -627,27 +571,11 @@ bool TRI_CheckAuthenticationAuthInfo (TRI_vocbase_t* vocbase,
 
   if (res && hash != nullptr) {
     // insert item into the cache
-    TRI_vocbase_auth_cache_t* cached = static_cast<TRI_vocbase_auth_cache_t*>(TRI_Allocate(TRI_CORE_MEM_ZONE, sizeof(TRI_vocbase_auth_cache_t), false));
-
-    if (cached != nullptr) {
-      cached->_hash       = TRI_DuplicateStringZ(TRI_CORE_MEM_ZONE, hash);
-      cached->_username   = TRI_DuplicateStringZ(TRI_CORE_MEM_ZONE, username);
-      cached->_mustChange = auth->_mustChange;
-
-      if (cached->_hash == nullptr || cached->_username == nullptr) {
-        FreeAuthCacheInfo(cached);
-        return res;
-      }
-
-      TRI_WriteLockReadWriteLock(&vocbase->_authInfoLock);
-      void* old = TRI_InsertKeyAssociativePointer(&vocbase->_authCache, cached->_hash, cached, false);
-
-      // duplicate entry?
-      if (old != nullptr) {
-        FreeAuthCacheInfo(cached);
-      }
-
-      TRI_WriteUnlockReadWriteLock(&vocbase->_authInfoLock);
+    try {
+      vocbase->_authCache->insert(hash, username, *mustChange, generation);
+    }
+    catch (...) {
+      // the credentials are verified again with the next request
     }
   }
 
@@ -57,17 +57,6 @@ typedef struct TRI_vocbase_auth_s {
 }
 TRI_vocbase_auth_t;
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief header to username cache
-////////////////////////////////////////////////////////////////////////////////
-
-typedef struct TRI_vocbase_auth_cache_s {
-  char* _hash;
-  char* _username;
-  bool _mustChange;
-}
-TRI_vocbase_auth_cache_t;
-
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -118,11 +107,15 @@ void TRI_ClearAuthInfo (TRI_vocbase_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief looks up authentication data in the cache
+///
+/// this does not acquire any lock. returns false if the authorization
+/// header value has not been verified recently
 ////////////////////////////////////////////////////////////////////////////////
 
-char* TRI_CheckCacheAuthInfo (TRI_vocbase_t*,
-                              char const* hash,
-                              bool* mustChange);
+bool TRI_CheckCacheAuthInfo (TRI_vocbase_t*,
+                             char const* hash,
+                             std::string& username,
+                             bool* mustChange);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks the authentication - note: only checks whether the user exists
@@ -30,6 +30,9 @@
 #include "cleanup.h"
 #include "Basics/files.h"
 #include "Basics/logging.h"
+#include "Basics/memory-map.h"
+#include "Basics/Mutex.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/tri-strings.h"
 #include "Utils/CursorRepository.h"
 #include "VocBase/compactor.h"
@@ -59,10 +62,125 @@ static int const CLEANUP_CURSOR_ITERATIONS = 3;
 
 static int const CLEANUP_INDEX_ITERATIONS = 5;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of transactions removing expired documents of a
+/// collection per cleanup run
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const CLEANUP_EXPIRY_BATCHES = 10;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief how many cleanup iterations until the memory of the loaded
+/// collections is compared with the memory target
+////////////////////////////////////////////////////////////////////////////////
+
+static int const CLEANUP_MEMORY_ITERATIONS = 10;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the memory held by the loaded collections of a database
+////////////////////////////////////////////////////////////////////////////////
+
+struct DatabaseMemoryUsage {
+  uint64_t _total;
+
+  // last access time and memory of the collections that may be unloaded
+  std::vector<std::pair<double, uint64_t>> _idle;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a collection that may be unloaded
+////////////////////////////////////////////////////////////////////////////////
+
+struct IdleCollection {
+  TRI_vocbase_col_t* _collection;
+  double _lastAccess;
+  uint64_t _memory;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interval (in seconds) for releasing the pages of sealed datafiles
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<double> ColdDatafileInterval(0.0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the memory (in bytes) the loaded collections of all databases
+/// should not exceed. a value of 0 turns off unloading
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> MemoryTarget(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time (in seconds) a collection must not have been used before it
+/// is unloaded
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<double> UnloadIdleTime(60.0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the memory usage published by the cleanup thread of each database
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex MemoryUsageLock;
+
+static std::unordered_map<TRI_voc_tick_t, DatabaseMemoryUsage> MemoryUsage;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the resident pages of the sealed datafiles of a collection
+///
+/// the datafiles stay mapped, so all master pointers into them remain valid.
+/// the kernel drops the pages from the process' mapping, and they will be
+/// faulted in again from the page cache or from disk when accessed. this
+/// keeps rarely read datafiles from adding to the resident set, and lets
+/// the kernel evict them before hot data. journals and compactors are
+/// left alone, and so are the datafiles of volatile collections, which are
+/// anonymous mappings whose contents would be lost
+////////////////////////////////////////////////////////////////////////////////
+
+static void ReleaseColdDatafiles (TRI_document_collection_t* document) {
+  if (! TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(document)) {
+    // we'll try again next time
+    return;
+  }
+
+  size_t const n = document->_datafiles._length;
+  size_t released = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    auto df = static_cast<TRI_datafile_t*>(document->_datafiles._buffer[i]);
+
+    if (! df->_isSealed || 
+        ! df->isPhysical(df) || 
+        df->_data == nullptr) {
+      continue;
+    }
+
+    if (TRI_MMFileAdvise(df->_data, (size_t) df->_maximalSize, TRI_MADVISE_DONTNEED) == TRI_ERROR_NO_ERROR) {
+      released += (size_t) df->_maximalSize;
+    }
+  }
+
+  TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(document);
+
+  if (released > 0) {
+    LOG_TRACE("released %llu bytes of sealed datafiles of collection '%s'",
+              (unsigned long long) released,
+              document->_info._name);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks all datafiles of a collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -204,6 +322,92 @@ static void CleanupCursors (TRI_vocbase_t* vocbase,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes the memory usage of a database, and returns the last
+/// access time up to which idle collections must be unloaded to bring all
+/// databases below the memory target. returns 0 if nothing must be unloaded
+///
+/// the idle collections of all databases are unloaded least recently used
+/// first, so the database that frees memory is the one whose collections
+/// have been idle the longest, not the one whose cleanup thread runs first
+////////////////////////////////////////////////////////////////////////////////
+
+static double UnloadCutoff (TRI_voc_tick_t id,
+                            uint64_t total,
+                            std::vector<IdleCollection> const& idle,
+                            uint64_t target) {
+  std::vector<std::pair<double, uint64_t>> candidates;
+  uint64_t globalTotal = 0;
+
+  {
+    MUTEX_LOCKER(MemoryUsageLock);
+
+    auto& usage = MemoryUsage[id];
+    usage._total = total;
+    usage._idle.clear();
+
+    for (auto const& it : idle) {
+      usage._idle.emplace_back(it._lastAccess, it._memory);
+    }
+
+    for (auto const& it : MemoryUsage) {
+      globalTotal += it.second._total;
+      candidates.insert(candidates.end(), it.second._idle.begin(), it.second._idle.end());
+    }
+  }
+
+  if (globalTotal <= target) {
+    return 0.0;
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+
+  uint64_t freed = 0;
+  double cutoff = 0.0;
+
+  for (auto const& it : candidates) {
+    if (globalTotal - freed <= target) {
+      break;
+    }
+
+    freed += it.second;
+    cutoff = it.first;
+  }
+
+  return cutoff;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unloads the least recently used collections of a database while
+/// the loaded collections of all databases exceed the memory target
+///
+/// unloaded collections are loaded again on their next use
+////////////////////////////////////////////////////////////////////////////////
+
+static void UnloadIdleCollections (TRI_vocbase_t* vocbase,
+                                   uint64_t total,
+                                   std::vector<IdleCollection> const& idle,
+                                   uint64_t target) {
+  double const cutoff = UnloadCutoff(vocbase->_id, total, idle, target);
+
+  if (cutoff == 0.0) {
+    return;
+  }
+
+  for (auto const& it : idle) {
+    if (it._lastAccess > cutoff) {
+      continue;
+    }
+
+    if (TRI_UnloadIdleCollectionVocBase(vocbase, it._collection, it._lastAccess)) {
+      LOG_INFO("unloading idle collection '%s' in database '%s' to free about %llu bytes",
+               it._collection->_name,
+               vocbase->_name,
+               (unsigned long long) it._memory);
+    }
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -220,6 +424,8 @@ void TRI_CleanupVocBase (void* data) {
   TRI_ASSERT(vocbase->_state == 1);
 
   std::vector<TRI_vocbase_col_t*> collections;
+  std::vector<IdleCollection> idle;
+  double lastRelease = TRI_microtime();
 
   while (true) {
     // keep initial _state value as vocbase->_state might change during cleanup loop
@@ -227,6 +433,30 @@ void TRI_CleanupVocBase (void* data) {
 
     ++iterations;
 
+    // check whether the pages of sealed datafiles should be released
+    bool releaseDatafiles = false;
+    double const releaseInterval = ColdDatafileInterval.load(std::memory_order_relaxed);
+
+    if (releaseInterval > 0.0 && state == 1) {
+      double const now = TRI_microtime();
+
+      if (lastRelease + releaseInterval <= now) {
+        releaseDatafiles = true;
+        lastRelease = now;
+      }
+    }
+
+    // check whether the loaded collections should be compared with the
+    // memory target
+    uint64_t const memoryTarget = MemoryTarget.load(std::memory_order_relaxed);
+    bool const balanceMemory = (memoryTarget > 0 &&
+                                state == 1 &&
+                                iterations % (uint64_t) CLEANUP_MEMORY_ITERATIONS == 0);
+    double const idleBefore = TRI_microtime() - UnloadIdleTime.load(std::memory_order_relaxed);
+    uint64_t memoryTotal = 0;
+    bool memoryComplete = true;
+    idle.clear();
+
     if (state == (sig_atomic_t) TRI_VOCBASE_STATE_SHUTDOWN_COMPACTOR ||
         state == (sig_atomic_t) TRI_VOCBASE_STATE_SHUTDOWN_CLEANUP) {
       // shadows must be cleaned before collections are handled
@@ -273,9 +503,75 @@ void TRI_CleanupVocBase (void* data) {
           document->cleanupIndexes(document);
         }
 
+        if (releaseDatafiles) {
+          ReleaseColdDatafiles(document);
+        }
+
+        // using a collection cancels its unloading, so skip those
+        bool const usable = (state == 1 &&
+                             ! document->ditches()->contains(triagens::arango::Ditch::TRI_DITCH_COLLECTION_UNLOAD) &&
+                             ! document->ditches()->contains(triagens::arango::Ditch::TRI_DITCH_COLLECTION_DROP));
+
+        // create the next journal before the current one is full, so that
+        // the collector does not have to wait for the file to be created
+        if (usable &&
+            ! triagens::wal::LogfileManager::instance()->isInRecovery()) {
+          TRI_PrepareSpareJournalDocumentCollection(document);
+        }
+
+        // trim capped collections that inserts have left above their cap
+        if (usable &&
+            document->_capEvictionPending.load(std::memory_order_relaxed)) {
+          int res = TRI_EvictCapConstraintDocumentCollection(vocbase, document);
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            LOG_WARNING("cannot cap collection '%s': %s",
+                        collection->_name,
+                        TRI_errno_string(res));
+          }
+        }
+
+        // remove expired documents
+        if (usable &&
+            document->_ttlIndexes > 0) {
+          int res = TRI_ExpireDocumentsDocumentCollection(vocbase, document, CLEANUP_EXPIRY_BATCHES);
+
+          if (res != TRI_ERROR_NO_ERROR) {
+            LOG_WARNING("cannot remove expired documents of collection '%s': %s",
+                        collection->_name,
+                        TRI_errno_string(res));
+          }
+        }
+
+        // estimate the memory of the collection, and whether it may be
+        // unloaded to free it
+        if (usable && balanceMemory) {
+          uint64_t memory;
+
+          if (document->memoryUsage(memory)) {
+            memoryTotal += memory;
+
+            double const lastAccess = document->_lastAccess.load(std::memory_order_relaxed);
+
+            if (lastAccess <= idleBefore &&
+                collection->_canUnload &&
+                collection->_name[0] != '_') {
+              idle.emplace_back(IdleCollection{ collection, lastAccess, memory });
+            }
+          }
+          else {
+            // the collection is busy, so try again next time
+            memoryComplete = false;
+          }
+        }
+
         CleanupDocumentCollection(collection, document);
       }
 
+      if (balanceMemory && memoryComplete) {
+        UnloadIdleCollections(vocbase, memoryTotal, idle, memoryTarget);
+      }
+
       TRI_UnlockCompactorVocBase(vocbase);
     }
 
@@ -306,9 +602,35 @@ void TRI_CleanupVocBase (void* data) {
 
   }
 
+  {
+    MUTEX_LOCKER(MemoryUsageLock);
+    MemoryUsage.erase(vocbase->_id);
+  }
+
   LOG_TRACE("shutting down cleanup thread");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the interval (in seconds) for releasing the resident pages of
+/// sealed datafiles
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetColdDatafileIntervalVocBase (double value) {
+  ColdDatafileInterval.store(value, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the memory target (in bytes) for the loaded collections of all
+/// databases, and the time (in seconds) a collection must be idle before it
+/// is unloaded
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMemoryTargetVocBase (uint64_t target,
+                                 double idleTime) {
+  MemoryTarget.store(target, std::memory_order_relaxed);
+  UnloadIdleTime.store(idleTime, std::memory_order_relaxed);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
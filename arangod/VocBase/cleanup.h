@@ -43,6 +43,22 @@
 
 void TRI_CleanupVocBase (void*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the interval (in seconds) for releasing the resident pages of
+/// sealed datafiles. a value of 0 turns off releasing
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetColdDatafileIntervalVocBase (double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the memory target (in bytes) for the loaded collections of all
+/// databases, and the time (in seconds) a collection must be idle before it
+/// is unloaded. a target of 0 turns off unloading
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMemoryTargetVocBase (uint64_t,
+                                 double);
+
 #endif
 
 // -----------------------------------------------------------------------------
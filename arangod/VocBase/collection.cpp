@@ -31,6 +31,7 @@
 
 #include <regex.h>
 
+#include "Basics/Barrier.h"
 #include "Basics/conversions.h"
 #include "Basics/files.h"
 #include "Basics/hashes.h"
@@ -39,6 +40,7 @@
 #include "Basics/logging.h"
 #include "Basics/tri-strings.h"
 #include "Basics/memory-map.h"
+#include "Basics/ThreadPool.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/server.h"
 #include "VocBase/vocbase.h"
@@ -402,6 +404,96 @@ static TRI_col_file_structure_t ScanCollectionDirectory (char const* path) {
   return structure;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief opens the datafiles of a collection
+///
+/// opening a datafile scans and checks all of its markers, so the files are
+/// opened in parallel by the index threads plus the calling thread. the
+/// datafile (or nullptr) and the error code for each file are stored at the
+/// file's position, so the caller can process them in directory order
+////////////////////////////////////////////////////////////////////////////////
+
+static void OpenDatafiles (TRI_collection_t* collection,
+                           std::vector<std::pair<std::string, char*>> const& files,
+                           std::vector<TRI_datafile_t*>& opened,
+                           std::vector<int>& errors,
+                           bool ignoreErrors) {
+  // only log progress for collections with at least this number of files
+  static size_t const NotificationThreshold = 64;
+
+  size_t const n = files.size();
+
+  if (n == 0) {
+    return;
+  }
+
+  std::atomic<size_t> done(0);
+
+  auto open = [&] (size_t i) -> void {
+    TRI_datafile_t* datafile = nullptr;
+
+    try {
+      datafile = TRI_OpenDatafile(files[i].second, ignoreErrors);
+    }
+    catch (...) {
+      TRI_set_errno(TRI_ERROR_INTERNAL);
+    }
+
+    opened[i] = datafile;
+    errors[i] = (datafile == nullptr ? TRI_errno() : TRI_ERROR_NO_ERROR);
+
+    size_t const count = ++done;
+
+    if (n >= NotificationThreshold && (count % NotificationThreshold == 0 || count == n)) {
+      LOG_INFO("opened %llu of %llu datafiles of collection '%s/%s'",
+               (unsigned long long) count,
+               (unsigned long long) n,
+               collection->_vocbase->_name,
+               collection->_info._name);
+    }
+  };
+
+  auto indexPool = collection->_vocbase->_server->_indexPool;
+
+  if (indexPool == nullptr || n == 1) {
+    for (size_t i = 0; i < n; ++i) {
+      open(i);
+    }
+    return;
+  }
+
+  size_t const numTasks = (std::min)(n, indexPool->numThreads() + 1);
+  std::atomic<size_t> next(0);
+
+  {
+    triagens::basics::Barrier barrier(numTasks);
+
+    // each task opens files until there are none left
+    auto task = [&] () -> void {
+      size_t i;
+      while ((i = next++) < n) {
+        open(i);
+      }
+      barrier.join();
+    };
+
+    // the last task is run by this thread
+    for (size_t t = 0; t < numTasks - 1; ++t) {
+      try {
+        indexPool->enqueue(task);
+      }
+      catch (...) {
+        // the remaining tasks' files will be opened by this thread
+        barrier.join();
+      }
+    }
+
+    task();
+
+    // barrier waits here until all tasks have joined
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks a collection
 ///
@@ -417,6 +509,7 @@ static bool CheckCollection (TRI_collection_t* collection,
   TRI_vector_pointer_t journals;
   TRI_vector_pointer_t sealed;
   TRI_vector_string_t files;
+  std::vector<std::pair<std::string, char*>> toOpen;
   bool stop;
   regex_t re;
   size_t i, n;
@@ -483,8 +576,6 @@ static bool CheckCollection (TRI_collection_t* collection,
 
       else if (TRI_EqualString2("db", third, thirdLen)) {
         char* filename;
-        char* ptr;
-        TRI_col_header_marker_t* cm;
 
         if (TRI_EqualString2("compaction", first, firstLen)) {
           // found a compaction file. now rename it back
@@ -529,95 +620,122 @@ static bool CheckCollection (TRI_collection_t* collection,
         }
 
         TRI_ASSERT(filename != nullptr);
-        datafile = TRI_OpenDatafile(filename, ignoreErrors);
+        toOpen.emplace_back(std::string(first, firstLen), filename);
+      }
+      else {
+        LOG_ERROR("unknown datafile '%s'", file);
+      }
+    }
+  }
 
-        if (datafile == nullptr) {
-          collection->_lastError = TRI_errno();
-          LOG_ERROR("cannot open datafile '%s': %s", filename, TRI_last_error());
+  TRI_DestroyVectorString(&files);
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+  regfree(&re);
 
-        TRI_PushBackVectorPointer(&all, datafile);
+  // open all datafiles and journals. this scans each of them completely,
+  // so it is done in parallel
+  std::vector<TRI_datafile_t*> opened(toOpen.size(), nullptr);
+  std::vector<int> errors(toOpen.size(), TRI_ERROR_NO_ERROR);
 
-        // check the document header
-        ptr  = datafile->_data;
-        // skip the datafile header
-        ptr += TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_header_marker_t));
-        cm   = (TRI_col_header_marker_t*) ptr;
+  if (! stop) {
+    OpenDatafiles(collection, toOpen, opened, errors, ignoreErrors);
+  }
 
-        if (cm->base._type != TRI_COL_MARKER_HEADER) {
-          LOG_ERROR("collection header mismatch in file '%s', expected TRI_COL_MARKER_HEADER, found %lu",
-                    filename,
-                    (unsigned long) cm->base._type);
+  for (i = 0;  i < toOpen.size();  ++i) {
+    char const* first = toOpen[i].first.c_str();
+    size_t firstLen = toOpen[i].first.size();
+    char* filename = toOpen[i].second;
+    char* ptr;
+    TRI_col_header_marker_t* cm;
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+    datafile = opened[i];
 
-        if (cm->_cid != collection->_info._cid) {
-          LOG_ERROR("collection identifier mismatch, expected %llu, found %llu",
-                    (unsigned long long) collection->_info._cid,
-                    (unsigned long long) cm->_cid);
+    if (datafile != nullptr) {
+      TRI_PushBackVectorPointer(&all, datafile);
+    }
 
-          TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-          stop = true;
-          break;
-        }
+    if (stop) {
+      // an earlier file failed. the remaining ones will be closed below
+      TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+      continue;
+    }
 
-        // file is a journal
-        if (TRI_EqualString2("journal", first, firstLen)) {
-          if (datafile->_isSealed) {
-            if (datafile->_state != TRI_DF_STATE_READ) {
-              LOG_WARNING("strange, journal '%s' is already sealed; must be a left over; will use it as datafile", filename);
-            }
+    if (datafile == nullptr) {
+      collection->_lastError = TRI_set_errno(errors[i]);
+      LOG_ERROR("cannot open datafile '%s': %s", filename, TRI_errno_string(errors[i]));
 
-            TRI_PushBackVectorPointer(&sealed, datafile);
-          }
-          else {
-            TRI_PushBackVectorPointer(&journals, datafile);
-          }
-        }
+      TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+      stop = true;
+      continue;
+    }
 
-        // file is a compactor
-        else if (TRI_EqualString2("compactor", first, firstLen)) {
-          // ignore
-        }
+    // check the document header
+    ptr  = datafile->_data;
+    // skip the datafile header
+    ptr += TRI_DF_ALIGN_BLOCK(sizeof(TRI_df_header_marker_t));
+    cm   = (TRI_col_header_marker_t*) ptr;
 
-        // file is a datafile (or was a compaction file)
-        else if (TRI_EqualString2("datafile", first, firstLen) ||
-                 TRI_EqualString2("compaction", first, firstLen)) {
-          if (! datafile->_isSealed) {
-            LOG_ERROR("datafile '%s' is not sealed, this should never happen", filename);
+    if (cm->base._type != TRI_COL_MARKER_HEADER) {
+      LOG_ERROR("collection header mismatch in file '%s', expected TRI_COL_MARKER_HEADER, found %lu",
+                filename,
+                (unsigned long) cm->base._type);
 
-            collection->_lastError = TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
-            TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
-            stop = true;
-            break;
-          }
-          else {
-            TRI_PushBackVectorPointer(&datafiles, datafile);
-          }
-        }
+      TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+      stop = true;
+      continue;
+    }
 
-        else {
-          LOG_ERROR("unknown datafile '%s'", file);
+    if (cm->_cid != collection->_info._cid) {
+      LOG_ERROR("collection identifier mismatch, expected %llu, found %llu",
+                (unsigned long long) collection->_info._cid,
+                (unsigned long long) cm->_cid);
+
+      TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+      stop = true;
+      continue;
+    }
+
+    // file is a journal
+    if (TRI_EqualString2("journal", first, firstLen)) {
+      if (datafile->_isSealed) {
+        if (datafile->_state != TRI_DF_STATE_READ) {
+          LOG_WARNING("strange, journal '%s' is already sealed; must be a left over; will use it as datafile", filename);
         }
 
+        TRI_PushBackVectorPointer(&sealed, datafile);
+      }
+      else {
+        TRI_PushBackVectorPointer(&journals, datafile);
+      }
+    }
+
+    // file is a compactor
+    else if (TRI_EqualString2("compactor", first, firstLen)) {
+      // ignore
+    }
+
+    // file is a datafile (or was a compaction file)
+    else if (TRI_EqualString2("datafile", first, firstLen) ||
+             TRI_EqualString2("compaction", first, firstLen)) {
+      if (! datafile->_isSealed) {
+        LOG_ERROR("datafile '%s' is not sealed, this should never happen", filename);
+
+        collection->_lastError = TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
         TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+        stop = true;
+        continue;
       }
       else {
-        LOG_ERROR("unknown datafile '%s'", file);
+        TRI_PushBackVectorPointer(&datafiles, datafile);
       }
     }
-  }
 
-  TRI_DestroyVectorString(&files);
+    else {
+      LOG_ERROR("unknown datafile '%s'", filename);
+    }
 
-  regfree(&re);
+    TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+  }
 
   // convert the sealed journals into datafiles
   if (! stop) {
@@ -872,6 +990,11 @@ static void FillParametersFromJson (TRI_col_info_t* parameters,
         parameters->_keyOptions = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value);
       }
     }
+    else if (value->_type == TRI_JSON_ARRAY) {
+      if (TRI_EqualString(key->_value._string.data, "stringDictionary")) {
+        parameters->_stringDictionary = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, value);
+      }
+    }
   }
 }
 
@@ -916,6 +1039,8 @@ void TRI_InitCollectionInfo (TRI_vocbase_t* vocbase,
     parameters->_keyOptions  = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, keyOptions);
   }
 
+  parameters->_stringDictionary = nullptr;
+
   parameters->_deleted       = false;
   parameters->_doCompact     = true;
   parameters->_isVolatile    = false;
@@ -959,6 +1084,13 @@ void TRI_CopyCollectionInfo (TRI_col_info_t* dst,
     dst->_keyOptions  = nullptr;
   }
 
+  if (src->_stringDictionary) {
+    dst->_stringDictionary = TRI_CopyJson(TRI_UNKNOWN_MEM_ZONE, src->_stringDictionary);
+  }
+  else {
+    dst->_stringDictionary = nullptr;
+  }
+
   dst->_deleted       = src->_deleted;
   dst->_doCompact     = src->_doCompact;
   dst->_isSystem      = src->_isSystem;
@@ -975,6 +1107,11 @@ void TRI_FreeCollectionInfoOptions (TRI_col_info_t* parameter) {
     TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, parameter->_keyOptions);
     parameter->_keyOptions = nullptr;
   }
+
+  if (parameter->_stringDictionary != nullptr) {
+    TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, parameter->_stringDictionary);
+    parameter->_stringDictionary = nullptr;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1348,6 +1485,10 @@ TRI_json_t* TRI_CreateJsonCollectionInfo (TRI_col_info_t const* info) {
     TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "keyOptions", TRI_CopyJson(TRI_CORE_MEM_ZONE, info->_keyOptions));
   }
 
+  if (info->_stringDictionary != nullptr) {
+    TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "stringDictionary", TRI_CopyJson(TRI_CORE_MEM_ZONE, info->_stringDictionary));
+  }
+
   TRI_Free(TRI_CORE_MEM_ZONE, planIdString);
   TRI_Free(TRI_CORE_MEM_ZONE, cidString);
 
@@ -1804,9 +1945,10 @@ int TRI_UpgradeCollection20 (TRI_vocbase_t* vocbase,
 
         tick = TRI_NewTickServer();
 
-        // datafile header
+        // datafile header. the shape markers are copied from the old datafiles
+        // as they are, so the new datafile keeps their CRC32 checksums
         TRI_InitMarkerDatafile((char*) &header, TRI_DF_MARKER_HEADER, sizeof(TRI_df_header_marker_t));
-        header._version     = TRI_DF_VERSION;
+        header._version     = TRI_DF_VERSION_CRC32;
         header._maximalSize = 0; // TODO: seems ok to set this to 0, check if this is ok
         header._fid         = tick;
         header.base._tick   = tick;
@@ -185,6 +185,7 @@ typedef struct TRI_col_info_s {
 
   char               _name[TRI_COL_PATH_LENGTH];  // name of the collection
   struct TRI_json_t* _keyOptions;      // options for key creation
+  struct TRI_json_t* _stringDictionary; // string values stored as codes
 
   // flags
   bool               _deleted;         // if true, collection has been deleted
@@ -108,6 +108,33 @@
 
 static int const COMPACTOR_INTERVAL = (1 * 1000 * 1000);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of bytes copied by one compaction round
+///
+/// when a round has copied more than this, the remaining collections are
+/// left for the next round, in which they will be ranked first if their
+/// datafiles are still the most fragmented
+////////////////////////////////////////////////////////////////////////////////
+
+#define COMPACTOR_MAX_BYTES_PER_ROUND (256 * 1024 * 1024)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bytes to copy between two checks of the throttle
+////////////////////////////////////////////////////////////////////////////////
+
+#define COMPACTOR_THROTTLE_CHUNK (1024 * 1024)
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of bytes per second copied by a compactor thread
+/// a value of 0 means the compactor is not throttled
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> CompactionMaxRate(0);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                     private types
 // -----------------------------------------------------------------------------
@@ -122,6 +149,17 @@ typedef struct compaction_blocker_s {
 }
 compaction_blocker_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief I/O budget of a compaction round
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct compaction_throttle_s {
+  double    _start;
+  uint64_t  _bytesCopied;
+  uint64_t  _lastCheck;
+}
+compaction_throttle_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief auxiliary struct used when initializing compaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -142,7 +180,10 @@ compaction_initial_context_t;
 typedef struct compaction_context_s {
   TRI_document_collection_t* _document;
   TRI_datafile_t*            _compactor;
+  TRI_df_version_t           _version;
   TRI_doc_datafile_info_t    _dfi;
+  compaction_throttle_t*     _throttle;
+  uint64_t                   _bytesCopied;
   bool                       _keepDeletions;
 }
 compaction_context_t;
@@ -206,6 +247,7 @@ static TRI_datafile_t* CreateCompactor (TRI_document_collection_t* document,
 
 static int CopyMarker (TRI_document_collection_t* document,
                        TRI_datafile_t* compactor,
+                       TRI_df_version_t version,
                        TRI_df_marker_t const* marker,
                        TRI_df_marker_t** result) {
   int res = TRI_ReserveElementDatafile(compactor, marker->_size, result, 0);
@@ -216,7 +258,14 @@ static int CopyMarker (TRI_document_collection_t* document,
     return TRI_ERROR_ARANGO_NO_JOURNAL;
   }
 
-  return TRI_WriteElementDatafile(compactor, *result, marker, false);
+  res = TRI_WriteElementDatafile(compactor, *result, marker, false);
+
+  if (res == TRI_ERROR_NO_ERROR && version != compactor->_version) {
+    // the marker comes from a datafile with another checksum
+    (*result)->_crc = TRI_CrcMarkerDatafile(compactor->_version, *result);
+  }
+
+  return res;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -417,6 +466,47 @@ static void RenameDatafileCallback (TRI_datafile_t* datafile,
   TRI_Free(TRI_CORE_MEM_ZONE, context);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief account for a copied marker and throttle the compaction
+///
+/// if the compactor is ahead of the configured rate, the documents write-lock
+/// is released while sleeping, so writers are not stalled by the throttle.
+/// this is safe because the Compactifier re-checks each marker against the
+/// primary index under the lock
+////////////////////////////////////////////////////////////////////////////////
+
+static void ThrottleCompaction (compaction_context_t* context,
+                                TRI_df_marker_t const* marker) {
+  uint64_t const size = (uint64_t) AlignedSize(marker);
+  compaction_throttle_t* throttle = context->_throttle;
+
+  context->_bytesCopied += size;
+  throttle->_bytesCopied += size;
+
+  if (throttle->_bytesCopied - throttle->_lastCheck < COMPACTOR_THROTTLE_CHUNK) {
+    return;
+  }
+
+  throttle->_lastCheck = throttle->_bytesCopied;
+
+  uint64_t const rate = CompactionMaxRate.load(std::memory_order_relaxed);
+
+  if (rate == 0) {
+    return;
+  }
+
+  double const expected = (double) throttle->_bytesCopied / (double) rate;
+  double const elapsed = TRI_microtime() - throttle->_start;
+
+  if (expected > elapsed) {
+    TRI_document_collection_t* document = context->_document;
+
+    TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+    usleep((unsigned long) ((expected - elapsed) * 1000.0 * 1000.0));
+    TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief datafile iterator, copies "live" data from datafile into compactor
 ///
@@ -466,7 +556,7 @@ static bool Compactifier (TRI_df_marker_t const* marker,
     context->_keepDeletions = true;
 
     // write to compactor files
-    res = CopyMarker(document, context->_compactor, marker, &result);
+    res = CopyMarker(document, context->_compactor, context->_version, marker, &result);
 
     if (res != TRI_ERROR_NO_ERROR) {
       // TODO: dont fail but recover from this state
@@ -483,13 +573,15 @@ static bool Compactifier (TRI_df_marker_t const* marker,
     // update datafile info
     context->_dfi._numberAlive += 1;
     context->_dfi._sizeAlive += AlignedSize(marker);
+
+    ThrottleCompaction(context, marker);
   }
 
   // deletions
   else if (marker->_type == TRI_DOC_MARKER_KEY_DELETION &&
            context->_keepDeletions) {
     // write to compactor files
-    res = CopyMarker(document, context->_compactor, marker, &result);
+    res = CopyMarker(document, context->_compactor, context->_version, marker, &result);
 
     if (res != TRI_ERROR_NO_ERROR) {
       // TODO: dont fail but recover from this state
@@ -498,12 +590,14 @@ static bool Compactifier (TRI_df_marker_t const* marker,
 
     // update datafile info
     context->_dfi._numberDeletion++;
+
+    ThrottleCompaction(context, marker);
   }
 
   // shapes
   else if (marker->_type == TRI_DF_MARKER_SHAPE) {
     // write to compactor files
-    res = CopyMarker(document, context->_compactor, marker, &result);
+    res = CopyMarker(document, context->_compactor, context->_version, marker, &result);
 
     if (res != TRI_ERROR_NO_ERROR) {
       // TODO: dont fail but recover from this state
@@ -518,12 +612,14 @@ static bool Compactifier (TRI_df_marker_t const* marker,
 
     context->_dfi._numberShapes++;
     context->_dfi._sizeShapes += AlignedSize(marker);
+
+    ThrottleCompaction(context, marker);
   }
 
   // attributes
   else if (marker->_type == TRI_DF_MARKER_ATTRIBUTE) {
     // write to compactor files
-    res = CopyMarker(document, context->_compactor, marker, &result);
+    res = CopyMarker(document, context->_compactor, context->_version, marker, &result);
 
     if (res != TRI_ERROR_NO_ERROR) {
       // TODO: dont fail but recover from this state
@@ -538,6 +634,8 @@ static bool Compactifier (TRI_df_marker_t const* marker,
 
     context->_dfi._numberAttributes++;
     context->_dfi._sizeAttributes += AlignedSize(marker);
+
+    ThrottleCompaction(context, marker);
   }
 
   // transaction markers
@@ -551,7 +649,7 @@ static bool Compactifier (TRI_df_marker_t const* marker,
 
     if (document->_failedTransactions != nullptr) {
       // write to compactor files
-      res = CopyMarker(document, context->_compactor, marker, &result);
+      res = CopyMarker(document, context->_compactor, context->_version, marker, &result);
 
       if (res != TRI_ERROR_NO_ERROR) {
         // TODO: dont fail but recover from this state
@@ -560,6 +658,8 @@ static bool Compactifier (TRI_df_marker_t const* marker,
 
       context->_dfi._numberTransactions++;
       context->_dfi._sizeTransactions += AlignedSize(marker);
+
+      ThrottleCompaction(context, marker);
     }
     // otherwise don't copy
   }
@@ -729,10 +829,10 @@ static compaction_initial_context_t InitCompaction (TRI_document_collection_t* d
     compaction_info_t* compaction = static_cast<compaction_info_t*>(TRI_AtVector(compactions, i));
     TRI_datafile_t* df = compaction->_datafile;
 
-    // We will sequentially scan the logfile for collection:
+    // We will sequentially scan the logfile for collection. the iteration
+    // reads ahead in windows, so the whole file is not requested at once
     if (df->isPhysical(df)) {
       TRI_MMFileAdvise(df->_data, df->_maximalSize, TRI_MADVISE_SEQUENTIAL);
-      TRI_MMFileAdvise(df->_data, df->_maximalSize, TRI_MADVISE_WILLNEED);
     }
 
     if (i == 0) {
@@ -759,10 +859,12 @@ static compaction_initial_context_t InitCompaction (TRI_document_collection_t* d
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compact a list of datafiles
+/// returns the number of bytes copied into the compactor file
 ////////////////////////////////////////////////////////////////////////////////
 
-static void CompactifyDatafiles (TRI_document_collection_t* document,
-                                 TRI_vector_t const* compactions) {
+static uint64_t CompactifyDatafiles (TRI_document_collection_t* document,
+                                     TRI_vector_t const* compactions,
+                                     compaction_throttle_t* throttle) {
   TRI_datafile_t* compactor;
   compaction_initial_context_t initial;
   compaction_context_t context;
@@ -780,7 +882,7 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
   if (initial._failed) {
     LOG_ERROR("could not create initialize compaction");
 
-    return;
+    return 0;
   }
 
   LOG_TRACE("compactify called for collection '%llu' for %d datafiles of total size %llu",
@@ -796,16 +898,18 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
     // some error occurred
     LOG_ERROR("could not create compactor file");
 
-    return;
+    return 0;
   }
 
   LOG_DEBUG("created new compactor file '%s'", compactor->getName(compactor));
 
   memset(&context._dfi, 0, sizeof(TRI_doc_datafile_info_t));
   // these attributes remain the same for all datafiles we collect
-  context._document  = document;
-  context._compactor = compactor;
-  context._dfi._fid  = compactor->_fid;
+  context._document    = document;
+  context._compactor   = compactor;
+  context._dfi._fid    = compactor->_fid;
+  context._throttle    = throttle;
+  context._bytesCopied = 0;
 
   // now compact all datafiles
   for (i = 0; i < n; ++i) {
@@ -821,11 +925,13 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
     // if this is the first datafile in the list of datafiles, we can also collect
     // deletion markers
     context._keepDeletions = compaction->_keepDeletions;
+    context._version       = df->_version;
 
     TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
    
-    // run the actual compaction of a single datafile
-    bool ok = TRI_IterateDatafile(df, Compactifier, &context);
+    // run the actual compaction of a single datafile. the datafile is not
+    // used anymore afterwards, so the scanned pages are released
+    bool ok = TRI_IterateDatafile(df, Compactifier, &context, true);
    
     TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
@@ -833,7 +939,7 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
       LOG_WARNING("failed to compact datafile '%s'", df->getName(df));
       // compactor file does not need to be removed now. will be removed on next startup
       // TODO: Remove
-      return;
+      return context._bytesCopied;
     }
   } // next file
 
@@ -847,7 +953,7 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
     TRI_WRITE_UNLOCK_DATAFILES_DOC_COLLECTION(document);
 
     LOG_ERROR("logic error in CompactifyDatafiles: could not find compactor");
-    return;
+    return context._bytesCopied;
   }
 
   if (! TRI_CloseDatafileDocumentCollection(document, j, true)) {
@@ -855,7 +961,7 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
 
     LOG_ERROR("could not close compactor file");
     // TODO: how do we recover from this state?
-    return;
+    return context._bytesCopied;
   }
 
   TRI_WRITE_UNLOCK_DATAFILES_DOC_COLLECTION(document);
@@ -948,13 +1054,60 @@ static void CompactifyDatafiles (TRI_document_collection_t* document,
       }
     }
   }
+
+  return context._bytesCopied;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief determine the compaction priority of a collection
+///
+/// the priority is the highest share of dead data in any of the collection's
+/// datafiles. collections with a priority of 0 have nothing to compact
+////////////////////////////////////////////////////////////////////////////////
+
+static double CompactionPriority (TRI_vocbase_col_t* collection) {
+  if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
+    return 0.0;
+  }
+
+  double priority = 0.0;
+  TRI_document_collection_t* document = collection->_collection;
+
+  if (document != nullptr &&
+      collection->_status == TRI_VOC_COL_STATUS_LOADED &&
+      document->_info._doCompact &&
+      TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(document)) {
+    size_t const n = document->_datafiles._length;
+
+    for (size_t i = 0; i < n; ++i) {
+      TRI_datafile_t* df = static_cast<TRI_datafile_t*>(document->_datafiles._buffer[i]);
+      TRI_doc_datafile_info_t* dfi = TRI_FindDatafileInfoDocumentCollection(document, df->_fid, false);
+
+      if (dfi == nullptr || dfi->_sizeDead <= 0) {
+        continue;
+      }
+
+      double share = (double) dfi->_sizeDead / ((double) dfi->_sizeDead + (double) dfi->_sizeAlive);
+
+      if (share > priority) {
+        priority = share;
+      }
+    }
+
+    TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(document);
+  }
+
+  TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+
+  return priority;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief checks all datafiles of a collection
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool CompactifyDocumentCollection (TRI_document_collection_t* document) {
+static bool CompactifyDocumentCollection (TRI_document_collection_t* document,
+                                          compaction_throttle_t* throttle) {
   // we can hopefully get away without the lock here...
 //  if (! TRI_IsFullyCollectedDocumentCollection(document)) {
 //    return false;
@@ -1113,7 +1266,12 @@ static bool CompactifyDocumentCollection (TRI_document_collection_t* document) {
   // handle datafiles with dead objects
   TRI_ASSERT(TRI_LengthVector(&vector) >= 1);
 
-  CompactifyDatafiles(document, &vector);
+  uint64_t copied = CompactifyDatafiles(document, &vector, throttle);
+
+  LOG_TRACE("compacted %d datafiles of collection '%llu', copied %llu bytes",
+            (int) TRI_LengthVector(&vector),
+            (unsigned long long) document->_info._cid,
+            (unsigned long long) copied);
 
   // cleanup local variables
   TRI_DestroyVector(&vector);
@@ -1181,6 +1339,68 @@ static bool CheckAndLockCompaction (TRI_vocbase_t* vocbase) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compact a single collection if it is loaded and not in use by
+/// another compaction. returns true if datafiles were compacted
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CompactifyCollection (TRI_vocbase_col_t* collection,
+                                  double now,
+                                  compaction_throttle_t* throttle) {
+  if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
+    // if we can't acquire the read lock instantly, we continue directly
+    // we don't want to stall here for too long
+    return false;
+  }
+
+  TRI_document_collection_t* document = collection->_collection;
+
+  if (document == nullptr) {
+    TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+    return false;
+  }
+
+  bool worked    = false;
+  bool doCompact = document->_info._doCompact;
+
+  // for document collection, compactify datafiles
+  if (collection->_status == TRI_VOC_COL_STATUS_LOADED && doCompact) {
+    // check whether someone else holds a read-lock on the compaction lock
+    if (! TRI_TryWriteLockReadWriteLock(&document->_compactionLock)) {
+      // someone else is holding the compactor lock, we'll not compact
+      TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+      return false;
+    }
+
+    if (document->_lastCompaction + COMPACTOR_COLLECTION_INTERVAL <= now) {
+      auto ce = document->ditches()->createCompactionDitch(__FILE__, __LINE__);
+
+      if (ce == nullptr) {
+        // out of memory
+        LOG_WARNING("out of memory when trying to create compaction ditch");
+      }
+      else {
+        worked = CompactifyDocumentCollection(document, throttle);
+
+        if (! worked) {
+          // set compaction stamp
+          document->_lastCompaction = now;
+        }
+        // if we worked, then we don't set the compaction stamp to force another round of compaction
+
+        document->ditches()->freeDitch(ce);
+      }
+    }
+
+    // read-unlock the compaction lock
+    TRI_WriteUnlockReadWriteLock(&document->_compactionLock);
+  }
+
+  TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+
+  return worked;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -1322,6 +1542,14 @@ void TRI_UnlockCompactorVocBase (TRI_vocbase_t* vocbase) {
   UnlockCompaction(vocbase);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximum number of bytes per second a compactor may copy
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMaxRateCompactorVocBase (uint64_t value) {
+  CompactionMaxRate.store(value, std::memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief remove an existing compaction blocker
 ////////////////////////////////////////////////////////////////////////////////
@@ -1364,89 +1592,72 @@ void TRI_CompactorVocBase (void* data) {
   TRI_ASSERT(vocbase->_state == 1);
 
   std::vector<TRI_vocbase_col_t*> collections;
+  std::vector<std::pair<double, TRI_vocbase_col_t*>> ranked;
 
   while (true) {
     // keep initial _state value as vocbase->_state might change during compaction loop
     int state = vocbase->_state;
+    numCompacted = 0;
 
-    // check if compaction is currently disallowed
-    if (CheckAndLockCompaction(vocbase)) {
-      // compaction is currently allowed
-      double now = TRI_microtime();
-      numCompacted = 0;
-
-      try {
-        READ_LOCKER(vocbase->_collectionsLock);
-        // copy all collections
-        collections = vocbase->_collections;
-      }
-      catch (...) {
-        collections.clear();
-      }
-
-      for (auto& collection : collections) {
-        if (! TRI_TRY_READ_LOCK_STATUS_VOCBASE_COL(collection)) {
-          // if we can't acquire the read lock instantly, we continue directly
-          // we don't want to stall here for too long
-          continue;
-        }
+    try {
+      READ_LOCKER(vocbase->_collectionsLock);
+      // copy all collections
+      collections = vocbase->_collections;
+    }
+    catch (...) {
+      collections.clear();
+    }
 
-        TRI_document_collection_t* document = collection->_collection;
+    // rank the collections so that the most fragmented ones are compacted
+    // first. collections without dead data keep their relative order at the
+    // end, as they may still have small datafiles to merge
+    ranked.clear();
 
-        if (document == nullptr) {
-          TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
-          continue;
-        }
+    for (auto& collection : collections) {
+      ranked.emplace_back(CompactionPriority(collection), collection);
+    }
 
-        bool worked    = false;
-        bool doCompact = document->_info._doCompact;
+    std::stable_sort(ranked.begin(), ranked.end(), [] (std::pair<double, TRI_vocbase_col_t*> const& lhs,
+                                                       std::pair<double, TRI_vocbase_col_t*> const& rhs) {
+      return lhs.first > rhs.first;
+    });
 
-        // for document collection, compactify datafiles
-        if (collection->_status == TRI_VOC_COL_STATUS_LOADED && doCompact) {
-          // check whether someone else holds a read-lock on the compaction lock
-          if (! TRI_TryWriteLockReadWriteLock(&document->_compactionLock)) {
-            // someone else is holding the compactor lock, we'll not compact
-            TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
-            continue;
-          }
+    double now = TRI_microtime();
 
-          if (document->_lastCompaction + COMPACTOR_COLLECTION_INTERVAL <= now) {
-            auto ce = document->ditches()->createCompactionDitch(__FILE__, __LINE__);
+    compaction_throttle_t throttle;
+    throttle._start       = now;
+    throttle._bytesCopied = 0;
+    throttle._lastCheck   = 0;
 
-            if (ce == nullptr) {
-              // out of memory
-              LOG_WARNING("out of memory when trying to create compaction ditch");
-            }
-            else {
-              worked = CompactifyDocumentCollection(document);
+    for (auto& it : ranked) {
+      TRI_vocbase_col_t* collection = it.second;
 
-              if (! worked) {
-                // set compaction stamp
-                document->_lastCompaction = now;
-              }
-              // if we worked, then we don't set the compaction stamp to force another round of compaction
+      if (throttle._bytesCopied >= (uint64_t) COMPACTOR_MAX_BYTES_PER_ROUND) {
+        // the I/O budget for this round is used up. leave the remaining
+        // collections for the next round
+        ++numCompacted;
+        break;
+      }
 
-              document->ditches()->freeDitch(ce);
-            }
-          }
+      // check if compaction is currently disallowed. the lock is held for
+      // one collection only, so compaction blockers (e.g. from replication)
+      // do not have to wait for a full round
+      if (! CheckAndLockCompaction(vocbase)) {
+        break;
+      }
 
-          // read-unlock the compaction lock
-          TRI_WriteUnlockReadWriteLock(&document->_compactionLock);
-        }
+      bool worked = CompactifyCollection(collection, now, &throttle);
 
-        TRI_READ_UNLOCK_STATUS_VOCBASE_COL(collection);
+      UnlockCompaction(vocbase);
 
-        if (worked) {
-          ++numCompacted;
+      if (worked) {
+        ++numCompacted;
 
-          // signal the cleanup thread that we worked and that it can now wake up
-          TRI_LockCondition(&vocbase->_cleanupCondition);
-          TRI_SignalCondition(&vocbase->_cleanupCondition);
-          TRI_UnlockCondition(&vocbase->_cleanupCondition);
-        }
+        // signal the cleanup thread that we worked and that it can now wake up
+        TRI_LockCondition(&vocbase->_cleanupCondition);
+        TRI_SignalCondition(&vocbase->_cleanupCondition);
+        TRI_UnlockCondition(&vocbase->_cleanupCondition);
       }
-
-      UnlockCompaction(vocbase);
     }
 
     if (numCompacted > 0) {
@@ -95,6 +95,13 @@ bool TRI_CheckAndLockCompactorVocBase (TRI_vocbase_t*);
 
 void TRI_UnlockCompactorVocBase (TRI_vocbase_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximum number of bytes per second a compactor may copy
+/// a value of 0 turns off the throttling
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetMaxRateCompactorVocBase (uint64_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compactor event loop
 ////////////////////////////////////////////////////////////////////////////////
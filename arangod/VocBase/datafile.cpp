@@ -135,7 +135,8 @@ static int TruncateDatafile (TRI_datafile_t* const datafile, const off_t length)
 /// @brief calculates the actual CRC of a marker, without bounds checks
 ////////////////////////////////////////////////////////////////////////////////
 
-static TRI_voc_crc_t CalculateCrcValue (TRI_df_marker_t const* marker) {
+static TRI_voc_crc_t CalculateCrcValue (TRI_df_marker_t const* marker,
+                                        TRI_df_version_t version) {
   TRI_voc_size_t zero = 0;
   off_t o = offsetof(TRI_df_marker_t, _crc);
   size_t n = sizeof(TRI_voc_crc_t);
@@ -144,9 +145,16 @@ static TRI_voc_crc_t CalculateCrcValue (TRI_df_marker_t const* marker) {
 
   TRI_voc_crc_t crc = TRI_InitialCrc32();
 
-  crc = TRI_BlockCrc32(crc, ptr, o);
-  crc = TRI_BlockCrc32(crc, (char*) &zero, n);
-  crc = TRI_BlockCrc32(crc, ptr + o + n, marker->_size - o - n);
+  if (version == TRI_DF_VERSION_CRC32) {
+    crc = TRI_BlockCrc32(crc, ptr, o);
+    crc = TRI_BlockCrc32(crc, (char*) &zero, n);
+    crc = TRI_BlockCrc32(crc, ptr + o + n, marker->_size - o - n);
+  }
+  else {
+    crc = TRI_BlockCrc32C(crc, ptr, o);
+    crc = TRI_BlockCrc32C(crc, (char*) &zero, n);
+    crc = TRI_BlockCrc32C(crc, ptr + o + n, marker->_size - o - n);
+  }
 
   crc = TRI_FinalCrc32(crc);
 
@@ -158,6 +166,7 @@ static TRI_voc_crc_t CalculateCrcValue (TRI_df_marker_t const* marker) {
 ////////////////////////////////////////////////////////////////////////////////
 
 static std::string DiagnoseMarker (TRI_df_marker_t const* marker,
+                                   TRI_df_version_t version,
                                    char const* end) {
   std::ostringstream result;
 
@@ -197,7 +206,7 @@ static std::string DiagnoseMarker (TRI_df_marker_t const* marker,
     return result.str();
   }
 
-  TRI_voc_crc_t crc = CalculateCrcValue(marker);
+  TRI_voc_crc_t crc = CalculateCrcValue(marker, version);
     
   if (marker->_crc == crc) {
     result << "crc checksum is correct";
@@ -214,7 +223,8 @@ static std::string DiagnoseMarker (TRI_df_marker_t const* marker,
 ////////////////////////////////////////////////////////////////////////////////
 
 static bool CheckCrcMarker (TRI_df_marker_t const* marker,
-                            char const* end) {
+                            char const* end,
+                            TRI_df_version_t version) {
   if (marker->_size < sizeof(TRI_df_marker_t)) {
     return false;
   }
@@ -223,7 +233,7 @@ static bool CheckCrcMarker (TRI_df_marker_t const* marker,
     return false;
   }
 
-  auto expected = CalculateCrcValue(marker);
+  auto expected = CalculateCrcValue(marker, version);
   return marker->_crc == expected;
 }
 
@@ -234,7 +244,8 @@ static bool CheckCrcMarker (TRI_df_marker_t const* marker,
 ////////////////////////////////////////////////////////////////////////////////
 
 static int CreateDatafile (char const* filename,
-                           TRI_voc_size_t maximalSize) {
+                           TRI_voc_size_t maximalSize,
+                           bool preallocate) {
   TRI_ERRORBUF;
   
   // open the file
@@ -261,41 +272,67 @@ static int CreateDatafile (char const* filename,
     return -1;
   }
 
-  // fill file with zeros from FileNullBuffer
-  size_t written = 0;
-  while (written < maximalSize) { 
-    size_t writeSize = TRI_GetNullBufferSizeFiles();
+  bool preallocated = false;
 
-    if (writeSize +written > maximalSize) {
-      writeSize = maximalSize - written;
-    }
-  
-    ssize_t writeResult = TRI_WRITE(fd, TRI_GetNullBufferFiles(), (TRI_write_t) writeSize);
-    
-    TRI_IF_FAILURE("CreateDatafile2") {
-      // intentionally fail
-      writeResult = -1;
-      errno = ENOSPC;
+#ifdef __linux__
+  if (preallocate) {
+    // reserve the disk space without writing to the file. the file reads as
+    // zeros, but creating it does not produce dirty pages that are written
+    // back concurrently with other disk writes
+    if (fallocate(fd, 0, 0, (off_t) maximalSize) == 0) {
+      preallocated = true;
     }
+    else if (errno == ENOSPC) {
+      TRI_set_errno(TRI_ERROR_ARANGO_FILESYSTEM_FULL);
+      LOG_ERROR("cannot create datafile '%s': %s", filename, TRI_last_error());
 
-    if (writeResult < 0) {
-      if (errno == ENOSPC) {
-        TRI_set_errno(TRI_ERROR_ARANGO_FILESYSTEM_FULL);
-        LOG_ERROR("cannot create datafile '%s': %s", filename, TRI_last_error());
-      }
-      else {
-        TRI_SYSTEM_ERROR();
-        TRI_set_errno(TRI_ERROR_SYS_ERROR);
-        LOG_ERROR("cannot create datafile '%s': %s", filename, TRI_GET_ERRORBUF);
-      }
-    
       TRI_CLOSE(fd);
       TRI_UnlinkFile(filename);
 
       return -1;
     }
+    // other errors (e.g. the filesystem does not support fallocate) will
+    // make us fall back to filling the file with zeros
+  }
+#endif
+
+  if (! preallocated) {
+    // fill file with zeros from FileNullBuffer
+    size_t written = 0;
+    while (written < maximalSize) { 
+      size_t writeSize = TRI_GetNullBufferSizeFiles();
 
-    written += static_cast<size_t>(writeResult);
+      if (writeSize +written > maximalSize) {
+        writeSize = maximalSize - written;
+      }
+  
+      ssize_t writeResult = TRI_WRITE(fd, TRI_GetNullBufferFiles(), (TRI_write_t) writeSize);
+    
+      TRI_IF_FAILURE("CreateDatafile2") {
+        // intentionally fail
+        writeResult = -1;
+        errno = ENOSPC;
+      }
+
+      if (writeResult < 0) {
+        if (errno == ENOSPC) {
+          TRI_set_errno(TRI_ERROR_ARANGO_FILESYSTEM_FULL);
+          LOG_ERROR("cannot create datafile '%s': %s", filename, TRI_last_error());
+        }
+        else {
+          TRI_SYSTEM_ERROR();
+          TRI_set_errno(TRI_ERROR_SYS_ERROR);
+          LOG_ERROR("cannot create datafile '%s': %s", filename, TRI_GET_ERRORBUF);
+        }
+    
+        TRI_CLOSE(fd);
+        TRI_UnlinkFile(filename);
+
+        return -1;
+      }
+
+      written += static_cast<size_t>(writeResult);
+    }
   }
   
   // go back to offset 0
@@ -327,6 +364,7 @@ static void InitDatafile (TRI_datafile_t* datafile,
                           TRI_voc_size_t maximalSize,
                           TRI_voc_size_t currentSize,
                           TRI_voc_fid_t fid,
+                          TRI_df_version_t version,
                           char* data) {
 
   // filename is a string for physical datafiles, and NULL for anonymous regions
@@ -342,6 +380,7 @@ static void InitDatafile (TRI_datafile_t* datafile,
   datafile->_fid         = fid;
 
   datafile->_filename    = filename;
+  datafile->_version     = version;
   datafile->_fd          = fd;
   datafile->_mmHandle    = mmHandle;
 
@@ -587,7 +626,7 @@ static TRI_df_scan_t ScanDatafile (TRI_datafile_t const* datafile) {
     if (marker->_size < sizeof(TRI_df_marker_t)) {
       entry._status = 4;
 
-      auto&& diagnosis = DiagnoseMarker(marker, end);
+      auto&& diagnosis = DiagnoseMarker(marker, datafile->_version, end);
       entry._diagnosis = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, diagnosis.c_str(), diagnosis.size());
 
       scan._endPosition = currentSize;
@@ -600,7 +639,7 @@ static TRI_df_scan_t ScanDatafile (TRI_datafile_t const* datafile) {
     if (! TRI_IsValidMarkerDatafile(marker)) {
       entry._status = 4;
 
-      auto&& diagnosis = DiagnoseMarker(marker, end);
+      auto&& diagnosis = DiagnoseMarker(marker, datafile->_version, end);
       entry._diagnosis = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, diagnosis.c_str(), diagnosis.size());
 
       scan._endPosition = currentSize;
@@ -610,12 +649,12 @@ static TRI_df_scan_t ScanDatafile (TRI_datafile_t const* datafile) {
       return scan;
     }
 
-    ok = CheckCrcMarker(marker, end);
+    ok = CheckCrcMarker(marker, end, datafile->_version);
 
     if (! ok) {
       entry._status = 5;
       
-      auto&& diagnosis = DiagnoseMarker(marker, end);
+      auto&& diagnosis = DiagnoseMarker(marker, datafile->_version, end);
       entry._diagnosis = TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, diagnosis.c_str(), diagnosis.size());
       
       scan._status = 4;
@@ -700,7 +739,7 @@ static bool TryRepairDatafile (TRI_datafile_t* datafile) {
     }
 
     if (marker->_type != 0) {
-      if (! CheckCrcMarker(marker, end)) {
+      if (! CheckCrcMarker(marker, end, datafile->_version)) {
         // CRC mismatch!
         auto next = reinterpret_cast<char const*>(marker) + marker->_size;
         auto p = next;
@@ -736,7 +775,7 @@ static bool TryRepairDatafile (TRI_datafile_t* datafile) {
                 nextMarker->_size >= sizeof(TRI_df_marker_t) &&
                 next + nextMarker->_size <= end &&
                 TRI_IsValidMarkerDatafile(nextMarker) &&
-                CheckCrcMarker(nextMarker, end)) {
+                CheckCrcMarker(nextMarker, end, datafile->_version)) {
               // next marker looks good.
 
               // create a temporary buffer
@@ -749,7 +788,7 @@ static bool TryRepairDatafile (TRI_datafile_t* datafile) {
               // create a new marker in the temporary buffer
               auto temp = reinterpret_cast<TRI_df_marker_t*>(buffer);
               TRI_InitMarkerDatafile(static_cast<char*>(buffer), TRI_DF_MARKER_BLANK, static_cast<TRI_voc_size_t>(marker->_size));
-              temp->_crc = CalculateCrcValue(temp);
+              temp->_crc = CalculateCrcValue(temp, datafile->_version);
 
               // all done. now copy back the marker into the file
               memcpy(static_cast<void*>(ptr), buffer, static_cast<size_t>(marker->_size));
@@ -941,7 +980,7 @@ static bool CheckDatafile (TRI_datafile_t* datafile,
     }
 
     if (marker->_type != 0) {
-      bool ok = CheckCrcMarker(marker, end);
+      bool ok = CheckCrcMarker(marker, end, datafile->_version);
 
       if (! ok) {
         // CRC mismatch!
@@ -979,7 +1018,7 @@ static bool CheckDatafile (TRI_datafile_t* datafile,
                     nextMarker->_size >= sizeof(TRI_df_marker_t) &&
                     next + nextMarker->_size <= end &&
                     TRI_IsValidMarkerDatafile(nextMarker) &&
-                    CheckCrcMarker(nextMarker, end)) {
+                    CheckCrcMarker(nextMarker, end, datafile->_version)) {
                   // next marker looks good.
                   nextMarkerOk = true;
                 }
@@ -1004,7 +1043,7 @@ static bool CheckDatafile (TRI_datafile_t* datafile,
           LOG_WARNING("crc mismatch found in datafile '%s' at position %lu. expected crc: %x, actual crc: %x", 
                       datafile->getName(datafile),
                       (unsigned long) currentSize,
-                      CalculateCrcValue(marker),
+                      CalculateCrcValue(marker, datafile->_version),
                       marker->_crc);
           
           if (nextMarkerOk) {
@@ -1082,7 +1121,7 @@ static int WriteInitialHeaderMarker (TRI_datafile_t* datafile,
   TRI_InitMarkerDatafile((char*) &header, TRI_DF_MARKER_HEADER, sizeof(TRI_df_header_marker_t));
   header.base._tick = (TRI_voc_tick_t) fid;
 
-  header._version     = TRI_DF_VERSION;
+  header._version     = datafile->_version;
   header._maximalSize = maximalSize;
   header._fid         = fid;
 
@@ -1177,8 +1216,15 @@ static TRI_datafile_t* OpenDatafile (char const* filename,
   
   char const* end = static_cast<char const*>(ptr) + len;
 
+  // the version selects the checksum of all markers, including the header
+  TRI_df_version_t version = header._version;
+
+  if (version != TRI_DF_VERSION && version != TRI_DF_VERSION_CRC32) {
+    version = TRI_DF_VERSION;
+  }
+
   // check CRC
-  ok = CheckCrcMarker(&header.base, end);
+  ok = CheckCrcMarker(&header.base, end, version);
 
   if (! ok) {
     TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
@@ -1193,7 +1239,7 @@ static TRI_datafile_t* OpenDatafile (char const* filename,
 
   // check the datafile version
   if (ok) {
-    if (header._version != TRI_DF_VERSION) {
+    if (header._version != TRI_DF_VERSION && header._version != TRI_DF_VERSION_CRC32) {
       TRI_set_errno(TRI_ERROR_ARANGO_CORRUPTED_DATAFILE);
 
       LOG_ERROR("unknown datafile version '%u' in datafile '%s'",
@@ -1243,6 +1289,7 @@ static TRI_datafile_t* OpenDatafile (char const* filename,
                size,
                size,
                fid,
+               version,
                static_cast<char*>(data));
 
   return datafile;
@@ -1259,7 +1306,8 @@ static TRI_datafile_t* OpenDatafile (char const* filename,
 TRI_datafile_t* TRI_CreateDatafile (char const* filename,
                                     TRI_voc_fid_t fid,
                                     TRI_voc_size_t maximalSize,
-                                    bool withInitialMarkers) {
+                                    bool withInitialMarkers,
+                                    bool preallocate) {
   TRI_datafile_t* datafile;
 
   TRI_ASSERT(PageSize >= 256);
@@ -1285,7 +1333,7 @@ TRI_datafile_t* TRI_CreateDatafile (char const* filename,
 #endif
   }
   else {
-    datafile = TRI_CreatePhysicalDatafile(filename, fid, maximalSize);
+    datafile = TRI_CreatePhysicalDatafile(filename, fid, maximalSize, preallocate);
   }
 
   if (datafile == nullptr) {
@@ -1386,6 +1434,7 @@ TRI_datafile_t* TRI_CreateAnonymousDatafile (TRI_voc_fid_t fid,
                maximalSize,
                0,
                fid,
+               TRI_DF_VERSION,
                static_cast<char*>(data));
 
   return datafile;
@@ -1399,10 +1448,11 @@ TRI_datafile_t* TRI_CreateAnonymousDatafile (TRI_voc_fid_t fid,
 
 TRI_datafile_t* TRI_CreatePhysicalDatafile (char const* filename,
                                             TRI_voc_fid_t fid,
-                                            TRI_voc_size_t maximalSize) {
+                                            TRI_voc_size_t maximalSize,
+                                            bool preallocate) {
   TRI_ASSERT(filename != nullptr);
 
-  int fd = CreateDatafile(filename, maximalSize);
+  int fd = CreateDatafile(filename, maximalSize, preallocate);
 
   if (fd < 0) {
     // an error occurred
@@ -1448,6 +1498,7 @@ TRI_datafile_t* TRI_CreatePhysicalDatafile (char const* filename,
                maximalSize,
                0,
                fid,
+               TRI_DF_VERSION,
                static_cast<char*>(data));
 
   // Advise OS that sequential access is going to happen:
@@ -1612,6 +1663,16 @@ bool TRI_IsValidMarkerDatafile (TRI_df_marker_t const* marker) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calculates the checksum of a marker for a datafile of the given
+/// version
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_voc_crc_t TRI_CrcMarkerDatafile (TRI_df_version_t version,
+                                     TRI_df_marker_t const* marker) {
+  return CalculateCrcValue(marker, version);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reserves room for an element, advances the pointer
 ///
@@ -1855,10 +1916,7 @@ int TRI_WriteCrcElementDatafile (TRI_datafile_t* datafile,
   TRI_ASSERT(marker->_tick != 0);
 
   if (datafile->isPhysical(datafile)) {
-    TRI_voc_crc_t crc = TRI_InitialCrc32();
-
-    crc = TRI_BlockCrc32(crc, (char const*) marker, marker->_size);
-    marker->_crc = TRI_FinalCrc32(crc);
+    marker->_crc = TRI_CrcMarkerDatafile(datafile->_version, marker);
   }
 
   return TRI_WriteElementDatafile(datafile, position, marker, forceSync);
@@ -1871,7 +1929,8 @@ int TRI_WriteCrcElementDatafile (TRI_datafile_t* datafile,
 
 bool TRI_IterateDatafile (TRI_datafile_t* datafile,
                           bool (*iterator)(TRI_df_marker_t const*, void*, TRI_datafile_t*),
-                          void* data) {
+                          void* data,
+                          bool release) {
   TRI_ASSERT(iterator != nullptr);
 
   LOG_TRACE("iterating over datafile '%s', fid: %llu",
@@ -1886,17 +1945,23 @@ bool TRI_IterateDatafile (TRI_datafile_t* datafile,
     return false;
   }
 
+  TRI_df_readahead_t readahead;
+  TRI_InitReadaheadDatafile(&readahead, datafile, release);
+
   while (ptr < end) {
     TRI_df_marker_t const* marker = reinterpret_cast<TRI_df_marker_t const*>(ptr);
 
     if (marker->_size == 0) {
-      return true;
+      break;
     }
 
+    TRI_AdvanceReadaheadDatafile(&readahead, ptr);
+
     // update the tick statistics
     TRI_UpdateTicksDatafile(datafile, marker);
 
     if (! iterator(marker, data, datafile)) {
+      TRI_FinishReadaheadDatafile(&readahead);
       return false;
     }
 
@@ -1904,9 +1969,83 @@ bool TRI_IterateDatafile (TRI_datafile_t* datafile,
     ptr += size;
   }
 
+  TRI_FinishReadaheadDatafile(&readahead);
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts a sequential scan of the current contents of a datafile
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitReadaheadDatafile (TRI_df_readahead_t* readahead,
+                                TRI_datafile_t const* datafile,
+                                bool release) {
+  if (! datafile->isPhysical(datafile) || datafile->_data == nullptr) {
+    // nothing to read for anonymous regions
+    readahead->_end      = nullptr;
+    readahead->_advised  = nullptr;
+    readahead->_released = nullptr;
+    readahead->_release  = false;
+    return;
+  }
+
+  // the mapping starts at a page boundary
+  readahead->_end      = datafile->_data + datafile->_currentSize;
+  readahead->_advised  = datafile->_data;
+  readahead->_released = datafile->_data;
+  readahead->_release  = release;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances a sequential scan to a position in the datafile
+///
+/// the next window is advised when the scan has entered the second half of
+/// the current one, so the kernel reads while the scan processes the data.
+/// pages are released in steps of a window, and only up to the page of the
+/// scan position
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AdvanceReadaheadDatafile (TRI_df_readahead_t* readahead,
+                                   char const* position) {
+  static size_t const WindowSize = 4 * 1024 * 1024;
+
+  if (readahead->_end == nullptr) {
+    return;
+  }
+
+  if (readahead->_advised < readahead->_end &&
+      position + WindowSize / 2 >= readahead->_advised) {
+    size_t length = (std::min)(WindowSize, static_cast<size_t>(readahead->_end - readahead->_advised));
+
+    // windows start at page boundaries, only the last one may end in a page
+    TRI_MMFileAdvise(readahead->_advised, length, TRI_MADVISE_WILLNEED);
+    readahead->_advised += length;
+  }
+
+  if (readahead->_release &&
+      position >= readahead->_released + WindowSize + PageSize) {
+    char* upto = const_cast<char*>(position) - reinterpret_cast<uintptr_t>(position) % PageSize;
+
+    TRI_MMFileAdvise(readahead->_released, upto - readahead->_released, TRI_MADVISE_DONTNEED);
+    readahead->_released = upto;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finishes a sequential scan
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FinishReadaheadDatafile (TRI_df_readahead_t* readahead) {
+  if (readahead->_release && readahead->_end > readahead->_released) {
+    TRI_MMFileAdvise(readahead->_released, readahead->_end - readahead->_released, TRI_MADVISE_DONTNEED);
+  }
+
+  readahead->_end      = nullptr;
+  readahead->_advised  = nullptr;
+  readahead->_released = nullptr;
+  readahead->_release  = false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief opens an existing datafile
 ///
@@ -2018,6 +2157,19 @@ bool TRI_RenameDatafile (TRI_datafile_t* datafile, char const* filename) {
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief assigns the fid to a datafile and writes its header marker
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_WriteHeaderDatafile (TRI_datafile_t* datafile, TRI_voc_fid_t fid) {
+  TRI_ASSERT(datafile->_currentSize == 0);
+  TRI_ASSERT(datafile->_state == TRI_DF_STATE_WRITE);
+
+  datafile->_fid = fid;
+
+  return WriteInitialHeaderMarker(datafile, fid, datafile->_maximalSize);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief seals a datafile, writes a footer, sets it to read-only
 ////////////////////////////////////////////////////////////////////////////////
@@ -96,9 +96,20 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief datafile version
+///
+/// the markers of datafiles of this version are checksummed with CRC32C
 ////////////////////////////////////////////////////////////////////////////////
 
-#define TRI_DF_VERSION          (1)
+#define TRI_DF_VERSION          (2)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief datafile version whose markers are checksummed with CRC32
+///
+/// datafiles of this version are still read and written, so they do not need
+/// to be converted
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_DF_VERSION_CRC32    (1)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief alignment in datafile blocks
@@ -276,6 +287,8 @@ typedef struct TRI_datafile_s {
 
   char* _filename;               // underlying filename
 
+  TRI_df_version_t _version;     // version of the datafile, selects the marker checksum
+
   // function pointers
   bool (*isPhysical)(const struct TRI_datafile_s* const); // returns true if the datafile is a physical file
   const char* (*getName)(const struct TRI_datafile_s* const); // returns the name of a datafile
@@ -297,6 +310,23 @@ typedef struct TRI_datafile_s {
 }
 TRI_datafile_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read-ahead state of a sequential scan of a datafile
+///
+/// the pages in a window ahead of the scan position are advised to be read,
+/// so a scan of cold data does not fault in one page at a time. a one-off
+/// scan can also release the pages behind the scan position from the mapping,
+/// so they are reclaimed before the pages that other readers still use
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_df_readahead_s {
+  char* _end;                    // end of the scanned region
+  char* _advised;                // end of the region advised to be read
+  char* _released;               // end of the region released, if _release
+  bool _release;                 // release the pages behind the scan position
+}
+TRI_df_readahead_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief datafile marker
 ///
@@ -573,13 +603,15 @@ TRI_doc_prepare_transaction_marker_t;
 /// @brief creates a new datafile
 ///
 /// This either creates a datafile using TRI_CreateAnonymousDatafile or
-/// ref TRI_CreatePhysicalDatafile, based on the first parameter
+/// ref TRI_CreatePhysicalDatafile, based on the first parameter. The last
+/// parameter is only used for physical datafiles
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_datafile_t* TRI_CreateDatafile (char const*,
                                     TRI_voc_fid_t fid,
                                     TRI_voc_size_t,
-                                    bool);
+                                    bool,
+                                    bool = false);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a new anonymous datafile
@@ -605,11 +637,16 @@ TRI_datafile_t* TRI_CreateAnonymousDatafile (TRI_voc_fid_t,
 /// that writing to the datafile will fill up your filesystem. This file is then
 /// mapped into the address of the process using mmap. The create function
 /// automatically adds a @ref TRI_df_footer_marker_t to the file.
+///
+/// If preallocate is true, the disk space for the file is reserved using
+/// fallocate where supported. Otherwise, or if fallocate fails, the file is
+/// filled with zeros.
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_datafile_t* TRI_CreatePhysicalDatafile (char const*,
                                             TRI_voc_fid_t,
-                                            TRI_voc_size_t);
+                                            TRI_voc_size_t,
+                                            bool);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief frees the memory allocated, but does not free the pointer
@@ -663,6 +700,14 @@ void TRI_InitMarkerDatafile (char*,
 
 bool TRI_IsValidMarkerDatafile (TRI_df_marker_t const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calculates the checksum of a marker for a datafile of the given
+/// version. the checksum stored in the marker is not included
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_voc_crc_t TRI_CrcMarkerDatafile (TRI_df_version_t,
+                                     TRI_df_marker_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief reserves room for an element, advances the pointer
 ////////////////////////////////////////////////////////////////////////////////
@@ -705,7 +750,34 @@ void TRI_UpdateTicksDatafile (TRI_datafile_t*,
 
 bool TRI_IterateDatafile (TRI_datafile_t*,
                           bool (*iterator)(TRI_df_marker_t const*, void*, TRI_datafile_t*),
-                          void* data);
+                          void* data,
+                          bool release = false);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts a sequential scan of the current contents of a datafile
+///
+/// if release is true, the pages behind the scan position are released from
+/// the mapping. this is ignored for anonymous datafiles, whose pages would
+/// be lost
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitReadaheadDatafile (TRI_df_readahead_t*,
+                                TRI_datafile_t const*,
+                                bool release);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances a sequential scan to a position in the datafile
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AdvanceReadaheadDatafile (TRI_df_readahead_t*,
+                                   char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finishes a sequential scan, releasing the remaining pages if the
+/// scan releases them
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FinishReadaheadDatafile (TRI_df_readahead_t*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief opens an existing datafile read-only
@@ -732,6 +804,15 @@ int TRI_SealDatafile (TRI_datafile_t* datafile) TRI_WARN_UNUSED_RESULT;
 
 bool TRI_RenameDatafile (TRI_datafile_t* datafile, char const* filename);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief assigns the fid to a datafile that has been created without initial
+/// markers, and writes its header marker
+///
+/// this allows creating a datafile before its fid is known
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_WriteHeaderDatafile (TRI_datafile_t* datafile, TRI_voc_fid_t fid);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief truncates a datafile and seals it, only called by arango-dfdd
 ////////////////////////////////////////////////////////////////////////////////
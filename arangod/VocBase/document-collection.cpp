@@ -30,21 +30,28 @@
 #include "document-collection.h"
 
 #include "Aql/QueryCache.h"
+#include "Aql/QueryPlanCache.h"
 #include "Basics/Barrier.h"
 #include "Basics/conversions.h"
 #include "Basics/Exceptions.h"
 #include "Basics/files.h"
+#include "Basics/hashes.h"
 #include "Basics/logging.h"
+#include "Basics/MerkleTree.h"
 #include "Basics/tri-strings.h"
 #include "Basics/ThreadPool.h"
 #include "FulltextIndex/fulltext-index.h"
+#include "Indexes/AggregateIndex.h"
 #include "Indexes/CapConstraint.h"
 #include "Indexes/EdgeIndex.h"
 #include "Indexes/FulltextIndex.h"
+#include "Indexes/GeoCellIndex.h"
 #include "Indexes/GeoIndex2.h"
 #include "Indexes/HashIndex.h"
 #include "Indexes/PrimaryIndex.h"
 #include "Indexes/SkiplistIndex.h"
+#include "Indexes/TtlIndex.h"
+#include "Indexes/VertexCentricIndex.h"
 #include "RestServer/ArangoServer.h"
 #include "Utils/transactions.h"
 #include "Utils/CollectionReadLocker.h"
@@ -124,7 +131,16 @@ TRI_document_collection_t::TRI_document_collection_t ()
     _keyGenerator(nullptr),
     _uncollectedLogfileEntries(0),
     _currentWriterThread(0),
-    _cleanupIndexes(0) {
+    _spareJournal(nullptr),
+    _spareJournalSize(0),
+    _cleanupIndexes(0),
+    _capEvictionPending(false),
+    _ttlIndexes(0),
+    _numberExpired(0),
+    _lastAccess(TRI_microtime()),
+    _keyTree(nullptr),
+    _keysChecksum(0),
+    _revisionsChecksum(0) {
 
   _tickMax = 0;
 }
@@ -134,6 +150,7 @@ TRI_document_collection_t::TRI_document_collection_t ()
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_document_collection_t::~TRI_document_collection_t () {
+  delete _keyTree;
   delete _keyGenerator;
 }
 
@@ -287,11 +304,11 @@ int TRI_document_collection_t::beginReadTimed (uint64_t timeout,
       }
     }
 
-#ifdef _WIN32
-    usleep((unsigned long) sleepPeriod);
-#else
-    usleep((useconds_t) sleepPeriod);
-#endif
+    // block until the lock is released rather than sleeping blindly, so the
+    // lock is taken as soon as it is available
+    if (TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(this, sleepPeriod)) {
+      break;
+    }
 
     waited += sleepPeriod;
 
@@ -365,11 +382,10 @@ int TRI_document_collection_t::beginWriteTimed (uint64_t timeout,
       }
     }
 
-#ifdef _WIN32
-    usleep((unsigned long) sleepPeriod);
-#else
-    usleep((useconds_t) sleepPeriod);
-#endif
+    // see beginReadTimed
+    if (TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(this, sleepPeriod)) {
+      break;
+    }
 
     waited += sleepPeriod;
 
@@ -460,8 +476,14 @@ TRI_doc_collection_info_t* TRI_document_collection_t::figures () {
   info->_numberIndexes = 0;
   info->_sizeIndexes   = 0;
 
+  info->_numberDocumentReferences = 0;
+  info->_sizeDocumentReferences   = 0;
+
   if (_headersPtr != nullptr) {
     info->_sizeIndexes += static_cast<int64_t>(_headersPtr->memory());
+
+    info->_numberDocumentReferences = static_cast<TRI_voc_ssize_t>(_headersPtr->numAllocated());
+    info->_sizeDocumentReferences   = static_cast<int64_t>(_headersPtr->memory());
   }
 
   for (auto& idx : allIndexes()) {
@@ -474,11 +496,57 @@ TRI_doc_collection_info_t* TRI_document_collection_t::figures () {
   info->_numberShapefiles = 0;
 
   info->_uncollectedLogfileEntries = _uncollectedLogfileEntries;
+  info->_numberExpired = _numberExpired;
   info->_tickMax = _tickMax;
 
   return info;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the memory held by the loaded collection: the master
+/// pointers, the indexes and the mapped datafiles, journals and compactors
+///
+/// this does not wait for any lock, and returns false if the collection is
+/// busy
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_document_collection_t::memoryUsage (uint64_t& result) {
+  if (! TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(this)) {
+    return false;
+  }
+
+  if (! TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(this)) {
+    TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(this);
+    return false;
+  }
+
+  uint64_t memory = 0;
+
+  if (_headersPtr != nullptr) {
+    memory += static_cast<uint64_t>(_headersPtr->memory());
+  }
+
+  for (auto& idx : _indexes) {
+    memory += static_cast<uint64_t>(idx->memory());
+  }
+
+  TRI_collection_t* base = this;
+
+  for (auto const* files : { &base->_datafiles, &base->_journals, &base->_compactors }) {
+    for (size_t i = 0; i < files->_length; ++i) {
+      auto df = static_cast<TRI_datafile_t const*>(files->_buffer[i]);
+
+      memory += static_cast<uint64_t>(df->_maximalSize);
+    }
+  }
+
+  TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(this);
+  TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(this);
+
+  result = memory;
+  return true;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief add an index to the collection
@@ -495,6 +563,9 @@ void TRI_document_collection_t::addIndex (triagens::arango::Index* idx) {
   else if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX) {
     ++_cleanupIndexes;
   }
+  else if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX) {
+    ++_ttlIndexes;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -523,6 +594,9 @@ triagens::arango::Index* TRI_document_collection_t::removeIndex (TRI_idx_iid_t i
       else if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX) {
         --_cleanupIndexes;
       }
+      else if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX) {
+        --_ttlIndexes;
+      }
 
       return idx;
     }
@@ -610,6 +684,14 @@ VocShaper* TRI_document_collection_t::getShaper () const {
 
 int TRI_AddOperationTransaction (triagens::wal::DocumentOperation&, bool&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add several WAL operations for a transaction collection
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddOperationsTransaction (std::vector<triagens::wal::DocumentOperation*>&,
+                                   std::vector<int>&,
+                                   bool&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              forward declarations
 // -----------------------------------------------------------------------------
@@ -627,6 +709,21 @@ static int GeoIndexFromJson (TRI_document_collection_t*,
                              TRI_idx_iid_t,
                              triagens::arango::Index**);
 
+static int GeoCellIndexFromJson (TRI_document_collection_t*,
+                                 TRI_json_t const*,
+                                 TRI_idx_iid_t,
+                                 triagens::arango::Index**);
+
+static int TtlIndexFromJson (TRI_document_collection_t*,
+                             TRI_json_t const*,
+                             TRI_idx_iid_t,
+                             triagens::arango::Index**);
+
+static int AggregateIndexFromJson (TRI_document_collection_t*,
+                                   TRI_json_t const*,
+                                   TRI_idx_iid_t,
+                                   triagens::arango::Index**);
+
 static int HashIndexFromJson (TRI_document_collection_t*,
                               TRI_json_t const*,
                               TRI_idx_iid_t,
@@ -642,6 +739,11 @@ static int FulltextIndexFromJson (TRI_document_collection_t*,
                                   TRI_idx_iid_t,
                                   triagens::arango::Index**);
 
+static int VertexCentricIndexFromJson (TRI_document_collection_t*,
+                                       TRI_json_t const*,
+                                       TRI_idx_iid_t,
+                                       triagens::arango::Index**);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  HELPER FUNCTIONS
 // -----------------------------------------------------------------------------
@@ -717,6 +819,174 @@ static void EnsureErrorCode (int code) {
   errno = code;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief closes and removes a spare journal
+////////////////////////////////////////////////////////////////////////////////
+
+static void DiscardSpareJournal (TRI_datafile_t* spare) {
+  TRI_CloseDatafile(spare);
+  TRI_UnlinkFile(spare->getName(spare));
+  TRI_FreeDatafile(spare);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief turns the spare journal of a collection into a new journal or
+/// compactor, returns nullptr if there is no suitable spare journal
+///
+/// the journals lock must be held. a journal must have been requested with
+/// the size of the spare journal. a compactor may be larger than requested,
+/// as it is truncated when it is sealed
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_datafile_t* UseSpareJournal (TRI_document_collection_t* document,
+                                        TRI_voc_fid_t fid,
+                                        TRI_voc_size_t journalSize,
+                                        bool isCompactor) {
+  TRI_datafile_t* spare = document->_spareJournal;
+
+  if (spare == nullptr) {
+    return nullptr;
+  }
+
+  if (isCompactor ? (spare->_maximalSize < journalSize) : (document->_spareJournalSize != journalSize)) {
+    return nullptr;
+  }
+
+  TRI_IF_FAILURE("CreateJournalDocumentCollection") {
+    // let the regular creation simulate the failure
+    return nullptr;
+  }
+
+  document->_spareJournal = nullptr;
+
+  int res = TRI_WriteHeaderDatafile(spare, fid);
+
+  if (res == TRI_ERROR_NO_ERROR && isCompactor) {
+    // a journal gets its final name later
+    char* number = TRI_StringUInt64(fid);
+    char* jname = TRI_Concatenate3String("compaction-", number, ".db");
+    char* filename = TRI_Concatenate2File(document->_directory, jname);
+
+    TRI_FreeString(TRI_CORE_MEM_ZONE, number);
+    TRI_FreeString(TRI_CORE_MEM_ZONE, jname);
+
+    if (! TRI_RenameDatafile(spare, filename)) {
+      res = TRI_ERROR_ARANGO_DATAFILE_ALREADY_EXISTS;
+    }
+
+    TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+  }
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    // fall back to creating a new file
+    LOG_WARNING("cannot use spare journal '%s': %s", spare->getName(spare), TRI_errno_string(res));
+    DiscardSpareJournal(spare);
+
+    return nullptr;
+  }
+
+  return spare;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checksum of the key of a document, as used by collection.checksum
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t KeyChecksum (TRI_doc_mptr_t const* header) {
+  return TRI_Crc32HashString(TRI_EXTRACT_MARKER_KEY(header));  // PROTECTED by collection lock
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checksum of the revision of a document, as used by
+/// collection.checksum
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t RevisionChecksum (TRI_doc_mptr_t const* header) {
+  return TRI_Crc32HashPointer(&header->_rid, sizeof(TRI_voc_rid_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief (re)builds the key tree and the checksums from the primary index
+///
+/// the depth of the tree is chosen for the current number of documents. if
+/// there is not enough memory, the old tree and checksums are kept
+////////////////////////////////////////////////////////////////////////////////
+
+static void BuildKeyTree (TRI_document_collection_t* document) {
+  auto primaryIndex = document->primaryIndex();
+  uint32_t const depth = triagens::basics::MerkleTree::depthForCount(primaryIndex->size());
+
+  triagens::basics::MerkleTree* tree = nullptr;
+
+  try {
+    tree = new triagens::basics::MerkleTree(depth);
+  }
+  catch (...) {
+    LOG_WARNING("out of memory when building the key tree of collection '%s'", document->_info._name);
+    return;
+  }
+
+  triagens::basics::BucketPosition position;
+  uint64_t total = 0;
+  uint32_t keysChecksum = 0;
+  uint32_t revisionsChecksum = 0;
+
+  while (true) {
+    auto ptr = primaryIndex->lookupSequential(position, total);
+
+    if (ptr == nullptr) {
+      break;
+    }
+
+    tree->insert(ptr->_hash, ptr->_rid);
+    keysChecksum += KeyChecksum(ptr);
+    revisionsChecksum += RevisionChecksum(ptr);
+  }
+
+  delete document->_keyTree;
+  document->_keyTree = tree;
+  document->_keysChecksum = keysChecksum;
+  document->_revisionsChecksum = revisionsChecksum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a document revision to the key tree and the checksums
+////////////////////////////////////////////////////////////////////////////////
+
+static void InsertKeyTree (TRI_document_collection_t* document,
+                           TRI_doc_mptr_t const* header) {
+  auto tree = document->_keyTree;
+
+  if (tree == nullptr) {
+    // collection is being loaded
+    return;
+  }
+
+  tree->insert(header->_hash, header->_rid);
+  document->_keysChecksum += KeyChecksum(header);
+  document->_revisionsChecksum += RevisionChecksum(header);
+
+  if (tree->isOverfull()) {
+    // grow the tree, like the primary index does
+    BuildKeyTree(document);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a document revision from the key tree and the checksums
+////////////////////////////////////////////////////////////////////////////////
+
+static void RemoveKeyTree (TRI_document_collection_t* document,
+                           TRI_doc_mptr_t const* header) {
+  auto tree = document->_keyTree;
+
+  if (tree != nullptr) {
+    tree->remove(header->_hash, header->_rid);
+    document->_keysChecksum -= KeyChecksum(header);
+    document->_revisionsChecksum -= RevisionChecksum(header);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief creates a new entry in the primary index
 ////////////////////////////////////////////////////////////////////////////////
@@ -744,6 +1014,8 @@ static int InsertPrimaryIndex (TRI_document_collection_t* document,
 
   if (found == nullptr) {
     // success
+    InsertKeyTree(document, header);
+
     return TRI_ERROR_NO_ERROR;
   }
 
@@ -815,6 +1087,8 @@ static int DeletePrimaryIndex (TRI_document_collection_t* document,
     return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
   }
 
+  RemoveKeyTree(document, header);
+
   return TRI_ERROR_NO_ERROR;
 }
 
@@ -973,24 +1247,29 @@ static void UpdateHeader (TRI_voc_fid_t fid,
 static int CleanupIndexes (TRI_document_collection_t* document) {
   int res = TRI_ERROR_NO_ERROR;
 
-  // cleaning indexes is expensive, so only do it if the flag is set for the
-  // collection
-  if (document->_cleanupIndexes > 0) {
-    TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+  // skiplist indexes defer freeing removed nodes to here. this is cheap and
+  // does not need exclusive access, as the skiplists synchronize themselves.
+  // fulltext indexes compact copies of their structures under their own read
+  // lock and swap them in under their own write lock, so the collection's
+  // read lock is enough to keep the indexes alive meanwhile
+  TRI_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
-    for (auto& idx : document->allIndexes()) {
-      if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX) {
-        res = idx->cleanup();
+  for (auto& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX) {
+      idx->cleanup();
+    }
+    else if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX &&
+             document->_cleanupIndexes > 0) {
+      int r = idx->cleanup();
 
-        if (res != TRI_ERROR_NO_ERROR) {
-          break;
-        }
+      if (r != TRI_ERROR_NO_ERROR) {
+        res = r;
       }
     }
-
-    TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
   }
 
+  TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
   return res;
 }
 
@@ -1169,6 +1448,10 @@ static int UpdateDocument (TRI_transaction_collection_t* trxCollection,
     return res;
   }
 
+  // the key stays in the primary index, but the revision changes
+  RemoveKeyTree(document, &oldData);
+  InsertKeyTree(document, newHeader);
+
   operation.indexed();
 
   TRI_IF_FAILURE("UpdateDocumentNoOperation") {
@@ -2369,7 +2652,7 @@ TRI_document_collection_t* TRI_CreateDocumentCollection (TRI_vocbase_t* vocbase,
     return nullptr;
   }
 
-  auto shaper = new VocShaper(TRI_UNKNOWN_MEM_ZONE, document);
+  auto shaper = new VocShaper(TRI_SHAPER_MEM_ZONE, document);
 
   // create document collection and shaper
   if (false == InitDocumentCollection(document, shaper)) {
@@ -2384,6 +2667,8 @@ TRI_document_collection_t* TRI_CreateDocumentCollection (TRI_vocbase_t* vocbase,
 
   document->_keyGenerator = keyGenerator;
 
+  BuildKeyTree(document);
+
   // save the parameters block (within create, no need to lock)
   bool doSync = vocbase->_settings.forceSyncProperties;
   int res = TRI_SaveCollectionInfo(collection->_directory, parameters, doSync);
@@ -2497,9 +2782,12 @@ TRI_datafile_t* TRI_CreateDatafileDocumentCollection (TRI_document_collection_t*
                                                       bool isCompactor) {
   TRI_ASSERT(fid > 0);
 
-  TRI_datafile_t* journal;
+  TRI_datafile_t* journal = UseSpareJournal(document, fid, journalSize, isCompactor);
 
-  if (document->_info._isVolatile) {
+  if (journal != nullptr) {
+    // the file has been created ahead of time
+  }
+  else if (document->_info._isVolatile) {
     // in-memory collection
     journal = TRI_CreateDatafile(nullptr, fid, journalSize, true);
   }
@@ -2655,6 +2943,79 @@ TRI_datafile_t* TRI_CreateDatafileDocumentCollection (TRI_document_collection_t*
   return journal;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the spare journal of a collection whose journal is filling
+/// up
+///
+/// the spare journal is created once the current journal is half full, so
+/// that collections which never fill a journal do not get one
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_PrepareSpareJournalDocumentCollection (TRI_document_collection_t* document) {
+  if (document->_info._isVolatile) {
+    // creating anonymous datafiles is cheap
+    return;
+  }
+
+  TRI_LOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+
+  bool needed = false;
+  TRI_voc_size_t const journalSize = document->_info._maximalSize;
+
+  if (document->_spareJournal == nullptr &&
+      document->_journals._length > 0) {
+    auto journal = static_cast<TRI_datafile_t const*>(document->_journals._buffer[0]);
+    needed = (journal->_currentSize >= journal->_maximalSize / 2);
+  }
+
+  TRI_UNLOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+
+  if (! needed) {
+    return;
+  }
+
+  // create and fill the file without holding the lock. the file gets a
+  // temporary name, so it is removed when the server is restarted before
+  // the file is used
+  TRI_voc_tick_t const tick = TRI_NewTickServer();
+
+  char* number = TRI_StringUInt64(tick);
+  char* jname = TRI_Concatenate3String("temp-", number, ".db");
+  char* filename = TRI_Concatenate2File(document->_directory, jname);
+
+  TRI_FreeString(TRI_CORE_MEM_ZONE, number);
+  TRI_FreeString(TRI_CORE_MEM_ZONE, jname);
+
+  TRI_datafile_t* spare = TRI_CreateDatafile(filename, static_cast<TRI_voc_fid_t>(tick), journalSize, false);
+
+  TRI_FreeString(TRI_CORE_MEM_ZONE, filename);
+
+  if (spare == nullptr) {
+    // the next journal will be created when it is needed
+    LOG_DEBUG("cannot create spare journal for collection '%s': %s",
+              document->_info._name,
+              TRI_last_error());
+    return;
+  }
+
+  TRI_LOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+
+  if (document->_spareJournal == nullptr) {
+    document->_spareJournal = spare;
+    document->_spareJournalSize = journalSize;
+    spare = nullptr;
+  }
+
+  TRI_UNLOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+
+  if (spare != nullptr) {
+    DiscardSpareJournal(spare);
+  }
+  else {
+    LOG_TRACE("created spare journal for collection '%s'", document->_info._name);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief iterate over all documents in the collection, using a user-defined
 /// callback function. Returns the total number of documents in the collection
@@ -2694,6 +3055,69 @@ size_t TRI_DocumentIteratorDocumentCollection (TransactionBase const*,
   return nrUsed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterate over all documents in the collection in chunks, using a
+/// user-defined callback function
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ChunkedDocumentIteratorDocumentCollection (TRI_transaction_collection_t* trxCollection,
+                                                   size_t chunkSize,
+                                                   std::function<bool(TRI_doc_mptr_t const*)> const& callback) {
+  TRI_ASSERT(chunkSize > 0);
+
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+  auto idx = document->primaryIndex();
+
+  // a lock held by the transaction must not be given up by us
+  bool const release = ! TRI_IsLockedCollectionTransaction(trxCollection);
+  int const nestingLevel = trxCollection->_nestingLevel;
+
+  triagens::basics::ScanCursor cursor;
+  bool aborted = false;
+
+  auto visit = [&] (TRI_doc_mptr_t* mptr) -> void {
+    if (! aborted && ! callback(mptr)) {
+      aborted = true;
+    }
+  };
+
+  while (true) {
+    if (release) {
+      int res = TRI_LockCollectionTransaction(trxCollection, TRI_TRANSACTION_READ, nestingLevel);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+
+    bool done;
+
+    try {
+      idx->scanChunk(cursor, chunkSize, visit);
+      done = (aborted || idx->isScanDone(cursor));
+    }
+    catch (...) {
+      if (release) {
+        TRI_UnlockCollectionTransaction(trxCollection, TRI_TRANSACTION_READ, nestingLevel);
+      }
+      throw;
+    }
+
+    if (release) {
+      TRI_UnlockCollectionTransaction(trxCollection, TRI_TRANSACTION_READ, nestingLevel);
+    }
+
+    if (done) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    if (release) {
+      // give waiting writers a chance
+      std::this_thread::yield();
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief create an index, based on a JSON description
 ////////////////////////////////////////////////////////////////////////////////
@@ -2751,6 +3175,14 @@ int TRI_FromJsonIndexDocumentCollection (TRI_document_collection_t* document,
     return GeoIndexFromJson(document, json, iid, idx);
   }
 
+  // ...........................................................................
+  // GEO CELL INDEX
+  // ...........................................................................
+
+  else if (TRI_EqualString(typeStr, "geo-cell")) {
+    return GeoCellIndexFromJson(document, json, iid, idx);
+  }
+
   // ...........................................................................
   // HASH INDEX
   // ...........................................................................
@@ -2767,6 +3199,22 @@ int TRI_FromJsonIndexDocumentCollection (TRI_document_collection_t* document,
     return SkiplistIndexFromJson(document, json, iid, idx);
   }
 
+  // ...........................................................................
+  // TTL INDEX
+  // ...........................................................................
+
+  else if (TRI_EqualString(typeStr, "ttl")) {
+    return TtlIndexFromJson(document, json, iid, idx);
+  }
+
+  // ...........................................................................
+  // AGGREGATE INDEX
+  // ...........................................................................
+
+  else if (TRI_EqualString(typeStr, "aggregate")) {
+    return AggregateIndexFromJson(document, json, iid, idx);
+  }
+
   // ...........................................................................
   // FULLTEXT INDEX
   // ...........................................................................
@@ -2775,6 +3223,14 @@ int TRI_FromJsonIndexDocumentCollection (TRI_document_collection_t* document,
     return FulltextIndexFromJson(document, json, iid, idx);
   }
 
+  // ...........................................................................
+  // VERTEX-CENTRIC INDEX
+  // ...........................................................................
+
+  else if (TRI_EqualString(typeStr, "vertex-centric")) {
+    return VertexCentricIndexFromJson(document, json, iid, idx);
+  }
+
   // ...........................................................................
   // EDGES INDEX
   // ...........................................................................
@@ -2821,6 +3277,9 @@ int TRI_RollbackOperationDocumentCollection (TRI_document_collection_t* document
     // revert again to the new state, because other parts of the new state
     // will be reverted at some other place
     header->copy(copy);
+
+    RemoveKeyTree(document, header);
+    InsertKeyTree(document, oldData);
     
     return res;
   }
@@ -2950,6 +3409,12 @@ class IndexFiller {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief fill the additional (non-primary) indexes
+///
+/// the secondary indexes are always rebuilt from the primary index when a
+/// collection is loaded. their elements point to master pointers, which are
+/// allocated anew on every load and which point into the memory-mapped
+/// datafiles, so the index contents cannot be persisted and reused as they
+/// are. the indexes are filled in parallel by the index threads instead
 ////////////////////////////////////////////////////////////////////////////////
 
 int TRI_FillIndexesDocumentCollection (TRI_vocbase_col_t* collection,
@@ -3096,7 +3561,7 @@ TRI_document_collection_t* TRI_OpenDocumentCollection (TRI_vocbase_t* vocbase,
     return nullptr;
   }
 
-  auto shaper = new VocShaper(TRI_UNKNOWN_MEM_ZONE, document);
+  auto shaper = new VocShaper(TRI_SHAPER_MEM_ZONE, document);
 
   // create document collection and shaper
   if (false == InitDocumentCollection(document, shaper)) {
@@ -3155,6 +3620,10 @@ TRI_document_collection_t* TRI_OpenDocumentCollection (TRI_vocbase_t* vocbase,
 
   TRI_ASSERT(document->getShaper() != nullptr);  // ONLY in OPENCOLLECTION, PROTECTED by fake trx here
 
+  // the open iterator updates documents in place, so the key tree is built
+  // only now
+  BuildKeyTree(document);
+
   if (! triagens::wal::LogfileManager::instance()->isInRecovery()) {
     TRI_FillIndexesDocumentCollection(col, document);
   }
@@ -3185,6 +3654,16 @@ int TRI_CloseDocumentCollection (TRI_document_collection_t* document,
     TRI_SaveCollectionInfo(document->_directory, &document->_info, doSync);
   }
 
+  // the spare journal has never been written to
+  TRI_LOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+  TRI_datafile_t* spare = document->_spareJournal;
+  document->_spareJournal = nullptr;
+  TRI_UNLOCK_JOURNAL_ENTRIES_DOC_COLLECTION(document);
+
+  if (spare != nullptr) {
+    DiscardSpareJournal(spare);
+  }
+
   // closes all open compactors, journals, datafiles
   int res = TRI_CloseCollection(document);
 
@@ -3292,6 +3771,8 @@ static int FillIndexBatch (TRI_document_collection_t* document,
   if (nrUsed > 0) {
     triagens::basics::BucketPosition position;
     uint64_t total = 0;
+    uint64_t indexed = 0;
+
     while (true) {
       TRI_doc_mptr_t const* mptr = primaryIndex->lookupSequential(position, total);
 
@@ -3303,12 +3784,22 @@ static int FillIndexBatch (TRI_document_collection_t* document,
 
       if (documents.size() == blockSize) {
         res = idx->batchInsert(&documents, indexPool->numThreads());
+        indexed += documents.size();
         documents.clear();
 
         // some error occurred
         if (res != TRI_ERROR_NO_ERROR) {
           break;
         }
+
+        // filling the index blocks writers of the collection, so let the
+        // user know how far it got
+        LOG_INFO("indexed %llu of %llu documents of collection '%s/%s' for %s",
+                 (unsigned long long) indexed,
+                 (unsigned long long) nrUsed,
+                 document->_vocbase->_name,
+                 document->_info._name,
+                 idx->context().c_str());
       }
     }
   }
@@ -3446,6 +3937,7 @@ static triagens::arango::Index* LookupPathIndexDocumentCollection (TRI_document_
                                                                    triagens::arango::Index::IndexType type,
                                                                    int sparsity,
                                                                    bool unique,
+                                                                   TRI_json_t const* filter,
                                                                    bool allowAnyAttributeOrder) {
 
   for (auto const& idx : collection->allIndexes()) {
@@ -3462,7 +3954,8 @@ static triagens::arango::Index* LookupPathIndexDocumentCollection (TRI_document_
         auto hashIndex = static_cast<triagens::arango::HashIndex*>(idx);
 
         if (unique != hashIndex->unique() ||
-            (sparsity != -1 && sparsity != (hashIndex->sparse() ? 1 : 0 ))) {
+            (sparsity != -1 && sparsity != (hashIndex->sparse() ? 1 : 0 )) ||
+            ! hashIndex->hasFilter(filter)) {
           continue;
         }
         break;
@@ -3472,16 +3965,26 @@ static triagens::arango::Index* LookupPathIndexDocumentCollection (TRI_document_
         auto skiplistIndex = static_cast<triagens::arango::SkiplistIndex*>(idx);
         
         if (unique != skiplistIndex->unique() ||
-            (sparsity != -1 && sparsity != (skiplistIndex->sparse() ? 1 : 0 ))) {
+            (sparsity != -1 && sparsity != (skiplistIndex->sparse() ? 1 : 0 )) ||
+            ! skiplistIndex->hasFilter(filter)) {
           continue;
         }
         break;
       }
 
-      default: {
-        continue;
-      }
-    }
+      case triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX: {
+        // vertex-centric indexes are never unique nor sparse
+        if (unique ||
+            sparsity == 1) {
+          continue;
+        }
+        break;
+      }
+
+      default: {
+        continue;
+      }
+    }
 
     // .........................................................................
     // check that the number of paths (fields) in the index matches that
@@ -3571,6 +4074,7 @@ static int PathBasedIndexFromJson (TRI_document_collection_t* document,
                                                                         TRI_idx_iid_t,
                                                                         bool,
                                                                         bool,
+                                                                        TRI_json_t const*,
                                                                         bool*),
                                    triagens::arango::Index** dst) {
 
@@ -3637,8 +4141,17 @@ static int PathBasedIndexFromJson (TRI_document_collection_t* document,
     attributes.emplace_back(std::string(fieldStr->_value._string.data, fieldStr->_value._string.length - 1));;
   }
 
+  // determine the filter of a partial index
+  TRI_json_t const* filter = TRI_LookupObjectJson(definition, "filter");
+
+  if (filter != nullptr &&
+      triagens::arango::PathBasedIndex::validateFilter(filter) != TRI_ERROR_NO_ERROR) {
+    LOG_ERROR("ignoring index %llu, invalid 'filter'", (unsigned long long) iid);
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
   // create the index
-  auto idx = creator(document, attributes, iid, sparse, unique, nullptr);
+  auto idx = creator(document, attributes, iid, sparse, unique, filter, nullptr);
 
   if (dst != nullptr) {
     *dst = idx;
@@ -3784,6 +4297,7 @@ bool TRI_DropIndexDocumentCollection (TRI_document_collection_t* document,
     TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
   
     triagens::aql::QueryCache::instance()->invalidate(vocbase, document->_info._name);
+    triagens::aql::QueryPlanCache::instance()->invalidate(vocbase, document->_info._name);
     found = document->removeIndex(iid);
   
     TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
@@ -3940,6 +4454,7 @@ static int PidNamesByAttributeNames (std::vector<std::string> const& attributes,
 static triagens::arango::Index* CreateCapConstraintDocumentCollection (TRI_document_collection_t* document,
                                                                        size_t count,
                                                                        int64_t size,
+                                                                       double tolerance,
                                                                        TRI_idx_iid_t iid,
                                                                        bool* created) {
   if (created != nullptr) {
@@ -3951,7 +4466,8 @@ static triagens::arango::Index* CreateCapConstraintDocumentCollection (TRI_docum
 
   if (existing != nullptr) {
     if (static_cast<size_t>(existing->count()) == count &&
-        existing->size() == size) {
+        existing->size() == size &&
+        existing->tolerance() == tolerance) {
       return static_cast<triagens::arango::Index*>(existing);
     }
       
@@ -3964,7 +4480,7 @@ static triagens::arango::Index* CreateCapConstraintDocumentCollection (TRI_docum
   }
 
   // create a new index
-  std::unique_ptr<triagens::arango::Index> capConstraint(new triagens::arango::CapConstraint(iid, document, count, size));
+  std::unique_ptr<triagens::arango::Index> capConstraint(new triagens::arango::CapConstraint(iid, document, count, size, tolerance));
   triagens::arango::Index* idx = static_cast<triagens::arango::Index*>(capConstraint.get());
 
   // initializes the index with all existing documents
@@ -4036,7 +4552,15 @@ static int CapConstraintFromJson (TRI_document_collection_t* document,
     return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
   }
 
-  auto idx = CreateCapConstraintDocumentCollection(document, count, size, iid, nullptr);
+  // constraints stored by older versions have no tolerance
+  double tolerance = 0.0;
+  TRI_json_t const* val3 = TRI_LookupObjectJson(definition, "tolerance");
+
+  if (TRI_IsNumberJson(val3) && val3->_value._number > 0.0) {
+    tolerance = val3->_value._number;
+  }
+
+  auto idx = CreateCapConstraintDocumentCollection(document, count, size, tolerance, iid, nullptr);
 
   if (dst != nullptr) {
     *dst = idx;
@@ -4065,16 +4589,18 @@ triagens::arango::Index* TRI_EnsureCapConstraintDocumentCollection (TRI_document
                                                                     TRI_idx_iid_t iid,
                                                                     size_t count,
                                                                     int64_t size,
+                                                                    double tolerance,
                                                                     bool* created) {
   READ_LOCKER(document->_vocbase->_inventoryLock);
 
   TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
-  auto idx = CreateCapConstraintDocumentCollection(document, count, size, iid, created);
+  auto idx = CreateCapConstraintDocumentCollection(document, count, size, tolerance, iid, created);
 
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4089,6 +4615,47 @@ triagens::arango::Index* TRI_EnsureCapConstraintDocumentCollection (TRI_document
   return idx;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the oldest documents of a collection that exceeds the
+/// limits of its cap constraint within the constraint's tolerance
+///
+/// Each batch of removals is a transaction of its own, so inserts can
+/// proceed between the batches.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_EvictCapConstraintDocumentCollection (TRI_vocbase_t* vocbase,
+                                              TRI_document_collection_t* document) {
+  bool more = document->_capEvictionPending.exchange(false);
+  int res = TRI_ERROR_NO_ERROR;
+
+  while (more) {
+    triagens::arango::SingleCollectionWriteTransaction<UINT64_MAX> trx(new triagens::arango::StandaloneTransactionContext(), vocbase, document->_info._cid);
+    trx.addHint(TRI_TRANSACTION_HINT_LOCK_ENTIRELY, false);
+
+    res = trx.begin();
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      break;
+    }
+
+    auto capConstraint = document->capConstraint();
+    more = false;
+
+    if (capConstraint != nullptr) {
+      res = capConstraint->evict(trx.trxCollection());
+      more = (res == TRI_ERROR_NO_ERROR && capConstraint->exceeds(1.0));
+    }
+
+    res = trx.finish(res);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      break;
+    }
+  }
+
+  return res;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                         GEO INDEX
 // -----------------------------------------------------------------------------
@@ -4403,6 +4970,7 @@ triagens::arango::Index* TRI_EnsureGeoIndex1DocumentCollection (TRI_document_col
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4434,6 +5002,222 @@ triagens::arango::Index* TRI_EnsureGeoIndex2DocumentCollection (TRI_document_col
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      int res = TRI_SaveIndex(document, idx, true);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        idx = nullptr;
+      }
+    }
+  }
+
+  TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  return idx;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    GEO CELL INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a geo cell index to a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::Index* CreateGeoCellIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                      std::vector<std::string> const& attributes,
+                                                                      bool geoJson,
+                                                                      TRI_idx_iid_t iid,
+                                                                      bool* created) {
+  if (attributes.size() != 1 && attributes.size() != 2) {
+    TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+    LOG_TRACE("expecting either 'location' or 'latitude' and 'longitude'");
+    return nullptr;
+  }
+
+  if (attributes.size() == 2 && geoJson) {
+    TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+    return nullptr;
+  }
+
+  auto shaper = document->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  std::vector<TRI_shape_pid_t> paths;
+  std::vector<std::vector<triagens::basics::AttributeName>> fields;
+
+  for (auto const& attribute : attributes) {
+    TRI_shape_pid_t pid = shaper->findOrCreateAttributePathByName(attribute.c_str());
+
+    if (pid == 0) {
+      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+      return nullptr;
+    }
+
+    paths.emplace_back(pid);
+    fields.emplace_back(std::vector<triagens::basics::AttributeName>{ { attribute, false } });
+  }
+
+  // check, if we know the index
+  triagens::arango::Index* idx = TRI_LookupGeoCellIndexDocumentCollection(document, attributes, geoJson);
+
+  if (idx != nullptr) {
+    LOG_TRACE("geo-cell-index already created for '%s'", attributes[0].c_str());
+
+    if (created != nullptr) {
+      *created = false;
+    }
+
+    return idx;
+  }
+
+  if (iid == 0) {
+    iid = triagens::arango::Index::generateId();
+  }
+
+  // create a new index
+  std::unique_ptr<triagens::arango::GeoCellIndex> geoCellIndex(new triagens::arango::GeoCellIndex(iid, document, fields, paths, geoJson));
+  idx = static_cast<triagens::arango::Index*>(geoCellIndex.get());
+
+  // initializes the index with all existing documents
+  int res = FillIndex(document, idx);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  // and store index
+  try {
+    document->addIndex(idx);
+    geoCellIndex.release();
+  }
+  catch (...) {
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+
+    return nullptr;
+  }
+
+  if (created != nullptr) {
+    *created = true;
+  }
+
+  return idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restores an index
+////////////////////////////////////////////////////////////////////////////////
+
+static int GeoCellIndexFromJson (TRI_document_collection_t* document,
+                                 TRI_json_t const* definition,
+                                 TRI_idx_iid_t iid,
+                                 triagens::arango::Index** dst) {
+  if (dst != nullptr) {
+    *dst = nullptr;
+  }
+
+  // extract fields
+  size_t fieldCount;
+  TRI_json_t* fld = ExtractFields(definition, &fieldCount, iid);
+
+  if (fld == nullptr) {
+    return TRI_errno();
+  }
+
+  if (fieldCount != 1 && fieldCount != 2) {
+    LOG_ERROR("ignoring geo-cell-index %llu, 'fields' must be a list with 1 or 2 entries",
+              (unsigned long long) iid);
+
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  // extract geo json
+  bool geoJson = false;
+  TRI_json_t const* bv = TRI_LookupObjectJson(definition, "geoJson");
+
+  if (TRI_IsBooleanJson(bv)) {
+    geoJson = bv->_value._boolean;
+  }
+
+  std::vector<std::string> attributes;
+
+  for (size_t i = 0; i < fieldCount; ++i) {
+    auto field = static_cast<TRI_json_t const*>(TRI_AtVector(&fld->_value._objects, i));
+
+    attributes.emplace_back(std::string(field->_value._string.data, field->_value._string.length - 1));
+  }
+
+  auto idx = CreateGeoCellIndexDocumentCollection(document, attributes, geoJson, iid, nullptr);
+
+  if (dst != nullptr) {
+    *dst = idx;
+  }
+
+  return idx == nullptr ? TRI_errno() : TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a geo cell index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupGeoCellIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                   std::vector<std::string> const& attributes,
+                                                                   bool geoJson) {
+  auto shaper = document->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  std::vector<TRI_shape_pid_t> paths;
+
+  for (auto const& attribute : attributes) {
+    TRI_shape_pid_t pid = shaper->lookupAttributePathByName(attribute.c_str());
+
+    if (pid == 0) {
+      return nullptr;
+    }
+
+    paths.emplace_back(pid);
+  }
+
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_GEO_CELL_INDEX) {
+      auto geoCellIndex = static_cast<triagens::arango::GeoCellIndex*>(idx);
+
+      if (geoCellIndex->isSame(paths, geoJson)) {
+        return idx;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a geo cell index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureGeoCellIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                   TRI_idx_iid_t iid,
+                                                                   std::vector<std::string> const& attributes,
+                                                                   bool geoJson,
+                                                                   bool* created) {
+  READ_LOCKER(document->_vocbase->_inventoryLock);
+
+  TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  auto idx = CreateGeoCellIndexDocumentCollection(document, attributes, geoJson, iid, created);
+
+  if (idx != nullptr) {
+    if (created) {
+      triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4464,6 +5248,7 @@ static triagens::arango::Index* CreateHashIndexDocumentCollection (TRI_document_
                                                                    TRI_idx_iid_t iid,
                                                                    bool sparse,
                                                                    bool unique,
+                                                                   TRI_json_t const* filter,
                                                                    bool* created) {
   std::vector<TRI_shape_pid_t> paths;
   std::vector<std::vector<triagens::basics::AttributeName>> fields;
@@ -4491,7 +5276,7 @@ static triagens::arango::Index* CreateHashIndexDocumentCollection (TRI_document_
   // ...........................................................................
 
   int sparsity = sparse ? 1 : 0;
-  auto idx = LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX, sparsity, unique, false);
+  auto idx = LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX, sparsity, unique, filter, false);
 
   if (idx != nullptr) {
     LOG_TRACE("hash-index already created");
@@ -4510,7 +5295,7 @@ static triagens::arango::Index* CreateHashIndexDocumentCollection (TRI_document_
 
   // create the hash index. we'll provide it with the current number of documents
   // in the collection so the index can do a sensible memory preallocation
-  std::unique_ptr<triagens::arango::HashIndex> hashIndex(new triagens::arango::HashIndex(iid, document, fields, unique, sparse));
+  std::unique_ptr<triagens::arango::HashIndex> hashIndex(new triagens::arango::HashIndex(iid, document, fields, unique, sparse, filter));
   idx = static_cast<triagens::arango::Index*>(hashIndex.get());
 
   // initializes the index with all existing documents
@@ -4563,7 +5348,8 @@ static int HashIndexFromJson (TRI_document_collection_t* document,
 triagens::arango::Index* TRI_LookupHashIndexDocumentCollection (TRI_document_collection_t* document,
                                                                 std::vector<std::string> const& attributes,
                                                                 int sparsity,
-                                                                bool unique) {
+                                                                bool unique,
+                                                                TRI_json_t const* filter) {
   std::vector<TRI_shape_pid_t> paths;
   std::vector<std::vector<triagens::basics::AttributeName>> fields;
 
@@ -4579,7 +5365,7 @@ triagens::arango::Index* TRI_LookupHashIndexDocumentCollection (TRI_document_col
     return nullptr;
   }
 
-  return LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX, sparsity, unique, true);
+  return LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_HASH_INDEX, sparsity, unique, filter, true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4591,16 +5377,18 @@ triagens::arango::Index* TRI_EnsureHashIndexDocumentCollection (TRI_document_col
                                                                 std::vector<std::string> const& attributes,
                                                                 bool sparse,
                                                                 bool unique,
+                                                                TRI_json_t const* filter,
                                                                 bool* created) {
   READ_LOCKER(document->_vocbase->_inventoryLock);
 
   TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
-  auto idx = CreateHashIndexDocumentCollection(document, attributes, iid, sparse, unique, created);
+  auto idx = CreateHashIndexDocumentCollection(document, attributes, iid, sparse, unique, filter, created);
 
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4631,6 +5419,7 @@ static triagens::arango::Index* CreateSkiplistIndexDocumentCollection (TRI_docum
                                                                        TRI_idx_iid_t iid,
                                                                        bool sparse,
                                                                        bool unique,
+                                                                       TRI_json_t const* filter,
                                                                        bool* created) {
   std::vector<TRI_shape_pid_t> paths;
   std::vector<std::vector<triagens::basics::AttributeName>> fields;
@@ -4657,7 +5446,7 @@ static triagens::arango::Index* CreateSkiplistIndexDocumentCollection (TRI_docum
   // ...........................................................................
 
   int sparsity = sparse ? 1 : 0;
-  auto idx = LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX, sparsity, unique, false);
+  auto idx = LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX, sparsity, unique, filter, false);
 
   if (idx != nullptr) {
     LOG_TRACE("skiplist-index already created");
@@ -4674,7 +5463,7 @@ static triagens::arango::Index* CreateSkiplistIndexDocumentCollection (TRI_docum
   }
 
   // Create the skiplist index
-  std::unique_ptr<triagens::arango::SkiplistIndex> skiplistIndex(new triagens::arango::SkiplistIndex(iid, document, fields, unique, sparse));
+  std::unique_ptr<triagens::arango::SkiplistIndex> skiplistIndex(new triagens::arango::SkiplistIndex(iid, document, fields, unique, sparse, filter));
   idx = static_cast<triagens::arango::Index*>(skiplistIndex.get());
 
   // initializes the index with all existing documents
@@ -4727,7 +5516,8 @@ static int SkiplistIndexFromJson (TRI_document_collection_t* document,
 triagens::arango::Index* TRI_LookupSkiplistIndexDocumentCollection (TRI_document_collection_t* document,
                                                                     std::vector<std::string> const& attributes,
                                                                     int sparsity,
-                                                                    bool unique) {
+                                                                    bool unique,
+                                                                    TRI_json_t const* filter) {
   std::vector<TRI_shape_pid_t> paths;
   std::vector<std::vector<triagens::basics::AttributeName>> fields;
 
@@ -4743,7 +5533,7 @@ triagens::arango::Index* TRI_LookupSkiplistIndexDocumentCollection (TRI_document
     return nullptr;
   }
 
-  return LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX, sparsity, unique, true);
+  return LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_SKIPLIST_INDEX, sparsity, unique, filter, true);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4755,16 +5545,18 @@ triagens::arango::Index* TRI_EnsureSkiplistIndexDocumentCollection (TRI_document
                                                                     std::vector<std::string> const& attributes,
                                                                     bool sparse,
                                                                     bool unique,
+                                                                    TRI_json_t const* filter,
                                                                     bool* created) {
   READ_LOCKER(document->_vocbase->_inventoryLock);
 
   TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
-  auto idx = CreateSkiplistIndexDocumentCollection(document, attributes, iid, sparse, unique, created);
+  auto idx = CreateSkiplistIndexDocumentCollection(document, attributes, iid, sparse, unique, filter, created);
 
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4779,62 +5571,749 @@ triagens::arango::Index* TRI_EnsureSkiplistIndexDocumentCollection (TRI_document
 }
 
 // -----------------------------------------------------------------------------
-// --SECTION--                                                    FULLTEXT INDEX
+// --SECTION--                                              VERTEX-CENTRIC INDEX
 // -----------------------------------------------------------------------------
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
 
-static triagens::arango::Index* LookupFulltextIndexDocumentCollection (TRI_document_collection_t* document,
-                                                                       std::string const& attribute,
-                                                                       int minWordLength) {
-  for (auto const& idx : document->allIndexes()) {
-    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX) {
-      auto fulltextIndex = static_cast<triagens::arango::FulltextIndex*>(idx);
-      
-      if (fulltextIndex->isSame(attribute, minWordLength)) {
-        return idx;
-      }
-    }
-  }
-
-  return nullptr;
-}
-
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief adds a fulltext index to the collection
+/// @brief adds a vertex-centric index to the collection
+///
+/// the first attribute must be _from or _to, followed by at least one other
+/// attribute. unique and sparse must be false
 ////////////////////////////////////////////////////////////////////////////////
 
-static triagens::arango::Index* CreateFulltextIndexDocumentCollection (TRI_document_collection_t* document,
-                                                                       std::string const& attribute,
-                                                                       int minWordLength,
-                                                                       TRI_idx_iid_t iid,
-                                                                       bool* created) {
-  // ...........................................................................
-  // Attempt to find an existing index with the same attribute
-  // If a suitable index is found, return that one otherwise we need to create
-  // a new one.
-  // ...........................................................................
-
-  auto idx = LookupFulltextIndexDocumentCollection(document, attribute, minWordLength);
+static triagens::arango::Index* CreateVertexCentricIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                            std::vector<std::string> const& attributes,
+                                                                            TRI_idx_iid_t iid,
+                                                                            bool sparse,
+                                                                            bool unique,
+                                                                            TRI_json_t const* filter,
+                                                                            bool* created) {
+  if (created != nullptr) {
+    *created = false;
+  }
 
-  if (idx != nullptr) {
-    LOG_TRACE("fulltext-index already created");
+  if (document->_info._type != TRI_COL_TYPE_EDGE) {
+    TRI_set_errno(TRI_ERROR_ARANGO_COLLECTION_TYPE_INVALID);
 
-    if (created != nullptr) {
-      *created = false;
-    }
-    return idx;
-  }
-  
-  if (iid == 0) {
-    iid = triagens::arango::Index::generateId();
+    return nullptr;
   }
 
-  // Create the fulltext index
-  std::unique_ptr<triagens::arango::FulltextIndex> fulltextIndex(new triagens::arango::FulltextIndex(iid, document, attribute, minWordLength));
-  idx = static_cast<triagens::arango::Index*>(fulltextIndex.get());
+  if (attributes.size() < 2 ||
+      (attributes[0] != TRI_VOC_ATTRIBUTE_FROM && attributes[0] != TRI_VOC_ATTRIBUTE_TO) ||
+      sparse ||
+      unique ||
+      filter != nullptr) {
+    TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+
+    return nullptr;
+  }
+
+  std::vector<TRI_shape_pid_t> paths;
+  std::vector<std::vector<triagens::basics::AttributeName>> fields;
+
+  int res = PidNamesByAttributeNames(attributes,
+                                     document->getShaper(),  // ONLY IN INDEX, PROTECTED by RUNTIME
+                                     paths,
+                                     fields,
+                                     false,
+                                     true);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return nullptr;
+  }
+
+  for (size_t i = 1; i < fields.size(); ++i) {
+    if (TRI_AttributeNamesHaveExpansion(fields[i]) ||
+        fields[i][0].name == TRI_VOC_ATTRIBUTE_FROM ||
+        fields[i][0].name == TRI_VOC_ATTRIBUTE_TO) {
+      // array expansion is not supported, and a vertex can only be indexed
+      // in front
+      TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+
+      return nullptr;
+    }
+  }
+
+  // ...........................................................................
+  // Attempt to find an existing index which matches the attributes above.
+  // If a suitable index is found, return that one otherwise we need to create
+  // a new one.
+  // ...........................................................................
+
+  auto idx = LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX, 0, false, nullptr, false);
+
+  if (idx != nullptr) {
+    LOG_TRACE("vertex-centric-index already created");
+
+    return idx;
+  }
+
+  if (iid == 0) {
+    iid = triagens::arango::Index::generateId();
+  }
+
+  // Create the vertex-centric index
+  std::unique_ptr<triagens::arango::VertexCentricIndex> vertexCentricIndex(new triagens::arango::VertexCentricIndex(iid, document, fields));
+  idx = static_cast<triagens::arango::Index*>(vertexCentricIndex.get());
+
+  // initializes the index with all existing documents
+  res = FillIndex(document, idx);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  // store index and return
+  try {
+    document->addIndex(idx);
+    vertexCentricIndex.release();
+  }
+  catch (...) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  if (created != nullptr) {
+    *created = true;
+  }
+
+  return idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restores an index
+////////////////////////////////////////////////////////////////////////////////
+
+static int VertexCentricIndexFromJson (TRI_document_collection_t* document,
+                                       TRI_json_t const* definition,
+                                       TRI_idx_iid_t iid,
+                                       triagens::arango::Index** dst) {
+  return PathBasedIndexFromJson(document, definition, iid, CreateVertexCentricIndexDocumentCollection, dst);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a vertex-centric index
+/// the index lock must be held when calling this function
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupVertexCentricIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                         std::vector<std::string> const& attributes) {
+  std::vector<TRI_shape_pid_t> paths;
+  std::vector<std::vector<triagens::basics::AttributeName>> fields;
+
+  // the order of the attributes matters
+  int res = PidNamesByAttributeNames(attributes,
+                                     document->getShaper(),  // ONLY IN INDEX, PROTECTED by RUNTIME
+                                     paths,
+                                     fields,
+                                     false,
+                                     false);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return nullptr;
+  }
+
+  return LookupPathIndexDocumentCollection(document, fields, triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX, 0, false, nullptr, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a vertex-centric index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureVertexCentricIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                         TRI_idx_iid_t iid,
+                                                                         std::vector<std::string> const& attributes,
+                                                                         bool* created) {
+  READ_LOCKER(document->_vocbase->_inventoryLock);
+
+  TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  auto idx = CreateVertexCentricIndexDocumentCollection(document, attributes, iid, false, false, nullptr, created);
+
+  if (idx != nullptr) {
+    if (created) {
+      triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      int res = TRI_SaveIndex(document, idx, true);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        idx = nullptr;
+      }
+    }
+  }
+
+  TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  return idx;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    FULLTEXT INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+static triagens::arango::Index* LookupFulltextIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                       std::string const& attribute,
+                                                                       int minWordLength) {
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_FULLTEXT_INDEX) {
+      auto fulltextIndex = static_cast<triagens::arango::FulltextIndex*>(idx);
+      
+      if (fulltextIndex->isSame(attribute, minWordLength)) {
+        return idx;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a fulltext index to the collection
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::Index* CreateFulltextIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                       std::string const& attribute,
+                                                                       int minWordLength,
+                                                                       TRI_idx_iid_t iid,
+                                                                       bool* created) {
+  // ...........................................................................
+  // Attempt to find an existing index with the same attribute
+  // If a suitable index is found, return that one otherwise we need to create
+  // a new one.
+  // ...........................................................................
+
+  auto idx = LookupFulltextIndexDocumentCollection(document, attribute, minWordLength);
+
+  if (idx != nullptr) {
+    LOG_TRACE("fulltext-index already created");
+
+    if (created != nullptr) {
+      *created = false;
+    }
+    return idx;
+  }
+  
+  if (iid == 0) {
+    iid = triagens::arango::Index::generateId();
+  }
+
+  // Create the fulltext index
+  std::unique_ptr<triagens::arango::FulltextIndex> fulltextIndex(new triagens::arango::FulltextIndex(iid, document, attribute, minWordLength));
+  idx = static_cast<triagens::arango::Index*>(fulltextIndex.get());
+
+  // initializes the index with all existing documents
+  int res = FillIndex(document, idx);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  // store index and return
+  try {
+    document->addIndex(idx);
+    fulltextIndex.release();
+  }
+  catch (...) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  if (created != nullptr) {
+    *created = true;
+  }
+
+  return idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restores an index
+////////////////////////////////////////////////////////////////////////////////
+
+static int FulltextIndexFromJson (TRI_document_collection_t* document,
+                                  TRI_json_t const* definition,
+                                  TRI_idx_iid_t iid,
+                                  triagens::arango::Index** dst) {
+  if (dst != nullptr) {
+    *dst = nullptr;
+  }
+
+  // extract fields
+  size_t fieldCount;
+  TRI_json_t* fld = ExtractFields(definition, &fieldCount, iid);
+
+  if (fld == nullptr) {
+    return TRI_errno();
+  }
+
+  // extract the list of fields
+  if (fieldCount != 1) {
+    LOG_ERROR("ignoring index %llu, has an invalid number of attributes", (unsigned long long) iid);
+
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&fld->_value._objects, 0));
+
+  if (! TRI_IsStringJson(value)) {
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  std::string const attribute(value->_value._string.data, value->_value._string.length - 1);
+
+  // 2013-01-17: deactivated substring indexing
+  // indexSubstrings = TRI_LookupObjectJson(definition, "indexSubstrings");
+
+  int minWordLengthValue = TRI_FULLTEXT_MIN_WORD_LENGTH_DEFAULT;
+  TRI_json_t const* minWordLength = TRI_LookupObjectJson(definition, "minLength");
+
+  if (minWordLength != nullptr && minWordLength->_type == TRI_JSON_NUMBER) {
+    minWordLengthValue = (int) minWordLength->_value._number;
+  }
+
+  // create the index
+  auto idx = LookupFulltextIndexDocumentCollection(document, attribute, minWordLengthValue);
+
+  if (idx == nullptr) {
+    bool created;
+    idx = CreateFulltextIndexDocumentCollection(document, attribute, minWordLengthValue, iid, &created);
+  }
+
+  if (dst != nullptr) {
+    *dst = idx;
+  }
+
+  if (idx == nullptr) {
+    LOG_ERROR("cannot create fulltext index %llu", (unsigned long long) iid);
+    return TRI_errno();
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a fulltext index (unique or non-unique)
+/// the index lock must be held when calling this function
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupFulltextIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                    std::string const& attribute,
+                                                                    int minWordLength) {
+  return LookupFulltextIndexDocumentCollection(document, attribute, minWordLength);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a fulltext index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureFulltextIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                    TRI_idx_iid_t iid,
+                                                                    std::string const& attribute,
+                                                                    int minWordLength,
+                                                                    bool* created) {
+  READ_LOCKER(document->_vocbase->_inventoryLock);
+
+  TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  auto idx = CreateFulltextIndexDocumentCollection(document, attribute, minWordLength, iid, created);
+
+  if (idx != nullptr) {
+    if (created) {
+      triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      int res = TRI_SaveIndex(document, idx, true);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        idx = nullptr;
+      }
+    }
+  }
+
+  TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  return idx;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                         TTL INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a ttl index to a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::Index* CreateTtlIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                  std::string const& attribute,
+                                                                  double expireAfter,
+                                                                  TRI_idx_iid_t iid,
+                                                                  bool* created) {
+  if (expireAfter < 0.0 || expireAfter != expireAfter) {
+    TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+    return nullptr;
+  }
+
+  auto shaper = document->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  TRI_shape_pid_t pid = shaper->findOrCreateAttributePathByName(attribute.c_str());
+
+  if (pid == 0) {
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
+  // check, if we know the index
+  triagens::arango::Index* idx = TRI_LookupTtlIndexDocumentCollection(document, attribute, expireAfter);
+
+  if (idx != nullptr) {
+    LOG_TRACE("ttl-index already created for '%s'", attribute.c_str());
+
+    if (created != nullptr) {
+      *created = false;
+    }
+
+    return idx;
+  }
+
+  if (iid == 0) {
+    iid = triagens::arango::Index::generateId();
+  }
+
+  std::vector<std::vector<triagens::basics::AttributeName>> fields;
+  fields.emplace_back(std::vector<triagens::basics::AttributeName>{ { attribute, false } });
+
+  // create a new index
+  std::unique_ptr<triagens::arango::TtlIndex> ttlIndex(new triagens::arango::TtlIndex(iid, document, fields, pid, expireAfter));
+  idx = static_cast<triagens::arango::Index*>(ttlIndex.get());
+
+  // initializes the index with all existing documents
+  int res = FillIndex(document, idx);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    TRI_set_errno(res);
+
+    return nullptr;
+  }
+
+  // and store index
+  try {
+    document->addIndex(idx);
+    ttlIndex.release();
+  }
+  catch (...) {
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+
+    return nullptr;
+  }
+
+  if (created != nullptr) {
+    *created = true;
+  }
+
+  return idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restores an index
+////////////////////////////////////////////////////////////////////////////////
+
+static int TtlIndexFromJson (TRI_document_collection_t* document,
+                             TRI_json_t const* definition,
+                             TRI_idx_iid_t iid,
+                             triagens::arango::Index** dst) {
+  if (dst != nullptr) {
+    *dst = nullptr;
+  }
+
+  // extract fields
+  size_t fieldCount;
+  TRI_json_t* fld = ExtractFields(definition, &fieldCount, iid);
+
+  if (fld == nullptr) {
+    return TRI_errno();
+  }
+
+  if (fieldCount != 1) {
+    LOG_ERROR("ignoring ttl-index %llu, 'fields' must be a list with 1 entry",
+              (unsigned long long) iid);
+
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  // extract expireAfter
+  TRI_json_t const* value = TRI_LookupObjectJson(definition, "expireAfter");
+
+  if (! TRI_IsNumberJson(value)) {
+    LOG_ERROR("ignoring ttl-index %llu, 'expireAfter' missing",
+              (unsigned long long) iid);
+
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  }
+
+  auto field = static_cast<TRI_json_t const*>(TRI_AtVector(&fld->_value._objects, 0));
+  std::string const attribute(field->_value._string.data, field->_value._string.length - 1);
+
+  auto idx = CreateTtlIndexDocumentCollection(document, attribute, value->_value._number, iid, nullptr);
+
+  if (dst != nullptr) {
+    *dst = idx;
+  }
+
+  return idx == nullptr ? TRI_errno() : TRI_ERROR_NO_ERROR;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a ttl index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupTtlIndexDocumentCollection (TRI_document_collection_t* document,
+                                                               std::string const& attribute,
+                                                               double expireAfter) {
+  auto shaper = document->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  TRI_shape_pid_t pid = shaper->lookupAttributePathByName(attribute.c_str());
+
+  if (pid == 0) {
+    return nullptr;
+  }
+
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX) {
+      auto ttlIndex = static_cast<triagens::arango::TtlIndex*>(idx);
+
+      if (ttlIndex->isSame(pid, expireAfter)) {
+        return idx;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a ttl index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureTtlIndexDocumentCollection (TRI_document_collection_t* document,
+                                                               TRI_idx_iid_t iid,
+                                                               std::string const& attribute,
+                                                               double expireAfter,
+                                                               bool* created) {
+  READ_LOCKER(document->_vocbase->_inventoryLock);
+
+  TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  auto idx = CreateTtlIndexDocumentCollection(document, attribute, expireAfter, iid, created);
+
+  if (idx != nullptr) {
+    if (created) {
+      triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      int res = TRI_SaveIndex(document, idx, true);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        idx = nullptr;
+      }
+    }
+  }
+
+  TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  return idx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the expired documents of a collection with ttl indexes
+///
+/// Documents are removed in transactions of at most ExpiryBatchSize
+/// documents each, and at most maxBatches transactions are run, which
+/// limits the rate of removals. Inserts can proceed between the batches.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ExpireDocumentsDocumentCollection (TRI_vocbase_t* vocbase,
+                                           TRI_document_collection_t* document,
+                                           size_t maxBatches) {
+  static size_t const ExpiryBatchSize = 1000;
+
+  double const now = TRI_microtime();
+
+  // check for expired documents without blocking writers
+  bool found = false;
+
+  TRI_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX &&
+        static_cast<triagens::arango::TtlIndex*>(idx)->hasExpired(now)) {
+      found = true;
+      break;
+    }
+  }
+
+  TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  for (size_t i = 0; found && i < maxBatches; ++i) {
+    triagens::arango::SingleCollectionWriteTransaction<UINT64_MAX> trx(new triagens::arango::StandaloneTransactionContext(), vocbase, document->_info._cid);
+    trx.addHint(TRI_TRANSACTION_HINT_LOCK_ENTIRELY, false);
+
+    res = trx.begin();
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      break;
+    }
+
+    std::vector<TRI_doc_mptr_t const*> expired;
+
+    for (auto const& idx : document->allIndexes()) {
+      if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_TTL_INDEX) {
+        static_cast<triagens::arango::TtlIndex*>(idx)->expired(now, ExpiryBatchSize, expired);
+      }
+    }
+
+    // a document may have expired in several indexes
+    std::sort(expired.begin(), expired.end());
+    expired.erase(std::unique(expired.begin(), expired.end()), expired.end());
+
+    for (auto const& doc : expired) {
+      res = TRI_DeleteDocumentDocumentCollection(trx.trxCollection(), nullptr, const_cast<TRI_doc_mptr_t*>(doc));
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        break;
+      }
+    }
+
+    res = trx.finish(res);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      break;
+    }
+
+    document->_numberExpired += static_cast<uint64_t>(expired.size());
+
+    // a batch that is not full has removed all expired documents
+    found = (expired.size() >= ExpiryBatchSize);
+  }
+
+  return res;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   AGGREGATE INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an aggregate index to a collection
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::arango::Index* CreateAggregateIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                        std::string const& name,
+                                                                        std::vector<std::string> const& attributes,
+                                                                        std::vector<triagens::arango::AggregateDefinition> aggregates,
+                                                                        TRI_idx_iid_t iid,
+                                                                        bool* created) {
+  if (name.empty() || attributes.empty()) {
+    TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+    return nullptr;
+  }
+
+  auto shaper = document->getShaper();  // ONLY IN INDEX, PROTECTED by RUNTIME
+
+  std::vector<TRI_shape_pid_t> paths;
+  std::vector<std::vector<triagens::basics::AttributeName>> fields;
+
+  for (auto const& attribute : attributes) {
+    TRI_shape_pid_t pid = shaper->findOrCreateAttributePathByName(attribute.c_str());
+
+    if (pid == 0) {
+      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+      return nullptr;
+    }
+
+    paths.emplace_back(pid);
+    fields.emplace_back(std::vector<triagens::basics::AttributeName>{ { attribute, false } });
+  }
+
+  for (auto& aggregate : aggregates) {
+    if (aggregate._name.empty() ||
+        (aggregate._function != triagens::arango::AggregateDefinition::AGGREGATE_COUNT && aggregate._attribute.empty())) {
+      TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+      return nullptr;
+    }
+
+    if (aggregate._function == triagens::arango::AggregateDefinition::AGGREGATE_COUNT) {
+      aggregate._attribute.clear();
+      aggregate._path = 0;
+      continue;
+    }
+
+    aggregate._path = shaper->findOrCreateAttributePathByName(aggregate._attribute.c_str());
+
+    if (aggregate._path == 0) {
+      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+      return nullptr;
+    }
+  }
+
+  // check, if we know the index
+  auto idx = TRI_LookupAggregateIndexDocumentCollection(document, name);
+
+  if (idx != nullptr) {
+    if (! static_cast<triagens::arango::AggregateIndex*>(idx)->isSame(paths, aggregates)) {
+      // another view with the same name
+      TRI_set_errno(TRI_ERROR_ARANGO_DUPLICATE_NAME);
+      return nullptr;
+    }
+
+    LOG_TRACE("aggregate-index '%s' already created", name.c_str());
+
+    if (created != nullptr) {
+      *created = false;
+    }
+
+    return idx;
+  }
+
+  if (iid == 0) {
+    iid = triagens::arango::Index::generateId();
+  }
+
+  // create a new index
+  std::unique_ptr<triagens::arango::AggregateIndex> aggregateIndex(new triagens::arango::AggregateIndex(iid, document, fields, paths, name, aggregates));
+  idx = static_cast<triagens::arango::Index*>(aggregateIndex.get());
 
   // initializes the index with all existing documents
   int res = FillIndex(document, idx);
@@ -4845,13 +6324,13 @@ static triagens::arango::Index* CreateFulltextIndexDocumentCollection (TRI_docum
     return nullptr;
   }
 
-  // store index and return
+  // and store index
   try {
     document->addIndex(idx);
-    fulltextIndex.release();
+    aggregateIndex.release();
   }
   catch (...) {
-    TRI_set_errno(res);
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
 
     return nullptr;
   }
@@ -4867,10 +6346,10 @@ static triagens::arango::Index* CreateFulltextIndexDocumentCollection (TRI_docum
 /// @brief restores an index
 ////////////////////////////////////////////////////////////////////////////////
 
-static int FulltextIndexFromJson (TRI_document_collection_t* document,
-                                  TRI_json_t const* definition,
-                                  TRI_idx_iid_t iid,
-                                  triagens::arango::Index** dst) {
+static int AggregateIndexFromJson (TRI_document_collection_t* document,
+                                   TRI_json_t const* definition,
+                                   TRI_idx_iid_t iid,
+                                   triagens::arango::Index** dst) {
   if (dst != nullptr) {
     *dst = nullptr;
   }
@@ -4883,49 +6362,72 @@ static int FulltextIndexFromJson (TRI_document_collection_t* document,
     return TRI_errno();
   }
 
-  // extract the list of fields
-  if (fieldCount != 1) {
-    LOG_ERROR("ignoring index %llu, has an invalid number of attributes", (unsigned long long) iid);
+  std::vector<std::string> attributes;
 
-    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+  for (size_t i = 0; i < fieldCount; ++i) {
+    auto field = static_cast<TRI_json_t const*>(TRI_AtVector(&fld->_value._objects, i));
+    attributes.emplace_back(field->_value._string.data, field->_value._string.length - 1);
   }
 
-  auto value = static_cast<TRI_json_t const*>(TRI_AtVector(&fld->_value._objects, 0));
+  // extract name
+  TRI_json_t const* value = TRI_LookupObjectJson(definition, "name");
 
   if (! TRI_IsStringJson(value)) {
+    LOG_ERROR("ignoring aggregate-index %llu, 'name' missing",
+              (unsigned long long) iid);
+
     return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
   }
 
-  std::string const attribute(value->_value._string.data, value->_value._string.length - 1);
+  std::string const name(value->_value._string.data, value->_value._string.length - 1);
 
-  // 2013-01-17: deactivated substring indexing
-  // indexSubstrings = TRI_LookupObjectJson(definition, "indexSubstrings");
+  // extract aggregates
+  value = TRI_LookupObjectJson(definition, "aggregates");
 
-  int minWordLengthValue = TRI_FULLTEXT_MIN_WORD_LENGTH_DEFAULT;
-  TRI_json_t const* minWordLength = TRI_LookupObjectJson(definition, "minLength");
+  if (! TRI_IsArrayJson(value)) {
+    LOG_ERROR("ignoring aggregate-index %llu, 'aggregates' missing",
+              (unsigned long long) iid);
 
-  if (minWordLength != nullptr && minWordLength->_type == TRI_JSON_NUMBER) {
-    minWordLengthValue = (int) minWordLength->_value._number;
+    return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
   }
 
-  // create the index
-  auto idx = LookupFulltextIndexDocumentCollection(document, attribute, minWordLengthValue);
+  std::vector<triagens::arango::AggregateDefinition> aggregates;
+  size_t const n = TRI_LengthArrayJson(value);
 
-  if (idx == nullptr) {
-    bool created;
-    idx = CreateFulltextIndexDocumentCollection(document, attribute, minWordLengthValue, iid, &created);
+  for (size_t i = 0; i < n; ++i) {
+    auto entry = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i));
+    auto aggregateName = TRI_LookupObjectJson(entry, "name");
+    auto function = TRI_LookupObjectJson(entry, "function");
+    auto attribute = TRI_LookupObjectJson(entry, "attribute");
+
+    triagens::arango::AggregateDefinition aggregate;
+
+    if (! TRI_IsStringJson(aggregateName) ||
+        ! TRI_IsStringJson(function) ||
+        ! triagens::arango::AggregateDefinition::function(std::string(function->_value._string.data, function->_value._string.length - 1), aggregate._function)) {
+      LOG_ERROR("ignoring aggregate-index %llu, invalid entry in 'aggregates'",
+                (unsigned long long) iid);
+
+      return TRI_set_errno(TRI_ERROR_BAD_PARAMETER);
+    }
+
+    aggregate._name = std::string(aggregateName->_value._string.data, aggregateName->_value._string.length - 1);
+
+    if (TRI_IsStringJson(attribute)) {
+      aggregate._attribute = std::string(attribute->_value._string.data, attribute->_value._string.length - 1);
+    }
+
+    aggregate._path = 0;
+    aggregates.emplace_back(aggregate);
   }
 
+  auto idx = CreateAggregateIndexDocumentCollection(document, name, attributes, aggregates, iid, nullptr);
+
   if (dst != nullptr) {
     *dst = idx;
   }
 
-  if (idx == nullptr) {
-    LOG_ERROR("cannot create fulltext index %llu", (unsigned long long) iid);
-    return TRI_errno();
-  }
-
-  return TRI_ERROR_NO_ERROR;
+  return idx == nullptr ? TRI_errno() : TRI_ERROR_NO_ERROR;
 }
 
 // -----------------------------------------------------------------------------
@@ -4933,34 +6435,41 @@ static int FulltextIndexFromJson (TRI_document_collection_t* document,
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief finds a fulltext index (unique or non-unique)
-/// the index lock must be held when calling this function
+/// @brief finds an aggregate index by the name of its view
 ////////////////////////////////////////////////////////////////////////////////
 
-triagens::arango::Index* TRI_LookupFulltextIndexDocumentCollection (TRI_document_collection_t* document,
-                                                                    std::string const& attribute,
-                                                                    int minWordLength) {
-  return LookupFulltextIndexDocumentCollection(document, attribute, minWordLength);
+triagens::arango::Index* TRI_LookupAggregateIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                     std::string const& name) {
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() == triagens::arango::Index::TRI_IDX_TYPE_AGGREGATE_INDEX &&
+        static_cast<triagens::arango::AggregateIndex*>(idx)->name() == name) {
+      return idx;
+    }
+  }
+
+  return nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief ensures that a fulltext index exists
+/// @brief ensures that an aggregate index exists
 ////////////////////////////////////////////////////////////////////////////////
 
-triagens::arango::Index* TRI_EnsureFulltextIndexDocumentCollection (TRI_document_collection_t* document,
-                                                                    TRI_idx_iid_t iid,
-                                                                    std::string const& attribute,
-                                                                    int minWordLength,
-                                                                    bool* created) {
+triagens::arango::Index* TRI_EnsureAggregateIndexDocumentCollection (TRI_document_collection_t* document,
+                                                                     TRI_idx_iid_t iid,
+                                                                     std::string const& name,
+                                                                     std::vector<std::string> const& attributes,
+                                                                     std::vector<triagens::arango::AggregateDefinition> const& aggregates,
+                                                                     bool* created) {
   READ_LOCKER(document->_vocbase->_inventoryLock);
 
   TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(document);
 
-  auto idx = CreateFulltextIndexDocumentCollection(document, attribute, minWordLength, iid, created);
+  auto idx = CreateAggregateIndexDocumentCollection(document, name, attributes, aggregates, iid, created);
 
   if (idx != nullptr) {
     if (created) {
       triagens::aql::QueryCache::instance()->invalidate(document->_vocbase, document->_info._name);
+      triagens::aql::QueryPlanCache::instance()->invalidate(document->_vocbase, document->_info._name);
       int res = TRI_SaveIndex(document, idx, true);
 
       if (res != TRI_ERROR_NO_ERROR) {
@@ -4982,12 +6491,192 @@ triagens::arango::Index* TRI_EnsureFulltextIndexDocumentCollection (TRI_document
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the attribute paths of the fields of a hash or skiplist
+/// index, or false if a field expands an array
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ExamplePaths (triagens::arango::PathBasedIndex const* idx,
+                          std::vector<TRI_shape_pid_t>& pids) {
+  pids.clear();
+
+  for (auto const& path : idx->paths()) {
+    if (path.size() != 1 || path[0].second) {
+      return false;
+    }
+    pids.emplace_back(path[0].first);
+  }
+
+  return ! pids.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the candidates for examples using the hash or skiplist index
+/// that restricts the examples best. returns false if there is no such
+/// index. the candidates are a superset of the matching documents
+///
+/// a hash index needs values for all its fields, a skiplist index for a
+/// prefix of its fields. a sparse index does not contain documents with
+/// null values, so it cannot be used for examples that ask for null
+////////////////////////////////////////////////////////////////////////////////
+
+static bool SelectByExampleIndex (TRI_document_collection_t* document,
+                                  ExampleMatcher const& matcher,
+                                  std::vector<TRI_doc_mptr_t const*>& candidates) {
+  Index const* best = nullptr;
+  std::vector<std::vector<TRI_shaped_json_t const*>> bestValues;
+  size_t bestScore = 0;
+
+  std::vector<TRI_shape_pid_t> pids;
+
+  for (auto const& idx : document->allIndexes()) {
+    auto const type = idx->type();
+
+    if (type != Index::TRI_IDX_TYPE_HASH_INDEX &&
+        type != Index::TRI_IDX_TYPE_SKIPLIST_INDEX) {
+      continue;
+    }
+
+    if (! ExamplePaths(static_cast<PathBasedIndex const*>(idx), pids)) {
+      continue;
+    }
+
+    std::vector<std::vector<TRI_shaped_json_t const*>> values;
+
+    if (! matcher.requiredValues(pids, values)) {
+      continue;
+    }
+
+    bool usable = true;
+    size_t score = 0;
+
+    for (auto const& it : values) {
+      if (type == Index::TRI_IDX_TYPE_HASH_INDEX && it.size() != pids.size()) {
+        usable = false;
+        break;
+      }
+
+      if (idx->sparse()) {
+        for (auto const& value : it) {
+          if (value->_sid == BasicShapes::TRI_SHAPE_SID_NULL) {
+            usable = false;
+            break;
+          }
+        }
+      }
+
+      score += it.size();
+    }
+
+    if (! usable) {
+      continue;
+    }
+
+    // with equal restrictions, a hash lookup is cheaper than a skiplist scan
+    if (score > bestScore ||
+        (score == bestScore && type == Index::TRI_IDX_TYPE_HASH_INDEX)) {
+      best = idx;
+      bestValues = std::move(values);
+      bestScore = score;
+    }
+  }
+
+  if (best == nullptr) {
+    return false;
+  }
+
+  auto shaper = document->getShaper();  // PROTECTED by trx from above
+
+  for (auto const& it : bestValues) {
+    if (best->type() == Index::TRI_IDX_TYPE_HASH_INDEX) {
+      TRI_hash_index_search_value_t searchValue;
+      searchValue.reserve(it.size());
+
+      for (size_t i = 0; i < it.size(); ++i) {
+        searchValue._values[i]._sid = it[i]->_sid;
+
+        int res = TRI_CopyToBlob(TRI_UNKNOWN_MEM_ZONE, &searchValue._values[i]._data, &it[i]->_data);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          THROW_ARANGO_EXCEPTION(res);
+        }
+      }
+
+      std::vector<TRI_doc_mptr_t*> found;
+      int res = static_cast<HashIndex const*>(best)->lookup(&searchValue, found);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        THROW_ARANGO_EXCEPTION(res);
+      }
+
+      candidates.insert(candidates.end(), found.begin(), found.end());
+    }
+    else {
+      std::unique_ptr<TRI_json_t> parameters(TRI_CreateArrayJson(TRI_UNKNOWN_MEM_ZONE, it.size()));
+
+      if (parameters == nullptr) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+      }
+
+      for (auto const& value : it) {
+        TRI_json_t* json = TRI_JsonShapedJson(shaper, value);
+
+        if (json == nullptr) {
+          THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+        }
+
+        TRI_PushBack3ArrayJson(TRI_UNKNOWN_MEM_ZONE, parameters.get(), json);
+      }
+
+      // the operator takes over the parameters
+      std::unique_ptr<TRI_index_operator_t> op(TRI_CreateIndexOperator(TRI_EQ_INDEX_OPERATOR,
+                                                                      nullptr,
+                                                                      nullptr,
+                                                                      parameters.get(),
+                                                                      shaper,
+                                                                      it.size()));
+
+      if (op == nullptr) {
+        THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
+      }
+      parameters.release();
+
+      std::unique_ptr<SkiplistIterator> iterator(static_cast<SkiplistIndex const*>(best)->lookup(op.get(), false));
+
+      if (iterator == nullptr) {
+        int res = TRI_errno();
+
+        if (res == TRI_RESULT_ELEMENT_NOT_FOUND) {
+          continue;
+        }
+        THROW_ARANGO_EXCEPTION(res);
+      }
+
+      while (true) {
+        TRI_index_element_t* element = iterator->next();
+
+        if (element == nullptr) {
+          break;
+        }
+
+        candidates.emplace_back(element->document());
+      }
+    }
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief executes a select-by-example query
+///
+/// the candidates are taken from the primary index if the examples contain
+/// document keys, and from the best hash or skiplist index otherwise. only
+/// if no index restricts the examples, all documents are checked
 ////////////////////////////////////////////////////////////////////////////////
 
 std::vector<TRI_doc_mptr_copy_t> TRI_SelectByExample (
@@ -5000,6 +6689,40 @@ std::vector<TRI_doc_mptr_copy_t> TRI_SelectByExample (
   // use filtered to hold copies of the master pointer
   std::vector<TRI_doc_mptr_copy_t> filtered;
 
+  std::vector<TRI_doc_mptr_t const*> candidates;
+  std::vector<std::string> keys;
+  bool indexed = false;
+
+  if (matcher.requiredKeys(keys)) {
+    auto primaryIndex = document->primaryIndex();
+
+    for (auto const& key : keys) {
+      TRI_doc_mptr_t const* mptr = primaryIndex->lookupKey(key.c_str());
+
+      if (mptr != nullptr) {
+        candidates.emplace_back(mptr);
+      }
+    }
+    indexed = true;
+  }
+  else {
+    indexed = SelectByExampleIndex(document, matcher, candidates);
+  }
+
+  if (indexed) {
+    // overlapping examples find the same documents more than once
+    std::unordered_set<TRI_doc_mptr_t const*> seen;
+
+    for (auto const& mptr : candidates) {
+      if (matcher.matches(0, mptr) &&
+          (candidates.size() == 1 || seen.emplace(mptr).second)) {
+        filtered.emplace_back(*mptr);
+      }
+    }
+
+    return filtered;
+  }
+
   auto work = [&] (TRI_doc_mptr_t const* ptr) -> void {
     if (matcher.matches(0, ptr)) {
       filtered.emplace_back(*ptr);
@@ -5340,6 +7063,150 @@ int TRI_InsertShapedJsonDocumentCollection (TRI_transaction_collection_t* trxCol
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert several shaped-json documents (or edges)
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_InsertShapedJsonDocumentsCollection (TRI_transaction_collection_t* trxCollection,
+                                             std::vector<TRI_doc_insert_t>& documents,
+                                             bool lock,
+                                             bool forceSync) {
+  TRI_document_collection_t* document = trxCollection->_collection->_collection;
+  size_t const n = documents.size();
+
+  std::vector<std::unique_ptr<triagens::wal::Marker>> markers(n);
+  std::vector<TRI_voc_rid_t> rids(n, 0);
+  std::vector<uint64_t> hashes(n, 0);
+
+  // create the markers outside the lock
+  for (size_t i = 0; i < n; ++i) {
+    auto& doc = documents[i];
+    doc._mptr.setDataPtr(nullptr);  // PROTECTED by trx in trxCollection
+    doc._errorCode = TRI_ERROR_NO_ERROR;
+
+    TRI_voc_rid_t const rid = GetRevisionId(0);
+    std::string keyString;
+
+    if (doc._key == nullptr) {
+      keyString.assign(document->_keyGenerator->generate(static_cast<TRI_voc_tick_t>(rid)));
+
+      if (keyString.empty()) {
+        doc._errorCode = TRI_ERROR_ARANGO_OUT_OF_KEYS;
+        continue;
+      }
+    }
+    else {
+      int res = document->_keyGenerator->validate(doc._key, false);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        doc._errorCode = res;
+        continue;
+      }
+
+      keyString = doc._key;
+    }
+
+    triagens::wal::Marker* marker = nullptr;
+    int res = CreateMarkerNoLegend(marker, document, rid, trxCollection, keyString, doc._shaped, doc._edge);
+    markers[i].reset(marker);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      doc._errorCode = res;
+      continue;
+    }
+
+    rids[i] = rid;
+    hashes[i] = document->primaryIndex()->calculateHash(keyString.c_str(), keyString.size());
+  }
+
+  TRI_voc_tick_t markerTick = 0;
+  {
+    triagens::arango::CollectionWriteLocker collectionLocker(document, lock);
+
+    // operations must be destroyed while the lock is still held
+    std::vector<std::unique_ptr<triagens::wal::DocumentOperation>> operations;
+    operations.reserve(n);
+
+    std::vector<triagens::wal::DocumentOperation*> indexed;
+    std::vector<TRI_doc_mptr_t*> headers;
+    std::vector<size_t> positions;
+
+    // insert into indexes
+    for (size_t i = 0; i < n; ++i) {
+      if (markers[i] == nullptr || documents[i]._errorCode != TRI_ERROR_NO_ERROR) {
+        continue;
+      }
+
+      auto operation = new triagens::wal::DocumentOperation(markers[i].release(), true, trxCollection, TRI_VOC_DOCUMENT_OPERATION_INSERT, rids[i]);
+      operations.emplace_back(operation);
+
+      TRI_doc_mptr_t* header = operation->header = document->_headersPtr->request(operation->marker->size());  // PROTECTED by trx in trxCollection
+
+      if (header == nullptr) {
+        documents[i]._errorCode = TRI_ERROR_OUT_OF_MEMORY;
+        continue;
+      }
+
+      header->_rid  = rids[i];
+      header->setDataPtr(operation->marker->mem());  // PROTECTED by trx in trxCollection
+      header->_hash = hashes[i];
+
+      int res = InsertPrimaryIndex(document, header, false);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = InsertSecondaryIndexes(document, header, false);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          DeleteSecondaryIndexes(document, header, true);
+          DeletePrimaryIndex(document, header, true);
+        }
+      }
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        documents[i]._errorCode = res;
+        operation->revert();
+        continue;
+      }
+
+      document->_numberDocuments++;
+
+      operation->indexed();
+      indexed.push_back(operation);
+      headers.push_back(header);
+      positions.push_back(i);
+    }
+
+    // write all markers into the WAL
+    std::vector<int> results;
+    bool waitForSync = forceSync;
+    TRI_AddOperationsTransaction(indexed, results, waitForSync);
+
+    for (size_t j = 0; j < indexed.size(); ++j) {
+      auto& doc = documents[positions[j]];
+
+      if (results[j] != TRI_ERROR_NO_ERROR) {
+        doc._errorCode = results[j];
+        indexed[j]->revert();
+        continue;
+      }
+
+      doc._mptr = *headers[j];
+      PostInsertIndexes(trxCollection, headers[j]);
+
+      if (waitForSync && indexed[j]->tick > markerTick) {
+        markerTick = indexed[j]->tick;
+      }
+    }
+  }
+
+  if (markerTick > 0) {
+    // need to wait for tick, outside the lock
+    triagens::wal::LogfileManager::instance()->slots()->waitForTick(markerTick);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief updates a document in the collection from shaped json
 ////////////////////////////////////////////////////////////////////////////////
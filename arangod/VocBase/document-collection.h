@@ -34,6 +34,7 @@
 #include "Basics/Common.h"
 #include "Basics/fasthash.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/LockProfiler.h"
 #include "Basics/ReadWriteLockCPP11.h"
 #include "VocBase/collection.h"
 #include "VocBase/Ditch.h"
@@ -56,7 +57,12 @@ class TRI_headers_t;
 class VocShaper;
 
 namespace triagens {
+  namespace basics {
+    class MerkleTree;
+  }
+
   namespace arango {
+    struct AggregateDefinition;
     class CapConstraint;
     class EdgeIndex;
     class ExampleMatcher;
@@ -66,6 +72,7 @@ namespace triagens {
     class Index;
     class PrimaryIndex;
     class SkiplistIndex;
+    class VertexCentricIndex;
   }
 }
 
@@ -75,6 +82,39 @@ class KeyGenerator;
 // --SECTION--                                                     public macros
 // -----------------------------------------------------------------------------
 
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the locks of the documents and indexes, recording the wait and hold
+/// times of every place they are acquired at
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::readLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::tryReadLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(a, t) \
+  triagens::basics::LockProfiler::tryReadLock(a->_lock, __FILE__, __LINE__, std::chrono::microseconds(t))
+
+#define TRI_READ_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::unlock(a->_lock)
+
+#define TRI_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::writeLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::tryWriteLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(a, t) \
+  triagens::basics::LockProfiler::tryWriteLock(a->_lock, __FILE__, __LINE__, std::chrono::microseconds(t))
+
+#define TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
+  triagens::basics::LockProfiler::unlock(a->_lock)
+
+#else
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read locks the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
@@ -89,6 +129,14 @@ class KeyGenerator;
 #define TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
   a->_lock.tryReadLock()
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to read lock the documents and indexes, waiting at most the
+/// given number of microseconds for the lock to become available
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_TRY_READ_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(a, t) \
+  a->_lock.tryReadLock(std::chrono::microseconds(t))
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief read unlocks the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
@@ -110,6 +158,14 @@ class KeyGenerator;
 #define TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
   a->_lock.tryWriteLock()
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to write lock the documents and indexes, waiting at most the
+/// given number of microseconds for the lock to become available
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_TRY_WRITE_LOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION_TIMED(a, t) \
+  a->_lock.tryWriteLock(std::chrono::microseconds(t))
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write unlocks the documents and indexes
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +173,8 @@ class KeyGenerator;
 #define TRI_WRITE_UNLOCK_DOCUMENTS_INDEXES_PRIMARY_COLLECTION(a) \
   a->_lock.unlock()
 
+#endif
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -331,6 +389,7 @@ typedef struct TRI_doc_collection_info_s {
   TRI_voc_ssize_t _numberAttributes;
   TRI_voc_ssize_t _numberTransactions;
   TRI_voc_ssize_t _numberIndexes;
+  TRI_voc_ssize_t _numberDocumentReferences;
 
   int64_t         _sizeAlive;
   int64_t         _sizeDead;
@@ -338,6 +397,7 @@ typedef struct TRI_doc_collection_info_s {
   int64_t         _sizeAttributes;
   int64_t         _sizeTransactions;
   int64_t         _sizeIndexes;
+  int64_t         _sizeDocumentReferences;
 
   int64_t         _datafileSize;
   int64_t         _journalfileSize;
@@ -346,6 +406,7 @@ typedef struct TRI_doc_collection_info_s {
 
   TRI_voc_tick_t  _tickMax;
   uint64_t        _uncollectedLogfileEntries;
+  uint64_t        _numberExpired;
 }
 TRI_doc_collection_info_t;
 
@@ -434,12 +495,49 @@ public:
 
   TRI_condition_t                        _journalsCondition;
 
+  // an empty journal created ahead of time by the cleanup thread, and the
+  // size it has been requested with. the next journal or compactor of the
+  // collection is made from it, so that the collector and the compactor do
+  // not wait for a file to be created. protected by _journalsCondition
+  TRI_datafile_t*                        _spareJournal;
+  TRI_voc_size_t                         _spareJournalSize;
+
   // whether or not any of the indexes may need to be garbage-collected
   // this flag may be modifying when an index is added to a collection
   // if true, the cleanup thread will periodically call the cleanup functions of
   // the collection's indexes that support cleanup
   size_t                                 _cleanupIndexes;
 
+  // whether the collection exceeds the limits of its cap constraint while
+  // staying within the constraint's tolerance. if true, the cleanup thread
+  // will remove the oldest documents
+  std::atomic<bool>                      _capEvictionPending;
+
+  // number of ttl indexes. if not 0, the cleanup thread will periodically
+  // remove the expired documents of the collection
+  size_t                                 _ttlIndexes;
+
+  // number of documents removed because they expired
+  std::atomic<uint64_t>                  _numberExpired;
+
+  // time of the last usage of the collection. the cleanup thread unloads
+  // the least recently used collections when the loaded collections of
+  // all databases hold more memory than the configured target
+  std::atomic<double>                    _lastAccess;
+
+  // hash tree over the keys and revisions of all documents, maintained with
+  // the primary index and protected by the collection lock. it is used to
+  // find the differences to another server's collection quickly. nullptr
+  // while the collection is loaded
+  triagens::basics::MerkleTree*          _keyTree;
+
+  // sums of the CRC32 checksums of all keys and of all revisions, maintained
+  // together with the key tree and valid whenever the key tree is. the sum
+  // of both is what collection.checksum(true) calculates for a document
+  // collection, so the checksum can be polled without a scan
+  uint32_t                               _keysChecksum;
+  uint32_t                               _revisionsChecksum;
+
   int beginRead ();
   int endRead ();
   int beginWrite ();
@@ -449,6 +547,8 @@ public:
 
   TRI_doc_collection_info_t* figures ();
 
+  bool memoryUsage (uint64_t&);
+
   uint64_t size ();
 
   // function that is called to garbage-collect the collection's indexes
@@ -495,6 +595,25 @@ size_t TRI_DocumentIteratorDocumentCollection (triagens::arango::TransactionBase
                                               bool (*callback)(TRI_doc_mptr_t const*,
                                               TRI_document_collection_t*, void*));
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief iterate over all documents in the collection in chunks, using a
+/// user-defined callback function
+///
+/// Unlike TRI_DocumentIteratorDocumentCollection, the function read-locks the
+/// collection itself, for at most chunkSize documents at a time. Between two
+/// chunks, the lock is released and the thread yields, so that a scan of a
+/// large collection does not stall writers. Documents that are inserted or
+/// removed during the scan may or may not be visited. If the transaction
+/// holds a lock on the collection already, it is kept during the whole scan.
+///
+/// The user can abort the iteration by return "false" from the callback
+/// function.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ChunkedDocumentIteratorDocumentCollection (TRI_transaction_collection_t*,
+                                                   size_t,
+                                                   std::function<bool(TRI_doc_mptr_t const*)> const&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                               DOCUMENT COLLECTION
 // -----------------------------------------------------------------------------
@@ -503,6 +622,30 @@ size_t TRI_DocumentIteratorDocumentCollection (triagens::arango::TransactionBase
 // --SECTION--                                                     public macros
 // -----------------------------------------------------------------------------
 
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the locks of the journal files and the parameter file, recording
+/// the wait and hold times of every place they are acquired at
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_TRY_READ_LOCK_DATAFILES_DOC_COLLECTION(a) \
+  triagens::basics::LockProfiler::tryReadLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_READ_LOCK_DATAFILES_DOC_COLLECTION(a) \
+  triagens::basics::LockProfiler::readLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_READ_UNLOCK_DATAFILES_DOC_COLLECTION(a) \
+  triagens::basics::LockProfiler::unlock(a->_lock)
+
+#define TRI_WRITE_LOCK_DATAFILES_DOC_COLLECTION(a) \
+  triagens::basics::LockProfiler::writeLock(a->_lock, __FILE__, __LINE__)
+
+#define TRI_WRITE_UNLOCK_DATAFILES_DOC_COLLECTION(a) \
+  triagens::basics::LockProfiler::unlock(a->_lock)
+
+#else
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief tries to read lock the journal files and the parameter file
 ///
@@ -541,6 +684,8 @@ size_t TRI_DocumentIteratorDocumentCollection (triagens::arango::TransactionBase
 #define TRI_WRITE_UNLOCK_DATAFILES_DOC_COLLECTION(a) \
   a->_lock.unlock()
 
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief locks the journal entries
 ////////////////////////////////////////////////////////////////////////////////
@@ -810,6 +955,13 @@ TRI_datafile_t* TRI_CreateDatafileDocumentCollection (TRI_document_collection_t*
                                                       TRI_voc_size_t,
                                                       bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the spare journal of a collection whose journal is filling
+/// up, called by the cleanup thread
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_PrepareSpareJournalDocumentCollection (TRI_document_collection_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief closes an existing journal
 ////////////////////////////////////////////////////////////////////////////////
@@ -895,8 +1047,17 @@ triagens::arango::Index* TRI_EnsureCapConstraintDocumentCollection (TRI_document
                                                                     TRI_idx_iid_t,
                                                                     size_t,
                                                                     int64_t,
+                                                                    double,
                                                                     bool*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the oldest documents of a collection that exceeds the
+/// limits of its cap constraint within the constraint's tolerance
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_EvictCapConstraintDocumentCollection (TRI_vocbase_t*,
+                                              TRI_document_collection_t*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                         GEO INDEX
 // -----------------------------------------------------------------------------
@@ -945,6 +1106,31 @@ triagens::arango::Index* TRI_EnsureGeoIndex2DocumentCollection (TRI_document_col
                                                                 std::string const&,
                                                                 bool*);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    GEO CELL INDEX
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a geo cell index, with either one location attribute or a
+/// latitude and a longitude attribute
+///
+/// Note that the caller must hold at least a read-lock.
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupGeoCellIndexDocumentCollection (TRI_document_collection_t*,
+                                                                   std::vector<std::string> const&,
+                                                                   bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a geo cell index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureGeoCellIndexDocumentCollection (TRI_document_collection_t*,
+                                                                   TRI_idx_iid_t,
+                                                                   std::vector<std::string> const&,
+                                                                   bool,
+                                                                   bool*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        HASH INDEX
 // -----------------------------------------------------------------------------
@@ -964,10 +1150,14 @@ triagens::arango::Index* TRI_EnsureGeoIndex2DocumentCollection (TRI_document_col
 triagens::arango::Index* TRI_LookupHashIndexDocumentCollection (TRI_document_collection_t*,
                                                                 std::vector<std::string> const&,
                                                                 int,
-                                                                bool);
+                                                                bool,
+                                                                struct TRI_json_t const*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ensures that a hash index exists
+///
+/// if a filter is given, the index is a partial index and only contains the
+/// documents with the attribute values of the filter
 ////////////////////////////////////////////////////////////////////////////////
 
 triagens::arango::Index* TRI_EnsureHashIndexDocumentCollection (TRI_document_collection_t*,
@@ -975,6 +1165,7 @@ triagens::arango::Index* TRI_EnsureHashIndexDocumentCollection (TRI_document_col
                                                                 std::vector<std::string> const&,
                                                                 bool,
                                                                 bool,
+                                                                struct TRI_json_t const*,
                                                                 bool*);
 
 // -----------------------------------------------------------------------------
@@ -994,10 +1185,14 @@ triagens::arango::Index* TRI_EnsureHashIndexDocumentCollection (TRI_document_col
 triagens::arango::Index* TRI_LookupSkiplistIndexDocumentCollection (TRI_document_collection_t*,
                                                                     std::vector<std::string> const&,
                                                                     int,
-                                                                    bool);
+                                                                    bool,
+                                                                    struct TRI_json_t const*);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ensures that a skiplist index exists
+///
+/// if a filter is given, the index is a partial index and only contains the
+/// documents with the attribute values of the filter
 ////////////////////////////////////////////////////////////////////////////////
 
 triagens::arango::Index* TRI_EnsureSkiplistIndexDocumentCollection (TRI_document_collection_t*,
@@ -1005,8 +1200,35 @@ triagens::arango::Index* TRI_EnsureSkiplistIndexDocumentCollection (TRI_document
                                                                     std::vector<std::string> const&,
                                                                     bool,
                                                                     bool,
+                                                                    struct TRI_json_t const*,
                                                                     bool*);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                              VERTEX-CENTRIC INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a vertex-centric index
+///
+/// Note that the caller must hold at least a read-lock.
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupVertexCentricIndexDocumentCollection (TRI_document_collection_t*,
+                                                                         std::vector<std::string> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a vertex-centric index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureVertexCentricIndexDocumentCollection (TRI_document_collection_t*,
+                                                                         TRI_idx_iid_t,
+                                                                         std::vector<std::string> const&,
+                                                                         bool*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    FULLTEXT INDEX
 // -----------------------------------------------------------------------------
@@ -1035,6 +1257,67 @@ triagens::arango::Index* TRI_EnsureFulltextIndexDocumentCollection (TRI_document
                                                                     int,
                                                                     bool*);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                         TTL INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds a ttl index
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupTtlIndexDocumentCollection (TRI_document_collection_t*,
+                                                               std::string const&,
+                                                               double);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that a ttl index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureTtlIndexDocumentCollection (TRI_document_collection_t*,
+                                                               TRI_idx_iid_t,
+                                                               std::string const&,
+                                                               double,
+                                                               bool*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes the expired documents of a collection with ttl indexes,
+/// using at most the given number of transactions
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ExpireDocumentsDocumentCollection (TRI_vocbase_t*,
+                                           TRI_document_collection_t*,
+                                           size_t);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   AGGREGATE INDEX
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds an aggregate index by the name of its view
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_LookupAggregateIndexDocumentCollection (TRI_document_collection_t*,
+                                                                     std::string const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief ensures that an aggregate index exists
+////////////////////////////////////////////////////////////////////////////////
+
+triagens::arango::Index* TRI_EnsureAggregateIndexDocumentCollection (TRI_document_collection_t*,
+                                                                     TRI_idx_iid_t,
+                                                                     std::string const&,
+                                                                     std::vector<std::string> const&,
+                                                                     std::vector<triagens::arango::AggregateDefinition> const&,
+                                                                     bool*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -1129,6 +1412,41 @@ int TRI_InsertShapedJsonDocumentCollection (TRI_transaction_collection_t*,
                                             bool,
                                             bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a single document of a batch insert
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_doc_insert_t {
+  TRI_doc_insert_t (TRI_voc_key_t key,
+                    TRI_shaped_json_t const* shaped,
+                    TRI_document_edge_t const* edge)
+    : _key(key),
+      _shaped(shaped),
+      _edge(edge),
+      _errorCode(TRI_ERROR_NO_ERROR) {
+  }
+
+  TRI_voc_key_t              _key;
+  TRI_shaped_json_t const*   _shaped;
+  TRI_document_edge_t const* _edge;
+  TRI_doc_mptr_copy_t        _mptr;
+  int                        _errorCode;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief insert several shaped-json documents (or edges)
+///
+/// The markers of all documents are written into the WAL in one go. Each
+/// document succeeds or fails on its own, its result is reported in
+/// _errorCode and _mptr. The return value is an error that affected the
+/// batch as a whole.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_InsertShapedJsonDocumentsCollection (TRI_transaction_collection_t*,
+                                             std::vector<TRI_doc_insert_t>&,
+                                             bool,
+                                             bool);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief updates a document in the collection from shaped json
 ////////////////////////////////////////////////////////////////////////////////
@@ -31,7 +31,9 @@
 #include "edge-collection.h"
 #include "Basics/logging.h"
 #include "Indexes/EdgeIndex.h"
+#include "Indexes/VertexCentricIndex.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/ExampleMatcher.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       EDGES INDEX
@@ -136,6 +138,97 @@ static bool FindEdges (TRI_edge_direction_e direction,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief find edges of one direction using the vertex-centric index that
+/// restricts the examples best. returns false if there is no such index
+///
+/// the result is a superset of the edges matching the examples. if
+/// skipReflexive is set, loop edges are left out as in FindEdges with
+/// matchType 3
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FindEdgesVertexCentric (TRI_document_collection_t* document,
+                                    TRI_edge_direction_e direction,
+                                    std::vector<TRI_doc_mptr_copy_t>& result,
+                                    TRI_voc_cid_t cid,
+                                    TRI_voc_key_t const key,
+                                    triagens::arango::ExampleMatcher const* matcher,
+                                    bool skipReflexive) {
+  TRI_ASSERT(direction == TRI_EDGE_OUT || direction == TRI_EDGE_IN);
+
+  bool const isFrom = (direction == TRI_EDGE_OUT);
+
+  triagens::arango::VertexCentricIndex const* best = nullptr;
+  std::vector<std::vector<TRI_shaped_json_t const*>> bestValues;
+  size_t bestScore = 0;
+
+  for (auto const& idx : document->allIndexes()) {
+    if (idx->type() != triagens::arango::Index::TRI_IDX_TYPE_VERTEX_CENTRIC_INDEX) {
+      continue;
+    }
+
+    auto vertexCentricIndex = static_cast<triagens::arango::VertexCentricIndex const*>(idx);
+
+    if (vertexCentricIndex->isFrom() != isFrom) {
+      continue;
+    }
+
+    // the attributes following the vertex
+    auto const& paths = vertexCentricIndex->paths();
+    std::vector<TRI_shape_pid_t> pids;
+    pids.reserve(paths.size() - 1);
+
+    for (size_t i = 1; i < paths.size(); ++i) {
+      pids.emplace_back(paths[i][0].first);
+    }
+
+    std::vector<std::vector<TRI_shaped_json_t const*>> values;
+
+    if (! matcher->requiredValues(pids, values)) {
+      continue;
+    }
+
+    size_t score = 0;
+    for (auto const& it : values) {
+      score += it.size();
+    }
+
+    if (score > bestScore) {
+      best = vertexCentricIndex;
+      bestValues = std::move(values);
+      bestScore = score;
+    }
+  }
+
+  if (best == nullptr) {
+    return false;
+  }
+
+  std::vector<TRI_doc_mptr_copy_t> found;
+
+  for (auto const& it : bestValues) {
+    best->lookup(cid, key, it, found);
+  }
+
+  // overlapping examples find the same edges more than once
+  std::unordered_set<void const*> seen;
+
+  for (auto& edge : found) {
+    if (skipReflexive && IsReflexive(&edge)) {
+      continue;
+    }
+
+    if (bestValues.size() > 1 &&
+        ! seen.emplace(edge.getDataPtr()).second) {  // ONLY IN INDEX, PROTECTED by RUNTIME
+      continue;
+    }
+
+    result.emplace_back(edge);
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -180,6 +273,53 @@ std::vector<TRI_doc_mptr_copy_t> TRI_LookupEdgesDocumentCollection (
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up edges that may match the examples
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<TRI_doc_mptr_copy_t> TRI_LookupEdgesDocumentCollection (
+                                        TRI_document_collection_t* document,
+                                        TRI_edge_direction_e direction,
+                                        TRI_voc_cid_t cid,
+                                        TRI_voc_key_t const key,
+                                        triagens::arango::ExampleMatcher const* matcher) {
+  if (matcher == nullptr) {
+    return TRI_LookupEdgesDocumentCollection(document, direction, cid, key);
+  }
+
+  // search criteria
+  TRI_edge_header_t entry(cid, key);
+
+  // initialize the result vector
+  std::vector<TRI_doc_mptr_copy_t> result;
+
+  auto edgeIndex = document->edgeIndex();
+
+  if (edgeIndex == nullptr) {
+    LOG_ERROR("collection does not have an edges index");
+    return result;
+  }
+
+  if (direction == TRI_EDGE_IN || direction == TRI_EDGE_ANY) {
+    // get all edges with a matching IN vertex
+    if (! FindEdgesVertexCentric(document, TRI_EDGE_IN, result, cid, key, matcher, false)) {
+      FindEdges(TRI_EDGE_IN, edgeIndex, result, &entry, 1);
+    }
+  }
+
+  if (direction == TRI_EDGE_OUT || direction == TRI_EDGE_ANY) {
+    // get all edges with a matching OUT vertex. in the ANY case, loop edges
+    // were found above already
+    bool const skipReflexive = (direction == TRI_EDGE_ANY);
+
+    if (! FindEdgesVertexCentric(document, TRI_EDGE_OUT, result, cid, key, matcher, skipReflexive)) {
+      FindEdges(TRI_EDGE_OUT, edgeIndex, result, &entry, skipReflexive ? 3 : 1);
+    }
+  }
+
+  return result;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
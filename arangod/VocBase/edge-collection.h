@@ -117,6 +117,23 @@ std::vector<TRI_doc_mptr_copy_t> TRI_LookupEdgesDocumentCollection (
                                                   TRI_voc_cid_t,
                                                   TRI_voc_key_t const);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up edges that may match the examples
+///
+/// uses a vertex-centric index if the examples restrict its attributes, so
+/// that only the vertex's edges with the example values are read. the result
+/// is a superset of the matching edges, the caller still has to check them
+/// with the matcher. without a matcher, this is the same as the function
+/// above
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<TRI_doc_mptr_copy_t> TRI_LookupEdgesDocumentCollection (
+                                                  struct TRI_document_collection_t*,
+                                                  TRI_edge_direction_e,
+                                                  TRI_voc_cid_t,
+                                                  TRI_voc_key_t const,
+                                                  triagens::arango::ExampleMatcher const*);
+
 #endif
 
 // -----------------------------------------------------------------------------
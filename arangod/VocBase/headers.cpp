@@ -44,7 +44,8 @@
 /// documents) only use little memory whereas bigger collections allocate new
 /// blocks in bigger chunks.
 /// the lowest value for the number of entries in a block is BLOCK_SIZE_UNIT,
-/// the highest value is BLOCK_SIZE_UNIT << 8.
+/// the highest value is BLOCK_SIZE_UNIT << 11. big collections thus use few
+/// large blocks instead of many small allocations.
 ////////////////////////////////////////////////////////////////////////////////
 
 static inline size_t GetBlockSize (size_t blockNumber) {
@@ -55,9 +56,15 @@ static inline size_t GetBlockSize (size_t blockNumber) {
     return (size_t) (BLOCK_SIZE_UNIT << blockNumber);
   }
 
-  // use a block size of 32768
-  // this will use 32768 * sizeof(TRI_doc_mptr_t) bytes, i.e. 1.5 MB
-  return (size_t) (BLOCK_SIZE_UNIT << 8);
+  if (blockNumber < 40) {
+    // use a block size of 32768
+    // this will use 32768 * sizeof(TRI_doc_mptr_t) bytes, i.e. 1.5 MB
+    return (size_t) (BLOCK_SIZE_UNIT << 8);
+  }
+
+  // the collection has more than 1M documents. use a block size of 262144
+  // this will use 262144 * sizeof(TRI_doc_mptr_t) bytes, i.e. 12 MB
+  return (size_t) (BLOCK_SIZE_UNIT << 11);
 }
 
 // -----------------------------------------------------------------------------
@@ -73,6 +80,7 @@ TRI_headers_t::TRI_headers_t ()
     _begin(nullptr),
     _end(nullptr),
     _nrAllocated(0),
+    _nrReserved(0),
     _nrLinked(0),
     _totalSize(0),
     _blocks() {
@@ -88,6 +96,10 @@ TRI_headers_t::~TRI_headers_t () {
   for (auto& it : _blocks) {
     delete[] it;
   }
+
+  TRI_AddMemoryZoneUsage(TRI_HEADERS_MEM_ZONE,
+                         - (int64_t) (_nrReserved * sizeof(TRI_doc_mptr_t)),
+                         - (int64_t) _blocks.size());
 }
 
 // -----------------------------------------------------------------------------
@@ -357,9 +369,14 @@ TRI_doc_mptr_t* TRI_headers_t::request (size_t size) {
     catch (...) {
       // out of memory
       delete[] begin; 
+      _freelist = nullptr;
       TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
       return nullptr;
     }
+
+    _nrReserved += blockSize;
+
+    TRI_AddMemoryZoneUsage(TRI_HEADERS_MEM_ZONE, (int64_t) (blockSize * sizeof(TRI_doc_mptr_t)), 1);
   }
 
   TRI_ASSERT(_freelist != nullptr);
@@ -434,8 +451,13 @@ void TRI_headers_t::release (TRI_doc_mptr_t* header,
     for (auto& it : _blocks) {
       delete[] it;
     }
+
+    TRI_AddMemoryZoneUsage(TRI_HEADERS_MEM_ZONE,
+                           - (int64_t) (_nrReserved * sizeof(TRI_doc_mptr_t)),
+                           - (int64_t) _blocks.size());
     _blocks.clear();
 
+    _nrReserved = 0;
     _freelist = nullptr;
     _begin = nullptr;
     _end = nullptr;
@@ -72,11 +72,21 @@ class TRI_headers_t {
     }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief returns the memory usage
+/// @brief returns the number of headers in all blocks, including the ones
+/// on the freelist
+////////////////////////////////////////////////////////////////////////////////
+
+    size_t numReserved () const {
+      return _nrReserved;
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the memory usage of all blocks
 ////////////////////////////////////////////////////////////////////////////////
 
     size_t memory () const {
-      return _nrAllocated * sizeof(TRI_doc_mptr_t);
+      return _nrReserved * sizeof(TRI_doc_mptr_t) + 
+             _blocks.capacity() * sizeof(TRI_doc_mptr_t const*);
     }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,6 +180,7 @@ class TRI_headers_t {
     TRI_doc_mptr_t*               _begin;       // start pointer to list of allocated headers
     TRI_doc_mptr_t*               _end;         // end pointer to list of allocated headers
     size_t                        _nrAllocated; // number of allocated headers
+    size_t                        _nrReserved;  // number of headers in all blocks
     size_t                        _nrLinked;    // number of linked headers
     int64_t                       _totalSize;   // total size of markers for linked headers
 
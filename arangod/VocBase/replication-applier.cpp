@@ -158,6 +158,16 @@ static TRI_json_t* JsonConfiguration (TRI_replication_applier_configuration_t co
                        "chunkSize",
                        TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) config->_chunkSize));
 
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
+                       json,
+                       "syncParallelism",
+                       TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) config->_syncParallelism));
+
+  TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
+                       json,
+                       "applyParallelism",
+                       TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) config->_applyParallelism));
+
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE,
                        json,
                        "autoStart",
@@ -311,6 +321,18 @@ static int LoadConfiguration (TRI_vocbase_t* vocbase,
     config->_chunkSize = (uint64_t) value->_value._number;
   }
 
+  value = TRI_LookupObjectJson(json.get(), "syncParallelism");
+
+  if (TRI_IsNumberJson(value)) {
+    config->_syncParallelism = (uint64_t) value->_value._number;
+  }
+
+  value = TRI_LookupObjectJson(json.get(), "applyParallelism");
+
+  if (TRI_IsNumberJson(value)) {
+    config->_applyParallelism = (uint64_t) value->_value._number;
+  }
+
   value = TRI_LookupObjectJson(json.get(), "autoStart");
 
   if (TRI_IsBooleanJson(value)) {
@@ -526,6 +548,97 @@ static TRI_json_t* JsonState (TRI_replication_applier_state_t const* state) {
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "totalEvents", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_totalEvents));
   TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "totalOperationsExcluded", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_skippedOperations));
 
+  // initial synchronization
+  if (state->_syncStartTime > 0.0) {
+    TRI_json_t* sync = TRI_CreateObjectJson(TRI_CORE_MEM_ZONE, 4);
+
+    if (sync != nullptr) {
+      double const duration = state->_syncUpdateTime - state->_syncStartTime;
+      double throughput = 0.0;
+
+      if (duration > 0.0) {
+        throughput = static_cast<double>(state->_syncBytesReceived) / duration;
+      }
+
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, sync, "bytesReceived", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_syncBytesReceived));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, sync, "markersProcessed", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_syncMarkersProcessed));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, sync, "duration", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, duration));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, sync, "bytesPerSecond", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, throughput));
+
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "initialSync", sync);
+    }
+  }
+
+  // continuous replication
+  if (state->_batches > 0) {
+    TRI_json_t* continuous = TRI_CreateObjectJson(TRI_CORE_MEM_ZONE, 12);
+
+    if (continuous != nullptr) {
+      // the time accounted for, so the rates do not drop while the applier is stopped
+      double const duration = state->_fetchTime + state->_applyTime + state->_waitTime;
+      double bytesPerSecond = 0.0;
+      double markersPerSecond = 0.0;
+
+      if (duration > 0.0) {
+        bytesPerSecond = static_cast<double>(state->_bytesReceived) / duration;
+        markersPerSecond = static_cast<double>(state->_markersReceived) / duration;
+      }
+
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "batches", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_batches));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "bytesReceived", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_bytesReceived));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "markersReceived", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_markersReceived));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "fetchTime", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, state->_fetchTime));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "applyTime", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, state->_applyTime));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "waitTime", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, state->_waitTime));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "bytesPerSecond", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, bytesPerSecond));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "markersPerSecond", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, markersPerSecond));
+
+      // apply time per batch with markers, in the format of the request statistics
+      TRI_json_t* distribution = TRI_CreateObjectJson(TRI_CORE_MEM_ZONE, 3);
+
+      if (distribution != nullptr) {
+        TRI_json_t* counts = TRI_CreateArrayJson(TRI_CORE_MEM_ZONE, TRI_REPLICATION_APPLIER_TIME_BUCKETS);
+        uint64_t count = 0;
+
+        for (size_t i = 0; i < TRI_REPLICATION_APPLIER_TIME_BUCKETS; ++i) {
+          count += state->_applyTimeCounts[i];
+
+          if (counts != nullptr) {
+            TRI_PushBack3ArrayJson(TRI_CORE_MEM_ZONE, counts, TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) state->_applyTimeCounts[i]));
+          }
+        }
+
+        TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, distribution, "sum", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, state->_applyTime));
+        TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, distribution, "count", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) count));
+
+        if (counts != nullptr) {
+          TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, distribution, "counts", counts);
+        }
+
+        TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "applyTimeDistribution", distribution);
+      }
+
+      // lag. the master does not tell the time of its ticks, so the lag in
+      // seconds is the time since the applier last had nothing more to fetch
+      uint64_t lagTicks = 0;
+
+      if (state->_lastAvailableContinuousTick > state->_lastAppliedContinuousTick) {
+        lagTicks = state->_lastAvailableContinuousTick - state->_lastAppliedContinuousTick;
+      }
+
+      double lagSeconds = 0.0;
+
+      if (! state->_caughtUp && state->_caughtUpTime > 0.0) {
+        lagSeconds = TRI_microtime() - state->_caughtUpTime;
+      }
+
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "lagTicks", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, (double) lagTicks));
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, continuous, "lagSeconds", TRI_CreateNumberJson(TRI_CORE_MEM_ZONE, lagSeconds));
+
+      TRI_Insert3ObjectJson(TRI_CORE_MEM_ZONE, json, "continuousSync", continuous);
+    }
+  }
+
   // lastError
   error = TRI_CreateObjectJson(TRI_CORE_MEM_ZONE);
 
@@ -667,6 +780,19 @@ int TRI_StateReplicationApplier (TRI_replication_applier_t* applier,
   state->_totalFailedConnects         = applier->_state._totalFailedConnects;
   state->_totalEvents                 = applier->_state._totalEvents;
   state->_skippedOperations           = applier->_state._skippedOperations;
+  state->_syncBytesReceived           = applier->_state._syncBytesReceived;
+  state->_syncMarkersProcessed        = applier->_state._syncMarkersProcessed;
+  state->_syncStartTime               = applier->_state._syncStartTime;
+  state->_syncUpdateTime              = applier->_state._syncUpdateTime;
+  state->_batches                     = applier->_state._batches;
+  state->_bytesReceived               = applier->_state._bytesReceived;
+  state->_markersReceived             = applier->_state._markersReceived;
+  state->_fetchTime                   = applier->_state._fetchTime;
+  state->_applyTime                   = applier->_state._applyTime;
+  state->_waitTime                    = applier->_state._waitTime;
+  state->_caughtUpTime                = applier->_state._caughtUpTime;
+  state->_caughtUp                    = applier->_state._caughtUp;
+  memcpy(&state->_applyTimeCounts, &applier->_state._applyTimeCounts, sizeof(state->_applyTimeCounts));
   memcpy(&state->_lastError._time, &applier->_state._lastError._time, sizeof(state->_lastError._time));
 
   if (applier->_state._progressMsg != nullptr) {
@@ -920,6 +1046,8 @@ void TRI_InitConfigurationReplicationApplier (TRI_replication_applier_configurat
   config->_ignoreErrors        = 0;
   config->_maxConnectRetries   = 100;
   config->_chunkSize           = 0;
+  config->_syncParallelism     = 1;
+  config->_applyParallelism    = 1;
   config->_sslProtocol         = 0;
   config->_autoStart           = false;
   config->_adaptivePolling     = true;
@@ -996,6 +1124,8 @@ void TRI_CopyConfigurationReplicationApplier (TRI_replication_applier_configurat
   dst->_maxConnectRetries   = src->_maxConnectRetries;
   dst->_sslProtocol         = src->_sslProtocol;
   dst->_chunkSize           = src->_chunkSize;
+  dst->_syncParallelism     = src->_syncParallelism;
+  dst->_applyParallelism    = src->_applyParallelism;
   dst->_autoStart           = src->_autoStart;
   dst->_adaptivePolling     = src->_adaptivePolling;
   dst->_includeSystem       = src->_includeSystem;
@@ -1148,6 +1278,17 @@ int TRI_replication_applier_t::start (TRI_voc_tick_t initialTick,
   setTermination(false);
   _state._active = true;
 
+  // reset the statistics of the continuous replication
+  _state._batches         = 0;
+  _state._bytesReceived   = 0;
+  _state._markersReceived = 0;
+  _state._fetchTime       = 0.0;
+  _state._applyTime       = 0.0;
+  _state._waitTime        = 0.0;
+  _state._caughtUpTime    = TRI_microtime();
+  _state._caughtUp        = false;
+  memset(&_state._applyTimeCounts, 0, sizeof(_state._applyTimeCounts));
+
   TRI_InitThread(&_thread);
 
   if (! TRI_StartThread(&_thread, nullptr, "[applier]", ApplyThread, static_cast<void*>(syncer.get()))) {
@@ -1405,6 +1546,87 @@ void TRI_replication_applier_t::setProgress (char const* msg,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resets the statistics of the initial synchronization
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_replication_applier_t::startSync () {
+  WRITE_LOCKER(_statusLock);
+
+  _state._syncBytesReceived    = 0;
+  _state._syncMarkersProcessed = 0;
+  _state._syncStartTime        = TRI_microtime();
+  _state._syncUpdateTime       = _state._syncStartTime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reports progress of the initial synchronization
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_replication_applier_t::setSyncProgress (char const* msg,
+                                                 uint64_t bytesReceived,
+                                                 uint64_t markersProcessed) {
+  WRITE_LOCKER(_statusLock);
+
+  _state._syncBytesReceived    += bytesReceived;
+  _state._syncMarkersProcessed += markersProcessed;
+  _state._syncUpdateTime        = TRI_microtime();
+
+  if (! _state._active) {
+    // do not overwrite the messages of the continuous applier
+    setProgress(msg, false);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a batch of the continuous replication
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_replication_applier_t::addBatch (double fetchTime,
+                                          double applyTime,
+                                          double waitTime,
+                                          uint64_t bytesReceived,
+                                          uint64_t markersReceived,
+                                          bool caughtUp) {
+  // same cuts as REQUEST_TIME_DISTRIBUTION
+  static double const Cuts[TRI_REPLICATION_APPLIER_TIME_BUCKETS - 1] = { 0.01, 0.05, 0.1, 0.2, 0.5, 1.0 };
+
+  WRITE_LOCKER(_statusLock);
+
+  ++_state._batches;
+  _state._bytesReceived   += bytesReceived;
+  _state._markersReceived += markersReceived;
+  _state._fetchTime       += fetchTime;
+  _state._applyTime       += applyTime;
+  _state._waitTime        += waitTime;
+
+  if (markersReceived > 0) {
+    size_t i = 0;
+
+    while (i < TRI_REPLICATION_APPLIER_TIME_BUCKETS - 1 && applyTime >= Cuts[i]) {
+      ++i;
+    }
+
+    ++_state._applyTimeCounts[i];
+  }
+
+  _state._caughtUp = caughtUp;
+
+  if (caughtUp) {
+    _state._caughtUpTime = TRI_microtime();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds time the continuous replication waited for the master
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_replication_applier_t::addWaitTime (double waitTime) {
+  WRITE_LOCKER(_statusLock);
+
+  _state._waitTime += waitTime;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief register an applier error
 ////////////////////////////////////////////////////////////////////////////////
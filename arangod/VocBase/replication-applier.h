@@ -53,6 +53,13 @@ struct TRI_vocbase_t;
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of buckets of the apply time histogram, see
+/// REQUEST_TIME_DISTRIBUTION for the cuts
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REPLICATION_APPLIER_TIME_BUCKETS (7)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief struct containing a replication apply configuration
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,6 +74,8 @@ typedef struct TRI_replication_applier_configuration_s {
   uint64_t      _ignoreErrors;
   uint64_t      _maxConnectRetries;
   uint64_t      _chunkSize;
+  uint64_t      _syncParallelism;
+  uint64_t      _applyParallelism;
   uint32_t      _sslProtocol;
   bool          _autoStart;
   bool          _adaptivePolling;
@@ -109,6 +118,20 @@ struct TRI_replication_applier_state_t {
   uint64_t                                 _totalFailedConnects;
   uint64_t                                 _totalEvents;
   uint64_t                                 _skippedOperations;
+  uint64_t                                 _syncBytesReceived;
+  uint64_t                                 _syncMarkersProcessed;
+  double                                   _syncStartTime;
+  double                                   _syncUpdateTime;
+  // continuous replication since the applier was started
+  uint64_t                                 _batches;
+  uint64_t                                 _bytesReceived;
+  uint64_t                                 _markersReceived;
+  double                                   _fetchTime;
+  double                                   _applyTime;
+  double                                   _waitTime;
+  double                                   _caughtUpTime;
+  bool                                     _caughtUp;
+  uint64_t                                 _applyTimeCounts[TRI_REPLICATION_APPLIER_TIME_BUCKETS];
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -197,6 +220,43 @@ class TRI_replication_applier_t {
     void setProgress (char const*,
                       bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resets the statistics of the initial synchronization
+////////////////////////////////////////////////////////////////////////////////
+
+    void startSync ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reports progress of the initial synchronization
+///
+/// the byte and marker counts are added to the totals. the message replaces
+/// the progress message only if the continuous applier is not running
+////////////////////////////////////////////////////////////////////////////////
+
+    void setSyncProgress (char const*,
+                          uint64_t,
+                          uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a batch of the continuous replication
+///
+/// takes the time spent fetching, applying and waiting, the bytes and markers
+/// received and whether the applier has caught up with the master
+////////////////////////////////////////////////////////////////////////////////
+
+    void addBatch (double,
+                   double,
+                   double,
+                   uint64_t,
+                   uint64_t,
+                   bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds time the continuous replication waited for the master
+////////////////////////////////////////////////////////////////////////////////
+
+    void addWaitTime (double);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief register an applier error
 ////////////////////////////////////////////////////////////////////////////////
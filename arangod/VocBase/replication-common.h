@@ -71,6 +71,12 @@
 
 #define TRI_REPLICATION_HEADER_ACTIVE    "x-arango-replication-active"
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type of a collection dump in binary format
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_REPLICATION_DUMP_BINARY_CONTENT_TYPE "application/x-arango-dump-binary"
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include "VocBase/collection.h"
 #include "VocBase/datafile.h"
 #include "VocBase/document-collection.h"
+#include "VocBase/Legends.h"
 #include "VocBase/server.h"
 #include "VocBase/transaction.h"
 #include "VocBase/vocbase.h"
@@ -475,6 +476,114 @@ static int StringifyMarkerDump (TRI_replication_dump_t* dump,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name of a collection for a binary dump
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string CollectionName (TRI_voc_cid_t cid,
+                                   triagens::arango::CollectionNameResolver* resolver) {
+  if (cid == 0) {
+    return "_unknown";
+  }
+
+  if (triagens::arango::ServerState::instance()->isDBServer()) {
+    return resolver->getCollectionNameCluster(cid);
+  }
+
+  return resolver->getCollectionName(cid);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append zero bytes up to the next 8 byte boundary
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendPadding (TRI_string_buffer_t* buffer,
+                          size_t length) {
+  static char const Zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  size_t const padding = TRI_DF_ALIGN_BLOCK(length) - length;
+
+  if (padding > 0) {
+    return TRI_AppendString2StringBuffer(buffer, Zeros, padding);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append a raw marker from a datafile for a binary collection dump
+///
+/// the follower needs the names of the collections an edge points to and the
+/// shapes and attribute names of the document, as its ids differ from ours
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendMarkerDump (TRI_replication_dump_t* dump,
+                             TRI_df_marker_t const* marker,
+                             triagens::basics::JsonLegend* legend,
+                             triagens::arango::CollectionNameResolver* resolver) {
+  TRI_string_buffer_t* buffer = dump->_buffer;
+
+  if (buffer == nullptr) {
+    return TRI_ERROR_INTERNAL;
+  }
+
+  std::string names;
+
+  if (marker->_type == TRI_DOC_MARKER_KEY_EDGE) {
+    auto e = reinterpret_cast<TRI_doc_edge_key_marker_t const*>(marker);
+
+    names.append(CollectionName(e->_fromCid, resolver));
+    names.push_back('\0');
+    names.append(CollectionName(e->_toCid, resolver));
+    names.push_back('\0');
+  }
+
+  legend->clear();
+
+  if (marker->_type != TRI_DOC_MARKER_KEY_DELETION) {
+    TRI_shaped_json_t shaped;
+    TRI_EXTRACT_SHAPED_JSON_MARKER(shaped, marker);
+
+    int res = legend->addShape(&shaped);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  size_t const legendSize = (marker->_type != TRI_DOC_MARKER_KEY_DELETION ? legend->getSize() : 0);
+
+  TRI_replication_dump_marker_t header;
+  header._markerSize = marker->_size;
+  header._namesSize  = static_cast<uint32_t>(names.size());
+  header._legendSize = static_cast<uint32_t>(legendSize);
+  header._size       = static_cast<uint32_t>(sizeof(TRI_replication_dump_marker_t) +
+                                             TRI_DF_ALIGN_BLOCK(header._markerSize) +
+                                             TRI_DF_ALIGN_BLOCK(header._namesSize) +
+                                             legendSize);
+
+  if (TRI_ReserveStringBuffer(buffer, header._size) != TRI_ERROR_NO_ERROR) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  TRI_AppendString2StringBuffer(buffer, reinterpret_cast<char const*>(&header), sizeof(header));
+  TRI_AppendString2StringBuffer(buffer, reinterpret_cast<char const*>(marker), marker->_size);
+  AppendPadding(buffer, marker->_size);
+
+  if (! names.empty()) {
+    TRI_AppendString2StringBuffer(buffer, names.c_str(), names.size());
+    AppendPadding(buffer, names.size());
+  }
+
+  if (legendSize > 0) {
+    // the legend size is a multiple of 8
+    legend->dump(const_cast<char*>(TRI_EndStringBuffer(buffer)));
+    TRI_IncreaseLengthStringBuffer(buffer, legendSize);
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief append the document attributes of a marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -1202,6 +1311,9 @@ static int DumpCollection (TRI_replication_dump_t* dump,
 
   buffer = dump->_buffer;
 
+  // legend for the binary format, reused for all markers
+  triagens::basics::JsonLegend legend(document->getShaper());  // ONLY IN DUMP, PROTECTED by fake trx above
+
   std::vector<df_entry_t> datafiles;
 
   try {
@@ -1247,6 +1359,11 @@ static int DumpCollection (TRI_replication_dump_t* dump,
       end = ptr;
     }
 
+    // the next chunk scans the datafile from its start again, so the pages
+    // are only read ahead, but not released
+    TRI_df_readahead_t readahead;
+    TRI_InitReadaheadDatafile(&readahead, datafile, false);
+
     while (ptr < end) {
       TRI_df_marker_t* marker = (TRI_df_marker_t*) ptr;
       TRI_voc_tick_t foundTick;
@@ -1257,6 +1374,8 @@ static int DumpCollection (TRI_replication_dump_t* dump,
         break;
       }
 
+      TRI_AdvanceReadaheadDatafile(&readahead, ptr);
+
       ptr += TRI_DF_ALIGN_BLOCK(marker->_size);
 
       if (marker->_type == TRI_DF_MARKER_ATTRIBUTE ||
@@ -1332,7 +1451,12 @@ static int DumpCollection (TRI_replication_dump_t* dump,
       }
 
 
-      res = StringifyMarkerDump(dump, document, marker, withTicks, translateCollectionIds, resolver);
+      if (dump->_binary) {
+        res = AppendMarkerDump(dump, marker, &legend, resolver);
+      }
+      else {
+        res = StringifyMarkerDump(dump, document, marker, withTicks, translateCollectionIds, resolver);
+      }
 
       if (res != TRI_ERROR_NO_ERROR) {
         break; // will go to NEXT_DF
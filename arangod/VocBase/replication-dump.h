@@ -53,6 +53,22 @@ struct TRI_vocbase_col_s;
 // --SECTION--                                                      public types
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief header of an entry in a collection dump in binary format
+///
+/// The header is followed by the raw datafile marker, by the NUL-terminated
+/// names of the _from and _to collections for edges, and by the legend of
+/// the document's shapes for documents and edges. Each part starts at an
+/// 8 byte boundary.
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_replication_dump_marker_t {
+  uint32_t _size;         // size of the entry including the header
+  uint32_t _markerSize;   // size of the marker
+  uint32_t _namesSize;    // size of the collection names
+  uint32_t _legendSize;   // size of the legend
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief replication dump container
 ////////////////////////////////////////////////////////////////////////////////
@@ -72,7 +88,8 @@ struct TRI_replication_dump_t {
       _bufferFull(false),
       _hasMore(false),
       _includeSystem(includeSystem),
-      _fromTickIncluded(false) {
+      _fromTickIncluded(false),
+      _binary(false) {
  
     if (_chunkSize == 0) {
       // default chunk size
@@ -105,6 +122,7 @@ struct TRI_replication_dump_t {
   bool                         _hasMore;
   bool                         _includeSystem;
   bool                         _fromTickIncluded;
+  bool                         _binary;
 };
 
 // -----------------------------------------------------------------------------
@@ -36,6 +36,8 @@
 #include <regex.h>
 
 #include "Aql/QueryCache.h"
+#include "Aql/QueryPlanCache.h"
+#include "Aql/QuerySnippetCache.h"
 #include "Aql/QueryRegistry.h"
 #include "Basics/conversions.h"
 #include "Basics/Exceptions.h"
@@ -50,6 +52,7 @@
 #include "Basics/random.h"
 #include "Basics/SpinLock.h"
 #include "Basics/SpinLocker.h"
+#include "Basics/ThreadPool.h"
 #include "Basics/tri-strings.h"
 #include "Cluster/ServerState.h"
 #include "Utils/CursorRepository.h"
@@ -59,6 +62,8 @@
 #include "Wal/LogfileManager.h"
 #include "Wal/Marker.h"
 
+#include <thread>
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -455,8 +460,19 @@ static int OpenDatabases (TRI_server_t* server,
   auto newLists = new DatabasesLists(*oldLists);
   // No try catch here, if we crash here because out of memory...
 
+  // the valid database directories, in the defined order
+  struct PendingDatabase {
+    char* _directory;
+    char* _name;
+    TRI_voc_tick_t _id;
+    TRI_vocbase_defaults_t _defaults;
+    TRI_vocbase_t* _vocbase;
+    int _res;
+  };
+
+  std::vector<PendingDatabase> pending;
+
   for (size_t i = 0;  i < n;  ++i) {
-    TRI_vocbase_t* vocbase;
     TRI_json_t* json;
     TRI_json_t const* deletedJson;
     TRI_json_t const* nameJson;
@@ -643,41 +659,106 @@ static int OpenDatabases (TRI_server_t* server,
     }
 
     // .........................................................................
-    // open the database and scan collections in it
+    // the database is opened below, together with the others
     // .........................................................................
 
-    // try to open this database
-    vocbase = TRI_OpenVocBase(server,
-                              databaseDirectory,
-                              id,
-                              databaseName,
-                              &defaults,
-                              isUpgrade,
-                              server->_iterateMarkersOnOpen);
+    try {
+      pending.emplace_back(PendingDatabase{ databaseDirectory, databaseName, id, defaults, nullptr, TRI_ERROR_NO_ERROR });
+    }
+    catch (...) {
+      TRI_FreeString(TRI_CORE_MEM_ZONE, databaseName);
+      TRI_FreeString(TRI_CORE_MEM_ZONE, databaseDirectory);
+      res = TRI_ERROR_OUT_OF_MEMORY;
+      break;
+    }
+  }
 
-    TRI_FreeString(TRI_CORE_MEM_ZONE, databaseName);
+  // .............................................................................
+  // open the databases and scan the collections in them
+  // .............................................................................
 
-    if (vocbase == nullptr) {
-      // grab last error
-      res = TRI_errno();
+  // databases are independent of each other, so they are opened in parallel.
+  // this mostly pays off when the datafiles must be scanned for the last tick
+  size_t numThreads = (server->_indexPool != nullptr ? server->_indexPool->numThreads() : 1);
 
-      if (res == TRI_ERROR_NO_ERROR) {
-        // but we must have an error...
-        res = TRI_ERROR_INTERNAL;
+  if (numThreads > pending.size()) {
+    numThreads = pending.size();
+  }
+
+  std::atomic<size_t> next(0);
+
+  auto opener = [&] () -> void {
+    size_t i;
+
+    while ((i = next++) < pending.size()) {
+      auto& database = pending[i];
+
+      database._vocbase = TRI_OpenVocBase(server,
+                                          database._directory,
+                                          database._id,
+                                          database._name,
+                                          &database._defaults,
+                                          isUpgrade,
+                                          server->_iterateMarkersOnOpen);
+
+      if (database._vocbase == nullptr) {
+        // grab last error
+        database._res = TRI_errno();
+
+        if (database._res == TRI_ERROR_NO_ERROR) {
+          // but we must have an error...
+          database._res = TRI_ERROR_INTERNAL;
+        }
+      }
+    }
+  };
+
+  if (numThreads > 1) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    try {
+      for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back(std::thread(opener));
       }
+    }
+    catch (...) {
+      // the remaining databases are opened by this thread
+    }
+
+    opener();
+
+    for (auto& it : threads) {
+      it.join();
+    }
+  }
+  else {
+    opener();
+  }
+
+  // register the databases in the defined order
+  for (auto& database : pending) {
+    TRI_vocbase_t* vocbase = database._vocbase;
 
+    if (vocbase == nullptr) {
       LOG_ERROR("could not process database directory '%s' for database '%s': %s",
-                databaseDirectory,
-                name,
-                TRI_errno_string(res));
+                database._directory,
+                database._name,
+                TRI_errno_string(database._res));
 
-      TRI_FreeString(TRI_CORE_MEM_ZONE, databaseDirectory);
-      break;
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = database._res;
+      }
+
+      TRI_FreeString(TRI_CORE_MEM_ZONE, database._name);
+      TRI_FreeString(TRI_CORE_MEM_ZONE, database._directory);
+      continue;
     }
 
     // we found a valid database
-    TRI_FreeString(TRI_CORE_MEM_ZONE, databaseDirectory);
-    
+    TRI_FreeString(TRI_CORE_MEM_ZONE, database._name);
+    TRI_FreeString(TRI_CORE_MEM_ZONE, database._directory);
+
     void const* TRI_UNUSED found = nullptr;
 
     try {
@@ -688,10 +769,16 @@ static int OpenDatabases (TRI_server_t* server,
       }
     }
     catch (...) {
-      res = TRI_ERROR_OUT_OF_MEMORY;
       LOG_ERROR("could not add database '%s': out of memory",
-                name);
-      break;
+                vocbase->_name);
+
+      TRI_DestroyVocBase(vocbase);
+      delete vocbase;
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = TRI_ERROR_OUT_OF_MEMORY;
+      }
+      continue;
     }
 
     TRI_ASSERT(found == nullptr);
@@ -2372,6 +2459,8 @@ int TRI_DropDatabaseServer (TRI_server_t* server,
 
   // invalidate all entries for the database
   triagens::aql::QueryCache::instance()->invalidate(vocbase);
+  triagens::aql::QueryPlanCache::instance()->invalidate(vocbase);
+  triagens::aql::QuerySnippetCache::instance()->invalidate(vocbase);
 
   int res = TRI_ERROR_NO_ERROR;
 
@@ -71,13 +71,6 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
     return false;
   }
   
-  // we need at least 3 or 4 entries in the vector to store an accessor
-  TRI_vector_pointer_t ops;
-
-  if (TRI_InitVectorPointer(&ops, TRI_UNKNOWN_MEM_ZONE, 4) != TRI_ERROR_NO_ERROR) {
-    return false;
-  }
-
   // find the attribute path
   TRI_shape_path_t const* path = shaper->lookupAttributePathByPid(accessor->_pid);
 
@@ -89,6 +82,18 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
     return false;
   }
 
+  // we need at least 3 or 4 entries in the vector to store an accessor
+  TRI_vector_pointer_t ops;
+
+  if (TRI_InitVectorPointer(&ops, TRI_UNKNOWN_MEM_ZONE, 4) != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  // position of the last fixed offset operation, if it is the last operation
+  // so far. a fixed size entry always has a fixed size shape, so all further
+  // steps are fixed offsets, too, and are folded into this one
+  size_t lastFixed = SIZE_MAX;
+
   TRI_shape_aid_t const* paids = (TRI_shape_aid_t*) (((char const*) path) + sizeof(TRI_shape_path_t));
 
   // and follow it
@@ -143,6 +148,15 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
             return false;
           }
 
+          if (lastFixed != SIZE_MAX) {
+            // offsets are relative to the begin of the previous range
+            auto b = (TRI_shape_size_t) (uintptr_t) ops._buffer[lastFixed + 1];
+
+            ops._buffer[lastFixed + 1] = (void*) (uintptr_t) (b + offsetsF[0]);
+            ops._buffer[lastFixed + 2] = (void*) (uintptr_t) (b + offsetsF[1]);
+            break;
+          }
+
           // reserve a block big enough to hold the following 3 entries plus the final AC_DONE entry
           int res = TRI_ReserveVectorPointer(&ops, 4);
 
@@ -153,6 +167,7 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
           }
 
           // this will always succeed as we reserve enough memory before
+          lastFixed = ops._length;
           TRI_PushBackVectorPointer(&ops, (void*) TRI_SHAPE_AC_OFFSET_FIX);
           TRI_PushBackVectorPointer(&ops, (void*) (uintptr_t) (offsetsF[0])); // offset is always smaller than 4 GByte
           TRI_PushBackVectorPointer(&ops, (void*) (uintptr_t) (offsetsF[1])); // offset is always smaller than 4 GByte
@@ -194,6 +209,7 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
           }
 
           // this will always succeed as we reserved enough memory in the vector before
+          lastFixed = SIZE_MAX;
           TRI_PushBackVectorPointer(&ops, (void*) TRI_SHAPE_AC_OFFSET_VAR);
           TRI_PushBackVectorPointer(&ops, (void*) j);
           break;
@@ -210,6 +226,7 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
     TRI_DestroyVectorPointer(&ops);
 
     accessor->_resultSid = TRI_SHAPE_ILLEGAL;
+    accessor->_resultShape = nullptr;
     accessor->_code = nullptr;
 
     return true;
@@ -219,8 +236,16 @@ static bool BytecodeShapeAccessor (VocShaper* shaper,
   // note that this must always succeed as we reserved enough space before
   TRI_PushBackVectorPointer(&ops, (void*) TRI_SHAPE_AC_DONE);
 
-  // remember resulting sid
+  // remember resulting shape. shapes are never freed while the shaper lives
   accessor->_resultSid = shape->_sid;
+  accessor->_resultShape = shape;
+
+  // a single fixed offset does not need to be interpreted
+  if (lastFixed == 0) {
+    accessor->_isFixed = true;
+    accessor->_fixedBegin = (TRI_shape_size_t) (uintptr_t) ops._buffer[1];
+    accessor->_fixedEnd = (TRI_shape_size_t) (uintptr_t) ops._buffer[2];
+  }
 
   // steal buffer from ops vector so we don't need to copy it
   accessor->_code = const_cast<void const**>(ops._buffer);
@@ -313,7 +338,11 @@ TRI_shape_access_t* TRI_ShapeAccessor (VocShaper* shaper,
 
   accessor->_sid = sid;
   accessor->_pid = pid;
+  accessor->_resultShape = nullptr;
   accessor->_code = nullptr;
+  accessor->_isFixed = false;
+  accessor->_fixedBegin = 0;
+  accessor->_fixedEnd = 0;
 
   bool ok = BytecodeShapeAccessor(shaper, accessor);
 
@@ -332,6 +361,14 @@ TRI_shape_access_t* TRI_ShapeAccessor (VocShaper* shaper,
 bool TRI_ExecuteShapeAccessor (TRI_shape_access_t const* accessor,
                                TRI_shaped_json_t const* shaped,
                                TRI_shaped_json_t* result) {
+  if (accessor->_isFixed) {
+    result->_sid         = accessor->_resultSid;
+    result->_data.data   = shaped->_data.data + accessor->_fixedBegin;
+    result->_data.length = (uint32_t) (accessor->_fixedEnd - accessor->_fixedBegin);
+
+    return true;
+  }
+
   void* begin = shaped->_data.data;
   void* end   = ((char*) begin) + shaped->_data.length;
 
@@ -366,6 +403,12 @@ void TRI_PrintShapeAccessor (TRI_shape_access_t* accessor) {
 
   printf("  result shape: %lu\n", (unsigned long) accessor->_resultSid);
 
+  if (accessor->_isFixed) {
+    printf("  fixed range %lu - %lu\n",
+           (unsigned long) accessor->_fixedBegin,
+           (unsigned long) accessor->_fixedEnd);
+  }
+
   void const** ops = static_cast<void const**>(accessor->_code);
 
   while (true) {
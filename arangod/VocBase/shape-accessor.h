@@ -49,7 +49,12 @@ typedef struct TRI_shape_access_s {
   TRI_shape_pid_t _pid;                 // path identifier of the attribute path
 
   TRI_shape_sid_t _resultSid;           // resulting shape
+  TRI_shape_t const* _resultShape;      // resulting shape, nullptr if the path does not exist
   void const** _code;                   // bytecode
+
+  bool _isFixed;                        // path resolves to a fixed byte range
+  TRI_shape_size_t _fixedBegin;         // begin of the byte range if fixed
+  TRI_shape_size_t _fixedEnd;           // end of the byte range if fixed
 }
 TRI_shape_access_t;
 
@@ -73,6 +78,9 @@ TRI_shape_access_t* TRI_ShapeAccessor (VocShaper* shaper,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief executes a shape accessor
+///
+/// Paths that only pass through fixed-size entries were compiled into a
+/// single byte range and are resolved without interpreting any bytecode.
 ////////////////////////////////////////////////////////////////////////////////
 
 bool TRI_ExecuteShapeAccessor (TRI_shape_access_t const* accessor,
@@ -35,6 +35,7 @@
 #include "Basics/string-buffer.h"
 #include "Basics/tri-strings.h"
 #include "Basics/vector.h"
+#include "JsonParser/json-scanner.h"
 #include "VocBase/Legends.h"
 #include "VocBase/VocShaper.h"
 
@@ -77,6 +78,38 @@ typedef struct shape_cache_s {
 }
 shape_cache_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state for shaping a json text
+////////////////////////////////////////////////////////////////////////////////
+
+struct shape_text_state_t {
+  VocShaper* _shaper;
+  TRI_json_scanner_t _scanner;
+  bool _create;
+
+  // converted values of all open objects and lists, innermost last
+  std::vector<TRI_shape_value_t> _values;
+
+  // scratch space for attribute names and the duplicate check
+  std::string _name;
+  std::vector<TRI_shape_aid_t> _aids;
+
+  // value of the top-level _key attribute
+  char* _key;
+  bool _keyBad;
+  bool _duplicate;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              forward declarations
+// -----------------------------------------------------------------------------
+
+static bool ShapeTextValue (shape_text_state_t*, 
+                            TRI_shape_value_t*, 
+                            int, 
+                            size_t, 
+                            bool);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -124,6 +157,13 @@ void TRI_PrintShape (VocShaper* shaper, TRI_shape_t const* shape, int indent) {
              (unsigned int) shape->_dataSize);
       break;
 
+    case TRI_SHAPE_DICTIONARY_STRING:
+      printf("%*sDICTIONARY STRING sid: %u, values: %u, data size: %u\n", indent, "",
+             (unsigned int) shape->_sid,
+             (unsigned int) ((TRI_dictionary_string_shape_t const*) shape)->_numberOfValues,
+             (unsigned int) shape->_dataSize);
+      break;
+
     case TRI_SHAPE_ARRAY: {
       TRI_array_shape_t const* array = (TRI_array_shape_t const*) shape;
       uint64_t n = array->_fixedEntries + array->_variableEntries;
@@ -270,6 +310,15 @@ static void PrintShapeValues (TRI_shape_value_t* values,
                p->_value + sizeof(TRI_shape_length_long_string_t));
         break;
 
+      case TRI_SHAPE_DICTIONARY_STRING:
+        printf("DICTIONARY STRING aid: %u, sid: %u, fixed: %s, size: %u, code: %u",
+               (unsigned int) p->_aid,
+               (unsigned int) p->_sid,
+               p->_fixedSized ? "yes" : "no",
+               (unsigned int) p->_size,
+               (unsigned int) *((TRI_shape_dictionary_code_t const*) p->_value));
+        break;
+
       case TRI_SHAPE_ARRAY:
         printf("ARRAY aid: %u, sid: %u, fixed: %s, size: %u",
                (unsigned int) p->_aid,
@@ -323,6 +372,7 @@ static int WeightShapeType (TRI_shape_type_t type) {
     case TRI_SHAPE_BOOLEAN:                return 200;
     case TRI_SHAPE_NUMBER:                 return 300;
     case TRI_SHAPE_SHORT_STRING:           return 400;
+    case TRI_SHAPE_DICTIONARY_STRING:      return 450;
     case TRI_SHAPE_LONG_STRING:            return 500;
     case TRI_SHAPE_HOMOGENEOUS_SIZED_LIST: return 600;
     case TRI_SHAPE_ARRAY:                  return 700;
@@ -360,11 +410,26 @@ static int SortShapeValuesFunc (void const* l, void const* r) {
   return (int) (left->_aid - right->_aid);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the data of shape values
+////////////////////////////////////////////////////////////////////////////////
+
+static void FreeShapeValues (TRI_memory_zone_t* zone,
+                             TRI_shape_value_t* values,
+                             TRI_shape_value_t* end) {
+  for (TRI_shape_value_t* p = values;  p < end;  ++p) {
+    if (p->_value != nullptr) {
+      TRI_Free(zone, p->_value);
+      p->_value = nullptr;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a null into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueNull (VocShaper* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueNull (VocShaper* shaper, TRI_shape_value_t* dst) {
   dst->_type = TRI_SHAPE_NULL;
   dst->_sid = BasicShapes::TRI_SHAPE_SID_NULL;
   dst->_fixedSized = true;
@@ -378,7 +443,7 @@ static bool FillShapeValueNull (VocShaper* shaper, TRI_shape_value_t* dst, TRI_j
 /// @brief converts a boolean into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueBoolean (VocShaper* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueBoolean (VocShaper* shaper, TRI_shape_value_t* dst, bool value) {
   TRI_shape_boolean_t* ptr;
 
   dst->_type = TRI_SHAPE_BOOLEAN;
@@ -392,7 +457,7 @@ static bool FillShapeValueBoolean (VocShaper* shaper, TRI_shape_value_t* dst, TR
     return false;
   }
 
-  *ptr = json->_value._boolean ? 1 : 0;
+  *ptr = value ? 1 : 0;
 
   return true;
 }
@@ -401,7 +466,7 @@ static bool FillShapeValueBoolean (VocShaper* shaper, TRI_shape_value_t* dst, TR
 /// @brief converts a number into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueNumber (VocShaper* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueNumber (VocShaper* shaper, TRI_shape_value_t* dst, double value) {
   TRI_shape_number_t* ptr;
 
   dst->_type = TRI_SHAPE_NUMBER;
@@ -414,19 +479,42 @@ static bool FillShapeValueNumber (VocShaper* shaper, TRI_shape_value_t* dst, TRI
     return false;
   }
 
-  *ptr = json->_value._number;
+  *ptr = value;
 
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a string into TRI_shape_value_t
+///
+/// The length does not include the terminating '\0', the data does not need
+/// to be terminated. Values from the string dictionary of the collection are
+/// stored as their code.
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueString (VocShaper* shaper, TRI_shape_value_t* dst, TRI_json_t const* json) {
+static bool FillShapeValueString (VocShaper* shaper,
+                                  TRI_shape_value_t* dst,
+                                  char const* data,
+                                  size_t length,
+                                  bool create) {
   char* ptr;
+  TRI_shape_sid_t sid;
+  TRI_shape_dictionary_code_t code;
+
+  if (shaper->lookupDictionaryCode(data, length, create, &sid, &code)) {
+    dst->_type = TRI_SHAPE_DICTIONARY_STRING;
+    dst->_sid = sid;
+    dst->_fixedSized = true;
+    dst->_size = sizeof(TRI_shape_dictionary_code_t);
+    dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, false)));
+
+    if (dst->_value == nullptr) {
+      return false;
+    }
 
-  if (json->_value._string.length <= TRI_SHAPE_SHORT_STRING_CUT) { // includes '\0'
+    * ((TRI_shape_dictionary_code_t*) ptr) = code;
+  }
+  else if (length + 1 <= TRI_SHAPE_SHORT_STRING_CUT) { // includes '\0'
     dst->_type = TRI_SHAPE_SHORT_STRING;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_SHORT_STRING;
     dst->_fixedSized = true;
@@ -439,42 +527,43 @@ static bool FillShapeValueString (VocShaper* shaper, TRI_shape_value_t* dst, TRI
       return false;
     }
 
-    * ((TRI_shape_length_short_string_t*) ptr) = json->_value._string.length;
+    * ((TRI_shape_length_short_string_t*) ptr) = (TRI_shape_length_short_string_t) (length + 1);
 
-    memcpy(ptr + sizeof(TRI_shape_length_short_string_t),
-           json->_value._string.data,
-           json->_value._string.length);
+    memcpy(ptr + sizeof(TRI_shape_length_short_string_t), data, length);
   }
   else {
     dst->_type = TRI_SHAPE_LONG_STRING;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_LONG_STRING;
     dst->_fixedSized = false;
-    dst->_size = sizeof(TRI_shape_length_long_string_t) + json->_value._string.length;
+    dst->_size = sizeof(TRI_shape_length_long_string_t) + length + 1;
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, false)));
 
     if (dst->_value == nullptr) {
       return false;
     }
 
-    * ((TRI_shape_length_long_string_t*) ptr) = json->_value._string.length;
+    * ((TRI_shape_length_long_string_t*) ptr) = (TRI_shape_length_long_string_t) (length + 1);
 
-    memcpy(ptr + sizeof(TRI_shape_length_long_string_t),
-           json->_value._string.data,
-           json->_value._string.length);
+    memcpy(ptr + sizeof(TRI_shape_length_long_string_t), data, length);
+    ptr[sizeof(TRI_shape_length_long_string_t) + length] = '\0';
   }
 
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief converts a json list into TRI_shape_value_t
+/// @brief builds a list TRI_shape_value_t from converted elements
+///
+/// total is the sum of the element sizes. The data of the elements is freed,
+/// the values array itself belongs to the caller.
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueList (VocShaper* shaper,
-                                TRI_shape_value_t* dst,
-                                TRI_json_t const* json,
-                                size_t level,
-                                bool create) {
+static bool FillShapeValueListValues (VocShaper* shaper,
+                                      TRI_shape_value_t* dst,
+                                      TRI_shape_value_t* values,
+                                      size_t n,
+                                      uint64_t total,
+                                      bool create) {
   TRI_shape_sid_t s;
   TRI_shape_sid_t l;
 
@@ -482,13 +571,10 @@ static bool FillShapeValueList (VocShaper* shaper,
   TRI_shape_size_t offset;
 
   char* ptr;
-
-  // sanity checks
-  TRI_ASSERT(json->_type == TRI_JSON_ARRAY);
+  TRI_shape_value_t* p;
+  TRI_shape_value_t* const e = values + n; // end does not change
 
   // check for special case "empty list"
-  size_t const n = TRI_LengthArrayJson(json);
-
   if (n == 0) {
     dst->_type = TRI_SHAPE_LIST;
     dst->_sid = BasicShapes::TRI_SHAPE_SID_LIST;
@@ -504,44 +590,6 @@ static bool FillShapeValueList (VocShaper* shaper,
 
     return true;
   }
-  
-  // helper function to free shape values
-  auto freeShapeValues = [] (TRI_memory_zone_t* zone, TRI_shape_value_t* values, TRI_shape_value_t* end) {
-    TRI_shape_value_t* p = values;
-    TRI_shape_value_t* e = end;
-
-    for (;  p < e;  ++p) {
-      if (p->_value != nullptr) {
-        TRI_Free(zone, p->_value);
-      }
-    }
-
-    TRI_Free(zone, values);
-  };
-  
-
-  // convert into TRI_shape_value_t array
-  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->memoryZone(), sizeof(TRI_shape_value_t) * n, true));
-
-  if (values == nullptr) {
-    return false;
-  }
-
-  uint64_t total = 0;
-
-  TRI_shape_value_t* p = values;
-
-  for (size_t i = 0;  i < n;  ++i, ++p) {
-    TRI_json_t const* el = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
-    bool ok = FillShapeValueJson(shaper, p, el, level + 1, create);
-
-    if (! ok) {
-      freeShapeValues(shaper->memoryZone(), values, p);
-      return false;
-    }
-
-    total += p->_size;
-  }
 
   // check if this list is homogeneous
   bool hs = true;
@@ -550,10 +598,7 @@ static bool FillShapeValueList (VocShaper* shaper,
   s = values[0]._sid;
   l = values[0]._size;
   
-  p = values;
-  TRI_shape_value_t* const e = values + n; // end does not change
-
-  for (;  p < e;  ++p) {
+  for (p = values;  p < e;  ++p) {
     if (p->_sid != s) {
       hs = false;
       break;
@@ -569,7 +614,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     TRI_homogeneous_sized_list_shape_t* shape = static_cast<TRI_homogeneous_sized_list_shape_t*>(TRI_Allocate(shaper->memoryZone(), sizeof(TRI_homogeneous_sized_list_shape_t), true));
 
     if (shape == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       return false;
     }
 
@@ -583,7 +628,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     TRI_shape_t const* found = shaper->findShape(&shape->base, create);
 
     if (found == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       TRI_Free(shaper->memoryZone(), shape);
       return false;
     }
@@ -598,7 +643,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       return false;
     }
 
@@ -617,7 +662,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     TRI_homogeneous_list_shape_t* shape = static_cast<TRI_homogeneous_list_shape_t*>(TRI_Allocate(shaper->memoryZone(), sizeof(TRI_homogeneous_list_shape_t), true));
 
     if (shape == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       return false;
     }
 
@@ -630,7 +675,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     TRI_shape_t const* found = shaper->findShape(&shape->base, create);
 
     if (found == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       TRI_Free(shaper->memoryZone(), shape);
       return false;
     }
@@ -647,7 +692,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       return false;
     }
 
@@ -684,7 +729,7 @@ static bool FillShapeValueList (VocShaper* shaper,
     dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, true)));
 
     if (dst->_value == nullptr) {
-      freeShapeValues(shaper->memoryZone(), values, e);
+      FreeShapeValues(shaper->memoryZone(), values, e);
       return false;
     }
 
@@ -711,127 +756,87 @@ static bool FillShapeValueList (VocShaper* shaper,
     *offsets = offset;
   }
 
-  // free TRI_shape_value_t array
-  freeShapeValues(shaper->memoryZone(), values, e);
+  FreeShapeValues(shaper->memoryZone(), values, e);
   return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief converts a json array into TRI_shape_value_t
+/// @brief converts a json list into TRI_shape_value_t
 ////////////////////////////////////////////////////////////////////////////////
 
-static bool FillShapeValueArray (VocShaper* shaper,
-                                 TRI_shape_value_t* dst,
-                                 TRI_json_t const* json,
-                                 size_t level,
-                                 bool create) {
-  TRI_shape_sid_t* sids;
-  TRI_shape_aid_t* aids;
-  TRI_shape_size_t* offsetsF;
-  TRI_shape_size_t* offsetsV;
-  TRI_shape_size_t offset;
-
-  char* ptr;
-
+static bool FillShapeValueList (VocShaper* shaper,
+                                TRI_shape_value_t* dst,
+                                TRI_json_t const* json,
+                                size_t level,
+                                bool create) {
   // sanity checks
-  TRI_ASSERT(json->_type == TRI_JSON_OBJECT);
-  TRI_ASSERT(TRI_LengthVector(&json->_value._objects) % 2 == 0);
+  TRI_ASSERT(json->_type == TRI_JSON_ARRAY);
 
-  // number of attributes
-  size_t n = TRI_LengthVector(&json->_value._objects) / 2;
+  size_t const n = TRI_LengthArrayJson(json);
+
+  if (n == 0) {
+    return FillShapeValueListValues(shaper, dst, nullptr, 0, 0, create);
+  }
 
   // convert into TRI_shape_value_t array
-  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->memoryZone(), n * sizeof(TRI_shape_value_t), true));
+  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->memoryZone(), sizeof(TRI_shape_value_t) * n, true));
 
   if (values == nullptr) {
     return false;
   }
-  
-  
-  // helper function to free shape values
-  auto freeShapeValues = [] (TRI_memory_zone_t* zone, TRI_shape_value_t* values, TRI_shape_value_t* end) {
-    TRI_shape_value_t* p = values;
-    TRI_shape_value_t* e = end;
-
-    for (;  p < e;  ++p) {
-      if (p->_value != nullptr) {
-        TRI_Free(zone, p->_value);
-      }
-    }
-
-    TRI_Free(zone, values);
-  };
-
 
   uint64_t total = 0;
-  size_t f = 0;
-  size_t v = 0;
 
   TRI_shape_value_t* p = values;
 
   for (size_t i = 0;  i < n;  ++i, ++p) {
-    TRI_json_t const* key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i));
-    TRI_ASSERT(key != nullptr);
-    TRI_ASSERT(key->_type == TRI_JSON_STRING);
-
-    char const* k = key->_value._string.data;
-
-    if (k == nullptr ||
-        key->_value._string.length == 1) {
-      // empty attribute name
-      p--;
-      continue;
-    }
+    TRI_json_t const* el = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+    bool ok = FillShapeValueJson(shaper, p, el, level + 1, create);
 
-    if (*k == '_' && level == 0) {
-      // on top level, strip reserved attributes before shaping
-      if (strcmp(k, "_key") == 0 || 
-          strcmp(k, "_rev") == 0 ||
-          strcmp(k, "_id") == 0 ||
-          strcmp(k, "_from") == 0 ||
-          strcmp(k, "_to") == 0) {
-        // found a reserved attribute - discard it
-        --p;
-        continue;
-      }
+    if (! ok) {
+      FreeShapeValues(shaper->memoryZone(), values, p);
+      TRI_Free(shaper->memoryZone(), values);
+      return false;
     }
 
-    // first find an identifier for the name
-    p->_aid = shaper->findOrCreateAttributeByName(k);
+    total += p->_size;
+  }
 
-    // convert value
-    bool ok;
-    if (p->_aid == 0) {
-      ok = false;
-    }
-    else {
-      auto val = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i + 1));
-      TRI_ASSERT(val != nullptr);
+  bool ok = FillShapeValueListValues(shaper, dst, values, n, total, create);
 
-      ok = FillShapeValueJson(shaper, p, val, level + 1, create);
-    }
+  // free TRI_shape_value_t array
+  TRI_Free(shaper->memoryZone(), values);
+  return ok;
+}
 
-    if (! ok) {
-      freeShapeValues(shaper->memoryZone(), values, p);
-      return false;
-    }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief builds an array TRI_shape_value_t from converted attributes
+///
+/// f and v are the numbers of fixed and variable sized attributes and total
+/// is the sum of their sizes. The data of the attributes is freed, the values
+/// array itself belongs to the caller.
+////////////////////////////////////////////////////////////////////////////////
 
-    total += p->_size;
+static bool FillShapeValueArrayValues (VocShaper* shaper,
+                                       TRI_shape_value_t* dst,
+                                       TRI_shape_value_t* values,
+                                       size_t f,
+                                       size_t v,
+                                       uint64_t total,
+                                       bool create) {
+  TRI_shape_sid_t* sids;
+  TRI_shape_aid_t* aids;
+  TRI_shape_size_t* offsetsF;
+  TRI_shape_size_t* offsetsV;
+  TRI_shape_size_t offset;
 
-    // count fixed and variable sized values
-    if (p->_fixedSized) {
-      ++f;
-    }
-    else {
-      ++v;
-    }
-  }
+  char* ptr;
+  TRI_shape_value_t* p;
 
   // add variable offset table size
   total += (v + 1) * sizeof(TRI_shape_size_t);
 
-  // now adjust n because we might have excluded empty attributes
-  n = f + v;
+  size_t const n = f + v;
 
   // now sort the shape entries
   if (n > 1) {
@@ -857,7 +862,7 @@ static bool FillShapeValueArray (VocShaper* shaper,
   TRI_array_shape_t* a = reinterpret_cast<TRI_array_shape_t*>(ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), byteSize, true)));
 
   if (ptr == nullptr) {
-    freeShapeValues(shaper->memoryZone(), values, values + n);
+    FreeShapeValues(shaper->memoryZone(), values, values + n);
     return false;
   }
 
@@ -890,7 +895,7 @@ static bool FillShapeValueArray (VocShaper* shaper,
   dst->_value = (ptr = static_cast<char*>(TRI_Allocate(shaper->memoryZone(), dst->_size, true)));
 
   if (ptr == nullptr) {
-    freeShapeValues(shaper->memoryZone(), values, values + n);
+    FreeShapeValues(shaper->memoryZone(), values, values + n);
     TRI_Free(shaper->memoryZone(), a);
     return false;
   }
@@ -923,14 +928,14 @@ static bool FillShapeValueArray (VocShaper* shaper,
     }
   }
 
-  // free TRI_shape_value_t array
-  freeShapeValues(shaper->memoryZone(), values, e);
+  FreeShapeValues(shaper->memoryZone(), values, e);
 
   // lookup this shape
   TRI_shape_t const* found = shaper->findShape(&a->base, create);
 
   if (found == nullptr) {
     TRI_Free(shaper->memoryZone(), dst->_value);
+    dst->_value = nullptr;
     TRI_Free(shaper->memoryZone(), a);
     return false;
   }
@@ -940,39 +945,495 @@ static bool FillShapeValueArray (VocShaper* shaper,
   return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief converts a json object into TRI_shape_value_t
-////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json array into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FillShapeValueArray (VocShaper* shaper,
+                                 TRI_shape_value_t* dst,
+                                 TRI_json_t const* json,
+                                 size_t level,
+                                 bool create) {
+  // sanity checks
+  TRI_ASSERT(json->_type == TRI_JSON_OBJECT);
+  TRI_ASSERT(TRI_LengthVector(&json->_value._objects) % 2 == 0);
+
+  // number of attributes
+  size_t n = TRI_LengthVector(&json->_value._objects) / 2;
+
+  // convert into TRI_shape_value_t array
+  TRI_shape_value_t* values = static_cast<TRI_shape_value_t*>(TRI_Allocate(shaper->memoryZone(), n * sizeof(TRI_shape_value_t), true));
+
+  if (values == nullptr) {
+    return false;
+  }
+
+  uint64_t total = 0;
+  size_t f = 0;
+  size_t v = 0;
+
+  TRI_shape_value_t* p = values;
+
+  for (size_t i = 0;  i < n;  ++i, ++p) {
+    TRI_json_t const* key = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i));
+    TRI_ASSERT(key != nullptr);
+    TRI_ASSERT(key->_type == TRI_JSON_STRING);
+
+    char const* k = key->_value._string.data;
+
+    if (k == nullptr ||
+        key->_value._string.length == 1) {
+      // empty attribute name
+      p--;
+      continue;
+    }
+
+    if (*k == '_' && level == 0) {
+      // on top level, strip reserved attributes before shaping
+      if (strcmp(k, "_key") == 0 || 
+          strcmp(k, "_rev") == 0 ||
+          strcmp(k, "_id") == 0 ||
+          strcmp(k, "_from") == 0 ||
+          strcmp(k, "_to") == 0) {
+        // found a reserved attribute - discard it
+        --p;
+        continue;
+      }
+    }
+
+    // first find an identifier for the name
+    p->_aid = shaper->findOrCreateAttributeByName(k);
+
+    // convert value
+    bool ok;
+    if (p->_aid == 0) {
+      ok = false;
+    }
+    else {
+      auto val = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, 2 * i + 1));
+      TRI_ASSERT(val != nullptr);
+
+      ok = FillShapeValueJson(shaper, p, val, level + 1, create);
+    }
+
+    if (! ok) {
+      FreeShapeValues(shaper->memoryZone(), values, p);
+      TRI_Free(shaper->memoryZone(), values);
+      return false;
+    }
+
+    total += p->_size;
+
+    // count fixed and variable sized values
+    if (p->_fixedSized) {
+      ++f;
+    }
+    else {
+      ++v;
+    }
+  }
+
+  bool ok = FillShapeValueArrayValues(shaper, dst, values, f, v, total, create);
+
+  // free TRI_shape_value_t array
+  TRI_Free(shaper->memoryZone(), values);
+  return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json object into TRI_shape_value_t
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FillShapeValueJson (VocShaper* shaper,
+                                TRI_shape_value_t* dst,
+                                TRI_json_t const* json,
+                                size_t level,
+                                bool create) {
+  switch (json->_type) {
+    case TRI_JSON_UNUSED:
+      return false;
+
+    case TRI_JSON_NULL:
+      return FillShapeValueNull(shaper, dst);
+
+    case TRI_JSON_BOOLEAN:
+      return FillShapeValueBoolean(shaper, dst, json->_value._boolean);
+
+    case TRI_JSON_NUMBER:
+      return FillShapeValueNumber(shaper, dst, json->_value._number);
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE:
+      return FillShapeValueString(shaper, dst, json->_value._string.data, json->_value._string.length - 1, create);
+
+    case TRI_JSON_OBJECT:
+      return FillShapeValueArray(shaper, dst, json, level, create);
+
+    case TRI_JSON_ARRAY:
+      return FillShapeValueList(shaper, dst, json, level, create);
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief top-level attributes which are stripped before shaping
+////////////////////////////////////////////////////////////////////////////////
+
+static int ReservedAttribute (char const* name) {
+  if (*name != '_') {
+    return 0;
+  }
+
+  if (strcmp(name, "_key") == 0) {
+    return 2;
+  }
+  if (strcmp(name, "_rev") == 0) {
+    return 4;
+  }
+  if (strcmp(name, "_id") == 0) {
+    return 8;
+  }
+  if (strcmp(name, "_from") == 0) {
+    return 16;
+  }
+  if (strcmp(name, "_to") == 0) {
+    return 32;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief copies the current string token, unescaping it if necessary
+////////////////////////////////////////////////////////////////////////////////
+
+static char* CopyStringToken (TRI_memory_zone_t* zone,
+                              TRI_json_scanner_t const* scanner,
+                              int c,
+                              size_t* length) {
+  if (c == TRI_JSON_TOKEN_STRING_ASCII) {
+    *length = scanner->_tokenLength - 2;
+    return TRI_DuplicateString2Z(zone, scanner->_token + 1, *length);
+  }
+
+  return TRI_UnescapeUtf8String(zone, scanner->_token + 1, scanner->_tokenLength - 2, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shapes a list from a json text
+///
+/// If dst is a nullptr, the list is only validated.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ShapeTextList (shape_text_state_t* state,
+                           TRI_shape_value_t* dst,
+                           size_t level) {
+  TRI_json_scanner_t* scanner = &state->_scanner;
+  size_t const start = state->_values.size();
+  uint64_t total = 0;
+
+  int c = TRI_NextJsonScanner(scanner);
+  bool comma = false;
+
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACKET) {
+      if (dst == nullptr) {
+        return true;
+      }
+
+      bool ok = FillShapeValueListValues(state->_shaper, dst, state->_values.data() + start, state->_values.size() - start, total, state->_create);
+      state->_values.resize(start);
+
+      return ok;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
+        break;
+      }
+
+      c = TRI_NextJsonScanner(scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    TRI_shape_value_t value;
+    value._value = nullptr;
+
+    if (! ShapeTextValue(state, dst == nullptr ? nullptr : &value, c, level + 1, false)) {
+      FreeShapeValues(state->_shaper->memoryZone(), state->_values.data() + start, state->_values.data() + state->_values.size());
+      state->_values.resize(start);
+      return false;
+    }
+
+    if (dst != nullptr) {
+      state->_values.push_back(value);
+      total += value._size;
+    }
+
+    c = TRI_NextJsonScanner(scanner);
+  }
+
+  if (c == TRI_JSON_TOKEN_END_OF_FILE) {
+    scanner->_message = "expecting a list element, got end-of-file";
+  }
+
+  FreeShapeValues(state->_shaper->memoryZone(), state->_values.data() + start, state->_values.data() + state->_values.size());
+  state->_values.resize(start);
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shapes an object from a json text
+///
+/// If dst is a nullptr, the object is only validated. Duplicate attribute
+/// names are checked for the same objects as TRI_HasDuplicateKeyJson does,
+/// i. e. not inside lists.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ShapeTextObject (shape_text_state_t* state,
+                             TRI_shape_value_t* dst,
+                             size_t level,
+                             bool checkDuplicates) {
+  VocShaper* shaper = state->_shaper;
+  TRI_json_scanner_t* scanner = &state->_scanner;
+  size_t const start = state->_values.size();
+  uint64_t total = 0;
+  size_t f = 0;
+  size_t v = 0;
+
+  // empty and reserved attribute names seen, these are not shaped
+  int seen = 0;
+
+  // names of an object which is only validated, these have no attribute ids
+  std::vector<std::string> names;
+
+  int c = TRI_NextJsonScanner(scanner);
+  bool comma = false;
+
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACE) {
+      if (dst == nullptr) {
+        if (checkDuplicates && names.size() > 1) {
+          std::sort(names.begin(), names.end());
+
+          if (std::adjacent_find(names.begin(), names.end()) != names.end()) {
+            state->_duplicate = true;
+          }
+        }
+
+        return true;
+      }
+
+      TRI_shape_value_t* values = state->_values.data() + start;
+      size_t const n = state->_values.size() - start;
+
+      if (checkDuplicates && n > 1) {
+        state->_aids.clear();
+
+        for (size_t i = 0;  i < n;  ++i) {
+          state->_aids.push_back(values[i]._aid);
+        }
+
+        std::sort(state->_aids.begin(), state->_aids.end());
+
+        if (std::adjacent_find(state->_aids.begin(), state->_aids.end()) != state->_aids.end()) {
+          state->_duplicate = true;
+        }
+      }
+
+      bool ok = FillShapeValueArrayValues(shaper, dst, values, f, v, total, state->_create);
+      state->_values.resize(start);
+
+      return ok;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        scanner->_message = "expecting comma";
+        break;
+      }
+
+      c = TRI_NextJsonScanner(scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    // attribute name, terminated for the shaper
+    if (c == TRI_JSON_TOKEN_STRING_ASCII) {
+      state->_name.assign(scanner->_token + 1, scanner->_tokenLength - 2);
+    }
+    else if (c == TRI_JSON_TOKEN_STRING) {
+      size_t length;
+      char* name = TRI_UnescapeUtf8String(shaper->memoryZone(), scanner->_token + 1, scanner->_tokenLength - 2, &length);
+
+      if (name == nullptr) {
+        scanner->_message = "out-of-memory";
+        break;
+      }
+
+      state->_name.assign(name, length);
+      TRI_FreeString(shaper->memoryZone(), name);
+    }
+    else {
+      scanner->_message = "expecting attribute name";
+      break;
+    }
+
+    c = TRI_NextJsonScanner(scanner);
+
+    if (c != TRI_JSON_TOKEN_COLON) {
+      scanner->_message = "expecting colon";
+      break;
+    }
+
+    c = TRI_NextJsonScanner(scanner);
+
+    char const* name = state->_name.c_str();
+    int skip = 0;
+
+    if (*name == '\0') {
+      skip = 1;
+    }
+    else if (level == 0) {
+      skip = ReservedAttribute(name);
+
+      if (skip == 2 && (seen & 2) == 0) {
+        if (c == TRI_JSON_TOKEN_STRING || c == TRI_JSON_TOKEN_STRING_ASCII) {
+          size_t length;
+          state->_key = CopyStringToken(TRI_CORE_MEM_ZONE, scanner, c, &length);
+
+          if (state->_key == nullptr) {
+            break;
+          }
+        }
+        else {
+          state->_keyBad = true;
+        }
+      }
+    }
+
+    bool ok;
+
+    if (skip != 0) {
+      if (checkDuplicates && (seen & skip) != 0) {
+        state->_duplicate = true;
+      }
+
+      seen |= skip;
+
+      ok = ShapeTextValue(state, nullptr, c, level + 1, checkDuplicates);
+    }
+    else if (dst == nullptr) {
+      if (checkDuplicates) {
+        names.emplace_back(state->_name);
+      }
+
+      ok = ShapeTextValue(state, nullptr, c, level + 1, checkDuplicates);
+    }
+    else {
+      TRI_shape_value_t value;
+      value._value = nullptr;
+      value._aid = shaper->findOrCreateAttributeByName(name);
+
+      ok = (value._aid != 0 && ShapeTextValue(state, &value, c, level + 1, checkDuplicates));
+
+      if (ok) {
+        state->_values.push_back(value);
+        total += value._size;
+
+        // count fixed and variable sized values
+        if (value._fixedSized) {
+          ++f;
+        }
+        else {
+          ++v;
+        }
+      }
+    }
+
+    if (! ok) {
+      break;
+    }
+
+    c = TRI_NextJsonScanner(scanner);
+  }
+
+  if (c == TRI_JSON_TOKEN_END_OF_FILE && scanner->_message == nullptr) {
+    scanner->_message = "expecting a object attribute name or element, got end-of-file";
+  }
+
+  FreeShapeValues(shaper->memoryZone(), state->_values.data() + start, state->_values.data() + state->_values.size());
+  state->_values.resize(start);
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief shapes a value from a json text
+///
+/// If dst is a nullptr, the value is only validated.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ShapeTextValue (shape_text_state_t* state,
+                            TRI_shape_value_t* dst,
+                            int c,
+                            size_t level,
+                            bool checkDuplicates) {
+  TRI_json_scanner_t* scanner = &state->_scanner;
+
+  switch (c) {
+    case TRI_JSON_TOKEN_FALSE:
+    case TRI_JSON_TOKEN_TRUE:
+      return dst == nullptr || FillShapeValueBoolean(state->_shaper, dst, c == TRI_JSON_TOKEN_TRUE);
+
+    case TRI_JSON_TOKEN_NULL:
+      return dst == nullptr || FillShapeValueNull(state->_shaper, dst);
+
+    case TRI_JSON_TOKEN_NUMBER: {
+      double value;
+
+      if (! TRI_NumberJsonScanner(scanner, &value)) {
+        return false;
+      }
+
+      return dst == nullptr || FillShapeValueNumber(state->_shaper, dst, value);
+    }
 
-static bool FillShapeValueJson (VocShaper* shaper,
-                                TRI_shape_value_t* dst,
-                                TRI_json_t const* json,
-                                size_t level,
-                                bool create) {
-  switch (json->_type) {
-    case TRI_JSON_UNUSED:
-      return false;
+    case TRI_JSON_TOKEN_STRING_ASCII:
+      return dst == nullptr || FillShapeValueString(state->_shaper, dst, scanner->_token + 1, scanner->_tokenLength - 2, state->_create);
 
-    case TRI_JSON_NULL:
-      return FillShapeValueNull(shaper, dst, json);
+    case TRI_JSON_TOKEN_STRING: {
+      if (dst == nullptr) {
+        return true;
+      }
 
-    case TRI_JSON_BOOLEAN:
-      return FillShapeValueBoolean(shaper, dst, json);
+      size_t length;
+      char* value = TRI_UnescapeUtf8String(state->_shaper->memoryZone(), scanner->_token + 1, scanner->_tokenLength - 2, &length);
 
-    case TRI_JSON_NUMBER:
-      return FillShapeValueNumber(shaper, dst, json);
+      if (value == nullptr) {
+        return false;
+      }
 
-    case TRI_JSON_STRING:
-    case TRI_JSON_STRING_REFERENCE:
-      return FillShapeValueString(shaper, dst, json);
+      bool ok = FillShapeValueString(state->_shaper, dst, value, length, state->_create);
+      TRI_FreeString(state->_shaper->memoryZone(), value);
 
-    case TRI_JSON_OBJECT:
-      return FillShapeValueArray(shaper, dst, json, level, create);
+      return ok;
+    }
 
-    case TRI_JSON_ARRAY:
-      return FillShapeValueList(shaper, dst, json, level, create);
+    case TRI_JSON_TOKEN_OPEN_BRACE:
+      return ShapeTextObject(state, dst, level, checkDuplicates);
+
+    case TRI_JSON_TOKEN_OPEN_BRACKET:
+      return ShapeTextList(state, dst, level);
   }
 
+  TRI_UnexpectedJsonScanner(scanner, c);
   return false;
 }
 
@@ -1033,6 +1494,27 @@ static inline int JsonShapeDataLongString (VocShaper* shaper,
   return TRI_InitStringCopyJson(shaper->memoryZone(), dst, data, static_cast<size_t>(l - 1));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a data dictionary string blob into a json object
+////////////////////////////////////////////////////////////////////////////////
+
+static inline int JsonShapeDataDictionaryString (VocShaper* shaper,
+                                                 TRI_shape_t const* shape,
+                                                 TRI_json_t* dst,
+                                                 char const* data) {
+  char const* value;
+  size_t length;
+
+  if (! TRI_ValueDictionaryStringShape((TRI_dictionary_string_shape_t const*) shape,
+                                       * (TRI_shape_dictionary_code_t const*) data,
+                                       &value,
+                                       &length)) {
+    return TRI_ERROR_INTERNAL;
+  }
+
+  return TRI_InitStringCopyJson(shaper->memoryZone(), dst, value, length);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a data array blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -1378,6 +1860,9 @@ static int JsonShapeData (VocShaper* shaper,
     case TRI_SHAPE_LONG_STRING:
       return JsonShapeDataLongString(shaper, dst, data);
 
+    case TRI_SHAPE_DICTIONARY_STRING:
+      return JsonShapeDataDictionaryString(shaper, shape, dst, data);
+
     case TRI_SHAPE_ARRAY:
       return JsonShapeDataArray(shaper, shape, dst, data, size);
 
@@ -1552,6 +2037,128 @@ static bool StringifyJsonShapeDataLongString (T* shaper,
   return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stringifies a data dictionary string blob into a json object
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static bool StringifyJsonShapeDataDictionaryString (T* shaper,
+                                                    TRI_string_buffer_t* buffer,
+                                                    TRI_shape_t const* shape,
+                                                    char const* data,
+                                                    uint64_t size) {
+  TRI_ASSERT(sizeof(TRI_shape_dictionary_code_t) <= size);
+
+  char const* value;
+  size_t length;
+
+  if (! TRI_ValueDictionaryStringShape((TRI_dictionary_string_shape_t const*) shape,
+                                       * (TRI_shape_dictionary_code_t const*) data,
+                                       &value,
+                                       &length)) {
+    return false;
+  }
+
+  int res = TRI_AppendCharStringBuffer(buffer, '"');
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  res = TRI_AppendJsonEncodedStringStringBuffer(buffer, value, length, true);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  res = TRI_AppendCharStringBuffer(buffer, '"');
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up the stringification template of an array shape
+///
+/// Only a VocShaper keeps templates, other shapers always print attribute by
+/// attribute.
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static inline TRI_shape_template_t const* LookupShapeTemplate (T* shaper,
+                                                               TRI_shape_t const* shape) {
+  return nullptr;
+}
+
+static inline TRI_shape_template_t const* LookupShapeTemplate (VocShaper* shaper,
+                                                               TRI_shape_t const* shape) {
+  return shaper->findShapeTemplate(shape);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stringifies the attributes of a data array blob using a template
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+static bool StringifyJsonShapeDataTemplate (T* shaper,
+                                            TRI_string_buffer_t* buffer,
+                                            TRI_shape_template_t const* tpl,
+                                            TRI_shape_t const* shape,
+                                            char const* data) {
+  TRI_array_shape_t const* s = (TRI_array_shape_t const*) shape;
+  TRI_shape_size_t const f = s->_fixedEntries;
+  TRI_shape_size_t const n = tpl->_numEntries;
+
+  TRI_shape_size_t const* offsetsF = (TRI_shape_size_t const*) ((char const*) shape
+                                                                + sizeof(TRI_array_shape_t)
+                                                                + n * sizeof(TRI_shape_sid_t)
+                                                                + n * sizeof(TRI_shape_aid_t));
+  TRI_shape_size_t const* offsetsV = (TRI_shape_size_t const*) data;
+  bool first = true;
+
+  for (TRI_shape_size_t i = 0;  i < n;  ++i) {
+    TRI_shape_size_t offset;
+    TRI_shape_size_t end;
+
+    if (i < f) {
+      offset = offsetsF[i];
+      end = offsetsF[i + 1];
+    }
+    else {
+      offset = offsetsV[i - f];
+      end = offsetsV[i - f + 1];
+    }
+
+    char const* name = tpl->_names + tpl->_offsets[i];
+    size_t length = tpl->_offsets[i + 1] - tpl->_offsets[i];
+
+    // the names include the separating comma
+    if (first) {
+      first = false;
+      ++name;
+      --length;
+    }
+
+    int res = TRI_AppendString2StringBuffer(buffer, name, length);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return false;
+    }
+
+    bool ok = StringifyJsonShapeData<T>(shaper, buffer, tpl->_shapes[i], data + offset, end - offset);
+
+    if (! ok) {
+      LOG_WARNING("cannot decode element for shape #%u", (unsigned int) tpl->_shapes[i]->_sid);
+      continue;
+    }
+  }
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief stringifies a data array blob into a json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -1608,6 +2215,24 @@ static bool StringifyJsonShapeDataArray (T* shaper,
 
   offsetsF = (TRI_shape_size_t const*) qtr;
 
+  TRI_shape_template_t const* tpl = LookupShapeTemplate(shaper, shape);
+
+  if (tpl != nullptr) {
+    if (! StringifyJsonShapeDataTemplate<T>(shaper, buffer, tpl, shape, data)) {
+      return false;
+    }
+
+    if (braces) {
+      res = TRI_AppendCharStringBuffer(buffer, '}');
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   shapeCache._sid   = 0;
   shapeCache._shape = nullptr;
 
@@ -2030,6 +2655,9 @@ static bool StringifyJsonShapeData (T* shaper,
     case TRI_SHAPE_LONG_STRING:
       return StringifyJsonShapeDataLongString<T>(shaper, buffer, shape, data, size);
 
+    case TRI_SHAPE_DICTIONARY_STRING:
+      return StringifyJsonShapeDataDictionaryString<T>(shaper, buffer, shape, data, size);
+
     case TRI_SHAPE_ARRAY:
       return StringifyJsonShapeDataArray<T>(shaper, buffer, shape, data, size, true, nullptr);
 
@@ -2069,6 +2697,174 @@ void TRI_FreeShapedJson (TRI_memory_zone_t* zone,
   TRI_Free(zone, shaped);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the stringification template of an array shape
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_template_t* TRI_CreateShapeTemplate (VocShaper* shaper,
+                                               TRI_shape_t const* shape) {
+  if (shape == nullptr || shape->_type != TRI_SHAPE_ARRAY) {
+    return nullptr;
+  }
+
+  TRI_array_shape_t const* s = (TRI_array_shape_t const*) shape;
+  TRI_shape_size_t const n = s->_fixedEntries + s->_variableEntries;
+
+  char const* qtr = (char const*) shape + sizeof(TRI_array_shape_t);
+  TRI_shape_sid_t const* sids = (TRI_shape_sid_t const*) qtr;
+  TRI_shape_aid_t const* aids = (TRI_shape_aid_t const*) (qtr + n * sizeof(TRI_shape_sid_t));
+
+  // encode the names first, the allocation needs their total length
+  std::vector<TRI_shape_t const*> shapes;
+  std::vector<uint32_t> offsets;
+  shapes.reserve(n);
+  offsets.reserve(n + 1);
+
+  TRI_string_buffer_t buffer;
+  TRI_InitStringBuffer(&buffer, TRI_UNKNOWN_MEM_ZONE);
+
+  bool ok = true;
+
+  for (TRI_shape_size_t i = 0;  i < n;  ++i) {
+    TRI_shape_t const* subshape = shaper->lookupShapeId(sids[i]);
+    char const* name = shaper->lookupAttributeId(aids[i]);
+
+    if (subshape == nullptr || name == nullptr) {
+      ok = false;
+      break;
+    }
+
+    shapes.push_back(subshape);
+    offsets.push_back(static_cast<uint32_t>(TRI_LengthStringBuffer(&buffer)));
+
+    if (TRI_AppendString2StringBuffer(&buffer, ",\"", 2) != TRI_ERROR_NO_ERROR ||
+        TRI_AppendJsonEncodedStringStringBuffer(&buffer, name, true) != TRI_ERROR_NO_ERROR ||
+        TRI_AppendString2StringBuffer(&buffer, "\":", 2) != TRI_ERROR_NO_ERROR) {
+      ok = false;
+      break;
+    }
+  }
+
+  TRI_shape_template_t* tpl = nullptr;
+
+  if (ok) {
+    size_t const length = TRI_LengthStringBuffer(&buffer);
+    offsets.push_back(static_cast<uint32_t>(length));
+
+    // one allocation for the template, the shapes, the offsets and the names
+    size_t const shapesSize = n * sizeof(TRI_shape_t const*);
+    size_t const offsetsSize = (n + 1) * sizeof(uint32_t);
+
+    char* ptr = static_cast<char*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_shape_template_t) + shapesSize + offsetsSize + length, false));
+
+    if (ptr != nullptr) {
+      tpl = reinterpret_cast<TRI_shape_template_t*>(ptr);
+      tpl->_sid = shape->_sid;
+      tpl->_numEntries = n;
+      tpl->_shapes = reinterpret_cast<TRI_shape_t const**>(ptr + sizeof(TRI_shape_template_t));
+      tpl->_offsets = reinterpret_cast<uint32_t*>(ptr + sizeof(TRI_shape_template_t) + shapesSize);
+      tpl->_names = ptr + sizeof(TRI_shape_template_t) + shapesSize + offsetsSize;
+
+      if (n > 0) {
+        memcpy(tpl->_shapes, shapes.data(), shapesSize);
+      }
+
+      memcpy(tpl->_offsets, offsets.data(), offsetsSize);
+
+      if (length > 0) {
+        memcpy(tpl->_names, TRI_BeginStringBuffer(&buffer), length);
+      }
+    }
+  }
+
+  TRI_DestroyStringBuffer(&buffer);
+
+  return tpl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a stringification template
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeShapeTemplate (TRI_shape_template_t* tpl) {
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, tpl);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the dictionary string shape for a list of string values
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_t* TRI_CreateDictionaryStringShape (TRI_json_t const* json) {
+  if (! TRI_IsArrayJson(json)) {
+    return nullptr;
+  }
+
+  size_t const n = TRI_LengthArrayJson(json);
+
+  if (n == 0 || n > TRI_SHAPE_DICTIONARY_MAX_VALUES) {
+    return nullptr;
+  }
+
+  // drop duplicates, the first occurrence of a value determines its code
+  std::vector<TRI_json_t const*> values;
+  std::unordered_set<std::string> seen;
+  size_t total = 0;
+
+  try {
+    values.reserve(n);
+
+    for (size_t i = 0;  i < n;  ++i) {
+      TRI_json_t const* value = TRI_LookupArrayJson(json, i);
+
+      // string lengths include the '\0'
+      if (! TRI_IsStringJson(value) ||
+          value->_value._string.length - 1 > TRI_SHAPE_DICTIONARY_MAX_LENGTH) {
+        return nullptr;
+      }
+
+      if (seen.emplace(value->_value._string.data, value->_value._string.length - 1).second) {
+        values.emplace_back(value);
+        total += value->_value._string.length;
+      }
+    }
+  }
+  catch (...) {
+    return nullptr;
+  }
+
+  size_t const offsetsSize = (values.size() + 1) * sizeof(TRI_shape_length_long_string_t);
+  size_t size = sizeof(TRI_dictionary_string_shape_t) + offsetsSize + total;
+  size = (size + 7) - ((size + 7) % 8);
+
+  // the padding must be zeroed, shapes are compared byte-wise
+  char* ptr = static_cast<char*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, size, true));
+
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+
+  TRI_dictionary_string_shape_t* shape = reinterpret_cast<TRI_dictionary_string_shape_t*>(ptr);
+  shape->base._sid = 0;
+  shape->base._type = TRI_SHAPE_DICTIONARY_STRING;
+  shape->base._size = size;
+  shape->base._dataSize = sizeof(TRI_shape_dictionary_code_t);
+  shape->_numberOfValues = static_cast<TRI_shape_length_list_t>(values.size());
+
+  TRI_shape_length_long_string_t* offsets = reinterpret_cast<TRI_shape_length_long_string_t*>(ptr + sizeof(TRI_dictionary_string_shape_t));
+  char* strings = ptr + sizeof(TRI_dictionary_string_shape_t) + offsetsSize;
+  TRI_shape_length_long_string_t offset = 0;
+
+  for (size_t i = 0;  i < values.size();  ++i) {
+    offsets[i] = offset;
+    memcpy(strings + offset, values[i]->_value._string.data, values[i]->_value._string.length - 1);
+    offset += static_cast<TRI_shape_length_long_string_t>(values[i]->_value._string.length);
+  }
+
+  offsets[values.size()] = offset;
+
+  return &shape->base;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -2121,6 +2917,98 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (VocShaper* shaper,
   return shaped;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json document text into a shaped json object
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ShapedJsonString (VocShaper* shaper,
+                          char const* text,
+                          size_t length,
+                          bool create,
+                          bool checkDuplicates,
+                          TRI_shaped_json_t** shaped,
+                          char** key,
+                          char** errmsg) {
+  *shaped = nullptr;
+  *key = nullptr;
+
+  if (errmsg != nullptr) {
+    *errmsg = nullptr;
+  }
+
+  shape_text_state_t state;
+  state._shaper = shaper;
+  state._create = create;
+  state._key = nullptr;
+  state._keyBad = false;
+  state._duplicate = false;
+
+  TRI_InitJsonScanner(&state._scanner, text, length);
+
+  TRI_shape_value_t dst;
+  dst._value = nullptr;
+
+  int c = TRI_NextJsonScanner(&state._scanner);
+  bool isObject = (c == TRI_JSON_TOKEN_OPEN_BRACE);
+  bool ok = ShapeTextValue(&state, isObject ? &dst : nullptr, c, 0, checkDuplicates);
+
+  if (ok && TRI_NextJsonScanner(&state._scanner) != TRI_JSON_TOKEN_END_OF_FILE) {
+    state._scanner._message = "failed to parse json object: expecting EOF";
+    ok = false;
+  }
+
+  // report errors in the same order as parsing, checking and shaping would
+  int res = TRI_ERROR_NO_ERROR;
+
+  if (state._scanner._message != nullptr) {
+    LOG_DEBUG("failed to parse json object: '%s'", state._scanner._message);
+
+    if (errmsg != nullptr) {
+      *errmsg = TRI_DuplicateString(state._scanner._message);
+    }
+
+    res = TRI_ERROR_HTTP_CORRUPTED_JSON;
+  }
+  else if (state._duplicate) {
+    res = TRI_ERROR_HTTP_CORRUPTED_JSON;
+  }
+  else if (! isObject) {
+    res = TRI_ERROR_ARANGO_DOCUMENT_TYPE_INVALID;
+  }
+  else if (state._keyBad) {
+    res = TRI_ERROR_ARANGO_DOCUMENT_KEY_BAD;
+  }
+  else if (! ok) {
+    res = TRI_ERROR_ARANGO_SHAPER_FAILED;
+  }
+
+  if (res == TRI_ERROR_NO_ERROR) {
+    *shaped = static_cast<TRI_shaped_json_t*>(TRI_Allocate(shaper->memoryZone(), sizeof(TRI_shaped_json_t), false));
+
+    if (*shaped == nullptr) {
+      res = TRI_ERROR_OUT_OF_MEMORY;
+    }
+    else {
+      (*shaped)->_sid = dst._sid;
+      (*shaped)->_data.length = (uint32_t) dst._size;
+      (*shaped)->_data.data = dst._value;
+
+      *key = state._key;
+      return TRI_ERROR_NO_ERROR;
+    }
+  }
+
+  if (dst._value != nullptr) {
+    TRI_Free(shaper->memoryZone(), dst._value);
+  }
+
+  if (state._key != nullptr) {
+    TRI_FreeString(TRI_CORE_MEM_ZONE, state._key);
+  }
+
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -2362,6 +3250,18 @@ bool TRI_StringValueShapedJson (TRI_shape_t const* shape,
 
     return true;
   }
+  else if (shape->_type == TRI_SHAPE_DICTIONARY_STRING) {
+    char const* v;
+
+    if (TRI_ValueDictionaryStringShape((TRI_dictionary_string_shape_t const*) shape,
+                                       * (TRI_shape_dictionary_code_t const*) data,
+                                       &v,
+                                       length)) {
+      *value = const_cast<char*>(v);
+
+      return true;
+    }
+  }
 
   // no string type
   *value = nullptr;
@@ -2370,6 +3270,32 @@ bool TRI_StringValueShapedJson (TRI_shape_t const* shape,
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get a value of a string dictionary
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_ValueDictionaryStringShape (TRI_dictionary_string_shape_t const* shape,
+                                     TRI_shape_dictionary_code_t code,
+                                     char const** value,
+                                     size_t* length) {
+  if (code >= shape->_numberOfValues) {
+    *value = nullptr;
+    *length = 0;
+
+    return false;
+  }
+
+  char const* ptr = reinterpret_cast<char const*>(shape) + sizeof(TRI_dictionary_string_shape_t);
+  TRI_shape_length_long_string_t const* offsets = reinterpret_cast<TRI_shape_length_long_string_t const*>(ptr);
+  char const* strings = ptr + (shape->_numberOfValues + 1) * sizeof(TRI_shape_length_long_string_t);
+
+  // the offsets include the '\0' of the previous value
+  *value = strings + offsets[code];
+  *length = static_cast<size_t>(offsets[code + 1] - offsets[code]) - 1;
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief iterate over a shaped json object, using a callback function
 ////////////////////////////////////////////////////////////////////////////////
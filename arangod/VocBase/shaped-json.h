@@ -64,6 +64,8 @@
 /// - @ref TRI_short_string_shape_t for short strings of size less then
 ///     @ref TRI_SHAPE_SHORT_STRING_CUT, this includes the trailing null
 /// - @ref TRI_long_string_shape_t for strings longer than the above limit
+/// - @ref TRI_dictionary_string_shape_t for strings taken from the string
+///     dictionary of a collection
 /// - @ref TRI_list_shape_t for arbitrary lists
 /// - @ref TRI_homogeneous_list_shape_t for lists of objects of the same shape
 /// - @ref TRI_homogeneous_sized_list_shape_t for lists of objects of the same
@@ -137,6 +139,12 @@
 ///
 /// @copydetails TRI_long_string_shape_t
 ///
+/// @section TRI_dictionary_string_shape_t
+///
+/// The shape representing a string from a string dictionary.
+///
+/// @copydetails TRI_dictionary_string_shape_t
+///
 /// @section TRI_array_shape_t
 ///
 /// The most complex shape is the shape of an associative array.
@@ -186,6 +194,18 @@ class VocShaper;
 
 #define TRI_SHAPE_SIZE_VARIABLE ((TRI_shape_size_t) -1)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of values in a string dictionary
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_SHAPE_DICTIONARY_MAX_VALUES 65536
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal length of a string dictionary value, excluding the '\0'
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_SHAPE_DICTIONARY_MAX_LENGTH 256
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                        JSON SHAPE
 // -----------------------------------------------------------------------------
@@ -228,7 +248,8 @@ typedef enum {
   TRI_SHAPE_ARRAY                  = 6,
   TRI_SHAPE_LIST                   = 7,
   TRI_SHAPE_HOMOGENEOUS_LIST       = 8,
-  TRI_SHAPE_HOMOGENEOUS_SIZED_LIST = 9
+  TRI_SHAPE_HOMOGENEOUS_SIZED_LIST = 9,
+  TRI_SHAPE_DICTIONARY_STRING      = 10
 }
 TRI_shape_type_e;
 
@@ -262,6 +283,12 @@ typedef uint8_t TRI_shape_length_short_string_t;
 
 typedef uint32_t TRI_shape_length_long_string_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief json storage type of a string dictionary code
+////////////////////////////////////////////////////////////////////////////////
+
+typedef uint32_t TRI_shape_dictionary_code_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief json storage type of a length for lists
 ////////////////////////////////////////////////////////////////////////////////
@@ -522,6 +549,72 @@ typedef struct TRI_long_string_shape_s {
 }
 TRI_long_string_shape_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief json shape, dictionary string
+///
+/// A @c TRI_dictionary_string_shape_t describes a string value which is one of
+/// the values of the string dictionary of a collection. The shape carries the
+/// dictionary itself, so the shaped JSON only stores the position of the value
+/// in it. There is at most one such shape per collection and it never changes.
+///
+/// <table border>
+///   <tr>
+///     <td>@c TRI_shape_sid_t</td>
+///     <td>_sid</td>
+///     <td>shape identifier</td>
+///   </tr>
+///   <tr>
+///     <td>@c TRI_shape_type_t</td>
+///     <td>_type</td>
+///     <td>always @c TRI_SHAPE_DICTIONARY_STRING</td>
+///   </tr>
+///   <tr>
+///     <td>@c TRI_shape_size_t</td>
+///     <td>_size</td>
+///     <td>total size of the shape including the dictionary, a multiple of 8</td>
+///   </tr>
+///   <tr>
+///     <td>@c TRI_shape_size_t</td>
+///     <td>_dataSize</td>
+///     <td>always sizeof(TRI_shape_dictionary_code_t)</td>
+///   </tr>
+///   <tr>
+///     <td>@c TRI_shape_length_list_t</td>
+///     <td>_numberOfValues</td>
+///     <td>number of values in the dictionary</td>
+///   </tr>
+///   <tr>
+///     <td>@c TRI_shape_length_long_string_t</td>
+///     <td>_offsets[_numberOfValues + 1]</td>
+///     <td>start of each value relative to the end of the offsets, plus the
+///         end of the last value</td>
+///   </tr>
+///   <tr>
+///     <td>@c char</td>
+///     <td>_values[]</td>
+///     <td>the values, each including the final '\0', padded with '\0' to
+///         the size of the shape</td>
+///   </tr>
+/// </table>
+///
+/// The memory layout of the corresponding shaped JSON is as follows
+///
+/// <table border>
+///   <tr>
+///     <td>@c TRI_shape_dictionary_code_t</td>
+///     <td>_code</td>
+///     <td>the position of the string in the dictionary</td>
+///   </tr>
+/// </table>
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_dictionary_string_shape_s {
+  TRI_shape_t base;
+
+  TRI_shape_length_list_t _numberOfValues;
+}
+TRI_dictionary_string_shape_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief json shape, array
 ///
@@ -933,6 +1026,24 @@ typedef struct TRI_shaped_sub_s {
 }
 TRI_shaped_sub_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stringification template of an array shape
+///
+/// Holds everything needed to print the attributes of an array shape which
+/// does not depend on the data: the sub-shapes and, for each attribute, its
+/// json-encoded name as `,"name":`. Shapes and attribute names never change
+/// once created, so a template stays valid for the lifetime of the shaper.
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_shape_template_s {
+  TRI_shape_sid_t _sid;
+  TRI_shape_size_t _numEntries;
+  TRI_shape_t const** _shapes;          // sub-shapes, one per attribute
+  uint32_t* _offsets;                   // start of each name, plus the end
+  char* _names;                         // concatenated names
+}
+TRI_shape_template_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    ATTRIBUTE PATH
 // -----------------------------------------------------------------------------
@@ -977,6 +1088,34 @@ void TRI_DestroyShapedJson (struct TRI_memory_zone_s*, TRI_shaped_json_t*);
 void TRI_FreeShapedJson (struct TRI_memory_zone_s*,
                          TRI_shaped_json_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the stringification template of an array shape
+///
+/// Returns a nullptr if the shape is not an array shape or if one of its
+/// sub-shapes or attribute names cannot be found.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_template_t* TRI_CreateShapeTemplate (VocShaper*,
+                                               TRI_shape_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a stringification template
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeShapeTemplate (TRI_shape_template_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the dictionary string shape for a list of string values
+///
+/// The shape is allocated in the unknown memory zone and has no shape
+/// identifier yet. Duplicate values are dropped, codes are the positions of
+/// the remaining values. Returns a nullptr if the list is empty, too long or
+/// contains anything but strings of at most @ref TRI_SHAPE_DICTIONARY_MAX_LENGTH
+/// bytes.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_shape_t* TRI_CreateDictionaryStringShape (struct TRI_json_t const*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -996,6 +1135,28 @@ TRI_shaped_json_t* TRI_ShapedJsonJson (VocShaper*,
                                        TRI_json_t const*,
                                        bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts a json document text into a shaped json object
+///
+/// The text is shaped while it is scanned, without building a TRI_json_t
+/// first. It must contain a single object. The result is the same as parsing
+/// the text, optionally rejecting duplicate attribute names like
+/// TRI_HasDuplicateKeyJson, and then calling TRI_ShapedJsonJson. The value of
+/// the top-level _key attribute is returned in key, or nullptr if there is
+/// none. Parse errors are reported as TRI_ERROR_HTTP_CORRUPTED_JSON with a
+/// message in errmsg. key and errmsg must be freed using TRI_FreeString with
+/// the TRI_CORE_MEM_ZONE.
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_ShapedJsonString (VocShaper*,
+                          char const* text,
+                          size_t length,
+                          bool create,
+                          bool checkDuplicates,
+                          TRI_shaped_json_t** shaped,
+                          char** key,
+                          char** errmsg);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a shaped json object into a json object
 ////////////////////////////////////////////////////////////////////////////////
@@ -1090,7 +1251,8 @@ void TRI_PrintShape (VocShaper*,
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the string value encoded in a shaped json
 /// this will return the pointer to the string and the string length in the
-/// variables passed by reference
+/// variables passed by reference. for dictionary strings, the pointer refers
+/// to the dictionary in the shape
 ////////////////////////////////////////////////////////////////////////////////
 
 bool TRI_StringValueShapedJson (TRI_shape_t const*,
@@ -1098,6 +1260,17 @@ bool TRI_StringValueShapedJson (TRI_shape_t const*,
                                 char**,
                                 size_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get a value of a string dictionary
+///
+/// Returns false if there is no value with this code.
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_ValueDictionaryStringShape (TRI_dictionary_string_shape_t const*,
+                                     TRI_shape_dictionary_code_t,
+                                     char const**,
+                                     size_t*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief iterate over a shaped json array, using a callback function
 ////////////////////////////////////////////////////////////////////////////////
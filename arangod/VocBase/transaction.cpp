@@ -37,9 +37,11 @@
 #include "VocBase/collection.h"
 #include "VocBase/document-collection.h"
 #include "VocBase/server.h"
+#include "VocBase/VocShaper.h"
 #include "VocBase/vocbase.h"
 #include "Wal/DocumentOperation.h"
 #include "Wal/LogfileManager.h"
+#include "Utils/DocumentCache.h"
 #include "Utils/Transaction.h"
 
 #ifdef TRI_ENABLE_MAINTAINER_MODE
@@ -119,6 +121,101 @@ static inline bool NeedWriteMarker (TRI_transaction_t const* trx,
           ! IsSingleOperationTransaction(trx));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal number of operations on a collection for which the
+/// query cache checks the written documents. more operations invalidate all
+/// results of the collection
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxQueryCacheOperations = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a document version written by a transaction, for the query cache
+////////////////////////////////////////////////////////////////////////////////
+
+class WrittenDocument : public triagens::aql::QueryCacheDocument {
+
+  public:
+
+    WrittenDocument (TRI_document_collection_t* document,
+                     TRI_df_marker_t const* marker)
+      : _document(document),
+        _marker(marker) {
+    }
+
+    std::string key () const override {
+      return std::string(TRI_EXTRACT_MARKER_KEY(_marker));  // PROTECTED by trx
+    }
+
+    std::unique_ptr<TRI_json_t> attribute (std::string const& name) const override {
+      if (name == TRI_VOC_ATTRIBUTE_KEY) {
+        return std::unique_ptr<TRI_json_t>(TRI_CreateStringCopyJson(TRI_UNKNOWN_MEM_ZONE, TRI_EXTRACT_MARKER_KEY(_marker), strlen(TRI_EXTRACT_MARKER_KEY(_marker))));
+      }
+
+      auto shaper = _document->getShaper();  // PROTECTED by trx
+      TRI_shape_pid_t pid = shaper->lookupAttributePathByName(name.c_str());
+
+      if (pid == 0) {
+        // no document has the attribute
+        return std::unique_ptr<TRI_json_t>();
+      }
+
+      TRI_shaped_json_t document;
+      TRI_EXTRACT_SHAPED_JSON_MARKER(document, _marker);
+
+      TRI_shaped_json_t json;
+      TRI_shape_t const* shape;
+
+      if (! shaper->extractShapedJson(&document, 0, pid, &json, &shape) || shape == nullptr) {
+        return std::unique_ptr<TRI_json_t>();
+      }
+
+      return std::unique_ptr<TRI_json_t>(TRI_JsonShapedJson(shaper, &json));
+    }
+
+  private:
+
+    TRI_document_collection_t* _document;
+
+    TRI_df_marker_t const* _marker;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief invalidate the query cache results of a collection that may be
+/// changed by the old and new document versions of the operations
+////////////////////////////////////////////////////////////////////////////////
+
+static void InvalidateQueryCache (TRI_vocbase_t* vocbase,
+                                  TRI_document_collection_t* document,
+                                  triagens::wal::DocumentOperation* const* operations,
+                                  size_t n) {
+  std::vector<WrittenDocument> written;
+  written.reserve(2 * n);
+
+  for (size_t i = 0; i < n; ++i) {
+    auto const operation = operations[i];
+
+    if (operation->type == TRI_VOC_DOCUMENT_OPERATION_UPDATE ||
+        operation->type == TRI_VOC_DOCUMENT_OPERATION_REMOVE) {
+      written.emplace_back(document, static_cast<TRI_df_marker_t const*>(operation->oldHeader.getDataPtr()));  // PROTECTED by trx
+    }
+
+    if (operation->type == TRI_VOC_DOCUMENT_OPERATION_INSERT ||
+        operation->type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
+      written.emplace_back(document, static_cast<TRI_df_marker_t const*>(operation->header->getDataPtr()));  // PROTECTED by trx
+    }
+  }
+
+  std::vector<triagens::aql::QueryCacheDocument const*> documents;
+  documents.reserve(written.size());
+
+  for (auto const& it : written) {
+    documents.emplace_back(&it);
+  }
+
+  triagens::aql::QueryCache::instance()->invalidate(vocbase, document->_info._name, documents);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief clear the query cache for all collections that were modified by
 /// the transaction
@@ -140,6 +237,14 @@ void ClearQueryCache (TRI_transaction_t* trx) {
         continue;
       }
 
+      auto const& operations = *trxCollection->_operations;
+
+      if (operations.size() <= MaxQueryCacheOperations) {
+        // only invalidate the results the written documents may change
+        InvalidateQueryCache(trx->_vocbase, trxCollection->_collection->_collection, operations.data(), operations.size());
+        continue;
+      }
+
       collections.emplace_back(reinterpret_cast<char const*>(&(trxCollection->_collection->_name)));
     }
 
@@ -309,11 +414,21 @@ static TRI_transaction_collection_t* CreateCollection (TRI_transaction_t* trx,
                                                        TRI_voc_cid_t cid,
                                                        TRI_transaction_type_e accessType,
                                                        int nestingLevel) {
-  TRI_transaction_collection_t* trxCollection = static_cast<TRI_transaction_collection_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_transaction_collection_t), false));
+  TRI_transaction_collection_t* trxCollection;
 
-  if (trxCollection == nullptr) {
-    // OOM
-    return nullptr;
+  if (! trx->_inlineUsed) {
+    // the first collection lives inside the transaction. this spares
+    // single-collection transactions an allocation
+    trxCollection = &trx->_inlineCollection;
+    trx->_inlineUsed = true;
+  }
+  else {
+    trxCollection = static_cast<TRI_transaction_collection_t*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(TRI_transaction_collection_t), false));
+
+    if (trxCollection == nullptr) {
+      // OOM
+      return nullptr;
+    }
   }
 
   // initialize collection properties
@@ -339,6 +454,13 @@ static TRI_transaction_collection_t* CreateCollection (TRI_transaction_t* trx,
 static void FreeCollection (TRI_transaction_collection_t* trxCollection) {
   TRI_ASSERT(trxCollection != nullptr);
 
+  TRI_transaction_t* trx = trxCollection->_transaction;
+
+  if (trxCollection == &trx->_inlineCollection) {
+    trx->_inlineUsed = false;
+    return;
+  }
+
   TRI_Free(TRI_UNKNOWN_MEM_ZONE, trxCollection);
 }
 
@@ -788,6 +910,34 @@ TRI_transaction_t* TRI_CreateTransaction (TRI_vocbase_t* vocbase,
     return nullptr;
   }
 
+  TRI_InitTransaction(trx, vocbase, externalId, timeout, waitForSync);
+
+  return trx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief free a transaction container
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeTransaction (TRI_transaction_t* trx) {
+  TRI_ASSERT(trx != nullptr);
+
+  TRI_DestroyTransaction(trx);
+
+  TRI_Free(TRI_UNKNOWN_MEM_ZONE, trx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize a transaction container in caller-provided memory
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitTransaction (TRI_transaction_t* trx,
+                          TRI_vocbase_t* vocbase,
+                          TRI_voc_tid_t externalId,
+                          double timeout,
+                          bool waitForSync) {
+  TRI_ASSERT(trx != nullptr);
+
   trx->_vocbase           = vocbase;
 
   // note: the real transaction id will be acquired on transaction start
@@ -800,6 +950,7 @@ TRI_transaction_t* TRI_CreateTransaction (TRI_vocbase_t* vocbase,
   trx->_hasOperations     = false;
   trx->_waitForSync       = waitForSync;
   trx->_beginWritten      = false;
+  trx->_inlineUsed        = false;
 
   if (timeout > 0.0) {
     trx->_timeout         = (uint64_t) (timeout * 1000000.0);
@@ -808,24 +959,27 @@ TRI_transaction_t* TRI_CreateTransaction (TRI_vocbase_t* vocbase,
     trx->_timeout         = static_cast<uint64_t>(0);
   }
 
-  TRI_InitVectorPointer(&trx->_collections, TRI_UNKNOWN_MEM_ZONE, 2);
-
-  return trx;
+  // the vector buffer is allocated lazily, on the first collection added
+  TRI_InitVectorPointer(&trx->_collections, TRI_UNKNOWN_MEM_ZONE);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief free a transaction container
+/// @brief destroy a transaction container, but does not free the pointer
 ////////////////////////////////////////////////////////////////////////////////
 
-void TRI_FreeTransaction (TRI_transaction_t* trx) {
+void TRI_DestroyTransaction (TRI_transaction_t* trx) {
   TRI_ASSERT(trx != nullptr);
 
   if (trx->_status == TRI_TRANSACTION_RUNNING) {
     TRI_AbortTransaction(trx, 0);
   }
 
-  // release the marker protector
-  bool const hasFailedOperations = (trx->_hasOperations && trx->_status == TRI_TRANSACTION_ABORTED);
+  // release the marker protector. the markers of single-operation
+  // transactions carry no transaction id, so there is nothing to
+  // mark as failed for them
+  bool const hasFailedOperations = (trx->_hasOperations &&
+                                    trx->_status == TRI_TRANSACTION_ABORTED &&
+                                    ! IsSingleOperationTransaction(trx));
   triagens::wal::LogfileManager::instance()->unregisterTransaction(trx->_id, hasFailedOperations);
 
   ReleaseCollections(trx, 0);
@@ -840,8 +994,6 @@ void TRI_FreeTransaction (TRI_transaction_t* trx) {
   }
 
   TRI_DestroyVectorPointer(&trx->_collections);
-
-  TRI_Free(TRI_UNKNOWN_MEM_ZONE, trx);
 }
 
 // -----------------------------------------------------------------------------
@@ -1088,6 +1240,9 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
   TRI_ASSERT(operation.header != nullptr);
 
   bool const isSingleOperationTransaction = IsSingleOperationTransaction(trx);
+  // the operation type is reset when the operation is buffered below
+  bool const replacesDocument = (operation.type == TRI_VOC_DOCUMENT_OPERATION_UPDATE ||
+                                 operation.type == TRI_VOC_DOCUMENT_OPERATION_REMOVE);
 
   // upgrade the info for the transaction
   if (waitForSync || trxCollection->_waitForSync) {
@@ -1233,7 +1388,10 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
     // operation is directly executed
     operation.handle();
      
-    triagens::aql::QueryCache::instance()->invalidate(trx->_vocbase, document->_info._name);
+    if (triagens::aql::QueryCache::instance()->mayBeActive()) {
+      triagens::wal::DocumentOperation* operations[] = { &operation };
+      InvalidateQueryCache(trx->_vocbase, document, operations, 1);
+    }
 
     ++document->_uncollectedLogfileEntries;
 
@@ -1271,6 +1429,13 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
   }
 
   TRI_UpdateRevisionDocumentCollection(document, operation.rid, false);
+
+  if (replacesDocument) {
+    // the cached revision can never be read again
+    triagens::arango::DocumentCache::instance()->invalidate(trx->_vocbase->_id,
+                                                            trxCollection->_cid,
+                                                            TRI_EXTRACT_MARKER_KEY(&operation.oldHeader));  // PROTECTED by trx
+  }
   
   TRI_IF_FAILURE("TransactionOperationAtEnd") {
     return TRI_ERROR_DEBUG;
@@ -1279,6 +1444,82 @@ int TRI_AddOperationTransaction (triagens::wal::DocumentOperation& operation,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief add several WAL operations for a transaction collection
+///
+/// The markers of all operations are written into the logfile at once, then
+/// each operation is registered as if it had been added on its own. results
+/// receives one error code per operation. If the markers cannot be written
+/// together, e.g. because a legend must be written first, the operations are
+/// added one by one.
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddOperationsTransaction (std::vector<triagens::wal::DocumentOperation*>& operations,
+                                   std::vector<int>& results,
+                                   bool& waitForSync) {
+  size_t const n = operations.size();
+  bool const requested = waitForSync;
+
+  results.assign(n, TRI_ERROR_NO_ERROR);
+  waitForSync = false;
+
+  if (n == 0) {
+    return;
+  }
+
+  TRI_transaction_t* trx = operations[0]->trxCollection->_transaction;
+
+  if (n > 1 && ! IsSingleOperationTransaction(trx)) {
+    int res = TRI_ERROR_NO_ERROR;
+
+    if (! trx->_beginWritten) {
+      // the begin marker must precede the operations' markers
+      res = WriteBeginMarker(trx);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        results.assign(n, res);
+        return;
+      }
+    }
+
+    std::vector<triagens::wal::Marker*> markers;
+    markers.reserve(n);
+
+    for (auto const& operation : operations) {
+      TRI_ASSERT(operation->marker->fid() == 0);
+      markers.push_back(operation->marker);
+    }
+
+    std::vector<triagens::wal::SlotInfoCopy> slots;
+    res = GetLogfileManager()->allocateAndWrite(markers, false, slots);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      TRI_ASSERT(slots.size() == n);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto operation = operations[i];
+
+        // from now on, the operation refers to the logfile copy of its marker
+        if (operation->type == TRI_VOC_DOCUMENT_OPERATION_INSERT ||
+            operation->type == TRI_VOC_DOCUMENT_OPERATION_UPDATE) {
+          operation->header->setDataPtr(slots[i].mem);  // PROTECTED by ongoing trx from operation
+        }
+
+        operation->marker->moveToLogfile(slots[i].mem, slots[i].logfileId);
+        operation->tick = slots[i].tick;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    // markers written above are recognized by their logfile id and are not
+    // written again
+    bool sync = requested;
+    results[i] = TRI_AddOperationTransaction(*operations[i], sync);
+    waitForSync |= sync;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief start a transaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -1296,17 +1537,17 @@ int TRI_BeginTransaction (TRI_transaction_t* trx,
     if (! HasHint(trx, TRI_TRANSACTION_HINT_NO_THROTTLING) &&
         trx->_type == TRI_TRANSACTION_WRITE &&
         logfileManager->canBeThrottled()) {
-      // write-throttling?
-      static uint64_t const WaitTime = 50000;
-      uint64_t const maxIterations = logfileManager->maxThrottleWait() / (WaitTime / 1000);
-      uint64_t iterations = 0;
-     
-      while (logfileManager->isThrottled()) {
-        if (++iterations == maxIterations) {
-          return TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT;
-        }
+      // write-throttling. a refused transaction fails right away, so that
+      // the client backs off instead of occupying this thread
+      uint64_t delay;
+      int res = logfileManager->writeThrottle().admit(trx->_vocbase->_id, delay);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
 
-        usleep(WaitTime);
+      if (delay > 0) {
+        usleep(static_cast<unsigned long>((std::min)(delay, logfileManager->maxThrottleWait() * 1000)));
       }
     }
 
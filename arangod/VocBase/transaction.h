@@ -134,6 +134,25 @@ typedef enum {
 }
 TRI_transaction_hint_e;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collection used in a transaction
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_transaction_collection_s {
+  struct TRI_transaction_s*            _transaction;       // the transaction
+  TRI_voc_cid_t                        _cid;               // collection id
+  TRI_transaction_type_e               _accessType;        // access type (read|write)
+  int                                  _nestingLevel;      // the transaction level that added this collection
+  struct TRI_vocbase_col_s*            _collection;        // vocbase collection pointer
+  triagens::arango::DocumentDitch*     _ditch;
+  std::vector<triagens::wal::DocumentOperation*>* _operations;
+  TRI_voc_rid_t                        _originalRevision;  // collection revision at trx start
+  TRI_transaction_type_e               _lockType;          // collection lock type
+  bool                                 _compactionLocked;  // was the compaction lock grabbed for the collection?
+  bool                                 _waitForSync;       // whether or not the collection has waitForSync
+}
+TRI_transaction_collection_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief transaction typedef
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,28 +169,11 @@ typedef struct TRI_transaction_s {
   bool                                 _waitForSync;       // whether or not the collection had a synchronous op
   bool                                 _beginWritten;      // whether or not the begin marker was already written
   uint64_t                             _timeout;           // timeout for lock acquisition
+  bool                                 _inlineUsed;        // whether or not _inlineCollection is in use
+  TRI_transaction_collection_t         _inlineCollection;  // storage for the first collection
 }
 TRI_transaction_t;
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief collection used in a transaction
-////////////////////////////////////////////////////////////////////////////////
-
-typedef struct TRI_transaction_collection_s {
-  TRI_transaction_t*                   _transaction;       // the transaction
-  TRI_voc_cid_t                        _cid;               // collection id
-  TRI_transaction_type_e               _accessType;        // access type (read|write)
-  int                                  _nestingLevel;      // the transaction level that added this collection
-  struct TRI_vocbase_col_s*            _collection;        // vocbase collection pointer
-  triagens::arango::DocumentDitch*     _ditch;
-  std::vector<triagens::wal::DocumentOperation*>* _operations;
-  TRI_voc_rid_t                        _originalRevision;  // collection revision at trx start
-  TRI_transaction_type_e               _lockType;          // collection lock type
-  bool                                 _compactionLocked;  // was the compaction lock grabbed for the collection?
-  bool                                 _waitForSync;       // whether or not the collection has waitForSync
-}
-TRI_transaction_collection_t;
-
 // -----------------------------------------------------------------------------
 // --SECTION--                                        constructors / destructors
 // -----------------------------------------------------------------------------
@@ -191,6 +193,25 @@ TRI_transaction_t* TRI_CreateTransaction (TRI_vocbase_t*,
 
 void TRI_FreeTransaction (TRI_transaction_t*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initialize a transaction in caller-provided memory
+///
+/// this saves the heap allocation of TRI_CreateTransaction for transactions
+/// whose state lives on the stack or inside another object
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitTransaction (TRI_transaction_t*,
+                          TRI_vocbase_t*,
+                          TRI_voc_tid_t,
+                          double,
+                          bool);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy a transaction, but does not free the pointer
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_DestroyTransaction (TRI_transaction_t*);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -37,6 +37,7 @@
 
 #include "Aql/QueryCache.h"
 #include "Aql/QueryList.h"
+#include "Aql/QueryPlanCache.h"
 #include "Basics/conversions.h"
 #include "Basics/files.h"
 #include "Basics/hashes.h"
@@ -780,6 +781,7 @@ static int RenameCollection (TRI_vocbase_t* vocbase,
 
   // invalidate all entries for the two collections
   triagens::aql::QueryCache::instance()->invalidate(vocbase, std::vector<char const*>{ oldName, newName });
+  triagens::aql::QueryPlanCache::instance()->invalidate(vocbase, std::vector<char const*>{ oldName, newName });
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -1013,6 +1015,7 @@ static int LoadCollectionVocBase (TRI_vocbase_t* vocbase,
   }
 
   if (collection->_status == TRI_VOC_COL_STATUS_LOADED) {
+    collection->_collection->_lastAccess.store(TRI_microtime(), std::memory_order_relaxed);
 
     // DO NOT release the lock
     return TRI_ERROR_NO_ERROR;
@@ -1158,6 +1161,7 @@ static int DropCollection (TRI_vocbase_t* vocbase,
   TRI_EVENTUAL_WRITE_LOCK_STATUS_VOCBASE_COL(collection);
 
   triagens::aql::QueryCache::instance()->invalidate(vocbase, collection->_name); 
+  triagens::aql::QueryPlanCache::instance()->invalidate(vocbase, collection->_name);
 
   // .............................................................................
   // collection already deleted
@@ -1913,6 +1917,32 @@ TRI_vocbase_col_t* TRI_CreateCollectionVocBase (TRI_vocbase_t* vocbase,
   return collection;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts unloading a loaded (document) collection
+///
+/// the caller must hold the write lock on the collection status, which is
+/// released
+////////////////////////////////////////////////////////////////////////////////
+
+static void StartUnloadCollection (TRI_vocbase_t* vocbase,
+                                   TRI_vocbase_col_t* collection) {
+  TRI_ASSERT(collection->_status == TRI_VOC_COL_STATUS_LOADED);
+
+  // mark collection as unloading
+  collection->_status = TRI_VOC_COL_STATUS_UNLOADING;
+
+  // add callback for unload
+  collection->_collection->ditches()->createUnloadCollectionDitch(collection->_collection, collection, UnloadCollectionCallback, __FILE__, __LINE__);
+
+  // release locks
+  TRI_WRITE_UNLOCK_STATUS_VOCBASE_COL(collection);
+
+  // wake up the cleanup thread
+  TRI_LockCondition(&vocbase->_cleanupCondition);
+  TRI_SignalCondition(&vocbase->_cleanupCondition);
+  TRI_UnlockCondition(&vocbase->_cleanupCondition);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief unloads a (document) collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -1974,21 +2004,41 @@ int TRI_UnloadCollectionVocBase (TRI_vocbase_t* vocbase,
     return TRI_set_errno(TRI_ERROR_INTERNAL);
   }
 
-  // mark collection as unloading
-  collection->_status = TRI_VOC_COL_STATUS_UNLOADING;
+  StartUnloadCollection(vocbase, collection);
 
-  // add callback for unload
-  collection->_collection->ditches()->createUnloadCollectionDitch(collection->_collection, collection, UnloadCollectionCallback, __FILE__, __LINE__);
+  return TRI_ERROR_NO_ERROR;
+}
 
-  // release locks
-  TRI_WRITE_UNLOCK_STATUS_VOCBASE_COL(collection);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unloads a (document) collection if it has not been used since
+/// lastAccess
+///
+/// this does not wait for the collection lock, and returns false if the
+/// collection is busy, has been used in the meantime or is not loaded
+////////////////////////////////////////////////////////////////////////////////
 
-  // wake up the cleanup thread
-  TRI_LockCondition(&vocbase->_cleanupCondition);
-  TRI_SignalCondition(&vocbase->_cleanupCondition);
-  TRI_UnlockCondition(&vocbase->_cleanupCondition);
+bool TRI_UnloadIdleCollectionVocBase (TRI_vocbase_t* vocbase,
+                                      TRI_vocbase_col_t* collection,
+                                      double lastAccess) {
+  if (! collection->_canUnload) {
+    return false;
+  }
 
-  return TRI_ERROR_NO_ERROR;
+  if (! TRI_TRY_WRITE_LOCK_STATUS_VOCBASE_COL(collection)) {
+    return false;
+  }
+
+  // loading a collection updates the access time under the read lock, so
+  // the collection cannot be used while we hold the write lock
+  if (collection->_status != TRI_VOC_COL_STATUS_LOADED ||
+      collection->_collection->_lastAccess.load(std::memory_order_relaxed) > lastAccess) {
+    TRI_WRITE_UNLOCK_STATUS_VOCBASE_COL(collection);
+    return false;
+  }
+
+  StartUnloadCollection(vocbase, collection);
+
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2385,6 +2435,7 @@ TRI_vocbase_t::TRI_vocbase_t (TRI_server_t* server,
     _queries(nullptr),
     _cursorRepository(nullptr),
     _collectionKeys(nullptr),
+    _authCache(nullptr),
     _authInfoLoaded(false),
     _hasCompactor(false),
     _isOwnAppsDirectory(true),
@@ -33,6 +33,7 @@
 #include "Basics/Common.h"
 #include "Basics/associative.h"
 #include "Basics/DeadlockDetector.h"
+#include "Basics/DistributedReadWriteLock.h"
 #include "Basics/locks.h"
 #include "Basics/ReadWriteLock.h"
 #include "Basics/threads.h"
@@ -57,6 +58,7 @@ namespace triagens {
     class QueryList;
   }
   namespace arango {
+    class AuthCache;
     class CollectionKeysRepository;
     class CursorRepository;
   }
@@ -277,7 +279,7 @@ struct TRI_vocbase_t {
 
   triagens::basics::DeadlockDetector<TRI_document_collection_t> _deadlockDetector;
 
-  triagens::basics::ReadWriteLock         _collectionsLock;    // collection iterator lock
+  triagens::basics::DistributedReadWriteLock _collectionsLock;  // collection iterator lock
   std::vector<struct TRI_vocbase_col_s*>  _collections;        // pointers to ALL collections
   std::vector<struct TRI_vocbase_col_s*>  _deadCollections;    // pointers to collections dropped that can be removed later
 
@@ -293,7 +295,7 @@ struct TRI_vocbase_t {
   triagens::arango::CollectionKeysRepository*  _collectionKeys;
 
   TRI_associative_pointer_t               _authInfo;
-  TRI_associative_pointer_t               _authCache;
+  triagens::arango::AuthCache*            _authCache;          // verified credentials
   TRI_read_write_lock_t                   _authInfoLock;
   bool                                    _authInfoLoaded;     // flag indicating whether the authentication info was loaded successfully
   bool                                    _hasCompactor;
@@ -511,6 +513,15 @@ int TRI_UnloadCollectionVocBase (TRI_vocbase_t*,
                                  TRI_vocbase_col_t*,
                                  bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unloads a (document) collection if it has not been used since
+/// the given time
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_UnloadIdleCollectionVocBase (TRI_vocbase_t*,
+                                      TRI_vocbase_col_t*,
+                                      double);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief drops a (document) collection
 ////////////////////////////////////////////////////////////////////////////////
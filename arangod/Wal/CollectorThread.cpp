@@ -28,6 +28,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "CollectorThread.h"
+#include "Basics/Barrier.h"
 
 #include "Basics/ConditionLocker.h"
 #include "Basics/Exceptions.h"
@@ -284,7 +285,8 @@ uint64_t const CollectorThread::Interval = 1000000;
 ////////////////////////////////////////////////////////////////////////////////
 
 CollectorThread::CollectorThread (LogfileManager* logfileManager,
-                                  TRI_server_t* server)
+                                  TRI_server_t* server,
+                                  size_t numWorkerThreads)
   : Thread("WalCollector"),
     _logfileManager(logfileManager),
     _server(server),
@@ -294,9 +296,14 @@ CollectorThread::CollectorThread (LogfileManager* logfileManager,
     _operationsQueueInUse(false),
     _stop(0),
     _numPendingOperations(0),
+    _workerPool(nullptr),
     _collectorResultCondition(),
     _collectorResult(TRI_ERROR_NO_ERROR) {
 
+  if (numWorkerThreads > 0) {
+    _workerPool = new triagens::basics::ThreadPool(numWorkerThreads, "WalCollectorWorker");
+  }
+
   allowAsynchronousCancelation();
 }
 
@@ -305,6 +312,7 @@ CollectorThread::CollectorThread (LogfileManager* logfileManager,
 ////////////////////////////////////////////////////////////////////////////////
 
 CollectorThread::~CollectorThread () {
+  delete _workerPool;
 }
 
 // -----------------------------------------------------------------------------
@@ -563,74 +571,23 @@ int CollectorThread::processQueuedOperations (bool& worked) {
 
   // go on without the mutex!
 
-  // process operations for each collection
-  for (auto it = _operationsQueue.begin(); it != _operationsQueue.end(); ++it) {
-    auto& operations = (*it).second;
-    TRI_ASSERT(! operations.empty());
-
-    for (auto it2 = operations.begin(); it2 != operations.end(); /* no hoisting */ ) {
-      Logfile* logfile = (*it2)->logfile;
-
-      int res = TRI_ERROR_INTERNAL;
-
-      try {
-        res = processCollectionOperations((*it2));
-      }
-      catch (triagens::basics::Exception const& ex) {
-        res = ex.code();
-      }
-
-      if (res == TRI_ERROR_LOCK_TIMEOUT) {
-        // could not acquire write-lock for collection in time
-        // do not delete the operations
-        ++it2;
-        continue;
-      }
+  // process operations for each collection. the queues of different
+  // collections are independent, so they can be processed in parallel
+  std::vector<std::function<int()>> tasks;
+  tasks.reserve(_operationsQueue.size());
 
-      if (res == TRI_ERROR_NO_ERROR) {
-        LOG_TRACE("queued operations applied successfully");
-      }
-      else if (res == TRI_ERROR_ARANGO_DATABASE_NOT_FOUND ||
-               res == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
-        // these are expected errors
-        LOG_TRACE("removing queued operations for already deleted collection");
-        res = TRI_ERROR_NO_ERROR;
-      }
-      else {
-        LOG_WARNING("got unexpected error code while applying queued operations: %s", TRI_errno_string(res));
-      }
-
-      if (res == TRI_ERROR_NO_ERROR) {
-        uint64_t numOperations = (*it2)->operations->size();
-        uint64_t maxNumPendingOperations = _logfileManager->throttleWhenPending();
-
-        if (maxNumPendingOperations > 0 && 
-            _numPendingOperations >= maxNumPendingOperations &&
-            (_numPendingOperations - numOperations) < maxNumPendingOperations) {
-          // write-throttling was active, but can be turned off now
-          _logfileManager->deactivateWriteThrottling();
-          LOG_INFO("deactivating write-throttling");
-        }
-
-        _numPendingOperations -= numOperations;
-
-        // delete the object
-        delete (*it2);
-
-        // delete the element from the vector while iterating over the vector
-        it2 = operations.erase(it2);
-
-        _logfileManager->decreaseCollectQueueSize(logfile);
-      }
-      else {
-        // do not delete the object but advance in the operations vector
-        ++it2;
-      }
-    }
+  for (auto it = _operationsQueue.begin(); it != _operationsQueue.end(); ++it) {
+    auto operations = &((*it).second);
+    TRI_ASSERT(! operations->empty());
 
-    // next collection
+    tasks.emplace_back([this, operations] () -> int {
+      processCollectionQueue(*operations);
+      return TRI_ERROR_NO_ERROR;
+    });
   }
 
+  executeTasks(tasks);
+
   // finally remove all entries from the map with empty vectors
   {
     MUTEX_LOCKER(_operationsQueueLock);
@@ -653,6 +610,65 @@ int CollectorThread::processQueuedOperations (bool& worked) {
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the queued operations of a single collection
+////////////////////////////////////////////////////////////////////////////////
+
+void CollectorThread::processCollectionQueue (std::vector<CollectorCache*>& operations) {
+  for (auto it2 = operations.begin(); it2 != operations.end(); /* no hoisting */ ) {
+    Logfile* logfile = (*it2)->logfile;
+
+    int res = TRI_ERROR_INTERNAL;
+
+    try {
+      res = processCollectionOperations((*it2));
+    }
+    catch (triagens::basics::Exception const& ex) {
+      res = ex.code();
+    }
+
+    if (res == TRI_ERROR_LOCK_TIMEOUT) {
+      // could not acquire write-lock for collection in time
+      // do not delete the operations
+      ++it2;
+      continue;
+    }
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      LOG_TRACE("queued operations applied successfully");
+    }
+    else if (res == TRI_ERROR_ARANGO_DATABASE_NOT_FOUND ||
+             res == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      // these are expected errors
+      LOG_TRACE("removing queued operations for already deleted collection");
+      res = TRI_ERROR_NO_ERROR;
+    }
+    else {
+      LOG_WARNING("got unexpected error code while applying queued operations: %s", TRI_errno_string(res));
+    }
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      uint64_t numOperations = (*it2)->operations->size();
+      _numPendingOperations.fetch_sub(numOperations);
+
+      // relax write-throttling as the backlog shrinks
+      _logfileManager->updateWritePressure();
+
+      // delete the object
+      delete (*it2);
+
+      // delete the element from the vector while iterating over the vector
+      it2 = operations.erase(it2);
+
+      _logfileManager->decreaseCollectQueueSize(logfile);
+    }
+    else {
+      // do not delete the object but advance in the operations vector
+      ++it2;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the number of queued operations
 ////////////////////////////////////////////////////////////////////////////////
@@ -663,6 +679,74 @@ size_t CollectorThread::numQueuedOperations () {
   return _operationsQueue.size();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief execute tasks in parallel, using the worker pool and the current
+/// thread. returns the first error reported by a task
+////////////////////////////////////////////////////////////////////////////////
+
+int CollectorThread::executeTasks (std::vector<std::function<int()>> const& tasks) {
+  size_t const n = tasks.size();
+
+  if (n == 0) {
+    return TRI_ERROR_NO_ERROR;
+  }
+   
+  std::atomic<int> result(TRI_ERROR_NO_ERROR);
+
+  auto setResult = [&result] (int res) -> void {
+    if (res != TRI_ERROR_NO_ERROR) {
+      int expected = TRI_ERROR_NO_ERROR;
+      result.compare_exchange_strong(expected, res, std::memory_order_acquire);
+    }
+  };
+
+  auto execute = [&setResult] (std::function<int()> const& task) -> void {
+    int res;
+
+    try {
+      res = task();
+    }
+    catch (triagens::basics::Exception const& ex) {
+      res = ex.code();
+    }
+    catch (...) {
+      res = TRI_ERROR_INTERNAL;
+    }
+
+    setResult(res);
+  };
+
+  {
+    triagens::basics::Barrier barrier(n);
+
+    for (size_t i = 0; i < n; ++i) {
+      auto const& task = tasks[i];
+
+      // the last task is always executed in this thread, so the collector
+      // does not only wait for the workers
+      if (_workerPool != nullptr && i != (n - 1)) {
+        try {
+          _workerPool->enqueue([&barrier, &execute, &task] () -> void {
+            execute(task);
+            barrier.join();
+          });
+          continue;
+        }
+        catch (...) {
+          // could not hand out the task. execute it here
+        }
+      }
+
+      execute(task);
+      barrier.join();
+    }
+
+    // barrier waits here until all tasks have joined
+  }
+
+  return result.load();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief process all operations for a single collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -844,7 +928,6 @@ int CollectorThread::collect (Logfile* logfile) {
 
   // We will sequentially scan the logfile for collection:
   TRI_MMFileAdvise(df->_data, df->_maximalSize, TRI_MADVISE_SEQUENTIAL);
-  TRI_MMFileAdvise(df->_data, df->_maximalSize, TRI_MADVISE_WILLNEED);
   TRI_DEFER(TRI_MMFileAdvise(df->_data, df->_maximalSize,
                              TRI_MADVISE_RANDOM));
 
@@ -884,11 +967,19 @@ int CollectorThread::collect (Logfile* logfile) {
     }
   }
 
-  // now for each collection, write all surviving markers into collection datafiles
+  // now for each collection, write all surviving markers into collection datafiles.
+  // the markers of different collections are written into different datafiles, so
+  // the collections can be handled in parallel
+  std::vector<OperationsType> allOperations;
+  allOperations.reserve(collectionIds.size());
+  std::vector<std::function<int()>> tasks;
+  tasks.reserve(collectionIds.size());
+
   for (auto it = collectionIds.begin(); it != collectionIds.end(); ++it) {
     auto cid = (*it);
 
-    OperationsType sortedOperations;
+    allOperations.emplace_back();
+    OperationsType& sortedOperations = allOperations.back();
 
     // insert structural operations - those are already sorted by tick
     if (state.structuralOperations.find(cid) != state.structuralOperations.end()) {
@@ -913,34 +1004,35 @@ int CollectorThread::collect (Logfile* logfile) {
     }
 
     if (! sortedOperations.empty()) {
-      int res = TRI_ERROR_INTERNAL;
-
-      try {
-        res = transferMarkers(logfile, cid, state.collections[cid], state.operationsCount[cid], sortedOperations);
-      }
-      catch (triagens::basics::Exception const& ex) {
-        res = ex.code();
-      }
-      catch (...) {
-        res = TRI_ERROR_INTERNAL;
-      }
+      TRI_voc_tick_t const databaseId = state.collections[cid];
+      int64_t const operationsCount = state.operationsCount[cid];
+      OperationsType const* operations = &sortedOperations;
 
-      if (res != TRI_ERROR_NO_ERROR &&
-          res != TRI_ERROR_ARANGO_DATABASE_NOT_FOUND &&
-          res != TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+      tasks.emplace_back([this, logfile, cid, databaseId, operationsCount, operations] () -> int {
+        int res = transferMarkers(logfile, cid, databaseId, operationsCount, *operations);
 
-        if (res != TRI_ERROR_ARANGO_FILESYSTEM_FULL) {
-          // other places already log this error, and making the logging conditional here 
-          // prevents the log message from being shown over and over again in case the
-          // file system is full
-          LOG_WARNING("got unexpected error in CollectorThread::collect: %s", TRI_errno_string(res));
+        if (res == TRI_ERROR_ARANGO_DATABASE_NOT_FOUND ||
+            res == TRI_ERROR_ARANGO_COLLECTION_NOT_FOUND) {
+          // these are expected errors
+          res = TRI_ERROR_NO_ERROR;
         }
-        // abort early
         return res;
-      }
+      });
     }
   }
 
+  int res = executeTasks(tasks);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    if (res != TRI_ERROR_ARANGO_FILESYSTEM_FULL) {
+      // other places already log this error, and making the logging conditional here 
+      // prevents the log message from being shown over and over again in case the
+      // file system is full
+      LOG_WARNING("got unexpected error in CollectorThread::collect: %s", TRI_errno_string(res));
+    }
+    return res;
+  }
+
   // TODO: what to do if an error has occurred?
 
   // remove all handled transactions from failedTransactions list
@@ -1233,7 +1325,6 @@ int CollectorThread::executeTransferMarkers (TRI_document_collection_t* document
 int CollectorThread::queueOperations (triagens::wal::Logfile* logfile,
                                       CollectorCache*& cache) {
   TRI_voc_cid_t cid = cache->collectionId;
-  uint64_t maxNumPendingOperations = _logfileManager->throttleWhenPending();
  
   TRI_ASSERT(! cache->operations->empty());
 
@@ -1265,17 +1356,10 @@ int CollectorThread::queueOperations (triagens::wal::Logfile* logfile,
   }
   
   uint64_t numOperations = cache->operations->size();
+  _numPendingOperations.fetch_add(numOperations);
 
-  if (maxNumPendingOperations > 0 && 
-      _numPendingOperations < maxNumPendingOperations &&
-      (_numPendingOperations + numOperations) >= maxNumPendingOperations) {
-    // activate write-throttling!
-    _logfileManager->activateWriteThrottling();
-    LOG_WARNING("queued more than %llu pending WAL collector operations. now activating write-throttling", 
-                (unsigned long long) maxNumPendingOperations);
-  }
-  
-  _numPendingOperations += numOperations;
+  // tighten write-throttling as the backlog grows
+  _logfileManager->updateWritePressure();
 
   // we have put the object into the queue successfully
   // now set the original pointer to null so it isn't double-freed
@@ -1515,14 +1599,12 @@ void CollectorThread::finishMarker (char const* walPosition,
   // re-use the original WAL marker's tick
   marker->_tick = tick;
 
-  // calculate the CRC
-  TRI_voc_crc_t crc = TRI_InitialCrc32();
-  crc = TRI_BlockCrc32(crc, const_cast<char*>(datafilePosition), marker->_size);
-  marker->_crc = TRI_FinalCrc32(crc);
-
   TRI_datafile_t* datafile = cache->lastDatafile;
   TRI_ASSERT(datafile != nullptr);
 
+  // calculate the CRC
+  marker->_crc = TRI_CrcMarkerDatafile(datafile->_version, marker);
+
   // update ticks
   TRI_UpdateTicksDatafile(datafile, marker);
 
@@ -34,6 +34,7 @@
 #include "Basics/ConditionVariable.h"
 #include "Basics/Mutex.h"
 #include "Basics/Thread.h"
+#include "Basics/ThreadPool.h"
 #include "VocBase/datafile.h"
 #include "VocBase/Ditch.h"
 #include "VocBase/document-collection.h"
@@ -210,7 +211,8 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         CollectorThread (LogfileManager*,
-                         TRI_server_t*);
+                         TRI_server_t*,
+                         size_t);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroy the collector thread
@@ -273,6 +275,20 @@ namespace triagens {
 
         bool hasQueuedOperations (TRI_voc_cid_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of operations waiting to be applied
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t numPendingOperations () const {
+          return _numPendingOperations.load();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of collections with queued operations
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numQueuedOperations ();
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    Thread methods
 // -----------------------------------------------------------------------------
@@ -292,10 +308,17 @@ namespace triagens {
       private:
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief return the number of queued operations
+/// @brief execute tasks in parallel, using the worker pool and the current
+/// thread. returns the first error reported by a task
 ////////////////////////////////////////////////////////////////////////////////
 
-        size_t numQueuedOperations ();
+        int executeTasks (std::vector<std::function<int()>> const&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief apply the queued operations of a single collection
+////////////////////////////////////////////////////////////////////////////////
+
+        void processCollectionQueue (std::vector<CollectorCache*>&);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief step 1: perform collection of a logfile (if any)
@@ -439,7 +462,13 @@ namespace triagens {
 /// @brief number of pending operations in collector queue
 ////////////////////////////////////////////////////////////////////////////////
 
-        uint64_t _numPendingOperations;
+        std::atomic<uint64_t> _numPendingOperations;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief worker threads for processing multiple collections in parallel
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::ThreadPool* _workerPool;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief condition variable for the collector thread result
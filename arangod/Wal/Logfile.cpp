@@ -47,8 +47,13 @@ Logfile::Logfile (Logfile::IdType id,
   : _id(id),
     _users(0),
     _df(df),
+    _mappedSize(df == nullptr ? 0 : static_cast<int64_t>(df->_maximalSize)),
     _status(status),
     _collectQueueSize(0) {
+
+  if (_df != nullptr) {
+    TRI_AddMemoryZoneUsage(TRI_WAL_MEM_ZONE, _mappedSize, 1);
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +64,8 @@ Logfile::~Logfile () {
   if (_df != nullptr) {
     TRI_CloseDatafile(_df);
     TRI_FreeDatafile(_df);
+
+    TRI_AddMemoryZoneUsage(TRI_WAL_MEM_ZONE, - _mappedSize, -1);
   }
 }
 
@@ -72,8 +79,9 @@ Logfile::~Logfile () {
 
 Logfile* Logfile::createNew (std::string const& filename,
                              Logfile::IdType id,
-                             uint32_t size) {
-  TRI_datafile_t* df = TRI_CreateDatafile(filename.c_str(), id, static_cast<TRI_voc_size_t>(size), false);
+                             uint32_t size,
+                             bool preallocate) {
+  TRI_datafile_t* df = TRI_CreateDatafile(filename.c_str(), id, static_cast<TRI_voc_size_t>(size), false, preallocate);
 
   if (df == nullptr) {
     int res = TRI_errno();
@@ -203,7 +211,7 @@ TRI_df_header_marker_t Logfile::getHeaderMarker () const {
   size_t const size = sizeof(TRI_df_header_marker_t);
   TRI_InitMarkerDatafile((char*) &header, TRI_DF_MARKER_HEADER, size);
 
-  header._version     = TRI_DF_VERSION;
+  header._version     = _df->_version;
   header._maximalSize = static_cast<TRI_voc_size_t>(allocatedSize());
   header._fid         = static_cast<TRI_voc_fid_t>(_id);
 
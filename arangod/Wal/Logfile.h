@@ -123,7 +123,8 @@ namespace triagens {
 
         static Logfile* createNew (std::string const&,
                                    Logfile::IdType,
-                                   uint32_t);
+                                   uint32_t,
+                                   bool);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief open an existing logfile
@@ -465,6 +466,12 @@ namespace triagens {
 
         TRI_datafile_t* _df;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the size of the mapped datafile, as accounted in the WAL zone
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t const _mappedSize;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief logfile status
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,6 +40,7 @@
 #include "Basics/StringUtils.h"
 #include "Basics/WriteLocker.h"
 #include "Basics/memory-map.h"
+#include "Statistics/MetricsRegistry.h"
 #include "VocBase/server.h"
 #include "Wal/AllocatorThread.h"
 #include "Wal/CollectorThread.h"
@@ -48,6 +49,8 @@
 #include "Wal/Slots.h"
 #include "Wal/SynchronizerThread.h"
 
+#include <thread>
+
 using namespace triagens::wal;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,13 +135,19 @@ LogfileManager::LogfileManager (TRI_server_t* server,
     _server(server),
     _databasePath(databasePath),
     _directory(),
+    _ioMode("zerofill"),
+    _preallocateLogfiles(false),
     _recoverState(nullptr),
     _filesize(32 * 1024 * 1024),
     _reserveLogfiles(4),
     _historicLogfiles(10),
+    _retentionSize(1024 * 1024 * 1024),
+    _retentionTime(3600.0),
     _maxOpenLogfiles(0),
     _numberOfSlots(1048576),
     _syncInterval(100),
+    _syncWindow(500),
+    _collectorThreads(2),
     _maxThrottleWait(15000),
     _throttleWhenPending(0),
     _allowOversizeEntries(true),
@@ -163,10 +172,12 @@ LogfileManager::LogfileManager (TRI_server_t* server,
     _transactionsLock(),
     _transactions(),
     _failedTransactions(),
+    _replicationClientsLock(),
+    _replicationClients(),
     _droppedCollections(),
     _droppedDatabases(),
     _idLock(),
-    _writeThrottled(0),
+    _writeThrottle(),
     _filenameRegex(),
     _shutdown(0) {
 
@@ -240,18 +251,23 @@ void LogfileManager::initialize (std::string* path,
 void LogfileManager::setupOptions (std::map<std::string, triagens::basics::ProgramOptionsDescription>& options) {
   options["Write-ahead log options:help-wal"]
     ("wal.allow-oversize-entries", &_allowOversizeEntries, "allow entries that are bigger than --wal.logfile-size")
+    ("wal.collector-threads", &_collectorThreads, "number of worker threads the collector uses for transferring collections in parallel")
     ("wal.directory", &_directory, "logfile directory")
     ("wal.historic-logfiles", &_historicLogfiles, "maximum number of historic logfiles to keep after collection")
+    ("wal.io-mode", &_ioMode, "how to create new logfiles (\"zerofill\" or \"fallocate\")")
     ("wal.ignore-logfile-errors", &_ignoreLogfileErrors, "ignore logfile errors. this will read recoverable data from corrupted logfiles but ignore any unrecoverable data")
     ("wal.ignore-recovery-errors", &_ignoreRecoveryErrors, "continue recovery even if re-applying operations fails")
     ("wal.logfile-size", &_filesize, "size of each logfile (in bytes)")
     ("wal.open-logfiles", &_maxOpenLogfiles, "maximum number of parallel open logfiles")
     ("wal.reserve-logfiles", &_reserveLogfiles, "maximum number of reserve logfiles to maintain")
+    ("wal.retention-size", &_retentionSize, "maximum size of collected logfiles to keep for replication clients that have not fetched them yet (in bytes)")
+    ("wal.retention-time", &_retentionTime, "keep logfiles only for replication clients that have fetched from the log within this time (in seconds)")
     ("wal.slots", &_numberOfSlots, "number of logfile slots to use")
     ("wal.suppress-shape-information", &_suppressShapeInformation, "do not write shape information for markers (saves a lot of disk space, but effectively disables using the write-ahead log for replication)")
     ("wal.sync-interval", &_syncInterval, "interval for automatic, non-requested disk syncs (in milliseconds)")
+    ("wal.sync-window", &_syncWindow, "maximum time to wait for concurrent writers before a requested disk sync (in microseconds)")
     ("wal.throttle-when-pending", &_throttleWhenPending, "throttle writes when at least this many operations are waiting for collection (set to 0 to deactivate write-throttling)")
-    ("wal.throttle-wait", &_maxThrottleWait, "maximum wait time per operation when write-throttled (in milliseconds)")
+    ("wal.throttle-wait", &_maxThrottleWait, "maximum delay of an operation when write-throttled (in milliseconds)")
   ;
 }
 
@@ -321,6 +337,13 @@ bool LogfileManager::prepare () {
     LOG_FATAL_AND_EXIT("invalid value for --wal.throttle-when-pending. Please use a value of at least %llu", (unsigned long long) MinThrottleWhenPending());
   }
 
+  if (_ioMode == "fallocate") {
+    _preallocateLogfiles = true;
+  }
+  else if (_ioMode != "zerofill") {
+    LOG_FATAL_AND_EXIT("invalid value for --wal.io-mode. Please use either \"zerofill\" or \"fallocate\"");
+  }
+
   if (_syncInterval < MinSyncInterval()) {
     LOG_FATAL_AND_EXIT("invalid value for --wal.sync-interval. Please use a value of at least %llu", (unsigned long long) MinSyncInterval());
   }
@@ -385,6 +408,8 @@ bool LogfileManager::start () {
 
   started = true;
 
+  registerMetrics();
+
   LOG_TRACE("WAL logfile manager configuration: historic logfiles: %lu, reserve logfiles: %lu, filesize: %lu, sync interval: %lu",
             (unsigned long) _historicLogfiles,
             (unsigned long) _reserveLogfiles,
@@ -556,6 +581,8 @@ void LogfileManager::stop () {
 
   _shutdown = 1;
 
+  triagens::basics::MetricsRegistry::instance()->removeCallbacks(this);
+
   LOG_TRACE("shutting down WAL");
 
   // set WAL to read-only mode
@@ -597,6 +624,67 @@ void LogfileManager::stop () {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the tick up to which a replication client has fetched
+////////////////////////////////////////////////////////////////////////////////
+
+void LogfileManager::updateReplicationClient (TRI_voc_tick_t databaseId,
+                                              TRI_server_id_t serverId,
+                                              TRI_voc_tick_t tick) {
+  auto const key = std::make_pair(databaseId, serverId);
+
+  MUTEX_LOCKER(_replicationClientsLock);
+
+  if (tick == 0) {
+    auto it = _replicationClients.find(key);
+
+    if (it != _replicationClients.end()) {
+      (*it).second.first = TRI_microtime();
+    }
+    return;
+  }
+
+  try {
+    auto& client = _replicationClients[key];
+    client.first = TRI_microtime();
+    client.second = tick;
+  }
+  catch (...) {
+    // the client only loses its retained logfiles
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the smallest tick that a replication client has fetched
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_voc_tick_t LogfileManager::minimumReplicationClientTick () {
+  double const expired = TRI_microtime() - _retentionTime;
+  TRI_voc_tick_t result = UINT64_MAX;
+
+  MUTEX_LOCKER(_replicationClientsLock);
+
+  for (auto it = _replicationClients.begin(); it != _replicationClients.end(); /* no hoisting */) {
+    if ((*it).second.first < expired) {
+      LOG_INFO("replication client %llu of database %llu has not fetched from the log for %d seconds. "
+               "its logfiles are no longer kept",
+               (unsigned long long) (*it).first.second,
+               (unsigned long long) (*it).first.first,
+               (int) _retentionTime);
+
+      it = _replicationClients.erase(it);
+      continue;
+    }
+
+    if ((*it).second.second < result) {
+      result = (*it).second.second;
+    }
+    ++it;
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief registers a transaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -927,6 +1015,87 @@ SlotInfoCopy LogfileManager::allocateAndWrite (Marker const& marker,
   return allocateAndWrite(marker.mem(), marker.size(), waitForSync);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write several markers into the logfile, using a single slot
+///
+/// The markers are placed next to each other in the same logfile and each
+/// gets a tick of its own, but they share one slot allocation and one slot
+/// return. result receives one entry per marker.
+///
+/// Document and edge markers are written as they are, so unless shape
+/// information is suppressed, the legends for all of them must already be
+/// present in the current logfile. Otherwise nothing is written and
+/// TRI_ERROR_LEGEND_NOT_IN_WAL_FILE is returned, and the caller should write
+/// the markers one by one.
+////////////////////////////////////////////////////////////////////////////////
+
+int LogfileManager::allocateAndWrite (std::vector<Marker*> const& markers,
+                                      bool waitForSync,
+                                      std::vector<SlotInfoCopy>& result) {
+  TRI_ASSERT(! markers.empty());
+
+  std::vector<std::pair<TRI_voc_cid_t, TRI_shape_sid_t>> legends;
+  uint64_t size = 0;
+
+  for (auto const& marker : markers) {
+    auto m = static_cast<document_marker_t const*>(marker->mem());
+
+    if ((m->_type == TRI_WAL_MARKER_DOCUMENT ||
+         m->_type == TRI_WAL_MARKER_EDGE) &&
+        ! _suppressShapeInformation) {
+      legends.emplace_back(m->_collectionId, m->_shape);
+    }
+
+    size += Marker::alignedSize(marker->size());
+  }
+
+  if (! _allowWrites) {
+    // no writes allowed
+    return TRI_ERROR_ARANGO_READ_ONLY;
+  }
+
+  if (size > MaxEntrySize() ||
+      (size > _filesize && ! _allowOversizeEntries)) {
+    // entries are too big to go into one slot
+    return TRI_ERROR_ARANGO_DOCUMENT_TOO_LARGE;
+  }
+
+  std::vector<Slot::TickType> ticks(markers.size(), 0);
+  SlotInfo slotInfo = _slots->nextUnused(static_cast<uint32_t>(size), legends, ticks);
+
+  if (slotInfo.errorCode != TRI_ERROR_NO_ERROR) {
+    return slotInfo.errorCode;
+  }
+
+  TRI_ASSERT(slotInfo.slot != nullptr);
+
+  try {
+    char const* base = static_cast<char const*>(slotInfo.mem);
+    size_t offset = 0;
+
+    result.clear();
+    result.reserve(markers.size());
+
+    for (size_t i = 0; i < markers.size(); ++i) {
+      Marker* marker = markers[i];
+
+      slotInfo.slot->fill(marker->mem(), marker->size(), offset, ticks[i]);
+      result.emplace_back(base + offset, marker->size(), slotInfo.slot->logfileId(), ticks[i]);
+
+      offset += Marker::alignedSize(marker->size());
+    }
+
+    finalize(slotInfo, waitForSync);
+    return TRI_ERROR_NO_ERROR;
+  }
+  catch (...) {
+    // if we don't return the slot we'll run into serious problems later
+    finalize(slotInfo, false);
+
+    return TRI_ERROR_INTERNAL;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wait for the collector queue to get cleared for the given collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -1456,9 +1625,13 @@ Logfile* LogfileManager::getRemovableLogfile () {
     }
   }
 
+  // replication clients keep the logfiles they have not fetched yet
+  TRI_voc_tick_t const minClientTick = (_retentionSize > 0 ? minimumReplicationClientTick() : UINT64_MAX);
+
   {
     uint32_t numberOfLogfiles = 0;
     uint32_t const minHistoricLogfiles = historicLogfiles();
+    uint64_t removableSize = 0;
     Logfile* first = nullptr;
 
     WRITE_LOCKER(_logfilesLock);
@@ -1478,15 +1651,25 @@ Logfile* LogfileManager::getRemovableLogfile () {
           first = logfile;
         }
 
-        if (++numberOfLogfiles > minHistoricLogfiles) {
-          TRI_ASSERT(first != nullptr);
-          _logfiles.erase(first->id());
+        ++numberOfLogfiles;
+        removableSize += logfile->allocatedSize();
+      }
+    }
 
-          TRI_ASSERT(_logfiles.find(first->id()) == _logfiles.end());
+    if (numberOfLogfiles > minHistoricLogfiles) {
+      TRI_ASSERT(first != nullptr);
 
-          return first;
-        }
+      if (first->df()->_tickMax > minClientTick &&
+          removableSize <= _retentionSize) {
+        // a client still needs the oldest logfile
+        return nullptr;
       }
+
+      _logfiles.erase(first->id());
+
+      TRI_ASSERT(_logfiles.find(first->id()) == _logfiles.end());
+
+      return first;
     }
   }
 
@@ -1509,6 +1692,34 @@ void LogfileManager::decreaseCollectQueueSize (Logfile* logfile) {
   logfile->decreaseCollectQueueSize();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief recomputes the write pressure
+////////////////////////////////////////////////////////////////////////////////
+
+void LogfileManager::updateWritePressure () {
+  uint64_t const maxNumPendingOperations = _throttleWhenPending;
+
+  if (maxNumPendingOperations == 0) {
+    _writeThrottle.update(0.0, 0.0);
+    return;
+  }
+
+  double collectorBacklog = 0.0;
+  CollectorThread* collector = _collectorThread;
+
+  if (collector != nullptr) {
+    collectorBacklog = static_cast<double>(collector->numPendingOperations()) / static_cast<double>(maxNumPendingOperations);
+  }
+
+  double syncBacklog = 0.0;
+
+  if (_slots != nullptr) {
+    syncBacklog = _slots->usage();
+  }
+
+  _writeThrottle.update(collectorBacklog, syncBacklog);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief mark a file as being requested for collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -1582,12 +1793,111 @@ LogfileManagerState LogfileManager::state () {
   LogfileManagerState state;
 
   // now fill the state
-  _slots->statistics(state.lastTick, state.lastDataTick, state.numEvents);
+  _slots->statistics(state.lastTick, state.lastDataTick, state.numEvents, state.numSyncs, state.numSyncedSlots);
+
+  // collector lag
+  state.numPendingCollectorOperations = 0;
+  if (_collectorThread != nullptr) {
+    state.numPendingCollectorOperations = _collectorThread->numPendingOperations();
+  }
+
+  state.numUncollectedLogfiles = 0;
+  {
+    READ_LOCKER(_logfilesLock);
+
+    for (auto const& it : _logfiles) {
+      auto logfile = it.second;
+
+      if (logfile != nullptr && logfile->canBeCollected()) {
+        ++state.numUncollectedLogfiles;
+      }
+    }
+  }
+
   state.timeString = getTimeString();
 
   return state;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers the state of the WAL and the collector in the metrics
+////////////////////////////////////////////////////////////////////////////////
+
+void LogfileManager::registerMetrics () {
+  using triagens::basics::MetricsRegistry;
+
+  auto metrics = MetricsRegistry::instance();
+
+  auto slotStatistics = [this] (int which) -> double {
+    TRI_voc_tick_t lastTick;
+    TRI_voc_tick_t lastDataTick;
+    uint64_t numEvents;
+    uint64_t numSyncs;
+    uint64_t numSyncedSlots;
+
+    _slots->statistics(lastTick, lastDataTick, numEvents, numSyncs, numSyncedSlots);
+
+    switch (which) {
+      case 0:
+        return static_cast<double>(lastTick);
+      case 1:
+        return static_cast<double>(numEvents);
+      default:
+        return static_cast<double>(numSyncs);
+    }
+  };
+
+  metrics->addCallback("arangodb_wal_last_tick", "Last tick written to the WAL",
+                       MetricsRegistry::GAUGE, this, [slotStatistics] () { return slotStatistics(0); });
+  metrics->addCallback("arangodb_wal_events_total", "Number of markers written to the WAL",
+                       MetricsRegistry::COUNTER, this, [slotStatistics] () { return slotStatistics(1); });
+  metrics->addCallback("arangodb_wal_syncs_total", "Number of WAL syncs",
+                       MetricsRegistry::COUNTER, this, [slotStatistics] () { return slotStatistics(2); });
+
+  metrics->addCallback("arangodb_wal_uncollected_logfiles", "Number of sealed WAL logfiles not yet collected",
+                       MetricsRegistry::GAUGE, this, [this] () {
+    double result = 0.0;
+
+    READ_LOCKER(_logfilesLock);
+
+    for (auto const& it : _logfiles) {
+      if (it.second != nullptr && it.second->canBeCollected()) {
+        ++result;
+      }
+    }
+
+    return result;
+  });
+
+  metrics->addCallback("arangodb_wal_collector_pending_operations", "Number of WAL operations not yet transferred to the datafiles",
+                       MetricsRegistry::GAUGE, this, [this] () {
+    CollectorThread* collector = _collectorThread;
+    return (collector == nullptr ? 0.0 : static_cast<double>(collector->numPendingOperations()));
+  });
+  metrics->addCallback("arangodb_wal_collector_queued_collections", "Number of collections with operations queued by the collector",
+                       MetricsRegistry::GAUGE, this, [this] () {
+    CollectorThread* collector = _collectorThread;
+    return (collector == nullptr ? 0.0 : static_cast<double>(collector->numQueuedOperations()));
+  });
+
+  metrics->addCallback("arangodb_wal_throttled", "Whether writes are throttled because the collector falls behind",
+                       MetricsRegistry::GAUGE, this, [this] () {
+    return (isThrottled() ? 1.0 : 0.0);
+  });
+  metrics->addCallback("arangodb_wal_write_pressure", "Backlog of the WAL collector or synchronizer relative to its limit",
+                       MetricsRegistry::GAUGE, this, [this] () {
+    return _writeThrottle.pressure();
+  });
+  metrics->addCallback("arangodb_wal_throttled_writes_total", "Number of write transactions delayed by write-throttling",
+                       MetricsRegistry::COUNTER, this, [this] () {
+    return static_cast<double>(_writeThrottle.numDelayed());
+  });
+  metrics->addCallback("arangodb_wal_rejected_writes_total", "Number of write transactions refused by write-throttling",
+                       MetricsRegistry::COUNTER, this, [this] () {
+    return static_cast<double>(_writeThrottle.numRejected());
+  });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the current available logfile ranges
 ////////////////////////////////////////////////////////////////////////////////
@@ -1899,7 +2209,7 @@ int LogfileManager::writeShutdownInfo (bool writeShutdownTime) {
 ////////////////////////////////////////////////////////////////////////////////
 
 int LogfileManager::startSynchronizerThread () {
-  _synchronizerThread = new SynchronizerThread(this, _syncInterval);
+  _synchronizerThread = new SynchronizerThread(this, _syncInterval, _syncWindow);
 
   if (_synchronizerThread == nullptr) {
     return TRI_ERROR_INTERNAL;
@@ -1969,7 +2279,7 @@ void LogfileManager::stopAllocatorThread () {
 ////////////////////////////////////////////////////////////////////////////////
 
 int LogfileManager::startCollectorThread () {
-  _collectorThread = new CollectorThread(this, _server);
+  _collectorThread = new CollectorThread(this, _server, static_cast<size_t>(_collectorThreads));
 
   if (_collectorThread == nullptr) {
     return TRI_ERROR_INTERNAL;
@@ -2096,28 +2406,95 @@ int LogfileManager::inspectLogfiles () {
   }
 #endif
 
-  for (auto it = _logfiles.begin(); it != _logfiles.end(); ) {
+  // opening a logfile checks the checksums of all its markers, so the
+  // logfiles are opened in parallel first, and then inspected in order
+  std::vector<Logfile::IdType> ids;
+  ids.reserve(_logfiles.size());
+
+  for (auto const& it : _logfiles) {
+    ids.emplace_back(it.first);
+  }
+
+  std::vector<Logfile*> opened(ids.size(), nullptr);
+  std::vector<int> judged(ids.size(), TRI_ERROR_NO_ERROR);
+  std::atomic<size_t> next(0);
+
+  auto opener = [&] () -> void {
+    size_t i;
+
+    while ((i = next++) < ids.size()) {
+      Logfile::IdType const id = ids[i];
+      std::string const filename = logfileName(id);
+
+      judged[i] = Logfile::judge(filename);
+
+      if (judged[i] != TRI_ERROR_ARANGO_DATAFILE_EMPTY) {
+        bool const wasCollected = (id <= _lastCollectedId);
+        opened[i] = Logfile::openExisting(filename, id, wasCollected, _ignoreLogfileErrors);
+
+        if (opened[i] == nullptr) {
+          judged[i] = TRI_errno();
+        }
+      }
+    }
+  };
+
+  size_t numThreads = (std::min)(ids.size(), static_cast<size_t>(std::thread::hardware_concurrency()));
+
+  if (numThreads > 1) {
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+
+    try {
+      for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back(std::thread(opener));
+      }
+    }
+    catch (...) {
+      // the remaining logfiles are opened by this thread
+    }
+
+    opener();
+
+    for (auto& it : threads) {
+      it.join();
+    }
+  }
+  else {
+    opener();
+  }
+
+  // frees the logfiles that were opened but not yet inspected
+  auto freeOpened = [&] (size_t from) -> void {
+    for (size_t i = from; i < opened.size(); ++i) {
+      delete opened[i];
+    }
+  };
+
+  size_t position = 0;
+
+  for (auto it = _logfiles.begin(); it != _logfiles.end(); ++position) {
     Logfile::IdType const id = (*it).first;
     std::string const filename = logfileName(id);
 
     TRI_ASSERT((*it).second == nullptr);
+    TRI_ASSERT(ids[position] == id);
 
-    int res = Logfile::judge(filename);
-
-    if (res == TRI_ERROR_ARANGO_DATAFILE_EMPTY) {
+    if (judged[position] == TRI_ERROR_ARANGO_DATAFILE_EMPTY) {
       _recoverState->emptyLogfiles.push_back(filename);
       _logfiles.erase(it++);
       continue;
     }
 
-    bool const wasCollected = (id <= _lastCollectedId);
-    Logfile* logfile = Logfile::openExisting(filename, id, wasCollected, _ignoreLogfileErrors);
+    Logfile* logfile = opened[position];
 
     if (logfile == nullptr) {
       // an error happened when opening a logfile
       if (! _ignoreLogfileErrors) {
         // we don't ignore errors, so we abort here
-        int res = TRI_errno();
+        int res = judged[position];
+
+        freeOpened(position + 1);
 
         if (res == TRI_ERROR_NO_ERROR) {
           // must have an error!
@@ -2142,6 +2519,7 @@ int LogfileManager::inspectLogfiles () {
     // update the tick statistics  
     if (! TRI_IterateDatafile(logfile->df(), &RecoverState::InitialScanMarker, static_cast<void*>(_recoverState))) {
       LOG_WARNING("WAL inspection failed when scanning logfile '%s'", logfile->filename().c_str());
+      freeOpened(position + 1);
       return TRI_ERROR_ARANGO_RECOVERY;
     }
     
@@ -2203,7 +2581,7 @@ int LogfileManager::createReserveLogfile (uint32_t size) {
     realsize = filesize();
   }
 
-  Logfile* logfile = Logfile::createNew(filename.c_str(), id, realsize);
+  Logfile* logfile = Logfile::createNew(filename.c_str(), id, realsize, _preallocateLogfiles);
 
   if (logfile == nullptr) {
     int res = TRI_errno();
@@ -38,6 +38,7 @@
 #include "Wal/Logfile.h"
 #include "Wal/Marker.h"
 #include "Wal/Slots.h"
+#include "Wal/WriteThrottle.h"
 
 #include <regex.h>
 
@@ -83,6 +84,10 @@ namespace triagens {
       TRI_voc_tick_t  lastTick;
       TRI_voc_tick_t  lastDataTick;
       uint64_t        numEvents;
+      uint64_t        numSyncs;
+      uint64_t        numSyncedSlots;
+      uint64_t        numPendingCollectorOperations;
+      uint64_t        numUncollectedLogfiles;
       std::string     timeString;
     };
 
@@ -318,7 +323,7 @@ namespace triagens {
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief maximum wait time when write-throttled (in milliseconds)
+/// @brief maximum delay of a write-throttled operation (in milliseconds)
 ////////////////////////////////////////////////////////////////////////////////
 
         inline uint64_t maxThrottleWait () const {
@@ -326,7 +331,7 @@ namespace triagens {
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief maximum wait time when write-throttled (in milliseconds)
+/// @brief maximum delay of a write-throttled operation (in milliseconds)
 ////////////////////////////////////////////////////////////////////////////////
 
         inline void maxThrottleWait (uint64_t value) {
@@ -337,25 +342,25 @@ namespace triagens {
 /// @brief whether or not write-throttling is currently enabled
 ////////////////////////////////////////////////////////////////////////////////
 
-        inline bool isThrottled () {
-          return (_writeThrottled != 0);
+        inline bool isThrottled () const {
+          return _writeThrottle.isThrottled();
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief activate write-throttling
+/// @brief returns the admission control for write transactions
 ////////////////////////////////////////////////////////////////////////////////
 
-        void activateWriteThrottling () {
-          _writeThrottled = 1;
+        inline WriteThrottle& writeThrottle () {
+          return _writeThrottle;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief deactivate write-throttling
+/// @brief recomputes the write pressure from the number of operations
+/// pending in the collector and the usage of the slots. called by the
+/// collector and the synchronizer whenever their backlog changes
 ////////////////////////////////////////////////////////////////////////////////
-        
-        void deactivateWriteThrottling () {
-          _writeThrottled = 0;
-        }
+
+        void updateWritePressure ();
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief allow or disallow writes to the WAL
@@ -379,12 +384,27 @@ namespace triagens {
 
         inline void throttleWhenPending (uint64_t value) {
           _throttleWhenPending = value;
-
-          if (_throttleWhenPending == 0) {
-            deactivateWriteThrottling();
-          }
+          updateWritePressure();
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the tick up to which a replication client of a database
+/// has fetched the log. logfiles with later ticks are kept for the client.
+/// a tick of 0 only marks a known client as seen
+////////////////////////////////////////////////////////////////////////////////
+
+        void updateReplicationClient (TRI_voc_tick_t,
+                                      TRI_server_id_t,
+                                      TRI_voc_tick_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the smallest tick that a replication client seen within
+/// the retention time has fetched, or UINT64_MAX if there is none. clients
+/// that have not been seen within the retention time are forgotten
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_voc_tick_t minimumReplicationClientTick ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief registers a transaction
 ////////////////////////////////////////////////////////////////////////////////
@@ -496,6 +516,14 @@ namespace triagens {
         SlotInfoCopy allocateAndWrite (Marker const&,
                                        bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write several markers into the logfile, using a single slot
+////////////////////////////////////////////////////////////////////////////////
+
+        int allocateAndWrite (std::vector<Marker*> const&,
+                              bool,
+                              std::vector<SlotInfoCopy>&);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief wait for the collector queue to get cleared for the given collection
 ////////////////////////////////////////////////////////////////////////////////
@@ -686,6 +714,12 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers the state of the WAL and the collector in the metrics
+////////////////////////////////////////////////////////////////////////////////
+
+        void registerMetrics ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief remove a logfile in the file system
 ////////////////////////////////////////////////////////////////////////////////
@@ -856,6 +890,29 @@ namespace triagens {
 
         std::string _directory;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief how to create new logfiles
+/// @startDocuBlock WalLogfileIoMode
+/// `--wal.io-mode`
+///
+/// Determines how new write-ahead logfiles are created. With the default
+/// value *zerofill*, each new logfile is filled with zeros. With the value
+/// *fallocate*, the disk space for a new logfile is reserved without writing
+/// to it (where the operating system and the filesystem support it). This
+/// avoids the writeback of the zero-filled pages, which can delay the disk
+/// syncs of concurrent write operations. In both modes, logfiles are
+/// accessed via memory mappings.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        std::string _ioMode;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not new logfiles are preallocated (set from _ioMode)
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _preallocateLogfiles;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief state during recovery
 ////////////////////////////////////////////////////////////////////////////////
@@ -918,6 +975,36 @@ namespace triagens {
 
         uint32_t _historicLogfiles;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum size of logfiles kept for replication clients
+/// @startDocuBlock WalLogfileRetentionSize
+/// `--wal.retention-size`
+///
+/// Logfiles that have been garbage-collected are kept beyond the number of
+/// `--wal.historic-logfiles` as long as a replication client still needs
+/// them, i.e. has not fetched all of their data yet. This option limits the
+/// total size of the collected logfiles kept this way (in bytes). If the
+/// limit is exceeded, the oldest logfiles are removed even if clients have
+/// not fetched them yet. Setting it to 0 turns off the retention for
+/// replication clients.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _retentionSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief time for which logfiles are kept for a replication client
+/// @startDocuBlock WalLogfileRetentionTime
+/// `--wal.retention-time`
+///
+/// A replication client keeps logfiles from being removed only if it has
+/// fetched from the log within this many seconds. A client that has been
+/// gone for longer needs a full resynchronization when it comes back.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        double _retentionTime;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum number of parallel open logfiles
 ////////////////////////////////////////////////////////////////////////////////
@@ -956,6 +1043,37 @@ namespace triagens {
 
         uint64_t _syncInterval;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum time to wait for more writers before a requested disk sync
+/// @startDocuBlock WalLogfileSyncWindow
+/// `--wal.sync-window`
+///
+/// The maximum time (in microseconds) the write-ahead log synchronizer will
+/// wait before executing a requested disk sync if there are still other
+/// write operations in progress. All operations that finish within this
+/// window are synchronized to disk with the same sync, which increases the
+/// throughput of concurrent operations executed with *waitForSync*. The
+/// synchronizer does not wait if no other write operations are in progress.
+/// A value of *0* disables waiting.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _syncWindow;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of worker threads used by the collector
+/// @startDocuBlock WalLogfileCollectorThreads
+/// `--wal.collector-threads`
+///
+/// The number of additional threads the write-ahead log collector uses to
+/// transfer the data of different collections into their datafiles in
+/// parallel. A value of *0* makes the collector handle all collections
+/// sequentially in its own thread.
+/// @endDocuBlock
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t _collectorThreads;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief maximum wait time for write-throttling
 ////////////////////////////////////////////////////////////////////////////////
@@ -973,24 +1091,22 @@ namespace triagens {
 /// writtle-throttling will occur. If set to a non-zero value, writte-throttling
 /// will automatically kick in when the garbage-collection queue contains at
 /// least as many elements as specified by this option.
-/// While write-throttling is active, data-modification operations will 
-/// intentionally be delayed by a configurable amount of time. This is to 
-/// ensure the write-ahead log garbage collector can catch up with the 
-/// operations executed.
-/// Write-throttling will stay active until the garbage-collection queue size
-/// goes down below the specified value.
+/// Write-throttling starts when the garbage-collection queue is half full,
+/// or when half of the write-ahead log slots wait to be written or synced.
+/// Data-modification operations are then delayed by an amount of time that
+/// grows with the queue size, so that the garbage collector can catch up
+/// with the operations executed. Once the queue is full, new write
+/// transactions are refused with error *1236* instead of being delayed
+/// further, and HTTP clients receive an *HTTP 503* response with a
+/// *Retry-After* header.
+/// While several databases are written to, a database that causes more
+/// than its share of the writes is delayed and refused first.
 /// Write-throttling is turned off by default.
 ///
 /// `--wal.throttle-wait`
 ///
-/// This option determines the maximum wait time (in milliseconds) for
-/// operations that are write-throttled. If write-throttling is active and a
-/// new write operation is to be executed, it will wait for at most the 
-/// specified amount of time for the write-ahead log garbage-collection queue
-/// size to fall below the throttling threshold. If the queue size decreases
-/// before the maximum wait time is over, the operation will be executed
-/// normally. If the queue size does not decrease before the wait time is over,
-/// the operation will be aborted with an error.
+/// This option determines the maximum delay (in milliseconds) of an
+/// operation that is write-throttled.
 /// This option only has an effect if `--wal.throttle-when-pending` has a 
 /// non-zero value, which is not the default.
 /// @endDocuBlock
@@ -1187,6 +1303,19 @@ namespace triagens {
 
         std::unordered_set<TRI_voc_tid_t> _failedTransactions;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a lock protecting _replicationClients
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _replicationClientsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replication clients by database and server id, with the time they
+/// were last seen and the tick they have fetched up to
+////////////////////////////////////////////////////////////////////////////////
+
+        std::map<std::pair<TRI_voc_tick_t, TRI_server_id_t>, std::pair<double, TRI_voc_tick_t>> _replicationClients;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set of dropped collections
 /// this is populated during recovery and not used afterwards
@@ -1209,10 +1338,10 @@ namespace triagens {
         basics::Mutex _idLock;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief whether or not write-throttling is currently enabled
+/// @brief admission control for write transactions
 ////////////////////////////////////////////////////////////////////////////////
 
-        int _writeThrottled;
+        WriteThrottle _writeThrottle;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief regex to match logfiles
@@ -309,6 +309,15 @@ namespace triagens {
           return buffer;
         }
 
+        // makes the marker refer to its copy in a logfile, as if it had been
+        // created from there
+        inline void moveToLogfile (void const* mem,
+                                   TRI_voc_fid_t fid) {
+          freeBuffer();
+          _buffer = static_cast<char*>(const_cast<void*>(mem));
+          _fid = fid;
+        }
+
         inline TRI_voc_fid_t fid () const {
           return _fid;
         }
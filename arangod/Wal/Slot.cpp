@@ -45,6 +45,7 @@ Slot::Slot ()
     _logfileId(0),
     _mem(nullptr),
     _size(0),
+    _version(TRI_DF_VERSION),
     _status(StatusType::UNUSED) {
 }
 
@@ -57,7 +58,7 @@ Slot::Slot ()
 ////////////////////////////////////////////////////////////////////////////////
 
 std::string Slot::statusText () const {
-  switch (_status) {
+  switch (_status.load()) {
     case StatusType::UNUSED:
       return "unused";
     case StatusType::USED:
@@ -85,21 +86,32 @@ std::string Slot::statusText () const {
 void Slot::fill (void* src,
                  size_t size) {
   TRI_ASSERT(size == _size);
+
+  fill(src, size, 0, _tick);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief same as fill, but for one of several markers sharing the slot
+////////////////////////////////////////////////////////////////////////////////
+
+void Slot::fill (void* src,
+                 size_t size,
+                 size_t offset,
+                 Slot::TickType tick) {
+  TRI_ASSERT(offset + size <= _size);
+  TRI_ASSERT(tick > 0 && tick <= _tick);
   TRI_ASSERT(src != nullptr);
 
   TRI_df_marker_t* marker = static_cast<TRI_df_marker_t*>(src);
 
   // set tick
-  marker->_tick = _tick;
+  marker->_tick = tick;
 
   // set size
   marker->_size = static_cast<TRI_voc_size_t>(size);
 
   // calculate the crc
-  marker->_crc = 0;
-  TRI_voc_crc_t crc = TRI_InitialCrc32();
-  crc = TRI_BlockCrc32(crc, (char const*) marker, static_cast<TRI_voc_size_t>(size));
-  marker->_crc = TRI_FinalCrc32(crc);
+  marker->_crc = TRI_CrcMarkerDatafile(_version, marker);
 
   TRI_IF_FAILURE("WalSlotCrc") {
     // intentionally corrupt the marker
@@ -108,7 +120,7 @@ void Slot::fill (void* src,
   }
 
   // copy data into marker
-  memcpy(_mem, src, size);
+  memcpy(static_cast<char*>(_mem) + offset, src, size);
 }
 
 // -----------------------------------------------------------------------------
@@ -125,7 +137,7 @@ void Slot::setUnused () {
   _logfileId   = 0;
   _mem         = nullptr;
   _size        = 0;
-  _status      = StatusType::UNUSED;
+  _status.store(StatusType::UNUSED, std::memory_order_release);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,13 +147,15 @@ void Slot::setUnused () {
 void Slot::setUsed (void* mem,
                     uint32_t size,
                     Logfile::IdType logfileId,
+                    TRI_df_version_t version,
                     Slot::TickType tick) {
   TRI_ASSERT(isUnused());
   _tick = tick;
   _logfileId = logfileId;
+  _version = static_cast<uint16_t>(version);
   _mem = mem;
   _size = size;
-  _status = StatusType::USED;
+  _status.store(StatusType::USED, std::memory_order_release);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,10 +165,10 @@ void Slot::setUsed (void* mem,
 void Slot::setReturned (bool waitForSync) {
   TRI_ASSERT(isUsed());
   if (waitForSync) {
-    _status = StatusType::RETURNED_WFS;
+    _status.store(StatusType::RETURNED_WFS, std::memory_order_release);
   }
   else {
-    _status = StatusType::RETURNED;
+    _status.store(StatusType::RETURNED, std::memory_order_release);
   }
 }
 
@@ -65,7 +65,7 @@ namespace triagens {
 /// @brief slot status typedef
 ////////////////////////////////////////////////////////////////////////////////
 
-        enum class StatusType : uint32_t {
+        enum class StatusType : uint16_t {
           UNUSED        = 0,
           USED          = 1,
           RETURNED      = 2,
@@ -136,6 +136,16 @@ namespace triagens {
         void fill (void*,
                    size_t);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief same as fill, but for one of several markers sharing the slot.
+/// the marker is placed at the given offset and gets the given tick
+////////////////////////////////////////////////////////////////////////////////
+
+        void fill (void*,
+                   size_t,
+                   size_t,
+                   Slot::TickType);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -147,7 +157,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         inline bool isUnused () const {
-          return _status == StatusType::UNUSED;
+          return _status.load(std::memory_order_acquire) == StatusType::UNUSED;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -155,7 +165,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         inline bool isUsed () const {
-          return _status == StatusType::USED;
+          return _status.load(std::memory_order_acquire) == StatusType::USED;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -163,8 +173,9 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         inline bool isReturned () const {
-          return (_status == StatusType::RETURNED ||
-                  _status == StatusType::RETURNED_WFS);
+          StatusType const status = _status.load(std::memory_order_acquire);
+          return (status == StatusType::RETURNED ||
+                  status == StatusType::RETURNED_WFS);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -172,7 +183,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         inline bool waitForSync () const {
-          return (_status == StatusType::RETURNED_WFS);
+          return (_status.load(std::memory_order_acquire) == StatusType::RETURNED_WFS);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -188,6 +199,7 @@ namespace triagens {
         void setUsed (void*,
                       uint32_t,
                       Logfile::IdType,
+                      TRI_df_version_t,
                       Slot::TickType);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -231,10 +243,18 @@ namespace triagens {
         uint32_t _size;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief slot status
+/// @brief datafile version of the logfile, selects the marker checksum
+////////////////////////////////////////////////////////////////////////////////
+
+        uint16_t _version;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief slot status. slots are handed out and recycled under the slots
+/// lock, but returned without it. the status change publishes the slot's
+/// contents to the synchronizer thread
 ////////////////////////////////////////////////////////////////////////////////
 
-        StatusType _status;
+        std::atomic<StatusType> _status;
 
     };
 
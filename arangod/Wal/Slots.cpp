@@ -55,6 +55,7 @@ Slots::Slots (LogfileManager* logfileManager,
     _slots(nullptr),
     _numberOfSlots(numberOfSlots),
     _freeSlots(numberOfSlots),
+    _returnedSlots(0),
     _waiting(0),
     _handoutIndex(0),
     _recycleIndex(0),
@@ -62,7 +63,9 @@ Slots::Slots (LogfileManager* logfileManager,
     _lastAssignedTick(0),
     _lastCommittedTick(0),
     _lastCommittedDataTick(0),
-    _numEvents(0)  {
+    _numEvents(0),
+    _numSyncs(0),
+    _numSyncedSlots(0) {
     
   _slots = new Slot[numberOfSlots];
 }
@@ -85,11 +88,24 @@ Slots::~Slots () {
 
 void Slots::statistics (Slot::TickType& lastTick,
                         Slot::TickType& lastDataTick,
-                        uint64_t& numEvents) {
+                        uint64_t& numEvents,
+                        uint64_t& numSyncs,
+                        uint64_t& numSyncedSlots) {
   MUTEX_LOCKER(_lock);
-  lastTick     = _lastCommittedTick;
-  lastDataTick = _lastCommittedDataTick;
-  numEvents    = _numEvents;
+  lastTick       = _lastCommittedTick;
+  lastDataTick   = _lastCommittedDataTick;
+  numEvents      = _numEvents;
+  numSyncs       = _numSyncs;
+  numSyncedSlots = _numSyncedSlots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the fraction of the slots that are in use
+////////////////////////////////////////////////////////////////////////////////
+
+double Slots::usage () {
+  MUTEX_LOCKER(_lock);
+  return static_cast<double>(_numberOfSlots - _freeSlots) / static_cast<double>(_numberOfSlots);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -130,8 +146,7 @@ int Slots::flush (bool waitForSync) {
 ////////////////////////////////////////////////////////////////////////////////
 
 Slot::TickType Slots::lastCommittedTick () {
-  MUTEX_LOCKER(_lock);
-  return _lastCommittedTick;
+  return _lastCommittedTick.load(std::memory_order_acquire);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -161,59 +176,10 @@ SlotInfo Slots::nextUnused (uint32_t size) {
         }
 
         // cycle until we have a valid logfile
-        while (_logfile == nullptr ||
-               _logfile->freeSize() < static_cast<uint64_t>(alignedSize)) {
-
-          if (_logfile != nullptr) {
-            // seal existing logfile by creating a footer marker
-            int res = writeFooter(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileSealRequested(_logfile);
-
-            _logfile = nullptr;
-          }
-            
-          TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
-            return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
-          }
-
-          // fetch the next free logfile (this may create a new one)
-          Logfile::StatusType status;
-          int res = newLogfile(alignedSize, status);
-
-          if (res != TRI_ERROR_NO_ERROR) {
-            if (res != TRI_ERROR_ARANGO_NO_JOURNAL) {
-              return SlotInfo(res);
-            }
-
-            usleep(10 * 1000);
-            // try again in next iteration
-          }
-          else {
-            TRI_ASSERT(_logfile != nullptr);
-
-            if (status == Logfile::StatusType::EMPTY) {
-              // initialize the empty logfile by writing a header marker
-              int res = writeHeader(slot);
+        int res = ensureLogfile(slot, alignedSize);
 
-              if (res != TRI_ERROR_NO_ERROR) {
-                return SlotInfo(res);
-              }
-
-              // advance to next slot
-              slot = &_slots[_handoutIndex];
-              _logfileManager->setLogfileOpen(_logfile);
-            }
-            else {
-              TRI_ASSERT(status == Logfile::StatusType::OPEN);
-            }
-          }
+        if (res != TRI_ERROR_NO_ERROR) {
+          return SlotInfo(res);
         }
 
         // if we get here, we got a free slot for the actual data...
@@ -225,7 +191,7 @@ SlotInfo Slots::nextUnused (uint32_t size) {
         }
 
         // only in this case we return a valid slot
-        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
+        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), _logfile->df()->_version, handout());
 
         return SlotInfo(slot);
       }
@@ -288,59 +254,10 @@ SlotInfo Slots::nextUnused (uint32_t size,
         }
 
         // cycle until we have a valid logfile
-        while (_logfile == nullptr ||
-               _logfile->freeSize() < static_cast<uint64_t>(alignedSize)) {
-
-          if (_logfile != nullptr) {
-            // seal existing logfile by creating a footer marker
-            int res = writeFooter(slot);
-
-            if (res != TRI_ERROR_NO_ERROR) {
-              return SlotInfo(res);
-            }
-
-            // advance to next slot
-            slot = &_slots[_handoutIndex];
-            _logfileManager->setLogfileSealRequested(_logfile);
-
-            _logfile = nullptr;
-          }
-            
-          TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
-            return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
-          }
-
-          // fetch the next free logfile (this may create a new one)
-          Logfile::StatusType status;
-          int res = newLogfile(alignedSize, status);
-
-          if (res != TRI_ERROR_NO_ERROR) {
-            if (res != TRI_ERROR_ARANGO_NO_JOURNAL) {
-              return SlotInfo(res);
-            }
+        int res = ensureLogfile(slot, alignedSize);
 
-            usleep(10 * 1000);
-            // try again in next iteration
-          }
-          else {
-            TRI_ASSERT(_logfile != nullptr);
-
-            if (status == Logfile::StatusType::EMPTY) {
-              // initialize the empty logfile by writing a header marker
-              int res = writeHeader(slot);
-
-              if (res != TRI_ERROR_NO_ERROR) {
-                return SlotInfo(res);
-              }
-
-              // advance to next slot
-              slot = &_slots[_handoutIndex];
-              _logfileManager->setLogfileOpen(_logfile);
-            }
-            else {
-              TRI_ASSERT(status == Logfile::StatusType::OPEN);
-            }
-          }
+        if (res != TRI_ERROR_NO_ERROR) {
+          return SlotInfo(res);
         }
 
         // if we get here, we got a free slot for the actual data...
@@ -367,7 +284,100 @@ SlotInfo Slots::nextUnused (uint32_t size,
         }
 
         // only in this case we return a valid slot
-        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), handout());
+        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), _logfile->df()->_version, handout());
+
+        return SlotInfo(slot);
+      }
+    }
+    
+    // if we get here, all slots are busy
+    CONDITION_LOCKER(guard, _condition);
+    if (! hasWaited) {
+      ++_waiting;
+      hasWaited = true;
+    }
+
+    bool mustWait;
+    {
+      MUTEX_LOCKER(_lock);
+      mustWait = (_freeSlots == 0);
+    }
+
+    if (mustWait) {
+      guard.wait(10 * 1000);
+    }
+  }
+
+  return SlotInfo(TRI_ERROR_ARANGO_NO_JOURNAL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the next unused slot, version for several markers
+///
+/// See explanations in arangod/Wal/LogfileManager.cpp in the
+/// corresponding allocateAndWrite method.
+////////////////////////////////////////////////////////////////////////////////
+
+SlotInfo Slots::nextUnused (uint32_t size,
+                            std::vector<std::pair<TRI_voc_cid_t, TRI_shape_sid_t>> const& legends,
+                            std::vector<Slot::TickType>& ticks) {
+  // we need to use the aligned size for writing
+  uint32_t alignedSize = TRI_DF_ALIGN_BLOCK(size);
+  int iterations = 0;
+  bool hasWaited = false;
+
+  TRI_ASSERT(size > 0);
+  TRI_ASSERT(! ticks.empty());
+
+  while (++iterations < 1000) {
+    {
+      MUTEX_LOCKER(_lock);
+
+      Slot* slot = &_slots[_handoutIndex];
+      TRI_ASSERT(slot != nullptr);
+
+      if (slot->isUnused()) {
+        if (hasWaited) {
+          CONDITION_LOCKER(guard, _condition);
+          TRI_ASSERT(_waiting > 0);
+          --_waiting;
+        }
+
+        // cycle until we have a valid logfile
+        int res = ensureLogfile(slot, alignedSize);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          return SlotInfo(res);
+        }
+
+        // if we get here, we got a free slot for the actual data...
+
+        // the markers cannot carry legends, so all of them must be present
+        // in the logfile already
+        for (auto const& it : legends) {
+          if (_logfile->lookupLegend(it.first, it.second) == nullptr) {
+            return SlotInfo(TRI_ERROR_LEGEND_NOT_IN_WAL_FILE);
+          }
+        }
+
+        char* mem = _logfile->reserve(alignedSize);
+
+        if (mem == nullptr) {
+          return SlotInfo(TRI_ERROR_INTERNAL);
+        }
+
+        // each marker gets a tick of its own. the slot itself carries the
+        // last one, so a synced slot covers all of them
+        size_t const n = ticks.size();
+
+        for (size_t i = 0; i < n - 1; ++i) {
+          ticks[i] = static_cast<Slot::TickType>(TRI_NewTickServer());
+        }
+
+        ticks[n - 1] = handout();
+
+        // only in this case we return a valid slot
+        slot->setUsed(static_cast<void*>(mem), size, _logfile->id(), _logfile->df()->_version, ticks[n - 1]);
 
         return SlotInfo(slot);
       }
@@ -405,11 +415,13 @@ void Slots::returnUsed (SlotInfo& slotInfo,
 
   TRI_ASSERT(tick > 0);
 
-  {
-    MUTEX_LOCKER(_lock);
-    slotInfo.slot->setReturned(waitForSync);
-    ++_numEvents;
-  }
+  // returning a slot does not need the slots lock, so writers that finished
+  // filling their slots do not contend with writers that acquire new ones.
+  // the counter is increased first so it never drops below the number of
+  // returned slots the synchronizer can see
+  ++_returnedSlots;
+  ++_numEvents;
+  slotInfo.slot->setReturned(waitForSync);
 
   _logfileManager->signalSync();
 
@@ -498,6 +510,18 @@ SyncRegion Slots::getSyncRegion () {
   return region;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not there are slots that were handed out but not yet
+/// returned
+////////////////////////////////////////////////////////////////////////////////
+
+bool Slots::hasUnreturnedSlots () {
+  MUTEX_LOCKER(_lock);
+
+  TRI_ASSERT(_numberOfSlots - _freeSlots >= _returnedSlots);
+  return (_numberOfSlots - _freeSlots) > _returnedSlots;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a region to the freelist
 ////////////////////////////////////////////////////////////////////////////////
@@ -510,6 +534,8 @@ void Slots::returnSyncRegion (SyncRegion const& region) {
   {
     MUTEX_LOCKER(_lock);
 
+    ++_numSyncs;
+
     while (true) {
       Slot* slot = &_slots[slotIndex];
       TRI_ASSERT(slot != nullptr);
@@ -517,21 +543,32 @@ void Slots::returnSyncRegion (SyncRegion const& region) {
       // note last tick
       Slot::TickType tick = slot->tick();
       TRI_ASSERT(tick >= _lastCommittedTick);
-      _lastCommittedTick = tick;
-
-      // update the data tick
-      TRI_df_marker_t const* m = static_cast<TRI_df_marker_t const*>(slot->mem());
-      if (m->_type != TRI_DF_MARKER_HEADER && 
-          m->_type != TRI_DF_MARKER_FOOTER && 
-          m->_type != TRI_WAL_MARKER_ATTRIBUTE &&
-          m->_type != TRI_WAL_MARKER_SHAPE) {
-        _lastCommittedDataTick = tick;
-      }
+      _lastCommittedTick.store(tick, std::memory_order_release);
+
+      // update the data tick. a slot may hold several adjacent markers
+      char const* p = static_cast<char const*>(slot->mem());
+      char const* end = p + slot->size();
+
+      while (p < end) {
+        TRI_df_marker_t const* m = reinterpret_cast<TRI_df_marker_t const*>(p);
+
+        if (m->_type != TRI_DF_MARKER_HEADER && 
+            m->_type != TRI_DF_MARKER_FOOTER && 
+            m->_type != TRI_WAL_MARKER_ATTRIBUTE &&
+            m->_type != TRI_WAL_MARKER_SHAPE) {
+          _lastCommittedDataTick = tick;
+        }
 
-      region.logfile->update(m);
+        region.logfile->update(m);
+
+        p += TRI_DF_ALIGN_BLOCK(m->_size);
+      }
 
       slot->setUnused();
       ++_freeSlots;
+      TRI_ASSERT(_returnedSlots > 0);
+      --_returnedSlots;
+      ++_numSyncedSlots;
 
       // update recycle index, too
       if (++_recycleIndex >= _numberOfSlots) {
@@ -711,6 +748,74 @@ int Slots::closeLogfile (Slot::TickType& lastCommittedTick,
   return TRI_ERROR_ARANGO_NO_JOURNAL;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief make sure there is an open logfile with room for the given number
+/// of bytes, sealing the current logfile if it is too full. slot is advanced
+/// past header and footer markers written on the way. the caller must hold
+/// the slots lock
+////////////////////////////////////////////////////////////////////////////////
+
+int Slots::ensureLogfile (Slot*& slot,
+                          uint32_t alignedSize) {
+  // cycle until we have a valid logfile
+  while (_logfile == nullptr ||
+         _logfile->freeSize() < static_cast<uint64_t>(alignedSize)) {
+
+    if (_logfile != nullptr) {
+      // seal existing logfile by creating a footer marker
+      int res = writeFooter(slot);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      // advance to next slot
+      slot = &_slots[_handoutIndex];
+      _logfileManager->setLogfileSealRequested(_logfile);
+
+      _logfile = nullptr;
+    }
+      
+    TRI_IF_FAILURE("LogfileManagerGetWriteableLogfile") {
+      return TRI_ERROR_ARANGO_NO_JOURNAL;
+    }
+
+    // fetch the next free logfile (this may create a new one)
+    Logfile::StatusType status;
+    int res = newLogfile(alignedSize, status);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      if (res != TRI_ERROR_ARANGO_NO_JOURNAL) {
+        return res;
+      }
+
+      usleep(10 * 1000);
+      // try again in next iteration
+    }
+    else {
+      TRI_ASSERT(_logfile != nullptr);
+
+      if (status == Logfile::StatusType::EMPTY) {
+        // initialize the empty logfile by writing a header marker
+        int res = writeHeader(slot);
+
+        if (res != TRI_ERROR_NO_ERROR) {
+          return res;
+        }
+
+        // advance to next slot
+        slot = &_slots[_handoutIndex];
+        _logfileManager->setLogfileOpen(_logfile);
+      }
+      else {
+        TRI_ASSERT(status == Logfile::StatusType::OPEN);
+      }
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write a header marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -722,8 +827,9 @@ int Slots::writeHeader (Slot* slot) {
   TRI_df_marker_t* mem = reinterpret_cast<TRI_df_marker_t*>(_logfile->reserve(size));
   TRI_ASSERT(mem != nullptr);
 
-  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), handout());
+  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), _logfile->df()->_version, handout());
   slot->fill(&header.base, size);
+  ++_returnedSlots;
   slot->setReturned(false); // sync
 
   return TRI_ERROR_NO_ERROR;
@@ -742,8 +848,9 @@ int Slots::writeFooter (Slot* slot) {
   TRI_df_marker_t* mem = reinterpret_cast<TRI_df_marker_t*>(_logfile->reserve(size));
   TRI_ASSERT(mem != nullptr);
 
-  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), handout());
+  slot->setUsed(static_cast<void*>(mem), static_cast<uint32_t>(size), _logfile->id(), _logfile->df()->_version, handout());
   slot->fill(&footer.base, size);
+  ++_returnedSlots;
   slot->setReturned(true); // sync
 
   return TRI_ERROR_NO_ERROR;
@@ -789,6 +896,36 @@ bool Slots::waitForTick (Slot::TickType tick) {
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait until data with a tick higher than the specified one has been
+/// synced, or until the timeout has passed
+////////////////////////////////////////////////////////////////////////////////
+
+bool Slots::waitForDataTick (Slot::TickType tick,
+                             uint64_t timeout) {
+  double const end = TRI_microtime() + static_cast<double>(timeout) / 1000000.0;
+
+  CONDITION_LOCKER(guard, _condition);
+
+  // make the synchronizer signal each synced region
+  ++_waiting;
+
+  while (_lastCommittedDataTick.load() <= tick) {
+    double const now = TRI_microtime();
+
+    if (now >= end) {
+      break;
+    }
+
+    guard.wait(static_cast<uint64_t>((end - now) * 1000000.0));
+  }
+
+  TRI_ASSERT(_waiting > 0);
+  --_waiting;
+
+  return (_lastCommittedDataTick.load() > tick);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief request a new logfile which can satisfy a marker of the
 /// specified size
@@ -55,6 +55,17 @@ namespace triagens {
           errorCode(TRI_ERROR_NO_ERROR) {
       }
 
+      SlotInfoCopy (void const* mem,
+                    uint32_t size,
+                    Logfile::IdType logfileId,
+                    Slot::TickType tick)
+        : mem(mem),
+          size(size),
+          logfileId(logfileId),
+          tick(tick),
+          errorCode(TRI_ERROR_NO_ERROR) {
+      }
+
       explicit SlotInfoCopy (int errorCode)
         : mem(nullptr),
           size(0),
@@ -142,8 +153,17 @@ namespace triagens {
 
         void statistics (Slot::TickType&,
                          Slot::TickType&,
+                         uint64_t&,
+                         uint64_t&,
                          uint64_t&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the fraction of the slots that are in use, i.e. that are
+/// being written or wait for their synchronization
+////////////////////////////////////////////////////////////////////////////////
+
+        double usage ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief execute a flush operation
 ////////////////////////////////////////////////////////////////////////////////
@@ -172,6 +192,15 @@ namespace triagens {
                              uint32_t legendIncluded,
                              void*& oldLegend);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the next unused slot, version for several markers. ticks
+/// must have one element per marker and receives their ticks
+////////////////////////////////////////////////////////////////////////////////
+
+        SlotInfo nextUnused (uint32_t size,
+                             std::vector<std::pair<TRI_voc_cid_t, TRI_shape_sid_t>> const& legends,
+                             std::vector<Slot::TickType>& ticks);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a used slot, allowing its synchronization
 ////////////////////////////////////////////////////////////////////////////////
@@ -185,6 +214,14 @@ namespace triagens {
 
         SyncRegion getSyncRegion ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not there are slots that were handed out but not yet
+/// returned. the synchronizer uses this to decide whether waiting a bit
+/// longer will let more writers join a group commit
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasUnreturnedSlots ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return a region to the freelist
 ////////////////////////////////////////////////////////////////////////////////
@@ -220,6 +257,13 @@ namespace triagens {
         int closeLogfile (Slot::TickType&,
                           bool&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief make sure there is an open logfile with room for a marker
+////////////////////////////////////////////////////////////////////////////////
+
+        int ensureLogfile (Slot*&,
+                           uint32_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write a header marker
 ////////////////////////////////////////////////////////////////////////////////
@@ -244,6 +288,15 @@ namespace triagens {
 
         bool waitForTick (Slot::TickType);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait until data with a tick higher than the specified one has been
+/// synced, or until the timeout (in microseconds) has passed. returns whether
+/// there is such data
+////////////////////////////////////////////////////////////////////////////////
+
+        bool waitForDataTick (Slot::TickType,
+                              uint64_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief request a new logfile which can satisfy a marker of the
 /// specified size
@@ -294,6 +347,12 @@ namespace triagens {
 
         size_t _freeSlots;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of slots that were returned but not yet synced
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _returnedSlots;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief whether or not someone is waiting for a slot
 ////////////////////////////////////////////////////////////////////////////////
@@ -325,22 +384,38 @@ namespace triagens {
         Slot::TickType _lastAssignedTick;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief last committed tick value
+/// @brief last committed tick value. this is only modified by the
+/// synchronizer thread (under the slots lock) in tick order, but can be read
+/// without the lock
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType _lastCommittedTick;
+        std::atomic<Slot::TickType> _lastCommittedTick;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief last committed data tick value
+/// @brief last committed data tick value. this is only modified by the
+/// synchronizer thread (under the slots lock), but can be read without the
+/// lock
 ////////////////////////////////////////////////////////////////////////////////
 
-        Slot::TickType _lastCommittedDataTick;
+        std::atomic<Slot::TickType> _lastCommittedDataTick;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief number of log events handled
 ////////////////////////////////////////////////////////////////////////////////
 
-        uint64_t _numEvents;
+        std::atomic<uint64_t> _numEvents;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of sync regions synced (i.e. number of group commits)
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _numSyncs;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of slots synced in all sync regions
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t _numSyncedSlots;
 
     };
 
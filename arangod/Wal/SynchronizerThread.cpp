@@ -52,13 +52,15 @@ using namespace triagens::wal;
 ////////////////////////////////////////////////////////////////////////////////
 
 SynchronizerThread::SynchronizerThread (LogfileManager* logfileManager,
-                                        uint64_t syncInterval)
+                                        uint64_t syncInterval,
+                                        uint64_t syncWindow)
   : Thread("WalSynchronizer"),
     _logfileManager(logfileManager),
     _condition(),
     _waiting(0),
     _stop(0),
     _syncInterval(syncInterval),
+    _syncWindow(syncWindow),
     _logfileCache({ 0, -1 }) {
 
   allowAsynchronousCancelation();
@@ -129,6 +131,12 @@ void SynchronizerThread::run () {
       iterations = 0;
 
       try {
+        if (waiting > 0 && stop == 0) {
+          // someone requested a sync. give concurrent writers a chance to
+          // return their slots so all of them are covered by the same sync
+          waitForGroupCommit();
+        }
+
         // sync as much as we can in this loop
         bool checkMore = false;
         while (true) {
@@ -252,9 +260,43 @@ int SynchronizerThread::doSync (bool& checkMore) {
   checkMore = region.checkMore;
 
   _logfileManager->slots()->returnSyncRegion(region);
+
+  // the synced slots are free again
+  _logfileManager->updateWritePressure();
+
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for more writers to return their slots, so they can be synced
+/// together with the already returned ones
+///
+/// waiting ends when no more slots are outstanding or when the sync window
+/// has elapsed, whatever comes first. every returned slot signals the
+/// condition, so a burst of writers is collected without extra latency
+////////////////////////////////////////////////////////////////////////////////
+
+void SynchronizerThread::waitForGroupCommit () {
+  if (_syncWindow == 0) {
+    return;
+  }
+
+  double const end = TRI_microtime() + static_cast<double>(_syncWindow) / 1000000.0;
+  auto slots = _logfileManager->slots();
+  
+  CONDITION_LOCKER(guard, _condition);
+
+  while (_stop == 0 && slots->hasUnreturnedSlots()) {
+    double const now = TRI_microtime();
+
+    if (now >= end) {
+      break;
+    }
+
+    guard.wait(static_cast<uint64_t>((end - now) * 1000000.0) + 1);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get a logfile descriptor (it caches the descriptor for performance)
 ////////////////////////////////////////////////////////////////////////////////
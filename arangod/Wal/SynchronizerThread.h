@@ -66,6 +66,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         SynchronizerThread (LogfileManager*,
+                            uint64_t,
                             uint64_t);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -116,6 +117,13 @@ namespace triagens {
 
         int doSync (bool&);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait for more writers to return their slots, so they can be synced
+/// together with the already returned ones
+////////////////////////////////////////////////////////////////////////////////
+
+        void waitForGroupCommit ();
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get a logfile descriptor (it caches the descriptor for performance)
 ////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +166,12 @@ namespace triagens {
 
         uint64_t const _syncInterval;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum time to wait for more slots before syncing (in microseconds)
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t const _syncWindow;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief logfile descriptor cache
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief admission of write transactions while the WAL falls behind
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "WriteThrottle.h"
+
+#include "Basics/logging.h"
+#include "Basics/MutexLocker.h"
+
+using namespace triagens::wal;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of seconds a rejected client is asked to wait
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const MaxRetryAfter = 30;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class WriteThrottle
+// -----------------------------------------------------------------------------
+
+double const WriteThrottle::LowWatermark = 0.5;
+
+uint64_t const WriteThrottle::MaxDelay = 100000;
+
+double const WriteThrottle::Window = 1.0;
+
+double const WriteThrottle::MinWeight = 0.5;
+
+double const WriteThrottle::MaxWeight = 2.0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+WriteThrottle::WriteThrottle ()
+  : _pressure(0.0),
+    _numDelayed(0),
+    _numRejected(0),
+    _lock(),
+    _shares(),
+    _total(),
+    _windowStart(0.0) {
+}
+
+WriteThrottle::~WriteThrottle () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the backlogs, each relative to its limit
+////////////////////////////////////////////////////////////////////////////////
+
+void WriteThrottle::update (double collectorBacklog,
+                            double syncBacklog) {
+  double const pressure = (std::max)(collectorBacklog, syncBacklog);
+  double const previous = _pressure.exchange(pressure, std::memory_order_relaxed);
+
+  if (previous < LowWatermark && pressure >= LowWatermark) {
+    LOG_INFO("WAL collector or synchronizer falls behind, throttling writes");
+  }
+  else if (previous >= LowWatermark && pressure < LowWatermark) {
+    LOG_INFO("WAL collector and synchronizer have caught up, no longer throttling writes");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief admits a write transaction of a database
+////////////////////////////////////////////////////////////////////////////////
+
+int WriteThrottle::admit (TRI_voc_tick_t databaseId,
+                          uint64_t& delay) {
+  delay = 0;
+
+  double pressure = this->pressure();
+
+  if (pressure < LowWatermark) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  pressure *= weigh(databaseId);
+
+  if (pressure >= 1.0) {
+    ++_numRejected;
+    return TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT;
+  }
+
+  if (pressure > LowWatermark) {
+    delay = static_cast<uint64_t>(MaxDelay * (pressure - LowWatermark) / (1.0 - LowWatermark));
+    ++_numDelayed;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of seconds a rejected client should wait
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t WriteThrottle::retryAfter () const {
+  double const pressure = this->pressure();
+
+  if (pressure <= 1.0) {
+    return 1;
+  }
+
+  // the collector runs at least once per second, so one more second per
+  // tenth of the limit the backlog exceeds it by
+  uint64_t const seconds = 1 + static_cast<uint64_t>((pressure - 1.0) * 10.0);
+
+  return (std::min)(seconds, MaxRetryAfter);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a write of a database and returns the factor for its
+/// pressure
+////////////////////////////////////////////////////////////////////////////////
+
+double WriteThrottle::weigh (TRI_voc_tick_t databaseId) {
+  double const now = TRI_microtime();
+
+  MUTEX_LOCKER(_lock);
+
+  if (now - _windowStart >= Window) {
+    // start a new window. the counts of the window before the previous one
+    // are dropped, and so are the databases that have not written since
+    bool const skipped = (now - _windowStart >= 2.0 * Window);
+
+    for (auto it = _shares.begin(); it != _shares.end(); /* no hoisting */) {
+      Share& share = (*it).second;
+      share.previous = (skipped ? 0 : share.current);
+      share.current = 0;
+
+      if (share.previous == 0) {
+        it = _shares.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+
+    _total.previous = (skipped ? 0 : _total.current);
+    _total.current = 0;
+    _windowStart = now;
+  }
+
+  Share& share = _shares[databaseId];
+  ++share.current;
+  ++_total.current;
+
+  // the share of the database relative to an equal share of all databases
+  // that have written recently. this is 1 if only one database writes
+  double const writes = static_cast<double>(share.current + share.previous);
+  double const total = static_cast<double>(_total.current + _total.previous);
+  double const weight = writes * static_cast<double>(_shares.size()) / total;
+
+  return (std::max)(MinWeight, (std::min)(MaxWeight, weight));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,237 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief admission of write transactions while the WAL falls behind
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_WAL_WRITE_THROTTLE_H
+#define ARANGODB_WAL_WRITE_THROTTLE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/Mutex.h"
+#include "VocBase/voc-types.h"
+
+namespace triagens {
+  namespace wal {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class WriteThrottle
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decides whether a write transaction may start, and how long it
+/// must wait before
+///
+/// the pressure is the larger of the collector backlog and the sync backlog,
+/// both relative to their limits. below LowWatermark writes are admitted
+/// without delay and without taking a lock. above it, the delay grows
+/// linearly with the pressure up to MaxDelay, and a write is rejected once
+/// the pressure reaches 1, so that clients back off instead of occupying a
+/// server thread.
+///
+/// while writes are throttled, the pressure seen by a database is scaled by
+/// its share of the recent writes relative to an equal share of all writing
+/// databases. a database that writes much more than the others absorbs most
+/// of the delay, and a database that writes little still gets through
+////////////////////////////////////////////////////////////////////////////////
+
+    class WriteThrottle {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+      private:
+
+        struct Share {
+          Share ()
+            : current(0),
+              previous(0) {
+          }
+
+          uint64_t current;
+          uint64_t previous;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        WriteThrottle (WriteThrottle const&) = delete;
+        WriteThrottle& operator= (WriteThrottle const&) = delete;
+
+        WriteThrottle ();
+
+        ~WriteThrottle ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the backlogs, each relative to its limit
+////////////////////////////////////////////////////////////////////////////////
+
+        void update (double collectorBacklog,
+                     double syncBacklog);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current pressure
+////////////////////////////////////////////////////////////////////////////////
+
+        double pressure () const {
+          return _pressure.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not writes are currently delayed
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isThrottled () const {
+          return pressure() >= LowWatermark;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief admits a write transaction of a database. returns
+/// TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT if the write must not start now,
+/// and otherwise sets delay to the number of microseconds it must wait
+////////////////////////////////////////////////////////////////////////////////
+
+        int admit (TRI_voc_tick_t databaseId,
+                   uint64_t& delay);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of seconds a rejected client should wait
+/// before it retries
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t retryAfter () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of delayed writes
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t numDelayed () const {
+          return _numDelayed.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of rejected writes
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t numRejected () const {
+          return _numRejected.load(std::memory_order_relaxed);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a write of a database and returns the factor for its
+/// pressure
+////////////////////////////////////////////////////////////////////////////////
+
+        double weigh (TRI_voc_tick_t databaseId);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public variables
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pressure above which writes are delayed
+////////////////////////////////////////////////////////////////////////////////
+
+        static double const LowWatermark;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief delay of a write just below a pressure of 1, in microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const MaxDelay;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief length of the window in which the writes per database are
+/// counted, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+        static double const Window;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bounds of the factor applied to the pressure of a database
+////////////////////////////////////////////////////////////////////////////////
+
+        static double const MinWeight;
+
+        static double const MaxWeight;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        std::atomic<double> _pressure;
+
+        std::atomic<uint64_t> _numDelayed;
+
+        std::atomic<uint64_t> _numRejected;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the shares and the window
+////////////////////////////////////////////////////////////////////////////////
+
+        basics::Mutex _lock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the writes per database in the current and the previous window
+////////////////////////////////////////////////////////////////////////////////
+
+        std::unordered_map<TRI_voc_tick_t, Share> _shares;
+
+        Share _total;
+
+        double _windowStart;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
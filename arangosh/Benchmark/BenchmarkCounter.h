@@ -105,10 +105,12 @@ namespace triagens {
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief get the next x until the max is reached
+/// @brief get the next x until the max is reached. if first is given, it
+/// receives the number of the first operation handed out
 ////////////////////////////////////////////////////////////////////////////////
 
-        T next (const T value) {
+        T next (const T value,
+                T* first = nullptr) {
           T realValue = value;
 
           if (value == 0) {
@@ -118,6 +120,10 @@ namespace triagens {
           MUTEX_LOCKER(this->_mutex);
 
           T oldValue = _value;
+
+          if (first != nullptr) {
+            *first = oldValue;
+          }
           if (oldValue + realValue > _maxValue) {
             _value = _maxValue;
             return _maxValue - oldValue;
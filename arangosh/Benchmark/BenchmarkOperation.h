@@ -90,6 +90,15 @@ namespace triagens {
 
       virtual const char* payload (size_t*, const int, const size_t, const size_t, bool*) = 0;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the name the latency of the operation is reported under.
+/// the default is empty, which reports it under its method and URL
+////////////////////////////////////////////////////////////////////////////////
+
+      virtual std::string name (const int, const size_t, const size_t) {
+        return std::string();
+      }
+
     };
   }
 }
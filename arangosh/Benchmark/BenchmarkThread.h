@@ -39,6 +39,7 @@
 #include "Basics/Thread.h"
 #include "Benchmark/BenchmarkCounter.h"
 #include "Benchmark/BenchmarkOperation.h"
+#include "Benchmark/ReplayLog.h"
 #include "Rest/HttpResponse.h"
 #include "SimpleHttpClient/SimpleHttpClient.h"
 #include "SimpleHttpClient/GeneralClientConnection.h"
@@ -77,6 +78,8 @@ namespace triagens {
                          uint32_t sslProtocol,
                          bool keepAlive,
                          bool async,
+                         double rate,
+                         double warmup,
                          bool verbose)
           : Thread("arangob"),
             _operation(operation),
@@ -96,11 +99,16 @@ namespace triagens {
             _sslProtocol(sslProtocol),
             _keepAlive(keepAlive),
             _async(async),
+            _rate(rate),
+            _warmup(warmup),
+            _start(0.0),
             _client(nullptr),
             _connection(nullptr),
             _offset(0),
             _counter(0),
             _time(0.0),
+            _names(),
+            _statistics(),
             _verbose(verbose) {
 
           _errorHeader = basics::StringUtils::tolower(rest::HttpResponse::BatchErrorHeader);
@@ -180,18 +188,33 @@ namespace triagens {
           }
 
           while (1) {
-            unsigned long numOps = _operationsCounter->next(_batchSize);
+            unsigned long first = 0;
+            unsigned long numOps = _operationsCounter->next(_batchSize, &first);
 
             if (numOps == 0) {
               break;
             }
 
+            double scheduled = 0.0;
+
+            if (_rate > 0.0) {
+              // open loop: the operation is due at a fixed time, whether or
+              // not the previous ones have been answered
+              scheduled = _start + static_cast<double>(first) / _rate;
+
+              double const wait = scheduled - TRI_microtime();
+
+              if (wait > 0.0) {
+                usleep(static_cast<unsigned long>(wait * 1000000.0));
+              }
+            }
+
             if (_batchSize < 1) {
-              executeSingleRequest();
+              executeSingleRequest(scheduled);
             }
             else {
               try {
-                executeBatchRequest(numOps);
+                executeBatchRequest(numOps, scheduled);
               }
               catch (triagens::basics::Exception const& ex) {
                 LOG_FATAL_AND_EXIT("Caught exception during test execution: %d %s",
@@ -239,11 +262,49 @@ namespace triagens {
           }
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the latency of a request. in open-loop mode the latency
+/// is measured from the time the request was due, so that the time a
+/// request waits for a free connection is not omitted. requests due during
+/// the warm-up are not recorded
+////////////////////////////////////////////////////////////////////////////////
+
+        void recordLatency (std::string const& name,
+                            double start,
+                            double scheduled,
+                            bool failed) {
+          double const end = TRI_microtime();
+          double const begin = (scheduled > 0.0 ? scheduled : start);
+
+          if (begin < _start + _warmup) {
+            return;
+          }
+
+          size_t i = 0;
+
+          while (i < _names.size() && _names[i] != name) {
+            ++i;
+          }
+
+          if (i == _names.size()) {
+            _names.emplace_back(name);
+            _statistics.emplace_back();
+          }
+
+          ReplayStatistics& statistics = _statistics[i];
+          statistics._latency.addFigure(static_cast<uint64_t>((std::max)(0.0, end - begin) * 1000000.0));
+
+          if (failed) {
+            ++statistics._failures;
+          }
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief execute a batch request with numOperations parts
 ////////////////////////////////////////////////////////////////////////////////
 
-        void executeBatchRequest (const unsigned long numOperations) {
+        void executeBatchRequest (const unsigned long numOperations,
+                                  double scheduled) {
           static const char boundary[] = "XXXarangob-benchmarkXXX";
           size_t blen = strlen(boundary);
 
@@ -309,6 +370,9 @@ namespace triagens {
                                                       _headers);
           _time += TRI_microtime() - start;
 
+          recordLatency("POST /_api/batch", start, scheduled,
+                        (result == nullptr || ! result->isComplete() || result->wasHttpError()));
+
           if (result == nullptr || ! result->isComplete()) {
             if (result != nullptr){
               _operationsCounter->incIncompleteFailures(numOperations);
@@ -371,7 +435,7 @@ namespace triagens {
 /// @brief execute a single request
 ////////////////////////////////////////////////////////////////////////////////
 
-        void executeSingleRequest () {
+        void executeSingleRequest (double scheduled) {
           const size_t threadCounter = _counter++;
           const size_t globalCounter = _offset + threadCounter;
           const rest::HttpRequest::HttpRequestType type = _operation->type(_threadNumber, threadCounter, globalCounter);
@@ -390,6 +454,15 @@ namespace triagens {
                                                       _headers);
           _time += TRI_microtime() - start;
 
+          std::string name = _operation->name(_threadNumber, threadCounter, globalCounter);
+
+          if (name.empty()) {
+            name = rest::HttpRequest::translateMethod(type) + " " + ReplayLog::endpointName(url);
+          }
+
+          recordLatency(name, start, scheduled,
+                        (result == nullptr || ! result->isComplete() || result->wasHttpError()));
+
           if (mustFree) {
             TRI_Free(TRI_UNKNOWN_MEM_ZONE, (void*) payload);
           }
@@ -443,6 +516,31 @@ namespace triagens {
           return _time;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief set the start of the test, before the threads are started
+////////////////////////////////////////////////////////////////////////////////
+
+        void setStartTime (double start) {
+          _start = start;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the operations, e.g. "POST /_api/document", valid after the
+/// thread has ended
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const& names () const {
+          return _names;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the latencies per operation, valid after the thread has ended
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ReplayStatistics> const& statistics () const {
+          return _statistics;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -551,6 +649,20 @@ namespace triagens {
 
         bool _async;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief operations per second of all threads in open-loop mode, or 0
+////////////////////////////////////////////////////////////////////////////////
+
+        double const _rate;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seconds after the start whose latencies are not recorded
+////////////////////////////////////////////////////////////////////////////////
+
+        double const _warmup;
+
+        double _start;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief underlying client
 ////////////////////////////////////////////////////////////////////////////////
@@ -581,6 +693,14 @@ namespace triagens {
 
         double _time;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the operations and their latencies, only written by this thread
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> _names;
+
+        std::vector<ReplayStatistics> _statistics;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief lower-case error header we look for
 ////////////////////////////////////////////////////////////////////////////////
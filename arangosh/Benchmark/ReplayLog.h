@@ -0,0 +1,351 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief requests captured by a server, replayed by arangob
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BENCHMARK_REPLAY_LOG_H
+#define ARANGODB_BENCHMARK_REPLAY_LOG_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+#include <fstream>
+
+#include "arangod/Statistics/figures.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/json.h"
+#include "Rest/HttpRequest.h"
+
+namespace triagens {
+  namespace arangob {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a captured request
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ReplayRequest {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arrival in seconds after the first request of the log
+////////////////////////////////////////////////////////////////////////////////
+
+      double _time;
+
+      rest::HttpRequest::HttpRequestType _type;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the URL, with the database prefix if a database was captured
+////////////////////////////////////////////////////////////////////////////////
+
+      std::string _url;
+
+      std::string _body;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief index of the endpoint the latencies are reported for
+////////////////////////////////////////////////////////////////////////////////
+
+      size_t _endpoint;
+    };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the latencies of an endpoint as seen by one thread
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ReplayStatistics {
+      ReplayStatistics ()
+        : _latency(), _failures(0) {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief latencies in microseconds
+////////////////////////////////////////////////////////////////////////////////
+
+      basics::StatisticsHistogram _latency;
+
+      uint64_t _failures;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class ReplayLog
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the requests of a capture file, written by a server started with
+/// --server.capture-requests, and the schedule to replay them
+///
+/// the replay threads take the requests in the order of the log. without a
+/// schedule (closed loop) a thread sends its next request as soon as the
+/// previous one was answered. with a schedule (open loop) every request has
+/// a time at which it is due, either its captured arrival time divided by
+/// the speed-up or the time given by a fixed arrival rate. latencies are
+/// then measured from that time, so a server which falls behind is charged
+/// for the time requests wait for a free connection, too
+////////////////////////////////////////////////////////////////////////////////
+
+    class ReplayLog {
+
+      public:
+
+        ReplayLog (ReplayLog const&) = delete;
+        ReplayLog& operator= (ReplayLog const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        ReplayLog ()
+          : _requests(),
+            _endpoints(),
+            _start(0.0),
+            _speedup(0.0),
+            _rate(0.0),
+            _next(0),
+            _done(0) {
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a capture file. returns false and an error message if it
+/// cannot be read
+////////////////////////////////////////////////////////////////////////////////
+
+        bool load (std::string const& filename,
+                   std::string& error) {
+          std::ifstream file(filename.c_str());
+
+          if (! file) {
+            error = "cannot open file '" + filename + "'";
+            return false;
+          }
+
+          std::unordered_map<std::string, size_t> endpoints;
+          std::string line;
+          size_t lineNumber = 0;
+          double first = -1.0;
+
+          while (std::getline(file, line)) {
+            ++lineNumber;
+
+            if (line.empty()) {
+              continue;
+            }
+
+            std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, line.c_str()));
+
+            if (! TRI_IsObjectJson(json.get())) {
+              error = "invalid request in line " + std::to_string(lineNumber);
+              return false;
+            }
+
+            ReplayRequest request;
+            request._time = basics::JsonHelper::getNumericValue<double>(json.get(), "time", 0.0);
+            request._type = rest::HttpRequest::translateMethod(basics::JsonHelper::getStringValue(json.get(), "method", ""));
+
+            std::string const database = basics::JsonHelper::getStringValue(json.get(), "database", "");
+            std::string const url = basics::JsonHelper::getStringValue(json.get(), "url", "");
+
+            request._url = (database.empty() ? url : "/_db/" + database + url);
+            request._body = basics::JsonHelper::getStringValue(json.get(), "body", "");
+
+            if (request._type == rest::HttpRequest::HTTP_REQUEST_ILLEGAL || url.empty() || url[0] != '/') {
+              error = "invalid request in line " + std::to_string(lineNumber);
+              return false;
+            }
+
+            if (first < 0.0) {
+              first = request._time;
+            }
+
+            // requests are written in the order of the capture lock, so their
+            // times may be slightly out of order
+            request._time = (std::max)(0.0, request._time - first);
+
+            std::string const name = rest::HttpRequest::translateMethod(request._type) + " " + endpointName(url);
+            auto it = endpoints.find(name);
+
+            if (it == endpoints.end()) {
+              it = endpoints.emplace(name, _endpoints.size()).first;
+              _endpoints.emplace_back(name);
+            }
+
+            request._endpoint = (*it).second;
+
+            _requests.emplace_back(std::move(request));
+          }
+
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts the replay. a positive rate replays the requests at this
+/// number per second, otherwise a positive speed-up replays them at their
+/// captured times divided by it. without both, the replay is closed-loop
+////////////////////////////////////////////////////////////////////////////////
+
+        void start (double now,
+                    double speedup,
+                    double rate) {
+          _start = now;
+          _speedup = speedup;
+          _rate = rate;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the requests follow a schedule
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isOpenLoop () const {
+          return (_rate > 0.0 || _speedup > 0.0);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the time at which a request is due, only for an open-loop replay
+////////////////////////////////////////////////////////////////////////////////
+
+        double scheduledTime (size_t i) const {
+          if (_rate > 0.0) {
+            return _start + static_cast<double>(i) / _rate;
+          }
+
+          return _start + _requests[i]._time / _speedup;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hands out the index of the next request to a thread. returns the
+/// number of requests if there are none left
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t next () {
+          size_t const i = _next.fetch_add(1, std::memory_order_relaxed);
+
+          return (std::min)(i, _requests.size());
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts an answered request
+////////////////////////////////////////////////////////////////////////////////
+
+        void done () {
+          _done.fetch_add(1, std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of answered requests
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t numDone () const {
+          return _done.load(std::memory_order_relaxed);
+        }
+
+        size_t size () const {
+          return _requests.size();
+        }
+
+        ReplayRequest const& at (size_t i) const {
+          return _requests[i];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the endpoints, e.g. "POST /_api/document"
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<std::string> const& endpoints () const {
+          return _endpoints;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the endpoint of a URL: its first path segment, or the first two
+/// for system APIs, like the server statistics do
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string endpointName (std::string const& url) {
+          std::string name = url.substr(0, url.find('?'));
+
+          size_t const segments = (name.compare(0, 2, "/_") == 0 ? 2 : 1);
+          size_t pos = 0;
+
+          for (size_t i = 0;  i < segments && pos != std::string::npos;  ++i) {
+            pos = name.find('/', pos + 1);
+          }
+
+          if (pos != std::string::npos) {
+            name.resize(pos);
+          }
+
+          return name;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        std::vector<ReplayRequest> _requests;
+
+        std::vector<std::string> _endpoints;
+
+        double _start;
+
+        double _speedup;
+
+        double _rate;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the next request to hand out
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _next;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of answered requests, for the progress report
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<size_t> _done;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
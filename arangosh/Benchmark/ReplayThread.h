@@ -0,0 +1,323 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief thread replaying captured requests
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BENCHMARK_REPLAY_THREAD_H
+#define ARANGODB_BENCHMARK_REPLAY_THREAD_H 1
+
+#include "Basics/Common.h"
+
+#include "Basics/ConditionLocker.h"
+#include "Basics/ConditionVariable.h"
+#include "Basics/logging.h"
+#include "Basics/Thread.h"
+#include "Benchmark/ReplayLog.h"
+#include "SimpleHttpClient/SimpleHttpClient.h"
+#include "SimpleHttpClient/SimpleHttpResult.h"
+#include "SimpleHttpClient/GeneralClientConnection.h"
+
+namespace triagens {
+  namespace arangob {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class ReplayThread
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a connection replaying requests of a capture file. it records the
+/// latencies per endpoint in histograms of its own, which are merged after
+/// the replay
+////////////////////////////////////////////////////////////////////////////////
+
+    class ReplayThread : public triagens::basics::Thread {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        constructors / destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        ReplayThread (ReplayLog* log,
+                      basics::ConditionVariable* condition,
+                      void (*callback) (),
+                      rest::Endpoint* endpoint,
+                      std::string const& databaseName,
+                      std::string const& username,
+                      std::string const& password,
+                      double requestTimeout,
+                      double connectTimeout,
+                      uint32_t sslProtocol,
+                      bool keepAlive)
+          : Thread("arangob"),
+            _log(log),
+            _startCondition(condition),
+            _callback(callback),
+            _endpoint(endpoint),
+            _headers(),
+            _databaseName(databaseName),
+            _username(username),
+            _password(password),
+            _requestTimeout(requestTimeout),
+            _connectTimeout(connectTimeout),
+            _sslProtocol(sslProtocol),
+            _keepAlive(keepAlive),
+            _client(nullptr),
+            _connection(nullptr),
+            _statistics(log->endpoints().size()),
+            _warningCount(0) {
+        }
+
+        ~ReplayThread () {
+          delete _client;
+          delete _connection;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                         virtual protected methods
+// -----------------------------------------------------------------------------
+
+      protected:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the thread program
+////////////////////////////////////////////////////////////////////////////////
+
+        void run () {
+          _connection = httpclient::GeneralClientConnection::factory(_endpoint, _requestTimeout, _connectTimeout, 3, _sslProtocol);
+
+          if (_connection == nullptr) {
+            LOG_FATAL_AND_EXIT("out of memory");
+          }
+
+          _client = new httpclient::SimpleHttpClient(_connection, _requestTimeout, true);
+
+          _client->setLocationRewriter(this, &rewriteLocation);
+          _client->setUserNamePassword("/", _username, _password);
+          _client->setKeepAlive(_keepAlive);
+
+          // test the connection
+          httpclient::SimpleHttpResult* result = _client->request(rest::HttpRequest::HTTP_REQUEST_GET,
+                                                                  "/_api/version",
+                                                                  nullptr,
+                                                                  0,
+                                                                  _headers);
+
+          if (result == nullptr || ! result->isComplete()) {
+            delete result;
+
+            LOG_FATAL_AND_EXIT("could not connect to server");
+          }
+
+          delete result;
+
+          _callback();
+
+          // wait for start condition to be broadcasted
+          {
+            CONDITION_LOCKER(guard, (*_startCondition));
+            guard.wait();
+          }
+
+          bool const openLoop = _log->isOpenLoop();
+
+          while (true) {
+            size_t const i = _log->next();
+
+            if (i >= _log->size()) {
+              break;
+            }
+
+            double scheduled = 0.0;
+
+            if (openLoop) {
+              scheduled = _log->scheduledTime(i);
+
+              double const wait = scheduled - TRI_microtime();
+
+              if (wait > 0.0) {
+                usleep(static_cast<unsigned long>(wait * 1000000.0));
+              }
+            }
+
+            executeRequest(_log->at(i), scheduled);
+
+            _log->done();
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the latencies per endpoint, valid after the thread has ended
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ReplayStatistics> const& statistics () const {
+          return _statistics;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief request location rewriter (injects database name)
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::string rewriteLocation (void* data, std::string const& location) {
+          auto t = static_cast<arangob::ReplayThread*>(data);
+
+          TRI_ASSERT(t != nullptr);
+
+          if (location.substr(0, 5) == "/_db/") {
+            // location already contains /_db/
+            return location;
+          }
+
+          return std::string("/_db/" + t->_databaseName + location);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a request and records its latency. in an open-loop replay
+/// the latency is measured from the time the request was due
+////////////////////////////////////////////////////////////////////////////////
+
+        void executeRequest (ReplayRequest const& request,
+                             double scheduled) {
+          double const start = TRI_microtime();
+
+          httpclient::SimpleHttpResult* result = _client->request(request._type,
+                                                                  request._url,
+                                                                  request._body.c_str(),
+                                                                  request._body.size(),
+                                                                  _headers);
+
+          double const end = TRI_microtime();
+          double const latency = end - (scheduled > 0.0 ? scheduled : start);
+
+          ReplayStatistics& statistics = _statistics[request._endpoint];
+          statistics._latency.addFigure(static_cast<uint64_t>((std::max)(0.0, latency) * 1000000.0));
+
+          if (result == nullptr || ! result->isComplete()) {
+            ++statistics._failures;
+
+            if (mustWarn()) {
+              LOG_WARNING("request for URL '%s' failed because server did not reply", request._url.c_str());
+            }
+          }
+          else if (result->wasHttpError() && result->getHttpReturnCode() >= 500) {
+            // client errors are part of the captured traffic, e.g. lookups of
+            // missing documents, so only server errors count as failures
+            ++statistics._failures;
+
+            if (mustWarn()) {
+              LOG_WARNING("request for URL '%s' failed with HTTP code %d", request._url.c_str(), (int) result->getHttpReturnCode());
+            }
+          }
+
+          delete result;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counts a warning. returns whether it is to be logged, which it
+/// is up to a maximum number per thread
+////////////////////////////////////////////////////////////////////////////////
+
+        bool mustWarn () {
+          ++_warningCount;
+
+          if (_warningCount == MaxWarnings) {
+            LOG_WARNING("...more warnings...");
+          }
+
+          return (_warningCount < MaxWarnings);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        ReplayLog* _log;
+
+        basics::ConditionVariable* _startCondition;
+
+        void (*_callback) ();
+
+        rest::Endpoint* _endpoint;
+
+        std::map<std::string, std::string> _headers;
+
+        std::string const _databaseName;
+
+        std::string const _username;
+
+        std::string const _password;
+
+        double _requestTimeout;
+
+        double _connectTimeout;
+
+        uint32_t _sslProtocol;
+
+        bool _keepAlive;
+
+        triagens::httpclient::SimpleHttpClient* _client;
+
+        triagens::httpclient::GeneralClientConnection* _connection;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief latencies per endpoint, only written by this thread
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<ReplayStatistics> _statistics;
+
+        int _warningCount;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of warnings to be displayed per thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static const int MaxWarnings = 5;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
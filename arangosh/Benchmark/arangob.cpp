@@ -36,6 +36,8 @@
 #include "Basics/ProgramOptions.h"
 #include "Basics/ProgramOptionsDescription.h"
 #include "Basics/StringUtils.h"
+#include "Basics/FileUtils.h"
+#include "Basics/StringBuffer.h"
 #include "Basics/init.h"
 #include "Basics/logging.h"
 #include "Basics/random.h"
@@ -50,6 +52,8 @@
 #include "Benchmark/BenchmarkCounter.h"
 #include "Benchmark/BenchmarkOperation.h"
 #include "Benchmark/BenchmarkThread.h"
+#include "Benchmark/ReplayLog.h"
+#include "Benchmark/ReplayThread.h"
 
 using namespace std;
 using namespace triagens::basics;
@@ -146,6 +150,55 @@ static string TestCase = "version";
 
 static bool verbose = false;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief file with captured requests to replay instead of a test case
+////////////////////////////////////////////////////////////////////////////////
+
+static string ReplayFile;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief speed-up of the replay over the captured arrival times
+////////////////////////////////////////////////////////////////////////////////
+
+static double ReplaySpeedup = 1.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fixed arrival rate of the replay in requests per second
+////////////////////////////////////////////////////////////////////////////////
+
+static double ReplayRate = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief fixed arrival rate of the test case in requests per second, 0 for
+/// a closed loop
+////////////////////////////////////////////////////////////////////////////////
+
+static double Rate = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief seconds at the start whose latencies are not reported
+////////////////////////////////////////////////////////////////////////////////
+
+static double Warmup = 0.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief file the latencies are written to
+////////////////////////////////////////////////////////////////////////////////
+
+static string LatencyFile;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief format of the latency file, csv or json
+////////////////////////////////////////////////////////////////////////////////
+
+static string LatencyFormat = "csv";
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief query types and their weights for the aql-mix test case
+////////////////////////////////////////////////////////////////////////////////
+
+static string QueryMix = "lookup=40,range=20,aggregate=5,join=10,traversal=10,upsert=15";
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief includes all the test cases
 ////////////////////////////////////////////////////////////////////////////////
@@ -198,11 +251,19 @@ static void ParseProgramOptions (int argc, char* argv[]) {
     ("batch-size", &BatchSize, "number of operations in one batch (0 disables batching)")
     ("keep-alive", &KeepAlive, "use HTTP keep-alive")
     ("collection", &Collection, "collection name to use in tests")
-    ("test-case", &TestCase, "test case to use (possible values: version, document, collection, import-document, hash, skiplist, edge, shapes, shapes-append, random-shapes, crud, crud-append, crud-write-read, aqltrx, counttrx, multitrx, multi-collection, aqlinsert, aqlv8)")
+    ("test-case", &TestCase, "test case to use (possible values: version, document, collection, import-document, hash, skiplist, edge, shapes, shapes-append, random-shapes, crud, crud-append, crud-write-read, aqltrx, counttrx, multitrx, multi-collection, aqlinsert, aqlv8, aql-mix)")
     ("complexity", &Complexity, "complexity parameter for the test")
     ("delay", &Delay, "use a startup delay (necessary only when run in series)")
     ("progress", &Progress, "show progress")
     ("verbose", &verbose, "print out replies if the http-header indicates db-errors")
+    ("replay", &ReplayFile, "replay the requests a server captured with --server.capture-requests in this file instead of a test case")
+    ("replay-speedup", &ReplaySpeedup, "replay the requests this many times faster than they were captured (0 = as fast as possible)")
+    ("replay-rate", &ReplayRate, "replay the requests open-loop at this fixed number of requests per second (0 = use the captured times)")
+    ("rate", &Rate, "send the requests of the test case open-loop at this fixed number of requests per second (0 = closed-loop)")
+    ("warmup", &Warmup, "do not report the latencies of the requests sent in the first seconds")
+    ("latency-file", &LatencyFile, "write the latencies per operation to this file")
+    ("latency-format", &LatencyFormat, "format of the latency file, csv or json")
+    ("query-mix", &QueryMix, "query types and their weights for test case aql-mix, e.g. lookup=40,range=20,aggregate=5,join=10,traversal=10,upsert=15")
   ;
 
   BaseClient.setupGeneral(description);
@@ -213,6 +274,216 @@ static void ParseProgramOptions (int argc, char* argv[]) {
 
   ProgramOptions options;
   BaseClient.parse(options, description, "--concurrency <concurrency> --requests <request> --test-case <case> ...", argc, argv, "arangob.conf");
+
+  if (LatencyFormat != "csv" && LatencyFormat != "json") {
+    LOG_FATAL_AND_EXIT("invalid value for --latency-format: '%s'", LatencyFormat.c_str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prints the latencies per operation in milliseconds
+////////////////////////////////////////////////////////////////////////////////
+
+static void PrintLatencies (vector<string> const& names,
+                            vector<ReplayStatistics> const& statistics,
+                            ReplayStatistics const& total) {
+  auto printLine = [] (string const& name, ReplayStatistics const& s) -> void {
+    char buffer[256];
+
+    snprintf(buffer, sizeof(buffer), "%-40s %9llu %8llu %10.3f %10.3f %10.3f %10.3f %10.3f",
+             name.c_str(),
+             (unsigned long long) s._latency._count,
+             (unsigned long long) s._failures,
+             s._latency.percentile(0.5) / 1000.0,
+             s._latency.percentile(0.9) / 1000.0,
+             s._latency.percentile(0.99) / 1000.0,
+             s._latency.percentile(0.999) / 1000.0,
+             s._latency._max / 1000.0);
+
+    cout << buffer << endl;
+  };
+
+  char header[256];
+  snprintf(header, sizeof(header), "%-40s %9s %8s %10s %10s %10s %10s %10s",
+           "endpoint", "requests", "failures", "p50 ms", "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+  cout << header << endl;
+
+  for (size_t j = 0; j < statistics.size(); ++j) {
+    printLine(names[j], statistics[j]);
+  }
+
+  printLine("total", total);
+  cout << endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the latencies per operation in milliseconds to the latency
+/// file, if one is given
+////////////////////////////////////////////////////////////////////////////////
+
+static void WriteLatencies (vector<string> const& names,
+                            vector<ReplayStatistics> const& statistics,
+                            ReplayStatistics const& total) {
+  if (LatencyFile.empty()) {
+    return;
+  }
+
+  bool const json = (LatencyFormat == "json");
+  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+
+  auto writeLine = [&] (string const& name, ReplayStatistics const& s, bool last) -> void {
+    char line[512];
+
+    snprintf(line, sizeof(line),
+             json ?
+             "  { \"operation\": \"%s\", \"requests\": %llu, \"failures\": %llu, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"p999\": %.3f, \"max\": %.3f }%s\n" :
+             "\"%s\",%llu,%llu,%.3f,%.3f,%.3f,%.3f,%.3f%s\n",
+             name.c_str(),
+             (unsigned long long) s._latency._count,
+             (unsigned long long) s._failures,
+             s._latency.percentile(0.5) / 1000.0,
+             s._latency.percentile(0.9) / 1000.0,
+             s._latency.percentile(0.99) / 1000.0,
+             s._latency.percentile(0.999) / 1000.0,
+             s._latency._max / 1000.0,
+             (json && ! last) ? "," : "");
+
+    buffer.appendText(line);
+  };
+
+  buffer.appendText(json ? "[\n" : "\"operation\",\"requests\",\"failures\",\"p50\",\"p90\",\"p99\",\"p999\",\"max\"\n");
+
+  for (size_t j = 0; j < statistics.size(); ++j) {
+    writeLine(names[j], statistics[j], false);
+  }
+
+  writeLine("total", total, true);
+
+  if (json) {
+    buffer.appendText("]\n");
+  }
+
+  try {
+    FileUtils::spit(LatencyFile, buffer);
+  }
+  catch (...) {
+    LOG_ERROR("cannot write latencies to '%s'", LatencyFile.c_str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replays a capture file and reports the latencies per endpoint.
+/// returns the exit code
+////////////////////////////////////////////////////////////////////////////////
+
+static int Replay () {
+  ReplayLog log;
+  string error;
+
+  if (! log.load(ReplayFile, error)) {
+    LOG_FATAL_AND_EXIT("cannot replay '%s': %s", ReplayFile.c_str(), error.c_str());
+  }
+
+  if (log.size() == 0) {
+    LOG_FATAL_AND_EXIT("no requests to replay in '%s'", ReplayFile.c_str());
+  }
+
+  Status("starting threads...");
+
+  ConditionVariable startCondition;
+  vector<Endpoint*> endpoints;
+  vector<ReplayThread*> threads;
+
+  for (int i = 0; i < ThreadConcurrency; ++i) {
+    Endpoint* endpoint = Endpoint::clientFactory(BaseClient.endpointString());
+    endpoints.push_back(endpoint);
+
+    ReplayThread* thread = new ReplayThread(&log,
+        &startCondition,
+        &UpdateStartCounter,
+        endpoint,
+        BaseClient.databaseName(),
+        BaseClient.username(),
+        BaseClient.password(),
+        BaseClient.requestTimeout(),
+        BaseClient.connectTimeout(),
+        BaseClient.sslProtocol(),
+        KeepAlive);
+
+    threads.push_back(thread);
+    thread->start();
+  }
+
+  // give all threads a chance to start so they will not miss the broadcast
+  while (GetStartCounter() < ThreadConcurrency) {
+    usleep(5000);
+  }
+
+  Status("replaying requests...");
+
+  double start = TRI_microtime();
+  log.start(start, ReplaySpeedup, ReplayRate);
+
+  // broadcast the start signal to all threads
+  {
+    CONDITION_LOCKER(guard, startCondition);
+    guard.broadcast();
+  }
+
+  const size_t stepValue = (log.size() / 20);
+  size_t nextReportValue = (stepValue < 100 ? 100 : stepValue);
+
+  while (log.numDone() < log.size()) {
+    if (Progress && log.numDone() >= nextReportValue) {
+      LOG_INFO("number of operations: %d", (int) nextReportValue);
+      nextReportValue += stepValue;
+    }
+
+    usleep(20000);
+  }
+
+  double time = TRI_microtime() - start;
+
+  // merge the latencies of all threads
+  vector<ReplayStatistics> statistics(log.endpoints().size());
+  ReplayStatistics total;
+
+  for (int i = 0; i < ThreadConcurrency; ++i) {
+    threads[i]->join();
+
+    auto const& s = threads[i]->statistics();
+
+    for (size_t j = 0; j < s.size(); ++j) {
+      statistics[j]._latency.merge(s[j]._latency);
+      statistics[j]._failures += s[j]._failures;
+      total._latency.merge(s[j]._latency);
+      total._failures += s[j]._failures;
+    }
+
+    delete threads[i];
+    delete endpoints[i];
+  }
+
+  cout << endl;
+  cout << "Replayed requests: " << log.size() <<
+          " from '" << ReplayFile << "'" <<
+          ", mode: " << (ReplayRate > 0.0 ? "open-loop, fixed rate" : (ReplaySpeedup > 0.0 ? "open-loop, captured times" : "closed-loop")) <<
+          ", keep alive: " << (KeepAlive ? "yes" : "no") <<
+          ", concurrency level (threads): " << ThreadConcurrency <<
+          endl;
+
+  cout << "Elapsed time since start: " << fixed << time << " s" <<
+          ", requests per second: " << fixed << ((double) log.size() / time) << endl << endl;
+
+  PrintLatencies(log.endpoints(), statistics, total);
+  WriteLatencies(log.endpoints(), statistics, total);
+
+  if (total._failures > 0) {
+    cerr << "WARNING: " << total._failures << " arangob request(s) failed!!" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
 }
 
 // -----------------------------------------------------------------------------
@@ -318,6 +589,16 @@ int main (int argc, char* argv[]) {
     LOG_FATAL_AND_EXIT("invalid value for --server.endpoint ('%s')", BaseClient.endpointString().c_str());
   }
 
+  if (! ReplayFile.empty()) {
+    ret = Replay();
+
+    TRIAGENS_REST_SHUTDOWN;
+
+    arangobExitFunction(ret, nullptr);
+
+    return ret;
+  }
+
   BenchmarkOperation* testCase = GetTestCase(TestCase);
 
   if (testCase == nullptr) {
@@ -365,6 +646,8 @@ int main (int argc, char* argv[]) {
         BaseClient.sslProtocol(),
         KeepAlive,
         Async,
+        Rate,
+        Warmup,
         verbose);
 
     threads.push_back(thread);
@@ -386,6 +669,10 @@ int main (int argc, char* argv[]) {
 
   double start = TRI_microtime();
 
+  for (int i = 0; i < ThreadConcurrency; ++i) {
+    threads[i]->setStartTime(start);
+  }
+
   // broadcast the start signal to all threads
   {
     CONDITION_LOCKER(guard, startCondition);
@@ -417,8 +704,31 @@ int main (int argc, char* argv[]) {
   double time = TRI_microtime() - start;
   double requestTime = 0.0;
 
+  // merge the latencies of all threads by operation
+  vector<string> names;
+  vector<ReplayStatistics> statistics;
+  ReplayStatistics total;
+
   for (int i = 0; i < ThreadConcurrency; ++i) {
+    threads[i]->join();
     requestTime += threads[i]->getTime();
+
+    auto const& n = threads[i]->names();
+    auto const& s = threads[i]->statistics();
+
+    for (size_t j = 0; j < s.size(); ++j) {
+      size_t k = std::find(names.begin(), names.end(), n[j]) - names.begin();
+
+      if (k == names.size()) {
+        names.emplace_back(n[j]);
+        statistics.emplace_back();
+      }
+
+      statistics[k]._latency.merge(s[j]._latency);
+      statistics[k]._failures += s[j]._failures;
+      total._latency.merge(s[j]._latency);
+      total._failures += s[j]._failures;
+    }
   }
 
   size_t failures = operationsCounter.failures();
@@ -430,6 +740,7 @@ int main (int argc, char* argv[]) {
           ", async: " << (Async ? "yes" : "no")  <<
           ", batch size: " << BatchSize <<
           ", concurrency level (threads): " << ThreadConcurrency <<
+          ", mode: " << (Rate > 0.0 ? "open-loop, fixed rate" : "closed-loop") <<
           endl;
 
   cout << "Test case: " << TestCase <<
@@ -445,6 +756,9 @@ int main (int argc, char* argv[]) {
   cout << "Operations per second rate: " << fixed << ((double) Operations / time) << endl;
   cout << "Elapsed time since start: " << fixed << time << " s" << endl << endl;
 
+  PrintLatencies(names, statistics, total);
+  WriteLatencies(names, statistics, total);
+
   if (failures > 0) {
     cerr << "WARNING: " << failures << " arangob request(s) failed!!" << endl;
   }
@@ -455,7 +769,6 @@ int main (int argc, char* argv[]) {
   testCase->tearDown();
 
   for (int i = 0; i < ThreadConcurrency; ++i) {
-    threads[i]->join();
     delete threads[i];
     delete endpoints[i];
   }
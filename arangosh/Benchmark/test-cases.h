@@ -41,6 +41,10 @@ static bool CreateDocument (SimpleHttpClient*, const std::string&, const std::st
 
 static bool CreateIndex (SimpleHttpClient*, const std::string&, const std::string&, const std::string&);
 
+static bool ImportDocuments (SimpleHttpClient*, const std::string&, const std::string&);
+
+static bool SendQueryTracking (SimpleHttpClient*, HttpRequest::HttpRequestType, const std::string&, const std::string&);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              benchmark test cases
 // -----------------------------------------------------------------------------
@@ -1634,6 +1638,331 @@ struct AqlV8Test : public BenchmarkOperation {
   }
 };
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 AQL workload mix
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs a weighted mix of AQL queries against a generated dataset
+///
+/// the dataset has 10000 * complexity documents with nested attributes, and
+/// edges between them whose degrees follow a power law: the out-degree of a
+/// document is Pareto distributed, and the targets are skewed towards the
+/// documents with low numbers, so that there are a few hubs. the query types
+/// and their weights are given by --query-mix. each query starts with a
+/// comment naming its type, so that the latencies are reported per type, and
+/// the server-side runtimes of the queries in the slow query list can be
+/// attributed to the types. for the latter, setUp makes the server track all
+/// queries, and tearDown restores the previous tracking properties
+////////////////////////////////////////////////////////////////////////////////
+
+struct AqlMixTest : public BenchmarkOperation {
+
+  enum QueryType {
+    QUERY_LOOKUP,
+    QUERY_RANGE,
+    QUERY_AGGREGATE,
+    QUERY_JOIN,
+    QUERY_TRAVERSAL,
+    QUERY_UPSERT
+  };
+
+  AqlMixTest ()
+    : BenchmarkOperation (),
+      _client(nullptr),
+      _numDocuments(10000 * (Complexity > 0 ? Complexity : 1)),
+      _totalWeight(0) {
+
+    static char const* names[] = { "lookup", "range", "aggregate", "join", "traversal", "upsert" };
+
+    for (auto const& part : StringUtils::split(QueryMix, ',')) {
+      std::vector<std::string> pair = StringUtils::split(StringUtils::trim(part), '=');
+      size_t type = 0;
+
+      while (type < sizeof(names) / sizeof(names[0]) && pair[0] != names[type]) {
+        ++type;
+      }
+
+      if (pair.size() != 2 || type == sizeof(names) / sizeof(names[0])) {
+        LOG_FATAL_AND_EXIT("invalid query mix '%s', expecting e.g. 'lookup=50,range=50'", QueryMix.c_str());
+      }
+
+      uint64_t weight = StringUtils::uint64(pair[1]);
+
+      if (weight > 0) {
+        _names.emplace_back(std::string("AQL ") + names[type]);
+        _types.emplace_back(static_cast<QueryType>(type));
+        _weights.emplace_back(weight);
+        _totalWeight += weight;
+      }
+    }
+
+    if (_totalWeight == 0) {
+      LOG_FATAL_AND_EXIT("invalid query mix '%s', all weights are 0", QueryMix.c_str());
+    }
+
+    _documents = Collection + "Documents";
+    _edges = Collection + "Edges";
+  }
+
+  ~AqlMixTest () {
+  }
+
+  bool setUp (SimpleHttpClient* client) {
+    _client = client;
+
+    if (! DeleteCollection(client, _documents) ||
+        ! DeleteCollection(client, _edges) ||
+        ! CreateCollection(client, _documents, 2) ||
+        ! CreateCollection(client, _edges, 3) ||
+        ! CreateIndex(client, _documents, "skiplist", "[\"value\"]") ||
+        ! CreateIndex(client, _documents, "hash", "[\"address.city\"]")) {
+      return false;
+    }
+
+    uint64_t const batchSize = 1000;
+    uint64_t seed = 0x2545F4914F6CDD1DULL;
+    std::string body;
+
+    for (uint64_t i = 0; i < _numDocuments; ++i) {
+      body += "{\"_key\":\"d" + StringUtils::itoa(i) + "\"" +
+              ",\"value\":" + StringUtils::itoa(i) +
+              ",\"name\":\"name" + StringUtils::itoa(i) + "\"" +
+              ",\"address\":{\"city\":\"city" + StringUtils::itoa(i % 100) + "\"" +
+              ",\"zip\":" + StringUtils::itoa(10000 + (i % 1000)) + "}" +
+              ",\"tags\":[\"tag" + StringUtils::itoa(i % 7) + "\",\"tag" + StringUtils::itoa(i % 13) + "\"]}\n";
+
+      if ((i + 1) % batchSize == 0 || i + 1 == _numDocuments) {
+        if (! ImportDocuments(client, _documents, body)) {
+          return false;
+        }
+        body.clear();
+      }
+    }
+
+    for (uint64_t i = 0; i < _numDocuments; ++i) {
+      // Pareto distributed out-degree: P(degree >= k) = 1 / k
+      uint64_t degree = static_cast<uint64_t>(1.0 / (1.0 - Uniform(seed)));
+
+      if (degree > 64) {
+        degree = 64;
+      }
+
+      for (uint64_t j = 0; j < degree; ++j) {
+        double const u = Uniform(seed);
+        uint64_t const to = static_cast<uint64_t>(u * u * u * static_cast<double>(_numDocuments));
+
+        body += "{\"_from\":\"" + _documents + "/d" + StringUtils::itoa(i) + "\"" +
+                ",\"_to\":\"" + _documents + "/d" + StringUtils::itoa(to) + "\"" +
+                ",\"weight\":" + StringUtils::itoa(j) + "}\n";
+      }
+
+      if ((i + 1) % batchSize == 0 || i + 1 == _numDocuments) {
+        if (! ImportDocuments(client, _edges, body)) {
+          return false;
+        }
+        body.clear();
+      }
+    }
+
+    // make the server track every query, so the slow query list holds the
+    // server-side runtimes of the last queries of the test
+    std::map<std::string, std::string> headerFields;
+    SimpleHttpResult* result = client->request(HttpRequest::HTTP_REQUEST_GET,
+                                               "/_api/query/properties",
+                                               "",
+                                               0,
+                                               headerFields);
+
+    if (result != nullptr && result->getHttpReturnCode() == 200) {
+      _properties = result->getBody().c_str();
+    }
+
+    delete result;
+
+    return SendQueryTracking(client, HttpRequest::HTTP_REQUEST_PUT,
+                             "/_api/query/properties",
+                             "{\"enabled\":true,\"trackSlowQueries\":true,\"slowQueryThreshold\":0,\"maxSlowQueries\":16384}") &&
+           SendQueryTracking(client, HttpRequest::HTTP_REQUEST_DELETE,
+                             "/_api/query/slow",
+                             "");
+  }
+
+  void tearDown () {
+    if (_client == nullptr) {
+      return;
+    }
+
+    std::map<std::string, std::string> headerFields;
+    SimpleHttpResult* result = _client->request(HttpRequest::HTTP_REQUEST_GET,
+                                                "/_api/query/slow",
+                                                "",
+                                                0,
+                                                headerFields);
+
+    if (result != nullptr && result->getHttpReturnCode() == 200) {
+      std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, result->getBody().c_str()));
+
+      if (TRI_IsArrayJson(json.get())) {
+        std::vector<uint64_t> counts(_names.size(), 0);
+        std::vector<double> sums(_names.size(), 0.0);
+        std::vector<double> maxs(_names.size(), 0.0);
+
+        for (size_t i = 0; i < TRI_LengthArrayJson(json.get()); ++i) {
+          auto const* entry = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+          auto const* query = TRI_LookupObjectJson(entry, "query");
+          auto const* runTime = TRI_LookupObjectJson(entry, "runTime");
+
+          if (! TRI_IsStringJson(query) || ! TRI_IsNumberJson(runTime)) {
+            continue;
+          }
+
+          for (size_t j = 0; j < _names.size(); ++j) {
+            if (TRI_IsPrefixString(query->_value._string.data, Tag(j).c_str())) {
+              ++counts[j];
+              sums[j] += runTime->_value._number;
+              maxs[j] = (std::max)(maxs[j], runTime->_value._number);
+              break;
+            }
+          }
+        }
+
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "%-40s %9s %10s %10s",
+                 "server-side runtime (query list)", "queries", "avg ms", "max ms");
+        std::cout << buffer << std::endl;
+
+        for (size_t j = 0; j < _names.size(); ++j) {
+          snprintf(buffer, sizeof(buffer), "%-40s %9llu %10.3f %10.3f",
+                   _names[j].c_str(),
+                   (unsigned long long) counts[j],
+                   counts[j] > 0 ? sums[j] / counts[j] * 1000.0 : 0.0,
+                   maxs[j] * 1000.0);
+          std::cout << buffer << std::endl;
+        }
+
+        std::cout << std::endl;
+      }
+    }
+
+    delete result;
+
+    if (! _properties.empty()) {
+      SendQueryTracking(_client, HttpRequest::HTTP_REQUEST_PUT, "/_api/query/properties", _properties);
+    }
+  }
+
+  std::string url (const int threadNumber, const size_t threadCounter, const size_t globalCounter) {
+    return std::string("/_api/cursor");
+  }
+
+  HttpRequest::HttpRequestType type (const int threadNumber, const size_t threadCounter, const size_t globalCounter) {
+    return HttpRequest::HTTP_REQUEST_POST;
+  }
+
+  std::string name (const int threadNumber, const size_t threadCounter, const size_t globalCounter) {
+    return _names[Pick(globalCounter)];
+  }
+
+  const char* payload (size_t* length, const int threadNumber, const size_t threadCounter, const size_t globalCounter, bool* mustFree) {
+    size_t const pick = Pick(globalCounter);
+    // a second, independent value for the parameters of the query
+    uint64_t const parameter = Hash(globalCounter ^ 0x5bd1e995ULL) % _numDocuments;
+    std::string const key = "\\\"" + _documents + "/d" + StringUtils::itoa(parameter) + "\\\"";
+    std::string query = Tag(pick);
+
+    switch (_types[pick]) {
+      case QUERY_LOOKUP:
+        query += "FOR d IN " + _documents + " FILTER d._key == \\\"d" + StringUtils::itoa(parameter) + "\\\" RETURN d";
+        break;
+      case QUERY_RANGE:
+        query += "FOR d IN " + _documents + " FILTER d.value >= " + StringUtils::itoa(parameter) +
+                 " && d.value < " + StringUtils::itoa(parameter + 100) + " SORT d.value RETURN d.name";
+        break;
+      case QUERY_AGGREGATE:
+        query += "FOR d IN " + _documents + " FILTER d.address.zip >= " + StringUtils::itoa(10000 + parameter % 1000) +
+                 " COLLECT city = d.address.city WITH COUNT INTO n SORT n DESC LIMIT 10 RETURN { city: city, n: n }";
+        break;
+      case QUERY_JOIN:
+        query += "FOR d IN " + _documents + " FILTER d.address.city == \\\"city" + StringUtils::itoa(parameter % 100) + "\\\"" +
+                 " LIMIT 10 FOR e IN " + _edges + " FILTER e._from == d._id" +
+                 " FOR t IN " + _documents + " FILTER t._id == e._to RETURN { from: d.name, to: t.name }";
+        break;
+      case QUERY_TRAVERSAL:
+        query += "FOR v IN NEIGHBORS(" + _documents + ", " + _edges + ", " + key +
+                 ", \\\"any\\\", [ ], { minDepth: 1, maxDepth: 2 }) RETURN v";
+        break;
+      case QUERY_UPSERT:
+        query += "UPSERT { _key: \\\"d" + StringUtils::itoa(parameter) + "\\\" } INSERT { _key: \\\"d" + StringUtils::itoa(parameter) +
+                 "\\\", hits: 1 } UPDATE { hits: OLD.hits + 1 } IN " + _documents;
+        break;
+    }
+
+    std::string const body = "{\"query\":\"" + query + "\"}";
+
+    *length = body.size();
+    *mustFree = true;
+    return TRI_DuplicateString2Z(TRI_UNKNOWN_MEM_ZONE, body.c_str(), body.size());
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the comment a query of a type starts with
+////////////////////////////////////////////////////////////////////////////////
+
+  std::string Tag (size_t type) const {
+    return "/* arangob " + _names[type] + " */ ";
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief picks the query type of an operation by the weights. the result
+/// only depends on the operation number, as type, url, name and payload are
+/// asked for separately
+////////////////////////////////////////////////////////////////////////////////
+
+  size_t Pick (size_t globalCounter) const {
+    uint64_t value = Hash(globalCounter) % _totalWeight;
+    size_t i = 0;
+
+    while (value >= _weights[i]) {
+      value -= _weights[i];
+      ++i;
+    }
+
+    return i;
+  }
+
+  static uint64_t Hash (uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a uniform number in [0, 1), from a fixed seed so the dataset is the
+/// same in every run
+////////////////////////////////////////////////////////////////////////////////
+
+  static double Uniform (uint64_t& seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return static_cast<double>(seed >> 11) / 9007199254740992.0;
+  }
+
+  SimpleHttpClient* _client;
+  uint64_t const _numDocuments;
+  std::string _documents;
+  std::string _edges;
+  std::vector<std::string> _names;
+  std::vector<QueryType> _types;
+  std::vector<uint64_t> _weights;
+  uint64_t _totalWeight;
+  std::string _properties;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -1758,6 +2087,65 @@ static bool CreateDocument (SimpleHttpClient* client,
   return ! failed;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief import documents, one JSON document per line
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ImportDocuments (SimpleHttpClient* client,
+                             const std::string& collection,
+                             const std::string& payload) {
+  std::map<std::string, std::string> headerFields;
+  SimpleHttpResult* result = nullptr;
+
+  result = client->request(HttpRequest::HTTP_REQUEST_POST,
+                           "/_api/import?type=documents&complete=true&collection=" + collection,
+                           payload.c_str(),
+                           payload.size(),
+                           headerFields);
+
+  bool failed = true;
+
+  if (result != nullptr) {
+    if (result->getHttpReturnCode() == 201) {
+      failed = false;
+    }
+
+    delete result;
+  }
+
+  return ! failed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief change the AQL query tracking
+////////////////////////////////////////////////////////////////////////////////
+
+static bool SendQueryTracking (SimpleHttpClient* client,
+                               HttpRequest::HttpRequestType type,
+                               const std::string& url,
+                               const std::string& payload) {
+  std::map<std::string, std::string> headerFields;
+  SimpleHttpResult* result = nullptr;
+
+  result = client->request(type,
+                           url,
+                           payload.c_str(),
+                           payload.size(),
+                           headerFields);
+
+  bool failed = true;
+
+  if (result != nullptr) {
+    if (result->getHttpReturnCode() == 200) {
+      failed = false;
+    }
+
+    delete result;
+  }
+
+  return ! failed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the test case for a name
 ////////////////////////////////////////////////////////////////////////////////
@@ -1823,6 +2211,9 @@ static BenchmarkOperation* GetTestCase (const std::string& name) {
   if (name == "aqlv8") {
     return new AqlV8Test();
   }
+  if (name == "aql-mix") {
+    return new AqlMixTest();
+  }
 
   return nullptr;
 }
@@ -33,6 +33,7 @@
 #include <sstream>
 #include <iomanip>
 
+#include "Basics/ScopeGuard.h"
 #include "Basics/StringUtils.h"
 #include "Basics/files.h"
 #include "Basics/json.h"
@@ -154,6 +155,7 @@ namespace triagens {
       _useBackslash(false),
       _createCollection(false),
       _overwrite(false),
+      _bulk(false),
       _progress(false),
       _firstChunk(true),
       _numberLines(0),
@@ -164,12 +166,16 @@ namespace triagens {
       _onDuplicateAction("error"),
       _collectionName(),
       _lineBuffer(TRI_UNKNOWN_MEM_ZONE),
-      _outputBuffer(TRI_UNKNOWN_MEM_ZONE) {
-
-      _hasError = false;
+      _outputBuffer(TRI_UNKNOWN_MEM_ZONE),
+      _hasError(false),
+      _queueClosed(false),
+      _firstBatch(true),
+      _totalRead(0),
+      _duration(0.0) {
     }
 
     ImportHelper::~ImportHelper () {
+      stopSenders();
     }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -207,8 +213,14 @@ namespace triagens {
       }
 
       // progress display control variables
-      int64_t totalRead = 0;
       double nextProgress = ProgressStep;
+      double const start = TRI_microtime();
+      _totalRead = 0;
+
+      triagens::basics::ScopeGuard senders{
+        [&] () -> void { startSenders(); },
+        [&] () -> void { stopSenders(); _duration = TRI_microtime() - start; }
+      };
 
       size_t separatorLength;
       char* separator = TRI_UnescapeUtf8String(TRI_UNKNOWN_MEM_ZONE, _separator.c_str(), _separator.size(), &separatorLength);
@@ -264,8 +276,8 @@ namespace triagens {
           break;
         }
 
-        totalRead += (int64_t) n;
-        reportProgress(totalLength, totalRead, nextProgress);
+        _totalRead += (int64_t) n;
+        reportProgress(totalLength, _totalRead, nextProgress);
 
         TRI_ParseCsvString(&parser, buffer, n);
       }
@@ -281,6 +293,9 @@ namespace triagens {
         TRI_CLOSE(fd);
       }
 
+      // wait for the responses to all batches
+      stopSenders();
+
       _outputBuffer.clear();
       return !_hasError;
     }
@@ -316,8 +331,14 @@ namespace triagens {
       bool checkedFront = false;
 
       // progress display control variables
-      int64_t totalRead = 0;
       double nextProgress = ProgressStep;
+      double const start = TRI_microtime();
+      _totalRead = 0;
+
+      triagens::basics::ScopeGuard senders{
+        [&] () -> void { startSenders(); },
+        [&] () -> void { stopSenders(); _duration = TRI_microtime() - start; }
+      };
 
       static const int BUFFER_SIZE = 32768;
 
@@ -365,8 +386,8 @@ namespace triagens {
           checkedFront = true;
         }
 
-        totalRead += (int64_t) n;
-        reportProgress(totalLength, totalRead, nextProgress);
+        _totalRead += (int64_t) n;
+        reportProgress(totalLength, _totalRead, nextProgress);
 
         if (_outputBuffer.length() > _maxUploadSize) {
           if (isObject) {
@@ -397,6 +418,9 @@ namespace triagens {
         TRI_CLOSE(fd);
       }
 
+      // wait for the responses to all batches before counting
+      stopSenders();
+
       // this is an approximation only. _numberLines is more meaningful for CSV imports
       _numberLines = _numberErrors + _numberCreated + _numberIgnored + _numberUpdated;
 
@@ -422,7 +446,7 @@ namespace triagens {
         static int64_t nextProcessed = 10 * 1000 * 1000; 
 
         if (totalRead >= nextProcessed) {
-          LOG_INFO("processed %lld bytes of input file", (long long) totalRead);
+          LOG_INFO("processed %lld bytes of input file, %llu documents created", (long long) totalRead, (unsigned long long) createdSoFar());
           nextProcessed += 10 * 1000 * 1000;
         }
       }
@@ -430,7 +454,7 @@ namespace triagens {
         double pct = 100.0 * ((double) totalRead / (double) totalLength);
 
         if (pct >= nextProgress && totalLength >= 1024) {
-          LOG_INFO("processed %lld bytes (%0.1f%%) of input file", (long long) totalRead, nextProgress);
+          LOG_INFO("processed %lld bytes (%0.1f%%) of input file, %llu documents created", (long long) totalRead, nextProgress, (unsigned long long) createdSoFar());
           nextProgress = (double) ((int) (pct + ProgressStep));
         }
       }
@@ -643,11 +667,9 @@ namespace triagens {
         return;
       }
 
-      map<string, string> headerFields;
       string url("/_api/import?" + getCollectionUrlPart() + "&line=" + StringUtils::itoa(_rowOffset) + "&details=true&onDuplicate=" + StringUtils::urlEncode(_onDuplicateAction));
-      std::unique_ptr<SimpleHttpResult> result(_client->request(HttpRequest::HTTP_REQUEST_POST, url, _outputBuffer.c_str(), _outputBuffer.length(), headerFields));
 
-      handleResult(result.get());
+      sendBuffer(url, _outputBuffer.c_str(), _outputBuffer.length());
 
       _outputBuffer.reset();
       _rowOffset = _rowsRead;
@@ -660,6 +682,10 @@ namespace triagens {
 
       // build target url
       std::string url("/_api/import?" + getCollectionUrlPart() + "&details=true&onDuplicate=" + StringUtils::urlEncode(_onDuplicateAction));
+
+      if (_bulk) {
+        url += "&bulk=true";
+      }
       if (isObject) {
         url += "&type=array";
       }
@@ -667,17 +693,154 @@ namespace triagens {
         url += "&type=documents";
       }
 
+      sendBuffer(url, str, len);
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sends a batch, or queues it for the sender threads
+////////////////////////////////////////////////////////////////////////////////
+
+    void ImportHelper::sendBuffer (string const& url,
+                                   char const* str,
+                                   size_t len) {
+      if (_senders.empty() || _firstBatch) {
+        _firstBatch = false;
+
+        map<string, string> headerFields;
+        std::unique_ptr<SimpleHttpResult> result(_client->request(HttpRequest::HTTP_REQUEST_POST, url, str, len, headerFields));
+
+        handleResult(_client, result.get());
+        return;
+      }
+
+      std::unique_lock<std::mutex> locker(_queueLock);
+
+      while (_queue.size() >= 2 * _senders.size() && ! _hasError) {
+        _queueCondition.wait(locker);
+      }
+
+      if (_hasError) {
+        return;
+      }
+
+      _queue.emplace_back(Batch{ url, string(str, len) });
+      _queueCondition.notify_all();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts one sender thread per sender client
+////////////////////////////////////////////////////////////////////////////////
+
+    void ImportHelper::startSenders () {
+      _firstBatch = true;
+      _queueClosed = false;
+
+      for (auto& client : _senderClients) {
+        try {
+          _senders.emplace_back(&ImportHelper::runSender, this, client);
+        }
+        catch (...) {
+          // go on with the threads we have
+          break;
+        }
+      }
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until the sender threads have sent all queued batches
+////////////////////////////////////////////////////////////////////////////////
+
+    void ImportHelper::stopSenders () {
+      {
+        std::lock_guard<std::mutex> locker(_queueLock);
+        _queueClosed = true;
+        _queueCondition.notify_all();
+      }
+
+      for (auto& sender : _senders) {
+        sender.join();
+      }
+
+      _senders.clear();
+      _queue.clear();
+    }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the sender thread program
+////////////////////////////////////////////////////////////////////////////////
+
+    void ImportHelper::runSender (SimpleHttpClient* client) {
       map<string, string> headerFields;
-      std::unique_ptr<SimpleHttpResult> result(_client->request(HttpRequest::HTTP_REQUEST_POST, url, str, len, headerFields));
 
-      handleResult(result.get());
+      while (true) {
+        Batch batch;
+
+        {
+          std::unique_lock<std::mutex> locker(_queueLock);
+
+          while (_queue.empty() && ! _queueClosed) {
+            _queueCondition.wait(locker);
+          }
+
+          if (_queue.empty()) {
+            return;
+          }
+
+          batch = std::move(_queue.front());
+          _queue.pop_front();
+
+          // wake up the reader
+          _queueCondition.notify_all();
+        }
+
+        if (_hasError) {
+          // drop the remaining batches
+          continue;
+        }
+
+        try {
+          std::unique_ptr<SimpleHttpResult> result(client->request(HttpRequest::HTTP_REQUEST_POST, batch.url, batch.body.c_str(), batch.body.size(), headerFields));
+
+          handleResult(client, result.get());
+        }
+        catch (...) {
+          std::lock_guard<std::mutex> locker(_resultLock);
+          _errorMessage = "caught exception while sending data";
+          _hasError = true;
+        }
+
+        if (_hasError) {
+          // wake up the reader, so that it stops
+          std::lock_guard<std::mutex> locker(_queueLock);
+          _queueCondition.notify_all();
+        }
+      }
     }
 
-    void ImportHelper::handleResult (SimpleHttpResult* result) {
-      if (result == nullptr) {
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of documents created so far
+////////////////////////////////////////////////////////////////////////////////
+
+    size_t ImportHelper::createdSoFar () {
+      std::lock_guard<std::mutex> locker(_resultLock);
+      return _numberCreated;
+    }
+
+    void ImportHelper::handleResult (SimpleHttpClient* client,
+                                     SimpleHttpResult* result) {
+      if (result == nullptr || ! result->isComplete()) {
+        if (! _senders.empty()) {
+          // a lost batch is not noticed otherwise if the import goes on
+          std::lock_guard<std::mutex> locker(_resultLock);
+          _errorMessage = "could not send batch: " + client->getErrorMessage();
+          _hasError = true;
+        }
         return;
       }
 
+      // the sender threads report concurrently
+      std::lock_guard<std::mutex> locker(_resultLock);
+
       std::unique_ptr<TRI_json_t> json(TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, result->getBody().c_str()));
 
       if (json == nullptr) {
@@ -36,6 +36,11 @@
 #include "Basics/csv.h"
 #include "Basics/StringBuffer.h"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #ifdef _WIN32
 #include "Basics/win-utils.h"
 #endif
@@ -98,6 +103,21 @@ namespace triagens {
 
       bool importJson (std::string const& collectionName, std::string const& fileName);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the clients of the sender threads
+///
+/// if clients are set, the batches are not sent by the thread that reads
+/// and parses the input, but by one sender thread per client. the reader
+/// queues at most two batches per sender. the first batch is always sent
+/// by the reader and completed before any other, as it may create or
+/// truncate the collection. the clients must stay valid until the import
+/// has finished
+////////////////////////////////////////////////////////////////////////////////
+
+      void setSenderClients (std::vector<httpclient::SimpleHttpClient*> const& clients) {
+        _senderClients = clients;
+      }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets the action to carry out on duplicate _key
 ////////////////////////////////////////////////////////////////////////////////
@@ -150,6 +170,14 @@ namespace triagens {
         _overwrite = value;
       }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the server should shape JSON documents in bulk
+////////////////////////////////////////////////////////////////////////////////
+
+      void setBulk (bool value) {
+        _bulk = value;
+      }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief set the progress indicator
 ////////////////////////////////////////////////////////////////////////////////
@@ -198,6 +226,22 @@ namespace triagens {
         return _numberIgnored;
       }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the number of bytes read from the input
+////////////////////////////////////////////////////////////////////////////////
+
+      int64_t getReadBytes () {
+        return _totalRead;
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the duration of the last import, in seconds
+////////////////////////////////////////////////////////////////////////////////
+
+      double getDuration () {
+        return _duration;
+      }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief increase the row counter
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,7 +274,13 @@ namespace triagens {
 
       void sendCsvBuffer ();
       void sendJsonBuffer (char const* str, size_t len, bool isObject);
-      void handleResult (httpclient::SimpleHttpResult* result);
+      void sendBuffer (std::string const& url, char const* str, size_t len);
+      void handleResult (httpclient::SimpleHttpClient* client, httpclient::SimpleHttpResult* result);
+
+      void startSenders ();
+      void stopSenders ();
+      void runSender (httpclient::SimpleHttpClient* client);
+      size_t createdSoFar ();
 
     private:
       httpclient::SimpleHttpClient* _client;
@@ -241,6 +291,7 @@ namespace triagens {
       bool _useBackslash;
       bool _createCollection;
       bool _overwrite;
+      bool _bulk;
       bool _progress;
       bool _firstChunk;
 
@@ -259,9 +310,45 @@ namespace triagens {
       triagens::basics::StringBuffer _outputBuffer;
       std::string _firstLine;
 
-      bool _hasError;
+      std::atomic<bool> _hasError;
       std::string _errorMessage;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects the counters and the error message
+////////////////////////////////////////////////////////////////////////////////
+
+      std::mutex _resultLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a batch waiting for a sender thread
+////////////////////////////////////////////////////////////////////////////////
+
+      struct Batch {
+        std::string url;
+        std::string body;
+      };
+
+      std::vector<httpclient::SimpleHttpClient*> _senderClients;
+      std::vector<std::thread> _senders;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the batches waiting for a sender thread
+////////////////////////////////////////////////////////////////////////////////
+
+      std::deque<Batch> _queue;
+      std::mutex _queueLock;
+      std::condition_variable _queueCondition;
+      bool _queueClosed;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the next batch is the first of the import
+////////////////////////////////////////////////////////////////////////////////
+
+      bool _firstBatch;
+
+      int64_t _totalRead;
+      double _duration;
+
       static const double ProgressStep;
     };
   }
@@ -28,7 +28,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Basics/Common.h"
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "zlib.h"
 
 #include "ArangoShell/ArangoClient.h"
 #include "Basics/FileUtils.h"
@@ -155,17 +160,107 @@ static uint64_t BatchId = 0;
 
 static bool clusterMode = false;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of collections or shards dumped in parallel
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Threads = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write the data files gzip-compressed
+////////////////////////////////////////////////////////////////////////////////
+
+static bool CompressOutput = false;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes progress output of the dump threads
+////////////////////////////////////////////////////////////////////////////////
+
+static std::mutex OutputLock;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief statistics
 ////////////////////////////////////////////////////////////////////////////////
 
 static struct {
-  uint64_t _totalBatches;
-  uint64_t _totalCollections;
-  uint64_t _totalWritten;
+  std::atomic<uint64_t> _totalBatches;
+  std::atomic<uint64_t> _totalCollections;
+  std::atomic<uint64_t> _totalWritten;
 }
 Stats;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the data file of a collection
+///
+/// in a cluster, the shards of a collection are dumped in parallel into the
+/// same file. each response body consists of complete lines and is written
+/// in one go, so the lines of different shards do not get mixed up. the
+/// file is opened when the first data arrives and closed by the thread that
+/// finishes the last shard
+////////////////////////////////////////////////////////////////////////////////
+
+struct DataFile {
+  DataFile (std::string const& fileName,
+            size_t pending)
+    : _fileName(fileName),
+      _fd(-1),
+      _gz(nullptr),
+      _pending(pending) {
+  }
+
+  ~DataFile () {
+    if (_gz != nullptr) {
+      gzclose(_gz);
+    }
+    else if (_fd >= 0) {
+      TRI_CLOSE(_fd);
+    }
+  }
+
+  std::mutex _lock;
+  std::string const _fileName;
+  int _fd;
+  gzFile _gz;
+  std::atomic<size_t> _pending;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the dump of a collection (single server) or of a shard (cluster)
+////////////////////////////////////////////////////////////////////////////////
+
+struct DumpJob {
+  std::string _collection;
+  std::string _DBserver;
+  std::shared_ptr<DataFile> _file;
+  uint64_t _maxTick;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a separate server connection of a dump thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct WorkerClient {
+  WorkerClient ()
+    : _endpoint(nullptr),
+      _connection(nullptr),
+      _client(nullptr) {
+  }
+
+  ~WorkerClient () {
+    delete _client;
+    delete _connection;
+    delete _endpoint;
+  }
+
+  Endpoint* _endpoint;
+  GeneralClientConnection* _connection;
+  SimpleHttpClient* _client;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -189,6 +284,8 @@ static void ParseProgramOptions (int argc, char* argv[]) {
     ("progress", &Progress, "show progress")
     ("tick-start", &TickStart, "only include data after this tick")
     ("tick-end", &TickEnd, "last tick to be included in data dump")
+    ("threads", &Threads, "number of collections or shards to dump in parallel")
+    ("compress-output", &CompressOutput, "write gzip-compressed data files")
   ;
 
   BaseClient.setupGeneral(description);
@@ -215,6 +312,7 @@ static void ParseProgramOptions (int argc, char* argv[]) {
 
 static void LocalEntryFunction ();
 static void LocalExitFunction (int, void*);
+static string rewriteLocation (void*, const string&);
 
 #ifdef _WIN32
 
@@ -386,7 +484,10 @@ static bool GetArangoIsCluster () {
 /// @brief start a batch
 ////////////////////////////////////////////////////////////////////////////////
 
-static int StartBatch (string DBserver, string& errorMsg) {
+static int StartBatch (SimpleHttpClient* client,
+                       string const& DBserver,
+                       uint64_t& batchId,
+                       string& errorMsg) {
   std::string const url = "/_api/replication/batch";
   std::string const body = "{\"ttl\":300}";
 
@@ -395,13 +496,13 @@ static int StartBatch (string DBserver, string& errorMsg) {
     urlExt = "?DBserver="+DBserver;
   }
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_POST,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_POST,
                                                url + urlExt,
                                                body.c_str(),
                                                body.size()));
 
   if (response == nullptr || ! response->isComplete()) {
-    errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+    errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
     if (Force) {
       return TRI_ERROR_NO_ERROR;
@@ -429,7 +530,7 @@ static int StartBatch (string DBserver, string& errorMsg) {
   // look up "id" value
   std::string const id = JsonHelper::getStringValue(json.get(), "id", "");
 
-  BatchId = StringUtils::uint64(id);
+  batchId = StringUtils::uint64(id);
 
   return TRI_ERROR_NO_ERROR;
 }
@@ -438,17 +539,19 @@ static int StartBatch (string DBserver, string& errorMsg) {
 /// @brief prolongs a batch
 ////////////////////////////////////////////////////////////////////////////////
 
-static void ExtendBatch (string DBserver) {
-  TRI_ASSERT(BatchId > 0);
+static void ExtendBatch (SimpleHttpClient* client,
+                         string const& DBserver,
+                         uint64_t batchId) {
+  TRI_ASSERT(batchId > 0);
 
-  const string url = "/_api/replication/batch/" + StringUtils::itoa(BatchId);
+  const string url = "/_api/replication/batch/" + StringUtils::itoa(batchId);
   const string body = "{\"ttl\":300}";
   string urlExt;
   if (! DBserver.empty()) {
     urlExt = "?DBserver=" + DBserver;
   }
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_PUT,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                url + urlExt,
                                                body.c_str(),
                                                body.size()));
@@ -460,18 +563,20 @@ static void ExtendBatch (string DBserver) {
 /// @brief end a batch
 ////////////////////////////////////////////////////////////////////////////////
 
-static void EndBatch (string DBserver) {
-  TRI_ASSERT(BatchId > 0);
+static void EndBatch (SimpleHttpClient* client,
+                      string const& DBserver,
+                      uint64_t& batchId) {
+  TRI_ASSERT(batchId > 0);
 
-  std::string const url = "/_api/replication/batch/" + StringUtils::itoa(BatchId);
+  std::string const url = "/_api/replication/batch/" + StringUtils::itoa(batchId);
   string urlExt;
   if (! DBserver.empty()) {
     urlExt = "?DBserver=" + DBserver;
   }
 
-  BatchId = 0;
+  batchId = 0;
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_DELETE,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_DELETE,
                                                url + urlExt,
                                                nullptr,
                                                0));
@@ -479,14 +584,123 @@ static void EndBatch (string DBserver) {
   // ignore any return value
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the suffix of data files
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string DataFileSuffix () {
+  return CompressOutput ? ".data.json.gz" : ".data.json";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a data file. the caller must hold its lock
+////////////////////////////////////////////////////////////////////////////////
+
+static int OpenDataFile (DataFile* file) {
+  TRI_ASSERT(file->_fd < 0);
+
+  char const* fileName = file->_fileName.c_str();
+
+  // remove an existing file first
+  if (TRI_ExistsFile(fileName)) {
+    TRI_UnlinkFile(fileName);
+  }
+
+  file->_fd = TRI_CREATE(fileName, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+
+  if (file->_fd < 0) {
+    return TRI_ERROR_CANNOT_WRITE_FILE;
+  }
+
+  if (CompressOutput) {
+    file->_gz = gzdopen(file->_fd, "wb");
+
+    if (file->_gz == nullptr) {
+      TRI_CLOSE(file->_fd);
+      file->_fd = -1;
+
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends complete lines to a data file
+////////////////////////////////////////////////////////////////////////////////
+
+static int WriteDataFile (DataFile* file,
+                          char const* data,
+                          size_t length) {
+  std::lock_guard<std::mutex> locker(file->_lock);
+
+  if (file->_fd < 0) {
+    int res = OpenDataFile(file);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  if (file->_gz != nullptr) {
+    while (length > 0) {
+      unsigned int const n = static_cast<unsigned int>((std::min)(length, static_cast<size_t>(1024 * 1024 * 64)));
+
+      if (gzwrite(file->_gz, data, n) != static_cast<int>(n)) {
+        return TRI_ERROR_CANNOT_WRITE_FILE;
+      }
+
+      data += n;
+      length -= n;
+    }
+  }
+  else if (! TRI_WritePointer(file->_fd, data, length)) {
+    return TRI_ERROR_CANNOT_WRITE_FILE;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief closes a data file, creating it if nothing was written
+////////////////////////////////////////////////////////////////////////////////
+
+static int CloseDataFile (DataFile* file) {
+  std::lock_guard<std::mutex> locker(file->_lock);
+
+  if (file->_fd < 0) {
+    int res = OpenDataFile(file);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+  }
+
+  int res = TRI_ERROR_NO_ERROR;
+
+  if (file->_gz != nullptr) {
+    if (gzclose(file->_gz) != Z_OK) {
+      res = TRI_ERROR_CANNOT_WRITE_FILE;
+    }
+  }
+  else if (TRI_CLOSE(file->_fd) != 0) {
+    res = TRI_ERROR_CANNOT_WRITE_FILE;
+  }
+
+  file->_gz = nullptr;
+  file->_fd = -1;
+
+  return res;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dump a single collection
 ////////////////////////////////////////////////////////////////////////////////
 
-static int DumpCollection (int fd,
+static int DumpCollection (SimpleHttpClient* client,
+                           DataFile* file,
                            const string& cid,
-                           const string& name,
-                           TRI_json_t const* parameters,
                            uint64_t maxTick,
                            string& errorMsg) {
 
@@ -507,13 +721,13 @@ static int DumpCollection (int fd,
 
     Stats._totalBatches++;
 
-    std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_GET,
+    std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_GET,
                                                  url,
                                                  nullptr,
                                                  0));
 
     if (response == nullptr || ! response->isComplete()) {
-      errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+      errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
       return TRI_ERROR_INTERNAL;
     }
@@ -562,10 +776,9 @@ static int DumpCollection (int fd,
     if (res == TRI_ERROR_NO_ERROR) {
       StringBuffer const& body = response->getBody();
 
-      if (! TRI_WritePointer(fd, body.c_str(), body.length())) {
-        res = TRI_ERROR_CANNOT_WRITE_FILE;
-      }
-      else {
+      res = WriteDataFile(file, body.c_str(), body.length());
+
+      if (res == TRI_ERROR_NO_ERROR) {
         Stats._totalWritten += (uint64_t) body.length();
       }
     }
@@ -610,6 +823,185 @@ static void FlushWal () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dump a single shard, that is a collection on a DBserver
+////////////////////////////////////////////////////////////////////////////////
+
+static int DumpShard (SimpleHttpClient*,
+                      DataFile*,
+                      const string&,
+                      const string&,
+                      string&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dumps the data of a collection or shard, and closes the data file
+/// after its last shard
+////////////////////////////////////////////////////////////////////////////////
+
+static int ProcessJob (SimpleHttpClient* client,
+                       DumpJob const& job,
+                       string& errorMsg) {
+  int res;
+
+  if (job._DBserver.empty()) {
+    ExtendBatch(client, "", BatchId);
+    res = DumpCollection(client, job._file.get(), job._collection, job._maxTick, errorMsg);
+  }
+  else {
+    if (Progress) {
+      std::lock_guard<std::mutex> locker(OutputLock);
+
+      cout << "dumping shard '" << job._collection << "' from DBserver '"
+           << job._DBserver << "' ..." << endl;
+    }
+
+    uint64_t batchId = 0;
+    res = StartBatch(client, job._DBserver, batchId, errorMsg);
+
+    if (res == TRI_ERROR_NO_ERROR) {
+      res = DumpShard(client, job._file.get(), job._DBserver, job._collection, errorMsg);
+
+      if (batchId > 0) {
+        EndBatch(client, job._DBserver, batchId);
+      }
+    }
+  }
+
+  if (res == TRI_ERROR_NO_ERROR &&
+      --job._file->_pending == 0) {
+    res = CloseDataFile(job._file.get());
+  }
+
+  if (res != TRI_ERROR_NO_ERROR && errorMsg.empty()) {
+    errorMsg = "cannot write to file '" + job._file->_fileName + "'";
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the server connection of a dump thread
+////////////////////////////////////////////////////////////////////////////////
+
+static int ConnectWorker (WorkerClient& worker,
+                          string& errorMsg) {
+  std::string const specification = BaseClient.endpointServer()->getSpecification();
+
+  // every connection needs its own endpoint, as the endpoint holds the socket
+  worker._endpoint = Endpoint::clientFactory(specification);
+
+  if (worker._endpoint == nullptr) {
+    errorMsg = "invalid value for --server.endpoint ('" + specification + "')";
+
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  worker._connection = GeneralClientConnection::factory(worker._endpoint,
+                                                        BaseClient.requestTimeout(),
+                                                        BaseClient.connectTimeout(),
+                                                        ArangoClient::DEFAULT_RETRIES,
+                                                        BaseClient.sslProtocol());
+
+  if (worker._connection == nullptr) {
+    errorMsg = "out of memory";
+
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  worker._client = new SimpleHttpClient(worker._connection, BaseClient.requestTimeout(), false);
+  worker._client->setLocationRewriter(nullptr, &rewriteLocation);
+  worker._client->setUserNamePassword("/", BaseClient.username(), BaseClient.password());
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief runs the dump jobs with up to --threads threads
+///
+/// every thread has its own server connection and takes the next job when it
+/// is done with the previous one. after the first error no more jobs are
+/// started
+////////////////////////////////////////////////////////////////////////////////
+
+static int RunJobs (std::vector<DumpJob> const& jobs,
+                    string& errorMsg) {
+  size_t const numThreads = (std::min)(static_cast<size_t>(Threads), jobs.size());
+
+  if (numThreads <= 1) {
+    for (auto const& job : jobs) {
+      int res = ProcessJob(Client, job, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::atomic<size_t> next(0);
+  std::mutex resultLock;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&] () -> void {
+    WorkerClient worker;
+    string msg;
+    int res;
+
+    try {
+      res = ConnectWorker(worker, msg);
+
+      while (res == TRI_ERROR_NO_ERROR) {
+        size_t const i = next++;
+
+        if (i >= jobs.size()) {
+          break;
+        }
+
+        res = ProcessJob(worker._client, jobs[i], msg);
+      }
+    }
+    catch (...) {
+      res = TRI_ERROR_INTERNAL;
+      msg = "caught exception while dumping data";
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      // let the other threads stop after their current job
+      next = jobs.size();
+
+      std::lock_guard<std::mutex> locker(resultLock);
+
+      if (result == TRI_ERROR_NO_ERROR) {
+        result = res;
+        errorMsg = msg;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    try {
+      threads.emplace_back(work);
+    }
+    catch (...) {
+      // go on with the threads we have
+      break;
+    }
+  }
+
+  if (threads.empty()) {
+    work();
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dump data from server
 ////////////////////////////////////////////////////////////////////////////////
@@ -726,6 +1118,10 @@ static int RunDump (string& errorMsg) {
     restrictList.insert(pair<string, bool>(Collections[i], true));
   }
 
+  // the data of the collections is dumped after all structure files are
+  // written
+  std::vector<DumpJob> jobs;
+
   // iterate over collections
   size_t const n = TRI_LengthArrayJson(collections);
 
@@ -814,47 +1210,21 @@ static int RunDump (string& errorMsg) {
 
     if (DumpData) {
       // save the actual data
-      string fileName;
-      fileName = OutputDirectory + TRI_DIR_SEPARATOR_STR + name + "_" + hexString + ".data.json";
-
-      int fd;
-
-      // remove an existing file first
-      if (TRI_ExistsFile(fileName.c_str())) {
-        TRI_UnlinkFile(fileName.c_str());
-      }
-
-      fd = TRI_CREATE(fileName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+      string const fileName = OutputDirectory + TRI_DIR_SEPARATOR_STR + name + "_" + hexString + DataFileSuffix();
 
-      if (fd < 0) {
-        errorMsg = "cannot write to file '" + fileName + "'";
-
-        return TRI_ERROR_CANNOT_WRITE_FILE;
-      }
-
-      ExtendBatch("");
-      int res = DumpCollection(fd, cid, name, parameters, maxTick, errorMsg);
-
-      TRI_CLOSE(fd);
-
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (errorMsg.empty()) {
-          errorMsg = "cannot write to file '" + fileName + "'";
-        }
-
-        return res;
-      }
+      jobs.emplace_back(DumpJob({ cid, "", std::make_shared<DataFile>(fileName, 1), maxTick }));
     }
   }
 
-  return TRI_ERROR_NO_ERROR;
+  return RunJobs(jobs, errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief dump a single shard, that is a collection on a DBserver
 ////////////////////////////////////////////////////////////////////////////////
 
-static int DumpShard (int fd,
+static int DumpShard (SimpleHttpClient* client,
+                      DataFile* file,
                       const string& DBserver,
                       const string& name,
                       string& errorMsg) {
@@ -876,13 +1246,13 @@ static int DumpShard (int fd,
 
     Stats._totalBatches++;
 
-    std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_GET,
+    std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_GET,
                                                  url,
                                                  nullptr,
                                                  0));
 
     if (response == nullptr || ! response->isComplete()) {
-      errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+      errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
       return TRI_ERROR_INTERNAL;
     }
@@ -931,10 +1301,9 @@ static int DumpShard (int fd,
     if (res == TRI_ERROR_NO_ERROR) {
       StringBuffer const& body = response->getBody();
 
-      if (! TRI_WritePointer(fd, body.c_str(), body.length())) {
-        res = TRI_ERROR_CANNOT_WRITE_FILE;
-      }
-      else {
+      res = WriteDataFile(file, body.c_str(), body.length());
+
+      if (res == TRI_ERROR_NO_ERROR) {
         Stats._totalWritten += (uint64_t) body.length();
       }
     }
@@ -959,8 +1328,6 @@ static int DumpShard (int fd,
 ////////////////////////////////////////////////////////////////////////////////
 
 static int RunClusterDump (string& errorMsg) {
-  int res;
-
   std::string const url = "/_api/replication/clusterInventory?includeSystem=" +
                           std::string(IncludeSystemCollections ? "true" : "false");
 
@@ -1008,6 +1375,9 @@ static int RunClusterDump (string& errorMsg) {
     restrictList.insert(pair<string, bool>(Collections[i], true));
   }
 
+  // the shards are dumped after all structure files are written
+  std::vector<DumpJob> jobs;
+
   // iterate over collections
   size_t const n = TRI_LengthArrayJson(collections);
 
@@ -1102,57 +1472,27 @@ static int RunClusterDump (string& errorMsg) {
       map<string, string> shardTab = JsonHelper::stringObject(shards);
       // This is now a map from shardIDs to DBservers
 
-      // Now set up the output file:
+      // Now set up the output file, which is shared by all shards:
       std::string const hexString(triagens::rest::SslInterface::sslMD5(name));
-      string fileName = OutputDirectory + TRI_DIR_SEPARATOR_STR + name + "_" + hexString + ".data.json";
+      string const fileName = OutputDirectory + TRI_DIR_SEPARATOR_STR + name + "_" + hexString + DataFileSuffix();
 
-      // remove an existing file first
-      if (TRI_ExistsFile(fileName.c_str())) {
-        TRI_UnlinkFile(fileName.c_str());
-      }
-
-      int fd = TRI_CREATE(fileName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
-
-      if (fd < 0) {
-        errorMsg = "cannot write to file '" + fileName + "'";
+      auto file = std::make_shared<DataFile>(fileName, shardTab.size());
 
-        return TRI_ERROR_CANNOT_WRITE_FILE;
-      }
+      if (shardTab.empty()) {
+        if (CloseDataFile(file.get()) != TRI_ERROR_NO_ERROR) {
+          errorMsg = "cannot write to file '" + fileName + "'";
 
-      map<string, string>::iterator it;
-      for (it = shardTab.begin(); it != shardTab.end(); it++) {
-        string shardName = it->first;
-        string DBserver = it->second;
-        if (Progress) {
-          cout << "dumping shard '" << shardName << "' from DBserver '"
-               << DBserver << "' ..." << endl;
-        }
-        res = StartBatch(DBserver, errorMsg);
-        if (res != TRI_ERROR_NO_ERROR) {
-          TRI_CLOSE(fd);
-          return res;
+          return TRI_ERROR_CANNOT_WRITE_FILE;
         }
-        res = DumpShard(fd, DBserver, shardName, errorMsg);
-        if (res != TRI_ERROR_NO_ERROR) {
-          TRI_CLOSE(fd);
-          return res;
-        }
-        EndBatch(DBserver);
       }
 
-      res = TRI_CLOSE(fd);
-
-      if (res != TRI_ERROR_NO_ERROR) {
-        if (errorMsg.empty()) {
-          errorMsg = "cannot write to file '" + fileName + "'";
-        }
-
-        return res;
+      for (auto const& it : shardTab) {
+        jobs.emplace_back(DumpJob({ it.first, it.second, file, 0 }));
       }
     }
   }
 
-  return TRI_ERROR_NO_ERROR;
+  return RunJobs(jobs, errorMsg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1209,6 +1549,10 @@ int main (int argc, char* argv[]) {
     MaxChunkSize = ChunkSize;
   }
 
+  if (Threads < 1) {
+    Threads = 1;
+  }
+
   if (TickStart < TickEnd) {
     cerr << "invalid values for --tick-start or --tick-end" << endl;
     TRI_EXIT_FUNCTION(EXIT_FAILURE, nullptr);
@@ -1352,15 +1696,13 @@ int main (int argc, char* argv[]) {
     cout << "Writing dump to output directory '" << OutputDirectory << "'" << endl;
   }
 
-  memset(&Stats, 0, sizeof(Stats));
-
   string errorMsg = "";
 
   int res;
 
   try {
     if (! clusterMode) {
-      res = StartBatch("",errorMsg);
+      res = StartBatch(Client, "", BatchId, errorMsg);
       if (res != TRI_ERROR_NO_ERROR && Force) {
         res = TRI_ERROR_NO_ERROR;
       }
@@ -1370,7 +1712,7 @@ int main (int argc, char* argv[]) {
       }
 
       if (BatchId > 0) {
-        EndBatch("");
+        EndBatch(Client, "", BatchId);
       }
     }
     else {   // clusterMode == true
@@ -130,6 +130,44 @@ static std::string OnDuplicateAction = "error";
 
 static bool Progress = true;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of parallel import requests
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Threads = 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the server shapes JSON documents in bulk
+////////////////////////////////////////////////////////////////////////////////
+
+static bool Bulk = false;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a connection used by a sender thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct SenderClient {
+  SenderClient ()
+    : _endpoint(nullptr),
+      _connection(nullptr),
+      _client(nullptr) {
+  }
+
+  ~SenderClient () {
+    delete _client;
+    delete _connection;
+    delete _endpoint;
+  }
+
+  Endpoint* _endpoint;
+  GeneralClientConnection* _connection;
+  SimpleHttpClient* _client;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -158,6 +196,8 @@ static void ParseProgramOptions (int argc, char* argv[]) {
     ("quote", &Quote, "quote character(s), used for csv")
     ("separator", &Separator, "field separator, used for csv")
     ("progress", &Progress, "show progress")
+    ("threads", &Threads, "number of parallel import requests")
+    ("bulk", &Bulk, "let the server shape JSON documents on multiple threads, for loading large files")
     ("on-duplicate", &OnDuplicateAction, "action to perform when a unique key constraint violation occurs. Possible values: 'error', 'update', 'replace', 'ignore')")
     (deprecatedOptions, true)
   ;
@@ -267,6 +307,37 @@ static string RewriteLocation (void* data, const std::string& location) {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief connects a sender client to the server
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ConnectSender (SenderClient* sender,
+                           std::string& errorMsg) {
+  sender->_endpoint = Endpoint::clientFactory(BaseClient.endpointServer()->getSpecification());
+
+  if (sender->_endpoint == nullptr) {
+    errorMsg = "invalid endpoint";
+    return false;
+  }
+
+  sender->_connection = GeneralClientConnection::factory(sender->_endpoint,
+                                                         BaseClient.requestTimeout(),
+                                                         BaseClient.connectTimeout(),
+                                                         ArangoClient::DEFAULT_RETRIES,
+                                                         BaseClient.sslProtocol());
+
+  if (sender->_connection == nullptr) {
+    errorMsg = "out of memory";
+    return false;
+  }
+
+  sender->_client = new SimpleHttpClient(sender->_connection, BaseClient.requestTimeout(), false);
+  sender->_client->setLocationRewriter(nullptr, &RewriteLocation);
+  sender->_client->setUserNamePassword("/", BaseClient.username(), BaseClient.password());
+
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief main
 ////////////////////////////////////////////////////////////////////////////////
@@ -350,16 +421,46 @@ int main (int argc, char* argv[]) {
 
       cout << "connect timeout:  " << BaseClient.connectTimeout() << endl;
       cout << "request timeout:  " << BaseClient.requestTimeout() << endl;
+      cout << "threads:          " << Threads << endl;
       cout << "----------------------------------------" << endl;
 
+      // one keep-alive connection per sender thread. these must outlive the
+      // import helper, which joins the threads when it is destroyed
+      std::vector<std::unique_ptr<SenderClient>> senders;
+
+      if (Threads > 1) {
+        for (uint32_t i = 0; i < Threads; ++i) {
+          std::unique_ptr<SenderClient> sender(new SenderClient());
+          std::string errorMsg;
+
+          if (! ConnectSender(sender.get(), errorMsg)) {
+            cerr << "Could not create connection: " << errorMsg << endl;
+            TRI_EXIT_FUNCTION(EXIT_FAILURE, nullptr);
+          }
+
+          senders.emplace_back(std::move(sender));
+        }
+      }
+
       triagens::v8client::ImportHelper ih(&client, ChunkSize);
 
+      if (! senders.empty()) {
+        std::vector<SimpleHttpClient*> clients;
+
+        for (auto& sender : senders) {
+          clients.emplace_back(sender->_client);
+        }
+
+        ih.setSenderClients(clients);
+      }
+
       // create colletion
       if (CreateCollection) {
         ih.setCreateCollection(true);
       }
 
       ih.setOverwrite(Overwrite);
+      ih.setBulk(Bulk);
       ih.useBackslash(UseBackslash);
 
       // quote
@@ -460,6 +561,15 @@ int main (int argc, char* argv[]) {
             cout << "lines read:       " << ih.getReadLines() << endl;
           }
 
+          double const duration = ih.getDuration();
+
+          if (duration > 0.0) {
+            size_t const documents = ih.getNumberCreated() + ih.getNumberUpdated();
+
+            cout << "time:             " << StringUtils::ftoa(duration) << " s" << endl;
+            cout << "throughput:       " << StringUtils::ftoa((double) documents / duration) << " documents/s, "
+                 << StringUtils::ftoa((double) ih.getReadBytes() / duration / (1024.0 * 1024.0)) << " MB/s" << endl;
+          }
         }
         else {
           cerr << "error message:    " << ih.getErrorMessage() << endl;
@@ -28,7 +28,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Basics/Common.h"
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "zlib.h"
 
 #include "ArangoShell/ArangoClient.h"
 #include "Basics/files.h"
@@ -153,19 +158,85 @@ static bool ClusterMode = false;
 /// @brief last error code received
 ////////////////////////////////////////////////////////////////////////////////
 
-static int LastErrorCode = TRI_ERROR_NO_ERROR;
+static std::atomic<int> LastErrorCode(TRI_ERROR_NO_ERROR);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of collections restored in parallel
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Threads = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief further endpoints of the same cluster the restore threads use
+////////////////////////////////////////////////////////////////////////////////
+
+static vector<string> AdditionalEndpoints;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes progress output of the restore threads
+////////////////////////////////////////////////////////////////////////////////
+
+static std::mutex OutputLock;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief statistics
 ////////////////////////////////////////////////////////////////////////////////
 
 static struct {
-  uint64_t _totalBatches;
-  uint64_t _totalCollections;
-  uint64_t _totalRead;
+  std::atomic<uint64_t> _totalBatches;
+  std::atomic<uint64_t> _totalCollections;
+  std::atomic<uint64_t> _totalRead;
 }
 Stats;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a separate server connection of a restore thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct WorkerClient {
+  WorkerClient ()
+    : _endpoint(nullptr),
+      _connection(nullptr),
+      _client(nullptr) {
+  }
+
+  ~WorkerClient () {
+    delete _client;
+    delete _connection;
+    delete _endpoint;
+  }
+
+  Endpoint* _endpoint;
+  GeneralClientConnection* _connection;
+  SimpleHttpClient* _client;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a data file, plain or gzip-compressed, in batches of lines
+////////////////////////////////////////////////////////////////////////////////
+
+struct DataReader {
+  DataReader ()
+    : _gz(nullptr),
+      _eof(false),
+      _buffer(TRI_UNKNOWN_MEM_ZONE) {
+  }
+
+  ~DataReader () {
+    if (_gz != nullptr) {
+      gzclose(_gz);
+    }
+  }
+
+  gzFile _gz;
+  bool _eof;
+  StringBuffer _buffer;
+};
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private functions
 // -----------------------------------------------------------------------------
@@ -189,6 +260,8 @@ static void ParseProgramOptions (int argc, char* argv[]) {
     ("input-directory", &InputDirectory, "input directory")
     ("overwrite", &Overwrite, "overwrite collections if they exist")
     ("progress", &Progress, "show progress")
+    ("threads", &Threads, "number of collections to restore in parallel")
+    ("additional-endpoint", &AdditionalEndpoints, "further endpoint of the same cluster to send data to (can be specified multiple times)")
   ;
 
   BaseClient.setupGeneral(description);
@@ -215,6 +288,7 @@ static void ParseProgramOptions (int argc, char* argv[]) {
 
 static void LocalEntryFunction ();
 static void LocalExitFunction (int, void*);
+static string rewriteLocation (void*, const string&);
 
 #ifdef _WIN32
 
@@ -444,7 +518,8 @@ static bool GetArangoIsCluster () {
 /// @brief send the request to re-create a collection
 ////////////////////////////////////////////////////////////////////////////////
 
-static int SendRestoreCollection (TRI_json_t const* json,
+static int SendRestoreCollection (SimpleHttpClient* client,
+                                  TRI_json_t const* json,
                                   string& errorMsg) {
   std::string const url = "/_api/replication/restore-collection"
                           "?overwrite=" + string(Overwrite ? "true" : "false") +
@@ -453,13 +528,13 @@ static int SendRestoreCollection (TRI_json_t const* json,
 
   std::string const body = JsonHelper::toString(json);
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_PUT,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                url,
                                                body.c_str(),
                                                body.size()));
 
   if (response == nullptr || ! response->isComplete()) {
-    errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+    errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
     return TRI_ERROR_INTERNAL;
   }
@@ -477,18 +552,19 @@ static int SendRestoreCollection (TRI_json_t const* json,
 /// @brief send the request to re-create indexes for a collection
 ////////////////////////////////////////////////////////////////////////////////
 
-static int SendRestoreIndexes (TRI_json_t const* json,
+static int SendRestoreIndexes (SimpleHttpClient* client,
+                               TRI_json_t const* json,
                                string& errorMsg) {
   std::string const url = "/_api/replication/restore-indexes?force=" + string(Force ? "true" : "false");
   std::string const body = JsonHelper::toString(json);
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_PUT,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                url,
                                                body.c_str(),
                                                body.size()));
 
   if (response == nullptr || ! response->isComplete()) {
-    errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+    errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
     return TRI_ERROR_INTERNAL;
   }
@@ -506,7 +582,8 @@ static int SendRestoreIndexes (TRI_json_t const* json,
 /// @brief send the request to load data into a collection
 ////////////////////////////////////////////////////////////////////////////////
 
-static int SendRestoreData (string const& cname,
+static int SendRestoreData (SimpleHttpClient* client,
+                            string const& cname,
                             char const* buffer,
                             size_t bufferSize,
                             string& errorMsg) {
@@ -515,13 +592,13 @@ static int SendRestoreData (string const& cname,
                           "&recycleIds=" + (RecycleIds ? "true" : "false") +
                           "&force=" + (Force ? "true" : "false");
 
-  std::unique_ptr<SimpleHttpResult> response(Client->request(HttpRequest::HTTP_REQUEST_PUT,
+  std::unique_ptr<SimpleHttpResult> response(client->request(HttpRequest::HTTP_REQUEST_PUT,
                                                url,
                                                buffer,
                                                bufferSize));
 
   if (response == nullptr || ! response->isComplete()) {
-    errorMsg = "got invalid response from server: " + Client->getErrorMessage();
+    errorMsg = "got invalid response from server: " + client->getErrorMessage();
 
     return TRI_ERROR_INTERNAL;
   }
@@ -535,6 +612,381 @@ static int SendRestoreData (string const& cname,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the next batch of complete lines from a data file. the batch
+/// is empty at the end of the file
+////////////////////////////////////////////////////////////////////////////////
+
+static int ReadBatch (DataReader& reader,
+                      StringBuffer& batch,
+                      string& errorMsg) {
+  StringBuffer& buffer = reader._buffer;
+
+  batch.clear();
+
+  while (true) {
+    while (! reader._eof && buffer.length() < ChunkSize) {
+      if (buffer.reserve(1024 * 1024) != TRI_ERROR_NO_ERROR) {
+        errorMsg = "out of memory";
+
+        return TRI_ERROR_OUT_OF_MEMORY;
+      }
+
+      int numRead = gzread(reader._gz, buffer.end(), 1024 * 1024);
+
+      if (numRead < 0) {
+        // error while reading
+        int errnum;
+        errorMsg = string(gzerror(reader._gz, &errnum));
+
+        return TRI_ERROR_INTERNAL;
+      }
+
+      if (numRead == 0) {
+        reader._eof = true;
+        break;
+      }
+
+      // read something
+      buffer.increaseLength(numRead);
+
+      Stats._totalRead += (uint64_t) numRead;
+    }
+
+    if (buffer.length() == 0) {
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    // look for the last \n in the buffer
+    char const* found = (char const*) memrchr((const void*) buffer.begin(), '\n', buffer.length());
+    size_t length;
+
+    if (found != nullptr) {
+      length = found - buffer.begin() + 1;
+    }
+    else if (reader._eof) {
+      // we're at the end. send the complete buffer anyway
+      length = buffer.length();
+    }
+    else {
+      // no \n found, read more. a single line may exceed the batch size
+      if (buffer.reserve(buffer.length()) != TRI_ERROR_NO_ERROR) {
+        errorMsg = "out of memory";
+
+        return TRI_ERROR_OUT_OF_MEMORY;
+      }
+
+      int numRead = gzread(reader._gz, buffer.end(), static_cast<unsigned int>(buffer.length()));
+
+      if (numRead < 0) {
+        int errnum;
+        errorMsg = string(gzerror(reader._gz, &errnum));
+
+        return TRI_ERROR_INTERNAL;
+      }
+
+      if (numRead == 0) {
+        reader._eof = true;
+      }
+
+      buffer.increaseLength(numRead);
+      Stats._totalRead += (uint64_t) numRead;
+      continue;
+    }
+
+    batch.appendText(buffer.begin(), length);
+    buffer.erase_front(length);
+
+    return TRI_ERROR_NO_ERROR;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads the data file of a collection
+///
+/// the batches of a collection are sent one after the other, as the dump may
+/// contain several operations for the same document. while a batch is on its
+/// way to the server, the next one is read and decompressed
+////////////////////////////////////////////////////////////////////////////////
+
+static int RestoreData (SimpleHttpClient* client,
+                        string const& cname,
+                        string const& datafile,
+                        string& errorMsg) {
+  DataReader reader;
+  reader._gz = gzopen(datafile.c_str(), "rb");
+
+  if (reader._gz == nullptr) {
+    errorMsg = "cannot open collection data file '" + datafile + "'";
+
+    return TRI_ERROR_INTERNAL;
+  }
+
+  std::unique_ptr<StringBuffer> current(new StringBuffer(TRI_UNKNOWN_MEM_ZONE));
+  std::unique_ptr<StringBuffer> following(new StringBuffer(TRI_UNKNOWN_MEM_ZONE));
+
+  int res = ReadBatch(reader, *current, errorMsg);
+
+  while (res == TRI_ERROR_NO_ERROR && current->length() > 0) {
+    int readRes = TRI_ERROR_NO_ERROR;
+    string readMsg;
+    auto readAhead = [&] () -> void {
+      readRes = ReadBatch(reader, *following, readMsg);
+    };
+
+    std::thread ahead;
+    bool readerStarted = true;
+
+    try {
+      ahead = std::thread(readAhead);
+    }
+    catch (...) {
+      readerStarted = false;
+    }
+
+    Stats._totalBatches++;
+
+    res = SendRestoreData(client, cname, current->begin(), current->length(), errorMsg);
+
+    if (readerStarted) {
+      ahead.join();
+    }
+    else {
+      readAhead();
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      if (errorMsg.empty()) {
+        errorMsg = string(TRI_errno_string(res));
+      }
+      else {
+        errorMsg = string(TRI_errno_string(res)) + ": " + errorMsg;
+      }
+
+      if (! Force) {
+        break;
+      }
+
+      {
+        std::lock_guard<std::mutex> locker(OutputLock);
+        cerr << errorMsg << endl;
+      }
+
+      errorMsg.clear();
+      res = TRI_ERROR_NO_ERROR;
+    }
+
+    if (readRes != TRI_ERROR_NO_ERROR) {
+      res = readRes;
+      errorMsg = "cannot read collection data file '" + datafile + "': " + readMsg;
+      break;
+    }
+
+    std::swap(current, following);
+  }
+
+  return res;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads the data of a collection and creates its indexes
+////////////////////////////////////////////////////////////////////////////////
+
+static int RestoreCollection (SimpleHttpClient* client,
+                              TRI_json_t const* json,
+                              string& errorMsg) {
+  TRI_json_t const* parameters = JsonHelper::getObjectElement(json, "parameters");
+  TRI_json_t const* indexes = JsonHelper::getObjectElement(json, "indexes");
+  const string cname = JsonHelper::getStringValue(parameters, "name", "");
+
+  if (ImportData) {
+    // import data. check if we have a datafile, compressed or not
+    std::string const base = InputDirectory + TRI_DIR_SEPARATOR_STR + cname;
+    std::string datafile;
+
+    for (auto const& name : { base + "_" + triagens::rest::SslInterface::sslMD5(cname), base }) {
+      for (auto const& suffix : { ".data.json", ".data.json.gz" }) {
+        if (datafile.empty() && TRI_ExistsFile((name + suffix).c_str())) {
+          datafile = name + suffix;
+        }
+      }
+    }
+
+    if (! datafile.empty()) {
+      // found a datafile
+
+      if (Progress) {
+        std::lock_guard<std::mutex> locker(OutputLock);
+        cout << "Loading data into collection '" << cname << "'..." << endl;
+      }
+
+      int res = RestoreData(client, cname, datafile, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+  }
+
+  if (ImportStructure) {
+    // re-create indexes
+
+    if (TRI_LengthVector(&indexes->_value._objects) > 0) {
+      // we actually have indexes
+      if (Progress) {
+        std::lock_guard<std::mutex> locker(OutputLock);
+        cout << "Creating indexes for collection '" << cname << "'..." << endl;
+      }
+
+      int res = SendRestoreIndexes(client, json, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        if (! Force) {
+          return TRI_ERROR_INTERNAL;
+        }
+
+        std::lock_guard<std::mutex> locker(OutputLock);
+        cerr << errorMsg << endl;
+        errorMsg.clear();
+      }
+    }
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates the server connection of a restore thread
+////////////////////////////////////////////////////////////////////////////////
+
+static int ConnectWorker (WorkerClient& worker,
+                          std::string const& specification,
+                          string& errorMsg) {
+  // every connection needs its own endpoint, as the endpoint holds the socket
+  worker._endpoint = Endpoint::clientFactory(specification);
+
+  if (worker._endpoint == nullptr) {
+    errorMsg = "invalid endpoint '" + specification + "'";
+
+    return TRI_ERROR_BAD_PARAMETER;
+  }
+
+  worker._connection = GeneralClientConnection::factory(worker._endpoint,
+                                                        BaseClient.requestTimeout(),
+                                                        BaseClient.connectTimeout(),
+                                                        ArangoClient::DEFAULT_RETRIES,
+                                                        BaseClient.sslProtocol());
+
+  if (worker._connection == nullptr) {
+    errorMsg = "out of memory";
+
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  worker._client = new SimpleHttpClient(worker._connection, BaseClient.requestTimeout(), false);
+  worker._client->setLocationRewriter(nullptr, &rewriteLocation);
+  worker._client->setUserNamePassword("/", BaseClient.username(), BaseClient.password());
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restores the data and indexes of the collections with up to
+/// --threads threads
+///
+/// every thread has its own connection. the threads use the endpoint given in
+/// --server.endpoint and the ones given in --additional-endpoint in turn, so
+/// the load is spread over several coordinators of a cluster. after the first
+/// error no more collections are started
+////////////////////////////////////////////////////////////////////////////////
+
+static int RunRestoreJobs (std::vector<TRI_json_t const*> const& jobs,
+                           string& errorMsg) {
+  if (jobs.empty()) {
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  size_t const numThreads = (std::min)(static_cast<size_t>(Threads), jobs.size());
+
+  if (numThreads <= 1 && AdditionalEndpoints.empty()) {
+    for (auto const& json : jobs) {
+      int res = RestoreCollection(Client, json, errorMsg);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+    }
+
+    return TRI_ERROR_NO_ERROR;
+  }
+
+  std::vector<std::string> endpoints;
+  endpoints.emplace_back(BaseClient.endpointServer()->getSpecification());
+  endpoints.insert(endpoints.end(), AdditionalEndpoints.begin(), AdditionalEndpoints.end());
+
+  std::atomic<size_t> next(0);
+  std::mutex resultLock;
+  int result = TRI_ERROR_NO_ERROR;
+
+  auto work = [&] (size_t id) -> void {
+    WorkerClient worker;
+    string msg;
+    int res;
+
+    try {
+      res = ConnectWorker(worker, endpoints[id % endpoints.size()], msg);
+
+      while (res == TRI_ERROR_NO_ERROR) {
+        size_t const i = next++;
+
+        if (i >= jobs.size()) {
+          break;
+        }
+
+        res = RestoreCollection(worker._client, jobs[i], msg);
+      }
+    }
+    catch (...) {
+      res = TRI_ERROR_INTERNAL;
+      msg = "caught exception while restoring data";
+    }
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      // let the other threads stop after their current collection
+      next = jobs.size();
+
+      std::lock_guard<std::mutex> locker(resultLock);
+
+      if (result == TRI_ERROR_NO_ERROR) {
+        result = res;
+        errorMsg = msg;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < numThreads; ++i) {
+    try {
+      threads.emplace_back(work, i);
+    }
+    catch (...) {
+      // go on with the threads we have
+      break;
+    }
+  }
+
+  if (threads.empty()) {
+    work(0);
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief comparator to sort collections
 /// sort order is by collection type first (vertices before edges, this is
@@ -669,16 +1121,16 @@ static int ProcessInputDirectory (string& errorMsg) {
   // sort collections according to type (documents before edges)
   qsort(collections->_value._objects._buffer, n, sizeof(TRI_json_t), &SortCollections);
 
-  StringBuffer buffer(TRI_UNKNOWN_MEM_ZONE);
+  // the collections whose data and indexes are restored
+  std::vector<TRI_json_t const*> jobs;
 
-  // step2: run the actual import
+  // step2: create the collections. this is done one after the other, so
+  // vertex collections exist before the edge collections
   {
     for (size_t i = 0; i < n; ++i) {
       TRI_json_t const* json = (TRI_json_t const*) TRI_AtVector(&collections->_value._objects, i);
       TRI_json_t const* parameters = JsonHelper::getObjectElement(json, "parameters");
-      TRI_json_t const* indexes = JsonHelper::getObjectElement(json, "indexes");
       const string cname = JsonHelper::getStringValue(parameters, "name", "");
-      const string cid   = JsonHelper::getStringValue(parameters, "cid", "");
 
       if (ImportStructure) {
         // re-create collection
@@ -691,7 +1143,7 @@ static int ProcessInputDirectory (string& errorMsg) {
           }
         }
 
-        int res = SendRestoreCollection(json, errorMsg);
+        int res = SendRestoreCollection(Client, json, errorMsg);
 
         if (res != TRI_ERROR_NO_ERROR) {
           if (Force) {
@@ -707,151 +1159,16 @@ static int ProcessInputDirectory (string& errorMsg) {
 
       Stats._totalCollections++;
 
-      if (ImportData) {
-        // import data. check if we have a datafile
-        std::string datafile = InputDirectory + TRI_DIR_SEPARATOR_STR + cname + "_" + triagens::rest::SslInterface::sslMD5(cname) + ".data.json";
-        if (! TRI_ExistsFile(datafile.c_str())) {
-          datafile = InputDirectory + TRI_DIR_SEPARATOR_STR + cname + ".data.json";
-        }
-
-        if (TRI_ExistsFile(datafile.c_str())) {
-          // found a datafile
-
-          if (Progress) {
-            cout << "Loading data into collection '" << cname << "'..." << endl;
-          }
-
-          int fd = TRI_OPEN(datafile.c_str(), O_RDONLY);
-
-          if (fd < 0) {
-            errorMsg = "cannot open collection data file '" + datafile + "'";
-            TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
-
-            return TRI_ERROR_INTERNAL;
-          }
-
-          buffer.clear();
-
-          while (true) {
-            if (buffer.reserve(16384) != TRI_ERROR_NO_ERROR) {
-              TRI_CLOSE(fd);
-              errorMsg = "out of memory";
-              TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
-
-              return TRI_ERROR_OUT_OF_MEMORY;
-            }
-
-            ssize_t numRead = TRI_READ(fd, buffer.end(), 16384);
-
-            if (numRead < 0) {
-              // error while reading
-              int res = TRI_errno();
-              TRI_CLOSE(fd);
-              errorMsg = string(TRI_errno_string(res));
-              TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
-
-              return res;
-            }
-
-            // read something
-            buffer.increaseLength(numRead);
-
-            Stats._totalRead += (uint64_t) numRead;
-
-            if (buffer.length() < ChunkSize && numRead > 0) {
-              // still continue reading
-              continue;
-            }
-
-            // do we have a buffer?
-            if (buffer.length() > 0) {
-              // look for the last \n in the buffer
-              char* found = (char*) memrchr((const void*) buffer.begin(), '\n', buffer.length());
-              size_t length;
-
-              if (found == nullptr) {
-                // no \n found...
-                if (numRead == 0) {
-                  // we're at the end. send the complete buffer anyway
-                  length = buffer.length();
-                }
-                else {
-                  // read more
-                  continue;
-                }
-              }
-              else {
-                // found a \n somewhere
-                length = found - buffer.begin();
-              }
-
-              TRI_ASSERT(length > 0);
-
-              Stats._totalBatches++;
-
-              int res = SendRestoreData(cname, buffer.begin(), length, errorMsg);
-
-              if (res != TRI_ERROR_NO_ERROR) {
-                TRI_CLOSE(fd);
-                if (errorMsg.empty()) {
-                  errorMsg = string(TRI_errno_string(res));
-                }
-                else {
-                  errorMsg = string(TRI_errno_string(res)) + ": " + errorMsg;
-                }
-
-                if (Force) {
-                  cerr << errorMsg << endl;
-                  continue;
-                }
-
-                TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
-                return res;
-              }
-
-              buffer.erase_front(length);
-            }
-
-            if (numRead == 0) {
-              // EOF
-              break;
-            }
-          }
-
-          TRI_CLOSE(fd);
-        }
-      }
-
-
-      if (ImportStructure) {
-        // re-create indexes
-
-        if (TRI_LengthVector(&indexes->_value._objects) > 0) {
-          // we actually have indexes
-          if (Progress) {
-            cout << "Creating indexes for collection '" << cname << "'..." << endl;
-          }
-
-          int res = SendRestoreIndexes(json, errorMsg);
-
-          if (res != TRI_ERROR_NO_ERROR) {
-            if (Force) {
-              cerr << errorMsg << endl;
-              continue;
-            }
-
-            TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
-
-            return TRI_ERROR_INTERNAL;
-          }
-        }
-      }
+      jobs.emplace_back(json);
     }
   }
 
+  // step3: run the actual import, possibly in parallel
+  int res = RunRestoreJobs(jobs, errorMsg);
+
   TRI_FreeJson(TRI_UNKNOWN_MEM_ZONE, collections);
 
-  return TRI_ERROR_NO_ERROR;
+  return res;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -903,6 +1220,10 @@ int main (int argc, char* argv[]) {
     ChunkSize = 1024 * 128;
   }
 
+  if (Threads < 1) {
+    Threads = 1;
+  }
+
   if (! InputDirectory.empty() &&
       InputDirectory.back() == TRI_DIR_SEPARATOR_CHAR) {
     // trim trailing slash from path because it may cause problems on ... Windows
@@ -1018,8 +1339,6 @@ int main (int argc, char* argv[]) {
     cout << "Connected to ArangoDB '" << BaseClient.endpointServer()->getSpecification() << endl;
   }
 
-  memset(&Stats, 0, sizeof(Stats));
-
   string errorMsg = "";
 
   int res;
@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append-only associative array with lock-free lookups
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/AssocAppendOnly.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the array
+////////////////////////////////////////////////////////////////////////////////
+
+AssocAppendOnly::AssocAppendOnly (HashKeyFuncType hashKey,
+                                  HashElementFuncType hashElement,
+                                  IsEqualKeyElementFuncType isEqualKeyElement,
+                                  uint64_t initialSize)
+  : _hashKey(hashKey),
+    _hashElement(hashElement),
+    _isEqualKeyElement(isEqualKeyElement),
+    _table(nullptr),
+    _nrUsed(0) {
+
+  uint64_t nrAlloc = 8;
+
+  while (nrAlloc < initialSize) {
+    nrAlloc <<= 1;
+  }
+
+  Table* table = createTable(nrAlloc);
+
+  if (table == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  _table.store(table, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the array
+////////////////////////////////////////////////////////////////////////////////
+
+AssocAppendOnly::~AssocAppendOnly () {
+  Table* table = _table.load(std::memory_order_relaxed);
+
+  while (table != nullptr) {
+    Table* previous = table->_previous;
+
+    delete[] table->_slots;
+    delete table;
+
+    table = previous;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an element
+////////////////////////////////////////////////////////////////////////////////
+
+int AssocAppendOnly::insert (void const* key,
+                             void* element,
+                             bool overwrite,
+                             void** found) {
+  TRI_ASSERT(element != nullptr);
+
+  if (found != nullptr) {
+    *found = nullptr;
+  }
+
+  Table* table = _table.load(std::memory_order_relaxed);
+  uint64_t mask = table->_nrAlloc - 1;
+  uint64_t i = _hashKey(key) & mask;
+
+  while (true) {
+    void* old = table->_slots[i].load(std::memory_order_relaxed);
+
+    if (old == nullptr) {
+      break;
+    }
+
+    if (_isEqualKeyElement(key, old)) {
+      if (found != nullptr) {
+        *found = old;
+      }
+
+      if (overwrite) {
+        table->_slots[i].store(element, std::memory_order_release);
+      }
+
+      return TRI_ERROR_NO_ERROR;
+    }
+
+    i = (i + 1) & mask;
+  }
+
+  // a new element. keep the table at most half full, but continue with the
+  // current table as long as there is room if we cannot get a bigger one
+  if (2 * (_nrUsed + 1) > table->_nrAlloc) {
+    if (grow()) {
+      table = _table.load(std::memory_order_relaxed);
+      mask = table->_nrAlloc - 1;
+      i = _hashKey(key) & mask;
+
+      while (table->_slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & mask;
+      }
+    }
+    else if (_nrUsed + 1 >= table->_nrAlloc) {
+      return TRI_ERROR_OUT_OF_MEMORY;
+    }
+  }
+
+  table->_slots[i].store(element, std::memory_order_release);
+  ++_nrUsed;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback for all elements
+////////////////////////////////////////////////////////////////////////////////
+
+void AssocAppendOnly::invokeOnAllElements (std::function<void(void*)> const& callback) const {
+  Table const* table = _table.load(std::memory_order_acquire);
+
+  for (uint64_t i = 0; i < table->_nrAlloc; ++i) {
+    void* element = table->_slots[i].load(std::memory_order_relaxed);
+
+    if (element != nullptr) {
+      callback(element);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates an empty table
+////////////////////////////////////////////////////////////////////////////////
+
+AssocAppendOnly::Table* AssocAppendOnly::createTable (uint64_t nrAlloc) {
+  Table* table = new (std::nothrow) Table;
+
+  if (table == nullptr) {
+    return nullptr;
+  }
+
+  // value-initialization sets all slots to nullptr
+  table->_slots = new (std::nothrow) std::atomic<void*>[nrAlloc]();
+
+  if (table->_slots == nullptr) {
+    delete table;
+    return nullptr;
+  }
+
+  table->_nrAlloc = nrAlloc;
+  table->_previous = nullptr;
+
+  return table;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes a table of twice the size
+///
+/// The new table is completely filled before it is published, so readers
+/// either see the old or the new table, both containing all elements added
+/// so far.
+////////////////////////////////////////////////////////////////////////////////
+
+bool AssocAppendOnly::grow () {
+  Table* old = _table.load(std::memory_order_relaxed);
+  Table* table = createTable(2 * old->_nrAlloc);
+
+  if (table == nullptr) {
+    return false;
+  }
+
+  uint64_t const mask = table->_nrAlloc - 1;
+
+  for (uint64_t j = 0; j < old->_nrAlloc; ++j) {
+    void* element = old->_slots[j].load(std::memory_order_relaxed);
+
+    if (element != nullptr) {
+      uint64_t i = _hashElement(element) & mask;
+
+      while (table->_slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & mask;
+      }
+
+      table->_slots[i].store(element, std::memory_order_relaxed);
+    }
+  }
+
+  table->_previous = old;
+  _table.store(table, std::memory_order_release);
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
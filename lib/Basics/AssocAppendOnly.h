@@ -0,0 +1,194 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append-only associative array with lock-free lookups
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_ASSOC_APPEND_ONLY_H
+#define ARANGODB_BASICS_ASSOC_APPEND_ONLY_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             class AssocAppendOnly
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief associative array of pointers for read-mostly dictionaries
+///
+/// Elements can be added and replaced, but never removed. Lookups take no
+/// lock at all: they read an immutable-sized snapshot of the table through
+/// an atomic pointer and probe its slots with atomic loads. Modifications
+/// must be serialized by the caller, e.g. with a mutex.
+///
+/// When the table gets more than half full, a table of twice the size is
+/// filled and then published atomically. Readers may still be probing the
+/// previous table, so it is kept until the array is destroyed. As tables
+/// double in size, all previous tables together take no more memory than
+/// the current one.
+////////////////////////////////////////////////////////////////////////////////
+
+    class AssocAppendOnly {
+
+      public:
+
+        typedef uint64_t (*HashKeyFuncType) (void const*);
+        typedef uint64_t (*HashElementFuncType) (void const*);
+        typedef bool (*IsEqualKeyElementFuncType) (void const*, void const*);
+
+      private:
+
+        struct Table {
+          uint64_t                _nrAlloc;   // always a power of two
+          std::atomic<void*>*     _slots;
+          Table*                  _previous;  // retired predecessor
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        AssocAppendOnly (AssocAppendOnly const&) = delete;
+        AssocAppendOnly& operator= (AssocAppendOnly const&) = delete;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief create the array
+///
+/// For arrays that use the elements themselves as keys, pass the element
+/// hash function for both hash functions.
+////////////////////////////////////////////////////////////////////////////////
+
+        AssocAppendOnly (HashKeyFuncType,
+                         HashElementFuncType,
+                         IsEqualKeyElementFuncType,
+                         uint64_t initialSize = 64);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroy the array, the elements are not freed
+////////////////////////////////////////////////////////////////////////////////
+
+        ~AssocAppendOnly ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up an element by key, may run concurrently with modifications
+////////////////////////////////////////////////////////////////////////////////
+
+        void* lookup (void const* key) const {
+          Table const* table = _table.load(std::memory_order_acquire);
+          uint64_t const mask = table->_nrAlloc - 1;
+          uint64_t i = _hashKey(key) & mask;
+
+          while (true) {
+            void* element = table->_slots[i].load(std::memory_order_acquire);
+
+            if (element == nullptr || _isEqualKeyElement(key, element)) {
+              return element;
+            }
+
+            i = (i + 1) & mask;
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an element, callers must serialize modifications
+///
+/// If an element with the same key is present, it is returned in found and
+/// replaced only if overwrite is set. Otherwise found is set to nullptr.
+////////////////////////////////////////////////////////////////////////////////
+
+        int insert (void const* key,
+                    void* element,
+                    bool overwrite,
+                    void** found);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback for all elements, callers must make sure
+/// there are no concurrent modifications
+////////////////////////////////////////////////////////////////////////////////
+
+        void invokeOnAllElements (std::function<void(void*)> const&) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of elements
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t size () const {
+          return _nrUsed;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates an empty table
+////////////////////////////////////////////////////////////////////////////////
+
+        static Table* createTable (uint64_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes a table of twice the size
+////////////////////////////////////////////////////////////////////////////////
+
+        bool grow ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        HashKeyFuncType const           _hashKey;
+        HashElementFuncType const       _hashElement;
+        IsEqualKeyElementFuncType const _isEqualKeyElement;
+
+        std::atomic<Table*>             _table;
+        uint64_t                        _nrUsed;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
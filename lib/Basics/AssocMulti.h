@@ -193,6 +193,12 @@ namespace triagens {
 
         std::function<std::string()> _contextCallback;
 
+        // the zone the memory of the tables is accounted in
+        TRI_memory_zone_t* _memoryZone;
+
+        // the preferred NUMA node of large tables, -1 for none
+        int _numaNode;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -210,7 +216,8 @@ namespace triagens {
                     IsEqualElementElementFuncType isEqualElementElementByKey,
                     size_t numberBuckets = 1,
                     IndexType initialSize = 64,
-                    std::function<std::string()> contextCallback = [] () -> std::string { return ""; }) :
+                    std::function<std::string()> contextCallback = [] () -> std::string { return ""; },
+                    TRI_memory_zone_t* memoryZone = TRI_UNKNOWN_MEM_ZONE) :
 #ifdef TRI_INTERNAL_STATS
             _nrFinds(0), _nrAdds(0), _nrRems(0), _nrResizes(0),
             _nrProbes(0), _nrProbesF(0), _nrProbesD(0),
@@ -220,7 +227,9 @@ namespace triagens {
             _isEqualKeyElement(isEqualKeyElement),
             _isEqualElementElement(isEqualElementElement),
             _isEqualElementElementByKey(isEqualElementElementByKey),
-            _contextCallback(contextCallback) {
+            _contextCallback(contextCallback),
+            _memoryZone(memoryZone),
+            _numaNode(-1) {
 
           // Make the number of buckets a power of two:
           size_t ex = 0;
@@ -242,18 +251,7 @@ namespace triagens {
               b._table = nullptr;
 
               // may fail...
-              b._table = new EntryType[b._nrAlloc];
-
-#ifdef __linux__
-              if (b._nrAlloc > 1000000) {
-                uintptr_t mem = reinterpret_cast<uintptr_t>(b._table);
-                uintptr_t pageSize = getpagesize();
-                mem = (mem / pageSize) * pageSize;
-                void* memptr = reinterpret_cast<void*>(mem);
-                TRI_MMFileAdvise(memptr, b._nrAlloc * sizeof(EntryType),
-                                 TRI_MADVISE_RANDOM);
-              }
-#endif
+              b._table = allocateTable(b._nrAlloc);
 
               for (IndexType i = 0; i < b._nrAlloc; i++) {
                 invalidateEntry(b, i);
@@ -262,7 +260,7 @@ namespace triagens {
           }
           catch (...) {
             for (auto& b : _buckets) {
-              delete [] b._table;
+              freeTable(b._table, b._nrAlloc);
               b._table = nullptr;
               b._nrAlloc = 0;
             }
@@ -276,10 +274,8 @@ namespace triagens {
 
         ~AssocMulti () {
           for (auto& b : _buckets) {
-            if (b._table != nullptr) {
-              delete [] b._table;
-              b._table = nullptr;
-            }
+            freeTable(b._table, b._nrAlloc);
+            b._table = nullptr;
           }
         }
 
@@ -288,6 +284,14 @@ namespace triagens {
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the preferred NUMA node for tables allocated from now on
+////////////////////////////////////////////////////////////////////////////////
+
+        void setNumaNode (int node) {
+          _numaNode = node;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief return the memory used by the hash table
 ////////////////////////////////////////////////////////////////////////////////
@@ -852,6 +856,97 @@ namespace triagens {
           return result.release();
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookups the elements for a batch of keys
+/// the hashes of all keys are computed up front, so the table slots can be
+/// prefetched a few probes ahead. the keys are probed in hash order, which
+/// makes equal keys adjacent: keys that find the same list of elements are
+/// only returned once. the elements are appended to result in no particular
+/// order
+////////////////////////////////////////////////////////////////////////////////
+
+        void lookupByKeys (std::vector<Key const*> const& keys,
+                           std::vector<Element*>& result) const {
+          static size_t const PrefetchDistance = 8;
+
+          struct Probe {
+            uint64_t hashByKey;
+            Key const* key;
+
+            bool operator< (Probe const& other) const {
+              return hashByKey < other.hashByKey;
+            }
+          };
+
+          size_t const n = keys.size();
+          std::vector<Probe> probes;
+          probes.reserve(n);
+
+          for (auto const& key : keys) {
+            probes.emplace_back(Probe{ _hashKey(key), key });
+          }
+
+          std::sort(probes.begin(), probes.end());
+
+          // start positions of the lists found for the current hash value
+          std::vector<std::pair<Bucket const*, IndexType>> found;
+
+          for (size_t j = 0; j < n; ++j) {
+            if (j + PrefetchDistance < n) {
+              uint64_t const ahead = probes[j + PrefetchDistance].hashByKey;
+              Bucket const& pb = _buckets[ahead & _bucketsMask];
+              PR(&pb._table[hashToIndex(ahead) % pb._nrAlloc]);
+            }
+
+            uint64_t const hashByKey = probes[j].hashByKey;
+            Key const* key = probes[j].key;
+
+            if (j > 0 && probes[j - 1].hashByKey != hashByKey) {
+              found.clear();
+            }
+
+            Bucket const& b = _buckets[hashByKey & _bucketsMask];
+            IndexType i = hashToIndex(hashByKey) % b._nrAlloc;
+
+#ifdef TRI_INTERNAL_STATS
+            // update statistics
+            _nrFinds++;
+#endif
+
+            // search the table
+            while (b._table[i].ptr != nullptr &&
+                   (b._table[i].prev != INVALID_INDEX ||
+                    (useHashCache && b._table[i].readHashCache() != hashByKey) ||
+                    ! _isEqualKeyElement(key, b._table[i].ptr))
+                  ) {
+              i = incr(b, i);
+#ifdef TRI_INTERNAL_STATS
+              _nrProbesF++;
+#endif
+            }
+
+            if (b._table[i].ptr == nullptr) {
+              continue;
+            }
+
+            auto position = std::make_pair(&b, i);
+
+            if (std::find(found.begin(), found.end(), position) != found.end()) {
+              // an equal key was already looked up
+              continue;
+            }
+
+            found.emplace_back(position);
+
+            // We found the beginning of the linked list:
+            do {
+              result.push_back(b._table[i].ptr);
+              i = b._table[i].next;
+            }
+            while (i != INVALID_INDEX);
+          }
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief looks up all elements with the same key as a given element
 ////////////////////////////////////////////////////////////////////////////////
@@ -1111,6 +1206,54 @@ namespace triagens {
           return i < b._nrAlloc ? i : dummy;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts the memory of tables allocated (1) or freed (-1)
+////////////////////////////////////////////////////////////////////////////////
+
+        void accountTable (IndexType size, int64_t tables) {
+          TRI_AddMemoryZoneUsage(_memoryZone, tables * (int64_t) (size * sizeof(EntryType)), tables);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a table, the entries are not initialized. large tables
+/// are mapped separately, so that they can use huge pages
+////////////////////////////////////////////////////////////////////////////////
+
+        EntryType* allocateTable (IndexType size) {
+          EntryType* table = static_cast<EntryType*>(TRI_AllocateLargeTable(size * sizeof(EntryType)));
+
+          if (table == nullptr) {
+            throw std::bad_alloc();
+          }
+
+          TRI_BindLargeTable(table, size * sizeof(EntryType), _numaNode);
+          accountTable(size, 1);
+
+#ifdef __linux__
+          if (size > 1000000) {
+            uintptr_t mem = reinterpret_cast<uintptr_t>(table);
+            uintptr_t pageSize = getpagesize();
+            mem = (mem / pageSize) * pageSize;
+            void* memptr = reinterpret_cast<void*>(mem);
+            TRI_MMFileAdvise(memptr, size * sizeof(EntryType),
+                             TRI_MADVISE_RANDOM);
+          }
+#endif
+
+          return table;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a table
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeTable (EntryType* table, IndexType size) {
+          if (table != nullptr) {
+            TRI_FreeLargeTable(table, size * sizeof(EntryType));
+            accountTable(size, -1);
+          }
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief resize the array, internal method
 ////////////////////////////////////////////////////////////////////////////////
@@ -1127,17 +1270,7 @@ namespace triagens {
           b._nrAlloc = static_cast<IndexType>(TRI_NearPrime(static_cast<uint64_t>(size)));
 
           try {
-            b._table = new EntryType[b._nrAlloc];
-#ifdef __linux__
-            if (b._nrAlloc > 1000000) {
-              uintptr_t mem = reinterpret_cast<uintptr_t>(b._table);
-              uintptr_t pageSize = getpagesize();
-              mem = (mem / pageSize) * pageSize;
-              void* memptr = reinterpret_cast<void*>(mem);
-              TRI_MMFileAdvise(memptr, b._nrAlloc * sizeof(EntryType),
-                               TRI_MADVISE_RANDOM);
-            }
-#endif
+            b._table = allocateTable(b._nrAlloc);
 
             IndexType i;
             for (i = 0; i < b._nrAlloc; i++) {
@@ -1190,7 +1323,7 @@ namespace triagens {
             }
           }
 
-          delete [] oldTable;
+          freeTable(oldTable, oldAlloc);
 
           LOG_TIMER((TRI_microtime() - start),
                     "index-resize, %s, target size: %llu",
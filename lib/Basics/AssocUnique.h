@@ -68,6 +68,42 @@ namespace triagens {
       }
     };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cursor of a scan over an associative array in chunks
+///
+/// unlike a BucketPosition, the cursor stays valid while the array is
+/// modified between two chunks. the elements returned from the current
+/// bucket are remembered, so that the bucket can be scanned again if its
+/// elements were moved in the meantime
+////////////////////////////////////////////////////////////////////////////////
+
+    struct ScanCursor {
+      size_t bucketId;
+      size_t endBucketId;
+      uint64_t position;
+      uint64_t moves;
+      std::unordered_set<void const*> returned;
+
+      ScanCursor ()
+        : bucketId(0),
+          endBucketId(SIZE_MAX),
+          position(0),
+          moves(0) {
+      }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief restricts the scan to the buckets [begin, end)
+////////////////////////////////////////////////////////////////////////////////
+
+      ScanCursor (size_t begin,
+                  size_t end)
+        : bucketId(begin),
+          endBucketId(end),
+          position(0),
+          moves(0) {
+      }
+    };
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                       UNIQUE ASSOCIATIVE POINTERS
 // -----------------------------------------------------------------------------
@@ -91,12 +127,32 @@ namespace triagens {
           typedef std::function<void(Element*)> CallbackElementFuncType;
 
         private:
+
+          // a slot keeps the hash of its element next to the pointer. probes
+          // compare the hashes first, so that a mismatch is rejected without
+          // touching the element, and resizes do not hash the elements again
+          struct Slot {
+            Element* element;
+            uint64_t hash;
+          };
+
           struct Bucket {
 
             uint64_t _nrAlloc; // the size of the table
-            uint64_t _nrUsed;  // the number of used entries
+            uint64_t _nrUsed;  // the number of used entries, in both tables
+
+            Slot* _table; // the table itself, aligned to a cache line boundary
 
-            Element** _table; // the table itself, aligned to a cache line boundary
+            // while a large bucket is resized incrementally, the previous
+            // table with the elements not yet moved to _table. slots that
+            // were moved or removed hold movedMarker()
+            Slot* _oldTable;
+            uint64_t _oldAlloc;  // the size of the old table
+            uint64_t _migrated;  // number of old table slots processed
+
+            // number of times elements of the bucket were moved to other
+            // slots. used by chunked scans to detect a changed layout
+            uint64_t _moves;
           };
 
           std::vector<Bucket> _buckets;
@@ -110,6 +166,12 @@ namespace triagens {
 
           std::function<std::string()> _contextCallback;
 
+          // the zone the memory of the tables is accounted in
+          TRI_memory_zone_t* _memoryZone;
+
+          // the preferred NUMA node of large tables, -1 for none
+          int _numaNode;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -126,13 +188,16 @@ namespace triagens {
               IsEqualElementElementFuncType isEqualElementElement,
               IsEqualElementElementFuncType isEqualElementElementByKey,
               size_t numberBuckets = 1,
-              std::function<std::string()> contextCallback = [] () -> std::string { return ""; }) 
+              std::function<std::string()> contextCallback = [] () -> std::string { return ""; },
+              TRI_memory_zone_t* memoryZone = TRI_UNKNOWN_MEM_ZONE) 
             : _hashKey(hashKey), 
               _hashElement(hashElement),
               _isEqualKeyElement(isEqualKeyElement),
               _isEqualElementElement(isEqualElementElement),
               _isEqualElementElementByKey(isEqualElementElementByKey),
-              _contextCallback(contextCallback) {
+              _contextCallback(contextCallback),
+              _memoryZone(memoryZone),
+              _numaNode(-1) {
 
               // Make the number of buckets a power of two:
               size_t ex = 0;
@@ -152,18 +217,18 @@ namespace triagens {
                   Bucket& b = _buckets.back();
                   b._nrAlloc = initialSize();
                   b._table = nullptr;
+                  b._oldTable = nullptr;
+                  b._oldAlloc = 0;
+                  b._migrated = 0;
+                  b._moves = 0;
 
                   // may fail...
-                  b._table = new Element* [b._nrAlloc];
-
-                  for (uint64_t i = 0; i < b._nrAlloc; i++) {
-                    b._table[i] = nullptr;
-                  }
+                  b._table = allocateTable(b._nrAlloc);
                 }
               }
               catch (...) {
                 for (auto& b : _buckets) {
-                  delete [] b._table;
+                  freeTable(b._table, b._nrAlloc);
                   b._table = nullptr;
                   b._nrAlloc = 0;
                 }
@@ -177,9 +242,12 @@ namespace triagens {
 
           ~AssocUnique () {
             for (auto& b : _buckets) {
-              delete [] b._table;
+              freeTable(b._table, b._nrAlloc);
               b._table = nullptr;
               b._nrAlloc = 0;
+              freeTable(b._oldTable, b._oldAlloc);
+              b._oldTable = nullptr;
+              b._oldAlloc = 0;
             }
           }
 
@@ -205,6 +273,274 @@ namespace triagens {
             return 251;
           }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tables larger than this are resized incrementally when they grow,
+/// smaller ones are rehashed in one go
+////////////////////////////////////////////////////////////////////////////////
+
+          static uint64_t incrementalResizeThreshold () {
+            return 131072;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of old table slots moved per modification of a bucket
+/// that is resized incrementally
+////////////////////////////////////////////////////////////////////////////////
+
+          static uint64_t migrationStep () {
+            return 256;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief marker for a slot of an old table whose element was moved or
+/// removed. unlike an empty slot, this does not end a probe sequence
+////////////////////////////////////////////////////////////////////////////////
+
+          static Element* movedMarker () {
+            return reinterpret_cast<Element*>(static_cast<uintptr_t>(1));
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the slot of a table that holds an element with the hash
+/// for which isEqual is true, or the empty slot that ends the probe sequence
+////////////////////////////////////////////////////////////////////////////////
+
+          template<typename F>
+          static uint64_t findSlot (Slot const* table,
+                                    uint64_t n,
+                                    uint64_t hash,
+                                    F const& isEqual) {
+            uint64_t i = hash % n;
+            uint64_t k = i;
+
+            for (; i < n && ! isEndOfProbe(table[i], hash, isEqual); ++i);
+            if (i == n) {
+              for (i = 0; i < k && ! isEndOfProbe(table[i], hash, isEqual); ++i);
+            }
+
+            return i;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a probe ends at a slot, because it is empty or holds the
+/// element searched for. the element is only looked at if the hashes match
+////////////////////////////////////////////////////////////////////////////////
+
+          template<typename F>
+          static inline bool isEndOfProbe (Slot const& slot,
+                                           uint64_t hash,
+                                           F const& isEqual) {
+            return (slot.element == nullptr ||
+                    (slot.hash == hash &&
+                     slot.element != movedMarker() &&
+                     isEqual(slot.element)));
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief places an element into the first empty slot of its probe sequence
+////////////////////////////////////////////////////////////////////////////////
+
+          static void place (Slot* table,
+                             uint64_t n,
+                             Element* element,
+                             uint64_t hash) {
+            uint64_t i, k;
+            i = k = hash % n;
+
+            for (; i < n && table[i].element != nullptr; ++i);
+            if (i == n) {
+              for (i = 0; i < k && table[i].element != nullptr; ++i);
+            }
+
+            table[i].element = element;
+            table[i].hash = hash;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds an element in a bucket, looking into the old table, too.
+/// slot is set to the slot in the current table at which the element is or
+/// would be placed
+////////////////////////////////////////////////////////////////////////////////
+
+          template<typename F>
+          Element* findInBucket (Bucket const& b,
+                                 uint64_t hash,
+                                 F const& isEqual,
+                                 uint64_t& slot) const {
+            slot = findSlot(b._table, b._nrAlloc, hash, isEqual);
+            Element* found = b._table[slot].element;
+
+            if (found == nullptr && b._oldTable != nullptr) {
+              found = b._oldTable[findSlot(b._oldTable, b._oldAlloc, hash, isEqual)].element;
+            }
+
+            // ...........................................................................
+            // return whatever we found, this is nullptr if the thing was not found
+            // and otherwise a valid pointer
+            // ...........................................................................
+
+            return found;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an element from a bucket, returns nullptr if it was not
+/// found
+////////////////////////////////////////////////////////////////////////////////
+
+          template<typename F>
+          Element* removeFromBucket (Bucket& b,
+                                     uint64_t hash,
+                                     F const& isEqual) {
+            uint64_t i = findSlot(b._table, b._nrAlloc, hash, isEqual);
+            Element* old = b._table[i].element;
+
+            if (old != nullptr) {
+              healHole(b, i);
+            }
+            else if (b._oldTable != nullptr) {
+              // slots of the old table are never reused, so no need to heal
+              i = findSlot(b._oldTable, b._oldAlloc, hash, isEqual);
+              old = b._oldTable[i].element;
+
+              if (old != nullptr) {
+                b._oldTable[i].element = movedMarker();
+                b._nrUsed--;
+              }
+            }
+
+            migrate(b, migrationStep());
+
+            return old;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of slots a bucket has, including those of its old table
+////////////////////////////////////////////////////////////////////////////////
+
+          static uint64_t slotCount (Bucket const& b) {
+            return b._nrAlloc + b._oldAlloc;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the element in a slot as counted by slotCount, or nullptr
+////////////////////////////////////////////////////////////////////////////////
+
+          static Element* slotAt (Bucket const& b,
+                                  uint64_t i) {
+            if (i < b._nrAlloc) {
+              return b._table[i].element;
+            }
+            Element* element = b._oldTable[i - b._nrAlloc].element;
+            return element == movedMarker() ? nullptr : element;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates an empty table
+////////////////////////////////////////////////////////////////////////////////
+
+          Slot* allocateTable (uint64_t size) {
+            // large tables are mapped separately, so that they can use huge
+            // pages. This might throw, is catched outside
+            Slot* table = static_cast<Slot*>(TRI_AllocateLargeTable(size * sizeof(Slot)));
+
+            if (table == nullptr) {
+              throw std::bad_alloc();
+            }
+
+            TRI_BindLargeTable(table, size * sizeof(Slot), _numaNode);
+
+            TRI_AddMemoryZoneUsage(_memoryZone, (int64_t) (size * sizeof(Slot)), 1);
+
+#ifdef __linux__
+            if (size > 1000000) {
+              uintptr_t mem = reinterpret_cast<uintptr_t>(table);
+              uintptr_t pageSize = getpagesize();
+              mem = (mem / pageSize) * pageSize;
+              void* memptr = reinterpret_cast<void*>(mem);
+              TRI_MMFileAdvise(memptr, size * sizeof(Slot),
+                               TRI_MADVISE_RANDOM);
+            }
+#endif
+            for (uint64_t i = 0; i < size; i++) {
+              table[i].element = nullptr;
+              table[i].hash = 0;
+            }
+
+            return table;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a table
+////////////////////////////////////////////////////////////////////////////////
+
+          void freeTable (Slot* table,
+                          uint64_t size) {
+            if (table != nullptr) {
+              TRI_FreeLargeTable(table, size * sizeof(Slot));
+
+              TRI_AddMemoryZoneUsage(_memoryZone, - (int64_t) (size * sizeof(Slot)), -1);
+            }
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts to resize a bucket incrementally. the current table becomes
+/// the old table, from which the elements are moved by migrate()
+////////////////////////////////////////////////////////////////////////////////
+
+          void startIncrementalResize (Bucket& b,
+                                       uint64_t targetSize) {
+            TRI_ASSERT(b._oldTable == nullptr);
+
+            targetSize = TRI_NearPrime(targetSize);
+
+            Slot* table = allocateTable(targetSize);
+
+            LOG_TRACE("index-resize %s, incremental, target size: %llu", 
+                _contextCallback().c_str(),
+                (unsigned long long) targetSize);
+
+            b._oldTable = b._table;
+            b._oldAlloc = b._nrAlloc;
+            b._migrated = 0;
+            b._table = table;
+            b._nrAlloc = targetSize;
+            ++b._moves;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves up to steps slots of the old table into the current table
+////////////////////////////////////////////////////////////////////////////////
+
+          void migrate (Bucket& b,
+                        uint64_t steps) {
+            if (b._oldTable == nullptr) {
+              return;
+            }
+
+            uint64_t const n = b._nrAlloc;
+            uint64_t const end = (std::min)(b._migrated + steps, b._oldAlloc);
+
+            ++b._moves;
+
+            for (; b._migrated < end; ++b._migrated) {
+              Slot& slot = b._oldTable[b._migrated];
+
+              if (slot.element != nullptr && slot.element != movedMarker()) {
+                place(b._table, n, slot.element, slot.hash);
+                // keep the slot occupied, so that probe sequences of the
+                // remaining old elements stay intact
+                slot.element = movedMarker();
+              }
+            }
+
+            if (b._migrated == b._oldAlloc) {
+              freeTable(b._oldTable, b._oldAlloc);
+              b._oldTable = nullptr;
+              b._oldAlloc = 0;
+              b._migrated = 0;
+            }
+          }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief resizes the array
 ////////////////////////////////////////////////////////////////////////////////
@@ -217,6 +553,9 @@ namespace triagens {
               return;
             }
 
+            // finish an incremental resize first
+            migrate(b, b._oldAlloc);
+
             // only log performance infos for indexes with more than this number of entries
             static uint64_t const NotificationSizeThreshold = 131072; 
 
@@ -227,7 +566,7 @@ namespace triagens {
                   (unsigned long long) targetSize);
             }
 
-            Element** oldTable    = b._table;
+            Slot* oldTable    = b._table;
             uint64_t oldAlloc = b._nrAlloc;
 
             TRI_ASSERT(targetSize > 0);
@@ -235,46 +574,23 @@ namespace triagens {
             targetSize = TRI_NearPrime(targetSize);
 
             // This might throw, is catched outside
-            b._table = new Element* [targetSize];
+            b._table = allocateTable(targetSize);
             
             b._nrAlloc = targetSize;
-
-#ifdef __linux__
-            if (b._nrAlloc > 1000000) {
-              uintptr_t mem = reinterpret_cast<uintptr_t>(b._table);
-              uintptr_t pageSize = getpagesize();
-              mem = (mem / pageSize) * pageSize;
-              void* memptr = reinterpret_cast<void*>(mem);
-              TRI_MMFileAdvise(memptr, b._nrAlloc * sizeof(Element*),
-                               TRI_MADVISE_RANDOM);
-            }
-#endif
-            for (uint64_t i = 0; i < targetSize; i++) {
-              b._table[i] = nullptr;
-            }
+            ++b._moves;
 
             if (b._nrUsed > 0) {
               uint64_t const n = b._nrAlloc;
               TRI_ASSERT(n > 0);
 
               for (uint64_t j = 0; j < oldAlloc; j++) {
-                Element* element = oldTable[j];
-
-                if (element != nullptr) {
-                  uint64_t i, k;
-                  i = k = _hashElement(element) % n;
-
-                  for (; i < n && b._table[i] != nullptr; ++i);
-                  if (i == n) {
-                    for (i = 0; i < k && b._table[i] != nullptr; ++i);
-                  }
-
-                  b._table[i] = element;
+                if (oldTable[j].element != nullptr) {
+                  place(b._table, n, oldTable[j].element, oldTable[j].hash);
                 }
               }
             }
 
-            delete [] oldTable;
+            freeTable(oldTable, oldAlloc);
 
             LOG_TIMER((TRI_microtime() - start),
                 "index-resize %s, target size: %llu", 
@@ -284,12 +600,24 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check a resize of the hash array
+///
+/// growing a large bucket for a single insert does not rehash it at once,
+/// as this would stall the writer for a long time. instead, the elements
+/// are moved to the new table in small steps with each later modification
+/// of the bucket. bulk inserts still rehash at once
 ////////////////////////////////////////////////////////////////////////////////
 
           bool checkResize (Bucket& b, uint64_t expected) {
             if (2 * (b._nrAlloc + expected) < 3 * b._nrUsed) {
               try {
-                resizeInternal(b, 2 * (b._nrAlloc + expected) + 1, false);
+                if (expected == 0 &&
+                    b._oldTable == nullptr &&
+                    b._nrAlloc > incrementalResizeThreshold()) {
+                  startIncrementalResize(b, 2 * b._nrAlloc + 1);
+                }
+                else {
+                  resizeInternal(b, 2 * (b._nrAlloc + expected) + 1, false);
+                }
               }
               catch (...) {
                 return false;
@@ -309,10 +637,10 @@ namespace triagens {
             Element* found;
             Bucket b = _buckets[position.bucketId];
             do {
-              found = b._table[position.position];
+              found = slotAt(b, position.position);
               position.position += step;
-              while (position.position >= b._nrAlloc) {
-                position.position -= b._nrAlloc;
+              while (position.position >= slotCount(b)) {
+                position.position -= slotCount(b);
                 position.bucketId = (position.bucketId + 1) % _buckets.size();
                 b = _buckets[position.bucketId];
               }
@@ -334,24 +662,17 @@ namespace triagens {
                         Bucket& b,
                         uint64_t hash) {
 
-            uint64_t const n = b._nrAlloc;
-            uint64_t i = hash % n;
-            uint64_t k = i;
-
-            for (; i < n && b._table[i] != nullptr &&
-                 ! _isEqualElementElementByKey(element, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                   ! _isEqualElementElementByKey(element, b._table[i]); ++i);
-            }
-
-            Element* arrayElement = b._table[i];
+            uint64_t i;
+            Element* arrayElement = findInBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualElementElementByKey(element, other);
+            }, i);
 
             if (arrayElement != nullptr) {
               return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
             }
 
-            b._table[i] = element;
+            b._table[i].element = element;
+            b._table[i].hash = hash;
             b._nrUsed++;
 
             return TRI_ERROR_NO_ERROR;
@@ -376,6 +697,14 @@ namespace triagens {
             return true;
           }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the preferred NUMA node for tables allocated from now on
+////////////////////////////////////////////////////////////////////////////////
+
+          void setNumaNode (int node) {
+            _numaNode = node;
+          }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get the hash array's memory usage
 ////////////////////////////////////////////////////////////////////////////////
@@ -383,7 +712,7 @@ namespace triagens {
           size_t memoryUsage () const {
             size_t sum = 0;
             for (auto& b : _buckets) {
-              sum += static_cast<size_t>(b._nrAlloc * sizeof(Element*));
+              sum += static_cast<size_t>(slotCount(b) * sizeof(Slot));
             }
             return sum;
           }
@@ -443,26 +772,13 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
           Element* find (Element const* element) const {
-            uint64_t i = _hashElement(element);
-            Bucket const& b = _buckets[i & _bucketsMask];
-
-            uint64_t const n = b._nrAlloc;
-            i = i % n;
-            uint64_t k = i;
-
-            for (; i < n && b._table[i] != nullptr && 
-                ! _isEqualElementElementByKey(element, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                  ! _isEqualElementElementByKey(element, b._table[i]); ++i);
-            }
-
-            // ...........................................................................
-            // return whatever we found, this is nullptr if the thing was not found
-            // and otherwise a valid pointer
-            // ...........................................................................
+            uint64_t hash = _hashElement(element);
+            Bucket const& b = _buckets[hash & _bucketsMask];
 
-            return b._table[i];
+            uint64_t i;
+            return findInBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualElementElementByKey(element, other);
+            }, i);
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -471,27 +787,65 @@ namespace triagens {
 
           Element* findByKey (Key const* key) const {
             uint64_t hash = _hashKey(key);
-            uint64_t i = hash;
-            uint64_t bucketId = i & _bucketsMask;
-            Bucket const& b = _buckets[bucketId];
+            Bucket const& b = _buckets[hash & _bucketsMask];
 
-            uint64_t const n = b._nrAlloc;
-            i = i % n;
-            uint64_t k = i;
+            uint64_t i;
+            return findInBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualKeyElement(key, hash, other);
+            }, i);
+          }
 
-            for (; i < n && b._table[i] != nullptr && 
-                ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                  ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the elements for a batch of keys
+/// the hashes of all keys are computed up front, so the table slots can be
+/// prefetched a few probes ahead. the keys are probed in hash order, which
+/// makes equal keys adjacent, so each element is returned only once. the
+/// elements are appended to result in no particular order
+////////////////////////////////////////////////////////////////////////////////
+
+          void findByKeys (std::vector<Key const*> const& keys,
+                           std::vector<Element*>& result) const {
+            static size_t const PrefetchDistance = 8;
+
+            std::vector<std::pair<uint64_t, Key const*>> probes;
+            probes.reserve(keys.size());
+
+            for (auto const& key : keys) {
+              probes.emplace_back(_hashKey(key), key);
             }
-            
-            // ...........................................................................
-            // return whatever we found, this is nullptr if the thing was not found
-            // and otherwise a valid pointer
-            // ...........................................................................
 
-            return b._table[i];
+            std::sort(probes.begin(), probes.end());
+
+            size_t const numProbes = probes.size();
+            // number of results found for the current hash value
+            size_t firstForHash = result.size();
+
+            for (size_t j = 0; j < numProbes; ++j) {
+              if (j + PrefetchDistance < numProbes) {
+                uint64_t const ahead = probes[j + PrefetchDistance].first;
+                Bucket const& pb = _buckets[ahead & _bucketsMask];
+                PR(&pb._table[ahead % pb._nrAlloc]);
+              }
+
+              uint64_t const hash = probes[j].first;
+              Key const* key = probes[j].second;
+
+              if (j > 0 && probes[j - 1].first != hash) {
+                firstForHash = result.size();
+              }
+
+              Bucket const& b = _buckets[hash & _bucketsMask];
+
+              uint64_t i;
+              Element* found = findInBucket(b, hash, [&] (Element const* other) -> bool {
+                return _isEqualKeyElement(key, hash, other);
+              }, i);
+
+              if (found != nullptr &&
+                  std::find(result.begin() + firstForHash, result.end(), found) == result.end()) {
+                result.push_back(found);
+              }
+            }
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -504,32 +858,21 @@ namespace triagens {
                               BucketPosition& position,
                               uint64_t& hash) const {
             hash = _hashKey(key);
-            uint64_t i = hash;
-            uint64_t bucketId = i & _bucketsMask;
+            uint64_t bucketId = hash & _bucketsMask;
             Bucket const& b = _buckets[bucketId];
 
-            uint64_t const n = b._nrAlloc;
-            i = i % n;
-            uint64_t k = i;
-
-            for (; i < n && b._table[i] != nullptr && 
-                ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                  ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
-            }
+            uint64_t i;
+            Element* found = findInBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualKeyElement(key, hash, other);
+            }, i);
             
             // if requested, pass the position of the found element back
-            // to the caller
+            // to the caller. this is the slot in the current table, in which
+            // the element would be placed if it was not found
             position.bucketId = bucketId;
             position.position = i;
 
-            // ...........................................................................
-            // return whatever we found, this is nullptr if the thing was not found
-            // and otherwise a valid pointer
-            // ...........................................................................
-
-            return b._table[i];
+            return found;
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -544,7 +887,10 @@ namespace triagens {
               return TRI_ERROR_OUT_OF_MEMORY;
             }
 
-            return doInsert(element, b, hash);
+            int res = doInsert(element, b, hash);
+            migrate(b, migrationStep());
+
+            return res;
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -559,18 +905,21 @@ namespace triagens {
 
           int insertAtPosition (Element* element, BucketPosition const& position) {
             Bucket& b = _buckets[position.bucketId];
-            Element* arrayElement = b._table[position.position];
+            Slot& slot = b._table[position.position];
 
-            if (arrayElement != nullptr) {
+            if (slot.element != nullptr) {
               return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
             }
 
-            b._table[position.position] = element;
+            slot.element = element;
+            slot.hash = _hashElement(element);
             b._nrUsed++;
            
             if (! checkResize(b, 0)) {
               return TRI_ERROR_OUT_OF_MEMORY;
             }
+
+            migrate(b, migrationStep());
             
             return TRI_ERROR_NO_ERROR;
           }
@@ -740,7 +1089,7 @@ namespace triagens {
             // element structure
             // ...........................................................................
 
-            b._table[i] = nullptr;
+            b._table[i].element = nullptr;
             b._nrUsed--;
 
             uint64_t const n = b._nrAlloc;
@@ -752,13 +1101,14 @@ namespace triagens {
 
             uint64_t k = TRI_IncModU64(i, n);
 
-            while (b._table[k] != nullptr) {
-              uint64_t j = _hashElement(b._table[k]) % n;
+            while (b._table[k].element != nullptr) {
+              uint64_t j = b._table[k].hash % n;
 
               if ((i < k && ! (i < j && j <= k)) || (k < i && ! (i < j || j <= k))) {
                 b._table[i] = b._table[k];
-                b._table[k] = nullptr;
+                b._table[k].element = nullptr;
                 i = k;
+                ++b._moves;
               }
 
               k = TRI_IncModU64(k, n);
@@ -778,26 +1128,11 @@ namespace triagens {
 
           Element* removeByKey (Key const* key) {
             uint64_t hash = _hashKey(key);
-            uint64_t i = hash;
-            Bucket& b = _buckets[i & _bucketsMask];
-
-            uint64_t const n = b._nrAlloc;
-            i = i % n;
-            uint64_t k = i;
-
-            for (; i < n && b._table[i] != nullptr && 
-                ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                  ! _isEqualKeyElement(key, hash, b._table[i]); ++i);
-            }
-
-            Element* old = b._table[i];
+            Bucket& b = _buckets[hash & _bucketsMask];
 
-            if (old != nullptr) {
-              healHole(b, i);
-            }
-            return old;
+            return removeFromBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualKeyElement(key, hash, other);
+            });
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -806,27 +1141,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
           Element* remove (Element const* element) {
-            uint64_t i = _hashElement(element);
-            Bucket& b = _buckets[i & _bucketsMask];
-
-            uint64_t const n = b._nrAlloc;
-            i = i % n;
-            uint64_t k = i;
-
-            for (; i < n && b._table[i] != nullptr && 
-                ! _isEqualElementElement(element, b._table[i]); ++i);
-            if (i == n) {
-              for (i = 0; i < k && b._table[i] != nullptr && 
-                  ! _isEqualElementElement(element, b._table[i]); ++i);
-            }
-
-            Element* old = b._table[i];
-
-            if (old != nullptr) {
-              healHole(b, i);
-            }
+            uint64_t hash = _hashElement(element);
+            Bucket& b = _buckets[hash & _bucketsMask];
 
-            return old;
+            return removeFromBucket(b, hash, [&] (Element const* other) -> bool {
+              return _isEqualElementElement(element, other);
+            });
           }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -836,9 +1156,11 @@ namespace triagens {
           void invokeOnAllElements (CallbackElementFuncType callback) {
             for (auto& b : _buckets) {
               if (b._table != nullptr) {
-                for (size_t i = 0; i < b._nrAlloc; ++i) {
-                  if (b._table[i] != nullptr) {
-                    callback(b._table[i]);
+                uint64_t const n = slotCount(b);
+                for (uint64_t i = 0; i < n; ++i) {
+                  Element* element = slotAt(b, i);
+                  if (element != nullptr) {
+                    callback(element);
                   }
                 }
               }
@@ -882,13 +1204,13 @@ namespace triagens {
 
             while (true) {
               Bucket const& b = _buckets[position.bucketId];
-              uint64_t const n = b._nrAlloc;
+              uint64_t const n = slotCount(b);
 
-              for (; position.position < n && b._table[position.position] == nullptr; ++position.position);
+              for (; position.position < n && slotAt(b, position.position) == nullptr; ++position.position);
 
               if (position.position != n) {
                 // found an element
-                auto found = b._table[position.position];
+                auto found = slotAt(b, position.position);
                 TRI_ASSERT_EXPENSIVE(found != nullptr);
 
                 // move forward the position indicator one more time
@@ -910,6 +1232,108 @@ namespace triagens {
             }
           }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief calls the callback for the next at most limit elements of a scan
+/// over all elements, and returns the number of elements visited. the
+/// scan is complete when the cursor is done.
+///
+/// the caller may release its lock on the array between two calls. each
+/// element that is contained in the array during the whole scan is
+/// visited exactly once, elements inserted or removed meanwhile may or may
+/// not be visited. if the elements of the current bucket were moved since
+/// the last call, the bucket is scanned again from its start, skipping the
+/// elements already returned, and the rest of the bucket is visited in
+/// this call regardless of the limit.
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t scanChunk (ScanCursor& cursor,
+                            size_t limit,
+                            CallbackElementFuncType const& callback) const {
+            size_t visited = 0;
+
+            while (cursor.bucketId < _buckets.size() &&
+                   cursor.bucketId < cursor.endBucketId) {
+              Bucket const& b = _buckets[cursor.bucketId];
+              bool const rescan = (! cursor.returned.empty() && cursor.moves != b._moves);
+
+              if (rescan) {
+                cursor.position = 0;
+              }
+              cursor.moves = b._moves;
+
+              uint64_t const n = slotCount(b);
+
+              for (; cursor.position < n; ++cursor.position) {
+                Element* element = slotAt(b, cursor.position);
+
+                if (element == nullptr) {
+                  continue;
+                }
+
+                if (rescan && cursor.returned.find(element) != cursor.returned.end()) {
+                  continue;
+                }
+
+                if (visited >= limit && ! rescan) {
+                  return visited;
+                }
+
+                cursor.returned.emplace(element);
+                callback(element);
+                ++visited;
+              }
+
+              // bucket done
+              cursor.returned.clear();
+              cursor.position = 0;
+              ++cursor.bucketId;
+            }
+
+            return visited;
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a chunked scan is complete
+////////////////////////////////////////////////////////////////////////////////
+
+          bool isScanDone (ScanCursor const& cursor) const {
+            return (cursor.bucketId >= _buckets.size() ||
+                    cursor.bucketId >= cursor.endBucketId);
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a method to iterate over the elements of a single bucket in
+///        sequential order. position is the slot to continue at, and is 0
+///        for a new start. Returns nullptr if all elements of the bucket
+///        have been returned.
+///        Different buckets may be iterated by different threads
+///        concurrently as long as no thread modifies the index.
+////////////////////////////////////////////////////////////////////////////////
+
+          Element* findSequentialInBucket (size_t bucketId,
+                                           uint64_t& position) const {
+            TRI_ASSERT(bucketId < _buckets.size());
+
+            Bucket const& b = _buckets[bucketId];
+            uint64_t const n = slotCount(b);
+
+            for (; position < n && slotAt(b, position) == nullptr; ++position);
+
+            if (position >= n) {
+              return nullptr;
+            }
+
+            return slotAt(b, position++);
+          }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the number of buckets
+////////////////////////////////////////////////////////////////////////////////
+
+          size_t numberOfBuckets () const {
+            return _buckets.size();
+          }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief a method to iterate over all elements in the index in
 ///        reversed sequential order.
@@ -929,13 +1353,13 @@ namespace triagens {
               }
 
               position.bucketId = _buckets.size() - 1;
-              position.position = _buckets[position.bucketId]._nrAlloc - 1;
+              position.position = slotCount(_buckets[position.bucketId]) - 1;
             }
 
             Bucket b = _buckets[position.bucketId];
             Element* found;
             do {
-              found = b._table[position.position];
+              found = slotAt(b, position.position);
 
               if (position.position == 0) {
                 if (position.bucketId == 0) {
@@ -946,7 +1370,7 @@ namespace triagens {
 
                 --position.bucketId;
                 b = _buckets[position.bucketId];
-                position.position = b._nrAlloc - 1;
+                position.position = slotCount(b) - 1;
               }
               else {
                 --position.position;
@@ -977,7 +1401,7 @@ namespace triagens {
               uint64_t used = 0;
               total = 0;
               for (auto& b : _buckets) {
-                total += b._nrAlloc;
+                total += slotCount(b);
                 used += b._nrUsed;
               }
               if (used == 0) {
@@ -994,14 +1418,14 @@ namespace triagens {
                     initialPositionNr = TRI_UInt32Random() % total;
                   }
                   for (size_t i = 0; i < _buckets.size(); ++i) {
-                    if (initialPositionNr < _buckets[i]._nrAlloc) {
+                    if (initialPositionNr < slotCount(_buckets[i])) {
                       position.bucketId = i;
                       position.position = initialPositionNr;
                       initialPosition.bucketId = i;
                       initialPosition.position = initialPositionNr;
                       break;
                     }
-                    initialPositionNr -= _buckets[i]._nrAlloc;
+                    initialPositionNr -= slotCount(_buckets[i]);
                   }
                   break;
                 }
@@ -0,0 +1,960 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-memory B+tree with wide nodes
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_BTREE_H
+#define ARANGODB_BASICS_BTREE_H 1
+
+#include "Basics/Common.h"
+#include "Basics/JsonHelper.h"
+#include "Basics/SkipList.h"
+
+// maximal number of elements in a leaf and of children of an inner node
+#define TRI_BTREE_NODE_SIZE 64
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       class BTree
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief an in-memory B+tree of element pointers
+///
+/// The tree uses the same comparison functions as the SkipList, see there.
+/// All elements live in the leaves, which are doubly linked for range
+/// scans. Each leaf stores up to TRI_BTREE_NODE_SIZE element pointers
+/// together with a 64 bit prefix per element, so that most comparisons
+/// while searching a node only touch its two contiguous arrays and not the
+/// elements themselves. The prefix functions are optional. If given, they
+/// must be order preserving: prefix(a) < prefix(b) must imply that a is
+/// less than b in the preorder, and the same must hold for key prefixes
+/// compared to element prefixes. Equal prefixes mean that the elements
+/// have to be compared.
+///
+/// Separators in the inner nodes are the smallest elements of the subtree
+/// to their right. Removing elements never merges nodes, only empty nodes
+/// are freed. This keeps removal simple; a tree that shrinks a lot may
+/// therefore have underfull nodes.
+///
+/// Positions are only valid until the next modification of the tree. A
+/// reader that keeps a position across modifications has to check
+/// version() and seek again, e.g. with upperBoundElement() for the last element
+/// it has seen. The tree itself is not synchronized.
+////////////////////////////////////////////////////////////////////////////////
+
+    template <class Key, class Element>
+    class BTree {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+        typedef std::function<int(Element const*, Element const*, SkipListCmpType)> CmpElmElmFuncType;
+        typedef std::function<int(Key const*, Element const*)> CmpKeyElmFuncType;
+        typedef std::function<void(Element*)> FreeElementFuncType;
+        typedef std::function<uint64_t(Element const*)> ElementPrefixFuncType;
+        typedef std::function<uint64_t(Key const*)> KeyPrefixFuncType;
+
+      private:
+
+        struct Inner;
+
+        struct NodeBase {
+          Inner*   _parent;
+          uint32_t _count;
+          bool     _isLeaf;
+        };
+
+        struct Leaf : NodeBase {
+          uint64_t _prefixes[TRI_BTREE_NODE_SIZE];
+          Element* _elements[TRI_BTREE_NODE_SIZE];
+          Leaf*    _prev;
+          Leaf*    _next;
+        };
+
+        // an inner node with _count children has _count - 1 separators.
+        // separator i is the smallest element below child i + 1
+        struct Inner : NodeBase {
+          uint64_t  _prefixes[TRI_BTREE_NODE_SIZE - 1];
+          Element*  _separators[TRI_BTREE_NODE_SIZE - 1];
+          NodeBase* _children[TRI_BTREE_NODE_SIZE];
+        };
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a position in the tree. a position with a nullptr leaf is the
+/// end position
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Position {
+          Leaf*  _leaf;
+          size_t _index;
+
+          Position ()
+            : _leaf(nullptr),
+              _index(0) {
+          }
+
+          Position (Leaf* leaf, size_t index)
+            : _leaf(leaf),
+              _index(index) {
+          }
+
+          bool isEnd () const {
+            return _leaf == nullptr;
+          }
+
+          bool operator== (Position const& other) const {
+            return _leaf == other._leaf && _index == other._index;
+          }
+
+          bool operator!= (Position const& other) const {
+            return ! (*this == other);
+          }
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        BTree (CmpElmElmFuncType cmp_elm_elm,
+               CmpKeyElmFuncType cmp_key_elm,
+               FreeElementFuncType freefunc,
+               bool unique,
+               bool isArray,
+               ElementPrefixFuncType elementPrefix = nullptr,
+               KeyPrefixFuncType keyPrefix = nullptr)
+          : _cmp_elm_elm(cmp_elm_elm),
+            _cmp_key_elm(cmp_key_elm),
+            _free(freefunc),
+            _elementPrefix(elementPrefix),
+            _keyPrefix(keyPrefix),
+            _root(nullptr),
+            _first(nullptr),
+            _last(nullptr),
+            _unique(unique),
+            _isArray(isArray),
+            _nrUsed(0),
+            _version(0),
+            _memoryUsed(sizeof(BTree)) {
+
+          _first = _last = allocLeaf();
+          _root = _first;
+        }
+
+        ~BTree () {
+          freeSubtree(_root, true);
+
+          for (auto& it : _spare) {
+            freeInner(it);
+          }
+        }
+
+        BTree (BTree const&) = delete;
+        BTree& operator= (BTree const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of elements in the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t getNrUsed () const {
+          return _nrUsed;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the memory used by the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memoryUsage () const {
+          return _memoryUsed;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns if the tree is used for arrays
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isArray () const {
+          return _isArray;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a number that changes with every modification
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t version () const {
+          return _version;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends information about statistics in the given json
+////////////////////////////////////////////////////////////////////////////////
+
+        void appendToJson (TRI_memory_zone_t*, Json& json) const {
+          json("nrUsed", Json(static_cast<double>(_nrUsed)));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts an element
+///
+/// Returns TRI_ERROR_NO_ERROR, TRI_ERROR_OUT_OF_MEMORY, or
+/// TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED if the tree is unique and
+/// an element equal in the preorder exists, or if the element is already
+/// in the tree. In the error cases nothing is inserted.
+////////////////////////////////////////////////////////////////////////////////
+
+        int insert (Element* element) {
+          uint64_t const prefix = prefixOf(element);
+
+          // the element must go into the leaf the search leads to, even at
+          // its end, to keep it right of all separators on the path
+          Leaf* leaf;
+          size_t index;
+          searchLeaf([&] (uint64_t p, Element const* e) -> bool {
+            return compareElement(element, prefix, p, e, SKIPLIST_CMP_TOTORDER) > 0;
+          }, leaf, index);
+
+          Position pos = (index < leaf->_count ? Position(leaf, index) : Position(leaf->_next, 0));
+
+          if (! pos.isEnd() &&
+              0 == compare(element, prefix, pos._leaf, pos._index, SKIPLIST_CMP_TOTORDER)) {
+            return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+          }
+
+          if (_unique) {
+            if (! pos.isEnd() &&
+                0 == _cmp_elm_elm(element, at(pos), SKIPLIST_CMP_PREORDER)) {
+              return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+            }
+            Position before = pos;
+            if (prev(before) &&
+                0 == _cmp_elm_elm(element, at(before), SKIPLIST_CMP_PREORDER)) {
+              return TRI_ERROR_ARANGO_UNIQUE_CONSTRAINT_VIOLATED;
+            }
+          }
+
+          if (leaf->_count == TRI_BTREE_NODE_SIZE) {
+            try {
+              splitLeaf(leaf);
+            }
+            catch (...) {
+              return TRI_ERROR_OUT_OF_MEMORY;
+            }
+
+            if (index > leaf->_count) {
+              index -= leaf->_count;
+              leaf = leaf->_next;
+            }
+          }
+
+          insertIntoLeaf(leaf, index, element, prefix);
+
+          ++_nrUsed;
+          ++_version;
+
+          return TRI_ERROR_NO_ERROR;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an element, comparing in the proper total order
+///
+/// Returns TRI_ERROR_NO_ERROR or TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND. The
+/// element stored in the tree is freed with the free function.
+////////////////////////////////////////////////////////////////////////////////
+
+        int remove (Element* element) {
+          uint64_t const prefix = prefixOf(element);
+          Position pos = lowerBoundElement(element, prefix);
+
+          if (pos.isEnd() ||
+              0 != compare(element, prefix, pos._leaf, pos._index, SKIPLIST_CMP_TOTORDER)) {
+            return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
+          }
+
+          Leaf* leaf = pos._leaf;
+          size_t const index = pos._index;
+          Element* stored = leaf->_elements[index];
+
+          memmove(&leaf->_prefixes[index], &leaf->_prefixes[index + 1], (leaf->_count - index - 1) * sizeof(uint64_t));
+          memmove(&leaf->_elements[index], &leaf->_elements[index + 1], (leaf->_count - index - 1) * sizeof(Element*));
+          --leaf->_count;
+
+          if (leaf->_count == 0 && leaf != _root) {
+            removeNode(leaf);
+          }
+
+          if (index == 0) {
+            // the element may be used as a separator, which must be
+            // replaced before the element is freed
+            replaceSeparator(stored, prefix);
+          }
+
+          if (nullptr != _free) {
+            _free(stored);
+          }
+
+          --_nrUsed;
+          ++_version;
+
+          return TRI_ERROR_NO_ERROR;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up an element using the proper total order, returns nullptr
+/// if it is not in the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        Element* lookup (Element const* element) const {
+          uint64_t const prefix = prefixOf(element);
+          Position pos = lowerBoundElement(element, prefix);
+
+          if (pos.isEnd() ||
+              0 != compare(element, prefix, pos._leaf, pos._index, SKIPLIST_CMP_TOTORDER)) {
+            return nullptr;
+          }
+          return at(pos);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the first element
+////////////////////////////////////////////////////////////////////////////////
+
+        Position begin () const {
+          if (_first->_count == 0) {
+            return end();
+          }
+          return Position(_first, 0);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the end position, after the last element
+////////////////////////////////////////////////////////////////////////////////
+
+        Position end () const {
+          return Position();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the last element, or the end position
+/// if the tree is empty
+////////////////////////////////////////////////////////////////////////////////
+
+        Position last () const {
+          if (_last->_count == 0) {
+            return end();
+          }
+          return Position(_last, _last->_count - 1);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the element at a position, which must not be the end
+////////////////////////////////////////////////////////////////////////////////
+
+        Element* at (Position const& pos) const {
+          TRI_ASSERT(! pos.isEnd());
+          TRI_ASSERT(pos._index < pos._leaf->_count);
+          return pos._leaf->_elements[pos._index];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances a position, returns false when it reaches the end
+////////////////////////////////////////////////////////////////////////////////
+
+        bool next (Position& pos) const {
+          if (pos.isEnd()) {
+            return false;
+          }
+          if (++pos._index < pos._leaf->_count) {
+            return true;
+          }
+          pos = Position(pos._leaf->_next, 0);
+          return ! pos.isEnd();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves a position back, returns false if there is no previous
+/// element, in which case the position is left unchanged. the end
+/// position moves to the last element
+////////////////////////////////////////////////////////////////////////////////
+
+        bool prev (Position& pos) const {
+          if (pos.isEnd()) {
+            Position l = last();
+            if (l.isEnd()) {
+              return false;
+            }
+            pos = l;
+            return true;
+          }
+          if (pos._index > 0) {
+            --pos._index;
+            return true;
+          }
+          if (pos._leaf->_prev == nullptr) {
+            return false;
+          }
+          pos = Position(pos._leaf->_prev, pos._leaf->_prev->_count - 1);
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the first element that is not less than
+/// key in the preorder, or the end position
+////////////////////////////////////////////////////////////////////////////////
+
+        Position lowerBound (Key const* key) const {
+          uint64_t const prefix = keyPrefixOf(key);
+
+          return search([&] (uint64_t p, Element const* e) -> bool {
+            // is the element less than the key?
+            return compareKey(key, prefix, p, e) > 0;
+          });
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the first element that is greater than
+/// key in the preorder, or the end position
+////////////////////////////////////////////////////////////////////////////////
+
+        Position upperBound (Key const* key) const {
+          uint64_t const prefix = keyPrefixOf(key);
+
+          return search([&] (uint64_t p, Element const* e) -> bool {
+            // is the element less than or equal to the key?
+            return compareKey(key, prefix, p, e) >= 0;
+          });
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the first element that is greater than
+/// element in the proper total order, or the end position. this is used to
+/// continue a scan after the tree was modified
+////////////////////////////////////////////////////////////////////////////////
+
+        Position upperBoundElement (Element const* element) const {
+          uint64_t const prefix = prefixOf(element);
+
+          return search([&] (uint64_t p, Element const* e) -> bool {
+            return compareElement(element, prefix, p, e, SKIPLIST_CMP_TOTORDER) >= 0;
+          });
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefix of an element, 0 if no prefix function is set
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t prefixOf (Element const* element) const {
+          return nullptr == _elementPrefix ? 0 : _elementPrefix(element);
+        }
+
+        uint64_t keyPrefixOf (Key const* key) const {
+          return nullptr == _keyPrefix ? 0 : _keyPrefix(key);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares element (with its prefix) to another element, looking at
+/// the prefixes first
+////////////////////////////////////////////////////////////////////////////////
+
+        int compareElement (Element const* element,
+                            uint64_t prefix,
+                            uint64_t otherPrefix,
+                            Element const* other,
+                            SkipListCmpType cmptype) const {
+          if (prefix != otherPrefix) {
+            return prefix < otherPrefix ? -1 : 1;
+          }
+          return _cmp_elm_elm(element, other, cmptype);
+        }
+
+        int compare (Element const* element,
+                     uint64_t prefix,
+                     Leaf const* leaf,
+                     size_t index,
+                     SkipListCmpType cmptype) const {
+          return compareElement(element, prefix, leaf->_prefixes[index], leaf->_elements[index], cmptype);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares a key (with its prefix) to an element in the preorder
+////////////////////////////////////////////////////////////////////////////////
+
+        int compareKey (Key const* key,
+                        uint64_t prefix,
+                        uint64_t otherPrefix,
+                        Element const* other) const {
+          if (prefix != otherPrefix) {
+            return prefix < otherPrefix ? -1 : 1;
+          }
+          return _cmp_key_elm(key, other);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the first element for which isLess returns false. isLess
+/// must be true for a prefix of the elements in order and false for the rest
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        Position search (F const& isLess) const {
+          Leaf* leaf;
+          size_t index;
+          searchLeaf(isLess, leaf, index);
+
+          if (index < leaf->_count) {
+            return Position(leaf, index);
+          }
+          // the first matching element is the first one of the next leaf
+          return Position(leaf->_next, 0);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the leaf and the index in it for search(). the index is
+/// the leaf's count if all elements of the leaf are less
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        void searchLeaf (F const& isLess,
+                         Leaf*& leaf,
+                         size_t& index) const {
+          NodeBase* node = _root;
+
+          while (! node->_isLeaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            // descend into the child after the last separator that is less
+            size_t lo = 0;
+            size_t hi = inner->_count - 1;
+            while (lo < hi) {
+              size_t mid = (lo + hi) / 2;
+              if (isLess(inner->_prefixes[mid], inner->_separators[mid])) {
+                lo = mid + 1;
+              }
+              else {
+                hi = mid;
+              }
+            }
+            node = inner->_children[lo];
+          }
+
+          leaf = static_cast<Leaf*>(node);
+          size_t lo = 0;
+          size_t hi = leaf->_count;
+          while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (isLess(leaf->_prefixes[mid], leaf->_elements[mid])) {
+              lo = mid + 1;
+            }
+            else {
+              hi = mid;
+            }
+          }
+          index = lo;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the position of the first element not less than element in the
+/// proper total order
+////////////////////////////////////////////////////////////////////////////////
+
+        Position lowerBoundElement (Element const* element,
+                                    uint64_t prefix) const {
+          return search([&] (uint64_t p, Element const* e) -> bool {
+            return compareElement(element, prefix, p, e, SKIPLIST_CMP_TOTORDER) > 0;
+          });
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts into a leaf that has room
+////////////////////////////////////////////////////////////////////////////////
+
+        void insertIntoLeaf (Leaf* leaf,
+                             size_t index,
+                             Element* element,
+                             uint64_t prefix) {
+          TRI_ASSERT(leaf->_count < TRI_BTREE_NODE_SIZE);
+          TRI_ASSERT(index <= leaf->_count);
+
+          memmove(&leaf->_prefixes[index + 1], &leaf->_prefixes[index], (leaf->_count - index) * sizeof(uint64_t));
+          memmove(&leaf->_elements[index + 1], &leaf->_elements[index], (leaf->_count - index) * sizeof(Element*));
+          leaf->_prefixes[index] = prefix;
+          leaf->_elements[index] = element;
+          ++leaf->_count;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief splits a full leaf into two, the new leaf follows the old one.
+/// this can throw, in which case nothing is changed
+////////////////////////////////////////////////////////////////////////////////
+
+        void splitLeaf (Leaf* leaf) {
+          // make sure all allocations succeed before modifying anything
+          reserveParents(leaf);
+
+          Leaf* right = allocLeaf();
+          size_t const half = leaf->_count / 2;
+
+          right->_count = static_cast<uint32_t>(leaf->_count - half);
+          memcpy(&right->_prefixes[0], &leaf->_prefixes[half], right->_count * sizeof(uint64_t));
+          memcpy(&right->_elements[0], &leaf->_elements[half], right->_count * sizeof(Element*));
+          leaf->_count = static_cast<uint32_t>(half);
+
+          right->_prev = leaf;
+          right->_next = leaf->_next;
+          if (leaf->_next != nullptr) {
+            leaf->_next->_prev = right;
+          }
+          else {
+            _last = right;
+          }
+          leaf->_next = right;
+
+          insertIntoParent(leaf, right, right->_prefixes[0], right->_elements[0]);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates all nodes needed to split node and its full ancestors
+/// up front, so that splitting cannot fail halfway
+////////////////////////////////////////////////////////////////////////////////
+
+        void reserveParents (NodeBase* node) {
+          size_t needed = 0;
+          Inner* parent = node->_parent;
+
+          while (parent != nullptr && parent->_count == TRI_BTREE_NODE_SIZE) {
+            ++needed;
+            parent = parent->_parent;
+          }
+          if (parent == nullptr) {
+            // a new root
+            ++needed;
+          }
+
+          while (_spare.size() < needed) {
+            _spare.reserve(needed);
+            _spare.emplace_back(allocInner());
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief links a new right sibling of node into the parent
+////////////////////////////////////////////////////////////////////////////////
+
+        void insertIntoParent (NodeBase* left,
+                               NodeBase* right,
+                               uint64_t prefix,
+                               Element* separator) {
+          Inner* parent = left->_parent;
+
+          if (parent == nullptr) {
+            // split the root
+            TRI_ASSERT(left == _root);
+            Inner* root = takeSpare();
+            root->_count = 2;
+            root->_children[0] = left;
+            root->_children[1] = right;
+            root->_prefixes[0] = prefix;
+            root->_separators[0] = separator;
+            left->_parent = root;
+            right->_parent = root;
+            _root = root;
+            return;
+          }
+
+          if (parent->_count == TRI_BTREE_NODE_SIZE) {
+            splitInner(parent);
+            if (left->_parent != parent) {
+              parent = left->_parent;
+            }
+          }
+
+          size_t index = childIndex(parent, left);
+          // the new child goes to index + 1, its separator to index
+          memmove(&parent->_children[index + 2], &parent->_children[index + 1], (parent->_count - index - 1) * sizeof(NodeBase*));
+          memmove(&parent->_prefixes[index + 1], &parent->_prefixes[index], (parent->_count - index - 1) * sizeof(uint64_t));
+          memmove(&parent->_separators[index + 1], &parent->_separators[index], (parent->_count - index - 1) * sizeof(Element*));
+          parent->_children[index + 1] = right;
+          parent->_prefixes[index] = prefix;
+          parent->_separators[index] = separator;
+          ++parent->_count;
+          right->_parent = parent;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief splits a full inner node, using a reserved spare node
+////////////////////////////////////////////////////////////////////////////////
+
+        void splitInner (Inner* node) {
+          Inner* right = takeSpare();
+          size_t const half = node->_count / 2;
+
+          // children half .. count - 1 move to the right node, separator
+          // half - 1 moves up
+          right->_count = static_cast<uint32_t>(node->_count - half);
+          memcpy(&right->_children[0], &node->_children[half], right->_count * sizeof(NodeBase*));
+          memcpy(&right->_prefixes[0], &node->_prefixes[half], (right->_count - 1) * sizeof(uint64_t));
+          memcpy(&right->_separators[0], &node->_separators[half], (right->_count - 1) * sizeof(Element*));
+
+          for (size_t i = 0; i < right->_count; ++i) {
+            right->_children[i]->_parent = right;
+          }
+
+          uint64_t const prefix = node->_prefixes[half - 1];
+          Element* separator = node->_separators[half - 1];
+          node->_count = static_cast<uint32_t>(half);
+
+          insertIntoParent(node, right, prefix, separator);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an empty node from its parent, and the parent if it
+/// becomes empty, and collapses the root
+////////////////////////////////////////////////////////////////////////////////
+
+        void removeNode (NodeBase* node) {
+          TRI_ASSERT(node->_count == 0);
+
+          while (true) {
+            Inner* parent = node->_parent;
+            TRI_ASSERT(parent != nullptr);
+
+            size_t const index = childIndex(parent, node);
+
+            memmove(&parent->_children[index], &parent->_children[index + 1], (parent->_count - index - 1) * sizeof(NodeBase*));
+            if (parent->_count > 1) {
+              // the removed child's separator, or for the leftmost child
+              // the separator of the child that takes its place
+              size_t const s = (index == 0 ? 0 : index - 1);
+              memmove(&parent->_prefixes[s], &parent->_prefixes[s + 1], (parent->_count - s - 2) * sizeof(uint64_t));
+              memmove(&parent->_separators[s], &parent->_separators[s + 1], (parent->_count - s - 2) * sizeof(Element*));
+            }
+            --parent->_count;
+
+            if (node->_isLeaf) {
+              Leaf* leaf = static_cast<Leaf*>(node);
+              if (leaf->_prev != nullptr) {
+                leaf->_prev->_next = leaf->_next;
+              }
+              else {
+                _first = leaf->_next;
+              }
+              if (leaf->_next != nullptr) {
+                leaf->_next->_prev = leaf->_prev;
+              }
+              else {
+                _last = leaf->_prev;
+              }
+              freeLeaf(leaf);
+            }
+            else {
+              freeInner(static_cast<Inner*>(node));
+            }
+
+            if (parent->_count > 0) {
+              break;
+            }
+            // the parent is empty now, too. it cannot be the root, because
+            // the root always has a non-empty subtree
+            node = parent;
+          }
+
+          // collapse the root while it has only a single child
+          while (! _root->_isLeaf && _root->_count == 1) {
+            Inner* root = static_cast<Inner*>(_root);
+            _root = root->_children[0];
+            _root->_parent = nullptr;
+            freeInner(root);
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief replaces a separator that points to a removed element by the
+/// smallest element of the subtree to its right
+////////////////////////////////////////////////////////////////////////////////
+
+        void replaceSeparator (Element const* element,
+                               uint64_t prefix) {
+          NodeBase* node = _root;
+
+          while (! node->_isLeaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            size_t i = 0;
+            while (i < inner->_count - 1 &&
+                   compareElement(element, prefix, inner->_prefixes[i], inner->_separators[i], SKIPLIST_CMP_TOTORDER) >= 0) {
+              if (inner->_separators[i] == element) {
+                // the smallest element right of the separator
+                NodeBase* sub = inner->_children[i + 1];
+                while (! sub->_isLeaf) {
+                  sub = static_cast<Inner*>(sub)->_children[0];
+                }
+                Leaf* leaf = static_cast<Leaf*>(sub);
+                TRI_ASSERT(leaf->_count > 0);
+                inner->_prefixes[i] = leaf->_prefixes[0];
+                inner->_separators[i] = leaf->_elements[0];
+                return;
+              }
+              ++i;
+            }
+            node = inner->_children[i];
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief position of a child in its parent
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t childIndex (Inner const* parent,
+                           NodeBase const* child) const {
+          for (size_t i = 0; i < parent->_count; ++i) {
+            if (parent->_children[i] == child) {
+              return i;
+            }
+          }
+          TRI_ASSERT(false);
+          return 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief node allocation
+////////////////////////////////////////////////////////////////////////////////
+
+        Leaf* allocLeaf () {
+          Leaf* leaf = new Leaf();
+          leaf->_parent = nullptr;
+          leaf->_count = 0;
+          leaf->_isLeaf = true;
+          leaf->_prev = nullptr;
+          leaf->_next = nullptr;
+          _memoryUsed += sizeof(Leaf);
+          return leaf;
+        }
+
+        Inner* allocInner () {
+          Inner* inner = new Inner();
+          inner->_parent = nullptr;
+          inner->_count = 0;
+          inner->_isLeaf = false;
+          _memoryUsed += sizeof(Inner);
+          return inner;
+        }
+
+        Inner* takeSpare () {
+          TRI_ASSERT(! _spare.empty());
+          Inner* inner = _spare.back();
+          _spare.pop_back();
+          return inner;
+        }
+
+        void freeLeaf (Leaf* leaf) {
+          _memoryUsed -= sizeof(Leaf);
+          delete leaf;
+        }
+
+        void freeInner (Inner* inner) {
+          _memoryUsed -= sizeof(Inner);
+          delete inner;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a subtree, optionally with all its elements
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeSubtree (NodeBase* node,
+                          bool freeElements) {
+          if (node->_isLeaf) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            if (freeElements && nullptr != _free) {
+              for (size_t i = 0; i < leaf->_count; ++i) {
+                _free(leaf->_elements[i]);
+              }
+            }
+            freeLeaf(leaf);
+            return;
+          }
+
+          Inner* inner = static_cast<Inner*>(node);
+          for (size_t i = 0; i < inner->_count; ++i) {
+            freeSubtree(inner->_children[i], freeElements);
+          }
+          freeInner(inner);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        CmpElmElmFuncType     _cmp_elm_elm;
+        CmpKeyElmFuncType     _cmp_key_elm;
+        FreeElementFuncType   _free;
+        ElementPrefixFuncType _elementPrefix;
+        KeyPrefixFuncType     _keyPrefix;
+
+        NodeBase* _root;
+        Leaf*     _first;
+        Leaf*     _last;
+
+        // inner nodes allocated ahead of a split
+        std::vector<Inner*> _spare;
+
+        bool      _unique;
+        bool      _isArray;
+        uint64_t  _nrUsed;
+        uint64_t  _version;
+        size_t    _memoryUsed;
+    };
+
+  }   // namespace triagens::basics
+}   // namespace triagens
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
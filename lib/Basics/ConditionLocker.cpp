@@ -47,14 +47,26 @@ using namespace triagens::basics;
 /// the condition variable
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 ConditionLocker::ConditionLocker (ConditionVariable* conditionVariable, char const* file, int line)
-  : _conditionVariable(conditionVariable), _file(file), _line(line), _time(0.0) {
+  : _conditionVariable(conditionVariable), _file(file), _line(line) {
 
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::CONDITION);
+#endif
+
   _conditionVariable->lock();
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else
@@ -74,6 +86,10 @@ ConditionLocker::ConditionLocker (ConditionVariable* conditionVariable)
 ConditionLocker::~ConditionLocker () {
   _conditionVariable->unlock();
 
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.released();
+#endif
+
 #ifdef TRI_SHOW_LOCK_TIME
   if (_time > TRI_SHOW_LOCK_THRESHOLD) {
     LOG_WARNING("ConditionLocker %s:%d took %f s", _file, _line, _time);
@@ -90,7 +106,15 @@ ConditionLocker::~ConditionLocker () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ConditionLocker::wait () {
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.waiting();
+#endif
+
   _conditionVariable->wait();
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.waited();
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -98,7 +122,15 @@ void ConditionLocker::wait () {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool ConditionLocker::wait (uint64_t delay) {
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.waiting();
+  bool signaled = _conditionVariable->wait(delay);
+  _timer.waited();
+
+  return signaled;
+#else
   return _conditionVariable->wait(delay);
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -123,6 +155,10 @@ void ConditionLocker::signal () {
 
 void ConditionLocker::unlock () {
   _conditionVariable->unlock();
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.released();
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -130,7 +166,15 @@ void ConditionLocker::unlock () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void ConditionLocker::lock () {
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.reacquire();
+#endif
+
   _conditionVariable->lock();
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 // -----------------------------------------------------------------------------
@@ -33,6 +33,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/ConditionVariable.h"
+#include "Basics/LockProfiler.h"
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                     public macros
@@ -42,7 +43,7 @@
 /// @brief construct locker with file and line information
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 #define CONDITION_LOCKER(a, b) \
   triagens::basics::ConditionLocker a(&b, __FILE__, __LINE__)
@@ -86,7 +87,7 @@ namespace triagens {
 /// the condition variable
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
         ConditionLocker (ConditionVariable* conditionVariable, char const* file, int line);
 
@@ -157,7 +158,7 @@ namespace triagens {
 
         ConditionVariable* _conditionVariable;
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief file
@@ -171,12 +172,26 @@ namespace triagens {
 
         int _line;
 
+#endif
+
+#ifdef TRI_SHOW_LOCK_TIME
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief lock time
 ////////////////////////////////////////////////////////////////////////////////
 
         double _time;
 
+#endif
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times
+////////////////////////////////////////////////////////////////////////////////
+
+        LockTimer _timer;
+
 #endif        
     };
   }
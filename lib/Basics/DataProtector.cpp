@@ -28,23 +28,224 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "Basics/DataProtector.h"
+#include "Basics/MutexLocker.h"
 
-// TODO: Make this a template again once everybody has gcc >= 4.9.2
-// template<int Nr> 
-// thread_local int triagens::basics::DataProtector<Nr>::_mySlot = -1;
-thread_local int triagens::basics::DataProtector::_mySlot = -1;
+using namespace triagens::basics;
 
-// TODO: Make this a template again once everybody has gcc >= 4.9.2
-// template<int Nr> 
-// std::atomic<int> triagens::basics::DataProtector<Nr>::_last(0);
-std::atomic<int> triagens::basics::DataProtector::_last(0);
+// -----------------------------------------------------------------------------
+// --SECTION--                                               class DataProtector
+// -----------------------------------------------------------------------------
 
-/// We need an explicit template initialization for each value of the
-/// template parameter, such that the compiler can allocate a thread local
-/// variable for each of them.
+std::atomic<uint64_t> DataProtector::_nextSerial(1);
 
-// TODO: Reactivate this template instantiation once everybody has gcc >= 4.9.2
-// template class triagens::basics::DataProtector<64>;
+thread_local DataProtector::CacheEntry DataProtector::_cache[DataProtector::CacheSize];
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+DataProtector::DataProtector () 
+  : _serial(_nextSerial.fetch_add(1, std::memory_order_relaxed)),
+    _epoch(1),
+    _slots(nullptr),
+    _retiredLock(),
+    _retired() {
+}
+
+DataProtector::~DataProtector () {
+  // no reader may be active anymore
+  for (auto& it : _retired) {
+    it._deleter(it._data);
+  }
+
+  Slot* slot = _slots.load(std::memory_order_acquire);
+
+  while (slot != nullptr) {
+    Slot* next = slot->_next;
+    delete slot;
+    slot = next;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until no reader that started before the call is active
+////////////////////////////////////////////////////////////////////////////////
+
+void DataProtector::scan () {
+  uint64_t const epoch = nextEpoch();
+
+  for (Slot* slot = _slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->_next) {
+    while (true) {
+      uint64_t const state = slot->_state.load(std::memory_order_acquire);
+
+      if ((state & CountMask) == 0 || (state >> CountBits) >= epoch) {
+        break;
+      }
+
+      // let other threads do some work while we're waiting
+      usleep(250);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns whether no reader that started before the call is active
+////////////////////////////////////////////////////////////////////////////////
+
+bool DataProtector::isUnused () {
+  uint64_t const epoch = nextEpoch();
+
+  return oldestEpoch() >= epoch;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the data once no reader that started before the call is
+/// active
+////////////////////////////////////////////////////////////////////////////////
+
+void DataProtector::retire (void* data,
+                            void (*deleter) (void*)) {
+  uint64_t const epoch = nextEpoch();
+  bool full;
+
+  {
+    MUTEX_LOCKER(_retiredLock);
+
+    try {
+      _retired.emplace_back(Retired{ data, deleter, epoch });
+    }
+    catch (...) {
+      // cannot remember the data, so wait for the readers instead
+      scan();
+      deleter(data);
+      return;
+    }
+
+    full = (_retired.size() >= RetireBatchSize);
+  }
+
+  if (full) {
+    reclaim();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the retired data that no reader can see anymore
+////////////////////////////////////////////////////////////////////////////////
+
+size_t DataProtector::reclaim () {
+  std::vector<Retired> garbage;
+
+  {
+    MUTEX_LOCKER(_retiredLock);
+
+    if (_retired.empty()) {
+      return 0;
+    }
+
+    uint64_t const oldest = oldestEpoch();
+    size_t kept = 0;
+
+    for (auto& it : _retired) {
+      if (it._epoch <= oldest) {
+        try {
+          garbage.emplace_back(it);
+        }
+        catch (...) {
+          // keep it for the next time
+          _retired[kept++] = it;
+        }
+      }
+      else {
+        _retired[kept++] = it;
+      }
+    }
+
+    _retired.resize(kept);
+  }
+
+  // free outside the lock, the deleters may be slow
+  for (auto& it : garbage) {
+    it._deleter(it._data);
+  }
+
+  return garbage.size();
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds or creates the slot of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+DataProtector::Slot* DataProtector::acquireSlot () {
+  auto const self = std::this_thread::get_id();
+  Slot* head = _slots.load(std::memory_order_acquire);
+  Slot* slot = head;
+
+  while (slot != nullptr && slot->_owner != self) {
+    slot = slot->_next;
+  }
+
+  if (slot == nullptr) {
+    // a thread that has finished leaves its slot to threads with the
+    // same id later
+    slot = new Slot(self);
+    slot->_next = head;
+
+    while (! _slots.compare_exchange_weak(slot->_next, slot, std::memory_order_release, std::memory_order_acquire)) {
+    }
+  }
+
+  CacheEntry& entry = _cache[_serial % CacheSize];
+  entry._serial = _serial;
+  entry._slot = slot;
+
+  return slot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief starts a new epoch
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t DataProtector::nextEpoch () {
+  // data unlinked before must be invisible to readers that see the new
+  // epoch, and the slots must be read after the data was unlinked
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  return _epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the oldest epoch held by a reader
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t DataProtector::oldestEpoch () const {
+  // the caller may not be the thread that unlinked the data
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  uint64_t oldest = UINT64_MAX;
+
+  for (Slot* slot = _slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->_next) {
+    uint64_t const state = slot->_state.load(std::memory_order_acquire);
+
+    if ((state & CountMask) != 0 && (state >> CountBits) < oldest) {
+      oldest = state >> CountBits;
+    }
+  }
+
+  return oldest;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
 
 // Local Variables:
 // mode: outline-minor
@@ -31,21 +31,21 @@
 #define ARANGODB_BASICS_DATA_PROTECTOR_H 1
 
 #include "Basics/Common.h"
+#include "Basics/Mutex.h"
+
+#include <thread>
 
 namespace triagens {
   namespace basics {
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief DataProtector, a template class to manage a single atomic
-/// value (can be a pointer to some class), optimized for many fast
-/// readers and slow writers using lockfree technology.
-/// The template parameter Nr should be on the order of magnitude of the
-/// maximal number of concurrently running threads.
+/// @brief DataProtector, a class to protect data that is read by many fast
+/// readers and changed by slow writers, using epoch-based reclamation.
 /// Usage:
 ///   Put an instance of the DataProtector next to the atomic value you
 ///   want to protect, as in:
 ///     atomic<SomeClass*> p;
-///     DataProtector<64> prot;
+///     DataProtector prot;
 ///   If you want to read p and *p, do
 ///     auto unuser(prot.use());
 ///     auto pSeen = p;
@@ -53,68 +53,118 @@ namespace triagens {
 ///   and *pSeen.
 ///   It is automatically released when the unuser instances goes out of scope.
 ///   This is guaranteed to be very fast, even when multiple threads do it
-///   concurrently.
+///   concurrently. Calls to use() may be nested.
 ///   If you want to change p (and call delete on the old value, say), then
 ///     auto oldp = p;       // save the old value of p
 ///     p = <new Value>;     // just assign p whenever you see fit
 ///     prot.scan();         // This will block until no thread is reading
 ///                          // the old value any more.
 ///     delete oldp;         // guaranteed to be safe
-///   This can be a slow operation and only one thread should perform it 
+///   or, without waiting:
+///     prot.retire(oldp);   // oldp is deleted once no thread reads it
+///   scan() can be a slow operation and only one thread should perform it 
 ///   at a time. Use a mutex to ensure this.
 ///   Please note:
 ///     - The value of p *can* change under the feet of the reading threads,
 ///       which is why you need to use the pSeen variable. However, you know
 ///       that as long as unused is in scope, pSeen remains valid.
-///     - The DataProtector instances needs 64*Nr bytes of memory.
-///     - DataProtector.cpp needs to contain an explicit template 
-///       instantiation for all values of Nr used in the executable.
+///     - A thread must not call scan() while it uses the same DataProtector,
+///       as it would wait for itself.
+///     - An unuser may be moved to and released by another thread.
+///
+/// Each thread that reads gets its own slot in the DataProtector, in its own
+/// cache line. A reader stores the current epoch in its slot, and clears it
+/// when it is done. A writer increments the epoch after unlinking data, and
+/// the data is safe to free once every slot is either clear or holds a newer
+/// epoch. Readers therefore only write to their own cache line, and only
+/// read the epoch, which changes rarely.
 ////////////////////////////////////////////////////////////////////////////////
 
-#define DATA_PROTECTOR_MULTIPLICITY 64
-
-    // TODO: Make this a template again once everybody has gcc >= 4.9.2
-    // template<int Nr>
     class DataProtector {
-        struct TRI_ALIGNAS(64) Entry {  // 64 is the size of a cache line,
-             // it is important that different list entries lie in different
-             // cache lines.
-          std::atomic<int> _count;
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the slot of a thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const CacheLineSize = 64;
+
+        struct Slot {
+          explicit Slot (std::thread::id owner) 
+            : _owner(owner),
+              _next(nullptr),
+              _state(0) {
+          }
+
+          // slots are allocated separately, and plain new does not honor an
+          // extended alignment. the padding on both sides keeps the states of
+          // different slots in different cache lines
+          char _padding[CacheLineSize];
+          std::thread::id const _owner;
+          Slot* _next;
+          // the epoch in which the oldest active use started in the upper
+          // bits, and the number of active uses in the lower CountBits bits.
+          // 0 if the slot is not used
+          std::atomic<uint64_t> _state;
+          char _padding2[CacheLineSize - sizeof(std::atomic<uint64_t>)];
+        };
+
+        static int const CountBits = 16;
+
+        static uint64_t const CountMask = (static_cast<uint64_t>(1) << CountBits) - 1;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief data waiting to be freed
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Retired {
+          void* _data;
+          void (*_deleter) (void*);
+          uint64_t _epoch;
         };
 
-        Entry* _list;
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a per-thread cache of the slots of the recently used protectors
+////////////////////////////////////////////////////////////////////////////////
 
-        static std::atomic<int> _last;
+        struct CacheEntry {
+          uint64_t _serial;
+          Slot* _slot;
+        };
 
-        static thread_local int _mySlot;
+        static size_t const CacheSize = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of retired objects after which retire() tries to free them
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const RetireBatchSize = 64;
 
       public:
 
         // A class to automatically unuse the DataProtector:
         class UnUser {
-            DataProtector* _prot;
-            int _id;
+            Slot* _slot;
 
           public:
-            UnUser (DataProtector* p, int i) 
-              : _prot(p), 
-                _id(i) {
+            explicit UnUser (Slot* slot) 
+              : _slot(slot) {
             }
 
             ~UnUser () {
-              if (_prot != nullptr) {
-                _prot->unUse(_id);
+              if (_slot != nullptr) {
+                DataProtector::unUse(_slot);
               }
             }
 
             // A move constructor
             UnUser (UnUser&& that) 
-              : _prot(that._prot), 
-                _id(that._id) {
+              : _slot(that._slot) {
               // Note that return value optimization will usually avoid
               // this move constructor completely. However, it has to be
               // present for the program to compile.
-              that._prot = nullptr;
+              that._slot = nullptr;
             }
 
             // Explicitly delete the others:
@@ -124,55 +174,111 @@ namespace triagens {
             UnUser () = delete;
         };
 
-        DataProtector () : _list(nullptr) {
-          _list = new Entry[DATA_PROTECTOR_MULTIPLICITY];
-          // Just to be sure:
-          for (size_t i = 0; i < DATA_PROTECTOR_MULTIPLICITY; i++) {
-            _list[i]._count = 0;
-          }
-        }
+        DataProtector ();
 
-        ~DataProtector () {
-          delete[] _list;
-        }
+        ~DataProtector ();
+
+        DataProtector (DataProtector const&) = delete;
+        DataProtector& operator= (DataProtector const&) = delete;
 
         UnUser use () {
-          int id = getMyId();
-          _list[id]._count++;   // this is implicitly using memory_order_seq_cst
-          return UnUser(this, id);  // return value optimization!
-        }
+          Slot* slot = mySlot();
+          uint64_t state = slot->_state.load(std::memory_order_relaxed);
+          uint64_t desired;
 
-        void scan () {
-          for (size_t i = 0; i < DATA_PROTECTOR_MULTIPLICITY; i++) {
-            while (_list[i]._count > 0) {
-              // let other threads do some work while we're waiting
-              usleep(250);
+          do {
+            if ((state & CountMask) == 0) {
+              desired = (_epoch.load(std::memory_order_relaxed) << CountBits) | 1;
+            }
+            else {
+              // nested use, keep the older epoch
+              TRI_ASSERT((state & CountMask) != CountMask);
+              desired = state + 1;
             }
           }
+          while (! slot->_state.compare_exchange_weak(state, desired, std::memory_order_relaxed, std::memory_order_relaxed));
+
+          // the slot must be visible to writers before the protected data
+          // is read
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          return UnUser(slot);  // return value optimization!
         }
 
-      private:
+        // waits until no reader that started before the call is active
+        void scan ();
+
+        // returns whether no reader that started before the call is active
+        // at the moment. unlike scan(), this never waits. a thread that has
+        // unlinked some data and then sees this return true may free that
+        // data
+        bool isUnused ();
 
-        void unUse (int id) {
-          _list[id]._count--;   // this is implicitly using memory_order_seq_cst
+        // frees the data once no reader that started before the call is
+        // active. the data must have been unlinked before
+        template<typename T>
+        void retire (T* data) {
+          retire(static_cast<void*>(data), [] (void* p) -> void { delete static_cast<T*>(p); });
         }
 
-        int getMyId () {
-          int id = _mySlot;
-          if (id >= 0) {
-            return id;
+        void retire (void* data, 
+                     void (*deleter) (void*));
+
+        // frees the retired data that no reader can see anymore, and returns
+        // the number of objects freed
+        size_t reclaim ();
+
+      private:
+
+        static void unUse (Slot* slot) {
+          uint64_t state = slot->_state.load(std::memory_order_relaxed);
+          uint64_t desired;
+
+          do {
+            TRI_ASSERT((state & CountMask) != 0);
+            desired = ((state & CountMask) == 1) ? 0 : state - 1;
           }
-          while (true) {
-            int newId = _last + 1;
-            if (newId >= DATA_PROTECTOR_MULTIPLICITY) {
-              newId = 0;
-            }
-            if (_last.compare_exchange_strong(id, newId)) {
-              _mySlot = newId;
-              return newId;
-            }
+          while (! slot->_state.compare_exchange_weak(state, desired, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        Slot* mySlot () {
+          CacheEntry& entry = _cache[_serial % CacheSize];
+
+          if (entry._serial == _serial) {
+            return entry._slot;
           }
+
+          return acquireSlot();
         }
+
+        Slot* acquireSlot ();
+
+        // starts a new epoch, and returns it. readers that hold an older
+        // epoch may still see data unlinked before the call
+        uint64_t nextEpoch ();
+
+        // returns the oldest epoch held by a reader, or UINT64_MAX
+        uint64_t oldestEpoch () const;
+
+      private:
+
+        // identifies the protector in the per-thread caches. unlike the
+        // address, the serial number is never reused
+        uint64_t const _serial;
+
+        std::atomic<uint64_t> _epoch;
+
+        // the slots of all threads that ever used the protector, the list
+        // only grows
+        std::atomic<Slot*> _slots;
+
+        Mutex _retiredLock;
+
+        std::vector<Retired> _retired;
+
+        static std::atomic<uint64_t> _nextSerial;
+
+        static thread_local CacheEntry _cache[CacheSize];
     };
 
   }  // namespace triagens::basics
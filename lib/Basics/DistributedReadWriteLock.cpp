@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reader-biased read-write lock with distributed reader counters
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "DistributedReadWriteLock.h"
+
+#include <thread>
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+std::atomic<size_t> DistributedReadWriteLock::NextSlot(0);
+
+thread_local int DistributedReadWriteLock::MySlot = -1;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief pauses a spinning thread
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void Pause (int round) {
+  if (round < 100) {
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#endif
+  }
+  else {
+    std::this_thread::yield();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+DistributedReadWriteLock::DistributedReadWriteLock ()
+  : _writer(false),
+    _writeLocked(false),
+    _sleepers(0) {
+
+  for (size_t i = 0; i < NumSlots; ++i) {
+    _slots[i]._readers = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes the read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+DistributedReadWriteLock::~DistributedReadWriteLock () {
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing
+////////////////////////////////////////////////////////////////////////////////
+
+void DistributedReadWriteLock::writeLock () {
+  // wait for other writers
+  int round = 0;
+
+  while (! _writerMutex.try_lock()) {
+    if (++round > SpinRounds) {
+      _writerMutex.lock();
+      break;
+    }
+
+    Pause(round);
+  }
+
+  // keep new readers out, then wait for the current ones to leave
+  _writer.store(true, std::memory_order_seq_cst);
+
+  round = 0;
+
+  while (readers() != 0) {
+    if (++round > SpinRounds) {
+      std::unique_lock<std::mutex> guard(_mutex);
+
+      ++_sleepers;
+
+      while (readers() != 0) {
+        _bell.wait(guard);
+      }
+
+      --_sleepers;
+      break;
+    }
+
+    Pause(round);
+  }
+
+  _writeLocked = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to lock for writing
+////////////////////////////////////////////////////////////////////////////////
+
+bool DistributedReadWriteLock::tryWriteLock () {
+  if (! _writerMutex.try_lock()) {
+    return false;
+  }
+
+  _writer.store(true, std::memory_order_seq_cst);
+
+  if (readers() != 0) {
+    // readers may have blocked in the meantime
+    _writer.store(false, std::memory_order_seq_cst);
+    wakeUp();
+    _writerMutex.unlock();
+
+    return false;
+  }
+
+  _writeLocked = true;
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until a read lock is acquired
+////////////////////////////////////////////////////////////////////////////////
+
+void DistributedReadWriteLock::readLockSlow () {
+  int round = 0;
+
+  while (true) {
+    if (! _writer.load(std::memory_order_seq_cst)) {
+      if (tryReadLock()) {
+        return;
+      }
+    }
+    else if (++round > SpinRounds) {
+      std::unique_lock<std::mutex> guard(_mutex);
+
+      ++_sleepers;
+
+      while (_writer.load(std::memory_order_seq_cst)) {
+        _bell.wait(guard);
+      }
+
+      --_sleepers;
+      round = 0;
+    }
+    else {
+      Pause(round);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+void DistributedReadWriteLock::writeUnlock () {
+  _writeLocked = false;
+  _writer.store(false, std::memory_order_seq_cst);
+
+  wakeUp();
+
+  _writerMutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of readers
+///
+/// A reader may release its lock in another counter than the one it acquired
+/// it in, so only the sum of all counters is meaningful.
+////////////////////////////////////////////////////////////////////////////////
+
+int64_t DistributedReadWriteLock::readers () const {
+  int64_t sum = 0;
+
+  for (size_t i = 0; i < NumSlots; ++i) {
+    sum += _slots[i]._readers.load(std::memory_order_seq_cst);
+  }
+
+  return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up all blocked threads
+////////////////////////////////////////////////////////////////////////////////
+
+void DistributedReadWriteLock::wakeUp () {
+  if (_sleepers.load(std::memory_order_seq_cst) > 0) {
+    std::unique_lock<std::mutex> guard(_mutex);
+    _bell.notify_all();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,322 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reader-biased read-write lock with distributed reader counters
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_DISTRIBUTED_READ_WRITE_LOCK_H
+#define ARANGODB_BASICS_DISTRIBUTED_READ_WRITE_LOCK_H 1
+
+#include "Basics/Common.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    class DistributedReadWriteLock
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read-write lock for short, read-mostly critical sections
+///
+/// Readers announce themselves in one of several counters, each on its own
+/// cache line, so that readers on different cores do not contend for the
+/// same line. A reader that finds no writer is done after one atomic add.
+/// Writers are serialized by a mutex, then raise a flag that keeps new
+/// readers out and wait until all counters add up to zero. So a writer is
+/// never starved by readers. Waiting threads spin for a short while before
+/// they block on a condition variable.
+///
+/// Like ReadWriteLockCPP11, the lock may be released by a thread other than
+/// the one that acquired it. Read locks must not be acquired recursively,
+/// as a waiting writer blocks the second acquisition.
+////////////////////////////////////////////////////////////////////////////////
+
+    class DistributedReadWriteLock {
+
+      private:
+        DistributedReadWriteLock (DistributedReadWriteLock const&) = delete;
+        DistributedReadWriteLock& operator= (DistributedReadWriteLock const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private defines
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of reader counters
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const NumSlots = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of spin rounds before a waiting thread blocks
+////////////////////////////////////////////////////////////////////////////////
+
+        static int const SpinRounds = 1000;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size of a cache line
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const CacheLineSize = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a reader counter, padded to a cache line
+///
+/// the lock is embedded in objects allocated with plain operator new, which
+/// does not honor an over-alignment. the counters are therefore padded
+/// instead of aligned: they are a cache line apart, so no two of them share
+/// a line, wherever the lock starts
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Slot {
+          std::atomic<int64_t> _readers;
+          char _padding[CacheLineSize - sizeof(std::atomic<int64_t>)];
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs a read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        DistributedReadWriteLock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief deletes the read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        ~DistributedReadWriteLock ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for reading
+////////////////////////////////////////////////////////////////////////////////
+
+        inline void readLock () {
+          if (! tryReadLock()) {
+            readLockSlow();
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to lock for reading
+////////////////////////////////////////////////////////////////////////////////
+
+        inline bool tryReadLock () {
+          std::atomic<int64_t>& readers = slot();
+
+          readers.fetch_add(1, std::memory_order_seq_cst);
+
+          if (! _writer.load(std::memory_order_seq_cst)) {
+            return true;
+          }
+
+          // a writer is active or waiting, back off
+          readUnlock(readers);
+          return false;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for writing
+////////////////////////////////////////////////////////////////////////////////
+
+        void writeLock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to lock for writing
+////////////////////////////////////////////////////////////////////////////////
+
+        bool tryWriteLock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the read-lock or write-lock
+////////////////////////////////////////////////////////////////////////////////
+
+        inline void unlock () {
+          if (_writeLocked) {
+            writeUnlock();
+          }
+          else {
+            readUnlock(slot());
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the reader counter of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+        inline std::atomic<int64_t>& slot () {
+          return _slots[ThreadSlot()]._readers;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases a read lock
+////////////////////////////////////////////////////////////////////////////////
+
+        inline void readUnlock (std::atomic<int64_t>& readers) {
+          readers.fetch_sub(1, std::memory_order_seq_cst);
+
+          if (_writer.load(std::memory_order_seq_cst)) {
+            // a writer may be waiting for the readers to leave
+            wakeUp();
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief waits until a read lock is acquired
+////////////////////////////////////////////////////////////////////////////////
+
+        void readLockSlow ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases the write lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void writeUnlock ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of readers
+////////////////////////////////////////////////////////////////////////////////
+
+        int64_t readers () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wakes up all blocked threads
+////////////////////////////////////////////////////////////////////////////////
+
+        void wakeUp ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the counter index of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static inline size_t ThreadSlot () {
+          if (MySlot < 0) {
+            MySlot = static_cast<int>(NextSlot++ % NumSlots);
+          }
+
+          return static_cast<size_t>(MySlot);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the next counter index handed out to a thread
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::atomic<size_t> NextSlot;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief counter index of the current thread, -1 if not yet assigned
+////////////////////////////////////////////////////////////////////////////////
+
+        static thread_local int MySlot;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief keeps the first counter off the cache line of the data before
+/// the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        char _padding[CacheLineSize];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reader counters
+////////////////////////////////////////////////////////////////////////////////
+
+        Slot _slots[NumSlots];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a writer holds or waits for the lock. the padding of the
+/// last counter keeps it off the cache line of that counter
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<bool> _writer;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a writer holds the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _writeLocked;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of blocked threads
+////////////////////////////////////////////////////////////////////////////////
+
+        std::atomic<int> _sleepers;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serializes writers
+////////////////////////////////////////////////////////////////////////////////
+
+        std::mutex _writerMutex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects blocking and waking up
+////////////////////////////////////////////////////////////////////////////////
+
+        std::mutex _mutex;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief condition variable for blocked threads
+////////////////////////////////////////////////////////////////////////////////
+
+        std::condition_variable _bell;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
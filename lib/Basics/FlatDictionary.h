@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief flat open-addressing dictionary for character slices
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_FLAT_DICTIONARY_H
+#define ARANGODB_BASICS_FLAT_DICTIONARY_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              class FlatDictionary
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief associative array for character slices to POD
+///
+/// The keys are not copied, they must point into a buffer that outlives the
+/// dictionary, e.g. the header block of a request. The first INLINE slots are
+/// part of the object itself, so that a dictionary with up to INLINE / 2
+/// entries does not allocate any memory. Inserting an existing key replaces
+/// its value. The interface mirrors the one of Dictionary.
+////////////////////////////////////////////////////////////////////////////////
+
+    template <typename ELEMENT, size_t INLINE = 16>
+    class FlatDictionary {
+      private:
+        FlatDictionary (FlatDictionary const&) = delete;
+        FlatDictionary& operator= (FlatDictionary const&) = delete;
+
+        static_assert((INLINE & (INLINE - 1)) == 0, "INLINE must be a power of two");
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief key-value stored in the dictonary
+////////////////////////////////////////////////////////////////////////////////
+
+        struct KeyValue {
+          public:
+            KeyValue ()
+              : _key(nullptr), _keyLength(0), _value() {
+            }
+
+          public:
+            char const* _key;
+            size_t _keyLength;
+            ELEMENT _value;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief constructs an empty dictionary
+////////////////////////////////////////////////////////////////////////////////
+
+        FlatDictionary ()
+          : _table(_inline),
+            _nrAlloc(INLINE),
+            _nrUsed(0) {
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destructor
+////////////////////////////////////////////////////////////////////////////////
+
+        ~FlatDictionary () {
+          if (_table != _inline) {
+            delete[] _table;
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of entries
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t size () const {
+          return _nrUsed;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a key value pair
+////////////////////////////////////////////////////////////////////////////////
+
+        bool insert (char const* key, ELEMENT const& value) {
+          return insert(key, strlen(key), value);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a key value pair, returns false if the key was replaced
+////////////////////////////////////////////////////////////////////////////////
+
+        bool insert (char const* key, size_t keyLength, ELEMENT const& value) {
+          // keep the load factor at most 1/2
+          if (2 * (_nrUsed + 1) > _nrAlloc) {
+            resize(2 * _nrAlloc);
+          }
+
+          KeyValue* slot = find(key, keyLength);
+
+          if (slot->_key != nullptr) {
+            slot->_value = value;
+            return false;
+          }
+
+          slot->_key = key;
+          slot->_keyLength = keyLength;
+          slot->_value = value;
+          ++_nrUsed;
+
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current range, empty slots have a null key
+////////////////////////////////////////////////////////////////////////////////
+
+        void range (KeyValue const*& begin, KeyValue const*& end) const {
+          begin = _table;
+          end = _table + _nrAlloc;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a key
+////////////////////////////////////////////////////////////////////////////////
+
+        KeyValue const* lookup (char const* key) const {
+          return lookup(key, strlen(key));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief looks up a key
+////////////////////////////////////////////////////////////////////////////////
+
+        KeyValue const* lookup (char const* key, size_t keyLength) const {
+          KeyValue const* slot = const_cast<FlatDictionary*>(this)->find(key, keyLength);
+
+          if (slot->_key == nullptr) {
+            return nullptr;
+          }
+
+          return slot;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hashes a key (FNV-1a)
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t hash (char const* key, size_t keyLength) {
+          uint32_t h = 0x811C9DC5UL;
+
+          for (size_t i = 0;  i < keyLength;  ++i) {
+            h ^= (uint8_t) key[i];
+            h *= 0x01000193UL;
+          }
+
+          return h;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the slot of a key or the empty slot where it belongs
+////////////////////////////////////////////////////////////////////////////////
+
+        KeyValue* find (char const* key, size_t keyLength) {
+          size_t const mask = _nrAlloc - 1;
+          size_t i = hash(key, keyLength) & mask;
+
+          while (true) {
+            KeyValue* slot = _table + i;
+
+            if (slot->_key == nullptr ||
+                (slot->_keyLength == keyLength && memcmp(slot->_key, key, keyLength) == 0)) {
+              return slot;
+            }
+
+            i = (i + 1) & mask;
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves all entries into a larger table
+////////////////////////////////////////////////////////////////////////////////
+
+        void resize (size_t nrAlloc) {
+          KeyValue* oldTable = _table;
+          size_t const oldAlloc = _nrAlloc;
+
+          _table = new KeyValue[nrAlloc];
+          _nrAlloc = nrAlloc;
+
+          for (size_t i = 0;  i < oldAlloc;  ++i) {
+            KeyValue const& old = oldTable[i];
+
+            if (old._key != nullptr) {
+              *find(old._key, old._keyLength) = old;
+            }
+          }
+
+          if (oldTable != _inline) {
+            delete[] oldTable;
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief slots, either _inline or allocated
+////////////////////////////////////////////////////////////////////////////////
+
+        KeyValue* _table;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of slots, a power of two
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nrAlloc;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of used slots
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _nrUsed;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inline slots
+////////////////////////////////////////////////////////////////////////////////
+
+        KeyValue _inline[INLINE];
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,480 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hierarchical geo cells
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "GeoCell.h"
+
+using namespace triagens::basics;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of grid coordinates per axis on the finest level
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t const GridSize = static_cast<uint64_t>(1) << GeoCell::MaxLevel;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief slack for comparing cell bounds in degrees with polygon edges, so
+/// that points rounded into a cell are not missed
+////////////////////////////////////////////////////////////////////////////////
+
+static double const Slack = 1e-9;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a cell during the computation of a covering
+////////////////////////////////////////////////////////////////////////////////
+
+struct CoverCell {
+  CoverCell (int level, uint32_t x, uint32_t y)
+    : _level(level), _x(x), _y(y) {
+  }
+
+  int      _level;
+  uint32_t _x;
+  uint32_t _y;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief first and last grid coordinate of a cell on the finest level
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void GridBounds (CoverCell const& cell,
+                               uint32_t& minX,
+                               uint32_t& minY,
+                               uint32_t& maxX,
+                               uint32_t& maxY) {
+  int const shift = GeoCell::MaxLevel - cell._level;
+  uint64_t const size = static_cast<uint64_t>(1) << shift;
+
+  minX = static_cast<uint32_t>(static_cast<uint64_t>(cell._x) << shift);
+  minY = static_cast<uint32_t>(static_cast<uint64_t>(cell._y) << shift);
+  maxX = static_cast<uint32_t>(minX + size - 1);
+  maxY = static_cast<uint32_t>(minY + size - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bounds of a cell in degrees
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void DegreeBounds (CoverCell const& cell,
+                                 double& minLatitude,
+                                 double& minLongitude,
+                                 double& maxLatitude,
+                                 double& maxLongitude) {
+  double const size = static_cast<double>(static_cast<uint64_t>(1) << cell._level);
+
+  minLongitude = -180.0 + 360.0 * static_cast<double>(cell._x) / size;
+  maxLongitude = -180.0 + 360.0 * static_cast<double>(cell._x + 1) / size;
+  minLatitude  = -90.0 + 180.0 * static_cast<double>(cell._y) / size;
+  maxLatitude  = -90.0 + 180.0 * static_cast<double>(cell._y + 1) / size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief orientation of the triangle (a, b, c): > 0 counterclockwise,
+/// < 0 clockwise, 0 collinear
+////////////////////////////////////////////////////////////////////////////////
+
+static inline double Orientation (double ax, double ay,
+                                  double bx, double by,
+                                  double cx, double cy) {
+  return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the segments (a, b) and (c, d) intersect or touch
+////////////////////////////////////////////////////////////////////////////////
+
+static bool SegmentsIntersect (double ax, double ay, double bx, double by,
+                               double cx, double cy, double dx, double dy) {
+  double const o1 = Orientation(ax, ay, bx, by, cx, cy);
+  double const o2 = Orientation(ax, ay, bx, by, dx, dy);
+  double const o3 = Orientation(cx, cy, dx, dy, ax, ay);
+  double const o4 = Orientation(cx, cy, dx, dy, bx, by);
+
+  if (((o1 > 0.0 && o2 < 0.0) || (o1 < 0.0 && o2 > 0.0)) &&
+      ((o3 > 0.0 && o4 < 0.0) || (o3 < 0.0 && o4 > 0.0))) {
+    return true;
+  }
+
+  // collinear or touching cases: check the bounding boxes
+  auto onSegment = [] (double px, double py, double qx, double qy, double rx, double ry) -> bool {
+    return (std::min(px, qx) <= rx && rx <= std::max(px, qx) &&
+            std::min(py, qy) <= ry && ry <= std::max(py, qy));
+  };
+
+  return ((o1 == 0.0 && onSegment(ax, ay, bx, by, cx, cy)) ||
+          (o2 == 0.0 && onSegment(ax, ay, bx, by, dx, dy)) ||
+          (o3 == 0.0 && onSegment(cx, cy, dx, dy, ax, ay)) ||
+          (o4 == 0.0 && onSegment(cx, cy, dx, dy, bx, by)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a segment intersects or touches a rectangle
+/// x is the longitude, y the latitude
+////////////////////////////////////////////////////////////////////////////////
+
+static bool SegmentIntersectsRectangle (double ax, double ay, double bx, double by,
+                                        double minX, double minY, double maxX, double maxY) {
+  if (std::max(ax, bx) < minX || std::min(ax, bx) > maxX ||
+      std::max(ay, by) < minY || std::min(ay, by) > maxY) {
+    return false;
+  }
+
+  if ((ax >= minX && ax <= maxX && ay >= minY && ay <= maxY) ||
+      (bx >= minX && bx <= maxX && by >= minY && by <= maxY)) {
+    // an endpoint is inside
+    return true;
+  }
+
+  return (SegmentsIntersect(ax, ay, bx, by, minX, minY, maxX, minY) ||
+          SegmentsIntersect(ax, ay, bx, by, maxX, minY, maxX, maxY) ||
+          SegmentsIntersect(ax, ay, bx, by, maxX, maxY, minX, maxY) ||
+          SegmentsIntersect(ax, ay, bx, by, minX, maxY, minX, minY));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes a covering from the root cell down
+///
+/// classify returns 0 if a cell is disjoint from the region, 1 if it
+/// intersects it and 2 if it is contained in it. cells are split
+/// breadth-first, so the coarsest cells are refined first, as long as the
+/// covering stays within maxCells cells
+////////////////////////////////////////////////////////////////////////////////
+
+template<typename F>
+static std::vector<GeoCell::Range> Cover (F const& classify,
+                                          size_t maxCells,
+                                          uint64_t (*interleave) (uint32_t, uint32_t)) {
+  if (maxCells < 1) {
+    maxCells = 1;
+  }
+
+  std::vector<CoverCell> done;
+  std::deque<CoverCell> pending;
+
+  CoverCell const root(0, 0, 0);
+
+  if (classify(root) != 0) {
+    pending.emplace_back(root);
+  }
+
+  while (! pending.empty()) {
+    CoverCell const current = pending.front();
+    pending.pop_front();
+
+    if (current._level == GeoCell::MaxLevel || classify(current) == 2) {
+      done.emplace_back(current);
+      continue;
+    }
+
+    CoverCell children[4] = {
+      CoverCell(current._level + 1, current._x * 2, current._y * 2),
+      CoverCell(current._level + 1, current._x * 2 + 1, current._y * 2),
+      CoverCell(current._level + 1, current._x * 2, current._y * 2 + 1),
+      CoverCell(current._level + 1, current._x * 2 + 1, current._y * 2 + 1)
+    };
+
+    size_t numChildren = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      if (classify(children[i]) != 0) {
+        children[numChildren++] = children[i];
+      }
+    }
+
+    if (done.size() + pending.size() + numChildren > maxCells) {
+      // splitting would exceed the budget, keep the coarse cell
+      done.emplace_back(current);
+      continue;
+    }
+
+    for (size_t i = 0; i < numChildren; ++i) {
+      pending.emplace_back(children[i]);
+    }
+  }
+
+  std::vector<GeoCell::Range> ranges;
+  ranges.reserve(done.size());
+
+  for (auto const& it : done) {
+    int const shift = 2 * (GeoCell::MaxLevel - it._level);
+    uint64_t const min = interleave(it._x, it._y) << shift;
+    uint64_t const max = min + ((static_cast<uint64_t>(1) << shift) - 1);
+    ranges.emplace_back(min, max);
+  }
+
+  std::sort(ranges.begin(), ranges.end(), [] (GeoCell::Range const& lhs, GeoCell::Range const& rhs) {
+    return lhs._min < rhs._min;
+  });
+
+  // merge adjacent ranges
+  size_t j = 0;
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    if (ranges[j]._max + 1 == ranges[i]._min) {
+      ranges[j]._max = ranges[i]._max;
+    }
+    else {
+      ranges[++j] = ranges[i];
+    }
+  }
+
+  if (! ranges.empty()) {
+    ranges.resize(j + 1, GeoCell::Range(0, 0));
+  }
+
+  return ranges;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     class GeoCell
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of a point, which must be valid
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t GeoCell::id (double latitude,
+                      double longitude) {
+  TRI_ASSERT(isValid(latitude, longitude));
+
+  return interleave(gridCoordinate(longitude, -180.0, 360.0),
+                    gridCoordinate(latitude, -90.0, 180.0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the range of ids of the cell of a point on a level
+////////////////////////////////////////////////////////////////////////////////
+
+GeoCell::Range GeoCell::cell (double latitude,
+                              double longitude,
+                              int level) {
+  TRI_ASSERT(level >= 0 && level <= MaxLevel);
+
+  int const shift = 2 * (MaxLevel - level);
+  uint64_t const mask = (static_cast<uint64_t>(1) << shift) - 1;
+  uint64_t const leaf = id(latitude, longitude);
+
+  return Range(leaf & ~mask, leaf | mask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns sorted, disjoint ranges of ids covering a rectangle
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<GeoCell::Range> GeoCell::coverRectangle (double minLatitude,
+                                                     double minLongitude,
+                                                     double maxLatitude,
+                                                     double maxLongitude,
+                                                     size_t maxCells) {
+  TRI_ASSERT(isValid(minLatitude, minLongitude));
+  TRI_ASSERT(isValid(maxLatitude, maxLongitude));
+  TRI_ASSERT(minLatitude <= maxLatitude);
+  TRI_ASSERT(minLongitude <= maxLongitude);
+
+  // the grid coordinates are monotonic in the degrees, so all points in the
+  // rectangle have grid coordinates in these bounds
+  uint32_t const minX = gridCoordinate(minLongitude, -180.0, 360.0);
+  uint32_t const maxX = gridCoordinate(maxLongitude, -180.0, 360.0);
+  uint32_t const minY = gridCoordinate(minLatitude, -90.0, 180.0);
+  uint32_t const maxY = gridCoordinate(maxLatitude, -90.0, 180.0);
+
+  auto classify = [&] (CoverCell const& cell) -> int {
+    uint32_t cellMinX, cellMinY, cellMaxX, cellMaxY;
+    GridBounds(cell, cellMinX, cellMinY, cellMaxX, cellMaxY);
+
+    if (cellMaxX < minX || cellMinX > maxX ||
+        cellMaxY < minY || cellMinY > maxY) {
+      return 0;
+    }
+
+    if (cellMinX >= minX && cellMaxX <= maxX &&
+        cellMinY >= minY && cellMaxY <= maxY) {
+      return 2;
+    }
+
+    return 1;
+  };
+
+  return Cover(classify, maxCells, &GeoCell::interleave);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns sorted, disjoint ranges of ids covering a polygon
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<GeoCell::Range> GeoCell::coverPolygon (std::vector<std::pair<double, double>> const& polygon,
+                                                   size_t maxCells) {
+  if (polygon.empty()) {
+    return std::vector<Range>();
+  }
+
+  double minLatitude = polygon[0].first;
+  double maxLatitude = polygon[0].first;
+  double minLongitude = polygon[0].second;
+  double maxLongitude = polygon[0].second;
+
+  for (auto const& it : polygon) {
+    minLatitude = std::min(minLatitude, it.first);
+    maxLatitude = std::max(maxLatitude, it.first);
+    minLongitude = std::min(minLongitude, it.second);
+    maxLongitude = std::max(maxLongitude, it.second);
+  }
+
+  // clamp the bounding box to the world, points outside cannot be indexed
+  minLatitude = std::max(minLatitude, -90.0);
+  maxLatitude = std::min(maxLatitude, 90.0);
+  minLongitude = std::max(minLongitude, -180.0);
+  maxLongitude = std::min(maxLongitude, 180.0);
+
+  if (minLatitude > maxLatitude || minLongitude > maxLongitude) {
+    return std::vector<Range>();
+  }
+
+  uint32_t const minX = gridCoordinate(minLongitude, -180.0, 360.0);
+  uint32_t const maxX = gridCoordinate(maxLongitude, -180.0, 360.0);
+  uint32_t const minY = gridCoordinate(minLatitude, -90.0, 180.0);
+  uint32_t const maxY = gridCoordinate(maxLatitude, -90.0, 180.0);
+
+  size_t const n = polygon.size();
+
+  auto classify = [&] (CoverCell const& cell) -> int {
+    uint32_t cellMinX, cellMinY, cellMaxX, cellMaxY;
+    GridBounds(cell, cellMinX, cellMinY, cellMaxX, cellMaxY);
+
+    if (cellMaxX < minX || cellMinX > maxX ||
+        cellMaxY < minY || cellMinY > maxY) {
+      // outside of the bounding box
+      return 0;
+    }
+
+    double cellMinLatitude, cellMinLongitude, cellMaxLatitude, cellMaxLongitude;
+    DegreeBounds(cell, cellMinLatitude, cellMinLongitude, cellMaxLatitude, cellMaxLongitude);
+    cellMinLatitude -= Slack;
+    cellMinLongitude -= Slack;
+    cellMaxLatitude += Slack;
+    cellMaxLongitude += Slack;
+
+    for (size_t i = 0; i < n; ++i) {
+      auto const& a = polygon[i];
+      auto const& b = polygon[(i + 1) % n];
+
+      if (SegmentIntersectsRectangle(a.second, a.first, b.second, b.first,
+                                     cellMinLongitude, cellMinLatitude,
+                                     cellMaxLongitude, cellMaxLatitude)) {
+        return 1;
+      }
+    }
+
+    // no edge touches the cell, so it is completely inside or outside
+    double const centerLatitude = (cellMinLatitude + cellMaxLatitude) / 2.0;
+    double const centerLongitude = (cellMinLongitude + cellMaxLongitude) / 2.0;
+
+    return (isInPolygon(polygon, centerLatitude, centerLongitude) ? 2 : 0);
+  };
+
+  return Cover(classify, maxCells, &GeoCell::interleave);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a point is inside a polygon
+////////////////////////////////////////////////////////////////////////////////
+
+bool GeoCell::isInPolygon (std::vector<std::pair<double, double>> const& polygon,
+                           double latitude,
+                           double longitude) {
+  size_t const n = polygon.size();
+  bool inside = false;
+
+  for (size_t i = 0, j = n - 1; i < n; j = i++) {
+    double const latI = polygon[i].first;
+    double const lonI = polygon[i].second;
+    double const latJ = polygon[j].first;
+    double const lonJ = polygon[j].second;
+
+    if (((latI > latitude) != (latJ > latitude)) &&
+        (longitude < (lonJ - lonI) * (latitude - latI) / (latJ - latI) + lonI)) {
+      inside = ! inside;
+    }
+  }
+
+  return inside;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief grid coordinate of a latitude or longitude on the finest level
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t GeoCell::gridCoordinate (double value,
+                                  double min,
+                                  double extent) {
+  double const scaled = std::floor((value - min) / extent * static_cast<double>(GridSize));
+
+  if (scaled <= 0.0) {
+    return 0;
+  }
+  if (scaled >= static_cast<double>(GridSize - 1)) {
+    return static_cast<uint32_t>(GridSize - 1);
+  }
+  return static_cast<uint32_t>(scaled);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interleaves the bits of two grid coordinates, x going to the odd
+/// and y to the even bit positions
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t GeoCell::interleave (uint32_t x,
+                              uint32_t y) {
+  auto spread = [] (uint64_t v) -> uint64_t {
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8))  & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2))  & 0x3333333333333333ULL;
+    v = (v | (v << 1))  & 0x5555555555555555ULL;
+    return v;
+  };
+
+  return (spread(x) << 1) | spread(y);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
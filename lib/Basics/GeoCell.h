@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hierarchical geo cells
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_GEO_CELL_H
+#define ARANGODB_BASICS_GEO_CELL_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     class GeoCell
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hierarchical cells on a latitude/longitude grid
+///
+/// the world is split into 2^level x 2^level cells on each level, up to
+/// MaxLevel. the id of a point is the Z-order (Morton) interleaving of its
+/// longitude and latitude grid coordinates on the finest level. all points
+/// of a cell on any level have ids in one contiguous range, and neighboring
+/// cells mostly have neighboring ranges, so points stored sorted by id can
+/// be looked up by scanning the ranges of a covering of the query region.
+/// coverings are conservative: they contain all points of the region but
+/// may contain others, which the caller has to filter out
+////////////////////////////////////////////////////////////////////////////////
+
+    class GeoCell {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the finest level, its cells are about 2 cm high at the equator
+////////////////////////////////////////////////////////////////////////////////
+
+        static int const MaxLevel = 30;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a range of ids, both ends inclusive
+////////////////////////////////////////////////////////////////////////////////
+
+        struct Range {
+          Range (uint64_t min, uint64_t max)
+            : _min(min), _max(max) {
+          }
+
+          uint64_t _min;
+          uint64_t _max;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether latitude and longitude are valid coordinates
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool isValid (double latitude,
+                             double longitude) {
+          return (latitude >= -90.0 && latitude <= 90.0 &&
+                  longitude >= -180.0 && longitude <= 180.0);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the id of a point, which must be valid
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t id (double latitude,
+                            double longitude);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the range of ids of the cell of a point on a level
+////////////////////////////////////////////////////////////////////////////////
+
+        static Range cell (double latitude,
+                           double longitude,
+                           int level);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns sorted, disjoint ranges of ids covering a rectangle
+///
+/// the rectangle must be valid and must not cross the antimeridian, i.e.
+/// minLongitude <= maxLongitude. the covering consists of at most maxCells
+/// cells, fewer if adjacent ranges could be merged
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::vector<Range> coverRectangle (double minLatitude,
+                                                  double minLongitude,
+                                                  double maxLatitude,
+                                                  double maxLongitude,
+                                                  size_t maxCells = 16);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns sorted, disjoint ranges of ids covering a polygon, given
+/// as a list of (latitude, longitude) vertices
+////////////////////////////////////////////////////////////////////////////////
+
+        static std::vector<Range> coverPolygon (std::vector<std::pair<double, double>> const&,
+                                                size_t maxCells = 16);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a point is inside a polygon, given as a list of
+/// (latitude, longitude) vertices
+///
+/// this uses the even-odd rule on the latitude/longitude plane, the same
+/// as the AQL function IS_IN_POLYGON
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool isInPolygon (std::vector<std::pair<double, double>> const&,
+                                 double latitude,
+                                 double longitude);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief grid coordinate of a latitude or longitude on the finest level
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t gridCoordinate (double value,
+                                        double min,
+                                        double extent);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief interleaves the bits of two grid coordinates
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t interleave (uint32_t x,
+                                    uint32_t y);
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
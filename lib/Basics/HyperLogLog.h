@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief HyperLogLog cardinality sketch
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2012-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_HYPER_LOG_LOG_H
+#define ARANGODB_BASICS_HYPER_LOG_LOG_H 1
+
+#include "Basics/Common.h"
+
+#include <cmath>
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 class HyperLogLog
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief estimates the number of distinct values in a stream of hash values
+///
+/// the sketch uses 2^precision one-byte registers. the standard error of the
+/// estimate is about 1.04 / sqrt(2^precision), i.e. about 3 % for the default
+/// precision of 10 (1 KB of registers). values can only be added, not
+/// removed, so the estimate never decreases until the sketch is cleared
+////////////////////////////////////////////////////////////////////////////////
+
+    class HyperLogLog {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        explicit HyperLogLog (uint32_t precision = 10)
+          : _precision(precision),
+            _registers(static_cast<size_t>(1) << precision, 0) {
+
+          TRI_ASSERT(precision >= 4 && precision <= 16);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds a hash value to the sketch. the hash value must be well
+/// distributed over all 64 bits
+////////////////////////////////////////////////////////////////////////////////
+
+        void add (uint64_t hash) {
+          size_t const index = static_cast<size_t>(hash >> (64 - _precision));
+          // the sentinel bit limits the rank to 64 - precision + 1
+          uint64_t const rest = (hash << _precision) | (static_cast<uint64_t>(1) << (_precision - 1));
+          uint8_t const rank = static_cast<uint8_t>(leadingZeros(rest) + 1);
+
+          if (rank > _registers[index]) {
+            _registers[index] = rank;
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the estimated number of distinct hash values added
+////////////////////////////////////////////////////////////////////////////////
+
+        double estimate () const {
+          double const m = static_cast<double>(_registers.size());
+          double sum = 0.0;
+          size_t zeros = 0;
+
+          for (auto const& it : _registers) {
+            sum += std::ldexp(1.0, - static_cast<int>(it));
+            if (it == 0) {
+              ++zeros;
+            }
+          }
+
+          double const estimate = alpha() * m * m / sum;
+
+          if (estimate <= 2.5 * m && zeros > 0) {
+            // small range correction: use linear counting
+            return m * std::log(m / static_cast<double>(zeros));
+          }
+
+          return estimate;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief merges another sketch of the same precision into this one
+////////////////////////////////////////////////////////////////////////////////
+
+        void merge (HyperLogLog const& other) {
+          TRI_ASSERT(_precision == other._precision);
+
+          for (size_t i = 0; i < _registers.size(); ++i) {
+            if (other._registers[i] > _registers[i]) {
+              _registers[i] = other._registers[i];
+            }
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief resets the sketch
+////////////////////////////////////////////////////////////////////////////////
+
+        void clear () {
+          std::fill(_registers.begin(), _registers.end(), 0);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the memory used by the sketch
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memory () const {
+          return sizeof(HyperLogLog) + _registers.size();
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bias correction constant for the number of registers
+////////////////////////////////////////////////////////////////////////////////
+
+        double alpha () const {
+          size_t const m = _registers.size();
+
+          if (m == 16) {
+            return 0.673;
+          }
+          if (m == 32) {
+            return 0.697;
+          }
+          if (m == 64) {
+            return 0.709;
+          }
+          return 0.7213 / (1.0 + 1.079 / static_cast<double>(m));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of leading zero bits of a non-zero value
+////////////////////////////////////////////////////////////////////////////////
+
+        static int leadingZeros (uint64_t value) {
+          TRI_ASSERT(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+          return __builtin_clzll(value);
+#else
+          int n = 0;
+          while ((value & (static_cast<uint64_t>(1) << 63)) == 0) {
+            value <<= 1;
+            ++n;
+          }
+          return n;
+#endif
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of bits used for the register index
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t const _precision;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the registers, each holding the maximum rank seen
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<uint8_t> _registers;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,402 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times of locks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "LockProfiler.h"
+#include "Basics/JsonHelper.h"
+
+using namespace triagens::basics;
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of sites, further sites share the last one
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaxSites = 2048;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the sites, as an open addressing table
+////////////////////////////////////////////////////////////////////////////////
+
+static LockSite Sites[MaxSites];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief state of a site: 0 = free, 1 = being initialized, 2 = in use
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int> SiteStates[MaxSites];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of sites in use
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> NumSites(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of locks a thread holds that are released elsewhere
+////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_HELD_LOCKS (16)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a lock held by the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct HeldLock {
+  void const* _lock;
+  LockSite* _site;
+  uint64_t _start;
+};
+
+static thread_local HeldLock HeldLocks[MAX_HELD_LOCKS];
+
+static thread_local size_t NumHeldLocks = 0;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clears the statistics of a site
+////////////////////////////////////////////////////////////////////////////////
+
+static void ClearSite (LockSite* site) {
+  site->_acquisitions.store(0, std::memory_order_relaxed);
+  site->_waitTime.store(0, std::memory_order_relaxed);
+
+  for (size_t i = 0;  i < LockSite::NumWaitBuckets;  ++i) {
+    site->_waitBuckets[i].store(0, std::memory_order_relaxed);
+  }
+
+  site->_holdTime.store(0, std::memory_order_relaxed);
+  site->_maxHoldTime.store(0, std::memory_order_relaxed);
+  site->_conditionWaits.store(0, std::memory_order_relaxed);
+  site->_conditionWaitTime.store(0, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the name of a lock type
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* TypeName (LockSite::LockType type) {
+  switch (type) {
+    case LockSite::MUTEX:     return "mutex";
+    case LockSite::READ:      return "read";
+    case LockSite::WRITE:     return "write";
+    case LockSite::CONDITION: return "condition";
+  }
+
+  return "unknown";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the statistics of all sites of the same file, line and type. a site
+/// in a header has one entry per translation unit
+////////////////////////////////////////////////////////////////////////////////
+
+struct SiteStatistics {
+  std::string _file;
+  int _line;
+  LockSite::LockType _type;
+  uint64_t _acquisitions;
+  uint64_t _waitTime;
+  uint64_t _waitBuckets[LockSite::NumWaitBuckets];
+  uint64_t _holdTime;
+  uint64_t _maxHoldTime;
+  uint64_t _conditionWaits;
+  uint64_t _conditionWaitTime;
+};
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the profiler is compiled in
+////////////////////////////////////////////////////////////////////////////////
+
+bool LockProfiler::enabled () {
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the site of a file and line, creating it if needed
+////////////////////////////////////////////////////////////////////////////////
+
+LockSite* LockProfiler::site (char const* file,
+                              int line,
+                              LockSite::LockType type) {
+  // the same literal always has the same address in a translation unit,
+  // so the pointer is good enough for hashing
+  size_t hash = (reinterpret_cast<uintptr_t>(file) >> 3) * 31 + static_cast<size_t>(line) * 7 + type;
+
+  for (size_t i = 0;  i < MaxSites - 1;  ++i) {
+    size_t pos = (hash + i) % (MaxSites - 1);
+    int state = SiteStates[pos].load(std::memory_order_acquire);
+
+    if (state == 0) {
+      if (NumSites.load(std::memory_order_relaxed) >= MaxSites / 2) {
+        // keep probe sequences short
+        break;
+      }
+
+      if (SiteStates[pos].compare_exchange_strong(state, 1, std::memory_order_acq_rel)) {
+        LockSite* site = &Sites[pos];
+        site->_file = file;
+        site->_line = line;
+        site->_type = type;
+        ClearSite(site);
+
+        NumSites.fetch_add(1, std::memory_order_relaxed);
+        SiteStates[pos].store(2, std::memory_order_release);
+
+        return site;
+      }
+    }
+
+    while (state == 1) {
+      // another thread is initializing this site
+      state = SiteStates[pos].load(std::memory_order_acquire);
+    }
+
+    LockSite* site = &Sites[pos];
+
+    if (site->_file == file && site->_line == line && site->_type == type) {
+      return site;
+    }
+  }
+
+  // the table is full, use the last site for all others
+  int expected = 0;
+
+  if (SiteStates[MaxSites - 1].compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+    LockSite* site = &Sites[MaxSites - 1];
+    site->_file = "other";
+    site->_line = 0;
+    site->_type = type;
+    ClearSite(site);
+    SiteStates[MaxSites - 1].store(2, std::memory_order_release);
+  }
+
+  while (SiteStates[MaxSites - 1].load(std::memory_order_acquire) != 2) {
+  }
+
+  return &Sites[MaxSites - 1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records that the current thread acquired a lock
+////////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::acquired (void const* lock,
+                             LockSite* site,
+                             uint64_t start) {
+  uint64_t locked = now();
+  site->addWait(locked - start);
+
+  if (NumHeldLocks < MAX_HELD_LOCKS) {
+    HeldLock& held = HeldLocks[NumHeldLocks++];
+    held._lock = lock;
+    held._site = site;
+    held._start = locked;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records that the current thread released a lock
+////////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::released (void const* lock) {
+  // locks are usually released in the reverse order
+  for (size_t i = NumHeldLocks;  i > 0;  --i) {
+    HeldLock& held = HeldLocks[i - 1];
+
+    if (held._lock == lock) {
+      held._site->addHold(now() - held._start);
+      HeldLocks[i - 1] = HeldLocks[--NumHeldLocks];
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clears the statistics of all sites
+////////////////////////////////////////////////////////////////////////////////
+
+void LockProfiler::reset () {
+  for (size_t i = 0;  i < MaxSites;  ++i) {
+    if (SiteStates[i].load(std::memory_order_acquire) == 2) {
+      ClearSite(&Sites[i]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the statistics, sorted by the total wait time
+////////////////////////////////////////////////////////////////////////////////
+
+Json LockProfiler::toJson () {
+  std::vector<SiteStatistics> sites;
+
+  for (size_t i = 0;  i < MaxSites;  ++i) {
+    if (SiteStates[i].load(std::memory_order_acquire) != 2) {
+      continue;
+    }
+
+    LockSite const* site = &Sites[i];
+    SiteStatistics* statistics = nullptr;
+
+    for (auto& it : sites) {
+      if (it._line == site->_line && it._type == site->_type && it._file == site->_file) {
+        statistics = &it;
+        break;
+      }
+    }
+
+    if (statistics == nullptr) {
+      sites.emplace_back();
+      statistics = &sites.back();
+      memset(statistics->_waitBuckets, 0, sizeof(statistics->_waitBuckets));
+      statistics->_file = site->_file;
+      statistics->_line = site->_line;
+      statistics->_type = site->_type;
+      statistics->_acquisitions = 0;
+      statistics->_waitTime = 0;
+      statistics->_holdTime = 0;
+      statistics->_maxHoldTime = 0;
+      statistics->_conditionWaits = 0;
+      statistics->_conditionWaitTime = 0;
+    }
+
+    statistics->_acquisitions += site->_acquisitions.load(std::memory_order_relaxed);
+    statistics->_waitTime += site->_waitTime.load(std::memory_order_relaxed);
+
+    for (size_t j = 0;  j < LockSite::NumWaitBuckets;  ++j) {
+      statistics->_waitBuckets[j] += site->_waitBuckets[j].load(std::memory_order_relaxed);
+    }
+
+    statistics->_holdTime += site->_holdTime.load(std::memory_order_relaxed);
+    statistics->_maxHoldTime = (std::max)(statistics->_maxHoldTime, site->_maxHoldTime.load(std::memory_order_relaxed));
+    statistics->_conditionWaits += site->_conditionWaits.load(std::memory_order_relaxed);
+    statistics->_conditionWaitTime += site->_conditionWaitTime.load(std::memory_order_relaxed);
+  }
+
+  std::sort(sites.begin(), sites.end(), [] (SiteStatistics const& lhs, SiteStatistics const& rhs) {
+    return lhs._waitTime > rhs._waitTime;
+  });
+
+  Json bounds(Json::Array, LockSite::NumWaitBuckets - 1);
+
+  for (size_t i = 0;  i < LockSite::NumWaitBuckets - 1;  ++i) {
+    bounds.add(Json(static_cast<double>(uint64_t(1) << i) / 1000000.0));
+  }
+
+  Json list(Json::Array, sites.size());
+
+  for (auto const& it : sites) {
+    if (it._acquisitions == 0 && it._conditionWaits == 0) {
+      continue;
+    }
+
+    Json counts(Json::Array, LockSite::NumWaitBuckets);
+
+    for (size_t i = 0;  i < LockSite::NumWaitBuckets;  ++i) {
+      counts.add(Json(static_cast<double>(it._waitBuckets[i])));
+    }
+
+    Json entry(Json::Object, 10);
+    entry.set("file", Json(it._file));
+    entry.set("line", Json(static_cast<double>(it._line)));
+    entry.set("type", Json(TypeName(it._type)));
+    entry.set("acquisitions", Json(static_cast<double>(it._acquisitions)));
+    entry.set("waitTime", Json(static_cast<double>(it._waitTime) / 1e9));
+    entry.set("waitCounts", counts);
+    entry.set("holdTime", Json(static_cast<double>(it._holdTime) / 1e9));
+    entry.set("maxHoldTime", Json(static_cast<double>(it._maxHoldTime) / 1e9));
+    entry.set("conditionWaits", Json(static_cast<double>(it._conditionWaits)));
+    entry.set("conditionWaitTime", Json(static_cast<double>(it._conditionWaitTime) / 1e9));
+
+    list.add(entry);
+  }
+
+  Json result(Json::Object, 3);
+  result.set("enabled", Json(true));
+  result.set("waitBounds", bounds);
+  result.set("sites", list);
+
+  return result;
+}
+
+#else
+
+LockSite* LockProfiler::site (char const*,
+                              int,
+                              LockSite::LockType) {
+  static LockSite Unused;
+  return &Unused;
+}
+
+void LockProfiler::acquired (void const*,
+                             LockSite*,
+                             uint64_t) {
+}
+
+void LockProfiler::released (void const*) {
+}
+
+void LockProfiler::reset () {
+}
+
+Json LockProfiler::toJson () {
+  Json result(Json::Object, 2);
+  result.set("enabled", Json(false));
+  result.set("sites", Json(Json::Array));
+
+  return result;
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
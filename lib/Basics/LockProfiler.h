@@ -0,0 +1,360 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times of locks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_LOCK_PROFILER_H
+#define ARANGODB_BASICS_LOCK_PROFILER_H 1
+
+#include "Basics/Common.h"
+
+#include <atomic>
+#include <chrono>
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     public macros
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the lockers know the file and line they were created at
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(TRI_SHOW_LOCK_TIME) || defined(TRI_ENABLE_LOCK_PROFILER)
+#define TRI_TRACK_LOCK_SITES 1
+#endif
+
+namespace triagens {
+  namespace basics {
+
+    class Json;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    class LockSite
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the statistics of a place in the code where a lock is acquired
+////////////////////////////////////////////////////////////////////////////////
+
+    struct LockSite {
+
+      enum LockType {
+        MUTEX,
+        READ,
+        WRITE,
+        CONDITION
+      };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of buckets of the wait times. bucket i counts the waits
+/// shorter than 2^i microseconds, the last one all longer waits
+////////////////////////////////////////////////////////////////////////////////
+
+      static size_t const NumWaitBuckets = 22;
+
+      void addWait (uint64_t nanoseconds) {
+        uint64_t micros = nanoseconds / 1000;
+        size_t bucket = 0;
+
+        while (bucket < NumWaitBuckets - 1 && (uint64_t(1) << bucket) <= micros) {
+          ++bucket;
+        }
+
+        _acquisitions.fetch_add(1, std::memory_order_relaxed);
+        _waitTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+        _waitBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+      }
+
+      void addHold (uint64_t nanoseconds) {
+        _holdTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        uint64_t max = _maxHoldTime.load(std::memory_order_relaxed);
+
+        while (max < nanoseconds &&
+               ! _maxHoldTime.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+        }
+      }
+
+      void addConditionWait (uint64_t nanoseconds) {
+        _conditionWaits.fetch_add(1, std::memory_order_relaxed);
+        _conditionWaitTime.fetch_add(nanoseconds, std::memory_order_relaxed);
+      }
+
+      char const* _file;
+      int _line;
+      LockType _type;
+
+      std::atomic<uint64_t> _acquisitions;
+      std::atomic<uint64_t> _waitTime;
+      std::atomic<uint64_t> _waitBuckets[NumWaitBuckets];
+      std::atomic<uint64_t> _holdTime;
+      std::atomic<uint64_t> _maxHoldTime;
+      std::atomic<uint64_t> _conditionWaits;
+      std::atomic<uint64_t> _conditionWaitTime;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                class LockProfiler
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times of locks, by the place they are acquired at
+///
+/// only compiled in with TRI_ENABLE_LOCK_PROFILER. the lockers (MUTEX_LOCKER,
+/// READ_LOCKER, WRITE_LOCKER and CONDITION_LOCKER) then time every lock they
+/// acquire, and the collection lock macros use the functions below
+////////////////////////////////////////////////////////////////////////////////
+
+    class LockProfiler {
+
+      public:
+
+        LockProfiler () = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the profiler is compiled in
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool enabled ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the current time in nanoseconds
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t now () {
+          return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the site of a file and line, creating it if needed. the
+/// file must be a string literal
+////////////////////////////////////////////////////////////////////////////////
+
+        static LockSite* site (char const* file,
+                               int line,
+                               LockSite::LockType type);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records that the current thread acquired a lock that is released
+/// elsewhere, the hold time is recorded by released()
+////////////////////////////////////////////////////////////////////////////////
+
+        static void acquired (void const* lock,
+                              LockSite* site,
+                              uint64_t start);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records that the current thread released a lock
+////////////////////////////////////////////////////////////////////////////////
+
+        static void released (void const* lock);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief read-locks a lock and records it
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename T>
+        static void readLock (T& lock,
+                              char const* file,
+                              int line) {
+          uint64_t start = now();
+          lock.readLock();
+          acquired(&lock, site(file, line, LockSite::READ), start);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to read-lock a lock and records it
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename T, typename... Args>
+        static bool tryReadLock (T& lock,
+                                 char const* file,
+                                 int line,
+                                 Args... args) {
+          uint64_t start = now();
+
+          if (! lock.tryReadLock(args...)) {
+            return false;
+          }
+
+          acquired(&lock, site(file, line, LockSite::READ), start);
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief write-locks a lock and records it
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename T>
+        static void writeLock (T& lock,
+                               char const* file,
+                               int line) {
+          uint64_t start = now();
+          lock.writeLock();
+          acquired(&lock, site(file, line, LockSite::WRITE), start);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tries to write-lock a lock and records it
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename T, typename... Args>
+        static bool tryWriteLock (T& lock,
+                                  char const* file,
+                                  int line,
+                                  Args... args) {
+          uint64_t start = now();
+
+          if (! lock.tryWriteLock(args...)) {
+            return false;
+          }
+
+          acquired(&lock, site(file, line, LockSite::WRITE), start);
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unlocks a lock and records it
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename T>
+        static void unlock (T& lock) {
+          released(&lock);
+          lock.unlock();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief clears the statistics of all sites
+////////////////////////////////////////////////////////////////////////////////
+
+        static void reset ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the statistics, sorted by the total wait time
+////////////////////////////////////////////////////////////////////////////////
+
+        static Json toJson ();
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   class LockTimer
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief times a lock held by a locker
+////////////////////////////////////////////////////////////////////////////////
+
+    class LockTimer {
+
+      public:
+
+        LockTimer ()
+          : _site(nullptr),
+            _start(0) {
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called before the lock is acquired
+////////////////////////////////////////////////////////////////////////////////
+
+        void acquire (char const* file,
+                      int line,
+                      LockSite::LockType type) {
+          _site = LockProfiler::site(file, line, type);
+          _start = LockProfiler::now();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called before the lock is acquired again
+////////////////////////////////////////////////////////////////////////////////
+
+        void reacquire () {
+          _start = LockProfiler::now();
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called once the lock is acquired
+////////////////////////////////////////////////////////////////////////////////
+
+        void acquired () {
+          uint64_t now = LockProfiler::now();
+          _site->addWait(now - _start);
+          _start = now;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called once the lock is released
+////////////////////////////////////////////////////////////////////////////////
+
+        void released () {
+          _site->addHold(LockProfiler::now() - _start);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called before waiting on a condition, which releases the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void waiting () {
+          uint64_t now = LockProfiler::now();
+          _site->addHold(now - _start);
+          _start = now;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief called after waiting on a condition, which reacquired the lock
+////////////////////////////////////////////////////////////////////////////////
+
+        void waited () {
+          uint64_t now = LockProfiler::now();
+          _site->addConditionWait(now - _start);
+          _start = now;
+        }
+
+      private:
+
+        LockSite* _site;
+
+        uint64_t _start;
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hash tree over the keys and revisions of a collection
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_MERKLE_TREE_H
+#define ARANGODB_BASICS_MERKLE_TREE_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  class MerkleTree
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a complete binary hash tree of fixed depth over (key, revision)
+/// pairs
+///
+/// an entry is assigned to a leaf by the hash of its key only, so a new
+/// revision of a document stays in the same leaf. every node stores the
+/// number of entries below it and the XOR of their entry hashes. XOR makes
+/// the tree independent of the order of operations, and inserting or removing
+/// an entry only touches the nodes on the path from its leaf to the root.
+///
+/// the node at index i of level l covers the leaves of all trees with a depth
+/// of at least l whose top l bits of the bucket hash are i, so trees of
+/// different depths can be compared down to the smaller depth.
+////////////////////////////////////////////////////////////////////////////////
+
+    class MerkleTree {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+        struct Node {
+          uint64_t _hash;
+          uint64_t _count;
+
+          bool operator== (Node const& other) const {
+            return _hash == other._hash && _count == other._count;
+          }
+
+          bool operator!= (Node const& other) const {
+            return ! operator==(other);
+          }
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the smallest and the largest supported depth
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const MinDepth = 6;
+        static uint32_t const MaxDepth = 18;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+        explicit MerkleTree (uint32_t depth)
+          : _depth(depth),
+            _nodes((static_cast<size_t>(2) << depth) - 1, Node({ 0, 0 })) {
+
+          TRI_ASSERT(depth >= MinDepth && depth <= MaxDepth);
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the depth of the tree. the leaves are on this level
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t depth () const {
+          return _depth;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of entries
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t count () const {
+          return _nodes[0]._count;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the leaves hold too many entries on average, so that the
+/// tree should be rebuilt with depthForCount()
+////////////////////////////////////////////////////////////////////////////////
+
+        bool isOverfull () const {
+          return (_depth < MaxDepth &&
+                  count() > (static_cast<uint64_t>(EntriesPerLeaf) << (_depth + 2)));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a node. level 0 is the root
+////////////////////////////////////////////////////////////////////////////////
+
+        Node const& node (uint32_t level,
+                          uint64_t index) const {
+          TRI_ASSERT(level <= _depth);
+          TRI_ASSERT(index < (static_cast<uint64_t>(1) << level));
+
+          return _nodes[static_cast<size_t>(((static_cast<uint64_t>(1) << level) - 1) + index)];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an entry
+////////////////////////////////////////////////////////////////////////////////
+
+        void insert (uint64_t keyHash,
+                     uint64_t revision) {
+          update(keyHash, revision, true);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes an entry that was added before
+////////////////////////////////////////////////////////////////////////////////
+
+        void remove (uint64_t keyHash,
+                     uint64_t revision) {
+          update(keyHash, revision, false);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all entries
+////////////////////////////////////////////////////////////////////////////////
+
+        void clear () {
+          std::fill(_nodes.begin(), _nodes.end(), Node({ 0, 0 }));
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the memory used by the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t memory () const {
+          return sizeof(MerkleTree) + _nodes.size() * sizeof(Node);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the index of the node on the given level that an entry
+/// with the key hash belongs to
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t bucket (uint32_t level,
+                                uint64_t keyHash) {
+          if (level == 0) {
+            return 0;
+          }
+
+          return mix(keyHash) >> (64 - level);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a good depth for a tree with the given number of entries
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t depthForCount (uint64_t count) {
+          uint32_t depth = MinDepth;
+
+          while (depth < MaxDepth &&
+                 (static_cast<uint64_t>(EntriesPerLeaf) << depth) < count) {
+            ++depth;
+          }
+
+          return depth;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds or removes an entry
+////////////////////////////////////////////////////////////////////////////////
+
+        void update (uint64_t keyHash,
+                     uint64_t revision,
+                     bool isInsert) {
+          uint64_t const hash = mix(keyHash ^ mix(revision));
+          uint64_t const leaf = bucket(_depth, keyHash);
+
+          for (uint32_t level = 0; level <= _depth; ++level) {
+            Node& n = _nodes[static_cast<size_t>(((static_cast<uint64_t>(1) << level) - 1) + (leaf >> (_depth - level)))];
+
+            n._hash ^= hash;
+
+            if (isInsert) {
+              ++n._count;
+            }
+            else {
+              TRI_ASSERT(n._count > 0);
+              --n._count;
+            }
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief spreads the bits of a value over all 64 bits
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t mix (uint64_t value) {
+          value ^= value >> 33;
+          value *= 0xff51afd7ed558ccdULL;
+          value ^= value >> 33;
+          value *= 0xc4ceb9fe1a85ec53ULL;
+          value ^= value >> 33;
+          return value;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries per leaf depthForCount() aims at
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const EntriesPerLeaf = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the depth of the tree
+////////////////////////////////////////////////////////////////////////////////
+
+        uint32_t const _depth;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the nodes, level by level, starting with the root
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<Node> _nodes;
+
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -46,14 +46,26 @@ using namespace triagens::basics;
 /// The constructor aquires a lock, the destructors releases the lock.
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 MutexLocker::MutexLocker (Mutex* mutex, char const* file, int line)
-  : _mutex(mutex), _file(file), _line(line), _time(0.0) {
-  
+  : _mutex(mutex), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::MUTEX);
+#endif
+
   _mutex->lock();
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else
@@ -73,6 +85,10 @@ MutexLocker::MutexLocker (Mutex* mutex)
 MutexLocker::~MutexLocker () {
   _mutex->unlock();
 
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.released();
+#endif
+
 #ifdef TRI_SHOW_LOCK_TIME
   if (_time > TRI_SHOW_LOCK_THRESHOLD) {
     LOG_WARNING("MutexLocker %s:%d took %f s", _file, _line, _time);
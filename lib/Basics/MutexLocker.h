@@ -32,6 +32,7 @@
 #define ARANGODB_BASICS_MUTEX_LOCKER_H 1
 
 #include "Basics/Common.h"
+#include "Basics/LockProfiler.h"
 #include "Basics/Mutex.h"
 
 // -----------------------------------------------------------------------------
@@ -48,7 +49,7 @@
 #define MUTEX_LOCKER_VAR_A(a) _mutex_lock_variable_ ## a
 #define MUTEX_LOCKER_VAR_B(a) MUTEX_LOCKER_VAR_A(a)
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 #define MUTEX_LOCKER(b) \
   triagens::basics::MutexLocker MUTEX_LOCKER_VAR_B(__LINE__)(&b, __FILE__, __LINE__)
@@ -90,7 +91,7 @@ namespace triagens {
 /// The constructor aquires a lock, the destructor releases the lock.
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
         MutexLocker (Mutex* mutex, char const* file, int line);
 
@@ -119,7 +120,7 @@ namespace triagens {
 
         Mutex* _mutex;
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief file
@@ -133,12 +134,26 @@ namespace triagens {
 
         int _line;
 
+#endif
+
+#ifdef TRI_SHOW_LOCK_TIME
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief lock time
 ////////////////////////////////////////////////////////////////////////////////
 
         double _time;
 
+#endif
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times
+////////////////////////////////////////////////////////////////////////////////
+
+        LockTimer _timer;
+
 #endif        
     };
   }
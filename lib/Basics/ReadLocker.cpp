@@ -46,40 +46,94 @@ using namespace triagens::basics;
 /// The constructors read-lock the lock, the destructors unlock the lock.
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 ReadLocker::ReadLocker (ReadWriteLock* readWriteLock, char const* file, int line)
-  : _readWriteLock(readWriteLock), _file(file), _line(line) {
-  
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::READ);
+#endif
+
   _readWriteLock->readLock();
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else 
 
 ReadLocker::ReadLocker (ReadWriteLock* readWriteLock)
-  : _readWriteLock(readWriteLock) {
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr) {
   
   _readWriteLock->readLock();
 }
 
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aquires a read-lock on a distributed read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef TRI_TRACK_LOCK_SITES
+
+ReadLocker::ReadLocker (DistributedReadWriteLock* readWriteLock, char const* file, int line)
+  : _readWriteLock(nullptr), _distributedLock(readWriteLock), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
+  double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::READ);
+#endif
+
+  _distributedLock->readLock();
+
+#ifdef TRI_SHOW_LOCK_TIME
+  _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
+}
+
+#else
+
+ReadLocker::ReadLocker (DistributedReadWriteLock* readWriteLock)
+  : _readWriteLock(nullptr), _distributedLock(readWriteLock) {
+
+  _distributedLock->readLock();
+}
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief aquires a read-lock, with periodic sleeps while not acquired
 /// sleep time is specified in nanoseconds
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 ReadLocker::ReadLocker (ReadWriteLock* readWriteLock, 
                         uint64_t sleepTime,
                         char const* file,
                         int line) 
-  : _readWriteLock(readWriteLock), _file(file), _line(line) {
-  
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::READ);
+#endif
+
   while (! _readWriteLock->tryReadLock()) {
 #ifdef _WIN32
     usleep((unsigned long) sleepTime);
@@ -87,14 +141,20 @@ ReadLocker::ReadLocker (ReadWriteLock* readWriteLock,
     usleep((useconds_t) sleepTime);
 #endif
   }
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else
 
 ReadLocker::ReadLocker (ReadWriteLock* readWriteLock, 
                         uint64_t sleepTime) 
-  : _readWriteLock(readWriteLock) {
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr) {
   
   while (! _readWriteLock->tryReadLock()) {
 #ifdef _WIN32
@@ -112,7 +172,16 @@ ReadLocker::ReadLocker (ReadWriteLock* readWriteLock,
 ////////////////////////////////////////////////////////////////////////////////
 
 ReadLocker::~ReadLocker () {
-  _readWriteLock->unlock();
+  if (_distributedLock != nullptr) {
+    _distributedLock->unlock();
+  }
+  else {
+    _readWriteLock->unlock();
+  }
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.released();
+#endif
 
 #ifdef TRI_SHOW_LOCK_TIME
   if (_time > TRI_SHOW_LOCK_THRESHOLD) {
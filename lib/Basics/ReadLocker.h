@@ -32,6 +32,8 @@
 #define ARANGODB_BASICS_READ_LOCKER_H 1
 
 #include "Basics/Common.h"
+#include "Basics/DistributedReadWriteLock.h"
+#include "Basics/LockProfiler.h"
 #include "Basics/ReadWriteLock.h"
 
 // -----------------------------------------------------------------------------
@@ -48,7 +50,7 @@
 #define READ_LOCKER_VAR_A(a) _read_lock_variable ## a
 #define READ_LOCKER_VAR_B(a) READ_LOCKER_VAR_A(a)
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 #define READ_LOCKER(b) \
   triagens::basics::ReadLocker READ_LOCKER_VAR_B(__LINE__)(&b, __FILE__, __LINE__)
@@ -96,7 +98,7 @@ namespace triagens {
 /// The constructors read-locks the lock, the destructors unlocks the lock.
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
         ReadLocker (ReadWriteLock* readWriteLock, char const* file, int line);
 
@@ -107,12 +109,27 @@ namespace triagens {
 
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aquires a read-lock on a distributed read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef TRI_TRACK_LOCK_SITES
+
+        ReadLocker (DistributedReadWriteLock* readWriteLock, char const* file, int line);
+
+#else
+
+        explicit
+        ReadLocker (DistributedReadWriteLock*);
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief aquires a read-lock, with periodic sleeps while not acquired
 /// sleep time is specified in nanoseconds
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
         ReadLocker (ReadWriteLock* readWriteLock, uint64_t sleepDelay, char const* file, int line);
 
@@ -140,7 +157,13 @@ namespace triagens {
 
         ReadWriteLock* _readWriteLock;
 
-#ifdef TRI_SHOW_LOCK_TIME
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the distributed read-write lock, if used instead
+////////////////////////////////////////////////////////////////////////////////
+
+        DistributedReadWriteLock* _distributedLock;
+
+#ifdef TRI_TRACK_LOCK_SITES
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief file
@@ -154,12 +177,26 @@ namespace triagens {
 
         int _line;
 
+#endif
+
+#ifdef TRI_SHOW_LOCK_TIME
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief lock time
 ////////////////////////////////////////////////////////////////////////////////
 
         double _time;
 
+#endif
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief wait and hold times
+////////////////////////////////////////////////////////////////////////////////
+
+        LockTimer _timer;
+
 #endif        
 
     };
@@ -31,6 +31,7 @@
 
 #include "Basics/Common.h"
 
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
@@ -66,7 +67,7 @@ namespace triagens {
 
       public:
 
-        ReadWriteLockCPP11 () : _state(0), _wantWrite(false) {
+        ReadWriteLockCPP11 () : _state(0), _wantWrite(0) {
         }
 
 // -----------------------------------------------------------------------------
@@ -83,13 +84,13 @@ namespace triagens {
             _state = -1;
             return;
           }
+          ++_wantWrite;
           do {
-            _wantWrite = true;
             _bell.wait(guard);
           }
           while (_state != 0);
           _state = -1;
-          _wantWrite = false;
+          --_wantWrite;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -106,23 +107,37 @@ namespace triagens {
         }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief locks for reading
+/// @brief locks for writing, waits at most the given time
+///
+/// Unlike writeLock, a waiting caller does not keep new readers out, so
+/// this behaves like tryWriteLock called in a loop, but it wakes up as soon
+/// as the lock is released instead of sleeping for a fixed period.
 ////////////////////////////////////////////////////////////////////////////////
 
-        void readLock () {
+        bool tryWriteLock (std::chrono::microseconds timeout) {
+          auto const deadline = std::chrono::steady_clock::now() + timeout;
           std::unique_lock<std::mutex> guard(_mut);
-          if (! _wantWrite && _state >= 0) {
-            _state += 1;
-            return;
-          }
-          while (true) {
-            while (_wantWrite || _state < 0) {
-              _bell.wait(guard);
-            }
-            if (! _wantWrite) {
+          while (_state != 0) {
+            if (_bell.wait_until(guard, deadline) == std::cv_status::timeout) {
+              if (_state != 0) {
+                return false;
+              }
               break;
             }
           }
+          _state = -1;
+          return true;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for reading
+////////////////////////////////////////////////////////////////////////////////
+
+        void readLock () {
+          std::unique_lock<std::mutex> guard(_mut);
+          while (_wantWrite > 0 || _state < 0) {
+            _bell.wait(guard);
+          }
           _state += 1;
         }
 
@@ -132,13 +147,32 @@ namespace triagens {
 
         bool tryReadLock () {
           std::unique_lock<std::mutex> guard(_mut);
-          if (! _wantWrite && _state >= 0) {
+          if (_wantWrite == 0 && _state >= 0) {
             _state += 1;
             return true;
           }
           return false;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief locks for reading, waits at most the given time
+////////////////////////////////////////////////////////////////////////////////
+
+        bool tryReadLock (std::chrono::microseconds timeout) {
+          auto const deadline = std::chrono::steady_clock::now() + timeout;
+          std::unique_lock<std::mutex> guard(_mut);
+          while (_wantWrite > 0 || _state < 0) {
+            if (_bell.wait_until(guard, deadline) == std::cv_status::timeout) {
+              if (_wantWrite > 0 || _state < 0) {
+                return false;
+              }
+              break;
+            }
+          }
+          _state += 1;
+          return true;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief releases the read-lock or write-lock
 ////////////////////////////////////////////////////////////////////////////////
@@ -183,10 +217,10 @@ namespace triagens {
         int _state;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief _wantWrite, is set if somebody is waiting for the write lock
+/// @brief _wantWrite, number of threads blocked in writeLock
 ////////////////////////////////////////////////////////////////////////////////
 
-        bool _wantWrite;
+        int _wantWrite;
 
     };
   }
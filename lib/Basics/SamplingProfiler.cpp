@@ -0,0 +1,431 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timer-based sampling of thread stacks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "SamplingProfiler.h"
+#include "Basics/logging.h"
+
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+#include <atomic>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+using namespace triagens::basics;
+
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a recorded stack, innermost frame first
+////////////////////////////////////////////////////////////////////////////////
+
+  struct Sample {
+    char _role[SamplingProfiler::RoleLength];
+    size_t _depth;
+    void* _frames[SamplingProfiler::MaxDepth];
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the frames of the signal handler and the signal trampoline
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const HandlerFrames = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the role of the current thread, empty for threads not started by
+/// TRI_StartThread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local char ThreadRole[SamplingProfiler::RoleLength];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a profile is running, only one can run at a time
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<bool> Running(false);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the signal handler records samples
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<bool> Active(false);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of signal handlers currently executing
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int> InFlight(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the samples of the running profile
+////////////////////////////////////////////////////////////////////////////////
+
+static Sample* Samples = nullptr;
+
+static size_t NumSamples = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the next free sample, counts the dropped samples beyond the end
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<size_t> NextSample(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the signal handler is installed. it is never removed again:
+/// a SIGPROF that is still pending when the timer has been stopped would
+/// otherwise terminate the process
+////////////////////////////////////////////////////////////////////////////////
+
+static bool HandlerInstalled = false;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief records the stack of the interrupted thread. only uses the atomics
+/// and the preallocated samples, backtrace() has been called once before so
+/// it does not need to load libgcc here
+////////////////////////////////////////////////////////////////////////////////
+
+static void SignalHandler (int) {
+  int const savedErrno = errno;
+
+  InFlight.fetch_add(1);
+
+  if (Active.load()) {
+    size_t const slot = NextSample.fetch_add(1, std::memory_order_relaxed);
+
+    if (slot < NumSamples) {
+      Sample& sample = Samples[slot];
+      void* frames[SamplingProfiler::MaxDepth + HandlerFrames];
+
+      int n = backtrace(frames, static_cast<int>(SamplingProfiler::MaxDepth + HandlerFrames));
+      size_t depth = 0;
+
+      for (int i = static_cast<int>(HandlerFrames);  i < n;  ++i) {
+        sample._frames[depth++] = frames[i];
+      }
+
+      sample._depth = depth;
+
+      for (size_t i = 0;  i < SamplingProfiler::RoleLength;  ++i) {
+        sample._role[i] = ThreadRole[i];
+      }
+    }
+  }
+
+  InFlight.fetch_sub(1);
+
+  errno = savedErrno;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the name of a code address. names cannot contain a semicolon, which
+/// separates the frames of a folded stack
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string Symbolize (void* address) {
+  std::string name;
+  Dl_info info;
+  char buffer[32];
+
+  bool const found = (dladdr(address, &info) != 0);
+
+  if (found && info.dli_sname != nullptr) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+
+    if (status == 0 && demangled != nullptr) {
+      name = demangled;
+    }
+    else {
+      name = info.dli_sname;
+    }
+
+    free(demangled);
+  }
+  else if (found && info.dli_fname != nullptr && info.dli_fbase != nullptr) {
+    char const* file = strrchr(info.dli_fname, '/');
+
+    snprintf(buffer, sizeof(buffer), "+0x%llx",
+             (unsigned long long) (static_cast<char*>(address) - static_cast<char*>(info.dli_fbase)));
+
+    name = (file == nullptr ? info.dli_fname : file + 1);
+    name.append(buffer);
+  }
+  else {
+    snprintf(buffer, sizeof(buffer), "0x%llx", (unsigned long long) (uintptr_t) address);
+    name = buffer;
+  }
+
+  for (auto& c : name) {
+    if (c == ';') {
+      c = ':';
+    }
+  }
+
+  return name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief folds the samples, the most frequent stacks first
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string Fold (Sample const* samples,
+                         size_t n) {
+  std::unordered_map<void*, std::string> symbols;
+  std::unordered_map<std::string, uint64_t> stacks;
+
+  for (size_t i = 0;  i < n;  ++i) {
+    Sample const& sample = samples[i];
+    std::string stack(sample._role[0] == '\0' ? "other" : sample._role);
+
+    for (size_t j = sample._depth;  j > 0;  --j) {
+      void* address = sample._frames[j - 1];
+      auto it = symbols.find(address);
+
+      if (it == symbols.end()) {
+        it = symbols.emplace(address, Symbolize(address)).first;
+      }
+
+      stack.push_back(';');
+      stack.append((*it).second);
+    }
+
+    ++stacks[stack];
+  }
+
+  std::vector<std::pair<std::string, uint64_t>> sorted(stacks.begin(), stacks.end());
+
+  std::sort(sorted.begin(), sorted.end(), [] (std::pair<std::string, uint64_t> const& lhs,
+                                              std::pair<std::string, uint64_t> const& rhs) {
+    return (lhs.second > rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first));
+  });
+
+  std::string result;
+
+  for (auto const& it : sorted) {
+    result.append(it.first);
+    result.push_back(' ');
+    result.append(std::to_string(it.second));
+    result.push_back('\n');
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the profiling timer, an interval of 0 stops it
+////////////////////////////////////////////////////////////////////////////////
+
+static int SetTimer (uint64_t interval) {
+  struct itimerval timer;
+
+  timer.it_interval.tv_sec = static_cast<time_t>(interval / 1000000);
+  timer.it_interval.tv_usec = static_cast<suseconds_t>(interval % 1000000);
+  timer.it_value = timer.it_interval;
+
+  return setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class SamplingProfiler
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the profiler is available on this platform
+////////////////////////////////////////////////////////////////////////////////
+
+bool SamplingProfiler::enabled () {
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+  return true;
+#else
+  return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the role the samples of the current thread are labelled with
+////////////////////////////////////////////////////////////////////////////////
+
+void SamplingProfiler::setThreadRole (char const* name) {
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+  if (*name == '[') {
+    ++name;
+  }
+
+  size_t n = 0;
+
+  while (name[n] != '\0' && name[n] != ']' && n < RoleLength - 1) {
+    // the role is a frame of the folded stacks as well
+    ThreadRole[n] = (name[n] == ';' || name[n] == ' ' ? '_' : name[n]);
+    ++n;
+  }
+
+  ThreadRole[n] = '\0';
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief samples for the given number of seconds and returns the folded
+/// stacks
+////////////////////////////////////////////////////////////////////////////////
+
+int SamplingProfiler::profile (double seconds,
+                               uint32_t frequency,
+                               std::string& folded,
+                               uint64_t& samples,
+                               uint64_t& dropped) {
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+  TRI_ASSERT(seconds > 0.0);
+  TRI_ASSERT(frequency > 0);
+
+  bool expected = false;
+
+  if (! Running.compare_exchange_strong(expected, true)) {
+    return TRI_ERROR_LOCKED;
+  }
+
+  struct RunningGuard {
+    ~RunningGuard () {
+      Running.store(false);
+    }
+  } guard;
+
+  // room for a few busy threads, more samples are dropped
+  double const wanted = seconds * static_cast<double>(frequency) * 8.0;
+  size_t const n = (wanted >= static_cast<double>(MaxSamples) ? MaxSamples : static_cast<size_t>(wanted) + 1);
+
+  std::unique_ptr<Sample[]> buffer(new (std::nothrow) Sample[n]);
+
+  if (buffer == nullptr) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  Samples = buffer.get();
+  NumSamples = n;
+  NextSample.store(0);
+
+  // the first call of backtrace() loads libgcc, which must not happen in
+  // the signal handler
+  void* frames[1];
+  backtrace(frames, 1);
+
+  if (! HandlerInstalled) {
+    struct sigaction action;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &SignalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+      TRI_set_errno(TRI_ERROR_SYS_ERROR);
+      LOG_ERROR("cannot install profiling signal handler: %s", strerror(errno));
+      return TRI_ERROR_SYS_ERROR;
+    }
+
+    HandlerInstalled = true;
+  }
+
+  Active.store(true);
+
+  uint64_t const interval = (std::max)(uint64_t(1), uint64_t(1000000) / frequency);
+
+  if (SetTimer(interval) != 0) {
+    Active.store(false);
+    TRI_set_errno(TRI_ERROR_SYS_ERROR);
+    LOG_ERROR("cannot start profiling timer: %s", strerror(errno));
+    return TRI_ERROR_SYS_ERROR;
+  }
+
+  LOG_INFO("sampling thread stacks for %.1f s at %lu Hz", seconds, (unsigned long) frequency);
+
+  // the sleep is interrupted whenever this thread receives a signal
+  double const end = TRI_microtime() + seconds;
+  double now;
+
+  while ((now = TRI_microtime()) < end) {
+    usleep(static_cast<unsigned long>((end - now) * 1000000.0));
+  }
+
+  SetTimer(0);
+  Active.store(false);
+
+  // wait for handlers still writing a sample
+  while (InFlight.load() != 0) {
+    usleep(1000);
+  }
+
+  size_t const taken = NextSample.load();
+
+  samples = (std::min)(taken, n);
+  dropped = taken - samples;
+
+  Samples = nullptr;
+  NumSamples = 0;
+
+  try {
+    folded = Fold(buffer.get(), static_cast<size_t>(samples));
+  }
+  catch (...) {
+    return TRI_ERROR_OUT_OF_MEMORY;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+#else
+  return TRI_ERROR_NOT_IMPLEMENTED;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief timer-based sampling of thread stacks
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_SAMPLING_PROFILER_H
+#define ARANGODB_BASICS_SAMPLING_PROFILER_H 1
+
+#include "Basics/Common.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     public macros
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether stacks can be sampled, this needs POSIX timers and signals
+/// and backtrace(3)
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(TRI_HAVE_POSIX_THREADS) && (defined(__GLIBC__) || defined(__APPLE__))
+#define TRI_HAVE_SAMPLING_PROFILER 1
+#endif
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            class SamplingProfiler
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief samples the stacks of the threads consuming CPU
+///
+/// while a profile runs, a profiling timer (ITIMER_PROF) sends SIGPROF to the
+/// process at the requested frequency of consumed CPU time, and the handler
+/// records the stack of the thread that received it together with the role
+/// of the thread, which is the name it was started with. idle threads are
+/// not sampled. the stacks are symbolized after the profile has ended and
+/// returned as folded stacks ("role;outer;...;inner count"), which flame
+/// graph tools read directly
+///
+/// functions are named from the dynamic symbol table, so functions of the
+/// executable itself only have names if it was linked with -rdynamic. all
+/// others are written as offsets into their object file, which addr2line
+/// translates
+////////////////////////////////////////////////////////////////////////////////
+
+    class SamplingProfiler {
+
+      public:
+
+        SamplingProfiler () = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public constants
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal length of a thread role, including the terminator
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const RoleLength = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal number of frames recorded per sample
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxDepth = 48;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the maximal number of samples of a profile, further samples are
+/// counted as dropped
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const MaxSamples = 65536;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             public static methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the profiler is available on this platform
+////////////////////////////////////////////////////////////////////////////////
+
+        static bool enabled ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the role the samples of the current thread are labelled
+/// with. the brackets of thread names like "[scheduler]" are removed
+////////////////////////////////////////////////////////////////////////////////
+
+        static void setThreadRole (char const* name);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief samples for the given number of seconds and returns the folded
+/// stacks. blocks the calling thread meanwhile. returns TRI_ERROR_LOCKED if
+/// another profile is running
+////////////////////////////////////////////////////////////////////////////////
+
+        static int profile (double seconds,
+                            uint32_t frequency,
+                            std::string& folded,
+                            uint64_t& samples,
+                            uint64_t& dropped);
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -31,7 +31,10 @@
 #define ARANGODB_BASICS_C_SKIP__LIST_H 1
 
 #include "Basics/Common.h"
+#include "Basics/DataProtector.h"
 #include "Basics/JsonHelper.h"
+#include "Basics/Mutex.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/random.h"
 
 // We will probably never see more than 2^48 documents in a skip list
@@ -50,6 +53,11 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief type of a skiplist node
+///
+/// the links of a node are atomic, because readers traverse the skiplist
+/// without taking any lock while a writer modifies it. a writer publishes
+/// a fully initialized node with a release store into its predecessor's
+/// link, readers follow links with acquire loads
 ////////////////////////////////////////////////////////////////////////////////
 
     template<class Key, class Element>
@@ -58,20 +66,20 @@ namespace triagens {
     template<class Key, class Element>
     class SkipListNode {
       friend class SkipList<Key, Element>;
-        SkipListNode<Key, Element>** _next;
-        SkipListNode<Key, Element>* _prev;
+        std::atomic<SkipListNode<Key, Element>*>* _next;
+        std::atomic<SkipListNode<Key, Element>*> _prev;
         Element* _doc;
         int _height;
 
       public:
 
         SkipListNode<Key, Element> (int height, char* ptr) 
-          : _next(reinterpret_cast<SkipListNode<Key, Element>**>(ptr + sizeof(SkipListNode<Key, Element>))),
+          : _next(reinterpret_cast<std::atomic<SkipListNode<Key, Element>*>*>(ptr + sizeof(SkipListNode<Key, Element>))),
             _prev(nullptr),
             _doc(nullptr),
             _height(height) {
               for (int i = 0; i < _height; i++) {
-                _next[i] = nullptr;
+                new (&_next[i]) std::atomic<SkipListNode<Key, Element>*>(nullptr);
               }
             }
 
@@ -84,14 +92,14 @@ namespace triagens {
             // _next[0] is uninitialized
             return nullptr;
           }
-          return _next[0];
+          return _next[0].load(std::memory_order_acquire);
         }
 
         // Note that the prevNode of the first data node is the artificial
         // _start node not containing data. This is contrary to the prevNode
         // method of the SkipList class, which returns nullptr in that case.
         SkipListNode<Key, Element>* prevNode () const {
-          return _prev;
+          return _prev.load(std::memory_order_acquire);
         }
     };
 
@@ -110,6 +118,15 @@ namespace triagens {
 /// _end always points to the last node in the skiplist, this can be the
 /// same as the _start node. If a node does not have a successor on a certain
 /// level, then the corresponding _next pointer is a nullptr.
+///
+/// Readers (all lookups and the node navigation methods) do not take any
+/// lock and can run concurrently with each other and with one writer.
+/// Writers (insert and remove) are serialized by an internal mutex.
+/// A removed node is unlinked immediately, but it and its document are
+/// only freed by reclaim(), once no reader that might still see them is
+/// active any more. Readers that keep node pointers beyond a single call
+/// (such as iterators) must hold the guard returned by readProtect() for
+/// as long as they use them.
 ////////////////////////////////////////////////////////////////////////////////
 
     template <class Key, class Element>
@@ -149,16 +166,30 @@ namespace triagens {
       private:
 
         Node* _start;
-        Node* _end;
+        std::atomic<Node*> _end;
+        std::atomic<int> _height;   // current height of the _start node
         CmpElmElmFuncType      _cmp_elm_elm;
         CmpKeyElmFuncType      _cmp_key_elm;
         FreeElementFuncType    _free;
         bool _unique;     // indicates whether multiple entries that
                           // are equal in the preorder are allowed in
-        uint64_t _nrUsed;
+        std::atomic<uint64_t> _nrUsed;
         bool _isArray;    // indicates whether this index is used to
                           // index arrays.
-        size_t _memoryUsed;
+        std::atomic<size_t> _memoryUsed;
+
+        // the zone the nodes are allocated in
+        TRI_memory_zone_t* _memoryZone;
+
+        // serializes all writers
+        triagens::basics::Mutex _writeLock;
+
+        // tracks the readers, so unlinked nodes can be freed safely
+        mutable triagens::basics::DataProtector _readers;
+
+        // unlinked nodes waiting to be freed, protected by _reclaimLock
+        triagens::basics::Mutex _reclaimLock;
+        std::vector<Node*> _garbage;
 
       public:
 
@@ -177,20 +208,18 @@ namespace triagens {
                   CmpKeyElmFuncType   cmp_key_elm,
                   FreeElementFuncType freefunc,
                   bool unique,
-                  bool isArray)
-          : _cmp_elm_elm(cmp_elm_elm), _cmp_key_elm(cmp_key_elm), 
-            _free(freefunc), _unique(unique), _nrUsed(0), _isArray(isArray) {
-
-          // Set the initial memory
-          _memoryUsed = sizeof(SkipList);
-
+                  bool isArray,
+                  TRI_memory_zone_t* memoryZone = TRI_UNKNOWN_MEM_ZONE)
+          : _start(nullptr), _end(nullptr), _height(1),
+            _cmp_elm_elm(cmp_elm_elm), _cmp_key_elm(cmp_key_elm), 
+            _free(freefunc), _unique(unique), _nrUsed(0), _isArray(isArray),
+            _memoryUsed(sizeof(SkipList)), _memoryZone(memoryZone) {
+
+          // all links of the _start node are initialized with nullptr, only
+          // the lowest _height of them are in use
           _start = allocNode(TRI_SKIPLIST_MAX_HEIGHT);
             // Note that this can throw
           _end = _start;
-
-          _start->_height = 1;
-          _start->_next[0] = nullptr;
-          _start->_prev = nullptr;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -201,13 +230,16 @@ namespace triagens {
           Node* p;
           Node* next;
 
+          // no reader can be active any more, so free the removed nodes
+          freeGarbage(_garbage);
+
           // First call free for all documents and free all nodes other than start:
-          p = _start->_next[0];
+          p = _start->_next[0].load(std::memory_order_relaxed);
           while (nullptr != p) {
             if (nullptr != _free) {
               _free(p->_doc);
             }
-            next = p->_next[0];
+            next = p->_next[0].load(std::memory_order_relaxed);
             freeNode(p);
             p = next;
           }
@@ -246,7 +278,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         Node* nextNode (Node* node) const {
-          return node->_next[0];
+          return node->_next[0].load(std::memory_order_acquire);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -256,7 +288,18 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         Node* prevNode (Node* node) const {
-          return nullptr == node ? _end : node->_prev;
+          return nullptr == node ? _end.load(std::memory_order_acquire) 
+                                 : node->_prev.load(std::memory_order_acquire);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief registers a reader. nodes returned by lookups and navigation
+/// remain valid until the returned guard is destroyed, even if they are
+/// removed from the skiplist in the meantime
+////////////////////////////////////////////////////////////////////////////////
+
+        triagens::basics::DataProtector::UnUser readProtect () const {
+          return _readers.use();
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -279,6 +322,8 @@ namespace triagens {
           Node* newNode;
           int cmp;
 
+          MUTEX_LOCKER(_writeLock);
+
           cmp = lookupLess(doc,&pos,&next,SKIPLIST_CMP_TOTORDER);
           // Now pos[0] points to the largest node whose document is less than
           // doc. next is the next node and can be nullptr if there is none. doc is
@@ -306,35 +351,43 @@ namespace triagens {
             return TRI_ERROR_OUT_OF_MEMORY;
           }
 
-          if (newNode->_height > _start->_height) {
+          int const height = _height.load(std::memory_order_relaxed);
+
+          if (newNode->_height > height) {
             // The new levels where not considered in the above search,
             // therefore pos is not set on these levels.
-            for (lev = _start->_height; lev < newNode->_height; lev++) {
+            for (lev = height; lev < newNode->_height; lev++) {
               pos[lev] = _start;
             }
             // Note that _start is already initialized with nullptr to the top!
-            _start->_height = newNode->_height;
+            // A reader seeing the new height early only finds nullptr links
+            // on the new levels and goes down.
+            _height.store(newNode->_height, std::memory_order_release);
           }
 
           newNode->_doc = doc;
 
-          // Now insert between newNode and next:
-          newNode->_next[0] = pos[0]->_next[0];
-          pos[0]->_next[0] = newNode;
-          newNode->_prev = pos[0];
-          if (newNode->_next[0] == nullptr) {
+          // Now insert between newNode and next. All links of the new node
+          // are set before it is published with a release store on level 0:
+          next = pos[0]->_next[0].load(std::memory_order_relaxed);
+          newNode->_next[0].store(next, std::memory_order_relaxed);
+          newNode->_prev.store(pos[0], std::memory_order_relaxed);
+          pos[0]->_next[0].store(newNode, std::memory_order_release);
+
+          if (next == nullptr) {
             // a new last node
-            _end = newNode;
+            _end.store(newNode, std::memory_order_release);
           }
           else {
-            newNode->_next[0]->_prev = newNode;
+            next->_prev.store(newNode, std::memory_order_release);
           }
 
           // Now the element is successfully inserted, the rest is performance
           // optimisation:
           for (lev = 1; lev < newNode->_height; lev++) {
-            newNode->_next[lev] = pos[lev]->_next[lev];
-            pos[lev]->_next[lev] = newNode;
+            newNode->_next[lev].store(pos[lev]->_next[lev].load(std::memory_order_relaxed), 
+                                      std::memory_order_relaxed);
+            pos[lev]->_next[lev].store(newNode, std::memory_order_release);
           }
 
           _nrUsed++;
@@ -349,6 +402,7 @@ namespace triagens {
 /// Returns TRI_ERROR_NO_ERROR if all is well and
 /// TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND if the document was not found.
 /// In the latter two cases nothing is removed.
+/// The removed node and its document are freed by a later call to reclaim().
 ////////////////////////////////////////////////////////////////////////////////
 
         int remove (Element* doc) {
@@ -357,6 +411,8 @@ namespace triagens {
           Node* next = nullptr;  // to please the compiler
           int cmp;
 
+          MUTEX_LOCKER(_writeLock);
+
           cmp = lookupLess(doc,&pos,&next,SKIPLIST_CMP_TOTORDER);
           // Now pos[0] points to the largest node whose document is less than
           // doc. next points to the next node and can be nullptr if there is none.
@@ -367,8 +423,15 @@ namespace triagens {
             return TRI_ERROR_ARANGO_DOCUMENT_NOT_FOUND;
           }
 
-          if (nullptr != _free) {
-            _free(next->_doc);
+          MUTEX_LOCKER(_reclaimLock);
+
+          // reserve the garbage slot first, so that nothing can fail once
+          // the node is unlinked
+          try {
+            _garbage.reserve(_garbage.size() + 1);
+          }
+          catch (...) {
+            return TRI_ERROR_OUT_OF_MEMORY;
           }
 
           // Now delete where next points to:
@@ -376,18 +439,24 @@ namespace triagens {
             // Note the order from top to bottom. The element remains in the
             // skiplist as long as we are at a level > 0, only some optimisations
             // in performance vanish before that. Only when we have removed it at
-            // level 0, it is really gone.
-            pos[lev]->_next[lev] = next->_next[lev];
+            // level 0, it is really gone. The links of the removed node stay
+            // intact, so a reader currently on it can still move on.
+            pos[lev]->_next[lev].store(next->_next[lev].load(std::memory_order_relaxed),
+                                       std::memory_order_release);
           }
-          if (next->_next[0] == nullptr) {
+
+          Node* after = next->_next[0].load(std::memory_order_relaxed);
+          Node* before = next->_prev.load(std::memory_order_relaxed);
+
+          if (after == nullptr) {
             // We were the last, so adjust _end
-            _end = next->_prev;
+            _end.store(before, std::memory_order_release);
           }
           else {
-            next->_next[0]->_prev = next->_prev;
+            after->_prev.store(before, std::memory_order_release);
           }
 
-          freeNode(next);
+          _garbage.emplace_back(next);
 
           _nrUsed--;
 
@@ -399,7 +468,54 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 
         uint64_t getNrUsed () const {
-          return _nrUsed;
+          return _nrUsed.load(std::memory_order_relaxed);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees the nodes and documents removed so far, if no reader is
+/// active that could still see them. Returns the number of nodes freed.
+/// This never blocks on readers; if some are active, the nodes are kept
+/// for the next call
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t reclaim () {
+          std::vector<Node*> garbage;
+
+          {
+            MUTEX_LOCKER(_reclaimLock);
+            garbage.swap(_garbage);
+          }
+
+          if (garbage.empty()) {
+            return 0;
+          }
+
+          // all nodes in garbage are unlinked already. a reader that starts
+          // from now on cannot reach them, so it is sufficient to see every
+          // reader slot idle once
+          if (! _readers.isUnused()) {
+            bool kept = false;
+
+            try {
+              MUTEX_LOCKER(_reclaimLock);
+              _garbage.insert(_garbage.end(), garbage.begin(), garbage.end());
+              kept = true;
+            }
+            catch (...) {
+            }
+
+            if (kept) {
+              return 0;
+            }
+
+            // cannot keep the nodes, so wait for the readers instead
+            _readers.scan();
+          }
+
+          size_t const n = garbage.size();
+          freeGarbage(garbage);
+
+          return n;
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -423,7 +539,7 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
           
         void appendToJson (TRI_memory_zone_t* zone, Json& json) {
-          json("nrUsed", Json(static_cast<double>(_nrUsed)));
+          json("nrUsed", Json(static_cast<double>(getNrUsed())));
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -547,7 +663,7 @@ namespace triagens {
           }
 
           // allocate enough memory for skiplist node plus all the next nodes in one go
-          void* ptr = TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, sizeof(Node) + sizeof(Node*) * height, false);
+          void* ptr = TRI_Allocate(_memoryZone, sizeof(Node) + sizeof(std::atomic<Node*>) * height, false);
 
           if (ptr == nullptr) {
             THROW_ARANGO_EXCEPTION(TRI_ERROR_OUT_OF_MEMORY);
@@ -560,12 +676,12 @@ namespace triagens {
             newNode = new(ptr) Node(height, static_cast<char*>(ptr));
           }
           catch (...) {
-            TRI_Free(TRI_UNKNOWN_MEM_ZONE, ptr);
+            TRI_Free(_memoryZone, ptr);
             throw;
           }
 
           _memoryUsed += sizeof(Node) +
-            sizeof(Node*) * newNode->_height;
+            sizeof(std::atomic<Node*>) * newNode->_height;
 
           return newNode;
         }
@@ -577,12 +693,26 @@ namespace triagens {
         void freeNode (Node* node) {
           // update memory usage
           _memoryUsed -= sizeof(Node) +
-            sizeof(Node*) * node->_height;
+            sizeof(std::atomic<Node*>) * node->_height;
 
           // we have used placement new to construct the skiplist node,
           // so now we have to manually call its dtor and free the underlying memory
           node->~Node();
-          TRI_Free(TRI_UNKNOWN_MEM_ZONE, node);
+          TRI_Free(_memoryZone, node);
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees unlinked nodes and their documents
+////////////////////////////////////////////////////////////////////////////////
+
+        void freeGarbage (std::vector<Node*>& garbage) {
+          for (auto& node : garbage) {
+            if (nullptr != _free) {
+              _free(node->_doc);
+            }
+            freeNode(node);
+          }
+          garbage.clear();
         }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -610,9 +740,9 @@ namespace triagens {
           int cmp = 0;  // just in case to avoid undefined values
 
           Node* cur = _start;
-          for (lev = _start->_height - 1; lev >= 0; lev--) {
+          for (lev = _height.load(std::memory_order_acquire) - 1; lev >= 0; lev--) {
             while (true) {   // will be left by break
-              *next = cur->_next[lev];
+              *next = cur->_next[lev].load(std::memory_order_acquire);
               if (nullptr == *next) {
                 break;
               }
@@ -652,9 +782,9 @@ namespace triagens {
           int cmp = 0;  // just in case to avoid undefined values
 
           Node* cur = _start;
-          for (lev = _start->_height-1; lev >= 0; lev--) {
+          for (lev = _height.load(std::memory_order_acquire) - 1; lev >= 0; lev--) {
             while (true) {   // will be left by break
-              *next = cur->_next[lev];
+              *next = cur->_next[lev].load(std::memory_order_acquire);
               if (nullptr == *next) {
                 break;
               }
@@ -687,9 +817,9 @@ namespace triagens {
           int cmp = 0;  // just in case to avoid undefined values
 
           Node* cur = _start;
-          for (lev = _start->_height - 1; lev >= 0; lev--) {
+          for (lev = _height.load(std::memory_order_acquire) - 1; lev >= 0; lev--) {
             while (true) {   // will be left by break
-              *next = cur->_next[lev];
+              *next = cur->_next[lev].load(std::memory_order_acquire);
               if (nullptr == *next) {
                 break;
               }
@@ -718,9 +848,9 @@ namespace triagens {
           int cmp = 0;  // just in case to avoid undefined values
 
           Node* cur = _start;
-          for (lev = _start->_height - 1; lev >= 0; lev--) {
+          for (lev = _height.load(std::memory_order_acquire) - 1; lev >= 0; lev--) {
             while (true) {   // will be left by break
-              *next = cur->_next[lev];
+              *next = cur->_next[lev].load(std::memory_order_acquire);
               if (nullptr == *next) {
                 break;
               }
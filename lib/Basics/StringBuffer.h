@@ -119,6 +119,15 @@ namespace triagens {
           return TRI_ReserveStringBuffer(&_buffer, length);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of characters the buffer can hold without
+/// growing
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t capacity () const {
+          return _buffer._len;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public methods
 // -----------------------------------------------------------------------------
@@ -127,8 +136,9 @@ namespace triagens {
 /// @brief compress the buffer using deflate
 ////////////////////////////////////////////////////////////////////////////////
 
-        int deflate (size_t bufferSize) {
-          return TRI_DeflateStringBuffer(&_buffer, bufferSize);
+        int deflate (size_t bufferSize,
+                     int level = Z_DEFAULT_COMPRESSION) {
+          return TRI_DeflateStringBuffer(&_buffer, bufferSize, level);
         }
 
 ////////////////////////////////////////////////////////////////////////////////
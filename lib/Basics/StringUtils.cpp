@@ -152,14 +152,92 @@ namespace {
 
 
 
-  inline bool isBase64 (unsigned char c) {
-    return (isalnum(c) || (c == '+') || (c == '/'));
+  string EncodeBase64 (string const& in, char const* chars) {
+    size_t const length = in.size();
+    string ret;
+
+    ret.resize(((length + 2) / 3) * 4);
+
+    unsigned char const* src = reinterpret_cast<unsigned char const*>(in.c_str());
+    unsigned char const* end = src + (length / 3) * 3;
+    char* dst = &ret[0];
+
+    // whole blocks of three bytes
+    for (;  src < end;  src += 3, dst += 4) {
+      uint32_t const value = (uint32_t(src[0]) << 16) | (uint32_t(src[1]) << 8) | uint32_t(src[2]);
+
+      dst[0] = chars[(value >> 18) & 0x3f];
+      dst[1] = chars[(value >> 12) & 0x3f];
+      dst[2] = chars[(value >>  6) & 0x3f];
+      dst[3] = chars[ value        & 0x3f];
+    }
+
+    size_t const rest = length % 3;
+
+    if (rest != 0) {
+      uint32_t value = uint32_t(src[0]) << 16;
+
+      if (rest == 2) {
+        value |= uint32_t(src[1]) << 8;
+      }
+
+      dst[0] = chars[(value >> 18) & 0x3f];
+      dst[1] = chars[(value >> 12) & 0x3f];
+      dst[2] = (rest == 2) ? chars[(value >> 6) & 0x3f] : '=';
+      dst[3] = '=';
+    }
+
+    return ret;
   }
 
 
 
-  inline bool isBase64U (unsigned char c) {
-    return (isalnum(c) || (c == '-') || (c == '_'));
+  string DecodeBase64 (string const& source,
+                       unsigned char const* revs) {
+    unsigned char const* src = reinterpret_cast<unsigned char const*>(source.c_str());
+    size_t length = 0;
+
+    // the input ends at the first padding or invalid character. 'A' is the
+    // only valid character that decodes to 0
+    while (length < source.size() && (revs[src[length]] != 0 || src[length] == 'A')) {
+      ++length;
+    }
+
+    size_t const rest = length % 4;
+    string ret;
+
+    ret.resize((length / 4) * 3 + (rest > 1 ? rest - 1 : 0));
+
+    unsigned char const* end = src + (length / 4) * 4;
+    char* dst = &ret[0];
+
+    // whole blocks of four characters
+    for (;  src < end;  src += 4, dst += 3) {
+      uint32_t const value = (uint32_t(revs[src[0]]) << 18) |
+                             (uint32_t(revs[src[1]]) << 12) |
+                             (uint32_t(revs[src[2]]) <<  6) |
+                              uint32_t(revs[src[3]]);
+
+      dst[0] = char(value >> 16);
+      dst[1] = char(value >>  8);
+      dst[2] = char(value);
+    }
+
+    if (rest > 1) {
+      uint32_t value = (uint32_t(revs[src[0]]) << 18) | (uint32_t(revs[src[1]]) << 12);
+
+      if (rest == 3) {
+        value |= uint32_t(revs[src[2]]) << 6;
+      }
+
+      dst[0] = char(value >> 16);
+
+      if (rest == 3) {
+        dst[1] = char(value >> 8);
+      }
+    }
+
+    return ret;
   }
 
 
@@ -622,6 +700,19 @@ namespace triagens {
         char const * end = ptr + len;
 
         for (;  ptr < end;  ++ptr, ++qtr) {
+          // copy the characters that need no escaping in one go
+          size_t const plain = TRI_PlainJsonPrefix(ptr, (size_t) (end - ptr), escapeSlash);
+
+          if (plain > 0) {
+            memcpy(qtr, ptr, plain);
+            ptr += plain;
+            qtr += plain;
+
+            if (ptr == end) {
+              break;
+            }
+          }
+
           switch (*ptr) {
             case '/':
               if (escapeSlash) {
@@ -1518,16 +1609,27 @@ namespace triagens {
         char* buffer = new char[str.size() + 1];
         char* ptr = buffer;
 
-        for (;  src < end && *src != '%';  ++src) {
+        while (src < end) {
+          // copy the characters that need no decoding in one go
+          char const* plain = src;
+
+          while (src < end && *src != '%' && *src != '+') {
+            ++src;
+          }
+
+          memcpy(ptr, plain, src - plain);
+          ptr += src - plain;
+
+          if (src == end) {
+            break;
+          }
+
           if (*src == '+') {
             *ptr++ = ' ';
+            ++src;
+            continue;
           }
-          else {
-            *ptr++ = *src;
-          }
-        }
 
-        while (src < end) {
           if (src + 2 < end) {
             int h1 = hex2int(src[1], -1);
             int h2 = hex2int(src[2], -1);
@@ -1560,15 +1662,6 @@ namespace triagens {
           else {
             src += 1;
           }
-
-          for (;  src < end && *src != '%';  ++src) {
-            if (*src == '+') {
-              *ptr++ = ' ';
-            }
-            else {
-              *ptr++ = *src;
-            }
-          }
         }
 
         *ptr = '\0';
@@ -3016,217 +3109,25 @@ namespace triagens {
       // .............................................................................
 
       string encodeBase64 (string const& in) {
-        unsigned char charArray3[3];
-        unsigned char charArray4[4];
-
-        string ret;
-
-        int i = 0;
-
-        unsigned char const* bytesToEncode = reinterpret_cast<unsigned char const*>(in.c_str());
-        size_t in_len = in.size();
-
-        while (in_len--) {
-          charArray3[i++] = *(bytesToEncode++);
-
-          if (i == 3) {
-            charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-            charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-            charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-            charArray4[3] =   charArray3[2] & 0x3f;
-
-            for (i = 0;  i < 4;  i++) {
-              ret += BASE64_CHARS[charArray4[i]];
-            }
-
-            i = 0;
-          }
-        }
-
-        if (i != 0) {
-          for(int j = i; j < 3; j++) {
-            charArray3[j] = '\0';
-          }
-
-          charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-          charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-          charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-          charArray4[3] =   charArray3[2] & 0x3f;
-
-          for (int j = 0; (j < i + 1); j++) {
-            ret += BASE64_CHARS[charArray4[j]];
-          }
-
-          while ((i++ < 3)) {
-            ret += '=';
-          }
-        }
-
-        return ret;
+        return EncodeBase64(in, BASE64_CHARS);
       }
 
 
 
       string decodeBase64 (string const& source) {
-        unsigned char charArray4[4];
-        unsigned char charArray3[3];
-
-        string ret;
-
-        int i = 0;
-        int inp = 0;
-
-        int in_len = (int) source.size();
-
-        while (in_len-- && (source[inp] != '=') && isBase64(source[inp])) {
-          charArray4[i++] = source[inp];
-
-          inp++;
-
-          if (i ==4) {
-            for (i = 0;  i < 4;  i++) {
-              charArray4[i] = BASE64_REVS[charArray4[i]];
-            }
-
-            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
-
-            for (i = 0; (i < 3); i++) {
-              ret += charArray3[i];
-            }
-
-            i = 0;
-          }
-        }
-
-        if (i) {
-          for (int j = i;  j < 4;  j++) {
-              charArray4[j] = 0;
-          }
-
-          for (int j = 0;  j < 4; j++) {
-            charArray4[j] = BASE64_REVS[charArray4[j]];
-          }
-
-          charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-          charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-          charArray3[2] = ((charArray4[2] & 0x3) << 6) + charArray4[3];
-
-          for (int j = 0;  j < i - 1;  j++) {
-            ret += charArray3[j];
-          }
-        }
-
-        return ret;
+        return DecodeBase64(source, BASE64_REVS);
       }
 
 
 
       string encodeBase64U (string const& in) {
-        unsigned char charArray3[3];
-        unsigned char charArray4[4];
-
-        string ret;
-
-        int i = 0;
-
-        unsigned char const* bytesToEncode = reinterpret_cast<unsigned char const*>(in.c_str());
-        size_t in_len = in.size();
-
-        while (in_len--) {
-          charArray3[i++] = *(bytesToEncode++);
-
-          if (i == 3) {
-            charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-            charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-            charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-            charArray4[3] =   charArray3[2] & 0x3f;
-
-            for (i = 0;  i < 4;  i++) {
-              ret += BASE64U_CHARS[charArray4[i]];
-            }
-
-            i = 0;
-          }
-        }
-
-        if (i != 0) {
-          for(size_t j = i; j < 3; j++) {
-            charArray3[j] = '\0';
-          }
-
-          charArray4[0] =  (charArray3[0] & 0xfc) >> 2;
-          charArray4[1] = ((charArray3[0] & 0x03) << 4) + ((charArray3[1] & 0xf0) >> 4);
-          charArray4[2] = ((charArray3[1] & 0x0f) << 2) + ((charArray3[2] & 0xc0) >> 6);
-          charArray4[3] =   charArray3[2] & 0x3f;
-
-          for (int j = 0; (j < i + 1); j++) {
-            ret += BASE64U_CHARS[charArray4[j]];
-          }
-
-          while ((i++ < 3)) {
-            ret += '=';
-          }
-        }
-
-        return ret;
+        return EncodeBase64(in, BASE64U_CHARS);
       }
 
 
 
       string decodeBase64U (string const& source) {
-        unsigned char charArray4[4];
-        unsigned char charArray3[3];
-
-        string ret;
-
-        int i = 0;
-        int inp = 0;
-
-        int in_len = (int) source.size();
-
-        while (in_len-- && (source[inp] != '=') && isBase64U(source[inp])) {
-          charArray4[i++] = source[inp];
-
-          inp++;
-
-          if (i ==4) {
-            for (i = 0;  i < 4;  i++) {
-              charArray4[i] = BASE64U_REVS[charArray4[i]];
-            }
-
-            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
-
-            for (i = 0; (i < 3); i++) {
-              ret += charArray3[i];
-            }
-
-            i = 0;
-          }
-        }
-
-        if (i) {
-          for (size_t j = i;  j < 4;  j++) {
-              charArray4[j] = 0;
-          }
-
-          for (size_t j = 0;  j < 4; j++) {
-            charArray4[j] = BASE64U_REVS[charArray4[j]];
-          }
-
-          charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-          charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-          charArray3[2] = ((charArray4[2] & 0x3) << 6) + charArray4[3];
-
-          for (int j = 0;  j < i - 1;  j++) {
-            ret += charArray3[j];
-          }
-        }
-
-        return ret;
+        return DecodeBase64(source, BASE64U_REVS);
       }
 
       // .............................................................................
@@ -104,7 +104,7 @@ Thread::Thread (std::string const& name)
     _started(0),
     _running(0),
     _joined(0),
-    _affinity(-1) {
+    _affinity() {
   TRI_InitThread(&_thread);
 }
 
@@ -189,8 +189,8 @@ bool Thread::start (ConditionVariable * finishedCondition) {
     LOG_ERROR("could not start thread '%s': %s", _name.c_str(), strerror(errno));
   }
 
-  if (0 <= _affinity) {
-    TRI_SetProcessorAffinity(&_thread, (size_t) _affinity);
+  if (! _affinity.empty()) {
+    TRI_SetProcessorAffinity(&_thread, _affinity);
   }
 
   return ok;
@@ -264,7 +264,15 @@ int Thread::shutdown () {
 ////////////////////////////////////////////////////////////////////////////////
 
 void Thread::setProcessorAffinity (size_t c) {
-  _affinity = (int) c;
+  _affinity = { c };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+void Thread::setProcessorAffinity (std::vector<size_t> const& cores) {
+  _affinity = cores;
 }
 
 // -----------------------------------------------------------------------------
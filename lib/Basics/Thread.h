@@ -152,6 +152,13 @@ namespace triagens {
 
        void setProcessorAffinity (size_t c);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors, e.g. the ones
+/// of a NUMA node
+////////////////////////////////////////////////////////////////////////////////
+
+       void setProcessorAffinity (std::vector<size_t> const& cores);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 protected methods
 // -----------------------------------------------------------------------------
@@ -260,10 +267,11 @@ namespace triagens {
         volatile sig_atomic_t _joined;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief processor affinity
+/// @brief processor affinity, the thread may run on any of the processors.
+/// empty if the thread may run anywhere
 ////////////////////////////////////////////////////////////////////////////////
 
-        int _affinity;
+        std::vector<size_t> _affinity;
 
     };
   }
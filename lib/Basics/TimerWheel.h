@@ -0,0 +1,512 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief hierarchical timer wheel
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_TIMER_WHEEL_H
+#define ARANGODB_BASICS_TIMER_WHEEL_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  class TimerWheel
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a hashed hierarchical timer wheel
+///
+/// time is counted in ticks, whose length is up to the user. a timer is
+/// linked into a slot of one of four levels of 256 slots each. level 0 holds
+/// the timers expiring in the next 256 ticks, one slot per tick, level 1 the
+/// timers of the next 256 * 256 ticks, one slot per 256 ticks, and so on.
+/// whenever the lower levels have passed a full round, the next slot of the
+/// level above is distributed to them. timers further away than the wheel
+/// reaches wait in the top level and are distributed again.
+///
+/// inserting and removing a timer takes constant time, and timers are not
+/// allocated by the wheel: they are embedded in the objects they belong to.
+/// the wheel is not thread-safe.
+////////////////////////////////////////////////////////////////////////////////
+
+    class TimerWheel {
+
+      private:
+        TimerWheel (TimerWheel const&) = delete;
+        TimerWheel& operator= (TimerWheel const&) = delete;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a timer. it must be removed from the wheel before it is destroyed.
+/// a copy of a timer is not in the wheel and has no data, and assigning to a
+/// timer does not change it
+////////////////////////////////////////////////////////////////////////////////
+
+        class Timer {
+          friend class TimerWheel;
+
+          public:
+
+            Timer ()
+              : _prev(nullptr),
+                _next(nullptr),
+                _expires(0),
+                _level(0),
+                _data(nullptr) {
+            }
+
+            explicit Timer (void* data)
+              : _prev(nullptr),
+                _next(nullptr),
+                _expires(0),
+                _level(0),
+                _data(data) {
+            }
+
+            Timer (Timer const&)
+              : _prev(nullptr),
+                _next(nullptr),
+                _expires(0),
+                _level(0),
+                _data(nullptr) {
+            }
+
+            Timer& operator= (Timer const&) {
+              return *this;
+            }
+
+            ~Timer () {
+              TRI_ASSERT(! isActive());
+            }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the timer is in a wheel
+////////////////////////////////////////////////////////////////////////////////
+
+            bool isActive () const {
+              return _next != nullptr;
+            }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the tick at which the timer expires
+////////////////////////////////////////////////////////////////////////////////
+
+            uint64_t expires () const {
+              return _expires;
+            }
+
+            void* data () const {
+              return _data;
+            }
+
+            void setData (void* data) {
+              _data = data;
+            }
+
+          private:
+
+            void unlink () {
+              _prev->_next = _next;
+              _next->_prev = _prev;
+              _prev = nullptr;
+              _next = nullptr;
+            }
+
+            Timer* _prev;
+            Timer* _next;
+            uint64_t _expires;
+            uint32_t _level;
+            void* _data;
+        };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public constants
+// -----------------------------------------------------------------------------
+
+      public:
+
+        static uint32_t const Levels = 4;
+
+        static uint32_t const SlotBits = 8;
+
+        static uint32_t const Slots = 1 << SlotBits;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the largest number of ticks a timer can be in the wheel before it
+/// has to be distributed again
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint64_t const Reach = (static_cast<uint64_t>(1) << (Levels * SlotBits)) - 1;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      constructors and destructors
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a wheel, starting at the given tick
+////////////////////////////////////////////////////////////////////////////////
+
+        explicit TimerWheel (uint64_t now = 0)
+          : _now(now),
+            _count(0) {
+
+          for (uint32_t level = 0; level < Levels; ++level) {
+            _levelCount[level] = 0;
+
+            for (uint32_t i = 0; i < Slots; ++i) {
+              Timer& head = _slots[level][i];
+              head._prev = &head;
+              head._next = &head;
+            }
+          }
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief destroys the wheel. timers still in the wheel are removed
+////////////////////////////////////////////////////////////////////////////////
+
+        ~TimerWheel () {
+          clear();
+
+          for (uint32_t level = 0; level < Levels; ++level) {
+            for (uint32_t i = 0; i < Slots; ++i) {
+              Timer& head = _slots[level][i];
+              head._prev = nullptr;
+              head._next = nullptr;
+            }
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the last tick the wheel has advanced to
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t now () const {
+          return _now;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the number of timers in the wheel
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t size () const {
+          return _count;
+        }
+
+        bool empty () const {
+          return _count == 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief inserts a timer expiring at the given tick, or moves it there if
+/// it is in the wheel already. a timer expiring at or before the current
+/// tick expires with the next tick
+////////////////////////////////////////////////////////////////////////////////
+
+        void insert (Timer* timer,
+                     uint64_t expires) {
+          if (timer->isActive()) {
+            remove(timer);
+          }
+
+          timer->_expires = (expires > _now) ? expires : _now + 1;
+          link(timer);
+          ++_count;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes a timer from the wheel, does nothing if it is not in it
+////////////////////////////////////////////////////////////////////////////////
+
+        void remove (Timer* timer) {
+          if (! timer->isActive()) {
+            return;
+          }
+
+          --_levelCount[timer->_level];
+          timer->unlink();
+          --_count;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief removes all timers
+////////////////////////////////////////////////////////////////////////////////
+
+        void clear () {
+          for (uint32_t level = 0; level < Levels; ++level) {
+            for (uint32_t i = 0; i < Slots; ++i) {
+              Timer* head = &_slots[level][i];
+
+              while (head->_next != head) {
+                head->_next->unlink();
+              }
+            }
+            _levelCount[level] = 0;
+          }
+
+          _count = 0;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief advances the wheel to the given tick, and calls the callback with
+/// every timer that has expired, in the order of their expiry
+///
+/// a timer is removed from the wheel before the callback is called with it.
+/// the callback may insert and remove any timers, including the expired one
+/// and the ones expiring with the same tick, and may destroy the expired
+/// timer. returns the number of expired timers
+////////////////////////////////////////////////////////////////////////////////
+
+        template<typename F>
+        size_t advance (uint64_t now,
+                        F const& callback) {
+          size_t expired = 0;
+
+          while (_now < now) {
+            if (_count == 0) {
+              _now = now;
+              break;
+            }
+
+            uint32_t lowest = 0;
+
+            while (_levelCount[lowest] == 0) {
+              ++lowest;
+            }
+
+            if (lowest > 0) {
+              // nothing happens before the next slot of the lowest level with
+              // timers is distributed
+              uint64_t const last = _now | ((static_cast<uint64_t>(1) << (lowest * SlotBits)) - 1);
+
+              if (last >= now) {
+                _now = now;
+                break;
+              }
+
+              _now = last;
+            }
+
+            ++_now;
+            cascade();
+
+            // take the timers of the tick, so timers inserted by the callbacks
+            // are not called before the next tick
+            Timer* head = &_slots[0][_now & (Slots - 1)];
+
+            if (head->_next == head) {
+              continue;
+            }
+
+            Timer expiring;
+            expiring._next = head->_next;
+            expiring._prev = head->_prev;
+            expiring._next->_prev = &expiring;
+            expiring._prev->_next = &expiring;
+            head->_next = head;
+            head->_prev = head;
+
+            while (expiring._next != &expiring) {
+              Timer* timer = expiring._next;
+              TRI_ASSERT(timer->_expires <= _now);
+
+              timer->unlink();
+              --_levelCount[0];
+              --_count;
+              ++expired;
+
+              callback(timer);
+            }
+
+            expiring._prev = nullptr;
+            expiring._next = nullptr;
+          }
+
+          return expired;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns a tick up to which the wheel can be advanced without any
+/// timer expiring before it, or UINT64_MAX if the wheel is empty
+///
+/// for timers of level 0 it is the tick at which they expire, for the other
+/// levels the tick at which their slot is distributed to the levels below
+////////////////////////////////////////////////////////////////////////////////
+
+        uint64_t nextExpiry () const {
+          if (_count == 0) {
+            return UINT64_MAX;
+          }
+
+          uint64_t result = UINT64_MAX;
+
+          for (uint32_t level = 0; level < Levels; ++level) {
+            if (_levelCount[level] == 0) {
+              continue;
+            }
+
+            uint32_t const shift = level * SlotBits;
+            uint64_t const current = _now >> shift;
+
+            for (uint64_t i = 1; i <= Slots; ++i) {
+              Timer const* head = &_slots[level][(current + i) & (Slots - 1)];
+
+              if (head->_next != head) {
+                uint64_t tick = (current + i) << shift;
+
+                if (level == 0) {
+                  tick = current + i;
+                }
+
+                if (tick < result) {
+                  result = tick;
+                }
+                break;
+              }
+            }
+          }
+
+          return result;
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief links a timer into the slot for its expiry
+////////////////////////////////////////////////////////////////////////////////
+
+        void link (Timer* timer) {
+          uint64_t expires = timer->_expires;
+
+          if (expires < _now) {
+            expires = _now;
+          }
+
+          uint64_t delta = expires - _now;
+
+          if (delta > Reach) {
+            // wait in the top level, and be distributed again
+            delta = Reach;
+            expires = _now + Reach;
+          }
+
+          uint32_t level = 0;
+
+          while (delta >= (static_cast<uint64_t>(1) << ((level + 1) * SlotBits))) {
+            ++level;
+          }
+
+          uint32_t const slot = (expires >> (level * SlotBits)) & (Slots - 1);
+          Timer* head = &_slots[level][slot];
+
+          timer->_level = level;
+          timer->_prev = head->_prev;
+          timer->_next = head;
+          head->_prev->_next = timer;
+          head->_prev = timer;
+
+          ++_levelCount[level];
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief distributes the slots of the upper levels that are due at the
+/// current tick to the lower levels
+////////////////////////////////////////////////////////////////////////////////
+
+        void cascade () {
+          uint32_t top = 0;
+
+          while (top + 1 < Levels &&
+                 (_now & ((static_cast<uint64_t>(1) << ((top + 1) * SlotBits)) - 1)) == 0) {
+            ++top;
+          }
+
+          for (uint32_t level = top; level > 0; --level) {
+            if (_levelCount[level] == 0) {
+              continue;
+            }
+
+            uint32_t const slot = (_now >> (level * SlotBits)) & (Slots - 1);
+            Timer* head = &_slots[level][slot];
+
+            while (head->_next != head) {
+              Timer* timer = head->_next;
+              timer->unlink();
+              --_levelCount[level];
+              link(timer);
+            }
+          }
+        }
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+      private:
+
+        uint64_t _now;
+
+        size_t _count;
+
+        size_t _levelCount[Levels];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the list heads of the slots
+////////////////////////////////////////////////////////////////////////////////
+
+        Timer _slots[Levels][Slots];
+    };
+
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -532,12 +532,22 @@ namespace triagens {
         typedef enum {FORWARD, BACKWARD} Direction;
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief callback to find neighbours
+/// @brief callback to find neighbours. the steps are appended by value, the
+/// searchers only allocate a step of their own for vertices not seen before
 ////////////////////////////////////////////////////////////////////////////////
 
-        typedef std::function<void(VertexId& V, std::vector<Step*>& result)>
+        typedef std::function<void(VertexId& V, std::vector<Step>& result)>
                 ExpanderFunction;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief callback for the A* search, returns a lower bound for the weight
+/// of the path from a vertex to the target. it must never overestimate, and
+/// h(x) <= weight(x, y) + h(y) must hold for every edge
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::function<EdgeWeight(VertexId const& V)>
+                HeuristicFunction;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief our specialization of the priority queue
 ////////////////////////////////////////////////////////////////////////////////
@@ -586,33 +596,37 @@ namespace triagens {
             }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// @brief Insert a neighbor to the todo list.
+/// @brief Insert the neighbors of a vertex at distance weight to the todo
+/// list. The mutex is acquired once for all of them.
 ////////////////////////////////////////////////////////////////////////////////
 
           private:
 
-            void insertNeighbor (Step* step, 
-                                 EdgeWeight newWeight) {
+            void insertNeighbors (std::vector<Step> const& neighbors,
+                                  EdgeWeight weight) {
               std::lock_guard<std::mutex> guard(_myInfo._mutex);
-              Step* s = _myInfo._pq.find(step->_vertex);
 
-              // Not found, so insert it:
-              if (s == nullptr) {
-                step->setWeight(newWeight);
-                _myInfo._pq.insert(step->_vertex, step);
-                // step is consumed!
-                return;
-              }
-              if (s->_done) {
-                delete step;
-                return;
-              }
-              if (s->weight() > newWeight) {
-                s->_predecessor = step->_predecessor;
-                s->_edge = step->_edge;
-                _myInfo._pq.lowerWeight(s->_vertex, newWeight);
+              for (auto const& step : neighbors) {
+                EdgeWeight newWeight = weight + step.weight();
+                Step* s = _myInfo._pq.find(step._vertex);
+
+                // Not found, so insert it:
+                if (s == nullptr) {
+                  std::unique_ptr<Step> copy(new Step(step));
+                  copy->setWeight(newWeight);
+                  _myInfo._pq.insert(copy->_vertex, copy.get());
+                  copy.release();
+                  continue;
+                }
+                if (s->_done) {
+                  continue;
+                }
+                if (s->weight() > newWeight) {
+                  s->_predecessor = step._predecessor;
+                  s->_edge = step._edge;
+                  _myInfo._pq.lowerWeight(s->_vertex, newWeight);
+                }
               }
-              delete step;
             }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -684,16 +698,14 @@ namespace triagens {
                   b = _myInfo._pq.popMinimal(v, s, true);
                 }
                 
-                std::vector<Step*> neighbors;
+                std::vector<Step> neighbors;
 
                 // Iterate while no bingo found and
                 // there still is a vertex on the stack.
                 while (! _pathFinder->_bingo && b) {
                   neighbors.clear();
                   _expander(v, neighbors);
-                  for (auto* neighbor : neighbors) {
-                    insertNeighbor(neighbor, s->weight() + neighbor->weight());
-                  }
+                  insertNeighbors(neighbors, s->weight());
                   lookupPeer(v, s->weight());
 
                   std::lock_guard<std::mutex> guard(_myInfo._mutex);
@@ -778,21 +790,24 @@ namespace triagens {
 
           private:
 
-            void insertNeighbor (Step* step, 
+            void insertNeighbor (Step const& step, 
                                  EdgeWeight newWeight) {
-              Step* s = _myInfo._pq.find(step->_vertex);
+              Step* s = _myInfo._pq.find(step._vertex);
 
               // Not found, so insert it:
               if (s == nullptr) {
-                step->setWeight(newWeight);
-                _myInfo._pq.insert(step->_vertex, step);
+                std::unique_ptr<Step> copy(new Step(step));
+                copy->setWeight(newWeight);
+                _myInfo._pq.insert(copy->_vertex, copy.get());
+                copy.release();
                 return;
               }
-              delete step;
               if (s->_done) {
                 return;
               }
               if (s->weight() > newWeight) {
+                s->_predecessor = step._predecessor;
+                s->_edge = step._edge;
                 _myInfo._pq.lowerWeight(s->_vertex, newWeight);
               }
             }
@@ -863,8 +878,6 @@ namespace triagens {
               Step* s;
               bool b = _myInfo._pq.popMinimal(v, s, true);
               
-              std::vector<Step*> neighbors;
-
               if (_pathFinder->_bingo || ! b) {
                 // We can leave this functino only under 2 conditions:
                 // 1) already bingo==true => bingo = true no effect
@@ -875,9 +888,10 @@ namespace triagens {
                 return false;
               }
 
-              _expander(v, neighbors);
-              for (Step* neighbor : neighbors) {
-                insertNeighbor(neighbor, s->weight() + neighbor->weight());
+              _neighbors.clear();
+              _expander(v, _neighbors);
+              for (auto const& neighbor : _neighbors) {
+                insertNeighbor(neighbor, s->weight() + neighbor.weight());
               }
               lookupPeer(v, s->weight());
 
@@ -886,6 +900,14 @@ namespace triagens {
               return true;
             }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the neighbors of the current vertex, reused for all steps
+////////////////////////////////////////////////////////////////////////////////
+
+          private:
+
+            std::vector<Step> _neighbors;
+
         };
 
 // -----------------------------------------------------------------------------
@@ -970,7 +992,7 @@ namespace triagens {
             if (! forwardSearcher.oneStep()) {
               break;
             }
-            if (! backwardSearcher->oneStep()) {
+            if (_bidirectional && ! backwardSearcher->oneStep()) {
               break;
             }
           }
@@ -1106,6 +1128,97 @@ namespace triagens {
           return new Path(r_vertices, r_edges, _highscore);
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief return the shortest path between the start and target vertex,
+/// A* version following the forward expander only.
+/// the queue is ordered by distance + heuristic(vertex), so the search is
+/// directed towards the target and finishes as soon as the target is
+/// taken from the queue. with a heuristic that is always 0 this is the
+/// plain Dijkstra search
+////////////////////////////////////////////////////////////////////////////////
+
+        // Caller has to free the result
+        // nullptr indicates there is no path
+
+        Path* shortestPathAStar (VertexId& start,
+                                 VertexId& target,
+                                 HeuristicFunction const& heuristic) {
+
+          // For the result:
+          std::deque<VertexId> r_vertices;
+          std::deque<EdgeId> r_edges;
+          std::equal_to<VertexId> eq;
+
+          VertexId emptyVertex;
+          EdgeId emptyEdge;
+          ThreadInfo forward;
+          forward._pq.insert(start,
+                             new Step(start, emptyVertex, heuristic(start), emptyEdge));
+
+          TRI_IF_FAILURE("TraversalOOMInitialize") {
+            THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+          }
+
+          std::vector<Step> neighbors;
+          VertexId v;
+          Step* s;
+
+          while (forward._pq.popMinimal(v, s, true)) {
+            // the weight in the queue is the distance plus the estimate
+            EdgeWeight const distance = s->weight() - heuristic(v);
+
+            if (eq(v, target)) {
+              r_vertices.emplace_back(v);
+
+              // Go path back from target -> start.
+              while (s->_predecessor.key != nullptr &&
+                     strcmp(s->_predecessor.key, "") != 0) {
+                r_edges.push_front(s->_edge);
+                r_vertices.push_front(s->_predecessor);
+                s = forward._pq.find(s->_predecessor);
+              }
+
+              TRI_IF_FAILURE("TraversalOOMPath") {
+                THROW_ARANGO_EXCEPTION(TRI_ERROR_DEBUG);
+              }
+
+              return new Path(r_vertices, r_edges, distance);
+            }
+
+            // with a consistent heuristic, a vertex is final once it is
+            // taken from the queue
+            s->_done = true;
+
+            neighbors.clear();
+            _forwardExpander(v, neighbors);
+
+            for (auto const& step : neighbors) {
+              Step* n = forward._pq.find(step._vertex);
+
+              if (n != nullptr && n->_done) {
+                continue;
+              }
+
+              EdgeWeight newWeight = distance + step.weight() + heuristic(step._vertex);
+
+              if (n == nullptr) {
+                std::unique_ptr<Step> copy(new Step(step));
+                copy->setWeight(newWeight);
+                forward._pq.insert(copy->_vertex, copy.get());
+                copy.release();
+              }
+              else if (n->weight() > newWeight) {
+                n->_predecessor = step._predecessor;
+                n->_edge = step._edge;
+                forward._pq.lowerWeight(n->_vertex, newWeight);
+              }
+            }
+          }
+
+          // the queue ran empty, so there is no path
+          return nullptr;
+        }
+
 /* Here is a proof for the correctness of this algorithm:
  *
  * Assume we are looking for a shortest path from vertex A to vertex B.
@@ -36,23 +36,121 @@
 #include "unicode/ucasemap.h"
 #include "unicode/uclean.h"
 #include "unicode/unorm2.h"
+#include "unicode/uniset.h"
+#include "unicode/usetiter.h"
 #include "unicode/ustdio.h"
 
 #ifdef _WIN32
 #include "Basics/win-utils.h"
 #endif
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define TRI_UTF8_HELPER_SSE2 1
+#endif
+
 using namespace triagens::basics;
 using namespace std;
 
 Utf8Helper Utf8Helper::DefaultUtf8Helper;
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a string consists of ASCII characters only
+///
+/// With SSE2, 16 bytes are checked at once using the sign bits.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool IsAscii (char const* value,
+                            size_t length) {
+  char const* end = value + length;
+
+#ifdef TRI_UTF8_HELPER_SSE2
+  while (end - value >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(value));
+
+    if (_mm_movemask_epi8(chunk) != 0) {
+      return false;
+    }
+
+    value += 16;
+  }
+#endif
+
+  while (value < end) {
+    if (static_cast<uint8_t>(*value) >= 0x80) {
+      return false;
+    }
+
+    ++value;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief flips the case of the ASCII letters between first and last
+///
+/// returns false as soon as a non-ASCII byte is found, the contents of dst
+/// are undefined then
+////////////////////////////////////////////////////////////////////////////////
+
+static bool FlipAsciiCase (char* dst,
+                           char const* src,
+                           size_t length,
+                           char first,
+                           char last) {
+  char const* end = src + length;
+
+#ifdef TRI_UTF8_HELPER_SSE2
+  __m128i const lower = _mm_set1_epi8(first - 1);
+  __m128i const upper = _mm_set1_epi8(last + 1);
+  __m128i const bit   = _mm_set1_epi8(0x20);
+
+  while (end - src >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src));
+
+    if (_mm_movemask_epi8(chunk) != 0) {
+      return false;
+    }
+
+    // signed compares are fine, all bytes are below 0x80 here
+    __m128i const letters = _mm_and_si128(_mm_cmpgt_epi8(chunk, lower), _mm_cmplt_epi8(chunk, upper));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_xor_si128(chunk, _mm_and_si128(letters, bit)));
+
+    src += 16;
+    dst += 16;
+  }
+#endif
+
+  while (src < end) {
+    char c = *src++;
+
+    if (static_cast<uint8_t>(c) >= 0x80) {
+      return false;
+    }
+
+    if (c >= first && c <= last) {
+      c ^= 0x20;
+    }
+
+    *dst++ = c;
+  }
+
+  return true;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
 
 Utf8Helper::Utf8Helper (std::string const& lang) : 
-  _coll(nullptr) {
+  _coll(nullptr),
+  _asciiCaseMapping(false),
+  _asciiCollation(false) {
 
   setCollatorLanguage(lang);
 }
@@ -77,6 +175,15 @@ int Utf8Helper::compareUtf8 (char const* left,
     return (strcmp(left, right));
   }
 
+  if (_asciiCollation) {
+    size_t const leftLength  = strlen(left);
+    size_t const rightLength = strlen(right);
+
+    if (IsAscii(left, leftLength) && IsAscii(right, rightLength)) {
+      return compareAscii(left, leftLength, right, rightLength);
+    }
+  }
+
   UErrorCode status = U_ZERO_ERROR;
   int result = _coll->compareUTF8(StringPiece(left), StringPiece(right), status);
   if (U_FAILURE(status)) {
@@ -96,6 +203,12 @@ int Utf8Helper::compareUtf8 (char const* left,
     return (strcmp(left, right));
   }
 
+  if (_asciiCollation &&
+      IsAscii(left, leftLength) &&
+      IsAscii(right, rightLength)) {
+    return compareAscii(left, leftLength, right, rightLength);
+  }
+
   UErrorCode status = U_ZERO_ERROR;
   int result = _coll->compareUTF8(StringPiece(left, (int32_t) leftLength), StringPiece(right, (int32_t) rightLength), status);
   if (U_FAILURE(status)) {
@@ -106,6 +219,47 @@ int Utf8Helper::compareUtf8 (char const* left,
   return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the collation sort key of a utf8 string to result
+////////////////////////////////////////////////////////////////////////////////
+
+void Utf8Helper::appendSortKey (char const* value,
+                                size_t length,
+                                std::string& result) const {
+  if (_coll != nullptr) {
+    UnicodeString const source = UnicodeString::fromUTF8(StringPiece(value, (int32_t) length));
+
+    uint8_t buffer[256];
+    int32_t needed = _coll->getSortKey(source, buffer, (int32_t) sizeof(buffer));
+
+    if (needed > 0 && needed <= (int32_t) sizeof(buffer)) {
+      // the key includes its terminating NUL byte
+      result.append(reinterpret_cast<char const*>(buffer), static_cast<size_t>(needed));
+      return;
+    }
+
+    if (needed > 0) {
+      size_t const offset = result.size();
+      result.resize(offset + static_cast<size_t>(needed));
+      needed = _coll->getSortKey(source, reinterpret_cast<uint8_t*>(&result[offset]), needed);
+
+      if (needed > 0) {
+        result.resize(offset + static_cast<size_t>(needed));
+        return;
+      }
+
+      result.resize(offset);
+    }
+
+    LOG_ERROR("error in Collator::getSortKey()");
+  }
+
+  // compareUtf8 falls back to strcmp, which stops at the first NUL byte
+  char const* end = static_cast<char const*>(memchr(value, '\0', length));
+  result.append(value, (end == nullptr) ? length : static_cast<size_t>(end - value));
+  result.push_back('\0');
+}
+
 int Utf8Helper::compareUtf16 (const uint16_t* left, size_t leftLength, const uint16_t* right, size_t rightLength) const {
   if (! _coll) {
     LOG_ERROR("no Collator in Utf8Helper::compareUtf16()!");
@@ -187,6 +341,8 @@ bool Utf8Helper::setCollatorLanguage (std::string const& lang) {
   }
 
   _coll = coll;
+  initAsciiTables();
+
   return true;
 }
 
@@ -256,6 +412,24 @@ char* Utf8Helper::tolower (TRI_memory_zone_t* zone,
     return utf8_dest;
   }
 
+  if (_asciiCaseMapping) {
+    utf8_dest = (char*) TRI_Allocate(zone, (srcLength + 1) * sizeof(char), false);
+
+    if (utf8_dest == nullptr) {
+      return nullptr;
+    }
+
+    if (FlipAsciiCase(utf8_dest, src, (size_t) srcLength, 'A', 'Z')) {
+      utf8_dest[srcLength] = '\0';
+      dstLength = srcLength;
+      return utf8_dest;
+    }
+
+    // not ASCII, let ICU do it
+    TRI_Free(zone, utf8_dest);
+    utf8_dest = nullptr;
+  }
+
   uint32_t options = U_FOLD_CASE_DEFAULT;
   UErrorCode status = U_ZERO_ERROR;
 
@@ -346,6 +520,24 @@ char* Utf8Helper::toupper (TRI_memory_zone_t* zone,
     return utf8_dest;
   }
 
+  if (_asciiCaseMapping) {
+    utf8_dest = (char*) TRI_Allocate(zone, (srcLength + 1) * sizeof(char), false);
+
+    if (utf8_dest == nullptr) {
+      return nullptr;
+    }
+
+    if (FlipAsciiCase(utf8_dest, src, (size_t) srcLength, 'a', 'z')) {
+      utf8_dest[srcLength] = '\0';
+      dstLength = srcLength;
+      return utf8_dest;
+    }
+
+    // not ASCII, let ICU do it
+    TRI_Free(zone, utf8_dest);
+    utf8_dest = nullptr;
+  }
+
   uint32_t options = U_FOLD_CASE_DEFAULT;
   UErrorCode status = U_ZERO_ERROR;
 
@@ -363,7 +555,7 @@ char* Utf8Helper::toupper (TRI_memory_zone_t* zone,
 
     dstLength = ucasemap_utf8ToUpper(csm.getAlias(),
                     utf8_dest,
-                    srcLength,
+                    srcLength + 1,
                     src,
                     srcLength,
                     &status);
@@ -711,6 +903,215 @@ bool Utf8Helper::matches (RegexMatcher* matcher,
   return (result ? true : false);
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   private methods
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets up the ASCII fast paths for the current collator
+///
+/// The weight tables are derived from the collator itself. They are only
+/// used if the collator does not tailor any ASCII character (which would
+/// allow contractions such as "ch"), and if they reproduce the collator's
+/// results for a set of sample strings.
+////////////////////////////////////////////////////////////////////////////////
+
+void Utf8Helper::initAsciiTables () {
+  _asciiCaseMapping = false;
+  _asciiCollation = false;
+
+  if (_coll == nullptr) {
+    return;
+  }
+
+  // Turkish and Azeri map i and I to dotted and dotless variants
+  std::string const language = getCollatorLanguage();
+  _asciiCaseMapping = (language != "tr" && language != "az");
+
+  UErrorCode status = U_ZERO_ERROR;
+
+  if (_coll->getAttribute(UCOL_ALTERNATE_HANDLING, status) != UCOL_NON_IGNORABLE ||
+      _coll->getAttribute(UCOL_NUMERIC_COLLATION, status) != UCOL_OFF ||
+      _coll->getAttribute(UCOL_CASE_LEVEL, status) != UCOL_OFF ||
+      U_FAILURE(status)) {
+    return;
+  }
+
+  std::unique_ptr<UnicodeSet> tailored(_coll->getTailoredSet(status));
+
+  if (U_FAILURE(status) || tailored == nullptr) {
+    return;
+  }
+
+  UnicodeSetIterator it(*tailored);
+
+  while (it.nextRange()) {
+    if (it.isString()) {
+      if (it.getString().char32At(0) < 0x80) {
+        return;
+      }
+    }
+    else if (it.getCodepoint() < 0x80) {
+      return;
+    }
+  }
+
+  std::unique_ptr<Collator> coll(_coll->clone());
+
+  if (coll == nullptr) {
+    return;
+  }
+
+  static Collator::ECollationStrength const strengths[] = {
+    Collator::PRIMARY, Collator::SECONDARY, Collator::TERTIARY
+  };
+
+  for (size_t level = 0;  level < 3;  ++level) {
+    coll->setStrength(strengths[level]);
+
+    std::vector<UChar> order;
+    order.reserve(128);
+
+    for (UChar c = 0;  c < 128;  ++c) {
+      order.emplace_back(c);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&coll, &status] (UChar a, UChar b) {
+      return coll->compare(&a, 1, &b, 1, status) == UCOL_LESS;
+    });
+
+    UChar const* previous = nullptr;
+    int rank = 0;
+
+    for (auto const& c : order) {
+      if (coll->compare(&c, 1, &c, 0, status) == UCOL_EQUAL) {
+        // ignorable at this level
+        _asciiWeights[level][c] = 0;
+        continue;
+      }
+
+      if (previous == nullptr || coll->compare(previous, 1, &c, 1, status) != UCOL_EQUAL) {
+        ++rank;
+      }
+
+      _asciiWeights[level][c] = static_cast<uint8_t>(rank);
+      previous = &c;
+    }
+  }
+
+  if (U_FAILURE(status)) {
+    return;
+  }
+
+  // characters must be ignorable at all levels or at none
+  for (size_t c = 0;  c < 128;  ++c) {
+    if ((_asciiWeights[0][c] == 0) != (_asciiWeights[1][c] == 0) ||
+        (_asciiWeights[0][c] == 0) != (_asciiWeights[2][c] == 0)) {
+      return;
+    }
+  }
+
+  // verify the tables against the collator
+  std::vector<std::string> samples;
+
+  for (int c = 0;  c < 128;  ++c) {
+    samples.emplace_back(1, static_cast<char>(c));
+  }
+
+  char const alphabet[] = { '\x01', ' ', '-', '0', 'a', 'A', 'b', 'B' };
+
+  samples.emplace_back();
+
+  for (auto a : alphabet) {
+    for (auto b : alphabet) {
+      samples.emplace_back(std::string(1, a) + b);
+    }
+  }
+
+  for (auto const& left : samples) {
+    for (auto const& right : samples) {
+      int expected = _coll->compareUTF8(StringPiece(left.c_str(), (int32_t) left.size()),
+                                        StringPiece(right.c_str(), (int32_t) right.size()),
+                                        status);
+
+      if (U_FAILURE(status) ||
+          expected != compareAscii(left.c_str(), left.size(), right.c_str(), right.size())) {
+        LOG_DEBUG("ASCII collation tables do not match the collator, not using them");
+        return;
+      }
+    }
+  }
+
+  _asciiCollation = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two ASCII strings using the collation weight tables
+///
+/// the strings are compared level by level, skipping ignorable characters,
+/// like the collator does. the identical level compares code points, which
+/// are the bytes for ASCII
+////////////////////////////////////////////////////////////////////////////////
+
+int Utf8Helper::compareAscii (char const* left,
+                              size_t leftLength,
+                              char const* right,
+                              size_t rightLength) const {
+  // a common prefix has the same weights on all levels
+  size_t const n = (std::min)(leftLength, rightLength);
+  size_t prefix = 0;
+
+  while (prefix < n && left[prefix] == right[prefix]) {
+    ++prefix;
+  }
+
+  if (prefix == n && leftLength == rightLength) {
+    return 0;
+  }
+
+  for (size_t level = 0;  level < 3;  ++level) {
+    uint8_t const* weights = _asciiWeights[level];
+    size_t i = prefix;
+    size_t j = prefix;
+
+    while (true) {
+      while (i < leftLength && weights[static_cast<uint8_t>(left[i])] == 0) {
+        ++i;
+      }
+
+      while (j < rightLength && weights[static_cast<uint8_t>(right[j])] == 0) {
+        ++j;
+      }
+
+      if (i == leftLength || j == rightLength) {
+        if (i < leftLength) {
+          return 1;
+        }
+        if (j < rightLength) {
+          return -1;
+        }
+        break;
+      }
+
+      uint8_t const l = weights[static_cast<uint8_t>(left[i])];
+      uint8_t const r = weights[static_cast<uint8_t>(right[j])];
+
+      if (l != r) {
+        return (l < r) ? -1 : 1;
+      }
+
+      ++i;
+      ++j;
+    }
+  }
+
+  if (prefix < n) {
+    return (static_cast<uint8_t>(left[prefix]) < static_cast<uint8_t>(right[prefix])) ? -1 : 1;
+  }
+
+  return (leftLength < rightLength) ? -1 : 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compare two utf16 strings
 ////////////////////////////////////////////////////////////////////////////////
@@ -742,6 +1143,16 @@ int TRI_compare_utf8 (char const* left,
   return Utf8Helper::DefaultUtf8Helper.compareUtf8(left, leftLength, right, rightLength);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the sort key of a utf8 string
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AppendSortKeyUtf8 (char const* value,
+                            size_t length,
+                            std::string& result) {
+  Utf8Helper::DefaultUtf8Helper.appendSortKey(value, length, result);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Lowercase the characters in a UTF-8 string (implemented in Basic/Utf8Helper.cpp)
 ////////////////////////////////////////////////////////////////////////////////
@@ -893,6 +1304,18 @@ char* TRI_normalize_utf8_to_NFC (TRI_memory_zone_t* zone,
     return utf8Dest;
   }
 
+  if (IsAscii(utf8, inLength)) {
+    // ASCII text is always in NFC
+    utf8Dest = static_cast<char*>(TRI_Allocate(zone, inLength + 1, false));
+
+    if (utf8Dest != nullptr) {
+      memcpy(utf8Dest, utf8, inLength);
+      utf8Dest[inLength] = '\0';
+      *outLength = inLength;
+    }
+    return utf8Dest;
+  }
+
   UChar* utf16 = TRI_Utf8ToUChar(zone, utf8, inLength, &utf16Length);
 
   if (utf16 == nullptr) {
@@ -925,6 +1348,26 @@ char* TRI_normalize_utf16_to_NFC (TRI_memory_zone_t* zone,
     return utf8Dest;
   }
 
+  uint16_t bits = 0;
+
+  for (size_t i = 0;  i < inLength;  ++i) {
+    bits |= utf16[i];
+  }
+
+  if (bits < 0x80) {
+    // ASCII text is always in NFC and converts to UTF-8 byte by byte
+    utf8Dest = static_cast<char*>(TRI_Allocate(zone, inLength + 1, false));
+
+    if (utf8Dest != nullptr) {
+      for (size_t i = 0;  i < inLength;  ++i) {
+        utf8Dest[i] = static_cast<char>(utf16[i]);
+      }
+      utf8Dest[inLength] = '\0';
+      *outLength = inLength;
+    }
+    return utf8Dest;
+  }
+
   UErrorCode status = U_ZERO_ERROR;
   UNormalizer2 const* norm2 = unorm2_getInstance(nullptr, "nfc", UNORM2_COMPOSE, &status);
 
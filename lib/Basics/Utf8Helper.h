@@ -99,6 +99,18 @@ namespace triagens {
                          char const* right,
                          size_t rightLength) const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the collation sort key of a utf8 string to result
+///
+/// comparing two sort keys with memcmp gives the same order as compareUtf8.
+/// the key ends with a NUL byte and contains no other NUL bytes, so that
+/// no key is a prefix of another one
+////////////////////////////////////////////////////////////////////////////////
+
+        void appendSortKey (char const* value,
+                            size_t length,
+                            std::string& result) const;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compare utf16 strings
 /// -1 : left < right
@@ -204,7 +216,49 @@ namespace triagens {
 
       private:
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets up the ASCII fast paths for the current collator
+////////////////////////////////////////////////////////////////////////////////
+
+        void initAsciiTables ();
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compares two ASCII strings using the collation weight tables
+////////////////////////////////////////////////////////////////////////////////
+
+        int compareAscii (char const* left,
+                          size_t leftLength,
+                          char const* right,
+                          size_t rightLength) const;
+
+      private:
+
         Collator* _coll;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether ASCII text can be case-mapped without ICU
+///
+/// false for locales with special rules for ASCII letters, such as the
+/// dotted and dotless i in Turkish
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _asciiCaseMapping;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether ASCII strings can be compared with _asciiWeights
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _asciiCollation;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief collation weights of the ASCII characters
+///
+/// one table each for the primary, secondary and tertiary level. a weight
+/// is the rank of the character among all ASCII characters when compared
+/// with the collator at that strength, 0 means ignorable
+////////////////////////////////////////////////////////////////////////////////
+
+        uint8_t _asciiWeights[3][128];
     };
 
   }
@@ -275,6 +329,14 @@ int TRI_compare_utf8 (char const* left,
                       char const* right, 
                       size_t rightLength);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief append the sort key of a utf8 string (implemented in Basic/Utf8Helper.cpp)
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AppendSortKeyUtf8 (char const* value,
+                            size_t length,
+                            std::string& result);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief Lowercase the characters in a UTF-8 string (implemented in Basic/Utf8Helper.cpp)
 ////////////////////////////////////////////////////////////////////////////////
@@ -47,40 +47,94 @@ using namespace triagens::basics;
 /// The constructors aquires a write lock, the destructors unlocks the lock.
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 WriteLocker::WriteLocker (ReadWriteLock* readWriteLock, char const* file, int line)
-  : _readWriteLock(readWriteLock), _file(file), _line(line) {
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr), _file(file), _line(line) {
 
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::WRITE);
+#endif
+
   _readWriteLock->writeLock();
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else 
 
 WriteLocker::WriteLocker (ReadWriteLock* readWriteLock)
-  : _readWriteLock(readWriteLock) {
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr) {
   
   _readWriteLock->writeLock();
 }
 
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief aquires a write-lock on a distributed read-write lock
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef TRI_TRACK_LOCK_SITES
+
+WriteLocker::WriteLocker (DistributedReadWriteLock* readWriteLock, char const* file, int line)
+  : _readWriteLock(nullptr), _distributedLock(readWriteLock), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
+  double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::WRITE);
+#endif
+
+  _distributedLock->writeLock();
+
+#ifdef TRI_SHOW_LOCK_TIME
+  _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
+}
+
+#else
+
+WriteLocker::WriteLocker (DistributedReadWriteLock* readWriteLock)
+  : _readWriteLock(nullptr), _distributedLock(readWriteLock) {
+
+  _distributedLock->writeLock();
+}
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief aquires a write-lock, with periodic sleeps while not acquired
 /// sleep time is specified in nanoseconds
 ////////////////////////////////////////////////////////////////////////////////
 
-#ifdef TRI_SHOW_LOCK_TIME
+#ifdef TRI_TRACK_LOCK_SITES
 
 WriteLocker::WriteLocker (ReadWriteLock* readWriteLock, 
                           uint64_t sleepTime,
                           char const* file,
                           int line) 
-  : _readWriteLock(readWriteLock), _file(file), _line(line) {
-  
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr), _file(file), _line(line) {
+
+#ifdef TRI_SHOW_LOCK_TIME
   double t = TRI_microtime();
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquire(file, line, LockSite::WRITE);
+#endif
+
   while (! _readWriteLock->tryWriteLock()) {
 #ifdef _WIN32
     usleep((unsigned long) sleepTime);
@@ -88,14 +142,20 @@ WriteLocker::WriteLocker (ReadWriteLock* readWriteLock,
     usleep((useconds_t) sleepTime);
 #endif
   }
+
+#ifdef TRI_SHOW_LOCK_TIME
   _time = TRI_microtime() - t;
+#endif
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.acquired();
+#endif
 }
 
 #else
 
 WriteLocker::WriteLocker (ReadWriteLock* readWriteLock, 
                           uint64_t sleepTime) 
-  : _readWriteLock(readWriteLock) {
+  : _readWriteLock(readWriteLock), _distributedLock(nullptr) {
   
   while (! _readWriteLock->tryWriteLock()) {
 #ifdef _WIN32
@@ -113,7 +173,16 @@ WriteLocker::WriteLocker (ReadWriteLock* readWriteLock,
 ////////////////////////////////////////////////////////////////////////////////
 
 WriteLocker::~WriteLocker () {
-  _readWriteLock->unlock();
+  if (_distributedLock != nullptr) {
+    _distributedLock->unlock();
+  }
+  else {
+    _readWriteLock->unlock();
+  }
+
+#ifdef TRI_ENABLE_LOCK_PROFILER
+  _timer.released();
+#endif
 
 #ifdef TRI_SHOW_LOCK_TIME
   if (_time > TRI_SHOW_LOCK_THRESHOLD) {
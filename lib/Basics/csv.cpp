@@ -29,6 +29,71 @@
 
 #include "csv.h"
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define TRI_CSV_SSE2 1
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the position of the first occurrence of a, b or c in
+/// [ptr, stop), or stop if there is none
+///
+/// fields are mostly plain text, so this checks 16 bytes at a time where SSE2
+/// is available, and the state machine only looks at the bytes found here
+////////////////////////////////////////////////////////////////////////////////
+
+static char* FindSpecial (char* ptr,
+                          char const* stop,
+                          char a,
+                          char b,
+                          char c) {
+#ifdef TRI_CSV_SSE2
+  __m128i const va = _mm_set1_epi8(a);
+  __m128i const vb = _mm_set1_epi8(b);
+  __m128i const vc = _mm_set1_epi8(c);
+
+  while (stop - ptr >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+    __m128i const special = _mm_or_si128(_mm_cmpeq_epi8(chunk, va),
+                                         _mm_or_si128(_mm_cmpeq_epi8(chunk, vb), _mm_cmpeq_epi8(chunk, vc)));
+    int const mask = _mm_movemask_epi8(special);
+
+    if (mask != 0) {
+      return ptr + __builtin_ctz(mask);
+    }
+
+    ptr += 16;
+  }
+#endif
+
+  while (ptr < stop && *ptr != a && *ptr != b && *ptr != c) {
+    ++ptr;
+  }
+
+  return ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief moves the plain characters of a field to the write position
+///
+/// the write position only falls behind the read position after an escaped
+/// quote, so most fields are not copied at all
+////////////////////////////////////////////////////////////////////////////////
+
+static inline char* CopyPlain (char* qtr,
+                               char const* ptr,
+                               char const* next) {
+  if (qtr != ptr) {
+    memmove(qtr, ptr, next - ptr);
+  }
+
+  return qtr + (next - ptr);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                      constructors and destructors
 // -----------------------------------------------------------------------------
@@ -265,9 +330,7 @@ int TRI_ParseCsvString (TRI_csv_parser_t* parser, char const* line, size_t lengt
           break;
 
         case TRI_CSV_PARSER_CORRUPTED:
-          while (ptr < parser->_stop && *ptr != parser->_separator && *ptr != '\n') {
-            ptr++;
-          }
+          ptr = FindSpecial(ptr, parser->_stop, parser->_separator, '\n', '\n');
 
           // found separator or eol
           if (ptr < parser->_stop) {
@@ -297,10 +360,10 @@ int TRI_ParseCsvString (TRI_csv_parser_t* parser, char const* line, size_t lengt
 
           break;
 
-        case TRI_CSV_PARSER_WITHIN_FIELD:
-          while (ptr < parser->_stop && *ptr != parser->_separator && *ptr != '\r' && *ptr != '\n') {
-            *qtr++ = *ptr++;
-          }
+        case TRI_CSV_PARSER_WITHIN_FIELD: {
+          char* next = FindSpecial(ptr, parser->_stop, parser->_separator, '\r', '\n');
+          qtr = CopyPlain(qtr, ptr, next);
+          ptr = next;
 
           // found separator or eol
           if (ptr < parser->_stop) {
@@ -342,15 +405,15 @@ int TRI_ParseCsvString (TRI_csv_parser_t* parser, char const* line, size_t lengt
           }
 
           break;
+        }
 
-        case TRI_CSV_PARSER_WITHIN_QUOTED_FIELD:
+        case TRI_CSV_PARSER_WITHIN_QUOTED_FIELD: {
           TRI_ASSERT(parser->_useQuote);
 
-          while (ptr < parser->_stop && 
-                 *ptr != parser->_quote && 
-                 (! parser->_useBackslash || *ptr != '\\')) {
-            *qtr++ = *ptr++;
-          }
+          char const escape = (parser->_useBackslash ? '\\' : parser->_quote);
+          char* next = FindSpecial(ptr, parser->_stop, parser->_quote, escape, escape);
+          qtr = CopyPlain(qtr, ptr, next);
+          ptr = next;
 
           // found quote or a backslash, need at least another quote, a separator, or an eol
           if (ptr + 1 < parser->_stop) {
@@ -420,6 +483,7 @@ int TRI_ParseCsvString (TRI_csv_parser_t* parser, char const* line, size_t lengt
           }
 
           break;
+        }
       }
     }
   }
@@ -29,6 +29,8 @@
 
 #include "hashes.h"
 
+#include "Basics/fasthash.h"
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                               FNV
 // -----------------------------------------------------------------------------
@@ -524,6 +526,316 @@ uint32_t TRI_Crc32HashString (char const* data) {
   return TRI_FinalCrc32(crc);
 }
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                            CRC32C
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lookup values for the CRC32C 8 bytes-at-a-time calculation
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t Crc32CLookup[8][256];
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates the CRC32C lookup values
+////////////////////////////////////////////////////////////////////////////////
+
+static void GenerateCrc32CLookup () {
+  // the reflected Castagnoli polynomial
+  uint32_t const polynomial = 0x82F63B78;
+
+  for (uint32_t i = 0; i < 256; ++i) {
+    uint32_t crc = i;
+
+    for (int j = 0; j < 8; ++j) {
+      crc = (crc >> 1) ^ ((crc & 1) ? polynomial : 0);
+    }
+
+    Crc32CLookup[0][i] = crc;
+  }
+
+  for (uint32_t i = 0; i < 256; ++i) {
+    for (int k = 1; k < 8; ++k) {
+      uint32_t const previous = Crc32CLookup[k - 1][i];
+      Crc32CLookup[k][i] = (previous >> 8) ^ Crc32CLookup[0][previous & 0xFF];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CRC32C value of data block, in software
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t BlockCrc32CSoftware (uint32_t value, char const* data, size_t length) {
+  uint32_t const* current = (uint32_t const*) data;
+
+  // process eight bytes at once
+  while (length >= 8) {
+    uint32_t one = *current++ ^ value;
+    uint32_t two = *current++;
+
+    value = Crc32CLookup[0][(two>>24) & 0xFF] ^
+            Crc32CLookup[1][(two>>16) & 0xFF] ^
+            Crc32CLookup[2][(two>> 8) & 0xFF] ^
+            Crc32CLookup[3][ two      & 0xFF] ^
+            Crc32CLookup[4][(one>>24) & 0xFF] ^
+            Crc32CLookup[5][(one>>16) & 0xFF] ^
+            Crc32CLookup[6][(one>> 8) & 0xFF] ^
+            Crc32CLookup[7][ one      & 0xFF];
+    length -= 8;
+  }
+
+  uint8_t const* currentChar = (uint8_t const*) current;
+
+  while (length--) {
+    value = (value >> 8) ^ Crc32CLookup[0][(value & 0xFF) ^ *currentChar++];
+  }
+
+  return value;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#define TRI_CRC32C_SSE42 1
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CRC32C value of data block, with the SSE4.2 instructions
+///
+/// the function is compiled for SSE4.2 regardless of the target architecture,
+/// and only called if the CPU supports it
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("sse4.2")))
+static uint32_t BlockCrc32CSse42 (uint32_t value, char const* data, size_t length) {
+  // process single bytes until the data is aligned
+  while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+    value = __builtin_ia32_crc32qi(value, static_cast<uint8_t>(*data++));
+    --length;
+  }
+
+#ifdef __x86_64__
+  uint64_t wide = value;
+
+  while (length >= 8) {
+    wide = __builtin_ia32_crc32di(wide, *reinterpret_cast<uint64_t const*>(data));
+    data += 8;
+    length -= 8;
+  }
+
+  value = static_cast<uint32_t>(wide);
+#endif
+
+  while (length >= 4) {
+    value = __builtin_ia32_crc32si(value, *reinterpret_cast<uint32_t const*>(data));
+    data += 4;
+    length -= 4;
+  }
+
+  while (length > 0) {
+    value = __builtin_ia32_crc32qi(value, static_cast<uint8_t>(*data++));
+    --length;
+  }
+
+  return value;
+}
+
+#elif defined(__ARM_FEATURE_CRC32)
+
+#include <arm_acle.h>
+
+#define TRI_CRC32C_ARMV8 1
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CRC32C value of data block, with the ARMv8 CRC32 instructions
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t BlockCrc32CArmv8 (uint32_t value, char const* data, size_t length) {
+  // process single bytes until the data is aligned
+  while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0) {
+    value = __crc32cb(value, static_cast<uint8_t>(*data++));
+    --length;
+  }
+
+  while (length >= 8) {
+    value = __crc32cd(value, *reinterpret_cast<uint64_t const*>(data));
+    data += 8;
+    length -= 8;
+  }
+
+  while (length > 0) {
+    value = __crc32cb(value, static_cast<uint8_t>(*data++));
+    --length;
+  }
+
+  return value;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the CRC32C implementation, selected in TRI_InitializeHashes
+////////////////////////////////////////////////////////////////////////////////
+
+static uint32_t (*BlockCrc32CImplementation) (uint32_t, char const*, size_t) = BlockCrc32CSoftware;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief selects the fastest CRC32C implementation the CPU supports
+////////////////////////////////////////////////////////////////////////////////
+
+static void SelectCrc32CImplementation () {
+#if defined(TRI_CRC32C_SSE42)
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("sse4.2")) {
+    BlockCrc32CImplementation = BlockCrc32CSse42;
+    return;
+  }
+#elif defined(TRI_CRC32C_ARMV8)
+  BlockCrc32CImplementation = BlockCrc32CArmv8;
+  return;
+#endif
+
+  BlockCrc32CImplementation = BlockCrc32CSoftware;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CRC32C value of data block
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_BlockCrc32C (uint32_t value, char const* data, size_t length) {
+  return BlockCrc32CImplementation(value, data, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether CRC32C is computed by the CPU
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_HardwareCrc32C () {
+  return BlockCrc32CImplementation != BlockCrc32CSoftware;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       MEMORY HASH
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplies two 64 bit values. afterwards, a holds the lower and b
+/// the upper 64 bits of the product
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void MemoryHashMultiply (uint64_t& a, uint64_t& b) {
+#ifdef __SIZEOF_INT128__
+  __uint128_t r = a;
+  r *= b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#else
+  uint64_t const aLow = a & 0xffffffffULL;
+  uint64_t const aHigh = a >> 32;
+  uint64_t const bLow = b & 0xffffffffULL;
+  uint64_t const bHigh = b >> 32;
+
+  uint64_t const ll = aLow * bLow;
+  uint64_t const lh = aLow * bHigh;
+  uint64_t const hl = aHigh * bLow;
+  uint64_t const hh = aHigh * bHigh;
+
+  uint64_t const middle = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+
+  a = (ll & 0xffffffffULL) | (middle << 32);
+  b = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplies two 64 bit values and folds the 128 bit product
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t MemoryHashMix (uint64_t a, uint64_t b) {
+  MemoryHashMultiply(a, b);
+  return a ^ b;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads 8 bytes from a possibly unaligned address
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t MemoryHashRead (uint8_t const* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes a 64 bit hash for a memory block
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_MemoryHash64 (void const* buffer, size_t length, uint64_t seed) {
+  static uint64_t const P0 = 0xa0761d6478bd642fULL;
+  static uint64_t const P1 = 0xe7037ed1a0b428dbULL;
+  static uint64_t const P2 = 0x8ebc6af09c88c6e3ULL;
+  static uint64_t const P3 = 0x589965cc75374cc3ULL;
+
+  if (length < 32) {
+    // the multiplications do not pay off for short blocks
+    return fasthash64(buffer, length, seed);
+  }
+
+  uint8_t const* p = static_cast<uint8_t const*>(buffer);
+  size_t i = length;
+
+  seed ^= MemoryHashMix(seed ^ P0, P1);
+
+  if (i > 48) {
+    uint64_t seed1 = seed;
+    uint64_t seed2 = seed;
+
+    do {
+      seed = MemoryHashMix(MemoryHashRead(p) ^ P1, MemoryHashRead(p + 8) ^ seed);
+      seed1 = MemoryHashMix(MemoryHashRead(p + 16) ^ P2, MemoryHashRead(p + 24) ^ seed1);
+      seed2 = MemoryHashMix(MemoryHashRead(p + 32) ^ P3, MemoryHashRead(p + 40) ^ seed2);
+      p += 48;
+      i -= 48;
+    }
+    while (i > 48);
+
+    seed ^= seed1 ^ seed2;
+  }
+
+  while (i > 16) {
+    seed = MemoryHashMix(MemoryHashRead(p) ^ P1, MemoryHashRead(p + 8) ^ seed);
+    p += 16;
+    i -= 16;
+  }
+
+  // the last 16 bytes, possibly overlapping with bytes already hashed
+  uint64_t a = MemoryHashRead(p + i - 16) ^ P1;
+  uint64_t b = MemoryHashRead(p + i - 8) ^ seed;
+  MemoryHashMultiply(a, b);
+
+  return MemoryHashMix(a ^ P0 ^ static_cast<uint64_t>(length), b ^ P1);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                            MODULE
 // -----------------------------------------------------------------------------
@@ -552,6 +864,8 @@ void TRI_InitializeHashes () {
   }
 
   GenerateCrc32Polynomial();
+  GenerateCrc32CLookup();
+  SelectCrc32CImplementation();
 
   Initialized = true;
 }
@@ -102,6 +102,51 @@ uint32_t TRI_Crc32HashPointer (void const*, size_t);
 
 uint32_t TRI_Crc32HashString (char const*);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                            CRC32C
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief CRC32C value of data block
+///
+/// uses the Castagnoli polynomial. the initial and final values are the same
+/// as for CRC32. the CRC32 instructions of SSE4.2 or ARMv8 are used if the
+/// CPU has them
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t TRI_BlockCrc32C (uint32_t, char const* data, size_t length);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether CRC32C is computed by the CPU
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_HardwareCrc32C ();
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       MEMORY HASH
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief computes a 64 bit hash for a memory block, for use in in-memory
+/// hash tables
+///
+/// blocks of 32 bytes and more are hashed 16 bytes at a time with 64x64->128
+/// bit multiplications in three independent lanes, which is about three times
+/// faster than fasthash64 for 256 bytes. shorter blocks are hashed with
+/// fasthash64. the values may change between versions, so they must not be
+/// persisted or used for data distribution
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_MemoryHash64 (void const*, size_t, uint64_t seed);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                            MODULE
 // -----------------------------------------------------------------------------
@@ -0,0 +1,594 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief binary json encoding
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/json-binary.h"
+#include "Basics/string-buffer.h"
+#include "Basics/tri-strings.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private constants
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief value tags
+////////////////////////////////////////////////////////////////////////////////
+
+enum {
+  TAG_NULL         = 0x00,
+  TAG_FALSE        = 0x01,
+  TAG_TRUE         = 0x02,
+  TAG_DOUBLE       = 0x03,
+  TAG_POSITIVE_INT = 0x04,
+  TAG_NEGATIVE_INT = 0x05,
+  TAG_STRING       = 0x06,
+  TAG_ARRAY        = 0x07,
+  TAG_OBJECT       = 0x08
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest magnitude of integers that are encoded as varints
+////////////////////////////////////////////////////////////////////////////////
+
+static double const MaxSafeInteger = 9007199254740992.0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal nesting depth accepted by the decoder
+////////////////////////////////////////////////////////////////////////////////
+
+static int const MaxDepth = 512;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief empty string, referenced by empty string values
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* EmptyString = "";
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decoder state
+////////////////////////////////////////////////////////////////////////////////
+
+struct binary_json_reader_t {
+  TRI_memory_zone_t* _memoryZone;
+  uint8_t const*     _position;
+  uint8_t const*     _end;
+  char const*        _message;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a varint
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendVarint (TRI_string_buffer_t* buffer, uint64_t value) {
+  int res = TRI_ReserveStringBuffer(buffer, 10);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  while (value >= 0x80) {
+    *buffer->_current++ = (char) ((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+
+  *buffer->_current++ = (char) value;
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a length-prefixed string without a tag
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendBytes (TRI_string_buffer_t* buffer,
+                        char const* value,
+                        size_t length) {
+  int res = AppendVarint(buffer, (uint64_t) length);
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  return TRI_AppendString2StringBuffer(buffer, value, length);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a number
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendNumber (TRI_string_buffer_t* buffer, double value) {
+  // integral values are stored as varints, except for -0.0
+  if (value >= - MaxSafeInteger &&
+      value <= MaxSafeInteger &&
+      value == (double) (int64_t) value &&
+      (value != 0.0 || ! std::signbit(value))) {
+    if (value >= 0.0) {
+      int res = TRI_AppendCharStringBuffer(buffer, (char) TAG_POSITIVE_INT);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      return AppendVarint(buffer, (uint64_t) value);
+    }
+
+    int res = TRI_AppendCharStringBuffer(buffer, (char) TAG_NEGATIVE_INT);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      return res;
+    }
+
+    return AppendVarint(buffer, (uint64_t) (- value));
+  }
+
+  int res = TRI_ReserveStringBuffer(buffer, 1 + sizeof(uint64_t));
+
+  if (res != TRI_ERROR_NO_ERROR) {
+    return res;
+  }
+
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  *buffer->_current++ = (char) TAG_DOUBLE;
+
+  for (size_t i = 0; i < sizeof(bits); ++i) {
+    *buffer->_current++ = (char) (bits & 0xff);
+    bits >>= 8;
+  }
+
+  return TRI_ERROR_NO_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a value
+////////////////////////////////////////////////////////////////////////////////
+
+static int AppendValue (TRI_string_buffer_t* buffer,
+                        TRI_json_t const* json) {
+  switch (json->_type) {
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL:
+      return TRI_AppendCharStringBuffer(buffer, (char) TAG_NULL);
+
+    case TRI_JSON_BOOLEAN:
+      return TRI_AppendCharStringBuffer(buffer, (char) (json->_value._boolean ? TAG_TRUE : TAG_FALSE));
+
+    case TRI_JSON_NUMBER:
+      return AppendNumber(buffer, json->_value._number);
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      int res = TRI_AppendCharStringBuffer(buffer, (char) TAG_STRING);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      // the stored length includes the terminating null byte
+      return AppendBytes(buffer, json->_value._string.data, json->_value._string.length - 1);
+    }
+
+    case TRI_JSON_ARRAY: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+
+      int res = TRI_AppendCharStringBuffer(buffer, (char) TAG_ARRAY);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = AppendVarint(buffer, (uint64_t) n);
+      }
+
+      for (size_t i = 0; i < n && res == TRI_ERROR_NO_ERROR; ++i) {
+        res = AppendValue(buffer, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i)));
+      }
+
+      return res;
+    }
+
+    case TRI_JSON_OBJECT: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+
+      int res = TRI_AppendCharStringBuffer(buffer, (char) TAG_OBJECT);
+
+      if (res == TRI_ERROR_NO_ERROR) {
+        res = AppendVarint(buffer, (uint64_t) (n / 2));
+      }
+
+      for (size_t i = 0; i + 1 < n && res == TRI_ERROR_NO_ERROR; i += 2) {
+        auto name = static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i));
+
+        res = AppendBytes(buffer, name->_value._string.data, name->_value._string.length - 1);
+
+        if (res == TRI_ERROR_NO_ERROR) {
+          res = AppendValue(buffer, static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i + 1)));
+        }
+      }
+
+      return res;
+    }
+  }
+
+  return TRI_ERROR_INTERNAL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a varint
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadVarint (binary_json_reader_t* reader, uint64_t* value) {
+  uint64_t result = 0;
+  int shift = 0;
+
+  while (reader->_position < reader->_end && shift < 64) {
+    uint8_t const c = *reader->_position++;
+
+    result |= ((uint64_t) (c & 0x7f)) << shift;
+
+    if ((c & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+
+    shift += 7;
+  }
+
+  reader->_message = "corrupted length";
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the length of a string and checks it against the input
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadLength (binary_json_reader_t* reader, size_t* length) {
+  uint64_t value;
+
+  if (! ReadVarint(reader, &value)) {
+    return false;
+  }
+
+  if (value > (uint64_t) (reader->_end - reader->_position)) {
+    reader->_message = "unexpected end of input";
+    return false;
+  }
+
+  *length = (size_t) value;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the element count of an array or object
+///
+/// Every element takes at least one byte of input, so larger counts are
+/// rejected before anything is allocated for them.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadCount (binary_json_reader_t* reader,
+                       size_t bytesPerElement,
+                       size_t* count) {
+  uint64_t value;
+
+  if (! ReadVarint(reader, &value)) {
+    return false;
+  }
+
+  if (value > (uint64_t) (reader->_end - reader->_position) / bytesPerElement) {
+    reader->_message = "unexpected end of input";
+    return false;
+  }
+
+  *count = (size_t) value;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a value
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadValue (binary_json_reader_t* reader,
+                       TRI_json_t* result,
+                       int depth) {
+  if (reader->_position >= reader->_end) {
+    reader->_message = "unexpected end of input";
+    return false;
+  }
+
+  switch (*reader->_position++) {
+    case TAG_NULL:
+      TRI_InitNullJson(result);
+      return true;
+
+    case TAG_FALSE:
+      TRI_InitBooleanJson(result, false);
+      return true;
+
+    case TAG_TRUE:
+      TRI_InitBooleanJson(result, true);
+      return true;
+
+    case TAG_DOUBLE: {
+      if (reader->_end - reader->_position < (ptrdiff_t) sizeof(uint64_t)) {
+        reader->_message = "unexpected end of input";
+        return false;
+      }
+
+      uint64_t bits = 0;
+
+      for (size_t i = 0; i < sizeof(bits); ++i) {
+        bits |= ((uint64_t) reader->_position[i]) << (8 * i);
+      }
+
+      reader->_position += sizeof(bits);
+
+      double value;
+      memcpy(&value, &bits, sizeof(value));
+
+      if (std::isnan(value) || std::isinf(value)) {
+        reader->_message = "invalid number";
+        return false;
+      }
+
+      TRI_InitNumberJson(result, value);
+      return true;
+    }
+
+    case TAG_POSITIVE_INT:
+    case TAG_NEGATIVE_INT: {
+      bool const negative = (reader->_position[-1] == TAG_NEGATIVE_INT);
+      uint64_t value;
+
+      if (! ReadVarint(reader, &value)) {
+        return false;
+      }
+
+      TRI_InitNumberJson(result, negative ? - (double) value : (double) value);
+      return true;
+    }
+
+    case TAG_STRING: {
+      size_t length;
+
+      if (! ReadLength(reader, &length)) {
+        return false;
+      }
+
+      if (length == 0) {
+        TRI_InitStringReferenceJson(result, EmptyString, 0);
+        return true;
+      }
+
+      char* value = TRI_DuplicateString2Z(reader->_memoryZone, (char const*) reader->_position, length);
+
+      if (value == nullptr) {
+        reader->_message = "out-of-memory";
+        return false;
+      }
+
+      reader->_position += length;
+
+      TRI_InitStringJson(result, value, length);
+      return true;
+    }
+
+    case TAG_ARRAY: {
+      size_t n;
+
+      if (depth >= MaxDepth) {
+        reader->_message = "nesting too deep";
+        return false;
+      }
+
+      if (! ReadCount(reader, 1, &n)) {
+        return false;
+      }
+
+      TRI_InitArrayJson(reader->_memoryZone, result, n);
+
+      for (size_t i = 0; i < n; ++i) {
+        TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+
+        if (next == nullptr) {
+          reader->_message = "out-of-memory";
+          return false;
+        }
+
+        TRI_InitNullJson(next);
+
+        if (! ReadValue(reader, next, depth + 1)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    case TAG_OBJECT: {
+      size_t n;
+
+      if (depth >= MaxDepth) {
+        reader->_message = "nesting too deep";
+        return false;
+      }
+
+      // a name takes at least one byte and a value another one
+      if (! ReadCount(reader, 2, &n)) {
+        return false;
+      }
+
+      TRI_InitObjectJson(reader->_memoryZone, result, n);
+
+      for (size_t i = 0; i < n; ++i) {
+        size_t length;
+
+        if (! ReadLength(reader, &length)) {
+          return false;
+        }
+
+        char* name = TRI_DuplicateString2Z(reader->_memoryZone, (char const*) reader->_position, length);
+
+        if (name == nullptr) {
+          reader->_message = "out-of-memory";
+          return false;
+        }
+
+        reader->_position += length;
+
+        // allocate room for name and value at once
+        if (TRI_ReserveVector(&result->_value._objects, 2) != TRI_ERROR_NO_ERROR) {
+          TRI_FreeString(reader->_memoryZone, name);
+          reader->_message = "out-of-memory";
+          return false;
+        }
+
+        TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+        TRI_ASSERT_EXPENSIVE(next != nullptr);
+        TRI_InitStringJson(next, name, length);
+
+        next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+        TRI_ASSERT_EXPENSIVE(next != nullptr);
+        TRI_InitNullJson(next);
+
+        if (! ReadValue(reader, next, depth + 1)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+  }
+
+  reader->_message = "unknown value tag";
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the binary encoding of a json value to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_StringifyBinaryJson (TRI_string_buffer_t* buffer,
+                             TRI_json_t const* json) {
+  return AppendValue(buffer, json);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a binary json value
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_BinaryJson (TRI_memory_zone_t* zone,
+                            char const* data,
+                            size_t length,
+                            char** error) {
+  TRI_json_t* json = static_cast<TRI_json_t*>(TRI_Allocate(zone, sizeof(TRI_json_t), false));
+
+  if (json == nullptr) {
+    if (error != nullptr) {
+      *error = TRI_DuplicateString("out-of-memory");
+    }
+
+    return nullptr;
+  }
+
+  // init as a JSON null object so the memory in json is initialized
+  TRI_InitNullJson(json);
+
+  binary_json_reader_t reader;
+  reader._memoryZone = zone;
+  reader._position   = reinterpret_cast<uint8_t const*>(data);
+  reader._end        = reader._position + length;
+  reader._message    = nullptr;
+
+  if (ReadValue(&reader, json, 0) && reader._position != reader._end) {
+    reader._message = "expecting end of input";
+  }
+
+  if (reader._message != nullptr) {
+    TRI_FreeJson(zone, json);
+    json = nullptr;
+  }
+
+  if (error != nullptr) {
+    *error = (reader._message != nullptr ? TRI_DuplicateString(reader._message) : nullptr);
+  }
+
+  return json;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a content type header denotes binary json
+///
+/// Also accepts lists of media ranges as sent in accept headers.
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_IsBinaryJsonContentType (char const* value) {
+  static size_t const length = sizeof(TRI_BINARY_JSON_CONTENT_TYPE) - 1;
+
+  if (value == nullptr) {
+    return false;
+  }
+
+  char const* p = value;
+
+  while (*p != '\0') {
+    while (*p == ' ' || *p == '\t' || *p == ',') {
+      ++p;
+    }
+
+    if (TRI_CaseEqualString2(p, TRI_BINARY_JSON_CONTENT_TYPE, length)) {
+      char const c = p[length];
+
+      if (c == '\0' || c == ';' || c == ',' || c == ' ' || c == '\t') {
+        return true;
+      }
+    }
+
+    // skip to the next media range
+    while (*p != '\0' && *p != ',') {
+      ++p;
+    }
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
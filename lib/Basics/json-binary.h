@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief binary json encoding
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_BASICS_C_JSON_BINARY_H
+#define ARANGODB_BASICS_C_JSON_BINARY_H 1
+
+#include "Basics/Common.h"
+#include "Basics/json.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       BINARY JSON
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief content type of binary json request and response bodies
+///
+/// Each value starts with a one byte tag, followed by its payload. Lengths
+/// and counts are unsigned LEB128 varints, doubles are little endian IEEE 754.
+///
+/// - 0x00: null
+/// - 0x01: false
+/// - 0x02: true
+/// - 0x03: double, 8 bytes
+/// - 0x04: integer >= 0 (up to 2^53), varint
+/// - 0x05: integer < 0 (down to -2^53), varint of its absolute value
+/// - 0x06: string, varint byte length followed by UTF-8 bytes
+/// - 0x07: array, varint element count followed by the elements
+/// - 0x08: object, varint attribute count followed by pairs of name (varint
+///   byte length and UTF-8 bytes, without a tag) and value
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_BINARY_JSON_CONTENT_TYPE "application/x-arango-binary"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the binary encoding of a json value to a buffer
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_StringifyBinaryJson (struct TRI_string_buffer_s*,
+                             TRI_json_t const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a binary json value
+///
+/// Returns nullptr if the data is not exactly one valid value. If error is
+/// given, it is set to a message allocated in the core memory zone then.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_BinaryJson (TRI_memory_zone_t*,
+                            char const* data,
+                            size_t length,
+                            char** error);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a content type header denotes binary json
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_IsBinaryJsonContentType (char const*);
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -320,6 +320,124 @@ int TRI_CompareValuesJson (TRI_json_t const* lhs,
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the sort key of a json value to result
+///
+/// a key starts with a tag byte ordered like the type weights. numbers
+/// follow as 8 big endian bytes whose unsigned order is the numeric order,
+/// strings as their collation key, and arrays as the keys of their members
+/// followed by a 0 byte. an array ending with null values compares equal to
+/// the array without them, so trailing null values are left out
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_AppendSortKeyJson (TRI_json_t const* value,
+                            bool useUTF8,
+                            std::string& result) {
+  static char const TagNull   = 0x01;
+  static char const TagFalse  = 0x02;
+  static char const TagTrue   = 0x03;
+  static char const TagNumber = 0x04;
+  static char const TagString = 0x05;
+  static char const TagArray  = 0x06;
+
+  if (value == nullptr) {
+    result.push_back(TagNull);
+    return true;
+  }
+
+  switch (value->_type) {
+    case TRI_JSON_UNUSED:
+    case TRI_JSON_NULL: {
+      result.push_back(TagNull);
+      return true;
+    }
+
+    case TRI_JSON_BOOLEAN: {
+      result.push_back(value->_value._boolean ? TagTrue : TagFalse);
+      return true;
+    }
+
+    case TRI_JSON_NUMBER: {
+      double number = value->_value._number;
+
+      if (number == 0.0) {
+        // -0.0 and 0.0 are equal
+        number = 0.0;
+      }
+
+      uint64_t bits;
+      memcpy(&bits, &number, sizeof(bits));
+
+      if (bits & (static_cast<uint64_t>(1) << 63)) {
+        // negative numbers sort in reverse order of their magnitudes
+        bits = ~bits;
+      }
+      else {
+        bits |= (static_cast<uint64_t>(1) << 63);
+      }
+
+      result.push_back(TagNumber);
+
+      for (int shift = 56; shift >= 0; shift -= 8) {
+        result.push_back(static_cast<char>((bits >> shift) & 0xff));
+      }
+      return true;
+    }
+
+    case TRI_JSON_STRING:
+    case TRI_JSON_STRING_REFERENCE: {
+      result.push_back(TagString);
+
+      if (useUTF8) {
+        TRI_AppendSortKeyUtf8(value->_value._string.data,
+                              value->_value._string.length - 1,
+                              result);
+      }
+      else {
+        // strcmp stops at the first NUL byte
+        result.append(value->_value._string.data);
+        result.push_back('\0');
+      }
+      return true;
+    }
+
+    case TRI_JSON_ARRAY: {
+      size_t n = TRI_LengthVector(&value->_value._objects);
+
+      while (n > 0) {
+        auto last = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, n - 1));
+
+        if (last->_type != TRI_JSON_NULL && last->_type != TRI_JSON_UNUSED) {
+          break;
+        }
+        --n;
+      }
+
+      result.push_back(TagArray);
+
+      for (size_t i = 0; i < n; ++i) {
+        auto member = static_cast<TRI_json_t const*>(TRI_AtVector(&value->_value._objects, i));
+
+        if (! TRI_AppendSortKeyJson(member, useUTF8, result)) {
+          return false;
+        }
+      }
+
+      // ends the array before any member
+      result.push_back('\0');
+      return true;
+    }
+
+    case TRI_JSON_OBJECT: {
+      // objects are compared attribute by attribute in the order of the
+      // union of their attribute names, which no key per value can encode
+      return false;
+    }
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check if two json values are the same
 ////////////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,20 @@ int TRI_CompareValuesJson (TRI_json_t const*,
                            TRI_json_t const*,
                            bool useUTF8 = true);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the sort key of a json value to result
+///
+/// comparing the sort keys of two values with memcmp gives the same result
+/// as TRI_CompareValuesJson with the same useUTF8 value. no sort key is a
+/// prefix of another one, so keys of several values can be concatenated.
+/// objects have no sort key: false is returned for them, and for arrays
+/// containing them, and result must not be used then
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_AppendSortKeyJson (TRI_json_t const*,
+                            bool useUTF8,
+                            std::string& result);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief check if two json values are the same
 ////////////////////////////////////////////////////////////////////////////////
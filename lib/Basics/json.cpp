@@ -512,9 +512,16 @@ void TRI_InitObjectJson (TRI_memory_zone_t* zone,
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief destroys a json object, but does not free the pointer
+///
+/// objects in arena zones are released with the zone, so there is no need to
+/// walk them
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_DestroyJson (TRI_memory_zone_t* zone, TRI_json_t* object) {
+  if (TRI_IsArenaMemoryZone(zone)) {
+    return;
+  }
+
   switch (object->_type) {
     case TRI_JSON_UNUSED:
     case TRI_JSON_NULL:
@@ -547,6 +554,10 @@ void TRI_DestroyJson (TRI_memory_zone_t* zone, TRI_json_t* object) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void TRI_FreeJson (TRI_memory_zone_t* zone, TRI_json_t* object) {
+  if (TRI_IsArenaMemoryZone(zone)) {
+    return;
+  }
+
   TRI_DestroyJson(zone, object);
   TRI_Free(zone, object);
 }
@@ -1132,6 +1143,34 @@ TRI_json_t* TRI_CopyJson (TRI_memory_zone_t* zone,
   return dst;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the approximate memory used by a json object
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_MemoryUsageJson (TRI_json_t const* json) {
+  size_t result = sizeof(TRI_json_t);
+
+  switch (json->_type) {
+    case TRI_JSON_STRING:
+      result += json->_value._string.length;
+      break;
+    case TRI_JSON_ARRAY:
+    case TRI_JSON_OBJECT: {
+      size_t const n = TRI_LengthVector(&json->_value._objects);
+
+      // the members are stored in the vector itself
+      for (size_t i = 0; i < n; ++i) {
+        result += TRI_MemoryUsageJson(static_cast<TRI_json_t const*>(TRI_AtVector(&json->_value._objects, i)));
+      }
+      break;
+    }
+    default:
+      break;
+  }
+
+  return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief converts a json object into a number
 ////////////////////////////////////////////////////////////////////////////////
@@ -389,6 +389,13 @@ int TRI_CopyToJson (TRI_memory_zone_t*, TRI_json_t* dst, TRI_json_t const* src);
 TRI_json_t* TRI_CopyJson (TRI_memory_zone_t*, 
                           TRI_json_t const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the approximate memory used by a json object, including
+/// the object itself
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_MemoryUsageJson (TRI_json_t const*);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief parses a json string
 ////////////////////////////////////////////////////////////////////////////////
@@ -401,6 +408,17 @@ TRI_json_t* TRI_JsonString (TRI_memory_zone_t*, char const* text);
 
 TRI_json_t* TRI_Json2String (TRI_memory_zone_t*, char const* text, char** error);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string of a given length and returns error message
+///
+/// The text does not need to be null-terminated.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_Json2StringLength (TRI_memory_zone_t*,
+                                   char const* text,
+                                   size_t length,
+                                   char** error);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief parses a json file and returns error message
 ////////////////////////////////////////////////////////////////////////////////
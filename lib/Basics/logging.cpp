@@ -118,6 +118,58 @@ struct log_message_t {
   bool                     _freeMessage;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal length of the message text kept in a log record. longer
+/// messages are passed through the message queue
+////////////////////////////////////////////////////////////////////////////////
+
+#define LOG_RECORD_MESSAGE_SIZE (480)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of log records a thread can have pending
+////////////////////////////////////////////////////////////////////////////////
+
+#define LOG_RECORDS_PER_THREAD (256)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a log record. the calling thread only renders the message text,
+/// the time, the prefix, the level and the file are formatted by the logging
+/// thread
+////////////////////////////////////////////////////////////////////////////////
+
+struct log_record_t {
+  uint64_t           _sequence;
+  time_t             _timestamp;
+  char const*        _file;          // always __FILE__, so it stays valid
+  int                _line;
+  TRI_log_level_e    _level;
+  TRI_log_severity_e _severity;
+  TRI_pid_t          _processId;
+  TRI_tid_t          _threadId;
+  size_t             _length;
+  char               _message[LOG_RECORD_MESSAGE_SIZE];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the log records of a thread
+///
+/// the owning thread is the only writer of _tail, the logging thread the only
+/// writer of _head. a record is owned by the logging thread from the moment
+/// _tail moves past it until _head does
+////////////////////////////////////////////////////////////////////////////////
+
+struct log_ring_t {
+  log_ring_t ()
+    : _tail(0),
+      _head(0) {
+  }
+
+  std::atomic<uint64_t> _tail;
+  char                  _padding[64];  // keep _head on another cache line
+  std::atomic<uint64_t> _head;
+  log_record_t          _records[LOG_RECORDS_PER_THREAD];
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief base structure for log appenders
 ////////////////////////////////////////////////////////////////////////////////
@@ -257,6 +309,38 @@ static triagens::basics::Mutex LogMessageQueueLock;
 
 static std::vector<log_message_t*> LogMessageQueue;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the log records of all threads that have logged. the rings are
+/// never freed, a thread may log until the process ends
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<log_ring_t*> LogRings;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief protects LogRings, not the records
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex LogRingsLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the log records of the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local log_ring_t* LocalLogRing = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief order of the log records across threads
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> LogSequence(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of messages dropped because the records of their thread
+/// were full
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> DroppedMessages(0);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief thread used for logging
 ////////////////////////////////////////////////////////////////////////////////
@@ -584,6 +668,49 @@ static int GenerateMessage (char* buffer,
   return m + n;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates a message string, with the arguments given directly
+////////////////////////////////////////////////////////////////////////////////
+
+static int GenerateMessageArgs (char* buffer,
+                                size_t size,
+                                int* offset,
+                                char const* file,
+                                int line,
+                                TRI_log_level_e level,
+                                TRI_pid_t currentProcessId,
+                                TRI_tid_t currentThreadId,
+                                char const* fmt,
+                                ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  int n = GenerateMessage(buffer, size, offset, nullptr, file, line, level, currentProcessId, currentThreadId, fmt, ap);
+  va_end(ap);
+
+  return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief generates the time prefix, the buffer must hold 32 bytes
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t GenerateTimePrefix (char* buffer,
+                                  time_t tt) {
+  struct tm tb;
+
+  if (UseLocalTime == 0) {
+    // use GMtime
+    TRI_gmtime(tt, &tb);
+    // write time in buffer
+    return strftime(buffer, 32, "%Y-%m-%dT%H:%M:%SZ ", &tb);
+  }
+
+  // use localtime
+  TRI_localtime(tt, &tb);
+  return strftime(buffer, 32, "%Y-%m-%dT%H:%M:%S ", &tb);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief write to stderr
 ////////////////////////////////////////////////////////////////////////////////
@@ -601,6 +728,43 @@ static void WriteStderr (TRI_log_level_e level,
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief passes a message string to the appenders
+////////////////////////////////////////////////////////////////////////////////
+
+static void WriteAppenders (TRI_log_level_e level,
+                            TRI_log_severity_e severity,
+                            char const* message,
+                            size_t length) {
+  MUTEX_LOCKER(AppendersLock);
+
+  if (Appenders.empty()) {
+    WriteStderr(level, message);
+    return;
+  }
+
+  for (auto& it : Appenders) {
+    // apply severity filter
+    if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
+        it->_severityFilter != severity) {
+      continue;
+    }
+
+    // apply content filter on log message
+    if (it->_contentFilter != nullptr) {
+      if (! TRI_IsContainedString(message, it->_contentFilter)) {
+        continue;
+      }
+    }
+
+    it->logMessage(level, severity, message, length);
+
+    if (it->_consume) {
+      break;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief outputs a message string to all appenders
 ////////////////////////////////////////////////////////////////////////////////
@@ -666,33 +830,221 @@ static void OutputMessage (TRI_log_level_e level,
     }
   }
   else {
-    MUTEX_LOCKER(AppendersLock);
+    WriteAppenders(level, severity, message, length);
 
-    for (auto& it : Appenders) {
-      // apply severity filter
-      if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
-          it->_severityFilter != severity) {
-        continue;
-      }
+    if (claimOwnership) {
+      TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
+    }
+  }
+}
 
-      // apply content filter on log message
-      if (it->_contentFilter != nullptr) {
-        if (! TRI_IsContainedString(message, it->_contentFilter)) {
-          continue;
-        }
-      }
+////////////////////////////////////////////////////////////////////////////////
+/// @brief stores a message in the log records of the current thread. returns
+/// false if the message must be passed through the message queue instead
+////////////////////////////////////////////////////////////////////////////////
 
-      it->logMessage(level, severity, message, length);
+static bool AppendRecord (char const* file,
+                          int line,
+                          TRI_log_level_e level,
+                          TRI_log_severity_e severity,
+                          TRI_pid_t processId,
+                          TRI_tid_t threadId,
+                          char const* fmt,
+                          va_list ap) {
+  log_ring_t* ring = LocalLogRing;
 
-      if (it->_consume) {
-        break;
-      }
+  if (ring == nullptr) {
+    try {
+      std::unique_ptr<log_ring_t> created(new log_ring_t());
+
+      MUTEX_LOCKER(LogRingsLock);
+      LogRings.emplace_back(created.get());
+      ring = created.release();
+    }
+    catch (...) {
+      return false;
     }
 
-    if (claimOwnership) {
-      TRI_FreeString(TRI_UNKNOWN_MEM_ZONE, message);
+    LocalLogRing = ring;
+  }
+
+  uint64_t tail = ring->_tail.load(std::memory_order_relaxed);
+  uint64_t used = tail - ring->_head.load(std::memory_order_acquire);
+
+  if (used >= LOG_RECORDS_PER_THREAD) {
+    if (level == TRI_LOG_LEVEL_FATAL || level == TRI_LOG_LEVEL_ERROR) {
+      // errors are never dropped
+      return false;
+    }
+
+    DroppedMessages.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  log_record_t* record = &ring->_records[tail % LOG_RECORDS_PER_THREAD];
+
+  va_list ap2;
+  va_copy(ap2, ap);
+  int n = vsnprintf(record->_message, sizeof(record->_message), fmt, ap2);
+  va_end(ap2);
+
+  if (n < 0 || n >= (int) sizeof(record->_message)) {
+    // too long or a corrupt format string, both are handled by the caller
+    return false;
+  }
+
+  record->_sequence  = LogSequence.fetch_add(1, std::memory_order_relaxed);
+  record->_timestamp = time(0);
+  record->_file      = file;
+  record->_line      = line;
+  record->_level     = level;
+  record->_severity  = severity;
+  record->_processId = processId;
+  record->_threadId  = threadId;
+  record->_length    = (size_t) n;
+
+  ring->_tail.store(tail + 1, std::memory_order_release);
+
+  if (used == LOG_RECORDS_PER_THREAD / 2) {
+    // the logging thread may be sleeping for up to a second, wake it up
+    // before the records are full
+    TRI_LockCondition(&LogCondition);
+    TRI_SignalCondition(&LogCondition);
+    TRI_UnlockCondition(&LogCondition);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether any thread has log records that are not yet written
+////////////////////////////////////////////////////////////////////////////////
+
+static bool HasPendingRecords () {
+  MUTEX_LOCKER(LogRingsLock);
+
+  for (auto const* ring : LogRings) {
+    if (ring->_head.load(std::memory_order_relaxed) != ring->_tail.load(std::memory_order_acquire)) {
+      return true;
     }
   }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief formats a log record and passes it to the appenders
+////////////////////////////////////////////////////////////////////////////////
+
+static void OutputRecord (log_record_t const* record) {
+  char buffer[LOG_RECORD_MESSAGE_SIZE + 512];
+  int offset;
+
+  size_t len = GenerateTimePrefix(buffer, record->_timestamp);
+  int n = GenerateMessageArgs(buffer + len, sizeof(buffer) - len, &offset,
+                              record->_file, record->_line, record->_level,
+                              record->_processId, record->_threadId,
+                              "%.*s", (int) record->_length, record->_message);
+
+  if (n < 0) {
+    return;
+  }
+
+  char* p = buffer;
+
+  if (n >= (int) (sizeof(buffer) - len)) {
+    // a long output prefix
+    p = static_cast<char*>(TRI_Allocate(TRI_UNKNOWN_MEM_ZONE, n + len + 1, false));
+
+    if (p == nullptr) {
+      return;
+    }
+
+    memcpy(p, buffer, len);
+    GenerateMessageArgs(p + len, n + 1, &offset,
+                        record->_file, record->_line, record->_level,
+                        record->_processId, record->_threadId,
+                        "%.*s", (int) record->_length, record->_message);
+  }
+
+  // copy the message without the prefix to ring buffer of recent log messages
+  if (record->_severity == TRI_LOG_SEVERITY_HUMAN) {
+    StoreOutput(record->_level, record->_timestamp, record->_message, record->_length);
+  }
+
+  WriteAppenders(record->_level, record->_severity, p, (size_t) n + len);
+
+  if (p != buffer) {
+    TRI_Free(TRI_UNKNOWN_MEM_ZONE, p);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the log records of all threads in the order they were made.
+/// the vectors are only passed in to reuse their memory. returns the number
+/// of records written
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t OutputRecords (std::vector<log_ring_t*>& rings,
+                             std::vector<uint64_t>& tails,
+                             std::vector<log_record_t const*>& records) {
+  try {
+    MUTEX_LOCKER(LogRingsLock);
+    rings = LogRings;
+  }
+  catch (...) {
+    return 0;
+  }
+
+  tails.clear();
+  records.clear();
+
+  try {
+    for (auto* ring : rings) {
+      uint64_t head = ring->_head.load(std::memory_order_relaxed);
+      uint64_t tail = ring->_tail.load(std::memory_order_acquire);
+
+      for (uint64_t i = head;  i < tail;  ++i) {
+        records.emplace_back(&ring->_records[i % LOG_RECORDS_PER_THREAD]);
+      }
+
+      tails.emplace_back(tail);
+    }
+  }
+  catch (...) {
+    // out of memory. leave the records for the next round
+    return 0;
+  }
+
+  std::sort(records.begin(), records.end(), [] (log_record_t const* lhs, log_record_t const* rhs) {
+    return lhs->_sequence < rhs->_sequence;
+  });
+
+  for (auto const* record : records) {
+    OutputRecord(record);
+  }
+
+  // hand the records back to their threads
+  for (size_t i = 0;  i < rings.size();  ++i) {
+    rings[i]->_head.store(tails[i], std::memory_order_release);
+  }
+
+  return records.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief logs how many messages were dropped since the last call
+////////////////////////////////////////////////////////////////////////////////
+
+static void ReportDroppedMessages (uint64_t& reported) {
+  uint64_t dropped = DroppedMessages.load(std::memory_order_relaxed);
+
+  if (dropped != reported) {
+    TRI_Log(__FUNCTION__, __FILE__, __LINE__, TRI_LOG_LEVEL_WARNING, TRI_LOG_SEVERITY_HUMAN,
+            "dropped %llu log message(s) because the logging thread could not keep up",
+            (unsigned long long) (dropped - reported));
+    reported = dropped;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -700,6 +1052,10 @@ static void OutputMessage (TRI_log_level_e level,
 ////////////////////////////////////////////////////////////////////////////////
 
 static void MessageQueueWorker (void* data) {
+  std::vector<log_ring_t*> rings;
+  std::vector<uint64_t> tails;
+  std::vector<log_record_t const*> records;
+  uint64_t reported = 0;
   int sl = 100;
   
   // now we're active
@@ -713,7 +1069,20 @@ static void MessageQueueWorker (void* data) {
       buffer.swap(LogMessageQueue);
     }
 
-    if (buffer.empty()) {
+    size_t numMessages = buffer.size();
+
+    // output messages using the appenders
+    for (auto& msg : buffer) {
+      WriteAppenders(msg->_level, msg->_severity, msg->_message, msg->_length);
+
+      delete msg;
+    }
+
+    buffer.clear();
+
+    numMessages += OutputRecords(rings, tails, records);
+
+    if (numMessages == 0) {
       sl += 1000;
 
       if (1000000 < sl) {
@@ -721,44 +1090,12 @@ static void MessageQueueWorker (void* data) {
       }
     }
     else {
-      TRI_ASSERT(! buffer.empty());
-
-      // output messages using the appenders
-      for (auto& msg : buffer) {
-        {
-          MUTEX_LOCKER(AppendersLock);
-
-          for (auto& it : Appenders) {
-            // apply severity filter
-            if (it->_severityFilter != TRI_LOG_SEVERITY_UNKNOWN &&
-                it->_severityFilter != msg->_severity) {
-              continue;
-            }
-
-            // apply content filter on log message
-            if (it->_contentFilter != nullptr) {
-              if (! TRI_IsContainedString(msg->_message, it->_contentFilter)) {
-                continue;
-              }
-            }
-
-            it->logMessage(msg->_level, msg->_severity, msg->_message, msg->_length);
-
-            if (it->_consume) {
-              break;
-            }
-          }
-        }
-
-        delete msg;
-      }
-
-      buffer.clear();
-
       // sleep a little while
       sl = 100;
     }
 
+    ReportDroppedMessages(reported);
+
     if (LoggingActive) {
       TRI_LockCondition(&LogCondition);
       TRI_TimedWaitCondition(&LogCondition, (uint64_t) sl);
@@ -766,7 +1103,7 @@ static void MessageQueueWorker (void* data) {
     }
     else {
       MUTEX_LOCKER(LogMessageQueueLock);
-      if (LogMessageQueue.empty()) {
+      if (LogMessageQueue.empty() && ! HasPendingRecords()) {
         // queue is empty. we can leave this loop
         break;
       }
@@ -809,29 +1146,26 @@ static void LogThread (char const* func,
   static const int maxSize = 100 * 1024;
   va_list ap2;
   char buffer[2048];  // try a static buffer first
-  time_t tt;
-  struct tm tb;
   size_t len;
   int offset;
   int n;
 
   // .............................................................................
-  // generate time prefix
+  // with a logging thread, the message is formatted and written there
   // .............................................................................
 
-  tt = time(0);
-  if (UseLocalTime == 0) {
-    // use GMtime
-    TRI_gmtime(tt, &tb);
-    // write time in buffer
-    len = strftime(buffer, 32, "%Y-%m-%dT%H:%M:%SZ ", &tb);
-  }
-  else {
-    // use localtime
-    TRI_localtime(tt, &tb);
-    len = strftime(buffer, 32, "%Y-%m-%dT%H:%M:%S ", &tb);
+  if (ThreadedLogging && LoggingThreadActive.load(std::memory_order_relaxed)) {
+    if (AppendRecord(file, line, level, severity, processId, threadId, fmt, ap)) {
+      return;
+    }
   }
 
+  // .............................................................................
+  // generate time prefix
+  // .............................................................................
+
+  len = GenerateTimePrefix(buffer, time(0));
+
   errno = TRI_ERROR_NO_ERROR;
   va_copy(ap2, ap);
   n = GenerateMessage(buffer + len, sizeof(buffer) - len, &offset, func, file, line, level, processId, threadId, fmt, ap2);
@@ -1956,7 +2290,7 @@ void TRI_FlushLogging () {
     while (++tries < 500) {
       {
         MUTEX_LOCKER(LogMessageQueueLock);
-        if (LogMessageQueue.empty()) {
+        if (LogMessageQueue.empty() && ! HasPendingRecords()) {
           break;
         }
       }
@@ -1966,6 +2300,15 @@ void TRI_FlushLogging () {
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of messages dropped because the logging thread
+/// could not keep up
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_DroppedMessagesLogging () {
+  return DroppedMessages.load(std::memory_order_relaxed);
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
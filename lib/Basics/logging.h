@@ -540,6 +540,18 @@ void TRI_ReopenLogging ();
 
 void TRI_FlushLogging ();
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the number of messages dropped because the logging thread
+/// could not keep up
+///
+/// with threaded logging, a thread renders the text of a message into a
+/// buffer of its own and the logging thread adds the prefix and writes it.
+/// messages other than errors are dropped instead of waiting for the logging
+/// thread when the buffer is full
+////////////////////////////////////////////////////////////////////////////////
+
+uint64_t TRI_DroppedMessagesLogging ();
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -36,6 +36,81 @@
 
 #include <sys/mman.h>
 
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size of a huge page
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const HugePageSize = 2 * 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the huge page mode for large tables
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int> HugePagesMode(TRI_HUGE_PAGES_NONE);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the mapped large tables, with their mapped sizes and whether they
+/// use huge pages
+////////////////////////////////////////////////////////////////////////////////
+
+static std::unordered_map<void*, std::pair<size_t, bool>> LargeTables;
+
+static std::mutex LargeTablesLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief huge page statistics
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int64_t> HugePagesBytes(0);
+
+static std::atomic<int64_t> HugePagesFallbacks(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether large tables are placed on NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<bool> NumaPlacement(false);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maps anonymous memory aligned to a huge page, returns nullptr if
+/// out of memory
+////////////////////////////////////////////////////////////////////////////////
+
+static void* MapAligned (size_t size) {
+  size_t const length = size + HugePageSize;
+  void* mapped = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (mapped == MAP_FAILED) {
+    return nullptr;
+  }
+
+  // unmap the parts before and after the aligned region
+  uintptr_t const start = reinterpret_cast<uintptr_t>(mapped);
+  uintptr_t const aligned = (start + HugePageSize - 1) & ~(static_cast<uintptr_t>(HugePageSize) - 1);
+
+  if (aligned > start) {
+    munmap(mapped, aligned - start);
+  }
+
+  if (start + length > aligned + size) {
+    munmap(reinterpret_cast<void*>(aligned + size), start + length - aligned - size);
+  }
+
+  return reinterpret_cast<void*>(aligned);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // @brief flush memory mapped file to disk
 ////////////////////////////////////////////////////////////////////////////////
@@ -181,6 +256,198 @@ int TRI_MMFileAdvise (void* memoryAddress, size_t numOfBytes, int advice) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the huge page mode for large tables allocated from now on
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetHugePagesLargeTable (int mode) {
+  HugePagesMode.store(mode, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a table
+////////////////////////////////////////////////////////////////////////////////
+
+void* TRI_AllocateLargeTable (size_t size) {
+  if (size < TRI_LARGE_TABLE_SIZE) {
+    return malloc(size);
+  }
+
+  int const mode = HugePagesMode.load(std::memory_order_relaxed);
+  void* table = nullptr;
+  size_t mapped = 0;
+  bool huge = false;
+
+#ifdef MAP_HUGETLB
+  if (mode == TRI_HUGE_PAGES_EXPLICIT) {
+    mapped = ((size + HugePageSize - 1) / HugePageSize) * HugePageSize;
+    table = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (table == MAP_FAILED) {
+      // the reserved huge pages are exhausted, or there are none
+      LOG_DEBUG("cannot map %llu bytes with explicit huge pages, falling back to transparent huge pages",
+                (unsigned long long) mapped);
+      table = nullptr;
+    }
+    else {
+      huge = true;
+    }
+  }
+#endif
+
+  if (table == nullptr) {
+    mapped = ((size + HugePageSize - 1) / HugePageSize) * HugePageSize;
+
+    if (mode == TRI_HUGE_PAGES_NONE) {
+      table = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+      if (table == MAP_FAILED) {
+        return nullptr;
+      }
+    }
+    else {
+      table = MapAligned(mapped);
+
+      if (table == nullptr) {
+        return nullptr;
+      }
+
+#ifdef MADV_HUGEPAGE
+      huge = (madvise(table, mapped, MADV_HUGEPAGE) == 0);
+#endif
+    }
+  }
+
+  if (mode != TRI_HUGE_PAGES_NONE) {
+    if (huge) {
+      HugePagesBytes += static_cast<int64_t>(mapped);
+    }
+    else {
+      ++HugePagesFallbacks;
+    }
+  }
+
+  try {
+    std::lock_guard<std::mutex> guard(LargeTablesLock);
+    LargeTables.emplace(table, std::make_pair(mapped, huge));
+  }
+  catch (...) {
+    munmap(table, mapped);
+
+    if (huge) {
+      HugePagesBytes -= static_cast<int64_t>(mapped);
+    }
+    return nullptr;
+  }
+
+  return table;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a table
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeLargeTable (void* table, size_t size) {
+  if (table == nullptr) {
+    return;
+  }
+
+  if (size < TRI_LARGE_TABLE_SIZE) {
+    free(table);
+    return;
+  }
+
+  std::pair<size_t, bool> mapping;
+
+  {
+    std::lock_guard<std::mutex> guard(LargeTablesLock);
+    auto it = LargeTables.find(table);
+
+    TRI_ASSERT(it != LargeTables.end());
+
+    if (it == LargeTables.end()) {
+      return;
+    }
+
+    mapping = (*it).second;
+    LargeTables.erase(it);
+  }
+
+  munmap(table, mapping.first);
+
+  if (mapping.second) {
+    HugePagesBytes -= static_cast<int64_t>(mapping.first);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the huge page statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_HugePagesStatistics (int64_t* bytes,
+                              int64_t* fallbacks) {
+  *bytes = HugePagesBytes.load(std::memory_order_relaxed);
+  *fallbacks = HugePagesFallbacks.load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enables or disables the placement of large tables on NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetNumaLargeTable (bool enabled) {
+  NumaPlacement.store(enabled, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the preferred NUMA node for the large tables of an object
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NumaNodeLargeTable (uint64_t id) {
+  if (! NumaPlacement.load(std::memory_order_relaxed)) {
+    return -1;
+  }
+
+  size_t n = TRI_numberNumaNodes();
+
+  if (n <= 1) {
+    return -1;
+  }
+
+  return static_cast<int>(id % n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefers a NUMA node for the memory of a large table
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_BindLargeTable (void* table, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (table == nullptr || node < 0 || size < TRI_LARGE_TABLE_SIZE) {
+    return;
+  }
+
+  // MPOL_PREFERRED from <numaif.h>, so we do not depend on libnuma
+  int const MpolPreferred = 1;
+  size_t const bitsPerWord = 8 * sizeof(unsigned long);
+  unsigned long mask[16] = { 0 };
+
+  size_t id = TRI_numaNodeId(static_cast<size_t>(node));
+
+  if (id >= 16 * bitsPerWord) {
+    return;
+  }
+
+  mask[id / bitsPerWord] |= 1UL << (id % bitsPerWord);
+
+  // the policy only applies to pages faulted in later. if it fails, the
+  // pages are placed on the node of the thread that first touches them
+  if (syscall(SYS_mbind, table, size, MpolPreferred, mask, 16 * bitsPerWord, 0) != 0) {
+    LOG_DEBUG("cannot bind table of %llu bytes to NUMA node %d: %s",
+              (unsigned long long) size, node, strerror(errno));
+  }
+#endif
+}
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -345,6 +345,69 @@ int TRI_MMFileAdvise (void*, size_t, int) {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the huge page mode for large tables, huge pages are not
+/// supported under Windows
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetHugePagesLargeTable (int) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a table
+////////////////////////////////////////////////////////////////////////////////
+
+void* TRI_AllocateLargeTable (size_t size) {
+  void* table = malloc(size);
+
+  if (table != nullptr && size >= TRI_LARGE_TABLE_SIZE) {
+    memset(table, 0, size);
+  }
+
+  return table;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a table
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeLargeTable (void* table, size_t) {
+  free(table);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the huge page statistics
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_HugePagesStatistics (int64_t* bytes,
+                              int64_t* fallbacks) {
+  *bytes = 0;
+  *fallbacks = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enables or disables the placement of large tables on NUMA nodes,
+/// which is not supported under Windows
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetNumaLargeTable (bool) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the preferred NUMA node for the large tables of an object
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NumaNodeLargeTable (uint64_t) {
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefers a NUMA node for the memory of a large table
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_BindLargeTable (void*, size_t, int) {
+}
+
 #endif
 
 // -----------------------------------------------------------------------------
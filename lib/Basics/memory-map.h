@@ -109,6 +109,80 @@ int TRI_ProtectMMFile (void* memoryAddress,
 
 int TRI_MMFileAdvise (void* memoryAddress, size_t numOfBytes, int advice);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      LARGE TABLES
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tables of at least this size are mapped, and can be backed by huge
+/// pages
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_LARGE_TABLE_SIZE (2 * 1024 * 1024)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief huge page modes for large tables
+///
+/// with transparent huge pages, the tables are aligned to and advised for
+/// huge pages, and the kernel backs them with huge pages if it can. explicit
+/// huge pages are taken from the pool reserved by the administrator, tables
+/// fall back to transparent huge pages if the pool is exhausted
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_HUGE_PAGES_NONE        (0)
+#define TRI_HUGE_PAGES_TRANSPARENT (1)
+#define TRI_HUGE_PAGES_EXPLICIT    (2)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the huge page mode for large tables allocated from now on
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetHugePagesLargeTable (int mode);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a table, returns nullptr if out of memory
+///
+/// tables of at least TRI_LARGE_TABLE_SIZE bytes are mapped and zero-filled,
+/// smaller ones are allocated on the heap and not initialized
+////////////////////////////////////////////////////////////////////////////////
+
+void* TRI_AllocateLargeTable (size_t size);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees a table, size must be the allocated size
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeLargeTable (void* table, size_t size);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes of large tables advised for or backed by huge
+/// pages, and the number of tables that could not use huge pages
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_HugePagesStatistics (int64_t* bytes,
+                              int64_t* fallbacks);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief enables or disables the placement of large tables on NUMA nodes
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetNumaLargeTable (bool enabled);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the preferred NUMA node for the large tables of an object,
+/// e.g. the indexes of a collection, or -1 if there is no preference
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NumaNodeLargeTable (uint64_t id);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief prefers a NUMA node for the memory of a table allocated with
+/// TRI_AllocateLargeTable. this must be called before the table is touched,
+/// and has no effect on small tables or if node is negative
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_BindLargeTable (void* table, size_t size, int node);
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -29,6 +29,16 @@
 
 #include "Basics/Common.h"
 
+#include <mutex>
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(__FreeBSD__)
+#include <malloc_np.h>
+#else
+#include <malloc.h>
+#endif
+
 #ifdef TRI_ENABLE_FAILURE_TESTS
 #include <sys/time.h>
 #include <unistd.h>
@@ -84,6 +94,84 @@
 #define REALLOC_WRAPPER(zone, ptr, n) BuiltInRealloc(ptr, n)
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximum number of arena zones alive at the same time
+////////////////////////////////////////////////////////////////////////////////
+
+#define MAX_ARENA_ZONES (64 * 1024)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief alignment of allocations in arena zones
+////////////////////////////////////////////////////////////////////////////////
+
+#define ARENA_ALIGNMENT 8
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size of the header in front of each allocation in an arena zone
+///
+/// the header stores the requested size, which TRI_Reallocate needs
+////////////////////////////////////////////////////////////////////////////////
+
+#define ARENA_HEADER_SIZE sizeof(uint64_t)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of accounted memory zones
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUM_ACCOUNTED_ZONES TRI_FIRST_ARENA_MEMORY_ZONE_ID
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of named memory zones
+////////////////////////////////////////////////////////////////////////////////
+
+#define NUM_NAMED_ZONES (TRI_FIRST_ARENA_MEMORY_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bytes and allocations a thread accounts before it publishes them
+////////////////////////////////////////////////////////////////////////////////
+
+#define USAGE_BATCH_BYTES (256 * 1024)
+#define USAGE_BATCH_ALLOCATIONS 1024
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory block of an arena zone, the data follows the header
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct arena_block_s {
+  struct arena_block_s* _next;
+  uint64_t              _size;
+}
+arena_block_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bytes and allocations of a zone accounted by a thread
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct zone_usage_s {
+  int64_t _bytes;
+  int64_t _allocations;
+}
+zone_usage_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_memory_arena_s {
+  TRI_memory_zone_t _zone;
+  arena_block_t*    _blocks;    // all blocks, most recent first
+  arena_block_t*    _block;     // block bump allocations are served from
+  char*             _current;   // next free byte in _block
+  char*             _end;       // end of _block
+  char*             _last;      // most recent allocation in _block
+  size_t            _blockSize;
+}
+TRI_memory_arena_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -100,6 +188,47 @@ static TRI_memory_zone_t TriCoreMemZone;
 
 static TRI_memory_zone_t TriUnknownMemZone;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief named memory zones
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_memory_zone_t TriNamedMemZones[NUM_NAMED_ZONES];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief names of the accounted memory zones
+////////////////////////////////////////////////////////////////////////////////
+
+static char const* ZoneNames[NUM_ACCOUNTED_ZONES] = {
+  "core",
+  "unknown",
+  "headers",
+  "primary-index",
+  "edge-index",
+  "hash-index",
+  "skiplist-index",
+  "geo-index",
+  "fulltext-index",
+  "shaper",
+  "wal",
+  "aql",
+  "query-cache",
+  "v8",
+  "cursors"
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief published bytes and allocations of the accounted zones
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<int64_t> ZoneBytes[NUM_ACCOUNTED_ZONES];
+static std::atomic<int64_t> ZoneAllocations[NUM_ACCOUNTED_ZONES];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief bytes and allocations accounted by this thread, not yet published
+////////////////////////////////////////////////////////////////////////////////
+
+static thread_local zone_usage_t LocalUsage[NUM_ACCOUNTED_ZONES];
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief memory reserve for core memory zone
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,6 +241,30 @@ static void* CoreReserve;
 
 static int CoreInitialized = 0;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arena zones by zone id
+////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<TRI_memory_zone_t*> ArenaZones[MAX_ARENA_ZONES];
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lock for handing out arena zone ids
+////////////////////////////////////////////////////////////////////////////////
+
+static std::mutex ArenaZonesLock;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief arena zone ids that can be reused, protected by ArenaZonesLock
+////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<TRI_memory_zone_id_t> FreeArenaZoneIds;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief next unused arena zone id, protected by ArenaZonesLock
+////////////////////////////////////////////////////////////////////////////////
+
+static TRI_memory_zone_id_t NextArenaZoneId = TRI_FIRST_ARENA_MEMORY_ZONE_ID;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief configuration parameters for memory error tests
 ////////////////////////////////////////////////////////////////////////////////
@@ -263,6 +416,191 @@ static void InitFailMalloc (void) {
 
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the size of an allocation as known to the allocator
+///
+/// this may be a bit larger than the size requested, which is what we want
+/// to account anyway
+////////////////////////////////////////////////////////////////////////////////
+
+static inline int64_t AllocationSize (void* m) {
+#if defined(__APPLE__)
+  return (int64_t) malloc_size(m);
+#elif defined(_WIN32)
+  return (int64_t) _msize(m);
+#else
+  return (int64_t) malloc_usable_size(m);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes the usage of a zone accounted by this thread
+////////////////////////////////////////////////////////////////////////////////
+
+static void FlushUsage (TRI_memory_zone_id_t zid) {
+  zone_usage_t* usage = &LocalUsage[zid];
+
+  ZoneBytes[zid].fetch_add(usage->_bytes, std::memory_order_relaxed);
+  ZoneAllocations[zid].fetch_add(usage->_allocations, std::memory_order_relaxed);
+
+  usage->_bytes = 0;
+  usage->_allocations = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts memory in a zone. arena zones are not accounted
+////////////////////////////////////////////////////////////////////////////////
+
+static inline void AccountUsage (TRI_memory_zone_id_t zid,
+                                 int64_t bytes,
+                                 int64_t allocations) {
+  if (zid >= NUM_ACCOUNTED_ZONES) {
+    return;
+  }
+
+  zone_usage_t* usage = &LocalUsage[zid];
+
+  usage->_bytes += bytes;
+  usage->_allocations += allocations;
+
+  if (usage->_bytes >= USAGE_BATCH_BYTES ||
+      usage->_bytes <= -USAGE_BATCH_BYTES ||
+      usage->_allocations >= USAGE_BATCH_ALLOCATIONS ||
+      usage->_allocations <= -USAGE_BATCH_ALLOCATIONS) {
+    FlushUsage(zid);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief rounds a size up to the arena alignment
+////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t ArenaAlign (uint64_t n) {
+  return (n + (ARENA_ALIGNMENT - 1)) & ~((uint64_t) (ARENA_ALIGNMENT - 1));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates a new block for an arena zone and links it
+////////////////////////////////////////////////////////////////////////////////
+
+static arena_block_t* ArenaAddBlock (TRI_memory_arena_t* arena,
+                                     uint64_t size) {
+  auto block = reinterpret_cast<arena_block_t*>(MALLOC_WRAPPER(&arena->_zone, (size_t) (sizeof(arena_block_t) + size)));
+
+  if (block == nullptr) {
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
+  block->_next = arena->_blocks;
+  block->_size = size;
+  arena->_blocks = block;
+
+  return block;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief makes a block the one bump allocations are served from
+////////////////////////////////////////////////////////////////////////////////
+
+static void ArenaUseBlock (TRI_memory_arena_t* arena,
+                           arena_block_t* block) {
+  arena->_block   = block;
+  arena->_current = reinterpret_cast<char*>(block + 1);
+  arena->_end     = arena->_current + block->_size;
+  arena->_last    = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief allocates memory in an arena zone
+///
+/// allocations larger than a quarter block get a block of their own, so the
+/// remainder of the current block is not wasted
+////////////////////////////////////////////////////////////////////////////////
+
+static char* ArenaAllocate (TRI_memory_arena_t* arena,
+                            uint64_t n) {
+  uint64_t const needed = ArenaAlign(ARENA_HEADER_SIZE + n);
+
+  if (needed > (uint64_t) (arena->_end - arena->_current)) {
+    if (needed > arena->_blockSize / 4) {
+      arena_block_t* block = ArenaAddBlock(arena, needed);
+
+      if (block == nullptr) {
+        return nullptr;
+      }
+
+      char* m = reinterpret_cast<char*>(block + 1);
+      *reinterpret_cast<uint64_t*>(m) = n;
+
+      return m + ARENA_HEADER_SIZE;
+    }
+
+    arena_block_t* block = ArenaAddBlock(arena, arena->_blockSize);
+
+    if (block == nullptr) {
+      return nullptr;
+    }
+
+    ArenaUseBlock(arena, block);
+  }
+
+  char* m = arena->_current;
+  *reinterpret_cast<uint64_t*>(m) = n;
+
+  arena->_current += needed;
+  arena->_last = m + ARENA_HEADER_SIZE;
+
+  return arena->_last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reallocates memory in an arena zone
+///
+/// the most recent allocation is resized in place if the block has room,
+/// everything else is copied
+////////////////////////////////////////////////////////////////////////////////
+
+static char* ArenaReallocate (TRI_memory_arena_t* arena,
+                              char* m,
+                              uint64_t n) {
+  uint64_t const old = *reinterpret_cast<uint64_t*>(m - ARENA_HEADER_SIZE);
+
+  if (m == arena->_last) {
+    uint64_t const needed = ArenaAlign(ARENA_HEADER_SIZE + n);
+
+    if (needed <= (uint64_t) (arena->_end - (m - ARENA_HEADER_SIZE))) {
+      *reinterpret_cast<uint64_t*>(m - ARENA_HEADER_SIZE) = n;
+      arena->_current = m - ARENA_HEADER_SIZE + needed;
+      return m;
+    }
+  }
+  else if (n <= old) {
+    return m;
+  }
+
+  char* p = ArenaAllocate(arena, n);
+
+  if (p != nullptr) {
+    memcpy(p, m, (size_t) (old < n ? old : n));
+  }
+
+  return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees memory in an arena zone. only the most recent allocation is
+/// actually given back
+////////////////////////////////////////////////////////////////////////////////
+
+static void ArenaFree (TRI_memory_arena_t* arena,
+                       char* m) {
+  if (m == arena->_last) {
+    arena->_current = m - ARENA_HEADER_SIZE;
+    arena->_last = nullptr;
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -281,6 +619,24 @@ TRI_memory_zone_t* TRI_CORE_MEM_ZONE = &TriCoreMemZone;
 TRI_memory_zone_t* TRI_UNKNOWN_MEM_ZONE = &TriUnknownMemZone;
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief named memory zones
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_HEADERS_MEM_ZONE        = &TriNamedMemZones[TRI_HEADERS_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_PRIMARY_INDEX_MEM_ZONE  = &TriNamedMemZones[TRI_PRIMARY_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_EDGE_INDEX_MEM_ZONE     = &TriNamedMemZones[TRI_EDGE_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_HASH_INDEX_MEM_ZONE     = &TriNamedMemZones[TRI_HASH_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_SKIPLIST_INDEX_MEM_ZONE = &TriNamedMemZones[TRI_SKIPLIST_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_GEO_INDEX_MEM_ZONE      = &TriNamedMemZones[TRI_GEO_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_FULLTEXT_INDEX_MEM_ZONE = &TriNamedMemZones[TRI_FULLTEXT_INDEX_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_SHAPER_MEM_ZONE         = &TriNamedMemZones[TRI_SHAPER_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_WAL_MEM_ZONE            = &TriNamedMemZones[TRI_WAL_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_AQL_MEM_ZONE            = &TriNamedMemZones[TRI_AQL_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_QUERY_CACHE_MEM_ZONE    = &TriNamedMemZones[TRI_QUERY_CACHE_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_V8_MEM_ZONE             = &TriNamedMemZones[TRI_V8_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+TRI_memory_zone_t* TRI_CURSORS_MEM_ZONE        = &TriNamedMemZones[TRI_CURSORS_MEM_ZONE_ID - TRI_HEADERS_MEM_ZONE_ID];
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -295,6 +651,17 @@ TRI_memory_zone_t* TRI_UnknownMemZoneZ (char const* file, int line) {
 }
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the named memory zone for a zone id
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_NamedMemoryZone (TRI_memory_zone_id_t zid) {
+  TRI_ASSERT(zid >= TRI_HEADERS_MEM_ZONE_ID);
+  TRI_ASSERT(zid < TRI_FIRST_ARENA_MEMORY_ZONE_ID);
+
+  return &TriNamedMemZones[zid - TRI_HEADERS_MEM_ZONE_ID];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief system memory allocation
 ////////////////////////////////////////////////////////////////////////////////
@@ -333,7 +700,15 @@ void* TRI_Allocate (TRI_memory_zone_t* zone, uint64_t n, bool set) {
 #ifdef TRI_ENABLE_MAINTAINER_MODE
   CheckSize(n, file, line);
 #endif
-  char* m = static_cast<char*>(MALLOC_WRAPPER(zone, (size_t) n));
+  char* m;
+
+  if (zone->_arena != nullptr) {
+    // arena zones are failable
+    m = ArenaAllocate(zone->_arena, n);
+  }
+  else {
+    m = static_cast<char*>(MALLOC_WRAPPER(zone, (size_t) n));
+  }
 
   if (m == nullptr) {
     if (zone->_failable) {
@@ -366,6 +741,10 @@ void* TRI_Allocate (TRI_memory_zone_t* zone, uint64_t n, bool set) {
 #endif
   }
 
+  if (zone->_arena == nullptr) {
+    AccountUsage(zone->_zid, AllocationSize(m), 1);
+  }
+
   if (set) {
     memset(m, 0, (size_t) n);
   }
@@ -403,6 +782,12 @@ void* TRI_Reallocate (TRI_memory_zone_t* zone, void* m, uint64_t n) {
   CheckSize(n, file, line);
 #endif
 
+  if (zone->_arena != nullptr) {
+    return ArenaReallocate(zone->_arena, p, n);
+  }
+
+  int64_t const oldSize = AllocationSize(p);
+
   p = static_cast<char*>(REALLOC_WRAPPER(zone, p, (size_t) n));
 
   if (p == nullptr) {
@@ -436,6 +821,8 @@ void* TRI_Reallocate (TRI_memory_zone_t* zone, void* m, uint64_t n) {
 #endif
   }
 
+  AccountUsage(zone->_zid, AllocationSize(p) - oldSize, 0);
+
   return p;
 }
 
@@ -461,6 +848,15 @@ void TRI_Free (TRI_memory_zone_t* zone, void* m) {
   }
 #endif
 
+  if (zone->_arena != nullptr) {
+    ArenaFree(zone->_arena, p);
+    return;
+  }
+
+  if (p != nullptr) {
+    AccountUsage(zone->_zid, - AllocationSize(p), -1);
+  }
+
   free(p);
 }
 
@@ -505,6 +901,168 @@ void* TRI_WrappedReallocate (void* ptr, long size) {
   return BuiltInRealloc(ptr, (size_t) size);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena memory zone for a zone id
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_ArenaMemoryZone (TRI_memory_zone_id_t zid) {
+  TRI_ASSERT(zid >= TRI_FIRST_ARENA_MEMORY_ZONE_ID);
+  TRI_ASSERT(zid < TRI_FIRST_ARENA_MEMORY_ZONE_ID + MAX_ARENA_ZONES);
+
+  return ArenaZones[zid - TRI_FIRST_ARENA_MEMORY_ZONE_ID].load(std::memory_order_acquire);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an arena memory zone
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_CreateArenaMemoryZone (size_t blockSize) {
+  TRI_memory_zone_id_t zid;
+
+  {
+    std::lock_guard<std::mutex> guard(ArenaZonesLock);
+
+    if (! FreeArenaZoneIds.empty()) {
+      zid = FreeArenaZoneIds.back();
+      FreeArenaZoneIds.pop_back();
+    }
+    else if (NextArenaZoneId < TRI_FIRST_ARENA_MEMORY_ZONE_ID + MAX_ARENA_ZONES) {
+      zid = NextArenaZoneId++;
+    }
+    else {
+      TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+      return nullptr;
+    }
+  }
+
+  auto arena = static_cast<TRI_memory_arena_t*>(BuiltInMalloc(sizeof(TRI_memory_arena_t)));
+
+  if (arena == nullptr) {
+    std::lock_guard<std::mutex> guard(ArenaZonesLock);
+    FreeArenaZoneIds.push_back(zid);
+
+    TRI_set_errno(TRI_ERROR_OUT_OF_MEMORY);
+    return nullptr;
+  }
+
+  arena->_zone._zid      = zid;
+  arena->_zone._failed   = false;
+  arena->_zone._failable = true;
+  arena->_zone._arena    = arena;
+  arena->_blocks         = nullptr;
+  arena->_block          = nullptr;
+  arena->_current        = nullptr;
+  arena->_end            = nullptr;
+  arena->_last           = nullptr;
+  arena->_blockSize      = (size_t) ArenaAlign(blockSize < 256 ? 256 : blockSize);
+
+  ArenaZones[zid - TRI_FIRST_ARENA_MEMORY_ZONE_ID].store(&arena->_zone, std::memory_order_release);
+
+  return &arena->_zone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases all memory allocated in an arena memory zone
+///
+/// the block bump allocations were served from last is kept for reuse
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ResetArenaMemoryZone (TRI_memory_zone_t* zone) {
+  TRI_memory_arena_t* arena = zone->_arena;
+  TRI_ASSERT(arena != nullptr);
+
+  arena_block_t* block = arena->_blocks;
+
+  while (block != nullptr) {
+    arena_block_t* next = block->_next;
+
+    if (block != arena->_block) {
+      free(block);
+    }
+
+    block = next;
+  }
+
+  arena->_blocks = arena->_block;
+
+  if (arena->_block != nullptr) {
+    arena->_block->_next = nullptr;
+    ArenaUseBlock(arena, arena->_block);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an arena memory zone, including all memory allocated in it
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeArenaMemoryZone (TRI_memory_zone_t* zone) {
+  TRI_memory_arena_t* arena = zone->_arena;
+  TRI_ASSERT(arena != nullptr);
+
+  arena_block_t* block = arena->_blocks;
+
+  while (block != nullptr) {
+    arena_block_t* next = block->_next;
+    free(block);
+    block = next;
+  }
+
+  TRI_memory_zone_id_t const zid = zone->_zid;
+  ArenaZones[zid - TRI_FIRST_ARENA_MEMORY_ZONE_ID].store(nullptr, std::memory_order_release);
+  free(arena);
+
+  std::lock_guard<std::mutex> guard(ArenaZonesLock);
+  FreeArenaZoneIds.push_back(zid);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts memory in a zone that was not allocated by TRI_Allocate
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddMemoryZoneUsage (TRI_memory_zone_t* zone,
+                             int64_t bytes,
+                             int64_t allocations) {
+  AccountUsage(zone->_zid, bytes, allocations);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes the memory accounted by the current thread
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FlushMemoryZoneUsage () {
+  for (TRI_memory_zone_id_t zid = 0; zid < NUM_ACCOUNTED_ZONES; ++zid) {
+    if (LocalUsage[zid]._bytes != 0 || LocalUsage[zid]._allocations != 0) {
+      FlushUsage(zid);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes and the number of allocations of a zone
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_MemoryZoneUsage (TRI_memory_zone_id_t zid,
+                          int64_t* bytes,
+                          int64_t* allocations) {
+  TRI_ASSERT(zid < NUM_ACCOUNTED_ZONES);
+
+  // what the calling thread holds back is at least up-to-date
+  FlushUsage(zid);
+
+  *bytes = ZoneBytes[zid].load(std::memory_order_relaxed);
+  *allocations = ZoneAllocations[zid].load(std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of an accounted zone
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_MemoryZoneName (TRI_memory_zone_id_t zid) {
+  TRI_ASSERT(zid < NUM_ACCOUNTED_ZONES);
+
+  return ZoneNames[zid];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief initialize memory subsystem
 ////////////////////////////////////////////////////////////////////////////////
@@ -516,10 +1074,19 @@ void TRI_InitializeMemory () {
     TriCoreMemZone._zid      = 0;
     TriCoreMemZone._failed   = false;
     TriCoreMemZone._failable = false;
+    TriCoreMemZone._arena    = nullptr;
 
     TriUnknownMemZone._zid      = 1;
     TriUnknownMemZone._failed   = false;
     TriUnknownMemZone._failable = true;
+    TriUnknownMemZone._arena    = nullptr;
+
+    for (TRI_memory_zone_id_t i = 0; i < NUM_NAMED_ZONES; ++i) {
+      TriNamedMemZones[i]._zid      = TRI_HEADERS_MEM_ZONE_ID + i;
+      TriNamedMemZones[i]._failed   = false;
+      TriNamedMemZones[i]._failable = true;
+      TriNamedMemZones[i]._arena    = nullptr;
+    }
 
 #ifdef TRI_ENABLE_FAILURE_TESTS 
     InitFailMalloc(); 
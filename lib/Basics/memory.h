@@ -49,12 +49,43 @@ typedef uint32_t TRI_memory_zone_id_t;
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef struct TRI_memory_zone_s {
-  TRI_memory_zone_id_t  _zid;
-  bool                  _failed;
-  bool                  _failable;
+  TRI_memory_zone_id_t       _zid;
+  bool                       _failed;
+  bool                       _failable;
+  struct TRI_memory_arena_s* _arena;    // nullptr unless an arena zone
 }
 TRI_memory_zone_t;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory zone ids of the named zones
+///
+/// the named zones behave like the unknown memory zone, but the memory of
+/// each is accounted separately, so it can be told which subsystem uses how
+/// much memory
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_HEADERS_MEM_ZONE_ID         2
+#define TRI_PRIMARY_INDEX_MEM_ZONE_ID   3
+#define TRI_EDGE_INDEX_MEM_ZONE_ID      4
+#define TRI_HASH_INDEX_MEM_ZONE_ID      5
+#define TRI_SKIPLIST_INDEX_MEM_ZONE_ID  6
+#define TRI_GEO_INDEX_MEM_ZONE_ID       7
+#define TRI_FULLTEXT_INDEX_MEM_ZONE_ID  8
+#define TRI_SHAPER_MEM_ZONE_ID          9
+#define TRI_WAL_MEM_ZONE_ID            10
+#define TRI_AQL_MEM_ZONE_ID            11
+#define TRI_QUERY_CACHE_MEM_ZONE_ID    12
+#define TRI_V8_MEM_ZONE_ID             13
+#define TRI_CURSORS_MEM_ZONE_ID        14
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief first memory zone id handed out to arena zones
+///
+/// all zones below are accounted, including the core and the unknown zone
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_FIRST_ARENA_MEMORY_ZONE_ID 15
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public variables
 // -----------------------------------------------------------------------------
@@ -76,6 +107,36 @@ TRI_memory_zone_t* TRI_UnknownMemZoneZ (char const* file, int line);
 extern TRI_memory_zone_t* TRI_UNKNOWN_MEM_ZONE;
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief named memory zones, allocation may fail
+////////////////////////////////////////////////////////////////////////////////
+
+extern TRI_memory_zone_t* TRI_HEADERS_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_PRIMARY_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_EDGE_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_HASH_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_SKIPLIST_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_GEO_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_FULLTEXT_INDEX_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_SHAPER_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_WAL_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_AQL_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_QUERY_CACHE_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_V8_MEM_ZONE;
+extern TRI_memory_zone_t* TRI_CURSORS_MEM_ZONE;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the named memory zone for a zone id
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_NamedMemoryZone (TRI_memory_zone_id_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the arena memory zone for a zone id
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_ArenaMemoryZone (TRI_memory_zone_id_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns the memory zone for a zone id
 ////////////////////////////////////////////////////////////////////////////////
@@ -84,7 +145,13 @@ inline TRI_memory_zone_t* TRI_MemoryZone (TRI_memory_zone_id_t zid) {
   if (zid == 0) {
     return TRI_CORE_MEM_ZONE;
   }
-  return TRI_UNKNOWN_MEM_ZONE;
+  if (zid < TRI_HEADERS_MEM_ZONE_ID) {
+    return TRI_UNKNOWN_MEM_ZONE;
+  }
+  if (zid < TRI_FIRST_ARENA_MEMORY_ZONE_ID) {
+    return TRI_NamedMemoryZone(zid);
+  }
+  return TRI_ArenaMemoryZone(zid);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -92,10 +159,15 @@ inline TRI_memory_zone_t* TRI_MemoryZone (TRI_memory_zone_id_t zid) {
 ////////////////////////////////////////////////////////////////////////////////
 
 inline TRI_memory_zone_id_t TRI_MemoryZoneId (TRI_memory_zone_t const* zone) {
-  if (zone == TRI_CORE_MEM_ZONE) {
-    return TRI_CORE_MEM_ZONE->_zid;
-  }
-  return TRI_UNKNOWN_MEM_ZONE->_zid;
+  return zone->_zid;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a memory zone is an arena zone
+////////////////////////////////////////////////////////////////////////////////
+
+inline bool TRI_IsArenaMemoryZone (TRI_memory_zone_t const* zone) {
+  return zone->_arena != nullptr;
 }
 
 // -----------------------------------------------------------------------------
@@ -190,6 +262,73 @@ static inline void* TRI_Align64 (void* p) {
   return (void*) ( ((uintptr_t) p + 63) & (~((uintptr_t) 63)) );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an arena memory zone
+///
+/// Allocations in an arena zone are bump-allocated from blocks of the given
+/// size, TRI_Free is a no-op (except for the most recent allocation, which is
+/// rolled back), and all memory is released at once by
+/// TRI_FreeArenaMemoryZone. Everything reachable from an object allocated in
+/// an arena zone must be allocated in the same zone, and the zone must only
+/// be used by one thread at a time. Returns nullptr if out of memory.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_memory_zone_t* TRI_CreateArenaMemoryZone (size_t blockSize);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief releases all memory allocated in an arena memory zone and makes
+/// the zone available for reuse
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_ResetArenaMemoryZone (TRI_memory_zone_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frees an arena memory zone, including all memory allocated in it
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FreeArenaMemoryZone (TRI_memory_zone_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief accounts memory in a zone that was not allocated by TRI_Allocate
+///
+/// this is for subsystems which allocate with new or outside of the process
+/// heap, e.g. the hash tables of the indexes or the V8 heaps. the bytes and
+/// allocations may be negative to account memory that was freed
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_AddMemoryZoneUsage (TRI_memory_zone_t*,
+                             int64_t bytes,
+                             int64_t allocations);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief publishes the memory accounted by the current thread
+///
+/// allocations are accounted per thread and published in batches, so the
+/// counters do not become a point of contention. a thread publishes what it
+/// has accounted before it ends
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_FlushMemoryZoneUsage (void);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the bytes and the number of allocations of a zone
+///
+/// zone ids from 0 up to TRI_FIRST_ARENA_MEMORY_ZONE_ID are accounted. the
+/// values are approximate: each thread may hold back a batch, and memory
+/// freed in another zone than it was allocated in is accounted in the
+/// wrong zone
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_MemoryZoneUsage (TRI_memory_zone_id_t,
+                          int64_t* bytes,
+                          int64_t* allocations);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the name of an accounted zone
+////////////////////////////////////////////////////////////////////////////////
+
+char const* TRI_MemoryZoneName (TRI_memory_zone_id_t);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief initialize memory subsystem
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +37,7 @@
 #include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
 #endif
 
@@ -126,6 +127,42 @@ int TRI_writesocket (TRI_socket_t s, const void* buffer, size_t numBytesToWrite,
   return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes several memory regions with a single system call
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_writevsocket (TRI_socket_t s, TRI_socket_buffer_t const* buffers, size_t numBuffers) {
+  if (numBuffers > TRI_MAX_SOCKET_BUFFERS) {
+    numBuffers = TRI_MAX_SOCKET_BUFFERS;
+  }
+
+#ifdef _WIN32
+  WSABUF vec[TRI_MAX_SOCKET_BUFFERS];
+
+  for (size_t i = 0; i < numBuffers; ++i) {
+    vec[i].buf = const_cast<char*>(buffers[i]._data);
+    vec[i].len = (ULONG) buffers[i]._length;
+  }
+
+  DWORD sent = 0;
+
+  if (WSASend(s.fileHandle, vec, (DWORD) numBuffers, &sent, 0, nullptr, nullptr) != 0) {
+    return -1;
+  }
+
+  return (int) sent;
+#else
+  struct iovec vec[TRI_MAX_SOCKET_BUFFERS];
+
+  for (size_t i = 0; i < numBuffers; ++i) {
+    vec[i].iov_base = const_cast<char*>(buffers[i]._data);
+    vec[i].iov_len = buffers[i]._length;
+  }
+
+  return (int) writev(s.fileDescriptor, vec, (int) numBuffers);
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets close-on-exit for a socket
 ////////////////////////////////////////////////////////////////////////////////
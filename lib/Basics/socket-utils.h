@@ -66,6 +66,21 @@
   } TRI_socket_t;
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a memory region for a gathering write
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct TRI_socket_buffer_s {
+  char const* _data;
+  size_t _length;
+}
+TRI_socket_buffer_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal number of regions of a gathering write
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_MAX_SOCKET_BUFFERS (64)
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
@@ -290,6 +305,15 @@ int TRI_readsocket (TRI_socket_t, void* buffer, size_t numBytesToRead, int flags
 
 int TRI_writesocket (TRI_socket_t, const void* buffer, size_t numBytesToWrite, int flags);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes several memory regions with a single system call
+///
+/// at most TRI_MAX_SOCKET_BUFFERS regions are written. returns the number of
+/// bytes written or -1, like TRI_writesocket
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_writevsocket (TRI_socket_t, TRI_socket_buffer_t const* buffers, size_t numBuffers);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief sets non-blocking mode for a socket
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +32,11 @@
 #include "Basics/fpconv.h"
 #include "Zip/zip.h"
 
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define TRI_STRING_BUFFER_SSE2 1
+#endif
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -103,7 +108,14 @@ static int Reserve (TRI_string_buffer_t * self, size_t size) {
 
   if (size > Remaining(self)) {
     ptrdiff_t off = self->_current - self->_buffer;
-    size_t len = (size_t) (1.2 * (self->_len + size));
+    // the first reservation is taken as a size hint and allocated exactly,
+    // later ones grow the buffer by at least half, so that appending n bytes
+    // piecewise reallocates O(log n) times
+    size_t len = (size_t) off + size;
+
+    if (len < self->_len + self->_len / 2) {
+      len = self->_len + self->_len / 2;
+    }
     TRI_ASSERT(len > 0);
 
     char* ptr = static_cast<char*>(TRI_Reallocate(self->_memoryZone, self->_buffer, len + 1));
@@ -287,6 +299,57 @@ static void EscapeUtf8Range10000T10FFFF (TRI_string_buffer_t* self, char const**
   }
 }
    
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the length of the prefix of a string that can be copied
+/// into JSON output verbatim
+///
+/// These are the printable ASCII characters except the quote, the backslash
+/// and (optionally) the forward slash. With SSE2, 16 bytes are checked at
+/// once; a signed compare against the space character catches both control
+/// characters and bytes >= 0x80.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline size_t PlainJsonPrefix (char const* src,
+                                      size_t length,
+                                      bool escapeSlash) {
+  char const* table = escapeSlash ? JsonEscapeTableWithSlash : JsonEscapeTableWithoutSlash;
+  char const* ptr = src;
+  char const* end = src + length;
+
+#ifdef TRI_STRING_BUFFER_SSE2
+  __m128i const space     = _mm_set1_epi8(' ');
+  __m128i const quote     = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const slash     = _mm_set1_epi8(escapeSlash ? '/' : '"');
+
+  while (end - ptr >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+    __m128i const special = _mm_or_si128(
+      _mm_or_si128(_mm_cmplt_epi8(chunk, space), _mm_cmpeq_epi8(chunk, quote)),
+      _mm_or_si128(_mm_cmpeq_epi8(chunk, backslash), _mm_cmpeq_epi8(chunk, slash)));
+    int const mask = _mm_movemask_epi8(special);
+
+    if (mask != 0) {
+      return static_cast<size_t>(ptr - src) + static_cast<size_t>(__builtin_ctz(mask));
+    }
+
+    ptr += 16;
+  }
+#endif
+
+  while (ptr < end) {
+    uint8_t const c = static_cast<uint8_t>(*ptr);
+
+    if (c >= 0x80 || table[c] != 0) {
+      break;
+    }
+
+    ++ptr;
+  }
+
+  return static_cast<size_t>(ptr - src);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief appends characters but json-encode the string
 ////////////////////////////////////////////////////////////////////////////////
@@ -512,7 +575,8 @@ void  TRI_FreeStringBuffer (TRI_memory_zone_t* zone, TRI_string_buffer_t * self)
 ////////////////////////////////////////////////////////////////////////////////
 
 int TRI_DeflateStringBuffer (TRI_string_buffer_t* self,
-                             size_t bufferSize) {
+                             size_t bufferSize,
+                             int level) {
   TRI_string_buffer_t deflated;
   const char* ptr;
   const char* end;
@@ -525,7 +589,7 @@ int TRI_DeflateStringBuffer (TRI_string_buffer_t* self,
   strm.opaque = Z_NULL;
 
   // initialize deflate procedure
-  res = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+  res = deflateInit(&strm, level);
 
   if (res != Z_OK) {
     return TRI_ERROR_OUT_OF_MEMORY;
@@ -857,6 +921,17 @@ int TRI_AppendUrlEncodedStringStringBuffer (TRI_string_buffer_t * self,
   return TRI_ERROR_NO_ERROR;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the length of the prefix of a string that needs no
+/// escaping in JSON output
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_PlainJsonPrefix (char const* src,
+                            size_t length,
+                            bool escapeSlash) {
+  return PlainJsonPrefix(src, length, escapeSlash);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief appends characters but json-encode the null-terminated string
 ////////////////////////////////////////////////////////////////////////////////
@@ -864,19 +939,7 @@ int TRI_AppendUrlEncodedStringStringBuffer (TRI_string_buffer_t * self,
 int TRI_AppendJsonEncodedStringStringBuffer (TRI_string_buffer_t* self,
                                              char const* src,
                                              bool escapeSlash) {
-  char const* ptr = src;
-
-  while (*ptr != '\0') {
-    int res = AppendJsonEncodedValue(self, ptr, escapeSlash);
-
-    if (res != TRI_ERROR_NO_ERROR) {
-      return res;
-    }
-
-    ++ptr;
-  }
-
-  return TRI_ERROR_NO_ERROR;
+  return TRI_AppendJsonEncodedStringStringBuffer(self, src, strlen(src), escapeSlash);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -891,6 +954,23 @@ int TRI_AppendJsonEncodedStringStringBuffer (TRI_string_buffer_t* self,
   char const* end = src + length;
 
   while (ptr < end) {
+    // copy runs of characters that need no escaping in one go
+    size_t const plain = PlainJsonPrefix(ptr, static_cast<size_t>(end - ptr), escapeSlash);
+
+    if (plain > 0) {
+      int res = AppendString(self, ptr, plain);
+
+      if (res != TRI_ERROR_NO_ERROR) {
+        return res;
+      }
+
+      ptr += plain;
+
+      if (ptr == end) {
+        break;
+      }
+    }
+
     int res = AppendJsonEncodedValue(self, ptr, escapeSlash);
 
     if (res != TRI_ERROR_NO_ERROR) {
@@ -1209,6 +1289,16 @@ int TRI_AppendDoubleStringBuffer (TRI_string_buffer_t* self, double attr) {
     return TRI_AppendStringStringBuffer(self, "-inf");
   }
 
+  // integral values below 1e8 are printed by fpconv_dtoa as plain digits,
+  // so the much cheaper integer conversion yields the same text
+  if (attr > -1.0e8 && attr < 1.0e8) {
+    int32_t const value = static_cast<int32_t>(attr);
+
+    if (static_cast<double>(value) == attr && (value != 0 || ! std::signbit(attr))) {
+      return TRI_AppendInt32StringBuffer(self, value);
+    }
+  }
+
   int res = Reserve(self, 24);
 
   if (res != TRI_ERROR_NO_ERROR) {
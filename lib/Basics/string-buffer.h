@@ -111,10 +111,14 @@ void TRI_FreeStringBuffer (TRI_memory_zone_t*, TRI_string_buffer_t *);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief compress the string buffer using deflate
+///
+/// the level is a zlib compression level, from Z_BEST_SPEED to
+/// Z_BEST_COMPRESSION, or Z_DEFAULT_COMPRESSION
 ////////////////////////////////////////////////////////////////////////////////
 
 int TRI_DeflateStringBuffer (TRI_string_buffer_t*,
-                             size_t);
+                             size_t,
+                             int);
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief ensure the string buffer has a specific capacity
@@ -253,6 +257,13 @@ int TRI_AppendJsonEncodedStringStringBuffer (TRI_string_buffer_t* self, char con
 
 int TRI_AppendJsonEncodedStringStringBuffer (TRI_string_buffer_t* self, char const* str, size_t, bool);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the length of the prefix of a string that needs no
+/// escaping in JSON output
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_PlainJsonPrefix (char const*, size_t, bool);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 INTEGER APPENDERS
 // -----------------------------------------------------------------------------
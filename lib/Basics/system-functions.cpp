@@ -29,6 +29,120 @@
 
 #include "Basics/Common.h"
 
+#include <fstream>
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the NUMA topology, the processors of each node and the node of each
+/// processor
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+  struct NumaTopology {
+    std::vector<std::vector<size_t>> _nodes;
+    std::vector<size_t> _ids;
+    std::vector<size_t> _nodeOfProcessor;
+  };
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a list like "0-3,8-11" as used by sysfs
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+
+static std::vector<size_t> ParseSysfsList (std::string const& filename) {
+  std::vector<size_t> result;
+  std::ifstream in(filename);
+  std::string list;
+
+  if (! std::getline(in, list)) {
+    return result;
+  }
+
+  char const* p = list.c_str();
+
+  while (*p != '\0') {
+    char* end;
+    unsigned long from = strtoul(p, &end, 10);
+
+    if (end == p) {
+      break;
+    }
+
+    unsigned long to = from;
+    p = end;
+
+    if (*p == '-') {
+      ++p;
+      to = strtoul(p, &end, 10);
+
+      if (end == p) {
+        break;
+      }
+      p = end;
+    }
+
+    for (unsigned long i = from; i <= to; ++i) {
+      result.emplace_back(static_cast<size_t>(i));
+    }
+
+    if (*p != ',') {
+      break;
+    }
+    ++p;
+  }
+
+  return result;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the NUMA topology, which is read once from sysfs. the
+/// topology is empty if it is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+static NumaTopology const& GetNumaTopology () {
+  static NumaTopology const topology = [] () {
+    NumaTopology result;
+
+#ifdef __linux__
+    std::vector<size_t> online = ParseSysfsList("/sys/devices/system/node/online");
+
+    for (auto const& id : online) {
+      std::vector<size_t> processors = ParseSysfsList("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+
+      if (processors.empty()) {
+        // a node with memory only
+        continue;
+      }
+
+      for (auto const& p : processors) {
+        if (p >= result._nodeOfProcessor.size()) {
+          result._nodeOfProcessor.resize(p + 1, 0);
+        }
+        result._nodeOfProcessor[p] = result._nodes.size();
+      }
+
+      result._nodes.emplace_back(std::move(processors));
+      result._ids.emplace_back(id);
+    }
+#endif
+
+    return result;
+  }();
+
+  return topology;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
@@ -229,6 +343,69 @@ size_t TRI_numberProcessors () {
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of NUMA nodes, 1 if the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_numberNumaNodes () {
+  NumaTopology const& topology = GetNumaTopology();
+
+  if (topology._nodes.empty()) {
+    return 1;
+  }
+
+  return topology._nodes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the processors of a NUMA node, empty if the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t> TRI_numaNodeProcessors (size_t node) {
+  NumaTopology const& topology = GetNumaTopology();
+
+  if (node >= topology._nodes.size()) {
+    return std::vector<size_t>();
+  }
+
+  return topology._nodes[node];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the id the operating system uses for a NUMA node
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_numaNodeId (size_t node) {
+  NumaTopology const& topology = GetNumaTopology();
+
+  if (node >= topology._ids.size()) {
+    return node;
+  }
+
+  return topology._ids[node];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the NUMA node of the processor the calling thread runs on, 0 if
+/// the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_currentNumaNode () {
+#ifdef __linux__
+  NumaTopology const& topology = GetNumaTopology();
+
+  if (topology._nodes.size() > 1) {
+    int cpu = sched_getcpu();
+
+    if (cpu >= 0 && (size_t) cpu < topology._nodeOfProcessor.size()) {
+      return topology._nodeOfProcessor[cpu];
+    }
+  }
+#endif
+
+  return 0;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
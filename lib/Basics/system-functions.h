@@ -86,6 +86,32 @@ double TRI_microtime (void);
 
 size_t TRI_numberProcessors (void);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of NUMA nodes, 1 if the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_numberNumaNodes (void);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the processors of a NUMA node, empty if the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<size_t> TRI_numaNodeProcessors (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the id the operating system uses for a NUMA node. nodes without
+/// processors are not counted by the other functions, so the ids can differ
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_numaNodeId (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the NUMA node of the processor the calling thread runs on, 0 if
+/// the topology is unknown
+////////////////////////////////////////////////////////////////////////////////
+
+size_t TRI_currentNumaNode (void);
+
 #endif
 
 // -----------------------------------------------------------------------------
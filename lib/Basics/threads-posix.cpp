@@ -36,6 +36,7 @@
 #endif
 
 #include "Basics/logging.h"
+#include "Basics/SamplingProfiler.h"
 #include "Basics/tri-strings.h"
 
 // -----------------------------------------------------------------------------
@@ -68,6 +69,11 @@ thread_data_t;
 static void* ThreadStarter (void* data) {
   sigset_t all;
   sigfillset(&all);
+#ifdef TRI_HAVE_SAMPLING_PROFILER
+  // the profiling timer must reach the threads, SIGPROF is only raised while
+  // a profile runs
+  sigdelset(&all, SIGPROF);
+#endif
   pthread_sigmask(SIG_SETMASK, &all, 0);
 
   thread_data_t* d = static_cast<thread_data_t*>(data);
@@ -78,18 +84,24 @@ static void* ThreadStarter (void* data) {
   prctl(PR_SET_NAME, d->_name, 0, 0, 0);
 #endif
 
+  triagens::basics::SamplingProfiler::setThreadRole(d->_name);
+
   try {
     d->starter(d->_data); 
   }
   catch (...) {
     TRI_FreeString(TRI_CORE_MEM_ZONE, d->_name);
     TRI_Free(TRI_CORE_MEM_ZONE, d);
+    TRI_FlushMemoryZoneUsage();
     throw;
   }
 
   TRI_FreeString(TRI_CORE_MEM_ZONE, d->_name);
   TRI_Free(TRI_CORE_MEM_ZONE, d);
 
+  // publish what the thread has accounted, it would be lost otherwise
+  TRI_FlushMemoryZoneUsage();
+
   return nullptr;
 }
 
@@ -230,6 +242,30 @@ void TRI_SetProcessorAffinity (TRI_thread_t* thread, size_t core) {
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetProcessorAffinity (TRI_thread_t* thread, std::vector<size_t> const& cores) {
+#ifdef TRI_HAVE_THREAD_AFFINITY
+
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+
+  for (auto const& core : cores) {
+    CPU_SET(core, &cpuset);
+  }
+
+  int s = pthread_setaffinity_np(*thread, sizeof(cpu_set_t), &cpuset);
+
+  if (s != 0) {
+    LOG_ERROR("cannot set affinity to %d cores: %s", (int) cores.size(), strerror(errno));
+  }
+
+#endif
+}
+
 #endif
 
 // -----------------------------------------------------------------------------
@@ -66,6 +66,7 @@ static DWORD __stdcall ThreadStarter (void* data) {
   d->starter(d->_data);
 
   TRI_Free(TRI_CORE_MEM_ZONE, d);
+  TRI_FlushMemoryZoneUsage();
 
   return 0;
 }
@@ -226,6 +227,13 @@ void TRI_AllowCancelation(void) {
 void TRI_SetProcessorAffinity (TRI_thread_t* thread, size_t core) {
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetProcessorAffinity (TRI_thread_t* thread, std::vector<size_t> const& cores) {
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
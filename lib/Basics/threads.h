@@ -126,6 +126,12 @@ void TRI_AllowCancelation (void);
 
 void TRI_SetProcessorAffinity (TRI_thread_t*, size_t core);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the process affinity to a set of processors
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_SetProcessorAffinity (TRI_thread_t*, std::vector<size_t> const& cores);
+
 #endif
 
 // -----------------------------------------------------------------------------
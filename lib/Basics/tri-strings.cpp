@@ -29,6 +29,7 @@
 
 #include "tri-strings.h"
 #include "Basics/conversions.h"
+#include "Basics/string-buffer.h"
 #include "Basics/Utf8Helper.h"
 #include <openssl/sha.h>
 
@@ -1027,6 +1028,19 @@ char* TRI_EscapeUtf8String (TRI_memory_zone_t* zone,
   qtr = buffer;
 
   for (ptr = in, end = ptr + inLength;  ptr < end;  ++ptr, ++qtr) {
+    // copy the characters that need no escaping in one go
+    size_t const plain = TRI_PlainJsonPrefix(ptr, (size_t) (end - ptr), escapeSlash);
+
+    if (plain > 0) {
+      memcpy(qtr, ptr, plain);
+      ptr += plain;
+      qtr += plain;
+
+      if (ptr == end) {
+        break;
+      }
+    }
+
     switch (*ptr) {
       case '/':
         if (escapeSlash) {
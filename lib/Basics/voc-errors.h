@@ -358,6 +358,9 @@
 /// - 1476: @LIT{could not determine my ID from my local info}
 ///   Will be raised if a cluster server at startup could not determine its own
 ///   ID from the local info provided.
+/// - 1477: @LIT{write concern not reached}
+///   Will be raised if the leader of a shard has applied a write operation,
+///   but not enough followers of the shard acknowledged it.
 /// - 1500: @LIT{query killed}
 ///   Will be raised when a running query is killed by an explicit admin
 ///   command.
@@ -462,6 +465,9 @@
 /// - 1592: @LIT{query with this ID is in use}
 ///    "Will be raised when an Id of a query is found by the HTTP API but the
 ///   query is in use."
+/// - 1593: @LIT{query snippet not found}
+///    "Will be raised when a DB server is asked to instantiate a query snippet
+///   it does not know."
 /// - 1600: @LIT{cursor not found}
 ///   Will be raised when a cursor is requested via its id but a cursor with
 ///   that id cannot be found.
@@ -660,6 +666,11 @@
 ///   Will be returned if a queue with this name does not exist.
 /// - 21003: @LIT{named queue is full}
 ///   Will be returned if a queue with this name is full.
+/// - 21004: @LIT{queue time exceeded}
+///   Will be returned if a job was not started before its deadline.
+/// - 21005: @LIT{queue overloaded}
+///   Will be returned if a low priority job is rejected because the queue is
+///   overloaded.
 ////////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2140,6 +2151,17 @@ void TRI_InitializeErrorMessages ();
 
 #define TRI_ERROR_CLUSTER_COULD_NOT_DETERMINE_ID                          (1476)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 1477: ERROR_CLUSTER_WRITE_CONCERN_NOT_REACHED
+///
+/// write concern not reached
+///
+/// Will be raised if the leader of a shard has applied a write operation, but
+/// not enough followers of the shard acknowledged it.
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_ERROR_CLUSTER_WRITE_CONCERN_NOT_REACHED                       (1477)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief 1500: ERROR_QUERY_KILLED
 ///
@@ -2570,6 +2592,17 @@ void TRI_InitializeErrorMessages ();
 
 #define TRI_ERROR_QUERY_IN_USE                                            (1592)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 1593: ERROR_QUERY_SNIPPET_NOT_FOUND
+///
+/// query snippet not found
+///
+///  "Will be raised when a DB server is asked to instantiate a query snippet
+/// it does not know."
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_ERROR_QUERY_SNIPPET_NOT_FOUND                                 (1593)
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief 1600: ERROR_CURSOR_NOT_FOUND
 ///
@@ -3509,5 +3542,26 @@ void TRI_InitializeErrorMessages ();
 
 #define TRI_ERROR_QUEUE_FULL                                              (21003)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 21004: ERROR_QUEUE_TIME_EXCEEDED
+///
+/// queue time exceeded
+///
+/// Will be returned if a job was not started before its deadline.
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_ERROR_QUEUE_TIME_EXCEEDED                                     (21004)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief 21005: ERROR_QUEUE_OVERLOADED
+///
+/// queue overloaded
+///
+/// Will be returned if a low priority job is rejected because the queue is
+/// overloaded.
+////////////////////////////////////////////////////////////////////////////////
+
+#define TRI_ERROR_QUEUE_OVERLOADED                                        (21005)
+
 #endif
 
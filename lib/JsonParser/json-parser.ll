@@ -495,76 +495,6 @@ static bool ParseValue (yyscan_t scanner, TRI_json_t* result, int c) {
 // --SECTION--                                                  public functions
 // -----------------------------------------------------------------------------
 
-////////////////////////////////////////////////////////////////////////////////
-/// @brief parses a json string
-////////////////////////////////////////////////////////////////////////////////
-
-TRI_json_t* TRI_Json2String (TRI_memory_zone_t* zone, char const* text, char** error) {
-  TRI_json_t* object;
-  YY_BUFFER_STATE buf;
-  int c;
-  struct yyguts_t * yyg;
-  yyscan_t scanner;
-
-  object = static_cast<TRI_json_t*>
-                      (TRI_Allocate(zone, sizeof(TRI_json_t), false));
-
-  if (object == nullptr) {
-    // out of memory
-    return nullptr;
-  }
-  
-  // init as a JSON null object so the memory in object is initialized
-  TRI_InitNullJson(object);
-
-  yylex_init(&scanner);
-  yyg = (struct yyguts_t*) scanner;
-
-  yyextra._memoryZone = zone;
-
-  buf = yy_scan_string((char yyconst*) text, scanner);
-
-  c = yylex(scanner);
-  if (! ParseValue(scanner, object, c)) {
-    TRI_FreeJson(zone, object);
-    object = nullptr;
-    LOG_DEBUG("failed to parse json object: '%s'", yyextra._message);
-  }
-  else {
-    c = yylex(scanner);
-
-    if (c != END_OF_FILE) {
-      TRI_FreeJson(zone, object);
-      object = nullptr;
-      yyextra._message = "failed to parse json object: expecting EOF";
-
-      LOG_DEBUG("failed to parse json object: expecting EOF");
-    }
-  }
-
-  if (error != nullptr) {
-    if (yyextra._message != nullptr) {
-      *error = TRI_DuplicateString(yyextra._message);
-    }
-    else {
-      *error = nullptr;
-    }
-  }
-
-  yy_delete_buffer(buf, scanner);
-  yylex_destroy(scanner);
-
-  return object;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-/// @brief parses a json string
-////////////////////////////////////////////////////////////////////////////////
-
-TRI_json_t* TRI_JsonString (TRI_memory_zone_t* zone, char const* text) {
-  return TRI_Json2String(zone, text, nullptr);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief parses a json file
 ////////////////////////////////////////////////////////////////////////////////
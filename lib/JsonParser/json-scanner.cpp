@@ -0,0 +1,708 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-memory json scanner
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2011-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "json-scanner.h"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define TRI_JSON_SCANNER_SSE2 1
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief checks for a whitespace character
+////////////////////////////////////////////////////////////////////////////////
+
+static inline bool IsWhitespace (char c) {
+  return (c == ' ' || c == '\n' || c == '\r' || c == '\t');
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skips whitespace
+///
+/// Single blanks are the common case and are handled without touching the
+/// vector unit, longer runs (indentation) are skipped 16 bytes at a time.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline char const* SkipWhitespace (char const* p, char const* end) {
+  if (p < end && ! IsWhitespace(*p)) {
+    return p;
+  }
+
+#ifdef TRI_JSON_SCANNER_SSE2
+  __m128i const blank   = _mm_set1_epi8(' ');
+  __m128i const newline = _mm_set1_epi8('\n');
+  __m128i const cr      = _mm_set1_epi8('\r');
+  __m128i const tab     = _mm_set1_epi8('\t');
+
+  while (end - p >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    __m128i const ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, blank),
+                                                 _mm_cmpeq_epi8(chunk, newline)),
+                                    _mm_or_si128(_mm_cmpeq_epi8(chunk, cr),
+                                                 _mm_cmpeq_epi8(chunk, tab)));
+    int const mask = _mm_movemask_epi8(ws) ^ 0xFFFF;
+
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+
+    p += 16;
+  }
+#endif
+
+  while (p < end && IsWhitespace(*p)) {
+    ++p;
+  }
+
+  return p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the next character inside a string which needs attention
+///
+/// These are the quote, the backslash and all characters outside the range
+/// 0x20 - 0x7f, i. e. everything which ends the plain ASCII fast path.
+////////////////////////////////////////////////////////////////////////////////
+
+static inline char const* FindStringSpecial (char const* p, char const* end) {
+#ifdef TRI_JSON_SCANNER_SSE2
+  __m128i const quote     = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const control   = _mm_set1_epi8(0x20);
+
+  while (end - p >= 16) {
+    __m128i const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+    // the signed comparison also catches all bytes >= 0x80
+    __m128i const special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                      _mm_cmpeq_epi8(chunk, backslash)),
+                                         _mm_cmplt_epi8(chunk, control));
+    int const mask = _mm_movemask_epi8(special);
+
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+
+    p += 16;
+  }
+#endif
+
+  while (p < end) {
+    uint8_t c = (uint8_t) *p;
+
+    if (c == '"' || c == '\\' || c < 0x20 || c >= 0x80) {
+      return p;
+    }
+
+    ++p;
+  }
+
+  return end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans a string, the current position is at the opening quote
+////////////////////////////////////////////////////////////////////////////////
+
+static int ScanString (TRI_json_scanner_t* scanner) {
+  char const* p = scanner->_position + 1;
+  char const* end = scanner->_end;
+  bool ascii = true;
+
+  while (true) {
+    p = FindStringSpecial(p, end);
+
+    if (p == end) {
+      break;
+    }
+
+    char c = *p;
+
+    if (c == '"') {
+      ++p;
+      scanner->_tokenLength = p - scanner->_token;
+      scanner->_position = p;
+
+      return ascii ? TRI_JSON_TOKEN_STRING_ASCII : TRI_JSON_TOKEN_STRING;
+    }
+
+    ascii = false;
+
+    if (c == '\\') {
+      // a backslash escapes any character but a newline
+      if (p + 1 == end || p[1] == '\n') {
+        break;
+      }
+
+      p += 2;
+    }
+    else {
+      ++p;
+    }
+  }
+
+  // unterminated string, the quote itself is garbage
+  scanner->_tokenLength = 1;
+  scanner->_position = scanner->_token + 1;
+
+  return TRI_JSON_TOKEN_UNQUOTED_STRING;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans a number, the current position is at a sign or digit
+///
+/// Accepts [+-]?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)? using longest
+/// match, i. e. trailing characters that do not continue the number are left
+/// for the next token.
+////////////////////////////////////////////////////////////////////////////////
+
+static int ScanNumber (TRI_json_scanner_t* scanner) {
+  char const* p = scanner->_position;
+  char const* end = scanner->_end;
+
+  if (*p == '-' || *p == '+') {
+    ++p;
+  }
+
+  if (p == end || *p < '0' || *p > '9') {
+    scanner->_tokenLength = 1;
+    scanner->_position = scanner->_token + 1;
+
+    return TRI_JSON_TOKEN_UNQUOTED_STRING;
+  }
+
+  char const* digits = p;
+
+  if (*p == '0') {
+    ++p;
+  }
+  else {
+    while (p < end && *p >= '0' && *p <= '9') {
+      ++p;
+    }
+  }
+
+  size_t integerDigits = p - digits;
+
+  if (p + 1 < end && *p == '.' && p[1] >= '0' && p[1] <= '9') {
+    p += 2;
+
+    while (p < end && *p >= '0' && *p <= '9') {
+      ++p;
+    }
+
+    integerDigits = 0;
+  }
+
+  if (p + 1 < end && (*p == 'e' || *p == 'E')) {
+    char const* q = p + 1;
+
+    if (*q == '-' || *q == '+') {
+      ++q;
+    }
+
+    if (q < end && *q >= '0' && *q <= '9') {
+      while (q < end && *q >= '0' && *q <= '9') {
+        ++q;
+      }
+
+      p = q;
+      integerDigits = 0;
+    }
+  }
+
+  scanner->_tokenLength = p - scanner->_token;
+  scanner->_position = p;
+  // integers with up to 15 digits are exactly representable
+  scanner->_integerDigits = (integerDigits <= 15 ? integerDigits : 0);
+
+  return TRI_JSON_TOKEN_NUMBER;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scans a case-insensitive keyword
+////////////////////////////////////////////////////////////////////////////////
+
+static int ScanKeyword (TRI_json_scanner_t* scanner,
+                        char const* keyword,
+                        size_t length,
+                        int token) {
+  char const* p = scanner->_position;
+
+  if ((size_t) (scanner->_end - p) >= length) {
+    size_t i = 0;
+
+    // keywords consist of lower case letters only
+    while (i < length && (p[i] | 0x20) == keyword[i]) {
+      ++i;
+    }
+
+    if (i == length) {
+      scanner->_tokenLength = length;
+      scanner->_position = p + length;
+
+      return token;
+    }
+  }
+
+  scanner->_tokenLength = 1;
+  scanner->_position = p + 1;
+
+  return TRI_JSON_TOKEN_UNQUOTED_STRING;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief skips over a value starting with token c
+///
+/// Follows the structure of ParseValue in json-string-parser.cpp, so an
+/// element is split off exactly where the parser would end it.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool SkipValue (TRI_json_scanner_t* scanner, int c) {
+  switch (c) {
+    case TRI_JSON_TOKEN_FALSE:
+    case TRI_JSON_TOKEN_TRUE:
+    case TRI_JSON_TOKEN_NULL:
+    case TRI_JSON_TOKEN_NUMBER:
+    case TRI_JSON_TOKEN_STRING:
+    case TRI_JSON_TOKEN_STRING_ASCII:
+      return true;
+
+    case TRI_JSON_TOKEN_OPEN_BRACE:
+    case TRI_JSON_TOKEN_OPEN_BRACKET: {
+      bool const isObject = (c == TRI_JSON_TOKEN_OPEN_BRACE);
+      int const close = (isObject ? TRI_JSON_TOKEN_CLOSE_BRACE : TRI_JSON_TOKEN_CLOSE_BRACKET);
+      bool comma = false;
+
+      c = TRI_NextJsonScanner(scanner);
+
+      while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+        if (c == close) {
+          return true;
+        }
+
+        if (comma) {
+          if (c != TRI_JSON_TOKEN_COMMA) {
+            scanner->_message = "expecting comma";
+            return false;
+          }
+
+          c = TRI_NextJsonScanner(scanner);
+        }
+        else {
+          comma = true;
+        }
+
+        if (isObject) {
+          if (c != TRI_JSON_TOKEN_STRING && c != TRI_JSON_TOKEN_STRING_ASCII) {
+            scanner->_message = "expecting attribute name";
+            return false;
+          }
+
+          if (TRI_NextJsonScanner(scanner) != TRI_JSON_TOKEN_COLON) {
+            scanner->_message = "expecting colon";
+            return false;
+          }
+
+          c = TRI_NextJsonScanner(scanner);
+        }
+
+        if (! SkipValue(scanner, c)) {
+          return false;
+        }
+
+        c = TRI_NextJsonScanner(scanner);
+      }
+
+      if (isObject) {
+        scanner->_message = "expecting a object attribute name or element, got end-of-file";
+      }
+      else {
+        scanner->_message = "expecting a list element, got end-of-file";
+      }
+
+      return false;
+    }
+  }
+
+  TRI_UnexpectedJsonScanner(scanner, c);
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializes a scanner for a text
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitJsonScanner (TRI_json_scanner_t* scanner,
+                          char const* text,
+                          size_t length) {
+  scanner->_message = nullptr;
+  scanner->_position = text;
+  scanner->_end = text + length;
+  scanner->_token = text;
+  scanner->_tokenLength = 0;
+  scanner->_integerDigits = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next token
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NextJsonScanner (TRI_json_scanner_t* scanner) {
+  char const* p = SkipWhitespace(scanner->_position, scanner->_end);
+
+  scanner->_position = p;
+  scanner->_token = p;
+
+  if (p == scanner->_end) {
+    scanner->_tokenLength = 0;
+    return TRI_JSON_TOKEN_END_OF_FILE;
+  }
+
+  switch (*p) {
+    case '{':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_OPEN_BRACE;
+
+    case '}':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_CLOSE_BRACE;
+
+    case '[':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_OPEN_BRACKET;
+
+    case ']':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_CLOSE_BRACKET;
+
+    case ',':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_COMMA;
+
+    case ':':
+      scanner->_tokenLength = 1;
+      scanner->_position = p + 1;
+      return TRI_JSON_TOKEN_COLON;
+
+    case '"':
+      return ScanString(scanner);
+
+    case '-':
+    case '+':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      return ScanNumber(scanner);
+
+    case 'f':
+    case 'F':
+      return ScanKeyword(scanner, "false", 5, TRI_JSON_TOKEN_FALSE);
+
+    case 'n':
+    case 'N':
+      return ScanKeyword(scanner, "null", 4, TRI_JSON_TOKEN_NULL);
+
+    case 't':
+    case 'T':
+      return ScanKeyword(scanner, "true", 4, TRI_JSON_TOKEN_TRUE);
+  }
+
+  scanner->_tokenLength = 1;
+  scanner->_position = p + 1;
+
+  return TRI_JSON_TOKEN_UNQUOTED_STRING;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the current number token, sets _message on failure
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NumberJsonScanner (TRI_json_scanner_t* scanner, double* result) {
+  char const* p = scanner->_token;
+  size_t length = scanner->_tokenLength;
+
+  if (scanner->_integerDigits > 0) {
+    // fast path for small integers, the result is identical to strtod
+    bool negative = (*p == '-');
+    char const* end = p + length;
+    uint64_t value = 0;
+
+    p = end - scanner->_integerDigits;
+
+    while (p < end) {
+      value = value * 10 + (*p++ - '0');
+    }
+
+    *result = negative ? - (double) value : (double) value;
+
+    return true;
+  }
+
+  if (length >= 512) {
+    scanner->_message = "number too big";
+    return false;
+  }
+
+  // the text is not terminated after the token
+  char buffer[512];
+  memcpy(buffer, p, length);
+  buffer[length] = '\0';
+
+  // need to reset errno because return value of 0 is not distinguishable from an error on Linux
+  errno = 0;
+
+  char* ep;
+  double d = strtod(buffer, &ep);
+
+  if (d == HUGE_VAL && errno == ERANGE) {
+    scanner->_message = "number too big";
+    return false;
+  }
+
+  if (d == 0 && errno == ERANGE) {
+    scanner->_message = "number too small";
+    return false;
+  }
+
+  if (ep != buffer + length) {
+    scanner->_message = "cannot parse number";
+    return false;
+  }
+
+  *result = d;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets _message for a token which cannot start a value
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_UnexpectedJsonScanner (TRI_json_scanner_t* scanner, int token) {
+  switch (token) {
+    case TRI_JSON_TOKEN_CLOSE_BRACE:
+      scanner->_message = "expected object, got '}'";
+      return;
+
+    case TRI_JSON_TOKEN_CLOSE_BRACKET:
+      scanner->_message = "expected object, got ']'";
+      return;
+
+    case TRI_JSON_TOKEN_COMMA:
+      scanner->_message = "expected object, got ','";
+      return;
+
+    case TRI_JSON_TOKEN_COLON:
+      scanner->_message = "expected object, got ':'";
+      return;
+
+    case TRI_JSON_TOKEN_UNQUOTED_STRING:
+      scanner->_message = "expected object, got unquoted string";
+      return;
+
+    case TRI_JSON_TOKEN_END_OF_FILE:
+      scanner->_message = "expecting atom, got end-of-file";
+      return;
+  }
+
+  scanner->_message = "unknown atom";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializes an array reader, returns false if the text does not
+/// start with an array
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_InitJsonArrayReader (TRI_json_array_reader_t* reader,
+                              char const* text,
+                              size_t length) {
+  TRI_InitJsonScanner(&reader->_scanner, text, length);
+  reader->_first = true;
+  reader->_done = false;
+
+  if (TRI_NextJsonScanner(&reader->_scanner) != TRI_JSON_TOKEN_OPEN_BRACKET) {
+    reader->_scanner._message = "expecting a JSON array";
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the text of the next array element
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NextJsonArrayReader (TRI_json_array_reader_t* reader,
+                              char const** value,
+                              size_t* length) {
+  TRI_json_scanner_t* scanner = &reader->_scanner;
+
+  *value = nullptr;
+  *length = 0;
+
+  if (reader->_done) {
+    return true;
+  }
+
+  int c = TRI_NextJsonScanner(scanner);
+
+  if (c == TRI_JSON_TOKEN_CLOSE_BRACKET) {
+    if (TRI_NextJsonScanner(scanner) != TRI_JSON_TOKEN_END_OF_FILE) {
+      scanner->_message = "failed to parse json object: expecting EOF";
+      return false;
+    }
+
+    reader->_done = true;
+    return true;
+  }
+
+  if (c == TRI_JSON_TOKEN_END_OF_FILE) {
+    scanner->_message = "expecting a list element, got end-of-file";
+    return false;
+  }
+
+  if (reader->_first) {
+    reader->_first = false;
+  }
+  else {
+    if (c != TRI_JSON_TOKEN_COMMA) {
+      scanner->_message = "expecting comma";
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(scanner);
+  }
+
+  char const* start = scanner->_token;
+
+  if (! SkipValue(scanner, c)) {
+    return false;
+  }
+
+  *value = start;
+  *length = static_cast<size_t>(scanner->_token + scanner->_tokenLength - start);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the text of an attribute value in the text of a json object
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_FindAttributeJsonScanner (char const* text,
+                                   size_t length,
+                                   char const* name,
+                                   char const** value,
+                                   size_t* valueLength) {
+  TRI_json_scanner_t scanner;
+  TRI_InitJsonScanner(&scanner, text, length);
+
+  *value = nullptr;
+  *valueLength = 0;
+
+  if (TRI_NextJsonScanner(&scanner) != TRI_JSON_TOKEN_OPEN_BRACE) {
+    return false;
+  }
+
+  size_t const nameLength = strlen(name);
+  bool first = true;
+
+  while (true) {
+    int c = TRI_NextJsonScanner(&scanner);
+
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACE || c == TRI_JSON_TOKEN_END_OF_FILE) {
+      return false;
+    }
+
+    if (first) {
+      first = false;
+    }
+    else {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        return false;
+      }
+
+      c = TRI_NextJsonScanner(&scanner);
+    }
+
+    if (c != TRI_JSON_TOKEN_STRING && c != TRI_JSON_TOKEN_STRING_ASCII) {
+      return false;
+    }
+
+    // the token includes the quotes
+    bool const found = (scanner._tokenLength == nameLength + 2 &&
+                        memcmp(scanner._token + 1, name, nameLength) == 0);
+
+    if (TRI_NextJsonScanner(&scanner) != TRI_JSON_TOKEN_COLON) {
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(&scanner);
+    char const* start = scanner._token;
+
+    if (! SkipValue(&scanner, c)) {
+      return false;
+    }
+
+    if (found) {
+      *value = start;
+      *valueLength = static_cast<size_t>(scanner._token + scanner._tokenLength - start);
+      return true;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -0,0 +1,170 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-memory json scanner
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2011-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_JSON_PARSER_JSON_SCANNER_H
+#define ARANGODB_JSON_PARSER_JSON_SCANNER_H 1
+
+#include "Basics/Common.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      public types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief tokens, identical to the ones of the flex based file parser
+////////////////////////////////////////////////////////////////////////////////
+
+enum TRI_json_token_e {
+  TRI_JSON_TOKEN_END_OF_FILE = 0,
+  TRI_JSON_TOKEN_FALSE = 1,
+  TRI_JSON_TOKEN_TRUE = 2,
+  TRI_JSON_TOKEN_NULL = 3,
+  TRI_JSON_TOKEN_NUMBER = 4,
+  TRI_JSON_TOKEN_STRING = 5,
+  TRI_JSON_TOKEN_OPEN_BRACE = 6,
+  TRI_JSON_TOKEN_CLOSE_BRACE = 7,
+  TRI_JSON_TOKEN_OPEN_BRACKET = 8,
+  TRI_JSON_TOKEN_CLOSE_BRACKET = 9,
+  TRI_JSON_TOKEN_COMMA = 10,
+  TRI_JSON_TOKEN_COLON = 11,
+  TRI_JSON_TOKEN_UNQUOTED_STRING = 12,
+  TRI_JSON_TOKEN_STRING_ASCII = 13
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief scanner state
+///
+/// The scanner works directly on the input text and never copies it. A token
+/// is described by its start and length inside the text, string tokens
+/// include their quotes. TRI_JSON_TOKEN_STRING_ASCII strings contain neither
+/// escapes nor characters outside 0x20 - 0x7f and can be used as they are.
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_json_scanner_t {
+  char const* _message;
+
+  char const* _position;
+  char const* _end;
+
+  char const* _token;
+  size_t _tokenLength;
+
+  // number of digits of a number token without fraction and exponent,
+  // or 0 if the number needs strtod
+  size_t _integerDigits;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reader for the elements of a json array
+///
+/// Splits the text of a json array into the texts of its elements without
+/// converting anything, so each element can be parsed or shaped on its own
+/// and the array never needs to exist as a whole.
+////////////////////////////////////////////////////////////////////////////////
+
+struct TRI_json_array_reader_t {
+  TRI_json_scanner_t _scanner;
+  bool _first;
+  bool _done;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializes a scanner for a text
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_InitJsonScanner (TRI_json_scanner_t*, char const* text, size_t length);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the next token
+////////////////////////////////////////////////////////////////////////////////
+
+int TRI_NextJsonScanner (TRI_json_scanner_t*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief converts the current number token, sets _message on failure
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NumberJsonScanner (TRI_json_scanner_t*, double*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets _message for a token which cannot start a value
+////////////////////////////////////////////////////////////////////////////////
+
+void TRI_UnexpectedJsonScanner (TRI_json_scanner_t*, int token);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initializes an array reader, returns false if the text does not
+/// start with an array
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_InitJsonArrayReader (TRI_json_array_reader_t*,
+                              char const* text,
+                              size_t length);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the text of the next array element
+///
+/// Sets value to nullptr once the array is closed and only whitespace
+/// follows. Returns false and sets _scanner._message if the array is
+/// malformed. Elements are only checked structurally, scalars inside them
+/// are validated when the element itself is parsed.
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_NextJsonArrayReader (TRI_json_array_reader_t*,
+                              char const** value,
+                              size_t* length);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the text of an attribute value in the text of a json object
+///
+/// Only the top level of the object is searched, up to the attribute. The
+/// name is compared with the attribute names as they appear in the text, so
+/// names containing escapes are not found. Returns false if the attribute
+/// does not exist or the text is not a json object.
+////////////////////////////////////////////////////////////////////////////////
+
+bool TRI_FindAttributeJsonScanner (char const* text,
+                                   size_t length,
+                                   char const* name,
+                                   char const** value,
+                                   size_t* valueLength);
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
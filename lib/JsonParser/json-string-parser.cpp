@@ -0,0 +1,355 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-memory json parser
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+/// @author Copyright 2011-2013, triAGENS GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Basics/Common.h"
+
+#include "Basics/json.h"
+#include "Basics/tri-strings.h"
+#include "Basics/logging.h"
+#include "JsonParser/json-scanner.h"
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+static char const* EmptyString = "";
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     private types
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parser state
+////////////////////////////////////////////////////////////////////////////////
+
+struct json_parser_t {
+  TRI_memory_zone_t* _memoryZone;
+  TRI_json_scanner_t _scanner;
+};
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                              forward declarations
+// -----------------------------------------------------------------------------
+
+static bool ParseValue (json_parser_t*, TRI_json_t*, int);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses an array
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseArray (json_parser_t* parser, TRI_json_t* result) {
+  TRI_InitArrayJson(parser->_memoryZone, result);
+
+  int c = TRI_NextJsonScanner(&parser->_scanner);
+  bool comma = false;
+
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACKET) {
+      return true;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        parser->_scanner._message = "expecting comma";
+        return false;
+      }
+
+      c = TRI_NextJsonScanner(&parser->_scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    // create the upcoming element in place
+    TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+
+    if (next == nullptr) {
+      parser->_scanner._message = "out-of-memory";
+      return false;
+    }
+
+    TRI_InitNullJson(next);
+
+    if (! ParseValue(parser, next, c)) {
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(&parser->_scanner);
+  }
+
+  parser->_scanner._message = "expecting a list element, got end-of-file";
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses an object
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseObject (json_parser_t* parser, TRI_json_t* result) {
+  TRI_InitObjectJson(parser->_memoryZone, result);
+
+  int c = TRI_NextJsonScanner(&parser->_scanner);
+  bool comma = false;
+
+  while (c != TRI_JSON_TOKEN_END_OF_FILE) {
+    if (c == TRI_JSON_TOKEN_CLOSE_BRACE) {
+      return true;
+    }
+
+    if (comma) {
+      if (c != TRI_JSON_TOKEN_COMMA) {
+        parser->_scanner._message = "expecting comma";
+        return false;
+      }
+
+      c = TRI_NextJsonScanner(&parser->_scanner);
+    }
+    else {
+      comma = true;
+    }
+
+    char* name;
+    size_t nameLen;
+
+    if (c == TRI_JSON_TOKEN_STRING) {
+      name = TRI_UnescapeUtf8String(parser->_memoryZone,
+                                    parser->_scanner._token + 1,
+                                    parser->_scanner._tokenLength - 2,
+                                    &nameLen);
+    }
+    else if (c == TRI_JSON_TOKEN_STRING_ASCII) {
+      nameLen = parser->_scanner._tokenLength - 2;
+      name = TRI_DuplicateString2Z(parser->_memoryZone, parser->_scanner._token + 1, nameLen);
+    }
+    else {
+      parser->_scanner._message = "expecting attribute name";
+      return false;
+    }
+
+    if (name == nullptr) {
+      parser->_scanner._message = "out-of-memory";
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(&parser->_scanner);
+
+    if (c != TRI_JSON_TOKEN_COLON) {
+      TRI_FreeString(parser->_memoryZone, name);
+      parser->_scanner._message = "expecting colon";
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(&parser->_scanner);
+
+    // allocate room for name and value at once
+    int res = TRI_ReserveVector(&result->_value._objects, 2);
+
+    if (res != TRI_ERROR_NO_ERROR) {
+      TRI_FreeString(parser->_memoryZone, name);
+      parser->_scanner._message = "out-of-memory";
+      return false;
+    }
+
+    TRI_json_t* next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+    TRI_ASSERT_EXPENSIVE(next != nullptr);
+    TRI_InitStringJson(next, name, nameLen);
+
+    next = static_cast<TRI_json_t*>(TRI_NextVector(&result->_value._objects));
+    TRI_ASSERT_EXPENSIVE(next != nullptr);
+    TRI_InitNullJson(next);
+
+    if (! ParseValue(parser, next, c)) {
+      return false;
+    }
+
+    c = TRI_NextJsonScanner(&parser->_scanner);
+  }
+
+  parser->_scanner._message = "expecting a object attribute name or element, got end-of-file";
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a value
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ParseValue (json_parser_t* parser, TRI_json_t* result, int c) {
+  switch (c) {
+    case TRI_JSON_TOKEN_FALSE:
+      TRI_InitBooleanJson(result, false);
+      return true;
+
+    case TRI_JSON_TOKEN_TRUE:
+      TRI_InitBooleanJson(result, true);
+      return true;
+
+    case TRI_JSON_TOKEN_NULL:
+      TRI_InitNullJson(result);
+      return true;
+
+    case TRI_JSON_TOKEN_NUMBER: {
+      double value;
+
+      if (! TRI_NumberJsonScanner(&parser->_scanner, &value)) {
+        return false;
+      }
+
+      TRI_InitNumberJson(result, value);
+      return true;
+    }
+
+    case TRI_JSON_TOKEN_STRING:
+    case TRI_JSON_TOKEN_STRING_ASCII: {
+      size_t length = parser->_scanner._tokenLength - 2;
+
+      if (length == 0) {
+        // create a reference to the compiled-in empty string
+        TRI_InitStringReferenceJson(result, EmptyString, 0);
+        return true;
+      }
+
+      char* ptr;
+
+      if (c == TRI_JSON_TOKEN_STRING_ASCII) {
+        ptr = TRI_DuplicateString2Z(parser->_memoryZone, parser->_scanner._token + 1, length);
+      }
+      else {
+        ptr = TRI_UnescapeUtf8String(parser->_memoryZone, parser->_scanner._token + 1, length, &length);
+      }
+
+      if (ptr == nullptr) {
+        parser->_scanner._message = "out-of-memory";
+        return false;
+      }
+
+      TRI_InitStringJson(result, ptr, length);
+      return true;
+    }
+
+    case TRI_JSON_TOKEN_OPEN_BRACE:
+      return ParseObject(parser, result);
+
+    case TRI_JSON_TOKEN_OPEN_BRACKET:
+      return ParseArray(parser, result);
+  }
+
+  TRI_UnexpectedJsonScanner(&parser->_scanner, c);
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string
+///
+/// Accepts the same language as the flex based file parser and produces the
+/// same error messages, but scans the text in place instead of copying it
+/// into a scanner buffer first, see json-scanner.h.
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_Json2String (TRI_memory_zone_t* zone, char const* text, char** error) {
+  return TRI_Json2StringLength(zone, text, strlen(text), error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string of a given length and returns error message
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_Json2StringLength (TRI_memory_zone_t* zone,
+                                   char const* text,
+                                   size_t length,
+                                   char** error) {
+  TRI_json_t* object = static_cast<TRI_json_t*>(TRI_Allocate(zone, sizeof(TRI_json_t), false));
+
+  if (object == nullptr) {
+    // out of memory
+    return nullptr;
+  }
+
+  // init as a JSON null object so the memory in object is initialized
+  TRI_InitNullJson(object);
+
+  json_parser_t parser;
+  parser._memoryZone = zone;
+  TRI_InitJsonScanner(&parser._scanner, text, length);
+
+  int c = TRI_NextJsonScanner(&parser._scanner);
+
+  if (! ParseValue(&parser, object, c)) {
+    TRI_FreeJson(zone, object);
+    object = nullptr;
+    LOG_DEBUG("failed to parse json object: '%s'", parser._scanner._message);
+  }
+  else {
+    c = TRI_NextJsonScanner(&parser._scanner);
+
+    if (c != TRI_JSON_TOKEN_END_OF_FILE) {
+      TRI_FreeJson(zone, object);
+      object = nullptr;
+      parser._scanner._message = "failed to parse json object: expecting EOF";
+
+      LOG_DEBUG("failed to parse json object: expecting EOF");
+    }
+  }
+
+  if (error != nullptr) {
+    if (parser._scanner._message != nullptr) {
+      *error = TRI_DuplicateString(parser._scanner._message);
+    }
+    else {
+      *error = nullptr;
+    }
+  }
+
+  return object;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a json string
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* TRI_JsonString (TRI_memory_zone_t* zone, char const* text) {
+  return TRI_Json2String(zone, text, nullptr);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
@@ -241,6 +241,14 @@ namespace triagens {
           return _specification;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief get the listen backlog size
+////////////////////////////////////////////////////////////////////////////////
+
+        int getListenBacklog () const {
+          return _listenBacklog;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief get endpoint domain
 ////////////////////////////////////////////////////////////////////////////////
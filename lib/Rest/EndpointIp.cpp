@@ -95,7 +95,8 @@ EndpointIp::EndpointIp (const Endpoint::EndpointType type,
   : Endpoint(type, domainType, encryption, specification, listenBacklog),
     _host(host),
     _port(port),
-    _reuseAddress(reuseAddress) {
+    _reuseAddress(reuseAddress),
+    _reusePort(false) {
 
   TRI_ASSERT(domainType == DOMAIN_IPV4 || domainType == Endpoint::DOMAIN_IPV6);
 }
@@ -186,6 +187,26 @@ TRI_socket_t EndpointIp::connectSocket (const struct addrinfo* aip,
         return listenSocket;
       }
     }
+
+#ifdef SO_REUSEPORT
+    // share the port with the other listeners of the endpoint
+    if (_reusePort) {
+      int opt = 1;
+      if (TRI_setsockopt(listenSocket, SOL_SOCKET, SO_REUSEPORT, reinterpret_cast<char*> (&opt), sizeof (opt)) == -1) {
+
+        pErr = STR_ERROR();
+        snprintf(errBuf, sizeof(errBuf), "setsockopt() failed with #%d - %s",
+                 errno,
+                 pErr);
+        
+        _errorMessage = errBuf;
+
+        TRI_CLOSE_SOCKET(listenSocket);
+        TRI_invalidatesocket(&listenSocket);
+        return listenSocket;
+      }
+    }
+#endif
 #endif
 
     // server needs to bind to socket
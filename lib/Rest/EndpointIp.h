@@ -139,6 +139,34 @@ namespace triagens {
           return _host;
         }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the address is reused
+////////////////////////////////////////////////////////////////////////////////
+
+        bool reuseAddress () const {
+          return _reuseAddress;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not the port is shared with other sockets
+////////////////////////////////////////////////////////////////////////////////
+
+        bool reusePort () const {
+          return _reusePort;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief lets the port be shared with other sockets
+///
+/// several server sockets with this flag can bind to the same address and
+/// port, and the kernel distributes the incoming connections among them.
+/// must be set before connecting
+////////////////////////////////////////////////////////////////////////////////
+
+        void setReusePort (bool value) {
+          _reusePort = value;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                 private variables
 // -----------------------------------------------------------------------------
@@ -163,6 +191,12 @@ namespace triagens {
 
         bool _reuseAddress;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether or not to share the port (SO_REUSEPORT)
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _reusePort;
+
     };
 
   }
@@ -30,6 +30,7 @@
 
 #include "HttpRequest.h"
 #include "Basics/conversions.h"
+#include "Basics/json-binary.h"
 #include "Basics/logging.h"
 #include "Basics/StringBuffer.h"
 #include "Basics/StringUtils.h"
@@ -70,10 +71,10 @@ HttpRequest::HttpRequest (ConnectionInfo const& info,
                           int32_t defaultApiCompatibility,
                           bool allowMethodOverride)
   : _requestPath(EMPTY_STR),
-    _headers(5),
-    _values(10),
-    _arrayValues(1),
-    _cookies(1),
+    _headers(),
+    _values(),
+    _arrayValues(),
+    _cookies(),
     _contentLength(0),
     _body(nullptr),
     _bodySize(0),
@@ -108,8 +109,8 @@ HttpRequest::HttpRequest (ConnectionInfo const& info,
 ////////////////////////////////////////////////////////////////////////////////
 
 HttpRequest::~HttpRequest () {
-  basics::Dictionary< vector<char const*>* >::KeyValue const* begin;
-  basics::Dictionary< vector<char const*>* >::KeyValue const* end;
+  array_value_fields_t::KeyValue const* begin;
+  array_value_fields_t::KeyValue const* end;
   for (_arrayValues.range(begin, end);  begin < end;  ++begin) {
     char const* key = begin->_key;
 
@@ -159,11 +160,11 @@ void HttpRequest::write (TRI_string_buffer_t* buffer) const {
   TRI_AppendStringStringBuffer(buffer, _requestPath);
 
   // generate the request parameters
-  basics::Dictionary<char const*>::KeyValue const* begin;
-  basics::Dictionary<char const*>::KeyValue const* end;
-
   bool first = true;
 
+  value_fields_t::KeyValue const* begin;
+  value_fields_t::KeyValue const* end;
+
   for (_values.range(begin, end);  begin < end;  ++begin) {
     char const* key = begin->_key;
 
@@ -189,14 +190,17 @@ void HttpRequest::write (TRI_string_buffer_t* buffer) const {
   TRI_AppendString2StringBuffer(buffer, " HTTP/1.1\r\n", 11);
 
   // generate the header fields
-  for (_headers.range(begin, end);  begin < end;  ++begin) {
-    char const* key = begin->_key;
+  header_fields_t::KeyValue const* hBegin;
+  header_fields_t::KeyValue const* hEnd;
+
+  for (_headers.range(hBegin, hEnd);  hBegin < hEnd;  ++hBegin) {
+    char const* key = hBegin->_key;
 
     if (key == nullptr) {
       continue;
     }
 
-    size_t const keyLength = strlen(key);
+    size_t const keyLength = hBegin->_keyLength;
 
     if (keyLength == 14 && memcmp(key, "content-length", keyLength) == 0) {
       continue;
@@ -205,14 +209,18 @@ void HttpRequest::write (TRI_string_buffer_t* buffer) const {
     TRI_AppendString2StringBuffer(buffer, key, keyLength);
     TRI_AppendString2StringBuffer(buffer, ": ", 2);
 
-    char const* value = begin->_value;
+    char const* value = hBegin->_value;
     TRI_AppendStringStringBuffer(buffer, value);
     TRI_AppendString2StringBuffer(buffer, "\r\n", 2);
   }
 
   first = true;
-  for (_cookies.range(begin, end);  begin < end;  ++begin) {
-    char const* key = begin->_key;
+
+  cookie_fields_t::KeyValue const* cBegin;
+  cookie_fields_t::KeyValue const* cEnd;
+
+  for (_cookies.range(cBegin, cEnd);  cBegin < cEnd;  ++cBegin) {
+    char const* key = cBegin->_key;
 
     if (key == nullptr) {
       continue;
@@ -226,11 +234,11 @@ void HttpRequest::write (TRI_string_buffer_t* buffer) const {
       TRI_AppendString2StringBuffer(buffer, "; ", 2);
     }
 
-    size_t const keyLength = strlen(key);
+    size_t const keyLength = cBegin->_keyLength;
     TRI_AppendString2StringBuffer(buffer, key, keyLength);
     TRI_AppendString2StringBuffer(buffer, "=", 2);
 
-    char const* value = begin->_value;
+    char const* value = cBegin->_value;
     TRI_AppendUrlEncodedStringStringBuffer(buffer, value);
   }
 
@@ -256,7 +264,7 @@ int64_t HttpRequest::contentLength () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::header (char const* key) const {
-  Dictionary<char const*>::KeyValue const* kv = _headers.lookup(key);
+  header_fields_t::KeyValue const* kv = _headers.lookup(key);
 
   if (kv == nullptr) {
     return EMPTY_STR;
@@ -271,7 +279,7 @@ char const* HttpRequest::header (char const* key) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::header (char const* key, bool& found) const {
-  Dictionary<char const*>::KeyValue const* kv = _headers.lookup(key);
+  header_fields_t::KeyValue const* kv = _headers.lookup(key);
 
   if (kv == nullptr) {
     found = false;
@@ -288,8 +296,8 @@ char const* HttpRequest::header (char const* key, bool& found) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 map<string, string> HttpRequest::headers () const {
-  basics::Dictionary<char const*>::KeyValue const* begin;
-  basics::Dictionary<char const*>::KeyValue const* end;
+  header_fields_t::KeyValue const* begin;
+  header_fields_t::KeyValue const* end;
 
   map<string, string> result;
 
@@ -313,7 +321,7 @@ map<string, string> HttpRequest::headers () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::value (char const* key) const {
-  Dictionary<char const*>::KeyValue const* kv = _values.lookup(key);
+  value_fields_t::KeyValue const* kv = _values.lookup(key);
 
   if (kv == nullptr) {
     return EMPTY_STR;
@@ -328,7 +336,7 @@ char const* HttpRequest::value (char const* key) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::value (char const* key, bool& found) const {
-  Dictionary<char const*>::KeyValue const* kv = _values.lookup(key);
+  value_fields_t::KeyValue const* kv = _values.lookup(key);
 
   if (kv == nullptr) {
     found = false;
@@ -345,8 +353,8 @@ char const* HttpRequest::value (char const* key, bool& found) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 map<string, string> HttpRequest::values () const {
-  basics::Dictionary<char const*>::KeyValue const* begin;
-  basics::Dictionary<char const*>::KeyValue const* end;
+  value_fields_t::KeyValue const* begin;
+  value_fields_t::KeyValue const* end;
 
   map<string, string> result;
 
@@ -368,8 +376,8 @@ map<string, string> HttpRequest::values () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 map<string, vector<char const*>* > HttpRequest::arrayValues () const {
-  basics::Dictionary< vector<char const*>* >::KeyValue const* begin;
-  basics::Dictionary< vector<char const*>* >::KeyValue const* end;
+  array_value_fields_t::KeyValue const* begin;
+  array_value_fields_t::KeyValue const* end;
 
   map<string, vector<char const*>* > result;
 
@@ -391,7 +399,7 @@ map<string, vector<char const*>* > HttpRequest::arrayValues () const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::cookieValue (char const* key) const {
-  Dictionary<char const*>::KeyValue const* kv = _cookies.lookup(key);
+  cookie_fields_t::KeyValue const* kv = _cookies.lookup(key);
 
   if (kv == nullptr) {
     return EMPTY_STR;
@@ -406,7 +414,7 @@ char const* HttpRequest::cookieValue (char const* key) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 char const* HttpRequest::cookieValue (char const* key, bool& found) const {
-  Dictionary<char const*>::KeyValue const* kv = _cookies.lookup(key);
+  cookie_fields_t::KeyValue const* kv = _cookies.lookup(key);
 
   if (kv == nullptr) {
     found = false;
@@ -423,8 +431,8 @@ char const* HttpRequest::cookieValue (char const* key, bool& found) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 map<string, string> HttpRequest::cookieValues () const {
-  basics::Dictionary<char const*>::KeyValue const* begin;
-  basics::Dictionary<char const*>::KeyValue const* end;
+  cookie_fields_t::KeyValue const* begin;
+  cookie_fields_t::KeyValue const* end;
 
   map<string, string> result;
 
@@ -519,7 +527,36 @@ void HttpRequest::setHeader (char const* key,
 ////////////////////////////////////////////////////////////////////////////////
 
 TRI_json_t* HttpRequest::toJson (char** errmsg) {
-  return TRI_Json2String(TRI_UNKNOWN_MEM_ZONE, body(), errmsg);
+  return toJson(TRI_UNKNOWN_MEM_ZONE, errmsg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief gets the request body as TRI_json_t*, allocated in the given zone
+////////////////////////////////////////////////////////////////////////////////
+
+TRI_json_t* HttpRequest::toJson (TRI_memory_zone_t* zone,
+                                 char** errmsg) {
+  if (hasBinaryJsonBody()) {
+    return TRI_BinaryJson(zone, body(), bodySize(), errmsg);
+  }
+
+  return TRI_Json2String(zone, body(), errmsg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the request body is binary json
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpRequest::hasBinaryJsonBody () const {
+  return TRI_IsBinaryJsonContentType(header("content-type"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the client accepts binary json responses
+////////////////////////////////////////////////////////////////////////////////
+
+bool HttpRequest::acceptsBinaryJson () const {
+  return TRI_IsBinaryJsonContentType(header("accept"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1381,7 +1418,7 @@ void HttpRequest::appendMethod (HttpRequestType method, StringBuffer* buffer) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void HttpRequest::setArrayValue (char* key, size_t length, char const* value) {
-  Dictionary< vector<char const*>* >::KeyValue const* kv = _arrayValues.lookup(key);
+  array_value_fields_t::KeyValue const* kv = _arrayValues.lookup(key, length);
   vector<char const*>* v = nullptr;
 
   if (kv == nullptr) {
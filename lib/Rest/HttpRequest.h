@@ -32,7 +32,7 @@
 #define ARANGODB_REST_HTTP_REQUEST_H 1
 
 #include "Basics/Common.h"
-#include "Basics/Dictionary.h"
+#include "Basics/FlatDictionary.h"
 
 #include "Basics/json.h"
 #include "Basics/string-buffer.h"
@@ -91,6 +91,33 @@ namespace triagens {
           HTTP_1_1
         };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief header fields
+///
+/// Keys and values point into the copy of the header block owned by the
+/// request, the table itself is part of the request for up to 16 fields.
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef basics::FlatDictionary<char const*, 32> header_fields_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief url parameters
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef basics::FlatDictionary<char const*, 16> value_fields_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief array url parameters
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef basics::FlatDictionary<std::vector<char const*>*, 4> array_value_fields_t;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief cookies
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef basics::FlatDictionary<char const*, 8> cookie_fields_t;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                           static public variables
 // -----------------------------------------------------------------------------
@@ -415,6 +442,17 @@ namespace triagens {
 
         std::map<std::string, std::string> headers () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns all header fields without copying them
+///
+/// Note: the content-length header is not part of the fields, use
+/// contentLength() instead.
+////////////////////////////////////////////////////////////////////////////////
+
+        header_fields_t const& headerFields () const {
+          return _headers;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                              public value methods
 // -----------------------------------------------------------------------------
@@ -447,6 +485,14 @@ namespace triagens {
 
         std::map<std::string, std::string> values () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns all values without copying them
+////////////////////////////////////////////////////////////////////////////////
+
+        value_fields_t const& valueFields () const {
+          return _values;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief returns all array values
 ///
@@ -479,6 +525,14 @@ namespace triagens {
 
         std::map<std::string, std::string > cookieValues () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns all cookies without copying them
+////////////////////////////////////////////////////////////////////////////////
+
+        cookie_fields_t const& cookieFields () const {
+          return _cookies;
+        }
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                               public body methods
 // -----------------------------------------------------------------------------
@@ -517,10 +571,32 @@ namespace triagens {
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief gets the request body as TRI_json_t*
+///
+/// Bodies sent with the binary json content type are decoded from binary,
+/// all others are parsed as json text.
 ////////////////////////////////////////////////////////////////////////////////
 
         TRI_json_t* toJson (char**);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief gets the request body as TRI_json_t*, allocated in the given zone
+////////////////////////////////////////////////////////////////////////////////
+
+        TRI_json_t* toJson (TRI_memory_zone_t*,
+                            char**);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the request body is binary json
+////////////////////////////////////////////////////////////////////////////////
+
+        bool hasBinaryJsonBody () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the client accepts binary json responses
+////////////////////////////////////////////////////////////////////////////////
+
+        bool acceptsBinaryJson () const;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
 // -----------------------------------------------------------------------------
@@ -591,25 +667,25 @@ namespace triagens {
 /// @brief headers
 ////////////////////////////////////////////////////////////////////////////////
 
-        basics::Dictionary<char const*> _headers;
+        header_fields_t _headers;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief values
 ////////////////////////////////////////////////////////////////////////////////
 
-        basics::Dictionary<char const*> _values;
+        value_fields_t _values;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief array values
 ////////////////////////////////////////////////////////////////////////////////
 
-        basics::Dictionary< std::vector<char const*>* > _arrayValues;
+        array_value_fields_t _arrayValues;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief cookies
 ////////////////////////////////////////////////////////////////////////////////
 
-        basics::Dictionary<char const*> _cookies;
+        cookie_fields_t _cookies;
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief content length
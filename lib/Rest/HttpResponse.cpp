@@ -246,6 +246,11 @@ HttpResponse::HttpResponseCode HttpResponse::responseCode (int code) {
     case TRI_ERROR_CLUSTER_UNSUPPORTED:
       return NOT_IMPLEMENTED;
 
+    case TRI_ERROR_QUEUE_TIME_EXCEEDED:
+    case TRI_ERROR_QUEUE_OVERLOADED:
+    case TRI_ERROR_ARANGO_WRITE_THROTTLE_TIMEOUT:
+      return SERVICE_UNAVAILABLE;
+
     case TRI_ERROR_OUT_OF_MEMORY:
     case TRI_ERROR_INTERNAL:
     default:
@@ -847,11 +852,13 @@ void HttpResponse::headResponse (size_t size) {
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief deflates the response body
 ///
-/// the body must already be set. deflate is then run on the existing body
+/// the body must already be set. deflate is then run on the existing body,
+/// using the given zlib compression level
 ////////////////////////////////////////////////////////////////////////////////
 
-int HttpResponse::deflate (size_t bufferSize) {
-  int res = _body.deflate(bufferSize);
+int HttpResponse::deflate (size_t bufferSize,
+                           int level) {
+  int res = _body.deflate(bufferSize, level);
 
   if (res != TRI_ERROR_NO_ERROR) {
     return res;
@@ -323,6 +323,14 @@ namespace triagens {
                         bool secure,
                         bool httpOnly);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the values of the set-cookie headers
+////////////////////////////////////////////////////////////////////////////////
+
+        std::vector<char const*> const& cookies () const {
+          return _cookies;
+        }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief swaps data
 ////////////////////////////////////////////////////////////////////////////////
@@ -367,10 +375,12 @@ namespace triagens {
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief deflates the response body
 ///
-/// the body must already be set. deflate is then run on the existing body
+/// the body must already be set. deflate is then run on the existing body,
+/// using the given zlib compression level
 ////////////////////////////////////////////////////////////////////////////////
 
-        int deflate (size_t = 16384);
+        int deflate (size_t = 16384,
+                     int = Z_DEFAULT_COMPRESSION);
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                   private methods
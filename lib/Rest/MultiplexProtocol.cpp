@@ -0,0 +1,614 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary protocol
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#include "MultiplexProtocol.h"
+
+#include "Basics/StringBuffer.h"
+
+using namespace triagens::basics;
+using namespace triagens::rest;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private variables
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the HPACK static table (RFC 7541, appendix A)
+////////////////////////////////////////////////////////////////////////////////
+
+static MultiplexProtocol::Header const StaticTable[] = {
+  { ":authority", "" },
+  { ":method", "GET" },
+  { ":method", "POST" },
+  { ":path", "/" },
+  { ":path", "/index.html" },
+  { ":scheme", "http" },
+  { ":scheme", "https" },
+  { ":status", "200" },
+  { ":status", "204" },
+  { ":status", "206" },
+  { ":status", "304" },
+  { ":status", "400" },
+  { ":status", "404" },
+  { ":status", "500" },
+  { "accept-charset", "" },
+  { "accept-encoding", "gzip, deflate" },
+  { "accept-language", "" },
+  { "accept-ranges", "" },
+  { "accept", "" },
+  { "access-control-allow-origin", "" },
+  { "age", "" },
+  { "allow", "" },
+  { "authorization", "" },
+  { "cache-control", "" },
+  { "content-disposition", "" },
+  { "content-encoding", "" },
+  { "content-language", "" },
+  { "content-length", "" },
+  { "content-location", "" },
+  { "content-range", "" },
+  { "content-type", "" },
+  { "cookie", "" },
+  { "date", "" },
+  { "etag", "" },
+  { "expect", "" },
+  { "expires", "" },
+  { "from", "" },
+  { "host", "" },
+  { "if-match", "" },
+  { "if-modified-since", "" },
+  { "if-none-match", "" },
+  { "if-range", "" },
+  { "if-unmodified-since", "" },
+  { "last-modified", "" },
+  { "link", "" },
+  { "location", "" },
+  { "max-forwards", "" },
+  { "proxy-authenticate", "" },
+  { "proxy-authorization", "" },
+  { "range", "" },
+  { "referer", "" },
+  { "refresh", "" },
+  { "retry-after", "" },
+  { "server", "" },
+  { "set-cookie", "" },
+  { "strict-transport-security", "" },
+  { "transfer-encoding", "" },
+  { "user-agent", "" },
+  { "vary", "" },
+  { "via", "" },
+  { "www-authenticate", "" }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief per-entry overhead of the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const EntryOverhead = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest value the encoder adds to the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t const MaximalIndexedValueLength = 256;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                 private functions
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends an integer with an N bit prefix
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendInteger (StringBuffer* buffer,
+                           uint8_t bits,
+                           int prefix,
+                           uint64_t value) {
+  uint64_t const max = (1ULL << prefix) - 1;
+
+  if (value < max) {
+    buffer->appendChar((char) (bits | value));
+    return;
+  }
+
+  buffer->appendChar((char) (bits | max));
+  value -= max;
+
+  while (value >= 128) {
+    buffer->appendChar((char) ((value & 127) | 128));
+    value >>= 7;
+  }
+
+  buffer->appendChar((char) value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a string literal, without Huffman coding
+////////////////////////////////////////////////////////////////////////////////
+
+static void AppendString (StringBuffer* buffer,
+                          std::string const& value) {
+  AppendInteger(buffer, 0x00, 7, value.size());
+  buffer->appendText(value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads an integer with an N bit prefix
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadInteger (uint8_t const*& p,
+                         uint8_t const* end,
+                         int prefix,
+                         uint64_t& value) {
+  if (p >= end) {
+    return false;
+  }
+
+  uint64_t const max = (1ULL << prefix) - 1;
+  value = *p++ & max;
+
+  if (value < max) {
+    return true;
+  }
+
+  int shift = 0;
+
+  while (true) {
+    if (p >= end || shift > 28) {
+      // truncated, or larger than any sensible length
+      return false;
+    }
+
+    uint8_t const b = *p++;
+    value += (uint64_t) (b & 127) << shift;
+    shift += 7;
+
+    if ((b & 128) == 0) {
+      return true;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a string literal
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ReadString (uint8_t const*& p,
+                        uint8_t const* end,
+                        std::string& value) {
+  if (p >= end || (*p & 0x80) != 0) {
+    // Huffman-coded strings are not supported
+    return false;
+  }
+
+  uint64_t length;
+
+  if (! ReadInteger(p, end, 7, length) || length > (uint64_t) (end - p)) {
+    return false;
+  }
+
+  value.assign(reinterpret_cast<char const*>(p), (size_t) length);
+  p += length;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether the encoder should add a header to the dynamic table
+///
+/// values which differ with each response would only push out useful entries
+////////////////////////////////////////////////////////////////////////////////
+
+static bool ShouldIndex (std::string const& name,
+                         std::string const& value) {
+  if (value.size() > MaximalIndexedValueLength) {
+    return false;
+  }
+
+  return name != "content-length" &&
+         name != "etag" &&
+         name != "location" &&
+         name != "x-arango-async-id";
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class MultiplexProtocol
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief static initializers
+////////////////////////////////////////////////////////////////////////////////
+
+char const* const MultiplexProtocol::ConnectionPreface = "ARANGODB-MUX/1.0\r\n\r\n";
+size_t const MultiplexProtocol::ConnectionPrefaceLength = 20;
+size_t const MultiplexProtocol::FrameHeaderSize;
+uint32_t const MultiplexProtocol::DefaultWindowSize;
+uint32_t const MultiplexProtocol::MaximalWindowSize;
+uint32_t const MultiplexProtocol::DefaultMaxFrameSize;
+uint32_t const MultiplexProtocol::MaximalMaxFrameSize;
+uint32_t const MultiplexProtocol::DefaultHeaderTableSize;
+size_t const MultiplexHeaderTable::StaticTableSize;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a frame header
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexProtocol::parseFrameHeader (char const* data,
+                                          FrameHeader& header) {
+  uint8_t const* p = reinterpret_cast<uint8_t const*>(data);
+
+  header._length   = ((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | (uint32_t) p[2];
+  header._type     = p[3];
+  header._flags    = p[4];
+  header._streamId = readUInt32(data + 5) & 0x7fffffff;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a frame header
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexProtocol::appendFrameHeader (StringBuffer* buffer,
+                                           uint32_t length,
+                                           uint8_t type,
+                                           uint8_t flags,
+                                           uint32_t streamId) {
+  TRI_ASSERT(length <= MaximalMaxFrameSize);
+
+  buffer->appendChar((char) ((length >> 16) & 0xff));
+  buffer->appendChar((char) ((length >> 8) & 0xff));
+  buffer->appendChar((char) (length & 0xff));
+  buffer->appendChar((char) type);
+  buffer->appendChar((char) flags);
+  appendUInt32(buffer, streamId & 0x7fffffff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a big-endian 32 bit value
+////////////////////////////////////////////////////////////////////////////////
+
+uint32_t MultiplexProtocol::readUInt32 (char const* data) {
+  uint8_t const* p = reinterpret_cast<uint8_t const*>(data);
+
+  return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a big-endian 32 bit value
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexProtocol::appendUInt32 (StringBuffer* buffer,
+                                      uint32_t value) {
+  buffer->appendChar((char) ((value >> 24) & 0xff));
+  buffer->appendChar((char) ((value >> 16) & 0xff));
+  buffer->appendChar((char) ((value >> 8) & 0xff));
+  buffer->appendChar((char) (value & 0xff));
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        class MultiplexHeaderTable
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a header table
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexHeaderTable::MultiplexHeaderTable ()
+  : _entries(),
+    _size(0),
+    _maxSize(MultiplexProtocol::DefaultHeaderTableSize) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the entry with the given index
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexProtocol::Header const* MultiplexHeaderTable::lookup (size_t index) const {
+  if (index == 0) {
+    return nullptr;
+  }
+
+  if (index <= StaticTableSize) {
+    return &StaticTable[index - 1];
+  }
+
+  index -= StaticTableSize + 1;
+
+  if (index >= _entries.size()) {
+    return nullptr;
+  }
+
+  return &_entries[index];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief searches for an entry
+////////////////////////////////////////////////////////////////////////////////
+
+size_t MultiplexHeaderTable::find (std::string const& name,
+                                   std::string const& value,
+                                   bool& exact) const {
+  size_t nameIndex = 0;
+  exact = false;
+
+  for (size_t i = 0; i < StaticTableSize; ++i) {
+    if (StaticTable[i].first == name) {
+      if (StaticTable[i].second == value) {
+        exact = true;
+        return i + 1;
+      }
+
+      if (nameIndex == 0) {
+        nameIndex = i + 1;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < _entries.size(); ++i) {
+    if (_entries[i].first == name) {
+      if (_entries[i].second == value) {
+        exact = true;
+        return StaticTableSize + 1 + i;
+      }
+
+      if (nameIndex == 0) {
+        nameIndex = StaticTableSize + 1 + i;
+      }
+    }
+  }
+
+  return nameIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an entry to the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexHeaderTable::add (std::string const& name,
+                                std::string const& value) {
+  size_t const cost = name.size() + value.size() + EntryOverhead;
+
+  if (cost > _maxSize) {
+    // an entry larger than the table empties it
+    evict(0);
+    return;
+  }
+
+  evict(_maxSize - cost);
+
+  _entries.emplace_front(name, value);
+  _size += cost;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximal size of the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexHeaderTable::setMaxSize (size_t maxSize) {
+  _maxSize = maxSize;
+  evict(maxSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evicts entries until the table fits into the given size
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexHeaderTable::evict (size_t size) {
+  while (_size > size && ! _entries.empty()) {
+    auto const& last = _entries.back();
+    _size -= last.first.size() + last.second.size() + EntryOverhead;
+    _entries.pop_back();
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class MultiplexHeaderEncoder
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates an encoder
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexHeaderEncoder::MultiplexHeaderEncoder ()
+  : _table(),
+    _sizeChanged(false) {
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the header block of the given headers
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexHeaderEncoder::encode (std::vector<MultiplexProtocol::Header> const& headers,
+                                     StringBuffer* buffer) {
+  if (_sizeChanged) {
+    // dynamic table size update
+    AppendInteger(buffer, 0x20, 5, _table.maxSize());
+    _sizeChanged = false;
+  }
+
+  for (auto const& it : headers) {
+    bool exact;
+    size_t const index = _table.find(it.first, it.second, exact);
+
+    if (exact) {
+      // indexed header field
+      AppendInteger(buffer, 0x80, 7, index);
+      continue;
+    }
+
+    if (ShouldIndex(it.first, it.second)) {
+      // literal header field with incremental indexing
+      AppendInteger(buffer, 0x40, 6, index);
+
+      if (index == 0) {
+        AppendString(buffer, it.first);
+      }
+
+      AppendString(buffer, it.second);
+      _table.add(it.first, it.second);
+    }
+    else {
+      // literal header field without indexing
+      AppendInteger(buffer, 0x00, 4, index);
+
+      if (index == 0) {
+        AppendString(buffer, it.first);
+      }
+
+      AppendString(buffer, it.second);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief limits the table size to the size the decoding peer allows
+////////////////////////////////////////////////////////////////////////////////
+
+void MultiplexHeaderEncoder::setMaxTableSize (size_t maxSize) {
+  if (maxSize > MultiplexProtocol::DefaultHeaderTableSize) {
+    // a larger table than the default brings little for response headers
+    maxSize = MultiplexProtocol::DefaultHeaderTableSize;
+  }
+
+  if (maxSize != _table.maxSize()) {
+    _table.setMaxSize(maxSize);
+    _sizeChanged = true;
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class MultiplexHeaderDecoder
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief creates a decoder
+////////////////////////////////////////////////////////////////////////////////
+
+MultiplexHeaderDecoder::MultiplexHeaderDecoder (size_t maxTableSize)
+  : _table(),
+    _maxTableSize(maxTableSize) {
+
+  _table.setMaxSize(maxTableSize);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a header block
+////////////////////////////////////////////////////////////////////////////////
+
+bool MultiplexHeaderDecoder::decode (char const* data,
+                                     size_t length,
+                                     size_t maxSize,
+                                     std::vector<MultiplexProtocol::Header>& headers) {
+  uint8_t const* p = reinterpret_cast<uint8_t const*>(data);
+  uint8_t const* end = p + length;
+  size_t total = 0;
+
+  while (p < end) {
+    uint8_t const b = *p;
+    uint64_t index;
+    bool addToTable = false;
+
+    if ((b & 0x80) != 0) {
+      // indexed header field
+      if (! ReadInteger(p, end, 7, index)) {
+        return false;
+      }
+
+      auto const* entry = _table.lookup((size_t) index);
+
+      if (entry == nullptr) {
+        return false;
+      }
+
+      headers.emplace_back(*entry);
+    }
+    else if ((b & 0xe0) == 0x20) {
+      // dynamic table size update
+      uint64_t size;
+
+      if (! ReadInteger(p, end, 5, size) || size > _maxTableSize) {
+        return false;
+      }
+
+      _table.setMaxSize((size_t) size);
+      continue;
+    }
+    else {
+      // literal header field, with (01), without (0000) or never (0001)
+      // indexing
+      addToTable = ((b & 0xc0) == 0x40);
+
+      if (! ReadInteger(p, end, addToTable ? 6 : 4, index)) {
+        return false;
+      }
+
+      MultiplexProtocol::Header header;
+
+      if (index == 0) {
+        if (! ReadString(p, end, header.first)) {
+          return false;
+        }
+      }
+      else {
+        auto const* entry = _table.lookup((size_t) index);
+
+        if (entry == nullptr) {
+          return false;
+        }
+
+        header.first = entry->first;
+      }
+
+      if (! ReadString(p, end, header.second)) {
+        return false;
+      }
+
+      if (addToTable) {
+        _table.add(header.first, header.second);
+      }
+
+      headers.emplace_back(std::move(header));
+    }
+
+    auto const& last = headers.back();
+    total += last.first.size() + last.second.size() + EntryOverhead;
+
+    if (total > maxSize) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
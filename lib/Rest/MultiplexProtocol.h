@@ -0,0 +1,430 @@
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary protocol
+///
+/// @file
+///
+/// DISCLAIMER
+///
+/// Copyright 2015 ArangoDB GmbH, Cologne, Germany
+/// Copyright 2004-2014 triAGENS GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Copyright 2015, ArangoDB GmbH, Cologne, Germany
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARANGODB_REST_MULTIPLEX_PROTOCOL_H
+#define ARANGODB_REST_MULTIPLEX_PROTOCOL_H 1
+
+#include "Basics/Common.h"
+
+namespace triagens {
+  namespace basics {
+    class StringBuffer;
+  }
+
+  namespace rest {
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                           class MultiplexProtocol
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief multiplexed binary protocol
+///
+/// the protocol uses the framing of HTTP/2: after the connection preface,
+/// both sides exchange frames with a 9 byte header (24 bit payload length,
+/// 8 bit type, 8 bit flags, 31 bit stream id, all big-endian). each request
+/// is sent on its own odd-numbered stream as a HEADERS frame with the
+/// pseudo-headers ":method" and ":path", followed by DATA frames with the
+/// body. the response comes back on the same stream as a HEADERS frame with
+/// ":status" and DATA frames. the last frame of each side carries the
+/// END_STREAM flag
+///
+/// header blocks use the HPACK representations with the HPACK static table
+/// and a dynamic table per direction. strings are never Huffman-coded.
+/// priorities, server push and CONTINUATION frames are not supported, so a
+/// header block must fit into a single HEADERS frame
+///
+/// DATA frames are flow-controlled per stream and per connection, with
+/// WINDOW_UPDATE frames as in HTTP/2
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexProtocol {
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frame types
+////////////////////////////////////////////////////////////////////////////////
+
+        enum FrameType : uint8_t {
+          FRAME_DATA          = 0x0,
+          FRAME_HEADERS       = 0x1,
+          FRAME_PRIORITY      = 0x2,
+          FRAME_RST_STREAM    = 0x3,
+          FRAME_SETTINGS      = 0x4,
+          FRAME_PUSH_PROMISE  = 0x5,
+          FRAME_PING          = 0x6,
+          FRAME_GOAWAY        = 0x7,
+          FRAME_WINDOW_UPDATE = 0x8,
+          FRAME_CONTINUATION  = 0x9
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief frame flags
+////////////////////////////////////////////////////////////////////////////////
+
+        enum FrameFlag : uint8_t {
+          FLAG_END_STREAM  = 0x1,
+          FLAG_ACK         = 0x1,
+          FLAG_END_HEADERS = 0x4,
+          FLAG_PADDED      = 0x8,
+          FLAG_PRIORITY    = 0x20
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief settings identifiers
+////////////////////////////////////////////////////////////////////////////////
+
+        enum Setting : uint16_t {
+          SETTINGS_HEADER_TABLE_SIZE      = 0x1,
+          SETTINGS_ENABLE_PUSH            = 0x2,
+          SETTINGS_MAX_CONCURRENT_STREAMS = 0x3,
+          SETTINGS_INITIAL_WINDOW_SIZE    = 0x4,
+          SETTINGS_MAX_FRAME_SIZE         = 0x5,
+          SETTINGS_MAX_HEADER_LIST_SIZE   = 0x6
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief error codes of RST_STREAM and GOAWAY frames
+////////////////////////////////////////////////////////////////////////////////
+
+        enum ErrorCode : uint32_t {
+          ERROR_NONE                = 0x0,
+          ERROR_PROTOCOL            = 0x1,
+          ERROR_INTERNAL            = 0x2,
+          ERROR_FLOW_CONTROL        = 0x3,
+          ERROR_STREAM_CLOSED       = 0x5,
+          ERROR_FRAME_SIZE          = 0x6,
+          ERROR_REFUSED_STREAM      = 0x7,
+          ERROR_CANCEL              = 0x8,
+          ERROR_COMPRESSION         = 0x9,
+          ERROR_ENHANCE_YOUR_CALM   = 0xb
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a frame header
+////////////////////////////////////////////////////////////////////////////////
+
+        struct FrameHeader {
+          uint32_t _length;
+          uint8_t _type;
+          uint8_t _flags;
+          uint32_t _streamId;
+        };
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief a header field
+////////////////////////////////////////////////////////////////////////////////
+
+        typedef std::pair<std::string, std::string> Header;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  public constants
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the connection preface a client sends first
+////////////////////////////////////////////////////////////////////////////////
+
+        static char const* const ConnectionPreface;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief length of the connection preface
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const ConnectionPrefaceLength;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief size of a frame header
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const FrameHeaderSize = 9;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initial flow-control window of streams and connections
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const DefaultWindowSize = 65535;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest flow-control window
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const MaximalWindowSize = 0x7fffffff;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initial maximal frame payload size
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const DefaultMaxFrameSize = 16384;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief largest maximal frame payload size a peer may announce
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const MaximalMaxFrameSize = 16777215;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief initial size of the dynamic header tables
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t const DefaultHeaderTableSize = 4096;
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                             static public methods
+// -----------------------------------------------------------------------------
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief parses a frame header, the buffer must hold FrameHeaderSize bytes
+////////////////////////////////////////////////////////////////////////////////
+
+        static void parseFrameHeader (char const*,
+                                      FrameHeader&);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a frame header
+////////////////////////////////////////////////////////////////////////////////
+
+        static void appendFrameHeader (basics::StringBuffer*,
+                                       uint32_t length,
+                                       uint8_t type,
+                                       uint8_t flags,
+                                       uint32_t streamId);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads a big-endian 32 bit value
+////////////////////////////////////////////////////////////////////////////////
+
+        static uint32_t readUInt32 (char const*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends a big-endian 32 bit value
+////////////////////////////////////////////////////////////////////////////////
+
+        static void appendUInt32 (basics::StringBuffer*,
+                                  uint32_t);
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                        class MultiplexHeaderTable
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the header table of one direction of a connection
+///
+/// indexes 1 to 61 address the HPACK static table, the following indexes the
+/// dynamic table, newest entry first. entries are evicted from the end when
+/// the table grows beyond its maximal size, an entry costs its name and value
+/// length plus 32 bytes
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexHeaderTable {
+      public:
+
+        MultiplexHeaderTable ();
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief number of entries of the static table
+////////////////////////////////////////////////////////////////////////////////
+
+        static size_t const StaticTableSize = 61;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the entry with the given index, nullptr if there is none
+////////////////////////////////////////////////////////////////////////////////
+
+        MultiplexProtocol::Header const* lookup (size_t) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief searches for an entry
+///
+/// returns the index of an entry with the name and the value and sets
+/// exact, or else the index of an entry with the name only, or else 0
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t find (std::string const& name,
+                     std::string const& value,
+                     bool& exact) const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief adds an entry to the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+        void add (std::string const& name,
+                  std::string const& value);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief sets the maximal size of the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaxSize (size_t);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the maximal size of the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t maxSize () const {
+          return _maxSize;
+        }
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns the current size of the dynamic table
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t size () const {
+          return _size;
+        }
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief evicts entries until the table fits into the given size
+////////////////////////////////////////////////////////////////////////////////
+
+        void evict (size_t);
+
+      private:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief dynamic entries, newest first
+////////////////////////////////////////////////////////////////////////////////
+
+        std::deque<MultiplexProtocol::Header> _entries;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief current size of the dynamic entries
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _size;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief maximal size of the dynamic entries
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _maxSize;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class MultiplexHeaderEncoder
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compresses header blocks
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexHeaderEncoder {
+      public:
+
+        MultiplexHeaderEncoder ();
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief appends the header block of the given headers
+///
+/// headers already in the table are sent as an index. other headers are
+/// added to the table, except for large or ever-changing values
+////////////////////////////////////////////////////////////////////////////////
+
+        void encode (std::vector<MultiplexProtocol::Header> const&,
+                     basics::StringBuffer*);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief limits the table size to the size the decoding peer allows
+///
+/// the change is signaled at the start of the next header block
+////////////////////////////////////////////////////////////////////////////////
+
+        void setMaxTableSize (size_t);
+
+      private:
+
+        MultiplexHeaderTable _table;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief whether a table size update must be signaled
+////////////////////////////////////////////////////////////////////////////////
+
+        bool _sizeChanged;
+    };
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                      class MultiplexHeaderDecoder
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decompresses header blocks
+////////////////////////////////////////////////////////////////////////////////
+
+    class MultiplexHeaderDecoder {
+      public:
+
+        explicit MultiplexHeaderDecoder (size_t maxTableSize = MultiplexProtocol::DefaultHeaderTableSize);
+
+      public:
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a header block
+///
+/// returns false if the block is malformed or the headers exceed maxSize
+/// bytes. the table is in an undefined state afterwards, so the
+/// connection must be closed
+////////////////////////////////////////////////////////////////////////////////
+
+        bool decode (char const*,
+                     size_t,
+                     size_t maxSize,
+                     std::vector<MultiplexProtocol::Header>&);
+
+      private:
+
+        MultiplexHeaderTable _table;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief the table size announced to the encoding peer
+////////////////////////////////////////////////////////////////////////////////
+
+        size_t _maxTableSize;
+    };
+  }
+}
+
+#endif
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
+
+// Local Variables:
+// mode: outline-minor
+// outline-regexp: "/// @brief\\|/// {@inheritDoc}\\|/// @page\\|// --SECTION--\\|/// @\\}"
+// End:
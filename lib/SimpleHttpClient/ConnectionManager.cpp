@@ -171,7 +171,7 @@ void ConnectionManager::ServerConnections::removeConnection (ConnectionManager::
 void ConnectionManager::ServerConnections::closeUnusedConnections (double limit) {
   time_t const t = time(0);
 
-  std::list<ConnectionManager::SingleServerConnection*>::iterator current;
+  std::vector<ConnectionManager::SingleServerConnection*>::iterator current;
 
   WRITE_LOCKER(_lock);
 
@@ -225,6 +225,7 @@ ConnectionManager::SingleServerConnection* ConnectionManager::leaseConnection (s
     std::unique_ptr<ServerConnections> sc(new ServerConnections());
 
     sc->_connections.reserve(16);
+    sc->_unused.reserve(16);
 
     // note that it is possible for a concurrent thread to have created
     // a list for the same endpoint. this case is handled below
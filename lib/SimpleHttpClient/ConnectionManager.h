@@ -131,7 +131,7 @@ namespace triagens {
 
         struct ServerConnections {
           std::vector<SingleServerConnection*> _connections;
-          std::list<SingleServerConnection*>   _unused;
+          std::vector<SingleServerConnection*> _unused;
           triagens::basics::ReadWriteLock      _lock;
 
           ServerConnections () = default;
@@ -52,7 +52,7 @@ namespace triagens {
 // --SECTION--                                                          typedefs
 // -----------------------------------------------------------------------------
 
-      protected:
+      public:
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief size of read buffer for read operations
@@ -607,6 +607,21 @@ namespace triagens {
               return;
             }
 
+            if (! _result->isDeflated()) {
+              // drop the header from the read buffer and make room for the
+              // rest of the body, so that the buffer is not grown while the
+              // body is read. the buffer then holds nothing but the body and
+              // can be handed over to the result
+              _readBuffer.move_front(_readBufferOffset);
+              _readBufferOffset = 0;
+
+              size_t const length = _readBuffer.length();
+
+              if (length < _result->getContentLength()) {
+                _readBuffer.reserve(_result->getContentLength() - length + GeneralClientConnection::READBUFFER_SIZE);
+              }
+            }
+
             _state = IN_READ_BODY;
             processBody();
             return;
@@ -674,6 +689,14 @@ namespace triagens {
       // body is compressed using deflate. inflate it
       if (_result->isDeflated()) {
         _readBuffer.inflate(_result->getBody(), 16384, _readBufferOffset);
+        _readBufferOffset += _result->getContentLength();
+      }
+
+      // the read buffer holds exactly the body, see processHeader()
+      else if (_readBufferOffset == 0 &&
+               _readBuffer.length() == _result->getContentLength() &&
+               _result->getBody().length() == 0) {
+        _result->getBody().swap(&_readBuffer);
       }
 
       // body is not compressed
@@ -682,9 +705,9 @@ namespace triagens {
         // _result->getContentLength() <= _readBuffer.length()-_readBufferOffset
         _result->getBody().appendText(_readBuffer.c_str() + _readBufferOffset, 
                                       _result->getContentLength());
+        _readBufferOffset += _result->getContentLength();
       }
 
-      _readBufferOffset += _result->getContentLength();
       _result->setResultType(SimpleHttpResult::COMPLETE);
       _state = FINISHED;
 
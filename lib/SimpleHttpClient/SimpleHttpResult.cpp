@@ -30,6 +30,7 @@
 
 #include "SimpleHttpResult.h"
 #include "Basics/StringUtils.h"
+#include "Basics/json-binary.h"
 
 using namespace triagens::basics;
 using namespace std;
@@ -237,6 +238,24 @@ namespace triagens {
       return (*ptr == '\0' || *ptr == ';' || *ptr == ' ');
     }
 
+    bool SimpleHttpResult::isBinaryJson () const {
+      auto const& find = _headerFields.find("content-type");
+
+      if (find == _headerFields.end()) {
+        return false;
+      }
+
+      return TRI_IsBinaryJsonContentType(find->second.c_str());
+    }
+
+    TRI_json_t* SimpleHttpResult::getBodyJson () const {
+      if (isBinaryJson()) {
+        return TRI_BinaryJson(TRI_UNKNOWN_MEM_ZONE, _resultBody.c_str(), _resultBody.length(), nullptr);
+      }
+
+      return TRI_JsonString(TRI_UNKNOWN_MEM_ZONE, _resultBody.c_str());
+    }
+
   }
 }
 
@@ -33,6 +33,7 @@
 
 #include "Basics/Common.h"
 #include "Basics/StringBuffer.h"
+#include "Basics/json.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief class for storing a request result
@@ -231,6 +232,19 @@ namespace triagens {
     
       bool isJson () const;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief returns whether the result is binary json-encoded
+////////////////////////////////////////////////////////////////////////////////
+
+      bool isBinaryJson () const;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes the body as json or binary json, depending on its content
+/// type. the caller has to free the result, which is nullptr on error
+////////////////////////////////////////////////////////////////////////////////
+
+      TRI_json_t* getBodyJson () const;
+
     private:
 
 ////////////////////////////////////////////////////////////////////////////////
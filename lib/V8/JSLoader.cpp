@@ -66,11 +66,10 @@ v8::Handle<v8::Value> JSLoader::executeGlobalScript (v8::Isolate* isolate,
   v8::EscapableHandleScope scope(isolate);
   v8::Handle<v8::Value> result;
 
-  findScript(name);
+  // findScript locks the scripts, so contexts can be set up in parallel
+  std::string const& script = findScript(name);
 
-  std::map<std::string, std::string>::iterator i = _scripts.find(name);
-
-  if (i == _scripts.end()) {
+  if (script.empty()) {
     // correct the path/name
     LOG_ERROR("unknown script '%s'", StringUtils::correctPath(name).c_str());
     return v8::Undefined(isolate);
@@ -78,7 +77,7 @@ v8::Handle<v8::Value> JSLoader::executeGlobalScript (v8::Isolate* isolate,
 
   result = TRI_ExecuteJavaScriptString(isolate,
                                        context,
-                                       TRI_V8_STD_STRING(i->second),
+                                       TRI_V8_STD_STRING(script),
                                        TRI_V8_STD_STRING(name),
                                        false);
 
@@ -106,11 +105,9 @@ JSLoader::eState JSLoader::loadScript(v8::Isolate* isolate,
   v8::TryCatch tryCatch;
   v8::HandleScope scope(isolate);
 
-  findScript(name);
-
-  map<string, string>::iterator i = _scripts.find(name);
+  string const& script = findScript(name);
 
-  if (i == _scripts.end()) {
+  if (script.empty()) {
     // correct the path/name
     LOG_ERROR("unknown script '%s'", StringUtils::correctPath(name).c_str());
     return eFailLoad;
@@ -121,7 +118,7 @@ JSLoader::eState JSLoader::loadScript(v8::Isolate* isolate,
   
   TRI_ExecuteJavaScriptString(isolate,
                               context,
-                              TRI_V8_STD_STRING(i->second),
+                              TRI_V8_STD_STRING(script),
                               TRI_V8_STD_STRING(name),
                               false);
 
@@ -174,15 +171,13 @@ bool JSLoader::executeScript (v8::Isolate* isolate,
   v8::TryCatch tryCatch;
   v8::HandleScope scope(isolate);
 
-  findScript(name);
-
-  map<string, string>::iterator i = _scripts.find(name);
+  string const& script = findScript(name);
 
-  if (i == _scripts.end()) {
+  if (script.empty()) {
     return false;
   }
 
-  string content = "(function() { " + i->second + "/* end-of-file '" + name + "' */ })()";
+  string content = "(function() { " + script + "/* end-of-file '" + name + "' */ })()";
 
   // Enter the newly created execution environment.
   v8::Context::Scope context_scope(context);
@@ -39,6 +39,7 @@
 
 #include "Basics/Dictionary.h"
 #include "Basics/FileUtils.h"
+#include "Basics/MutexLocker.h"
 #include "Basics/Nonce.h"
 #include "Basics/ProgramOptions.h"
 #include "Basics/RandomGenerator.h"
@@ -46,6 +47,7 @@
 #include "Basics/conversions.h"
 #include "Basics/csv.h"
 #include "Basics/files.h"
+#include "Basics/hashes.h"
 #include "Basics/logging.h"
 #include "Basics/process-utils.h"
 #include "Basics/string-buffer.h"
@@ -84,6 +86,26 @@ namespace {
   static Random::UniformCharacter JSSaltGenerator("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*(){}[]:;<>,.?/|");
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compiled code of named scripts, shared by all isolates
+///
+/// the key is the script name and the hash of its source. the code cache of
+/// V8 does not depend on the isolate, so every script only needs to be fully
+/// compiled once per process
+////////////////////////////////////////////////////////////////////////////////
+
+static triagens::basics::Mutex CodeCacheLock;
+
+static std::unordered_map<std::string, std::shared_ptr<std::string const>> CodeCache;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief memory used by the code cache, and its limit
+////////////////////////////////////////////////////////////////////////////////
+
+static size_t CodeCacheSize = 0;
+
+static size_t const CodeCacheMaxSize = 64 * 1024 * 1024;
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                    public classes
 // -----------------------------------------------------------------------------
@@ -210,7 +232,7 @@ static bool LoadJavaScriptFile (v8::Isolate* isolate,
 
   v8::TryCatch tryCatch;
 
-  v8::Handle<v8::Script> script = v8::Script::Compile(source, name);
+  v8::Handle<v8::Script> script = TRI_CompileJavaScriptString(isolate, source, name);
 
   if (tryCatch.HasCaught()) {
     TRI_LogV8Exception(isolate, &tryCatch);
@@ -983,7 +1005,7 @@ static void JS_Execute (const v8::FunctionCallbackInfo<v8::Value>& args) {
   {
     v8::TryCatch tryCatch;
 
-    script = v8::Script::Compile(source->ToString(), filename->ToString());
+    script = TRI_CompileJavaScriptString(isolate, source->ToString(), filename->ToString());
 
     // compilation failed, print errors that happened during compilation
     if (script.IsEmpty()) {
@@ -4067,6 +4089,99 @@ bool TRI_ParseJavaScriptFile (v8::Isolate* isolate, char const* filename) {
   return LoadJavaScriptFile(isolate, filename, false, false);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compiles a named script in the current context
+///
+/// scripts with a name not starting with '<' are compiled with the V8 code
+/// cache. the first isolate compiling a script produces the cached code, all
+/// others consume it instead of parsing and compiling the source again
+////////////////////////////////////////////////////////////////////////////////
+
+v8::Handle<v8::Script> TRI_CompileJavaScriptString (v8::Isolate* isolate,
+                                                    v8::Handle<v8::String> const source,
+                                                    v8::Handle<v8::String> const name) {
+  v8::EscapableHandleScope scope(isolate);
+
+  v8::String::Utf8Value nameValue(name);
+
+  if (*nameValue == nullptr ||
+      nameValue.length() == 0 ||
+      (*nameValue)[0] == '<') {
+    // anonymous snippets are not worth caching
+    return scope.Escape<v8::Script>(v8::Script::Compile(source, name));
+  }
+
+  v8::String::Utf8Value sourceValue(source);
+
+  if (*sourceValue == nullptr) {
+    return scope.Escape<v8::Script>(v8::Script::Compile(source, name));
+  }
+
+  std::string key(*nameValue, (size_t) nameValue.length());
+  key.push_back('\0');
+  key.append(std::to_string(TRI_FnvHashPointer(*sourceValue, (size_t) sourceValue.length())));
+
+  std::shared_ptr<std::string const> cached;
+
+  {
+    MUTEX_LOCKER(CodeCacheLock);
+
+    auto it = CodeCache.find(key);
+
+    if (it != CodeCache.end()) {
+      cached = (*it).second;
+    }
+  }
+
+  v8::ScriptOrigin origin(name);
+
+  if (cached != nullptr) {
+    // the source takes over the CachedData object, but not the buffer, which
+    // is kept alive by cached
+    v8::ScriptCompiler::Source compilerSource(source, origin,
+      new v8::ScriptCompiler::CachedData(reinterpret_cast<uint8_t const*>(cached->c_str()),
+                                         (int) cached->size()));
+
+    v8::Local<v8::Script> script = v8::ScriptCompiler::Compile(isolate, &compilerSource, v8::ScriptCompiler::kConsumeCodeCache);
+
+    if (compilerSource.GetCachedData()->rejected) {
+      // V8 has compiled the source as usual. drop the entry, so the next
+      // isolate produces a new one
+      MUTEX_LOCKER(CodeCacheLock);
+
+      auto it = CodeCache.find(key);
+
+      if (it != CodeCache.end() && (*it).second == cached) {
+        CodeCacheSize -= cached->size();
+        CodeCache.erase(it);
+      }
+    }
+
+    return scope.Escape<v8::Script>(script);
+  }
+
+  v8::ScriptCompiler::Source compilerSource(source, origin);
+  v8::Local<v8::Script> script = v8::ScriptCompiler::Compile(isolate, &compilerSource, v8::ScriptCompiler::kProduceCodeCache);
+
+  v8::ScriptCompiler::CachedData const* data = compilerSource.GetCachedData();
+
+  if (! script.IsEmpty() &&
+      data != nullptr &&
+      data->length > 0) {
+    MUTEX_LOCKER(CodeCacheLock);
+
+    if (CodeCacheSize + (size_t) data->length <= CodeCacheMaxSize) {
+      auto produced = std::make_shared<std::string const>(reinterpret_cast<char const*>(data->data), (size_t) data->length);
+
+      if (CodeCache.emplace(key, produced).second) {
+        CodeCacheSize += produced->size();
+      }
+    }
+  }
+
+  return scope.Escape<v8::Script>(script);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief executes a string within a V8 context, optionally print the result
 ////////////////////////////////////////////////////////////////////////////////
@@ -4079,7 +4194,7 @@ v8::Handle<v8::Value> TRI_ExecuteJavaScriptString (v8::Isolate* isolate,
   v8::EscapableHandleScope scope(isolate);
 
   v8::Handle<v8::Value> result;
-  v8::Handle<v8::Script> script = v8::Script::Compile(source, name);
+  v8::Handle<v8::Script> script = TRI_CompileJavaScriptString(isolate, source, name);
 
   // compilation failed, print errors that happened during compilation
   if (script.IsEmpty()) {
@@ -169,6 +169,15 @@ bool TRI_ExecuteLocalJavaScriptDirectory (v8::Isolate* isolate, char const*);
 
 bool TRI_ParseJavaScriptFile (v8::Isolate* isolate, char const*);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief compiles a named script in the current context, using the code
+/// cache shared by all isolates
+////////////////////////////////////////////////////////////////////////////////
+
+v8::Handle<v8::Script> TRI_CompileJavaScriptString (v8::Isolate* isolate,
+                                                    v8::Handle<v8::String> const source,
+                                                    v8::Handle<v8::String> const name);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief executes a string within a V8 context, optionally print the result
 ////////////////////////////////////////////////////////////////////////////////